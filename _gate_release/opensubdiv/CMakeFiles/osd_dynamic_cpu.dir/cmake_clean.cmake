@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "../lib/libosdCPU.pdb"
+  "../lib/libosdCPU.so"
+  "../lib/libosdCPU.so.3.0.5"
+  "CMakeFiles/osd_dynamic_cpu.dir/version.cpp.o"
+  "CMakeFiles/osd_dynamic_cpu.dir/version.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/osd_dynamic_cpu.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
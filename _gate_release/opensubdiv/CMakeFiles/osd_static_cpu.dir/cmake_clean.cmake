@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../lib/libosdCPU.a"
+  "../lib/libosdCPU.pdb"
+  "CMakeFiles/osd_static_cpu.dir/version.cpp.o"
+  "CMakeFiles/osd_static_cpu.dir/version.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/osd_static_cpu.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
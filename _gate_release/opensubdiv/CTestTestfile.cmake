@@ -0,0 +1,11 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/opensubdiv
+# Build directory: /root/repo/_gate_release/opensubdiv
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("hbr")
+subdirs("sdc")
+subdirs("vtr")
+subdirs("far")
+subdirs("osd")
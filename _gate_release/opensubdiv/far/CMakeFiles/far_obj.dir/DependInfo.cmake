@@ -0,0 +1,53 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/opensubdiv/far/buildMonitor.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/buildMonitor.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/buildMonitor.cpp.o.d"
+  "/root/repo/opensubdiv/far/endCapBSplineBasisPatchFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/endCapBSplineBasisPatchFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/endCapBSplineBasisPatchFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/endCapGregoryBasisPatchFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/endCapGregoryBasisPatchFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/endCapGregoryBasisPatchFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/endCapLegacyGregoryPatchFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/endCapLegacyGregoryPatchFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/endCapLegacyGregoryPatchFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/error.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/error.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/error.cpp.o.d"
+  "/root/repo/opensubdiv/far/faceLevelTableFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/faceLevelTableFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/faceLevelTableFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/gregoryBasis.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/gregoryBasis.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/gregoryBasis.cpp.o.d"
+  "/root/repo/opensubdiv/far/hierarchicalEdits.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/hierarchicalEdits.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/hierarchicalEdits.cpp.o.d"
+  "/root/repo/opensubdiv/far/incrementalRefiner.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/incrementalRefiner.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/incrementalRefiner.cpp.o.d"
+  "/root/repo/opensubdiv/far/limitSurfaceQuery.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/limitSurfaceQuery.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/limitSurfaceQuery.cpp.o.d"
+  "/root/repo/opensubdiv/far/meshletTableFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/meshletTableFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/meshletTableFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchBVH.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchBVH.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchBVH.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchBasis.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchBasis.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchBasis.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchDescriptor.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchDescriptor.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchDescriptor.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchMap.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchMap.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchMap.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchProvider.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchProvider.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchProvider.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchTable.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchTable.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchTable.cpp.o.d"
+  "/root/repo/opensubdiv/far/patchTableFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/patchTableFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/patchTableFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/profile.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/profile.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/profile.cpp.o.d"
+  "/root/repo/opensubdiv/far/ptexIndices.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/ptexIndices.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/ptexIndices.cpp.o.d"
+  "/root/repo/opensubdiv/far/stencilBuilder.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilBuilder.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilBuilder.cpp.o.d"
+  "/root/repo/opensubdiv/far/stencilReverseIndex.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilReverseIndex.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilReverseIndex.cpp.o.d"
+  "/root/repo/opensubdiv/far/stencilTable.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilTable.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilTable.cpp.o.d"
+  "/root/repo/opensubdiv/far/stencilTableFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilTableFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/stencilTableFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/streamingRefiner.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/streamingRefiner.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/streamingRefiner.cpp.o.d"
+  "/root/repo/opensubdiv/far/tableSerializer.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/tableSerializer.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/tableSerializer.cpp.o.d"
+  "/root/repo/opensubdiv/far/taskScheduler.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/taskScheduler.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/taskScheduler.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyBatchFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyBatchFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyBatchFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyCache.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyCache.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyCache.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyDescriptor.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyDescriptor.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyDescriptor.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyFingerprint.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyFingerprint.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyFingerprint.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyLevel.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyLevel.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyLevel.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyRefiner.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyRefiner.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyRefiner.cpp.o.d"
+  "/root/repo/opensubdiv/far/topologyRefinerFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyRefinerFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/topologyRefinerFactory.cpp.o.d"
+  "/root/repo/opensubdiv/far/variableLevelMeshFactory.cpp" "opensubdiv/far/CMakeFiles/far_obj.dir/variableLevelMeshFactory.cpp.o" "gcc" "opensubdiv/far/CMakeFiles/far_obj.dir/variableLevelMeshFactory.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
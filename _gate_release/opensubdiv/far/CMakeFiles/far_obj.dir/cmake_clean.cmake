@@ -0,0 +1,77 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/far_obj.dir/buildMonitor.cpp.o"
+  "CMakeFiles/far_obj.dir/buildMonitor.cpp.o.d"
+  "CMakeFiles/far_obj.dir/endCapBSplineBasisPatchFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/endCapBSplineBasisPatchFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/endCapGregoryBasisPatchFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/endCapGregoryBasisPatchFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/endCapLegacyGregoryPatchFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/endCapLegacyGregoryPatchFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/error.cpp.o"
+  "CMakeFiles/far_obj.dir/error.cpp.o.d"
+  "CMakeFiles/far_obj.dir/faceLevelTableFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/faceLevelTableFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/gregoryBasis.cpp.o"
+  "CMakeFiles/far_obj.dir/gregoryBasis.cpp.o.d"
+  "CMakeFiles/far_obj.dir/hierarchicalEdits.cpp.o"
+  "CMakeFiles/far_obj.dir/hierarchicalEdits.cpp.o.d"
+  "CMakeFiles/far_obj.dir/incrementalRefiner.cpp.o"
+  "CMakeFiles/far_obj.dir/incrementalRefiner.cpp.o.d"
+  "CMakeFiles/far_obj.dir/limitSurfaceQuery.cpp.o"
+  "CMakeFiles/far_obj.dir/limitSurfaceQuery.cpp.o.d"
+  "CMakeFiles/far_obj.dir/meshletTableFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/meshletTableFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchBVH.cpp.o"
+  "CMakeFiles/far_obj.dir/patchBVH.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchBasis.cpp.o"
+  "CMakeFiles/far_obj.dir/patchBasis.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchDescriptor.cpp.o"
+  "CMakeFiles/far_obj.dir/patchDescriptor.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchMap.cpp.o"
+  "CMakeFiles/far_obj.dir/patchMap.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchProvider.cpp.o"
+  "CMakeFiles/far_obj.dir/patchProvider.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchTable.cpp.o"
+  "CMakeFiles/far_obj.dir/patchTable.cpp.o.d"
+  "CMakeFiles/far_obj.dir/patchTableFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/patchTableFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/profile.cpp.o"
+  "CMakeFiles/far_obj.dir/profile.cpp.o.d"
+  "CMakeFiles/far_obj.dir/ptexIndices.cpp.o"
+  "CMakeFiles/far_obj.dir/ptexIndices.cpp.o.d"
+  "CMakeFiles/far_obj.dir/stencilBuilder.cpp.o"
+  "CMakeFiles/far_obj.dir/stencilBuilder.cpp.o.d"
+  "CMakeFiles/far_obj.dir/stencilReverseIndex.cpp.o"
+  "CMakeFiles/far_obj.dir/stencilReverseIndex.cpp.o.d"
+  "CMakeFiles/far_obj.dir/stencilTable.cpp.o"
+  "CMakeFiles/far_obj.dir/stencilTable.cpp.o.d"
+  "CMakeFiles/far_obj.dir/stencilTableFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/stencilTableFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/streamingRefiner.cpp.o"
+  "CMakeFiles/far_obj.dir/streamingRefiner.cpp.o.d"
+  "CMakeFiles/far_obj.dir/tableSerializer.cpp.o"
+  "CMakeFiles/far_obj.dir/tableSerializer.cpp.o.d"
+  "CMakeFiles/far_obj.dir/taskScheduler.cpp.o"
+  "CMakeFiles/far_obj.dir/taskScheduler.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyBatchFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyBatchFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyCache.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyCache.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyDescriptor.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyDescriptor.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyFingerprint.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyFingerprint.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyLevel.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyLevel.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyRefiner.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyRefiner.cpp.o.d"
+  "CMakeFiles/far_obj.dir/topologyRefinerFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/topologyRefinerFactory.cpp.o.d"
+  "CMakeFiles/far_obj.dir/variableLevelMeshFactory.cpp.o"
+  "CMakeFiles/far_obj.dir/variableLevelMeshFactory.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/far_obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
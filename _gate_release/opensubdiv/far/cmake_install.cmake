@@ -0,0 +1,87 @@
+# Install script for directory: /root/repo/opensubdiv/far
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/usr/local")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "Release")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include/opensubdiv/far" TYPE FILE PERMISSIONS OWNER_READ GROUP_READ WORLD_READ FILES
+    "/root/repo/opensubdiv/far/buildMonitor.h"
+    "/root/repo/opensubdiv/far/error.h"
+    "/root/repo/opensubdiv/far/faceLevelTable.h"
+    "/root/repo/opensubdiv/far/faceLevelTableFactory.h"
+    "/root/repo/opensubdiv/far/hierarchicalEdits.h"
+    "/root/repo/opensubdiv/far/incrementalRefiner.h"
+    "/root/repo/opensubdiv/far/limitSurfaceQuery.h"
+    "/root/repo/opensubdiv/far/memoryResource.h"
+    "/root/repo/opensubdiv/far/meshletTable.h"
+    "/root/repo/opensubdiv/far/meshletTableFactory.h"
+    "/root/repo/opensubdiv/far/patchBVH.h"
+    "/root/repo/opensubdiv/far/patchDescriptor.h"
+    "/root/repo/opensubdiv/far/patchParam.h"
+    "/root/repo/opensubdiv/far/patchMap.h"
+    "/root/repo/opensubdiv/far/patchProvider.h"
+    "/root/repo/opensubdiv/far/patchTable.h"
+    "/root/repo/opensubdiv/far/patchTableFactory.h"
+    "/root/repo/opensubdiv/far/primvarBuffers.h"
+    "/root/repo/opensubdiv/far/primvarRefiner.h"
+    "/root/repo/opensubdiv/far/profile.h"
+    "/root/repo/opensubdiv/far/ptexIndices.h"
+    "/root/repo/opensubdiv/far/stencilReverseIndex.h"
+    "/root/repo/opensubdiv/far/stencilTable.h"
+    "/root/repo/opensubdiv/far/stencilTableFactory.h"
+    "/root/repo/opensubdiv/far/streamingRefiner.h"
+    "/root/repo/opensubdiv/far/tableSerializer.h"
+    "/root/repo/opensubdiv/far/taskScheduler.h"
+    "/root/repo/opensubdiv/far/topologyBatch.h"
+    "/root/repo/opensubdiv/far/topologyBatchFactory.h"
+    "/root/repo/opensubdiv/far/topologyCache.h"
+    "/root/repo/opensubdiv/far/topologyDescriptor.h"
+    "/root/repo/opensubdiv/far/topologyFingerprint.h"
+    "/root/repo/opensubdiv/far/topologyLevel.h"
+    "/root/repo/opensubdiv/far/topologyRefiner.h"
+    "/root/repo/opensubdiv/far/topologyRefinerFactory.h"
+    "/root/repo/opensubdiv/far/types.h"
+    "/root/repo/opensubdiv/far/variableLevelMesh.h"
+    "/root/repo/opensubdiv/far/variableLevelMeshFactory.h"
+    )
+endif()
+
@@ -0,0 +1,42 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/opensubdiv/osd/cpuAvx2Kernel.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuAvx2Kernel.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuAvx2Kernel.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuAvx512Kernel.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuAvx512Kernel.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuAvx512Kernel.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuCompactStencilTable.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuCompactStencilTable.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuCompactStencilTable.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuDisplacementTexture.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuDisplacementTexture.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuDisplacementTexture.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuEvaluator.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuEvaluator.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuEvaluator.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuFaceLevelSelector.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuFaceLevelSelector.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuFaceLevelSelector.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuInstancedStencilTable.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuInstancedStencilTable.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuInstancedStencilTable.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuKernel.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuKernel.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuKernel.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuPackedStencilTable.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPackedStencilTable.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPackedStencilTable.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuPatchGridBasis.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPatchGridBasis.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPatchGridBasis.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuPatchMap.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPatchMap.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPatchMap.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuPatchTable.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPatchTable.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPatchTable.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuPtexAdjacency.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPtexAdjacency.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuPtexAdjacency.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuSurfaceSampler.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuSurfaceSampler.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuSurfaceSampler.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuTessellator.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuTessellator.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuTessellator.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuVaryingStencilTable.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuVaryingStencilTable.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuVaryingStencilTable.cpp.o.d"
+  "/root/repo/opensubdiv/osd/cpuVertexBuffer.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuVertexBuffer.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/cpuVertexBuffer.cpp.o.d"
+  "/root/repo/opensubdiv/osd/dispatchEvaluator.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/dispatchEvaluator.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/dispatchEvaluator.cpp.o.d"
+  "/root/repo/opensubdiv/osd/ompEvaluator.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompEvaluator.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompEvaluator.cpp.o.d"
+  "/root/repo/opensubdiv/osd/ompKernel.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompKernel.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompKernel.cpp.o.d"
+  "/root/repo/opensubdiv/osd/ompStencilTable.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompStencilTable.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompStencilTable.cpp.o.d"
+  "/root/repo/opensubdiv/osd/ompTaskScheduler.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompTaskScheduler.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/ompTaskScheduler.cpp.o.d"
+  "/root/repo/opensubdiv/osd/programCache.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/programCache.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/programCache.cpp.o.d"
+  "/root/repo/opensubdiv/osd/splitEvaluator.cpp" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/splitEvaluator.cpp.o" "gcc" "opensubdiv/osd/CMakeFiles/osd_cpu_obj.dir/splitEvaluator.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,55 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/osd_cpu_obj.dir/cpuAvx2Kernel.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuAvx2Kernel.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuAvx512Kernel.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuAvx512Kernel.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuCompactStencilTable.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuCompactStencilTable.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuDisplacementTexture.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuDisplacementTexture.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuEvaluator.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuEvaluator.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuFaceLevelSelector.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuFaceLevelSelector.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuInstancedStencilTable.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuInstancedStencilTable.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuKernel.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuKernel.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPackedStencilTable.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPackedStencilTable.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPatchGridBasis.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPatchGridBasis.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPatchMap.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPatchMap.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPatchTable.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPatchTable.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPtexAdjacency.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuPtexAdjacency.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuSurfaceSampler.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuSurfaceSampler.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuTessellator.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuTessellator.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuVaryingStencilTable.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuVaryingStencilTable.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/cpuVertexBuffer.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/cpuVertexBuffer.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/dispatchEvaluator.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/dispatchEvaluator.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/ompEvaluator.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/ompEvaluator.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/ompKernel.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/ompKernel.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/ompStencilTable.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/ompStencilTable.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/ompTaskScheduler.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/ompTaskScheduler.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/programCache.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/programCache.cpp.o.d"
+  "CMakeFiles/osd_cpu_obj.dir/splitEvaluator.cpp.o"
+  "CMakeFiles/osd_cpu_obj.dir/splitEvaluator.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/osd_cpu_obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,78 @@
+# Install script for directory: /root/repo/opensubdiv/osd
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/usr/local")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "Release")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include/opensubdiv/osd" TYPE FILE PERMISSIONS OWNER_READ GROUP_READ WORLD_READ FILES
+    "/root/repo/opensubdiv/osd/bufferDescriptor.h"
+    "/root/repo/opensubdiv/osd/cpuCompactStencilTable.h"
+    "/root/repo/opensubdiv/osd/cpuDisplacementTexture.h"
+    "/root/repo/opensubdiv/osd/cpuEvaluator.h"
+    "/root/repo/opensubdiv/osd/cpuFaceLevelSelector.h"
+    "/root/repo/opensubdiv/osd/cpuFixedStencilKernel.h"
+    "/root/repo/opensubdiv/osd/cpuInstancedStencilTable.h"
+    "/root/repo/opensubdiv/osd/cpuPackedStencilTable.h"
+    "/root/repo/opensubdiv/osd/cpuPatchGridBasis.h"
+    "/root/repo/opensubdiv/osd/cpuPatchMap.h"
+    "/root/repo/opensubdiv/osd/cpuPatchTable.h"
+    "/root/repo/opensubdiv/osd/cpuPtexAdjacency.h"
+    "/root/repo/opensubdiv/osd/cpuSurfaceSampler.h"
+    "/root/repo/opensubdiv/osd/cpuTessellator.h"
+    "/root/repo/opensubdiv/osd/cpuVaryingStencilTable.h"
+    "/root/repo/opensubdiv/osd/cpuVertexBuffer.h"
+    "/root/repo/opensubdiv/osd/dispatchEvaluator.h"
+    "/root/repo/opensubdiv/osd/gpuTimer.h"
+    "/root/repo/opensubdiv/osd/mesh.h"
+    "/root/repo/opensubdiv/osd/nonCopyable.h"
+    "/root/repo/opensubdiv/osd/opengl.h"
+    "/root/repo/opensubdiv/osd/partitionedStencils.h"
+    "/root/repo/opensubdiv/osd/programCache.h"
+    "/root/repo/opensubdiv/osd/splitEvaluator.h"
+    "/root/repo/opensubdiv/osd/types.h"
+    "/root/repo/opensubdiv/osd/ompEvaluator.h"
+    "/root/repo/opensubdiv/osd/ompKernel.h"
+    "/root/repo/opensubdiv/osd/ompStencilTable.h"
+    "/root/repo/opensubdiv/osd/ompTaskScheduler.h"
+    )
+endif()
+
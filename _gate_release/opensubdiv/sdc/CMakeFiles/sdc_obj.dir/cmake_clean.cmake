@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sdc_obj.dir/crease.cpp.o"
+  "CMakeFiles/sdc_obj.dir/crease.cpp.o.d"
+  "CMakeFiles/sdc_obj.dir/typeTraits.cpp.o"
+  "CMakeFiles/sdc_obj.dir/typeTraits.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sdc_obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
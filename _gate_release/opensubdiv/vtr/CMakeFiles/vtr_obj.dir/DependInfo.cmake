@@ -0,0 +1,26 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/opensubdiv/vtr/arena.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/arena.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/arena.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/fvarLevel.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/fvarLevel.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/fvarLevel.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/fvarRefinement.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/fvarRefinement.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/fvarRefinement.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/level.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/level.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/level.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/quadRefinement.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/quadRefinement.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/quadRefinement.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/refinement.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/refinement.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/refinement.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/sparseSelector.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/sparseSelector.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/sparseSelector.cpp.o.d"
+  "/root/repo/opensubdiv/vtr/triRefinement.cpp" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/triRefinement.cpp.o" "gcc" "opensubdiv/vtr/CMakeFiles/vtr_obj.dir/triRefinement.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
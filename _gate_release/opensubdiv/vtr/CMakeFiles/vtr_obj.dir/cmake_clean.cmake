@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/vtr_obj.dir/arena.cpp.o"
+  "CMakeFiles/vtr_obj.dir/arena.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/fvarLevel.cpp.o"
+  "CMakeFiles/vtr_obj.dir/fvarLevel.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/fvarRefinement.cpp.o"
+  "CMakeFiles/vtr_obj.dir/fvarRefinement.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/level.cpp.o"
+  "CMakeFiles/vtr_obj.dir/level.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/quadRefinement.cpp.o"
+  "CMakeFiles/vtr_obj.dir/quadRefinement.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/refinement.cpp.o"
+  "CMakeFiles/vtr_obj.dir/refinement.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/sparseSelector.cpp.o"
+  "CMakeFiles/vtr_obj.dir/sparseSelector.cpp.o.d"
+  "CMakeFiles/vtr_obj.dir/triRefinement.cpp.o"
+  "CMakeFiles/vtr_obj.dir/triRefinement.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/vtr_obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression
+# Build directory: /root/repo/_gate_release/regression
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("common")
+subdirs("hbr_regression")
+subdirs("far_regression")
+subdirs("far_unit")
+subdirs("far_perf")
+subdirs("osd_perf")
+subdirs("osd_unit")
+subdirs("osd_pipeline")
+subdirs("shape_cache")
@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/regression_common_obj.dir/shape_utils.cpp.o"
+  "CMakeFiles/regression_common_obj.dir/shape_utils.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/regression_common_obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
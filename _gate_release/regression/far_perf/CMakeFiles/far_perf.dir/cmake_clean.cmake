@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/far_perf"
+  "../../bin/far_perf.pdb"
+  "CMakeFiles/far_perf.dir/far_perf.cpp.o"
+  "CMakeFiles/far_perf.dir/far_perf.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/far_perf.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
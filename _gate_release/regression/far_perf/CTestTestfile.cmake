@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression/far_perf
+# Build directory: /root/repo/_gate_release/regression/far_perf
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(far_perf "/root/repo/_gate_release/bin/far_regression")
+set_tests_properties(far_perf PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/regression/far_perf/CMakeLists.txt;49;add_test;/root/repo/regression/far_perf/CMakeLists.txt;0;")
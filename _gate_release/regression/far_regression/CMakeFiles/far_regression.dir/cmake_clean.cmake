@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/far_regression"
+  "../../bin/far_regression.pdb"
+  "CMakeFiles/far_regression.dir/far_regression.cpp.o"
+  "CMakeFiles/far_regression.dir/far_regression.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/far_regression.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
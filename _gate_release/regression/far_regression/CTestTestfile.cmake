@@ -0,0 +1,14 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression/far_regression
+# Build directory: /root/repo/_gate_release/regression/far_regression
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(far_regression_0 "/root/repo/_gate_release/bin/far_regression" "-partition" "0" "4" "-timing")
+set_tests_properties(far_regression_0 PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/regression/far_regression/CMakeLists.txt;51;add_test;/root/repo/regression/far_regression/CMakeLists.txt;0;")
+add_test(far_regression_1 "/root/repo/_gate_release/bin/far_regression" "-partition" "1" "4" "-timing")
+set_tests_properties(far_regression_1 PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/regression/far_regression/CMakeLists.txt;51;add_test;/root/repo/regression/far_regression/CMakeLists.txt;0;")
+add_test(far_regression_2 "/root/repo/_gate_release/bin/far_regression" "-partition" "2" "4" "-timing")
+set_tests_properties(far_regression_2 PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/regression/far_regression/CMakeLists.txt;51;add_test;/root/repo/regression/far_regression/CMakeLists.txt;0;")
+add_test(far_regression_3 "/root/repo/_gate_release/bin/far_regression" "-partition" "3" "4" "-timing")
+set_tests_properties(far_regression_3 PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/regression/far_regression/CMakeLists.txt;51;add_test;/root/repo/regression/far_regression/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/far_unit"
+  "../../bin/far_unit.pdb"
+  "CMakeFiles/far_unit.dir/far_unit.cpp.o"
+  "CMakeFiles/far_unit.dir/far_unit.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/far_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
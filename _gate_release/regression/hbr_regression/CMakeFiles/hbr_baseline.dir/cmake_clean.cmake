@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/hbr_baseline"
+  "../../bin/hbr_baseline.pdb"
+  "CMakeFiles/hbr_baseline.dir/baseline.cpp.o"
+  "CMakeFiles/hbr_baseline.dir/baseline.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hbr_baseline.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
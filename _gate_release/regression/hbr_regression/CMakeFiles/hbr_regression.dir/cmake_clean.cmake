@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/hbr_regression"
+  "../../bin/hbr_regression.pdb"
+  "CMakeFiles/hbr_regression.dir/main.cpp.o"
+  "CMakeFiles/hbr_regression.dir/main.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hbr_regression.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression/hbr_regression
+# Build directory: /root/repo/_gate_release/regression/hbr_regression
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
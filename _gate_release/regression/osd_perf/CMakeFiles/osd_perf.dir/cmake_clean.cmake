@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/osd_perf"
+  "../../bin/osd_perf.pdb"
+  "CMakeFiles/osd_perf.dir/osd_perf.cpp.o"
+  "CMakeFiles/osd_perf.dir/osd_perf.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/osd_perf.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression/osd_perf
+# Build directory: /root/repo/_gate_release/regression/osd_perf
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/examples/common/objAnim.cpp" "regression/osd_pipeline/CMakeFiles/osd_pipeline.dir/__/__/examples/common/objAnim.cpp.o" "gcc" "regression/osd_pipeline/CMakeFiles/osd_pipeline.dir/__/__/examples/common/objAnim.cpp.o.d"
+  "/root/repo/regression/osd_pipeline/osd_pipeline.cpp" "regression/osd_pipeline/CMakeFiles/osd_pipeline.dir/osd_pipeline.cpp.o" "gcc" "regression/osd_pipeline/CMakeFiles/osd_pipeline.dir/osd_pipeline.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_release/opensubdiv/CMakeFiles/osd_dynamic_cpu.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "../../bin/osd_pipeline"
+  "../../bin/osd_pipeline.pdb"
+  "CMakeFiles/osd_pipeline.dir/__/__/examples/common/objAnim.cpp.o"
+  "CMakeFiles/osd_pipeline.dir/__/__/examples/common/objAnim.cpp.o.d"
+  "CMakeFiles/osd_pipeline.dir/osd_pipeline.cpp.o"
+  "CMakeFiles/osd_pipeline.dir/osd_pipeline.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/osd_pipeline.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
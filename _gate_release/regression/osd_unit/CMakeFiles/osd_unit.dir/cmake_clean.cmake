@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/osd_unit"
+  "../../bin/osd_unit.pdb"
+  "CMakeFiles/osd_unit.dir/osd_unit.cpp.o"
+  "CMakeFiles/osd_unit.dir/osd_unit.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/osd_unit.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
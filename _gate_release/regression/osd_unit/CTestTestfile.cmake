@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression/osd_unit
+# Build directory: /root/repo/_gate_release/regression/osd_unit
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(osd_unit "/root/repo/_gate_release/bin/osd_unit" "-timing")
+set_tests_properties(osd_unit PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/regression/osd_unit/CMakeLists.txt;50;add_test;/root/repo/regression/osd_unit/CMakeLists.txt;0;")
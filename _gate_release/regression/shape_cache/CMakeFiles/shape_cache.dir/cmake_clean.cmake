@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/shape_cache"
+  "../../bin/shape_cache.pdb"
+  "CMakeFiles/shape_cache.dir/shape_cache.cpp.o"
+  "CMakeFiles/shape_cache.dir/shape_cache.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/shape_cache.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
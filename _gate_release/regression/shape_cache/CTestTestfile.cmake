@@ -0,0 +1,6 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/regression/shape_cache
+# Build directory: /root/repo/_gate_release/regression/shape_cache
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
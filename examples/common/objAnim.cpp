@@ -67,22 +67,54 @@ ObjAnim::InterpolatePositions(float time, float * positions, int stride) const {
         return;
     }
 
+    int key0, key1;
+    float b;
+    GetKeyframes(time, &key0, &key1, &b);
+
+    for (int i = 0; i <nverts; ++i) {
+
+        for (int j=0; j<3; ++j) {
+
+            float p0 = _positions[key0][i*3+j];
+            float p1 = _positions[key1][i*3+j];
+
+            positions[i*stride + j] = p0*(1-b) + p1*b;
+        }
+    }
+}
+
+void
+ObjAnim::GetKeyframes(float time, int * key0, int * key1, float * weight) const {
+
+    int nkeys = GetNumKeyframes();
+
+    if (nkeys<2) {
+        *key0 = *key1 = 0;
+        *weight = 0.0f;
+        return;
+    }
+
     const float fps = 24.0f;
 
     float p = fmodf(time * fps, (float)nkeys);
 
-    int key = (int)p;
-
-    float b = p - key;
+    *key0 = (int)p;
+    *key1 = (*key0+1)%nkeys;
+    *weight = p - *key0;
+}
 
-    for (int i = 0; i <nverts; ++i) {
+void
+ObjAnim::CopyKeyframes(float * positions, int stride) const {
 
-        for (int j=0; j<3; ++j) {
+    assert(positions);
 
-            float p0 = _positions[ key         ][i*3+j];
-            float p1 = _positions[(key+1)%nkeys][i*3+j];
+    for (int key = 0; key < GetNumKeyframes(); ++key) {
 
-            positions[i*stride + j] = p0*(1-b) + p1*b;
+        float const * vert = &_positions[key][0];
+        for (int i = 0; i < (int)_positions[key].size()/3; ++i) {
+             memcpy( positions, vert, sizeof(float)*3);
+             positions += stride;
+             vert += 3;
         }
     }
 }
@@ -43,6 +43,15 @@ public:
     // time.
     void InterpolatePositions(float time, float * positions, int stride) const;
 
+    // Returns the two key-frames to blend for a given time and the blend
+    // weight of the second one (see Osd::CpuEvaluator::BlendKeyframes).
+    void GetKeyframes(float time, int * key0, int * key1, float * weight) const;
+
+    // Populates 'positions' with the vertex data of all the key-frames, one
+    // key-frame after the other, so that they can be uploaded to the device
+    // once and blended there.
+    void CopyKeyframes(float * positions, int stride) const;
+
     // Number of key-frames in the animation
     int GetNumKeyframes() const {
         return (int)_positions.size();
@@ -32,6 +32,10 @@
 #include <cstring>
 #include <cassert>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
 // sample neighbor pixels and populate around blocks
 void
 PtexMipmapTextureLoader::Block::guttering(PtexMipmapTextureLoader *loader,
@@ -904,8 +908,14 @@ PtexMipmapTextureLoader::optimizePacking(int maxNumPages,
             _pages[firstslot+1]->IsFull()) ++firstslot;
     }
 
-    // set corner pixel mipmap factors
-    for (BlockArray::iterator it = _blocks.begin(); it != _blocks.end(); ++it) {
+    // set corner pixel mipmap factors (blocks are processed concurrently :
+    // the ptex reader is thread-safe)
+    int numBlocks = (int)_blocks.size();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for (int i = 0; i < numBlocks; ++i) {
+        Block *it = &_blocks[i];
         int face = it->index;
         uint16_t adjSizeDiffs = 0;
         for (int edge = 0; edge < 4; ++edge) {
@@ -949,6 +959,11 @@ PtexMipmapTextureLoader::generateBuffers()
     _memoryUsage = pageStride * numPages;
     memset(_texelBuffer, 0, pageStride * numPages);
 
+    // pages are filled concurrently : each writes its own texels, and the
+    // guttering only reads the ptex data of the neighboring faces
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
     for (int i = 0; i < numPages; ++i) {
         _pages[i]->Generate(this, _ptex, _texelBuffer + pageStride * i,
                             _bpp, _pageWidth, _maxLevels);
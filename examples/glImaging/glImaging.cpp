@@ -72,6 +72,7 @@
 #include "../common/patchColors.h"
 #include "../common/stb_image_write.h"    // common.obj has an implementation.
 #include "../common/glShaderCache.h"
+#include "../common/stopwatch.h"
 #include "init_shapes.h"
 
 using namespace OpenSubdiv;
@@ -278,9 +279,32 @@ createOsdMesh(std::string const &kernel,
     exit(1);
 }
 
+// ---------------------------------------------------------------------------
+
+// timings and patch statistics of a test, averaged over its repetitions
+struct PerfResult {
+
+    PerfResult() : evalCpuTime(0), evalGpuTime(0), drawGpuTime(0),
+                   numPrimitives(0) {
+        memset(patchCount, 0, sizeof(patchCount));
+    }
+
+    float evalCpuTime,   // Refine() + Synchronize(), in ms
+          evalGpuTime,   // GPU time elapsed in Refine(), in ms
+          drawGpuTime;   // GPU time elapsed in the draw calls, in ms
+
+    GLuint numPrimitives;
+
+    int patchCount[Far::PatchDescriptor::GREGORY_BASIS+1]; // [Type]
+};
+
+static const char *patchTypeNames[Far::PatchDescriptor::GREGORY_BASIS+1] = {
+    "NON_PATCH", "POINTS", "LINES", "QUADS", "TRIANGLES", "LOOP",
+    "REGULAR", "GREGORY", "GREGORY_BOUNDARY", "GREGORY_BASIS" };
+
 void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
-             int level, bool adaptive,
-             ShaderCache *shaderCache) {
+             int level, bool adaptive, Osd::MeshBits endCap, int repeats,
+             ShaderCache *shaderCache, PerfResult *result) {
 
     std::cout << "Testing " << shapeDesc.name << ", kernel = " << kernel << "\n";
 
@@ -307,7 +331,7 @@ void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
     bits.set(Osd::MeshUseSingleCreasePatch, doSingleCreasePatch);
     bits.set(Osd::MeshInterleaveVarying, interleaveVarying);
     bits.set(Osd::MeshFVarData, false);
-    bits.set(Osd::MeshEndCapGregoryBasis, true);
+    bits.set(endCap, true);
 
     int numVertexElements = 3 + 4; // XYZ, RGBA (interleaved)
     int numVaryingElements = 0;
@@ -356,12 +380,28 @@ void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
     }
     mesh->UpdateVertexBuffer(&vertex[0], 0, nverts);
 
-    // refine
-    mesh->Refine();
+    GLuint queries[2];
+    glGenQueries(2, queries);
 
-    // draw
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // refine
+    Stopwatch s;
+    for (int r = 0; r < repeats; ++r) {
+#if defined(GL_VERSION_3_3)
+        glBeginQuery(GL_TIME_ELAPSED, queries[1]);
+#endif
+        s.Start();
+        mesh->Refine();
+        mesh->Synchronize();
+        s.Stop();
+#if defined(GL_VERSION_3_3)
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint timeElapsed = 0;
+        glGetQueryObjectuiv(queries[1], GL_QUERY_RESULT, &timeElapsed);
+        result->evalGpuTime += timeElapsed / 1000.0f / 1000.0f / repeats;
+#endif
+    }
+    result->evalCpuTime = float(s.GetTotalElapsed() * 1000.0f / repeats);
 
     GLuint vao;
     glGenVertexArrays(1, &vao);
@@ -389,11 +429,17 @@ void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
     Osd::PatchArrayVector const & patches =
         mesh->GetPatchTable()->GetPatchArrays();
 
+    // compile the shaders and set their uniforms ahead of the timed draws
+    std::vector<GLuint> programs(patches.size());
+    std::vector<GLenum> primTypes(patches.size());
+
     for (int i=0; i<(int)patches.size(); ++i) {
         Osd::PatchArray const & patch = patches[i];
         Far::PatchDescriptor desc = patch.GetDescriptor();
         Far::PatchDescriptor::Type patchType = desc.GetType();
 
+        result->patchCount[patchType] += patch.GetNumPatches();
+
         GLenum primType;
         switch(patchType) {
         case Far::PatchDescriptor::QUADS:
@@ -404,11 +450,9 @@ void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
             break;
         default:
             primType = GL_PATCHES;
-            glPatchParameteri(GL_PATCH_VERTICES, desc.GetNumControlVertices());
         }
 
         GLuint program = shaderCache->GetDrawConfig(desc)->GetProgram();
-        glUseProgram(program);
 
         GLuint diffuseColor =
             glGetUniformLocation(program, "diffuseColor");
@@ -425,10 +469,47 @@ void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
             glProgramUniform4f(program, diffuseColor, 0.4f, 0.4f, 0.8f, 1);
         }
 
-        glDrawElements(primType,
-                       patch.GetNumPatches() * desc.GetNumControlVertices(),
-                       GL_UNSIGNED_INT,
-                       (void *)(patch.GetIndexBase() * sizeof(unsigned int)));
+        programs[i] = program;
+        primTypes[i] = primType;
+    }
+
+    // draw
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0);
+
+    for (int r = 0; r < repeats; ++r) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glBeginQuery(GL_PRIMITIVES_GENERATED, queries[0]);
+#if defined(GL_VERSION_3_3)
+        glBeginQuery(GL_TIME_ELAPSED, queries[1]);
+#endif
+
+        for (int i=0; i<(int)patches.size(); ++i) {
+            Osd::PatchArray const & patch = patches[i];
+            Far::PatchDescriptor desc = patch.GetDescriptor();
+
+            if (primTypes[i] == GL_PATCHES) {
+                glPatchParameteri(GL_PATCH_VERTICES,
+                                  desc.GetNumControlVertices());
+            }
+            glUseProgram(programs[i]);
+
+            glDrawElements(primTypes[i],
+                           patch.GetNumPatches() * desc.GetNumControlVertices(),
+                           GL_UNSIGNED_INT,
+                           (void *)(patch.GetIndexBase() * sizeof(unsigned int)));
+        }
+
+        glEndQuery(GL_PRIMITIVES_GENERATED);
+#if defined(GL_VERSION_3_3)
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint timeElapsed = 0;
+        glGetQueryObjectuiv(queries[1], GL_QUERY_RESULT, &timeElapsed);
+        result->drawGpuTime += timeElapsed / 1000.0f / 1000.0f / repeats;
+#endif
+        glGetQueryObjectuiv(queries[0], GL_QUERY_RESULT,
+                            &result->numPrimitives);
     }
 
     glDisableVertexAttribArray(0);
@@ -436,6 +517,7 @@ void runTest(ShapeDesc const &shapeDesc, std::string const &kernel,
 
     glBindVertexArray(0);
     glDeleteVertexArrays(1, &vao);
+    glDeleteQueries(2, queries);
 
     // cleanup
     delete shape;
@@ -449,25 +531,85 @@ static void usage(const char *program) {
         << "Usage %s : " << program << "\n"
         << "   -a                      : adaptive refinement\n"
         << "   -l <isolation level>    : isolation level (default = 2)\n"
-        << "   -t <tess level>         : tessellation level (default = 1)\n"
+        << "   -t <tess>,<tess>...     : tessellation levels (default = 1)\n"
         << "   -w <prefix>             : write images to PNG as\n"
         << "                             <prefix>_<kernel>_modelname.png\n"
         << "   -s <width> <height>     : image size (default = 128 128)\n"
         << "   -k <kernel>,<kernel>... : kernel types (default = all)\n"
         << "      kernel = [CPU, OPENMP, TBB, CUDA, CL, XFB, GLSL]\n"
         << "   -d <displayMode>        : display mode\n"
-        << "      displayMode = [PATCH_TYPE, VARYING, NORMAL]\n";
+        << "      displayMode = [PATCH_TYPE, VARYING, NORMAL]\n"
+        << "   -e <endcap>,<endcap>... : end cap types (default = GREGORY)\n"
+        << "      endcap = [BSPLINE, GREGORY]\n"
+        << "   -r <repeats>            : timed repetitions of each test\n"
+        << "                             (default = 1)\n"
+        << "   -j <file>               : write timings and patch counts to\n"
+        << "                             a JSON file. The window is hidden\n"
+        << "                             unless images are written (-w)\n"
+        << "\n"
+        << "   Images are written for the first end cap and tess level\n"
+        << "   only, the JSON report covers all the combinations.\n";
+}
+
+static bool
+parseEndCap(std::string const &name, Osd::MeshBits *endCap) {
+    if (name == "BSPLINE") {
+        *endCap = Osd::MeshEndCapBSplineBasis;
+    } else if (name == "GREGORY") {
+        *endCap = Osd::MeshEndCapGregoryBasis;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static std::string
+jsonString(char const *str) {
+    std::string result = "\"";
+    for (; str and *str; ++str) {
+        if (*str == '"' or *str == '\\') result += '\\';
+        result += *str;
+    }
+    return result + "\"";
+}
+
+static void
+writeJSONResult(std::ostream &os, ShapeDesc const &shapeDesc,
+                std::string const &kernel, std::string const &endCap,
+                int tessLevel, PerfResult const &result) {
+
+    os << "    { \"shape\": " << jsonString(shapeDesc.name.c_str())
+       << ", \"kernel\": " << jsonString(kernel.c_str())
+       << ", \"endCap\": " << jsonString(endCap.c_str())
+       << ", \"tessLevel\": " << tessLevel << ",\n"
+       << "      \"evalCpuMs\": " << result.evalCpuTime
+       << ", \"evalGpuMs\": " << result.evalGpuTime
+       << ", \"drawGpuMs\": " << result.drawGpuTime
+       << ", \"primitives\": " << result.numPrimitives << ",\n"
+       << "      \"patches\": {";
+
+    const char *separator = " ";
+    for (int i = 0; i <= Far::PatchDescriptor::GREGORY_BASIS; ++i) {
+        if (result.patchCount[i] == 0) continue;
+        os << separator << jsonString(patchTypeNames[i])
+           << ": " << result.patchCount[i];
+        separator = ", ";
+    }
+    os << " } }";
 }
 
 int main(int argc, char ** argv) {
 
     int width = 128;
     int height = 128;
-    int tessLevel = 1;
     int isolationLevel = 2;
+    int repeats = 1;
     bool writeToFile = false;
     bool adaptive = false;
     std::string prefix;
+    std::string jsonFile;
+    std::vector<int> tessLevels;
+    std::vector<std::string> endCaps;
     std::string displayMode = "PATCH_TYPE";
     std::vector<std::string> kernels;
 
@@ -483,7 +625,26 @@ int main(int argc, char ** argv) {
                 kernels.push_back(kernel);
             }
         } else if (!strcmp(argv[i], "-t")) {
-            tessLevel = atoi(argv[++i]);
+            std::stringstream ss(argv[++i]);
+            std::string tessLevel;
+            while(std::getline(ss, tessLevel, ',')) {
+                tessLevels.push_back(atoi(tessLevel.c_str()));
+            }
+        } else if (!strcmp(argv[i], "-e")) {
+            std::stringstream ss(argv[++i]);
+            std::string endCap;
+            while(std::getline(ss, endCap, ',')) {
+                Osd::MeshBits bit;
+                if (not parseEndCap(endCap, &bit)) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                endCaps.push_back(endCap);
+            }
+        } else if (!strcmp(argv[i], "-r")) {
+            repeats = std::max(1, atoi(argv[++i]));
+        } else if (!strcmp(argv[i], "-j")) {
+            jsonFile = argv[++i];
         } else if (!strcmp(argv[i], "-w")) {
             writeToFile = true;
             prefix = argv[++i];
@@ -498,6 +659,13 @@ int main(int argc, char ** argv) {
         }
     }
 
+    if (tessLevels.empty()) {
+        tessLevels.push_back(1);
+    }
+    if (endCaps.empty()) {
+        endCaps.push_back("GREGORY");
+    }
+
     // by default, test all available kernels
     if (kernels.empty()) {
         kernels.push_back("CPU");
@@ -531,6 +699,11 @@ int main(int argc, char ** argv) {
 
     GLUtils::SetMinimumGLVersion();
 
+    // performance captures only do not need a visible window
+    if (not writeToFile) {
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    }
+
     GLFWwindow *window = glfwCreateWindow(width, height, windowTitle, NULL, NULL);
     if (not window) {
         std::cerr << "Failed to create OpenGL context.\n";
@@ -588,7 +761,7 @@ int main(int argc, char ** argv) {
     transformData.Viewport[1] = 0;
     transformData.Viewport[2] = static_cast<float>(width);
     transformData.Viewport[3] = static_cast<float>(height);
-    transformData.TessLevel = static_cast<float>(1 << tessLevel);
+    transformData.TessLevel = static_cast<float>(1 << tessLevels[0]);
 
     GLuint transformUB = 0;
     glGenBuffers(1, &transformUB);
@@ -620,7 +793,8 @@ int main(int argc, char ** argv) {
             << ", " << glGetString(GL_RENDERER)
             << "\n";
         ofs << "Isolation Level : " << isolationLevel << "\n";
-        ofs << "Tess Level      : " << tessLevel << "\n";
+        ofs << "Tess Level      : " << tessLevels[0] << "\n";
+        ofs << "End Cap         : " << endCaps[0] << "\n";
         ofs << "Adaptive        : " << adaptive << "\n";
         ofs << "Display Mode    : " << displayMode << "\n";
         ofs << "</pre>\n";
@@ -648,6 +822,9 @@ int main(int argc, char ** argv) {
         ofs.close();
     }
 
+    std::stringstream jsonResults;
+    int numResults = 0;
+
     // run test
     for (size_t k = 0; k < kernels.size(); ++k) {
         std::string const &kernel = kernels[k];
@@ -673,24 +850,71 @@ int main(int argc, char ** argv) {
             }
         }
 #endif
-        for (size_t i = 0; i < g_shapes.size(); ++i) {
-            // run test
-            runTest(g_shapes[i], kernel, isolationLevel, adaptive, &shaderCache);
-
-            if (writeToFile) {
-                // read back pixels
-                std::vector<unsigned char> data(width*height*3);
-                glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, &data[0]);
-
-                // write image
-                std::string filename = prefix + "_" + kernel + "_" + g_shapes[i].name + ".png";
-                // flip vertical
-                stbi_write_png(filename.c_str(), width, height, 3, &data[width*3*(height-1)], -width*3);
-            }
+        // sweep the end caps and the tess levels
+        for (size_t c = 0; c < endCaps.size() * tessLevels.size(); ++c) {
+            size_t e = c / tessLevels.size(),
+                   t = c % tessLevels.size();
+
+            Osd::MeshBits endCap;
+            parseEndCap(endCaps[e], &endCap);
+
+            transformData.TessLevel = static_cast<float>(1 << tessLevels[t]);
+            glBindBuffer(GL_UNIFORM_BUFFER, transformUB);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(transformData),
+                            &transformData);
+
+            // images of the first configuration only (see the html report)
+            bool writeImages = writeToFile and e == 0 and t == 0;
+
+            for (size_t i = 0; i < g_shapes.size(); ++i) {
+                // run test
+                PerfResult result;
+                runTest(g_shapes[i], kernel, isolationLevel, adaptive,
+                        endCap, repeats, &shaderCache, &result);
+
+                if (writeImages) {
+                    // read back pixels
+                    std::vector<unsigned char> data(width*height*3);
+                    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, &data[0]);
+
+                    // write image
+                    std::string filename = prefix + "_" + kernel + "_" + g_shapes[i].name + ".png";
+                    // flip vertical
+                    stbi_write_png(filename.c_str(), width, height, 3, &data[width*3*(height-1)], -width*3);
+                }
+
+                if (not jsonFile.empty()) {
+                    if (numResults++ > 0) jsonResults << ",\n";
+                    writeJSONResult(jsonResults, g_shapes[i], kernel,
+                                    endCaps[e], tessLevels[t], result);
+                }
 
-            glfwSwapBuffers(window);
+                glfwSwapBuffers(window);
+            }
         }
     }
 
+    // write performance report
+    if (not jsonFile.empty()) {
+        std::ofstream ofs(jsonFile.c_str());
+
+        ofs << "{\n"
+            << "  \"opensubdiv\": " << jsonString(OPENSUBDIV_VERSION_STRING) << ",\n"
+            << "  \"glVersion\": "
+            << jsonString((const char *)glGetString(GL_VERSION)) << ",\n"
+            << "  \"glVendor\": "
+            << jsonString((const char *)glGetString(GL_VENDOR)) << ",\n"
+            << "  \"glRenderer\": "
+            << jsonString((const char *)glGetString(GL_RENDERER)) << ",\n"
+            << "  \"isolationLevel\": " << isolationLevel << ",\n"
+            << "  \"adaptive\": " << (adaptive ? "true" : "false") << ",\n"
+            << "  \"repeats\": " << repeats << ",\n"
+            << "  \"results\": [\n"
+            << jsonResults.str() << "\n"
+            << "  ]\n"
+            << "}\n";
+        ofs.close();
+    }
+
     return 0;
 }
@@ -53,6 +53,7 @@ static const char *paintShaderSource =
 ;
 
 #include <cfloat>
+#include <cstdio>
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -112,7 +113,15 @@ GLuint g_ptexPages = 0,
     g_ptexLayouts = 0,
     g_ptexTexels = 0;
 
-int g_pageSize = 512;
+int g_pageSize = 512,
+    g_numPages = 0;
+
+// one flag per page, set by the paint shader : only the pages painted since
+// the last save are read back and written
+GLuint g_dirtyPagesBuffer = 0,
+    g_dirtyPages = 0;
+
+static const char * g_savePagesFile = "glPaintTest.pages";
 
 struct SimpleShape {
     std::string  name;
@@ -299,6 +308,24 @@ createOsdMesh() {
 
     glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
+    // dirty page flags (the buffer is kept to read the flags back)
+    if (g_dirtyPages) glDeleteTextures(1, &g_dirtyPages);
+    if (g_dirtyPagesBuffer) glDeleteBuffers(1, &g_dirtyPagesBuffer);
+
+    g_numPages = numPtexFaces;
+
+    std::vector<GLuint> dirty(numPtexFaces, 0);
+    glGenBuffers(1, &g_dirtyPagesBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, g_dirtyPagesBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, numPtexFaces * sizeof(GLuint),
+                 &dirty[0], GL_DYNAMIC_READ);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &g_dirtyPages);
+    glBindTexture(GL_TEXTURE_BUFFER, g_dirtyPages);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, g_dirtyPagesBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
     checkGLErrors("create osd exit");
 }
 
@@ -454,6 +481,9 @@ public:
             if ((loc = glGetUniformLocation(program, "outTextureImage")) != -1) {
                 glUniform1i(loc, 0); // image 0
             }
+            if ((loc = glGetUniformLocation(program, "dirtyPages")) != -1) {
+                glUniform1i(loc, 1); // image 1
+            }
             if ((loc = glGetUniformLocation(program, "paintTexture")) != -1) {
                 glUniform1i(loc, 5); // GL_TEXTURE5
             }
@@ -552,6 +582,7 @@ static void bindTextures(Effect effect) {
     if (effect.paint) {
         // set image
         glBindImageTexture(0, g_ptexTexels, 0, GL_TRUE, 0, GL_READ_WRITE, GL_R32F);
+        glBindImageTexture(1, g_dirtyPages, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32UI);
 
         glActiveTexture(GL_TEXTURE5);
         glBindTexture(GL_TEXTURE_2D, g_paintTexture);
@@ -903,6 +934,67 @@ void windowClose(GLFWwindow*) {
     g_running = false;
 }
 
+//------------------------------------------------------------------------------
+// Appends the texels of the pages painted since the last save to the pages
+// file (a page index, the page size and its texels for each page), then
+// clears their dirty flags
+static void
+savePaintedPages() {
+
+    if (not g_dirtyPagesBuffer or g_numPages == 0) return;
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT |
+                    GL_FRAMEBUFFER_BARRIER_BIT);
+
+    std::vector<GLuint> dirty(g_numPages);
+    glBindBuffer(GL_TEXTURE_BUFFER, g_dirtyPagesBuffer);
+    glGetBufferSubData(GL_TEXTURE_BUFFER, 0, g_numPages * sizeof(GLuint), &dirty[0]);
+
+    FILE * file = fopen(g_savePagesFile, "ab");
+    if (not file) {
+        printf("Cannot open %s\n", g_savePagesFile);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        return;
+    }
+
+    // each page is a layer of the texels array, read back through a framebuffer
+    GLuint fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    std::vector<float> texels(g_pageSize * g_pageSize);
+
+    int numSaved = 0;
+    for (int page = 0; page < g_numPages; ++page) {
+        if (not dirty[page]) continue;
+
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  g_ptexTexels, 0, page);
+        glReadPixels(0, 0, g_pageSize, g_pageSize, GL_RED, GL_FLOAT, &texels[0]);
+
+        fwrite(&page, sizeof(int), 1, file);
+        fwrite(&g_pageSize, sizeof(int), 1, file);
+        fwrite(&texels[0], sizeof(float), texels.size(), file);
+
+        dirty[page] = 0;
+        ++numSaved;
+    }
+    fclose(file);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+
+    if (numSaved) {
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, g_numPages * sizeof(GLuint), &dirty[0]);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    printf("Saved %d of %d pages to %s\n", numSaved, g_numPages, g_savePagesFile);
+
+    checkGLErrors("save painted pages");
+}
+
 //------------------------------------------------------------------------------
 static void
 toggleFullScreen() {
@@ -919,6 +1011,7 @@ keyboard(GLFWwindow *, int key, int /* scancode */, int event, int /* mods */) {
     switch (key) {
         case 'Q': g_running = 0; break;
         case 'F': fitFrame(); break;
+        case 'S': savePaintedPages(); break;
         case GLFW_KEY_TAB: toggleFullScreen(); break;
         case '+':
         case '=':  g_tessLevel++; break;
@@ -186,6 +186,7 @@ in block {
 } inpt;
 
 layout(size1x32) uniform image2DArray outTextureImage;
+layout(r32ui) uniform writeonly uimageBuffer dirtyPages;
 uniform sampler2D paintTexture;
 uniform sampler2D depthTexture;
 uniform int imageSize = 256;
@@ -211,6 +212,9 @@ main()
     vec4 d = imageLoad(outTextureImage, pos);
     c = c + d;
     imageStore(outTextureImage, pos, c);
+
+    // flag the page for the next save
+    imageStore(dirtyPages, pos.z, uvec4(1));
     discard;
 }
 
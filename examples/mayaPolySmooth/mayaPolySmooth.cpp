@@ -51,6 +51,8 @@
 #include <maya/MUintArray.h>
 
 #include <maya/MFnPlugin.h>
+#include <maya/MThreadAsync.h>
+#include <maya/MMutexLock.h>
 
 #include <cassert>
 #include <map>
@@ -63,10 +65,40 @@
 #include <far/topologyDescriptor.h>
 #include <far/stencilTableFactory.h>
 #include <far/primvarRefiner.h>
+#include <far/topologyFingerprint.h>
 
 #include <osd/mesh.h>
 #include <osd/cpuVertexBuffer.h>
 
+#if defined(OPENSUBDIV_HAS_TBB)
+    #include <osd/tbbEvaluator.h>
+    #include <osd/tbbTaskScheduler.h>
+#elif defined(OPENSUBDIV_HAS_OPENMP)
+    #include <osd/ompEvaluator.h>
+    #include <osd/ompTaskScheduler.h>
+#else
+    #include <osd/cpuEvaluator.h>
+    #include <far/taskScheduler.h>
+#endif
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+// Multithreaded evaluator and scheduler of the cached topologies
+#if defined(OPENSUBDIV_HAS_TBB)
+    typedef OpenSubdiv::Osd::TbbEvaluator       Evaluator;
+    typedef OpenSubdiv::Osd::TbbTaskScheduler   Scheduler;
+#elif defined(OPENSUBDIV_HAS_OPENMP)
+    typedef OpenSubdiv::Osd::OmpEvaluator       Evaluator;
+    typedef OpenSubdiv::Osd::OmpTaskScheduler   Scheduler;
+#else
+    typedef OpenSubdiv::Osd::CpuEvaluator       Evaluator;
+    typedef OpenSubdiv::Far::SerialTaskScheduler Scheduler;
+#endif
+
 
 // ====================================
 // Static Initialization
@@ -156,12 +188,149 @@ ConvertMayaFVarBoundary(short boundaryMethod, bool propagateCorner) {
 
 #define CHANNELCOLOR 1
 
+// ====================================
+// Cached Topology
+// ====================================
+
+typedef OpenSubdiv::Far::TopologyFingerprint::Hash TopologyHash;
+
+// Number of stencil tables being built in the background : the plugin
+// cannot be unloaded before their completion
+static int g_pendingBuilds = 0;
+static MMutexLock g_pendingBuildsLock;
+
+// The refiner of a topology is shared by the node and the background build of
+// the stencil table of its finest level : both release their reference when
+// done with it.
+struct MayaPolySmooth::Topology {
+
+    Topology(TopologyHash hash, OpenSubdiv::Far::TopologyRefiner const * refiner) :
+        hash(hash), refiner(refiner), _vertexStencils(0), _refCount(1) { }
+
+    ~Topology() {
+        delete _vertexStencils;
+        delete refiner;
+    }
+
+    void Retain() {
+        _lock.lock();
+        ++_refCount;
+        _lock.unlock();
+    }
+
+    void Release() {
+        _lock.lock();
+        bool unused = (--_refCount == 0);
+        _lock.unlock();
+        if (unused) {
+            delete this;
+        }
+    }
+
+    // Returns the stencils of the finest level, or NULL until they are built
+    OpenSubdiv::Far::StencilTable const * GetVertexStencils() {
+        _lock.lock();
+        OpenSubdiv::Far::StencilTable const * stencils = _vertexStencils;
+        _lock.unlock();
+        return stencils;
+    }
+
+    void SetVertexStencils(OpenSubdiv::Far::StencilTable const * stencils) {
+        _lock.lock();
+        _vertexStencils = stencils;
+        _lock.unlock();
+    }
+
+    TopologyHash const hash;
+
+    OpenSubdiv::Far::TopologyRefiner const * const refiner;
+
+private:
+    OpenSubdiv::Far::StencilTable const * _vertexStencils;
+    int _refCount;
+    MMutexLock _lock;
+};
+
+// Builds the stencil table of the finest level of a topology on a Maya
+// asynchronous thread
+static MThreadRetVal
+buildVertexStencils(void * data) {
+
+    MayaPolySmooth::Topology * topology =
+        static_cast<MayaPolySmooth::Topology *>(data);
+
+    Scheduler scheduler;
+
+    OpenSubdiv::Far::StencilTableFactory::Options options;
+    options.generateOffsets = true;
+    options.generateIntermediateLevels = false;
+    options.maxLevel = topology->refiner->GetMaxLevel();
+    options.taskScheduler = &scheduler;
+
+    topology->SetVertexStencils(
+        OpenSubdiv::Far::StencilTableFactory::Create(*topology->refiner, options));
+    topology->Release();
+
+    g_pendingBuildsLock.lock();
+    --g_pendingBuilds;
+    g_pendingBuildsLock.unlock();
+
+    return 0;
+}
+
+static void
+buildVertexStencilsDone(void *) { }
+
+static void
+launchVertexStencilsBuild(MayaPolySmooth::Topology * topology) {
+
+    topology->Retain();
+
+    g_pendingBuildsLock.lock();
+    ++g_pendingBuilds;
+    g_pendingBuildsLock.unlock();
+
+    if (MThreadAsync::createTask(buildVertexStencils, topology,
+            buildVertexStencilsDone, NULL) != MS::kSuccess) {
+
+        // positions keep being interpolated level by level
+        MGlobal::displayWarning("Failed to launch the build of the stencil table.");
+        g_pendingBuildsLock.lock();
+        --g_pendingBuilds;
+        g_pendingBuildsLock.unlock();
+        topology->Release();
+    }
+}
+
+static void
+waitForVertexStencilsBuilds() {
+
+    for (;;) {
+        g_pendingBuildsLock.lock();
+        int pending = g_pendingBuilds;
+        g_pendingBuildsLock.unlock();
+        if (pending == 0) {
+            break;
+        }
+#if defined(_WIN32)
+        Sleep(1);
+#else
+        usleep(1000);
+#endif
+    }
+}
+
 // ====================================
 // Constructors/Destructors
 // ====================================
-MayaPolySmooth::MayaPolySmooth() {}
+MayaPolySmooth::MayaPolySmooth() : _topology(0) {}
 
-MayaPolySmooth::~MayaPolySmooth() {}
+MayaPolySmooth::~MayaPolySmooth() {
+
+    if (_topology) {
+        _topology->Release();
+    }
+}
 
 
 // ====================================
@@ -306,12 +475,12 @@ getMayaFvarFieldParams(
 }
 
 
-//! Caller is expected to delete the returned value
-static OpenSubdiv::Far::TopologyRefiner *
+//! Caller is expected to release the arrays of the descriptor with
+//! releaseTopology()
+static void
 gatherTopology( MFnMesh & inMeshFn,
                 MItMeshPolygon & inMeshItPolygon,
-                OpenSubdiv::Sdc::SchemeType type,
-                OpenSubdiv::Sdc::Options options,
+                Descriptor & desc,
                 bool * hasUVs, bool * hasColors,
                 std::vector<MFloatArray> & uvSet_uCoords,
                 std::vector<MFloatArray> & uvSet_vCoords,
@@ -337,8 +506,6 @@ gatherTopology( MFnMesh & inMeshFn,
     colorSet_colors.clear();colorSet_colors.resize(colorSetNames.length());
 
     // Put the data in the format needed for OSD
-    Descriptor desc;
-    
     int numFaceVertices = inMeshFn.numFaceVertices();
 
     desc.numVertices = inMeshFn.numVertices();
@@ -436,9 +603,13 @@ gatherTopology( MFnMesh & inMeshFn,
     float maxEdgeCrease = getCreaseEdges( inMeshFn, desc );
     float maxVertexCrease = getCreaseVertices( inMeshFn, desc );
 
-    OpenSubdiv::Far::TopologyRefiner * refiner =
-        OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Create(desc,
-            OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>::Options(type, options));
+    if (maxCreaseSharpness) {
+        *maxCreaseSharpness = std::max(maxEdgeCrease, maxVertexCrease);
+    }
+}
+
+static void
+releaseTopology( Descriptor & desc ) {
 
     delete [] desc.numVertsPerFace;
     delete [] desc.vertIndicesPerFace;
@@ -447,18 +618,10 @@ gatherTopology( MFnMesh & inMeshFn,
     delete [] desc.cornerVertexIndices;
     delete [] desc.cornerWeights;
 
-    if (*hasUVs || *hasColors) {
-        for(int i = 0 ; i < desc.numFVarChannels ; i ++) {
-            delete [] channels[i].valueIndices;
-        }
-        delete [] channels;
-    }
-
-    if (maxCreaseSharpness) {
-        *maxCreaseSharpness = std::max(maxEdgeCrease, maxVertexCrease);
+    for(int i = 0 ; i < desc.numFVarChannels ; i ++) {
+        delete [] desc.fvarChannels[i].valueIndices;
     }
-
-    return refiner;
+    delete [] desc.fvarChannels;
 }
 
 static inline int
@@ -625,9 +788,20 @@ struct FVarVertexColor {
     float r,g,b,a;
 };
 
+// Binds memory to the Osd evaluators as source or destination buffer
+struct RawCpuBuffer {
+
+    RawCpuBuffer(float * data) : _data(data) { }
+
+    float * BindCpuBuffer() { return _data; }
+
+private:
+    float * _data;
+};
+
 static MStatus
 convertToMayaMeshData(OpenSubdiv::Far::TopologyRefiner const & refiner,
-    std::vector<Vertex> const & refinedVerts,
+    Vertex const * finestVerts,
     bool hasUVs, std::vector<FVarVertexUV> const & refinedUVs,
     bool hasColors, std::vector<FVarVertexColor> const & refinedColors,
     MFnMesh & inMeshFn, MObject newMeshDataObj) {
@@ -662,13 +836,10 @@ convertToMayaMeshData(OpenSubdiv::Far::TopologyRefiner const & refiner,
 
     // Points
     int nverts = refLastLevel.GetNumVertices();
-    int firstOfLastVert = refiner.GetNumVerticesTotal() 
-                        - nverts 
-                        - refiner.GetLevel(0).GetNumVertices();
 
     MFloatPointArray points(nverts);
     for (int vIt = 0; vIt < nverts; ++vIt) {
-        Vertex const & v = refinedVerts[firstOfLastVert + vIt];
+        Vertex const & v = finestVerts[vIt];
         points.set(vIt, v.position[0], v.position[1], v.position[2]);
     }
 
@@ -834,20 +1005,65 @@ MayaPolySmooth::compute( const MPlug& plug, MDataBlock& data ) {
 
             bool hasUVs = false, hasColors = false;
             float maxCreaseSharpness=0.0f;
-            OpenSubdiv::Far::TopologyRefiner * refiner = gatherTopology(
-                inMeshFn, inMeshItPolygon, type, options, &hasUVs, &hasColors,
+            Descriptor desc;
+            gatherTopology(inMeshFn, inMeshItPolygon, desc, &hasUVs, &hasColors,
                 uvSet_uCoords, uvSet_vCoords, colorSet_colors, &maxCreaseSharpness);
 
-            assert(refiner);
+            // == Refine (unless the topology is unchanged) ====================
+            typedef OpenSubdiv::Far::TopologyRefinerFactory<Descriptor> RefinerFactory;
+            typedef OpenSubdiv::Far::TopologyFingerprint Fingerprint;
 
-            // == Refine & Interpolate ==========================
-            refiner->RefineUniform(OpenSubdiv::Far::TopologyRefiner::UniformOptions(subdivisionLevel));
+            RefinerFactory::Options refinerOptions(type, options);
+            OpenSubdiv::Far::TopologyRefiner::UniformOptions
+                uniformOptions(subdivisionLevel);
+
+            Scheduler scheduler;
+            TopologyHash hash = Fingerprint::Combine(
+                Fingerprint::Compute(desc, refinerOptions, &scheduler), uniformOptions);
+
+            if ((not _topology) or (_topology->hash != hash)) {
+
+                OpenSubdiv::Far::TopologyRefiner * refiner =
+                    RefinerFactory::Create(desc, refinerOptions);
+                assert(refiner);
+                refiner->RefineUniform(uniformOptions);
+
+                if (_topology) {
+                    _topology->Release();
+                }
+                _topology = new Topology(hash, refiner);
+
+                // positions are interpolated level by level until the
+                // stencils are available
+                launchVertexStencilsBuild(_topology);
+            }
+            releaseTopology(desc);
+
+            OpenSubdiv::Far::TopologyRefiner const * refiner = _topology->refiner;
 
             // Prepare vertex information
             Vertex const * initialVerts = 
                 reinterpret_cast<Vertex const *>(inMeshFn.getRawPoints(&status));
-            std::vector<Vertex> refinedVerts(
-                refiner->GetNumVerticesTotal() - refiner->GetLevel(0).GetNumVertices());
+            OpenSubdiv::Far::StencilTable const * vertexStencils =
+                _topology->GetVertexStencils();
+            std::vector<Vertex> refinedVerts;
+            Vertex const * finestVerts = NULL;
+
+            if (vertexStencils) {
+                // == Evaluate the finest level from the control vertices ======
+                refinedVerts.resize(vertexStencils->GetNumStencils());
+
+                OpenSubdiv::Osd::BufferDescriptor desc3(0, 3, 3);
+                RawCpuBuffer srcBuffer(const_cast<float *>(initialVerts[0].position)),
+                             dstBuffer(refinedVerts[0].position);
+                Evaluator::EvalStencils(&srcBuffer, desc3, &dstBuffer, desc3,
+                    vertexStencils);
+
+                finestVerts = &refinedVerts[0];
+            } else {
+                refinedVerts.resize(
+                    refiner->GetNumVerticesTotal() - refiner->GetLevel(0).GetNumVertices());
+            }
             Vertex const * srcVerts = &initialVerts[0];
             Vertex * dstVerts = &refinedVerts[0];
            
@@ -904,9 +1120,11 @@ MayaPolySmooth::compute( const MPlug& plug, MDataBlock& data ) {
             for (int level = 1; level <= subdivisionLevel; ++level) {
                 
                 // Interpolate vertices
-                primvarRefiner.Interpolate(level, srcVerts, dstVerts);
-                srcVerts = dstVerts;
-                dstVerts += refiner->GetLevel(level).GetNumVertices();
+                if (not vertexStencils) {
+                    primvarRefiner.Interpolate(level, srcVerts, dstVerts);
+                    srcVerts = dstVerts;
+                    dstVerts += refiner->GetLevel(level).GetNumVertices();
+                }
 
                 // Interpolate the uv set
                 if(hasUVs) {
@@ -922,6 +1140,9 @@ MayaPolySmooth::compute( const MPlug& plug, MDataBlock& data ) {
                     dstColor += refiner->GetLevel(level).GetNumFVarValues(CHANNELCOLOR);
                 }
             }
+            if (not vertexStencils) {
+                finestVerts = srcVerts;
+            }
 
             // == Convert subdivided OpenSubdiv mesh to MFnMesh Data outputMesh =============
 
@@ -931,7 +1152,7 @@ MayaPolySmooth::compute( const MPlug& plug, MDataBlock& data ) {
             MCHECKERR(status, "ERROR creating outputData");
 
             // Create out mesh
-            status = convertToMayaMeshData(*refiner, refinedVerts, hasUVs, 
+            status = convertToMayaMeshData(*refiner, finestVerts, hasUVs, 
                 refinedUVs, hasColors, refinedColors, inMeshFn, newMeshDataObj);
             MCHECKERR(status, "ERROR convertOsdFarToMayaMesh");
 
@@ -947,11 +1168,6 @@ MayaPolySmooth::compute( const MPlug& plug, MDataBlock& data ) {
             int isolation = std::min(10,(int)ceil(maxCreaseSharpness)+1);
             data.outputValue(a_recommendedIsolation).set(isolation);
 
-            // == Cleanup OSD ============================================
-
-            // REVISIT: Re-add these deletes
-            delete refiner;
-
             // note that the subd mesh was created (see the section below if !createdSubdMesh)
             createdSubdMesh = true;
         }
@@ -1203,6 +1419,9 @@ MStatus initializePlugin( MObject obj ) {
     MStatus   status = MS::kSuccess;
     MFnPlugin plugin( obj, "MayaPolySmooth", "1.0", "Any");
 
+    status = MThreadAsync::init();
+    MCHECKERR(status, "MThreadAsync::init");
+
     status = plugin.registerNode(
         MayaPolySmooth::typeNameStr,
         MayaPolySmooth::id,
@@ -1234,5 +1453,9 @@ MStatus uninitializePlugin( MObject obj) {
     returnStatus = plugin.deregisterNode( MayaPolySmooth::id );
     MCHECKERR(returnStatus, "deregisterNode");
 
+    // The code of the pending builds must not be unloaded
+    waitForVertexStencilsBuilds();
+    MThreadAsync::release();
+
     return returnStatus;
 }
@@ -59,6 +59,14 @@ public:
 
     static const MTypeId id;
     static const MString typeNameStr;
+
+    // Refined topology of the previous evaluation, reused as long as the
+    // topology of the input mesh and the refinement settings are unchanged
+    struct Topology;
+
+private:
+
+    Topology * _topology;
 };
 
 #endif // _MayaPolySmooth
@@ -0,0 +1,159 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/buildMonitor.h"
+#include "../far/stencilTable.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    // The state of a monitor is shared between the threads of the build and
+    // the threads following it
+    inline long
+    atomicLoad(long volatile const & value) {
+#ifdef _MSC_VER
+        return _InterlockedCompareExchange(
+            const_cast<long volatile *>(&value), 0, 0);
+#else
+        return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    inline void
+    atomicStore(long volatile & value, long newValue) {
+#ifdef _MSC_VER
+        _InterlockedExchange(&value, newValue);
+#else
+        __atomic_store_n(&value, newValue, __ATOMIC_RELEASE);
+#endif
+    }
+
+    inline long
+    atomicAdd(long volatile & value, long increment) {
+#ifdef _MSC_VER
+        return _InterlockedExchangeAdd(&value, increment) + increment;
+#else
+        return __atomic_add_fetch(&value, increment, __ATOMIC_ACQ_REL);
+#endif
+    }
+
+    float const progressUnit = (float)(1 << 24);
+}
+
+BuildMonitor::BuildMonitor(bool reportLevelStencils) :
+    _stageItems(0), _stageItemsDone(0), _progress(0), _cancelled(0),
+    _reportLevelStencils(reportLevelStencils) {
+
+    _range.begin = _stage.begin = 0.0f;
+    _range.end = _stage.end = 1.0f;
+}
+
+void
+BuildMonitor::Cancel() {
+    atomicStore(_cancelled, 1);
+}
+
+bool
+BuildMonitor::IsCancelled() const {
+    return atomicLoad(_cancelled) != 0;
+}
+
+float
+BuildMonitor::GetProgress() const {
+    return (float)atomicLoad(_progress) / progressUnit;
+}
+
+void
+BuildMonitor::Reset() {
+
+    _range.begin = _stage.begin = 0.0f;
+    _range.end = _stage.end = 1.0f;
+    _stageItems = 0;
+
+    atomicStore(_stageItemsDone, 0);
+    atomicStore(_progress, 0);
+    atomicStore(_cancelled, 0);
+}
+
+void
+BuildMonitor::StencilLevelCompleted(int /* level */,
+                                    StencilTable const * stencils) {
+    delete stencils;
+}
+
+BuildMonitor::Range
+BuildMonitor::enterRange(float begin, float end) {
+
+    Range previous = _range;
+
+    float size = previous.end - previous.begin;
+    _range.begin = previous.begin + begin * size;
+    _range.end = previous.begin + end * size;
+    return previous;
+}
+
+void
+BuildMonitor::beginStage(float begin, float end, int numItems) {
+
+    float size = _range.end - _range.begin;
+    _stage.begin = _range.begin + begin * size;
+    _stage.end = _range.begin + end * size;
+    _stageItems = numItems;
+
+    atomicStore(_stageItemsDone, 0);
+    setProgress(_stage.begin);
+}
+
+bool
+BuildMonitor::advance(int numItems) {
+
+    long done = atomicAdd(_stageItemsDone, numItems);
+
+    if (_stageItems > 0) {
+        float fraction = (float)done / (float)_stageItems;
+        setProgress(_stage.begin +
+            (_stage.end - _stage.begin) * (fraction < 1.0f ? fraction : 1.0f));
+    }
+    return not IsCancelled();
+}
+
+void
+BuildMonitor::setProgress(float progress) {
+    // concurrent ranges may complete out of order : the progress reported
+    // may briefly step back, but never past the beginning of the stage
+    atomicStore(_progress, (long)(progress * progressUnit));
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,151 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_BUILD_MONITOR_H
+#define OPENSUBDIV3_FAR_BUILD_MONITOR_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class StencilTable;
+
+///
+///  \brief Progress, cancellation and partial results of the factories of
+///         tables running on another thread
+///
+///  Far does not start threads of its own : a client building tables in the
+///  background calls the factories from a thread it manages, and shares a
+///  BuildMonitor (given to the factories with their options) with the
+///  threads waiting for the tables. The monitor stands for the build in
+///  progress :
+///
+///  - Cancel() stops a build which is no longer needed : the factories check
+///    the monitor between levels and between ranges of components (of a few
+///    thousand items when the factories run on a single thread), and return
+///    NULL.
+///
+///  - GetProgress() returns the fraction of the work done.
+///
+///  - StencilLevelCompleted() receives the stencil table of each level as
+///    soon as it is interpolated (if requested), e.g. to display the first
+///    levels of a refinement while the last ones are still interpolated.
+///
+///  Cancel(), IsCancelled() and GetProgress() can be called from any thread.
+///  A monitor follows a single build at a time : Reset() it before its next
+///  build.
+///
+class BuildMonitor {
+
+public:
+    /// \brief Constructor
+    ///
+    /// @param reportLevelStencils  Create the stencil table of each level
+    ///                             interpolated by StencilTableFactory
+    ///                             (see StencilLevelCompleted())
+    ///
+    BuildMonitor(bool reportLevelStencils = false);
+
+    virtual ~BuildMonitor() { }
+
+    /// \brief Requests the build to stop
+    void Cancel();
+
+    /// \brief Returns true if the build was cancelled
+    bool IsCancelled() const;
+
+    /// \brief Returns the fraction of the build done (from 0 to 1)
+    float GetProgress() const;
+
+    /// \brief Clears the cancellation and progress of the previous build
+    void Reset();
+
+    /// \brief Returns true if the stencil tables of the levels are created
+    bool ReportsLevelStencils() const { return _reportLevelStencils; }
+
+    /// \brief Called by StencilTableFactory::Create() on the thread of the
+    ///        build, once the stencils of a level are interpolated
+    ///
+    /// The table holds the stencils that Create() would return for a
+    /// 'maxLevel' of 'level' (the table of the last level is returned by
+    /// Create()). The default implementation deletes the table.
+    ///
+    /// @param level     Level of the stencils
+    ///
+    /// @param stencils  Stencil table of the levels up to 'level' (owned by
+    ///                  the monitor)
+    ///
+    virtual void StencilLevelCompleted(int level, StencilTable const * stencils);
+
+private:
+    friend class StencilTableFactory;
+    friend class LimitStencilTableFactory;
+    friend class PatchTableFactory;
+
+    // Fractions of the progress of the build are mapped to the range of the
+    // current factory : factories building tables with other factories assign
+    // them sub-ranges
+    struct Range {
+        float begin,
+              end;
+    };
+
+    // Maps the range [begin, end) of the current range to the next factory,
+    // and returns the current range to be restored
+    Range enterRange(float begin, float end);
+
+    void restoreRange(Range range) { _range = range; }
+
+    // Starts a stage of 'numItems' items over [begin, end) of the current
+    // range (called by a single thread)
+    void beginStage(float begin, float end, int numItems);
+
+    // Records items done in the current stage (called by any thread of the
+    // build) and returns false if the build is cancelled
+    bool advance(int numItems);
+
+    void setProgress(float progress);
+
+    Range _range,
+          _stage;
+
+    int _stageItems;
+
+    long volatile _stageItemsDone;
+    long volatile _progress;   // fraction of the build in 1/2^24 units
+    long volatile _cancelled;
+
+    bool _reportLevelStencils;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_BUILD_MONITOR_H */
@@ -55,8 +55,8 @@ EndCapBSplineBasisPatchFactory::EndCapBSplineBasisPatchFactory(
     _vertexStencils(vertexStencils), _varyingStencils(varyingStencils),
     _refiner(&refiner), _numVertices(0), _numPatches(0) {
 
-    // Sanity check: the mesh must be adaptively refined
-    assert(not refiner.IsUniform());
+    // Sanity check: the mesh must be adaptively refined (or unrefined)
+    assert(not refiner.IsUniform() or refiner.GetMaxLevel() == 0);
 
     // Reserve the patch point stencils. Ideally topology refiner
     // would have an API to return how many endcap patches will be required.
@@ -124,7 +124,8 @@ EndCapBSplineBasisPatchFactory::getPatchPointsFromGregoryBasis(
         _patchPoints.push_back(_numVertices + offset);
         ++_numVertices;
     }
-    GregoryBasis::ProtoBasis basis(*level, thisFace, levelVertOffset, -1);
+    GregoryBasis::ProtoBasis & basis = _basis;
+    basis.Compute(*level, thisFace, levelVertOffset, -1);
     // XXX: temporary hack. we should traverse topology and find existing
     //      vertices if available
     //
@@ -232,9 +233,7 @@ EndCapBSplineBasisPatchFactory::computeLimitStencils(
     e0.Clear(stencilCapacity);
     e1.Clear(stencilCapacity);
 
-    float t = 2.0f * float(M_PI) / float(valence);
-    float ef = 1.0f / (valence * (cosf(t) + 5.0f +
-                                  sqrtf((cosf(t) + 9) * (cosf(t) + 1)))/16.0f);
+    float ef = GregoryBasis::GetTangentScale(valence);
 
     for (int i = 0; i < valence; ++i) {
         Index ip = (i+1)%valence;
@@ -252,21 +251,21 @@ EndCapBSplineBasisPatchFactory::computeLimitStencils(
 
         P->AddWithWeight(f, 1.0f/float(valence));
 
-        float c0 = 0.5f*cosf((float(2*M_PI) * float(i)/float(valence)))
-                 + 0.5f*cosf((float(2*M_PI) * float(ip)/float(valence)));
-        float c1 = 0.5f*sinf((float(2*M_PI) * float(i)/float(valence)))
-                 + 0.5f*sinf((float(2*M_PI) * float(ip)/float(valence)));
+        float c0 = 0.5f*GregoryBasis::GetRingCos(valence, i)
+                 + 0.5f*GregoryBasis::GetRingCos(valence, ip);
+        float c1 = 0.5f*GregoryBasis::GetRingSin(valence, i)
+                 + 0.5f*GregoryBasis::GetRingSin(valence, ip);
         e0.AddWithWeight(f, c0*ef);
         e1.AddWithWeight(f, c1*ef);
     }
 
     *Ep = *P;
-    Ep->AddWithWeight(e0, cosf((float(2*M_PI) * float(start)/float(valence))));
-    Ep->AddWithWeight(e1, sinf((float(2*M_PI) * float(start)/float(valence))));
+    Ep->AddWithWeight(e0, GregoryBasis::GetRingCos(valence, start));
+    Ep->AddWithWeight(e1, GregoryBasis::GetRingSin(valence, start));
 
     *Em = *P;
-    Em->AddWithWeight(e0, cosf((float(2*M_PI) * float(prev)/float(valence))));
-    Em->AddWithWeight(e1, sinf((float(2*M_PI) * float(prev)/float(valence))));
+    Em->AddWithWeight(e0, GregoryBasis::GetRingCos(valence, prev));
+    Em->AddWithWeight(e1, GregoryBasis::GetRingSin(valence, prev));
 }
 
 ConstIndexArray
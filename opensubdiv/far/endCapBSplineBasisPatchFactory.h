@@ -106,6 +106,9 @@ private:
     int _numVertices;
     int _numPatches;
     std::vector<Index> _patchPoints;
+
+    // scratch basis reused between the patches
+    GregoryBasis::ProtoBasis _basis;
 };
 
 } // end namespace Far
@@ -26,8 +26,10 @@
 #include "../far/endCapGregoryBasisPatchFactory.h"
 #include "../far/error.h"
 #include "../far/stencilTableFactory.h"
+#include "../far/taskScheduler.h"
 #include "../far/topologyRefiner.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -47,10 +49,11 @@ EndCapGregoryBasisPatchFactory::EndCapGregoryBasisPatchFactory(
     bool shareBoundaryVertices) :
     _vertexStencils(vertexStencils), _varyingStencils(varyingStencils),
     _refiner(&refiner), _shareBoundaryVertices(shareBoundaryVertices),
-    _numGregoryBasisVertices(0), _numGregoryBasisPatches(0) {
+    _numGregoryBasisVertices(0), _numGregoryBasisPatches(0),
+    _level(0), _levelFirstPatch(0) {
 
-    // Sanity check: the mesh must be adaptively refined
-    assert(not refiner.IsUniform());
+    // Sanity check: the mesh must be adaptively refined (or unrefined)
+    assert(not refiner.IsUniform() or refiner.GetMaxLevel() == 0);
 
     // Reserve the patch point stencils. Ideally topology refiner
     // would have an API to return how many endcap patches will be required.
@@ -85,41 +88,117 @@ EndCapGregoryBasisPatchFactory::Create(TopologyRefiner const & refiner,
     return result;
 }
 
-bool
-EndCapGregoryBasisPatchFactory::addPatchBasis(Index faceIndex,
-                                              bool verticesMask[4][5],
-                                              int levelVertOffset) {
-
-    // Gregory patches only exist on the hight
-    Vtr::internal::Level const & level = _refiner->getLevel(_refiner->GetMaxLevel());
+void
+EndCapGregoryBasisPatchFactory::addPatchBasis(PatchBasis const & patch,
+                                              GregoryBasis::ProtoBasis & basis,
+                                              StencilTable * vertexStencils,
+                                              StencilTable * varyingStencils) {
 
     // Gather the CVs that influence the Gregory patch and their relative
     // weights in a basis
-    GregoryBasis::ProtoBasis basis(level, faceIndex, levelVertOffset, -1);
+    basis.Compute(*patch.level, patch.faceIndex, patch.levelVertOffset, -1);
+
+    GregoryBasis::Point const * points[5] = {
+        basis.P, basis.Ep, basis.Em, basis.Fp, basis.Fm };
 
     for (int i = 0; i < 4; ++i) {
-        if (verticesMask[i][0]) {
-            GregoryBasis::AppendToStencilTable(basis.P[i], _vertexStencils);
-            GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+        for (int j = 0; j < 5; ++j) {
+            if (patch.newVerticesMask & (1 << (i*5+j))) {
+                GregoryBasis::AppendToStencilTable(points[j][i], vertexStencils);
+                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], varyingStencils);
+            }
         }
-        if (verticesMask[i][1]) {
-            GregoryBasis::AppendToStencilTable(basis.Ep[i], _vertexStencils);
-            GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+    }
+}
+
+namespace {
+    void
+    appendStencils(StencilTable const & src, std::vector<int> & sizes,
+                   std::vector<Index> & indices, std::vector<float> & weights) {
+
+        sizes.insert(sizes.end(), src.GetSizes().begin(), src.GetSizes().end());
+        indices.insert(indices.end(), src.GetControlIndices().begin(),
+                                      src.GetControlIndices().end());
+        weights.insert(weights.end(), src.GetWeights().begin(),
+                                      src.GetWeights().end());
+    }
+}
+
+//
+//  Bases of ranges of patches, computed into stencil tables of their own
+//  (a vertex and a varying table per range) to be appended in turn
+//
+struct EndCapGregoryBasisPatchFactory::FinalizeContext {
+    PatchBasis const * patches;
+    int rangeSize;
+    StencilTable ** stencils;
+};
+
+void
+EndCapGregoryBasisPatchFactory::addPatchBases(int begin, int end, void * data) {
+
+    FinalizeContext const & context = *static_cast<FinalizeContext const *>(data);
+
+    // one basis per task, reused by all of its patches
+    GregoryBasis::ProtoBasis basis;
+
+    for (int i = begin; i < end; ++i) {
+        StencilTable * vertexStencils = context.stencils[2*i],
+                     * varyingStencils = context.stencils[2*i+1];
+
+        int numPatches = context.rangeSize;
+        for (int j = 0; j < numPatches; ++j) {
+            PatchBasis const & patch = context.patches[i*numPatches + j];
+            if (patch.faceIndex == Vtr::INDEX_INVALID) break;
+            addPatchBasis(patch, basis, vertexStencils, varyingStencils);
+        }
+    }
+}
+
+void
+EndCapGregoryBasisPatchFactory::Finalize(TaskScheduler const * taskScheduler) {
+
+    int numPatches = (int)_patchBases.size();
+
+    if (taskScheduler and taskScheduler->GetNumThreads() > 1 and numPatches > 1) {
+
+        int rangeSize = std::max(64,
+            numPatches / (4 * taskScheduler->GetNumThreads()) + 1);
+        int numRanges = (numPatches + rangeSize - 1) / rangeSize;
+
+        // pad the last range with invalid patches
+        PatchBasis padding = { 0, Vtr::INDEX_INVALID, 0, 0 };
+        _patchBases.resize(numRanges * rangeSize, padding);
+
+        std::vector<StencilTable *> stencils(2 * numRanges);
+        for (int i = 0; i < 2 * numRanges; ++i) {
+            stencils[i] = new StencilTable(0);
         }
-        if (verticesMask[i][2]) {
-            GregoryBasis::AppendToStencilTable(basis.Em[i], _vertexStencils);
-            GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+
+        FinalizeContext context;
+        context.patches = &_patchBases[0];
+        context.rangeSize = rangeSize;
+        context.stencils = &stencils[0];
+
+        taskScheduler->ParallelFor(0, numRanges, 1, addPatchBases, &context);
+
+        for (int i = 0; i < numRanges; ++i) {
+            appendStencils(*stencils[2*i], _vertexStencils->_sizes,
+                _vertexStencils->_indices, _vertexStencils->_weights);
+            appendStencils(*stencils[2*i+1], _varyingStencils->_sizes,
+                _varyingStencils->_indices, _varyingStencils->_weights);
         }
-        if (verticesMask[i][3]) {
-            GregoryBasis::AppendToStencilTable(basis.Fp[i], _vertexStencils);
-            GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+        for (int i = 0; i < 2 * numRanges; ++i) {
+            delete stencils[i];
         }
-        if (verticesMask[i][4]) {
-            GregoryBasis::AppendToStencilTable(basis.Fm[i], _vertexStencils);
-            GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+    } else {
+        GregoryBasis::ProtoBasis basis;
+        for (int i = 0; i < numPatches; ++i) {
+            addPatchBasis(_patchBases[i], basis,
+                          _vertexStencils, _varyingStencils);
         }
     }
-    return true;
+    _patchBases.clear();
 }
 
 //
@@ -140,6 +219,16 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
     }
     Index * dest = &_patchPoints[_numGregoryBasisPatches * 20];
 
+    // end caps of lower levels of isolation come first (see
+    // TopologyRefiner::RefineAdaptive) : their points are not shared
+    if (level != _level) {
+        _level = level;
+        _levelFirstPatch = _numGregoryBasisPatches;
+        if (_shareBoundaryVertices) {
+            _vertexPoints.assign(level->getNumVertices(), Vtr::INDEX_INVALID);
+        }
+    }
+
     int gregoryVertexOffset = _refiner->GetNumVerticesTotal();
 
     if (_shareBoundaryVertices) {
@@ -165,6 +254,7 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
             // - have already been processed (known CV indices)
             // - are also Gregory basis patches
             if (adjface!=Vtr::INDEX_INVALID and (adjface < faceIndex) and
+                levelPatchTags[adjface]._hasPatch and
                 (not levelPatchTags[adjface]._isRegular)) {
 
                 ConstIndexArray aedges = level->getFaceEdges(adjface);
@@ -178,9 +268,12 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
                     }
                 };
 
+                Index * levelFaceIndices = _faceIndices.empty() ?
+                    0 : &_faceIndices[0] + _levelFirstPatch;
+
                 Index * ptr = (Index *)std::bsearch(&adjface,
-                                                    &_faceIndices[0],
-                                                    _faceIndices.size(),
+                                                    levelFaceIndices,
+                                                    _faceIndices.size() - _levelFirstPatch,
                                                     sizeof(Index), compare::op);
 
                 int srcBasisIdx = (int)(ptr - &_faceIndices[0]);
@@ -209,7 +302,17 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
         }
     }
 
-    bool newVerticesMask[4][5];
+    if (_shareBoundaryVertices) {
+        // Share the corner points of patches meeting only at a vertex
+        ConstIndexArray fverts = level->getFaceVertices(faceIndex);
+        for (int i = 0; i < 4; ++i) {
+            if (dest[i*5]==Vtr::INDEX_INVALID) {
+                dest[i*5] = _vertexPoints[fverts[i]];
+            }
+        }
+    }
+
+    PatchBasis patch = { level, faceIndex, levelVertOffset, 0 };
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 5; ++j) {
             if (dest[i*5+j]==Vtr::INDEX_INVALID) {
@@ -217,17 +320,20 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
                 dest[i*5+j] =
                     _numGregoryBasisVertices + gregoryVertexOffset;
                 ++_numGregoryBasisVertices;
-                newVerticesMask[i][j] = true;
-            } else {
-                // share vertex
-                newVerticesMask[i][j] = false;
+                patch.newVerticesMask |= 1 << (i*5+j);
             }
         }
     }
+    if (_shareBoundaryVertices) {
+        ConstIndexArray fverts = level->getFaceVertices(faceIndex);
+        for (int i = 0; i < 4; ++i) {
+            _vertexPoints[fverts[i]] = dest[i*5];
+        }
+    }
     _faceIndices.push_back(faceIndex);
 
-    // add basis
-    addPatchBasis(faceIndex, newVerticesMask, levelVertOffset);
+    // the basis is computed by Finalize()
+    _patchBases.push_back(patch);
 
     ++_numGregoryBasisPatches;
 
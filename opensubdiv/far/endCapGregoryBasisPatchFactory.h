@@ -36,6 +36,7 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 class TopologyRefiner;
+class TaskScheduler;
 
 /// \brief A specialized factory to gather Gregory basis control vertices
 ///
@@ -108,12 +109,38 @@ public:
         PatchTableFactory::PatchFaceTag const * levelPatchTags,
         int levelVertOffset);
 
+    /// \brief Appends the stencils of the new patch points returned by
+    ///        GetPatchPoints to the stencil tables
+    ///
+    /// The bases of the patches are independent and are computed
+    /// concurrently when a scheduler is given, their stencils being
+    /// appended in the order of the patches.
+    ///
+    /// @param taskScheduler  Optional scheduler of the computation
+    ///
+    void Finalize(TaskScheduler const * taskScheduler=0);
+
 private:
 
+    // patch whose basis remains to be computed, and the mask of its new
+    // points (bit 5*corner+point)
+    struct PatchBasis {
+        Vtr::internal::Level const * level;
+        Index faceIndex;
+        int levelVertOffset;
+        int newVerticesMask;
+    };
+
     /// Creates a basis for the vertices specified in mask on the face and
-    /// accumates it
-    bool addPatchBasis(Index faceIndex, bool newVerticesMask[4][5],
-                       int levelVertOffset);
+    /// accumates it (\a basis is the scratch basis reused between patches)
+    static void addPatchBasis(PatchBasis const & patch,
+                              GregoryBasis::ProtoBasis & basis,
+                              StencilTable * vertexStencils,
+                              StencilTable * varyingStencils);
+
+    struct FinalizeContext;
+
+    static void addPatchBases(int begin, int end, void * data);
 
     StencilTable *_vertexStencils;
     StencilTable *_varyingStencils;
@@ -124,6 +151,17 @@ private:
     int _numGregoryBasisPatches;
     std::vector<Index> _faceIndices;
     std::vector<Index> _patchPoints;
+    std::vector<PatchBasis> _patchBases;
+
+    // patch point of the corner at each vertex of the level (corner points
+    // only depend on the vertex, and are also shared between patches that
+    // meet at a vertex)
+    std::vector<Index> _vertexPoints;
+
+    // level of the last patch and index of its first patch (patch points
+    // are only shared between the faces of a level)
+    Vtr::internal::Level const * _level;
+    int _levelFirstPatch;
 };
 
 } // end namespace Far
@@ -49,12 +49,19 @@ EndCapLegacyGregoryPatchFactory::GetPatchPoints(
     // Gregory Regular Patch (4 CVs + quad-offsets / valence tables)
     Vtr::ConstIndexArray faceVerts = level->getFaceVertices(faceIndex);
 
+    int depth = level->getDepth();
+    if ((int)_levelsWithPatches.size() <= depth) {
+        _levelsWithPatches.resize(depth + 1, false);
+    }
+    _levelsWithPatches[depth] = true;
+
     if (patchTag._boundaryCount) {
         for (int j = 0; j < 4; ++j) {
             // apply level offset
             _gregoryBoundaryTopology.push_back(faceVerts[j] + levelVertOffset);
         }
         _gregoryBoundaryFaceIndices.push_back(faceIndex);
+        _gregoryBoundaryFaceLevels.push_back((unsigned char)depth);
         return ConstIndexArray(&_gregoryBoundaryTopology[_gregoryBoundaryTopology.size()-4], 4);
     } else {
         for (int j = 0; j < 4; ++j) {
@@ -62,6 +69,7 @@ EndCapLegacyGregoryPatchFactory::GetPatchPoints(
             _gregoryTopology.push_back(faceVerts[j] + levelVertOffset);
         }
         _gregoryFaceIndices.push_back(faceIndex);
+        _gregoryFaceLevels.push_back((unsigned char)depth);
         return ConstIndexArray(&_gregoryTopology[_gregoryTopology.size()-4], 4);
     }
 }
@@ -112,19 +120,19 @@ EndCapLegacyGregoryPatchFactory::Finalize(
     size_t numTotalGregoryPatches = 
         numGregoryPatches + numGregoryBoundaryPatches;
 
-    Vtr::internal::Level const &maxLevel = _refiner.getLevel(_refiner.GetMaxLevel());
-
     quadOffsetsTable->resize(numTotalGregoryPatches*4);
 
     if (numTotalGregoryPatches > 0) {
         PatchTable::QuadOffsetsTable::value_type *p = 
             &((*quadOffsetsTable)[0]);
         for (size_t i = 0; i < numGregoryPatches; ++i) {
-            getQuadOffsets(maxLevel, _gregoryFaceIndices[i], p);
+            getQuadOffsets(_refiner.getLevel(_gregoryFaceLevels[i]),
+                           _gregoryFaceIndices[i], p);
             p += 4;
         }
         for (size_t i = 0; i < numGregoryBoundaryPatches; ++i) {
-            getQuadOffsets(maxLevel, _gregoryBoundaryFaceIndices[i], p);
+            getQuadOffsets(_refiner.getLevel(_gregoryBoundaryFaceLevels[i]),
+                           _gregoryBoundaryFaceIndices[i], p);
             p += 4;
         }
     }
@@ -153,7 +161,7 @@ EndCapLegacyGregoryPatchFactory::Finalize(
 
         Vtr::internal::Level const * level = &_refiner.getLevel(i);
 
-        if (i == levelLast) {
+        if ((i < (int)_levelsWithPatches.size()) and _levelsWithPatches[i]) {
 
             int vTableOffset = vOffset * SizePerVertex;
 
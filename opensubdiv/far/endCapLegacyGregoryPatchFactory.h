@@ -47,8 +47,8 @@ public:
     EndCapLegacyGregoryPatchFactory(TopologyRefiner const & refiner);
 
     /// \brief Returns end patch point indices for \a faceIndex of \a level.
-    ///        Note that legacy gregory patch points exist in the max level
-    ///        of subdivision in the topologyRefiner.
+    ///        Note that legacy gregory patch points exist in the level of
+    ///        the face in the topologyRefiner.
     ///        The returning indices are offsetted by levelVertOffset
     ///
     /// @param level            vtr refinement level
@@ -74,6 +74,12 @@ private:
     std::vector<Index> _gregoryBoundaryTopology;
     std::vector<Index> _gregoryFaceIndices;
     std::vector<Index> _gregoryBoundaryFaceIndices;
+
+    // levels of the faces and levels containing patches (end caps are in the
+    // max level, unless the isolation of their base face was limited)
+    std::vector<unsigned char> _gregoryFaceLevels;
+    std::vector<unsigned char> _gregoryBoundaryFaceLevels;
+    std::vector<bool> _levelsWithPatches;
 };
 
 } // end namespace Far
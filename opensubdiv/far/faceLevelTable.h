@@ -0,0 +1,145 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_FACE_LEVEL_TABLE_H
+#define OPENSUBDIV3_FAR_FACE_LEVEL_TABLE_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Triangles of each base face at each level of a uniform refinement
+///
+/// View-dependent refinement draws each base face at its own level, picked
+/// every frame (e.g. from its distance to the camera and its curvature) :
+/// the table holds the triangles descending from each base face at each
+/// level, quads being split in two and the N-sided base faces in fans.
+///
+/// The triangles index the vertex buffer of all the levels : the control
+/// vertices followed by the points of a StencilTable created with
+/// generateIntermediateLevels (and without generateControlVerts), the
+/// vertices of level k starting at GetLevelVertexOffset(k). Evaluating the
+/// first StencilTableFactory::GetLevelStencilCounts() stencils up to the
+/// finest level drawn refines all the vertices its triangles index.
+///
+/// Levels are picked from the corners of each base face and from their child
+/// vertices at level 1, which move away from the corners as much as the
+/// surface is curved around them (GetFaceCorners() and
+/// GetFaceRefinedCorners()).
+///
+/// \note Adjacent base faces drawn at different levels do not share the
+///       vertices of their common edge, which leaves cracks along it.
+///
+/// See FaceLevelTableFactory.
+///
+class FaceLevelTable {
+
+public:
+
+    /// \brief Returns the number of base faces
+    int GetNumBaseFaces() const { return (int)_cornerOffsets.size() - 1; }
+
+    /// \brief Returns the finest level of the triangles
+    int GetMaxLevel() const { return (int)_levelVertexOffsets.size() - 2; }
+
+    /// \brief Returns the index of the first vertex of a level in the vertex
+    ///        buffer (the last entry, at GetMaxLevel() + 1, is the number of
+    ///        vertices of all the levels)
+    Index GetLevelVertexOffset(int level) const {
+        return _levelVertexOffsets[level];
+    }
+
+    /// \brief Returns the triangles of a base face at a level (3 indices
+    ///        of the vertex buffer per triangle)
+    ConstIndexArray GetTriangles(int face, int level) const {
+        int range = face * (GetMaxLevel() + 1) + level;
+        int size = _triangleOffsets[range + 1] - _triangleOffsets[range];
+        return ConstIndexArray(size ? &_triangles[_triangleOffsets[range]] : 0, size);
+    }
+
+    /// \brief Returns the offsets of the triangles of each base face at each
+    ///        level into GetTriangleVertices() (face * (GetMaxLevel() + 1) +
+    ///        level, followed by the total)
+    std::vector<Index> const & GetTriangleOffsets() const {
+        return _triangleOffsets;
+    }
+
+    /// \brief Returns the vertices of the triangles of all the base faces
+    std::vector<Index> const & GetTriangleVertices() const {
+        return _triangles;
+    }
+
+    /// \brief Returns the corners of a base face (indices of the vertex
+    ///        buffer)
+    ConstIndexArray GetFaceCorners(int face) const {
+        int size = _cornerOffsets[face + 1] - _cornerOffsets[face];
+        return ConstIndexArray(size ? &_corners[_cornerOffsets[face]] : 0, size);
+    }
+
+    /// \brief Returns the child vertices at level 1 of the corners of a base
+    ///        face (the corners themselves without refined levels)
+    ConstIndexArray GetFaceRefinedCorners(int face) const {
+        int size = _cornerOffsets[face + 1] - _cornerOffsets[face];
+        return ConstIndexArray(size ? &_refinedCorners[_cornerOffsets[face]] : 0, size);
+    }
+
+    /// \brief Returns the offsets of the corners of each base face (followed
+    ///        by the total)
+    std::vector<Index> const & GetCornerOffsets() const { return _cornerOffsets; }
+
+    /// \brief Returns the corners of all the base faces
+    std::vector<Index> const & GetCorners() const { return _corners; }
+
+    /// \brief Returns the refined corners of all the base faces
+    std::vector<Index> const & GetRefinedCorners() const { return _refinedCorners; }
+
+private:
+
+    friend class FaceLevelTableFactory;
+
+    std::vector<Index> _levelVertexOffsets; // first vertex of each level
+
+    std::vector<Index> _triangleOffsets;    // triangles of each face and level
+    std::vector<Index> _triangles;
+
+    std::vector<Index> _cornerOffsets;      // corners of each base face
+    std::vector<Index> _corners;
+    std::vector<Index> _refinedCorners;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_FACE_LEVEL_TABLE_H
@@ -0,0 +1,141 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/faceLevelTableFactory.h"
+#include "../far/error.h"
+#include "../far/topologyRefiner.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+FaceLevelTable const *
+FaceLevelTableFactory::Create(TopologyRefiner const & refiner) {
+
+    if (not refiner.IsUniform()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in FaceLevelTableFactory::Create() -- "
+            "refinement is not uniform.");
+        return NULL;
+    }
+    if (refiner.IsTrimmed()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in FaceLevelTableFactory::Create() -- "
+            "refinements were trimmed.");
+        return NULL;
+    }
+
+    int maxLevel = refiner.GetMaxLevel(),
+        numLevels = maxLevel + 1;
+
+    TopologyLevel const & baseLevel = refiner.GetLevel(0);
+    int numBaseFaces = baseLevel.GetNumFaces();
+
+    FaceLevelTable * table = new FaceLevelTable;
+
+    table->_levelVertexOffsets.resize(numLevels + 1);
+    table->_levelVertexOffsets[0] = 0;
+    for (int level = 0; level < numLevels; ++level) {
+        table->_levelVertexOffsets[level + 1] = table->_levelVertexOffsets[level] +
+            refiner.GetLevel(level).GetNumVertices();
+    }
+
+    //  Corners of the base faces and their child vertices at level 1:
+    table->_cornerOffsets.resize(numBaseFaces + 1);
+    table->_cornerOffsets[0] = 0;
+    for (int face = 0; face < numBaseFaces; ++face) {
+        ConstIndexArray fVerts = baseLevel.GetFaceVertices(face);
+        for (int i = 0; i < fVerts.size(); ++i) {
+            table->_corners.push_back(fVerts[i]);
+            table->_refinedCorners.push_back(maxLevel ?
+                table->_levelVertexOffsets[1] + baseLevel.GetVertexChildVertex(fVerts[i]) :
+                fVerts[i]);
+        }
+        table->_cornerOffsets[face + 1] = (Index)table->_corners.size();
+    }
+
+    //  Count the triangles of each base face at each level, identifying the
+    //  base face of the faces of each level from that of their parent:
+    std::vector<Index> triangleCounts(numBaseFaces * numLevels + 1, 0);
+
+    std::vector<Index> faceBaseFaces, parentBaseFaces;
+    for (int level = 0; level < numLevels; ++level) {
+        TopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        faceBaseFaces.resize(refLevel.GetNumFaces());
+        for (Index face = 0; face < refLevel.GetNumFaces(); ++face) {
+            faceBaseFaces[face] = level ?
+                parentBaseFaces[refLevel.GetFaceParentFace(face)] : face;
+
+            if (refLevel.IsFaceHole(face)) continue;
+
+            triangleCounts[faceBaseFaces[face] * numLevels + level] +=
+                refLevel.GetFaceVertices(face).size() - 2;
+        }
+        faceBaseFaces.swap(parentBaseFaces);
+    }
+
+    table->_triangleOffsets.resize(numBaseFaces * numLevels + 1);
+    table->_triangleOffsets[0] = 0;
+    for (int i = 0; i < numBaseFaces * numLevels; ++i) {
+        table->_triangleOffsets[i + 1] = table->_triangleOffsets[i] + triangleCounts[i] * 3;
+    }
+    table->_triangles.resize(table->_triangleOffsets.back());
+
+    //  Gather the triangles in the order of the faces of each level:
+    std::vector<Index> triangleEnds(table->_triangleOffsets.begin(),
+                                    table->_triangleOffsets.end() - 1);
+    for (int level = 0; level < numLevels; ++level) {
+        TopologyLevel const & refLevel = refiner.GetLevel(level);
+        Index vertexOffset = table->_levelVertexOffsets[level];
+
+        faceBaseFaces.resize(refLevel.GetNumFaces());
+        for (Index face = 0; face < refLevel.GetNumFaces(); ++face) {
+            faceBaseFaces[face] = level ?
+                parentBaseFaces[refLevel.GetFaceParentFace(face)] : face;
+
+            if (refLevel.IsFaceHole(face)) continue;
+
+            Index * dst = &table->_triangles[
+                triangleEnds[faceBaseFaces[face] * numLevels + level]];
+
+            ConstIndexArray fVerts = refLevel.GetFaceVertices(face);
+            for (int i = 1; i + 1 < fVerts.size(); ++i) {
+                *dst++ = vertexOffset + fVerts[0];
+                *dst++ = vertexOffset + fVerts[i];
+                *dst++ = vertexOffset + fVerts[i + 1];
+            }
+            triangleEnds[faceBaseFaces[face] * numLevels + level] +=
+                (fVerts.size() - 2) * 3;
+        }
+        faceBaseFaces.swap(parentBaseFaces);
+    }
+    return table;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,65 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_FACE_LEVEL_TABLE_FACTORY_H
+#define OPENSUBDIV3_FAR_FACE_LEVEL_TABLE_FACTORY_H
+
+#include "../version.h"
+
+#include "../far/faceLevelTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TopologyRefiner;
+
+/// \brief A specialized factory for FaceLevelTable
+///
+class FaceLevelTableFactory {
+
+public:
+
+    /// \brief Instantiates the FaceLevelTable of the levels of a uniform
+    ///        refinement
+    ///
+    /// The faces of all the levels are gathered by base face, holes
+    /// excluded. Quads are split along the diagonal from their first vertex.
+    ///
+    /// @param refiner  TopologyRefiner refined uniformly (with the topology
+    ///                 of all its levels, i.e. not trimmed)
+    ///
+    /// @return         A new instance of FaceLevelTable (NULL on failure)
+    ///
+    static FaceLevelTable const * Create(TopologyRefiner const & refiner);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_FACE_LEVEL_TABLE_FACTORY_H
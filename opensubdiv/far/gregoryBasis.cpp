@@ -70,35 +70,127 @@ GregoryBasis::ProtoBasis::Copy(GregoryBasis * dest) const {
     Copy(dest->_sizes, &dest->_indices[0], &dest->_weights[0]);
 }
 
+//
+//  Per-valence coefficients, computed once at static initialization (the
+//  table is then only read and so safely shared by concurrent end-cap
+//  factories).  Larger valences are computed on the fly with the same
+//  expressions so that the results do not depend on the table.
+//
+namespace {
+    float computeRingCos(int valence, int i) {
+        return cosf((2.0f * float(M_PI) * float(i)) / float(valence));
+    }
+    float computeRingSin(int valence, int i) {
+        return sinf((2.0f * float(M_PI) * float(i)) / float(valence));
+    }
+    float computeBoundaryCos(int k, int j) {
+        return cosf((float(M_PI) * float(j)) / float(k));
+    }
+    float computeBoundarySin(int k, int j) {
+        return sinf((float(M_PI) * float(j)) / float(k));
+    }
+    float computeTangentScale(int valence) {
+        float t = 2.0f * float(M_PI) / float(valence);
+        return 1.0f / (valence * (cosf(t) + 5.0f +
+                                  sqrtf((cosf(t) + 9) * (cosf(t) + 1)))/16.0f);
+    }
+
+    struct ValenceTable {
+        static const int MAX_VALENCE = 30;
+
+        //  row n of the ring (resp. boundary) entries starts at n*(n-1)/2
+        //  (resp. n*(n+1)/2) and holds n (resp. n+1) entries
+        static int ringOffset(int n)     { return n*(n-1)/2; }
+        static int boundaryOffset(int k) { return k*(k+1)/2; }
+
+        ValenceTable() {
+            tangentScale[0] = 0.0f;
+            for (int n = 1; n <= MAX_VALENCE; ++n) {
+                tangentScale[n] = computeTangentScale(n);
+                for (int i = 0; i < n; ++i) {
+                    ringCos[ringOffset(n) + i] = computeRingCos(n, i);
+                    ringSin[ringOffset(n) + i] = computeRingSin(n, i);
+                }
+            }
+            for (int k = 1; k <= MAX_VALENCE; ++k) {
+                for (int j = 0; j <= k; ++j) {
+                    boundaryCos[boundaryOffset(k) + j] = computeBoundaryCos(k, j);
+                    boundarySin[boundaryOffset(k) + j] = computeBoundarySin(k, j);
+                }
+            }
+        }
+
+        float tangentScale[MAX_VALENCE + 1];
+        float ringCos[(MAX_VALENCE + 1) * MAX_VALENCE / 2];
+        float ringSin[(MAX_VALENCE + 1) * MAX_VALENCE / 2];
+        float boundaryCos[(MAX_VALENCE + 1) * (MAX_VALENCE + 2) / 2];
+        float boundarySin[(MAX_VALENCE + 1) * (MAX_VALENCE + 2) / 2];
+    };
+
+    ValenceTable const valenceTable;
+
+    inline bool inRingTable(int valence, int i) {
+        return (valence > 0) and (valence <= ValenceTable::MAX_VALENCE) and
+               (i >= 0) and (i < valence);
+    }
+    inline bool inBoundaryTable(int k, int j) {
+        return (k > 0) and (k <= ValenceTable::MAX_VALENCE) and
+               (j >= 0) and (j <= k);
+    }
+}
+
+float
+GregoryBasis::GetTangentScale(int valence) {
+    assert(valence > 0);
+    return (valence <= ValenceTable::MAX_VALENCE) ?
+        valenceTable.tangentScale[valence] : computeTangentScale(valence);
+}
+
+float
+GregoryBasis::GetRingCos(int valence, int i) {
+    return inRingTable(valence, i) ?
+        valenceTable.ringCos[ValenceTable::ringOffset(valence) + i] :
+        computeRingCos(valence, i);
+}
+
+float
+GregoryBasis::GetRingSin(int valence, int i) {
+    return inRingTable(valence, i) ?
+        valenceTable.ringSin[ValenceTable::ringOffset(valence) + i] :
+        computeRingSin(valence, i);
+}
+
+float
+GregoryBasis::GetBoundaryCos(int k, int j) {
+    return inBoundaryTable(k, j) ?
+        valenceTable.boundaryCos[ValenceTable::boundaryOffset(k) + j] :
+        computeBoundaryCos(k, j);
+}
+
+float
+GregoryBasis::GetBoundarySin(int k, int j) {
+    return inBoundaryTable(k, j) ?
+        valenceTable.boundarySin[ValenceTable::boundaryOffset(k) + j] :
+        computeBoundarySin(k, j);
+}
+
 inline float csf(Index n, Index j) {
     if (j%2 == 0) {
-        return cosf((2.0f * float(M_PI) * float(float(j-0)/2.0f))/(float(n)+3.0f));
+        return GregoryBasis::GetRingCos(n+3, j/2);
     } else {
-        return sinf((2.0f * float(M_PI) * float(float(j-1)/2.0f))/(float(n)+3.0f));
+        return GregoryBasis::GetRingSin(n+3, (j-1)/2);
     }
 }
 
-inline float computeCoefficient(int valence) {
-    // precomputed coefficient table up to valence 29
-    static float efTable[] = {
-        0, 0, 0,
-        0.812816f, 0.500000f, 0.363644f, 0.287514f,
-        0.238688f, 0.204544f, 0.179229f, 0.159657f,
-        0.144042f, 0.131276f, 0.120632f, 0.111614f,
-        0.103872f, 0.09715f, 0.0912559f, 0.0860444f,
-        0.0814022f, 0.0772401f, 0.0734867f, 0.0700842f,
-        0.0669851f, 0.0641504f, 0.0615475f, 0.0591488f,
-        0.0569311f, 0.0548745f, 0.0529621f
-    };
-    assert(valence > 0);
-    if (valence < 30) return efTable[valence];
+GregoryBasis::ProtoBasis::ProtoBasis(
+    Vtr::internal::Level const & level, Index faceIndex,
+    int levelVertOffset, int fvarChannel) {
 
-    float t = 2.0f * float(M_PI) / float(valence);
-    return 1.0f / (valence * (cosf(t) + 5.0f +
-                              sqrtf((cosf(t) + 9) * (cosf(t) + 1)))/16.0f);
+    Compute(level, faceIndex, levelVertOffset, fvarChannel);
 }
 
-GregoryBasis::ProtoBasis::ProtoBasis(
+void
+GregoryBasis::ProtoBasis::Compute(
     Vtr::internal::Level const & level, Index faceIndex,
     int levelVertOffset, int fvarChannel) {
 
@@ -121,21 +213,35 @@ GregoryBasis::ProtoBasis::ProtoBasis(
         4/*0-ring*/ + 2*(2*(maxvalence-2)/*1-ring around extraordinaries*/
                          + 2/*1-ring around regulars, excluding shared ones*/);
 
-    Point e0[4], e1[4];
+    // the scratch buffers are only resized when growing, so that their
+    // points retain the capacity reserved for previous faces
+    Point * e0 = _e0,
+          * e1 = _e1;
     for (int i = 0; i < 4; ++i) {
         P[i].Clear(stencilCapacity);
+        Ep[i].Clear(stencilCapacity);
+        Em[i].Clear(stencilCapacity);
+        Fp[i].Clear(stencilCapacity);
+        Fm[i].Clear(stencilCapacity);
         e0[i].Clear(stencilCapacity);
         e1[i].Clear(stencilCapacity);
     }
 
-    Vtr::internal::StackBuffer<Index, 40> manifoldRings[4];
-    manifoldRings[0].SetSize(maxvalence*2);
-    manifoldRings[1].SetSize(maxvalence*2);
-    manifoldRings[2].SetSize(maxvalence*2);
-    manifoldRings[3].SetSize(maxvalence*2);
+    Vtr::internal::StackBuffer<Index, 40> * manifoldRings = _rings;
+    for (int i = 0; i < 4; ++i) {
+        if ((int)manifoldRings[i].GetSize() < maxvalence*2) {
+            manifoldRings[i].SetSize(maxvalence*2);
+        }
+    }
 
-    Vtr::internal::StackBuffer<Point, 10> f(maxvalence);
-    Vtr::internal::StackBuffer<Point, 40> r(maxvalence*4);
+    if ((int)_f.GetSize() < maxvalence) {
+        _f.SetSize(maxvalence);
+    }
+    if ((int)_r.GetSize() < maxvalence*4) {
+        _r.SetSize(maxvalence*4);
+    }
+    Point * f = _f,
+          * r = _r;
 
     // the first phase
 
@@ -175,8 +281,9 @@ GregoryBasis::ProtoBasis::ProtoBasis(
                   idx_neighbor_m = (manifoldRings[vid][2*im + 0]),
                   idx_diagonal_m = (manifoldRings[vid][2*im + 1]);
 
-            bool boundaryNeighbor = (level.getVertexEdges(idx_neighbor).size() >
-                                     level.getVertexFaces(idx_neighbor).size());
+            // the tag rather than the incident edges and faces, which are partial
+            // for the incomplete neighbors of sparse refinements
+            bool boundaryNeighbor = level.getVertexTag(idx_neighbor)._boundary;
 
             if (fvarChannel>=0) {
                 // XXXX manuelk need logic to check for boundary in fvar
@@ -229,7 +336,7 @@ GregoryBasis::ProtoBasis::ProtoBasis(
             e1[vid].AddWithWeight(f[im], c1);
         }
 
-        float ef = computeCoefficient(ivalence);
+        float ef = GetTangentScale(ivalence);
         e0[vid] *= ef;
         e1[vid] *= ef;
 
@@ -244,8 +351,8 @@ GregoryBasis::ProtoBasis::ProtoBasis(
                 P[vid].AddWithWeight(facePoints[vid], 1.0f);
             }
             float k = float(float(ivalence) - 1.0f);    //k is the number of faces
-            float c = cosf(float(M_PI)/k);
-            float s = sinf(float(M_PI)/k);
+            float c = GetBoundaryCos(ivalence-1, 1);
+            float s = GetBoundarySin(ivalence-1, 1);
             float gamma = -(4.0f*s)/(3.0f*k+c);
             float alpha_0k = -((1.0f+2.0f*c)*sqrtf(1.0f+c))/((3.0f*k+c)*sqrtf(1.0f-c));
             float beta_0 = s/(3.0f*k + c);
@@ -266,8 +373,8 @@ GregoryBasis::ProtoBasis::ProtoBasis(
 
                 Index curri = ((x + zerothNeighbor)%ivalence);
 
-                float alpha = (4.0f*sinf((float(M_PI) * float(x))/k))/(3.0f*k+c),
-                      beta = (sinf((float(M_PI) * float(x))/k) + sinf((float(M_PI) * float(x+1))/k))/(3.0f*k+c);
+                float alpha = (4.0f*GetBoundarySin(ivalence-1, x))/(3.0f*k+c),
+                      beta = (GetBoundarySin(ivalence-1, x) + GetBoundarySin(ivalence-1, x+1))/(3.0f*k+c);
 
                 Index idx_neighbor = manifoldRings[vid][2*curri + 0],
                       idx_diagonal = manifoldRings[vid][2*curri + 1];
@@ -312,13 +419,15 @@ GregoryBasis::ProtoBasis::ProtoBasis(
         }
         assert(start != -1 && prev != -1 && start_m != -1 && prev_p != -1);
 
-        Point Em_ip = P[ip];
-        Point Ep_im = P[im];
+        Point & Em_ip = _Em_ip;
+        Point & Ep_im = _Ep_im;
+        Em_ip = P[ip];
+        Ep_im = P[im];
 
         if (valences[ip]<-2) {
             Index j = (np + prev_p - zerothNeighbors[ip]) % np;
-            Em_ip.AddWithWeight(e0[ip], cosf((float(M_PI)*j)/float(np-1)));
-            Em_ip.AddWithWeight(e1[ip], sinf((float(M_PI)*j)/float(np-1)));
+            Em_ip.AddWithWeight(e0[ip], GetBoundaryCos(np-1, j));
+            Em_ip.AddWithWeight(e1[ip], GetBoundarySin(np-1, j));
         } else {
             Em_ip.AddWithWeight(e0[ip], csf(np-3, 2*prev_p));
             Em_ip.AddWithWeight(e1[ip], csf(np-3, 2*prev_p+1));
@@ -326,8 +435,8 @@ GregoryBasis::ProtoBasis::ProtoBasis(
 
         if (valences[im]<-2) {
             Index j = (nm + start_m - zerothNeighbors[im]) % nm;
-            Ep_im.AddWithWeight(e0[im], cosf((float(M_PI)*j)/float(nm-1)));
-            Ep_im.AddWithWeight(e1[im], sinf((float(M_PI)*j)/float(nm-1)));
+            Ep_im.AddWithWeight(e0[im], GetBoundaryCos(nm-1, j));
+            Ep_im.AddWithWeight(e1[im], GetBoundarySin(nm-1, j));
         } else {
             Ep_im.AddWithWeight(e0[im], csf(nm-3, 2*start_m));
             Ep_im.AddWithWeight(e1[im], csf(nm-3, 2*start_m+1));
@@ -349,7 +458,7 @@ GregoryBasis::ProtoBasis::ProtoBasis(
 
             float s1 = 3.0f - 2.0f*csf(n-3,2)-csf(np-3,2),
                   s2 = 2.0f*csf(n-3,2),
-                  s3 = 3.0f -2.0f*cosf(2.0f*float(M_PI)/float(n)) - cosf(2.0f*float(M_PI)/float(nm));
+                  s3 = 3.0f -2.0f*GetRingCos(n, 1) - GetRingCos(nm, 1);
             Ep[vid] = P[vid];
             Ep[vid].AddWithWeight(e0[vid], csf(n-3, 2*start));
             Ep[vid].AddWithWeight(e1[vid], csf(n-3, 2*start +1));
@@ -376,15 +485,15 @@ GregoryBasis::ProtoBasis::ProtoBasis(
 
             float s1 = 3-2*csf(n-3,2)-csf(np-3,2),
                   s2 = 2*csf(n-3,2),
-                  s3 = 3.0f-2.0f*cosf(2.0f*float(M_PI)/n)-cosf(2.0f*float(M_PI)/nm);
+                  s3 = 3.0f-2.0f*GetRingCos(n, 1)-GetRingCos(nm, 1);
 
             Ep[vid] = P[vid];
-            Ep[vid].AddWithWeight(e0[vid], cosf((float(M_PI)*jp)/float(ivalence-1)));
-            Ep[vid].AddWithWeight(e1[vid], sinf((float(M_PI)*jp)/float(ivalence-1)));
+            Ep[vid].AddWithWeight(e0[vid], GetBoundaryCos(ivalence-1, jp));
+            Ep[vid].AddWithWeight(e1[vid], GetBoundarySin(ivalence-1, jp));
 
             Em[vid] = P[vid];
-            Em[vid].AddWithWeight(e0[vid], cosf((float(M_PI)*jm)/float(ivalence-1)));
-            Em[vid].AddWithWeight(e1[vid], sinf((float(M_PI)*jm)/float(ivalence-1)));
+            Em[vid].AddWithWeight(e0[vid], GetBoundaryCos(ivalence-1, jm));
+            Em[vid].AddWithWeight(e1[vid], GetBoundarySin(ivalence-1, jm));
 
             Fp[vid].Clear(stencilCapacity);
             Fp[vid].AddWithWeight(P[vid],    csf(np-3,2)/3.0f);
@@ -407,7 +516,7 @@ GregoryBasis::ProtoBasis::ProtoBasis(
                 Fp[vid].AddWithWeight(rp[start], 1.0f/3.0f);
                 Fm[vid] = Fp[vid];
             } else if (valences[ip]<0) {
-                s1 = 3.0f-2.0f*cosf(2.0f*float(M_PI)/n)-cosf(2.0f*float(M_PI)/nm);
+                s1 = 3.0f-2.0f*GetRingCos(n, 1)-GetRingCos(nm, 1);
                 Fm[vid].Clear(stencilCapacity);
                 Fm[vid].AddWithWeight(P[vid],   csf(nm-3,2)/3.0f);
                 Fm[vid].AddWithWeight(Em[vid],  s1/3.0f);
@@ -185,13 +185,24 @@ public:
     // Given a Vtr::Level and a face index, gathers all the influences of the
     // 1-ring that supports the 20 CVs of a Gregory patch basis.
     //
+    // A ProtoBasis can be computed again for other faces, the buffers of
+    // its points keeping their capacity so that the bases of consecutive
+    // patches do not reallocate them.
+    //
     struct ProtoBasis {
 
+        ProtoBasis() { }
+
         ProtoBasis(Vtr::internal::Level const & level,
                    Vtr::Index faceIndex,
                    int levelVertOffset,
                    int fvarChannel);
 
+        void Compute(Vtr::internal::Level const & level,
+                     Vtr::Index faceIndex,
+                     int levelVertOffset,
+                     int fvarChannel);
+
         int GetNumElements() const;
 
         void Copy(int * sizes, Vtr::Index * indices, float * weights) const;
@@ -226,19 +237,47 @@ public:
 
         // for varying interpolation
         Vtr::Index varyingIndex[4];
+
+    private:
+        // scratch points and rings, retained between faces
+        Point _e0[4], _e1[4], _Em_ip, _Ep_im;
+        Vtr::internal::StackBuffer<Point, 10> _f;
+        Vtr::internal::StackBuffer<Point, 40> _r;
+        Vtr::internal::StackBuffer<Vtr::Index, 40> _rings[4];
     };
 
+    //
+    // Per-valence coefficients of the limit tangent masks, precomputed up
+    // to a valence of 30 and shared by all threads:
+    //
+    //   GetTangentScale(n)   scale of the tangents of a vertex of valence n
+    //   GetRingCos/Sin(n,i)  cos/sin(2*pi*i/n) of the i-th edge of the ring
+    //   GetBoundaryCos/Sin(k,j)  cos/sin(pi*j/k) around a boundary vertex
+    //                        of k faces
+    //
+    static float GetTangentScale(int valence);
+
+    static float GetRingCos(int valence, int i);
+    static float GetRingSin(int valence, int i);
+
+    static float GetBoundaryCos(int numFaces, int j);
+    static float GetBoundarySin(int numFaces, int j);
+
     typedef std::vector<GregoryBasis::Point> PointsVector;
 
     // for basis point stencil
     static void AppendToStencilTable(GregoryBasis::Point const &p,
                                      StencilTable *table) {
-        int size = p.GetSize();
-        table->_sizes.push_back(size);
-        for (int i = 0; i < size; ++i) {
-            table->_indices.push_back(p.GetStencilIndex(i));
-            table->_weights.push_back(p.GetStencilWeight(i));
+        // weights cancelling out are pruned
+        int size = 0;
+        for (int i = 0; i < p.GetSize(); ++i) {
+            if (p.GetStencilWeight(i) != 0.0f) {
+                table->_indices.push_back(p.GetStencilIndex(i));
+                table->_weights.push_back(p.GetStencilWeight(i));
+                ++size;
+            }
         }
+        table->_sizes.push_back(size);
     }
 
     // for varying stencil (just copy)
@@ -0,0 +1,113 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/hierarchicalEdits.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+//
+//  The length of the paths is bounded by the maximum level of refinement:
+//
+namespace {
+    int const MAX_EDIT_LEVEL = 15;
+}
+
+bool
+HierarchicalEdits::addEdit(Type type, Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                           LocalIndex component, Operation op, float sharpness) {
+
+    if ((baseFace < 0) || (numSubfaces < 0) || (numSubfaces > MAX_EDIT_LEVEL) ||
+        (numSubfaces && !subfaces)) {
+        return false;
+    }
+
+    Edit edit;
+    edit.type           = (unsigned char) type;
+    edit.op             = (unsigned char) op;
+    edit.numSubfaces    = (unsigned char) numSubfaces;
+    edit.component      = component;
+    edit.baseFace       = baseFace;
+    edit.subfacesOffset = (int) _subfaces.size();
+    edit.valueIndex     = (type == VERTEX) ? _numVertexEdits : -1;
+    edit.sharpness      = sharpness;
+
+    _edits.push_back(edit);
+    _subfaces.insert(_subfaces.end(), subfaces, subfaces + numSubfaces);
+
+    _numVertexEdits    += (type == VERTEX);
+    _numSharpnessEdits += (type == VERTEX_SHARPNESS) || (type == EDGE_SHARPNESS);
+    return true;
+}
+
+int
+HierarchicalEdits::AddVertexEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                                 LocalIndex vertex, Operation op) {
+
+    if (!addEdit(VERTEX, baseFace, numSubfaces, subfaces, vertex, op, 0.0f)) {
+        return -1;
+    }
+    return _numVertexEdits - 1;
+}
+
+bool
+HierarchicalEdits::AddVertexSharpnessEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                                          LocalIndex vertex, Operation op, float sharpness) {
+
+    return addEdit(VERTEX_SHARPNESS, baseFace, numSubfaces, subfaces, vertex, op, sharpness);
+}
+
+bool
+HierarchicalEdits::AddEdgeSharpnessEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                                        LocalIndex edge, Operation op, float sharpness) {
+
+    return addEdit(EDGE_SHARPNESS, baseFace, numSubfaces, subfaces, edge, op, sharpness);
+}
+
+bool
+HierarchicalEdits::AddHoleEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces) {
+
+    return addEdit(HOLE, baseFace, numSubfaces, subfaces, 0, SET, 0.0f);
+}
+
+bool
+HierarchicalEdits::HasVertexEdits(int level) const {
+
+    for (int i = 0; i < (int)_edits.size(); ++i) {
+        if ((_edits[i].type == VERTEX) && (_edits[i].numSubfaces == level)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
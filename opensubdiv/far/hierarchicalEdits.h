@@ -0,0 +1,178 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_HIERARCHICAL_EDITS_H
+#define OPENSUBDIV3_FAR_HIERARCHICAL_EDITS_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+///  \brief Hierarchical edits of the vertices, edges and faces of refined levels
+///
+///  Edits are addressed as in Hbr : a base face, the path of child faces
+///  leading from it to a face of the level edited (one child face per level,
+///  indexed as the children of the parent face), and a vertex or edge local
+///  to that face.  The level of an edit is the length of its path.
+///
+///  Sharpness and hole edits are applied by the TopologyRefiner as each level
+///  is refined (see TopologyRefiner::SetHierarchicalEdits()).  Vertex edits
+///  modify the value of refined vertices : each edit is assigned an index of
+///  value, the values of all edits being provided by the client as a primvar
+///  buffer (see PrimvarRefiner::ApplyVertexEdits() and StencilTableFactory).
+///
+///  Edits of faces which are not refined (sparse and adaptive refinement) are
+///  ignored.
+///
+class HierarchicalEdits {
+
+public:
+    enum Type {
+        VERTEX,            ///< Value of a vertex
+        VERTEX_SHARPNESS,  ///< Sharpness of a vertex
+        EDGE_SHARPNESS,    ///< Sharpness of an edge
+        HOLE               ///< Face made a hole
+    };
+
+    enum Operation {
+        SET,               ///< The edit replaces the current value
+        ADD,               ///< The edit is added to the current value
+        SUBTRACT           ///< The edit is subtracted from the current value
+    };
+
+    HierarchicalEdits() : _numVertexEdits(0), _numSharpnessEdits(0) { }
+
+    /// \brief Adds an edit of the value of a face vertex and returns the index
+    ///        of its value (or -1 if the path is invalid)
+    ///
+    /// @param baseFace     Base face the path starts from
+    ///
+    /// @param numSubfaces  Length of the path (level of the edit)
+    ///
+    /// @param subfaces     Index of the child face at each level
+    ///
+    /// @param vertex       Vertex local to the face edited
+    ///
+    /// @param op           Operation applied with the value of the edit
+    ///
+    int AddVertexEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                      LocalIndex vertex, Operation op);
+
+    /// \brief Adds an edit of the sharpness of a face vertex (returns false if
+    ///        the path is invalid)
+    bool AddVertexSharpnessEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                                LocalIndex vertex, Operation op, float sharpness);
+
+    /// \brief Adds an edit of the sharpness of a face edge (returns false if
+    ///        the path is invalid)
+    bool AddEdgeSharpnessEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                              LocalIndex edge, Operation op, float sharpness);
+
+    /// \brief Adds an edit making a face a hole (returns false if the path is
+    ///        invalid)
+    bool AddHoleEdit(Index baseFace, int numSubfaces, LocalIndex const * subfaces);
+
+    /// \brief Returns the number of edits
+    int GetNumEdits() const { return (int)_edits.size(); }
+
+    /// \brief Returns the number of vertex edits (and of their values)
+    int GetNumVertexEdits() const { return _numVertexEdits; }
+
+    /// \brief Returns true if there are sharpness edits (of any level)
+    bool HasSharpnessEdits() const { return _numSharpnessEdits > 0; }
+
+    /// \brief Returns true if there are vertex edits of the given level
+    bool HasVertexEdits(int level) const;
+
+    //@{
+    ///  @name Properties of an edit
+    ///
+
+    Type GetEditType(int edit) const { return (Type) _edits[edit].type; }
+
+    Operation GetEditOperation(int edit) const { return (Operation) _edits[edit].op; }
+
+    /// \brief Returns the level of an edit (the length of its path)
+    int GetEditLevel(int edit) const { return _edits[edit].numSubfaces; }
+
+    Index GetEditBaseFace(int edit) const { return _edits[edit].baseFace; }
+
+    ConstLocalIndexArray GetEditSubfaces(int edit) const;
+
+    /// \brief Returns the vertex or edge local to the face of an edit
+    LocalIndex GetEditComponent(int edit) const { return _edits[edit].component; }
+
+    /// \brief Returns the sharpness of a sharpness edit
+    float GetEditSharpness(int edit) const { return _edits[edit].sharpness; }
+
+    /// \brief Returns the index of the value of a vertex edit
+    int GetEditValueIndex(int edit) const { return _edits[edit].valueIndex; }
+
+    //@}
+
+private:
+
+    struct Edit {
+        unsigned char type,
+                      op,
+                      numSubfaces;
+        LocalIndex    component;
+        Index         baseFace;
+        int           subfacesOffset;
+        int           valueIndex;
+        float         sharpness;
+    };
+
+    bool addEdit(Type type, Index baseFace, int numSubfaces, LocalIndex const * subfaces,
+                 LocalIndex component, Operation op, float sharpness);
+
+    std::vector<Edit>       _edits;
+    std::vector<LocalIndex> _subfaces;
+
+    int _numVertexEdits;
+    int _numSharpnessEdits;
+};
+
+inline ConstLocalIndexArray
+HierarchicalEdits::GetEditSubfaces(int edit) const {
+    Edit const & e = _edits[edit];
+    return ConstLocalIndexArray(e.numSubfaces ? &_subfaces[e.subfacesOffset] : 0, e.numSubfaces);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_HIERARCHICAL_EDITS_H */
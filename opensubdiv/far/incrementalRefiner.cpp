@@ -0,0 +1,494 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/incrementalRefiner.h"
+#include "../far/error.h"
+#include "../far/stencilTable.h"
+#include "../far/stencilTableFactory.h"
+#include "../far/streamingRefiner.h"
+#include "../far/topologyDescriptor.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+    //  Refinement of a dirty tile, gathered by the callback of the streaming
+    //  refiner before being moved to the tile
+    struct TileRefinement {
+        std::vector<int>   sizes;
+        std::vector<Index> indices;
+        std::vector<float> weights;
+        std::vector<Index> faceVertices;
+        std::vector<Index> faceParents;
+    };
+
+    struct TileRefinements {
+        std::vector<int> const *    faceTiles;
+        std::vector<Index> const *  faceTileIndices;
+        std::vector<TileRefinement> tiles;
+    };
+
+    //  All dirty tiles are refined together, as a single tile of the streaming
+    //  refiner:  the cost of refining and of computing stencils includes work
+    //  proportional to the base level, which is then paid once per edit rather
+    //  than once per dirty tile.
+    void
+    refineTile(StreamingRefiner::Tile const & tile, void * data) {
+
+        TileRefinements & refinements = *static_cast<TileRefinements *>(data);
+
+        ConstIndexArray lastFaces = tile.GetFaces();
+        if (lastFaces.size() == 0) return;
+
+        //  Stencils of the vertices of the last level of the tile refiner, of
+        //  which only those of the faces of the tile are kept, in the order of
+        //  the faces:
+        TopologyRefiner const & refiner = tile.GetRefiner();
+        int maxLevel = refiner.GetMaxLevel();
+
+        StencilTableFactory::Options options;
+        options.generateIntermediateLevels = false;
+        options.generateOffsets = true;
+
+        StencilTable const * stencils = StencilTableFactory::Create(refiner, options);
+        if (stencils == 0) return;
+
+        TopologyLevel const & lastLevel = refiner.GetLevel(maxLevel);
+
+        //  Sort the faces by dirty tile, then by face, so that the vertices
+        //  of each dirty tile are numbered in the order of its faces:
+        std::vector<std::pair<int, Index> > tileFaces(lastFaces.size());
+        std::vector<Index> faceBaseFaces(lastLevel.GetNumFaces(), INDEX_INVALID);
+        for (int i = 0; i < lastFaces.size(); ++i) {
+            Index baseFace = lastFaces[i];
+            for (int level = maxLevel; level > 0; --level) {
+                baseFace = refiner.GetLevel(level).GetFaceParentFace(baseFace);
+            }
+            faceBaseFaces[lastFaces[i]] = baseFace;
+            tileFaces[i] = std::make_pair((*refinements.faceTiles)[baseFace], lastFaces[i]);
+        }
+        std::sort(tileFaces.begin(), tileFaces.end());
+
+        std::vector<Index> tileVertices(lastLevel.GetNumVertices(), INDEX_INVALID);
+        std::vector<Index> usedVertices;
+        int numTileVertices = 0;
+
+        for (size_t i = 0; i < tileFaces.size(); ++i) {
+            //  Reset the vertices numbered for the previous dirty tile:
+            if (i and (tileFaces[i].first != tileFaces[i-1].first)) {
+                for (size_t j = 0; j < usedVertices.size(); ++j) {
+                    tileVertices[usedVertices[j]] = INDEX_INVALID;
+                }
+                usedVertices.clear();
+                numTileVertices = 0;
+            }
+            TileRefinement & refinement = refinements.tiles[tileFaces[i].first];
+
+            Index face = tileFaces[i].second;
+            refinement.faceParents.push_back(
+                (*refinements.faceTileIndices)[faceBaseFaces[face]]);
+
+            ConstIndexArray faceVerts = lastLevel.GetFaceVertices(face);
+            for (int j = 0; j < faceVerts.size(); ++j) {
+                Index & vertex = tileVertices[faceVerts[j]];
+                if (vertex == INDEX_INVALID) {
+                    vertex = numTileVertices++;
+                    usedVertices.push_back(faceVerts[j]);
+
+                    Stencil stencil = stencils->GetStencil(faceVerts[j]);
+                    refinement.sizes.push_back(stencil.GetSize());
+                    refinement.indices.insert(refinement.indices.end(),
+                        stencil.GetVertexIndices(),
+                        stencil.GetVertexIndices() + stencil.GetSize());
+                    refinement.weights.insert(refinement.weights.end(),
+                        stencil.GetWeights(),
+                        stencil.GetWeights() + stencil.GetSize());
+                }
+                refinement.faceVertices.push_back(vertex);
+            }
+        }
+        delete stencils;
+    }
+}
+
+IncrementalRefiner::IncrementalRefiner(Sdc::SchemeType schemeType,
+    Sdc::Options schemeOptions, Options options) :
+        _schemeType(schemeType),
+        _schemeOptions(schemeOptions),
+        _options(options),
+        _numVertices(0),
+        _baseRefiner(0),
+        _numTilesRefined(0),
+        _stencilTable(0),
+        _assembled(false) {
+}
+
+IncrementalRefiner::~IncrementalRefiner() {
+    delete _baseRefiner;
+    delete _stencilTable;
+}
+
+TopologyRefiner *
+IncrementalRefiner::createBaseRefiner() const {
+
+    TopologyDescriptor desc;
+    desc.numVertices = _numVertices;
+    desc.numFaces = (int)_faceSizes.size();
+    desc.numVertsPerFace = _faceSizes.empty() ? 0 : &_faceSizes[0];
+    desc.vertIndicesPerFace = _faceVertices.empty() ? 0 : &_faceVertices[0];
+
+    typedef TopologyRefinerFactory<TopologyDescriptor> Factory;
+    return Factory::Create(desc,
+        Factory::Options(_schemeType, _schemeOptions));
+}
+
+bool
+IncrementalRefiner::SetTopology(int numVertices, int numFaces,
+    int const * numVertsPerFace, Index const * faceVertices) {
+
+    if (_schemeType == Sdc::SCHEME_BILINEAR) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in IncrementalRefiner::SetTopology() -- "
+            "not supported for Bilinear scheme.");
+        return false;
+    }
+    if (_options.refinementLevel == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in IncrementalRefiner::SetTopology() -- "
+            "the refinement level must be at least 1.");
+        return false;
+    }
+
+    _numVertices = numVertices;
+    _faceSizes.assign(numVertsPerFace, numVertsPerFace + numFaces);
+    _faceOffsets.resize(numFaces);
+    int numFaceVertices = 0;
+    for (int face = 0; face < numFaces; ++face) {
+        _faceOffsets[face] = numFaceVertices;
+        numFaceVertices += numVertsPerFace[face];
+    }
+    _faceVertices.assign(faceVertices, faceVertices + numFaceVertices);
+
+    delete _baseRefiner;
+    _baseRefiner = createBaseRefiner();
+
+    //  tiles of consecutive faces
+    int tileSize = std::max(_options.maxTileFaces, 1);
+
+    _tiles.clear();
+    _tiles.resize((numFaces + tileSize - 1) / tileSize);
+    _faceTiles.resize(numFaces);
+    for (int face = 0; face < numFaces; ++face) {
+        _faceTiles[face] = face / tileSize;
+        _tiles[face / tileSize].baseFaces.push_back(face);
+    }
+    for (int tile = 0; tile < GetNumTiles(); ++tile) {
+        _tiles[tile].dirty = true;
+    }
+
+    return _baseRefiner != 0 and refineDirtyTiles();
+}
+
+bool
+IncrementalRefiner::EditTopology(int numRemovedFaces, Index const * removedFaces,
+    int numAddedVertices, int numAddedFaces,
+    int const * numVertsPerFace, Index const * faceVertices) {
+
+    if (_baseRefiner == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in IncrementalRefiner::EditTopology() -- "
+            "no topology to edit (see SetTopology()).");
+        return false;
+    }
+
+    int numFaces = (int)_faceSizes.size(),
+        numVertices = _numVertices + numAddedVertices;
+
+    //  Validate the edit before changing anything:
+    std::vector<bool> removed(numFaces, false);
+    for (int i = 0; i < numRemovedFaces; ++i) {
+        if (removedFaces[i] < 0 or removedFaces[i] >= numFaces) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in IncrementalRefiner::EditTopology() -- "
+                "face %d removed is not a base face.", removedFaces[i]);
+            return false;
+        }
+        removed[removedFaces[i]] = true;
+    }
+    int numAddedFaceVertices = 0;
+    for (int face = 0; face < numAddedFaces; ++face) {
+        numAddedFaceVertices += numVertsPerFace[face];
+    }
+    for (int i = 0; i < numAddedFaceVertices; ++i) {
+        if (faceVertices[i] < 0 or faceVertices[i] >= numVertices) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in IncrementalRefiner::EditTopology() -- "
+                "vertex %d of an added face is not a base vertex.",
+                faceVertices[i]);
+            return false;
+        }
+    }
+
+    //  The vertices of the faces removed and added, whose neighborhood changes:
+    std::vector<bool> editedVertices(numVertices, false);
+    for (int face = 0; face < numFaces; ++face) {
+        if (not removed[face]) continue;
+        for (int j = 0; j < _faceSizes[face]; ++j) {
+            editedVertices[_faceVertices[_faceOffsets[face] + j]] = true;
+        }
+    }
+    for (int i = 0; i < numAddedFaceVertices; ++i) {
+        editedVertices[faceVertices[i]] = true;
+    }
+
+    //  Compact the faces kept, marking the tiles of the faces removed or
+    //  sharing an edited vertex, and append the faces added:
+    std::vector<int> faceSizes;
+    std::vector<Index> faceVerts;
+    faceSizes.reserve(numFaces - numRemovedFaces + numAddedFaces);
+    faceVerts.reserve(_faceVertices.size() + numAddedFaceVertices);
+
+    std::vector<bool> dirtyTiles(_tiles.size(), false);
+    std::vector<int> faceTiles;
+    faceTiles.reserve(faceSizes.capacity());
+
+    for (int face = 0; face < numFaces; ++face) {
+        int tile = _faceTiles[face];
+        if (removed[face]) {
+            dirtyTiles[tile] = true;
+            continue;
+        }
+        Index const * verts = &_faceVertices[_faceOffsets[face]];
+        for (int j = 0; j < _faceSizes[face]; ++j) {
+            if (editedVertices[verts[j]]) dirtyTiles[tile] = true;
+        }
+        faceSizes.push_back(_faceSizes[face]);
+        faceVerts.insert(faceVerts.end(), verts, verts + _faceSizes[face]);
+        faceTiles.push_back(tile);
+    }
+
+    int tileSize = std::max(_options.maxTileFaces, 1),
+        numOldTiles = (int)_tiles.size();
+    for (int face = 0; face < numAddedFaces; ++face) {
+        faceSizes.push_back(numVertsPerFace[face]);
+        faceTiles.push_back(numOldTiles + face / tileSize);
+    }
+    faceVerts.insert(faceVerts.end(), faceVertices, faceVertices + numAddedFaceVertices);
+
+    //  Rebuild the base level (in time linear with the size of the mesh, but
+    //  far cheaper than its refinement):
+    std::swap(_faceSizes, faceSizes);
+    std::swap(_faceVertices, faceVerts);
+    std::swap(_numVertices, numVertices);
+
+    TopologyRefiner * baseRefiner = createBaseRefiner();
+    if (baseRefiner == 0) {
+        std::swap(_faceSizes, faceSizes);
+        std::swap(_faceVertices, faceVerts);
+        std::swap(_numVertices, numVertices);
+        return false;
+    }
+    delete _baseRefiner;
+    _baseRefiner = baseRefiner;
+
+    numFaces = (int)_faceSizes.size();
+    _faceOffsets.resize(numFaces);
+    for (int face = 0, offset = 0; face < numFaces; ++face) {
+        _faceOffsets[face] = offset;
+        offset += _faceSizes[face];
+    }
+
+    //  Rebuild the face lists of the tiles (marking the new tiles dirty), and
+    //  drop the tiles left without faces:
+    int numTiles = numOldTiles + (numAddedFaces + tileSize - 1) / tileSize;
+    _tiles.resize(numTiles);
+    for (int tile = 0; tile < numTiles; ++tile) {
+        _tiles[tile].baseFaces.clear();
+        _tiles[tile].dirty = (tile >= numOldTiles) or dirtyTiles[tile];
+    }
+    for (int face = 0; face < numFaces; ++face) {
+        _tiles[faceTiles[face]].baseFaces.push_back(face);
+    }
+
+    std::vector<int> tileRemap(numTiles, -1);
+    int numKept = 0;
+    for (int tile = 0; tile < numTiles; ++tile) {
+        if (_tiles[tile].baseFaces.empty()) continue;
+        if (numKept != tile) {
+            Tile & dst = _tiles[numKept];
+            Tile & src = _tiles[tile];
+            dst.baseFaces.swap(src.baseFaces);
+            dst.sizes.swap(src.sizes);
+            dst.indices.swap(src.indices);
+            dst.weights.swap(src.weights);
+            dst.faceVertices.swap(src.faceVertices);
+            dst.faceParents.swap(src.faceParents);
+            dst.dirty = src.dirty;
+        }
+        tileRemap[tile] = numKept++;
+    }
+    _tiles.resize(numKept);
+
+    _faceTiles.resize(numFaces);
+    for (int face = 0; face < numFaces; ++face) {
+        _faceTiles[face] = tileRemap[faceTiles[face]];
+    }
+
+    return refineDirtyTiles();
+}
+
+bool
+IncrementalRefiner::refineDirtyTiles() {
+
+    _assembled = false;
+    _numTilesRefined = 0;
+
+    int numFaces = (int)_faceTiles.size();
+
+    //  Only the faces of dirty tiles are refined, all as the single tile of
+    //  the streaming refiner (the others are assigned no tile).  The index of
+    //  each of these faces within its own tile identifies the parent of the
+    //  refined faces:
+    std::vector<int> baseFaceTiles(numFaces, -1);
+    std::vector<Index> faceTileIndices(numFaces, INDEX_INVALID);
+    for (int tile = 0; tile < GetNumTiles(); ++tile) {
+        Tile const & src = _tiles[tile];
+        if (not src.dirty) continue;
+
+        for (int i = 0; i < (int)src.baseFaces.size(); ++i) {
+            baseFaceTiles[src.baseFaces[i]] = 0;
+            faceTileIndices[src.baseFaces[i]] = i;
+        }
+    }
+
+    TileRefinements refinements;
+    refinements.faceTiles = &_faceTiles;
+    refinements.faceTileIndices = &faceTileIndices;
+    refinements.tiles.resize(_tiles.size());
+
+    StreamingRefiner::Options options(_options.refinementLevel);
+    StreamingRefiner streamingRefiner(*_baseRefiner, options,
+        numFaces ? &baseFaceTiles[0] : 0);
+
+    if (not streamingRefiner.Refine(refineTile, &refinements)) {
+        return false;
+    }
+
+    for (int tile = 0; tile < GetNumTiles(); ++tile) {
+        Tile & dst = _tiles[tile];
+        if (not dst.dirty) continue;
+
+        TileRefinement & src = refinements.tiles[tile];
+        dst.sizes.swap(src.sizes);
+        dst.indices.swap(src.indices);
+        dst.weights.swap(src.weights);
+        dst.faceVertices.swap(src.faceVertices);
+        dst.faceParents.swap(src.faceParents);
+        dst.dirty = false;
+        ++_numTilesRefined;
+    }
+    return true;
+}
+
+void
+IncrementalRefiner::assemble() const {
+
+    if (_assembled) return;
+
+    std::vector<int> sizes;
+    std::vector<Index> indices;
+    std::vector<float> weights;
+
+    size_t numStencils = 0, numWeights = 0, numFaceVertices = 0;
+    for (int tile = 0; tile < GetNumTiles(); ++tile) {
+        numStencils += _tiles[tile].sizes.size();
+        numWeights += _tiles[tile].indices.size();
+        numFaceVertices += _tiles[tile].faceVertices.size();
+    }
+    sizes.reserve(numStencils);
+    indices.reserve(numWeights);
+    weights.reserve(numWeights);
+
+    _refinedFaceVertices.clear();
+    _refinedFaceVertices.reserve(numFaceVertices);
+    _refinedFaceBaseFaces.clear();
+    _refinedFaceBaseFaces.reserve(numFaceVertices / GetNumRefinedFaceVertices());
+
+    for (int tile = 0; tile < GetNumTiles(); ++tile) {
+        Tile const & src = _tiles[tile];
+
+        Index firstVertex = (Index)sizes.size();
+        for (size_t i = 0; i < src.faceVertices.size(); ++i) {
+            _refinedFaceVertices.push_back(firstVertex + src.faceVertices[i]);
+        }
+        for (size_t i = 0; i < src.faceParents.size(); ++i) {
+            _refinedFaceBaseFaces.push_back(src.baseFaces[src.faceParents[i]]);
+        }
+        sizes.insert(sizes.end(), src.sizes.begin(), src.sizes.end());
+        indices.insert(indices.end(), src.indices.begin(), src.indices.end());
+        weights.insert(weights.end(), src.weights.begin(), src.weights.end());
+    }
+
+    delete _stencilTable;
+    _stencilTable = StencilTableFactory::Create(_numVertices,
+        sizes, indices, weights);
+    _assembled = true;
+}
+
+StencilTable const *
+IncrementalRefiner::GetStencilTable() const {
+
+    assemble();
+    return _stencilTable;
+}
+
+int
+IncrementalRefiner::GetNumRefinedFaceVertices() const {
+
+    return (_schemeType == Sdc::SCHEME_LOOP) ? 3 : 4;
+}
+
+std::vector<Index> const &
+IncrementalRefiner::GetRefinedFaceVertices() const {
+
+    assemble();
+    return _refinedFaceVertices;
+}
+
+std::vector<Index> const &
+IncrementalRefiner::GetRefinedFaceBaseFaces() const {
+
+    assemble();
+    return _refinedFaceBaseFaces;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,211 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_INCREMENTAL_REFINER_H
+#define OPENSUBDIV3_FAR_INCREMENTAL_REFINER_H
+
+#include "../version.h"
+
+#include "../sdc/types.h"
+#include "../sdc/options.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TopologyRefiner;
+class StencilTable;
+
+///
+/// \brief Uniform refinement of a mesh updated incrementally by topology edits
+///
+/// Modeling edits (extrusions, deletions, bridges...) change the topology of a
+/// mesh locally : rather than refining the whole mesh again after each edit,
+/// the refinement is held in tiles of base faces, refined with the ring of
+/// neighboring faces supporting them (see StreamingRefiner). An edit
+/// refines again only the tiles whose faces share a vertex with the removed or
+/// added faces -- the refinement of the other tiles is unchanged, since base
+/// vertices are never renumbered. The cost of an edit is then proportional to
+/// the size of the edit (and of the tiles), only the base level and the
+/// concatenation of the tiles into the tables scaling with the mesh.
+///
+/// The tables of the mesh are the stencils of the refined vertices of all the
+/// tiles (from the base vertices) and the vertices of the refined faces.
+///
+/// \note The refined vertices of a tile are indexed locally : vertices on the
+///       boundary of a tile are refined again by the neighboring tiles (see
+///       StreamingRefiner).
+///
+/// \note Schemes Catmark and Loop only (the schemes of sparse refinement), and
+///       topology without tags (creases, corners or holes).
+///
+class IncrementalRefiner {
+public:
+
+    /// \brief Incremental refinement options
+    struct Options {
+
+        Options(int level) :
+            refinementLevel(level),
+            maxTileFaces(256) { }
+
+        unsigned int refinementLevel:4; ///< Number of uniform refinements
+                                        ///< (at least 1)
+        int          maxTileFaces;      ///< Number of base faces of the tiles
+                                        ///< of a new topology or of added faces
+                                        ///< (smaller tiles make edits cheaper,
+                                        ///< at the cost of more duplicated
+                                        ///< boundary vertices)
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param schemeType     Type of subdivision scheme (Catmark or Loop)
+    ///
+    /// @param schemeOptions  Options of the subdivision scheme
+    ///
+    /// @param options        Options controlling the refinement
+    ///
+    IncrementalRefiner(Sdc::SchemeType schemeType,
+                       Sdc::Options schemeOptions, Options options);
+
+    /// \brief Destructor
+    ~IncrementalRefiner();
+
+    /// \brief Sets the topology of the base mesh, refining all of it (returns
+    ///        false on failure)
+    ///
+    /// @param numVertices      Number of base vertices
+    ///
+    /// @param numFaces         Number of base faces
+    ///
+    /// @param numVertsPerFace  Number of vertices of each face
+    ///
+    /// @param faceVertices     Vertices of the faces, face after face
+    ///
+    bool SetTopology(int numVertices, int numFaces,
+                     int const * numVertsPerFace, Index const * faceVertices);
+
+    /// \brief Removes and adds base faces, refining again only the tiles
+    ///        affected (returns false on failure, the mesh being unchanged)
+    ///
+    /// The faces kept keep their order, followed by the added faces : face
+    /// indices are thus compacted, while vertices are never renumbered (the
+    /// vertices left without faces remain, unused).
+    ///
+    /// @param numRemovedFaces    Number of faces removed
+    ///
+    /// @param removedFaces       Base faces removed
+    ///
+    /// @param numAddedVertices   Number of base vertices added (following the
+    ///                           existing ones)
+    ///
+    /// @param numAddedFaces      Number of base faces added
+    ///
+    /// @param numVertsPerFace    Number of vertices of each added face
+    ///
+    /// @param faceVertices       Vertices of the added faces
+    ///
+    bool EditTopology(int numRemovedFaces, Index const * removedFaces,
+                      int numAddedVertices, int numAddedFaces,
+                      int const * numVertsPerFace, Index const * faceVertices);
+
+    /// \brief Returns the refiner of the base level of the mesh (not refined)
+    TopologyRefiner const * GetBaseRefiner() const { return _baseRefiner; }
+
+    /// \brief Returns the number of tiles
+    int GetNumTiles() const { return (int)_tiles.size(); }
+
+    /// \brief Returns the number of tiles refined by the last SetTopology()
+    ///        or EditTopology()
+    int GetNumTilesRefined() const { return _numTilesRefined; }
+
+    /// \brief Returns the stencils of the refined vertices of all the tiles,
+    ///        from the base vertices (owned by the refiner, and valid until
+    ///        the next edit)
+    StencilTable const * GetStencilTable() const;
+
+    /// \brief Returns the number of vertices of the refined faces (4 for
+    ///        Catmark, 3 for Loop)
+    int GetNumRefinedFaceVertices() const;
+
+    /// \brief Returns the refined vertices of the refined faces of all the
+    ///        tiles (indices of the stencils of GetStencilTable())
+    std::vector<Index> const & GetRefinedFaceVertices() const;
+
+    /// \brief Returns the base face of each refined face
+    std::vector<Index> const & GetRefinedFaceBaseFaces() const;
+
+private:
+    //  The refinement of a tile : its base faces, and the stencils and faces
+    //  of its refined vertices indexed locally (the base face of each refined
+    //  face being an index in the base faces of the tile)
+    struct Tile {
+        std::vector<Index> baseFaces;
+        std::vector<int>   sizes;
+        std::vector<Index> indices;
+        std::vector<float> weights;
+        std::vector<Index> faceVertices;
+        std::vector<Index> faceParents;
+        bool               dirty;
+    };
+
+    TopologyRefiner * createBaseRefiner() const;
+    bool refineDirtyTiles();
+    void assemble() const;
+
+private:
+    Sdc::SchemeType _schemeType;
+    Sdc::Options    _schemeOptions;
+    Options         _options;
+
+    //  topology of the base mesh
+    int                _numVertices;
+    std::vector<int>   _faceSizes;
+    std::vector<Index> _faceOffsets;
+    std::vector<Index> _faceVertices;
+
+    TopologyRefiner *  _baseRefiner;
+    std::vector<Tile>  _tiles;
+    std::vector<int>   _faceTiles;   // tile of each base face
+    int                _numTilesRefined;
+
+    //  tables of all the tiles, assembled on demand
+    mutable StencilTable const * _stencilTable;
+    mutable std::vector<Index>   _refinedFaceVertices;
+    mutable std::vector<Index>   _refinedFaceBaseFaces;
+    mutable bool                 _assembled;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_INCREMENTAL_REFINER_H
@@ -0,0 +1,494 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/limitSurfaceQuery.h"
+#include "../far/patchBVH.h"
+#include "../far/taskScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    enum { NUM_SAMPLES = 4,    // samples per direction of the initial guesses
+           MAX_ITERATIONS = 20 };
+
+    inline float
+    dot(float const a[3], float const b[3]) {
+        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    }
+
+    //
+    //  Limit surface of a patch over its (a,b) domain : [0,1]x[0,1] for quads,
+    //  a + b <= 1 for triangles
+    //
+    class PatchSurface {
+    public:
+        PatchSurface(PatchTable const & patchTable,
+                     PatchTable::PatchHandle const & handle,
+                     float const * positions, int stride) :
+            _patchTable(patchTable), _handle(handle),
+            _cvs(patchTable.GetPatchVertices(handle)),
+            _positions(positions), _stride(stride) {
+
+            PatchDescriptor::Type type =
+                patchTable.GetPatchArrayDescriptor(handle.arrayIndex).GetType();
+
+            _param = patchTable.GetPatchParam(handle);
+            _triangle = (type == PatchDescriptor::LOOP) or
+                        (type == PatchDescriptor::TRIANGLES);
+
+            //  derivatives of the face parameterization wrt the domain
+            _scale = _param.GetParamFraction();
+            if (_triangle and _param.IsTriangleRotated()) {
+                _scale = -_scale;
+            }
+        }
+
+        bool IsTriangle() const { return _triangle; }
+
+        void GetFaceLocation(float a, float b, float & s, float & t) const {
+            s = a;
+            t = b;
+            if (_triangle) {
+                _param.UnnormalizeTriangle(s, t);
+            } else {
+                _param.Unnormalize(s, t);
+            }
+        }
+
+        //  Limit position and derivatives at (a,b)
+        void Evaluate(float a, float b, float p[3], float da[3] = 0,
+                      float db[3] = 0) const {
+
+            float s, t;
+            GetFaceLocation(a, b, s, t);
+
+            float wP[20], wDs[20], wDt[20];
+            _patchTable.EvaluateBasis(_handle, s, t, wP, wDs, wDt);
+
+            for (int k = 0; k < 3; ++k) {
+                p[k] = 0.0f;
+                if (da) da[k] = 0.0f;
+                if (db) db[k] = 0.0f;
+            }
+            for (int i = 0; i < _cvs.size(); ++i) {
+                float const * cv = _positions + _cvs[i] * _stride;
+                for (int k = 0; k < 3; ++k) {
+                    p[k] += wP[i] * cv[k];
+                    if (da) da[k] += wDs[i] * _scale * cv[k];
+                    if (db) db[k] += wDt[i] * _scale * cv[k];
+                }
+            }
+        }
+
+        //  Closest location of the domain
+        void Clamp(float & a, float & b) const {
+            a = std::max(0.0f, std::min(1.0f, a));
+            b = std::max(0.0f, std::min(1.0f, b));
+            if (_triangle and (a + b > 1.0f)) {
+                float excess = 0.5f * (a + b - 1.0f);
+                a = std::max(0.0f, a - excess);
+                b = std::max(0.0f, b - excess);
+                a = std::min(a, 1.0f - b);
+            }
+        }
+
+        bool IsInside(float a, float b, float tolerance) const {
+            return (a >= -tolerance) and (b >= -tolerance) and
+                   (a <= 1.0f + tolerance) and (b <= 1.0f + tolerance) and
+                   (not _triangle or (a + b <= 1.0f + tolerance));
+        }
+
+        //  Location (i,j) of the grid of samples (false outside triangles)
+        bool GetSample(int i, int j, float & a, float & b) const {
+            a = ((float)i + 0.5f) / (float)NUM_SAMPLES;
+            b = ((float)j + 0.5f) / (float)NUM_SAMPLES;
+            return not _triangle or (i + j < NUM_SAMPLES);
+        }
+
+    private:
+        PatchTable const &              _patchTable;
+        PatchTable::PatchHandle const & _handle;
+        ConstIndexArray                 _cvs;
+        float const *                   _positions;
+        int                             _stride;
+        PatchParam                      _param;
+        bool                            _triangle;
+        float                           _scale;
+    };
+
+    //  Tolerance of the iterations on a patch, relative to the extent and the
+    //  magnitude of its box
+    inline float
+    getPatchTolerance(PatchBVH const & bvh, PatchTable::PatchHandle const & handle) {
+        float const * box = bvh.GetPatchBox(handle.patchIndex);
+        float scale = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            scale = std::max(scale, box[k+3] - box[k]);
+            scale = std::max(scale, std::max(std::fabs(box[k]), std::fabs(box[k+3])));
+        }
+        return 1e-5f * scale;
+    }
+
+    //  Samples of non-finite positions (e.g. of vertices not yet computed) are
+    //  not starting points of the iterations
+    inline bool
+    isFiniteSquare(float d2) {
+        return d2 <= std::numeric_limits<float>::max();
+    }
+
+    //
+    //  Closest location of a patch to a point : Gauss-Newton iterations on the
+    //  squared distance, projected to the domain, from the closest sample.
+    //  Returns a negative distance (location not found) if no sample is finite
+    //
+    float
+    findClosestOnPatch(PatchSurface const & surface, float const point[3],
+                       float & a, float & b, float closest[3]) {
+
+        a = b = 0.0f;
+
+        float best = -1.0f;
+        for (int j = 0; j < NUM_SAMPLES; ++j) {
+            for (int i = 0; i < NUM_SAMPLES; ++i) {
+                float sa, sb, p[3];
+                if (surface.GetSample(i, j, sa, sb)) {
+                    surface.Evaluate(sa, sb, p);
+                    float r[3] = { p[0]-point[0], p[1]-point[1], p[2]-point[2] },
+                          d2 = dot(r, r);
+                    if (isFiniteSquare(d2) and (best < 0.0f or d2 < best)) {
+                        best = d2;
+                        a = sa;
+                        b = sb;
+                    }
+                }
+            }
+        }
+        if (best < 0.0f) {
+            return -1.0f;
+        }
+
+        float p[3], pa[3], pb[3];
+        surface.Evaluate(a, b, p, pa, pb);
+        for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+
+            float r[3] = { p[0]-point[0], p[1]-point[1], p[2]-point[2] };
+            float f = dot(r, r),
+                  ga = dot(pa, r), gb = dot(pb, r),
+                  haa = dot(pa, pa), hab = dot(pa, pb), hbb = dot(pb, pb),
+                  det = haa * hbb - hab * hab;
+            if (det <= 1e-12f * haa * hbb) {
+                break;
+            }
+            float stepA = -(hbb * ga - hab * gb) / det,
+                  stepB = -(haa * gb - hab * ga) / det;
+
+            //  the step is halved until the distance decreases
+            bool improved = false;
+            for (int halving = 0; halving < 8 and not improved; ++halving) {
+                float na = a + stepA, nb = b + stepB, np[3];
+                surface.Clamp(na, nb);
+                surface.Evaluate(na, nb, np);
+                float nr[3] = { np[0]-point[0], np[1]-point[1], np[2]-point[2] };
+                if (dot(nr, nr) < f) {
+                    improved = true;
+                    stepA = na - a;
+                    stepB = nb - b;
+                    a = na;
+                    b = nb;
+                } else {
+                    stepA *= 0.5f;
+                    stepB *= 0.5f;
+                }
+            }
+            if (not improved) {
+                break;
+            }
+            surface.Evaluate(a, b, p, pa, pb);
+            if (std::fabs(stepA) + std::fabs(stepB) < 1e-6f) {
+                break;
+            }
+        }
+        std::copy(p, p + 3, closest);
+
+        float r[3] = { p[0]-point[0], p[1]-point[1], p[2]-point[2] };
+        return std::sqrt(dot(r, r));
+    }
+
+    //
+    //  Intersection of a ray with a patch : Newton iterations on the
+    //  difference of the surface and the ray, from the sample closest to the
+    //  ray (no intersection if no sample is finite)
+    //
+    bool
+    intersectPatch(PatchSurface const & surface, float const origin[3],
+                   float const direction[3], float tolerance,
+                   float & a, float & b, float & distance, float hit[3]) {
+
+        a = b = distance = 0.0f;
+
+        float dd = dot(direction, direction), best = -1.0f;
+        for (int j = 0; j < NUM_SAMPLES; ++j) {
+            for (int i = 0; i < NUM_SAMPLES; ++i) {
+                float sa, sb, p[3];
+                if (surface.GetSample(i, j, sa, sb)) {
+                    surface.Evaluate(sa, sb, p);
+                    float r[3] = { p[0]-origin[0], p[1]-origin[1], p[2]-origin[2] },
+                          t = dot(r, direction) / dd;
+                    for (int k = 0; k < 3; ++k) {
+                        r[k] -= t * direction[k];
+                    }
+                    float d2 = dot(r, r);
+                    if (isFiniteSquare(d2) and (best < 0.0f or d2 < best)) {
+                        best = d2;
+                        a = sa;
+                        b = sb;
+                        distance = t;
+                    }
+                }
+            }
+        }
+        if (best < 0.0f) {
+            return false;
+        }
+
+        for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+
+            float p[3], pa[3], pb[3];
+            surface.Evaluate(a, b, p, pa, pb);
+
+            float f[3];
+            for (int k = 0; k < 3; ++k) {
+                f[k] = p[k] - origin[k] - distance * direction[k];
+            }
+            if (std::sqrt(dot(f, f)) <= tolerance) {
+                if (not surface.IsInside(a, b, 1e-4f)) {
+                    return false;
+                }
+                surface.Clamp(a, b);
+                std::copy(p, p + 3, hit);
+                return true;
+            }
+
+            //  solves [pa pb -direction] x = -f by Cramer's rule
+            float nd[3] = { -direction[0], -direction[1], -direction[2] };
+            float c0[3] = { pb[1]*nd[2] - pb[2]*nd[1],
+                            pb[2]*nd[0] - pb[0]*nd[2],
+                            pb[0]*nd[1] - pb[1]*nd[0] },
+                  c1[3] = { nd[1]*pa[2] - nd[2]*pa[1],
+                            nd[2]*pa[0] - nd[0]*pa[2],
+                            nd[0]*pa[1] - nd[1]*pa[0] },
+                  c2[3] = { pa[1]*pb[2] - pa[2]*pb[1],
+                            pa[2]*pb[0] - pa[0]*pb[2],
+                            pa[0]*pb[1] - pa[1]*pb[0] };
+            float det = dot(pa, c0);
+            if (det == 0.0f) {
+                return false;
+            }
+            a        -= dot(f, c0) / det;
+            b        -= dot(f, c1) / det;
+            distance -= dot(f, c2) / det;
+
+            //  diverging away from the patch
+            if (not surface.IsInside(a, b, 0.5f)) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    struct ClosestPointContext {
+        PatchTable const * patchTable;
+        float const * positions;
+        int stride;
+        float const * point;
+        LimitSurfaceQuery::Result * result;
+        float maxDistance;
+    };
+
+    float
+    visitClosestPatch(PatchTable::PatchHandle const & handle, void * data) {
+
+        ClosestPointContext & context = *static_cast<ClosestPointContext *>(data);
+
+        PatchSurface surface(*context.patchTable, handle, context.positions,
+            context.stride);
+
+        float a, b, closest[3],
+              distance = findClosestOnPatch(surface, context.point, a, b, closest);
+
+        if ((distance >= 0.0f) and (distance <= context.maxDistance) and
+            (not context.result->handle or
+            distance < context.result->distance)) {
+            context.result->handle = &handle;
+            surface.GetFaceLocation(a, b, context.result->s, context.result->t);
+            std::copy(closest, closest + 3, context.result->point);
+            context.result->distance = distance;
+        }
+        return context.result->handle ? context.result->distance : context.maxDistance;
+    }
+
+    struct BatchContext {
+        LimitSurfaceQuery const * query;
+        float const * points;
+        float const * directions;
+        float maxDistance;
+        LimitSurfaceQuery::Result * results;
+    };
+
+    void
+    findClosestPointRange(int begin, int end, void * data) {
+
+        BatchContext const & context = *static_cast<BatchContext const *>(data);
+        for (int i = begin; i < end; ++i) {
+            context.query->FindClosestPoint(context.points + i * 3,
+                context.maxDistance, context.results[i]);
+        }
+    }
+
+    void
+    intersectRayRange(int begin, int end, void * data) {
+
+        BatchContext const & context = *static_cast<BatchContext const *>(data);
+        for (int i = begin; i < end; ++i) {
+            context.query->IntersectRay(context.points + i * 3,
+                context.directions + i * 3, context.maxDistance,
+                context.results[i]);
+        }
+    }
+
+} // end namespace
+
+LimitSurfaceQuery::LimitSurfaceQuery(PatchTable const & patchTable,
+                                     PatchBVH const & bvh,
+                                     float const * positions, int stride) :
+    _patchTable(patchTable), _bvh(bvh), _positions(positions), _stride(stride) {
+}
+
+bool
+LimitSurfaceQuery::FindClosestPoint(float const point[3], float maxDistance,
+                                    Result & result) const {
+
+    result.handle = 0;
+
+    ClosestPointContext context;
+    context.patchTable = &_patchTable;
+    context.positions = _positions;
+    context.stride = _stride;
+    context.point = point;
+    context.result = &result;
+    context.maxDistance = maxDistance;
+
+    _bvh.VisitNearestPatches(point, maxDistance, visitClosestPatch, &context);
+
+    return result.handle != 0;
+}
+
+bool
+LimitSurfaceQuery::IntersectRay(float const origin[3], float const direction[3],
+                                float maxDistance, Result & result) const {
+
+    result.handle = 0;
+
+    std::vector<Handle const *> handles;
+    std::vector<float> distances;
+    _bvh.IntersectRay(origin, direction, maxDistance, handles, &distances);
+
+    //  The patches are ordered by the distance of their box : the first hit
+    //  is found once the boxes are beyond the closest hit
+    for (int i = 0; i < (int)handles.size(); ++i) {
+        if (result.handle and (distances[i] > result.distance)) {
+            break;
+        }
+        PatchSurface surface(_patchTable, *handles[i], _positions, _stride);
+
+        float tolerance = getPatchTolerance(_bvh, *handles[i]);
+
+        float a, b, distance, hit[3];
+        if (intersectPatch(surface, origin, direction, tolerance,
+                a, b, distance, hit) and
+            (distance >= 0.0f) and (distance <= maxDistance) and
+            (not result.handle or (distance < result.distance))) {
+
+            result.handle = handles[i];
+            surface.GetFaceLocation(a, b, result.s, result.t);
+            std::copy(hit, hit + 3, result.point);
+            result.distance = distance;
+        }
+    }
+    return result.handle != 0;
+}
+
+void
+LimitSurfaceQuery::FindClosestPoints(int count, float const * points,
+                                     float maxDistance, Result * results,
+                                     TaskScheduler const * scheduler) const {
+
+    BatchContext context;
+    context.query = this;
+    context.points = points;
+    context.directions = 0;
+    context.maxDistance = maxDistance;
+    context.results = results;
+
+    if (scheduler) {
+        scheduler->ParallelFor(0, count, 16, findClosestPointRange, &context);
+    } else {
+        findClosestPointRange(0, count, &context);
+    }
+}
+
+void
+LimitSurfaceQuery::IntersectRays(int count, float const * origins,
+                                 float const * directions, float maxDistance,
+                                 Result * results,
+                                 TaskScheduler const * scheduler) const {
+
+    BatchContext context;
+    context.query = this;
+    context.points = origins;
+    context.directions = directions;
+    context.maxDistance = maxDistance;
+    context.results = results;
+
+    if (scheduler) {
+        scheduler->ParallelFor(0, count, 16, intersectRayRange, &context);
+    } else {
+        intersectRayRange(0, count, &context);
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
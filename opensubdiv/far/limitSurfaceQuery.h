@@ -0,0 +1,168 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_LIMIT_SURFACE_QUERY_H
+#define OPENSUBDIV3_FAR_LIMIT_SURFACE_QUERY_H
+
+#include "../version.h"
+
+#include "../far/patchTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class PatchBVH;
+class TaskScheduler;
+
+/// \brief Closest point and ray intersection queries on the limit surface
+///
+/// The patches near a query are located by a PatchBVH, and the location on
+/// each patch is refined by Newton iterations on the basis of the patch (see
+/// PatchTable::EvaluateBasis()), from the closest of a few samples of the
+/// patch. The tables, the hierarchy and the positions are referenced by the
+/// query and must remain valid while it is used : deforming the surface only
+/// requires to refit the hierarchy to the new positions.
+///
+/// Queries only read their data, and can be issued concurrently : the batched
+/// variants apply them to many locations through a TaskScheduler.
+///
+class LimitSurfaceQuery {
+public:
+
+    typedef PatchTable::PatchHandle Handle;
+
+    /// \brief Location found by a query
+    struct Result {
+        Handle const * handle;  ///< Patch of the location (NULL if none)
+        float s, t;             ///< Location (in the face parameterization
+                                ///< of PatchTable::EvaluateBasis())
+        float point[3];         ///< Limit position of the location
+        float distance;         ///< Distance to the point, or along the ray
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param patchTable  PatchTable of the patches
+    ///
+    /// @param bvh         Hierarchy of the patches of the table, fit to the
+    ///                    positions
+    ///
+    /// @param positions   Positions of the control vertices of the patches
+    ///                    (the refined vertices followed by the local points
+    ///                    of the end caps)
+    ///
+    /// @param stride      Number of floats between successive positions
+    ///
+    LimitSurfaceQuery(PatchTable const & patchTable, PatchBVH const & bvh,
+                      float const * positions, int stride = 3);
+
+    /// \brief Finds the closest location of the limit surface to a point
+    ///
+    /// @param point       Location of the point
+    ///
+    /// @param maxDistance Largest distance of the location
+    ///
+    /// @param result      Returned location
+    ///
+    /// @return            False if no location is within maxDistance
+    ///
+    bool FindClosestPoint(float const point[3], float maxDistance,
+                          Result & result) const;
+
+    /// \brief Finds the first intersection of a ray with the limit surface
+    ///
+    /// @param origin      Origin of the ray
+    ///
+    /// @param direction   Direction of the ray
+    ///
+    /// @param maxDistance Largest distance along the ray (in units of the
+    ///                    direction)
+    ///
+    /// @param result      Returned location
+    ///
+    /// @return            False if the ray does not hit the surface
+    ///
+    bool IntersectRay(float const origin[3], float const direction[3],
+                      float maxDistance, Result & result) const;
+
+    /// \brief Finds the closest locations to a set of points (see
+    /// FindClosestPoint())
+    ///
+    /// @param count       Number of points
+    ///
+    /// @param points      Locations of the points (3 floats per point)
+    ///
+    /// @param maxDistance Largest distance of the locations
+    ///
+    /// @param results     Returned location of each point (with a NULL
+    ///                    handle if none is found)
+    ///
+    /// @param scheduler   Scheduler of the concurrent queries (serially if
+    ///                    null)
+    ///
+    void FindClosestPoints(int count, float const * points, float maxDistance,
+                           Result * results,
+                           TaskScheduler const * scheduler = NULL) const;
+
+    /// \brief Intersects a set of rays with the limit surface (see
+    /// IntersectRay())
+    ///
+    /// @param count       Number of rays
+    ///
+    /// @param origins     Origins of the rays (3 floats per ray)
+    ///
+    /// @param directions  Directions of the rays (3 floats per ray)
+    ///
+    /// @param maxDistance Largest distance along the rays
+    ///
+    /// @param results     Returned location of each ray (with a NULL handle
+    ///                    if the ray does not hit the surface)
+    ///
+    /// @param scheduler   Scheduler of the concurrent queries (serially if
+    ///                    null)
+    ///
+    void IntersectRays(int count, float const * origins,
+                       float const * directions, float maxDistance,
+                       Result * results,
+                       TaskScheduler const * scheduler = NULL) const;
+
+private:
+
+    PatchTable const & _patchTable;
+    PatchBVH const &   _bvh;
+    float const *      _positions;
+    int                _stride;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_LIMIT_SURFACE_QUERY_H */
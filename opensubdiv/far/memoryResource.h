@@ -0,0 +1,69 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_MEMORY_RESOURCE_H
+#define OPENSUBDIV3_FAR_MEMORY_RESOURCE_H
+
+#include "../version.h"
+
+#include <cstddef>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+///  \brief Abstract interface for the memory of the refined topology
+///
+///  A MemoryResource assigned to TopologyRefinerFactory::Options provides the
+///  large blocks from which the TopologyRefiner allocates its refined levels
+///  and refinements, so that this memory can be routed through an allocator
+///  of the client (e.g. tracked, huge-page or NUMA-aware).  Blocks are
+///  returned with Deallocate() on Unrefine() or destruction of the refiner,
+///  which a monotonic resource may ignore and release all at once instead --
+///  provided no refiner using it is refined again or destroyed afterwards.
+///
+///  The resource must outlive all refiners using it and be thread-safe if
+///  shared by refiners refined concurrently.
+///
+class MemoryResource {
+
+public:
+    virtual ~MemoryResource() { }
+
+    /// \brief Returns a block of 'size' bytes aligned at least as those of
+    /// operator new (NULL is not a valid result)
+    virtual void * Allocate(size_t size) = 0;
+
+    /// \brief Releases a block previously returned by Allocate(size)
+    virtual void Deallocate(void * ptr, size_t size) = 0;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_MEMORY_RESOURCE_H */
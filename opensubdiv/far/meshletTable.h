@@ -0,0 +1,115 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_MESHLET_TABLE_H
+#define OPENSUBDIV3_FAR_MESHLET_TABLE_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Clusters of the faces of a uniform refinement
+///
+/// Mesh shading pipelines draw small clusters of triangles ("meshlets") of a
+/// bounded number of vertices rather than index buffers : each meshlet lists
+/// its vertices, as indices of the vertex buffer of the refinement (the
+/// control vertices followed by the points evaluated by its StencilTable),
+/// and its triangles as local indices into its own vertices.
+///
+/// The bounds of each meshlet allow whole meshlets to be culled before their
+/// vertices are transformed : a bounding sphere for frustum culling and a
+/// cone of the normals of its triangles for back-face culling. All triangles
+/// of a meshlet face away from an eye position 'eye' if
+///
+///     dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) + radius
+///
+/// See MeshletTableFactory.
+///
+class MeshletTable {
+
+public:
+
+    /// \brief Vertices, triangles and bounds of a meshlet
+    struct Meshlet {
+        int vertexOffset,   ///< first vertex of the meshlet (GetVertices())
+            numVertices,    ///< number of vertices of the meshlet
+            triangleOffset, ///< first triangle of the meshlet (GetTriangles())
+            numTriangles;   ///< number of triangles of the meshlet
+
+        float center[3],    ///< center of the bounding sphere
+              radius;       ///< radius of the bounding sphere
+
+        float coneAxis[3],  ///< average normal of the triangles
+              coneCutoff;   ///< sine of the half-angle of the cone of normals
+                            ///< (1 if the normals span a half-space or more)
+    };
+
+    /// \brief Returns the number of meshlets
+    int GetNumMeshlets() const { return (int)_meshlets.size(); }
+
+    /// \brief Returns a meshlet
+    Meshlet const & GetMeshlet(int meshlet) const { return _meshlets[meshlet]; }
+
+    /// \brief Returns the meshlets
+    std::vector<Meshlet> const & GetMeshlets() const { return _meshlets; }
+
+    /// \brief Returns the vertices of all meshlets (indices of the vertex
+    ///        buffer)
+    std::vector<Index> const & GetVertices() const { return _vertices; }
+
+    /// \brief Returns the triangles of all meshlets (3 local indices into the
+    ///        vertices of the meshlet per triangle)
+    std::vector<unsigned char> const & GetTriangles() const { return _triangles; }
+
+    /// \brief Returns the vertex buffer index of a local vertex of a meshlet
+    Index GetMeshletVertex(int meshlet, int vertex) const {
+        return _vertices[_meshlets[meshlet].vertexOffset + vertex];
+    }
+
+private:
+
+    friend class MeshletTableFactory;
+
+    std::vector<Meshlet>       _meshlets;
+    std::vector<Index>         _vertices;   // vertex buffer index of the
+                                            // vertices of each meshlet
+    std::vector<unsigned char> _triangles;  // local vertices of the triangles
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_MESHLET_TABLE_H
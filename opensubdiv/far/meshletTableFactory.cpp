@@ -0,0 +1,238 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/meshletTableFactory.h"
+#include "../far/patchTable.h"
+#include "../far/error.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //
+    //  Computes the bounding sphere and the cone of normals of a meshlet
+    //
+    void
+    computeMeshletBounds(MeshletTable::Meshlet & meshlet,
+                         Index const * vertices, unsigned char const * triangles,
+                         float const * positions, int stride) {
+
+        //  An empty meshlet is a point at the origin with an open cone (never
+        //  culled) :
+        if (meshlet.numVertices == 0) {
+            for (int k = 0; k < 3; ++k) {
+                meshlet.center[k] = 0.0f;
+                meshlet.coneAxis[k] = 0.0f;
+            }
+            meshlet.radius = 0.0f;
+            meshlet.coneCutoff = 1.0f;
+            return;
+        }
+
+        float const * p0 = positions + vertices[0] * stride;
+        float bmin[3] = { p0[0], p0[1], p0[2] },
+              bmax[3] = { p0[0], p0[1], p0[2] };
+        for (int i = 1; i < meshlet.numVertices; ++i) {
+            float const * p = positions + vertices[i] * stride;
+            for (int k = 0; k < 3; ++k) {
+                bmin[k] = std::min(bmin[k], p[k]);
+                bmax[k] = std::max(bmax[k], p[k]);
+            }
+        }
+
+        float radius2 = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            meshlet.center[k] = 0.5f * (bmin[k] + bmax[k]);
+        }
+        for (int i = 0; i < meshlet.numVertices; ++i) {
+            float const * p = positions + vertices[i] * stride;
+            float d[3] = { p[0] - meshlet.center[0],
+                           p[1] - meshlet.center[1],
+                           p[2] - meshlet.center[2] };
+            radius2 = std::max(radius2, d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+        }
+        meshlet.radius = std::sqrt(radius2);
+
+        //  The axis of the cone averages the unit normals of the triangles
+        //  (degenerate triangles excluded) :
+        std::vector<float> normals(meshlet.numTriangles * 3, 0.0f);
+
+        float axis[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < meshlet.numTriangles; ++i) {
+            unsigned char const * tri = triangles + i * 3;
+            float const * p0 = positions + vertices[tri[0]] * stride,
+                        * p1 = positions + vertices[tri[1]] * stride,
+                        * p2 = positions + vertices[tri[2]] * stride;
+            float e1[3] = { p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2] },
+                  e2[3] = { p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2] };
+            float * n = &normals[i * 3];
+            n[0] = e1[1]*e2[2] - e1[2]*e2[1];
+            n[1] = e1[2]*e2[0] - e1[0]*e2[2];
+            n[2] = e1[0]*e2[1] - e1[1]*e2[0];
+
+            float length = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+            if (length == 0.0f) continue;
+            for (int k = 0; k < 3; ++k) {
+                n[k] /= length;
+                axis[k] += n[k];
+            }
+        }
+
+        float length = std::sqrt(axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2]);
+        for (int k = 0; k < 3; ++k) {
+            meshlet.coneAxis[k] = (length > 0.0f) ? axis[k] / length : 0.0f;
+        }
+
+        float mindp = 1.0f;
+        for (int i = 0; i < meshlet.numTriangles; ++i) {
+            float const * n = &normals[i * 3];
+            if (n[0]==0.0f and n[1]==0.0f and n[2]==0.0f) continue;
+            mindp = std::min(mindp, n[0]*meshlet.coneAxis[0] +
+                                    n[1]*meshlet.coneAxis[1] +
+                                    n[2]*meshlet.coneAxis[2]);
+        }
+        meshlet.coneCutoff = (length > 0.0f and mindp > 0.0f) ?
+            std::sqrt(1.0f - mindp * mindp) : 1.0f;
+    }
+}
+
+MeshletTable const *
+MeshletTableFactory::Create(PatchTable const & table,
+                            float const * positions, int stride,
+                            Options options) {
+
+    if ((positions == NULL) or (stride < 3)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in MeshletTableFactory::Create() -- "
+            "no vertex positions.");
+        return NULL;
+    }
+    if ((options.maxVertices < 4) or (options.maxVertices > 256) or
+        (options.maxTriangles < 2)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in MeshletTableFactory::Create() -- "
+            "meshlets of %d vertices and %d triangles are not supported.",
+            options.maxVertices, options.maxTriangles);
+        return NULL;
+    }
+
+    Index maxVertex = -1;
+    for (int array = 0; array < table.GetNumPatchArrays(); ++array) {
+        PatchDescriptor::Type type = table.GetPatchArrayDescriptor(array).GetType();
+        if ((type != PatchDescriptor::QUADS) and
+            (type != PatchDescriptor::TRIANGLES)) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in MeshletTableFactory::Create() -- "
+                "patches of array %d are not faces of a uniform table.", array);
+            return NULL;
+        }
+        ConstIndexArray verts = table.GetPatchArrayVertices(array);
+        for (int i = 0; i < verts.size(); ++i) {
+            maxVertex = std::max(maxVertex, verts[i]);
+        }
+    }
+
+    MeshletTable * result = new MeshletTable;
+
+    std::vector<MeshletTable::Meshlet> & meshlets = result->_meshlets;
+    std::vector<Index> & vertices = result->_vertices;
+    std::vector<unsigned char> & triangles = result->_triangles;
+
+    //  Local index of each vertex of the current meshlet (-1 otherwise)
+    std::vector<int> localIndices(maxVertex + 1, -1);
+
+    MeshletTable::Meshlet meshlet;
+    meshlet.vertexOffset = meshlet.numVertices = 0;
+    meshlet.triangleOffset = meshlet.numTriangles = 0;
+
+    for (int array = 0; array < table.GetNumPatchArrays(); ++array) {
+
+        int nverts = table.GetPatchArrayDescriptor(array).GetNumControlVertices(),
+            ntris = nverts - 2;
+
+        for (int patch = 0; patch < table.GetNumPatches(array); ++patch) {
+
+            ConstIndexArray fverts = table.GetPatchVertices(array, patch);
+
+            int newVerts = 0;
+            for (int i = 0; i < nverts; ++i) {
+                bool duplicate = false;
+                for (int j = 0; j < i; ++j) {
+                    duplicate |= (fverts[j] == fverts[i]);
+                }
+                newVerts += (localIndices[fverts[i]] < 0) and not duplicate;
+            }
+
+            //  Close the current meshlet when the face doesn't fit:
+            if ((meshlet.numVertices + newVerts > options.maxVertices) or
+                (meshlet.numTriangles + ntris > options.maxTriangles)) {
+
+                computeMeshletBounds(meshlet, &vertices[meshlet.vertexOffset],
+                    &triangles[meshlet.triangleOffset * 3], positions, stride);
+                meshlets.push_back(meshlet);
+
+                for (int i = 0; i < meshlet.numVertices; ++i) {
+                    localIndices[vertices[meshlet.vertexOffset + i]] = -1;
+                }
+                meshlet.vertexOffset = (int)vertices.size();
+                meshlet.triangleOffset = (int)triangles.size() / 3;
+                meshlet.numVertices = meshlet.numTriangles = 0;
+            }
+
+            unsigned char local[4];
+            for (int i = 0; i < nverts; ++i) {
+                int & index = localIndices[fverts[i]];
+                if (index < 0) {
+                    index = meshlet.numVertices++;
+                    vertices.push_back(fverts[i]);
+                }
+                local[i] = (unsigned char)index;
+            }
+            for (int i = 0; i < ntris; ++i) {
+                triangles.push_back(local[0]);
+                triangles.push_back(local[i + 1]);
+                triangles.push_back(local[i + 2]);
+            }
+            meshlet.numTriangles += ntris;
+        }
+    }
+    if (meshlet.numTriangles) {
+        computeMeshletBounds(meshlet, &vertices[meshlet.vertexOffset],
+            &triangles[meshlet.triangleOffset * 3], positions, stride);
+        meshlets.push_back(meshlet);
+    }
+    return result;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,87 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_MESHLET_TABLE_FACTORY_H
+#define OPENSUBDIV3_FAR_MESHLET_TABLE_FACTORY_H
+
+#include "../version.h"
+
+#include "../far/meshletTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class PatchTable;
+
+/// \brief A specialized factory for MeshletTable
+///
+class MeshletTableFactory {
+
+public:
+
+    struct Options {
+
+        Options() : maxVertices(64), maxTriangles(124) { }
+
+        int maxVertices,  ///< Maximum number of vertices of a meshlet (at most 256)
+            maxTriangles; ///< Maximum number of triangles of a meshlet
+    };
+
+    /// \brief Instantiates the MeshletTable of the faces of a uniform
+    ///        PatchTable
+    ///
+    /// Faces are gathered in the order of the table, quads split into two
+    /// triangles, until the next face exceeds the vertices or triangles of
+    /// the meshlet : faces reordered for the vertex cache first (see
+    /// PatchTableFactory::OptimizeVertexCache()) share more of their
+    /// vertices, and yield fewer meshlets.
+    ///
+    /// The bounds of the meshlets are those of the positions of the vertices
+    /// refined for the table (e.g. by its StencilTable).
+    ///
+    /// @param table      Uniform PatchTable (QUADS or TRIANGLES)
+    ///
+    /// @param positions  Positions of the vertices indexed by the table
+    ///
+    /// @param stride     Number of floats between consecutive positions
+    ///
+    /// @param options    Options controlling the size of the meshlets
+    ///
+    /// @return           A new instance of MeshletTable (NULL on failure)
+    ///
+    static MeshletTable const * Create(PatchTable const & table,
+                                       float const * positions, int stride=3,
+                                       Options options=Options());
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_MESHLET_TABLE_FACTORY_H
@@ -0,0 +1,488 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/patchBVH.h"
+#include "../far/error.h"
+#include "../far/taskScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    enum { MAX_LEAF_PATCHES = 4 };
+
+    //  Handles of all the patches of a table, in the order of the table
+    void
+    getPatchHandles(PatchTable const & patchTable,
+                    std::vector<PatchTable::PatchHandle> & handles) {
+
+        handles.resize(patchTable.GetNumPatchesTotal());
+        for (int array = 0, patch = 0; array < patchTable.GetNumPatchArrays(); ++array) {
+            int ncvs = patchTable.GetPatchArrayDescriptor(array).GetNumControlVertices();
+            for (int i = 0; i < patchTable.GetNumPatches(array); ++i, ++patch) {
+                handles[patch].arrayIndex = array;
+                handles[patch].patchIndex = patch;
+                handles[patch].vertIndex = i * ncvs;
+            }
+        }
+    }
+
+    bool
+    hasConvexHulls(PatchTable const & patchTable) {
+
+        for (int array = 0; array < patchTable.GetNumPatchArrays(); ++array) {
+            PatchDescriptor::Type type =
+                patchTable.GetPatchArrayDescriptor(array).GetType();
+            if (type == PatchDescriptor::GREGORY or
+                type == PatchDescriptor::GREGORY_BOUNDARY) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct BoundsContext {
+        PatchTable const * patchTable;
+        PatchTable::PatchHandle const * handles;
+        float const * positions;
+        int stride;
+        float * boxes;
+        float * spheres;
+    };
+
+    void
+    computeBoundsRange(int begin, int end, void * data) {
+
+        BoundsContext const & context = *static_cast<BoundsContext const *>(data);
+
+        for (int patch = begin; patch < end; ++patch) {
+
+            ConstIndexArray cvs =
+                context.patchTable->GetPatchVertices(context.handles[patch]);
+
+            float box[6];
+            for (int i = 0; i < cvs.size(); ++i) {
+                float const * p = context.positions + cvs[i] * context.stride;
+                for (int k = 0; k < 3; ++k) {
+                    box[k]   = i ? std::min(box[k],   p[k]) : p[k];
+                    box[k+3] = i ? std::max(box[k+3], p[k]) : p[k];
+                }
+            }
+            if (context.boxes) {
+                std::copy(box, box + 6, context.boxes + patch * 6);
+            }
+
+            //  The sphere is centered on the box, and is usually tighter than
+            //  the sphere of the box itself
+            if (context.spheres) {
+                float * sphere = context.spheres + patch * 4,
+                        radius2 = 0.0f;
+                for (int k = 0; k < 3; ++k) {
+                    sphere[k] = 0.5f * (box[k] + box[k+3]);
+                }
+                for (int i = 0; i < cvs.size(); ++i) {
+                    float const * p = context.positions + cvs[i] * context.stride;
+                    float d[3] = { p[0] - sphere[0],
+                                   p[1] - sphere[1],
+                                   p[2] - sphere[2] };
+                    radius2 = std::max(radius2, d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+                }
+                sphere[3] = std::sqrt(radius2);
+            }
+        }
+    }
+
+    inline void
+    mergeBox(float box[6], float const other[6]) {
+        for (int k = 0; k < 3; ++k) {
+            box[k]   = std::min(box[k],   other[k]);
+            box[k+3] = std::max(box[k+3], other[k+3]);
+        }
+    }
+
+    //  Distances at which a ray enters and leaves a box (empty if tmin > tmax)
+    inline void
+    intersectBox(float const box[6], float const origin[3],
+                 float const invDirection[3], float & tmin, float & tmax) {
+
+        for (int k = 0; k < 3; ++k) {
+            float t0 = (box[k]   - origin[k]) * invDirection[k],
+                  t1 = (box[k+3] - origin[k]) * invDirection[k];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            //  written for NaNs (ray in the plane of a face) to keep the
+            //  current interval
+            tmin = (t0 > tmin) ? t0 : tmin;
+            tmax = (t1 < tmax) ? t1 : tmax;
+        }
+    }
+
+    //  Distance from a point to a box (0 inside)
+    inline float
+    distanceToBox(float const box[6], float const point[3]) {
+
+        float d2 = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            float d = std::max(0.0f, std::max(box[k] - point[k],
+                                              point[k] - box[k+3]));
+            d2 += d * d;
+        }
+        return std::sqrt(d2);
+    }
+
+    //  Orders the patches crossed by a ray by entry distance
+    struct PatchEntry {
+        float distance;
+        int patch;
+
+        bool operator < (PatchEntry const & other) const {
+            return (distance < other.distance) or
+                   (distance == other.distance and patch < other.patch);
+        }
+    };
+
+    //  Compares the centers of patches along an axis
+    struct CenterLess {
+        CenterLess(std::vector<float> const & centers, int axis) :
+            _centers(centers), _axis(axis) { }
+
+        bool operator () (int a, int b) const {
+            return _centers[a * 3 + _axis] < _centers[b * 3 + _axis];
+        }
+
+        std::vector<float> const & _centers;
+        int _axis;
+    };
+
+} // end namespace
+
+bool
+PatchBVH::ComputePatchBounds(PatchTable const & patchTable,
+                             float const * positions, int stride,
+                             float * boxes, float * spheres,
+                             TaskScheduler const * scheduler) {
+
+    if (not hasConvexHulls(patchTable)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchBVH::ComputePatchBounds() -- "
+            "legacy Gregory patches are not supported.");
+        return false;
+    }
+
+    int numPatches = patchTable.GetNumPatchesTotal();
+    if (numPatches == 0) {
+        return true;
+    }
+
+    std::vector<PatchTable::PatchHandle> handles;
+    getPatchHandles(patchTable, handles);
+
+    BoundsContext context;
+    context.patchTable = &patchTable;
+    context.handles = &handles[0];
+    context.positions = positions;
+    context.stride = stride;
+    context.boxes = boxes;
+    context.spheres = spheres;
+
+    if (scheduler) {
+        scheduler->ParallelFor(0, numPatches, 256, computeBoundsRange, &context);
+    } else {
+        computeBoundsRange(0, numPatches, &context);
+    }
+    return true;
+}
+
+PatchBVH::PatchBVH(PatchTable const & patchTable, float const * positions,
+                   int stride) {
+
+    int numPatches = patchTable.GetNumPatchesTotal();
+
+    _boxes.resize(numPatches * 6);
+    if (numPatches == 0 or not ComputePatchBounds(patchTable, positions,
+            stride, &_boxes[0], 0)) {
+        _boxes.clear();
+        return;
+    }
+
+    getPatchHandles(patchTable, _handles);
+
+    //  The patches are split at the median of their centers along the longest
+    //  axis of the box of the centers, until leaves have at most
+    //  MAX_LEAF_PATCHES patches
+    std::vector<float> centers(numPatches * 3);
+    for (int patch = 0; patch < numPatches; ++patch) {
+        for (int k = 0; k < 3; ++k) {
+            centers[patch * 3 + k] =
+                0.5f * (_boxes[patch * 6 + k] + _boxes[patch * 6 + k + 3]);
+        }
+    }
+
+    _patches.resize(numPatches);
+    for (int patch = 0; patch < numPatches; ++patch) {
+        _patches[patch] = patch;
+    }
+    _nodes.reserve(2 * (numPatches / MAX_LEAF_PATCHES + 1));
+
+    build(0, numPatches, centers);
+    refitNodes();
+}
+
+int
+PatchBVH::build(int first, int count, std::vector<float> const & centers) {
+
+    int nodeIndex = (int)_nodes.size();
+    _nodes.push_back(Node());
+
+    if (count <= MAX_LEAF_PATCHES) {
+        _nodes[nodeIndex].offset = first;
+        _nodes[nodeIndex].count = count;
+        return nodeIndex;
+    }
+
+    float cmin[3], cmax[3];
+    for (int i = 0; i < count; ++i) {
+        float const * c = &centers[_patches[first + i] * 3];
+        for (int k = 0; k < 3; ++k) {
+            cmin[k] = i ? std::min(cmin[k], c[k]) : c[k];
+            cmax[k] = i ? std::max(cmax[k], c[k]) : c[k];
+        }
+    }
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis]) {
+            axis = k;
+        }
+    }
+
+    int half = count / 2;
+    std::nth_element(_patches.begin() + first, _patches.begin() + first + half,
+        _patches.begin() + first + count, CenterLess(centers, axis));
+
+    build(first, half, centers);
+    int second = build(first + half, count - half, centers);
+
+    _nodes[nodeIndex].offset = second;
+    _nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+void
+PatchBVH::refitNodes() {
+
+    //  Children follow their parents : the nodes are merged in reverse order
+    for (int i = (int)_nodes.size() - 1; i >= 0; --i) {
+        Node & node = _nodes[i];
+        if (node.IsLeaf()) {
+            float const * box = &_boxes[_patches[node.offset] * 6];
+            std::copy(box, box + 6, node.box);
+            for (int j = 1; j < node.count; ++j) {
+                mergeBox(node.box, &_boxes[_patches[node.offset + j] * 6]);
+            }
+        } else {
+            std::copy(_nodes[i + 1].box, _nodes[i + 1].box + 6, node.box);
+            mergeBox(node.box, _nodes[node.offset].box);
+        }
+    }
+}
+
+bool
+PatchBVH::Refit(PatchTable const & patchTable, float const * positions,
+                int stride, TaskScheduler const * scheduler) {
+
+    if (_nodes.empty() or
+        patchTable.GetNumPatchesTotal() != GetNumPatches()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchBVH::Refit() -- mismatched patch table.");
+        return false;
+    }
+    if (not ComputePatchBounds(patchTable, positions, stride, &_boxes[0], 0,
+            scheduler)) {
+        return false;
+    }
+    refitNodes();
+    return true;
+}
+
+void
+PatchBVH::FindPatches(float const point[3],
+                      std::vector<Handle const *> & handles) const {
+
+    handles.clear();
+    if (_nodes.empty()) {
+        return;
+    }
+
+    int stack[64], depth = 0;
+    stack[depth++] = 0;
+    while (depth) {
+        int nodeIndex = stack[--depth];
+        Node const & node = _nodes[nodeIndex];
+
+        bool inside = true;
+        for (int k = 0; k < 3; ++k) {
+            inside = inside and (point[k] >= node.box[k]) and
+                                (point[k] <= node.box[k+3]);
+        }
+        if (not inside) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            for (int j = 0; j < node.count; ++j) {
+                int patch = _patches[node.offset + j];
+                float const * box = &_boxes[patch * 6];
+                if (point[0] >= box[0] and point[0] <= box[3] and
+                    point[1] >= box[1] and point[1] <= box[4] and
+                    point[2] >= box[2] and point[2] <= box[5]) {
+                    handles.push_back(&_handles[patch]);
+                }
+            }
+        } else {
+            stack[depth++] = node.offset;
+            stack[depth++] = nodeIndex + 1;
+        }
+    }
+}
+
+void
+PatchBVH::IntersectRay(float const origin[3], float const direction[3],
+                       float maxDistance,
+                       std::vector<Handle const *> & handles,
+                       std::vector<float> * distances) const {
+
+    handles.clear();
+    if (distances) {
+        distances->clear();
+    }
+    if (_nodes.empty()) {
+        return;
+    }
+
+    float invDirection[3];
+    for (int k = 0; k < 3; ++k) {
+        invDirection[k] = 1.0f / direction[k];
+    }
+
+    std::vector<PatchEntry> entries;
+
+    int stack[64], depth = 0;
+    stack[depth++] = 0;
+    while (depth) {
+        int nodeIndex = stack[--depth];
+        Node const & node = _nodes[nodeIndex];
+
+        float tmin = 0.0f, tmax = maxDistance;
+        intersectBox(node.box, origin, invDirection, tmin, tmax);
+        if (tmin > tmax) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            for (int j = 0; j < node.count; ++j) {
+                PatchEntry entry;
+                entry.patch = _patches[node.offset + j];
+                entry.distance = 0.0f;
+                float tleave = maxDistance;
+                intersectBox(&_boxes[entry.patch * 6], origin, invDirection,
+                    entry.distance, tleave);
+                if (entry.distance <= tleave) {
+                    entries.push_back(entry);
+                }
+            }
+        } else {
+            stack[depth++] = node.offset;
+            stack[depth++] = nodeIndex + 1;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    handles.resize(entries.size());
+    if (distances) {
+        distances->resize(entries.size());
+    }
+    for (int i = 0; i < (int)entries.size(); ++i) {
+        handles[i] = &_handles[entries[i].patch];
+        if (distances) {
+            (*distances)[i] = entries[i].distance;
+        }
+    }
+}
+
+void
+PatchBVH::VisitNearestPatches(float const point[3], float maxDistance,
+                              NearestPatchVisitor visitor, void * data) const {
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    //  Nodes and patches are visited best first : entries are the distance
+    //  of a node (index >= 0) or of a patch (~index)
+    typedef std::pair<float, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+
+    queue.push(Entry(distanceToBox(_nodes[0].box, point), 0));
+    while (not queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+
+        if (entry.first > maxDistance) {
+            break;
+        }
+        if (entry.second < 0) {
+            maxDistance = std::min(maxDistance,
+                visitor(_handles[~entry.second], data));
+            continue;
+        }
+
+        Node const & node = _nodes[entry.second];
+        if (node.IsLeaf()) {
+            for (int j = 0; j < node.count; ++j) {
+                int patch = _patches[node.offset + j];
+                queue.push(Entry(distanceToBox(&_boxes[patch * 6], point), ~patch));
+            }
+        } else {
+            int children[2] = { entry.second + 1, node.offset };
+            for (int j = 0; j < 2; ++j) {
+                queue.push(Entry(distanceToBox(_nodes[children[j]].box, point),
+                                 children[j]));
+            }
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
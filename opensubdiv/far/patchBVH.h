@@ -0,0 +1,209 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_PATCH_BVH_H
+#define OPENSUBDIV3_FAR_PATCH_BVH_H
+
+#include "../version.h"
+
+#include "../far/patchTable.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TaskScheduler;
+
+/// \brief A bounding volume hierarchy over the patches of a PatchTable
+///
+/// The limit surface of each patch lies in the convex hull of its control
+/// vertices (B-spline, Gregory basis, Loop, bilinear and triangular patches),
+/// so the bounds of the control vertices of the patches bound the surface
+/// without evaluating it. The hierarchy of these bounds locates the patches
+/// containing points of space or crossed by rays, to be intersected or
+/// evaluated (see PatchTable::EvaluateBasis()) by the client.
+///
+/// As the topology of the hierarchy only depends on the initial positions,
+/// deformed positions only require to Refit() the bounds.
+///
+/// \note The legacy Gregory patches (ENDCAP_LEGACY_GREGORY) have no convex
+///       hull property : they are not supported.
+///
+class PatchBVH {
+public:
+
+    typedef PatchTable::PatchHandle Handle;
+
+    /// \brief Computes the bounds of the control vertices of each patch
+    ///
+    /// @param patchTable  PatchTable of the patches
+    ///
+    /// @param positions   Positions of the control vertices of the patches
+    ///                    (the refined vertices followed by the local points
+    ///                    of the end caps)
+    ///
+    /// @param stride      Number of floats between successive positions
+    ///
+    /// @param boxes       Returned box of each patch (6 floats : the minimum
+    ///                    then the maximum coordinates) or NULL
+    ///
+    /// @param spheres     Returned sphere of each patch (4 floats : the
+    ///                    center then the radius) or NULL
+    ///
+    /// @param scheduler   Scheduler computing the bounds of the patches
+    ///                    concurrently (serially if null)
+    ///
+    /// @return            False if the table has legacy Gregory patches
+    ///
+    static bool ComputePatchBounds(PatchTable const & patchTable,
+                                   float const * positions, int stride,
+                                   float * boxes, float * spheres,
+                                   TaskScheduler const * scheduler = NULL);
+
+    /// \brief Constructor
+    ///
+    /// The hierarchy is empty if the table has legacy Gregory patches.
+    ///
+    /// @param patchTable  PatchTable of the patches
+    ///
+    /// @param positions   Positions of the control vertices of the patches
+    ///
+    /// @param stride      Number of floats between successive positions
+    ///
+    PatchBVH(PatchTable const & patchTable, float const * positions,
+             int stride = 3);
+
+    /// \brief Updates the bounds of the hierarchy from new positions of the
+    /// control vertices
+    ///
+    /// @param patchTable  PatchTable the hierarchy was built from
+    ///
+    /// @param positions   Positions of the control vertices of the patches
+    ///
+    /// @param stride      Number of floats between successive positions
+    ///
+    /// @param scheduler   Scheduler computing the bounds of the patches
+    ///                    concurrently (serially if null)
+    ///
+    /// @return            False if the hierarchy is empty or does not match
+    ///                    the table
+    ///
+    bool Refit(PatchTable const & patchTable, float const * positions,
+               int stride = 3, TaskScheduler const * scheduler = NULL);
+
+    /// \brief Returns the number of patches of the hierarchy
+    int GetNumPatches() const { return (int)_handles.size(); }
+
+    /// \brief Returns the handle of a patch
+    Handle const & GetHandle(int patch) const { return _handles[patch]; }
+
+    /// \brief Returns the box of a patch (minimum then maximum coordinates)
+    float const * GetPatchBox(int patch) const { return &_boxes[patch * 6]; }
+
+    /// \brief Returns the box of all the patches
+    float const * GetBox() const { return _nodes.empty() ? 0 : _nodes[0].box; }
+
+    /// \brief Returns the patches whose box contains a point
+    ///
+    /// @param point    Location of the point
+    ///
+    /// @param handles  Returned handles of the patches
+    ///
+    void FindPatches(float const point[3],
+                     std::vector<Handle const *> & handles) const;
+
+    /// \brief Returns the patches whose box is crossed by a ray, in the order
+    /// of the distances at which the ray enters the boxes
+    ///
+    /// @param origin     Origin of the ray
+    ///
+    /// @param direction  Direction of the ray
+    ///
+    /// @param maxDistance Largest distance along the ray (in units of the
+    ///                   direction)
+    ///
+    /// @param handles    Returned handles of the patches
+    ///
+    /// @param distances  Returned distances at which the ray enters the box
+    ///                   of each patch (optional)
+    ///
+    void IntersectRay(float const origin[3], float const direction[3],
+                      float maxDistance,
+                      std::vector<Handle const *> & handles,
+                      std::vector<float> * distances = 0) const;
+
+    /// \brief Function applied to the patches by VisitNearestPatches() :
+    /// returns the largest distance of the patches still to visit
+    typedef float (*NearestPatchVisitor)(Handle const & handle, void * data);
+
+    /// \brief Visits the patches in the order of the distance of their box
+    /// to a point, as long as this distance does not exceed the (decreasing)
+    /// distance returned by the visitor
+    ///
+    /// @param point       Location of the point
+    ///
+    /// @param maxDistance Largest distance of the patches to visit
+    ///
+    /// @param visitor     Function applied to each patch
+    ///
+    /// @param data        Client data passed to the visitor
+    ///
+    void VisitNearestPatches(float const point[3], float maxDistance,
+                             NearestPatchVisitor visitor, void * data) const;
+
+private:
+
+    // Nodes are stored in depth-first order : the first child of an interior
+    // node follows it, and its second child is at 'offset'. Leaves have the
+    // 'count' patches of _patches from 'offset'.
+    struct Node {
+        float box[6];
+        int offset,
+            count;
+
+        bool IsLeaf() const { return count > 0; }
+    };
+
+    int build(int first, int count, std::vector<float> const & centers);
+
+    void refitNodes();
+
+    std::vector<Handle> _handles;  // all the patches of the PatchTable
+    std::vector<float>  _boxes;    // box of each patch
+    std::vector<int>    _patches;  // patches in the order of the leaves
+    std::vector<Node>   _nodes;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_PATCH_BVH_H */
@@ -25,6 +25,7 @@
 #include "../far/patchBasis.h"
 
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
 namespace OpenSubdiv {
@@ -45,15 +46,14 @@ class Spline {
 
 public:
 
-    // curve weights
-    static void GetWeights(float t, float point[], float deriv[]);
-
-    // box-spline weights
-    static void GetWeights(float v, float w, float point[]);
+    // curve weights (and optional second derivatives)
+    static void GetWeights(float t, float point[], float deriv[],
+        float deriv2[] = 0);
 
     // patch weights
     static void GetPatchWeights(PatchParam const & param,
-        float s, float t, float point[], float deriv1[], float deriv2[]);
+        float s, float t, float point[], float deriv1[], float deriv2[],
+        float deriv11[] = 0, float deriv12[] = 0, float deriv22[] = 0);
 
     // adjust patch weights for boundary (and corner) edges
     static void AdjustBoundaryWeights(PatchParam const & param,
@@ -62,7 +62,7 @@ public:
 
 template <>
 inline void Spline<BASIS_BEZIER>::GetWeights(
-    float t, float point[4], float deriv[4]) {
+    float t, float point[4], float deriv[4], float deriv2[4]) {
 
     // The four uniform cubic Bezier basis functions (in terms of t and its
     // complement tC) evaluated at t:
@@ -83,11 +83,19 @@ inline void Spline<BASIS_BEZIER>::GetWeights(
        deriv[2] = -9.0f * t2 +  6.0f * t;
        deriv[3] =  3.0f * t2;
     }
+
+    // Second derivatives of the basis functions at t:
+    if (deriv2) {
+       deriv2[0] =   6.0f * tC;
+       deriv2[1] =  18.0f * t - 12.0f;
+       deriv2[2] = -18.0f * t +  6.0f;
+       deriv2[3] =   6.0f * t;
+    }
 }
 
 template <>
 inline void Spline<BASIS_BSPLINE>::GetWeights(
-    float t, float point[4], float deriv[4]) {
+    float t, float point[4], float deriv[4], float deriv2[4]) {
 
     // The four uniform cubic B-Spline basis functions evaluated at t:
     float const one6th = 1.0f / 6.0f;
@@ -108,64 +116,20 @@ inline void Spline<BASIS_BSPLINE>::GetWeights(
         deriv[2] = -1.5f*t2 +      t + 0.5f;
         deriv[3] =  0.5f*t2;
     }
-}
-
-template <>
-inline void Spline<BASIS_BOX_SPLINE>::GetWeights(
-    float v, float w, float point[12]) {
-
-    float u = 1.0f - v - w;
-
-    //
-    //  The 12 basis functions of the quartic box spline (unscaled by their common
-    //  factor of 1/12 until later, and formatted to make it easy to spot any
-    //  typing errors):
-    //
-    //      15 terms for the 3 points above the triangle corners
-    //       9 terms for the 3 points on faces opposite the triangle edges
-    //       2 terms for the 6 points on faces opposite the triangle corners
-    //
-    //  Powers of each variable for notational convenience:
-    float u2 = u*u;
-    float u3 = u*u2;
-    float u4 = u*u3;
-    float v2 = v*v;
-    float v3 = v*v2;
-    float v4 = v*v3;
-    float w2 = w*w;
-    float w3 = w*w2;
-    float w4 = w*w3;
-
-    //  And now the basis functions:
-    point[ 0] = u4 + 2.0f*u3*v;
-    point[ 1] = u4 + 2.0f*u3*w;
-    point[ 8] = w4 + 2.0f*w3*u;
-    point[11] = w4 + 2.0f*w3*v;
-    point[ 9] = v4 + 2.0f*v3*w;
-    point[ 5] = v4 + 2.0f*v3*u;
-
-    point[ 2] = u4 + 2.0f*u3*w + 6.0f*u3*v + 6.0f*u2*v*w + 12.0f*u2*v2 +
-                v4 + 2.0f*v3*w + 6.0f*v3*u + 6.0f*v2*u*w;
-    point[ 4] = w4 + 2.0f*w3*v + 6.0f*w3*u + 6.0f*w2*u*v + 12.0f*w2*u2 +
-                u4 + 2.0f*u3*v + 6.0f*u3*w + 6.0f*u2*v*w;
-    point[10] = v4 + 2.0f*v3*u + 6.0f*v3*w + 6.0f*v2*w*u + 12.0f*v2*w2 +
-                w4 + 2.0f*w3*u + 6.0f*w3*v + 6.0f*w3*u*v;
-
-    point[ 3] = v4 + 6*v3*w + 8*v3*u + 36*v2*w*u + 24*v2*u2 + 24*v*u3 +
-                w4 + 6*w3*v + 8*w3*u + 36*w2*v*u + 24*w2*u2 + 24*w*u3 + 6*u4 + 60*u2*v*w + 12*v2*w2;
-    point[ 6] = w4 + 6*w3*u + 8*w3*v + 36*w2*u*v + 24*w2*v2 + 24*w*v3 +
-                u4 + 6*u3*w + 8*u3*v + 36*u2*v*w + 24*u2*v2 + 24*u*v3 + 6*v4 + 60*v2*w*u + 12*w2*u2;
-    point[ 7] = u4 + 6*u3*v + 8*u3*w + 36*u2*v*w + 24*u2*w2 + 24*u*w3 +
-                v4 + 6*v3*u + 8*v3*w + 36*v2*u*w + 24*v2*w2 + 24*v*w3 + 6*w4 + 60*w2*u*v + 12*u2*v2;
 
-    for (int i = 0; i < 12; ++i) {
-        point[i] *= 1.0f / 12.0f;
+    // Second derivatives of the basis functions at t:
+    if (deriv2) {
+        deriv2[0] = -       t + 1.0f;
+        deriv2[1] =  3.0f * t - 2.0f;
+        deriv2[2] = -3.0f * t + 1.0f;
+        deriv2[3] =         t;
     }
 }
 
 template <>
 inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
-    float s, float t, float point[4], float derivS[4], float derivT[4]) {
+    float s, float t, float point[4], float derivS[4], float derivT[4],
+    float derivSS[4], float derivST[4], float derivTT[4]) {
 
     param.Normalize(s,t);
 
@@ -191,6 +155,147 @@ inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
         derivT[1] =  -s * dScale;
         derivT[2] =   s * dScale;
         derivT[3] =  sC * dScale;
+
+        // Only the mixed partial of a bilinear patch is non-zero:
+        if (derivSS and derivST and derivTT) {
+            float d2Scale = dScale * dScale;
+
+            for (int i = 0; i < 4; ++i) {
+                derivSS[i] = 0.0f;
+                derivTT[i] = 0.0f;
+            }
+            derivST[0] =  d2Scale;
+            derivST[1] = -d2Scale;
+            derivST[2] =  d2Scale;
+            derivST[3] = -d2Scale;
+        }
+    }
+}
+
+//
+//  The 12 points of a regular (Loop) triangular patch -- the patch is the
+//  triangle {4, 5, 8}, parameterized with s along {4, 5} and t along {4, 8}:
+//
+//             10 ---- 11
+//            .  .    .  .
+//           .    .  .    .
+//          7 ---- 8 ---- 9
+//         .  .   .  .   .  .
+//        .    . .    . .    .
+//       3 ---- 4 ---- 5 ---- 6
+//        .    . .    . .    .
+//         .  .   .  .   .  .
+//          0 ---- 1 ---- 2
+//
+//  The weights of the points are the quartic box spline basis functions,
+//  expressed in the bivariate monomials of (s,t) with a common factor of 1/12
+//  (the monomials are ordered s^i t^j for increasing i, then j, as below):
+//
+static float const boxSplineMonomialCoefficients[12][15] = {
+    //   1  t  t2  t3  t4    s  st st2 st3   s2 s2t s2t2  s3 s3t  s4
+    {    1,-4,  6, -4,  1,  -2,  6, -6,  2,   0,  0,   0,  2, -2, -1 },
+    {    1,-2,  0,  2, -1,   2, -6,  6, -2,   0,  0,   0, -4,  4,  2 },
+    {    0, 0,  0,  0,  0,   0,  0,  0,  0,   0,  0,   0,  2, -2, -1 },
+    {    1,-2,  0,  2, -1,  -4,  6,  0, -2,   6, -6,   0, -4,  2,  1 },
+    {    6, 0,-12,  8, -1,   0,-12, 12, -2, -12, 12,   0,  8, -2, -1 },
+    {    1, 2,  0, -4,  2,   4,  6,-12,  4,   6, -6,   0, -4, -2, -1 },
+    {    0, 0,  0,  0,  0,   0,  0,  0,  0,   0,  0,   0,  0,  2,  1 },
+    {    1, 2,  0, -4,  2,  -2, -6,  0,  4,   0,  6,   0,  2, -2, -1 },
+    {    1, 4,  6, -4, -1,   2,  6, -6, -2,   0,-12,   0, -4,  4,  2 },
+    {    0, 0,  0,  2, -1,   0,  0,  6, -2,   0,  6,   0,  2, -2, -1 },
+    {    0, 0,  0,  2, -1,   0,  0,  0, -2,   0,  0,   0,  0,  0,  0 },
+    {    0, 0,  0,  0,  1,   0,  0,  0,  2,   0,  0,   0,  0,  0,  0 }
+};
+
+//
+//  Points of a boundary patch beyond a boundary edge (or beyond the boundary
+//  through a corner of the patch, when bit 3 of the boundary mask is set) are
+//  extrapolated from the points of the patch, i.e. P = Pa + Pb - Pc, which
+//  preserves the boundary rules of the Loop scheme:
+//
+static void
+adjustBoxSplineBoundaryWeights(int boundary, float weights[12]) {
+
+    //  { P, Pa, Pb, Pc } for the points beyond each edge or corner:
+    static int const edgePoints[3][3][4] = {
+        { {  0,  3,  4,  7 }, {  1,  4,  5,  8 }, {  2,  5,  6,  9 } },
+        { {  9,  5,  8,  4 }, {  6,  2,  5,  1 }, { 11,  8, 10,  7 } },
+        { {  3,  0,  4,  1 }, {  7,  4,  8,  5 }, { 10,  8, 11,  9 } } };
+    static int const cornerPoints[3][2][4] = {
+        { {  3,  7,  4,  8 }, {  0,  4,  1,  5 } },
+        { {  2,  1,  5,  4 }, {  6,  5,  9,  8 } },
+        { { 10,  7,  8,  4 }, { 11,  8,  9,  5 } } };
+
+    bool corners = (boundary & 8) != 0;
+
+    for (int i = 0; i < 3; ++i) {
+        if (not (boundary & (1 << i))) continue;
+
+        int numPoints = corners ? 2 : 3;
+        for (int j = 0; j < numPoints; ++j) {
+            int const * p = corners ? cornerPoints[i][j] : edgePoints[i][j];
+
+            weights[p[1]] += weights[p[0]];
+            weights[p[2]] += weights[p[0]];
+            weights[p[3]] -= weights[p[0]];
+            weights[p[0]] = 0.0f;
+        }
+    }
+}
+
+template <>
+inline void Spline<BASIS_BOX_SPLINE>::GetPatchWeights(PatchParam const & param,
+    float s, float t, float point[12], float derivS[12], float derivT[12],
+    float derivSS[12], float derivST[12], float derivTT[12]) {
+
+    //  Derivatives of rotated triangles are reversed with their parameters:
+    float dScale = (float)(1 << param.GetDepth());
+    if (param.IsTriangleRotated()) {
+        dScale = -dScale;
+    }
+
+    param.NormalizeTriangle(s,t);
+
+    bool second = derivS and derivT and derivSS and derivST and derivTT;
+
+    //  The monomials and their derivatives:
+    float sPow[5] = { 1.0f, s, s*s, s*s*s, s*s*s*s },
+          tPow[5] = { 1.0f, t, t*t, t*t*t, t*t*t*t };
+
+    float M[15], Ms[15], Mt[15], Mss[15], Mst[15], Mtt[15];
+    for (int i = 0, k = 0; i <= 4; ++i) {
+        for (int j = 0; j <= 4 - i; ++j, ++k) {
+            M[k]   = sPow[i] * tPow[j];
+            Ms[k]  = i ? (float)i * sPow[i-1] * tPow[j] : 0.0f;
+            Mt[k]  = j ? (float)j * sPow[i] * tPow[j-1] : 0.0f;
+            Mss[k] = (i > 1) ? (float)(i*(i-1)) * sPow[i-2] * tPow[j] : 0.0f;
+            Mst[k] = (i and j) ? (float)(i*j) * sPow[i-1] * tPow[j-1] : 0.0f;
+            Mtt[k] = (j > 1) ? (float)(j*(j-1)) * sPow[i] * tPow[j-2] : 0.0f;
+        }
+    }
+
+    float const * monomials[6] = { M, Ms, Mt, Mss, Mst, Mtt };
+    float * weights[6] = { point, derivS, derivT,
+                           second ? derivSS : 0, second ? derivST : 0, second ? derivTT : 0 };
+    float scales[6] = { 1.0f, dScale, dScale,
+                        dScale * dScale, dScale * dScale, dScale * dScale };
+
+    int boundary = param.GetBoundary();
+
+    for (int d = 0; d < 6; ++d) {
+        if (not weights[d]) continue;
+
+        float scale = scales[d] / 12.0f;
+        for (int i = 0; i < 12; ++i) {
+            float w = 0.0f;
+            for (int k = 0; k < 15; ++k) {
+                w += boxSplineMonomialCoefficients[i][k] * monomials[d][k];
+            }
+            weights[d][i] = w * scale;
+        }
+        if (boundary) {
+            adjustBoxSplineBoundaryWeights(boundary, weights[d]);
+        }
     }
 }
 
@@ -224,14 +329,20 @@ void Spline<BASIS>::AdjustBoundaryWeights(PatchParam const & param,
 
 template <SplineBasis BASIS>
 void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
-    float s, float t, float point[16], float derivS[16], float derivT[16]) {
+    float s, float t, float point[16], float derivS[16], float derivT[16],
+    float derivSS[16], float derivST[16], float derivTT[16]) {
+
+    float sWeights[4], tWeights[4], dsWeights[4], dtWeights[4],
+          dssWeights[4], dttWeights[4];
 
-    float sWeights[4], tWeights[4], dsWeights[4], dtWeights[4];
+    bool second = derivSS and derivST and derivTT;
 
     param.Normalize(s,t);
 
-    Spline<BASIS>::GetWeights(s, point ? sWeights : 0, derivS ? dsWeights : 0);
-    Spline<BASIS>::GetWeights(t, point ? tWeights : 0, derivT ? dtWeights : 0);
+    Spline<BASIS>::GetWeights(s, point ? sWeights : 0, derivS ? dsWeights : 0,
+        second ? dssWeights : 0);
+    Spline<BASIS>::GetWeights(t, point ? tWeights : 0, derivT ? dtWeights : 0,
+        second ? dttWeights : 0);
 
     if (point) {
         // Compute the tensor product weight of the (s,t) basis function
@@ -260,29 +371,207 @@ void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
                 derivT[4*i+j] = sWeights[j] * dtWeights[i] * dScale;
             }
         }
+
+        if (second) {
+            float d2Scale = dScale * dScale;
+
+            AdjustBoundaryWeights(param, dssWeights, dttWeights);
+
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                    derivSS[4*i+j] = dssWeights[j] * tWeights[i] * d2Scale;
+                    derivST[4*i+j] = dsWeights[j] * dtWeights[i] * d2Scale;
+                    derivTT[4*i+j] = sWeights[j] * dttWeights[i] * d2Scale;
+                }
+            }
+        }
     }
 }
 
 void GetBilinearWeights(PatchParam const & param,
-    float s, float t, float point[4], float deriv1[4], float deriv2[4]) {
+    float s, float t, float point[4], float deriv1[4], float deriv2[4],
+    float deriv11[4], float deriv12[4], float deriv22[4]) {
 
-    Spline<BASIS_BILINEAR>::GetPatchWeights(param, s, t, point, deriv1, deriv2);
+    Spline<BASIS_BILINEAR>::GetPatchWeights(param, s, t, point, deriv1, deriv2,
+        deriv11, deriv12, deriv22);
 }
 
-void GetBezierWeights(PatchParam const param,
-    float s, float t, float point[16], float deriv1[16], float deriv2[16]) {
+void GetBezierWeights(PatchParam const & param,
+    float s, float t, float point[16], float deriv1[16], float deriv2[16],
+    float deriv11[16], float deriv12[16], float deriv22[16]) {
 
-    Spline<BASIS_BEZIER>::GetPatchWeights(param, s, t, point, deriv1, deriv2);
+    Spline<BASIS_BEZIER>::GetPatchWeights(param, s, t, point, deriv1, deriv2,
+        deriv11, deriv12, deriv22);
 }
 
 void GetBSplineWeights(PatchParam const & param,
-    float s, float t, float point[16], float deriv1[16], float deriv2[16]) {
+    float s, float t, float point[16], float deriv1[16], float deriv2[16],
+    float deriv11[16], float deriv12[16], float deriv22[16]) {
+
+    Spline<BASIS_BSPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2,
+        deriv11, deriv12, deriv22);
+}
+
+//
+//  Single-crease patches are segmented across the crease at 1 - 2^-floor(S)
+//  and 1 - 2^-ceil(S) (S being the sharpness) : each segment is a Bezier
+//  patch whose points are combinations of the B-Spline points across the
+//  crease, given by the matrices below for a crease on the side of the last
+//  points (rows are the Bezier points).  The fractional part of the sharpness
+//  blends the matrices of the neighboring integer sharpnesses.
+//
+static float const infSharpCreaseMatrix[4][4] = {
+    { 1.0f/6.0f, 4.0f/6.0f, 1.0f/6.0f, 0.0f },
+    { 0.0f,      4.0f/6.0f, 2.0f/6.0f, 0.0f },
+    { 0.0f,      2.0f/6.0f, 4.0f/6.0f, 0.0f },
+    { 0.0f,      0.0f,      1.0f,      0.0f }
+};
+
+static void
+computeSingleCreaseMatrix(float sharpness, float m[4][4]) {
+
+    float s = powf(2.0f, sharpness),
+          s2 = s * s,
+          s3 = s2 * s;
+
+    float const c[4][4] = {
+        { 0.0f, s + 1 + 3*s2 - s3, 7*s - 2 - 6*s2 + 2*s3, (1-s)*(s-1)*(s-1) },
+        { 0.0f,       (1+s)*(1+s),        6*s - 2 - 2*s2,       (s-1)*(s-1) },
+        { 0.0f,               1+s,               6*s - 2,               1-s },
+        { 0.0f,              1.0f,               6*s - 2,              1.0f }
+    };
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            m[i][j] = c[i][j] / (6.0f * s);
+        }
+    }
+    m[0][0] = 1.0f / 6.0f;
+}
+
+static void
+getSingleCreaseSegmentMatrix(float sharpness, float segment, float m[4][4]) {
+
+    float sFloor = floorf(sharpness),
+          sCeil = ceilf(sharpness),
+          sFrac = sharpness - sFloor;
+
+    if (segment <= 1.0f - powf(2.0f, -sFloor)) {
+        memcpy(m, infSharpCreaseMatrix, sizeof(infSharpCreaseMatrix));
+        return;
+    }
+
+    float mFloor[4][4], mOther[4][4];
+    computeSingleCreaseMatrix(sFloor, mFloor);
+    if (segment <= 1.0f - powf(2.0f, -sCeil)) {
+        memcpy(mOther, infSharpCreaseMatrix, sizeof(infSharpCreaseMatrix));
+    } else {
+        computeSingleCreaseMatrix(sCeil, mOther);
+    }
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            m[i][j] = (1.0f - sFrac) * mFloor[i][j] + sFrac * mOther[i][j];
+        }
+    }
+}
+
+// Combines the Bezier weights of a segment into weights of the B-Spline points
+static void
+applySingleCreaseMatrix(float const m[4][4], bool flip, float weights[4]) {
+
+    float bezier[4];
+    memcpy(bezier, weights, sizeof(bezier));
+    for (int k = 0; k < 4; ++k) {
+        weights[k] = 0.0f;
+        for (int j = 0; j < 4; ++j) {
+            weights[k] += flip ? bezier[3-j] * m[j][3-k] : bezier[j] * m[j][k];
+        }
+    }
+}
+
+void GetBSplineSingleCreaseWeights(PatchParam const & param,
+    float sharpness, float s, float t,
+    float point[16], float derivS[16], float derivT[16],
+    float derivSS[16], float derivST[16], float derivTT[16]) {
+
+    if (sharpness <= 0.0f) {
+        GetBSplineWeights(param, s, t, point, derivS, derivT,
+            derivSS, derivST, derivTT);
+        return;
+    }
+
+    float sWeights[4], tWeights[4], dsWeights[4], dtWeights[4],
+          dssWeights[4], dttWeights[4];
+
+    bool deriv = derivS and derivT,
+         second = deriv and derivSS and derivST and derivTT;
+
+    param.Normalize(s,t);
+
+    //  The crease is along t=0 (1), s=1 (2), t=1 (4) or s=0 (8) : the
+    //  weights across the crease are Bezier weights of the segment of the
+    //  patch containing (s,t), and B-Spline weights along the crease
+    int boundary = param.GetBoundary();
+
+    bool acrossT = (boundary & 5) != 0,
+         flip = (boundary & 9) != 0;
+
+    float x = acrossT ? t : s;
+
+    float m[4][4];
+    getSingleCreaseSegmentMatrix(sharpness, flip ? 1.0f - x : x, m);
+
+    Spline<BASIS_BEZIER>::GetWeights(x,
+        acrossT ? tWeights : sWeights,
+        deriv ? (acrossT ? dtWeights : dsWeights) : 0,
+        second ? (acrossT ? dttWeights : dssWeights) : 0);
+    Spline<BASIS_BSPLINE>::GetWeights(acrossT ? s : t,
+        acrossT ? sWeights : tWeights,
+        deriv ? (acrossT ? dsWeights : dtWeights) : 0,
+        second ? (acrossT ? dssWeights : dttWeights) : 0);
+
+    applySingleCreaseMatrix(m, flip, acrossT ? tWeights : sWeights);
+    if (deriv) {
+        applySingleCreaseMatrix(m, flip, acrossT ? dtWeights : dsWeights);
+    }
+    if (second) {
+        applySingleCreaseMatrix(m, flip, acrossT ? dttWeights : dssWeights);
+    }
+
+    if (point) {
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                point[4*i+j] = sWeights[j] * tWeights[i];
+            }
+        }
+    }
+
+    if (deriv) {
+        float dScale = (float)(1 << param.GetDepth());
+
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                derivS[4*i+j] = dsWeights[j] * tWeights[i] * dScale;
+                derivT[4*i+j] = sWeights[j] * dtWeights[i] * dScale;
+            }
+        }
+
+        if (second) {
+            float d2Scale = dScale * dScale;
 
-    Spline<BASIS_BSPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2);
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                    derivSS[4*i+j] = dssWeights[j] * tWeights[i] * d2Scale;
+                    derivST[4*i+j] = dsWeights[j] * dtWeights[i] * d2Scale;
+                    derivTT[4*i+j] = sWeights[j] * dttWeights[i] * d2Scale;
+                }
+            }
+        }
+    }
 }
 
 void GetGregoryWeights(PatchParam const & param,
-    float s, float t, float point[20], float deriv1[20], float deriv2[20]) {
+    float s, float t, float point[20], float deriv1[20], float deriv2[20],
+    float deriv11[20], float deriv12[20], float deriv22[20]) {
 
     //
     //  P3         e3-      e2+         P2
@@ -321,13 +610,15 @@ void GetGregoryWeights(PatchParam const & param,
     //  interior points will be denoted G -- so we have B(s), B(t) and G(s,t):
     //
     //  Directional Bezier basis functions B at s and t:
-    float Bs[4], Bds[4];
-    float Bt[4], Bdt[4];
+    float Bs[4], Bds[4], Bdss[4];
+    float Bt[4], Bdt[4], Bdtt[4];
+
+    bool second = deriv11 and deriv12 and deriv22;
 
     param.Normalize(s,t);
 
-    Spline<BASIS_BEZIER>::GetWeights(s, Bs, deriv1 ? Bds : 0);
-    Spline<BASIS_BEZIER>::GetWeights(t, Bt, deriv2 ? Bdt : 0);
+    Spline<BASIS_BEZIER>::GetWeights(s, Bs, deriv1 ? Bds : 0, second ? Bdss : 0);
+    Spline<BASIS_BEZIER>::GetWeights(t, Bt, deriv2 ? Bdt : 0, second ? Bdtt : 0);
 
     //  Rational multipliers G at s and t:
     float sC = 1.0f - s;
@@ -424,6 +715,76 @@ void GetGregoryWeights(PatchParam const & param,
             deriv2[iDst] = (Bdt[tRow] * G[i] + Bt[tRow] * Gdt) * Bs[sCol] * dScale;
         }
 #endif
+
+        //  Second derivatives always use the Bezier pseudo-derivatives above, i.e. the
+        //  interior weights are the (scaled) Bezier tensor products with G+ or G-:
+        if (second) {
+            float d2Scale = dScale * dScale;
+
+            for (int i = 0; i < 12; ++i) {
+                int iDst = boundaryGregory[i];
+                int tRow = boundaryBezTRow[i];
+                int sCol = boundaryBezSCol[i];
+
+                deriv11[iDst] = Bdss[sCol] * Bt[tRow] * d2Scale;
+                deriv12[iDst] = Bds[sCol] * Bdt[tRow] * d2Scale;
+                deriv22[iDst] = Bs[sCol] * Bdtt[tRow] * d2Scale;
+            }
+            for (int i = 0; i < 8; ++i) {
+                int iDst = interiorGregory[i];
+                int tRow = interiorBezTRow[i];
+                int sCol = interiorBezSCol[i];
+
+                deriv11[iDst] = Bdss[sCol] * Bt[tRow] * G[i] * d2Scale;
+                deriv12[iDst] = Bds[sCol] * Bdt[tRow] * G[i] * d2Scale;
+                deriv22[iDst] = Bs[sCol] * Bdtt[tRow] * G[i] * d2Scale;
+            }
+        }
+    }
+}
+
+void GetLoopWeights(PatchParam const & param,
+    float s, float t, float point[12], float deriv1[12], float deriv2[12],
+    float deriv11[12], float deriv12[12], float deriv22[12]) {
+
+    Spline<BASIS_BOX_SPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2,
+        deriv11, deriv12, deriv22);
+}
+
+void GetTriangleWeights(PatchParam const & param,
+    float s, float t, float point[3], float deriv1[3], float deriv2[3],
+    float deriv11[3], float deriv12[3], float deriv22[3]) {
+
+    float dScale = (float)(1 << param.GetDepth());
+    if (param.IsTriangleRotated()) {
+        dScale = -dScale;
+    }
+
+    param.NormalizeTriangle(s,t);
+
+    if (point) {
+        point[0] = 1.0f - s - t;
+        point[1] = s;
+        point[2] = t;
+    }
+
+    if (deriv1 and deriv2) {
+        deriv1[0] = -dScale;
+        deriv1[1] =  dScale;
+        deriv1[2] =  0.0f;
+
+        deriv2[0] = -dScale;
+        deriv2[1] =  0.0f;
+        deriv2[2] =  dScale;
+
+        // All second derivatives of a linear patch are zero:
+        if (deriv11 and deriv12 and deriv22) {
+            for (int i = 0; i < 3; ++i) {
+                deriv11[i] = 0.0f;
+                deriv12[i] = 0.0f;
+                deriv22[i] = 0.0f;
+            }
+        }
     }
 }
 
@@ -45,18 +45,50 @@ namespace internal {
 // So this interface will be changing in future.
 //
 
+//
+// Second derivatives (wDss, wDst, wDtt) are optional and only computed when
+// all three arrays and the first derivatives are given.
+//
+
 void GetBilinearWeights(PatchParam const & patchParam,
-    float s, float t, float wP[4], float wDs[4], float wDt[4]);
+    float s, float t, float wP[4], float wDs[4], float wDt[4],
+    float wDss[4] = 0, float wDst[4] = 0, float wDtt[4] = 0);
 
 void GetBezierWeights(PatchParam const & patchParam,
-    float s, float t, float wP[16], float wDs[16], float wDt[16]);
+    float s, float t, float wP[16], float wDs[16], float wDt[16],
+    float wDss[16] = 0, float wDst[16] = 0, float wDtt[16] = 0);
 
 void GetBSplineWeights(PatchParam const & patchParam,
-    float s, float t, float wP[16], float wDs[16], float wDt[16]);
+    float s, float t, float wP[16], float wDs[16], float wDt[16],
+    float wDss[16] = 0, float wDst[16] = 0, float wDtt[16] = 0);
+
+//
+// Single-crease patches : regular B-Spline patches with a semi-sharp crease
+// along the edge identified by the boundary mask of their PatchParam, which
+// are evaluated piecewise across the crease as in the Osd shaders (the
+// sharpness may be fractional)
+//
+
+void GetBSplineSingleCreaseWeights(PatchParam const & patchParam,
+    float sharpness, float s, float t,
+    float wP[16], float wDs[16], float wDt[16],
+    float wDss[16] = 0, float wDst[16] = 0, float wDtt[16] = 0);
 
 void GetGregoryWeights(PatchParam const & patchParam,
-    float s, float t, float wP[20], float wDs[20], float wDt[20]);
+    float s, float t, float wP[20], float wDs[20], float wDt[20],
+    float wDss[20] = 0, float wDst[20] = 0, float wDtt[20] = 0);
+
+//
+// Triangular patches of the Loop scheme (see PatchParam::NormalizeTriangle())
+//
+
+void GetLoopWeights(PatchParam const & patchParam,
+    float s, float t, float wP[12], float wDs[12], float wDt[12],
+    float wDss[12] = 0, float wDst[12] = 0, float wDtt[12] = 0);
 
+void GetTriangleWeights(PatchParam const & patchParam,
+    float s, float t, float wP[3], float wDs[3], float wDt[3],
+    float wDss[3] = 0, float wDst[3] = 0, float wDtt[3] = 0);
 
 } // end namespace internal
 } // end namespace Far
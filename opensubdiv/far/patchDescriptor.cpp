@@ -42,7 +42,6 @@ ConstPatchDescriptorArray
 PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SchemeType type) {
 
     static PatchDescriptor _loopDescriptors[] = {
-        // XXXX work in progress !
         PatchDescriptor(LOOP),
     };
 
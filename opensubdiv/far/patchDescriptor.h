@@ -47,6 +47,9 @@ namespace Far {
 /// * Adaptively subdivided meshes contain bicubic patches of types REGULAR,
 ///   GREGORY, GREGORY_BOUNDARY, GREGORY_BASIS.
 ///
+/// * Adaptively subdivided Loop meshes contain quartic box-spline patches of
+///   type LOOP, and TRIANGLES around the remaining irregular features.
+///
 /// Bitfield layout :
 ///
 ///  Field       | Bits | Content
@@ -124,6 +127,9 @@ public:
     /// \brief Number of control vertices of Regular Patches in table.
     static short GetRegularPatchSize() { return 16; }
 
+    /// \brief Number of control vertices of Loop (box-spline) Patches in table.
+    static short GetLoopPatchSize() { return 12; }
+
     /// \brief Number of control vertices of Gregory (and Gregory Boundary) Patches in table.
     static short GetGregoryPatchSize() { return 4; }
 
@@ -155,6 +161,7 @@ inline short
 PatchDescriptor::GetNumControlVertices( Type type ) {
     switch (type) {
         case REGULAR           : return GetRegularPatchSize();
+        case LOOP              : return GetLoopPatchSize();
         case QUADS             : return 4;
         case GREGORY           :
         case GREGORY_BOUNDARY  : return GetGregoryPatchSize();
@@ -42,25 +42,29 @@ PatchMap::QuadNode::SetChild(int patchIdx) {
     for (int i=0; i<4; ++i) {
         children[i].isSet=true;
         children[i].isLeaf=true;
+        children[i].isTriangle=false;
         children[i].idx=patchIdx;
     }
 }
 
 // sets the child in "quadrant" to point to the node or patch of the given index
 void
-PatchMap::QuadNode::SetChild(unsigned char quadrant, int idx, bool isLeaf) {
+PatchMap::QuadNode::SetChild(unsigned char quadrant, int idx, bool isLeaf,
+    bool isTriangle) {
     assert(quadrant<4);
-    children[quadrant].isSet  = true;
-    children[quadrant].isLeaf = isLeaf;
-    children[quadrant].idx    = idx;
+    children[quadrant].isSet      = true;
+    children[quadrant].isLeaf     = isLeaf;
+    children[quadrant].isTriangle = isTriangle;
+    children[quadrant].idx        = idx;
 }
 
 // adds a child to a parent node and pushes it back on the tree
 PatchMap::QuadNode *
-PatchMap::addChild( QuadTree & quadtree, QuadNode * parent, int quadrant ) {
+PatchMap::addChild( QuadTree & quadtree, QuadNode * parent, int quadrant,
+    bool isTriangle ) {
     quadtree.push_back(QuadNode());
     int idx = (int)quadtree.size()-1;
-    parent->SetChild(quadrant, idx, false);
+    parent->SetChild(quadrant, idx, false, isTriangle);
     return &(quadtree[idx]);
 }
 
@@ -76,6 +80,7 @@ PatchMap::initialize( PatchTable const & patchTable ) {
 
     // populate subpatch handles vector
     _handles.resize(npatches);
+    _patchParams.resize(npatches);
 
     for (int parray=0, current=0; parray<narrays; ++parray) {
 
@@ -91,6 +96,8 @@ PatchMap::initialize( PatchTable const & patchTable ) {
             h.patchIndex = current;
             h.vertIndex  = j * ringsize;
 
+            _patchParams[current] = params[j];
+
             nfaces = std::max(nfaces, (int)params[j].GetFaceId());
 
             ++current;
@@ -106,11 +113,18 @@ PatchMap::initialize( PatchTable const & patchTable ) {
     // each coarse face has a root node associated to it that we need to initialize
     quadtree.resize(nfaces);
 
+    // faces of triangular patches (Loop scheme) have triangle nodes
+    std::vector<bool> triangleFaces(nfaces, false);
+
     // populate the quadtree from the FarPatchArrays sub-patches
     for (Index parray=0, handleIndex=0; parray<narrays; ++parray) {
 
         ConstPatchParamArray params = patchTable.GetPatchParams(parray);
 
+        PatchDescriptor::Type type = patchTable.GetPatchArrayDescriptor(parray).GetType();
+
+        bool triangle = (type==PatchDescriptor::LOOP or type==PatchDescriptor::TRIANGLES);
+
         for (int i=0; i < patchTable.GetNumPatches(parray); ++i, ++handleIndex) {
 
             PatchParam const & param = params[i];
@@ -119,6 +133,10 @@ PatchMap::initialize( PatchTable const & patchTable ) {
 
             QuadNode * node = &quadtree[ params[i].GetFaceId() ];
 
+            if (triangle) {
+                triangleFaces[params[i].GetFaceId()] = true;
+            }
+
             if (depth==(param.NonQuadRoot() ? 1 : 0)) {
                 // special case : regular BSpline face w/ no sub-patches
                 node->SetChild( handleIndex );
@@ -127,17 +145,43 @@ PatchMap::initialize( PatchTable const & patchTable ) {
 
             int u = param.GetU(),
                 v = param.GetV(),
-                pdepth = param.NonQuadRoot() ? depth-2 : depth-1,
-                half = 1 << pdepth;
+                pdepth = param.NonQuadRoot() ? depth-2 : depth-1;
+
+            // the quadrants from the root of the face down to the sub-patch
+            unsigned char quadrants[16];
+
+            if (triangle) {
+                // sub-triangles are resolved from their cells up to the root :
+                // the rotated center children have odd (u,v) cells, mirrored
+                // from the cells of their parents (see PatchParam)
+                for (int j=pdepth; j>=0; --j) {
+                    int res = 1 << (j+1);
+                    if ((u & 1) and (v & 1)) {
+                        quadrants[j] = 2;
+                        u = (res-1-u) >> 1;
+                        v = (res-1-v) >> 1;
+                    } else {
+                        quadrants[j] = (u & 1) ? 3 : ((v & 1) ? 1 : 0);
+                        u >>= 1;
+                        v >>= 1;
+                    }
+                }
+            } else {
+                int half = 1 << pdepth;
+                for (int j=0; j<=pdepth; ++j) {
+                    int delta = half >> 1;
 
-            for (unsigned char j=0; j<depth; ++j) {
+                    int quadrant = resolveQuadrant(half, u, v);
+                    assert(quadrant>=0);
+                    quadrants[j] = (unsigned char)quadrant;
 
-                int delta = half >> 1;
+                    half = delta;
+                }
+            }
 
-                int quadrant = resolveQuadrant(half, u, v);
-                assert(quadrant>=0);
+            for (int j=0; j<=pdepth; ++j) {
 
-                half = delta;
+                int quadrant = quadrants[j];
 
                 if (j==pdepth) {
                    // we have reached the depth of the sub-patch : add a leaf
@@ -148,7 +192,7 @@ PatchMap::initialize( PatchTable const & patchTable ) {
                     // travel down the child node of the corresponding quadrant
                     if (not node->children[quadrant].isSet) {
                         // create a new branch in the quadrant
-                        node = addChild(quadtree, node, quadrant);
+                        node = addChild(quadtree, node, quadrant, triangle);
                     } else {
                         // travel down an existing branch
                         node = &(quadtree[ node->children[quadrant].idx ]);
@@ -160,8 +204,171 @@ PatchMap::initialize( PatchTable const & patchTable ) {
 
     // copy the resulting quadtree to eliminate un-unused vector capacity
     _quadtree = quadtree;
+
+    initializeGrids( patchTable, nfaces, triangleFaces );
 }
 
+void
+PatchMap::initializeGrids( PatchTable const & patchTable, int nfaces,
+    std::vector<bool> const & triangleFaces ) {
+
+    // the depth of the grid of a face is the deepest level of its quadtree
+    // (capped to MAX_GRID_DEPTH), while triangle faces are descended from
+    // their root node (sub-triangles do not map to grid cells)
+    _gridDepths.assign(nfaces, 0);
+
+    for (Index parray=0; parray<(int)patchTable.GetNumPatchArrays(); ++parray) {
+
+        ConstPatchParamArray params = patchTable.GetPatchParams(parray);
+
+        for (int i=0; i < patchTable.GetNumPatches(parray); ++i) {
+
+            PatchParam const & param = params[i];
+
+            if (triangleFaces[param.GetFaceId()]) {
+                continue;
+            }
+
+            int depth = param.GetDepth(),
+                levels = depth - (param.NonQuadRoot() ? 1 : 0);
+
+            // regular faces w/ no sub-patches set their 4 root children
+            levels = std::max(levels, 1);
+
+            unsigned char & gridDepth = _gridDepths[param.GetFaceId()];
+            gridDepth = (unsigned char)std::max((int)gridDepth,
+                std::min(levels, (int)MAX_GRID_DEPTH));
+        }
+    }
+
+    _gridOffsets.resize(nfaces);
+
+    int ncells = 0;
+    for (int face=0; face<nfaces; ++face) {
+        _gridOffsets[face] = ncells;
+        ncells += 1 << (2*_gridDepths[face]);
+    }
+
+    _grids.resize(ncells);
+
+    // resolve the child of the quadtree under the center of each cell
+    for (int face=0; face<nfaces; ++face) {
+
+        int depth = _gridDepths[face],
+            res = 1 << depth;
+
+        for (int j=0; j<res; ++j) {
+            for (int i=0; i<res; ++i) {
+
+                float u = ((float)i + 0.5f) / (float)res,
+                      v = ((float)j + 0.5f) / (float)res,
+                      half = 0.5f;
+
+                // the root node of the face
+                QuadNode::Child child;
+                child.isSet = true;
+                child.isLeaf = false;
+                child.isTriangle = triangleFaces[face];
+                child.idx = face;
+
+                for (int level=0; level<depth; ++level) {
+                    if (not child.isSet or child.isLeaf)
+                        break;
+
+                    float delta = half * 0.5f;
+
+                    int quadrant = resolveQuadrant( half, u, v );
+                    assert(quadrant>=0);
+
+                    child = _quadtree[child.idx].children[quadrant];
+
+                    half = delta;
+                }
+                _grids[_gridOffsets[face] + j*res + i] = child;
+            }
+        }
+    }
+}
+
+void
+PatchMap::FindPatches( int const * faceids, float const * u, float const * v,
+    int count, Handle const ** handles ) const {
+
+    // locations are resolved in blocks : the grid cells of a block are looked
+    // up first, and the quadtree is descended for the cells above its leaves
+    int const blockSize = 64;
+
+    QuadNode::Child const * cells[blockSize];
+    float cellU[blockSize], cellV[blockSize], cellHalf[blockSize];
+
+    int nfaces = (int)_gridDepths.size();
+
+    for (int start=0; start<count; start+=blockSize) {
+
+        int n = std::min(blockSize, count-start);
+
+        for (int i=0; i<n; ++i) {
+            int faceid = faceids[start+i];
+            if (faceid>=nfaces) {
+                cells[i] = 0;
+                continue;
+            }
+            assert( (u[start+i]>=0.0f) and (u[start+i]<=1.0f) and
+                    (v[start+i]>=0.0f) and (v[start+i]<=1.0f) );
+
+            cellU[i] = u[start+i];
+            cellV[i] = v[start+i];
+            cells[i] = &findCell( faceid, cellU[i], cellV[i], cellHalf[i] );
+        }
+
+        for (int i=0; i<n; ++i) {
+            handles[start+i] = cells[i] ?
+                descend( *cells[i], cellU[i], cellV[i], cellHalf[i] ) : 0;
+        }
+    }
+}
+
+void
+PatchMap::UpdatePatches( int const * faceids, float const * u, float const * v,
+    int count, Handle const ** handles ) const {
+
+    for (int i=0; i<count; ++i) {
+        handles[i] = FindPatch( faceids[i], u[i], v[i], handles[i] );
+    }
+}
+
+
+void
+PatchMap::GetEncodedTables( std::vector<int> & faces,
+    std::vector<unsigned int> & nodes ) const {
+
+    int nfaces = (int)_gridDepths.size(),
+        ncells = (int)_grids.size();
+
+    faces.resize(2*nfaces);
+    for (int face=0; face<nfaces; ++face) {
+        faces[2*face  ] = _gridOffsets[face];
+        faces[2*face+1] = _gridDepths[face];
+    }
+
+    // the children of quadtree node i follow the cells at ncells + 4*i
+    nodes.resize(ncells + 4*_quadtree.size());
+
+    for (int i=0; i<(int)nodes.size(); ++i) {
+
+        QuadNode::Child const & child = i < ncells ?
+            _grids[i] : _quadtree[(i-ncells)/4].children[(i-ncells)%4];
+
+        if (not child.isSet) {
+            nodes[i] = 0;
+        } else if (child.isLeaf) {
+            nodes[i] = ((unsigned int)child.idx << 2) | 3;
+        } else {
+            nodes[i] = ((unsigned int)(ncells + 4*child.idx) << 2) |
+                       (child.isTriangle ? 2 : 1);
+        }
+    }
+}
 
 } // end namespace Far
 
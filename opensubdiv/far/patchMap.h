@@ -72,23 +72,107 @@ public:
     ///
     Handle const * FindPatch( int faceid, float u, float v ) const;
 
+    /// \brief Returns a handle to the sub-patch of the face at the given (u,v),
+    /// testing first the sub-patch of a previous lookup (see FindPatch)
+    ///
+    /// Locations moving across the surface by small steps from frame to
+    /// frame mostly stay within the same sub-patch : the domain of the hint is
+    /// tested from its PatchParam, and the quadtree is only descended when
+    /// the location has left it.
+    ///
+    /// @param faceid  The index of the face
+    ///
+    /// @param u       Local u parameter
+    ///
+    /// @param v       Local v parameter
+    ///
+    /// @param hint    A handle previously returned by this map (or NULL)
+    ///
+    /// @return        A patch handle or NULL (as returned by FindPatch)
+    ///
+    Handle const * FindPatch( int faceid, float u, float v,
+        Handle const * hint ) const;
+
+    /// \brief Returns the handles to the sub-patches of a set of locations
+    /// (see FindPatch)
+    ///
+    /// @param faceids The indices of the faces of the locations
+    ///
+    /// @param u       Local u parameters of the locations
+    ///
+    /// @param v       Local v parameters of the locations
+    ///
+    /// @param count   The number of locations
+    ///
+    /// @param handles Returned patch handle of each location (or NULL, as
+    ///                returned by FindPatch)
+    ///
+    void FindPatches( int const * faceids, float const * u, float const * v,
+        int count, Handle const ** handles ) const;
+
+    /// \brief Updates the handles to the sub-patches of a set of moving
+    /// locations, using their previous handles as hints (see FindPatch)
+    ///
+    /// @param faceids The indices of the faces of the locations
+    ///
+    /// @param u       Local u parameters of the locations
+    ///
+    /// @param v       Local v parameters of the locations
+    ///
+    /// @param count   The number of locations
+    ///
+    /// @param handles The previous patch handle of each location (or NULL),
+    ///                replaced by its updated handle
+    ///
+    void UpdatePatches( int const * faceids, float const * u, float const * v,
+        int count, Handle const ** handles ) const;
+
+    /// \brief Returns the handles of all the patches of the map
+    std::vector<Handle> const & GetHandles() const { return _handles; }
+
+    /// \brief Returns the lookup structures of the map encoded in arrays of
+    ///        integers, to be copied to other devices (see Osd::CpuPatchMap)
+    ///
+    /// @param faces  Returned (first cell, grid depth) pair of each face :
+    ///               the grid of a face has (1 << depth) x (1 << depth)
+    ///               cells, in rows of increasing v
+    ///
+    /// @param nodes  Returned grid cells of all the faces, followed by the 4
+    ///               children of each quadtree node (in the quadrant order of
+    ///               resolveQuadrant). Cells and children are encoded as 0
+    ///               for holes, (offset << 2) | 1 for nodes (offset of their
+    ///               children in 'nodes') and (index << 2) | 3 for patches
+    ///               (index of their handle). Nodes of triangular faces
+    ///               (Loop scheme) are encoded as (offset << 2) | 2, and
+    ///               their children are in the order of
+    ///               resolveTriangleQuadrant
+    ///
+    void GetEncodedTables( std::vector<int> & faces,
+        std::vector<unsigned int> & nodes ) const;
+
 private:
 
     inline void initialize( PatchTable const & patchTable );
 
+    // builds the grids of the faces from the quadtree
+    void initializeGrids( PatchTable const & patchTable, int nfaces,
+        std::vector<bool> const & triangleFaces );
+
     // Quadtree node with 4 children
     struct QuadNode {
         struct Child {
-            unsigned int isSet:1,    // true if the child has been set
-                         isLeaf:1,   // true if the child is a QuadNode
-                         idx:30;     // child index (either QuadNode or Handle)
+            unsigned int isSet:1,      // true if the child has been set
+                         isLeaf:1,     // true if the child is a QuadNode
+                         isTriangle:1, // true if the child is a triangle node
+                         idx:29;       // child index (either QuadNode or Handle)
         };
 
         // sets all the children to point to the patch of index patchIdx
         void SetChild(int patchIdx);
 
         // sets the child in "quadrant" to point to the node or patch of the given index
-        void SetChild(unsigned char quadrant, int child, bool isLeaf=true);
+        void SetChild(unsigned char quadrant, int child, bool isLeaf=true,
+            bool isTriangle=false);
 
         Child children[4];
     };
@@ -96,7 +180,8 @@ private:
     typedef std::vector<QuadNode> QuadTree;
 
     // adds a child to a parent node and pushes it back on the tree
-    static QuadNode * addChild( QuadTree & quadtree, QuadNode * parent, int quadrant );
+    static QuadNode * addChild( QuadTree & quadtree, QuadNode * parent,
+        int quadrant, bool isTriangle=false );
 
     // given a median, transforms the (u,v) to the quadrant they point to, and
     // return the quadrant index.
@@ -115,8 +200,49 @@ private:
     //
     template <class T> static int resolveQuadrant(T & median, T & u, T & v);
 
-    std::vector<Handle>   _handles;  // all the patches in the PatchTable
+    // same as resolveQuadrant for the 4 sub-triangles of a triangle node :
+    // the (u,v) of the rotated center triangle are reflected, so that every
+    // sub-triangle is in the half u + v <= median of its frame
+    //
+    //   (0,0) o-----o-----o
+    //         |    /|    /
+    //         | 0 / | 3 /
+    //         |  / 2|  /
+    //         | /   | /
+    //         o-----o
+    //         |    /
+    //         | 1 /
+    //         |  /
+    //         | /
+    //         o
+    //
+    template <class T> static int resolveTriangleQuadrant(T & median, T & u, T & v);
+
+    // Each face has a grid of the children of the first levels of its
+    // quadtree (at most MAX_GRID_DEPTH levels) : the grid cell of a location
+    // is looked up directly, and only the quadtree nodes below the grid are
+    // descended.
+    enum { MAX_GRID_DEPTH = 3 };
+
+    // returns the grid cell of the face at the given (u,v) and the location
+    // relative to the cell
+    QuadNode::Child const & findCell( int faceid, float & u, float & v,
+        float & half ) const;
+
+    // returns the patch of a location from the node of a grid cell
+    Handle const * descend( QuadNode::Child const & cell,
+        float u, float v, float half ) const;
+
+    // returns true if the location is in the domain of the patch of a handle
+    bool isInPatch( Handle const & handle, int faceid, float u, float v ) const;
+
+    std::vector<Handle>     _handles;     // all the patches in the PatchTable
+    std::vector<PatchParam> _patchParams; // domains of the patches (hints)
     std::vector<QuadNode> _quadtree; // quadtree nodes
+
+    std::vector<unsigned char>   _gridDepths;  // depth of the grid of each face
+    std::vector<int>             _gridOffsets; // first cell of each face
+    std::vector<QuadNode::Child> _grids;       // grid cells (v-major rows)
 };
 
 // given a median, transforms the (u,v) to the quadrant they point to, and
@@ -144,25 +270,71 @@ PatchMap::resolveQuadrant(T & median, T & u, T & v) {
     return quadrant;
 }
 
-/// Returns a handle to the sub-patch of the face at the given (u,v).
+// same as resolveQuadrant for the sub-triangles of a triangle node
+template <class T> int
+PatchMap::resolveTriangleQuadrant(T & median, T & u, T & v) {
+    if (u>=median) {
+        u-=median;
+        return 3;
+    } else if (v>=median) {
+        v-=median;
+        return 1;
+    } else if ((u+v)>=median) {
+        u=median-u;
+        v=median-v;
+        return 2;
+    }
+    return 0;
+}
+
+// returns the grid cell of the face at the given (u,v) and the location
+// relative to the cell (the grids of the faces are sized in powers of 2 :
+// the location is scaled and offset exactly as by the descent of the quadtree)
+inline PatchMap::QuadNode::Child const &
+PatchMap::findCell( int faceid, float & u, float & v, float & half ) const {
+
+    int res = 1 << _gridDepths[faceid];
+
+    float scale = (float)res;
+
+    int i = (int)(u * scale),
+        j = (int)(v * scale);
+
+    // locations on the far edges of the face
+    i = i < res ? i : res-1;
+    j = j < res ? j : res-1;
+
+    u -= (float)i / scale;
+    v -= (float)j / scale;
+
+    half = 0.5f / scale;
+
+    return _grids[_gridOffsets[faceid] + j*res + i];
+}
+
+// returns the patch of a location from the node of a grid cell
 inline PatchMap::Handle const *
-PatchMap::FindPatch( int faceid, float u, float v ) const {
+PatchMap::descend( QuadNode::Child const & cell,
+    float u, float v, float half ) const {
 
-    if (faceid>=(int)_quadtree.size())
-        return NULL;
+    // is the cell a hole ?
+    if (not cell.isSet)
+        return 0;
 
-    assert( (u>=0.0f) and (u<=1.0f) and (v>=0.0f) and (v<=1.0f) );
+    if (cell.isLeaf)
+        return &_handles[cell.idx];
 
-    QuadNode const * node = &_quadtree[faceid];
+    QuadNode const * node = &_quadtree[cell.idx];
 
-    float half = 0.5f;
+    bool triangle = cell.isTriangle;
 
     // 0xFF : we should never have depths greater than k_InfinitelySharp
     for (int depth=0; depth<0xFF; ++depth) {
 
         float delta = half * 0.5f;
 
-        int quadrant = resolveQuadrant( half, u, v );
+        int quadrant = triangle ? resolveTriangleQuadrant( half, u, v ) :
+                                  resolveQuadrant( half, u, v );
         assert(quadrant>=0);
 
         // is the quadrant a hole ?
@@ -182,6 +354,56 @@ PatchMap::FindPatch( int faceid, float u, float v ) const {
     return 0;
 }
 
+/// Returns a handle to the sub-patch of the face at the given (u,v).
+inline PatchMap::Handle const *
+PatchMap::FindPatch( int faceid, float u, float v ) const {
+
+    if (faceid>=(int)_gridDepths.size())
+        return NULL;
+
+    assert( (u>=0.0f) and (u<=1.0f) and (v>=0.0f) and (v<=1.0f) );
+
+    float half;
+    QuadNode::Child const & cell = findCell( faceid, u, v, half );
+
+    return descend( cell, u, v, half );
+}
+
+// returns true if the location is in the domain of the patch of a handle :
+// the bounds of the domain are those of the descent (see resolveQuadrant),
+// lower bounds included and upper bounds excluded, except on the far edges
+// of the face. Triangle nodes are not tested (their sub-domains are not
+// rectangular).
+inline bool
+PatchMap::isInPatch( Handle const & handle, int faceid, float u, float v ) const {
+
+    PatchParam const & param = _patchParams[handle.patchIndex];
+
+    if (param.GetFaceId()!=faceid or _grids[_gridOffsets[faceid]].isTriangle)
+        return false;
+
+    float frac = param.GetParamFraction(),
+          u0 = (float)param.GetU() * frac,
+          v0 = (float)param.GetV() * frac,
+          u1 = u0 + frac,
+          v1 = v0 + frac;
+
+    return (u>=u0) and (v>=v0) and
+           ((u<u1) or (u1>=1.0f)) and ((v<v1) or (v1>=1.0f));
+}
+
+/// Returns a handle to the sub-patch of the face at the given (u,v), testing
+/// the hint first.
+inline PatchMap::Handle const *
+PatchMap::FindPatch( int faceid, float u, float v, Handle const * hint ) const {
+
+    if (hint and faceid<(int)_gridDepths.size() and
+        isInPatch( *hint, faceid, u, v ))
+        return hint;
+
+    return FindPatch( faceid, u, v );
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
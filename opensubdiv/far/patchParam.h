@@ -53,7 +53,8 @@ namespace Far {
 ///  -----------|:----:|------------------------------------------------------
 ///  level      | 4    | the subdivision level of the patch
 ///  nonquad    | 1    | whether the patch is the child of a non-quad face
-///  unused     | 3    | unused
+///  regular    | 1    | whether the face-varying patch is bicubic
+///  unused     | 2    | unused
 ///  boundary   | 4    | boundary edge mask encoding
 ///  v          | 10   | log2 value of u parameter at first patch corner
 ///  u          | 10   | log2 value of v parameter at first patch corner
@@ -61,6 +62,15 @@ namespace Far {
 /// Note : the bitfield is not expanded in the struct due to differences in how
 ///        GPU & CPU compilers pack bit-fields and endian-ness.
 ///
+/// Triangular patches (Loop scheme) : the base triangle covers the half
+/// u + v <= 1 of the parametric square, and sub-triangles cover the lower half
+/// of the cell at (u,v) of their level -- except rotated (center) triangles,
+/// identified by u + v >= (1 << level), which cover the upper half of the cell
+/// at ((1 << level) - 1 - u, (1 << level) - 1 - v), with their parameterization
+/// reversed in both directions (see NormalizeTriangle()). The 3 first bits of
+/// the boundary mask identify boundary edges as for quads or, if the fourth
+/// bit is set, the corners of the patch lying on a boundary.
+///
 struct PatchParam {
     /// \brief Sets the values of the bit fields
     ///
@@ -102,6 +112,11 @@ struct PatchParam {
     /// \brief True if the parent coarse face is a non-quad
     bool NonQuadRoot() const { return (field1 >> 4) & 0x1; }
 
+    /// \brief True if the face-varying patch is a bicubic B-spline patch
+    /// (only set in the PatchParams of face-varying channels, see
+    /// PatchTable::GetPatchFVarPatchParam())
+    bool IsRegular() const { return (field1 >> 5) & 0x1; }
+
     /// \brief Returns the fraction of normalized parametric space covered by the
     /// sub-patch.
     float GetParamFraction() const;
@@ -116,6 +131,36 @@ struct PatchParam {
     ///
     void Normalize( float & u, float & v ) const;
 
+    /// \brief True if the triangular patch is rotated within its cell
+    bool IsTriangleRotated() const {
+        return (GetU() + GetV()) >= (1 << GetDepth());
+    }
+
+    /// The (u,v) pair of a location of a triangular patch is normalized to
+    /// the sub-parametric space of the triangle.
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void NormalizeTriangle( float & u, float & v ) const;
+
+    /// The (u,v) pair of this sub-parametric space is returned to the
+    /// parametric space of the face (inverse of Normalize()).
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void Unnormalize( float & u, float & v ) const;
+
+    /// The (u,v) pair of the sub-parametric space of a triangular patch is
+    /// returned to the parametric space of the face (inverse of
+    /// NormalizeTriangle()).
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void UnnormalizeTriangle( float & u, float & v ) const;
+
     unsigned int field0:32;
     unsigned int field1:32;
 };
@@ -161,6 +206,45 @@ PatchParam::Normalize( float & u, float & v ) const {
     v = (v - pv) / frac;
 }
 
+inline void
+PatchParam::NormalizeTriangle( float & u, float & v ) const {
+
+    if (IsTriangleRotated()) {
+        float frac = GetParamFraction();
+
+        // rotated triangles are reversed from the far corner of their cell
+        float pu = (float)GetU()*frac;
+        float pv = (float)GetV()*frac;
+
+        u = (1.0f - pu - u) / frac,
+        v = (1.0f - pv - v) / frac;
+    } else {
+        Normalize(u, v);
+    }
+}
+
+inline void
+PatchParam::Unnormalize( float & u, float & v ) const {
+
+    float frac = GetParamFraction();
+
+    u = (float)GetU()*frac + u*frac;
+    v = (float)GetV()*frac + v*frac;
+}
+
+inline void
+PatchParam::UnnormalizeTriangle( float & u, float & v ) const {
+
+    if (IsTriangleRotated()) {
+        float frac = GetParamFraction();
+
+        u = 1.0f - (float)GetU()*frac - u*frac;
+        v = 1.0f - (float)GetV()*frac - v*frac;
+    } else {
+        Unnormalize(u, v);
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
@@ -0,0 +1,369 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/patchProvider.h"
+#include "../far/error.h"
+#include "../far/ptexIndices.h"
+#include "../far/stencilTableFactory.h"
+#include "../far/topologyDescriptor.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    // The patches of a face are published to the threads requesting them
+    // once built
+    template <class T>
+    inline T *
+    atomicLoad(T * const & value) {
+#ifdef _MSC_VER
+        return (T *)_InterlockedCompareExchangePointer(
+            (void * volatile *)&value, 0, 0);
+#else
+        return __atomic_load_n(&value, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    template <class T>
+    inline bool
+    atomicCompareExchange(T * & value, T * expected, T * desired) {
+#ifdef _MSC_VER
+        return _InterlockedCompareExchangePointer(
+            (void * volatile *)&value, desired, expected) == expected;
+#else
+        return __atomic_compare_exchange_n(&value, &expected, desired,
+            false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+    }
+}
+
+PatchProvider::FacePatches::~FacePatches() {
+    delete _patchTable;
+    delete _stencilTable;
+}
+
+PatchProvider::Handle const *
+PatchProvider::FacePatches::FindPatch(int faceid, float s, float t) const {
+
+    //  (the face ids of the patches are relative to the first of the face)
+    int res = _gridResolution,
+        subface = faceid - _firstFaceId;
+    if (res == 0 or subface < 0 or subface >= (int)_grid.size() / (res * res)) {
+        return 0;
+    }
+    int u = std::max(0, std::min((int)(s * (float)res), res - 1)),
+        v = std::max(0, std::min((int)(t * (float)res), res - 1));
+
+    int patch = _grid[(subface * res + v) * res + u];
+    return patch < 0 ? 0 : &_handles[patch];
+}
+
+PatchProvider::PatchProvider(TopologyRefiner const & refiner, int isolationLevel,
+    PatchTableFactory::Options options) :
+        _baseRefiner(refiner), _isolationLevel(std::max(isolationLevel, 1)),
+        _options(options) {
+
+    if (refiner.GetSchemeType() != Sdc::SCHEME_CATMARK) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchProvider::PatchProvider() -- "
+            "only supported for Catmark scheme.");
+        return;
+    }
+
+    //  Legacy Gregory patches are not evaluated from the stencils of their points,
+    //  and the neighborhoods refined have no face-varying channels:
+    if (_options.GetEndCapType() == PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY) {
+        _options.SetEndCapType(PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    }
+    _options.generateFVarTables = false;
+
+    PtexIndices ptexIndices(refiner);
+
+    int numFaces = refiner.GetLevel(0).GetNumFaces();
+
+    _ptexOffsets.resize(numFaces + 1);
+    for (Index face = 0; face < numFaces; ++face) {
+        _ptexOffsets[face] = ptexIndices.GetFaceId(face);
+    }
+    _ptexOffsets[numFaces] = ptexIndices.GetNumFaces();
+
+    _facePatches.resize(numFaces, 0);
+}
+
+PatchProvider::~PatchProvider() {
+
+    for (int face = 0; face < (int)_facePatches.size(); ++face) {
+        delete _facePatches[face];
+    }
+}
+
+PatchProvider::FacePatches const *
+PatchProvider::GetFacePatches(Index baseFace) const {
+
+    if (baseFace < 0 or baseFace >= (int)_facePatches.size() or
+            _baseRefiner.GetLevel(0).IsFaceHole(baseFace)) {
+        return 0;
+    }
+
+    FacePatches * patches = atomicLoad(_facePatches[baseFace]);
+    if (patches) {
+        return patches;
+    }
+
+    //  Threads racing to build the same face keep the first patches published:
+    patches = createFacePatches(baseFace);
+    if (patches and not atomicCompareExchange(_facePatches[baseFace], (FacePatches *)0, patches)) {
+        delete patches;
+        patches = atomicLoad(_facePatches[baseFace]);
+    }
+    return patches;
+}
+
+PatchProvider::Handle const *
+PatchProvider::FindPatch(int faceid, float s, float t,
+    FacePatches const ** patches) const {
+
+    if (patches) {
+        *patches = 0;
+    }
+    if (faceid < 0 or faceid >= GetNumFaceIds()) {
+        return 0;
+    }
+
+    Index baseFace = (Index)(std::upper_bound(_ptexOffsets.begin(),
+        _ptexOffsets.end(), faceid) - _ptexOffsets.begin()) - 1;
+
+    FacePatches const * facePatches = GetFacePatches(baseFace);
+    if (not facePatches) {
+        return 0;
+    }
+    if (patches) {
+        *patches = facePatches;
+    }
+    return facePatches->FindPatch(faceid, s, t);
+}
+
+int
+PatchProvider::GetNumFacePatches() const {
+
+    int count = 0;
+    for (int face = 0; face < (int)_facePatches.size(); ++face) {
+        count += atomicLoad(_facePatches[face]) ? 1 : 0;
+    }
+    return count;
+}
+
+PatchProvider::FacePatches *
+PatchProvider::createFacePatches(Index baseFace) const {
+
+    TopologyLevel const & level = _baseRefiner.GetLevel(0);
+
+    //
+    //  Gather the neighborhood of the face : the faces around its vertices support
+    //  its patches, and the faces around theirs preserve the topology and tags of
+    //  their vertices. The face is the first of the neighborhood, so that its ptex
+    //  faces are the first:
+    //
+    std::vector<Index> faces(1, baseFace);
+    for (int ring = 0, first = 0; ring < 2; ++ring) {
+        int last = (int)faces.size();
+        for (int i = first; i < last; ++i) {
+            ConstIndexArray fVerts = level.GetFaceVertices(faces[i]);
+            for (int j = 0; j < fVerts.size(); ++j) {
+                ConstIndexArray vFaces = level.GetVertexFaces(fVerts[j]);
+                for (int k = 0; k < vFaces.size(); ++k) {
+                    if (std::find(faces.begin(), faces.end(), vFaces[k]) == faces.end()) {
+                        faces.push_back(vFaces[k]);
+                    }
+                }
+            }
+        }
+        first = last;
+    }
+
+    //  Vertices of the neighborhood, indexed locally in increasing order:
+    std::vector<Index> vertices;
+    for (int i = 0; i < (int)faces.size(); ++i) {
+        ConstIndexArray fVerts = level.GetFaceVertices(faces[i]);
+        vertices.insert(vertices.end(), fVerts.begin(), fVerts.end());
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+    std::vector<int>   vertsPerFace;
+    std::vector<Index> faceVerts, holes, creaseVerts, corners, edges;
+    std::vector<float> creaseWeights, cornerWeights;
+
+    for (int i = 0; i < (int)faces.size(); ++i) {
+        ConstIndexArray fVerts = level.GetFaceVertices(faces[i]),
+                        fEdges = level.GetFaceEdges(faces[i]);
+
+        vertsPerFace.push_back(fVerts.size());
+        for (int j = 0; j < fVerts.size(); ++j) {
+            faceVerts.push_back((Index)(std::lower_bound(vertices.begin(),
+                vertices.end(), fVerts[j]) - vertices.begin()));
+        }
+        if (level.IsFaceHole(faces[i])) {
+            holes.push_back(i);
+        }
+        edges.insert(edges.end(), fEdges.begin(), fEdges.end());
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    //  Sharpness of the edges and vertices (boundaries and corners included):
+    for (int i = 0; i < (int)edges.size(); ++i) {
+        float sharpness = level.GetEdgeSharpness(edges[i]);
+        if (sharpness > 0.0f) {
+            ConstIndexArray eVerts = level.GetEdgeVertices(edges[i]);
+            for (int j = 0; j < 2; ++j) {
+                creaseVerts.push_back((Index)(std::lower_bound(vertices.begin(),
+                    vertices.end(), eVerts[j]) - vertices.begin()));
+            }
+            creaseWeights.push_back(sharpness);
+        }
+    }
+    for (int i = 0; i < (int)vertices.size(); ++i) {
+        float sharpness = level.GetVertexSharpness(vertices[i]);
+        if (sharpness > 0.0f) {
+            corners.push_back(i);
+            cornerWeights.push_back(sharpness);
+        }
+    }
+
+    TopologyDescriptor desc;
+    desc.numVertices        = (int)vertices.size();
+    desc.numFaces           = (int)faces.size();
+    desc.numVertsPerFace    = &vertsPerFace[0];
+    desc.vertIndicesPerFace = &faceVerts[0];
+    desc.numCreases             = (int)creaseWeights.size();
+    desc.creaseVertexIndexPairs = creaseWeights.empty() ? 0 : &creaseVerts[0];
+    desc.creaseWeights          = creaseWeights.empty() ? 0 : &creaseWeights[0];
+    desc.numCorners          = (int)cornerWeights.size();
+    desc.cornerVertexIndices = cornerWeights.empty() ? 0 : &corners[0];
+    desc.cornerWeights       = cornerWeights.empty() ? 0 : &cornerWeights[0];
+    desc.numHoles    = (int)holes.size();
+    desc.holeIndices = holes.empty() ? 0 : &holes[0];
+
+    typedef TopologyRefinerFactory<TopologyDescriptor> RefinerFactory;
+
+    TopologyRefiner * refiner = RefinerFactory::Create(desc,
+        RefinerFactory::Options(_baseRefiner.GetSchemeType(),
+                                _baseRefiner.GetSchemeOptions()));
+    if (not refiner) {
+        return 0;
+    }
+
+    Index face = 0;
+    refiner->RefineSparse(TopologyRefiner::AdaptiveOptions(_isolationLevel),
+                          ConstIndexArray(&face, 1));
+
+    PatchTable const * patchTable = refiner->IsSparse() ?
+        PatchTableFactory::Create(*refiner, _options) : 0;
+    if (not patchTable) {
+        delete refiner;
+        return 0;
+    }
+
+    //  Stencils of all the vertices of the refinement, and of the local points of
+    //  the end caps, factorized to the vertices of the neighborhood:
+    StencilTableFactory::Options stencilOptions;
+    stencilOptions.generateControlVerts = true;
+    stencilOptions.generateIntermediateLevels = true;
+
+    StencilTable const * localStencils = StencilTableFactory::Create(*refiner, stencilOptions);
+
+    if (StencilTable const * localPoints = patchTable->GetLocalPointStencilTable()) {
+        StencilTable const * table = StencilTableFactory::AppendLocalPointStencilTable(
+            *refiner, localStencils, localPoints, /*factorize*/ true, /*deleteBaseTable*/ true);
+        if (table) {
+            localStencils = table;
+        }
+    }
+    delete refiner;
+
+    //  ... which are those of the base vertices of the whole mesh:
+    std::vector<int>   sizes(localStencils->GetSizes());
+    std::vector<Index> indices(localStencils->GetControlIndices());
+    std::vector<float> weights(localStencils->GetWeights());
+    for (int i = 0; i < (int)indices.size(); ++i) {
+        indices[i] = vertices[indices[i]];
+    }
+    delete localStencils;
+
+    FacePatches * patches = new FacePatches;
+    patches->_baseFace = baseFace;
+    patches->_patchTable = patchTable;
+    patches->_stencilTable = StencilTableFactory::Create(
+        level.GetNumVertices(), sizes, indices, weights);
+
+    //  Patches are all at the isolation level, in a grid over each ptex face (the
+    //  ptex faces of non-quads being children of the base face):
+    int numSubfaces = _ptexOffsets[baseFace + 1] - _ptexOffsets[baseFace],
+        res = 1 << (_isolationLevel - (numSubfaces > 1 ? 1 : 0));
+
+    patches->_firstFaceId = _ptexOffsets[baseFace];
+    patches->_gridResolution = res;
+    patches->_grid.resize(numSubfaces * res * res, -1);
+    patches->_handles.resize(patchTable->GetNumPatchesTotal());
+
+    for (int array = 0, patch = 0; array < patchTable->GetNumPatchArrays(); ++array) {
+
+        ConstPatchParamArray params = patchTable->GetPatchParams(array);
+        int ncvs = patchTable->GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+        for (int i = 0; i < patchTable->GetNumPatches(array); ++i, ++patch) {
+
+            Handle & handle = patches->_handles[patch];
+            handle.arrayIndex = array;
+            handle.patchIndex = patch;
+            handle.vertIndex  = i * ncvs;
+
+            PatchParam const & param = params[i];
+
+            int subface = param.GetFaceId();
+            assert(subface >= 0 and subface < numSubfaces);
+            assert(param.GetDepth() == _isolationLevel);
+
+            patches->_grid[(subface * res + param.GetV()) * res + param.GetU()] = patch;
+        }
+    }
+    return patches;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,237 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_PATCH_PROVIDER_H
+#define OPENSUBDIV3_FAR_PATCH_PROVIDER_H
+
+#include "../version.h"
+
+#include "../far/patchTable.h"
+#include "../far/patchTableFactory.h"
+#include "../far/stencilTable.h"
+#include "../far/topologyRefiner.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Patches of the base faces of a mesh, built on demand
+///
+/// Intended for clients evaluating the limit surface at few locations of a
+/// large mesh (e.g. rig attachments or constraints) : rather than refining
+/// the whole mesh and creating its PatchTable, the patches of a base face are
+/// built the first time they are requested, and are kept for later requests.
+/// The neighborhood of the face (the faces within two rings of its vertices)
+/// is copied to a TopologyRefiner of its own and refined sparsely (see
+/// TopologyRefiner::RefineSparse()), so that the cost of a face does not
+/// depend on the size of the mesh.
+///
+/// The control vertices of the patches of a face are given by stencils of
+/// the base vertices : the limit of a face is evaluated from the base
+/// vertices alone (see FacePatches::Evaluate()).
+///
+/// Requests can be issued concurrently : threads requesting the same face
+/// simultaneously may each build it, a single one being kept.
+///
+/// \note Catmark scheme only. Patches are all generated at the isolation
+///       level (B-spline or end cap patches), legacy Gregory end caps are
+///       converted to Gregory basis end caps, and neither face-varying
+///       channels nor hierarchical edits are applied.
+///
+class PatchProvider {
+
+public:
+
+    typedef PatchTable::PatchHandle Handle;
+
+    /// \brief The patches of a base face
+    class FacePatches {
+
+    public:
+
+        /// \brief Returns the base face of the patches
+        Index GetBaseFace() const { return _baseFace; }
+
+        /// \brief Returns the table of the patches of the face
+        ///
+        /// The face ids of the patches are relative to the first ptex face of
+        /// the base face, and their control vertices are the stencils of
+        /// GetStencilTable().
+        ///
+        PatchTable const & GetPatchTable() const { return *_patchTable; }
+
+        /// \brief Returns the stencils of the control vertices of the patches,
+        ///        from the base vertices of the whole mesh
+        StencilTable const & GetStencilTable() const { return *_stencilTable; }
+
+        /// \brief Returns the patch of a location of a ptex face of the base
+        ///        face (NULL if there is none)
+        Handle const * FindPatch(int faceid, float s, float t) const;
+
+        /// \brief Evaluates the limit of vertex data at a location of a patch
+        ///
+        /// @param handle   Patch of the location (see FindPatch())
+        ///
+        /// @param s        Location in the ptex face of the patch
+        ///
+        /// @param t        Location in the ptex face of the patch
+        ///
+        /// @param src      Data of the base vertices of the whole mesh
+        ///
+        /// @param dst      Limit value
+        ///
+        /// @param dstDs    Limit derivative wrt s (optional)
+        ///
+        /// @param dstDt    Limit derivative wrt t (optional)
+        ///
+        /// \note T and U follow the requirements of StencilTable::UpdateValues()
+        ///
+        template <class T, class U>
+        void Evaluate(Handle const & handle, float s, float t, T const * src,
+                      U & dst, U * dstDs = 0, U * dstDt = 0) const;
+
+    private:
+
+        friend class PatchProvider;
+
+        FacePatches() : _baseFace(INDEX_INVALID), _firstFaceId(0),
+            _gridResolution(0), _patchTable(0), _stencilTable(0) { }
+        ~FacePatches();
+
+        Index _baseFace;
+
+        //  Handles of the patches of each ptex face of the base face, in a grid
+        //  of the isolation level:
+        int                 _firstFaceId,
+                            _gridResolution;
+        std::vector<Handle> _handles;
+        std::vector<int>    _grid;
+
+        PatchTable const *   _patchTable;
+        StencilTable const * _stencilTable;
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param refiner         TopologyRefiner of the base mesh (its base level
+    ///                        must remain valid and unchanged while patches
+    ///                        are built)
+    ///
+    /// @param isolationLevel  Level of the sparse refinement of the faces
+    ///                        (at least 1)
+    ///
+    /// @param options         Options controlling the creation of the patches
+    ///                        of each face
+    ///
+    PatchProvider(TopologyRefiner const & refiner, int isolationLevel,
+                  PatchTableFactory::Options options = PatchTableFactory::Options());
+
+    /// \brief Destructor
+    ~PatchProvider();
+
+    /// \brief Returns the number of ptex faces of the base mesh
+    int GetNumFaceIds() const { return _ptexOffsets.empty() ? 0 : _ptexOffsets.back(); }
+
+    /// \brief Returns the patches of a base face, built on the first request
+    ///        (NULL for holes, invalid faces or on failure)
+    FacePatches const * GetFacePatches(Index baseFace) const;
+
+    /// \brief Returns the patch of a location of a ptex face (NULL if there is
+    ///        none), building the patches of its base face if needed
+    ///
+    /// @param faceid   Ptex face of the location (see PtexIndices)
+    ///
+    /// @param s        Location in the ptex face
+    ///
+    /// @param t        Location in the ptex face
+    ///
+    /// @param patches  Returned patches of the base face of the location
+    ///
+    Handle const * FindPatch(int faceid, float s, float t,
+                             FacePatches const ** patches) const;
+
+    /// \brief Returns the number of base faces whose patches were built
+    int GetNumFacePatches() const;
+
+private:
+
+    PatchProvider(PatchProvider const &);
+    PatchProvider & operator=(PatchProvider const &);
+
+    FacePatches * createFacePatches(Index baseFace) const;
+
+private:
+
+    TopologyRefiner const &    _baseRefiner;
+    int                        _isolationLevel;
+    PatchTableFactory::Options _options;
+
+    //  First ptex face of each base face (and their total):
+    std::vector<int> _ptexOffsets;
+
+    //  Patches of each base face, assigned atomically once built:
+    mutable std::vector<FacePatches *> _facePatches;
+};
+
+template <class T, class U>
+inline void
+PatchProvider::FacePatches::Evaluate(Handle const & handle, float s, float t,
+    T const * src, U & dst, U * dstDs, U * dstDt) const {
+
+    float wP[20], wDs[20], wDt[20];
+    _patchTable->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+
+    ConstIndexArray cvs = _patchTable->GetPatchVertices(handle);
+
+    dst.Clear();
+    if (dstDs) dstDs->Clear();
+    if (dstDt) dstDt->Clear();
+
+    for (int i = 0; i < cvs.size(); ++i) {
+        Stencil stencil = _stencilTable->GetStencil(cvs[i]);
+
+        Index const * indices = stencil.GetVertexIndices();
+        float const * weights = stencil.GetWeights();
+        for (int j = 0; j < stencil.GetSize(); ++j) {
+            dst.AddWithWeight(src[indices[j]], wP[i] * weights[j]);
+            if (dstDs) dstDs->AddWithWeight(src[indices[j]], wDs[i] * weights[j]);
+            if (dstDt) dstDt->AddWithWeight(src[indices[j]], wDt[i] * weights[j]);
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_PATCH_PROVIDER_H */
@@ -24,7 +24,12 @@
 
 #include "../far/patchTable.h"
 #include "../far/patchBasis.h"
+#include "../far/stencilTable.h"
+#include "../far/taskScheduler.h"
 
+#include <algorithm>
+
+#include <cstdlib>
 #include <cstring>
 #include <cstdio>
 
@@ -52,6 +57,7 @@ PatchTable::PatchTable(PatchTable const & src) :
     _localPointStencils(NULL),
     _localPointVaryingStencils(NULL),
     _fvarChannels(src._fvarChannels),
+    _fvarPatchFaces(src._fvarPatchFaces),
     _sharpnessIndices(src._sharpnessIndices),
     _sharpnessValues(src._sharpnessValues) {
 
@@ -73,24 +79,6 @@ PatchTable::~PatchTable() {
 //
 // PatchArrays
 //
-struct PatchTable::PatchArray {
-
-    PatchArray(PatchDescriptor d, int np, Index v, Index p, Index qo) :
-            desc(d), numPatches(np), vertIndex(v),
-                patchIndex(p), quadOffsetIndex (qo) { }
-
-    void print() const;
-
-    PatchDescriptor desc;  // type of patches in the array
-
-    int numPatches;        // number of patches in the array
-
-    Index vertIndex,       // index to the first control vertex
-          patchIndex,      // index of the first patch in the array
-          quadOffsetIndex; // index of the first quad offset entry
-
-};
-
 // debug helper
 void
 PatchTable::PatchArray::print() const {
@@ -99,73 +87,26 @@ PatchTable::PatchArray::print() const {
         "quadOffsetIndex=%d\n", numPatches, vertIndex, patchIndex,
             quadOffsetIndex);
 }
-inline PatchTable::PatchArray &
-PatchTable::getPatchArray(Index arrayIndex) {
-    assert(arrayIndex<(Index)GetNumPatchArrays());
-    return _patchArrays[arrayIndex];
-}
-inline PatchTable::PatchArray const &
-PatchTable::getPatchArray(Index arrayIndex) const {
-    assert(arrayIndex<(Index)GetNumPatchArrays());
-    return _patchArrays[arrayIndex];
-}
+
 void
 PatchTable::reservePatchArrays(int numPatchArrays) {
     _patchArrays.reserve(numPatchArrays);
 }
 
-//
-// FVarPatchChannel
-//
-// Stores a record for each patch in the primitive :
-//
-//  - Each patch in the PatchTable has a corresponding patch in each
-//    face-varying patch channel. Patch vertex indices are sorted in the same
-//    patch-type order as PatchTable::PTables. Face-varying data for a patch
-//    can therefore be quickly accessed by using the patch primitive ID as
-//    index into patchValueOffsets to locate the face-varying control vertex
-//    indices.
-//
-//  - Face-varying channels can have a different interpolation modes
-//
-//  - Unlike "vertex" patches, there are no transition masks required
-//    for face-varying patches.
-//
-//  - Face-varying patches still require boundary edge masks.
-//
-//  - currently most patches with sharp boundaries but smooth interiors have
-//    to be isolated to level 10 : we need a special type of bicubic patch
-//    similar to single-crease to resolve this condition without requiring
-//    isolation if possible
-//
-struct PatchTable::FVarPatchChannel {
-
-    // Channel interpolation mode
-    Sdc::Options::FVarLinearInterpolation interpolation;
-
-    // Patch type
-    //
-    // Note : in bilinear interpolation modes, all patches are of the same type,
-    // so we only need a single type (patchesType). In bi-cubic modes, each
-    // patch requires its own type (patchTypes).
-    PatchDescriptor::Type              patchesType;
-    std::vector<PatchDescriptor::Type> patchTypes;
-
-    // Patch points values
-    std::vector<Index> patchValuesOffsets; // offset to the first value of each patch
-    std::vector<Index> patchValues; // point values for each patch
-};
-
-inline PatchTable::FVarPatchChannel &
-PatchTable::getFVarPatchChannel(int channel) {
-    assert(channel<(int)_fvarChannels.size());
-    return _fvarChannels[channel];
-}
-inline PatchTable::FVarPatchChannel const &
-PatchTable::getFVarPatchChannel(int channel) const {
-    assert(channel<(int)_fvarChannels.size());
-    return _fvarChannels[channel];
+//  The values of a channel sharing the patch vertices are those vertices, and are
+//  copied in the channel when the vertices are to be modified independently:
+std::vector<Index> const &
+PatchTable::getFVarPatchChannelValues(FVarPatchChannel const & c) const {
+    return c.sharesPatchVertices ? _patchVerts : c.patchValues;
 }
+void
+PatchTable::separateFVarPatchChannelValues(FVarPatchChannel & c) {
+    if (c.sharesPatchVertices) {
+        c.patchValues = _patchVerts;
+        c.sharesPatchVertices = false;
+    }
+}
+
 void
 PatchTable::allocateFVarPatchChannels(int numChannels) {
     _fvarChannels.resize(numChannels);
@@ -186,6 +127,11 @@ PatchTable::setFVarPatchChannelLinearInterpolation(
     FVarPatchChannel & c = getFVarPatchChannel(channel);
     c.interpolation = interpolation;
 }
+void
+PatchTable::setFVarPatchChannelPatchesType(PatchDescriptor::Type type, int channel) {
+    FVarPatchChannel & c = getFVarPatchChannel(channel);
+    c.patchesType = type;
+}
 
 //
 // PatchTable
@@ -252,6 +198,214 @@ PatchTable::GetNumPatchesTotal() const {
     // there is one PatchParam record for each patch in the mesh
     return (int)_paramTable.size();
 }
+
+PatchTable::TableMemoryUsage
+PatchTable::GetTableMemoryUsage() const {
+
+    TableMemoryUsage usage;
+
+    usage.patchVertices.Add(_patchArrays);
+    usage.patchVertices.Add(_patchVerts);
+
+    usage.patchParams.Add(_paramTable);
+
+    usage.sharpness.Add(_sharpnessIndices);
+    usage.sharpness.Add(_sharpnessValues);
+
+    usage.fvar.Add(_fvarChannels);
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        usage.fvar.Add(_fvarChannels[i].patchTypes);
+        usage.fvar.Add(_fvarChannels[i].patchValuesOffsets);
+        usage.fvar.Add(_fvarChannels[i].patchValues);
+        usage.fvar.Add(_fvarChannels[i].patchParams);
+    }
+    usage.fvar.Add(_fvarPatchFaces);
+
+    if (_localPointStencils) {
+        usage.localPointStencils += _localPointStencils->GetMemoryUsage();
+    }
+    if (_localPointVaryingStencils) {
+        usage.localPointStencils += _localPointVaryingStencils->GetMemoryUsage();
+    }
+
+    usage.gregory.Add(_quadOffsetsTable);
+    usage.gregory.Add(_vertexValenceTable);
+    return usage;
+}
+
+MemoryUsage
+PatchTable::GetMemoryUsage() const {
+
+    TableMemoryUsage tableUsage = GetTableMemoryUsage();
+
+    MemoryUsage usage;
+    usage += tableUsage.patchVertices;
+    usage += tableUsage.patchParams;
+    usage += tableUsage.sharpness;
+    usage += tableUsage.fvar;
+    usage += tableUsage.localPointStencils;
+    usage += tableUsage.gregory;
+    return usage;
+}
+
+namespace {
+    //  Patches are accounted for in ranges of fixed size within their arrays:
+    int const statisticsRangeSize = 4096;
+
+    struct PatchRange {
+        PatchRange(PatchDescriptor const & rangeDesc, Index rangeFirstPatch,
+                   Index rangeFirstVert, int rangeNumPatches) :
+            desc(rangeDesc), firstPatch(rangeFirstPatch),
+            firstVert(rangeFirstVert), numPatches(rangeNumPatches),
+            maxVert(-1), numEndCaps(0), numSingleCrease(0) { }
+
+        PatchDescriptor desc;
+        Index firstPatch,
+              firstVert;
+        int numPatches;
+
+        //  accumulated by the range:
+        Index maxVert;
+        int numEndCaps,
+            numSingleCrease,
+            numByDepth[16];
+    };
+
+    struct StatisticsData {
+        PatchRange * ranges;
+        Index const * patchVerts;
+        PatchParam const * patchParams;
+        Index const * sharpnessIndices;
+        Index firstLocalPoint;
+    };
+
+    //  The first pass finds the largest vertex index, the second identifies
+    //  the patches with local points, which are the last vertices indexed:
+    void
+    accumulateRanges(int begin, int end, void * data) {
+
+        StatisticsData const & stats = *static_cast<StatisticsData *>(data);
+        for (int r = begin; r < end; ++r) {
+            PatchRange & range = stats.ranges[r];
+
+            int patchSize = range.desc.GetNumControlVertices();
+            Index const * verts = stats.patchVerts + range.firstVert;
+
+            range.maxVert = -1;
+            for (int i = 0; i < range.numPatches * patchSize; ++i) {
+                range.maxVert = std::max(range.maxVert, verts[i]);
+            }
+
+            range.numSingleCrease = 0;
+            std::fill(range.numByDepth, range.numByDepth + 16, 0);
+            for (int i = 0; i < range.numPatches; ++i) {
+                Index patch = range.firstPatch + i;
+                ++range.numByDepth[stats.patchParams[patch].GetDepth()];
+                if (stats.sharpnessIndices and
+                    stats.sharpnessIndices[patch] != Vtr::INDEX_INVALID) {
+                    ++range.numSingleCrease;
+                }
+            }
+        }
+    }
+
+    void
+    countEndCapRanges(int begin, int end, void * data) {
+
+        StatisticsData const & stats = *static_cast<StatisticsData *>(data);
+        for (int r = begin; r < end; ++r) {
+            PatchRange & range = stats.ranges[r];
+
+            PatchDescriptor::Type type = range.desc.GetType();
+            if (type == PatchDescriptor::GREGORY or
+                type == PatchDescriptor::GREGORY_BOUNDARY or
+                type == PatchDescriptor::GREGORY_BASIS) {
+                range.numEndCaps = range.numPatches;
+                continue;
+            }
+
+            int patchSize = range.desc.GetNumControlVertices();
+            Index const * verts = stats.patchVerts + range.firstVert;
+
+            range.numEndCaps = 0;
+            if (range.maxVert < stats.firstLocalPoint) continue;
+            for (int i = 0; i < range.numPatches; ++i, verts += patchSize) {
+                for (int j = 0; j < patchSize; ++j) {
+                    if (verts[j] >= stats.firstLocalPoint) {
+                        ++range.numEndCaps;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+PatchTable::Statistics
+PatchTable::GetStatistics(TaskScheduler const * scheduler) const {
+
+    Statistics stats;
+    stats.numPatches = GetNumPatchesTotal();
+    stats.numEndCapPatches = 0;
+    stats.numSingleCreasePatches = 0;
+    stats.numLocalPoints = GetNumLocalPoints();
+    stats.maxValence = _maxValence;
+    stats.numPatchesByType.resize(PatchDescriptor::GREGORY_BASIS + 1, 0);
+
+    std::vector<PatchRange> ranges;
+    for (int array = 0; array < (int)_patchArrays.size(); ++array) {
+        PatchArray const & pa = _patchArrays[array];
+
+        stats.numPatchesByType[pa.desc.GetType()] += pa.numPatches;
+
+        for (int i = 0; i < pa.numPatches; i += statisticsRangeSize) {
+            ranges.push_back(PatchRange(pa.desc, pa.patchIndex + i,
+                pa.vertIndex + i * pa.desc.GetNumControlVertices(),
+                std::min(statisticsRangeSize, pa.numPatches - i)));
+        }
+    }
+    if (ranges.empty()) {
+        return stats;
+    }
+
+    StatisticsData data = { &ranges[0], &_patchVerts[0], &_paramTable[0],
+        ((int)_sharpnessIndices.size() == stats.numPatches) ? &_sharpnessIndices[0] : 0, 0 };
+
+    int numRanges = (int)ranges.size();
+    if (scheduler and numRanges > 1) {
+        scheduler->ParallelFor(0, numRanges, 1, accumulateRanges, &data);
+    } else {
+        accumulateRanges(0, numRanges, &data);
+    }
+
+    Index maxVert = -1;
+    for (int r = 0; r < numRanges; ++r) {
+        maxVert = std::max(maxVert, ranges[r].maxVert);
+    }
+    data.firstLocalPoint = stats.numLocalPoints ?
+        maxVert + 1 - stats.numLocalPoints : maxVert + 1;
+
+    if (scheduler and numRanges > 1) {
+        scheduler->ParallelFor(0, numRanges, 1, countEndCapRanges, &data);
+    } else {
+        countEndCapRanges(0, numRanges, &data);
+    }
+
+    for (int r = 0; r < numRanges; ++r) {
+        PatchRange const & range = ranges[r];
+
+        stats.numEndCapPatches += range.numEndCaps;
+        stats.numSingleCreasePatches += range.numSingleCrease;
+        for (int depth = 0; depth < 16; ++depth) {
+            if (range.numByDepth[depth] == 0) continue;
+            if (depth >= (int)stats.numPatchesByDepth.size()) {
+                stats.numPatchesByDepth.resize(depth + 1, 0);
+            }
+            stats.numPatchesByDepth[depth] += range.numByDepth[depth];
+        }
+    }
+    return stats;
+}
 int
 PatchTable::GetNumControlVertices(int arrayIndex) const {
     PatchArray const & pa = getPatchArray(arrayIndex);
@@ -357,8 +511,7 @@ PatchTable::IsFeatureAdaptive() const {
 
     for (int i=0; i<GetNumPatchArrays(); ++i) {
         PatchDescriptor const & desc = _patchArrays[i].desc;
-        if (desc.GetType()>=PatchDescriptor::REGULAR and
-            desc.GetType()<=PatchDescriptor::GREGORY_BASIS) {
+        if (desc.IsAdaptive()) {
             return true;
         }
     }
@@ -374,28 +527,36 @@ PatchTable::GetFVarChannelLinearInterpolation(int channel) const {
     FVarPatchChannel const & c = getFVarPatchChannel(channel);
     return c.interpolation;
 }
+PatchDescriptor
+PatchTable::GetFVarChannelPatchDescriptor(int channel) const {
+    FVarPatchChannel const & c = getFVarPatchChannel(channel);
+    return PatchDescriptor(c.patchesType);
+}
 ConstIndexArray
 PatchTable::GetFVarValues(int channel) const {
-    FVarPatchChannel const & c = getFVarPatchChannel(channel);
-    return ConstIndexArray(&c.patchValues[0], (int)c.patchValues.size());
+    std::vector<Index> const & values = getFVarPatchChannelValues(getFVarPatchChannel(channel));
+    return ConstIndexArray(values.empty() ? 0 : &values[0], (int)values.size());
 }
 IndexArray
 PatchTable::getFVarValues(int channel) {
     FVarPatchChannel & c = getFVarPatchChannel(channel);
-    return IndexArray(&c.patchValues[0], (int)c.patchValues.size());
+    assert(not c.sharesPatchVertices);
+    return IndexArray(c.patchValues.empty() ? 0 : &c.patchValues[0],
+                      (int)c.patchValues.size());
 }
 ConstIndexArray
 PatchTable::getPatchFVarValues(int patch, int channel) const {
 
     FVarPatchChannel const & c = getFVarPatchChannel(channel);
+    std::vector<Index> const & values = getFVarPatchChannelValues(c);
 
     if (c.patchValuesOffsets.empty()) {
         int ncvs = PatchDescriptor::GetNumFVarControlVertices(c.patchesType);
-        return ConstIndexArray(&c.patchValues[patch * ncvs], ncvs);
+        return ConstIndexArray(&values[patch * ncvs], ncvs);
     } else {
         assert(patch<(int)c.patchValuesOffsets.size() and
             patch<(int)c.patchTypes.size());
-        return ConstIndexArray(&c.patchValues[c.patchValuesOffsets[patch]],
+        return ConstIndexArray(&values[c.patchValuesOffsets[patch]],
             PatchDescriptor::GetNumFVarControlVertices(c.patchTypes[patch]));
    }
 }
@@ -407,6 +568,83 @@ ConstIndexArray
 PatchTable::GetPatchFVarValues(int arrayIndex, int patchIndex, int channel) const {
     return getPatchFVarValues(getPatchIndex(arrayIndex, patchIndex), channel);
 }
+PatchParam
+PatchTable::GetPatchFVarPatchParam(PatchHandle const & handle, int channel) const {
+    return GetFVarPatchParams(channel)[handle.patchIndex];
+}
+PatchParam
+PatchTable::GetPatchFVarPatchParam(int arrayIndex, int patchIndex, int channel) const {
+    return GetFVarPatchParams(channel)[getPatchIndex(arrayIndex, patchIndex)];
+}
+ConstPatchParamArray
+PatchTable::GetFVarPatchParams(int channel) const {
+    FVarPatchChannel const & c = getFVarPatchChannel(channel);
+    std::vector<PatchParam> const & params =
+        c.patchParams.empty() ? _paramTable : c.patchParams;
+    return ConstPatchParamArray(params.empty() ? 0 : &params[0], (int)params.size());
+}
+
+namespace {
+    inline Index
+    remapIndex(std::vector<Index> const & permutation, Index offset, Index index) {
+        Index i = index - offset;
+        return (i>=0 and i<(Index)permutation.size()) ? offset + permutation[i] : index;
+    }
+
+    void
+    remapStencilSources(std::vector<Index> const & permutation, Index offset,
+        std::vector<Index> & indices) {
+
+        for (int i=0; i<(int)indices.size(); ++i) {
+            indices[i] = remapIndex(permutation, offset, indices[i]);
+        }
+    }
+}
+
+void
+PatchTable::RemapControlVertices(std::vector<Index> const & permutation,
+    Index offset) {
+
+    // Face-varying values shared with the vertices are not remapped with them
+    for (int i=0; i<(int)_fvarChannels.size(); ++i) {
+        separateFVarPatchChannelValues(_fvarChannels[i]);
+    }
+
+    for (int i=0; i<(int)_patchVerts.size(); ++i) {
+        _patchVerts[i] = remapIndex(permutation, offset, _patchVerts[i]);
+    }
+
+    // Each entry of the vertex valence table (the valence of a vertex and its
+    // one-ring) is moved to the new position of its vertex
+    if (not _vertexValenceTable.empty()) {
+        int entrySize = 2*_maxValence + 1,
+            numEntries = (int)_vertexValenceTable.size() / entrySize;
+
+        VertexValenceTable table(_vertexValenceTable.size(), 0);
+        for (int i=0; i<numEntries; ++i) {
+            Index const * src = &_vertexValenceTable[i*entrySize];
+            Index * dst = &table[remapIndex(permutation, offset, i)*entrySize];
+
+            int ringSize = 2*std::abs(src[0]);
+            dst[0] = src[0];
+            for (int j=1; j<=ringSize; ++j) {
+                dst[j] = remapIndex(permutation, offset, src[j]);
+            }
+        }
+        _vertexValenceTable.swap(table);
+    }
+
+    // Local point stencils are owned by the table : their sources are
+    // remapped in place
+    if (_localPointStencils) {
+        remapStencilSources(permutation, offset,
+            const_cast<StencilTable *>(_localPointStencils)->_indices);
+    }
+    if (_localPointVaryingStencils) {
+        remapStencilSources(permutation, offset,
+            const_cast<StencilTable *>(_localPointVaryingStencils)->_indices);
+    }
+}
 
 void
 PatchTable::print() const {
@@ -420,21 +658,75 @@ PatchTable::print() const {
 }
 
 //
-//  Evaluate basis functions for position and first derivatives at (s,t):
+//  Evaluate basis functions for position, first and second derivatives at (s,t):
 //
 void
 PatchTable::EvaluateBasis(PatchHandle const & handle, float s, float t,
-    float wP[], float wDs[], float wDt[]) const {
+    float wP[], float wDs[], float wDt[],
+    float wDss[], float wDst[], float wDtt[]) const {
 
     PatchDescriptor::Type patchType = GetPatchArrayDescriptor(handle.arrayIndex).GetType();
     PatchParam const & param = _paramTable[handle.patchIndex];
 
     if (patchType == PatchDescriptor::REGULAR) {
-        internal::GetBSplineWeights(param, s, t, wP, wDs, wDt);
+        //  single-crease patches have a sharpness, and their crease edge as
+        //  boundary mask
+        float sharpness = _sharpnessIndices.empty() ? 0.0f :
+            GetSingleCreasePatchSharpnessValue(handle);
+        if (sharpness > 0.0f) {
+            internal::GetBSplineSingleCreaseWeights(param, sharpness, s, t,
+                wP, wDs, wDt, wDss, wDst, wDtt);
+        } else {
+            internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+        }
     } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
-        internal::GetGregoryWeights(param, s, t, wP, wDs, wDt);
+        internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::QUADS) {
-        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt);
+        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::LOOP) {
+        internal::GetLoopWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::TRIANGLES) {
+        internal::GetTriangleWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else {
+        assert(0);
+    }
+}
+
+void
+PatchTable::EvaluateBasisFaceVarying(PatchHandle const & handle, float s, float t,
+    float wP[], float wDs[], float wDt[], int channel) const {
+
+    EvaluateBasisFaceVarying(handle, s, t, wP, wDs, wDt, 0, 0, 0, channel);
+}
+
+void
+PatchTable::EvaluateBasisFaceVarying(PatchHandle const & handle, float s, float t,
+    float wP[], float wDs[], float wDt[],
+    float wDss[], float wDst[], float wDtt[], int channel) const {
+
+    PatchDescriptor::Type patchType = GetFVarChannelPatchDescriptor(channel).GetType();
+    PatchParam param = GetPatchFVarPatchParam(handle, channel);
+
+    if (patchType == PatchDescriptor::REGULAR and param.IsRegular()) {
+        internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::REGULAR or
+               patchType == PatchDescriptor::QUADS) {
+        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+
+        //  the corner values of bilinear patches of bicubic channels come first
+        if (patchType == PatchDescriptor::REGULAR) {
+            bool second = wDs and wDt and wDss and wDst and wDtt;
+            for (int i = 4; i < 16; ++i) {
+                wP[i] = 0.0f;
+                if (wDs) wDs[i] = 0.0f;
+                if (wDt) wDt[i] = 0.0f;
+                if (second) {
+                    wDss[i] = 0.0f;
+                    wDst[i] = 0.0f;
+                    wDtt[i] = 0.0f;
+                }
+            }
+        }
     } else {
         assert(0);
     }
@@ -33,6 +33,7 @@
 
 #include "../sdc/options.h"
 
+#include <cassert>
 #include <cstdlib>
 #include <vector>
 
@@ -95,6 +96,45 @@ public:
     /// \brief Returns the total number of ptex faces in the mesh
     int GetNumPtexFaces() const { return _numPtexFaces; }
 
+    /// \brief Memory held by the arrays of the table (see GetTableMemoryUsage)
+    struct TableMemoryUsage {
+        MemoryUsage patchVertices,      ///< patch arrays and control vertices
+                    patchParams,        ///< patch parameterization
+                    sharpness,          ///< single-crease sharpness
+                    fvar,               ///< face-varying channels
+                    localPointStencils, ///< end cap change of basis stencils
+                    gregory;            ///< legacy gregory quad-offsets and
+                                        ///< vertex valences
+    };
+
+    /// \brief Returns the memory held by the arrays of the table -- both their
+    ///        size and their capacity
+    TableMemoryUsage GetTableMemoryUsage() const;
+
+    /// \brief Returns the total memory held by the arrays of the table
+    MemoryUsage GetMemoryUsage() const;
+
+    /// \brief Statistics of the patches of the table (see GetStatistics)
+    struct Statistics {
+        int numPatches,                   ///< number of patches
+            numEndCapPatches,             ///< number of Gregory patches and of
+                                          ///< patches with local points
+            numSingleCreasePatches,       ///< number of single-crease patches
+            numLocalPoints,               ///< number of end cap local points
+            maxValence;                   ///< maximum vertex valence
+        std::vector<int> numPatchesByType,  ///< number of patches of each
+                                            ///< PatchDescriptor::Type
+                         numPatchesByDepth; ///< number of patches of each
+                                            ///< isolation level (depth)
+    };
+
+    /// \brief Returns the statistics of the patches of the table
+    ///
+    /// @param scheduler  Optional scheduler computing the statistics of
+    ///                   ranges of patches of large tables concurrently
+    ///
+    Statistics GetStatistics(TaskScheduler const * scheduler = 0) const;
+
 
     //@{
     ///  @name Individual patches
@@ -238,6 +278,15 @@ public:
     /// \brief Returns the interpolation mode for a given channel
     Sdc::Options::FVarLinearInterpolation GetFVarChannelLinearInterpolation(int channel = 0) const;
 
+    /// \brief Returns the patch descriptor of the patches of a given channel
+    ///
+    /// Patches of bilinear channels are QUADS (or TRIANGLES). Patches of
+    /// bicubic channels (see PatchTableFactory::Options) are REGULAR : the
+    /// values of a patch are the points of a B-spline patch if its PatchParam
+    /// IsRegular(), otherwise its 4 corner values come first and the patch is
+    /// bilinear.
+    PatchDescriptor GetFVarChannelPatchDescriptor(int channel = 0) const;
+
 
     /// \brief Returns the value indices for a given patch in a channel
     ConstIndexArray GetPatchFVarValues(PatchHandle const & handle, int channel = 0) const;
@@ -247,7 +296,20 @@ public:
 
 
     /// \brief Returns an array of value indices for the patches in a channel
+    ///        (empty until gathered if deferred, see
+    ///        PatchTableFactory::BuildFVarChannel())
     ConstIndexArray GetFVarValues(int channel = 0) const;
+
+
+    /// \brief Returns the PatchParam of a given patch in a channel (those of
+    ///        bilinear channels are the PatchParams of the patches)
+    PatchParam GetPatchFVarPatchParam(PatchHandle const & handle, int channel = 0) const;
+
+    /// \brief Returns the PatchParam of a given patch in a channel
+    PatchParam GetPatchFVarPatchParam(int array, int patch, int channel = 0) const;
+
+    /// \brief Returns an array of PatchParams for the patches in a channel
+    ConstPatchParamArray GetFVarPatchParams(int channel = 0) const;
     //@}
 
 
@@ -280,6 +342,23 @@ public:
     }
     //@}
 
+    /// \brief Remaps the indices of the vertices referenced by the table
+    ///
+    /// Remaps the control vertices of the patches, the vertex valence table
+    /// and the sources of the local point stencils after the vertices have
+    /// been reordered (see StencilTableFactory::ReorderStencils).
+    ///
+    /// @param permutation  New index of each vertex relative to 'offset'
+    ///                     (permutation[oldIndex] == newIndex)
+    ///
+    /// @param offset       Index of the first reordered vertex (typically the
+    ///                     number of control vertices if the stencils of the
+    ///                     control vertices are not in the table) : vertices
+    ///                     outside of the permutation are left unchanged
+    ///
+    void RemapControlVertices(std::vector<Index> const & permutation,
+        Index offset = 0);
+
     /// debug helper
     void print() const;
 
@@ -289,8 +368,8 @@ public:
     ///  @name Evaluation methods
     ///
 
-    /// \brief Evaluate basis functions for position and first derivatives at a
-    /// given (s,t) parametric location of a patch.
+    /// \brief Evaluate basis functions for position, first and (optionally)
+    /// second derivatives at a given (s,t) parametric location of a patch.
     ///
     /// @param handle  A patch handle indentifying the sub-patch containing the
     ///                (s,t) location
@@ -305,14 +384,60 @@ public:
     ///
     /// @param wDt     Weights (evaluated basis functions) for derivative wrt t
     ///
+    /// @param wDss    Weights (evaluated basis functions) for the second
+    ///                derivative wrt s (optional)
+    ///
+    /// @param wDst    Weights (evaluated basis functions) for the mixed
+    ///                derivative wrt s and t (optional)
+    ///
+    /// @param wDtt    Weights (evaluated basis functions) for the second
+    ///                derivative wrt t (optional)
+    ///
+    /// \note Second derivatives are only evaluated if wDss, wDst and wDtt are
+    ///       all given (along with the first derivatives)
+    ///
+    /// \note Locations of the triangular patches of Loop meshes are in the
+    ///       half s + t <= 1 of the normalized space of their coarse face
+    ///
     void EvaluateBasis(PatchHandle const & handle, float s, float t,
-        float wP[], float wDs[], float wDt[]) const;
+        float wP[], float wDs[], float wDt[],
+        float wDss[] = 0, float wDst[] = 0, float wDtt[] = 0) const;
+
+    /// \brief Evaluate basis functions for the face-varying values of a
+    /// channel at a given (s,t) parametric location of a patch (weights of
+    /// the values returned by GetPatchFVarValues()).
+    ///
+    /// @param handle  A patch handle indentifying the sub-patch containing the
+    ///                (s,t) location
+    ///
+    /// @param s       Patch coordinate (in coarse face normalized space)
+    ///
+    /// @param t       Patch coordinate (in coarse face normalized space)
+    ///
+    /// @param wP      Weights (evaluated basis functions) for the position
+    ///
+    /// @param wDs     Weights (evaluated basis functions) for derivative wrt s
+    ///
+    /// @param wDt     Weights (evaluated basis functions) for derivative wrt t
+    ///
+    /// @param channel Face-varying channel
+    ///
+    void EvaluateBasisFaceVarying(PatchHandle const & handle, float s, float t,
+        float wP[], float wDs[], float wDt[], int channel = 0) const;
+
+    /// \brief Evaluate basis functions for the face-varying values of a
+    /// channel, including second derivatives (see EvaluateBasis())
+    ///
+    void EvaluateBasisFaceVarying(PatchHandle const & handle, float s, float t,
+        float wP[], float wDs[], float wDt[],
+        float wDss[], float wDst[], float wDtt[], int channel = 0) const;
 
     //@}
 
 protected:
 
     friend class PatchTableFactory;
+    friend class TableSerializer;
 
     // Factory constructor
     PatchTable(int maxvalence);
@@ -330,7 +455,24 @@ private:
     // Patch arrays
     //
 
-    struct PatchArray;
+    struct PatchArray {
+
+        PatchArray(PatchDescriptor d, int np, Index v, Index p, Index qo) :
+                desc(d), numPatches(np), vertIndex(v),
+                    patchIndex(p), quadOffsetIndex (qo) { }
+
+        void print() const;
+
+        PatchDescriptor desc;  // type of patches in the array
+
+        int numPatches;        // number of patches in the array
+
+        Index vertIndex,       // index to the first control vertex
+              patchIndex,      // index of the first patch in the array
+              quadOffsetIndex; // index of the first quad offset entry
+
+    };
+
     typedef std::vector<PatchArray> PatchArrayVector;
 
     PatchArray & getPatchArray(Index arrayIndex);
@@ -348,8 +490,52 @@ private:
     //
     // FVar patch channels
     //
+    // Stores a record for each patch in the primitive :
+    //
+    //  - Each patch in the PatchTable has a corresponding patch in each
+    //    face-varying patch channel. Patch vertex indices are sorted in the same
+    //    patch-type order as PatchTable::PTables. Face-varying data for a patch
+    //    can therefore be quickly accessed by using the patch primitive ID as
+    //    index into patchValueOffsets to locate the face-varying control vertex
+    //    indices.
+    //
+    //  - Face-varying channels can have a different interpolation modes
+    //
+    //  - Unlike "vertex" patches, there are no transition masks required
+    //    for face-varying patches.
+    //
+    //  - Face-varying patches still require boundary edge masks.
+    //
+    //  - currently most patches with sharp boundaries but smooth interiors have
+    //    to be isolated to level 10 : we need a special type of bicubic patch
+    //    similar to single-crease to resolve this condition without requiring
+    //    isolation if possible
+    //
+    struct FVarPatchChannel {
+
+        // Channel interpolation mode
+        Sdc::Options::FVarLinearInterpolation interpolation;
+
+        // Patch type
+        //
+        // Note : in bilinear interpolation modes, all patches are of the same type,
+        // so we only need a single type (patchesType). In bi-cubic modes, each
+        // patch requires its own type (patchTypes).
+        PatchDescriptor::Type              patchesType;
+        std::vector<PatchDescriptor::Type> patchTypes;
+
+        // Patch points values
+        std::vector<Index> patchValuesOffsets; // offset to the first value of each patch
+        std::vector<Index> patchValues; // point values for each patch
+
+        // Values are those of the patch vertices (patchValues is empty) : the
+        // channel aliases the vertex topology of a uniform table
+        bool sharesPatchVertices;
+
+        // Patch parameterization of bicubic channels (empty otherwise)
+        std::vector<PatchParam> patchParams;
+    };
 
-    struct FVarPatchChannel;
     typedef std::vector<FVarPatchChannel> FVarPatchChannelVector;
 
     FVarPatchChannel & getFVarPatchChannel(int channel);
@@ -362,6 +548,11 @@ private:
     void setFVarPatchChannelLinearInterpolation(
         Sdc::Options::FVarLinearInterpolation interpolation, int channel);
 
+    void setFVarPatchChannelPatchesType(PatchDescriptor::Type type, int channel);
+
+    std::vector<Index> const & getFVarPatchChannelValues(FVarPatchChannel const & c) const;
+    void separateFVarPatchChannelValues(FVarPatchChannel & c);
+
 
     PatchDescriptor::Type getFVarPatchType(int patch, int channel) const;
     Vtr::Array<PatchDescriptor::Type> getFVarPatchTypes(int channel);
@@ -402,6 +593,10 @@ private:
 
     FVarPatchChannelVector _fvarChannels;
 
+    // Face of each patch (indexed over all levels) retained to gather deferred
+    // face-varying channels of adaptive tables on demand
+    std::vector<Index> _fvarPatchFaces;
+
     //
     // 'single-crease' patch sharpness tables
     //
@@ -410,6 +605,30 @@ private:
     std::vector<float>   _sharpnessValues;  // Sharpness values.
 };
 
+inline PatchTable::PatchArray &
+PatchTable::getPatchArray(Index arrayIndex) {
+    assert(arrayIndex<(Index)GetNumPatchArrays());
+    return _patchArrays[arrayIndex];
+}
+
+inline PatchTable::PatchArray const &
+PatchTable::getPatchArray(Index arrayIndex) const {
+    assert(arrayIndex<(Index)GetNumPatchArrays());
+    return _patchArrays[arrayIndex];
+}
+
+inline PatchTable::FVarPatchChannel &
+PatchTable::getFVarPatchChannel(int channel) {
+    assert(channel<(int)_fvarChannels.size());
+    return _fvarChannels[channel];
+}
+
+inline PatchTable::FVarPatchChannel const &
+PatchTable::getFVarPatchChannel(int channel) const {
+    assert(channel<(int)_fvarChannels.size());
+    return _fvarChannels[channel];
+}
+
 template <class T>
 inline void
 PatchTable::ComputeLocalPointValues(T const *src, T *dst) const {
@@ -24,6 +24,7 @@
 #include "../far/patchTableFactory.h"
 #include "../far/error.h"
 #include "../far/ptexIndices.h"
+#include "../far/profile.h"
 #include "../far/topologyRefiner.h"
 #include "../vtr/level.h"
 #include "../vtr/fvarLevel.h"
@@ -31,9 +32,12 @@
 #include "../far/endCapBSplineBasisPatchFactory.h"
 #include "../far/endCapGregoryBasisPatchFactory.h"
 #include "../far/endCapLegacyGregoryPatchFactory.h"
+#include "../far/taskScheduler.h"
+#include "../far/buildMonitor.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
 namespace OpenSubdiv {
@@ -74,6 +78,7 @@ typedef PatchTypes<Far::PatchParam *> PatchParamPointers;
 typedef PatchTypes<Far::Index *>      SharpnessIndexPointers;
 typedef PatchTypes<Far::Index>        PatchFVarOffsets;
 typedef PatchTypes<Far::Index **>     PatchFVarPointers;
+typedef PatchTypes<Far::Index *>      PatchFacePointers;
 
 //  Helpers for compiler warnings and floating point equality tests
 #ifdef __INTEL_COMPILER
@@ -87,6 +92,42 @@ inline bool isSharpnessEqual(float s1, float s2) { return (s1 == s2); }
 #pragma warning (pop)
 #endif
 
+//  True if a base face can be approximated by a patch without isolation : a quad
+//  with quads around its vertices, manifold, and with at most two adjacent boundary
+//  edges and no other boundary vertex, or a single boundary vertex (the configurations
+//  isolation otherwise reduces the faces of the patches to):
+bool
+isApproximableFace(Vtr::internal::Level const & level, Vtr::Index face) {
+
+    Vtr::ConstIndexArray fVerts = level.getFaceVertices(face);
+    if (fVerts.size() != 4) return false;
+
+    for (int i = 0; i < fVerts.size(); ++i) {
+        Vtr::ConstIndexArray vFaces = level.getVertexFaces(fVerts[i]);
+        for (int j = 0; j < vFaces.size(); ++j) {
+            if (level.getFaceVertices(vFaces[j]).size() != 4) return false;
+        }
+    }
+
+    Vtr::internal::Level::VTag compFaceVertTag = level.getFaceCompositeVTag(fVerts);
+    if (compFaceVertTag._nonManifold) return false;
+    if (not compFaceVertTag._boundary) return true;
+
+    Vtr::ConstIndexArray fEdges = level.getFaceEdges(face);
+
+    int edgeMask = 0, vertCount = 0;
+    for (int i = 0; i < 4; ++i) {
+        edgeMask  |= level.getEdgeTag(fEdges[i])._boundary << i;
+        vertCount += level.getVertexTag(fVerts[i])._boundary;
+    }
+    switch (edgeMask) {
+    case 0x0:  return vertCount == 1;
+    case 0x1: case 0x2: case 0x4: case 0x8:  return vertCount == 2;
+    case 0x3: case 0x6: case 0x9: case 0xc:  return vertCount == 3;
+    default:   return false;
+    }
+}
+
 } // namespace anon
 
 
@@ -278,6 +319,38 @@ private:
     int const * _channelIndices;  // list of selected channel indices
 };
 
+//
+// Patch face range
+//
+// A contiguous range of faces within a level of the refiner. The faces of
+// each level are divided into ranges that are identified and populated
+// independently (and so possibly concurrently). The patches identified for
+// each range are counted, and the counts are accumulated in order to locate
+// the first patch of each range in the patch arrays before populating them,
+// so that the resulting tables match those populated serially.
+//
+struct PatchTableFactory::PatchFaceRange {
+
+    int   level;
+    Index levelFaceOffset,
+          levelVertOffset;
+    Index faceBegin,
+          faceEnd;
+
+    // Number of patches of each type identified for the faces of the range
+    PatchTypes<int> patchCounts;
+
+    // Index of the first patch of the range in each patch array, and in the
+    // table as a whole (sharpness indices are assigned in face order)
+    PatchTypes<int> patchOffsets;
+    int             patchIndex;
+
+    // End-cap patches share points with their neighbors, so their points
+    // are gathered serially and in order once all ranges are populated
+    std::vector<Index>   endCapFaces;
+    std::vector<Index *> endCapVerts;
+};
+
 //
 // Adaptive Context
 //
@@ -291,12 +364,17 @@ private:
 struct PatchTableFactory::AdaptiveContext {
 
 public:
-    AdaptiveContext(TopologyRefiner const & refiner, Options options);
+    AdaptiveContext(TopologyRefiner const & refiner, Options options,
+                    int isolationLevel=-1);
 
     TopologyRefiner const & refiner;
 
     Options const options;
 
+    // The level patches are isolated to (the last level of the refiner
+    // unless creating a level of detail)
+    int const maxLevel;
+
     // The patch table being created
     PatchTable * table;
 
@@ -312,6 +390,15 @@ public:
     // Bit tags accumulating patch attributes during topology traversal
     PatchTagVector patchTags;
 
+    // Ranges of faces of all levels identified and populated independently
+    std::vector<PatchFaceRange> faceRanges;
+
+    // Scheduler for the face ranges (null if they are processed serially)
+    TaskScheduler const * taskScheduler;
+
+    // Optional monitor of the build, checked between face ranges
+    BuildMonitor * monitor;
+
 public:
 
     //
@@ -321,6 +408,10 @@ public:
     // True if face-varying patches need to be generated for this topology
     bool RequiresFVarPatches() const;
 
+    // True if the face-varying values are deferred (the faces of the patches
+    // are retained instead, see PatchTableFactory::BuildFVarChannel)
+    bool DefersFVarPatches() const;
+
     // A cursor to iterate through the face-varying channels requested
     // by client-code
     FVarChannelCursor fvarChannelCursor;
@@ -328,14 +419,69 @@ public:
 
 // Constructor
 PatchTableFactory::AdaptiveContext::AdaptiveContext(
-    TopologyRefiner const & ref, Options opts) :
-    refiner(ref), options(opts), table(0),
+    TopologyRefiner const & ref, Options opts, int isolationLevel) :
+    refiner(ref), options(opts),
+    maxLevel(isolationLevel < 0 ? ref.GetMaxLevel() : isolationLevel),
+    table(0),
+    taskScheduler(opts.taskScheduler),
+    monitor(opts.monitor),
     fvarChannelCursor(ref, opts) {
+
+    if (taskScheduler and taskScheduler->GetNumThreads() < 2) {
+        taskScheduler = 0;
+    }
 }
 
 bool
 PatchTableFactory::AdaptiveContext::RequiresFVarPatches() const {
-    return (fvarChannelCursor.size() > 0);
+    return (fvarChannelCursor.size() > 0) and not options.deferFVarChannels;
+}
+
+bool
+PatchTableFactory::AdaptiveContext::DefersFVarPatches() const {
+    return (fvarChannelCursor.size() > 0) and options.deferFVarChannels;
+}
+
+//
+// Populate Context
+//
+// Data shared by the face ranges populating the patch table -- the ranges
+// locate their patches relative to the start of each patch array.
+//
+struct PatchTableFactory::PopulateContext {
+
+public:
+    PopulateContext(AdaptiveContext & ctx, PtexIndices const & ptex) :
+        context(ctx), ptexIndices(ptex) { }
+
+    AdaptiveContext & context;
+
+    PtexIndices const & ptexIndices;
+
+    // Pointers to the first patch of each patch array
+    PatchCVPointers    iptrs;
+    PatchParamPointers pptrs;
+    PatchFVarPointers  fptrs;
+    PatchFacePointers  faceptrs;
+
+    // Offsets to the face-varying values of each level (for all channels)
+    std::vector<Index> levelFVarVertOffsets;
+
+    // Sharpness of all patches in face order (if sharpness is required)
+    std::vector<float> sharpness;
+};
+
+namespace {
+    // Number of faces per range of patches identified and populated
+    // concurrently -- a few ranges per thread to balance the load
+    inline int
+    getRangeSize(int numFaces, TaskScheduler const & scheduler) {
+        return std::max(1024, numFaces / (4 * scheduler.GetNumThreads()) + 1);
+    }
+
+    // Number of faces per range of a monitored build processed serially --
+    // the build is checked for cancellation between ranges
+    int const monitoredRangeSize = 4096;
 }
 
 //
@@ -394,10 +540,20 @@ PatchTableFactory::allocateFVarChannels(TopologyRefiner const & refiner,
         PatchDescriptor::Type type = options.triangulateQuads ?
             PatchDescriptor::TRIANGLES : PatchDescriptor::QUADS;
 
+        table->setFVarPatchChannelPatchesType(type, fvc.pos());
+
         nverts =
             npatches * PatchDescriptor::GetNumFVarControlVertices(type);
 
-        table->allocateFVarPatchChannelValues(npatches, nverts, fvc.pos());
+        if (not options.deferFVarChannels) {
+            PatchTable::FVarPatchChannel & c = table->getFVarPatchChannel(fvc.pos());
+
+            c.sharesPatchVertices = refiner.IsUniform() and
+                uniformFVarValuesMatchVertices(refiner, options, *fvc);
+            if (not c.sharesPatchVertices) {
+                table->allocateFVarPatchChannelValues(npatches, nverts, fvc.pos());
+            }
+        }
     }
 }
 
@@ -417,8 +573,9 @@ PatchTableFactory::gatherFVarData(AdaptiveContext & context, int level,
 
     TopologyRefiner const & refiner = context.refiner;
 
-    // Iterate over valid FVar channels (if any)
-    FVarChannelCursor & fvc = context.fvarChannelCursor;
+    // Iterate over valid FVar channels (if any) -- with a copy of the cursor,
+    // as faces of different ranges may be gathered concurrently
+    FVarChannelCursor fvc = context.fvarChannelCursor;
     for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
 
         Vtr::internal::Level const & vtxLevel = refiner.getLevel(level);
@@ -458,6 +615,38 @@ PatchTableFactory::computePatchParam(
         v = 0,
         ofs = 1;
 
+    if (refiner.GetSchemeType() == Sdc::SCHEME_LOOP) {
+        // Sub-triangles are identified by the path of their child indices from
+        // the coarse face, the rotated center children mirroring the cells of
+        // their parents (see PatchParam)
+        unsigned char childIndices[16];
+        assert(depth < 16);
+
+        for (int i = depth; i > 0; --i) {
+            Vtr::internal::Refinement const& refinement = refiner.getRefinement(i-1);
+
+            childIndices[i-1] = (unsigned char)refinement.getChildFaceInParentFace(faceIndex);
+            faceIndex = refinement.getChildFaceParentFace(faceIndex);
+        }
+        for (int i = 0; i < depth; ++i) {
+            int res = 1 << (i+1);
+            switch ( childIndices[i] ) {
+                case 0 : { u = 2*u;           v = 2*v;           } break;
+                case 1 : { u = 2*u + 1;       v = 2*v;           } break;
+                case 2 : { u = 2*u;           v = 2*v + 1;       } break;
+                case 3 : { u = res - 1 - 2*u; v = res - 1 - 2*v; } break;
+            }
+        }
+
+        Vtr::Index ptexIndex = ptexIndices.GetFaceId(faceIndex);
+        assert(ptexIndex!=-1);
+
+        param->Set(ptexIndex, (short)u, (short)v, (unsigned short) depth, false,
+                   (unsigned short) boundaryMask, (unsigned short) transitionMask);
+
+        return ++param;
+    }
+
     bool nonquad = (refiner.GetLevel(depth).GetFaceVertices(faceIndex).size() != 4);
 
     for (int i = depth; i > 0; --i) {
@@ -529,517 +718,1725 @@ assignSharpnessIndex(float sharpness, std::vector<float> & sharpnessValues) {
 PatchTable *
 PatchTableFactory::Create(TopologyRefiner const & refiner, Options options) {
 
-    if (refiner.IsUniform()) {
-        return createUniform(refiner, options);
+    OPENSUBDIV_PROFILE_ZONE("PatchTableFactory::Create");
+
+    if (refiner.IsTrimmed()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::Create() -- refinements were trimmed.");
+        return 0;
+    }
+    if (refiner.IsUniform() or refiner.GetSchemeType() == Sdc::SCHEME_LOOP) {
+        // (uniform and Loop patches are checked for cancellation once complete)
+        BuildMonitor * monitor = options.monitor;
+        if (monitor) {
+            monitor->beginStage(0.0f, 1.0f, 1);
+        }
+        PatchTable * table = refiner.IsUniform() ?
+            createUniform(refiner, options) : createLoopAdaptive(refiner, options);
+        if (monitor and (not monitor->advance(1))) {
+            delete table;
+            return 0;
+        }
+        return table;
     } else {
         return createAdaptive(refiner, options);
     }
 }
 
 PatchTable *
-PatchTableFactory::createUniform(TopologyRefiner const & refiner, Options options) {
+PatchTableFactory::CreateLevelOfDetail(TopologyRefiner const & refiner,
+    int isolationLevel, Index localPointOffset, Options options) {
 
-    assert(refiner.IsUniform());
-
-    // ensure that triangulateQuads is only set for quadrilateral schemes
-    options.triangulateQuads &= (refiner.GetSchemeType()==Sdc::SCHEME_BILINEAR or
-                                 refiner.GetSchemeType()==Sdc::SCHEME_CATMARK);
+    OPENSUBDIV_PROFILE_ZONE("PatchTableFactory::CreateLevelOfDetail");
 
-    // level=0 may contain n-gons, which are not supported in PatchTable.
-    // even if generateAllLevels = true, we start from level 1.
+    if (refiner.IsUniform() or refiner.IsSparse() or refiner.IsTrimmed() or
+            refiner.GetSchemeType() != Sdc::SCHEME_CATMARK) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::CreateLevelOfDetail() -- "
+            "requires a non-sparse adaptive Catmark refinement.");
+        return 0;
+    }
+    if (isolationLevel < 1 or isolationLevel > refiner.GetMaxLevel() or
+            localPointOffset < 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::CreateLevelOfDetail() -- "
+            "invalid isolation level or local point offset.");
+        return 0;
+    }
 
-    int maxvalence = refiner.GetMaxValence(),
-        maxlevel = refiner.GetMaxLevel(),
-        firstlevel = options.generateAllLevels ? 1 : maxlevel,
-        nlevels = maxlevel-firstlevel+1;
+    options.maxIsolationLevel = isolationLevel;
+    options.deferFVarChannels = false;
 
-    PtexIndices ptexIndices(refiner);
+    PatchTable * table = createAdaptive(refiner, options, isolationLevel);
 
-    PatchDescriptor::Type ptype = PatchDescriptor::NON_PATCH;
-    if (options.triangulateQuads) {
-        ptype = PatchDescriptor::TRIANGLES;
-    } else {
-        switch (refiner.GetSchemeType()) {
-            case Sdc::SCHEME_BILINEAR :
-            case Sdc::SCHEME_CATMARK  : ptype = PatchDescriptor::QUADS; break;
-            case Sdc::SCHEME_LOOP     : ptype = PatchDescriptor::TRIANGLES; break;
+    //  Local points are the only vertices indexed past the refined vertices:
+    if (localPointOffset) {
+        Index numRefinedVerts = refiner.GetNumVerticesTotal();
+        for (size_t i = 0; i < table->_patchVerts.size(); ++i) {
+            if (table->_patchVerts[i] >= numRefinedVerts) {
+                table->_patchVerts[i] += localPointOffset;
+            }
         }
     }
-    assert(ptype!=PatchDescriptor::NON_PATCH);
-
-    //
-    //  Create the instance of the table and allocate and initialize its members.
-    //
-    PatchTable * table = new PatchTable(maxvalence);
-
-    table->_numPtexFaces = ptexIndices.GetNumFaces();
-
-    table->reservePatchArrays(nlevels);
+    return table;
+}
 
-    PatchDescriptor desc(ptype);
+PatchTable *
+PatchTableFactory::CreateApproximate(TopologyRefiner const & refiner,
+                                     Options options) {
 
-    // generate patch arrays
-    for (int level=firstlevel, poffset=0, voffset=0; level<=maxlevel; ++level) {
+    OPENSUBDIV_PROFILE_ZONE("PatchTableFactory::CreateApproximate");
 
-        TopologyLevel const & refLevel = refiner.GetLevel(level);
+    if ((refiner.GetNumLevels() > 1) or
+            refiner.GetSchemeType() != Sdc::SCHEME_CATMARK) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::CreateApproximate() -- "
+            "requires an unrefined Catmark refiner.");
+        return 0;
+    }
 
-        int npatches = refLevel.GetNumFaces();
-        if (refiner.HasHoles()) {
-            for (int i = npatches - 1; i >= 0; --i) {
-                npatches -= refLevel.IsFaceHole(i);
-            }
-        }
-        assert(npatches>=0);
+    //  The legacy Gregory patches rely on isolated extraordinary vertices:
+    if (options.GetEndCapType() == Options::ENDCAP_LEGACY_GREGORY) {
+        options.SetEndCapType(Options::ENDCAP_GREGORY_BASIS);
+    }
+    //  (face-varying patches of the base level are not supported)
+    options.generateFVarTables = false;
+    options.deferFVarChannels = false;
 
-        if (options.triangulateQuads)
-            npatches *= 2;
+    //  Patches of the faces of the base level:
+    return createAdaptive(refiner, options, 0);
+}
 
-        table->pushPatchArray(desc, npatches, &voffset, &poffset, 0);
-    }
+//
+//  Merging the tables of partitions of a mesh -- patches of the same descriptor are gathered
+//  in a single array, in the order of the tables:
+//
+PatchTable *
+PatchTableFactory::Create(int numTables, PatchTable const ** tables,
+                          Index const * vertexOffsets) {
 
-    // Allocate various tables
-    allocateVertexTables( table, 0, /*hasSharpness=*/false );
+    OPENSUBDIV_PROFILE_ZONE("PatchTableFactory::Create");
 
-    FVarChannelCursor fvc(refiner, options);
-    bool generateFVarPatches = (options.generateFVarTables and fvc.size()>0);
-    if (generateFVarPatches) {
-        int npatches = table->GetNumPatchesTotal();
-        allocateFVarChannels(refiner, options, npatches, table);
-        assert(fvc.size() == table->GetNumFVarChannels());
+    if ((numTables <= 0) or (not tables)) {
+        return 0;
     }
 
-    //
-    //  Now populate the patches:
-    //
+    std::vector<PatchDescriptor> descs;
+    std::vector<int> descPatches;
 
-    Index          * iptr = &table->_patchVerts[0];
-    PatchParam     * pptr = &table->_paramTable[0];
-    Index         ** fptr = 0;
+    int maxValence = 0,
+        numPtexFaces = 0;
+    bool hasSharpness = false;
 
-    // we always skip level=0 vertices (control cages)
-    Index levelVertOffset = refiner.GetLevel(0).GetNumVertices();
+    for (int i = 0; i < numTables; ++i) {
+        PatchTable const * src = tables[i];
+        if (not src) continue;
 
-    Index * levelFVarVertOffsets = 0;
-    if (generateFVarPatches) {
+        if (not src->_vertexValenceTable.empty()) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::Create() -- legacy Gregory patches cannot be merged.");
+            return 0;
+        }
+        maxValence   = std::max(maxValence, src->GetMaxValence());
+        numPtexFaces = std::max(numPtexFaces, src->GetNumPtexFaces());
+        hasSharpness = hasSharpness or not src->_sharpnessIndices.empty();
 
-        levelFVarVertOffsets = (Index *)alloca(fvc.size()*sizeof(Index));
-        memset(levelFVarVertOffsets, 0, fvc.size()*sizeof(Index));
+        for (int array = 0; array < src->GetNumPatchArrays(); ++array) {
+            PatchDescriptor desc = src->GetPatchArrayDescriptor(array);
 
-        fptr = (Index **)alloca(fvc.size()*sizeof(Index *));
-        for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
-            fptr[fvc.pos()] = table->getFVarValues(fvc.pos()).begin();
+            int d = (int)(std::find(descs.begin(), descs.end(), desc) - descs.begin());
+            if (d == (int)descs.size()) {
+                descs.push_back(desc);
+                descPatches.push_back(0);
+            }
+            descPatches[d] += src->GetNumPatches(array);
         }
     }
 
-    for (int level=1; level<=maxlevel; ++level) {
+    PatchTable * table = new PatchTable(maxValence);
 
-        TopologyLevel const & refLevel = refiner.GetLevel(level);
+    table->_numPtexFaces = numPtexFaces;
 
-        int nfaces = refLevel.GetNumFaces();
-        if (level>=firstlevel) {
-            for (int face=0; face<nfaces; ++face) {
+    table->reservePatchArrays((int)descs.size());
 
-                if (refiner.HasHoles() and refLevel.IsFaceHole(face)) {
-                    continue;
-                }
+    int voffset = 0, poffset = 0;
+    for (int d = 0; d < (int)descs.size(); ++d) {
+        table->pushPatchArray(descs[d], descPatches[d], &voffset, &poffset, 0);
+    }
 
-                ConstIndexArray fverts = refLevel.GetFaceVertices(face);
-                for (int vert=0; vert<fverts.size(); ++vert) {
-                    *iptr++ = levelVertOffset + fverts[vert];
-                }
+    allocateVertexTables(table, 0, hasSharpness);
 
-                pptr = computePatchParam(refiner, ptexIndices, level, face, /*boundary*/0, /*transition*/0, pptr);
+    for (int array = 0; array < table->GetNumPatchArrays(); ++array) {
+        PatchDescriptor desc = table->GetPatchArrayDescriptor(array);
 
-                if (generateFVarPatches) {
-                    for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
-                        ConstIndexArray fvalues = refLevel.GetFaceFVarValues(face, *fvc);
-                        for (int vert=0; vert<fvalues.size(); ++vert) {
-                            assert((levelVertOffset + fvalues[vert]) < (int)table->getFVarValues(fvc.pos()).size());
-                            fptr[fvc.pos()][vert] = levelFVarVertOffsets[fvc.pos()] + fvalues[vert];
-                        }
-                        fptr[fvc.pos()]+=fvalues.size();
-                    }
-                }
+        Index *      iptr = table->getPatchArrayVertices(array).begin();
+        PatchParam * pptr = table->getPatchParams(array).begin();
+        Index *      sptr = hasSharpness ? table->getSharpnessIndices(array) : 0;
 
-                if (options.triangulateQuads) {
-                    // Triangulate the quadrilateral: {v0,v1,v2,v3} -> {v0,v1,v2},{v3,v0,v2}.
-                    *iptr = *(iptr - 4); // copy v0 index
-                    ++iptr;
-                    *iptr = *(iptr - 3); // copy v2 index
-                    ++iptr;
+        for (int i = 0; i < numTables; ++i) {
+            PatchTable const * src = tables[i];
+            if (not src) continue;
 
-                    *pptr = *(pptr - 1); // copy first patch param
-                    ++pptr;
+            Index vertexOffset = vertexOffsets ? vertexOffsets[i] : 0;
 
-                    if (generateFVarPatches) {
-                        for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
-                            *fptr[fvc.pos()] = *(fptr[fvc.pos()]-4); // copy fv0 index
-                            ++fptr[fvc.pos()];
-                            *fptr[fvc.pos()] = *(fptr[fvc.pos()]-3); // copy fv2 index
-                            ++fptr[fvc.pos()];
-                        }
-                    }
+            for (int srcArray = 0; srcArray < src->GetNumPatchArrays(); ++srcArray) {
+                if (not (src->GetPatchArrayDescriptor(srcArray) == desc)) continue;
+
+                ConstIndexArray srcVerts = src->GetPatchArrayVertices(srcArray);
+                for (int k = 0; k < srcVerts.size(); ++k) {
+                    *iptr++ = srcVerts[k] + vertexOffset;
                 }
-            }
-        }
 
-        if (options.generateAllLevels) {
-            levelVertOffset += refiner.GetLevel(level).GetNumVertices();
-            for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
-                levelFVarVertOffsets[fvc.pos()] += refiner.GetLevel(level).GetNumFVarValues(fvc.pos());
+                int numPatches = src->GetNumPatches(srcArray);
+                for (int patch = 0; patch < numPatches; ++patch) {
+                    *pptr++ = src->GetPatchParam(srcArray, patch);
+
+                    if (sptr) {
+                        Index sharpnessIndex = src->_sharpnessIndices.empty() ? Vtr::INDEX_INVALID :
+                            src->_sharpnessIndices[src->getPatchIndex(srcArray, patch)];
+                        *sptr++ = Vtr::IndexIsValid(sharpnessIndex) ?
+                            assignSharpnessIndex(src->_sharpnessValues[sharpnessIndex],
+                                                 table->_sharpnessValues) :
+                            Vtr::INDEX_INVALID;
+                    }
+                }
             }
         }
     }
     return table;
 }
 
-PatchTable *
-PatchTableFactory::createAdaptive(TopologyRefiner const & refiner, Options options) {
-
-    assert(not refiner.IsUniform());
+bool
+PatchTableFactory::UpdateFVarChannels(TopologyRefiner const & refiner,
+                                      PatchTable & table, Options options) {
 
-    PtexIndices ptexIndices(refiner);
+    options.generateFVarTables = true;
 
-    AdaptiveContext context(refiner, options);
+    //  Channels of uniform and deferred adaptive tables are gathered directly:
+    if ((refiner.IsUniform() or not table._fvarPatchFaces.empty()) and
+        (FVarChannelCursor(refiner, options).size() == table.GetNumFVarChannels())) {
 
-    //
-    //  First identify the patches -- accumulating the inventory patches for all of the
-    //  different types and information about the patch for each face:
-    //
-    identifyAdaptivePatches(context);
+        bool built = true;
+        for (int channel = 0; built and (channel < table.GetNumFVarChannels()); ++channel) {
+            built = BuildFVarChannel(refiner, table, channel, options);
+        }
+        return built;
+    }
 
-    //
-    //  Create the instance of the table and allocate and initialize its members based on
-    //  the inventory of patches determined above:
-    //
-    int maxValence = refiner.GetMaxValence();
+    PatchTable * fvarTable = Create(refiner, options);
+    if (not fvarTable) {
+        return false;
+    }
 
-    context.table = new PatchTable(maxValence);
+    //  The face-varying values are gathered in the order of the patches, which must match:
+    bool matching = (fvarTable->GetNumPatchArrays() == table.GetNumPatchArrays());
+    for (int i = 0; matching and (i < table.GetNumPatchArrays()); ++i) {
+        matching = (fvarTable->GetPatchArrayDescriptor(i) == table.GetPatchArrayDescriptor(i)) and
+                   (fvarTable->GetNumPatches(i) == table.GetNumPatches(i));
+    }
+    if (matching) {
+        table._fvarChannels.swap(fvarTable->_fvarChannels);
+    } else {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::UpdateFVarChannels() -- "
+            "patches differ from those of the table.");
+    }
+    delete fvarTable;
+    return matching;
+}
 
-    // Populate the patch array descriptors
-    int numPatchArrays = 0;
-    if (context.patchInventory.R > 0) ++numPatchArrays;
-    if (context.patchInventory.G > 0) ++numPatchArrays;
-    if (context.patchInventory.GB > 0) ++numPatchArrays;
-    if (context.patchInventory.GP > 0) ++numPatchArrays;
+bool
+PatchTableFactory::BuildFVarChannel(TopologyRefiner const & refiner,
+                                    PatchTable & table, int channel, Options options) {
 
-    context.table->reservePatchArrays(numPatchArrays);
+    options.generateFVarTables = true;
 
-    // Sort through the inventory and push back non-empty patch arrays
-    ConstPatchDescriptorArray const & descs =
-        PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_CATMARK);
+    if (refiner.IsTrimmed()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::BuildFVarChannel() -- refinements were trimmed.");
+        return false;
+    }
 
-    int voffset=0, poffset=0, qoffset=0;
-    for (int i=0; i<descs.size(); ++i) {
-        PatchDescriptor desc = descs[i];
-        context.table->pushPatchArray(desc,
-            context.patchInventory.getValue(desc), &voffset, &poffset, &qoffset );
+    FVarChannelCursor fvc(refiner, options);
+    if ((channel < 0) or (channel >= fvc.size()) or
+        (channel >= table.GetNumFVarChannels())) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PatchTableFactory::BuildFVarChannel() -- "
+            "channel %d is not a face-varying channel of the table.", channel);
+        return false;
     }
+    fvc = channel;
 
-    context.table->_numPtexFaces = ptexIndices.GetNumFaces();
+    int npatches = table.GetNumPatchesTotal();
 
-    // Allocate various tables
-    bool hasSharpness = context.options.useSingleCreasePatch;
-    allocateVertexTables(context.table, 0, hasSharpness);
+    PatchTable::FVarPatchChannel & c = table.getFVarPatchChannel(channel);
 
-    if (context.RequiresFVarPatches()) {
+    if (refiner.IsUniform()) {
+        options.triangulateQuads &= (refiner.GetSchemeType()==Sdc::SCHEME_BILINEAR or
+                                     refiner.GetSchemeType()==Sdc::SCHEME_CATMARK);
+
+        //  The faces gathered must be those of the patches of the table:
+        int nfaces = 0;
+        for (int level = options.generateAllLevels ? 1 : refiner.GetMaxLevel();
+                level <= refiner.GetMaxLevel(); ++level) {
+            TopologyLevel const & refLevel = refiner.GetLevel(level);
+            for (int face = 0; face < refLevel.GetNumFaces(); ++face) {
+                nfaces += not (refiner.HasHoles() and refLevel.IsFaceHole(face));
+            }
+        }
+        if (nfaces * (options.triangulateQuads ? 2 : 1) != npatches) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::BuildFVarChannel() -- "
+                "patches differ from those of the table.");
+            return false;
+        }
 
-        int npatches = context.table->GetNumPatchesTotal();
+        PatchDescriptor::Type type = options.triangulateQuads ?
+            PatchDescriptor::TRIANGLES : PatchDescriptor::QUADS;
 
-        allocateFVarChannels(refiner, options, npatches, context.table);
+        c.sharesPatchVertices = uniformFVarValuesMatchVertices(refiner, options, *fvc);
+        if (c.sharesPatchVertices) {
+            std::vector<Index>().swap(c.patchValues);
+        } else {
+            c.patchValues.resize(npatches * PatchDescriptor::GetNumFVarControlVertices(type));
+            if (npatches) {
+                gatherUniformFVarValues(refiner, options, *fvc, &c.patchValues[0]);
+            }
+        }
+    } else {
+        //  The faces of adaptive patches are only retained by deferred tables:
+        if ((int)table._fvarPatchFaces.size() != npatches) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::BuildFVarChannel() -- "
+                "face-varying channels of the table were not deferred.");
+            return false;
+        }
+        c.sharesPatchVertices = false;
+        c.patchValues.resize(npatches * 4);
+        c.patchParams.clear();
+        c.patchesType = PatchDescriptor::QUADS;
+        if (npatches) {
+            gatherDeferredFVarValues(refiner, table, *fvc, &c.patchValues[0]);
+        }
+        if (options.generateFVarBicubicPatches) {
+            buildBicubicFVarChannel(refiner, table, *fvc, channel);
+        }
     }
+    c.interpolation = refiner.GetFVarLinearInterpolation(*fvc);
+    return true;
+}
 
+namespace {
     //
-    //  Now populate the patches:
+    //  Linear-speed vertex cache optimization (T. Forsyth) : the vertices of
+    //  the faces are scored by their position in a LRU cache (those of the
+    //  last face emitted excepted) and boosted by the number of faces still
+    //  to emit, and the face of highest score among those of the cached
+    //  vertices is emitted next.
     //
-    populateAdaptivePatches(context, ptexIndices);
+    class VertexCacheOptimizer {
+    public:
+        VertexCacheOptimizer(Index const * verts, int numFaces, int faceSize,
+                             int cacheSize) :
+            _verts(verts), _numFaces(numFaces), _faceSize(faceSize),
+            _cacheSize(cacheSize) { }
 
-    return context.table;
-}
+        void ComputeFaceOrder(std::vector<int> & order);
 
-//
-//  Identify all patches required for faces at all levels -- accumulating the number of patches
-//  for each type, and retaining enough information for the patch for each face to populate it
-//  later with no additional analysis.
-//
-void
-PatchTableFactory::identifyAdaptivePatches(AdaptiveContext & context) {
+    private:
+        float scoreVertex(Index v) const;
+
+        void scoreFace(int face);
+
+        Index const * _verts;
+        int _numFaces,
+            _faceSize,
+            _cacheSize;
+
+        // faces of each vertex not yet emitted (the first 'numActive')
+        std::vector<int> _vertFaceOffsets,
+                         _vertFaces,
+                         _numActive;
+
+        std::vector<int> _cachePosition;
+        std::vector<float> _vertScores,
+                           _faceScores;
+        std::vector<bool> _emitted;
+
+        int _bestFace;
+    };
+
+    float
+    VertexCacheOptimizer::scoreVertex(Index v) const {
+
+        int numActive = _numActive[v];
+        if (numActive == 0) {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        int position = _cachePosition[v];
+        if (position >= 0) {
+            if (position < _faceSize) {
+                score = 0.75f;
+            } else {
+                float scale = 1.0f / (float)(_cacheSize - _faceSize);
+                score = std::pow(1.0f - (float)(position - _faceSize) * scale, 1.5f);
+            }
+        }
+        return score + 2.0f / std::sqrt((float)numActive);
+    }
+
+    void
+    VertexCacheOptimizer::scoreFace(int face) {
+
+        Index const * fverts = _verts + face * _faceSize;
+
+        float score = 0.0f;
+        for (int i = 0; i < _faceSize; ++i) {
+            score += _vertScores[fverts[i]];
+        }
+        _faceScores[face] = score;
+
+        if ((_bestFace < 0) or (score > _faceScores[_bestFace])) {
+            _bestFace = face;
+        }
+    }
+
+    void
+    VertexCacheOptimizer::ComputeFaceOrder(std::vector<int> & order) {
+
+        order.clear();
+        order.reserve(_numFaces);
+
+        int numVerts = 0;
+        for (int i = 0; i < _numFaces * _faceSize; ++i) {
+            numVerts = std::max(numVerts, _verts[i] + 1);
+        }
+
+        _vertFaceOffsets.assign(numVerts + 1, 0);
+        for (int i = 0; i < _numFaces * _faceSize; ++i) {
+            ++_vertFaceOffsets[_verts[i] + 1];
+        }
+        for (int v = 0; v < numVerts; ++v) {
+            _vertFaceOffsets[v + 1] += _vertFaceOffsets[v];
+        }
+        _numActive.assign(numVerts, 0);
+        _vertFaces.resize(_numFaces * _faceSize);
+        for (int i = 0; i < _numFaces * _faceSize; ++i) {
+            Index v = _verts[i];
+            _vertFaces[_vertFaceOffsets[v] + _numActive[v]++] = i / _faceSize;
+        }
+
+        _cachePosition.assign(numVerts, -1);
+        _vertScores.resize(numVerts);
+        for (int v = 0; v < numVerts; ++v) {
+            _vertScores[v] = scoreVertex(v);
+        }
+
+        _bestFace = -1;
+        _faceScores.resize(_numFaces);
+        for (int face = 0; face < _numFaces; ++face) {
+            scoreFace(face);
+        }
+        _emitted.assign(_numFaces, false);
+
+        std::vector<Index> cache, nextCache;
+        cache.reserve(_cacheSize + _faceSize);
+        nextCache.reserve(_cacheSize + _faceSize);
+
+        for (int next = 0; (int)order.size() < _numFaces; ) {
+
+            //  Resume with the best face left when no cached vertex has any:
+            int face = _bestFace;
+            if (face < 0) {
+                while (_emitted[next]) ++next;
+                face = next;
+                for (int i = next + 1; i < _numFaces; ++i) {
+                    if (not _emitted[i] and (_faceScores[i] > _faceScores[face])) {
+                        face = i;
+                    }
+                }
+            }
+            order.push_back(face);
+            _emitted[face] = true;
+
+            //  Retire the face from the active faces of its vertices and move
+            //  them to the front of the cache:
+            Index const * fverts = _verts + face * _faceSize;
+
+            nextCache.clear();
+            for (int i = 0; i < _faceSize; ++i) {
+                Index v = fverts[i];
+
+                int * faces = &_vertFaces[_vertFaceOffsets[v]];
+                int & numActive = _numActive[v];
+                for (int j = 0; j < numActive; ++j) {
+                    if (faces[j] == face) {
+                        std::swap(faces[j], faces[--numActive]);
+                        break;
+                    }
+                }
+                if (std::find(nextCache.begin(), nextCache.end(), v) ==
+                    nextCache.end()) {
+                    nextCache.push_back(v);
+                }
+            }
+            for (int i = 0; i < (int)cache.size(); ++i) {
+                if (std::find(nextCache.begin(), nextCache.end(), cache[i]) ==
+                    nextCache.end()) {
+                    nextCache.push_back(cache[i]);
+                }
+            }
+            cache.swap(nextCache);
+
+            //  Score the vertices of the cache (and those evicted), then the
+            //  faces left around them:
+            for (int i = 0; i < (int)cache.size(); ++i) {
+                _cachePosition[cache[i]] = (i < _cacheSize) ? i : -1;
+                _vertScores[cache[i]] = scoreVertex(cache[i]);
+            }
+
+            _bestFace = -1;
+            for (int i = 0; i < (int)cache.size(); ++i) {
+                Index v = cache[i];
+                int const * faces = &_vertFaces[_vertFaceOffsets[v]];
+                for (int j = 0; j < _numActive[v]; ++j) {
+                    scoreFace(faces[j]);
+                }
+            }
+            if ((int)cache.size() > _cacheSize) {
+                cache.resize(_cacheSize);
+            }
+        }
+    }
+
+    //  Number of misses of a LRU cache of vertices
+    int
+    countVertexCacheMisses(Index const * verts, int numVerts, int cacheSize) {
+
+        std::vector<Index> cache;
+        cache.reserve(cacheSize + 1);
+
+        int misses = 0;
+        for (int i = 0; i < numVerts; ++i) {
+            std::vector<Index>::iterator it =
+                std::find(cache.begin(), cache.end(), verts[i]);
+            if (it == cache.end()) {
+                ++misses;
+            } else {
+                cache.erase(it);
+            }
+            cache.insert(cache.begin(), verts[i]);
+            if ((int)cache.size() > cacheSize) {
+                cache.pop_back();
+            }
+        }
+        return misses;
+    }
+
+    //  Reorder blocks of elements in place : block i is set to block order[i]
+    template <typename T>
+    void
+    permuteBlocks(T * blocks, std::vector<int> const & order, int blockSize) {
+
+        std::vector<T> src(blocks, blocks + order.size() * blockSize);
+        for (int i = 0; i < (int)order.size(); ++i) {
+            std::copy(&src[order[i] * blockSize],
+                      &src[order[i] * blockSize] + blockSize,
+                      blocks + i * blockSize);
+        }
+    }
+
+    //  Locality of a patch : its ptex face, then the Morton code of its origin
+    //  in the face (scaled to the 10 bits of U and V of the finest depth)
+    typedef std::pair<Index, unsigned int> PatchLocality;
+
+    PatchLocality
+    getPatchLocality(PatchParam const & param) {
+
+        int shift = 10 - std::min((int)param.GetDepth(), 10);
+        unsigned int u = (unsigned int)param.GetU() << shift,
+                     v = (unsigned int)param.GetV() << shift,
+                     code = 0;
+        for (int bit = 0; bit < 10; ++bit) {
+            code |= (((u >> bit) & 1) << (2 * bit)) |
+                    (((v >> bit) & 1) << (2 * bit + 1));
+        }
+        return PatchLocality(param.GetFaceId(), code);
+    }
+
+    struct PatchLocalityLess {
+        PatchLocalityLess(std::vector<PatchLocality> const & keys) : _keys(keys) { }
+
+        bool operator()(int a, int b) const { return _keys[a] < _keys[b]; }
+
+        std::vector<PatchLocality> const & _keys;
+    };
+}
+
+bool
+PatchTableFactory::OptimizeVertexCache(PatchTable & table,
+                                       std::vector<Index> * permutation,
+                                       Index vertexOffset, int cacheSize) {
+
+    OPENSUBDIV_PROFILE_ZONE("PatchTableFactory::OptimizeVertexCache");
+
+    for (int array = 0; array < table.GetNumPatchArrays(); ++array) {
+        PatchDescriptor desc = table.GetPatchArrayDescriptor(array);
+        if ((desc.GetType() != PatchDescriptor::QUADS) and
+            (desc.GetType() != PatchDescriptor::TRIANGLES)) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::OptimizeVertexCache() -- "
+                "patches of array %d are not faces of a uniform table.", array);
+            return false;
+        }
+        if (cacheSize <= desc.GetNumControlVertices()) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::OptimizeVertexCache() -- "
+                "cache of %d vertices is too small.", cacheSize);
+            return false;
+        }
+    }
+    int npatches = table.GetNumPatchesTotal();
+    for (int channel = 0; channel < table.GetNumFVarChannels(); ++channel) {
+        PatchTable::FVarPatchChannel const & c = table.getFVarPatchChannel(channel);
+        if (npatches and ((c.patchValues.empty() and not c.sharesPatchVertices) or
+                          not c.patchValuesOffsets.empty())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::OptimizeVertexCache() -- "
+                "face-varying channel %d was deferred.", channel);
+            return false;
+        }
+    }
+
+    std::vector<int> order;
+    std::vector<Index> verts;
+
+    for (int array = 0; array < table.GetNumPatchArrays(); ++array) {
+        PatchTable::PatchArray const & pa = table.getPatchArray(array);
+
+        int nverts = pa.desc.GetNumControlVertices();
+        if (pa.numPatches == 0) continue;
+
+        Index * patchVerts = &table._patchVerts[pa.vertIndex];
+
+        VertexCacheOptimizer(patchVerts, pa.numPatches, nverts, cacheSize)
+            .ComputeFaceOrder(order);
+
+        //  Faces already in a better order (e.g. refined faces, which
+        //  follow their parents) are left in place:
+        verts.resize(pa.numPatches * nverts);
+        for (int i = 0; i < pa.numPatches; ++i) {
+            std::memcpy(&verts[i * nverts], patchVerts + order[i] * nverts,
+                        nverts * sizeof(Index));
+        }
+        if (countVertexCacheMisses(&verts[0], (int)verts.size(), cacheSize) >=
+            countVertexCacheMisses(patchVerts, (int)verts.size(), cacheSize)) {
+            continue;
+        }
+
+        permutePatches(table, array, order);
+    }
+
+    if (permutation) {
+        //  Renumber the vertices in order of first use -- those not used by
+        //  any face follow in their original order:
+        Index nverts = 0;
+        for (int i = 0; i < (int)table._patchVerts.size(); ++i) {
+            nverts = std::max(nverts, table._patchVerts[i] - vertexOffset + 1);
+        }
+        permutation->assign(nverts, Vtr::INDEX_INVALID);
+
+        Index next = 0;
+        for (int i = 0; i < (int)table._patchVerts.size(); ++i) {
+            Index v = table._patchVerts[i] - vertexOffset;
+            if ((v >= 0) and not Vtr::IndexIsValid((*permutation)[v])) {
+                (*permutation)[v] = next++;
+            }
+        }
+        for (Index v = 0; v < nverts; ++v) {
+            if (not Vtr::IndexIsValid((*permutation)[v])) {
+                (*permutation)[v] = next++;
+            }
+        }
+        table.RemapControlVertices(*permutation, vertexOffset);
+    }
+    return true;
+}
+
+bool
+PatchTableFactory::SortPatchesByFace(PatchTable & table) {
+
+    OPENSUBDIV_PROFILE_ZONE("PatchTableFactory::SortPatchesByFace");
+
+    //  Deferred channels of adaptive tables are gathered from the faces of
+    //  their patches, which follow the reordering:
+    int npatches = table.GetNumPatchesTotal();
+    for (int channel = 0; channel < table.GetNumFVarChannels(); ++channel) {
+        PatchTable::FVarPatchChannel const & c = table.getFVarPatchChannel(channel);
+        bool deferred = c.patchValues.empty() and not c.sharesPatchVertices;
+        if (npatches and ((deferred and table._fvarPatchFaces.empty()) or
+                          not c.patchValuesOffsets.empty())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in PatchTableFactory::SortPatchesByFace() -- "
+                "face-varying channel %d was deferred.", channel);
+            return false;
+        }
+    }
+
+    std::vector<PatchLocality> keys;
+    std::vector<int> order;
+
+    for (int array = 0; array < table.GetNumPatchArrays(); ++array) {
+        PatchTable::PatchArray const & pa = table.getPatchArray(array);
+
+        keys.resize(pa.numPatches);
+        order.resize(pa.numPatches);
+        bool sorted = true;
+        for (int i = 0; i < pa.numPatches; ++i) {
+            keys[i] = getPatchLocality(table._paramTable[pa.patchIndex + i]);
+            order[i] = i;
+            sorted = sorted and ((i == 0) or not (keys[i] < keys[i-1]));
+        }
+        if (sorted) continue;
+
+        std::stable_sort(order.begin(), order.end(), PatchLocalityLess(keys));
+
+        permutePatches(table, array, order);
+    }
+    return true;
+}
+
+//
+//  Reorder the patches of an array -- and all per-patch data following them:
+//
+void
+PatchTableFactory::permutePatches(PatchTable & table, int array,
+                                  std::vector<int> const & order) {
+
+    PatchTable::PatchArray const & pa = table.getPatchArray(array);
+    if (pa.numPatches == 0) return;
+
+    assert((int)order.size() == pa.numPatches);
+
+    int ncvs = pa.desc.GetNumControlVertices();
+
+    permuteBlocks(&table._patchVerts[pa.vertIndex], order, ncvs);
+    permuteBlocks(&table._paramTable[pa.patchIndex], order, 1);
+
+    if (not table._sharpnessIndices.empty()) {
+        permuteBlocks(&table._sharpnessIndices[pa.patchIndex], order, 1);
+    }
+    if (not table._fvarPatchFaces.empty()) {
+        permuteBlocks(&table._fvarPatchFaces[pa.patchIndex], order, 1);
+    }
+
+    //  Quad offsets of legacy Gregory patches are indexed as their vertices:
+    if (((pa.desc.GetType() == PatchDescriptor::GREGORY) or
+         (pa.desc.GetType() == PatchDescriptor::GREGORY_BOUNDARY)) and
+        not table._quadOffsetsTable.empty()) {
+        permuteBlocks(&table._quadOffsetsTable[pa.quadOffsetIndex], order, ncvs);
+    }
+
+    for (int channel = 0; channel < table.GetNumFVarChannels(); ++channel) {
+        PatchTable::FVarPatchChannel & c = table.getFVarPatchChannel(channel);
+
+        if (not c.patchValues.empty()) {
+            int nvalues = PatchDescriptor::GetNumFVarControlVertices(c.patchesType);
+            permuteBlocks(&c.patchValues[pa.patchIndex * nvalues], order, nvalues);
+        }
+        if (not c.patchParams.empty()) {
+            permuteBlocks(&c.patchParams[pa.patchIndex], order, 1);
+        }
+    }
+}
+
+//
+//  Convert the bilinear patches of an adaptive channel into B-spline patches
+//  where the face-varying topology around their points matches the vertex
+//  topology -- the values of the patch points are then those of its vertices.
+//  Other patches remain bilinear, with their corner values first:
+//
+void
+PatchTableFactory::buildBicubicFVarChannel(TopologyRefiner const & refiner,
+    PatchTable & table, int refinerChannel, int channel) {
+
+    //  Linear channels are bilinear everywhere:
+    if (refiner.GetFVarLinearInterpolation(refinerChannel) ==
+        Sdc::Options::FVAR_LINEAR_ALL) {
+        return;
+    }
+
+    PatchTable::FVarPatchChannel & c = table.getFVarPatchChannel(channel);
+    assert(c.patchesType == PatchDescriptor::QUADS);
+
+    int nlevels = refiner.GetNumLevels();
+
+    //  Offsets of the vertices and face-varying values of each level:
+    std::vector<Index> levelVertOffsets(nlevels + 1, 0),
+                       levelFVarValueOffsets(nlevels + 1, 0);
+    for (int i = 0; i < nlevels; ++i) {
+        Vtr::internal::Level const & level = refiner.getLevel(i);
+
+        levelVertOffsets[i+1] = levelVertOffsets[i] + level.getNumVertices();
+        levelFVarValueOffsets[i+1] = levelFVarValueOffsets[i] +
+            level.getNumFVarValues(refinerChannel);
+    }
+
+    int ncvs = PatchDescriptor::GetRegularPatchSize(),
+        npatches = table.GetNumPatchesTotal();
+
+    std::vector<Index> values(npatches * ncvs);
+    c.patchParams = table._paramTable;
+
+    for (int array = 0, patch = 0; array < table.GetNumPatchArrays(); ++array) {
+
+        //  Only regular patches of smooth vertices (not single-crease nor
+        //  end-cap patches) are candidates:
+        bool regularArray =
+            (table.GetPatchArrayDescriptor(array).GetType() == PatchDescriptor::REGULAR);
+
+        for (int i = 0; i < table.GetNumPatches(array); ++i, ++patch) {
+
+            Index * patchValues = &values[patch * ncvs];
+
+            bool bicubic = regularArray and (table._sharpnessIndices.empty() or
+                (table.GetSingleCreasePatchSharpnessValue(array, i) == 0.0f));
+            if (bicubic) {
+                ConstIndexArray cvs = table.GetPatchVertices(array, i);
+
+                int levelIndex = (int)(std::upper_bound(levelVertOffsets.begin(),
+                    levelVertOffsets.end(), cvs[0]) - levelVertOffsets.begin()) - 1;
+                bicubic = (levelIndex < nlevels);
+
+                for (int k = 0; bicubic and (k < ncvs); ++k) {
+                    Vtr::internal::Level const & level = refiner.getLevel(levelIndex);
+                    Vtr::internal::FVarLevel const & fvarLevel =
+                        level.getFVarLevel(refinerChannel);
+
+                    Index vert = cvs[k] - levelVertOffsets[levelIndex];
+                    bicubic = (vert >= 0) and (vert < level.getNumVertices()) and
+                        fvarLevel.valueTopologyMatches(fvarLevel.getVertexValueOffset(vert));
+                    if (bicubic) {
+                        patchValues[k] = levelFVarValueOffsets[levelIndex] +
+                            fvarLevel.getVertexValue(vert);
+                    }
+                }
+            }
+            if (bicubic) {
+                c.patchParams[patch].field1 |= (1 << 5);  // see PatchParam::IsRegular()
+            } else {
+                Index const * corners = &c.patchValues[patch * 4];
+                for (int k = 0; k < ncvs; ++k) {
+                    patchValues[k] = corners[k < 4 ? k : 0];
+                }
+            }
+        }
+    }
+    c.patchesType = PatchDescriptor::REGULAR;
+    c.patchValues.swap(values);
+}
+
+//
+//  Gather the face-varying values of the faces of each level of a uniform table
+//  (in the order of its patches) for a channel of the refiner:
+//
+//
+//  The values of a channel aliasing the vertex topology are those of the vertices at
+//  every level, and so the uniform patches gathered for them are the patch vertices --
+//  as long as the offsets of the levels gathered match, i.e. all levels of both are
+//  included or the patches are of the first level.  The triangles of Loop are not
+//  shared as they are gathered in channels of quads:
+//
+bool
+PatchTableFactory::uniformFVarValuesMatchVertices(TopologyRefiner const & refiner,
+    Options const & options, int refinerChannel) {
+
+    assert(refiner.IsUniform());
+
+    return refiner.getLevel(0).getFVarLevel(refinerChannel).isVertexTopologyAlias() and
+           (refiner.GetSchemeType() != Sdc::SCHEME_LOOP) and
+           (options.generateAllLevels or (refiner.GetMaxLevel() == 1));
+}
+
+void
+PatchTableFactory::gatherUniformFVarValues(TopologyRefiner const & refiner,
+    Options const & options, int refinerChannel, Index * values) {
+
+    int maxlevel = refiner.GetMaxLevel(),
+        firstlevel = options.generateAllLevels ? 1 : maxlevel;
+
+    Index levelFVarValueOffset = 0;
+    for (int level=0; level<firstlevel; ++level) {
+        levelFVarValueOffset += refiner.GetLevel(level).GetNumFVarValues(refinerChannel);
+    }
+
+    Index * fptr = values;
+
+    for (int level=firstlevel; level<=maxlevel; ++level) {
+
+        TopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        int nfaces = refLevel.GetNumFaces();
+        for (int face=0; face<nfaces; ++face) {
+
+            if (refiner.HasHoles() and refLevel.IsFaceHole(face)) {
+                continue;
+            }
+
+            ConstIndexArray fvalues = refLevel.GetFaceFVarValues(face, refinerChannel);
+            for (int vert=0; vert<fvalues.size(); ++vert) {
+                fptr[vert] = levelFVarValueOffset + fvalues[vert];
+            }
+            fptr += fvalues.size();
+
+            if (options.triangulateQuads) {
+                *fptr = *(fptr-4); // copy fv0 index
+                ++fptr;
+                *fptr = *(fptr-3); // copy fv2 index
+                ++fptr;
+            }
+        }
+        levelFVarValueOffset += refLevel.GetNumFVarValues(refinerChannel);
+    }
+}
+
+//
+//  Gather the face-varying values of the faces retained for each patch of a
+//  deferred adaptive table for a channel of the refiner:
+//
+void
+PatchTableFactory::gatherDeferredFVarValues(TopologyRefiner const & refiner,
+    PatchTable const & table, int refinerChannel, Index * values) {
+
+    int nlevels = refiner.GetNumLevels();
+
+    //  Offsets of the faces and face-varying values of each level:
+    std::vector<Index> levelFaceOffsets(nlevels + 1, 0),
+                       levelFVarValueOffsets(nlevels, 0);
+    for (int i = 0; i < nlevels; ++i) {
+        Vtr::internal::Level const & level = refiner.getLevel(i);
+
+        levelFaceOffsets[i+1] = levelFaceOffsets[i] + level.getNumFaces();
+        if (i > 0) {
+            levelFVarValueOffsets[i] = levelFVarValueOffsets[i-1] +
+                refiner.getLevel(i-1).getNumFVarValues(refinerChannel);
+        }
+    }
+
+    int npatches = (int)table._fvarPatchFaces.size();
+    for (int patch = 0, levelIndex = 0; patch < npatches; ++patch) {
+
+        Index face = table._fvarPatchFaces[patch];
+
+        //  Patches are mostly sorted by level within each array:
+        if ((face < levelFaceOffsets[levelIndex]) or (face >= levelFaceOffsets[levelIndex+1])) {
+            levelIndex = (int)(std::upper_bound(levelFaceOffsets.begin(),
+                levelFaceOffsets.end(), face) - levelFaceOffsets.begin()) - 1;
+        }
+        assert(levelIndex < nlevels);
+
+        ConstIndexArray fvarValues = refiner.getLevel(levelIndex).getFVarLevel(refinerChannel).
+            getFaceValues(face - levelFaceOffsets[levelIndex]);
+        assert(fvarValues.size() == 4);
+
+        Index * fptr = values + patch * 4;
+        for (int vert = 0; vert < 4; ++vert) {
+            fptr[vert] = levelFVarValueOffsets[levelIndex] + fvarValues[vert];
+        }
+    }
+}
+
+PatchTable *
+PatchTableFactory::createUniform(TopologyRefiner const & refiner, Options options) {
+
+    assert(refiner.IsUniform());
+
+    // ensure that triangulateQuads is only set for quadrilateral schemes
+    options.triangulateQuads &= (refiner.GetSchemeType()==Sdc::SCHEME_BILINEAR or
+                                 refiner.GetSchemeType()==Sdc::SCHEME_CATMARK);
+
+    // level=0 may contain n-gons, which are not supported in PatchTable.
+    // even if generateAllLevels = true, we start from level 1.
+
+    int maxvalence = refiner.GetMaxValence(),
+        maxlevel = refiner.GetMaxLevel(),
+        firstlevel = options.generateAllLevels ? 1 : maxlevel,
+        nlevels = maxlevel-firstlevel+1;
+
+    PtexIndices ptexIndices(refiner);
+
+    PatchDescriptor::Type ptype = PatchDescriptor::NON_PATCH;
+    if (options.triangulateQuads) {
+        ptype = PatchDescriptor::TRIANGLES;
+    } else {
+        switch (refiner.GetSchemeType()) {
+            case Sdc::SCHEME_BILINEAR :
+            case Sdc::SCHEME_CATMARK  : ptype = PatchDescriptor::QUADS; break;
+            case Sdc::SCHEME_LOOP     : ptype = PatchDescriptor::TRIANGLES; break;
+        }
+    }
+    assert(ptype!=PatchDescriptor::NON_PATCH);
+
+    //
+    //  Create the instance of the table and allocate and initialize its members.
+    //
+    PatchTable * table = new PatchTable(maxvalence);
+
+    table->_numPtexFaces = ptexIndices.GetNumFaces();
+
+    table->reservePatchArrays(nlevels);
+
+    PatchDescriptor desc(ptype);
+
+    // generate patch arrays
+    for (int level=firstlevel, poffset=0, voffset=0; level<=maxlevel; ++level) {
+
+        TopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        int npatches = refLevel.GetNumFaces();
+        if (refiner.HasHoles()) {
+            for (int i = npatches - 1; i >= 0; --i) {
+                npatches -= refLevel.IsFaceHole(i);
+            }
+        }
+        assert(npatches>=0);
+
+        if (options.triangulateQuads)
+            npatches *= 2;
+
+        table->pushPatchArray(desc, npatches, &voffset, &poffset, 0);
+    }
+
+    // Allocate various tables
+    allocateVertexTables( table, 0, /*hasSharpness=*/false );
+
+    FVarChannelCursor fvc(refiner, options);
+    bool generateFVarPatches = (options.generateFVarTables and fvc.size()>0);
+    if (generateFVarPatches) {
+        int npatches = table->GetNumPatchesTotal();
+        allocateFVarChannels(refiner, options, npatches, table);
+        assert(fvc.size() == table->GetNumFVarChannels());
+    }
+
+    //
+    //  Now populate the patches:
+    //
+
+    Index          * iptr = &table->_patchVerts[0];
+    PatchParam     * pptr = &table->_paramTable[0];
+
+    // we always skip level=0 vertices (control cages)
+    Index levelVertOffset = refiner.GetLevel(0).GetNumVertices();
+
+    for (int level=1; level<=maxlevel; ++level) {
+
+        TopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        int nfaces = refLevel.GetNumFaces();
+        if (level>=firstlevel) {
+            for (int face=0; face<nfaces; ++face) {
+
+                if (refiner.HasHoles() and refLevel.IsFaceHole(face)) {
+                    continue;
+                }
+
+                ConstIndexArray fverts = refLevel.GetFaceVertices(face);
+                for (int vert=0; vert<fverts.size(); ++vert) {
+                    *iptr++ = levelVertOffset + fverts[vert];
+                }
+
+                pptr = computePatchParam(refiner, ptexIndices, level, face, /*boundary*/0, /*transition*/0, pptr);
+
+                if (options.triangulateQuads) {
+                    // Triangulate the quadrilateral: {v0,v1,v2,v3} -> {v0,v1,v2},{v3,v0,v2}.
+                    *iptr = *(iptr - 4); // copy v0 index
+                    ++iptr;
+                    *iptr = *(iptr - 3); // copy v2 index
+                    ++iptr;
+
+                    *pptr = *(pptr - 1); // copy first patch param
+                    ++pptr;
+                }
+            }
+        }
+
+        if (options.generateAllLevels) {
+            levelVertOffset += refiner.GetLevel(level).GetNumVertices();
+        }
+    }
+
+    //
+    //  Gather the face-varying values of each channel (unless deferred):
+    //
+    if (generateFVarPatches and not options.deferFVarChannels) {
+        for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
+            if (not table->getFVarPatchChannel(fvc.pos()).sharesPatchVertices) {
+                gatherUniformFVarValues(refiner, options, *fvc, table->getFVarValues(fvc.pos()).begin());
+            }
+        }
+    }
+    return table;
+}
+
+PatchTable *
+PatchTableFactory::createAdaptive(TopologyRefiner const & refiner, Options options,
+                                  int isolationLevel) {
+
+    //  (unrefined refiners are uniform, and approximated at their base level)
+    assert((isolationLevel == 0) or not refiner.IsUniform());
+
+    //  The Gregory basis of a legacy Gregory patch is that computed in the
+    //  shaders from its valence table -- build it once with the local points:
+    if (options.convertLegacyGregory and
+            options.GetEndCapType() == Options::ENDCAP_LEGACY_GREGORY) {
+        options.SetEndCapType(Options::ENDCAP_GREGORY_BASIS);
+    }
+
+    PtexIndices ptexIndices(refiner);
+
+    AdaptiveContext context(refiner, options, isolationLevel);
+
+    //
+    //  First identify the patches -- accumulating the inventory patches for all of the
+    //  different types and information about the patch for each face:
+    //
+    identifyAdaptivePatches(context);
+
+    if (context.monitor and context.monitor->IsCancelled()) {
+        return 0;
+    }
+
+    //
+    //  Create the instance of the table and allocate and initialize its members based on
+    //  the inventory of patches determined above:
+    //
+    int maxValence = refiner.GetMaxValence();
+
+    context.table = new PatchTable(maxValence);
+
+    // Populate the patch array descriptors
+    int numPatchArrays = 0;
+    if (context.patchInventory.R > 0) ++numPatchArrays;
+    if (context.patchInventory.G > 0) ++numPatchArrays;
+    if (context.patchInventory.GB > 0) ++numPatchArrays;
+    if (context.patchInventory.GP > 0) ++numPatchArrays;
+
+    context.table->reservePatchArrays(numPatchArrays);
+
+    // Sort through the inventory and push back non-empty patch arrays
+    ConstPatchDescriptorArray const & descs =
+        PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_CATMARK);
+
+    int voffset=0, poffset=0, qoffset=0;
+    for (int i=0; i<descs.size(); ++i) {
+        PatchDescriptor desc = descs[i];
+        context.table->pushPatchArray(desc,
+            context.patchInventory.getValue(desc), &voffset, &poffset, &qoffset );
+    }
+
+    context.table->_numPtexFaces = ptexIndices.GetNumFaces();
+
+    // Allocate various tables
+    bool hasSharpness = context.options.useSingleCreasePatch;
+    allocateVertexTables(context.table, 0, hasSharpness);
+
+    if (context.RequiresFVarPatches() or context.DefersFVarPatches()) {
+
+        int npatches = context.table->GetNumPatchesTotal();
+
+        allocateFVarChannels(refiner, options, npatches, context.table);
+
+        if (context.DefersFVarPatches()) {
+            context.table->_fvarPatchFaces.resize(npatches);
+        }
+    }
+
+    //
+    //  Now populate the patches:
+    //
+    populateAdaptivePatches(context, ptexIndices);
+
+    if (context.monitor and context.monitor->IsCancelled()) {
+        delete context.table;
+        return 0;
+    }
+
+    if (context.RequiresFVarPatches() and options.generateFVarBicubicPatches) {
+        FVarChannelCursor fvc = context.fvarChannelCursor;
+        for (fvc=fvc.begin(); fvc!=fvc.end(); ++fvc) {
+            buildBicubicFVarChannel(refiner, *context.table, *fvc, fvc.pos());
+        }
+    }
+
+    return context.table;
+}
+
+//
+//  Feature adaptive patches of the Loop scheme : regular triangles are box-spline (LOOP) patches
+//  and the irregular triangles where isolation stopped are linear (TRIANGLES) end caps -- there is
+//  no Gregory patch for triangles (yet), whatever the end cap type, other than ENDCAP_NONE.  The
+//  patches are few and simple enough to be identified and populated in two serial passes, and no
+//  face-varying patches are generated:
+//
+PatchTable *
+PatchTableFactory::createLoopAdaptive(TopologyRefiner const & refiner, Options options) {
+
+    assert(not refiner.IsUniform() and refiner.GetSchemeType()==Sdc::SCHEME_LOOP);
+
+    PtexIndices ptexIndices(refiner);
+
+    bool hasEndCaps = (options.GetEndCapType() != Options::ENDCAP_NONE);
+
+    //
+    //  Identify the patch of each face from its tags (the boundary mask of each LOOP patch, or
+    //  -1 for an end cap) -- faces without patch are holes, refined or incomplete faces:
+    //
+    int const NO_PATCH = -2,
+              END_CAP  = -1;
+
+    std::vector<signed char> facePatches(refiner.GetNumFacesTotal(), (signed char)NO_PATCH);
+
+    int numLoopPatches = 0,
+        numEndCaps = 0;
+
+    for (int levelIndex = 0, levelFaceOffset = 0; levelIndex < refiner.GetNumLevels(); ++levelIndex) {
+        Vtr::internal::Level const & level = refiner.getLevel(levelIndex);
+
+        Vtr::internal::Refinement::SparseTag const * refinedFaceTags =
+            (levelIndex < refiner.GetMaxLevel()) ?
+                &refiner.getRefinement(levelIndex).getParentFaceSparseTag(0) : 0;
+
+        for (int faceIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
+
+            if (level.isFaceHole(faceIndex)) {
+                continue;
+            }
+            if (refinedFaceTags and refinedFaceTags[faceIndex]._selected) {
+                continue;
+            }
+            if (refiner.IsSparse() and (levelIndex < refiner.GetMaxLevel())) {
+                continue;
+            }
+            //  Unlike quads, the child triangles of a face refined only to support its
+            //  neighbors may all have complete vertices -- so inspect the face itself:
+            if ((levelIndex > 0) and
+                refiner.getRefinement(levelIndex-1).getChildFaceTag(faceIndex)._incomplete) {
+                continue;
+            }
+
+            Vtr::ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
+            if ((fVerts.size() != 3) or level.getFaceCompositeVTag(fVerts)._incomplete) {
+                continue;
+            }
+
+            int boundaryMask = 0;
+            if (level.isTriRegularPatch(faceIndex, &boundaryMask)) {
+                facePatches[levelFaceOffset + faceIndex] = (signed char)boundaryMask;
+                ++numLoopPatches;
+            } else if (hasEndCaps) {
+                facePatches[levelFaceOffset + faceIndex] = (signed char)END_CAP;
+                ++numEndCaps;
+            }
+        }
+        levelFaceOffset += level.getNumFaces();
+    }
+
+    //
+    //  Create the instance of the table and allocate its members:
+    //
+    PatchTable * table = new PatchTable(refiner.GetMaxValence());
+
+    table->_numPtexFaces = ptexIndices.GetNumFaces();
+
+    table->reservePatchArrays((numLoopPatches > 0) + (numEndCaps > 0));
+
+    int voffset = 0, poffset = 0;
+    table->pushPatchArray(PatchDescriptor(PatchDescriptor::LOOP),
+                          numLoopPatches, &voffset, &poffset, 0);
+    table->pushPatchArray(PatchDescriptor(PatchDescriptor::TRIANGLES),
+                          numEndCaps, &voffset, &poffset, 0);
+
+    allocateVertexTables(table, 0, /*hasSharpness=*/false);
+
+    //
+    //  Populate the patches -- the points of regular patches are gathered in the orientation
+    //  of the face with the boundary, and permuted to those of the box-spline basis (see
+    //  Far::internal::GetLoopWeights()), with points beyond the boundary set to the first
+    //  vertex of the face:
+    //
+    Index      * iptrs[2] = { 0, 0 };
+    PatchParam * pptrs[2] = { 0, 0 };
+    for (int i = 0; i < table->GetNumPatchArrays(); ++i) {
+        int type = (table->GetPatchArrayDescriptor(i).GetType() == PatchDescriptor::LOOP) ? 0 : 1;
+        iptrs[type] = table->getPatchArrayVertices(i).begin();
+        pptrs[type] = table->getPatchParams(i).begin();
+    }
+
+    static int const permuteInterior[12] =
+        {  3,  4,  5, 11,  0,  1,  6, 10,  2,  7,  9,  8 };
+    static int const permuteBoundaryEdge[3][12] = {
+        { -1, -1, -1,  8,  0,  1,  3,  7,  2,  4,  6,  5 },
+        {  6,  7,  8,  5,  2,  0, -1,  4,  1, -1,  3, -1 },
+        {  3,  4,  5, -1,  1,  2,  6, -1,  0,  7, -1,  8 } };
+    static int const permuteBoundaryVertex[3][12] = {
+        { -1,  3,  4, -1,  0,  1,  5,  9,  2,  6,  8,  7 },
+        {  8,  9, -1,  7,  2,  0, -1,  6,  1,  3,  5,  4 },
+        {  5,  6,  7,  4,  1,  2,  8,  3,  0,  9, -1, -1 } };
+
+    for (int levelIndex = 0, levelFaceOffset = 0, levelVertOffset = 0;
+            levelIndex < refiner.GetNumLevels(); ++levelIndex) {
+        Vtr::internal::Level const & level = refiner.getLevel(levelIndex);
+
+        Vtr::internal::Refinement::SparseTag const * refinedFaceTags =
+            (levelIndex < refiner.GetMaxLevel()) ?
+                &refiner.getRefinement(levelIndex).getParentFaceSparseTag(0) : 0;
+
+        for (int faceIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
+
+            int facePatch = facePatches[levelFaceOffset + faceIndex];
+            if (facePatch == NO_PATCH) {
+                continue;
+            }
+
+            int transitionMask = refinedFaceTags ? refinedFaceTags[faceIndex]._transitional : 0;
+
+            if (facePatch == END_CAP) {
+                Vtr::ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
+                offsetAndPermuteIndices(&fVerts[0], 3, levelVertOffset, 0, iptrs[1]);
+
+                iptrs[1] += 3;
+                pptrs[1] = computePatchParam(refiner, ptexIndices, levelIndex, faceIndex,
+                                             /*boundary*/0, transitionMask, pptrs[1]);
+                continue;
+            }
+
+            int boundaryMask = facePatch;
+
+            Index patchVerts[12];
+            int const * permutation = 0;
+            if (boundaryMask == 0) {
+                level.gatherTriRegularInteriorPatchPoints(faceIndex, patchVerts);
+                permutation = permuteInterior;
+            } else if (boundaryMask & 8) {
+                int bIndex = (boundaryMask & 1) ? 0 : ((boundaryMask & 2) ? 1 : 2);
+                level.gatherTriRegularBoundaryVertexPatchPoints(faceIndex, patchVerts, bIndex);
+                permutation = permuteBoundaryVertex[bIndex];
+            } else {
+                int bIndex = (boundaryMask & 1) ? 0 : ((boundaryMask & 2) ? 1 : 2);
+                level.gatherTriRegularBoundaryEdgePatchPoints(faceIndex, patchVerts, bIndex);
+                permutation = permuteBoundaryEdge[bIndex];
+            }
+            offsetAndPermuteIndices(patchVerts, 12, levelVertOffset, permutation, iptrs[0]);
+
+            iptrs[0] += 12;
+            pptrs[0] = computePatchParam(refiner, ptexIndices, levelIndex, faceIndex,
+                                         boundaryMask, transitionMask, pptrs[0]);
+        }
+        levelFaceOffset += level.getNumFaces();
+        levelVertOffset += level.getNumVertices();
+    }
+    return table;
+}
+
+//
+//  Identify all patches required for faces at all levels -- accumulating the number of patches
+//  for each type, and retaining enough information for the patch for each face to populate it
+//  later with no additional analysis.
+//
+void
+PatchTableFactory::identifyAdaptivePatches(AdaptiveContext & context) {
+
+    TopologyRefiner const & refiner = context.refiner;
+
+    //
+    //  Iterate through the levels of refinement to inspect and tag components with information
+    //  relative to patch generation.  We allocate all of the tags locally and use them to
+    //  populate the patches once a complete inventory has been taken and all tables appropriately
+    //  allocated and initialized:
+    //
+    //  The first Level may have no Refinement if it is the only level -- similarly the last Level
+    //  has no Refinement, so a single level is effectively the last, but with less information
+    //  available in some cases, as it was not generated by refinement.
+    //
+    context.patchTags.resize(refiner.GetNumFacesTotal());
+
+    //
+    //  Divide the faces of each level into ranges -- a single range per level unless
+    //  a scheduler is available to process several concurrently (or a monitor to
+    //  cancel the build between them):
+    //
+    context.faceRanges.clear();
+
+    Index levelFaceOffset = 0,
+          levelVertOffset = 0;
+
+    for (int levelIndex = 0; levelIndex < refiner.GetNumLevels(); ++levelIndex) {
+        Vtr::internal::Level const & level = refiner.getLevel(levelIndex);
+
+        int numFaces = level.getNumFaces();
+        int rangeSize = context.taskScheduler ?
+            getRangeSize(numFaces, *context.taskScheduler) :
+                (context.monitor ? monitoredRangeSize : std::max(numFaces, 1));
+
+        for (Index faceBegin = 0; faceBegin < std::max(numFaces, 1); faceBegin += rangeSize) {
+            PatchFaceRange range;
+            range.level           = levelIndex;
+            range.levelFaceOffset = levelFaceOffset;
+            range.levelVertOffset = levelVertOffset;
+            range.faceBegin       = faceBegin;
+            range.faceEnd         = std::min(faceBegin + rangeSize, numFaces);
+            range.patchIndex      = 0;
+
+            context.faceRanges.push_back(range);
+        }
+        levelFaceOffset += numFaces;
+        levelVertOffset += level.getNumVertices();
+    }
+
+    int numRanges = (int)context.faceRanges.size();
+    if (context.monitor) {
+        context.monitor->beginStage(0.0f, 0.5f, numRanges);
+    }
+    if (context.taskScheduler and numRanges > 1) {
+        context.taskScheduler->ParallelFor(0, numRanges, 1, identifyPatchFaceRanges, &context);
+    } else {
+        identifyPatchFaceRanges(0, numRanges, &context);
+    }
+
+    //
+    //  Accumulate the inventory of patches from all ranges:
+    //
+    for (int i = 0; i < numRanges; ++i) {
+        PatchTypes<int> const & patchCounts = context.faceRanges[i].patchCounts;
+
+        context.patchInventory.R  += patchCounts.R;
+        context.patchInventory.G  += patchCounts.G;
+        context.patchInventory.GB += patchCounts.GB;
+        context.patchInventory.GP += patchCounts.GP;
+    }
+}
+
+void
+PatchTableFactory::identifyPatchFaceRanges(int begin, int end, void * state) {
+
+    AdaptiveContext & context = *static_cast<AdaptiveContext *>(state);
+
+    for (int i = begin; i < end; ++i) {
+        // (the ranges of a cancelled build are left empty)
+        if (context.monitor and context.monitor->IsCancelled()) continue;
+
+        identifyPatchFaceRange(context, context.faceRanges[i]);
+
+        if (context.monitor) context.monitor->advance(1);
+    }
+}
+
+//
+//  Identify the patches for a range of faces within a level -- tagging each face and
+//  counting the patches of each type for the range:
+//
+void
+PatchTableFactory::identifyPatchFaceRange(AdaptiveContext & context, PatchFaceRange & range) {
 
     TopologyRefiner const & refiner = context.refiner;
 
+    int levelIndex = range.level;
+
+    Vtr::internal::Level const * level = &refiner.getLevel(levelIndex);
+
+    PatchFaceTag * levelPatchTags = &context.patchTags[range.levelFaceOffset];
+
     //
-    //  Iterate through the levels of refinement to inspect and tag components with information
-    //  relative to patch generation.  We allocate all of the tags locally and use them to
-    //  populate the patches once a complete inventory has been taken and all tables appropriately
-    //  allocated and initialized:
+    //  Given components at Level[i], we need to be looking at Refinement[i] -- and not
+    //  [i-1] -- because the Refinement has transitional information for its parent edges
+    //  and faces.
     //
-    //  The first Level may have no Refinement if it is the only level -- similarly the last Level
-    //  has no Refinement, so a single level is effectively the last, but with less information
-    //  available in some cases, as it was not generated by refinement.
+    //  For components in this level, we want to determine:
+    //    - what Edges are "transitional" (already done in Refinement for parent)
+    //    - what Faces are "transitional" (already done in Refinement for parent)
+    //    - what Faces are "complete" (applied to this Level in previous refinement)
     //
-    context.patchTags.resize(refiner.GetNumFacesTotal());
+    Vtr::internal::Refinement const            * refinement = 0;
+    Vtr::internal::Refinement::SparseTag const * refinedFaceTags = 0;
+
+    //  Faces of the level patches are isolated to are leaves, whether refined further
+    //  or not, and the faces of the levels beyond have no patch:
+    if (levelIndex < context.maxLevel) {
+        refinement      = &refiner.getRefinement(levelIndex);
+        refinedFaceTags = &refinement->getParentFaceSparseTag(0);
+    }
 
-    PatchFaceTag * levelPatchTags = &context.patchTags[0];
+    for (int faceIndex = range.faceBegin; faceIndex < range.faceEnd; ++faceIndex) {
 
-    for (int levelIndex = 0; levelIndex < refiner.GetNumLevels(); ++levelIndex) {
-        Vtr::internal::Level const * level = &refiner.getLevel(levelIndex);
+        PatchFaceTag & patchTag = levelPatchTags[faceIndex];
+        patchTag.clear();
+        patchTag._hasPatch = false;
+
+        if (level->isFaceHole(faceIndex) or (levelIndex > context.maxLevel)) {
+            continue;
+        }
 
         //
-        //  Given components at Level[i], we need to be looking at Refinement[i] -- and not
-        //  [i-1] -- because the Refinement has transitional information for its parent edges
-        //  and faces.
+        //  This face does not warrant a patch under the following conditions:
+        //
+        //      - the face was fully refined into child faces
+        //      - the face is not a quad (should have been refined, so assert)
+        //      - the face is not "complete"
         //
-        //  For components in this level, we want to determine:
-        //    - what Edges are "transitional" (already done in Refinement for parent)
-        //    - what Faces are "transitional" (already done in Refinement for parent)
-        //    - what Faces are "complete" (applied to this Level in previous refinement)
+        //  The first is trivially determined, and the second is really redundant.  The
+        //  last -- "incompleteness" -- indicates a face that exists to support the limit
+        //  of some neighboring component, and which does not have its own neighborhood
+        //  fully defined for its limit.  If any child vertex of a vertex of this face is
+        //  "incomplete" (and all are tagged) the face must be "incomplete", so get the
+        //  "composite" tag which combines bits for all vertices:
         //
-        Vtr::internal::Refinement const            * refinement = 0;
-        Vtr::internal::Refinement::SparseTag const * refinedFaceTags = 0;
+        Vtr::internal::Refinement::SparseTag refinedFaceTag = refinedFaceTags ?
+            refinedFaceTags[faceIndex] : Vtr::internal::Refinement::SparseTag();
 
-        if (levelIndex < refiner.GetMaxLevel()) {
-            refinement      = &refiner.getRefinement(levelIndex);
-            refinedFaceTags = &refinement->getParentFaceSparseTag(0);
+        if (refinedFaceTag._selected) {
+            continue;
         }
 
-        for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
+        //  Sparse refinement of a face selection only covers the descendants of the
+        //  selected faces -- all of which are refined to the last level.  The children
+        //  of the neighboring faces supporting them may be complete, so the parent of
+        //  the face must have been selected:
+        if (refiner.IsSparse() && (levelIndex < refiner.GetMaxLevel())) {
+            continue;
+        }
+        if (refiner.IsSparse() && (levelIndex > 0) &&
+            refiner.getRefinement(levelIndex-1).getChildFaceTag(faceIndex)._incomplete) {
+            continue;
+        }
 
-            PatchFaceTag & patchTag = levelPatchTags[faceIndex];
-            patchTag.clear();
-            patchTag._hasPatch = false;
+        //  Base faces of unrefined meshes approximated without isolation (see
+        //  CreateApproximate()) are limited to the neighborhoods patches can gather:
+        if (refiner.IsUniform() and not isApproximableFace(*level, faceIndex)) {
+            continue;
+        }
 
-            if (level->isFaceHole(faceIndex)) {
-                continue;
-            }
+        Vtr::ConstIndexArray fVerts = level->getFaceVertices(faceIndex);
+        assert(fVerts.size() == 4);
 
-            //
-            //  This face does not warrant a patch under the following conditions:
-            //
-            //      - the face was fully refined into child faces
-            //      - the face is not a quad (should have been refined, so assert)
-            //      - the face is not "complete"
-            //
-            //  The first is trivially determined, and the second is really redundant.  The
-            //  last -- "incompleteness" -- indicates a face that exists to support the limit
-            //  of some neighboring component, and which does not have its own neighborhood
-            //  fully defined for its limit.  If any child vertex of a vertex of this face is
-            //  "incomplete" (and all are tagged) the face must be "incomplete", so get the
-            //  "composite" tag which combines bits for all vertices:
-            //
-            Vtr::internal::Refinement::SparseTag refinedFaceTag = refinedFaceTags ?
-                refinedFaceTags[faceIndex] : Vtr::internal::Refinement::SparseTag();
-
-            if (refinedFaceTag._selected) {
-                continue;
-            }
+        Vtr::internal::Level::VTag compFaceVertTag = level->getFaceCompositeVTag(fVerts);
+        if (compFaceVertTag._incomplete) {
+            continue;
+        }
 
-            Vtr::ConstIndexArray fVerts = level->getFaceVertices(faceIndex);
-            assert(fVerts.size() == 4);
+        //
+        //  We have a quad that will be represented as a B-spline or end cap patch.  Use
+        //  the "composite" tag again to quickly determine if any vertex is irregular, on
+        //  a boundary, non-manifold, etc.
+        //
+        //  Inspect the edges for boundaries and transitional edges and pack results into
+        //  4-bit masks.  We detect boundary edges rather than vertices as we hope to
+        //  replace the mask in future with one for infinitely sharp edges -- allowing
+        //  us to detect regular patches and avoid isolation.  We still need to account
+        //  for the irregular/xordinary case when a corner vertex is a boundary but there
+        //  are no boundary edges.
+        //
+        //  As for transition detection, assign the transition properties (even if 0).
+        //
+        //  NOTE on patches around non-manifold vertices:
+        //      In most cases the use of regular boundary or corner patches is what we want,
+        //  but in some, i.e. when a non-manifold vertex is infinitely sharp, using
+        //  such patches will create some discontinuities.  At this point non-manifold
+        //  support is still evolving and is not strictly defined, so this is left to
+        //  a later date to resolve.
+        //
+        //  NOTE on infinitely sharp (hard) edges:
+        //      We should be able to adapt this later to detect hard (inf-sharp) edges
+        //  rather than just boundary edges -- there is a similar tag per edge.  That
+        //  should allow us to generate regular patches for interior hard features.
+        //
+        bool hasBoundaryVertex    = compFaceVertTag._boundary;
+        bool hasNonManifoldVertex = compFaceVertTag._nonManifold;
+        bool hasXOrdinaryVertex   = compFaceVertTag._xordinary;
+
+        patchTag._hasPatch  = true;
+        patchTag._isRegular = not hasXOrdinaryVertex or hasNonManifoldVertex;
+
+        //  Regular patches bounded by infinitely sharp edges -- the sharp edges of the face
+        //  become the boundary edges of the patch, taking precedence over the single-crease
+        //  patch and the inspection of boundaries below:
+        int infSharpEdgeMask = 0;
+        if (context.options.useInfSharpPatch and
+            level->isInfSharpRegularPatch(faceIndex, &infSharpEdgeMask) and infSharpEdgeMask) {
+
+            patchTag._isRegular       = true;
+            patchTag._isInfSharp      = true;
+            patchTag._hasBoundaryEdge = true;
+            patchTag._boundaryMask    = infSharpEdgeMask;
+            patchTag._boundaryCount   = ((infSharpEdgeMask >> 0) & 1) + ((infSharpEdgeMask >> 1) & 1) +
+                                        ((infSharpEdgeMask >> 2) & 1) + ((infSharpEdgeMask >> 3) & 1);
+        }
 
-            Vtr::internal::Level::VTag compFaceVertTag = level->getFaceCompositeVTag(fVerts);
-            if (compFaceVertTag._incomplete) {
-                continue;
-            }
+        // single crease patch optimization
+        if (context.options.useSingleCreasePatch and not patchTag._isInfSharp and
+            not hasXOrdinaryVertex and not hasBoundaryVertex and not hasNonManifoldVertex) {
 
-            //
-            //  We have a quad that will be represented as a B-spline or end cap patch.  Use
-            //  the "composite" tag again to quickly determine if any vertex is irregular, on
-            //  a boundary, non-manifold, etc.
-            //
-            //  Inspect the edges for boundaries and transitional edges and pack results into
-            //  4-bit masks.  We detect boundary edges rather than vertices as we hope to
-            //  replace the mask in future with one for infinitely sharp edges -- allowing
-            //  us to detect regular patches and avoid isolation.  We still need to account
-            //  for the irregular/xordinary case when a corner vertex is a boundary but there
-            //  are no boundary edges.
-            //
-            //  As for transition detection, assign the transition properties (even if 0).
-            //
-            //  NOTE on patches around non-manifold vertices:
-            //      In most cases the use of regular boundary or corner patches is what we want,
-            //  but in some, i.e. when a non-manifold vertex is infinitely sharp, using
-            //  such patches will create some discontinuities.  At this point non-manifold
-            //  support is still evolving and is not strictly defined, so this is left to
-            //  a later date to resolve.
-            //
-            //  NOTE on infinitely sharp (hard) edges:
-            //      We should be able to adapt this later to detect hard (inf-sharp) edges
-            //  rather than just boundary edges -- there is a similar tag per edge.  That
-            //  should allow us to generate regular patches for interior hard features.
-            //
-            bool hasBoundaryVertex    = compFaceVertTag._boundary;
-            bool hasNonManifoldVertex = compFaceVertTag._nonManifold;
-            bool hasXOrdinaryVertex   = compFaceVertTag._xordinary;
-
-            patchTag._hasPatch  = true;
-            patchTag._isRegular = not hasXOrdinaryVertex or hasNonManifoldVertex;
-
-            // single crease patch optimization
-            if (context.options.useSingleCreasePatch and
-                not hasXOrdinaryVertex and not hasBoundaryVertex and not hasNonManifoldVertex) {
-
-                Vtr::ConstIndexArray fEdges = level->getFaceEdges(faceIndex);
-                Vtr::internal::Level::ETag compFaceETag = level->getFaceCompositeETag(fEdges);
-
-                if (compFaceETag._semiSharp or compFaceETag._infSharp) {
-                    float sharpness = 0;
-                    int rotation = 0;
-                    if (level->isSingleCreasePatch(faceIndex, &sharpness, &rotation)) {
-
-                        // cap sharpness to the max isolation level
-                        float cappedSharpness =
-                                std::min(sharpness, (float)(context.options.maxIsolationLevel - levelIndex));
-                        if (cappedSharpness > 0) {
-                            patchTag._isSingleCrease = true;
-                            patchTag._boundaryIndex = rotation;
-                        }
+            Vtr::ConstIndexArray fEdges = level->getFaceEdges(faceIndex);
+            Vtr::internal::Level::ETag compFaceETag = level->getFaceCompositeETag(fEdges);
+
+            if (compFaceETag._semiSharp or compFaceETag._infSharp) {
+                float sharpness = 0;
+                int rotation = 0;
+                if (level->isSingleCreasePatch(faceIndex, &sharpness, &rotation)) {
+
+                    // cap sharpness to the max isolation level
+                    float cappedSharpness =
+                            std::min(sharpness, (float)(context.options.maxIsolationLevel - levelIndex));
+                    if (cappedSharpness > 0) {
+                        patchTag._isSingleCrease = true;
+                        patchTag._boundaryIndex = rotation;
                     }
                 }
             }
+        }
 
-            //  Identify boundaries for both regular and xordinary patches -- non-manifold
-            //  (infinitely sharp) edges and vertices are currently interpreted as boundaries
-            //  for regular patches, though an irregular patch or extrapolated boundary patch
-            //  is really necessary in future for some non-manifold cases.
-            //
-            if (hasBoundaryVertex or hasNonManifoldVertex) {
-                Vtr::ConstIndexArray fEdges = level->getFaceEdges(faceIndex);
-
-                int boundaryEdgeMask = ((level->getEdgeTag(fEdges[0])._boundary) << 0) |
-                                       ((level->getEdgeTag(fEdges[1])._boundary) << 1) |
-                                       ((level->getEdgeTag(fEdges[2])._boundary) << 2) |
-                                       ((level->getEdgeTag(fEdges[3])._boundary) << 3);
-                if (hasNonManifoldVertex) {
-                    int nonManEdgeMask = ((level->getEdgeTag(fEdges[0])._nonManifold) << 0) |
-                                         ((level->getEdgeTag(fEdges[1])._nonManifold) << 1) |
-                                         ((level->getEdgeTag(fEdges[2])._nonManifold) << 2) |
-                                         ((level->getEdgeTag(fEdges[3])._nonManifold) << 3);
-
-                    //  Other than non-manifold edges, non-manifold vertices that were made
-                    //  sharp should also trigger new "boundary" edges for the sharp corner
-                    //  patches introduced in these cases.
-                    //
-                    if (level->getVertexTag(fVerts[0])._nonManifold &&
-                        level->getVertexTag(fVerts[0])._infSharp) {
-                        nonManEdgeMask |= (1 << 0) | (1 << 3);
-                    }
-                    if (level->getVertexTag(fVerts[1])._nonManifold &&
-                        level->getVertexTag(fVerts[1])._infSharp) {
-                        nonManEdgeMask |= (1 << 1) | (1 << 0);
-                    }
-                    if (level->getVertexTag(fVerts[2])._nonManifold &&
-                        level->getVertexTag(fVerts[2])._infSharp) {
-                        nonManEdgeMask |= (1 << 2) | (1 << 1);
-                    }
-                    if (level->getVertexTag(fVerts[3])._nonManifold &&
-                        level->getVertexTag(fVerts[3])._infSharp) {
-                        nonManEdgeMask |= (1 << 3) | (1 << 2);
-                    }
-                    boundaryEdgeMask |= nonManEdgeMask;
+        //  Identify boundaries for both regular and xordinary patches -- non-manifold
+        //  (infinitely sharp) edges and vertices are currently interpreted as boundaries
+        //  for regular patches, though an irregular patch or extrapolated boundary patch
+        //  is really necessary in future for some non-manifold cases.
+        //
+        if ((hasBoundaryVertex or hasNonManifoldVertex) and not patchTag._isInfSharp) {
+            Vtr::ConstIndexArray fEdges = level->getFaceEdges(faceIndex);
+
+            int boundaryEdgeMask = ((level->getEdgeTag(fEdges[0])._boundary) << 0) |
+                                   ((level->getEdgeTag(fEdges[1])._boundary) << 1) |
+                                   ((level->getEdgeTag(fEdges[2])._boundary) << 2) |
+                                   ((level->getEdgeTag(fEdges[3])._boundary) << 3);
+            if (hasNonManifoldVertex) {
+                int nonManEdgeMask = ((level->getEdgeTag(fEdges[0])._nonManifold) << 0) |
+                                     ((level->getEdgeTag(fEdges[1])._nonManifold) << 1) |
+                                     ((level->getEdgeTag(fEdges[2])._nonManifold) << 2) |
+                                     ((level->getEdgeTag(fEdges[3])._nonManifold) << 3);
+
+                //  Other than non-manifold edges, non-manifold vertices that were made
+                //  sharp should also trigger new "boundary" edges for the sharp corner
+                //  patches introduced in these cases.
+                //
+                if (level->getVertexTag(fVerts[0])._nonManifold &&
+                    level->getVertexTag(fVerts[0])._infSharp) {
+                    nonManEdgeMask |= (1 << 0) | (1 << 3);
+                }
+                if (level->getVertexTag(fVerts[1])._nonManifold &&
+                    level->getVertexTag(fVerts[1])._infSharp) {
+                    nonManEdgeMask |= (1 << 1) | (1 << 0);
+                }
+                if (level->getVertexTag(fVerts[2])._nonManifold &&
+                    level->getVertexTag(fVerts[2])._infSharp) {
+                    nonManEdgeMask |= (1 << 2) | (1 << 1);
                 }
+                if (level->getVertexTag(fVerts[3])._nonManifold &&
+                    level->getVertexTag(fVerts[3])._infSharp) {
+                    nonManEdgeMask |= (1 << 3) | (1 << 2);
+                }
+                boundaryEdgeMask |= nonManEdgeMask;
+            }
 
-                if (boundaryEdgeMask) {
-                    patchTag.assignBoundaryPropertiesFromEdgeMask(boundaryEdgeMask);
-                } else {
-                    int boundaryVertMask = ((level->getVertexTag(fVerts[0])._boundary) << 0) |
-                                           ((level->getVertexTag(fVerts[1])._boundary) << 1) |
-                                           ((level->getVertexTag(fVerts[2])._boundary) << 2) |
-                                           ((level->getVertexTag(fVerts[3])._boundary) << 3);
-
-                    if (hasNonManifoldVertex) {
-                        int nonManVertMask = ((level->getVertexTag(fVerts[0])._nonManifold) << 0) |
-                                             ((level->getVertexTag(fVerts[1])._nonManifold) << 1) |
-                                             ((level->getVertexTag(fVerts[2])._nonManifold) << 2) |
-                                             ((level->getVertexTag(fVerts[3])._nonManifold) << 3);
-                        boundaryVertMask |= nonManVertMask;
-                    }
-                    patchTag.assignBoundaryPropertiesFromVertexMask(boundaryVertMask);
+            if (boundaryEdgeMask) {
+                patchTag.assignBoundaryPropertiesFromEdgeMask(boundaryEdgeMask);
+            } else {
+                int boundaryVertMask = ((level->getVertexTag(fVerts[0])._boundary) << 0) |
+                                       ((level->getVertexTag(fVerts[1])._boundary) << 1) |
+                                       ((level->getVertexTag(fVerts[2])._boundary) << 2) |
+                                       ((level->getVertexTag(fVerts[3])._boundary) << 3);
+
+                if (hasNonManifoldVertex) {
+                    int nonManVertMask = ((level->getVertexTag(fVerts[0])._nonManifold) << 0) |
+                                         ((level->getVertexTag(fVerts[1])._nonManifold) << 1) |
+                                         ((level->getVertexTag(fVerts[2])._nonManifold) << 2) |
+                                         ((level->getVertexTag(fVerts[3])._nonManifold) << 3);
+                    boundaryVertMask |= nonManVertMask;
                 }
+                patchTag.assignBoundaryPropertiesFromVertexMask(boundaryVertMask);
             }
+        }
 
-            //  XXXX (barfowl) -- why are we approximating a smooth x-ordinary corner with
-            //  a sharp corner patch?  The boundary/corner points of the regular patch are
-            //  not even made colinear to make it smoother.  Something historical here...
-            //
-            //  So this treatment may become optional in future and is bracketed with a
-            //  condition now for that reason.  We approximate x-ordinary smooth corners
-            //  with regular B-spline patches instead of using a Gregory patch.  The smooth
-            //  corner must be properly isolated from any other irregular vertices (as it
-            //  will be at any level > 1) otherwise the Gregory patch is necessary.
-            //
-            //  This flag to be initialized with a future option... ?
-            bool approxSmoothCornerWithRegularPatch = true;
-
-            if (approxSmoothCornerWithRegularPatch) {
-                if (!patchTag._isRegular and (patchTag._boundaryCount == 2)) {
-                    //  We may have a sharp corner opposite/adjacent an xordinary vertex --
-                    //  need to make sure there is only one xordinary vertex and that it
-                    //  is the corner vertex.
-                    if (levelIndex > 1) {
-                        patchTag._isRegular = true;
-                    } else {
-                        int xordVertex = 0;
-                        int xordCount = 0;
-                        if (level->getVertexTag(fVerts[0])._xordinary) { xordCount++; xordVertex = 0; }
-                        if (level->getVertexTag(fVerts[1])._xordinary) { xordCount++; xordVertex = 1; }
-                        if (level->getVertexTag(fVerts[2])._xordinary) { xordCount++; xordVertex = 2; }
-                        if (level->getVertexTag(fVerts[3])._xordinary) { xordCount++; xordVertex = 3; }
-
-                        if (xordCount == 1) {
-                            //  We require the vertex opposite the xordinary vertex be interior:
-                            if (not level->getVertexTag(fVerts[(xordVertex + 2) % 4])._boundary) {
-                                patchTag._isRegular = true;
-                            }
+        //  XXXX (barfowl) -- why are we approximating a smooth x-ordinary corner with
+        //  a sharp corner patch?  The boundary/corner points of the regular patch are
+        //  not even made colinear to make it smoother.  Something historical here...
+        //
+        //  So this treatment may become optional in future and is bracketed with a
+        //  condition now for that reason.  We approximate x-ordinary smooth corners
+        //  with regular B-spline patches instead of using a Gregory patch.  The smooth
+        //  corner must be properly isolated from any other irregular vertices (as it
+        //  will be at any level > 1) otherwise the Gregory patch is necessary.
+        //
+        //  This flag to be initialized with a future option... ?
+        bool approxSmoothCornerWithRegularPatch = true;
+
+        if (approxSmoothCornerWithRegularPatch) {
+            if (!patchTag._isRegular and (patchTag._boundaryCount == 2)) {
+                //  We may have a sharp corner opposite/adjacent an xordinary vertex --
+                //  need to make sure there is only one xordinary vertex and that it
+                //  is the corner vertex.
+                if (levelIndex > 1) {
+                    patchTag._isRegular = true;
+                } else {
+                    int xordVertex = 0;
+                    int xordCount = 0;
+                    if (level->getVertexTag(fVerts[0])._xordinary) { xordCount++; xordVertex = 0; }
+                    if (level->getVertexTag(fVerts[1])._xordinary) { xordCount++; xordVertex = 1; }
+                    if (level->getVertexTag(fVerts[2])._xordinary) { xordCount++; xordVertex = 2; }
+                    if (level->getVertexTag(fVerts[3])._xordinary) { xordCount++; xordVertex = 3; }
+
+                    if (xordCount == 1) {
+                        //  We require the vertex opposite the xordinary vertex be interior:
+                        if (not level->getVertexTag(fVerts[(xordVertex + 2) % 4])._boundary) {
+                            patchTag._isRegular = true;
                         }
                     }
                 }
             }
+        }
 
-            //
-            //  Now that all boundary features have have been identified and tagged, assign
-            //  the transition type for the patch before taking inventory.
-            //
-            //  Identify and increment counts for regular patches (both non-transitional and
-            //  transitional) and extra-ordinary patches (always non-transitional):
-            //
-            patchTag.assignTransitionPropertiesFromEdgeMask(refinedFaceTag._transitional);
+        //
+        //  Now that all boundary features have have been identified and tagged, assign
+        //  the transition type for the patch before taking inventory.
+        //
+        //  Identify and increment counts for regular patches (both non-transitional and
+        //  transitional) and extra-ordinary patches (always non-transitional):
+        //
+        patchTag.assignTransitionPropertiesFromEdgeMask(refinedFaceTag._transitional);
 
-            if (patchTag._isRegular) {
+        if (patchTag._isRegular) {
 
+            if (patchTag._boundaryCount == 0) {
+                range.patchCounts.R++;
+            } else if (patchTag._boundaryCount == 1) {
+                range.patchCounts.R++;
+            } else {
+                range.patchCounts.R++;
+            }
+        } else {
+            // select endcap patchtype
+            switch(context.options.GetEndCapType()) {
+            case Options::ENDCAP_GREGORY_BASIS:
+                range.patchCounts.GP++;
+                break;
+            case Options::ENDCAP_BSPLINE_BASIS:
+                range.patchCounts.R++;
+                break;
+            case Options::ENDCAP_LEGACY_GREGORY:
                 if (patchTag._boundaryCount == 0) {
-                    context.patchInventory.R++;
-                } else if (patchTag._boundaryCount == 1) {
-                    context.patchInventory.R++;
+                    range.patchCounts.G++;
                 } else {
-                    context.patchInventory.R++;
-                }
-            } else {
-                // select endcap patchtype
-                switch(context.options.GetEndCapType()) {
-                case Options::ENDCAP_GREGORY_BASIS:
-                    context.patchInventory.GP++;
-                    break;
-                case Options::ENDCAP_BSPLINE_BASIS:
-                    context.patchInventory.R++;
-                    break;
-                case Options::ENDCAP_LEGACY_GREGORY:
-                    if (patchTag._boundaryCount == 0) {
-                        context.patchInventory.G++;
-                    } else {
-                        context.patchInventory.GB++;
-                    }
-                    break;
-                case Options::ENDCAP_BILINEAR_BASIS:
-                    // not implemented yet
-                    assert(false);
-                    break;
-                default:
-                    // no endcap
-                    break;
+                    range.patchCounts.GB++;
                 }
+                break;
+            case Options::ENDCAP_BILINEAR_BASIS:
+                // not implemented yet
+                assert(false);
+                break;
+            default:
+                // no endcap
+                break;
             }
         }
-        levelPatchTags += level->getNumFaces();
     }
 }
 
@@ -1056,15 +2453,13 @@ PatchTableFactory::populateAdaptivePatches(
 
     PatchTable * table = context.table;
 
+    PopulateContext populate(context, ptexIndices);
+
     //
     //  Setup convenience pointers at the beginning of each patch array for each
     // table (patches, ptex)
     //
-    PatchCVPointers    iptrs;
-    PatchParamPointers pptrs;
-    PatchFVarOffsets   fofss;
-    PatchFVarPointers  fptrs;
-    SharpnessIndexPointers sptrs;
+    Index * sharpnessIndices = 0;
 
     ConstPatchDescriptorArray const & descs =
         PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_CATMARK);
@@ -1079,17 +2474,18 @@ PatchTableFactory::populateAdaptivePatches(
             continue;
         }
 
-        iptrs.getValue(desc) = table->getPatchArrayVertices(arrayIndex).begin();
-        pptrs.getValue(desc) = table->getPatchParams(arrayIndex).begin();
-        if (context.options.useSingleCreasePatch) {
-            sptrs.getValue(desc) = table->getSharpnessIndices(arrayIndex);
+        populate.iptrs.getValue(desc) = table->getPatchArrayVertices(arrayIndex).begin();
+        populate.pptrs.getValue(desc) = table->getPatchParams(arrayIndex).begin();
+
+        // sharpness indices of all patches are assigned in face order from
+        // the start of the regular patches
+        if (context.options.useSingleCreasePatch and
+            desc.GetType()==PatchDescriptor::REGULAR) {
+            sharpnessIndices = table->getSharpnessIndices(arrayIndex);
         }
 
         if (context.RequiresFVarPatches()) {
 
-            Index & offsets = fofss.getValue(desc);
-            offsets = table->getPatchIndex(arrayIndex, 0);
-
             // XXXX manuelk this stuff will go away as we use offsets from FVarPatchChannel
             FVarChannelCursor & fvc = context.fvarChannelCursor;
             assert(fvc.size() == table->GetNumFVarChannels());
@@ -1101,20 +2497,52 @@ PatchTableFactory::populateAdaptivePatches(
                 int ofs = pidx * 4;
                 fptr[fvc.pos()] = &table->getFVarValues(fvc.pos())[ofs];
             }
-            fptrs.getValue(desc) = fptr;
+            populate.fptrs.getValue(desc) = fptr;
+        }
+
+        if (context.DefersFVarPatches()) {
+            populate.faceptrs.getValue(desc) =
+                &table->_fvarPatchFaces[table->getPatchIndex(arrayIndex, 0)];
+        }
+    }
+
+    if (context.RequiresFVarPatches()) {
+        int nchannels = refiner.GetNumFVarChannels();
+
+        populate.levelFVarVertOffsets.resize(refiner.GetNumLevels() * nchannels, 0);
+        for (int i = 1; i < refiner.GetNumLevels(); ++i) {
+            for (int channel=0; channel<nchannels; ++channel) {
+                populate.levelFVarVertOffsets[i * nchannels + channel] =
+                    populate.levelFVarVertOffsets[(i-1) * nchannels + channel] +
+                    refiner.getLevel(i-1).getNumFVarValues(channel);
+            }
         }
     }
 
     //
-    //  Now iterate through the faces for all levels and populate the patches:
+    //  Locate the first patch of each range of faces in the patch arrays from the
+    //  patches identified for all preceding ranges:
     //
-    int levelFaceOffset = 0,
-        levelVertOffset = 0;
-    int * levelFVarVertOffsets = 0;
-    if (context.RequiresFVarPatches()) {
-         int nchannels = refiner.GetNumFVarChannels();
-         levelFVarVertOffsets = (int *)alloca(nchannels*sizeof(int));
-         memset(levelFVarVertOffsets, 0, nchannels*sizeof(int));
+    PatchTypes<int> patchOffsets;
+    int patchIndex = 0;
+
+    int numRanges = (int)context.faceRanges.size();
+    for (int i = 0; i < numRanges; ++i) {
+        PatchFaceRange & range = context.faceRanges[i];
+
+        range.patchOffsets = patchOffsets;
+        range.patchIndex   = patchIndex;
+
+        patchOffsets.R  += range.patchCounts.R;
+        patchOffsets.G  += range.patchCounts.G;
+        patchOffsets.GB += range.patchCounts.GB;
+        patchOffsets.GP += range.patchCounts.GP;
+
+        patchIndex += range.patchCounts.R + range.patchCounts.G +
+                      range.patchCounts.GB + range.patchCounts.GP;
+    }
+    if (sharpnessIndices) {
+        populate.sharpness.resize(patchIndex);
     }
 
     // endcap factories
@@ -1150,156 +2578,66 @@ PatchTableFactory::populateAdaptivePatches(
         break;
     }
 
-    for (int i = 0; i < refiner.GetNumLevels(); ++i) {
-        Vtr::internal::Level const * level = &refiner.getLevel(i);
-
-        const PatchFaceTag * levelPatchTags = &context.patchTags[levelFaceOffset];
-
-        for (int faceIndex = 0; faceIndex < level->getNumFaces(); ++faceIndex) {
-
-            if (level->isFaceHole(faceIndex)) {
-                continue;
-            }
+    //
+    //  Now iterate through the faces of all ranges and populate the patches:
+    //
+    if (context.monitor) {
+        context.monitor->beginStage(0.5f, 1.0f, numRanges);
+    }
+    if (context.taskScheduler and numRanges > 1) {
+        context.taskScheduler->ParallelFor(0, numRanges, 1, populatePatchFaceRanges, &populate);
+    } else {
+        populatePatchFaceRanges(0, numRanges, &populate);
+    }
 
-            const PatchFaceTag& patchTag = levelPatchTags[faceIndex];
-            if (not patchTag._hasPatch) {
-                continue;
+    //
+    //  Gather the points of the end-cap patches, deferred by the ranges, in face order:
+    //
+    for (int i = 0; i < numRanges; ++i) {
+        PatchFaceRange const & range = context.faceRanges[i];
+
+        Vtr::internal::Level const * level = &refiner.getLevel(range.level);
+
+        const PatchFaceTag * levelPatchTags = &context.patchTags[range.levelFaceOffset];
+
+        for (int j = 0; j < (int)range.endCapFaces.size(); ++j) {
+
+            Index faceIndex = range.endCapFaces[j];
+
+            ConstIndexArray cvs;
+
+            // switch endcap patchtype by option
+            switch(context.options.GetEndCapType()) {
+            case Options::ENDCAP_GREGORY_BASIS:
+                // note: this call will be moved into vtr::level.
+                cvs = endCapGregoryBasis->GetPatchPoints(
+                    level, faceIndex, levelPatchTags, range.levelVertOffset);
+                break;
+            case Options::ENDCAP_BSPLINE_BASIS:
+                cvs = endCapBSpline->GetPatchPoints(
+                    level, faceIndex, levelPatchTags, range.levelVertOffset);
+                break;
+            case Options::ENDCAP_LEGACY_GREGORY:
+                cvs = endCapLegacyGregory->GetPatchPoints(
+                    level, faceIndex, levelPatchTags, range.levelVertOffset);
+                break;
+            default:
+                assert(false);
+                break;
             }
 
-            if (patchTag._isRegular) {
-                Index patchVerts[16];
-
-                int bIndex = patchTag._boundaryIndex;
-                int boundaryMask = patchTag._boundaryMask;
-                int transitionMask = patchTag._transitionMask;
-
-                int const * permutation = 0;
-                // only single-crease patch has a sharpness.
-                float sharpness = 0;
-
-                if (patchTag._boundaryCount == 0) {
-                    static int const permuteRegular[16] = { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
-                    permutation = permuteRegular;
-
-                    if (patchTag._isSingleCrease) {
-                        boundaryMask = (1<<bIndex);
-                        sharpness = level->getEdgeSharpness((level->getFaceEdges(faceIndex)[bIndex]));
-                        sharpness = std::min(sharpness, (float)(context.options.maxIsolationLevel-i));
-                    }
-
-                    level->gatherQuadRegularInteriorPatchPoints(faceIndex, patchVerts, 0 /* no rotation*/);
-                } else if (patchTag._boundaryCount == 1) {
-                    // Expand boundary patch vertices and rotate to restore correct orientation.
-                    static int const permuteBoundary[4][16] = {
-                        { -1, -1, -1, -1, 11, 3, 0, 4, 10, 2, 1, 5, 9, 8, 7, 6 },
-                        { 9, 10, 11, -1, 8, 2, 3, -1, 7, 1, 0, -1, 6, 5, 4, -1 },
-                        { 6, 7, 8, 9, 5, 1, 2, 10, 4, 0, 3, 11, -1, -1, -1, -1 },
-                        { -1, 4, 5, 6, -1, 0, 1, 7, -1, 3, 2, 8, -1, 11, 10, 9 } };
-                    permutation = permuteBoundary[bIndex];
-                    level->gatherQuadRegularBoundaryPatchPoints(faceIndex, patchVerts, bIndex);
-                } else if (patchTag._boundaryCount == 2) {
-                    // Expand corner patch vertices and rotate to restore correct orientation.
-                    static int const permuteCorner[4][16] = {
-                        { -1, -1, -1, -1, -1, 0, 1, 4, -1, 3, 2, 5, -1, 8, 7, 6 },
-                        { -1, -1, -1, -1, 8, 3, 0, -1, 7, 2, 1, -1, 6, 5, 4, -1 },
-                        { 6, 7, 8, -1, 5, 2, 3, -1, 4, 1, 0, -1, -1, -1, -1, -1 },
-                        { -1, 4, 5, 6, -1, 1, 2, 7, -1, 0, 3, 8, -1, -1, -1, -1 } };
-                    permutation = permuteCorner[bIndex];
-                    level->gatherQuadRegularCornerPatchPoints(faceIndex, patchVerts, bIndex);
-                } else {
-                    assert(patchTag._boundaryCount <= 2);
-                }
-
-                offsetAndPermuteIndices(patchVerts, 16, levelVertOffset, permutation, iptrs.R);
+            Index * verts = range.endCapVerts[j];
+            for (int k = 0; k < cvs.size(); ++k) verts[k] = cvs[k];
+        }
+    }
 
-                iptrs.R += 16;
-                pptrs.R = computePatchParam(refiner, ptexIndices, i, faceIndex, boundaryMask, transitionMask, pptrs.R);
-                // XXX: sharpness will be integrated into patch param soon.
-                if (sptrs.R) *sptrs.R++ = assignSharpnessIndex(sharpness, table->_sharpnessValues);
+    if (endCapGregoryBasis) {
+        endCapGregoryBasis->Finalize(context.taskScheduler);
+    }
 
-                fofss.R += gatherFVarData(context,
-                                          i, faceIndex, levelFaceOffset, /*rotation*/0, levelFVarVertOffsets, fofss.R, fptrs.R);
-            } else {
-                // emit end patch. end patch should be in the max level (until we implement DFAS)
-                assert(i==refiner.GetMaxLevel());
-
-                // switch endcap patchtype by option
-                switch(context.options.GetEndCapType()) {
-                case Options::ENDCAP_GREGORY_BASIS:
-                {
-                    // note: this call will be moved into vtr::level.
-                    ConstIndexArray cvs = endCapGregoryBasis->GetPatchPoints(
-                        level, faceIndex, levelPatchTags, levelVertOffset);
-
-                    for (int j = 0; j < cvs.size(); ++j) iptrs.GP[j] = cvs[j];
-                    iptrs.GP += cvs.size();
-                    pptrs.GP = computePatchParam(
-                        refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.GP);
-                    if (sptrs.R) *sptrs.R++ = assignSharpnessIndex(0, table->_sharpnessValues);
-                    fofss.GP += gatherFVarData(context,
-                                               i, faceIndex, levelFaceOffset,
-                                               0, levelFVarVertOffsets, fofss.GP, fptrs.GP);
-                    break;
-                }
-                case Options::ENDCAP_BSPLINE_BASIS:
-                {
-                    ConstIndexArray cvs = endCapBSpline->GetPatchPoints(
-                        level, faceIndex, levelPatchTags, levelVertOffset);
-
-                    for (int j = 0; j < cvs.size(); ++j) iptrs.R[j] = cvs[j];
-                    iptrs.R += cvs.size();
-                    pptrs.R = computePatchParam(
-                        refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.R);
-                    if (sptrs.R) *sptrs.R++ = assignSharpnessIndex(0, table->_sharpnessValues);
-                    fofss.R += gatherFVarData(context,
-                                              i, faceIndex, levelFaceOffset,
-                                              0, levelFVarVertOffsets, fofss.R, fptrs.R);
-                    break;
-                }
-                case Options::ENDCAP_LEGACY_GREGORY:
-                {
-                    ConstIndexArray cvs = endCapLegacyGregory->GetPatchPoints(
-                        level, faceIndex, levelPatchTags, levelVertOffset);
-
-                    if (patchTag._boundaryCount == 0) {
-                        for (int j = 0; j < cvs.size(); ++j) iptrs.G[j] = cvs[j];
-                        iptrs.G += cvs.size();
-                        pptrs.G = computePatchParam(
-                            refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.G);
-                        if (sptrs.R) *sptrs.R++ = assignSharpnessIndex(0, table->_sharpnessValues);
-                        fofss.G += gatherFVarData(context,
-                                                  i, faceIndex, levelFaceOffset,
-                                                  0, levelFVarVertOffsets, fofss.G, fptrs.G);
-                    } else {
-                        for (int j = 0; j < cvs.size(); ++j) iptrs.GB[j] = cvs[j];
-                        iptrs.GB += cvs.size();
-                        pptrs.GB = computePatchParam(
-                            refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.GB);
-                        if (sptrs.R) *sptrs.R++ = assignSharpnessIndex(0, table->_sharpnessValues);
-                        fofss.GB += gatherFVarData(context,
-                                                   i, faceIndex, levelFaceOffset,
-                                                   0, levelFVarVertOffsets, fofss.GB, fptrs.GB);
-                    }
-                    break;
-                }
-                case Options::ENDCAP_BILINEAR_BASIS:
-                    // not implemented yet
-                    assert(false);
-                    break;
-                default:
-                    // no endcap
-                    break;
-                }
-            }
-        }
-        levelFaceOffset += level->getNumFaces();
-        levelVertOffset += level->getNumVertices();
-        if (context.RequiresFVarPatches()) {
-            int nchannels = refiner.GetNumFVarChannels();
-            for (int channel=0; channel<nchannels; ++channel) {
-                levelFVarVertOffsets[channel] += level->getNumFVarValues(channel);
-            }
-        }
+    // XXX: sharpness will be integrated into patch param soon.
+    for (int i = 0; i < (int)populate.sharpness.size(); ++i) {
+        sharpnessIndices[i] = assignSharpnessIndex(populate.sharpness[i], table->_sharpnessValues);
     }
 
     // finalize end patches
@@ -1340,6 +2678,239 @@ PatchTableFactory::populateAdaptivePatches(
     }
 }
 
+void
+PatchTableFactory::populatePatchFaceRanges(int begin, int end, void * populate) {
+
+    PopulateContext & context = *static_cast<PopulateContext *>(populate);
+
+    BuildMonitor * monitor = context.context.monitor;
+
+    for (int i = begin; i < end; ++i) {
+        // (the ranges of a cancelled build are left empty)
+        if (monitor and monitor->IsCancelled()) continue;
+
+        populatePatchFaceRange(context, context.context.faceRanges[i]);
+
+        if (monitor) monitor->advance(1);
+    }
+}
+
+//
+//  Populate the patches for a range of faces within a level -- the points of end-cap
+//  patches are not gathered here but deferred to be gathered serially.
+//
+void
+PatchTableFactory::populatePatchFaceRange(
+    PopulateContext & populate, PatchFaceRange & range) {
+
+    AdaptiveContext & context = populate.context;
+
+    TopologyRefiner const & refiner = context.refiner;
+
+    PtexIndices const & ptexIndices = populate.ptexIndices;
+
+    //
+    //  Setup convenience pointers at the first patch of the range in each patch array:
+    //
+    PatchCVPointers    iptrs;
+    PatchParamPointers pptrs;
+    PatchFVarOffsets   fofss;
+    PatchFVarPointers  fptrs;
+    PatchFacePointers  faceptrs;
+
+    ConstPatchDescriptorArray const & descs =
+        PatchDescriptor::GetAdaptivePatchDescriptors(Sdc::SCHEME_CATMARK);
+
+    for (int i=0; i<descs.size(); ++i) {
+
+        PatchDescriptor desc = descs[i];
+
+        int patchOffset = range.patchOffsets.getValue(desc);
+
+        iptrs.getValue(desc) = populate.iptrs.getValue(desc) +
+                               patchOffset * desc.GetNumControlVertices();
+        pptrs.getValue(desc) = populate.pptrs.getValue(desc) + patchOffset;
+
+        if (populate.fptrs.getValue(desc)) {
+
+            int nchannels = context.fvarChannelCursor.size();
+
+            Index ** fptr = (Index **)alloca(nchannels*sizeof(Index *));
+            for (int channel=0; channel<nchannels; ++channel) {
+                fptr[channel] = populate.fptrs.getValue(desc)[channel] + patchOffset * 4;
+            }
+            fptrs.getValue(desc) = fptr;
+        }
+
+        if (populate.faceptrs.getValue(desc)) {
+            faceptrs.getValue(desc) = populate.faceptrs.getValue(desc) + patchOffset;
+        }
+    }
+
+    float * sptr = populate.sharpness.empty() ? 0 :
+                   &populate.sharpness[0] + range.patchIndex;
+
+    int i = range.level;
+
+    Vtr::internal::Level const * level = &refiner.getLevel(i);
+
+    Index levelFaceOffset = range.levelFaceOffset,
+          levelVertOffset = range.levelVertOffset;
+
+    Index const * levelFVarVertOffsets = 0;
+    if (context.RequiresFVarPatches()) {
+        levelFVarVertOffsets =
+            &populate.levelFVarVertOffsets[i * refiner.GetNumFVarChannels()];
+    }
+
+    const PatchFaceTag * levelPatchTags = &context.patchTags[levelFaceOffset];
+
+    for (int faceIndex = range.faceBegin; faceIndex < range.faceEnd; ++faceIndex) {
+
+        if (level->isFaceHole(faceIndex)) {
+            continue;
+        }
+
+        const PatchFaceTag& patchTag = levelPatchTags[faceIndex];
+        if (not patchTag._hasPatch) {
+            continue;
+        }
+
+        if (patchTag._isRegular) {
+            Index patchVerts[16];
+
+            int bIndex = patchTag._boundaryIndex;
+            int boundaryMask = patchTag._boundaryMask;
+            int transitionMask = patchTag._transitionMask;
+
+            int const * permutation = 0;
+            // only single-crease patch has a sharpness.
+            float sharpness = 0;
+
+            if (patchTag._isInfSharp) {
+                //  Points are gathered in the order of the patch, with those beyond the
+                //  sharp edges (extrapolated by the boundary mask) already assigned:
+                level->gatherQuadRegularInfSharpPatchPoints(faceIndex, patchVerts, boundaryMask);
+            } else if (patchTag._boundaryCount == 0) {
+                static int const permuteRegular[16] = { 5, 6, 7, 8, 4, 0, 1, 9, 15, 3, 2, 10, 14, 13, 12, 11 };
+                permutation = permuteRegular;
+
+                if (patchTag._isSingleCrease) {
+                    boundaryMask = (1<<bIndex);
+                    sharpness = level->getEdgeSharpness((level->getFaceEdges(faceIndex)[bIndex]));
+                    sharpness = std::min(sharpness, (float)(context.options.maxIsolationLevel-i));
+                }
+
+                level->gatherQuadRegularInteriorPatchPoints(faceIndex, patchVerts, 0 /* no rotation*/);
+            } else if (patchTag._boundaryCount == 1) {
+                // Expand boundary patch vertices and rotate to restore correct orientation.
+                static int const permuteBoundary[4][16] = {
+                    { -1, -1, -1, -1, 11, 3, 0, 4, 10, 2, 1, 5, 9, 8, 7, 6 },
+                    { 9, 10, 11, -1, 8, 2, 3, -1, 7, 1, 0, -1, 6, 5, 4, -1 },
+                    { 6, 7, 8, 9, 5, 1, 2, 10, 4, 0, 3, 11, -1, -1, -1, -1 },
+                    { -1, 4, 5, 6, -1, 0, 1, 7, -1, 3, 2, 8, -1, 11, 10, 9 } };
+                permutation = permuteBoundary[bIndex];
+                level->gatherQuadRegularBoundaryPatchPoints(faceIndex, patchVerts, bIndex);
+            } else if (patchTag._boundaryCount == 2) {
+                // Expand corner patch vertices and rotate to restore correct orientation.
+                static int const permuteCorner[4][16] = {
+                    { -1, -1, -1, -1, -1, 0, 1, 4, -1, 3, 2, 5, -1, 8, 7, 6 },
+                    { -1, -1, -1, -1, 8, 3, 0, -1, 7, 2, 1, -1, 6, 5, 4, -1 },
+                    { 6, 7, 8, -1, 5, 2, 3, -1, 4, 1, 0, -1, -1, -1, -1, -1 },
+                    { -1, 4, 5, 6, -1, 1, 2, 7, -1, 0, 3, 8, -1, -1, -1, -1 } };
+                permutation = permuteCorner[bIndex];
+                level->gatherQuadRegularCornerPatchPoints(faceIndex, patchVerts, bIndex);
+            } else {
+                assert(patchTag._boundaryCount <= 2);
+            }
+
+            offsetAndPermuteIndices(patchVerts, 16, levelVertOffset, permutation, iptrs.R);
+
+            iptrs.R += 16;
+            pptrs.R = computePatchParam(refiner, ptexIndices, i, faceIndex, boundaryMask, transitionMask, pptrs.R);
+            if (sptr) *sptr++ = sharpness;
+
+            fofss.R += gatherFVarData(context,
+                                      i, faceIndex, levelFaceOffset, /*rotation*/0, levelFVarVertOffsets, fofss.R, fptrs.R);
+
+            if (faceptrs.R) *faceptrs.R++ = levelFaceOffset + faceIndex;
+        } else {
+            // emit end patch. end patches are in the max level, unless the isolation
+            // of their base face was limited (see TopologyRefiner::RefineAdaptive)
+
+            // switch endcap patchtype by option
+            switch(context.options.GetEndCapType()) {
+            case Options::ENDCAP_GREGORY_BASIS:
+            {
+                range.endCapFaces.push_back(faceIndex);
+                range.endCapVerts.push_back(iptrs.GP);
+
+                iptrs.GP += PatchDescriptor::GetGregoryBasisPatchSize();
+                pptrs.GP = computePatchParam(
+                    refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.GP);
+                if (sptr) *sptr++ = 0;
+                fofss.GP += gatherFVarData(context,
+                                           i, faceIndex, levelFaceOffset,
+                                           0, levelFVarVertOffsets, fofss.GP, fptrs.GP);
+                if (faceptrs.GP) *faceptrs.GP++ = levelFaceOffset + faceIndex;
+                break;
+            }
+            case Options::ENDCAP_BSPLINE_BASIS:
+            {
+                range.endCapFaces.push_back(faceIndex);
+                range.endCapVerts.push_back(iptrs.R);
+
+                iptrs.R += PatchDescriptor::GetRegularPatchSize();
+                pptrs.R = computePatchParam(
+                    refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.R);
+                if (sptr) *sptr++ = 0;
+                fofss.R += gatherFVarData(context,
+                                          i, faceIndex, levelFaceOffset,
+                                          0, levelFVarVertOffsets, fofss.R, fptrs.R);
+                if (faceptrs.R) *faceptrs.R++ = levelFaceOffset + faceIndex;
+                break;
+            }
+            case Options::ENDCAP_LEGACY_GREGORY:
+            {
+                range.endCapFaces.push_back(faceIndex);
+
+                if (patchTag._boundaryCount == 0) {
+                    range.endCapVerts.push_back(iptrs.G);
+
+                    iptrs.G += PatchDescriptor::GetGregoryPatchSize();
+                    pptrs.G = computePatchParam(
+                        refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.G);
+                    if (sptr) *sptr++ = 0;
+                    fofss.G += gatherFVarData(context,
+                                              i, faceIndex, levelFaceOffset,
+                                              0, levelFVarVertOffsets, fofss.G, fptrs.G);
+                    if (faceptrs.G) *faceptrs.G++ = levelFaceOffset + faceIndex;
+                } else {
+                    range.endCapVerts.push_back(iptrs.GB);
+
+                    iptrs.GB += PatchDescriptor::GetGregoryPatchSize();
+                    pptrs.GB = computePatchParam(
+                        refiner, ptexIndices, i, faceIndex, /*boundary*/0, /*transition*/0, pptrs.GB);
+                    if (sptr) *sptr++ = 0;
+                    fofss.GB += gatherFVarData(context,
+                                               i, faceIndex, levelFaceOffset,
+                                               0, levelFVarVertOffsets, fofss.GB, fptrs.GB);
+                    if (faceptrs.GB) *faceptrs.GB++ = levelFaceOffset + faceIndex;
+                }
+                break;
+            }
+            case Options::ENDCAP_BILINEAR_BASIS:
+                // not implemented yet
+                assert(false);
+                break;
+            default:
+                // no endcap
+                break;
+            }
+        }
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
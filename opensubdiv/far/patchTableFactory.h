@@ -35,7 +35,9 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 //  Forward declarations (for internal implementation purposes):
+class BuildMonitor;
 class PtexIndices;
+class TaskScheduler;
 class TopologyRefiner;
 
 class PatchTableFactory {
@@ -66,6 +68,7 @@ public:
         unsigned int   _boundaryCount   : 3;
         unsigned int   _hasBoundaryEdge : 3;
         unsigned int   _isSingleCrease  : 1;
+        unsigned int   _isInfSharp      : 1;
 
         void clear();
         void assignBoundaryPropertiesFromEdgeMask(int boundaryEdgeMask);
@@ -90,15 +93,25 @@ public:
              generateAllLevels(false),
              triangulateQuads(false),
              useSingleCreasePatch(false),
+             useInfSharpPatch(false),
              maxIsolationLevel(maxIsolation),
              endCapType(ENDCAP_GREGORY_BASIS),
              shareEndCapPatchPoints(true),
+             convertLegacyGregory(false),
              generateFVarTables(false),
+             deferFVarChannels(false),
+             generateFVarBicubicPatches(false),
              numFVarChannels(-1),
-             fvarChannelIndices(0)
+             fvarChannelIndices(0),
+             taskScheduler(0),
+             monitor(0)
         { }
 
         /// \brief Get endcap patch type
+        ///
+        /// \note End caps of the Loop scheme are linear triangles (TRIANGLES)
+        ///       of any type other than ENDCAP_NONE
+        ///
         EndCapType GetEndCapType() const { return (EndCapType)endCapType; }
 
         /// \brief Set endcap patch type
@@ -107,17 +120,34 @@ public:
         unsigned int generateAllLevels    : 1, ///< Include levels from 'firstLevel' to 'maxLevel' (Uniform mode only)
                      triangulateQuads     : 1, ///< Triangulate 'QUADS' primitives (Uniform mode only)
                      useSingleCreasePatch : 1, ///< Use single crease patch
+                     useInfSharpPatch     : 1, ///< Use regular patches bounded by infinitely sharp
+                                               ///< edges (see TopologyRefiner::AdaptiveOptions)
                      maxIsolationLevel    : 4, ///< Cap adaptive feature isolation to the given level (max. 10)
 
                      // end-capping
                      endCapType              : 3, ///< EndCapType
                      shareEndCapPatchPoints  : 1, ///< Share endcap patch points among adjacent endcap patches.
                                                   ///< currently only work with GregoryBasis.
+                     convertLegacyGregory    : 1, ///< Build ENDCAP_LEGACY_GREGORY end caps as
+                                                  ///< Gregory basis patches and local point
+                                                  ///< stencils (same surface, no valence table)
 
                      // face-varying
-                     generateFVarTables   : 1;///< Generate face-varying patch tables
+                     generateFVarTables   : 1,///< Generate face-varying patch tables
+                     deferFVarChannels    : 1,///< Defer gathering the values of each face-varying
+                                              ///< channel to BuildFVarChannel()
+                     generateFVarBicubicPatches : 1; ///< Generate bicubic face-varying patches where the
+                                                     ///< face-varying topology matches the vertex topology
+                                                     ///< of regular patches (Adaptive mode only, see
+                                                     ///< PatchTable::GetFVarChannelPatchDescriptor())
         int          numFVarChannels;          ///< Number of channel indices and interpolation modes passed
         int const *  fvarChannelIndices;       ///< List containing the indices of the channels selected for the factory
+
+        TaskScheduler const * taskScheduler;   ///< Scheduler used to identify and populate adaptive
+                                               ///< patches concurrently (serial if null)
+
+        BuildMonitor * monitor;                ///< Optional monitor of the progress of the build,
+                                               ///< which can cancel it (Create() then returns NULL)
     };
 
     /// \brief Factory constructor for PatchTable
@@ -131,11 +161,240 @@ public:
     static PatchTable * Create(TopologyRefiner const & refiner,
                                Options options=Options());
 
+    /// \brief Instantiates the PatchTable of a level of detail of an
+    ///        adaptive refinement
+    ///
+    /// Patches are isolated to 'isolationLevel' rather than to the last
+    /// level of the refiner, as if the refinement had stopped there : the
+    /// tables of all levels of detail are created from a single refinement,
+    /// and share its refined vertices (and their stencils, see
+    /// StencilTableFactory::Create()).
+    ///
+    /// The local points of the table are offset by 'localPointOffset', so
+    /// that the local points of several levels of detail are stacked after
+    /// the refined vertices : the local point stencils of the tables
+    /// concatenated in the same order (see StencilTableFactory::Create())
+    /// are appended at once to the vertex stencils (see
+    /// StencilTableFactory::AppendLocalPointStencilTable()).
+    ///
+    /// \note Catmark scheme and non-sparse refinements only. Face-varying
+    ///       channels of the table can't be updated or deferred (see
+    ///       UpdateFVarChannels()), and the table of the last level is that
+    ///       of Create().
+    ///
+    /// @param refiner              Adaptive TopologyRefiner
+    ///
+    /// @param isolationLevel       Level of isolation of the patches, from 1
+    ///                             (base faces are not all patches) to the
+    ///                             last level of the refiner
+    ///
+    /// @param localPointOffset     Offset of the indices of the local points
+    ///
+    /// @param options              Options controlling the creation of the table
+    ///                             (maxIsolationLevel is ignored)
+    ///
+    /// @return                     A new instance of PatchTable (NULL on
+    ///                             failure)
+    ///
+    static PatchTable * CreateLevelOfDetail(TopologyRefiner const & refiner,
+                                            int isolationLevel,
+                                            Index localPointOffset=0,
+                                            Options options=Options());
+
+    /// \brief Instantiates a PatchTable approximating the limit surface with
+    ///        a patch per base face, without feature isolation
+    ///
+    /// Intended for fast previews : the patches are gathered from the base
+    /// level alone, so the refiner must not be refined. Regular quads are
+    /// B-spline patches, exact on the limit surface, and irregular quads are
+    /// approximated by the end caps of 'options' (Gregory basis patches by
+    /// default, legacy Gregory end caps being converted to them) computed
+    /// directly from the base mesh, in the manner of the approximate
+    /// Catmull-Clark (ACC) patches. The base faces are identified and
+    /// populated in parallel ranges with Options::taskScheduler.
+    ///
+    /// The local points of the end caps are indexed past the vertices of the
+    /// refiner (see StencilTableFactory::AppendLocalPointStencilTable()).
+    ///
+    /// \note Unrefined Catmark refiners only, and face-varying channels are
+    ///       not generated. Semi-sharp features of the base mesh are
+    ///       approximated by the smooth surface (or by single-crease patches
+    ///       if enabled). Faces that are not quads, and
+    ///       quads with a vertex incident to a face that is not a quad, have no
+    ///       patch : such meshes need feature adaptive refinement for a
+    ///       complete table.
+    ///
+    /// @param refiner              Unrefined Catmark TopologyRefiner
+    ///
+    /// @param options              Options controlling the creation of the table
+    ///                             (maxIsolationLevel only caps the sharpness of
+    ///                             single-crease patches)
+    ///
+    /// @return                     A new instance of PatchTable (NULL on
+    ///                             failure)
+    ///
+    static PatchTable * CreateApproximate(TopologyRefiner const & refiner,
+                                          Options options=Options());
+
+    /// \brief Instantiates a PatchTable by merging the tables of partitions
+    ///        of a mesh
+    ///
+    /// The table of each partition is created from a sparse refinement of its
+    /// base faces (see TopologyRefiner::RefineSparse()), e.g. on a thread or
+    /// a node of its own : the refinement includes the ring of neighboring
+    /// faces supporting the patches, and the ptex indices of the patches are
+    /// those of the whole base mesh.
+    ///
+    /// The control vertices of the patches of each table are offset by
+    /// vertexOffsets[i] -- e.g. the first stencil of the partition in a
+    /// StencilTable concatenating those of all partitions (see
+    /// StencilTableFactory::Create()). The stencils of the local points of
+    /// each partition must therefore be appended to its vertex stencils (see
+    /// StencilTableFactory::AppendLocalPointStencilTable()) : the merged table
+    /// holds no local point stencils.
+    ///
+    /// \note Patches of the same descriptor are gathered in a single array, in
+    ///       the order of the tables. Face-varying channels are not merged, and
+    ///       tables with legacy Gregory patches are rejected.
+    ///
+    /// \note End cap points shared among adjacent patches (see
+    ///       Options::shareEndCapPatchPoints) are not shared across partitions :
+    ///       disable sharing for the merged table to match that of the whole
+    ///       mesh exactly.
+    ///
+    /// @param numTables            Number of input PatchTables
+    ///
+    /// @param tables               Array of input PatchTables (null entries
+    ///                             are skipped)
+    ///
+    /// @param vertexOffsets        Offset of the control vertex indices of each
+    ///                             table (no re-indexing if null)
+    ///
+    /// @return                     A new instance of PatchTable (NULL on
+    ///                             failure)
+    ///
+    static PatchTable * Create(int numTables, PatchTable const ** tables,
+                               Index const * vertexOffsets=0);
+
+    /// \brief Updates the face-varying channels of a PatchTable in place
+    ///
+    /// Intended to follow changes to the face-varying channels of a refiner
+    /// (see TopologyRefiner::UpdateFVarChannel()) : the face-varying values of
+    /// all patches are gathered again while the vertex data of the table, and
+    /// any buffers created from it, remain valid.
+    ///
+    /// The patches are identified again to gather their values, so 'options'
+    /// must be those the table was created with (generateFVarTables is
+    /// implied).
+    ///
+    /// @param refiner              TopologyRefiner the table was created from
+    ///
+    /// @param table                PatchTable to update
+    ///
+    /// @param options              Options the table was created with
+    ///
+    /// @return                     False (and the table is left unmodified)
+    ///                             if its patches no longer match the refiner
+    ///
+    static bool UpdateFVarChannels(TopologyRefiner const & refiner,
+                                   PatchTable & table,
+                                   Options options=Options());
+
+    /// \brief Gathers the values of a face-varying channel of a PatchTable
+    ///
+    /// Tables created with Options::deferFVarChannels hold the interpolation
+    /// of their face-varying channels but no values (GetFVarValues() is empty)
+    /// until they are gathered by this method, so that the channels never
+    /// accessed are neither gathered nor stored. The faces of the patches of
+    /// adaptive tables are retained for this purpose.
+    ///
+    /// @param refiner              TopologyRefiner the table was created from
+    ///
+    /// @param table                PatchTable to gather the values of
+    ///
+    /// @param channel              Face-varying channel of the table
+    ///
+    /// @param options              Options the table was created with
+    ///
+    /// @return                     False on failure
+    ///
+    static bool BuildFVarChannel(TopologyRefiner const & refiner,
+                                 PatchTable & table, int channel,
+                                 Options options=Options());
+
+    /// \brief Reorders the faces of a uniform PatchTable for the
+    ///        post-transform vertex cache
+    ///
+    /// The faces (QUADS or TRIANGLES) of each patch array are reordered in
+    /// place (T. Forsyth's "linear-speed vertex cache optimisation"), so
+    /// that consecutive faces share the vertices recently transformed by a
+    /// GPU drawing the patch vertices as an index buffer. The patch params
+    /// and face-varying values of the faces follow their reordering.
+    ///
+    /// If 'permutation' is not null, the vertices are also renumbered in
+    /// the order of their first use by the reordered faces, so that the
+    /// vertex fetches follow the index buffer : the remapped table refers
+    /// to vertices reordered by 'permutation', which is returned to reorder
+    /// the stencils of the vertices the same way (see
+    /// StencilTableFactory::PermuteStencils()).
+    ///
+    /// \note Face-varying channels of the reordered table can no longer be
+    ///       gathered from the refiner (see UpdateFVarChannels() and
+    ///       BuildFVarChannel()) : tables with deferred channels are
+    ///       rejected.
+    ///
+    /// @param table                Uniform PatchTable to reorder
+    ///
+    /// @param permutation          Returned new index of each vertex relative
+    ///                             to 'vertexOffset' (permutation[oldIndex] ==
+    ///                             newIndex), the vertices are not renumbered
+    ///                             if null
+    ///
+    /// @param vertexOffset         Index of the first renumbered vertex
+    ///                             (typically the number of control vertices
+    ///                             if the stencils of the control vertices are
+    ///                             not in the table)
+    ///
+    /// @param cacheSize            Number of vertices of the cache
+    ///
+    /// @return                     False (and the table is left unmodified)
+    ///                             if the table can't be reordered
+    ///
+    static bool OptimizeVertexCache(PatchTable & table,
+                                    std::vector<Index> * permutation=0,
+                                    Index vertexOffset=0,
+                                    int cacheSize=32);
+
+    /// \brief Reorders the patches of a PatchTable by ptex face
+    ///
+    /// The patches of each patch array are sorted in place by the ptex face
+    /// of their PatchParam, and the patches of a face by the Morton order of
+    /// their origin within it, so that consecutive patches drawn in the order
+    /// of the table address the same or nearby ptex pages. The patch params,
+    /// single-crease sharpness, legacy Gregory quad offsets and face-varying
+    /// values of the patches follow their reordering -- the patch arrays and
+    /// the vertices (and so the stencils) are left unchanged.
+    ///
+    /// \note A PatchMap of the table must be created after the reordering.
+    ///
+    /// \note Face-varying channels of a reordered uniform table can no
+    ///       longer be gathered from the refiner : uniform tables with
+    ///       deferred channels are rejected.
+    ///
+    /// @param table                PatchTable to reorder
+    ///
+    /// @return                     False (and the table is left unmodified)
+    ///                             if the table can't be reordered
+    ///
+    static bool SortPatchesByFace(PatchTable & table);
+
 private:
     //
     // Private helper structures
     //
     struct AdaptiveContext;
+    struct PatchFaceRange;
+    struct PopulateContext;
 
     //
     //  Methods for allocating and managing the patch table data arrays:
@@ -144,7 +403,11 @@ private:
                                       Options options);
 
     static PatchTable * createAdaptive(TopologyRefiner const & refiner,
-                                       Options options);
+                                       Options options,
+                                       int isolationLevel=-1);
+
+    static PatchTable * createLoopAdaptive(TopologyRefiner const & refiner,
+                                           Options options);
 
     //
     //  High-level methods for identifying and populating patches associated with faces:
@@ -152,9 +415,19 @@ private:
 
     static void identifyAdaptivePatches(AdaptiveContext & state);
 
+    static void identifyPatchFaceRange(AdaptiveContext & state,
+                                       PatchFaceRange & range);
+
+    static void identifyPatchFaceRanges(int begin, int end, void * state);
+
     static void populateAdaptivePatches(AdaptiveContext & state,
                                         PtexIndices const &ptexIndices);
 
+    static void populatePatchFaceRange(PopulateContext & populate,
+                                       PatchFaceRange & range);
+
+    static void populatePatchFaceRanges(int begin, int end, void * populate);
+
     static void allocateVertexTables(PatchTable * table, int nlevels, bool hasSharpness);
 
     static void allocateFVarChannels(TopologyRefiner const & refiner,
@@ -165,6 +438,21 @@ private:
         int level, int face,
         int boundaryMask, int transitionMask, PatchParam * coord);
 
+    static bool uniformFVarValuesMatchVertices(TopologyRefiner const & refiner,
+        Options const & options, int refinerChannel);
+
+    static void gatherUniformFVarValues(TopologyRefiner const & refiner,
+        Options const & options, int refinerChannel, Index * values);
+
+    static void gatherDeferredFVarValues(TopologyRefiner const & refiner,
+        PatchTable const & table, int refinerChannel, Index * values);
+
+    static void buildBicubicFVarChannel(TopologyRefiner const & refiner,
+        PatchTable & table, int refinerChannel, int channel);
+
+    static void permutePatches(PatchTable & table, int array,
+        std::vector<int> const & order);
+
     static int gatherFVarData(AdaptiveContext & state,
         int level, Index faceIndex, Index levelFaceOffset, int rotation,
                               Index const * levelOffsets, Index fofss, Index ** fptrs);
@@ -0,0 +1,148 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_PRIMVAR_BUFFERS_H
+#define OPENSUBDIV3_FAR_PRIMVAR_BUFFERS_H
+
+#include "../version.h"
+
+#include <cassert>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+///  \brief A set of float primvar buffers interpolated in a single pass
+///
+/// PrimvarBuffers bundles several buffers of float data (positions, normals,
+/// uvs, ...) so that they can be passed as a single source or destination to
+/// the interpolation methods of PrimvarRefiner (see \ref templating) : the
+/// topology of each level is traversed and the weights of each refined
+/// vertex are computed only once, then applied to all the buffers.
+///
+/// Each buffer is described by a pointer to the data of its first element,
+/// the number of floats of each element and the stride (in floats) between
+/// consecutive elements. Interleaved layouts are described by offsetting the
+/// pointer to the first primvar of the interleaved vertex.
+///
+/// The source and destination sets passed to PrimvarRefiner must describe
+/// the same number of buffers, with matching lengths.
+///
+/// \code{.cpp}
+///
+///       Far::PrimvarBuffers src, dst;
+///       src.AddBuffer(&positions[0], 3, 3);
+///       src.AddBuffer(&uvs[0], 2, 2);
+///       dst.AddBuffer(&positions[nCoarseVerts*3], 3, 3);
+///       dst.AddBuffer(&uvs[nCoarseVerts*2], 2, 2);
+///
+///       primvarRefiner.Interpolate(1, src, dst);
+///
+/// \endcode
+///
+class PrimvarBuffers {
+
+public:
+
+    class Element;
+
+    PrimvarBuffers() { }
+
+    /// \brief Adds a buffer of 'length' floats per element, 'stride' floats
+    ///        apart
+    void AddBuffer(float * data, int length, int stride) {
+        Buffer buffer = { data, length, stride };
+        _buffers.push_back(buffer);
+    }
+
+    /// \brief Returns the number of buffers of the set
+    int GetNumBuffers() const { return (int)_buffers.size(); }
+
+    /// \brief Returns the element 'index' of all the buffers
+    Element operator[](int index) const { return Element(*this, index); }
+
+    /// \brief The element of the same index in all the buffers of a set
+    class Element {
+
+    public:
+
+        void Clear() {
+            for (int i = 0; i < _set.GetNumBuffers(); ++i) {
+                Buffer const & buffer = _set._buffers[i];
+
+                float * d = buffer.data + _index * buffer.stride;
+                for (int k = 0; k < buffer.length; ++k) {
+                    d[k] = 0.0f;
+                }
+            }
+        }
+
+        void AddWithWeight(Element const & src, float weight) {
+            assert(src._set.GetNumBuffers() == _set.GetNumBuffers());
+
+            for (int i = 0; i < _set.GetNumBuffers(); ++i) {
+                Buffer const & buffer    = _set._buffers[i],
+                             & srcBuffer = src._set._buffers[i];
+                assert(srcBuffer.length == buffer.length);
+
+                float       * d = buffer.data + _index * buffer.stride;
+                float const * s = srcBuffer.data + src._index * srcBuffer.stride;
+                for (int k = 0; k < buffer.length; ++k) {
+                    d[k] += weight * s[k];
+                }
+            }
+        }
+
+    private:
+        friend class PrimvarBuffers;
+
+        Element(PrimvarBuffers const & set, int index) : _set(set), _index(index) { }
+
+        PrimvarBuffers const & _set;
+        int                    _index;
+    };
+
+private:
+
+    struct Buffer {
+        float * data;
+        int     length,
+                stride;
+    };
+
+    std::vector<Buffer> _buffers;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_PRIMVAR_BUFFERS_H
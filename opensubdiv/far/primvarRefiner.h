@@ -39,10 +39,14 @@
 #include "../vtr/componentInterfaces.h"
 #include "../far/types.h"
 #include "../far/error.h"
+#include "../far/hierarchicalEdits.h"
+#include "../far/taskScheduler.h"
 #include "../far/topologyLevel.h"
 #include "../far/topologyRefiner.h"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -56,11 +60,34 @@ namespace Far {
 class PrimvarRefiner {
 
 public:
-    PrimvarRefiner(TopologyRefiner const & refiner) : _refiner(refiner) { }
+    /// \brief Constructor
+    ///
+    /// @param refiner           The refined topology
+    ///
+    /// @param cacheVertexMasks  Record the vertex interpolation weights of each
+    ///                          level the first time it is interpolated, and
+    ///                          apply the recorded weights to the following
+    ///                          calls to Interpolate() (see ClearVertexMasks()).
+    ///                          The limit weights of the last level are
+    ///                          likewise recorded by the first call to Limit()
+    ///
+    PrimvarRefiner(TopologyRefiner const & refiner, bool cacheVertexMasks = false) :
+        _refiner(refiner), _cacheVertexMasks(cacheVertexMasks) { }
     ~PrimvarRefiner() { }
 
     TopologyRefiner const & GetTopologyRefiner() const { return _refiner; }
 
+    /// \brief Returns true if the vertex interpolation weights are cached
+    bool IsCachingVertexMasks() const { return _cacheVertexMasks; }
+
+    /// \brief Releases the cached vertex interpolation weights -- they must be
+    ///        released when the topology or the sharpness of the refiner change
+    void ClearVertexMasks() { _vertexMasks.clear(); _limitMasks = LimitMasks(); }
+
+    /// \brief Returns the memory held by the cached vertex interpolation and
+    ///        limit weights
+    MemoryUsage GetVertexMasksMemoryUsage() const;
+
     //@{
     ///  @name Primvar data interpolation
     ///
@@ -94,6 +121,10 @@ public:
     ///       reference: this allows to work transparently with arrays and
     ///       containers (or other scheme that overload the '[]' operator)
     ///       <br><br>
+    ///       Several float buffers can be interpolated in a single pass with
+    ///       Far::PrimvarBuffers (see far/primvarBuffers.h) : the weights of
+    ///       each refined vertex are then computed once for all the buffers.
+    ///       <br><br>
     ///       See the <a href=http://graphics.pixar.com/opensubdiv/docs/tutorials.html>
     ///       Far tutorials</a> for code examples.
     ///
@@ -110,6 +141,10 @@ public:
     ///
     /// @param dst    Destination primvar buffer (\ref templating refined vertex data)
     ///
+    /// \note When caching vertex masks, the weights of the level are recorded
+    ///       by the first call (which is then not thread-safe) and applied by
+    ///       the following ones without querying the topology of the level.
+    ///
     template <class T, class U> void Interpolate(int level, T const & src, U & dst) const;
 
     /// \brief Apply only varying interpolation weights to a primvar buffer
@@ -129,6 +164,21 @@ public:
     ///
     template <class T, class U> void InterpolateVarying(int level, T const & src, U & dst) const;
 
+    /// \brief Apply the vertex edits of a level to its interpolated primvar data
+    ///
+    /// Vertex edits of the hierarchical edits of the refiner modify the data of
+    /// a level once it is interpolated, and before the next level is
+    /// interpolated from it (see TopologyRefiner::SetHierarchicalEdits()).
+    ///
+    /// @param level   The level edited (the base level included)
+    ///
+    /// @param values  Value of each vertex edit, as indexed by
+    ///                HierarchicalEdits::GetEditValueIndex() (\ref templating)
+    ///
+    /// @param dst     Primvar buffer of the level (\ref templating refined vertex data)
+    ///
+    template <class T, class U> void ApplyVertexEdits(int level, T const & values, U & dst) const;
+
     /// \brief Refine uniform (per-face) primvar data between levels.
     ///
     /// Data is simply copied from a parent face to its child faces and does not involve
@@ -181,30 +231,196 @@ public:
 
     //@}
 
+    //@{
+    ///  @name Concurrent primvar data interpolation
+    ///
+    /// Variants of the methods above partitioning the components of a level
+    /// into ranges that are interpolated concurrently by a TaskScheduler.
+    /// Child vertices originating from parent faces are interpolated before
+    /// those originating from edges and vertices, which depend on them.
+    ///
+    /// \note Ranges are interpolated by several threads at once : accessing
+    ///       distinct elements of the source and destination buffers (and
+    ///       applying AddWithWeight() to them) must be thread-safe.
+    ///
+
+    /// \brief Concurrent variant of Interpolate()
+    template <class T, class U>
+    void Interpolate(int level, T const & src, U & dst, TaskScheduler const & scheduler) const;
+
+    /// \brief Concurrent variant of InterpolateVarying()
+    template <class T, class U>
+    void InterpolateVarying(int level, T const & src, U & dst, TaskScheduler const & scheduler) const;
+
+    /// \brief Concurrent variant of InterpolateFaceVarying()
+    template <class T, class U>
+    void InterpolateFaceVarying(int level, T const & src, U & dst, int channel,
+                                TaskScheduler const & scheduler) const;
+
+    /// \brief Concurrent variants of Limit()
+    template <class T, class U>
+    void Limit(T const & src, U & dstPos, TaskScheduler const & scheduler) const;
+
+    template <class T, class U, class U1, class U2>
+    void Limit(T const & src, U & dstPos, U1 & dstTan1, U2 & dstTan2,
+               TaskScheduler const & scheduler) const;
+
+    /// \brief Concurrent variant of LimitFaceVarying()
+    template <class T, class U>
+    void LimitFaceVarying(T const & src, U & dst, int channel,
+                          TaskScheduler const & scheduler) const;
+
+    //@}
+
 private:
 
     //  Non-copyable:
-    PrimvarRefiner(PrimvarRefiner const & src) : _refiner(src._refiner) { }
+    PrimvarRefiner(PrimvarRefiner const & src) : _refiner(src._refiner), _cacheVertexMasks(false) { }
     PrimvarRefiner & operator=(PrimvarRefiner const &) { return *this; }
 
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromFaces(int, T const &, U &) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromEdges(int, T const &, U &) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromVerts(int, T const &, U &) const;
+    //  Interpolation of the child vertices originating from a range of parent faces,
+    //  edges or vertices (all when end < 0) -- the stencil factories use these to
+    //  interpolate the vertices of a level concurrently:
+    friend class StencilTableFactory;
+
+    template <class T, class U> void interpolateFromFaces(int level, T const & src, U & dst, int begin, int end) const;
+    template <class T, class U> void interpolateFromEdges(int level, T const & src, U & dst, int begin, int end) const;
+    template <class T, class U> void interpolateFromVerts(int level, T const & src, U & dst, int begin, int end) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromFaces(int, T const &, U &, int begin = 0, int end = -1) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromEdges(int, T const &, U &, int begin = 0, int end = -1) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromVerts(int, T const &, U &, int begin = 0, int end = -1) const;
 
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromFaces(int, T const &, U &, int) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromEdges(int, T const &, U &, int) const;
-    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromVerts(int, T const &, U &, int) const;
+    template <class T, class U> void interpVaryingFromFaces(int, T const &, U &, int begin = 0, int end = -1) const;
+    template <class T, class U> void interpVaryingFromEdges(int, T const &, U &, int begin = 0, int end = -1) const;
+    template <class T, class U> void interpVaryingFromVerts(int, T const &, U &, int begin = 0, int end = -1) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromFaces(int, T const &, U &, int, int begin = 0, int end = -1) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromEdges(int, T const &, U &, int, int begin = 0, int end = -1) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromVerts(int, T const &, U &, int, int begin = 0, int end = -1) const;
 
     template <Sdc::SchemeType SCHEME, class T, class U, class U1, class U2>
-    void limit(T const & src, U & pos, U1 * tan1, U2 * tan2) const;
+    void limit(T const & src, U & pos, U1 * tan1, U2 * tan2, int begin = 0, int end = -1) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U>
+    void limitFVar(T const & src, U & dst, int channel, int begin = 0, int end = -1) const;
+
+    //  Cached vertex masks -- the operations applied to the vertices of a level by
+    //  Interpolate(), in order.  Child vertices computed from other child vertices
+    //  of the same level (e.g. face-vertices contributing to vertex-vertices) are
+    //  referenced by the complement of their index, and Clear() operations by an
+    //  invalid source index:
+    struct VertexMasks {
+        std::vector<Index> dstIndices;
+        std::vector<Index> srcIndices;
+        std::vector<float> weights;
+    };
+
+    class VertexMaskRecorder {
+    public:
+        VertexMaskRecorder(VertexMasks * masks, bool child) : _masks(masks), _child(child) { }
+
+        class Vertex {
+        public:
+            Vertex(VertexMasks * masks, Index index, bool child) :
+                _masks(masks), _index(index), _child(child) { }
+
+            void Clear() { record(INDEX_INVALID, 0.0f); }
+
+            void AddWithWeight(Vertex const & src, float weight) {
+                record(src._child ? ~src._index : src._index, weight);
+            }
+
+        private:
+            void record(Index srcIndex, float weight) {
+                assert(_child);
+                _masks->dstIndices.push_back(_index);
+                _masks->srcIndices.push_back(srcIndex);
+                _masks->weights.push_back(weight);
+            }
+
+            VertexMasks * _masks;
+            Index         _index;
+            bool          _child;
+        };
+
+        Vertex operator[](int index) const { return Vertex(_masks, index, _child); }
+
+    private:
+        VertexMasks * _masks;
+        bool          _child;
+    };
+
+    void recordVertexMasks(int level) const;
+
+    template <class T, class U>
+    void applyVertexMasks(VertexMasks const & masks, T const & src, U & dst) const;
+
+    //  Cached limit masks -- the vertices supporting the limit of each vertex of
+    //  the last level (opposite face-vertices, edge-vertices and the vertex itself)
+    //  and their position and tangent weights, padded with zeros to the same size.
+    //  Regular vertices all share the weights of the first one recorded:
+    struct LimitMasks {
+        std::vector<int>   offsets;        // first index of each vertex, and the end
+        std::vector<int>   weightOffsets;  // first weight of each vertex
+        std::vector<Index> indices;
+        std::vector<float> weights;        // position, 1st and 2nd tangent weights
+    };
+
+    void recordLimitMasks() const;
+
+    template <Sdc::SchemeType SCHEME> void recordLimitMasks() const;
+
+    template <class T, class U, class U1, class U2>
+    void applyLimitMasks(T const & src, U & pos, U1 * tan1, U2 * tan2, int begin = 0, int end = -1) const;
+
+    //  Concurrent interpolation -- the components of a level (the parent faces, edges
+    //  or vertices of a refined level, or the vertices of the last level for the limit)
+    //  are partitioned into ranges by the scheduler and passed to one of the kernels:
+    template <class T, class U, class U1, class U2>
+    struct RangeData {
+        PrimvarRefiner const * primvarRefiner;
+
+        int level,
+            channel,
+            parentType;  // 0 = faces, 1 = edges, 2 = vertices
+
+        T const * src;
+        U *       dst;
+        U1 *      tan1;
+        U2 *      tan2;
+    };
+
+    template <class T, class U, class U1, class U2>
+    void interpolateConcurrently(RangeData<T,U,U1,U2> & data, TaskScheduler::RangeKernel kernel,
+                                 TaskScheduler const & scheduler) const;
+
+    static int getRangeSize(int numItems, TaskScheduler const & scheduler) {
+        return std::max(1024, numItems / (4 * scheduler.GetNumThreads()) + 1);
+    }
+
+    template <class T, class U> static void interpolateRanges(int begin, int end, void * data);
+    template <class T, class U> static void interpolateVaryingRanges(int begin, int end, void * data);
+    template <class T, class U> static void interpolateFVarRanges(int begin, int end, void * data);
+
+    template <class T, class U, class U1, class U2>
+    static void limitRanges(int begin, int end, void * data);
+
+    template <class T, class U> static void limitFVarRanges(int begin, int end, void * data);
 
     template <Sdc::SchemeType SCHEME, class T, class U>
-    void limitFVar(T const & src, U * dst, int channel) const;
+    void interpFVarFromParents(int parentType, int level, T const & src, U & dst, int channel,
+                               int begin, int end) const;
 
 private:
 
     TopologyRefiner const &  _refiner;
 
+    bool _cacheVertexMasks;
+
+    mutable std::vector<VertexMasks> _vertexMasks;  // cached masks of each level
+    mutable LimitMasks               _limitMasks;   // cached limit masks of the last level
+
 private:
     //
     //  Local class to fulfil interface for <typename MASK> in the Scheme mask queries:
@@ -267,6 +483,48 @@ PrimvarRefiner::Interpolate(int level, T const & src, U & dst) const {
 
     assert(level>0 and level<=(int)_refiner._refinements.size());
 
+    if (_cacheVertexMasks) {
+        if ((int)_vertexMasks.size() <= level or _vertexMasks[level].weights.empty()) {
+            recordVertexMasks(level);
+        }
+        applyVertexMasks(_vertexMasks[level], src, dst);
+        return;
+    }
+
+    switch (_refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        interpFromFaces<Sdc::SCHEME_CATMARK>(level, src, dst);
+        interpFromEdges<Sdc::SCHEME_CATMARK>(level, src, dst);
+        interpFromVerts<Sdc::SCHEME_CATMARK>(level, src, dst);
+        break;
+    case Sdc::SCHEME_LOOP:
+        interpFromFaces<Sdc::SCHEME_LOOP>(level, src, dst);
+        interpFromEdges<Sdc::SCHEME_LOOP>(level, src, dst);
+        interpFromVerts<Sdc::SCHEME_LOOP>(level, src, dst);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        interpFromFaces<Sdc::SCHEME_BILINEAR>(level, src, dst);
+        interpFromEdges<Sdc::SCHEME_BILINEAR>(level, src, dst);
+        interpFromVerts<Sdc::SCHEME_BILINEAR>(level, src, dst);
+        break;
+    }
+}
+
+inline void
+PrimvarRefiner::recordVertexMasks(int level) const {
+
+    if ((int)_vertexMasks.size() <= level) {
+        _vertexMasks.resize(level + 1);
+    }
+    VertexMasks & masks = _vertexMasks[level];
+
+    masks.dstIndices.clear();
+    masks.srcIndices.clear();
+    masks.weights.clear();
+
+    VertexMaskRecorder src(&masks, false),
+                       dst(&masks, true);
+
     switch (_refiner._subdivType) {
     case Sdc::SCHEME_CATMARK:
         interpFromFaces<Sdc::SCHEME_CATMARK>(level, src, dst);
@@ -286,6 +544,275 @@ PrimvarRefiner::Interpolate(int level, T const & src, U & dst) const {
     }
 }
 
+template <class T, class U>
+inline void
+PrimvarRefiner::applyVertexMasks(VertexMasks const & masks, T const & src, U & dst) const {
+
+    int numOps = (int)masks.weights.size();
+
+    Index const * dstIndices = numOps ? &masks.dstIndices[0] : 0,
+                * srcIndices = numOps ? &masks.srcIndices[0] : 0;
+    float const * weights    = numOps ? &masks.weights[0] : 0;
+
+    for (int i = 0; i < numOps; ++i) {
+        Index srcIndex = srcIndices[i];
+        if (srcIndex == INDEX_INVALID) {
+            dst[dstIndices[i]].Clear();
+        } else if (srcIndex >= 0) {
+            dst[dstIndices[i]].AddWithWeight(src[srcIndex], weights[i]);
+        } else {
+            dst[dstIndices[i]].AddWithWeight(dst[~srcIndex], weights[i]);
+        }
+    }
+}
+
+inline MemoryUsage
+PrimvarRefiner::GetVertexMasksMemoryUsage() const {
+
+    MemoryUsage usage;
+    for (int i = 0; i < (int)_vertexMasks.size(); ++i) {
+        usage.Add(_vertexMasks[i].dstIndices);
+        usage.Add(_vertexMasks[i].srcIndices);
+        usage.Add(_vertexMasks[i].weights);
+    }
+    usage.Add(_limitMasks.offsets);
+    usage.Add(_limitMasks.weightOffsets);
+    usage.Add(_limitMasks.indices);
+    usage.Add(_limitMasks.weights);
+    return usage;
+}
+
+inline void
+PrimvarRefiner::recordLimitMasks() const {
+
+    switch (_refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:  recordLimitMasks<Sdc::SCHEME_CATMARK>();  break;
+    case Sdc::SCHEME_LOOP:     recordLimitMasks<Sdc::SCHEME_LOOP>();     break;
+    case Sdc::SCHEME_BILINEAR: recordLimitMasks<Sdc::SCHEME_BILINEAR>(); break;
+    }
+}
+
+template <Sdc::SchemeType SCHEME>
+inline void
+PrimvarRefiner::recordLimitMasks() const {
+
+    Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
+
+    Vtr::internal::Level const & level = _refiner.getLevel(_refiner.GetMaxLevel());
+
+    int numVertices = level.getNumVertices(),
+        regularValence = Sdc::Scheme<SCHEME>::GetRegularVertexValence(),
+        maxWeightsPerMask = 1 + 2 * level.getMaxValence();
+
+    LimitMasks & masks = _limitMasks;
+
+    masks = LimitMasks();
+    masks.offsets.reserve(numVertices + 1);
+    masks.weightOffsets.reserve(numVertices);
+    masks.indices.reserve(numVertices * (1 + 2 * regularValence));
+
+    Vtr::internal::StackBuffer<float,99> weightBuffer(3 * maxWeightsPerMask);
+
+    float * vPosWeights = weightBuffer,
+          * ePosWeights = vPosWeights + 1,
+          * fPosWeights = ePosWeights + level.getMaxValence();
+
+    Mask posMask( vPosWeights,  ePosWeights,  fPosWeights);
+    Mask tan1Mask(vPosWeights + maxWeightsPerMask, ePosWeights + maxWeightsPerMask,
+                  fPosWeights + maxWeightsPerMask);
+    Mask tan2Mask(vPosWeights + 2 * maxWeightsPerMask, ePosWeights + 2 * maxWeightsPerMask,
+                  fPosWeights + 2 * maxWeightsPerMask);
+
+    Vtr::internal::VertexInterface vHood(level, level);
+
+    //  The weights shared by all the regular vertices, with their number of face
+    //  and edge weights, and those of the vertices left at their refined location:
+    int regularWeights = -1, regularNumFaces = 0, regularNumEdges = 0,
+        identityWeights = -1;
+
+    for (int vert = 0; vert < numVertices; ++vert) {
+        ConstIndexArray vEdges = level.getVertexEdges(vert);
+
+        masks.offsets.push_back((int)masks.indices.size());
+
+        Vtr::internal::Level::VTag vTag = level.getVertexTag(vert);
+        if (vTag._incomplete || (vEdges.size() == 0)) {
+            if (identityWeights < 0) {
+                identityWeights = (int)masks.weights.size();
+                masks.weights.push_back(1.0f);
+                masks.weights.push_back(0.0f);
+                masks.weights.push_back(0.0f);
+            }
+            masks.weightOffsets.push_back(identityWeights);
+            masks.indices.push_back(vert);
+            continue;
+        }
+
+        Sdc::Crease::Rule vRule = level.getVertexRule(vert);
+
+        bool isRegular = (vRule == Sdc::Crease::RULE_SMOOTH) && !vTag._boundary &&
+                         !vTag._nonManifold && (vEdges.size() == regularValence) &&
+                         (level.getVertexFaces(vert).size() == regularValence);
+
+        int numFaces = 0, numEdges = 0;
+        if (isRegular && (regularWeights >= 0)) {
+            numFaces = regularNumFaces;
+            numEdges = regularNumEdges;
+            masks.weightOffsets.push_back(regularWeights);
+        } else {
+            vHood.SetIndex(vert, vert);
+            scheme.ComputeVertexLimitMask(vHood, posMask, tan1Mask, tan2Mask, vRule);
+
+            assert(tan1Mask.GetNumFaceWeights() == tan2Mask.GetNumFaceWeights());
+            assert(tan1Mask.GetNumEdgeWeights() == tan2Mask.GetNumEdgeWeights());
+
+            numFaces = std::max(posMask.GetNumFaceWeights(), tan1Mask.GetNumFaceWeights());
+            numEdges = std::max(posMask.GetNumEdgeWeights(), tan1Mask.GetNumEdgeWeights());
+
+            //  Append the face, edge and vertex weights of each mask, in the
+            //  order they are applied, padding the smaller masks with zeros:
+            int weightOffset = (int)masks.weights.size();
+            masks.weightOffsets.push_back(weightOffset);
+
+            Mask const * vMasks[3] = { &posMask, &tan1Mask, &tan2Mask };
+            for (int m = 0; m < 3; ++m) {
+                Mask const & mask = *vMasks[m];
+                for (int i = 0; i < numFaces; ++i) {
+                    masks.weights.push_back(
+                        (i < mask.GetNumFaceWeights()) ? mask.FaceWeight(i) : 0.0f);
+                }
+                for (int i = 0; i < numEdges; ++i) {
+                    masks.weights.push_back(
+                        (i < mask.GetNumEdgeWeights()) ? mask.EdgeWeight(i) : 0.0f);
+                }
+                masks.weights.push_back(mask.VertexWeight(0));
+            }
+            if (isRegular) {
+                regularWeights  = weightOffset;
+                regularNumFaces = numFaces;
+                regularNumEdges = numEdges;
+            }
+        }
+
+        //  Gather the opposite vertices of the incident faces, then those of the
+        //  incident edges, followed by the vertex itself:
+        if (numFaces) {
+            ConstIndexArray      vFaces = level.getVertexFaces(vert);
+            ConstLocalIndexArray vInFace = level.getVertexFaceLocalIndices(vert);
+
+            for (int i = 0; i < numFaces; ++i) {
+                ConstIndexArray fVerts = level.getFaceVertices(vFaces[i]);
+
+                LocalIndex vOppInFace = (vInFace[i] + 2);
+                if (vOppInFace >= fVerts.size()) vOppInFace -= (LocalIndex)fVerts.size();
+
+                masks.indices.push_back(fVerts[vOppInFace]);
+            }
+        }
+        for (int i = 0; i < numEdges; ++i) {
+            ConstIndexArray eVerts = level.getEdgeVertices(vEdges[i]);
+
+            masks.indices.push_back((eVerts[0] == vert) ? eVerts[1] : eVerts[0]);
+        }
+        masks.indices.push_back(vert);
+    }
+    masks.offsets.push_back((int)masks.indices.size());
+}
+
+template <class T, class U, class U1, class U2>
+inline void
+PrimvarRefiner::applyLimitMasks(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Ptr,
+                                int begin, int end) const {
+
+    LimitMasks const & masks = _limitMasks;
+
+    bool hasTangents = (dstTan1Ptr && dstTan2Ptr);
+
+    if (end < 0) end = (int)masks.weightOffsets.size();
+
+    for (int vert = begin; vert < end; ++vert) {
+        int           numWeights = masks.offsets[vert + 1] - masks.offsets[vert];
+        Index const * indices = &masks.indices[masks.offsets[vert]];
+        float const * weights = &masks.weights[masks.weightOffsets[vert]];
+
+        dstPos[vert].Clear();
+        for (int i = 0; i < numWeights; ++i) {
+            dstPos[vert].AddWithWeight(src[indices[i]], weights[i]);
+        }
+        if (hasTangents) {
+            U1 & dstTan1 = *dstTan1Ptr;
+            U2 & dstTan2 = *dstTan2Ptr;
+
+            float const * tan1Weights = weights + numWeights,
+                        * tan2Weights = tan1Weights + numWeights;
+
+            dstTan1[vert].Clear();
+            dstTan2[vert].Clear();
+            for (int i = 0; i < numWeights; ++i) {
+                dstTan1[vert].AddWithWeight(src[indices[i]], tan1Weights[i]);
+                dstTan2[vert].AddWithWeight(src[indices[i]], tan2Weights[i]);
+            }
+        }
+    }
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::interpolateFromFaces(int level, T const & src, U & dst, int begin, int end) const {
+
+    assert(level>0 and level<=(int)_refiner._refinements.size());
+
+    switch (_refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        interpFromFaces<Sdc::SCHEME_CATMARK>(level, src, dst, begin, end);
+        break;
+    case Sdc::SCHEME_LOOP:
+        interpFromFaces<Sdc::SCHEME_LOOP>(level, src, dst, begin, end);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        interpFromFaces<Sdc::SCHEME_BILINEAR>(level, src, dst, begin, end);
+        break;
+    }
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::interpolateFromEdges(int level, T const & src, U & dst, int begin, int end) const {
+
+    assert(level>0 and level<=(int)_refiner._refinements.size());
+
+    switch (_refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        interpFromEdges<Sdc::SCHEME_CATMARK>(level, src, dst, begin, end);
+        break;
+    case Sdc::SCHEME_LOOP:
+        interpFromEdges<Sdc::SCHEME_LOOP>(level, src, dst, begin, end);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        interpFromEdges<Sdc::SCHEME_BILINEAR>(level, src, dst, begin, end);
+        break;
+    }
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::interpolateFromVerts(int level, T const & src, U & dst, int begin, int end) const {
+
+    assert(level>0 and level<=(int)_refiner._refinements.size());
+
+    switch (_refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        interpFromVerts<Sdc::SCHEME_CATMARK>(level, src, dst, begin, end);
+        break;
+    case Sdc::SCHEME_LOOP:
+        interpFromVerts<Sdc::SCHEME_LOOP>(level, src, dst, begin, end);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        interpFromVerts<Sdc::SCHEME_BILINEAR>(level, src, dst, begin, end);
+        break;
+    }
+}
+
 template <class T, class U>
 inline void
 PrimvarRefiner::InterpolateFaceVarying(int level, T const & src, U & dst, int channel) const {
@@ -322,6 +849,14 @@ PrimvarRefiner::Limit(T const & src, U & dst) const {
         return;
     }
 
+    if (_cacheVertexMasks) {
+        if (_limitMasks.offsets.empty()) {
+            recordLimitMasks();
+        }
+        applyLimitMasks(src, dst, (U*)0, (U*)0);
+        return;
+    }
+
     switch (_refiner._subdivType) {
     case Sdc::SCHEME_CATMARK:
         limit<Sdc::SCHEME_CATMARK>(src, dst, (U*)0, (U*)0);
@@ -346,6 +881,14 @@ PrimvarRefiner::Limit(T const & src, U & dstPos, U1 & dstTan1, U2 & dstTan2) con
         return;
     }
 
+    if (_cacheVertexMasks) {
+        if (_limitMasks.offsets.empty()) {
+            recordLimitMasks();
+        }
+        applyLimitMasks(src, dstPos, &dstTan1, &dstTan2);
+        return;
+    }
+
     switch (_refiner._subdivType) {
     case Sdc::SCHEME_CATMARK:
         limit<Sdc::SCHEME_CATMARK>(src, dstPos, &dstTan1, &dstTan2);
@@ -406,33 +949,93 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
 
     assert(level>0 and level<=(int)_refiner._refinements.size());
 
+    interpVaryingFromFaces(level, src, dst);
+    interpVaryingFromEdges(level, src, dst);
+    interpVaryingFromVerts(level, src, dst);
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::ApplyVertexEdits(int level, T const & values, U & dst) const {
+
+    HierarchicalEdits const * edits = _refiner.GetHierarchicalEdits();
+    if (not edits) return;
+
+    assert(level>=0 and level<=(int)_refiner._refinements.size());
+
+    Vtr::internal::Level const & vtrLevel = _refiner.getLevel(level);
+
+    for (int i = 0; i < edits->GetNumEdits(); ++i) {
+        if ((edits->GetEditLevel(i) != level) or
+            (edits->GetEditType(i) != HierarchicalEdits::VERTEX)) continue;
+
+        Vtr::Index face = _refiner.findEditFace(i);
+        if (not Vtr::IndexIsValid(face)) continue;
+
+        ConstIndexArray fVerts = vtrLevel.getFaceVertices(face);
+
+        LocalIndex vertex = edits->GetEditComponent(i);
+        if (vertex >= fVerts.size()) continue;
+
+        int value = edits->GetEditValueIndex(i);
+        switch (edits->GetEditOperation(i)) {
+            case HierarchicalEdits::ADD:
+                dst[fVerts[vertex]].AddWithWeight(values[value], 1.0f);
+                break;
+            case HierarchicalEdits::SUBTRACT:
+                dst[fVerts[vertex]].AddWithWeight(values[value], -1.0f);
+                break;
+            default:
+                dst[fVerts[vertex]].Clear();
+                dst[fVerts[vertex]].AddWithWeight(values[value], 1.0f);
+                break;
+        }
+    }
+}
+
+//
+//  Varying interpolation of the child vertices of ranges of parent faces, edges and
+//  vertices -- note that there may be none originating from faces:
+//
+template <class T, class U>
+inline void
+PrimvarRefiner::interpVaryingFromFaces(int level, T const & src, U & dst, int begin, int end) const {
+
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
 
-    //
-    //  Group values to interolate based on origin -- note that there may
-    //  be none originating from faces:
-    //
-    if (refinement.getNumChildVerticesFromFaces() > 0) {
+    if (refinement.getNumChildVerticesFromFaces() == 0) return;
 
-        for (int face = 0; face < parent.getNumFaces(); ++face) {
+    if (end < 0) end = parent.getNumFaces();
 
-            Vtr::Index cVert = refinement.getFaceChildVertex(face);
-            if (Vtr::IndexIsValid(cVert)) {
+    for (int face = begin; face < end; ++face) {
 
-                //  Apply the weights to the parent face's vertices:
-                ConstIndexArray fVerts = parent.getFaceVertices(face);
+        Vtr::Index cVert = refinement.getFaceChildVertex(face);
+        if (Vtr::IndexIsValid(cVert)) {
 
-                float fVaryingWeight = 1.0f / (float) fVerts.size();
+            //  Apply the weights to the parent face's vertices:
+            ConstIndexArray fVerts = parent.getFaceVertices(face);
 
-                dst[cVert].Clear();
-                for (int i = 0; i < fVerts.size(); ++i) {
-                    dst[cVert].AddWithWeight(src[fVerts[i]], fVaryingWeight);
-                }
+            float fVaryingWeight = 1.0f / (float) fVerts.size();
+
+            dst[cVert].Clear();
+            for (int i = 0; i < fVerts.size(); ++i) {
+                dst[cVert].AddWithWeight(src[fVerts[i]], fVaryingWeight);
             }
         }
     }
-    for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::interpVaryingFromEdges(int level, T const & src, U & dst, int begin, int end) const {
+
+    Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
+    Vtr::internal::Level const &      parent     = refinement.parent();
+
+    if (end < 0) end = parent.getNumEdges();
+
+    for (int edge = begin; edge < end; ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
         if (Vtr::IndexIsValid(cVert)) {
@@ -445,7 +1048,18 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
             dst[cVert].AddWithWeight(src[eVerts[1]], 0.5f);
         }
     }
-    for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::interpVaryingFromVerts(int level, T const & src, U & dst, int begin, int end) const {
+
+    Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
+    Vtr::internal::Level const &      parent     = refinement.parent();
+
+    if (end < 0) end = parent.getNumVertices();
+
+    for (int vert = begin; vert < end; ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
         if (Vtr::IndexIsValid(cVert)) {
@@ -458,13 +1072,278 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
 }
 
 
+//
+//  Concurrent entry points -- the components of the level are partitioned by the
+//  scheduler and passed to the kernels below, which apply the same internal methods
+//  as above to each range:
+//
+template <class T, class U>
+inline void
+PrimvarRefiner::Interpolate(int level, T const & src, U & dst,
+                            TaskScheduler const & scheduler) const {
+
+    assert(level>0 and level<=(int)_refiner._refinements.size());
+
+    RangeData<T,U,U,U> data;
+    data.level = level;
+    data.src = &src;
+    data.dst = &dst;
+
+    interpolateConcurrently(data, interpolateRanges<T,U>, scheduler);
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst,
+                                   TaskScheduler const & scheduler) const {
+
+    assert(level>0 and level<=(int)_refiner._refinements.size());
+
+    RangeData<T,U,U,U> data;
+    data.level = level;
+    data.src = &src;
+    data.dst = &dst;
+
+    interpolateConcurrently(data, interpolateVaryingRanges<T,U>, scheduler);
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::InterpolateFaceVarying(int level, T const & src, U & dst, int channel,
+                                       TaskScheduler const & scheduler) const {
+
+    assert(level>0 and level<=(int)_refiner._refinements.size());
+
+    RangeData<T,U,U,U> data;
+    data.level = level;
+    data.channel = channel;
+    data.src = &src;
+    data.dst = &dst;
+
+    interpolateConcurrently(data, interpolateFVarRanges<T,U>, scheduler);
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::Limit(T const & src, U & dstPos, TaskScheduler const & scheduler) const {
+
+    if (_refiner.getLevel(_refiner.GetMaxLevel()).getNumVertexEdgesTotal() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PrimvarRefiner::Limit() -- "
+            "last level of refinement does not include full topology.");
+        return;
+    }
+
+    if (_cacheVertexMasks and _limitMasks.offsets.empty()) {
+        recordLimitMasks();
+    }
+
+    RangeData<T,U,U,U> data;
+    data.primvarRefiner = this;
+    data.src = &src;
+    data.dst = &dstPos;
+    data.tan1 = 0;
+    data.tan2 = 0;
+
+    int numVertices = _refiner.getLevel(_refiner.GetMaxLevel()).getNumVertices();
+
+    scheduler.ParallelFor(0, numVertices, getRangeSize(numVertices, scheduler),
+        limitRanges<T,U,U,U>, &data);
+}
+
+template <class T, class U, class U1, class U2>
+inline void
+PrimvarRefiner::Limit(T const & src, U & dstPos, U1 & dstTan1, U2 & dstTan2,
+                      TaskScheduler const & scheduler) const {
+
+    if (_refiner.getLevel(_refiner.GetMaxLevel()).getNumVertexEdgesTotal() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PrimvarRefiner::Limit() -- "
+            "last level of refinement does not include full topology.");
+        return;
+    }
+
+    if (_cacheVertexMasks and _limitMasks.offsets.empty()) {
+        recordLimitMasks();
+    }
+
+    RangeData<T,U,U1,U2> data;
+    data.primvarRefiner = this;
+    data.src = &src;
+    data.dst = &dstPos;
+    data.tan1 = &dstTan1;
+    data.tan2 = &dstTan2;
+
+    int numVertices = _refiner.getLevel(_refiner.GetMaxLevel()).getNumVertices();
+
+    scheduler.ParallelFor(0, numVertices, getRangeSize(numVertices, scheduler),
+        limitRanges<T,U,U1,U2>, &data);
+}
+
+template <class T, class U>
+inline void
+PrimvarRefiner::LimitFaceVarying(T const & src, U & dst, int channel,
+                                 TaskScheduler const & scheduler) const {
+
+    if (_refiner.getLevel(_refiner.GetMaxLevel()).getNumVertexEdgesTotal() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in PrimvarRefiner::LimitFaceVarying() -- "
+            "last level of refinement does not include full topology.");
+        return;
+    }
+
+    RangeData<T,U,U,U> data;
+    data.primvarRefiner = this;
+    data.channel = channel;
+    data.src = &src;
+    data.dst = &dst;
+
+    int numVertices = _refiner.getLevel(_refiner.GetMaxLevel()).getNumVertices();
+
+    scheduler.ParallelFor(0, numVertices, getRangeSize(numVertices, scheduler),
+        limitFVarRanges<T,U>, &data);
+}
+
+template <class T, class U, class U1, class U2>
+inline void
+PrimvarRefiner::interpolateConcurrently(RangeData<T,U,U1,U2> & data,
+    TaskScheduler::RangeKernel kernel, TaskScheduler const & scheduler) const {
+
+    Vtr::internal::Level const & parent = _refiner.getLevel(data.level-1);
+
+    int numParents[3] = { parent.getNumFaces(),
+                          parent.getNumEdges(),
+                          parent.getNumVertices() };
+
+    data.primvarRefiner = this;
+
+    //  Parent faces first, as the child vertices of edges and vertices depend on
+    //  those of faces:
+    for (int type = 0; type < 3; ++type) {
+        data.parentType = type;
+
+        scheduler.ParallelFor(0, numParents[type],
+            getRangeSize(numParents[type], scheduler), kernel, &data);
+    }
+}
+
+template <class T, class U>
+void
+PrimvarRefiner::interpolateRanges(int begin, int end, void * data) {
+
+    RangeData<T,U,U,U> const & d = *static_cast<RangeData<T,U,U,U> const *>(data);
+
+    switch (d.parentType) {
+    case 0: d.primvarRefiner->interpolateFromFaces(d.level, *d.src, *d.dst, begin, end); break;
+    case 1: d.primvarRefiner->interpolateFromEdges(d.level, *d.src, *d.dst, begin, end); break;
+    case 2: d.primvarRefiner->interpolateFromVerts(d.level, *d.src, *d.dst, begin, end); break;
+    }
+}
+
+template <class T, class U>
+void
+PrimvarRefiner::interpolateVaryingRanges(int begin, int end, void * data) {
+
+    RangeData<T,U,U,U> const & d = *static_cast<RangeData<T,U,U,U> const *>(data);
+
+    switch (d.parentType) {
+    case 0: d.primvarRefiner->interpVaryingFromFaces(d.level, *d.src, *d.dst, begin, end); break;
+    case 1: d.primvarRefiner->interpVaryingFromEdges(d.level, *d.src, *d.dst, begin, end); break;
+    case 2: d.primvarRefiner->interpVaryingFromVerts(d.level, *d.src, *d.dst, begin, end); break;
+    }
+}
+
+template <class T, class U>
+void
+PrimvarRefiner::interpolateFVarRanges(int begin, int end, void * data) {
+
+    RangeData<T,U,U,U> const & d = *static_cast<RangeData<T,U,U,U> const *>(data);
+
+    PrimvarRefiner const & primvarRefiner = *d.primvarRefiner;
+
+    switch (primvarRefiner._refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        primvarRefiner.interpFVarFromParents<Sdc::SCHEME_CATMARK>(
+            d.parentType, d.level, *d.src, *d.dst, d.channel, begin, end);
+        break;
+    case Sdc::SCHEME_LOOP:
+        primvarRefiner.interpFVarFromParents<Sdc::SCHEME_LOOP>(
+            d.parentType, d.level, *d.src, *d.dst, d.channel, begin, end);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        primvarRefiner.interpFVarFromParents<Sdc::SCHEME_BILINEAR>(
+            d.parentType, d.level, *d.src, *d.dst, d.channel, begin, end);
+        break;
+    }
+}
+
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefiner::interpFVarFromParents(int parentType, int level, T const & src, U & dst,
+                                      int channel, int begin, int end) const {
+
+    switch (parentType) {
+    case 0: interpFVarFromFaces<SCHEME>(level, src, dst, channel, begin, end); break;
+    case 1: interpFVarFromEdges<SCHEME>(level, src, dst, channel, begin, end); break;
+    case 2: interpFVarFromVerts<SCHEME>(level, src, dst, channel, begin, end); break;
+    }
+}
+
+template <class T, class U, class U1, class U2>
+void
+PrimvarRefiner::limitRanges(int begin, int end, void * data) {
+
+    RangeData<T,U,U1,U2> const & d = *static_cast<RangeData<T,U,U1,U2> const *>(data);
+
+    PrimvarRefiner const & primvarRefiner = *d.primvarRefiner;
+
+    if (primvarRefiner._cacheVertexMasks) {
+        primvarRefiner.applyLimitMasks(*d.src, *d.dst, d.tan1, d.tan2, begin, end);
+        return;
+    }
+
+    switch (primvarRefiner._refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        primvarRefiner.limit<Sdc::SCHEME_CATMARK>(*d.src, *d.dst, d.tan1, d.tan2, begin, end);
+        break;
+    case Sdc::SCHEME_LOOP:
+        primvarRefiner.limit<Sdc::SCHEME_LOOP>(*d.src, *d.dst, d.tan1, d.tan2, begin, end);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        primvarRefiner.limit<Sdc::SCHEME_BILINEAR>(*d.src, *d.dst, d.tan1, d.tan2, begin, end);
+        break;
+    }
+}
+
+template <class T, class U>
+void
+PrimvarRefiner::limitFVarRanges(int begin, int end, void * data) {
+
+    RangeData<T,U,U,U> const & d = *static_cast<RangeData<T,U,U,U> const *>(data);
+
+    PrimvarRefiner const & primvarRefiner = *d.primvarRefiner;
+
+    switch (primvarRefiner._refiner._subdivType) {
+    case Sdc::SCHEME_CATMARK:
+        primvarRefiner.limitFVar<Sdc::SCHEME_CATMARK>(*d.src, *d.dst, d.channel, begin, end);
+        break;
+    case Sdc::SCHEME_LOOP:
+        primvarRefiner.limitFVar<Sdc::SCHEME_LOOP>(*d.src, *d.dst, d.channel, begin, end);
+        break;
+    case Sdc::SCHEME_BILINEAR:
+        primvarRefiner.limitFVar<Sdc::SCHEME_BILINEAR>(*d.src, *d.dst, d.channel, begin, end);
+        break;
+    }
+}
+
+
 //
 //  Internal implementation methods -- grouping vertices to be interpolated
 //  based on the type of parent component from which they originated:
 //
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
+PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst, int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
@@ -475,7 +1354,9 @@ PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
 
     Vtr::internal::StackBuffer<float,16> fVertWeights(parent.getMaxValence());
 
-    for (int face = 0; face < parent.getNumFaces(); ++face) {
+    if (end < 0) end = parent.getNumFaces();
+
+    for (int face = begin; face < end; ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
         if (!Vtr::IndexIsValid(cVert))
@@ -501,7 +1382,7 @@ PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
 
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
+PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst, int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
@@ -514,7 +1395,9 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
     float                               eVertWeights[2];
     Vtr::internal::StackBuffer<float,8> eFaceWeights(parent.getMaxEdgeFaces());
 
-    for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
+    if (end < 0) end = parent.getNumEdges();
+
+    for (int edge = begin; edge < end; ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
         if (!Vtr::IndexIsValid(cVert))
@@ -570,7 +1453,7 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
 
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
+PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst, int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
@@ -582,16 +1465,52 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
 
     Vtr::internal::StackBuffer<float,32> weightBuffer(2*parent.getMaxValence());
 
-    for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
+    if (end < 0) end = parent.getNumVertices();
+
+    for (int vert = begin; vert < end; ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
         if (!Vtr::IndexIsValid(cVert))
             continue;
 
-        //  Declare and compute mask weights for this vertex relative to its parent edge:
         ConstIndexArray vEdges = parent.getVertexEdges(vert),
                         vFaces = parent.getVertexFaces(vert);
 
+        //  Smooth interior vertices of regular valence -- the vast majority -- are
+        //  assigned the constant weights of the scheme rather than computing a mask:
+        Vtr::internal::Level::VTag vTag = parent.getVertexTag(vert);
+
+        if ((vTag._rule == Sdc::Crease::RULE_SMOOTH) && !vTag._xordinary &&
+            !vTag._boundary && !vTag._nonManifold &&
+            (vFaces.size() == Sdc::Scheme<SCHEME>::GetRegularVertexValence()) &&
+            (vEdges.size() == vFaces.size())) {
+
+            float vVertWeight = Sdc::Scheme<SCHEME>::GetRegularSmoothVertexWeight(),
+                  vEdgeWeight = Sdc::Scheme<SCHEME>::GetRegularSmoothEdgeWeight(),
+                  vFaceWeight = Sdc::Scheme<SCHEME>::GetRegularSmoothFaceWeight();
+
+            //  Applied in the same order as the weights of a mask (see below):
+            dst[cVert].Clear();
+
+            if (vFaceWeight > 0.0f) {
+                for (int i = 0; i < vFaces.size(); ++i) {
+                    Vtr::Index cVertOfFace = refinement.getFaceChildVertex(vFaces[i]);
+                    assert(Vtr::IndexIsValid(cVertOfFace));
+                    dst[cVert].AddWithWeight(dst[cVertOfFace], vFaceWeight);
+                }
+            }
+            if (vEdgeWeight > 0.0f) {
+                for (int i = 0; i < vEdges.size(); ++i) {
+                    ConstIndexArray eVerts = parent.getEdgeVertices(vEdges[i]);
+                    Vtr::Index pVertOppositeEdge = (eVerts[0] == vert) ? eVerts[1] : eVerts[0];
+                    dst[cVert].AddWithWeight(src[pVertOppositeEdge], vEdgeWeight);
+                }
+            }
+            dst[cVert].AddWithWeight(src[vert], vVertWeight);
+            continue;
+        }
+
+        //  Declare and compute mask weights for this vertex relative to its parent edge:
         float   vVertWeight,
               * vEdgeWeights = weightBuffer,
               * vFaceWeights = vEdgeWeights + vEdges.size();
@@ -643,7 +1562,7 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
 //
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int channel) const {
+PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int channel, int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
 
@@ -659,7 +1578,9 @@ PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int chann
 
     Vtr::internal::StackBuffer<float,16> fValueWeights(parentLevel.getMaxValence());
 
-    for (int face = 0; face < parentLevel.getNumFaces(); ++face) {
+    if (end < 0) end = parentLevel.getNumFaces();
+
+    for (int face = begin; face < end; ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
         if (!Vtr::IndexIsValid(cVert))
@@ -691,7 +1612,7 @@ PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int chann
 
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int channel) const {
+PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int channel, int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
 
@@ -725,7 +1646,9 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
 
     Vtr::internal::EdgeInterface eHood(parentLevel);
 
-    for (int edge = 0; edge < parentLevel.getNumEdges(); ++edge) {
+    if (end < 0) end = parentLevel.getNumEdges();
+
+    for (int edge = begin; edge < end; ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
         if (!Vtr::IndexIsValid(cVert))
@@ -835,7 +1758,7 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
 
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int channel) const {
+PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int channel, int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
 
@@ -856,7 +1779,9 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
 
     Vtr::internal::VertexInterface vHood(parentLevel, childLevel);
 
-    for (int vert = 0; vert < parentLevel.getNumVertices(); ++vert) {
+    if (end < 0) end = parentLevel.getNumVertices();
+
+    for (int vert = begin; vert < end; ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
         if (!Vtr::IndexIsValid(cVert))
@@ -1002,7 +1927,7 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
 
 template <Sdc::SchemeType SCHEME, class T, class U, class U1, class U2>
 inline void
-PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Ptr) const {
+PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Ptr, int begin, int end) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
@@ -1033,7 +1958,9 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
     //  this mask type was intended for another purpose.  Consider one for the limit:
     Vtr::internal::VertexInterface vHood(level, level);
 
-    for (int vert = 0; vert < level.getNumVertices(); ++vert) {
+    if (end < 0) end = level.getNumVertices();
+
+    for (int vert = begin; vert < end; ++vert) {
         ConstIndexArray vEdges = level.getVertexEdges(vert);
 
         //  Incomplete vertices (present in sparse refinement) do not have their full
@@ -1136,7 +2063,7 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
 
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
+PrimvarRefiner::limitFVar(T const & src, U & dst, int channel, int begin, int end) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
@@ -1151,7 +2078,9 @@ PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
     //  This is a bit obscure -- assign both parent and child as last level
     Vtr::internal::VertexInterface vHood(level, level);
 
-    for (int vert = 0; vert < level.getNumVertices(); ++vert) {
+    if (end < 0) end = level.getNumVertices();
+
+    for (int vert = begin; vert < end; ++vert) {
 
         ConstIndexArray vEdges  = level.getVertexEdges(vert);
         ConstIndexArray vValues = fvarChannel.getVertexValues(vert);
@@ -0,0 +1,154 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/profile.h"
+
+#if !defined(OPENSUBDIV_NO_PROFILE)
+    #if defined(OPENSUBDIV_HAS_NVTX)
+        #include <nvtx3/nvToolsExt.h>
+    #endif
+    #if defined(OPENSUBDIV_HAS_ITT)
+        #include <ittnotify.h>
+    #endif
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+//
+//  Statics for the publicly assignable backend and callbacks (disable static
+//  assignment warnings when doing so):
+//
+static ProfileBackend profileBackend = FAR_PROFILE_NONE;
+
+static ProfileZoneBeginFunc profileBeginFunc = 0;
+static ProfileZoneEndFunc profileEndFunc = 0;
+static void * profileClientData = 0;
+
+#if !defined(OPENSUBDIV_NO_PROFILE) && defined(OPENSUBDIV_HAS_ITT)
+static __itt_domain * profileDomain = 0;
+#endif
+
+#ifdef __INTEL_COMPILER
+#pragma warning disable 1711
+#endif
+
+void SetProfileCallbacks(ProfileZoneBeginFunc begin, ProfileZoneEndFunc end,
+                         void *clientData) {
+    profileBeginFunc = begin;
+    profileEndFunc = end;
+    profileClientData = clientData;
+
+    SetProfileBackend(FAR_PROFILE_CALLBACK);
+}
+
+bool SetProfileBackend(ProfileBackend backend) {
+
+    switch (backend) {
+        case FAR_PROFILE_NONE:
+            break;
+#if !defined(OPENSUBDIV_NO_PROFILE)
+        case FAR_PROFILE_CALLBACK:
+            if (not profileBeginFunc or not profileEndFunc) {
+                return false;
+            }
+            break;
+#if defined(OPENSUBDIV_HAS_NVTX)
+        case FAR_PROFILE_NVTX:
+            break;
+#endif
+#if defined(OPENSUBDIV_HAS_ITT)
+        case FAR_PROFILE_ITT:
+            if (not profileDomain) {
+                profileDomain = __itt_domain_create("OpenSubdiv");
+            }
+            break;
+#endif
+#endif
+        default:
+            return false;
+    }
+    profileBackend = backend;
+    return true;
+}
+
+#ifdef __INTEL_COMPILER
+#pragma warning enable 1711
+#endif
+
+ProfileBackend GetProfileBackend() {
+    return profileBackend;
+}
+
+void BeginProfileZone(const char *name) {
+
+    switch (profileBackend) {
+        case FAR_PROFILE_CALLBACK:
+            profileBeginFunc(name, profileClientData);
+            break;
+#if !defined(OPENSUBDIV_NO_PROFILE) && defined(OPENSUBDIV_HAS_NVTX)
+        case FAR_PROFILE_NVTX:
+            nvtxRangePushA(name);
+            break;
+#endif
+#if !defined(OPENSUBDIV_NO_PROFILE) && defined(OPENSUBDIV_HAS_ITT)
+        case FAR_PROFILE_ITT:
+            //  string handles are unique per name (looked up by ITT):
+            __itt_task_begin(profileDomain, __itt_null, __itt_null,
+                __itt_string_handle_create(name));
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+void EndProfileZone(const char *name) {
+
+    switch (profileBackend) {
+        case FAR_PROFILE_CALLBACK:
+            profileEndFunc(name, profileClientData);
+            break;
+#if !defined(OPENSUBDIV_NO_PROFILE) && defined(OPENSUBDIV_HAS_NVTX)
+        case FAR_PROFILE_NVTX:
+            nvtxRangePop();
+            break;
+#endif
+#if !defined(OPENSUBDIV_NO_PROFILE) && defined(OPENSUBDIV_HAS_ITT)
+        case FAR_PROFILE_ITT:
+            __itt_task_end(profileDomain);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
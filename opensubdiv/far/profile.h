@@ -0,0 +1,128 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_PROFILE_H
+#define OPENSUBDIV3_FAR_PROFILE_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+//
+//  Profiling zones of the hot paths : refinement (and its phases), the
+//  factories of stencil and patch tables, the evaluation of stencils and
+//  patches by every Osd evaluator, and the updates of vertex buffers.
+//
+//  Zones are ignored until a profiler backend is set, and are compiled out
+//  entirely when the library is built with OPENSUBDIV_NO_PROFILE (cmake
+//  option NO_PROFILE).
+//
+
+typedef enum {
+    FAR_PROFILE_NONE,       ///< Zones are ignored (default)
+    FAR_PROFILE_CALLBACK,   ///< Zones are sent to the callbacks of SetProfileCallbacks()
+    FAR_PROFILE_NVTX,       ///< Zones are NVTX ranges (requires OPENSUBDIV_HAS_NVTX)
+    FAR_PROFILE_ITT         ///< Zones are Intel ITT tasks (requires OPENSUBDIV_HAS_ITT)
+} ProfileBackend;
+
+
+/// \brief The callback function types of the beginning and end of a zone
+///
+/// Zones are nested, and each ends on the thread it began : 'name' is a
+/// static string identifying the zone (e.g. "CpuEvaluator::EvalStencils").
+///
+typedef void (*ProfileZoneBeginFunc)(const char *name, void *clientData);
+typedef void (*ProfileZoneEndFunc)(const char *name, void *clientData);
+
+/// \brief Sets the callback functions of the FAR_PROFILE_CALLBACK backend
+///        and selects it
+///
+/// \note This function is not thread-safe !
+///
+/// @param begin       function called at the beginning of each zone
+///
+/// @param end         function called at the end of each zone
+///
+/// @param clientData  client data passed to the functions
+///
+void SetProfileCallbacks(ProfileZoneBeginFunc begin, ProfileZoneEndFunc end,
+                         void *clientData = 0);
+
+/// \brief Selects the profiler backend zones are sent to
+///
+/// \note This function is not thread-safe !
+///
+/// @return  False (and the backend is left unchanged) if the backend was
+///          not compiled in the library, or if its callbacks are not set
+///
+bool SetProfileBackend(ProfileBackend backend);
+
+/// \brief Returns the profiler backend zones are sent to
+ProfileBackend GetProfileBackend();
+
+
+//
+//  The following are intended for internal use only
+//
+
+/// \brief Begins a zone (internal use only)
+void BeginProfileZone(const char *name);
+
+/// \brief Ends the last zone begun on the calling thread (internal use only)
+void EndProfileZone(const char *name);
+
+namespace internal {
+
+/// \brief A zone for the lifetime of the instance (internal use only)
+class ProfileZone {
+public:
+    ProfileZone(const char *name) : _name(name) { BeginProfileZone(name); }
+    ~ProfileZone() { EndProfileZone(_name); }
+
+private:
+    const char *_name;
+};
+
+} // end namespace internal
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+//  Declares a zone lasting until the end of the enclosing scope:
+#if defined(OPENSUBDIV_NO_PROFILE)
+    #define OPENSUBDIV_PROFILE_ZONE(name)
+#else
+    #define OPENSUBDIV_PROFILE_ZONE(name) \
+        OpenSubdiv::Far::internal::ProfileZone _opensubdivProfileZone(name)
+#endif
+
+#endif // OPENSUBDIV3_FAR_PROFILE_H
@@ -24,6 +24,7 @@
 #include "../far/ptexIndices.h"
 
 #include "../far/error.h"
+#include "../far/taskScheduler.h"
 #include "../vtr/level.h"
 
 #include <cassert>
@@ -100,6 +101,91 @@ PtexIndices::GetAdjacency(
         return;
     }
 
+    if (HasAdjacency()) {
+        bool isQuad = (_ptexIndices[face+1] - _ptexIndices[face]) == 1;
+        GetAdjacency(_ptexIndices[face] + (isQuad ? 0 : quadrant),
+                     adjFaces, adjEdges);
+        return;
+    }
+    computeAdjacency(refiner, face, quadrant, adjFaces, adjEdges);
+}
+
+namespace {
+    struct AdjacencyContext {
+        TopologyRefiner const * refiner;
+        PtexIndices const *     ptexIndices;
+        Index const *           faceOffsets;
+        int *                   adjacency;
+    };
+}
+
+void
+PtexIndices::buildAdjacencyRange(int begin, int end, void * data) {
+
+    AdjacencyContext const & context = *static_cast<AdjacencyContext *>(data);
+
+    for (int face=begin; face<end; ++face) {
+        int ptexFace = context.faceOffsets[face],
+            numSubfaces = context.faceOffsets[face+1] - ptexFace;
+
+        for (int quadrant=0; quadrant<numSubfaces; ++quadrant, ++ptexFace) {
+            int adjFaces[4], adjEdges[4];
+            context.ptexIndices->computeAdjacency(*context.refiner,
+                face, quadrant, adjFaces, adjEdges);
+
+            int * adjacency = context.adjacency + 4*ptexFace;
+            for (int i=0; i<4; ++i) {
+                adjacency[i] = adjFaces[i] < 0 ?
+                    -1 : ((adjFaces[i] << 2) | adjEdges[i]);
+            }
+        }
+    }
+}
+
+bool
+PtexIndices::BuildAdjacency(TopologyRefiner const &refiner,
+                            TaskScheduler const * taskScheduler) {
+
+    if (Sdc::SchemeTypeTraits::GetRegularFaceSize(
+            refiner.GetSchemeType()) != 4) {
+        Far::Error(FAR_RUNTIME_ERROR,
+                "Failure in PtexIndices::BuildAdjacency() -- "
+                "currently only implemented for quad schemes.");
+        return false;
+    }
+
+    int nfaces = (int)_ptexIndices.size() - 1;
+    if (refiner.getLevel(0).getNumFaces() != nfaces) {
+        Far::Error(FAR_RUNTIME_ERROR,
+                "Failure in PtexIndices::BuildAdjacency() -- "
+                "refiner does not match the ptex indices.");
+        return false;
+    }
+
+    std::vector<int> adjacency(4*GetNumFaces());
+
+    AdjacencyContext context;
+    context.refiner = &refiner;
+    context.ptexIndices = this;
+    context.faceOffsets = &_ptexIndices[0];
+    context.adjacency = adjacency.empty() ? 0 : &adjacency[0];
+
+    if (taskScheduler) {
+        taskScheduler->ParallelFor(0, nfaces, 256,
+                                   buildAdjacencyRange, &context);
+    } else {
+        buildAdjacencyRange(0, nfaces, &context);
+    }
+    _adjacency.swap(adjacency);
+    return true;
+}
+
+void
+PtexIndices::computeAdjacency(
+    TopologyRefiner const &refiner,
+    int face, int quadrant,
+    int adjFaces[4], int adjEdges[4]) const {
+
     Vtr::internal::Level const & level = refiner.getLevel(0);
 
     ConstIndexArray fedges = level.getFaceEdges(face);
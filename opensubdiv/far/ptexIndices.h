@@ -36,6 +36,8 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
+class TaskScheduler;
+
 ///
 /// \brief Object used to compute and query ptex face indices.
 ///
@@ -43,6 +45,11 @@ namespace Far {
 /// from coarse faces to ptex ids.  Once built, the object can be used to
 /// query the mapping.
 ///
+/// The ptex adjacency of all faces can also be precomputed (see
+/// BuildAdjacency()), so that it is queried without walking the topology,
+/// or without the refiner when the object is serialized (see
+/// TableSerializer).
+///
 class PtexIndices {
 
 public:
@@ -85,15 +92,58 @@ public:
         int face, int quadrant,
         int adjFaces[4], int adjEdges[4]) const;
 
+    /// \brief Precomputes the ptex adjacency of all ptex faces (quad schemes
+    ///        only). Returns false on failure.
+    ///
+    /// @param refiner        refiner used to build this PtexIndices object.
+    ///
+    /// @param taskScheduler  optional scheduler used to build the adjacency
+    ///                       of ranges of faces concurrently
+    ///
+    bool BuildAdjacency(TopologyRefiner const &refiner,
+                        TaskScheduler const * taskScheduler=0);
+
+    /// \brief Returns true if the ptex adjacency is precomputed
+    bool HasAdjacency() const { return not _adjacency.empty(); }
+
+    /// \brief Returns the precomputed ptex adjacency of a ptex face
+    ///
+    /// @param ptexFace  ptex face index
+    ///
+    /// @param adjFaces  ptex face indices of adjacent faces (-1 on boundaries)
+    ///
+    /// @param adjEdges  ptex edge indices of adjacent faces
+    ///
+    void GetAdjacency(int ptexFace, int adjFaces[4], int adjEdges[4]) const {
+        int const * adjacency = &_adjacency[4*ptexFace];
+        for (int i=0; i<4; ++i) {
+            adjFaces[i] = adjacency[i] < 0 ? -1 : (adjacency[i] >> 2);
+            adjEdges[i] = adjacency[i] < 0 ?  0 : (adjacency[i] & 3);
+        }
+    }
+
     //@}
 
 private:
 
+    friend class TableSerializer;
+
+    PtexIndices() { }
+
     void initializePtexIndices(TopologyRefiner const &refiner);
 
+    void computeAdjacency(TopologyRefiner const &refiner,
+        int face, int quadrant, int adjFaces[4], int adjEdges[4]) const;
+
+    static void buildAdjacencyRange(int begin, int end, void * data);
+
 private:
 
     std::vector<Index> _ptexIndices;
+
+    // adjacent ptex face and edge of the 4 edges of each ptex face, packed
+    // as (face << 2 | edge), or -1 for boundaries
+    std::vector<int> _adjacency;
 };
 
 
@@ -74,6 +74,46 @@ struct PointDerivWeight {
     }
 };
 
+struct Point2ndDerivWeight {
+    float p;
+    float du;
+    float dv;
+    float duu;
+    float duv;
+    float dvv;
+
+    Point2ndDerivWeight()
+        : p(0.0f), du(0.0f), dv(0.0f), duu(0.0f), duv(0.0f), dvv(0.0f)
+    { }
+    Point2ndDerivWeight(float w)
+        : p(w), du(w), dv(w), duu(w), duv(w), dvv(w)
+    { }
+    Point2ndDerivWeight(float w, float wDu, float wDv,
+                        float wDuu, float wDuv, float wDvv)
+        : p(w), du(wDu), dv(wDv), duu(wDuu), duv(wDuv), dvv(wDvv)
+    { }
+
+    friend Point2ndDerivWeight operator*(Point2ndDerivWeight lhs,
+                                         Point2ndDerivWeight const& rhs) {
+        lhs.p *= rhs.p;
+        lhs.du *= rhs.du;
+        lhs.dv *= rhs.dv;
+        lhs.duu *= rhs.duu;
+        lhs.duv *= rhs.duv;
+        lhs.dvv *= rhs.dvv;
+        return lhs;
+    }
+    Point2ndDerivWeight& operator+=(Point2ndDerivWeight const& rhs) {
+        p += rhs.p;
+        du += rhs.du;
+        dv += rhs.dv;
+        duu += rhs.duu;
+        duv += rhs.duv;
+        dvv += rhs.dvv;
+        return *this;
+    }
+};
+
 /// Stencil table constructor set.
 ///
 class WeightTable {
@@ -85,6 +125,8 @@ public:
         , _lastOffset(0)
         , _coarseVertCount(coarseVerts)
         , _compactWeights(compactWeights)
+        , _firstDest(0)
+        , _srcTable(this)
     {
         // These numbers were chosen by profiling production assets at uniform
         // level 3.
@@ -117,6 +159,58 @@ public:
         _lastOffset = _size - 1;
     }
 
+    // Construct a table to accumulate the stencils of a range of vertices
+    // in isolation -- source stencils are resolved from the given table,
+    // which must not be modified while this table is in use, and the
+    // stencils accumulated are subsequently appended to it.
+    explicit WeightTable(WeightTable const * srcTable)
+        : _size(0)
+        , _lastOffset(0)
+        , _coarseVertCount(srcTable->_coarseVertCount)
+        , _compactWeights(srcTable->_compactWeights)
+        , _firstDest(-1)
+        , _srcTable(srcTable)
+    {
+    }
+
+    // Append the stencils accumulated by a table constructed from this one.
+    // Appending the tables of successive ranges in order yields the same
+    // result as accumulating all stencils in this table directly.
+    void Append(WeightTable const & rangeTable)
+    {
+        assert(rangeTable._srcTable == this);
+        if (rangeTable._dests.empty())
+            return;
+
+        int offset = static_cast<int>(_sources.size());
+
+        _dests.insert(_dests.end(), rangeTable._dests.begin(), rangeTable._dests.end());
+        _sources.insert(_sources.end(), rangeTable._sources.begin(), rangeTable._sources.end());
+        _weights.insert(_weights.end(), rangeTable._weights.begin(), rangeTable._weights.end());
+        _duWeights.insert(_duWeights.end(), rangeTable._duWeights.begin(), rangeTable._duWeights.end());
+        _dvWeights.insert(_dvWeights.end(), rangeTable._dvWeights.begin(), rangeTable._dvWeights.end());
+        _duuWeights.insert(_duuWeights.end(), rangeTable._duuWeights.begin(), rangeTable._duuWeights.end());
+        _duvWeights.insert(_duvWeights.end(), rangeTable._duvWeights.begin(), rangeTable._duvWeights.end());
+        _dvvWeights.insert(_dvvWeights.end(), rangeTable._dvvWeights.begin(), rangeTable._dvvWeights.end());
+
+        for (int i = 0; i < (int)rangeTable._sizes.size(); ++i) {
+            // Skip vertices of the range for which no stencil was started
+            if (rangeTable._sizes[i] == 0)
+                continue;
+
+            int dst = rangeTable._firstDest + i;
+            if (dst+1 > (int)_indices.size()) {
+                _indices.resize(dst+1);
+                _sizes.resize(dst+1);
+            }
+            _indices[dst] = offset + rangeTable._indices[i];
+            _sizes[dst] = rangeTable._sizes[i];
+        }
+
+        _size += rangeTable._size;
+        _lastOffset = offset + rangeTable._lastOffset;
+    }
+
     template <class W, class WACCUM>
     void AddWithWeight(int src, int dest, W weight, WACCUM weights) 
     {
@@ -137,22 +231,33 @@ public:
         // verts (src itself is made up of many control vert weights). 
         //
         // Find the src stencil and number of contributing CVs.
-        int len = _sizes[src];
-        int start = _indices[src];
+        WeightTable const & srcTable = *_srcTable;
+
+        int len = srcTable._sizes[src];
+        int start = srcTable._indices[src];
 
         for (int i = start; i < start+len; i++) {
             // Invariant: by processing each level in order and each vertex in
             // dependent order, any src stencil vertex reference is guaranteed
             // to consist only of coarse verts: therefore resolving src verts
             // must yield verts in the coarse mesh.
-            assert(_sources[i] < _coarseVertCount);
+            assert(srcTable._sources[i] < _coarseVertCount);
 
             // Merge each of src's contributing verts into this stencil.
-            merge(_sources[i], dest, weights.Get(i), weight, 
+            merge(srcTable._sources[i], dest, weights.Get(i), weight, 
                                 _lastOffset, _size, weights);
         }
     }
 
+    // Add the weight of a control vertex which does not contribute to the
+    // stencil yet (the weight is neither resolved nor merged).
+    template <class W, class WACCUM>
+    void AddDistinct(int src, int dest, W weight, WACCUM weights)
+    {
+        assert(src < _coarseVertCount);
+        add(src, dest, weight, weights);
+    }
+
     class PointDerivAccumulator {
         WeightTable* _tbl;
     public:
@@ -169,15 +274,51 @@ public:
             _tbl->_dvWeights[i] += weight.dv;
         }
         PointDerivWeight Get(size_t index) {
-            return PointDerivWeight(_tbl->_weights[index], 
-                                    _tbl->_duWeights[index],
-                                    _tbl->_dvWeights[index]);
+            WeightTable const * src = _tbl->_srcTable;
+            return PointDerivWeight(src->_weights[index], 
+                                    src->_duWeights[index],
+                                    src->_dvWeights[index]);
         }
     };
     PointDerivAccumulator GetPointDerivAccumulator() { 
         return PointDerivAccumulator(this);
     };
 
+    class Point2ndDerivAccumulator {
+        WeightTable* _tbl;
+    public:
+        Point2ndDerivAccumulator(WeightTable* tbl) : _tbl(tbl)
+        { }
+        void PushBack(Point2ndDerivWeight weight) {
+            _tbl->_weights.push_back(weight.p);
+            _tbl->_duWeights.push_back(weight.du);
+            _tbl->_dvWeights.push_back(weight.dv);
+            _tbl->_duuWeights.push_back(weight.duu);
+            _tbl->_duvWeights.push_back(weight.duv);
+            _tbl->_dvvWeights.push_back(weight.dvv);
+        }
+        void Add(size_t i, Point2ndDerivWeight weight) {
+            _tbl->_weights[i] += weight.p;
+            _tbl->_duWeights[i] += weight.du;
+            _tbl->_dvWeights[i] += weight.dv;
+            _tbl->_duuWeights[i] += weight.duu;
+            _tbl->_duvWeights[i] += weight.duv;
+            _tbl->_dvvWeights[i] += weight.dvv;
+        }
+        Point2ndDerivWeight Get(size_t index) {
+            WeightTable const * src = _tbl->_srcTable;
+            return Point2ndDerivWeight(src->_weights[index],
+                                       src->_duWeights[index],
+                                       src->_dvWeights[index],
+                                       src->_duuWeights[index],
+                                       src->_duvWeights[index],
+                                       src->_dvvWeights[index]);
+        }
+    };
+    Point2ndDerivAccumulator GetPoint2ndDerivAccumulator() {
+        return Point2ndDerivAccumulator(this);
+    };
+
     class ScalarAccumulator {
         WeightTable* _tbl;
     public:
@@ -190,7 +331,7 @@ public:
             _tbl->_weights[i] += w;
         }
         float Get(size_t index) {
-            return _tbl->_weights[index];
+            return _tbl->_srcTable->_weights[index];
         }
     };
     ScalarAccumulator GetScalarAccumulator() { 
@@ -215,12 +356,117 @@ public:
     std::vector<float> const&
     GetDvWeights() const { return _dvWeights; }
 
+    std::vector<float> const&
+    GetDuuWeights() const { return _duuWeights; }
+
+    std::vector<float> const&
+    GetDuvWeights() const { return _duvWeights; }
+
+    std::vector<float> const&
+    GetDvvWeights() const { return _dvvWeights; }
+
     void SetCoarseVertCount(int numVerts) {
         _coarseVertCount = numVerts;
     }
 
+    // Swaps the stencils from 'first' on into the given arrays if they are
+    // stored contiguously and in order, i.e. without the weights of cleared
+    // or relocated stencils (the table is left unusable). Returns false if
+    // they are not, and must then be copied.
+    bool Release(int first, std::vector<int> & sizes,
+        std::vector<int> & sources, std::vector<float> & weights,
+            std::vector<float> * duWeights, std::vector<float> * dvWeights,
+                std::vector<float> * duuWeights, std::vector<float> * duvWeights,
+                    std::vector<float> * dvvWeights) {
+
+        int numStencils = (int)_sizes.size();
+        if (first > numStencils) return false;
+
+        int begin = first < numStencils ? _indices[first] : (int)_sources.size(),
+            end = begin;
+        for (int i = first; i < numStencils; ++i) {
+            if (_indices[i] != end) return false;
+            end += _sizes[i];
+        }
+        if (end != (int)_sources.size()) return false;
+
+        releaseArray(_sizes, first, sizes);
+        releaseArray(_sources, begin, sources);
+        releaseArray(_weights, begin, weights);
+        if (duWeights) releaseArray(_duWeights, begin, *duWeights);
+        if (dvWeights) releaseArray(_dvWeights, begin, *dvWeights);
+        if (duuWeights) releaseArray(_duuWeights, begin, *duuWeights);
+        if (duvWeights) releaseArray(_duvWeights, begin, *duvWeights);
+        if (dvvWeights) releaseArray(_dvvWeights, begin, *dvvWeights);
+
+        _indices.clear();
+        _dests.clear();
+        _size = 0;
+        _lastOffset = 0;
+        return true;
+    }
+
+    // Reserve the arrays for stencils to be accumulated next (the arrays of
+    // the derivative weights are only reserved once they are in use)
+    void Reserve(int numStencils, size_t numWeights) {
+        size_t n = _sources.size() + numWeights;
+        _dests.reserve(n);
+        _sources.reserve(n);
+        _weights.reserve(n);
+        if (not _duWeights.empty()) {
+            _duWeights.reserve(n);
+            _dvWeights.reserve(n);
+        }
+        if (not _duuWeights.empty()) {
+            _duuWeights.reserve(n);
+            _duvWeights.reserve(n);
+            _dvvWeights.reserve(n);
+        }
+        _indices.reserve(_indices.size() + numStencils);
+        _sizes.reserve(_sizes.size() + numStencils);
+    }
+
+    // Remove all the weights of a stencil -- the weights of the last stencil
+    // are discarded, those of other stencils are left unused.
+    void Clear(int dst) {
+        int d = dst - _firstDest;
+        if (_firstDest < 0 or d < 0 or d >= (int)_indices.size() or _sizes[d] == 0)
+            return;
+
+        if (_indices[d] + _sizes[d] == _size) {
+            _size = _indices[d];
+            _dests.resize(_size);
+            _sources.resize(_size);
+            _weights.resize(_size);
+            if (not _duWeights.empty()) {
+                _duWeights.resize(_size);
+                _dvWeights.resize(_size);
+            }
+            if (not _duuWeights.empty()) {
+                _duuWeights.resize(_size);
+                _duvWeights.resize(_size);
+                _dvvWeights.resize(_size);
+            }
+        }
+        _sizes[d] = 0;
+    }
+
 private:
 
+    // Moves the elements of 'src' from 'begin' on into 'dst' (the prefix is
+    // erased in place, without reallocating)
+    template <class T>
+    static void releaseArray(std::vector<T> & src, int begin,
+                             std::vector<T> & dst) {
+        if (src.empty()) {
+            dst.clear();
+            return;
+        }
+        src.erase(src.begin(), src.begin() + begin);
+        dst.swap(src);
+        std::vector<T>().swap(src);
+    }
+
     // Merge a vertex weight into the stencil table, if there is an existing
     // weight for a given source vertex it will be combined.
     //
@@ -272,23 +518,35 @@ private:
             // stencils can be directly looked up by their index in these
             // arrays. So here, ensure that they are large enough to hold the
             // new stencil about to be built.
-            if (dst+1 > (int)_indices.size()) {
-                _indices.resize(dst+1);
-                _sizes.resize(dst+1);
+            //
+            // A table accumulating a range of vertices stores these relative
+            // to the first vertex of the range.
+            if (_firstDest < 0) {
+                _firstDest = dst;
+            }
+            assert(dst >= _firstDest);
+            if (dst-_firstDest+1 > (int)_indices.size()) {
+                _indices.resize(dst-_firstDest+1);
+                _sizes.resize(dst-_firstDest+1);
+            }
+            // Initialize the new stencil's meta-data (offset, size) -- weights
+            // added to an existing stencil other than the last one (vertex
+            // edits) first move it to the end of the table.
+            if (_sizes[dst-_firstDest] > 0) {
+                relocate(dst-_firstDest);
+            } else {
+                _indices[dst-_firstDest] = static_cast<int>(_sources.size());
             }
-            // Initialize the new stencil's meta-data (offset, size).
-            _indices[dst] = static_cast<int>(_sources.size());
-            _sizes[dst] = 0;
             // Keep track of where the current stencil begins, which lets us
             // avoid having to look it up later.
-            _lastOffset = static_cast<int>(_sources.size());
+            _lastOffset = _indices[dst-_firstDest];
         }
         // Cache the number of elements as an optimization, it's faster than
         // calling size() on any of the vectors.
         _size++;
 
         // Increment the current stencil element size.
-        _sizes[dst]++;
+        _sizes[dst-_firstDest]++;
         // Track this element as belonging to the stencil "dst".
         _dests.push_back(dst);
 
@@ -297,6 +555,35 @@ private:
         weights.PushBack(weight);
     }
 
+    // Copy the weights of a stencil to the end of the table.
+    void relocate(int d) {
+        int offset = _indices[d],
+            size = _sizes[d];
+
+        _indices[d] = _size;
+        for (int i = offset; i < offset+size; ++i) {
+            appendCopy(_dests, i);
+            appendCopy(_sources, i);
+            appendCopy(_weights, i);
+            if (not _duWeights.empty()) {
+                appendCopy(_duWeights, i);
+                appendCopy(_dvWeights, i);
+            }
+            if (not _duuWeights.empty()) {
+                appendCopy(_duuWeights, i);
+                appendCopy(_duvWeights, i);
+                appendCopy(_dvvWeights, i);
+            }
+        }
+        _size += size;
+    }
+
+    template <class T>
+    static void appendCopy(std::vector<T> & v, int i) {
+        T value = v[i];
+        v.push_back(value);
+    }
+
     // The following vectors are explicitly stored as non-interleaved elements
     // to reduce cache misses.
 
@@ -308,6 +595,9 @@ private:
     std::vector<float> _weights;
     std::vector<float> _duWeights;
     std::vector<float> _dvWeights;
+    std::vector<float> _duuWeights;
+    std::vector<float> _duvWeights;
+    std::vector<float> _dvvWeights;
 
     // Index data used to recover stencil-to-vertex mapping.
     std::vector<int> _indices;
@@ -318,6 +608,15 @@ private:
     int _lastOffset;
     int _coarseVertCount;
     bool _compactWeights;
+
+    // First vertex of the range (zero unless constructed for a range) and
+    // the table from which source stencils are resolved (usually this).
+    int _firstDest;
+    WeightTable const * _srcTable;
+
+    // Tables are not copied (range tables refer to their source table)
+    WeightTable(WeightTable const &);
+    WeightTable & operator=(WeightTable const &);
 };
 
 StencilBuilder::StencilBuilder(int coarseVertCount, 
@@ -329,11 +628,39 @@ StencilBuilder::StencilBuilder(int coarseVertCount,
 {
 }
 
+StencilBuilder::StencilBuilder(StencilBuilder const * srcBuilder)
+        : _weightTable(new WeightTable(srcBuilder->_weightTable))
+{
+}
+
 StencilBuilder::~StencilBuilder()
 {
     delete _weightTable;
 }
 
+void
+StencilBuilder::Append(StencilBuilder const & rangeBuilder)
+{
+    _weightTable->Append(*rangeBuilder._weightTable);
+}
+
+bool
+StencilBuilder::ReleaseStencils(int firstStencil,
+    std::vector<int> & sizes, std::vector<int> & sources,
+        std::vector<float> & weights, std::vector<float> * duWeights,
+            std::vector<float> * dvWeights, std::vector<float> * duuWeights,
+                std::vector<float> * duvWeights, std::vector<float> * dvvWeights)
+{
+    return _weightTable->Release(firstStencil, sizes, sources, weights,
+        duWeights, dvWeights, duuWeights, duvWeights, dvvWeights);
+}
+
+void
+StencilBuilder::Reserve(int numStencils, size_t numWeights)
+{
+    _weightTable->Reserve(numStencils, numWeights);
+}
+
 size_t
 StencilBuilder::GetNumVerticesTotal() const
 {
@@ -386,6 +713,27 @@ StencilBuilder::GetStencilDvWeights() const {
     return _weightTable->GetDvWeights();
 }
 
+std::vector<float> const&
+StencilBuilder::GetStencilDuuWeights() const {
+    return _weightTable->GetDuuWeights();
+}
+
+std::vector<float> const&
+StencilBuilder::GetStencilDuvWeights() const {
+    return _weightTable->GetDuvWeights();
+}
+
+std::vector<float> const&
+StencilBuilder::GetStencilDvvWeights() const {
+    return _weightTable->GetDvvWeights();
+}
+
+void
+StencilBuilder::Index::Clear()
+{
+    _owner->_weightTable->Clear(_index);
+}
+
 void
 StencilBuilder::Index::AddWithWeight(Index const & src, float weight)
 {
@@ -448,6 +796,69 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src,
     }
 }
 
+void
+StencilBuilder::Index::AddWithWeight(Stencil const& src,
+                                     float weight, float du, float dv,
+                                     float duu, float duv, float dvv)
+{
+    if (isWeightZero(weight) and isWeightZero(du) and isWeightZero(dv) and
+        isWeightZero(duu) and isWeightZero(duv) and isWeightZero(dvv)) {
+        return;
+    }
+
+    int srcSize = *src.GetSizePtr();
+    Vtr::Index const * srcIndices = src.GetVertexIndices();
+    float const * srcWeights = src.GetWeights();
+
+    for (int i = 0; i < srcSize; ++i) {
+        float w = srcWeights[i];
+        if (isWeightZero(w)) {
+            continue;
+        }
+
+        Vtr::Index srcIndex = srcIndices[i];
+
+        Point2ndDerivWeight wgt =
+            Point2ndDerivWeight(weight, du, dv, duu, duv, dvv) * w;
+        _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
+                           _owner->_weightTable->GetPoint2ndDerivAccumulator());
+    }
+}
+
+void
+StencilBuilder::Index::AddDistinctWeights(int size, Vtr::Index const * sources,
+                                          float const * weights,
+                                          float const * du, float const * dv,
+                                          float const * duu, float const * duv,
+                                          float const * dvv)
+{
+    WeightTable * table = _owner->_weightTable;
+
+    if (duu and duv and dvv) {
+        for (int i = 0; i < size; ++i) {
+            if (isWeightZero(weights[i]) and isWeightZero(du[i]) and
+                isWeightZero(dv[i]) and isWeightZero(duu[i]) and
+                isWeightZero(duv[i]) and isWeightZero(dvv[i])) {
+                continue;
+            }
+            table->AddDistinct(sources[i], _index,
+                Point2ndDerivWeight(weights[i], du[i], dv[i],
+                                    duu[i], duv[i], dvv[i]),
+                table->GetPoint2ndDerivAccumulator());
+        }
+    } else {
+        for (int i = 0; i < size; ++i) {
+            if (isWeightZero(weights[i]) and isWeightZero(du[i]) and
+                isWeightZero(dv[i])) {
+                continue;
+            }
+            table->AddDistinct(sources[i], _index,
+                PointDerivWeight(weights[i], du[i], dv[i]),
+                table->GetPointDerivAccumulator());
+        }
+    }
+}
+
 } // end namespace internal
 } // end namespace Far
 } // end namespace OPENSUBDIV_VERSION
@@ -43,10 +43,37 @@ public:
     StencilBuilder(int coarseVertCount, 
                    bool genCtrlVertStencils=true,
                    bool compactWeights=true);
+
+    // Builder for the stencils of a range of vertices, to be accumulated
+    // independently of (and concurrently with) other ranges. Stencils of
+    // source vertices are resolved from srcBuilder, which must not be
+    // modified until the range builder is appended to it with Append().
+    explicit StencilBuilder(StencilBuilder const * srcBuilder);
+
     ~StencilBuilder();
 
     // TODO: noncopyable.
 
+    // Appends the stencils of a range builder constructed from this one.
+    void Append(StencilBuilder const & rangeBuilder);
+
+    // Swaps the arrays of the stencils from firstStencil on into those given,
+    // rather than copying them, if the stencils are stored contiguously and
+    // in order (the builder can't be used any further). Returns false if
+    // they are not.
+    bool ReleaseStencils(int firstStencil,
+        std::vector<int> & sizes, std::vector<int> & sources,
+            std::vector<float> & weights,
+                std::vector<float> * duWeights = 0,
+                    std::vector<float> * dvWeights = 0,
+                        std::vector<float> * duuWeights = 0,
+                            std::vector<float> * duvWeights = 0,
+                                std::vector<float> * dvvWeights = 0);
+
+    // Reserves the arrays for 'numStencils' more stencils holding a total of
+    // 'numWeights' weights, so that they are accumulated without reallocation
+    void Reserve(int numStencils, size_t numWeights);
+
     size_t GetNumVerticesTotal() const;
 
     int GetNumVertsInStencil(size_t stencilIndex) const;
@@ -66,6 +93,9 @@ public:
     std::vector<float> const& GetStencilWeights() const;
     std::vector<float> const& GetStencilDuWeights() const;
     std::vector<float> const& GetStencilDvWeights() const;
+    std::vector<float> const& GetStencilDuuWeights() const;
+    std::vector<float> const& GetStencilDuvWeights() const;
+    std::vector<float> const& GetStencilDvvWeights() const;
 
     // Vertex Facade.
     class Index {
@@ -83,13 +113,28 @@ public:
         void AddWithWeight(Stencil const& src,
                                      float weight, float du, float dv);
 
+        // Add with first and second derivatives.
+        void AddWithWeight(Stencil const& src,
+                                     float weight, float du, float dv,
+                                     float duu, float duv, float dvv);
+
+        // Add the weights of distinct control vertices : sources are added
+        // without looking for existing weights to merge them with, and
+        // sources for which all the weights are zero are skipped.
+        void AddDistinctWeights(int size, Vtr::Index const * sources,
+                                float const * weights,
+                                float const * du, float const * dv,
+                                float const * duu=0, float const * duv=0,
+                                float const * dvv=0);
+
         Index operator[](int index) const {
             return Index(_owner, index+_index);
         }
 
         int GetOffset() const { return _index; }
 
-        void Clear() {/*nothing to do here*/}
+        // Remove the weights of the vertex (a no-op for new vertices).
+        void Clear();
     private:
         StencilBuilder* _owner;
         int _index;
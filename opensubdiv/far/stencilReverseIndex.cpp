@@ -0,0 +1,168 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/stencilReverseIndex.h"
+#include "../far/stencilTable.h"
+
+#include <algorithm>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+StencilReverseIndex::StencilReverseIndex(StencilTable const & stencilTable) :
+    _numControlVertices(stencilTable.GetNumControlVertices()),
+    _numStencils(stencilTable.GetNumStencils()) {
+
+    std::vector<int> const & sizes = stencilTable.GetSizes();
+    std::vector<Index> const & indices = stencilTable.GetControlIndices();
+
+    //  The vertices interpolated by the stencils are only referred to by the
+    //  stencils of later passes:
+    int numVertices = _numControlVertices +
+        (stencilTable.GetPassOffsets().empty() ? 0 : _numStencils);
+
+    _vertexOffsets.assign(numVertices + 1, 0);
+    for (int i = 0, ofs = 0; i < _numStencils; ofs += sizes[i++]) {
+        for (int j = 0; j < sizes[i]; ++j) {
+            Index vertex = indices[ofs + j];
+            if (vertex >= 0 and vertex < numVertices) {
+                ++_vertexOffsets[vertex + 1];
+            }
+        }
+    }
+    for (int vertex = 0; vertex < numVertices; ++vertex) {
+        _vertexOffsets[vertex + 1] += _vertexOffsets[vertex];
+    }
+
+    _stencilIndices.resize(_vertexOffsets.back());
+
+    std::vector<Index> counts(_vertexOffsets.begin(), _vertexOffsets.end() - 1);
+    for (int i = 0, ofs = 0; i < _numStencils; ofs += sizes[i++]) {
+        for (int j = 0; j < sizes[i]; ++j) {
+            Index vertex = indices[ofs + j];
+            if (vertex >= 0 and vertex < numVertices) {
+                _stencilIndices[counts[vertex]++] = i;
+            }
+        }
+    }
+}
+
+int
+StencilReverseIndex::GetStencilRanges(Index const * vertices, int numVertices,
+    std::vector<Index> & ranges, int maxGap, int maxRanges) const {
+
+    ranges.clear();
+
+    int numIndexedVertices = (int)_vertexOffsets.size() - 1;
+
+    std::vector<Index> stencils;
+    if (numIndexedVertices == _numControlVertices) {
+        for (int i = 0; i < numVertices; ++i) {
+            Index vertex = vertices[i];
+            if (vertex >= 0 and vertex < _numControlVertices) {
+                ConstIndexArray vertexStencils = GetVertexStencils(vertex);
+                stencils.insert(stencils.end(),
+                    vertexStencils.begin(), vertexStencils.end());
+            }
+        }
+        std::sort(stencils.begin(), stencils.end());
+        stencils.erase(std::unique(stencils.begin(), stencils.end()),
+            stencils.end());
+    } else {
+        //  Stencils of several passes : the stencils referring to the vertices
+        //  interpolated by the gathered stencils are gathered in turn
+        std::vector<bool> gathered(_numStencils, false);
+        for (int i = 0; i < numVertices; ++i) {
+            Index vertex = vertices[i];
+            if (vertex < 0 or vertex >= _numControlVertices) continue;
+
+            ConstIndexArray vertexStencils = GetVertexStencils(vertex);
+            for (int j = 0; j < vertexStencils.size(); ++j) {
+                if (not gathered[vertexStencils[j]]) {
+                    gathered[vertexStencils[j]] = true;
+                    stencils.push_back(vertexStencils[j]);
+                }
+            }
+        }
+        for (size_t i = 0; i < stencils.size(); ++i) {
+            ConstIndexArray vertexStencils =
+                GetVertexStencils(_numControlVertices + stencils[i]);
+            for (int j = 0; j < vertexStencils.size(); ++j) {
+                if (not gathered[vertexStencils[j]]) {
+                    gathered[vertexStencils[j]] = true;
+                    stencils.push_back(vertexStencils[j]);
+                }
+            }
+        }
+        std::sort(stencils.begin(), stencils.end());
+    }
+
+    if (stencils.empty()) {
+        return 0;
+    }
+
+    //  Runs of consecutive stencils, merged across small gaps:
+    maxGap = std::max(maxGap, 0);
+    ranges.push_back(stencils[0]);
+    ranges.push_back(stencils[0] + 1);
+    for (size_t i = 1; i < stencils.size(); ++i) {
+        if (stencils[i] - ranges.back() <= maxGap) {
+            ranges.back() = stencils[i] + 1;
+        } else {
+            ranges.push_back(stencils[i]);
+            ranges.push_back(stencils[i] + 1);
+        }
+    }
+
+    //  Widen the gap until few enough ranges remain:
+    maxRanges = std::max(maxRanges, 1);
+    while ((int)ranges.size() > 2 * maxRanges) {
+        maxGap = std::max(2 * maxGap, 1);
+
+        size_t numMerged = 2;
+        for (size_t i = 2; i < ranges.size(); i += 2) {
+            if (ranges[i] - ranges[numMerged - 1] <= maxGap) {
+                ranges[numMerged - 1] = ranges[i + 1];
+            } else {
+                ranges[numMerged++] = ranges[i];
+                ranges[numMerged++] = ranges[i + 1];
+            }
+        }
+        ranges.resize(numMerged);
+    }
+
+    int numStencils = 0;
+    for (size_t i = 0; i < ranges.size(); i += 2) {
+        numStencils += ranges[i + 1] - ranges[i];
+    }
+    return numStencils;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
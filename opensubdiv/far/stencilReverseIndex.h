@@ -0,0 +1,122 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_STENCIL_REVERSE_INDEX_H
+#define OPENSUBDIV3_FAR_STENCIL_REVERSE_INDEX_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class StencilTable;
+
+///
+/// \brief Stencils depending on each control vertex of a StencilTable
+///
+/// Animated meshes often deform a small subset of their control vertices
+/// from one frame to the next : the stencils referring to these vertices are
+/// the only ones to evaluate again. The index gathers them as ranges of
+/// consecutive stencils, suitable for the evaluation of partial tables (see
+/// StencilTable::UpdateValues() and EvalStencilRange() of the Osd
+/// evaluators).
+///
+/// Stencils of tables of several passes (see StencilTable::GetPassOffsets())
+/// which refer to interpolated vertices are gathered along with the stencils
+/// of these vertices.
+///
+class StencilReverseIndex {
+
+public:
+
+    /// \brief Constructor
+    ///
+    /// @param stencilTable  Table to index (the table is not retained)
+    ///
+    StencilReverseIndex(StencilTable const & stencilTable);
+
+    /// \brief Returns the number of control vertices of the indexed table
+    int GetNumControlVertices() const { return _numControlVertices; }
+
+    /// \brief Returns the number of stencils of the indexed table
+    int GetNumStencils() const { return _numStencils; }
+
+    /// \brief Returns the stencils referring to a control vertex
+    ConstIndexArray GetVertexStencils(Index vertex) const {
+        int size = _vertexOffsets[vertex+1] - _vertexOffsets[vertex];
+        return ConstIndexArray(size ?
+            &_stencilIndices[_vertexOffsets[vertex]] : 0, size);
+    }
+
+    /// \brief Gathers the ranges of stencils depending on a set of control
+    ///        vertices
+    ///
+    /// Ranges separated by at most 'maxGap' stencils are merged (evaluating
+    /// a few unaffected stencils again costs less than launching a kernel for
+    /// each range), and the gap is widened until at most 'maxRanges' ranges
+    /// remain.
+    ///
+    /// @param vertices   Control vertices (in any order, duplicates allowed)
+    ///
+    /// @param numVertices Number of control vertices
+    ///
+    /// @param ranges     Returned [start, end) pairs of stencil indices, in
+    ///                   increasing order
+    ///
+    /// @param maxGap     Gap between merged ranges
+    ///
+    /// @param maxRanges  Maximum number of ranges returned
+    ///
+    /// @return           The number of stencils in the ranges
+    ///
+    int GetStencilRanges(Index const * vertices, int numVertices,
+                         std::vector<Index> & ranges,
+                         int maxGap = 64, int maxRanges = 16) const;
+
+private:
+
+    int _numControlVertices,
+        _numStencils;
+
+    // Stencils referring to each vertex : vertices following the control
+    // vertices are the interpolated vertices of tables of several passes
+    std::vector<Index> _vertexOffsets,
+                       _stencilIndices;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_STENCIL_REVERSE_INDEX_H
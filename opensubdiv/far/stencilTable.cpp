@@ -24,6 +24,9 @@
 
 #include "../version.h"
 #include "../far/stencilTable.h"
+#include "../far/taskScheduler.h"
+
+#include <algorithm>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -47,7 +50,13 @@ namespace {
                     std::vector<float> const*  duWeights=NULL,
                     std::vector<float> *      _duWeights=NULL,
                     std::vector<float> const*  dvWeights=NULL,
-                    std::vector<float> *      _dvWeights=NULL) {
+                    std::vector<float> *      _dvWeights=NULL,
+                    std::vector<float> const*  duuWeights=NULL,
+                    std::vector<float> *      _duuWeights=NULL,
+                    std::vector<float> const*  duvWeights=NULL,
+                    std::vector<float> *      _duvWeights=NULL,
+                    std::vector<float> const*  dvvWeights=NULL,
+                    std::vector<float> *      _dvvWeights=NULL) {
         size_t start = includeCoarseVerts ? 0 : firstOffset;
 
         _offsets->resize(offsets->size());
@@ -58,6 +67,12 @@ namespace {
             _duWeights->resize(duWeights->size());
         if (_dvWeights)
             _dvWeights->resize(dvWeights->size());
+        if (_duuWeights)
+            _duuWeights->resize(duuWeights->size());
+        if (_duvWeights)
+            _duvWeights->resize(duvWeights->size());
+        if (_dvvWeights)
+            _dvvWeights->resize(dvvWeights->size());
 
         // The stencils are probably not in order, so we must copy/sort them.
         // Note here that loop index 'i' represents stencil_i for vertex_i.
@@ -92,6 +107,18 @@ namespace {
                 std::memcpy(&(*_dvWeights)[curOffset],
                         &(*dvWeights)[off], sz*sizeof(float));
             }
+            if (_duuWeights) {
+                std::memcpy(&(*_duuWeights)[curOffset],
+                        &(*duuWeights)[off], sz*sizeof(float));
+            }
+            if (_duvWeights) {
+                std::memcpy(&(*_duvWeights)[curOffset],
+                        &(*duvWeights)[off], sz*sizeof(float));
+            }
+            if (_dvvWeights) {
+                std::memcpy(&(*_dvvWeights)[curOffset],
+                        &(*dvvWeights)[off], sz*sizeof(float));
+            }
 
             curOffset += sz;
             stencilCount++;
@@ -101,11 +128,18 @@ namespace {
         _offsets->resize(stencilCount);
         _sizes->resize(stencilCount);
         _sources->resize(weightCount);
+        _weights->resize(weightCount);
 
         if (_duWeights)
             _duWeights->resize(weightCount);
         if (_dvWeights)
             _dvWeights->resize(weightCount);
+        if (_duuWeights)
+            _duuWeights->resize(weightCount);
+        if (_duvWeights)
+            _duvWeights->resize(weightCount);
+        if (_dvvWeights)
+            _dvvWeights->resize(weightCount);
     }
 };
 
@@ -129,10 +163,93 @@ StencilTable::StencilTable(int numControlVerts,
 void
 StencilTable::Clear() {
     _numControlVertices=0;
-    _sizes.clear();
-    _offsets.clear();
-    _indices.clear();
-    _weights.clear();
+    std::vector<int>().swap(_sizes);
+    std::vector<Index>().swap(_offsets);
+    std::vector<Index>().swap(_indices);
+    std::vector<float>().swap(_weights);
+    std::vector<Index>().swap(_passOffsets);
+}
+
+MemoryUsage
+StencilTable::GetMemoryUsage() const {
+    MemoryUsage usage;
+    usage.Add(_sizes);
+    usage.Add(_offsets);
+    usage.Add(_indices);
+    usage.Add(_weights);
+    usage.Add(_passOffsets);
+    return usage;
+}
+
+namespace {
+    //  Stencils are histogrammed in ranges of fixed size, merged in order:
+    int const statisticsRangeSize = 16 * 1024;
+
+    struct StatisticsData {
+        int const * sizes;
+        int numSizes;
+        std::vector<int> * histograms;
+    };
+
+    void
+    histogramSizes(int begin, int end, void * data) {
+
+        StatisticsData const & stats = *static_cast<StatisticsData *>(data);
+        for (int range = begin; range < end; ++range) {
+            int first = range * statisticsRangeSize,
+                last = std::min(first + statisticsRangeSize, stats.numSizes);
+
+            std::vector<int> & histogram = stats.histograms[range];
+            for (int i = first; i < last; ++i) {
+                int size = stats.sizes[i];
+                if (size >= (int)histogram.size()) {
+                    histogram.resize(size + 1, 0);
+                }
+                ++histogram[size];
+            }
+        }
+    }
+}
+
+StencilTable::Statistics
+StencilTable::GetStatistics(TaskScheduler const * scheduler) const {
+
+    Statistics stats;
+    stats.numStencils = GetNumStencils();
+    stats.numWeights = (int)_weights.size();
+    stats.numPasses = _passOffsets.empty() ? 1 : (int)_passOffsets.size();
+    stats.minSize = 0;
+    stats.maxSize = 0;
+    if (stats.numStencils == 0) {
+        return stats;
+    }
+
+    int numRanges = (stats.numStencils + statisticsRangeSize - 1) / statisticsRangeSize;
+
+    std::vector<std::vector<int> > histograms(numRanges);
+
+    StatisticsData data = { &_sizes[0], stats.numStencils, &histograms[0] };
+    if (scheduler and numRanges > 1) {
+        scheduler->ParallelFor(0, numRanges, 1, histogramSizes, &data);
+    } else {
+        histogramSizes(0, numRanges, &data);
+    }
+
+    for (int range = 0; range < numRanges; ++range) {
+        std::vector<int> const & histogram = histograms[range];
+        if (histogram.size() > stats.sizeHistogram.size()) {
+            stats.sizeHistogram.resize(histogram.size(), 0);
+        }
+        for (int size = 0; size < (int)histogram.size(); ++size) {
+            stats.sizeHistogram[size] += histogram[size];
+        }
+    }
+
+    stats.maxSize = (int)stats.sizeHistogram.size() - 1;
+    while (stats.sizeHistogram[stats.minSize] == 0) {
+        ++stats.minSize;
+    }
+    return stats;
 }
 
 LimitStencilTable::LimitStencilTable(int numControlVerts,
@@ -142,9 +259,16 @@ LimitStencilTable::LimitStencilTable(int numControlVerts,
                                      std::vector<float> const& weights,
                                      std::vector<float> const& duWeights,
                                      std::vector<float> const& dvWeights,
+                                     std::vector<float> const& duuWeights,
+                                     std::vector<float> const& duvWeights,
+                                     std::vector<float> const& dvvWeights,
                                      bool includeCoarseVerts,
                                      size_t firstOffset)
     : StencilTable(numControlVerts) {
+
+    // Second derivatives are optional
+    bool second = not duuWeights.empty();
+
     copyStencilData(numControlVerts,
                     includeCoarseVerts,
                     firstOffset,
@@ -153,14 +277,31 @@ LimitStencilTable::LimitStencilTable(int numControlVerts,
                     &sources, &_indices,
                     &weights, &_weights,
                     &duWeights, &_duWeights,
-                    &dvWeights, &_dvWeights);
+                    &dvWeights, &_dvWeights,
+                    second ? &duuWeights : NULL, second ? &_duuWeights : NULL,
+                    second ? &duvWeights : NULL, second ? &_duvWeights : NULL,
+                    second ? &dvvWeights : NULL, second ? &_dvvWeights : NULL);
 }
 
 void
 LimitStencilTable::Clear() {
     StencilTable::Clear();
-    _duWeights.clear();
-    _dvWeights.clear();
+    std::vector<float>().swap(_duWeights);
+    std::vector<float>().swap(_dvWeights);
+    std::vector<float>().swap(_duuWeights);
+    std::vector<float>().swap(_duvWeights);
+    std::vector<float>().swap(_dvvWeights);
+}
+
+MemoryUsage
+LimitStencilTable::GetMemoryUsage() const {
+    MemoryUsage usage = StencilTable::GetMemoryUsage();
+    usage.Add(_duWeights);
+    usage.Add(_dvWeights);
+    usage.Add(_duuWeights);
+    usage.Add(_duvWeights);
+    usage.Add(_dvvWeights);
+    return usage;
 }
 
 
@@ -39,6 +39,8 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
+class TaskScheduler;
+
 /// \brief Vertex stencil descriptor
 ///
 /// Allows access and manipulation of a single stencil in a StencilTable.
@@ -168,6 +170,40 @@ public:
         return _weights;
     }
 
+    /// \brief Returns the index of the first stencil of each evaluation pass
+    ///        (empty if all the stencils can be evaluated in a single pass)
+    ///
+    /// Stencils of a pass may refer to the vertices interpolated by previous
+    /// passes (see StencilTableFactory::Options) : passes must be evaluated
+    /// in order, with the interpolated values following the control values
+    /// in a single buffer.
+    ///
+    std::vector<Index> const & GetPassOffsets() const {
+        return _passOffsets;
+    }
+
+    /// \brief Returns the memory held by the arrays of the table -- both their
+    ///        size and their capacity
+    virtual MemoryUsage GetMemoryUsage() const;
+
+    /// \brief Statistics of the stencils of the table (see GetStatistics)
+    struct Statistics {
+        int numStencils,             ///< number of stencils
+            numWeights,              ///< number of weights of all stencils
+            numPasses,               ///< number of evaluation passes
+            minSize,                 ///< size of the smallest stencil
+            maxSize;                 ///< size of the largest stencil
+        std::vector<int> sizeHistogram; ///< number of stencils of each size
+                                        ///< (from 0 to maxSize)
+    };
+
+    /// \brief Returns the statistics of the stencils of the table
+    ///
+    /// @param scheduler  Optional scheduler computing the statistics of
+    ///                   ranges of stencils of large tables concurrently
+    ///
+    Statistics GetStatistics(TaskScheduler const * scheduler = 0) const;
+
     /// \brief Returns the stencil at index i in the table
     Stencil operator[] (Index index) const;
 
@@ -176,6 +212,10 @@ public:
     /// \note The destination buffers are assumed to have allocated at least
     ///       \c GetNumStencils() elements.
     ///
+    /// \note Tables of several passes (see GetPassOffsets()) are evaluated
+    ///       in order, but 'values' must then follow 'controlValues' in the
+    ///       same buffer.
+    ///
     /// @param controlValues  Buffer with primvar data for the control vertices
     ///
     /// @param values         Destination buffer for the interpolated primvar
@@ -190,7 +230,8 @@ public:
         update(controlValues, values, _weights, start, end);
     }
 
-    /// \brief Clears the stencils from the table
+    /// \brief Clears the stencils from the table and frees the memory of its
+    ///        arrays
     void Clear();
 
 protected:
@@ -222,6 +263,8 @@ protected:
 
     friend class StencilTableFactory;
     friend class PatchTableFactory;
+    friend class PatchTable;
+    friend class TableSerializer;
     // XXX: temporarily, GregoryBasis class will go away.
     friend class GregoryBasis;
     // XXX: needed to call reserve().
@@ -234,6 +277,8 @@ protected:
     std::vector<Index>         _offsets,  // offset to the start of each stencil
                                _indices;  // indices of contributing coarse vertices
     std::vector<float>         _weights;  // stencil weight coefficients
+
+    std::vector<Index>         _passOffsets; // first stencil of each evaluation pass
 };
 
 
@@ -255,14 +300,29 @@ public:
     ///
     /// @param dvWeights Table pointer to the 'v' derivative weights
     ///
+    /// @param duuWeights Table pointer to the 'uu' derivative weights
+    ///                   (optional)
+    ///
+    /// @param duvWeights Table pointer to the 'uv' derivative weights
+    ///                   (optional)
+    ///
+    /// @param dvvWeights Table pointer to the 'vv' derivative weights
+    ///                   (optional)
+    ///
     LimitStencil( int* size,
                   Index * indices,
                   float * weights,
                   float * duWeights,
-                  float * dvWeights )
+                  float * dvWeights,
+                  float * duuWeights = 0,
+                  float * duvWeights = 0,
+                  float * dvvWeights = 0 )
         : Stencil(size, indices, weights),
           _duWeights(duWeights),
-          _dvWeights(dvWeights) {
+          _dvWeights(dvWeights),
+          _duuWeights(duuWeights),
+          _duvWeights(duvWeights),
+          _dvvWeights(dvvWeights) {
     }
 
     /// \brief
@@ -275,6 +335,24 @@ public:
         return _dvWeights;
     }
 
+    /// \brief Returns the 'uu' derivative weights (NULL if the table has no
+    ///        second derivatives)
+    float const * GetDuuWeights() const {
+        return _duuWeights;
+    }
+
+    /// \brief Returns the 'uv' derivative weights (NULL if the table has no
+    ///        second derivatives)
+    float const * GetDuvWeights() const {
+        return _duvWeights;
+    }
+
+    /// \brief Returns the 'vv' derivative weights (NULL if the table has no
+    ///        second derivatives)
+    float const * GetDvvWeights() const {
+        return _dvvWeights;
+    }
+
     /// \brief Advance to the next stencil in the table
     void Next() {
        int stride = *_size;
@@ -283,6 +361,11 @@ public:
        _weights += stride;
        _duWeights += stride;
        _dvWeights += stride;
+       if (_duuWeights) {
+           _duuWeights += stride;
+           _duvWeights += stride;
+           _dvvWeights += stride;
+       }
     }
 
 private:
@@ -291,7 +374,10 @@ private:
     friend class LimitStencilTableFactory;
 
     float * _duWeights,  // pointer to stencil u derivative limit weights
-          * _dvWeights;  // pointer to stencil v derivative limit weights
+          * _dvWeights,  // pointer to stencil v derivative limit weights
+          * _duuWeights, // pointer to stencil uu derivative limit weights
+          * _duvWeights, // pointer to stencil uv derivative limit weights
+          * _dvvWeights; // pointer to stencil vv derivative limit weights
 };
 
 /// \brief Table of limit subdivision stencils.
@@ -305,6 +391,9 @@ class LimitStencilTable : public StencilTable {
                     std::vector<float> const& weights,
                     std::vector<float> const& duWeights,
                     std::vector<float> const& dvWeights,
+                    std::vector<float> const& duuWeights,
+                    std::vector<float> const& duvWeights,
+                    std::vector<float> const& dvvWeights,
                     bool includeCoarseVerts,
                     size_t firstOffset);
 
@@ -326,6 +415,34 @@ public:
         return _dvWeights;
     }
 
+    /// \brief Returns true if the table holds second derivative weights
+    ///        (see LimitStencilTableFactory::Create())
+    bool HasSecondDerivatives() const {
+        return not _duuWeights.empty();
+    }
+
+    /// \brief Returns the 'uu' derivative stencil interpolation weights
+    ///        (empty if the table has no second derivatives)
+    std::vector<float> const & GetDuuWeights() const {
+        return _duuWeights;
+    }
+
+    /// \brief Returns the 'uv' derivative stencil interpolation weights
+    ///        (empty if the table has no second derivatives)
+    std::vector<float> const & GetDuvWeights() const {
+        return _duvWeights;
+    }
+
+    /// \brief Returns the 'vv' derivative stencil interpolation weights
+    ///        (empty if the table has no second derivatives)
+    std::vector<float> const & GetDvvWeights() const {
+        return _dvvWeights;
+    }
+
+    /// \brief Returns the memory held by the arrays of the table (including
+    ///        the derivative weights)
+    virtual MemoryUsage GetMemoryUsage() const;
+
     /// \brief Updates derivative values based on the control values
     ///
     /// \note The destination buffers ('uderivs' & 'vderivs') are assumed to
@@ -351,18 +468,57 @@ public:
         update(controlValues, vderivs, _dvWeights, start, end);
     }
 
-    /// \brief Clears the stencils from the table
+    /// \brief Updates second derivative values based on the control values
+    ///
+    /// \note The table must hold second derivatives (see
+    ///       HasSecondDerivatives()) and the destination buffers are assumed
+    ///       to have allocated at least \c GetNumStencils() elements.
+    ///
+    /// @param controlValues  Buffer with primvar data for the control vertices
+    ///
+    /// @param uuderivs       Destination buffer for the interpolated 'uu'
+    ///                       derivative primvar data
+    ///
+    /// @param uvderivs       Destination buffer for the interpolated 'uv'
+    ///                       derivative primvar data
+    ///
+    /// @param vvderivs       Destination buffer for the interpolated 'vv'
+    ///                       derivative primvar data
+    ///
+    /// @param start          (skip to )index of first value to update
+    ///
+    /// @param end            Index of last value to update
+    ///
+    template <class T>
+    void Update2ndDerivs(T const *controlValues,
+        T *uuderivs, T *uvderivs, T *vvderivs, int start=-1, int end=-1) const {
+
+        assert(HasSecondDerivatives());
+        update(controlValues, uuderivs, _duuWeights, start, end);
+        update(controlValues, uvderivs, _duvWeights, start, end);
+        update(controlValues, vvderivs, _dvvWeights, start, end);
+    }
+
+    /// \brief Clears the stencils from the table and frees the memory of its
+    ///        arrays
     void Clear();
 
 private:
+    friend class StencilTableFactory;
     friend class LimitStencilTableFactory;
+    friend class TableSerializer;
+
+    LimitStencilTable(int numControlVerts) : StencilTable(numControlVerts) { }
 
     // Resize the table arrays (factory helper)
     void resize(int nstencils, int nelems);
 
 private:
     std::vector<float>  _duWeights,  // u derivative limit stencil weights
-                        _dvWeights;  // v derivative limit stencil weights
+                        _dvWeights,  // v derivative limit stencil weights
+                        _duuWeights, // uu derivative limit stencil weights
+                        _duvWeights, // uv derivative limit stencil weights
+                        _dvvWeights; // vv derivative limit stencil weights
 };
 
 
@@ -460,6 +616,11 @@ LimitStencilTable::resize(int nstencils, int nelems) {
     StencilTable::resize(nstencils, nelems);
     _duWeights.resize(nelems);
     _dvWeights.resize(nelems);
+    if (HasSecondDerivatives()) {
+        _duuWeights.resize(nelems);
+        _duvWeights.resize(nelems);
+        _dvvWeights.resize(nelems);
+    }
 }
 
 // Returns a LimitStencil at index i in the table
@@ -469,6 +630,16 @@ LimitStencilTable::GetLimitStencil(Index i) const {
 
     Index ofs = GetOffsets()[i];
 
+    if (HasSecondDerivatives()) {
+        return LimitStencil( const_cast<int *>(&GetSizes()[i]),
+                             const_cast<Index *>(&GetControlIndices()[ofs]),
+                             const_cast<float *>(&GetWeights()[ofs]),
+                             const_cast<float *>(&GetDuWeights()[ofs]),
+                             const_cast<float *>(&GetDvWeights()[ofs]),
+                             const_cast<float *>(&GetDuuWeights()[ofs]),
+                             const_cast<float *>(&GetDuvWeights()[ofs]),
+                             const_cast<float *>(&GetDvvWeights()[ofs]) );
+    }
     return LimitStencil( const_cast<int *>(&GetSizes()[i]),
                          const_cast<Index *>(&GetControlIndices()[ofs]),
                          const_cast<float *>(&GetWeights()[ofs]),
@@ -25,13 +25,19 @@
 #include "../far/stencilTableFactory.h"
 #include "../far/stencilBuilder.h"
 #include "../far/endCapGregoryBasisPatchFactory.h"
+#include "../far/hierarchicalEdits.h"
 #include "../far/patchTable.h"
 #include "../far/patchTableFactory.h"
 #include "../far/patchMap.h"
 #include "../far/topologyRefiner.h"
 #include "../far/primvarRefiner.h"
+#include "../far/profile.h"
+#include "../far/taskScheduler.h"
+#include "../far/error.h"
+#include "../far/buildMonitor.h"
 
 #include <cassert>
+#include <cmath>
 #include <algorithm>
 #include <iostream>
 
@@ -51,10 +57,201 @@ namespace {
 #ifdef __INTEL_COMPILER
 #pragma warning (pop)
 #endif
+
+    // Number of parent components (or locations) per range of stencils to be
+    // accumulated concurrently -- a few ranges per thread to balance the load
+    // (a single thread interpolates monitored levels by the smallest ranges,
+    // checking for cancellation between them)
+    inline int
+    getRangeSize(int numItems, TaskScheduler const & scheduler) {
+        if (scheduler.GetNumThreads() < 2) return 1024;
+        return std::max(1024, numItems / (4 * scheduler.GetNumThreads()) + 1);
+    }
 }
 
 //------------------------------------------------------------------------------
 
+//
+// Counting prepass of the stencils of a level : the weights of a stencil are
+// the distinct sources of the stencils it combines with non-zero weights
+// (see StencilBuilder), counted by interpolating the level without weights
+// so that the builder is reserved once for the exact size of the level
+//
+namespace {
+    class LevelWeightCounter {
+    public:
+        LevelWeightCounter(internal::StencilBuilder const & builder,
+            int numCoarseVerts, int firstVert, int numVerts) :
+                _offsets(builder.GetStencilOffsets()),
+                _sizes(builder.GetStencilSizes()),
+                _sources(builder.GetStencilSources()),
+                _numCoarseVerts(numCoarseVerts),
+                _firstVert(firstVert),
+                _counts(numVerts, 0),
+                _levelOffsets(numVerts, 0),
+                _marks(numCoarseVerts, -1) { }
+
+        class Vertex {
+        public:
+            Vertex(LevelWeightCounter * counter, int index) :
+                _counter(counter), _index(index) { }
+
+            void Clear() { }
+
+            void AddWithWeight(Vertex const & src, float weight) {
+                if (not isWeightZero(weight)) {
+                    _counter->add(src._index, _index);
+                }
+            }
+
+        private:
+            LevelWeightCounter * _counter;
+            int _index;
+        };
+
+        // Vertices of the parent (or child) level, indexed from 'offset'
+        class Vertices {
+        public:
+            Vertices(LevelWeightCounter * counter, int offset) :
+                _counter(counter), _offset(offset) { }
+
+            Vertex operator[](int index) const {
+                return Vertex(_counter, _offset + index);
+            }
+
+        private:
+            LevelWeightCounter * _counter;
+            int _offset;
+        };
+
+        size_t GetNumWeights() const {
+            size_t numWeights = 0;
+            for (int i=0; i<(int)_counts.size(); ++i) {
+                numWeights += _counts[i];
+            }
+            return numWeights;
+        }
+
+    private:
+        void add(int src, int dst) {
+            // (the sources of a vertex are counted contiguously, as its
+            // weights are accumulated)
+            if (_counts[dst - _firstVert] == 0) {
+                _levelOffsets[dst - _firstVert] = (int)_levelSources.size();
+            }
+            if (src < _numCoarseVerts) {
+                mark(src, dst);
+            } else if (src >= _firstVert) {
+                // vertices of the level contributing to other vertices of
+                // the level (e.g. face-vertices to edge-vertices)
+                int offset = _levelOffsets[src - _firstVert];
+                for (int i=0; i<_counts[src - _firstVert]; ++i) {
+                    mark(_levelSources[offset + i], dst);
+                }
+            } else {
+                int offset = _offsets[src];
+                for (int i=0; i<_sizes[src]; ++i) {
+                    mark(_sources[offset + i], dst);
+                }
+            }
+        }
+
+        void mark(int src, int dst) {
+            if (_marks[src] != dst) {
+                _marks[src] = dst;
+                _levelSources.push_back(src);
+                ++_counts[dst - _firstVert];
+            }
+        }
+
+        std::vector<int> const & _offsets;
+        std::vector<int> const & _sizes;
+        std::vector<int> const & _sources;
+
+        int _numCoarseVerts,
+            _firstVert;
+
+        std::vector<int> _counts,        // number of weights of each vertex
+                         _levelOffsets,  // first of its sources in _levelSources
+                         _levelSources,  // sources of the vertices of the level
+                         _marks;         // last vertex each source was counted for
+    };
+
+    size_t
+    countLevelWeights(PrimvarRefiner const & primvarRefiner, int level,
+        internal::StencilBuilder const & builder, int numCoarseVerts,
+            int srcOffset, int dstOffset, bool interpolateVarying) {
+
+        int numVerts = primvarRefiner.GetTopologyRefiner().
+            GetLevel(level).GetNumVertices();
+
+        LevelWeightCounter counter(builder, numCoarseVerts, dstOffset, numVerts);
+
+        LevelWeightCounter::Vertices src(&counter, srcOffset),
+                                     dst(&counter, dstOffset);
+        if (interpolateVarying) {
+            primvarRefiner.InterpolateVarying(level, src, dst);
+        } else {
+            primvarRefiner.Interpolate(level, src, dst);
+        }
+        return counter.GetNumWeights();
+    }
+
+    //
+    // Bilinear levels : each vertex of a level is the average of the vertices
+    // of its parent face, edge or vertex, for vertex and varying data alike.
+    // The stencils are accumulated directly from the parent topology, without
+    // the masks of PrimvarRefiner, in the order of the vertices of the level
+    //
+    void
+    interpolateBilinearLevel(TopologyRefiner const & refiner, int level,
+        internal::StencilBuilder::Index const & src,
+            internal::StencilBuilder::Index const & dst) {
+
+        TopologyLevel const & parent = refiner.GetLevel(level-1);
+
+        int numFaces = parent.GetNumFaces(),
+            numEdges = parent.GetNumEdges(),
+            numVerts = parent.GetNumVertices();
+
+        // parent component of each vertex of the level : faces, then edges
+        // and vertices, following each other
+        std::vector<Index> parents(refiner.GetLevel(level).GetNumVertices(),
+            INDEX_INVALID);
+
+        for (int face=0; face<numFaces; ++face) {
+            Index child = parent.GetFaceChildVertex(face);
+            if (IndexIsValid(child)) parents[child] = face;
+        }
+        for (int edge=0; edge<numEdges; ++edge) {
+            Index child = parent.GetEdgeChildVertex(edge);
+            if (IndexIsValid(child)) parents[child] = numFaces + edge;
+        }
+        for (int vert=0; vert<numVerts; ++vert) {
+            Index child = parent.GetVertexChildVertex(vert);
+            if (IndexIsValid(child)) parents[child] = numFaces + numEdges + vert;
+        }
+
+        for (int child=0; child<(int)parents.size(); ++child) {
+            Index p = parents[child];
+
+            if (p < numFaces) {
+                ConstIndexArray fVerts = parent.GetFaceVertices(p);
+                float w = 1.0f / (float)fVerts.size();
+                for (int i=0; i<fVerts.size(); ++i) {
+                    dst[child].AddWithWeight(src[fVerts[i]], w);
+                }
+            } else if (p < numFaces + numEdges) {
+                ConstIndexArray eVerts = parent.GetEdgeVertices(p - numFaces);
+                dst[child].AddWithWeight(src[eVerts[0]], 0.5f);
+                dst[child].AddWithWeight(src[eVerts[1]], 0.5f);
+            } else {
+                dst[child].AddWithWeight(src[p - numFaces - numEdges], 1.0f);
+            }
+        }
+    }
+}
+
 void
 StencilTableFactory::generateControlVertStencils(
     int numControlVerts, Stencil & dst) {
@@ -75,283 +272,1922 @@ StencilTable const *
 StencilTableFactory::Create(TopologyRefiner const & refiner,
     Options options) {
 
+    OPENSUBDIV_PROFILE_ZONE("StencilTableFactory::Create");
+
+    if (options.projectToLimit) {
+        return CreateLimitProjection(refiner, options);
+    }
+
+    bool interpolateVarying = options.interpolationMode==INTERPOLATE_VARYING;
+
+    // Bilinear levels are averages of their parent topology, interpolated
+    // directly (see interpolateBilinearLevel())
+    bool bilinear = refiner.GetSchemeType()==Sdc::SCHEME_BILINEAR;
+
+    // Values of the vertex edits are sources of the stencils following the
+    // control vertices (varying data is not edited)
+    HierarchicalEdits const * edits = refiner.GetHierarchicalEdits();
+
+    bool applyEdits = edits and edits->GetNumVertexEdits() > 0 and
+                      (not interpolateVarying);
+
+    if (applyEdits and (not options.factorizeIntermediateLevels)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::Create() -- "
+            "vertex edits require factorized intermediate levels.");
+        return NULL;
+    }
+
+    int numBaseVerts = refiner.GetLevel(0).GetNumVertices(),
+        numControlVerts = numBaseVerts +
+                          (applyEdits ? edits->GetNumVertexEdits() : 0);
+
     int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
     if (maxlevel==0 and (not options.generateControlVerts)) {
         StencilTable * result = new StencilTable;
-        result->_numControlVertices = refiner.GetLevel(0).GetNumVertices();
+        result->_numControlVertices = numControlVerts;
         return result;
     }
 
-    bool interpolateVarying = options.interpolationMode==INTERPOLATE_VARYING;
-    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
+    if (options.factorizeIntermediateLevels and
+        options.shareIntermediateLevels and
+        (not options.generateControlVerts) and maxlevel>1 and
+        (not applyEdits)) {
+        // (shared levels are measured over all the levels first : the
+        // build is only checked for cancellation once complete)
+        if (options.monitor) {
+            options.monitor->beginStage(0.0f, 1.0f, 1);
+        }
+        StencilTable const * result =
+            createSharedLevels(refiner, options, maxlevel);
+        if (options.monitor and (not options.monitor->advance(1))) {
+            delete result;
+            return NULL;
+        }
+        return result;
+    }
+
+    internal::StencilBuilder builder(numControlVerts,
                                 /*genControlVerts*/ true,
                                 /*compactWeights*/  true);
 
     //
     // Interpolate stencils for each refinement level using
-    // PrimvarRefiner::InterpolateLevel<>() for vertex or varying
+    // PrimvarRefiner::InterpolateLevel<>() for vertex or varying (bilinear
+    // levels are interpolated directly from their parent topology)
     //
     PrimvarRefiner primvarRefiner(refiner);
 
-    internal::StencilBuilder::Index srcIndex(&builder, 0);
-    internal::StencilBuilder::Index dstIndex(&builder, 
-                                    refiner.GetLevel(0).GetNumVertices());
+    internal::StencilBuilder::Index srcIndex(&builder, 0);
+    internal::StencilBuilder::Index dstIndex(&builder, numControlVerts);
+
+    internal::StencilBuilder::Index editValues(&builder, numBaseVerts);
+
+    // Edits of the control vertices are applied to copies of their stencils,
+    // from which the first level is interpolated
+    bool editBaseLevel = applyEdits and edits->HasVertexEdits(0);
+    if (editBaseLevel) {
+        for (int i=0; i<numBaseVerts; ++i) {
+            dstIndex[i].AddWithWeight(srcIndex[i], 1.0f);
+        }
+        primvarRefiner.ApplyVertexEdits(0, editValues, dstIndex);
+
+        srcIndex = dstIndex;
+        dstIndex = dstIndex[numBaseVerts];
+    }
+    size_t levelsOffset = dstIndex.GetOffset();
+
+    // Varying and bilinear stencils are trivial and always interpolated
+    // serially
+    bool interpolateSerially = interpolateVarying or bilinear;
+
+    TaskScheduler const * scheduler = options.taskScheduler;
+    if (scheduler and (scheduler->GetNumThreads() < 2 or interpolateSerially)) {
+        scheduler = 0;
+    }
+
+    // Monitored builds interpolate their levels by ranges, to be cancelled
+    // between ranges
+    BuildMonitor * monitor = options.monitor;
+
+    SerialTaskScheduler serialScheduler;
+    if (monitor and (not scheduler) and (not interpolateSerially)) {
+        scheduler = &serialScheduler;
+    }
+
+    if (monitor) {
+        int numParents = 0;
+        for (int level=0; level<maxlevel; ++level) {
+            TopologyLevel const & parent = refiner.GetLevel(level);
+            numParents += parent.GetNumFaces() + parent.GetNumEdges() +
+                          parent.GetNumVertices();
+        }
+        monitor->beginStage(0.0f, 1.0f, numParents);
+    }
+
+    // first stencil of each level in the builder
+    std::vector<size_t> levelStarts(maxlevel+1, 0);
+
+    // vertices the stencils of the next level are expressed in (see
+    // StencilBuilder::SetCoarseVertCount())
+    int numCoarseVerts = numControlVerts;
+
+    for (int level=1; level<=maxlevel; ++level) {
+        levelStarts[level] = dstIndex.GetOffset();
+
+        // The stencils of the level are counted first, so that the arrays
+        // of the builder are reallocated once per level rather than grown
+        // while they are interpolated
+        if (options.presizeLevels) {
+            builder.Reserve(refiner.GetLevel(level).GetNumVertices(),
+                countLevelWeights(primvarRefiner, level, builder, numCoarseVerts,
+                    srcIndex.GetOffset(), dstIndex.GetOffset(), interpolateVarying));
+        }
+
+        if (bilinear) {
+            interpolateBilinearLevel(refiner, level, srcIndex, dstIndex);
+        } else if (scheduler) {
+            interpolateLevelConcurrently(*scheduler, primvarRefiner, level,
+                builder, srcIndex.GetOffset(), dstIndex.GetOffset(), monitor);
+        } else if (not interpolateVarying) {
+            primvarRefiner.Interpolate(level, srcIndex, dstIndex);
+        } else {
+            primvarRefiner.InterpolateVarying(level, srcIndex, dstIndex);
+        }
+
+        if (applyEdits) {
+            primvarRefiner.ApplyVertexEdits(level, editValues, dstIndex);
+        }
+
+        srcIndex = dstIndex;
+
+        dstIndex = dstIndex[refiner.GetLevel(level).GetNumVertices()];
+
+        if (not options.factorizeIntermediateLevels) {
+            // All previous verts are considered as coarse verts : the
+            // stencils of the next level refer to those of this level
+            // rather than being factorized
+            numCoarseVerts = dstIndex.GetOffset();
+            builder.SetCoarseVertCount(numCoarseVerts);
+        }
+
+        if (monitor) {
+            if (interpolateSerially) {
+                TopologyLevel const & parent = refiner.GetLevel(level-1);
+                monitor->advance(parent.GetNumFaces() + parent.GetNumEdges() +
+                                 parent.GetNumVertices());
+            }
+            if (monitor->IsCancelled()) {
+                return NULL;
+            }
+            if (monitor->ReportsLevelStencils() and level<maxlevel) {
+                monitor->StencilLevelCompleted(level,
+                    createLevelsTable(builder, options, numBaseVerts,
+                        numControlVerts, applyEdits, editBaseLevel,
+                            levelsOffset, srcIndex.GetOffset(),
+                                levelStarts, level, /*release*/ false));
+            }
+        }
+    }
+
+    return createLevelsTable(builder, options, numBaseVerts, numControlVerts,
+        applyEdits, editBaseLevel, levelsOffset, srcIndex.GetOffset(),
+            levelStarts, maxlevel, /*release*/ true);
+}
+
+//
+// Limit projection of the last level : the limit masks of the vertices of the
+// last level (see PrimvarRefiner::Limit()) are applied to their stencils,
+// the positions as point weights and the two tangents as derivative weights
+// of the limit stencils
+//
+namespace {
+    // Stencils of the vertices of the last level, as sources of the masks
+    struct LimitProjectionSources {
+        LimitProjectionSources(StencilTable const & table) : _table(table) { }
+
+        Stencil operator[](int index) const {
+            return _table.GetStencil(index);
+        }
+
+        StencilTable const & _table;
+    };
+
+    // Limit stencil of a vertex accumulating one of its masks : the point
+    // weights (0) or those of the first (1) or second (2) tangent
+    class LimitProjectionStencil {
+    public:
+        LimitProjectionStencil(internal::StencilBuilder::Index dst, int mask) :
+            _dst(dst), _mask(mask) { }
+
+        // (the masks of a vertex are accumulated into a same new stencil)
+        void Clear() { }
+
+        void AddWithWeight(Stencil const & src, float weight) {
+            _dst.AddWithWeight(src, _mask==0 ? weight : 0.0f,
+                                    _mask==1 ? weight : 0.0f,
+                                    _mask==2 ? weight : 0.0f);
+        }
+
+    private:
+        internal::StencilBuilder::Index _dst;
+        int _mask;
+    };
+
+    struct LimitProjectionStencils {
+        LimitProjectionStencils(internal::StencilBuilder & builder, int mask) :
+            _origin(&builder, 0), _mask(mask) { }
+
+        LimitProjectionStencil operator[](int index) const {
+            return LimitProjectionStencil(_origin[index], _mask);
+        }
+
+        internal::StencilBuilder::Index _origin;
+        int _mask;
+    };
+}
+
+LimitStencilTable const *
+StencilTableFactory::CreateLimitProjection(TopologyRefiner const & refiner,
+    Options options) {
+
+    OPENSUBDIV_PROFILE_ZONE("StencilTableFactory::CreateLimitProjection");
+
+    int maxlevel = refiner.GetMaxLevel();
+
+    if (options.interpolationMode != INTERPOLATE_VERTEX or
+        (not refiner.IsUniform())) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreateLimitProjection() -- "
+            "limit projection requires vertex stencils of a uniform "
+            "refinement.");
+        return NULL;
+    }
+    if (maxlevel > 0 and
+        (not refiner.GetUniformOptions().fullTopologyInLastLevel)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreateLimitProjection() -- "
+            "last level of refinement does not include full topology.");
+        return NULL;
+    }
+    if ((int)options.maxLevel < maxlevel) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreateLimitProjection() -- "
+            "limit projection requires the last level of the refiner.");
+        return NULL;
+    }
+
+    // Stencils of the vertices of the last level, factorized from the
+    // control vertices (and the values of the vertex edits)
+    BuildMonitor * monitor = options.monitor;
+
+    Options levelOptions = options;
+    levelOptions.projectToLimit = false;
+    levelOptions.generateOffsets = true;
+    levelOptions.generateControlVerts = (maxlevel == 0);
+    levelOptions.generateIntermediateLevels = false;
+    levelOptions.factorizeIntermediateLevels = true;
+    levelOptions.shareIntermediateLevels = false;
+
+    BuildMonitor::Range range;
+    if (monitor) range = monitor->enterRange(0.0f, 0.8f);
+
+    StencilTable const * levelStencils = Create(refiner, levelOptions);
+
+    if (monitor) monitor->restoreRange(range);
+    if (not levelStencils) {
+        return NULL;
+    }
+
+    int numControlVerts = levelStencils->GetNumControlVertices();
+
+    if (monitor) {
+        monitor->beginStage(0.8f, 1.0f, 1);
+    }
+
+    internal::StencilBuilder builder(numControlVerts,
+                                /*genControlVerts*/ false,
+                                /*compactWeights*/  true);
+
+    LimitProjectionSources src(*levelStencils);
+    LimitProjectionStencils dstPos(builder, 0),
+                            dstTan1(builder, 1),
+                            dstTan2(builder, 2);
+
+    PrimvarRefiner(refiner).Limit(src, dstPos, dstTan1, dstTan2);
+
+    delete levelStencils;
+
+    if (monitor and (not monitor->advance(1))) {
+        return NULL;
+    }
+
+    LimitStencilTable * result = new LimitStencilTable(numControlVerts);
+    if (builder.ReleaseStencils(0, result->_sizes, result->_indices,
+            result->_weights, &result->_duWeights, &result->_dvWeights)) {
+        result->generateOffsets();
+        return result;
+    }
+    delete result;
+
+    return new LimitStencilTable(numControlVerts,
+                                 builder.GetStencilOffsets(),
+                                 builder.GetStencilSizes(),
+                                 builder.GetStencilSources(),
+                                 builder.GetStencilWeights(),
+                                 builder.GetStencilDuWeights(),
+                                 builder.GetStencilDvWeights(),
+                                 builder.GetStencilDuuWeights(),
+                                 builder.GetStencilDuvWeights(),
+                                 builder.GetStencilDvvWeights(),
+                                 /*ctrlVerts*/false,
+                                 /*firstOffset*/0);
+}
+
+bool
+StencilTableFactory::GetLevelStencilCounts(TopologyRefiner const & refiner,
+    Options const & options, std::vector<Index> & counts) {
+
+    counts.clear();
+    if ((not options.generateIntermediateLevels) or options.projectToLimit or
+        (options.shareIntermediateLevels and options.factorizeIntermediateLevels and
+         (not options.generateControlVerts))) {
+        return false;
+    }
+
+    // (the stencils of the edited control vertices replace their trivial
+    // stencils, see createLevelsTable())
+    int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
+
+    Index count = options.generateControlVerts ?
+        refiner.GetLevel(0).GetNumVertices() : 0;
+    counts.push_back(count);
+    for (int level=1; level<=maxlevel; ++level) {
+        count += refiner.GetLevel(level).GetNumVertices();
+        counts.push_back(count);
+    }
+    return true;
+}
+
+StencilTable *
+StencilTableFactory::createLevelsTable(internal::StencilBuilder & builder,
+    Options const & options, int numBaseVerts, int numControlVerts,
+        bool applyEdits, bool editBaseLevel, size_t levelsOffset,
+            size_t levelOffset, std::vector<size_t> const & levelStarts,
+                int level, bool release) {
+
+    // (the stencils of unfactorized levels refer to the intermediate levels,
+    // which are then always generated)
+    size_t firstOffset = levelsOffset;
+    if (not options.generateIntermediateLevels and level>0 and
+        options.factorizeIntermediateLevels)
+        firstOffset = levelOffset;
+
+    std::vector<int> const * offsets = &builder.GetStencilOffsets();
+    std::vector<int> const * sizes = &builder.GetStencilSizes();
+
+    // With vertex edits, the stencils of the edit values are skipped and
+    // those of the edited control vertices replace the trivial ones
+    std::vector<int> editedOffsets,
+                     editedSizes;
+    if (applyEdits) {
+        int controlOffset = editBaseLevel ? numControlVerts : 0;
+
+        editedOffsets.assign(offsets->begin() + controlOffset,
+                             offsets->begin() + controlOffset + numBaseVerts);
+        editedOffsets.insert(editedOffsets.end(),
+                             offsets->begin() + firstOffset, offsets->end());
+        editedSizes.assign(sizes->begin() + controlOffset,
+                           sizes->begin() + controlOffset + numBaseVerts);
+        editedSizes.insert(editedSizes.end(),
+                           sizes->begin() + firstOffset, sizes->end());
+
+        offsets = &editedOffsets;
+        sizes = &editedSizes;
+        firstOffset = numBaseVerts;
+    }
+
+    // Move (or copy) stencils from the StencilBuilder into the StencilTable
+    // -- the arrays of the last stencils of the builder are moved rather
+    // than copied when they are all included
+    // Always initialize numControlVertices (useful for torus case)
+    StencilTable * result = 0;
+    if (release and (not applyEdits) and ((not options.generateControlVerts) or
+        (int)firstOffset==numControlVerts)) {
+        result = new StencilTable(numBaseVerts);
+        if (builder.ReleaseStencils(options.generateControlVerts ? 0 : (int)firstOffset,
+            result->_sizes, result->_indices, result->_weights)) {
+            result->generateOffsets();
+        } else {
+            delete result;
+            result = 0;
+        }
+    }
+    if (not result) {
+        result = new StencilTable(numBaseVerts,
+                                  *offsets,
+                                  *sizes,
+                                  builder.GetStencilSources(),
+                                  builder.GetStencilWeights(),
+                                  options.generateControlVerts,
+                                  firstOffset);
+    }
+    result->_numControlVertices = numControlVerts;
+
+    // Stencils of unfactorized levels refer to the vertices of the previous
+    // levels : each level past the first is a pass of its own
+    if ((not options.factorizeIntermediateLevels) and level>1) {
+        size_t base = options.generateControlVerts ? 0 : firstOffset;
+        result->_passOffsets.push_back(0);
+        for (int i=2; i<=level; ++i) {
+            result->_passOffsets.push_back((Index)(levelStarts[i] - base));
+        }
+    }
+    return result;
+}
+
+//
+// Concurrent interpolation of the stencils of a level
+//
+// The child vertices of a level are partitioned into ranges by the type and
+// index of their parent components.  Each range is accumulated by its own
+// StencilBuilder (resolving source stencils from the shared builder, which
+// remains unmodified meanwhile) and the ranges are then appended in the order
+// they would have been interpolated serially -- so the resulting stencils are
+// identical to those of the serial method.
+//
+// Child vertices of edges and vertices may depend on the child vertices of
+// faces within the same level, so those of faces are appended first.
+//
+namespace {
+    struct LevelRange {
+        LevelRange(int type, int b, int e) :
+            parentType(type), begin(b), end(e), builder(0) { }
+
+        int parentType;  // 0 = faces, 1 = edges, 2 = vertices
+        int begin;
+        int end;
+
+        internal::StencilBuilder * builder;
+    };
+
+    struct LevelRangeData {
+        PrimvarRefiner const *     primvarRefiner;
+        internal::StencilBuilder * builder;
+        int                        level;
+        int                        srcOffset;
+        int                        dstOffset;
+        std::vector<LevelRange> *  ranges;
+        BuildMonitor *             monitor;
+    };
+}
+
+void
+StencilTableFactory::interpolateLevelRanges(int begin, int end, void * data) {
+
+    LevelRangeData const & levelData = *static_cast<LevelRangeData *>(data);
+
+    PrimvarRefiner const & primvarRefiner = *levelData.primvarRefiner;
+
+    for (int i=begin; i<end; ++i) {
+        LevelRange & range = (*levelData.ranges)[i];
+
+        range.builder = new internal::StencilBuilder(levelData.builder);
+
+        // (the ranges of a cancelled build are left empty)
+        if (levelData.monitor and levelData.monitor->IsCancelled()) {
+            continue;
+        }
+
+        internal::StencilBuilder::Index srcIndex(range.builder, levelData.srcOffset);
+        internal::StencilBuilder::Index dstIndex(range.builder, levelData.dstOffset);
+
+        switch (range.parentType) {
+        case 0:
+            primvarRefiner.interpolateFromFaces(levelData.level,
+                srcIndex, dstIndex, range.begin, range.end);
+            break;
+        case 1:
+            primvarRefiner.interpolateFromEdges(levelData.level,
+                srcIndex, dstIndex, range.begin, range.end);
+            break;
+        case 2:
+            primvarRefiner.interpolateFromVerts(levelData.level,
+                srcIndex, dstIndex, range.begin, range.end);
+            break;
+        }
+
+        if (levelData.monitor) {
+            levelData.monitor->advance(range.end - range.begin);
+        }
+    }
+}
+
+void
+StencilTableFactory::interpolateLevelConcurrently(TaskScheduler const & scheduler,
+    PrimvarRefiner const & primvarRefiner, int level,
+        internal::StencilBuilder & builder, int srcOffset, int dstOffset,
+            BuildMonitor * monitor) {
+
+    TopologyLevel const & parent =
+        primvarRefiner.GetTopologyRefiner().GetLevel(level-1);
+
+    int numParents[3] = { parent.GetNumFaces(),
+                          parent.GetNumEdges(),
+                          parent.GetNumVertices() };
+
+    int rangeSize = getRangeSize(
+        std::max(numParents[0], std::max(numParents[1], numParents[2])), scheduler);
+
+    LevelRangeData data;
+    data.primvarRefiner = &primvarRefiner;
+    data.builder = &builder;
+    data.level = level;
+    data.srcOffset = srcOffset;
+    data.dstOffset = dstOffset;
+    data.monitor = monitor;
+
+    std::vector<LevelRange> ranges;
+    data.ranges = &ranges;
+
+    // Two passes: vertices from faces, then those from edges and vertices
+    for (int pass=0; pass<2; ++pass) {
+
+        ranges.clear();
+        for (int type=(pass ? 1 : 0); type<=(pass ? 2 : 0); ++type) {
+            for (int b=0; b<numParents[type]; b+=rangeSize) {
+                ranges.push_back(
+                    LevelRange(type, b, std::min(b+rangeSize, numParents[type])));
+            }
+        }
+
+        scheduler.ParallelFor(0, (int)ranges.size(), 1, interpolateLevelRanges, &data);
+
+        for (int i=0; i<(int)ranges.size(); ++i) {
+            builder.Append(*ranges[i].builder);
+            delete ranges[i].builder;
+        }
+    }
+}
+
+
+//
+// Factorization of the stencils over shared levels
+//
+// Fully factorized stencils grow with the level of their vertices, converging
+// to the support of their limit position, while the stencils of a level over
+// the vertices of the previous one remain small.  Keeping the vertices of some
+// intermediate levels as the sources of the stencils of the following levels
+// -- as "virtual" vertices interpolated by earlier passes -- shares their
+// weights among all the stencils referring to them.
+//
+// The shared levels are chosen to minimize the total number of weights, each
+// virtual vertex that would not be interpolated otherwise counting as one more
+// weight.  The number of weights of every level factorized over each of the
+// previous levels is measured first, by accumulating the stencils of all the
+// levels following each level in turn : the table is more expensive to create.
+//
+void
+StencilTableFactory::interpolateSharedLevels(TopologyRefiner const & refiner,
+    Options const & options, int firstLevel, int maxlevel,
+        std::vector<int> const & levelOffsets,
+            std::vector<bool> const & sharedLevels,
+                internal::StencilBuilder & builder,
+                    std::vector<size_t> * levelWeights) {
+
+    bool interpolateVarying = options.interpolationMode==INTERPOLATE_VARYING;
+
+    PrimvarRefiner primvarRefiner(refiner);
+
+    TaskScheduler const * scheduler = options.taskScheduler;
+    if (scheduler and (scheduler->GetNumThreads() < 2 or interpolateVarying)) {
+        scheduler = 0;
+    }
+
+    internal::StencilBuilder::Index srcIndex(&builder, levelOffsets[firstLevel]);
+    internal::StencilBuilder::Index dstIndex(&builder, levelOffsets[firstLevel+1]);
+
+    builder.SetCoarseVertCount(levelOffsets[firstLevel+1]);
+
+    for (int level=firstLevel+1; level<=maxlevel; ++level) {
+
+        size_t numWeights = builder.GetStencilSources().size();
+
+        if (scheduler) {
+            interpolateLevelConcurrently(*scheduler, primvarRefiner, level,
+                builder, srcIndex.GetOffset(), dstIndex.GetOffset());
+        } else if (not interpolateVarying) {
+            primvarRefiner.Interpolate(level, srcIndex, dstIndex);
+        } else {
+            primvarRefiner.InterpolateVarying(level, srcIndex, dstIndex);
+        }
+
+        if (levelWeights) {
+            levelWeights->push_back(builder.GetStencilSources().size() - numWeights);
+        }
+
+        // Stencils of the following levels are flattened down to the
+        // vertices of the last shared level
+        if (sharedLevels[level]) {
+            builder.SetCoarseVertCount(levelOffsets[level+1]);
+        }
+
+        srcIndex = dstIndex;
+        dstIndex = dstIndex[refiner.GetLevel(level).GetNumVertices()];
+    }
+}
+
+StencilTable const *
+StencilTableFactory::createSharedLevels(TopologyRefiner const & refiner,
+    Options const & options, int maxlevel) {
+
+    int numControlVerts = refiner.GetLevel(0).GetNumVertices();
+
+    std::vector<int> levelOffsets(maxlevel+2, 0);
+    for (int level=0; level<=maxlevel; ++level) {
+        levelOffsets[level+1] =
+            levelOffsets[level] + refiner.GetLevel(level).GetNumVertices();
+    }
+
+    // Number of weights of each level factorized over each of the previous
+    // levels : levelWeights[base][level-base-1]
+    std::vector<bool> sharedLevels(maxlevel+1, false);
+
+    std::vector<std::vector<size_t> > levelWeights(maxlevel);
+    for (int base=0; base<maxlevel; ++base) {
+        internal::StencilBuilder builder(numControlVerts,
+                                    /*genControlVerts*/ false,
+                                    /*compactWeights*/  true);
+        interpolateSharedLevels(refiner, options, base, maxlevel,
+            levelOffsets, sharedLevels, builder, &levelWeights[base]);
+    }
+
+    // Select the shared levels with the smallest total cost : cost[level] is
+    // that of the stencils of the levels up to 'level', given that 'level' is
+    // shared (or is the last one)
+    std::vector<size_t> cost(maxlevel+1, 0);
+    std::vector<int> baseLevels(maxlevel+1, 0);
+    for (int level=1; level<=maxlevel; ++level) {
+        for (int base=0; base<level; ++base) {
+            size_t numWeights = 0;
+            if (options.generateIntermediateLevels) {
+                for (int i=base+1; i<=level; ++i) {
+                    numWeights += levelWeights[base][i-base-1];
+                }
+            } else {
+                numWeights = levelWeights[base][level-base-1];
+            }
+            size_t c = cost[base] + numWeights;
+            if (base==0 or c<cost[level]) {
+                cost[level] = c;
+                baseLevels[level] = base;
+            }
+        }
+        if (level<maxlevel and not options.generateIntermediateLevels) {
+            cost[level] += refiner.GetLevel(level).GetNumVertices();
+        }
+    }
+    for (int level=baseLevels[maxlevel]; level>0; level=baseLevels[level]) {
+        sharedLevels[level] = true;
+    }
+
+    internal::StencilBuilder builder(numControlVerts,
+                                /*genControlVerts*/ false,
+                                /*compactWeights*/  true);
+    interpolateSharedLevels(refiner, options, 0, maxlevel,
+        levelOffsets, sharedLevels, builder, 0);
+
+    std::vector<int> const & offsets = builder.GetStencilOffsets(),
+                           & sizes = builder.GetStencilSizes(),
+                           & sources = builder.GetStencilSources();
+    std::vector<float> const & weights = builder.GetStencilWeights();
+
+    // Index of the first vertex of each level in the primvar buffer, where
+    // refined vertices follow the control vertices (-1 if not interpolated)
+    std::vector<int> bufferOffsets(maxlevel+1, -1);
+    bufferOffsets[0] = 0;
+
+    int numStencils = 0,
+        numElements = 0;
+    for (int level=1; level<=maxlevel; ++level) {
+        if (options.generateIntermediateLevels or sharedLevels[level] or
+            level==maxlevel) {
+            bufferOffsets[level] = numControlVerts + numStencils;
+            for (int i=levelOffsets[level]; i<levelOffsets[level+1]; ++i) {
+                if (i<(int)sizes.size()) numElements += sizes[i];
+            }
+            numStencils += refiner.GetLevel(level).GetNumVertices();
+        }
+    }
+
+    StencilTable * result = new StencilTable(numControlVerts);
+    result->resize(numStencils, numElements);
+
+    int * dstSizes = result->_sizes.empty() ? 0 : &result->_sizes[0];
+    Index * dstIndices = result->_indices.empty() ? 0 : &result->_indices[0];
+    float * dstWeights = result->_weights.empty() ? 0 : &result->_weights[0];
+
+    int stencil = 0,
+        passBase = 0;
+    for (int level=1; level<=maxlevel; ++level) {
+        if (bufferOffsets[level]<0) continue;
+
+        // Stencils refer to the vertices of their base level : a new pass
+        // starts with each base level
+        int base = level-1;
+        while (base>0 and not sharedLevels[base]) --base;
+
+        if (base!=passBase) {
+            if (result->_passOffsets.empty()) {
+                result->_passOffsets.push_back(0);
+            }
+            result->_passOffsets.push_back(stencil);
+            passBase = base;
+        }
+
+        int srcOffset = levelOffsets[base],
+            bufferOffset = bufferOffsets[base];
+
+        for (int i=levelOffsets[level]; i<levelOffsets[level+1]; ++i) {
+            int size = i<(int)sizes.size() ? sizes[i] : 0;
+            for (int j=0; j<size; ++j) {
+                *dstIndices++ = sources[offsets[i]+j] - srcOffset + bufferOffset;
+                *dstWeights++ = weights[offsets[i]+j];
+            }
+            *dstSizes++ = size;
+        }
+        stencil += refiner.GetLevel(level).GetNumVertices();
+    }
+
+    result->generateOffsets();
+
+    return result;
+}
+//------------------------------------------------------------------------------
+
+StencilTable const *
+StencilTableFactory::Create(int numTables, StencilTable const ** tables,
+    bool deleteTables) {
+
+    // XXXtakahito:
+    // This function returns NULL for empty inputs or erroneous condition.
+    // It's convenient for skipping varying stencils etc, however,
+    // other Create() API returns an empty stencil instead of NULL.
+    // They need to be consistent.
+
+    if ( (numTables<=0) or (not tables)) {
+        return NULL;
+    }
+
+    int ncvs = -1,
+        nstencils = 0,
+        nelems = 0;
+
+    for (int i=0; i<numTables; ++i) {
+
+        StencilTable const * st = tables[i];
+        // allow the tables could have a null entry.
+        if (!st) continue;
+
+        if (ncvs >= 0 and st->GetNumControlVertices() != ncvs) {
+            return NULL;
+        }
+        ncvs = st->GetNumControlVertices();
+        nstencils += st->GetNumStencils();
+        nelems += (int)st->GetControlIndices().size();
+    }
+
+    if (ncvs == -1) {
+        return NULL;
+    }
+
+    StencilTable * result = new StencilTable;
+
+    if (deleteTables) {
+        // The arrays of the first table are moved to the result, and those
+        // of the others appended and freed in turn
+        bool first = true;
+        for (int i=0; i<numTables; ++i) {
+            // (the tables are owned by the caller, which hands them over)
+            StencilTable * st = const_cast<StencilTable *>(tables[i]);
+            if (!st) continue;
+
+            if (first) {
+                moveStencils(*st, *result, nstencils, nelems);
+                first = false;
+            } else {
+                result->_sizes.insert(result->_sizes.end(),
+                    st->_sizes.begin(), st->_sizes.end());
+                result->_indices.insert(result->_indices.end(),
+                    st->_indices.begin(), st->_indices.end());
+                result->_weights.insert(result->_weights.end(),
+                    st->_weights.begin(), st->_weights.end());
+            }
+            delete st;
+        }
+    } else {
+        result->resize(nstencils, nelems);
+
+        int * sizes = &result->_sizes[0];
+        Index * indices = &result->_indices[0];
+        float * weights = &result->_weights[0];
+        for (int i=0; i<numTables; ++i) {
+            StencilTable const * st = tables[i];
+            if (!st) continue;
+
+            int st_nstencils = st->GetNumStencils(),
+                st_nelems = (int)st->_indices.size();
+            memcpy(sizes, &st->_sizes[0], st_nstencils*sizeof(int));
+            memcpy(indices, &st->_indices[0], st_nelems*sizeof(Index));
+            memcpy(weights, &st->_weights[0], st_nelems*sizeof(float));
+
+            sizes += st_nstencils;
+            indices += st_nelems;
+            weights += st_nelems;
+        }
+    }
+
+    result->_numControlVertices = ncvs;
+
+    // have to re-generate offsets from scratch
+    result->generateOffsets();
+
+    return result;
+}
+
+StencilTable const *
+StencilTableFactory::Create(int numControlVerts, std::vector<int> & sizes,
+    std::vector<Index> & indices, std::vector<float> & weights) {
+
+    size_t numWeights = 0;
+    for (size_t i=0; i<sizes.size(); ++i) {
+        if (sizes[i] < 0) {
+            numWeights = indices.size() + 1;
+            break;
+        }
+        numWeights += sizes[i];
+    }
+    bool valid = numControlVerts >= 0 and numWeights==indices.size() and
+                 numWeights==weights.size();
+    for (size_t i=0; valid and i<indices.size(); ++i) {
+        valid = indices[i] >= 0 and indices[i] < numControlVerts;
+    }
+    if (not valid) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::Create() -- "
+            "inconsistent arrays of stencils.");
+        return NULL;
+    }
+
+    StencilTable * result = new StencilTable(numControlVerts);
+    result->_sizes.swap(sizes);
+    result->_indices.swap(indices);
+    result->_weights.swap(weights);
+    result->generateOffsets();
+    return result;
+}
+
+void
+StencilTableFactory::moveStencils(StencilTable & src, StencilTable & dst,
+    int numStencils, int numWeights) {
+
+    dst._numControlVertices = src._numControlVertices;
+
+    // (each array is reallocated at most once, when reserved)
+    std::vector<Index>().swap(src._offsets);
+    dst._sizes.swap(src._sizes);
+    dst._sizes.reserve(numStencils);
+    dst._indices.swap(src._indices);
+    dst._indices.reserve(numWeights);
+    dst._weights.swap(src._weights);
+    dst._weights.reserve(numWeights);
+}
+
+//------------------------------------------------------------------------------
+
+StencilTable const *
+StencilTableFactory::AppendLocalPointStencilTable(
+    TopologyRefiner const &refiner,
+    StencilTable const * baseStencilTable,
+    StencilTable const * localPointStencilTable,
+    bool factorize,
+    bool deleteBaseTable) {
+
+    OPENSUBDIV_PROFILE_ZONE("StencilTableFactory::AppendLocalPointStencilTable");
+
+    // factorize and append.
+    if (baseStencilTable == NULL or
+        localPointStencilTable == NULL or
+        localPointStencilTable->GetNumStencils() == 0) return NULL;
+
+    // baseStencilTable can be built with or without singular stencils
+    // (single weight of 1.0f) as place-holders for coarse mesh vertices.
+
+    int controlVertsIndexOffset = 0;
+    int nBaseStencils = baseStencilTable->GetNumStencils();
+    int nBaseStencilsElements = (int)baseStencilTable->_indices.size();
+    {
+        int nverts = refiner.GetNumVerticesTotal();
+        if (nBaseStencils == nverts) {
+
+            // the table contain stencils for the control vertices
+            //
+            //  <-----------------  nverts ------------------>
+            //
+            //  +---------------+----------------------------+-----------------+
+            //  | control verts | refined verts   : (max lv) |   local points  |
+            //  +---------------+----------------------------+-----------------+
+            //  |          base stencil table                |    LP stencils  |
+            //  +--------------------------------------------+-----------------+
+            //                         ^                           /
+            //                          \_________________________/
+            //
+            //
+            controlVertsIndexOffset = 0;
+
+        } else if (nBaseStencils == (nverts -refiner.GetLevel(0).GetNumVertices())) {
+
+            // the table does not contain stencils for the control vertices
+            //
+            //  <-----------------  nverts ------------------>
+            //                  <------ nBaseStencils ------->
+            //  +---------------+----------------------------+-----------------+
+            //  | control verts | refined verts   : (max lv) |   local points  |
+            //  +---------------+----------------------------+-----------------+
+            //                  |     base stencil table     |    LP stencils  |
+            //                  +----------------------------+-----------------+
+            //                                 ^                   /
+            //                                  \_________________/
+            //  <-------------->
+            //                 controlVertsIndexOffset
+            //
+            controlVertsIndexOffset = refiner.GetLevel(0).GetNumVertices();
+
+        } else {
+            // these are not the stencils you are looking for.
+            assert(0);
+            return NULL;
+        }
+    }
+
+    // copy all local points stencils to proto stencils, and factorize if needed.
+    int nLocalPointStencils = localPointStencilTable->GetNumStencils();
+    int nLocalPointStencilsElements = 0;
+
+    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
+                                /*genControlVerts*/ false,
+                                /*compactWeights*/  factorize);
+
+    // Base stencils of several passes refer to refined vertices, which are
+    // sources of the local points as such, as are those of unfactorized
+    // local points : the sources are then the indices of the vertices in the
+    // buffer of the control vertices followed by the base stencils
+    int numBufferVerts = refiner.GetLevel(0).GetNumVertices() + nBaseStencils;
+    if ((not factorize) or (not baseStencilTable->_passOffsets.empty())) {
+        builder.SetCoarseVertCount(numBufferVerts);
+    }
+
+    internal::StencilBuilder::Index origin(&builder, 0);
+    internal::StencilBuilder::Index dst = origin;
+    internal::StencilBuilder::Index srcIdx = origin;
+
+    for (int i = 0 ; i < nLocalPointStencils; ++i) {
+        Stencil src = localPointStencilTable->GetStencil(i);
+        dst = origin[i];
+        for (int j = 0; j < src.GetSize(); ++j) {
+            Index index = src.GetVertexIndices()[j];
+            float weight = src.GetWeights()[j];
+            if (isWeightZero(weight)) continue;
+
+            if (factorize) {
+                dst.AddWithWeight(
+                    // subtracting controlVertsIndex if the baseStencil doesn't
+                    // include control vertices (see above diagram)
+                    // since currently local point stencils are created with
+                    // absolute indices including control (level=0) vertices.
+                    baseStencilTable->GetStencil(index - controlVertsIndexOffset),
+                    weight);
+            } else {
+                // (the stencils of the control vertices, if any, follow the
+                // control vertices in the buffer)
+                srcIdx = origin[index +
+                    refiner.GetLevel(0).GetNumVertices() - controlVertsIndexOffset];
+                dst.AddWithWeight(srcIdx, weight);
+            }
+        }
+        nLocalPointStencilsElements += builder.GetNumVertsInStencil(i);
+    }
+
+    // create new stencil table
+    StencilTable * result = new StencilTable;
+    result->_numControlVertices = refiner.GetLevel(0).GetNumVertices();
+
+    // Local points are evaluated with the last pass of the base stencils,
+    // unless they refer to the refined vertices (unfactorized) : they are
+    // then a pass of their own
+    result->_passOffsets = baseStencilTable->_passOffsets;
+    if ((not factorize) and nLocalPointStencils > 0 and nBaseStencils > 0) {
+        if (result->_passOffsets.empty()) {
+            result->_passOffsets.push_back(0);
+        }
+        result->_passOffsets.push_back(nBaseStencils);
+    }
+
+    // put base stencils first (moved from a base table handed over)
+    if (deleteBaseTable) {
+        StencilTable * base = const_cast<StencilTable *>(baseStencilTable);
+        moveStencils(*base, *result, nBaseStencils + nLocalPointStencils,
+                     nBaseStencilsElements + nLocalPointStencilsElements);
+        result->_numControlVertices = refiner.GetLevel(0).GetNumVertices();
+        delete base;
+    }
+    result->resize(nBaseStencils + nLocalPointStencils,
+                   nBaseStencilsElements + nLocalPointStencilsElements);
+
+    int* sizes = &result->_sizes[0];
+    Index * indices = &result->_indices[0];
+    float * weights = &result->_weights[0];
+
+    if (not deleteBaseTable) {
+        memcpy(sizes, &baseStencilTable->_sizes[0],
+               nBaseStencils*sizeof(int));
+        memcpy(indices, &baseStencilTable->_indices[0],
+               nBaseStencilsElements*sizeof(Index));
+        memcpy(weights, &baseStencilTable->_weights[0],
+               nBaseStencilsElements*sizeof(float));
+    }
+
+    sizes += nBaseStencils;
+    indices += nBaseStencilsElements;
+    weights += nBaseStencilsElements;
+
+    // endcap stencils second
+    for (int i = 0 ; i < nLocalPointStencils; ++i) {
+        int size = builder.GetNumVertsInStencil(i);
+        int idx = builder.GetStencilOffsets()[i];
+        for (int j = 0; j < size; ++j) {
+            *indices++ = builder.GetStencilSources()[idx+j];
+            *weights++ = builder.GetStencilWeights()[idx+j];
+        }
+        *sizes++ = size;
+    }
+
+    // have to re-generate offsets from scratch
+    result->generateOffsets();
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+// Reordering of stencils for locality
+//
+// Each stencil is keyed by the control vertex of its largest weight (the
+// smallest index on ties) and stencils are stable-sorted by key : stencils of
+// the refined vertices around a control vertex end up contiguous and gather
+// their values from the same neighborhood of control vertices.
+//
+namespace {
+    struct StencilControl {
+        Index index;
+        float weight;
+
+        bool operator < (StencilControl const & other) const {
+            return index < other.index;
+        }
+    };
+}
+
+StencilTable const *
+StencilTableFactory::ReorderStencils(
+    StencilTable const * table, std::vector<Index> & permutation) {
+
+    permutation.clear();
+    if (table == NULL) return NULL;
+
+    int nStencils = table->GetNumStencils(),
+        nControlVerts = table->GetNumControlVertices();
+
+    // offsets are optional in the input table
+    std::vector<Index> offsets(nStencils);
+    for (int i=0, offset=0; i<nStencils; ++i) {
+        offsets[i] = offset;
+        offset += table->_sizes[i];
+    }
+
+    // Leading stencils of the control vertices are left in place
+    int nFixed = 0;
+    for ( ; nFixed<std::min(nStencils, nControlVerts); ++nFixed) {
+        Index offset = offsets[nFixed];
+        if (table->_sizes[nFixed]!=1 or table->_indices[offset]!=nFixed or
+            table->_weights[offset]!=1.0f) break;
+    }
+
+    std::vector<std::pair<Index, Index> > keys(nStencils-nFixed);
+    int nElements = 0;
+    for (int i=nFixed; i<nStencils; ++i) {
+
+        Index const * indices = &table->_indices[offsets[i]];
+        float const * weights = &table->_weights[offsets[i]];
+
+        Index key = -1;
+        float keyWeight = 0.0f;
+        for (int j=0; j<table->_sizes[i]; ++j) {
+            if (indices[j]<0 or indices[j]>=nControlVerts) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in StencilTableFactory::ReorderStencils() -- "
+                    "stencil %d refers to vertex %d, which is not a control "
+                    "vertex (stencils must be factorized).", i, indices[j]);
+                return NULL;
+            }
+            if (isWeightZero(weights[j])) continue;
+
+            float w = std::abs(weights[j]);
+            if (key<0 or w>keyWeight or (w==keyWeight and indices[j]<key)) {
+                key = indices[j];
+                keyWeight = w;
+            }
+            ++nElements;
+        }
+        keys[i-nFixed] = std::make_pair(key, (Index)i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    StencilTable * result = new StencilTable;
+    result->_numControlVertices = nControlVerts;
+    result->resize(nStencils, nElements + nFixed);
+
+    permutation.resize(nStencils);
+
+    int * sizes = result->_sizes.empty() ? 0 : &result->_sizes[0];
+    Index * indices = result->_indices.empty() ? 0 : &result->_indices[0];
+    float * weights = result->_weights.empty() ? 0 : &result->_weights[0];
+
+    std::vector<StencilControl> controls;
+    for (int i=0; i<nStencils; ++i) {
+
+        Index src = (i<nFixed) ? i : keys[i-nFixed].second;
+        permutation[src] = i;
+
+        controls.clear();
+        for (int j=0; j<table->_sizes[src]; ++j) {
+            Index offset = offsets[src] + j;
+            if (isWeightZero(table->_weights[offset]) and src>=nFixed) continue;
+
+            StencilControl control;
+            control.index = table->_indices[offset];
+            control.weight = table->_weights[offset];
+            controls.push_back(control);
+        }
+        std::sort(controls.begin(), controls.end());
+
+        for (int j=0; j<(int)controls.size(); ++j) {
+            *indices++ = controls[j].index;
+            *weights++ = controls[j].weight;
+        }
+        *sizes++ = (int)controls.size();
+    }
+
+    result->generateOffsets();
+
+    return result;
+}
+
+StencilTable const *
+StencilTableFactory::PermuteStencils(
+    StencilTable const * table, std::vector<Index> const & permutation) {
+
+    if (table == NULL) return NULL;
+
+    int nStencils = table->GetNumStencils(),
+        nControlVerts = table->GetNumControlVertices(),
+        nPermuted = (int)permutation.size();
+
+    if (nPermuted > nStencils or not table->_passOffsets.empty()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::PermuteStencils() -- "
+            "the permutation does not match the stencils of the table.");
+        return NULL;
+    }
+
+    // source stencil of each stencil of the result
+    std::vector<Index> sources(nStencils, Vtr::INDEX_INVALID);
+    for (int i=0; i<nStencils; ++i) {
+        Index dst = (i<nPermuted) ? permutation[i] : i;
+        if (dst<0 or dst>=nStencils or Vtr::IndexIsValid(sources[dst])) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in StencilTableFactory::PermuteStencils() -- "
+                "stencil %d is not moved to a stencil of its own.", i);
+            return NULL;
+        }
+        sources[dst] = i;
+    }
+
+    std::vector<Index> offsets(nStencils);
+    for (int i=0, offset=0; i<nStencils; ++i) {
+        offsets[i] = offset;
+        offset += table->_sizes[i];
+
+        for (int j=0; j<table->_sizes[i]; ++j) {
+            Index index = table->_indices[offsets[i] + j];
+            if (index<0 or index>=nControlVerts) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in StencilTableFactory::PermuteStencils() -- "
+                    "stencil %d refers to vertex %d, which is not a control "
+                    "vertex (stencils must be factorized).", i, index);
+                return NULL;
+            }
+        }
+    }
+
+    StencilTable * result = new StencilTable;
+    result->_numControlVertices = nControlVerts;
+    result->resize(nStencils, (int)table->_indices.size());
+
+    Index * indices = result->_indices.empty() ? 0 : &result->_indices[0];
+    float * weights = result->_weights.empty() ? 0 : &result->_weights[0];
+
+    for (int i=0; i<nStencils; ++i) {
+        Index src = sources[i];
+        int size = table->_sizes[src];
+
+        std::copy(table->_indices.begin() + offsets[src],
+                  table->_indices.begin() + offsets[src] + size, indices);
+        std::copy(table->_weights.begin() + offsets[src],
+                  table->_weights.begin() + offsets[src] + size, weights);
+        indices += size;
+        weights += size;
+        result->_sizes[i] = size;
+    }
+
+    result->generateOffsets();
+
+    return result;
+}
+
+StencilTable const *
+StencilTableFactory::CreateTranspose(StencilTable const * table) {
+
+    if (table == NULL) return NULL;
+
+    if (not table->_passOffsets.empty()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreateTranspose() -- "
+            "tables of several passes cannot be transposed.");
+        return NULL;
+    }
+
+    int nStencils = table->GetNumStencils(),
+        nControlVerts = table->GetNumControlVertices();
+
+    // count the stencils referring to each control vertex
+    std::vector<int> sizes(nControlVerts, 0);
+    for (int i=0, offset=0; i<nStencils; offset+=table->_sizes[i++]) {
+        for (int j=0; j<table->_sizes[i]; ++j) {
+            Index index = table->_indices[offset+j];
+            if (index<0 or index>=nControlVerts) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in StencilTableFactory::CreateTranspose() -- "
+                    "stencil %d refers to vertex %d, which is not a control "
+                    "vertex (stencils must be factorized).", i, index);
+                return NULL;
+            }
+            if (not isWeightZero(table->_weights[offset+j])) {
+                ++sizes[index];
+            }
+        }
+    }
+
+    std::vector<Index> offsets(nControlVerts);
+    int nElements = 0;
+    for (int i=0; i<nControlVerts; ++i) {
+        offsets[i] = nElements;
+        nElements += sizes[i];
+    }
+
+    StencilTable * result = new StencilTable;
+    result->_numControlVertices = nStencils;
+    result->resize(nControlVerts, nElements);
+
+    // stencils visited in order leave the indices of each transposed stencil
+    // sorted
+    for (int i=0, offset=0; i<nStencils; offset+=table->_sizes[i++]) {
+        for (int j=0; j<table->_sizes[i]; ++j) {
+            float weight = table->_weights[offset+j];
+            if (isWeightZero(weight)) continue;
+
+            Index & dst = offsets[table->_indices[offset+j]];
+            result->_indices[dst] = i;
+            result->_weights[dst] = weight;
+            ++dst;
+        }
+    }
+    std::copy(sizes.begin(), sizes.end(), result->_sizes.begin());
+
+    result->generateOffsets();
+
+    return result;
+}
+
+StencilTable const *
+StencilTableFactory::CreatePartition(StencilTable const * table,
+    int start, int end, std::vector<Index> & controlVertices) {
+
+    controlVertices.clear();
+    if (table == NULL) return NULL;
+
+    int nStencils = table->GetNumStencils(),
+        nControlVerts = table->GetNumControlVertices();
+
+    if (start<0 or end>nStencils or start>end) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreatePartition() -- "
+            "range [%d, %d) out of the %d stencils of the table.",
+            start, end, nStencils);
+        return NULL;
+    }
+    if (not table->_passOffsets.empty()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreatePartition() -- "
+            "tables of several passes cannot be partitioned.");
+        return NULL;
+    }
+
+    // offsets are optional in the input table
+    Index first = 0;
+    for (int i=0; i<start; ++i) {
+        first += table->_sizes[i];
+    }
+    Index last = first;
+    for (int i=start; i<end; ++i) {
+        last += table->_sizes[i];
+    }
+
+    // mark the control vertices referenced by the range, then number them
+    // in increasing order
+    std::vector<Index> partitionIndex(nControlVerts, Vtr::INDEX_INVALID);
+    for (Index j=first; j<last; ++j) {
+        Index index = table->_indices[j];
+        if (index<0 or index>=nControlVerts) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in StencilTableFactory::CreatePartition() -- "
+                "stencil table refers to vertex %d, which is not a control "
+                "vertex (stencils must be factorized).", index);
+            return NULL;
+        }
+        partitionIndex[index] = 0;
+    }
+    for (int i=0; i<nControlVerts; ++i) {
+        if (partitionIndex[i] != Vtr::INDEX_INVALID) {
+            partitionIndex[i] = (Index)controlVertices.size();
+            controlVertices.push_back(i);
+        }
+    }
+
+    StencilTable * result = new StencilTable;
+    result->_numControlVertices = (int)controlVertices.size();
+    result->resize(end-start, last-first);
+
+    std::copy(table->_sizes.begin()+start, table->_sizes.begin()+end,
+        result->_sizes.begin());
+    for (Index j=first; j<last; ++j) {
+        result->_indices[j-first] = partitionIndex[table->_indices[j]];
+    }
+    std::copy(table->_weights.begin()+first, table->_weights.begin()+last,
+        result->_weights.begin());
+
+    result->generateOffsets();
+
+    return result;
+}
+
+namespace {
+    // orders the weights of a stencil by decreasing magnitude
+    struct WeightMagnitudeGreater {
+        WeightMagnitudeGreater(float const * weights) : _weights(weights) { }
+
+        bool operator()(int a, int b) const {
+            return std::abs(_weights[a]) > std::abs(_weights[b]);
+        }
+
+        float const * _weights;
+    };
+}
+
+StencilTable const *
+StencilTableFactory::CreateApproximation(StencilTable const * table,
+    float tolerance, int maxSize, float * maxError,
+        float const * controlPoints) {
+
+    if (table == NULL) return NULL;
+
+    if (not table->_passOffsets.empty()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StencilTableFactory::CreateApproximation() -- "
+            "tables of several passes cannot be approximated.");
+        return NULL;
+    }
+
+    int nStencils = table->GetNumStencils(),
+        nControlVerts = table->GetNumControlVertices();
+
+    for (int i=0; i<(int)table->_indices.size(); ++i) {
+        Index index = table->_indices[i];
+        if (index<0 or index>=nControlVerts) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in StencilTableFactory::CreateApproximation() -- "
+                "vertex %d is not a control vertex (stencils must be "
+                "factorized).", index);
+            return NULL;
+        }
+    }
+
+    StencilTable * result = new StencilTable;
+    result->_numControlVertices = nControlVerts;
+    result->_sizes.resize(nStencils);
+    result->reserve(nStencils, (int)table->_indices.size());
+
+    float error = 0.0f;
+
+    std::vector<int> order;
+    for (int i=0, offset=0; i<nStencils; offset+=table->_sizes[i++]) {
+
+        int size = table->_sizes[i];
+
+        Index const * indices = &table->_indices[offset];
+        float const * weights = &table->_weights[offset];
+
+        order.resize(size);
+        for (int j=0; j<size; ++j) {
+            order[j] = j;
+        }
+        std::stable_sort(order.begin(), order.end(),
+            WeightMagnitudeGreater(weights));
+
+        // keep the largest weight and the following ones above the tolerance
+        int nKept = size ? 1 : 0;
+        while (nKept<size and std::abs(weights[order[nKept]])>=tolerance and
+               (maxSize<=0 or nKept<maxSize)) {
+            ++nKept;
+        }
+
+        float sum = 0.0f,
+              keptSum = 0.0f;
+        for (int j=0; j<size; ++j) {
+            sum += weights[order[j]];
+            if (j<nKept) keptSum += weights[order[j]];
+        }
+        float scale = (nKept<size and not isWeightZero(keptSum)) ?
+            sum / keptSum : 1.0f;
+
+        // difference between the approximated and the exact stencil
+        float stencilError = 0.0f,
+              delta[3] = { 0.0f, 0.0f, 0.0f };
+        for (int j=0; j<size; ++j) {
+            float weight = weights[order[j]],
+                  diff = (j<nKept ? weight * scale : 0.0f) - weight;
+            if (controlPoints) {
+                float const * p = controlPoints + 3 * indices[order[j]];
+                delta[0] += diff * p[0];
+                delta[1] += diff * p[1];
+                delta[2] += diff * p[2];
+            } else {
+                stencilError += std::abs(diff);
+            }
+        }
+        if (controlPoints) {
+            stencilError = std::sqrt(delta[0]*delta[0] +
+                delta[1]*delta[1] + delta[2]*delta[2]);
+        }
+        error = std::max(error, stencilError);
+
+        for (int j=0; j<nKept; ++j) {
+            result->_indices.push_back(indices[order[j]]);
+            result->_weights.push_back(weights[order[j]] * scale);
+        }
+        result->_sizes[i] = nKept;
+    }
+
+    result->shrinkToFit();
+    result->generateOffsets();
+
+    if (maxError) {
+        *maxError = error;
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+//
+// Bezier points of regular patches
+//
+// Each row of the conversion matrix expresses a Bezier point of a uniform
+// cubic B-spline segment in terms of its 4 control points. The boundaries of
+// a patch are applied to the rows exactly as to the basis functions (see
+// Far::internal::Spline::AdjustBoundaryWeights).
+//
+namespace {
+    void
+    getBezierConversion(int boundary, float sRows[4][4], float tRows[4][4]) {
+
+        static float const rows[4][4] = {
+            { 1.0f/6.0f, 4.0f/6.0f, 1.0f/6.0f, 0.0f      },
+            { 0.0f,      4.0f/6.0f, 2.0f/6.0f, 0.0f      },
+            { 0.0f,      2.0f/6.0f, 4.0f/6.0f, 0.0f      },
+            { 0.0f,      1.0f/6.0f, 4.0f/6.0f, 1.0f/6.0f } };
+
+        for (int i = 0; i < 4; ++i) {
+            float * s = sRows[i],
+                  * t = tRows[i];
+            for (int j = 0; j < 4; ++j) {
+                s[j] = t[j] = rows[i][j];
+            }
+            if (boundary & 1) {
+                t[2] -= t[0];
+                t[1] += 2*t[0];
+                t[0] = 0;
+            }
+            if (boundary & 2) {
+                s[1] -= s[3];
+                s[2] += 2*s[3];
+                s[3] = 0;
+            }
+            if (boundary & 4) {
+                t[1] -= t[3];
+                t[2] += 2*t[3];
+                t[3] = 0;
+            }
+            if (boundary & 8) {
+                s[2] -= s[0];
+                s[1] += 2*s[0];
+                s[0] = 0;
+            }
+        }
+    }
+}
+
+StencilTable const *
+StencilTableFactory::CreateBezierPatchStencilTable(
+    PatchTable const & patchTable) {
+
+    PatchTable::PatchVertsTable const & cvs =
+        patchTable.GetPatchControlVerticesTable();
+
+    int numPoints = 0;
+    for (int i = 0; i < (int)cvs.size(); ++i) {
+        numPoints = std::max(numPoints, cvs[i] + 1);
+    }
+
+    StencilTable * result = new StencilTable(numPoints);
+
+    std::vector<int> & sizes = result->_sizes;
+    std::vector<Index> & indices = result->_indices;
+    std::vector<float> & weights = result->_weights;
+
+    sizes.assign(cvs.size(), 0);
+
+    for (int array = 0; array < patchTable.GetNumPatchArrays(); ++array) {
+
+        PatchDescriptor desc = patchTable.GetPatchArrayDescriptor(array);
+        if (desc.GetType() != PatchDescriptor::REGULAR) continue;
 
-    for (int level=1; level<=maxlevel; ++level) {
-        if (not interpolateVarying) {
-            primvarRefiner.Interpolate(level, srcIndex, dstIndex);
-        } else {
-            primvarRefiner.InterpolateVarying(level, srcIndex, dstIndex);
-        }
+        for (int patch = 0; patch < patchTable.GetNumPatches(array); ++patch) {
 
-        if (options.factorizeIntermediateLevels) {
-            srcIndex = dstIndex;
-        }
+            ConstIndexArray patchCvs = patchTable.GetPatchVertices(array, patch);
 
-        dstIndex = dstIndex[refiner.GetLevel(level).GetNumVertices()];
+            int first = (int)(&patchCvs[0] - &cvs[0]);
 
-        if (not options.factorizeIntermediateLevels) {
-            // All previous verts are considered as coarse verts, as a
-            // result, we don't update the srcIndex and update the coarse
-            // vertex count.
-            builder.SetCoarseVertCount(dstIndex.GetOffset());
+            float sRows[4][4], tRows[4][4];
+            getBezierConversion(
+                patchTable.GetPatchParam(array, patch).GetBoundary(),
+                sRows, tRows);
+
+            // Bezier point (i,j) combines the control vertices (a,b) with the
+            // weights of its rows in t and s
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                    int size = 0;
+                    for (int a = 0; a < 4; ++a) {
+                        for (int b = 0; b < 4; ++b) {
+                            float w = tRows[i][a] * sRows[j][b];
+                            if (isWeightZero(w)) continue;
+
+                            indices.push_back(patchCvs[4*a+b]);
+                            weights.push_back(w);
+                            ++size;
+                        }
+                    }
+                    sizes[first + 4*i+j] = size;
+                }
+            }
         }
     }
 
-    size_t firstOffset = refiner.GetLevel(0).GetNumVertices();
-    if (not options.generateIntermediateLevels)
-        firstOffset = srcIndex.GetOffset();
- 
-    // Copy stencils from the StencilBuilder into the StencilTable.
-    // Always initialize numControlVertices (useful for torus case)
-    StencilTable * result = 
-                        new StencilTable(refiner.GetLevel(0).GetNumVertices(),
-                                          builder.GetStencilOffsets(),
-                                          builder.GetStencilSizes(),
-                                          builder.GetStencilSources(),
-                                          builder.GetStencilWeights(),
-                                          options.generateControlVerts,
-                                          firstOffset);
+    result->generateOffsets();
+
     return result;
 }
 
 //------------------------------------------------------------------------------
+//
+// Generation of limit stencils
+//
+// The patches of the locations are first found (concurrently), and the
+// locations found are assigned a limit stencil, either in order or sorted by
+// patch. The stencils of ranges of consecutive limit stencils are then
+// accumulated independently and appended in order.
+//
+// The stencils of the control vertices of a patch are combined only once, for
+// all the consecutive limit stencils on the patch : their weights are gathered
+// into a dense table over the union of their sources, from which the weights
+// of each limit stencil are accumulated without any search or merge.
+//
+namespace {
+    struct LimitRangeData {
+        LimitStencilTableFactory::LocationArrayVec const * locationArrays;
+        std::vector<int> const *                           arrayOffsets;
+        std::vector<PatchMap::Handle const *> *            handles;
+        std::vector<int> const *                           stencilLocations;
+        std::vector<internal::StencilBuilder *> *          builders;
+
+        PatchMap const *           patchMap;
+        PatchTable const *         patchTable;
+        StencilTable const *       cvStencils;
+        internal::StencilBuilder * builder;
+        BuildMonitor *             monitor;
+        int                        numControlVerts;
+        int                        rangeSize;
+        int                        numStencils;
+        bool                       secondDerivatives;
+        bool                       patchPoints;
+    };
+
+    // Stencils of the control vertices of a patch combined over the union of
+    // their sources : the weights of the k-th control vertex of the patch
+    // are the k-th row of 'weights'.
+    struct PatchSupport {
+
+        PatchSupport(int numControlVerts) :
+            patchIndex(-1), numRows(0), columns(numControlVerts, -1) { }
+
+        void Set(int patch, StencilTable const & cvStencils,
+                 ConstIndexArray const & cvs) {
+
+            patchIndex = patch;
+            numRows = cvs.size();
+
+            sources.clear();
+            for (int k = 0; k < numRows; ++k) {
+                Stencil src = cvStencils[cvs[k]];
+                Index const * indices = src.GetVertexIndices();
+                for (int i = 0; i < src.GetSize(); ++i) {
+                    // limit stencils are factorized from control vertices
+                    assert(indices[i] < (int)columns.size());
+                    if (columns[indices[i]] < 0) {
+                        columns[indices[i]] = (int)sources.size();
+                        sources.push_back(indices[i]);
+                    }
+                }
+            }
 
-StencilTable const *
-StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
+            int numColumns = (int)sources.size();
 
-    // XXXtakahito:
-    // This function returns NULL for empty inputs or erroneous condition.
-    // It's convenient for skipping varying stencils etc, however,
-    // other Create() API returns an empty stencil instead of NULL.
-    // They need to be consistent.
+            weights.assign(numRows * numColumns, 0.0f);
+            for (int k = 0; k < numRows; ++k) {
+                Stencil src = cvStencils[cvs[k]];
+                Index const * indices = src.GetVertexIndices();
+                float const * srcWeights = src.GetWeights();
+                for (int i = 0; i < src.GetSize(); ++i) {
+                    weights[k*numColumns + columns[indices[i]]] += srcWeights[i];
+                }
+            }
 
-    if ( (numTables<=0) or (not tables)) {
-        return NULL;
-    }
+            for (int j = 0; j < numColumns; ++j) {
+                columns[sources[j]] = -1;
+            }
+        }
 
-    int ncvs = -1,
-        nstencils = 0,
-        nelems = 0;
+        // Accumulate the weights of the sources from the weights of the basis
+        // functions of the control vertices of the patch
+        void Combine(float const wCV[], float result[]) const {
 
-    for (int i=0; i<numTables; ++i) {
+            int numColumns = (int)sources.size();
 
-        StencilTable const * st = tables[i];
-        // allow the tables could have a null entry.
-        if (!st) continue;
+            std::fill(result, result + numColumns, 0.0f);
+            for (int k = 0; k < numRows; ++k) {
+                float w = wCV[k];
+                if (isWeightZero(w)) continue;
 
-        if (ncvs >= 0 and st->GetNumControlVertices() != ncvs) {
-            return NULL;
+                float const * row = &weights[k*numColumns];
+                for (int j = 0; j < numColumns; ++j) {
+                    result[j] += w * row[j];
+                }
+            }
         }
-        ncvs = st->GetNumControlVertices();
-        nstencils += st->GetNumStencils();
-        nelems += (int)st->GetControlIndices().size();
+
+        int                patchIndex,
+                           numRows;
+        std::vector<int>   columns,  // column of each control vertex (or -1)
+                           sources;
+        std::vector<float> weights;
+    };
+
+    // Add the weights of the points of the patch of a location (combining
+    // the weights of the points shared by several of its control vertices):
+    inline void
+    addPatchPointWeights(internal::StencilBuilder::Index dst,
+        ConstIndexArray const & cvs, float wP[], float wDs[], float wDt[],
+            float wDss[], float wDst[], float wDtt[], bool secondDerivatives) {
+
+        Index sources[20];
+
+        int n = 0;
+        for (int k = 0; k < cvs.size(); ++k) {
+            int j = 0;
+            while (j < n and sources[j] != cvs[k]) ++j;
+
+            if (j == n) {
+                sources[n++] = cvs[k];
+                wP[j] = wP[k];
+                wDs[j] = wDs[k];
+                wDt[j] = wDt[k];
+                if (secondDerivatives) {
+                    wDss[j] = wDss[k];
+                    wDst[j] = wDst[k];
+                    wDtt[j] = wDtt[k];
+                }
+            } else {
+                wP[j] += wP[k];
+                wDs[j] += wDs[k];
+                wDt[j] += wDt[k];
+                if (secondDerivatives) {
+                    wDss[j] += wDss[k];
+                    wDst[j] += wDst[k];
+                    wDtt[j] += wDtt[k];
+                }
+            }
+        }
+
+        dst.AddDistinctWeights(n, sources, wP, wDs, wDt,
+            secondDerivatives ? wDss : 0,
+            secondDerivatives ? wDst : 0,
+            secondDerivatives ? wDtt : 0);
     }
 
-    if (ncvs == -1) {
-        return NULL;
+    // Identify the array and index within it of a location:
+    inline void
+    getLocation(LimitRangeData const & data, int location, int & array, int & index) {
+
+        std::vector<int> const & offsets = *data.arrayOffsets;
+
+        array = (int)(std::upper_bound(offsets.begin(), offsets.end(), location)
+                    - offsets.begin()) - 1;
+        index = location - offsets[array];
     }
 
-    StencilTable * result = new StencilTable;
-    result->resize(nstencils, nelems);
+    void
+    findLimitPatches(int begin, int end, void * dataPtr) {
 
-    int * sizes = &result->_sizes[0];
-    Index * indices = &result->_indices[0];
-    float * weights = &result->_weights[0];
-    for (int i=0; i<numTables; ++i) {
-        StencilTable const * st = tables[i];
-        if (!st) continue;
+        LimitRangeData const & data = *static_cast<LimitRangeData *>(dataPtr);
 
-        int st_nstencils = st->GetNumStencils(),
-            st_nelems = (int)st->_indices.size();
-        memcpy(sizes, &st->_sizes[0], st_nstencils*sizeof(int));
-        memcpy(indices, &st->_indices[0], st_nelems*sizeof(Index));
-        memcpy(weights, &st->_weights[0], st_nelems*sizeof(float));
+        for (int i=begin; i<end; ++i) {
+            int array, index;
+            getLocation(data, i, array, index);
 
-        sizes += st_nstencils;
-        indices += st_nelems;
-        weights += st_nelems;
-    }
+            LimitStencilTableFactory::LocationArray const & locations =
+                (*data.locationArrays)[array];
+            assert(locations.ptexIdx>=0);
 
-    result->_numControlVertices = ncvs;
+            (*data.handles)[i] = data.patchMap->FindPatch(
+                locations.ptexIdx, locations.s[index], locations.t[index]);
+        }
+    }
 
-    // have to re-generate offsets from scratch
-    result->generateOffsets();
+    void
+    populateLimitStencils(int begin, int end, void * dataPtr) {
 
-    return result;
-}
+        LimitRangeData const & data = *static_cast<LimitRangeData *>(dataPtr);
 
-//------------------------------------------------------------------------------
+        float wP[20], wDs[20], wDt[20], wDss[20], wDst[20], wDtt[20];
 
-StencilTable const *
-StencilTableFactory::AppendLocalPointStencilTable(
-    TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
-    bool factorize) {
+        bool second = data.secondDerivatives;
 
-    // factorize and append.
-    if (baseStencilTable == NULL or
-        localPointStencilTable == NULL or
-        localPointStencilTable->GetNumStencils() == 0) return NULL;
+        PatchSupport support(data.numControlVerts);
 
-    // baseStencilTable can be built with or without singular stencils
-    // (single weight of 1.0f) as place-holders for coarse mesh vertices.
+        // weights of the sources of a limit stencil (point, first and
+        // optionally second derivatives)
+        std::vector<float> weights;
 
-    int controlVertsIndexOffset = 0;
-    int nBaseStencils = baseStencilTable->GetNumStencils();
-    int nBaseStencilsElements = (int)baseStencilTable->_indices.size();
-    {
-        int nverts = refiner.GetNumVerticesTotal();
-        if (nBaseStencils == nverts) {
+        for (int r=begin; r<end; ++r) {
 
-            // the table contain stencils for the control vertices
-            //
-            //  <-----------------  nverts ------------------>
-            //
-            //  +---------------+----------------------------+-----------------+
-            //  | control verts | refined verts   : (max lv) |   local points  |
-            //  +---------------+----------------------------+-----------------+
-            //  |          base stencil table                |    LP stencils  |
-            //  +--------------------------------------------+-----------------+
-            //                         ^                           /
-            //                          \_________________________/
-            //
-            //
-            controlVertsIndexOffset = 0;
+            // Ranges are accumulated directly into the builder when the
+            // stencils are generated serially
+            internal::StencilBuilder * builder = data.builder;
+            if (data.builders) {
+                builder = new internal::StencilBuilder(data.builder);
+                (*data.builders)[r] = builder;
+            }
 
-        } else if (nBaseStencils == (nverts -refiner.GetLevel(0).GetNumVertices())) {
+            internal::StencilBuilder::Index origin(builder, 0);
 
-            // the table does not contain stencils for the control vertices
-            //
-            //  <-----------------  nverts ------------------>
-            //                  <------ nBaseStencils ------->
-            //  +---------------+----------------------------+-----------------+
-            //  | control verts | refined verts   : (max lv) |   local points  |
-            //  +---------------+----------------------------+-----------------+
-            //                  |     base stencil table     |    LP stencils  |
-            //                  +----------------------------+-----------------+
-            //                                 ^                   /
-            //                                  \_________________/
-            //  <-------------->
-            //                 controlVertsIndexOffset
-            //
-            controlVertsIndexOffset = refiner.GetLevel(0).GetNumVertices();
+            // (the ranges of a cancelled build are left empty)
+            if (data.monitor and data.monitor->IsCancelled()) {
+                continue;
+            }
 
-        } else {
-            // these are not the stencils you are looking for.
-            assert(0);
-            return NULL;
-        }
-    }
+            int rangeEnd = std::min((r+1)*data.rangeSize, data.numStencils);
+            for (int i=r*data.rangeSize; i<rangeEnd; ++i) {
 
-    // copy all local points stencils to proto stencils, and factorize if needed.
-    int nLocalPointStencils = localPointStencilTable->GetNumStencils();
-    int nLocalPointStencilsElements = 0;
+                int location = (*data.stencilLocations)[i];
 
-    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
-                                /*genControlVerts*/ false,
-                                /*compactWeights*/  factorize);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
-    internal::StencilBuilder::Index srcIdx = origin;
+                PatchMap::Handle const & handle = *(*data.handles)[location];
 
-    for (int i = 0 ; i < nLocalPointStencils; ++i) {
-        Stencil src = localPointStencilTable->GetStencil(i);
-        dst = origin[i];
-        for (int j = 0; j < src.GetSize(); ++j) {
-            Index index = src.GetVertexIndices()[j];
-            float weight = src.GetWeights()[j];
-            if (isWeightZero(weight)) continue;
+                int array, index;
+                getLocation(data, location, array, index);
 
-            if (factorize) {
-                dst.AddWithWeight(
-                    // subtracting controlVertsIndex if the baseStencil doesn't
-                    // include control vertices (see above diagram)
-                    // since currently local point stencils are created with
-                    // absolute indices including control (level=0) vertices.
-                    baseStencilTable->GetStencil(index - controlVertsIndexOffset),
-                    weight);
-            } else {
-                srcIdx = origin[index + controlVertsIndexOffset];
-                dst.AddWithWeight(srcIdx, weight);
-            }
-        }
-        nLocalPointStencilsElements += builder.GetNumVertsInStencil(i);
-    }
+                float s = (*data.locationArrays)[array].s[index],
+                      t = (*data.locationArrays)[array].t[index];
 
-    // create new stencil table
-    StencilTable * result = new StencilTable;
-    result->_numControlVertices = refiner.GetLevel(0).GetNumVertices();
-    result->resize(nBaseStencils + nLocalPointStencils,
-                   nBaseStencilsElements + nLocalPointStencilsElements);
+                data.patchTable->EvaluateBasis(handle, s, t, wP, wDs, wDt,
+                    second ? wDss : 0, second ? wDst : 0, second ? wDtt : 0);
 
-    int* sizes = &result->_sizes[0];
-    Index * indices = &result->_indices[0];
-    float * weights = &result->_weights[0];
+                if (data.patchPoints) {
+                    addPatchPointWeights(origin[i],
+                        data.patchTable->GetPatchVertices(handle),
+                        wP, wDs, wDt, wDss, wDst, wDtt, second);
+                    continue;
+                }
 
-    // put base stencils first
-    memcpy(sizes, &baseStencilTable->_sizes[0],
-           nBaseStencils*sizeof(int));
-    memcpy(indices, &baseStencilTable->_indices[0],
-           nBaseStencilsElements*sizeof(Index));
-    memcpy(weights, &baseStencilTable->_weights[0],
-           nBaseStencilsElements*sizeof(float));
+                if (handle.patchIndex != support.patchIndex) {
+                    support.Set(handle.patchIndex, *data.cvStencils,
+                        data.patchTable->GetPatchVertices(handle));
+                    weights.resize(support.sources.size() * (second ? 6 : 3));
+                }
 
-    sizes += nBaseStencils;
-    indices += nBaseStencilsElements;
-    weights += nBaseStencilsElements;
+                int n = (int)support.sources.size();
+                if (n == 0) continue;
+
+                float * w = &weights[0];
+                support.Combine(wP,  w);
+                support.Combine(wDs, w + n);
+                support.Combine(wDt, w + 2*n);
+                if (second) {
+                    support.Combine(wDss, w + 3*n);
+                    support.Combine(wDst, w + 4*n);
+                    support.Combine(wDtt, w + 5*n);
+                }
 
-    // endcap stencils second
-    for (int i = 0 ; i < nLocalPointStencils; ++i) {
-        int size = builder.GetNumVertsInStencil(i);
-        int idx = builder.GetStencilOffsets()[i];
-        for (int j = 0; j < size; ++j) {
-            *indices++ = builder.GetStencilSources()[idx+j];
-            *weights++ = builder.GetStencilWeights()[idx+j];
+                origin[i].AddDistinctWeights(n, &support.sources[0],
+                    w, w + n, w + 2*n,
+                    second ? w + 3*n : 0,
+                    second ? w + 4*n : 0,
+                    second ? w + 5*n : 0);
+            }
         }
-        *sizes++ = size;
     }
+}
 
-    // have to re-generate offsets from scratch
-    result->generateOffsets();
+LimitStencilTable const *
+LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
+    LocationArrayVec const & locationArrays, StencilTable const * cvStencilsIn,
+        PatchTable const * patchTableIn, TaskScheduler const * scheduler,
+            bool generate2ndDerivatives) {
 
-    return result;
+    Options options;
+    options.generate2ndDerivatives = generate2ndDerivatives;
+    options.taskScheduler = scheduler;
+
+    return Create(refiner, locationArrays, options, cvStencilsIn, patchTableIn);
 }
 
-//------------------------------------------------------------------------------
 LimitStencilTable const *
 LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
-    LocationArrayVec const & locationArrays, StencilTable const * cvStencilsIn,
-        PatchTable const * patchTableIn) {
+    LocationArrayVec const & locationArrays, Options const & limitOptions,
+        StencilTable const * cvStencilsIn, PatchTable const * patchTableIn,
+            std::vector<int> * stencilLocationsOut) {
+
+    OPENSUBDIV_PROFILE_ZONE("LimitStencilTableFactory::Create");
+
+    TaskScheduler const * scheduler = limitOptions.taskScheduler;
 
-    // Compute the total number of stencils to generate
-    int numStencils=0, numLimitStencils=0;
+    BuildMonitor * monitor = limitOptions.monitor;
+
+    // Compute the total number of locations to generate stencils for
+    int numLocations=0;
     for (int i=0; i<(int)locationArrays.size(); ++i) {
         assert(locationArrays[i].numLocations>=0);
-        numStencils += locationArrays[i].numLocations;
+        numLocations += locationArrays[i].numLocations;
+    }
+    if (numLocations<=0) {
+        return 0;
     }
-    if (numStencils<=0) {
+
+    bool patchPoints = limitOptions.patchPointStencils;
+    if (patchPoints and (not cvStencilsIn or not patchTableIn)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in LimitStencilTableFactory::Create() -- "
+            "stencils of patch points require the StencilTable and the "
+            "PatchTable the patch points are evaluated from.");
         return 0;
     }
 
@@ -370,11 +2206,21 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
         options.generateIntermediateLevels = uniform ? false :true;
         options.generateControlVerts = true;
         options.generateOffsets = true;
+        options.taskScheduler = scheduler;
+        options.monitor = monitor;
 
         // PERFORMANCE: We could potentially save some mem-copies by not
         // instanciating the stencil tables and work directly off the source
         // data.
+        BuildMonitor::Range range;
+        if (monitor) range = monitor->enterRange(0.0f, 0.4f);
+
         cvstencils = StencilTableFactory::Create(refiner, options);
+
+        if (monitor) monitor->restoreRange(range);
+        if (not cvstencils) {
+            return 0;
+        }
     } else {
         // Sanity checks
         //
@@ -399,18 +2245,35 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
         PatchTableFactory::Options options;
         options.SetEndCapType(
             Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        options.useSingleCreasePatch =
+            refiner.GetAdaptiveOptions().useSingleCreasePatch;
+        options.monitor = monitor;
+
+        BuildMonitor::Range range;
+        if (monitor) range = monitor->enterRange(0.4f, 0.5f);
 
         patchtable = PatchTableFactory::Create(refiner, options);
 
+        if (monitor) monitor->restoreRange(range);
+
+        if (not patchtable) {
+            if (not cvStencilsIn) {
+                delete cvstencils;
+            }
+            return 0;
+        }
+
         if (not cvStencilsIn) {
             // if cvstencils is just created above, append endcap stencils
             if (StencilTable const *localPointStencilTable =
                 patchtable->GetLocalPointStencilTable()) {
                 StencilTable const *table =
                     StencilTableFactory::AppendLocalPointStencilTable(
-                        refiner, cvstencils, localPointStencilTable);
-                delete cvstencils;
-                cvstencils = table;
+                        refiner, cvstencils, localPointStencilTable,
+                        /*factorize*/ true, /*deleteBaseTable*/ true);
+                if (table) {
+                    cvstencils = table;
+                }
             }
         }
     } else {
@@ -433,42 +2296,117 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
     // Generate limit stencils for locations
     //
 
-    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
+    // Stencils of patch points refer to the points computed by cvStencils
+    int numControlVerts = patchPoints ? cvstencils->GetNumStencils() :
+                                        refiner.GetLevel(0).GetNumVertices();
+
+    internal::StencilBuilder builder(numControlVerts,
                                 /*genControlVerts*/ false,
                                 /*compactWeights*/  true);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
 
-    float wP[20], wDs[20], wDt[20];
+    bool concurrent = scheduler and scheduler->GetNumThreads() > 1;
 
-    for (size_t i=0; i<locationArrays.size(); ++i) {
-        LocationArray const & array = locationArrays[i];
-        assert(array.ptexIdx>=0);
+    LimitRangeData data;
 
-        for (int j=0; j<array.numLocations; ++j) {
-            float s = array.s[j],
-                  t = array.t[j];
-
-            PatchMap::Handle const * handle = 
-                                        patchmap.FindPatch(array.ptexIdx, s, t);
-            if (handle) {
-                ConstIndexArray cvs = patchtable->GetPatchVertices(*handle);
+    std::vector<int> arrayOffsets(locationArrays.size());
+    for (int i=0, offset=0; i<(int)locationArrays.size(); ++i) {
+        arrayOffsets[i] = offset;
+        offset += locationArrays[i].numLocations;
+    }
 
-                patchtable->EvaluateBasis(*handle, s, t, wP, wDs, wDt);
+    std::vector<PatchMap::Handle const *> handles(numLocations);
 
-                StencilTable const & src = *cvstencils;
-                dst = origin[numLimitStencils];
+    data.locationArrays = &locationArrays;
+    data.arrayOffsets   = &arrayOffsets;
+    data.handles        = &handles;
+    data.patchMap       = &patchmap;
+    data.monitor        = 0;
 
-                dst.Clear();
-                for (int k = 0; k < cvs.size(); ++k) {
-                    dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k]);
-                }
+    if (concurrent) {
+        scheduler->ParallelFor(0, numLocations,
+            getRangeSize(numLocations, *scheduler), findLimitPatches, &data);
+    } else {
+        findLimitPatches(0, numLocations, &data);
+    }
 
-                ++numLimitStencils;
+    // Assign the limit stencils to the locations found, in order or sorted
+    // by patch (locations of a same patch remain in order)
+    std::vector<int> stencilLocations;
+    if (limitOptions.sortByPatch) {
+        std::vector<int> patchOffsets(patchtable->GetNumPatchesTotal()+1, 0);
+        for (int i=0; i<numLocations; ++i) {
+            if (handles[i]) {
+                ++patchOffsets[handles[i]->patchIndex+1];
+            }
+        }
+        for (int i=1; i<(int)patchOffsets.size(); ++i) {
+            patchOffsets[i] += patchOffsets[i-1];
+        }
+        stencilLocations.resize(patchOffsets.back());
+        for (int i=0; i<numLocations; ++i) {
+            if (handles[i]) {
+                stencilLocations[patchOffsets[handles[i]->patchIndex]++] = i;
+            }
+        }
+    } else {
+        for (int i=0; i<numLocations; ++i) {
+            if (handles[i]) {
+                stencilLocations.push_back(i);
             }
         }
     }
 
+    int numLimitStencils = (int)stencilLocations.size();
+
+    if (monitor) {
+        monitor->beginStage(0.5f, 1.0f, numLimitStencils);
+    }
+
+    data.stencilLocations  = &stencilLocations;
+    data.patchTable        = patchtable;
+    data.cvStencils        = cvstencils;
+    data.builder           = &builder;
+    data.monitor           = monitor;
+    data.numControlVerts   = patchPoints ? 0 : numControlVerts;
+    data.numStencils       = numLimitStencils;
+    data.secondDerivatives = limitOptions.generate2ndDerivatives;
+    data.patchPoints       = patchPoints;
+
+    if (concurrent) {
+        data.rangeSize = getRangeSize(numLimitStencils, *scheduler);
+
+        int numRanges = (numLimitStencils + data.rangeSize - 1) / data.rangeSize;
+
+        std::vector<internal::StencilBuilder *> builders(numRanges);
+        data.builders = &builders;
+
+        scheduler->ParallelFor(0, numRanges, 1, populateLimitStencils, &data);
+
+        for (int i=0; i<numRanges; ++i) {
+            builder.Append(*builders[i]);
+            delete builders[i];
+        }
+        if (monitor) {
+            monitor->advance(numLimitStencils);
+        }
+    } else if (monitor) {
+        // Monitored stencils are accumulated serially by ranges, checking
+        // for cancellation between them
+        data.rangeSize = 1024;
+        data.builders  = 0;
+
+        for (int b=0, r=0; b<numLimitStencils; b+=data.rangeSize, ++r) {
+            populateLimitStencils(r, r+1, &data);
+            if (not monitor->advance(
+                std::min(data.rangeSize, numLimitStencils-b))) break;
+        }
+    } else {
+        data.rangeSize = numLimitStencils;
+        data.builders  = 0;
+
+        populateLimitStencils(0, numLimitStencils ? 1 : 0, &data);
+    }
+
     if (not cvStencilsIn) {
         delete cvstencils;
     }
@@ -477,17 +2415,42 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
         delete patchtable;
     }
 
+    if (monitor and monitor->IsCancelled()) {
+        return 0;
+    }
+
+    if (stencilLocationsOut) {
+        stencilLocationsOut->swap(stencilLocations);
+    }
+
     //
-    // Copy the proto-stencils into the limit stencil table
+    // Move the proto-stencils into the limit stencil table (or copy them,
+    // if they are not stored in order)
     //
-    LimitStencilTable * result = new LimitStencilTable(
-                                          refiner.GetLevel(0).GetNumVertices(),
+    bool second = limitOptions.generate2ndDerivatives;
+
+    LimitStencilTable * result = new LimitStencilTable(numControlVerts);
+    if (builder.ReleaseStencils(0, result->_sizes, result->_indices,
+            result->_weights, &result->_duWeights, &result->_dvWeights,
+                second ? &result->_duuWeights : 0,
+                    second ? &result->_duvWeights : 0,
+                        second ? &result->_dvvWeights : 0)) {
+        result->generateOffsets();
+        return result;
+    }
+    delete result;
+
+    result = new LimitStencilTable(
+                                          numControlVerts,
                                           builder.GetStencilOffsets(),
                                           builder.GetStencilSizes(),
                                           builder.GetStencilSources(),
                                           builder.GetStencilWeights(),
                                           builder.GetStencilDuWeights(),
                                           builder.GetStencilDvWeights(),
+                                          builder.GetStencilDuuWeights(),
+                                          builder.GetStencilDuvWeights(),
+                                          builder.GetStencilDvvWeights(),
                                           /*ctrlVerts*/false,
                                           /*fristOffset*/0);
     return result;
@@ -37,6 +37,11 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 class TopologyRefiner;
+class BuildMonitor;
+class PrimvarRefiner;
+class TaskScheduler;
+
+namespace internal { class StencilBuilder; }
 
 class Stencil;
 class StencilTable;
@@ -61,7 +66,12 @@ public:
                     generateControlVerts(false),
                     generateIntermediateLevels(true),
                     factorizeIntermediateLevels(true),
-                    maxLevel(10) { }
+                    shareIntermediateLevels(false),
+                    projectToLimit(false),
+                    presizeLevels(false),
+                    maxLevel(10),
+                    taskScheduler(0),
+                    monitor(0) { }
 
         unsigned int interpolationMode           : 2, ///< interpolation mode
                      generateOffsets             : 1, ///< populate optional "_offsets" field
@@ -69,8 +79,39 @@ public:
                      generateIntermediateLevels  : 1, ///< vertices at all levels or highest only
                      factorizeIntermediateLevels : 1, ///< accumulate stencil weights from control
                                                       ///  vertices or from the stencils of the
-                                                      ///  previous level
+                                                      ///  previous level (evaluated one pass per
+                                                      ///  level, see
+                                                      ///  StencilTable::GetPassOffsets())
+                     shareIntermediateLevels     : 1, ///< factorized stencils without control-
+                                                      ///  vertex stencils only : keep the
+                                                      ///  vertices of the intermediate levels
+                                                      ///  that minimize the total number of
+                                                      ///  weights as sources of the stencils
+                                                      ///  of the following levels (evaluated
+                                                      ///  in several passes, see
+                                                      ///  StencilTable::GetPassOffsets())
+                     projectToLimit              : 1, ///< uniform vertex stencils only : the
+                                                      ///  vertices of the last level are
+                                                      ///  projected to the limit surface, and
+                                                      ///  the table is a LimitStencilTable
+                                                      ///  holding the weights of their
+                                                      ///  tangents as derivatives (the other
+                                                      ///  level options are ignored)
+                     presizeLevels               : 1, ///< count the weights of the stencils of
+                                                      ///  each level before interpolating it,
+                                                      ///  so that the arrays of the stencils
+                                                      ///  are allocated once per level rather
+                                                      ///  than grown (lower peak allocation,
+                                                      ///  at the cost of the counting pass)
                      maxLevel                    : 4; ///< generate stencils up to 'maxLevel'
+
+        TaskScheduler const * taskScheduler; ///< optional scheduler to interpolate the
+                                             ///  stencils of each level concurrently
+
+        BuildMonitor * monitor;              ///< optional monitor of the progress of the
+                                             ///  build, which can cancel it (Create()
+                                             ///  then returns NULL) and receive the
+                                             ///  stencils of each level
     };
 
     /// \brief Instantiates StencilTable from TopologyRefiner that have been
@@ -80,6 +121,18 @@ public:
     ///       been refined in the TopologyRefiner. Use RefineUniform() or
     ///       RefineAdaptive() before constructing the stencils.
     ///
+    /// \note Vertex edits of the hierarchical edits of the refiner are folded
+    ///       into vertex stencils (see TopologyRefiner::SetHierarchicalEdits()):
+    ///       the values of the edits are sources of the stencils following the
+    ///       control vertices, and are included in GetNumControlVertices().
+    ///       Edits require factorized intermediate levels.
+    ///
+    /// \note With Options::projectToLimit, the last level of the uniform
+    ///       refinement must include its full topology (see TopologyRefiner::
+    ///       UniformOptions::fullTopologyInLastLevel) and is generated up to
+    ///       the last level of the refiner. The table returned is then a
+    ///       LimitStencilTable (see CreateLimitProjection()).
+    ///
     /// @param refiner  The TopologyRefiner containing the topology
     ///
     /// @param options  Options controlling the creation of the table
@@ -87,6 +140,47 @@ public:
     static StencilTable const * Create(TopologyRefiner const & refiner,
         Options options = Options());
 
+    /// \brief Instantiates the LimitStencilTable of the vertices of the last
+    ///        level of a uniformly refined TopologyRefiner projected to the
+    ///        limit surface (see Options::projectToLimit)
+    ///
+    /// The stencils of the vertices of the last level are composed with
+    /// their limit masks (see PrimvarRefiner::Limit()) : limit positions
+    /// and their two tangents (as derivative weights, see LimitStencilTable::
+    /// UpdateDerivs()) are evaluated from the control vertices in one pass.
+    ///
+    /// @param refiner  The uniformly refined TopologyRefiner
+    ///
+    /// @param options  Options controlling the creation of the table
+    ///
+    static LimitStencilTable const * CreateLimitProjection(
+        TopologyRefiner const & refiner, Options options = Options());
+
+    /// \brief Returns the number of stencils of the levels up to each level
+    ///        of the table created from a TopologyRefiner with 'options'
+    ///
+    /// The stencils of a table with intermediate levels are ordered by
+    /// level : the first counts[k] stencils of the table are those of the
+    /// table created with a 'maxLevel' of k, so that a single table holds
+    /// the tables of all its levels. Evaluating its first counts[k] stencils
+    /// refines the levels up to k, e.g. to display the levels of a mesh
+    /// progressively (see StencilTable::UpdateValues()).
+    ///
+    /// @param refiner  The TopologyRefiner containing the topology
+    ///
+    /// @param options  Options of the creation of the table
+    ///
+    /// @param counts   Number of stencils of the levels up to each level, from
+    ///                 level 0 (the control vertices, if generated) to the
+    ///                 last level of the table
+    ///
+    /// @return         False if the stencils of the levels are not shared by
+    ///                 the table (without generateIntermediateLevels, or with
+    ///                 shareIntermediateLevels or projectToLimit)
+    ///
+    static bool GetLevelStencilCounts(TopologyRefiner const & refiner,
+        Options const & options, std::vector<Index> & counts);
+
 
     /// \brief Instantiates StencilTable by concatenating an array of existing
     ///        stencil table.
@@ -96,11 +190,42 @@ public:
     ///       GetNumControlVertices() *must* return the same value for all input
     ///       tables.
     ///
-    /// @param numTables Number of input StencilTables
+    /// @param numTables    Number of input StencilTables
     ///
-    /// @param tables    Array of input StencilTables
+    /// @param tables       Array of input StencilTables
     ///
-    static StencilTable const * Create(int numTables, StencilTable const ** tables);
+    /// @param deleteTables Delete the input tables once concatenated (if a
+    ///                     table is returned) : the arrays of the first table
+    ///                     are moved to the result rather than copied, and
+    ///                     those of the others are freed as they are appended,
+    ///                     so that the merge does not double the memory held
+    ///                     by the tables
+    ///
+    static StencilTable const * Create(int numTables, StencilTable const ** tables,
+        bool deleteTables = false);
+
+    /// \brief Instantiates StencilTable from the arrays of stencils of the
+    ///        client, which are moved to the table rather than copied (they
+    ///        are swapped with the empty arrays of the table)
+    ///
+    /// Stencils built by the client in its own arrays (e.g. read from a file)
+    /// become a table without an intermediate copy.
+    ///
+    /// @param numControlVerts  Number of control vertices of the stencils
+    ///
+    /// @param sizes            Number of weights of each stencil
+    ///
+    /// @param indices          Control vertices of the weights of the
+    ///                         stencils, stencil after stencil
+    ///
+    /// @param weights          Weights of the stencils
+    ///
+    /// @return                 A new table (NULL if the arrays are
+    ///                         inconsistent, and are then left unchanged)
+    ///
+    static StencilTable const * Create(int numControlVerts,
+        std::vector<int> & sizes, std::vector<Index> & indices,
+            std::vector<float> & weights);
 
 
     /// \brief Utility function for stencil splicing for local point stencils.
@@ -117,16 +242,212 @@ public:
     ///                             table so that the endcap points can be computed
     ///                             directly from control vertices.
     ///
+    /// @param deleteBaseTable      Delete the baseStencilTable if a table is
+    ///                             returned : its arrays are then moved to the
+    ///                             result rather than copied
+    ///
     static StencilTable const * AppendLocalPointStencilTable(
         TopologyRefiner const &refiner,
         StencilTable const *baseStencilTable,
         StencilTable const *localPointStencilTable,
-        bool factorize = true);
+        bool factorize = true,
+        bool deleteBaseTable = false);
+
+    /// \brief Returns the stencils of the Bezier control points of the
+    ///        regular patches of a PatchTable
+    ///
+    /// The table holds a stencil for each control vertex of the patches, in
+    /// the order of the patch control vertices table : the Bezier points of
+    /// a regular patch replace its 16 B-spline control vertices (with the
+    /// boundaries of the patch applied), and the stencils of the control
+    /// vertices of other patches are empty. The stencils refer to the points
+    /// of the patches (refined vertices and local points) : applied to them
+    /// once per frame, they yield the Bezier points that can be evaluated
+    /// more directly (see Osd::CpuEvaluator::EvalBezierPatches).
+    ///
+    /// @param patchTable  The PatchTable of the patches
+    ///
+    static StencilTable const * CreateBezierPatchStencilTable(
+        PatchTable const & patchTable);
+
+
+    /// \brief Instantiates a StencilTable with the stencils of 'table'
+    ///        reordered for the locality of their control vertices.
+    ///
+    /// Stencils are sorted by the control vertex of their largest weight, so
+    /// that consecutive stencils gather their values from neighboring control
+    /// vertices. The control indices of each stencil are sorted in increasing
+    /// order and those of zero weights are removed.
+    ///
+    /// Leading stencils of the control vertices (see
+    /// Options::generateControlVerts) are left in place.
+    ///
+    /// The reordering is not free : it is meant to be applied once, offline,
+    /// to the tables of large meshes.
+    ///
+    /// \note Only factorized tables are supported : all the control indices
+    ///       must refer to control vertices (returns NULL otherwise).
+    ///
+    /// @param table        Input StencilTable
+    ///
+    /// @param permutation  Returned new index of each stencil of 'table'
+    ///                     (permutation[oldIndex] == newIndex), to remap the
+    ///                     PatchTable (see PatchTable::RemapControlVertices)
+    ///                     and any other index buffer of the vertices
+    ///
+    static StencilTable const * ReorderStencils(
+        StencilTable const * table, std::vector<Index> & permutation);
+
+    /// \brief Instantiates a StencilTable with the stencils of 'table'
+    ///        moved by a permutation of the vertices
+    ///
+    /// Stencil i of 'table' becomes stencil permutation[i] of the result,
+    /// e.g. to follow the vertices renumbered for the vertex cache (see
+    /// PatchTableFactory::OptimizeVertexCache()). Stencils beyond the end of
+    /// the permutation are left in place.
+    ///
+    /// \note Only factorized tables are supported, the control vertices are
+    ///       not reordered (returns NULL otherwise).
+    ///
+    /// @param table        Input StencilTable
+    ///
+    /// @param permutation  New index of each stencil (permutation[oldIndex] ==
+    ///                     newIndex)
+    ///
+    static StencilTable const * PermuteStencils(
+        StencilTable const * table, std::vector<Index> const & permutation);
+
+    /// \brief Instantiates the transpose of a StencilTable
+    ///
+    /// Stencil i of the transpose holds the stencils of 'table' referring to
+    /// control vertex i, weighted by the weight of the vertex in each : it
+    /// lists the points influenced by the vertex, and its evaluation is the
+    /// product by the transpose of the table (e.g. scattering forces applied
+    /// to the refined points back to the control vertices). The transpose
+    /// is an ordinary table of GetNumStencils() "control vertices", evaluated
+    /// as such by StencilTable::UpdateValues() and the Osd evaluators.
+    ///
+    /// Control indices are sorted in increasing order and zero weights are
+    /// removed. Limit stencil tables are transposed for their point weights
+    /// only (not the weights of their derivatives).
+    ///
+    /// \note Only tables of a single pass are supported, and all the control
+    ///       indices must refer to control vertices (returns NULL otherwise).
+    ///
+    /// @param table        Input StencilTable
+    ///
+    static StencilTable const * CreateTranspose(StencilTable const * table);
+
+    /// \brief Instantiates the partition of a StencilTable holding a range
+    ///        of its stencils, for evaluation on one of several devices
+    ///
+    /// The stencils [start, end) of 'table' become the stencils of the
+    /// partition, whose control vertices are only those referenced by the
+    /// range : control index i of the partition refers to control vertex
+    /// controlVertices[i] of 'table' (in increasing order). Each device can
+    /// then hold the control values of its partition only, gathered from
+    /// the control values of the mesh through 'controlVertices'.
+    ///
+    /// Limit stencil tables are partitioned for their point weights only
+    /// (not the weights of their derivatives).
+    ///
+    /// \note Only tables of a single pass are supported, and all the control
+    ///       indices must refer to control vertices (returns NULL otherwise).
+    ///
+    /// @param table            Input StencilTable
+    ///
+    /// @param start            Index of the first stencil of the partition
+    ///
+    /// @param end              Index past the last stencil of the partition
+    ///
+    /// @param controlVertices  Returned control vertices of 'table' referenced
+    ///                         by the partition
+    ///
+    static StencilTable const * CreatePartition(StencilTable const * table,
+        int start, int end, std::vector<Index> & controlVertices);
+
+    /// \brief Instantiates an approximation of a StencilTable with fewer
+    ///        weights, for interactive previews
+    ///
+    /// Weights of magnitude below 'tolerance' are dropped, and at most the
+    /// 'maxSize' largest weights of each stencil are kept. The remaining
+    /// weights of each stencil are scaled to the sum of its original
+    /// weights, so that the approximation stays affine invariant (the
+    /// largest weight of a stencil is always kept). Control indices are
+    /// sorted by decreasing weight magnitude.
+    ///
+    /// The weights of the contributions of the deep levels of a refinement
+    /// decay quickly : most of them can be dropped for a small error.
+    ///
+    /// Limit stencil tables are approximated for their point weights only
+    /// (not the weights of their derivatives).
+    ///
+    /// \note Only tables of a single pass are supported, and all the control
+    ///       indices must refer to control vertices (returns NULL otherwise).
+    ///
+    /// @param table         Input StencilTable
+    ///
+    /// @param tolerance     Magnitude of the smallest weight kept
+    ///
+    /// @param maxSize       Maximum number of weights of a stencil (or 0 to
+    ///                      keep all the weights above the tolerance)
+    ///
+    /// @param maxError      Returned maximum error of the approximation (if
+    ///                      not NULL) : the largest distance between exact
+    ///                      and approximated points of 'controlPoints', or
+    ///                      the largest sum of the magnitudes of the weight
+    ///                      differences of a stencil without control points
+    ///                      (which bounds the distance relative to the radius
+    ///                      of the control cage)
+    ///
+    /// @param controlPoints Optional (x,y,z) positions of the control vertices
+    ///                      of the table, to measure 'maxError'
+    ///
+    static StencilTable const * CreateApproximation(StencilTable const * table,
+        float tolerance, int maxSize = 0, float * maxError = 0,
+            float const * controlPoints = 0);
 
 private:
 
+    // Moves the arrays of a table to another, reserving 'numStencils' and
+    // 'numWeights' for the stencils appended next
+    static void moveStencils(StencilTable & src, StencilTable & dst,
+        int numStencils, int numWeights);
+
     // Generate stencils for the coarse control-vertices (single weight = 1.0f)
     static void generateControlVertStencils(int numControlVerts, Stencil & dst);
+
+    // Interpolate the vertex stencils of a level over ranges of the parent
+    // components concurrently (see stencilTableFactory.cpp)
+    static void interpolateLevelConcurrently(TaskScheduler const & scheduler,
+        PrimvarRefiner const & primvarRefiner, int level,
+            internal::StencilBuilder & builder, int srcOffset, int dstOffset,
+                BuildMonitor * monitor = 0);
+
+    static void interpolateLevelRanges(int begin, int end, void * data);
+
+    // Copy the stencils of the levels interpolated up to 'level' from the
+    // builder into a new table, or move them if 'release' (see Create())
+    static StencilTable * createLevelsTable(internal::StencilBuilder & builder,
+        Options const & options, int numBaseVerts, int numControlVerts,
+            bool applyEdits, bool editBaseLevel, size_t levelsOffset,
+                size_t levelOffset, std::vector<size_t> const & levelStarts,
+                    int level, bool release);
+
+    // Interpolate the vertex stencils of the levels following 'firstLevel',
+    // flattened down to the vertices of the last shared level (returns the
+    // number of weights of each level if 'levelWeights' is not NULL)
+    static void interpolateSharedLevels(TopologyRefiner const & refiner,
+        Options const & options, int firstLevel, int maxLevel,
+            std::vector<int> const & levelOffsets,
+                std::vector<bool> const & sharedLevels,
+                    internal::StencilBuilder & builder,
+                        std::vector<size_t> * levelWeights);
+
+    // Create stencils factorized over the intermediate levels that minimize
+    // the total number of weights (see Options::shareIntermediateLevels)
+    static StencilTable const * createSharedLevels(
+        TopologyRefiner const & refiner, Options const & options, int maxLevel);
 };
 
 /// \brief A specialized factory for LimitStencilTable
@@ -140,6 +461,12 @@ private:
 /// normalized (s,t) patch coordinates. The factory exposes the LocationArray
 /// struct as a container for these location descriptors.
 ///
+/// Limit stencils are factorized from the control vertices by default. They
+/// can instead combine the 16 (or 20) points of the patches of the locations
+/// (see Options::patchPointStencils) : the patch points are first computed
+/// once from the control vertices by the StencilTable given to the factory,
+/// and the limit stencils are then applied to the patch points.
+///
 class LimitStencilTableFactory {
 
 public:
@@ -158,6 +485,38 @@ public:
 
     typedef std::vector<LocationArray> LocationArrayVec;
 
+    struct Options {
+
+        Options() : generate2ndDerivatives(false),
+                    sortByPatch(false),
+                    patchPointStencils(false),
+                    taskScheduler(0),
+                    monitor(0) { }
+
+        unsigned int generate2ndDerivatives : 1, ///< also generate the weights of the
+                                                 ///  second derivatives (see
+                                                 ///  LimitStencilTable::GetDuuWeights())
+                     sortByPatch            : 1, ///< order the stencils by patch rather
+                                                 ///  than by location, so that the
+                                                 ///  stencils of a patch are evaluated
+                                                 ///  from the same control vertices in
+                                                 ///  turn (see 'stencilLocations')
+                     patchPointStencils     : 1; ///< stencils of the points of the patches
+                                                 ///  of the locations rather than of the
+                                                 ///  control vertices : limit values are
+                                                 ///  evaluated in two steps, from the
+                                                 ///  points computed by 'cvStencils' (which
+                                                 ///  must be given, with the 'patchTable')
+
+        TaskScheduler const * taskScheduler; ///< optional scheduler to generate the
+                                             ///  limit stencils (and the tables they
+                                             ///  are generated from) concurrently
+
+        BuildMonitor * monitor;              ///< optional monitor of the progress of the
+                                             ///  build, which can cancel it (Create()
+                                             ///  then returns NULL)
+    };
+
     /// \brief Instantiates LimitStencilTable from a TopologyRefiner that has
     ///        been refined either uniformly or adaptively.
     ///
@@ -174,10 +533,49 @@ public:
     ///                         TopologyRefiner (optional: prevents redundant
     ///                         instanciation of the table if available)
     ///
+    /// @param taskScheduler    Scheduler used to generate the limit stencils
+    ///                         (and any of the above tables) concurrently
+    ///                         (optional: generated serially if not specified)
+    ///
+    /// @param generate2ndDerivatives  Also generate the weights of the second
+    ///                         derivatives (see LimitStencilTable::
+    ///                         GetDuuWeights())
+    ///
     static LimitStencilTable const * Create(TopologyRefiner const & refiner,
         LocationArrayVec const & locationArrays,
             StencilTable const * cvStencils=0,
-                PatchTable const * patchTable=0);
+                PatchTable const * patchTable=0,
+                    TaskScheduler const * taskScheduler=0,
+                        bool generate2ndDerivatives=false);
+
+    /// \brief Instantiates LimitStencilTable from a TopologyRefiner that has
+    ///        been refined either uniformly or adaptively (see above).
+    ///
+    /// @param refiner          The TopologyRefiner containing the topology
+    ///
+    /// @param locationArrays   An array of surface location descriptors
+    ///                         (see LocationArray)
+    ///
+    /// @param options          Options controlling the creation of the table
+    ///
+    /// @param cvStencils       Optional StencilTable generated from the
+    ///                         TopologyRefiner, with the stencils of the
+    ///                         control vertices and of the local points of
+    ///                         the patchTable (required by patchPointStencils)
+    ///
+    /// @param patchTable       Optional PatchTable generated from the
+    ///                         TopologyRefiner (required by patchPointStencils)
+    ///
+    /// @param stencilLocations Optional index of the location of each stencil
+    ///                         (locations are numbered in the order of the
+    ///                         location arrays, and locations for which no
+    ///                         patch is found have no stencil)
+    ///
+    static LimitStencilTable const * Create(TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays, Options const & options,
+            StencilTable const * cvStencils=0,
+                PatchTable const * patchTable=0,
+                    std::vector<int> * stencilLocations=0);
 };
 
 
@@ -0,0 +1,189 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/streamingRefiner.h"
+#include "../far/error.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+StreamingRefiner::StreamingRefiner(TopologyRefiner const & refiner, Options options) :
+    _baseRefiner(refiner), _tileRefiner(0), _options(options) {
+
+    int numFaces = refiner.GetLevel(0).GetNumFaces(),
+        tileSize = std::max(options.maxTileFaces, 1);
+
+    std::vector<int> baseFaceTiles(numFaces);
+    for (int face = 0; face < numFaces; ++face) {
+        baseFaceTiles[face] = face / tileSize;
+    }
+    initializeTiles(numFaces ? &baseFaceTiles[0] : 0, (numFaces + tileSize - 1) / tileSize);
+}
+
+StreamingRefiner::StreamingRefiner(TopologyRefiner const & refiner, Options options,
+    int const * baseFaceTiles) :
+        _baseRefiner(refiner), _tileRefiner(0), _options(options) {
+
+    int numFaces = refiner.GetLevel(0).GetNumFaces(),
+        numTiles = 0;
+    for (int face = 0; face < numFaces; ++face) {
+        numTiles = std::max(numTiles, baseFaceTiles[face] + 1);
+    }
+    initializeTiles(baseFaceTiles, numTiles);
+}
+
+StreamingRefiner::~StreamingRefiner() {
+    delete _tileRefiner;
+}
+
+void
+StreamingRefiner::initializeTiles(int const * baseFaceTiles, int numTiles) {
+
+    int numFaces = _baseRefiner.GetLevel(0).GetNumFaces();
+
+    _baseFaceTiles.assign(baseFaceTiles, baseFaceTiles + numFaces);
+
+    //  Gather the base faces of each tile (holes are left to the refinement),
+    //  skipping the tiles without faces:
+    std::vector<int> tileSizes(numTiles, 0);
+    for (int face = 0; face < numFaces; ++face) {
+        if (_baseFaceTiles[face] >= 0) {
+            ++tileSizes[_baseFaceTiles[face]];
+        }
+    }
+
+    std::vector<int> tileRemap(numTiles, -1);
+
+    _tileOffsets.reserve(numTiles + 1);
+    _tileOffsets.push_back(0);
+    for (int tile = 0; tile < numTiles; ++tile) {
+        if (tileSizes[tile]) {
+            tileRemap[tile] = (int)_tileOffsets.size() - 1;
+            _tileOffsets.push_back(_tileOffsets.back() + tileSizes[tile]);
+        }
+    }
+
+    _tileFaces.resize(_tileOffsets.back());
+
+    std::vector<int> tileCounts(_tileOffsets.begin(), _tileOffsets.end() - 1);
+    for (int face = 0; face < numFaces; ++face) {
+        int & tile = _baseFaceTiles[face];
+        if (tile >= 0) {
+            tile = tileRemap[tile];
+            _tileFaces[tileCounts[tile]++] = face;
+        }
+    }
+}
+
+ConstIndexArray
+StreamingRefiner::GetTileBaseFaces(int tile) const {
+
+    assert(tile >= 0 and tile < GetNumTiles());
+    int size = _tileOffsets[tile+1] - _tileOffsets[tile];
+    return ConstIndexArray(size ? &_tileFaces[_tileOffsets[tile]] : 0, size);
+}
+
+bool
+StreamingRefiner::Refine(TileCallback callback, void * clientData) {
+
+    for (int tile = 0; tile < GetNumTiles(); ++tile) {
+        if (not RefineTile(tile, callback, clientData)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+StreamingRefiner::RefineTile(int tileIndex, TileCallback callback, void * clientData) {
+
+    if (tileIndex < 0 or tileIndex >= GetNumTiles()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StreamingRefiner::RefineTile() -- invalid tile index.");
+        return false;
+    }
+    if (_baseRefiner.GetSchemeType() == Sdc::SCHEME_BILINEAR) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in StreamingRefiner::RefineTile() -- not supported for Bilinear scheme.");
+        return false;
+    }
+
+    //  A single instance sharing the base level is refined again for each tile, so that
+    //  the refined levels of the previous tile are released first:
+    if (not _tileRefiner) {
+        _tileRefiner = new TopologyRefiner(_baseRefiner);
+    }
+    _tileRefiner->Unrefine();
+
+    ConstIndexArray baseFaces = GetTileBaseFaces(tileIndex);
+
+    if (_options.refinementLevel > 0) {
+        TopologyRefiner::AdaptiveOptions refineOptions(_options.refinementLevel);
+        refineOptions.numThreads = _options.numThreads;
+        refineOptions.taskScheduler = _options.taskScheduler;
+
+        _tileRefiner->RefineSparse(refineOptions, baseFaces);
+
+        if (not _tileRefiner->IsSparse()) {
+            //  the error was reported by the refiner
+            return false;
+        }
+    }
+
+    Tile tile(*_tileRefiner, tileIndex, baseFaces);
+
+    //  Identify the faces of the last level descending from the faces of the tile (the
+    //  refinement also holds the faces of the neighborhood supporting them).  Levels
+    //  missing when the tile only contains holes leave it without faces:
+    if ((int)_options.refinementLevel == _tileRefiner->GetMaxLevel()) {
+        int maxLevel = _tileRefiner->GetMaxLevel();
+
+        TopologyLevel const & lastLevel = _tileRefiner->GetLevel(maxLevel);
+
+        for (Index face = 0; face < lastLevel.GetNumFaces(); ++face) {
+            if (lastLevel.IsFaceHole(face)) continue;
+
+            Index baseFace = face;
+            for (int level = maxLevel; level > 0; --level) {
+                baseFace = _tileRefiner->GetLevel(level).GetFaceParentFace(baseFace);
+            }
+            if (_baseFaceTiles[baseFace] == tileIndex) {
+                tile._faces.push_back(face);
+            }
+        }
+    }
+
+    callback(tile, clientData);
+    return true;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,230 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_STREAMING_REFINER_H
+#define OPENSUBDIV3_FAR_STREAMING_REFINER_H
+
+#include "../version.h"
+
+#include "../far/topologyRefiner.h"
+#include "../far/primvarRefiner.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TaskScheduler;
+
+///
+/// \brief Uniform refinement of a mesh streamed in tiles of base faces
+///
+/// Meshes whose uniform refinement does not fit in memory are refined one
+/// tile of base faces at a time : each tile is refined sparsely (see
+/// TopologyRefiner::RefineSparse()) along with the ring of neighboring faces
+/// supporting it, and handed to a callback before the next tile is refined.
+/// The refined levels held at any time are those of a single tile -- only
+/// the base level, shared with the source TopologyRefiner, is held for the
+/// whole mesh.
+///
+/// Tiles are either ranges of consecutive base faces, or assigned by the
+/// client (e.g. from a spatial partition of the mesh).
+///
+/// \note The refined vertices of a tile are indexed locally : vertices on the
+///       boundary of a tile are emitted again by the neighboring tiles.
+///
+/// \note Schemes Catmark and Loop only (the schemes of sparse refinement).
+///
+class StreamingRefiner {
+
+public:
+
+    /// \brief Streaming refinement options
+    struct Options {
+
+        Options(int level) :
+            refinementLevel(level),
+            maxTileFaces(65536),
+            numThreads(1),
+            taskScheduler(0) { }
+
+        unsigned int refinementLevel:4;     ///< Number of uniform refinements
+        int          maxTileFaces;          ///< Number of base faces of each tile
+                                            ///< when tiles are face ranges
+        int          numThreads;            ///< Number of threads used to refine
+                                            ///< each tile (requires OpenMP)
+        TaskScheduler const * taskScheduler;///< Optional scheduler used for
+                                            ///< concurrency instead of OpenMP
+    };
+
+    /// \brief A refined tile, valid for the duration of the callback
+    class Tile {
+
+    public:
+
+        /// \brief Returns the index of the tile
+        int GetIndex() const { return _index; }
+
+        /// \brief Returns the base faces of the tile
+        ConstIndexArray GetBaseFaces() const { return _baseFaces; }
+
+        /// \brief Returns the refinement of the tile, and of its neighborhood
+        TopologyRefiner const & GetRefiner() const { return _refiner; }
+
+        /// \brief Returns the faces of the last level refined from the base
+        ///        faces of the tile (the faces of the neighborhood excluded)
+        ConstIndexArray GetFaces() const {
+            return ConstIndexArray(_faces.empty() ? 0 : &_faces[0], (int)_faces.size());
+        }
+
+        /// \brief Interpolates vertex primvar data from the base level to the
+        ///        vertices of the last level of the tile
+        ///
+        /// @param src  Primvar data of the base vertices of the whole mesh
+        ///
+        /// @param dst  Destination primvar data, for the vertices of the last
+        ///             level of GetRefiner()
+        ///
+        /// \note Intermediate levels are interpolated in temporary buffers of
+        ///       T (see PrimvarRefiner for the requirements of T)
+        ///
+        template <class T>
+        void InterpolateVertices(T const * src, T * dst) const;
+
+    private:
+
+        friend class StreamingRefiner;
+
+        Tile(TopologyRefiner const & refiner, int index, ConstIndexArray baseFaces) :
+            _refiner(refiner), _index(index), _baseFaces(baseFaces) { }
+
+        TopologyRefiner const & _refiner;
+        int                     _index;
+        ConstIndexArray         _baseFaces;
+        std::vector<Index>      _faces;
+    };
+
+    /// \brief Function called with each refined tile
+    typedef void (*TileCallback)(Tile const & tile, void * clientData);
+
+    /// \brief Constructor of tiles of consecutive base faces
+    ///
+    /// @param refiner        TopologyRefiner of the base mesh (the topology of
+    ///                       its base level is shared, and must remain valid
+    ///                       and unchanged while tiles are refined)
+    ///
+    /// @param options        Options controlling the refinement
+    ///
+    StreamingRefiner(TopologyRefiner const & refiner, Options options);
+
+    /// \brief Constructor of tiles assigned by the client
+    ///
+    /// @param refiner        TopologyRefiner of the base mesh (see above)
+    ///
+    /// @param options        Options controlling the refinement (maxTileFaces
+    ///                       is ignored)
+    ///
+    /// @param baseFaceTiles  Tile of each base face : faces of negative tiles
+    ///                       are not refined, and tiles without faces are
+    ///                       skipped
+    ///
+    StreamingRefiner(TopologyRefiner const & refiner, Options options,
+                     int const * baseFaceTiles);
+
+    /// \brief Destructor
+    ~StreamingRefiner();
+
+    /// \brief Returns the number of tiles
+    int GetNumTiles() const { return (int)_tileOffsets.size() - 1; }
+
+    /// \brief Returns the base faces of a tile
+    ConstIndexArray GetTileBaseFaces(int tile) const;
+
+    /// \brief Refines all the tiles in turn, calling 'callback' with each
+    ///        (returns false on failure)
+    bool Refine(TileCallback callback, void * clientData = 0);
+
+    /// \brief Refines a single tile, calling 'callback' with it (returns false
+    ///        on failure)
+    bool RefineTile(int tile, TileCallback callback, void * clientData = 0);
+
+private:
+
+    StreamingRefiner(StreamingRefiner const &);
+    StreamingRefiner & operator=(StreamingRefiner const &);
+
+    void initializeTiles(int const * baseFaceTiles, int numTiles);
+
+private:
+
+    TopologyRefiner const & _baseRefiner;
+    TopologyRefiner *       _tileRefiner;
+
+    Options _options;
+
+    std::vector<int>   _tileOffsets,    // base faces of each tile in _tileFaces
+                       _baseFaceTiles;  // tile of each base face
+    std::vector<Index> _tileFaces;
+};
+
+template <class T>
+inline void
+StreamingRefiner::Tile::InterpolateVertices(T const * src, T * dst) const {
+
+    int maxLevel = _refiner.GetMaxLevel();
+    if (maxLevel == 0) {
+        for (int i = 0; i < _refiner.GetLevel(0).GetNumVertices(); ++i) {
+            dst[i] = src[i];
+        }
+        return;
+    }
+
+    PrimvarRefiner primvarRefiner(_refiner);
+
+    std::vector<T> buffers[2];
+
+    T const * levelSrc = src;
+    for (int level = 1; level <= maxLevel; ++level) {
+        T * levelDst = dst;
+        if (level < maxLevel) {
+            std::vector<T> & buffer = buffers[level & 1];
+            buffer.resize(_refiner.GetLevel(level).GetNumVertices());
+            levelDst = &buffer[0];
+        }
+        primvarRefiner.Interpolate(level, levelSrc, levelDst);
+        levelSrc = levelDst;
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_STREAMING_REFINER_H
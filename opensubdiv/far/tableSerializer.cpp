@@ -0,0 +1,965 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/tableSerializer.h"
+#include "../far/error.h"
+#include "../far/patchTable.h"
+#include "../far/ptexIndices.h"
+#include "../far/stencilTable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //
+    //  Record layout : a header, followed by a sequence of 32 bit integers
+    //  and arrays. Arrays are preceded by their number of elements and the
+    //  size of an element, and padded to a multiple of 8 bytes.
+    //
+    enum RecordType {
+        RECORD_STENCIL_TABLE = 1,
+        RECORD_LIMIT_STENCIL_TABLE,
+        RECORD_PATCH_TABLE,
+        RECORD_PTEX_INDICES
+    };
+
+    struct RecordHeader {
+        char         magic[4];
+        unsigned int version,
+                     type,
+                     byteOrder,
+                     sizeLow,   // size of the record, header included
+                     sizeHigh;
+    };
+
+    char const         recordMagic[4] = { 'O', 'S', 'D', 'T' };
+    unsigned int const recordByteOrder = 0x01020304;
+
+    size_t const recordAlignment = 8;
+
+    class Writer {
+    public:
+        Writer(std::vector<unsigned char> & data, RecordType type) :
+            _data(data), _start(data.size()) {
+
+            RecordHeader header;
+            memcpy(header.magic, recordMagic, sizeof(recordMagic));
+            header.version = TableSerializer::FORMAT_VERSION;
+            header.type = type;
+            header.byteOrder = recordByteOrder;
+            header.sizeLow = header.sizeHigh = 0;
+            write(&header, sizeof(RecordHeader));
+        }
+
+        // Sets the size of the record in its header
+        void Finalize() {
+            unsigned long long size = _data.size() - _start;
+
+            RecordHeader header;
+            memcpy(&header, &_data[_start], sizeof(RecordHeader));
+            header.sizeLow = (unsigned int)(size & 0xffffffff);
+            header.sizeHigh = (unsigned int)(size >> 32);
+            memcpy(&_data[_start], &header, sizeof(RecordHeader));
+        }
+
+        void WriteInt(int value) {
+            write(&value, sizeof(int));
+        }
+
+        template <class T> void WriteArray(std::vector<T> const & array) {
+            WriteInt((int)array.size());
+            WriteInt((int)sizeof(T));
+            if (not array.empty()) {
+                write(&array[0], array.size() * sizeof(T));
+            }
+            pad();
+        }
+
+    private:
+        void write(void const * src, size_t size) {
+            unsigned char const * bytes = (unsigned char const *)src;
+            _data.insert(_data.end(), bytes, bytes + size);
+        }
+
+        void pad() {
+            size_t size = _data.size() - _start;
+            _data.resize(_data.size() +
+                (recordAlignment - size % recordAlignment) % recordAlignment, 0);
+        }
+
+        std::vector<unsigned char> & _data;
+        size_t _start;
+    };
+
+    class Reader {
+    public:
+        Reader(void const * data, size_t size) :
+            _data((unsigned char const *)data), _size(size), _pos(0),
+            _version(0), _valid(data != 0) { }
+
+        // Validates the header of the record, and restricts reads to it
+        bool ReadHeader(RecordType type, char const * caller) {
+
+            RecordHeader header;
+            if (not read(&header, sizeof(RecordHeader)) or
+                memcmp(header.magic, recordMagic, sizeof(recordMagic))) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in %s -- not a serialized table.", caller);
+                return false;
+            }
+            if (header.byteOrder != recordByteOrder) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in %s -- table serialized with another byte order.",
+                        caller);
+                return false;
+            }
+            if (header.version < 1 or
+                header.version > TableSerializer::FORMAT_VERSION) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in %s -- unsupported format version %d (expected %d).",
+                        caller, header.version, TableSerializer::FORMAT_VERSION);
+                return false;
+            }
+            if (header.type != (unsigned int)type) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in %s -- serialized table of another type.", caller);
+                return false;
+            }
+            unsigned long long size = header.sizeLow |
+                ((unsigned long long)header.sizeHigh << 32);
+            if (size < sizeof(RecordHeader) or size > _size) {
+                Error(FAR_RUNTIME_ERROR,
+                    "Failure in %s -- truncated table data.", caller);
+                return false;
+            }
+            _size = (size_t)size;
+            _version = header.version;
+            return true;
+        }
+
+        // Returns the format version of the record
+        unsigned int GetVersion() const { return _version; }
+
+        int ReadInt() {
+            int value = 0;
+            read(&value, sizeof(int));
+            return value;
+        }
+
+        template <class T> void ReadArray(std::vector<T> & array) {
+            int numElements = ReadInt(),
+                elementSize = ReadInt();
+            if (numElements < 0 or elementSize != (int)sizeof(T) or
+                (size_t)numElements > (_size - _pos) / sizeof(T)) {
+                _valid = false;
+            }
+            if (_valid) {
+                array.resize(numElements);
+                if (numElements > 0) {
+                    read(&array[0], numElements * sizeof(T));
+                }
+                _pos += (recordAlignment - _pos % recordAlignment) % recordAlignment;
+            }
+        }
+
+        // Returns a pointer to the elements of an array in place
+        template <class T> T const * ViewArray(int & numElements) {
+            numElements = ReadInt();
+            int elementSize = ReadInt();
+            if (numElements < 0 or elementSize != (int)sizeof(T) or
+                (size_t)numElements > (_size - _pos) / sizeof(T) or
+                (size_t)(_data + _pos) % sizeof(T)) {
+                _valid = false;
+            }
+            if (not _valid) {
+                return 0;
+            }
+            T const * array = (T const *)(_data + _pos);
+            _pos += numElements * sizeof(T);
+            _pos += (recordAlignment - _pos % recordAlignment) % recordAlignment;
+            return array;
+        }
+
+        // Flags the data as invalid (failed consistency check)
+        void Check(bool condition) {
+            _valid = _valid and condition;
+        }
+
+        bool IsValid() const { return _valid and _pos <= _size; }
+
+        size_t GetRecordSize() const { return _size; }
+
+    private:
+        bool read(void * dst, size_t size) {
+            if (not _valid or size > _size - _pos) {
+                _valid = false;
+                return false;
+            }
+            memcpy(dst, _data + _pos, size);
+            _pos += size;
+            return true;
+        }
+
+        unsigned char const * _data;
+        size_t _size,
+               _pos;
+        unsigned int _version;
+        bool _valid;
+    };
+
+    // Checks that the stencils reference existing weights
+    bool
+    checkStencils(int const * sizes, Index const * offsets,
+                  size_t numStencils, size_t numWeights) {
+
+        for (size_t i=0; i<numStencils; ++i) {
+            if (sizes[i] < 0 or offsets[i] < 0 or
+                (size_t)offsets[i] + sizes[i] > numWeights) return false;
+        }
+        return true;
+    }
+
+    bool
+    checkStencils(std::vector<int> const & sizes,
+                  std::vector<Index> const & offsets,
+                  size_t numWeights) {
+
+        if (sizes.size() != offsets.size()) return false;
+        return sizes.empty() or
+            checkStencils(&sizes[0], &offsets[0], sizes.size(), numWeights);
+    }
+
+    // Checks that the passes are ranges of existing stencils
+    bool
+    checkPasses(std::vector<Index> const & passOffsets, size_t numStencils) {
+
+        for (size_t i=0; i<passOffsets.size(); ++i) {
+            if (passOffsets[i] < (i ? passOffsets[i-1] : 0) or
+                (size_t)passOffsets[i] > numStencils) return false;
+        }
+        return true;
+    }
+
+    //
+    //  Shared memory segments start with a header : the size of the records
+    //  is written first, and the segment is flagged as published once the
+    //  records have been copied, so that processes attaching concurrently
+    //  never load partial records.
+    //
+    struct SharedMemoryHeader {
+        unsigned int sizeLow,
+                     sizeHigh,
+                     published,
+                     reserved;
+    };
+
+    void
+    memoryBarrier() {
+#if defined(_WIN32)
+        MemoryBarrier();
+#elif defined(__GNUC__)
+        __sync_synchronize();
+#endif
+    }
+
+#ifndef _WIN32
+    // POSIX shared memory names start with a slash
+    std::string
+    getSharedMemoryName(char const * name) {
+        return name[0] == '/' ? std::string(name) : std::string("/") + name;
+    }
+#endif
+
+    void
+    errorInvalid(char const * caller) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in %s -- corrupted table data.", caller);
+    }
+}
+
+//
+//  Stencils
+//
+template <class WRITER> void
+TableSerializer::writeStencils(WRITER & writer, StencilTable const & table) {
+
+    writer.WriteInt(table._numControlVertices);
+    writer.WriteArray(table._sizes);
+    writer.WriteArray(table._offsets);
+    writer.WriteArray(table._indices);
+    writer.WriteArray(table._weights);
+    writer.WriteArray(table._passOffsets);
+}
+
+template <class READER> bool
+TableSerializer::readStencils(READER & reader, StencilTable & table) {
+
+    table._numControlVertices = reader.ReadInt();
+    reader.ReadArray(table._sizes);
+    reader.ReadArray(table._offsets);
+    reader.ReadArray(table._indices);
+    reader.ReadArray(table._weights);
+    if (reader.GetVersion() >= 2) {
+        reader.ReadArray(table._passOffsets);
+    }
+
+    reader.Check(table._numControlVertices >= 0 and checkStencils(table._sizes,
+        table._offsets, std::min(table._indices.size(), table._weights.size()))
+            and checkPasses(table._passOffsets, table._sizes.size()));
+    return reader.IsValid();
+}
+
+void
+TableSerializer::Write(StencilTable const & table,
+                       std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_STENCIL_TABLE);
+    writeStencils(writer, table);
+    writer.Finalize();
+}
+
+void
+TableSerializer::Write(LimitStencilTable const & table,
+                       std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_LIMIT_STENCIL_TABLE);
+    writeStencils(writer, table);
+    writer.WriteArray(table._duWeights);
+    writer.WriteArray(table._dvWeights);
+    writer.WriteArray(table._duuWeights);
+    writer.WriteArray(table._duvWeights);
+    writer.WriteArray(table._dvvWeights);
+    writer.Finalize();
+}
+
+StencilTable const *
+TableSerializer::ReadStencilTable(void const * data, size_t size,
+                                  size_t * recordSize) {
+
+    static char const * caller = "TableSerializer::ReadStencilTable()";
+
+    Reader reader(data, size);
+    if (not reader.ReadHeader(RECORD_STENCIL_TABLE, caller)) {
+        return NULL;
+    }
+
+    StencilTable * table = new StencilTable;
+    if (not readStencils(reader, *table)) {
+        errorInvalid(caller);
+        delete table;
+        return NULL;
+    }
+    if (recordSize) {
+        *recordSize = reader.GetRecordSize();
+    }
+    return table;
+}
+
+bool
+TableSerializer::ViewStencilTable(void const * data, size_t size,
+                                  StencilTableView & view,
+                                  size_t * recordSize) {
+
+    static char const * caller = "TableSerializer::ViewStencilTable()";
+
+    Reader reader(data, size);
+    if (not reader.ReadHeader(RECORD_STENCIL_TABLE, caller)) {
+        return false;
+    }
+
+    int numOffsets = 0,
+        numIndices = 0,
+        numWeights = 0;
+
+    view.numControlVertices = reader.ReadInt();
+    view.sizes = reader.ViewArray<int>(view.numStencils);
+    view.offsets = reader.ViewArray<Index>(numOffsets);
+    view.indices = reader.ViewArray<Index>(numIndices);
+    view.weights = reader.ViewArray<float>(numWeights);
+
+    reader.Check(view.numControlVertices >= 0 and
+        numOffsets == view.numStencils);
+    if (not reader.IsValid() or not checkStencils(view.sizes, view.offsets,
+            view.numStencils, std::min(numIndices, numWeights))) {
+        errorInvalid(caller);
+        return false;
+    }
+    if (recordSize) {
+        *recordSize = reader.GetRecordSize();
+    }
+    return true;
+}
+
+LimitStencilTable const *
+TableSerializer::ReadLimitStencilTable(void const * data, size_t size,
+                                       size_t * recordSize) {
+
+    static char const * caller = "TableSerializer::ReadLimitStencilTable()";
+
+    Reader reader(data, size);
+    if (not reader.ReadHeader(RECORD_LIMIT_STENCIL_TABLE, caller)) {
+        return NULL;
+    }
+
+    std::vector<int> empty;
+    std::vector<float> emptyWeights;
+    LimitStencilTable * table = new LimitStencilTable(0, empty, empty, empty,
+        emptyWeights, emptyWeights, emptyWeights, emptyWeights, emptyWeights,
+            emptyWeights, false, 0);
+
+    bool valid = readStencils(reader, *table);
+    if (valid) {
+        reader.ReadArray(table->_duWeights);
+        reader.ReadArray(table->_dvWeights);
+        reader.Check(checkStencils(table->_sizes, table->_offsets,
+            std::min(table->_duWeights.size(), table->_dvWeights.size())));
+        if (reader.GetVersion() >= 4) {
+            // second derivatives are optional (empty arrays)
+            reader.ReadArray(table->_duuWeights);
+            reader.ReadArray(table->_duvWeights);
+            reader.ReadArray(table->_dvvWeights);
+            if (not table->_duuWeights.empty()) {
+                reader.Check(checkStencils(table->_sizes, table->_offsets,
+                    std::min(table->_duuWeights.size(),
+                        std::min(table->_duvWeights.size(),
+                            table->_dvvWeights.size()))));
+            } else {
+                reader.Check(table->_duvWeights.empty() and
+                             table->_dvvWeights.empty());
+            }
+        }
+        valid = reader.IsValid();
+    }
+    if (not valid) {
+        errorInvalid(caller);
+        delete table;
+        return NULL;
+    }
+    if (recordSize) {
+        *recordSize = reader.GetRecordSize();
+    }
+    return table;
+}
+
+//
+//  PatchTable
+//
+void
+TableSerializer::Write(PatchTable const & table,
+                       std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_PATCH_TABLE);
+
+    writer.WriteInt(table._maxValence);
+    writer.WriteInt(table._numPtexFaces);
+
+    std::vector<int> patchArrays;
+    patchArrays.reserve(table._patchArrays.size() * 5);
+    for (size_t i=0; i<table._patchArrays.size(); ++i) {
+        PatchTable::PatchArray const & pa = table._patchArrays[i];
+        patchArrays.push_back(pa.desc.GetType());
+        patchArrays.push_back(pa.numPatches);
+        patchArrays.push_back(pa.vertIndex);
+        patchArrays.push_back(pa.patchIndex);
+        patchArrays.push_back(pa.quadOffsetIndex);
+    }
+    writer.WriteArray(patchArrays);
+
+    writer.WriteArray(table._patchVerts);
+    writer.WriteArray(table._paramTable);
+    writer.WriteArray(table._quadOffsetsTable);
+    writer.WriteArray(table._vertexValenceTable);
+
+    writer.WriteInt(table._localPointStencils != 0);
+    if (table._localPointStencils) {
+        writeStencils(writer, *table._localPointStencils);
+    }
+    writer.WriteInt(table._localPointVaryingStencils != 0);
+    if (table._localPointVaryingStencils) {
+        writeStencils(writer, *table._localPointVaryingStencils);
+    }
+
+    writer.WriteInt((int)table._fvarChannels.size());
+    for (size_t i=0; i<table._fvarChannels.size(); ++i) {
+        PatchTable::FVarPatchChannel const & c = table._fvarChannels[i];
+
+        writer.WriteInt(c.interpolation);
+        writer.WriteInt(c.patchesType);
+
+        std::vector<int> patchTypes(c.patchTypes.begin(), c.patchTypes.end());
+        writer.WriteArray(patchTypes);
+        writer.WriteArray(c.patchValuesOffsets);
+        writer.WriteArray(table.getFVarPatchChannelValues(c));
+        writer.WriteArray(c.patchParams);
+    }
+
+    writer.WriteArray(table._sharpnessIndices);
+    writer.WriteArray(table._sharpnessValues);
+
+    writer.Finalize();
+}
+
+PatchTable const *
+TableSerializer::ReadPatchTable(void const * data, size_t size,
+                                size_t * recordSize) {
+
+    static char const * caller = "TableSerializer::ReadPatchTable()";
+
+    Reader reader(data, size);
+    if (not reader.ReadHeader(RECORD_PATCH_TABLE, caller)) {
+        return NULL;
+    }
+
+    PatchTable * table = new PatchTable(reader.ReadInt());
+    table->_numPtexFaces = reader.ReadInt();
+
+    std::vector<int> patchArrays;
+    reader.ReadArray(patchArrays);
+
+    reader.ReadArray(table->_patchVerts);
+    reader.ReadArray(table->_paramTable);
+    reader.ReadArray(table->_quadOffsetsTable);
+    reader.ReadArray(table->_vertexValenceTable);
+
+    reader.Check(patchArrays.size() % 5 == 0);
+    int numPatches = 0;
+    for (size_t i=0; reader.IsValid() and i<patchArrays.size(); i+=5) {
+        PatchDescriptor desc((PatchDescriptor::Type)patchArrays[i]);
+        int npatches = patchArrays[i+1];
+        Index vertIndex = patchArrays[i+2],
+              patchIndex = patchArrays[i+3];
+        reader.Check(desc.GetType() > PatchDescriptor::NON_PATCH and
+            desc.GetType() <= PatchDescriptor::GREGORY_BASIS and
+            npatches >= 0 and vertIndex >= 0 and patchIndex == numPatches and
+            (size_t)vertIndex + (size_t)npatches * desc.GetNumControlVertices()
+                <= table->_patchVerts.size());
+        table->_patchArrays.push_back(PatchTable::PatchArray(
+            desc, npatches, vertIndex, patchIndex, patchArrays[i+4]));
+        numPatches += npatches;
+    }
+    reader.Check((size_t)numPatches == table->_paramTable.size());
+
+    if (reader.ReadInt()) {
+        StencilTable * stencils = new StencilTable;
+        table->_localPointStencils = stencils;
+        readStencils(reader, *stencils);
+    }
+    if (reader.ReadInt()) {
+        StencilTable * stencils = new StencilTable;
+        table->_localPointVaryingStencils = stencils;
+        readStencils(reader, *stencils);
+    }
+
+    int numChannels = reader.ReadInt();
+    reader.Check(numChannels >= 0);
+    for (int i=0; reader.IsValid() and i<numChannels; ++i) {
+        table->_fvarChannels.push_back(PatchTable::FVarPatchChannel());
+        PatchTable::FVarPatchChannel & c = table->_fvarChannels.back();
+
+        c.interpolation = (Sdc::Options::FVarLinearInterpolation)reader.ReadInt();
+        c.patchesType = (PatchDescriptor::Type)reader.ReadInt();
+
+        std::vector<int> patchTypes;
+        reader.ReadArray(patchTypes);
+        c.patchTypes.resize(patchTypes.size());
+        for (size_t j=0; j<patchTypes.size(); ++j) {
+            c.patchTypes[j] = (PatchDescriptor::Type)patchTypes[j];
+        }
+        reader.ReadArray(c.patchValuesOffsets);
+        reader.ReadArray(c.patchValues);
+        if (reader.GetVersion() >= 3) {
+            reader.ReadArray(c.patchParams);
+        }
+        reader.Check(c.patchParams.empty() or
+            c.patchParams.size() == table->_paramTable.size());
+    }
+
+    reader.ReadArray(table->_sharpnessIndices);
+    reader.ReadArray(table->_sharpnessValues);
+    reader.Check(table->_sharpnessIndices.empty() or
+        table->_sharpnessIndices.size() == table->_paramTable.size());
+
+    if (not reader.IsValid()) {
+        errorInvalid(caller);
+        delete table;
+        return NULL;
+    }
+    if (recordSize) {
+        *recordSize = reader.GetRecordSize();
+    }
+    return table;
+}
+
+//
+//  PtexIndices
+//
+void
+TableSerializer::Write(PtexIndices const & ptexIndices,
+                       std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_PTEX_INDICES);
+    writer.WriteArray(ptexIndices._ptexIndices);
+    writer.WriteArray(ptexIndices._adjacency);
+    writer.Finalize();
+}
+
+PtexIndices const *
+TableSerializer::ReadPtexIndices(void const * data, size_t size,
+                                 size_t * recordSize) {
+
+    static char const * caller = "TableSerializer::ReadPtexIndices()";
+
+    Reader reader(data, size);
+    if (not reader.ReadHeader(RECORD_PTEX_INDICES, caller)) {
+        return NULL;
+    }
+
+    PtexIndices * ptexIndices = new PtexIndices;
+    reader.ReadArray(ptexIndices->_ptexIndices);
+    reader.ReadArray(ptexIndices->_adjacency);
+
+    std::vector<Index> const & offsets = ptexIndices->_ptexIndices;
+    reader.Check(not offsets.empty() and offsets[0] == 0);
+    for (size_t i=1; reader.IsValid() and i<offsets.size(); ++i) {
+        reader.Check(offsets[i] > offsets[i-1]);
+    }
+    if (reader.IsValid() and not ptexIndices->_adjacency.empty()) {
+        int numFaces = offsets.back();
+        std::vector<int> const & adjacency = ptexIndices->_adjacency;
+        reader.Check(adjacency.size() == 4 * (size_t)numFaces);
+        for (size_t i=0; reader.IsValid() and i<adjacency.size(); ++i) {
+            reader.Check(adjacency[i] >= -1 and (adjacency[i] >> 2) < numFaces);
+        }
+    }
+
+    if (not reader.IsValid()) {
+        errorInvalid(caller);
+        delete ptexIndices;
+        return NULL;
+    }
+    if (recordSize) {
+        *recordSize = reader.GetRecordSize();
+    }
+    return ptexIndices;
+}
+
+//
+//  Files
+//
+bool
+TableSerializer::WriteFile(char const * filename,
+                           std::vector<unsigned char> const & data) {
+
+    FILE * file = fopen(filename, "wb");
+    if (not file) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TableSerializer::WriteFile() -- cannot open %s.", filename);
+        return false;
+    }
+    bool success = data.empty() or
+        fwrite(&data[0], 1, data.size(), file) == data.size();
+    success = (fclose(file) == 0) and success;
+    if (not success) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TableSerializer::WriteFile() -- cannot write %s.", filename);
+    }
+    return success;
+}
+
+TableSerializer::MappedFile *
+TableSerializer::MappedFile::Open(char const * filename) {
+
+    static char const * caller = "TableSerializer::MappedFile::Open()";
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot open %s.",
+            caller, filename);
+        return NULL;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    void const * data = NULL;
+    if (GetFileSizeEx(file, &size) and size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+    CloseHandle(file);
+
+    if (not data) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot map %s.",
+            caller, filename);
+        return NULL;
+    }
+
+    MappedFile * mappedFile = new MappedFile;
+    mappedFile->_data = data;
+    mappedFile->_size = (size_t)size.QuadPart;
+    mappedFile->_handle = mapping;
+    return mappedFile;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot open %s.",
+            caller, filename);
+        return NULL;
+    }
+
+    struct stat st;
+    void * data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 and st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot map %s.",
+            caller, filename);
+        return NULL;
+    }
+
+    MappedFile * mappedFile = new MappedFile;
+    mappedFile->_data = data;
+    mappedFile->_size = (size_t)st.st_size;
+    return mappedFile;
+#endif
+}
+
+TableSerializer::MappedFile::~MappedFile() {
+
+#if defined(_WIN32)
+    UnmapViewOfFile(_data);
+    CloseHandle((HANDLE)_handle);
+#else
+    munmap(const_cast<void *>(_data), _size);
+#endif
+}
+
+TableSerializer::SharedMemory *
+TableSerializer::SharedMemory::Publish(char const * name,
+                                       std::vector<unsigned char> const & data) {
+
+    static char const * caller = "TableSerializer::SharedMemory::Publish()";
+
+    unsigned long long mappingSize = sizeof(SharedMemoryHeader) + data.size();
+
+#if defined(_WIN32)
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL,
+        PAGE_READWRITE, (DWORD)(mappingSize >> 32),
+            (DWORD)(mappingSize & 0xffffffff), name);
+    if (handle and GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(handle);
+        handle = NULL;
+    }
+    void * mapping = handle ?
+        MapViewOfFile(handle, FILE_MAP_WRITE, 0, 0, 0) : NULL;
+    if (not mapping) {
+        if (handle) {
+            CloseHandle(handle);
+        }
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot create %s.",
+            caller, name);
+        return NULL;
+    }
+#else
+    std::string shmName = getSharedMemoryName(name);
+
+    int fd = shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot create %s.",
+            caller, name);
+        return NULL;
+    }
+
+    void * mapping = MAP_FAILED;
+    if (ftruncate(fd, (off_t)mappingSize) == 0) {
+        mapping = mmap(NULL, (size_t)mappingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        shm_unlink(shmName.c_str());
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot map %s.",
+            caller, name);
+        return NULL;
+    }
+    void * handle = 0;
+#endif
+
+    SharedMemoryHeader * header = (SharedMemoryHeader *)mapping;
+    header->sizeLow = (unsigned int)(data.size() & 0xffffffff);
+    header->sizeHigh = (unsigned int)((unsigned long long)data.size() >> 32);
+    if (not data.empty()) {
+        memcpy(header + 1, &data[0], data.size());
+    }
+    memoryBarrier();
+    *(volatile unsigned int *)&header->published = 1;
+
+    SharedMemory * sharedMemory = new SharedMemory;
+    sharedMemory->_mapping = mapping;
+    sharedMemory->_mappingSize = (size_t)mappingSize;
+    sharedMemory->_data = header + 1;
+    sharedMemory->_size = data.size();
+    sharedMemory->_handle = handle;
+    return sharedMemory;
+}
+
+TableSerializer::SharedMemory *
+TableSerializer::SharedMemory::Attach(char const * name) {
+
+    static char const * caller = "TableSerializer::SharedMemory::Attach()";
+
+#if defined(_WIN32)
+    HANDLE handle = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+    if (not handle) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot open %s.",
+            caller, name);
+        return NULL;
+    }
+
+    void * mapping = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (not mapping or not VirtualQuery(mapping, &info, sizeof(info))) {
+        if (mapping) {
+            UnmapViewOfFile(mapping);
+        }
+        CloseHandle(handle);
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot map %s.",
+            caller, name);
+        return NULL;
+    }
+    size_t mappingSize = info.RegionSize;
+#else
+    int fd = shm_open(getSharedMemoryName(name).c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot open %s.",
+            caller, name);
+        return NULL;
+    }
+
+    struct stat st;
+    void * mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 and
+        (size_t)st.st_size >= sizeof(SharedMemoryHeader)) {
+        mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- cannot map %s.",
+            caller, name);
+        return NULL;
+    }
+    size_t mappingSize = (size_t)st.st_size;
+    void * handle = 0;
+#endif
+
+    SharedMemory * sharedMemory = new SharedMemory;
+    sharedMemory->_mapping = mapping;
+    sharedMemory->_mappingSize = mappingSize;
+    sharedMemory->_handle = handle;
+
+    SharedMemoryHeader const * header = (SharedMemoryHeader const *)mapping;
+    bool published = *(volatile unsigned int const *)&header->published != 0;
+    memoryBarrier();
+
+    unsigned long long size = header->sizeLow |
+        ((unsigned long long)header->sizeHigh << 32);
+    if (not published or
+        size > mappingSize - sizeof(SharedMemoryHeader)) {
+        delete sharedMemory;
+        Error(FAR_RUNTIME_ERROR, "Failure in %s -- %s is not published.",
+            caller, name);
+        return NULL;
+    }
+    sharedMemory->_data = header + 1;
+    sharedMemory->_size = (size_t)size;
+    return sharedMemory;
+}
+
+bool
+TableSerializer::SharedMemory::Remove(char const * name) {
+
+#if defined(_WIN32)
+    (void)name;
+    return true;
+#else
+    if (shm_unlink(getSharedMemoryName(name).c_str()) != 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TableSerializer::SharedMemory::Remove() -- "
+                "cannot remove %s.", name);
+        return false;
+    }
+    return true;
+#endif
+}
+
+TableSerializer::SharedMemory::~SharedMemory() {
+
+#if defined(_WIN32)
+    UnmapViewOfFile(_mapping);
+    CloseHandle((HANDLE)_handle);
+#else
+    munmap(_mapping, _mappingSize);
+#endif
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
@@ -0,0 +1,235 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_TABLE_SERIALIZER_H
+#define OPENSUBDIV3_FAR_TABLE_SERIALIZER_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class StencilTable;
+class LimitStencilTable;
+class PatchTable;
+class PtexIndices;
+
+/// \brief Binary serialization of StencilTable, LimitStencilTable,
+///        PatchTable and PtexIndices
+///
+/// Each table is written as a record : a header identifying the type of the
+/// table and the version of the format, followed by the arrays of the table.
+/// Arrays are aligned on 8 bytes from the start of the record, and records
+/// can be concatenated into a single buffer or file, to be loaded in turn.
+///
+/// Records are written in the byte order of the host, and are rejected when
+/// loaded on a host of another byte order.
+///
+/// Topology is not serialized : tables are all that is required to evaluate
+/// primvar data, and can be loaded without a TopologyRefiner.
+///
+class TableSerializer {
+
+public:
+
+    /// \brief Version of the records written (records of previous versions
+    ///        are still loaded)
+    enum { FORMAT_VERSION = 4 };
+
+    /// \brief Appends the record of a table to 'data'
+    static void Write(StencilTable const & table,
+                      std::vector<unsigned char> & data);
+
+    static void Write(LimitStencilTable const & table,
+                      std::vector<unsigned char> & data);
+
+    static void Write(PatchTable const & table,
+                      std::vector<unsigned char> & data);
+
+    static void Write(PtexIndices const & ptexIndices,
+                      std::vector<unsigned char> & data);
+
+    /// \brief Instantiates a StencilTable from the record at the start of
+    ///        'data' (returns NULL if the record is invalid or of another
+    ///        type of table)
+    ///
+    /// @param data       Pointer to the record (a memory mapped file for
+    ///                   instance)
+    ///
+    /// @param size       Size of the data (in bytes)
+    ///
+    /// @param recordSize Optional size of the record (in bytes), or offset of
+    ///                   the next record in 'data'
+    ///
+    static StencilTable const * ReadStencilTable(
+        void const * data, size_t size, size_t * recordSize=0);
+
+    /// \brief Instantiates a LimitStencilTable from the record at the start
+    ///        of 'data' (see ReadStencilTable)
+    static LimitStencilTable const * ReadLimitStencilTable(
+        void const * data, size_t size, size_t * recordSize=0);
+
+    /// \brief Instantiates a PatchTable from the record at the start of
+    ///        'data' (see ReadStencilTable)
+    static PatchTable const * ReadPatchTable(
+        void const * data, size_t size, size_t * recordSize=0);
+
+    /// \brief Instantiates PtexIndices, and their precomputed adjacency if
+    ///        any, from the record at the start of 'data' (see
+    ///        ReadStencilTable)
+    static PtexIndices const * ReadPtexIndices(
+        void const * data, size_t size, size_t * recordSize=0);
+
+    /// \brief Arrays of a serialized StencilTable, referenced in place
+    struct StencilTableView {
+        int           numControlVertices,
+                      numStencils;
+        int   const * sizes;
+        Index const * offsets;
+        Index const * indices;
+        float const * weights;
+    };
+
+    /// \brief References the arrays of the StencilTable record at the start
+    ///        of 'data' without copying them (returns false if the record is
+    ///        invalid or of another type of table)
+    ///
+    /// The view remains valid as long as 'data' does, and 'data' must be
+    /// aligned on 8 bytes (memory mapped files and shared memory are). The
+    /// arrays can be passed directly to the Osd evaluators taking raw stencil
+    /// arrays, so that processes attached to the same SharedMemory evaluate
+    /// from a single copy of the table.
+    ///
+    static bool ViewStencilTable(void const * data, size_t size,
+        StencilTableView & view, size_t * recordSize=0);
+
+    /// \brief Writes serialized data to a file (returns false on failure)
+    static bool WriteFile(char const * filename,
+                          std::vector<unsigned char> const & data);
+
+    /// \brief Read-only memory mapping of a file
+    ///
+    /// Records are loaded from mapped files without intermediate copies : the
+    /// operating system pages in the data as it is read.
+    ///
+    class MappedFile {
+
+    public:
+
+        /// \brief Maps a file in memory (returns NULL on failure)
+        static MappedFile * Open(char const * filename);
+
+        ~MappedFile();
+
+        /// \brief Returns a pointer to the contents of the file
+        void const * GetData() const { return _data; }
+
+        /// \brief Returns the size of the file (in bytes)
+        size_t GetSize() const { return _size; }
+
+    private:
+
+        MappedFile() : _data(0), _size(0), _handle(0) { }
+
+        MappedFile(MappedFile const &);
+        MappedFile & operator=(MappedFile const &);
+
+        void const * _data;
+        size_t       _size;
+        void *       _handle;  // file mapping object (Windows only)
+    };
+
+    /// \brief Named shared memory holding serialized records
+    ///
+    /// A process publishes the records once, and the other processes of the
+    /// host attach to them read-only : the tables are loaded (or viewed) from
+    /// the same physical pages instead of being rebuilt by every process.
+    ///
+    /// The segment persists until it is removed on POSIX systems, and until
+    /// the last process attached to it releases it on Windows.
+    ///
+    class SharedMemory {
+
+    public:
+
+        /// \brief Creates the named segment and copies 'data' into it
+        ///        (returns NULL on failure, or if the name is in use)
+        static SharedMemory * Publish(char const * name,
+                                      std::vector<unsigned char> const & data);
+
+        /// \brief Attaches read-only to a published segment (returns NULL
+        ///        on failure, or if the segment is not completely published)
+        static SharedMemory * Attach(char const * name);
+
+        /// \brief Removes the name of a segment : processes attached keep
+        ///        their mapping (no-op on Windows)
+        static bool Remove(char const * name);
+
+        ~SharedMemory();
+
+        /// \brief Returns a pointer to the published records
+        void const * GetData() const { return _data; }
+
+        /// \brief Returns the size of the published records (in bytes)
+        size_t GetSize() const { return _size; }
+
+    private:
+
+        SharedMemory() : _mapping(0), _mappingSize(0),
+            _data(0), _size(0), _handle(0) { }
+
+        SharedMemory(SharedMemory const &);
+        SharedMemory & operator=(SharedMemory const &);
+
+        void *       _mapping;
+        size_t       _mappingSize;
+        void const * _data;
+        size_t       _size;
+        void *       _handle;  // file mapping object (Windows only)
+    };
+
+private:
+
+    template <class WRITER>
+    static void writeStencils(WRITER & writer, StencilTable const & table);
+
+    template <class READER>
+    static bool readStencils(READER & reader, StencilTable & table);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_TABLE_SERIALIZER_H
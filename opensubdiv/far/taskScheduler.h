@@ -0,0 +1,95 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TASK_SCHEDULER_H
+#define OPENSUBDIV3_FAR_TASK_SCHEDULER_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+///  \brief Abstract interface for the concurrent execution of Far tasks
+///
+///  Far factories and the TopologyRefiner partition their work into ranges
+///  of independent items and delegate the execution of those ranges to a
+///  TaskScheduler.  This allows OpenSubdiv to run within a threading system
+///  already managed by the client (e.g. an existing TBB arena) rather than
+///  starting a competing pool of threads of its own.
+///
+///  Backends for OpenMP and TBB are provided in Osd (OmpTaskScheduler and
+///  TbbTaskScheduler).  Any other scheduler need only implement ParallelFor().
+///
+class TaskScheduler {
+
+public:
+    /// \brief Function applied to a sub-range [begin, end) of items
+    typedef void (*RangeKernel)(int begin, int end, void * data);
+
+    virtual ~TaskScheduler() { }
+
+    /// \brief Applies the kernel to a set of sub-ranges partitioning [begin, end)
+    ///
+    /// Sub-ranges may be processed concurrently and in any order, and the call
+    /// must not return until all have been processed.
+    ///
+    /// @param begin      First item of the range
+    ///
+    /// @param end        One past the last item of the range
+    ///
+    /// @param grainSize  Hint for the minimum number of items per sub-range
+    ///
+    /// @param kernel     Function to apply to each sub-range
+    ///
+    /// @param data       Client data passed to each invocation of the kernel
+    ///
+    virtual void ParallelFor(int begin, int end, int grainSize,
+                             RangeKernel kernel, void * data) const = 0;
+
+    /// \brief Returns the expected number of concurrent workers (used to
+    /// determine the number of ranges into which work is partitioned)
+    virtual int GetNumThreads() const = 0;
+};
+
+///
+///  \brief TaskScheduler applying all ranges serially on the calling thread
+///
+class SerialTaskScheduler : public TaskScheduler {
+
+public:
+    virtual void ParallelFor(int begin, int end, int grainSize,
+                             RangeKernel kernel, void * data) const;
+
+    virtual int GetNumThreads() const { return 1; }
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TASK_SCHEDULER_H */
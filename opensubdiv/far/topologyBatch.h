@@ -0,0 +1,151 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TOPOLOGY_BATCH_H
+#define OPENSUBDIV3_FAR_TOPOLOGY_BATCH_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+#include "../far/topologyRefiner.h"
+#include "../far/stencilTable.h"
+#include "../far/patchTable.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Refiners and tables of a batch of objects built together
+///
+/// Scenes of many small objects build their refiners and tables concurrently
+/// rather than one object at a time (see TopologyBatchFactory).  The batch
+/// owns the refiners and tables of its objects and deletes them with it.
+///
+/// The tables of all the objects may also be packed into a single
+/// StencilTable and a single PatchTable, evaluated in one dispatch :
+///
+///   - the control values of all the objects follow each other, those of
+///     object i starting at GetControlVertexOffset(i)
+///
+///   - the packed stencils refine the vertices of all the objects, those of
+///     object i starting at GetVertexOffset(i) in the buffer of their results
+///
+///   - the packed patches index that buffer (the stencils of each object then
+///     include its control vertices and local points)
+///
+class TopologyBatch {
+
+public:
+
+    ~TopologyBatch() {
+        delete _packedStencilTable;
+        delete _packedPatchTable;
+        for (int i=0; i<GetNumObjects(); ++i) {
+            delete _refiners[i];
+            delete _stencilTables[i];
+            delete _patchTables[i];
+        }
+    }
+
+    /// \brief Returns the number of objects of the batch
+    int GetNumObjects() const { return (int)_refiners.size(); }
+
+    /// \brief Returns the refiner of an object (NULL if refiners were not
+    ///        kept)
+    TopologyRefiner const * GetRefiner(int object) const {
+        return _refiners[object];
+    }
+
+    /// \brief Returns the stencil table of an object (NULL if not created)
+    StencilTable const * GetStencilTable(int object) const {
+        return _stencilTables[object];
+    }
+
+    /// \brief Returns the patch table of an object (NULL if not created)
+    PatchTable const * GetPatchTable(int object) const {
+        return _patchTables[object];
+    }
+
+    /// \brief Returns the stencils of all the objects (NULL if not packed)
+    StencilTable const * GetPackedStencilTable() const {
+        return _packedStencilTable;
+    }
+
+    /// \brief Returns the patches of all the objects (NULL if not packed)
+    PatchTable const * GetPackedPatchTable() const {
+        return _packedPatchTable;
+    }
+
+    /// \brief Returns the index of the first control vertex of an object in
+    ///        the control values of the packed stencils (the entry at
+    ///        GetNumObjects() is the number of control vertices of all)
+    Index GetControlVertexOffset(int object) const {
+        return _controlVertexOffsets[object];
+    }
+
+    /// \brief Returns the index of the first stencil of an object in the
+    ///        packed stencils (the entry at GetNumObjects() is the number of
+    ///        stencils of all)
+    Index GetVertexOffset(int object) const {
+        return _vertexOffsets[object];
+    }
+
+private:
+
+    friend class TopologyBatchFactory;
+
+    TopologyBatch(int numObjects) :
+        _refiners(numObjects, 0),
+        _stencilTables(numObjects, 0),
+        _patchTables(numObjects, 0),
+        _packedStencilTable(0),
+        _packedPatchTable(0),
+        _controlVertexOffsets(numObjects + 1, 0),
+        _vertexOffsets(numObjects + 1, 0) { }
+
+    TopologyBatch(TopologyBatch const &);
+    TopologyBatch & operator=(TopologyBatch const &);
+
+    std::vector<TopologyRefiner *>      _refiners;
+    std::vector<StencilTable const *>   _stencilTables;
+    std::vector<PatchTable const *>     _patchTables;
+
+    StencilTable const * _packedStencilTable;
+    PatchTable const *   _packedPatchTable;
+
+    std::vector<Index> _controlVertexOffsets,   // of each object in the packed tables
+                       _vertexOffsets;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_TOPOLOGY_BATCH_H
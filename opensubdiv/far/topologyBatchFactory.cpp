@@ -0,0 +1,245 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#include "../far/topologyBatchFactory.h"
+#include "../far/error.h"
+#include "../far/taskScheduler.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //  Objects built by each range of the scheduler, with the status of each
+    struct BatchKernelData {
+        TopologyDescriptor const *           descriptors;
+        TopologyBatchFactory::Options const * options;
+
+        std::vector<TopologyRefiner *> *    refiners;
+        std::vector<StencilTable const *> * stencilTables;
+        std::vector<PatchTable const *> *   patchTables;
+        std::vector<char> *                 built;
+    };
+
+    void
+    buildObject(BatchKernelData const & data, int object) {
+
+        typedef TopologyBatchFactory::RefinerFactory RefinerFactory;
+
+        TopologyBatchFactory::Options const & options = *data.options;
+
+        TopologyRefiner * refiner =
+            RefinerFactory::Create(data.descriptors[object], options.refinerOptions);
+        if (not refiner) return;
+
+        if (options.refineAdaptive) {
+            refiner->RefineAdaptive(options.adaptiveOptions);
+        } else {
+            refiner->RefineUniform(options.uniformOptions);
+        }
+
+        bool built = true;
+
+        StencilTable const * stencils = 0;
+        if (options.createStencilTables) {
+            stencils = StencilTableFactory::Create(*refiner, options.stencilOptions);
+            built = (stencils != 0);
+        }
+
+        PatchTable const * patches = 0;
+        if (built and options.createPatchTables) {
+            patches = PatchTableFactory::Create(*refiner, options.patchOptions);
+            built = (patches != 0);
+
+            //  The stencils of the local points of the patches follow those of the
+            //  refined vertices they are expressed in:
+            StencilTable const * localPoints =
+                patches ? patches->GetLocalPointStencilTable() : 0;
+            if (stencils and localPoints and localPoints->GetNumStencils() > 0) {
+                StencilTable const * appended =
+                    StencilTableFactory::AppendLocalPointStencilTable(
+                        *refiner, stencils, localPoints, true, true);
+                if (appended) {
+                    stencils = appended;
+                } else {
+                    built = false;
+                }
+            }
+        }
+
+        if (not options.keepRefiners) {
+            delete refiner;
+            refiner = 0;
+        }
+        (*data.refiners)[object] = refiner;
+        (*data.stencilTables)[object] = stencils;
+        (*data.patchTables)[object] = patches;
+        (*data.built)[object] = built;
+    }
+
+    void
+    buildObjectsKernel(int begin, int end, void * data) {
+
+        BatchKernelData const & batchData = *static_cast<BatchKernelData const *>(data);
+        for (int object = begin; object < end; ++object) {
+            buildObject(batchData, object);
+        }
+    }
+}
+
+TopologyBatch const *
+TopologyBatchFactory::Create(int numObjects,
+    TopologyDescriptor const * descriptors, Options options) {
+
+    if (numObjects < 0 or (numObjects > 0 and not descriptors)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyBatchFactory::Create() -- "
+            "invalid descriptors.");
+        return NULL;
+    }
+    if (options.packTables and options.createPatchTables and
+        (not options.createStencilTables)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyBatchFactory::Create() -- "
+            "packed patch tables require stencil tables.");
+        return NULL;
+    }
+
+    //  Each object is built serially by one worker of the scheduler:
+    options.refinerOptions.numThreads = 1;
+    options.refinerOptions.taskScheduler = 0;
+    options.uniformOptions.numThreads = 1;
+    options.uniformOptions.taskScheduler = 0;
+    options.adaptiveOptions.numThreads = 1;
+    options.adaptiveOptions.taskScheduler = 0;
+    options.stencilOptions.taskScheduler = 0;
+    options.stencilOptions.monitor = 0;
+
+    //  Local points are expressed in all the levels, and packed patches index
+    //  the control vertices of each object in the packed stencils:
+    if (options.createPatchTables) {
+        options.stencilOptions.generateIntermediateLevels = true;
+        if (options.packTables) {
+            options.stencilOptions.generateControlVerts = true;
+        }
+    }
+
+    TopologyBatch * batch = new TopologyBatch(numObjects);
+
+    std::vector<char> built(numObjects, 0);
+
+    BatchKernelData data;
+    data.descriptors   = descriptors;
+    data.options       = &options;
+    data.refiners      = &batch->_refiners;
+    data.stencilTables = &batch->_stencilTables;
+    data.patchTables   = &batch->_patchTables;
+    data.built         = &built;
+
+    if (options.taskScheduler) {
+        options.taskScheduler->ParallelFor(0, numObjects, 1, buildObjectsKernel, &data);
+    } else {
+        buildObjectsKernel(0, numObjects, &data);
+    }
+
+    for (int object = 0; object < numObjects; ++object) {
+        if (not built[object]) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyBatchFactory::Create() -- "
+                "object %d could not be built.", object);
+            delete batch;
+            return NULL;
+        }
+    }
+
+    if (options.packTables and (not packTables(*batch, options))) {
+        delete batch;
+        return NULL;
+    }
+    return batch;
+}
+
+bool
+TopologyBatchFactory::packTables(TopologyBatch & batch, Options const & options) {
+
+    int numObjects = batch.GetNumObjects();
+
+    if (options.createStencilTables) {
+        size_t numWeights = 0;
+        for (int object = 0; object < numObjects; ++object) {
+            StencilTable const & stencils = *batch._stencilTables[object];
+
+            batch._controlVertexOffsets[object + 1] =
+                batch._controlVertexOffsets[object] + stencils.GetNumControlVertices();
+            batch._vertexOffsets[object + 1] =
+                batch._vertexOffsets[object] + stencils.GetNumStencils();
+            numWeights += stencils.GetControlIndices().size();
+        }
+
+        //  The stencils of each object follow each other, their control vertices
+        //  offset by those of the objects preceding it:
+        std::vector<int>   sizes;
+        std::vector<Index> indices;
+        std::vector<float> weights;
+        sizes.reserve(batch._vertexOffsets[numObjects]);
+        indices.reserve(numWeights);
+        weights.reserve(numWeights);
+
+        for (int object = 0; object < numObjects; ++object) {
+            StencilTable const & stencils = *batch._stencilTables[object];
+
+            Index offset = batch._controlVertexOffsets[object];
+
+            sizes.insert(sizes.end(), stencils.GetSizes().begin(),
+                                      stencils.GetSizes().end());
+            for (size_t i = 0; i < stencils.GetControlIndices().size(); ++i) {
+                indices.push_back(stencils.GetControlIndices()[i] + offset);
+            }
+            weights.insert(weights.end(), stencils.GetWeights().begin(),
+                                          stencils.GetWeights().end());
+        }
+        batch._packedStencilTable = StencilTableFactory::Create(
+            batch._controlVertexOffsets[numObjects], sizes, indices, weights);
+        if (not batch._packedStencilTable) {
+            return false;
+        }
+    }
+
+    if (options.createPatchTables) {
+        //  The patches of each object index its vertices in the packed stencils:
+        batch._packedPatchTable = PatchTableFactory::Create(numObjects,
+            numObjects ? &batch._patchTables[0] : 0,
+            numObjects ? &batch._vertexOffsets[0] : 0);
+        if (not batch._packedPatchTable) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
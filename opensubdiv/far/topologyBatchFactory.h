@@ -0,0 +1,118 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TOPOLOGY_BATCH_FACTORY_H
+#define OPENSUBDIV3_FAR_TOPOLOGY_BATCH_FACTORY_H
+
+#include "../version.h"
+
+#include "../far/topologyBatch.h"
+#include "../far/topologyDescriptor.h"
+#include "../far/stencilTableFactory.h"
+#include "../far/patchTableFactory.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TaskScheduler;
+
+/// \brief A specialized factory for TopologyBatch
+///
+class TopologyBatchFactory {
+
+public:
+    typedef TopologyRefinerFactory<TopologyDescriptor> RefinerFactory;
+
+    struct Options {
+
+        Options() :
+            uniformOptions(1),
+            adaptiveOptions(2),
+            refineAdaptive(false),
+            createStencilTables(true),
+            createPatchTables(false),
+            keepRefiners(true),
+            packTables(false),
+            taskScheduler(0) { }
+
+        RefinerFactory::Options          refinerOptions;  ///< Scheme of the refiners
+        TopologyRefiner::UniformOptions  uniformOptions;  ///< Uniform refinement
+        TopologyRefiner::AdaptiveOptions adaptiveOptions; ///< Adaptive refinement
+
+        StencilTableFactory::Options stencilOptions;      ///< Stencil tables
+        PatchTableFactory::Options   patchOptions;        ///< Patch tables
+
+        unsigned int refineAdaptive      : 1, ///< Refine adaptively rather than uniformly
+                     createStencilTables : 1, ///< Create the stencil table of each object
+                     createPatchTables   : 1, ///< Create the patch table of each object
+                     keepRefiners        : 1, ///< Keep the refiners once the tables are
+                                              ///< created (deleted as soon as possible
+                                              ///< otherwise)
+                     packTables          : 1; ///< Pack the tables of all the objects (see
+                                              ///< TopologyBatch)
+
+        TaskScheduler const * taskScheduler;  ///< Optional scheduler building the objects
+                                              ///< concurrently (serially if NULL)
+    };
+
+    /// \brief Instantiates the refiners and tables of a batch of objects
+    ///
+    /// Each object is built on a single worker of the scheduler, from its
+    /// refiner to its tables : the concurrency options of the refinement and
+    /// of the tables (and their build monitor) are ignored. Refined levels are
+    /// allocated from the MemoryResource of refinerOptions if any, which must
+    /// then be thread-safe.
+    ///
+    /// When patch tables are created, the local points of each patch table
+    /// are appended to the stencil table of the object. Packed patches index
+    /// the vertices of the packed stencils, which then include the control
+    /// vertices and all the levels of each object (generateControlVerts and
+    /// generateIntermediateLevels are implied).
+    ///
+    /// @param numObjects   Number of objects
+    ///
+    /// @param descriptors  Topology of each object
+    ///
+    /// @param options      Options shared by all the objects
+    ///
+    /// @return             A new instance of TopologyBatch (NULL if any object
+    ///                     fails to be built)
+    ///
+    static TopologyBatch const * Create(int numObjects,
+                                        TopologyDescriptor const * descriptors,
+                                        Options options = Options());
+
+private:
+    static bool packTables(TopologyBatch & batch, Options const & options);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_TOPOLOGY_BATCH_FACTORY_H
@@ -0,0 +1,318 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/topologyCache.h"
+#include "../far/patchTable.h"
+#include "../far/stencilTable.h"
+#include "../far/tableSerializer.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    inline void
+    refine(TopologyRefiner & refiner, TopologyRefiner::UniformOptions const & options) {
+        refiner.RefineUniform(options);
+    }
+
+    inline void
+    refine(TopologyRefiner & refiner, TopologyRefiner::AdaptiveOptions const & options) {
+        refiner.RefineAdaptive(options);
+    }
+
+    //  table records of the directory of the cache
+    inline StencilTable const *
+    readTable(TableSerializer::MappedFile const & file, StencilTable const *) {
+        return TableSerializer::ReadStencilTable(file.GetData(), file.GetSize());
+    }
+
+    inline LimitStencilTable const *
+    readTable(TableSerializer::MappedFile const & file, LimitStencilTable const *) {
+        return TableSerializer::ReadLimitStencilTable(file.GetData(), file.GetSize());
+    }
+
+    inline PatchTable const *
+    readTable(TableSerializer::MappedFile const & file, PatchTable const *) {
+        return TableSerializer::ReadPatchTable(file.GetData(), file.GetSize());
+    }
+
+    //  a missing file is a miss of the cache rather than an error : only
+    //  files found but failing to map or parse are reported
+    inline bool
+    fileExists(std::string const & filename) {
+
+        FILE * file = fopen(filename.c_str(), "rb");
+        if (not file) {
+            return false;
+        }
+        fclose(file);
+        return true;
+    }
+
+    template <class TABLE>
+    TABLE const *
+    loadTable(std::string const & filename) {
+
+        if (not fileExists(filename)) {
+            return 0;
+        }
+        TableSerializer::MappedFile * file =
+            TableSerializer::MappedFile::Open(filename.c_str());
+        if (not file) {
+            return 0;
+        }
+        TABLE const * table = readTable(*file, (TABLE const *)0);
+        delete file;
+        return table;
+    }
+
+    template <class TABLE>
+    void
+    saveTable(std::string const & filename, TABLE const & table) {
+
+        std::vector<unsigned char> data;
+        TableSerializer::Write(table, data);
+        TableSerializer::WriteFile(filename.c_str(), data);
+    }
+}
+
+TopologyCache::TopologyCache(char const * directory) {
+    if (directory) {
+        _directory = directory;
+    }
+}
+
+TopologyCache::~TopologyCache() {
+    Clear();
+}
+
+void
+TopologyCache::Clear() {
+
+    for (std::map<Hash, TopologyRefiner *>::iterator it = _refiners.begin();
+         it != _refiners.end(); ++it) {
+        delete it->second;
+    }
+    for (std::map<Hash, StencilTable const *>::iterator it = _stencilTables.begin();
+         it != _stencilTables.end(); ++it) {
+        delete it->second;
+    }
+    for (std::map<Hash, PatchTable const *>::iterator it = _patchTables.begin();
+         it != _patchTables.end(); ++it) {
+        delete it->second;
+    }
+    _refiners.clear();
+    _stencilTables.clear();
+    _patchTables.clear();
+}
+
+std::string
+TopologyCache::getFilename(Hash hash, char const * extension) const {
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", hash);
+    return _directory + "/" + name + extension;
+}
+
+template <class REFINE_OPTIONS>
+TopologyRefiner const *
+TopologyCache::getRefiner(Hash hash,
+                          TopologyDescriptor const & desc,
+                          RefinerFactory::Options const & options,
+                          REFINE_OPTIONS const & refineOptions) {
+
+    std::map<Hash, TopologyRefiner *>::iterator it = _refiners.find(hash);
+    if (it != _refiners.end()) {
+        return it->second;
+    }
+
+    TopologyRefiner * refiner = RefinerFactory::Create(desc, options);
+    if (not refiner) {
+        return 0;
+    }
+    refine(*refiner, refineOptions);
+
+    _refiners[hash] = refiner;
+    return refiner;
+}
+
+template <class REFINE_OPTIONS>
+StencilTable const *
+TopologyCache::getStencilTable(TopologyDescriptor const & desc,
+                               RefinerFactory::Options const & options,
+                               REFINE_OPTIONS const & refineOptions,
+                               StencilTableFactory::Options const & tableOptions,
+                               TaskScheduler const * scheduler) {
+
+    Hash refinerHash = TopologyFingerprint::Combine(
+        TopologyFingerprint::Compute(desc, options, scheduler), refineOptions);
+
+    Hash hash = TopologyFingerprint::Combine(refinerHash, tableOptions);
+
+    std::map<Hash, StencilTable const *>::iterator it = _stencilTables.find(hash);
+    if (it != _stencilTables.end()) {
+        return it->second;
+    }
+
+    // tables projected to the limit are LimitStencilTables, holding the
+    // weights of the derivatives as well
+    StencilTable const * table = 0;
+    if (not _directory.empty()) {
+        if (tableOptions.projectToLimit) {
+            table = loadTable<LimitStencilTable>(getFilename(hash, ".stencils"));
+        } else {
+            table = loadTable<StencilTable>(getFilename(hash, ".stencils"));
+        }
+    }
+    if (not table) {
+        TopologyRefiner const * refiner =
+            getRefiner(refinerHash, desc, options, refineOptions);
+        if (not refiner) {
+            return 0;
+        }
+        table = StencilTableFactory::Create(*refiner, tableOptions);
+        if (not table) {
+            return 0;
+        }
+        if (not _directory.empty()) {
+            if (tableOptions.projectToLimit) {
+                saveTable(getFilename(hash, ".stencils"),
+                          static_cast<LimitStencilTable const &>(*table));
+            } else {
+                saveTable(getFilename(hash, ".stencils"), *table);
+            }
+        }
+    }
+    _stencilTables[hash] = table;
+    return table;
+}
+
+template <class REFINE_OPTIONS>
+PatchTable const *
+TopologyCache::getPatchTable(TopologyDescriptor const & desc,
+                             RefinerFactory::Options const & options,
+                             REFINE_OPTIONS const & refineOptions,
+                             PatchTableFactory::Options const & tableOptions,
+                             TaskScheduler const * scheduler) {
+
+    Hash refinerHash = TopologyFingerprint::Combine(
+        TopologyFingerprint::Compute(desc, options, scheduler), refineOptions);
+
+    Hash hash = TopologyFingerprint::Combine(refinerHash, tableOptions);
+
+    std::map<Hash, PatchTable const *>::iterator it = _patchTables.find(hash);
+    if (it != _patchTables.end()) {
+        return it->second;
+    }
+
+    PatchTable const * table = 0;
+    if (not _directory.empty()) {
+        table = loadTable<PatchTable>(getFilename(hash, ".patches"));
+    }
+    if (not table) {
+        TopologyRefiner const * refiner =
+            getRefiner(refinerHash, desc, options, refineOptions);
+        if (not refiner) {
+            return 0;
+        }
+        table = PatchTableFactory::Create(*refiner, tableOptions);
+        if (not table) {
+            return 0;
+        }
+        if (not _directory.empty()) {
+            saveTable(getFilename(hash, ".patches"), *table);
+        }
+    }
+    _patchTables[hash] = table;
+    return table;
+}
+
+TopologyRefiner const *
+TopologyCache::GetRefiner(TopologyDescriptor const & desc,
+                          RefinerFactory::Options const & options,
+                          TopologyRefiner::UniformOptions const & refineOptions,
+                          TaskScheduler const * scheduler) {
+
+    Hash hash = TopologyFingerprint::Combine(
+        TopologyFingerprint::Compute(desc, options, scheduler), refineOptions);
+    return getRefiner(hash, desc, options, refineOptions);
+}
+
+TopologyRefiner const *
+TopologyCache::GetRefiner(TopologyDescriptor const & desc,
+                          RefinerFactory::Options const & options,
+                          TopologyRefiner::AdaptiveOptions const & refineOptions,
+                          TaskScheduler const * scheduler) {
+
+    Hash hash = TopologyFingerprint::Combine(
+        TopologyFingerprint::Compute(desc, options, scheduler), refineOptions);
+    return getRefiner(hash, desc, options, refineOptions);
+}
+
+StencilTable const *
+TopologyCache::GetStencilTable(TopologyDescriptor const & desc,
+                               RefinerFactory::Options const & options,
+                               TopologyRefiner::UniformOptions const & refineOptions,
+                               StencilTableFactory::Options const & tableOptions,
+                               TaskScheduler const * scheduler) {
+    return getStencilTable(desc, options, refineOptions, tableOptions, scheduler);
+}
+
+StencilTable const *
+TopologyCache::GetStencilTable(TopologyDescriptor const & desc,
+                               RefinerFactory::Options const & options,
+                               TopologyRefiner::AdaptiveOptions const & refineOptions,
+                               StencilTableFactory::Options const & tableOptions,
+                               TaskScheduler const * scheduler) {
+    return getStencilTable(desc, options, refineOptions, tableOptions, scheduler);
+}
+
+PatchTable const *
+TopologyCache::GetPatchTable(TopologyDescriptor const & desc,
+                             RefinerFactory::Options const & options,
+                             TopologyRefiner::UniformOptions const & refineOptions,
+                             PatchTableFactory::Options const & tableOptions,
+                             TaskScheduler const * scheduler) {
+    return getPatchTable(desc, options, refineOptions, tableOptions, scheduler);
+}
+
+PatchTable const *
+TopologyCache::GetPatchTable(TopologyDescriptor const & desc,
+                             RefinerFactory::Options const & options,
+                             TopologyRefiner::AdaptiveOptions const & refineOptions,
+                             PatchTableFactory::Options const & tableOptions,
+                             TaskScheduler const * scheduler) {
+    return getPatchTable(desc, options, refineOptions, tableOptions, scheduler);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,178 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TOPOLOGY_CACHE_H
+#define OPENSUBDIV3_FAR_TOPOLOGY_CACHE_H
+
+#include "../version.h"
+
+#include "../far/topologyFingerprint.h"
+
+#include <map>
+#include <string>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class StencilTable;
+class PatchTable;
+
+///
+///  \brief Cache of refiners and tables shared by identical topologies
+///
+///  Refiners and tables are identified by the fingerprint of their topology
+///  and options (see TopologyFingerprint) : requests for a topology already
+///  in the cache return the instances built for the first request rather
+///  than building them again.
+///
+///  Given a directory, tables are also saved there (see TableSerializer)
+///  and loaded by later sessions without refining the topology at all.
+///  Refiners are not serialized, and are rebuilt once per session when
+///  requested.
+///
+///  Instances returned are owned by the cache and remain valid until it is
+///  cleared or destroyed.  The cache is not thread-safe : requests from
+///  several threads must be serialized by the client.
+///
+class TopologyCache {
+
+public:
+    typedef TopologyFingerprint::Hash                  Hash;
+    typedef TopologyRefinerFactory<TopologyDescriptor> RefinerFactory;
+
+    /// \brief Constructor
+    ///
+    /// @param directory  Optional directory where tables are saved and
+    ///                   found across sessions (tables are only kept in
+    ///                   memory if NULL)
+    ///
+    explicit TopologyCache(char const * directory = 0);
+
+    ~TopologyCache();
+
+    /// \brief Returns a shared refiner of the topology, uniformly refined
+    ///
+    /// @param desc           Topology of the refiner
+    ///
+    /// @param options        Scheme of the refiner
+    ///
+    /// @param refineOptions  Refinement of the refiner
+    ///
+    /// @param scheduler      Optional scheduler hashing the topology
+    ///                       concurrently (see TopologyFingerprint)
+    ///
+    TopologyRefiner const * GetRefiner(TopologyDescriptor const & desc,
+                                       RefinerFactory::Options const & options,
+                                       TopologyRefiner::UniformOptions const & refineOptions,
+                                       TaskScheduler const * scheduler = 0);
+
+    /// \brief Returns a shared refiner of the topology, adaptively refined
+    TopologyRefiner const * GetRefiner(TopologyDescriptor const & desc,
+                                       RefinerFactory::Options const & options,
+                                       TopologyRefiner::AdaptiveOptions const & refineOptions,
+                                       TaskScheduler const * scheduler = 0);
+
+    /// \brief Returns a shared stencil table of the uniformly refined
+    ///        topology (NULL if the table cannot be built)
+    StencilTable const * GetStencilTable(TopologyDescriptor const & desc,
+                                         RefinerFactory::Options const & options,
+                                         TopologyRefiner::UniformOptions const & refineOptions,
+                                         StencilTableFactory::Options const & tableOptions,
+                                         TaskScheduler const * scheduler = 0);
+
+    /// \brief Returns a shared stencil table of the adaptively refined
+    ///        topology (NULL if the table cannot be built)
+    StencilTable const * GetStencilTable(TopologyDescriptor const & desc,
+                                         RefinerFactory::Options const & options,
+                                         TopologyRefiner::AdaptiveOptions const & refineOptions,
+                                         StencilTableFactory::Options const & tableOptions,
+                                         TaskScheduler const * scheduler = 0);
+
+    /// \brief Returns a shared patch table of the uniformly refined topology
+    ///        (NULL if the table cannot be built)
+    PatchTable const * GetPatchTable(TopologyDescriptor const & desc,
+                                     RefinerFactory::Options const & options,
+                                     TopologyRefiner::UniformOptions const & refineOptions,
+                                     PatchTableFactory::Options const & tableOptions,
+                                     TaskScheduler const * scheduler = 0);
+
+    /// \brief Returns a shared patch table of the adaptively refined
+    ///        topology (NULL if the table cannot be built)
+    PatchTable const * GetPatchTable(TopologyDescriptor const & desc,
+                                     RefinerFactory::Options const & options,
+                                     TopologyRefiner::AdaptiveOptions const & refineOptions,
+                                     PatchTableFactory::Options const & tableOptions,
+                                     TaskScheduler const * scheduler = 0);
+
+    /// \brief Returns the number of refiners and tables in the cache
+    int GetNumEntries() const {
+        return (int)(_refiners.size() + _stencilTables.size() +
+                     _patchTables.size());
+    }
+
+    /// \brief Deletes the refiners and tables of the cache (files saved in
+    ///        the directory of the cache are kept)
+    void Clear();
+
+private:
+    TopologyCache(TopologyCache const &);
+    TopologyCache & operator=(TopologyCache const &);
+
+    template <class REFINE_OPTIONS>
+    TopologyRefiner const * getRefiner(Hash hash,
+                                       TopologyDescriptor const & desc,
+                                       RefinerFactory::Options const & options,
+                                       REFINE_OPTIONS const & refineOptions);
+
+    template <class REFINE_OPTIONS>
+    StencilTable const * getStencilTable(TopologyDescriptor const & desc,
+                                         RefinerFactory::Options const & options,
+                                         REFINE_OPTIONS const & refineOptions,
+                                         StencilTableFactory::Options const & tableOptions,
+                                         TaskScheduler const * scheduler);
+
+    template <class REFINE_OPTIONS>
+    PatchTable const * getPatchTable(TopologyDescriptor const & desc,
+                                     RefinerFactory::Options const & options,
+                                     REFINE_OPTIONS const & refineOptions,
+                                     PatchTableFactory::Options const & tableOptions,
+                                     TaskScheduler const * scheduler);
+
+    std::string getFilename(Hash hash, char const * extension) const;
+
+    std::string _directory;
+
+    std::map<Hash, TopologyRefiner *>      _refiners;
+    std::map<Hash, StencilTable const *>   _stencilTables;
+    std::map<Hash, PatchTable const *>     _patchTables;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TOPOLOGY_CACHE_H */
@@ -29,6 +29,7 @@
 #include "../vtr/level.h"
 
 #include <cstdio>
+#include <cstring>
 #ifdef _MSC_VER
     #define snprintf _snprintf
 #endif
@@ -70,22 +71,54 @@ bool
 TopologyRefinerFactory<TopologyDescriptor>::assignComponentTopology(
     TopologyRefiner & refiner, TopologyDescriptor const & desc) {
 
-    for (int face=0, idx=0; face<desc.numFaces; ++face) {
+    Vtr::internal::Level & baseLevel = refiner.getLevel(0);
 
-        IndexArray dstFaceVerts = getBaseFaceVertices(refiner, face);
+    if (desc.isLeftHanded) {
+        for (int face=0, idx=0; face<desc.numFaces; ++face) {
+
+            IndexArray dstFaceVerts = getBaseFaceVertices(refiner, face);
 
-        if (desc.isLeftHanded) {
             dstFaceVerts[0] = desc.vertIndicesPerFace[idx++];
             for (int vert=dstFaceVerts.size()-1; vert > 0; --vert) {
 
                 dstFaceVerts[vert] = desc.vertIndicesPerFace[idx++];
             }
-        } else {
-            for (int vert=0; vert<dstFaceVerts.size(); ++vert) {
+        }
+    } else {
+        //  Face-vertices are contiguous and in the same order as the descriptor's:
+        std::memcpy(&getBaseFaceVertices(refiner, 0)[0], desc.vertIndicesPerFace,
+                    baseLevel.getNumFaceVerticesTotal() * sizeof(Index));
+    }
 
-                dstFaceVerts[vert] = desc.vertIndicesPerFace[idx++];
+    //
+    //  When edges are given, complete the topology here rather than deferring to
+    //  the generic completion from the face-vertices:
+    //
+    if ((desc.numEdges > 0) and desc.faceEdgeIndices) {
+        baseLevel.resizeFaceEdges(baseLevel.getNumFaceVerticesTotal());
+
+        //  The edge following face-vertex i of a left-handed face of size N follows
+        //  face-vertex N-1-i once reversed:
+        for (int face=0, idx=0; face<desc.numFaces; ++face) {
+
+            IndexArray dstFaceEdges = getBaseFaceEdges(refiner, face);
+
+            int size = dstFaceEdges.size();
+            for (int edge=0; edge<size; ++edge) {
+
+                dstFaceEdges[desc.isLeftHanded ? (size-1-edge) : edge] =
+                    desc.faceEdgeIndices[idx++];
             }
         }
+
+        if (not baseLevel.completeTopologyFromFaceEdges(desc.numEdges)) {
+            char msg[1024];
+            snprintf(msg, 1024, "Failure in TopologyRefinerFactory<TopologyDescriptor>::Create() -- "
+                    "vertex with valence %d > %d max, or edge not incident any face.",
+                    baseLevel.getMaxValence(), Vtr::VALENCE_LIMIT);
+            Error(FAR_RUNTIME_ERROR, msg);
+            return false;
+        }
     }
     return true;
 }
@@ -64,6 +64,13 @@ struct TopologyDescriptor {
 
     bool          isLeftHanded;
 
+    //  Optional edges -- face-vertices only need be specified, but edges given
+    //  with one edge for every vertex of every face (the edge from each
+    //  face-vertex to the next) need not be identified:
+    //
+    int           numEdges;
+    Index const * faceEdgeIndices;
+
     //  Face-varying data channel -- value indices correspond to vertex indices,
     //  i.e. one for every vertex of every face:
     //
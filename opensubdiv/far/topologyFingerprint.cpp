@@ -0,0 +1,254 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/topologyFingerprint.h"
+#include "../far/taskScheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    typedef TopologyFingerprint::Hash Hash;
+
+    //
+    //  Words are mixed as in MurmurHash64A : hashes depend on the values of
+    //  the words, not on the byte order of the host
+    //
+    const Hash hashMultiplier = 0xc6a4a7935bd1e995ULL;
+
+    inline Hash
+    mix(Hash hash, Hash word) {
+        word *= hashMultiplier;
+        word ^= word >> 47;
+        word *= hashMultiplier;
+        return (hash ^ word) * hashMultiplier;
+    }
+
+    inline Hash
+    finalize(Hash hash) {
+        hash ^= hash >> 47;
+        hash *= hashMultiplier;
+        return hash ^ (hash >> 47);
+    }
+
+    template <typename T>
+    inline unsigned int
+    asWord(T const & value) {
+        unsigned int word;
+        std::memcpy(&word, &value, sizeof(word));
+        return word;
+    }
+
+    //
+    //  Arrays are hashed in chunks of a fixed size, whatever the scheduler,
+    //  so that concurrent and serial hashes match
+    //
+    const int chunkSize = 1 << 16;
+
+    template <typename T>
+    struct ChunkData {
+        T const * array;
+        int       size;
+        Hash *    chunkHashes;
+    };
+
+    template <typename T>
+    void
+    hashChunks(int begin, int end, void * data) {
+
+        ChunkData<T> const & chunks = *static_cast<ChunkData<T> *>(data);
+
+        for (int chunk = begin; chunk < end; ++chunk) {
+            int first = chunk * chunkSize,
+                last = std::min(first + chunkSize, chunks.size);
+
+            Hash hash = (Hash)chunk;
+            for (int i = first; i < last; ++i) {
+                hash = mix(hash, asWord(chunks.array[i]));
+            }
+            chunks.chunkHashes[chunk] = hash;
+        }
+    }
+
+    template <typename T>
+    Hash
+    hashArray(Hash hash, T const * array, int size,
+              TaskScheduler const * scheduler) {
+
+        if (array == 0 or size <= 0) {
+            return mix(hash, 0);
+        }
+        hash = mix(hash, (Hash)size);
+
+        int numChunks = (size + chunkSize - 1) / chunkSize;
+
+        std::vector<Hash> chunkHashes(numChunks);
+
+        ChunkData<T> data = { array, size, &chunkHashes[0] };
+        if (scheduler and numChunks > 1) {
+            scheduler->ParallelFor(0, numChunks, 1, hashChunks<T>, &data);
+        } else {
+            hashChunks<T>(0, numChunks, &data);
+        }
+
+        for (int chunk = 0; chunk < numChunks; ++chunk) {
+            hash = mix(hash, chunkHashes[chunk]);
+        }
+        return hash;
+    }
+
+    //  tags distinguishing the kinds of data combined into a hash
+    enum Tag {
+        TAG_TOPOLOGY = 1,
+        TAG_UNIFORM,
+        TAG_ADAPTIVE,
+        TAG_STENCIL_TABLE,
+        TAG_PATCH_TABLE
+    };
+}
+
+TopologyFingerprint::Hash
+TopologyFingerprint::Compute(TopologyDescriptor const & desc,
+                             TopologyRefinerFactory<TopologyDescriptor>::Options const & options,
+                             TaskScheduler const * scheduler) {
+
+    Hash hash = mix(0, TAG_TOPOLOGY);
+
+    //  scheme
+    Sdc::Options const & sdcOptions = options.schemeOptions;
+    hash = mix(hash, options.schemeType);
+    hash = mix(hash, sdcOptions.GetVtxBoundaryInterpolation());
+    hash = mix(hash, sdcOptions.GetFVarLinearInterpolation());
+    hash = mix(hash, sdcOptions.GetCreasingMethod());
+    hash = mix(hash, sdcOptions.GetTriangleSubdivision());
+
+    //  face-vertices
+    int numFaceVerts = 0;
+    if (desc.numVertsPerFace) {
+        for (int face = 0; face < desc.numFaces; ++face) {
+            numFaceVerts += desc.numVertsPerFace[face];
+        }
+    }
+    hash = mix(hash, desc.numVertices);
+    hash = mix(hash, desc.numFaces);
+    hash = mix(hash, desc.isLeftHanded);
+    hash = hashArray(hash, desc.numVertsPerFace, desc.numFaces, scheduler);
+    hash = hashArray(hash, desc.vertIndicesPerFace, numFaceVerts, scheduler);
+
+    //  optional edges
+    hash = mix(hash, desc.numEdges);
+    hash = hashArray(hash, desc.faceEdgeIndices,
+                     desc.numEdges > 0 ? numFaceVerts : 0, scheduler);
+
+    //  tags
+    hash = hashArray(hash, desc.creaseVertexIndexPairs, 2 * desc.numCreases, scheduler);
+    hash = hashArray(hash, desc.creaseWeights, desc.numCreases, scheduler);
+    hash = hashArray(hash, desc.cornerVertexIndices, desc.numCorners, scheduler);
+    hash = hashArray(hash, desc.cornerWeights, desc.numCorners, scheduler);
+    hash = hashArray(hash, desc.holeIndices, desc.numHoles, scheduler);
+
+    //  face-varying channels
+    int numFVarChannels = desc.fvarChannels ? desc.numFVarChannels : 0;
+    hash = mix(hash, numFVarChannels);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        TopologyDescriptor::FVarChannel const & fvar = desc.fvarChannels[channel];
+        hash = mix(hash, fvar.numValues);
+        hash = hashArray(hash, fvar.valueIndices, numFaceVerts, scheduler);
+    }
+    return finalize(hash);
+}
+
+TopologyFingerprint::Hash
+TopologyFingerprint::Combine(Hash hash, TopologyRefiner::UniformOptions const & options) {
+
+    hash = mix(hash, TAG_UNIFORM);
+    hash = mix(hash, options.refinementLevel);
+    hash = mix(hash, options.orderVerticesFromFacesFirst);
+    hash = mix(hash, options.fullTopologyInLastLevel);
+    hash = mix(hash, options.skipHoles);
+    return finalize(hash);
+}
+
+TopologyFingerprint::Hash
+TopologyFingerprint::Combine(Hash hash, TopologyRefiner::AdaptiveOptions const & options) {
+
+    hash = mix(hash, TAG_ADAPTIVE);
+    hash = mix(hash, options.isolationLevel);
+    hash = mix(hash, options.secondaryLevel);
+    hash = mix(hash, options.useSingleCreasePatch);
+    hash = mix(hash, options.useInfSharpPatch);
+    hash = mix(hash, options.orderVerticesFromFacesFirst);
+    return finalize(hash);
+}
+
+TopologyFingerprint::Hash
+TopologyFingerprint::Combine(Hash hash, StencilTableFactory::Options const & options) {
+
+    hash = mix(hash, TAG_STENCIL_TABLE);
+    hash = mix(hash, options.interpolationMode);
+    hash = mix(hash, options.generateOffsets);
+    hash = mix(hash, options.generateControlVerts);
+    hash = mix(hash, options.generateIntermediateLevels);
+    hash = mix(hash, options.factorizeIntermediateLevels);
+    hash = mix(hash, options.shareIntermediateLevels);
+    hash = mix(hash, options.projectToLimit);
+    hash = mix(hash, options.maxLevel);
+    return finalize(hash);
+}
+
+TopologyFingerprint::Hash
+TopologyFingerprint::Combine(Hash hash, PatchTableFactory::Options const & options) {
+
+    hash = mix(hash, TAG_PATCH_TABLE);
+    hash = mix(hash, options.generateAllLevels);
+    hash = mix(hash, options.triangulateQuads);
+    hash = mix(hash, options.useSingleCreasePatch);
+    hash = mix(hash, options.useInfSharpPatch);
+    hash = mix(hash, options.maxIsolationLevel);
+    hash = mix(hash, options.endCapType);
+    hash = mix(hash, options.shareEndCapPatchPoints);
+    hash = mix(hash, options.convertLegacyGregory);
+    hash = mix(hash, options.generateFVarTables);
+    hash = mix(hash, options.deferFVarChannels);
+    hash = mix(hash, options.generateFVarBicubicPatches);
+    hash = mix(hash, (Hash)options.numFVarChannels);
+    if (options.fvarChannelIndices) {
+        for (int i = 0; i < options.numFVarChannels; ++i) {
+            hash = mix(hash, (Hash)options.fvarChannelIndices[i]);
+        }
+    }
+    return finalize(hash);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
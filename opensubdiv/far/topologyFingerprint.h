@@ -0,0 +1,91 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TOPOLOGY_FINGERPRINT_H
+#define OPENSUBDIV3_FAR_TOPOLOGY_FINGERPRINT_H
+
+#include "../version.h"
+
+#include "../far/topologyDescriptor.h"
+#include "../far/topologyRefiner.h"
+#include "../far/stencilTableFactory.h"
+#include "../far/patchTableFactory.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TaskScheduler;
+
+///
+///  \brief Stable hash of a topology and of the options of its refinement
+///
+///  The fingerprint of a TopologyDescriptor covers all of its data (face-
+///  vertices, optional edges, creases, corners, holes, orientation and
+///  face-varying channels) and the scheme and Sdc::Options of its refiner.
+///  Hashes of the refinement and table options are combined with it to
+///  identify refined topologies and tables (see TopologyCache).
+///
+///  Hashes depend on values only : they are identical across sessions,
+///  hosts and schedulers, and can name files.  Options that do not change
+///  results (threads, schedulers, allocation) are not hashed.
+///
+class TopologyFingerprint {
+
+public:
+    typedef unsigned long long Hash;
+
+    /// \brief Returns the hash of a topology and its scheme
+    ///
+    /// @param desc           Topology to hash
+    ///
+    /// @param options        Scheme of the refiners of the topology
+    ///
+    /// @param scheduler      Optional scheduler hashing the arrays of the
+    ///                       descriptor concurrently (serial if NULL)
+    ///
+    static Hash Compute(TopologyDescriptor const & desc,
+                        TopologyRefinerFactory<TopologyDescriptor>::Options const & options,
+                        TaskScheduler const * scheduler = 0);
+
+    /// \brief Combines a hash with uniform refinement options
+    static Hash Combine(Hash hash, TopologyRefiner::UniformOptions const & options);
+
+    /// \brief Combines a hash with adaptive refinement options
+    static Hash Combine(Hash hash, TopologyRefiner::AdaptiveOptions const & options);
+
+    /// \brief Combines a hash with stencil table options
+    static Hash Combine(Hash hash, StencilTableFactory::Options const & options);
+
+    /// \brief Combines a hash with patch table options
+    static Hash Combine(Hash hash, PatchTableFactory::Options const & options);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TOPOLOGY_FINGERPRINT_H */
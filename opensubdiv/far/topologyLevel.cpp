@@ -0,0 +1,212 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#include "../far/topologyLevel.h"
+#include "../far/taskScheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+    struct FaceVertexCopy {
+        Vtr::internal::Level const * level;
+        int *                        dst;
+    };
+
+    void
+    copyFaceVertexCountsRange(int begin, int end, void * data) {
+
+        FaceVertexCopy const & copy = *static_cast<FaceVertexCopy *>(data);
+        for (int face=begin; face<end; ++face) {
+            copy.dst[face] = copy.level->getNumFaceVertices(face);
+        }
+    }
+
+    void
+    copyFaceVertexOffsetsRange(int begin, int end, void * data) {
+
+        FaceVertexCopy const & copy = *static_cast<FaceVertexCopy *>(data);
+        for (int face=begin; face<end; ++face) {
+            copy.dst[face] = copy.level->getOffsetOfFaceVertices(face);
+        }
+    }
+
+    void
+    copyFaceVertexRelation(Vtr::internal::Level const & level, int * dst,
+        TaskScheduler::RangeKernel kernel, TaskScheduler const * scheduler) {
+
+        FaceVertexCopy copy;
+        copy.level = &level;
+        copy.dst = dst;
+
+        int numFaces = level.getNumFaces();
+        if (scheduler) {
+            scheduler->ParallelFor(0, numFaces, 4096, kernel, &copy);
+        } else {
+            kernel(0, numFaces, &copy);
+        }
+    }
+
+    //
+    //  Ranges of components of balanced cost, applied concurrently by a
+    //  scheduler (a few ranges per worker absorb the imbalance of kernels
+    //  whose cost isn't proportional to that of the components):
+    //
+    struct BalancedRanges {
+        TaskScheduler::RangeKernel kernel;
+        void *                     data;
+        std::vector<int>           bounds;
+    };
+
+    void
+    applyBalancedRanges(int begin, int end, void * data) {
+
+        BalancedRanges const & ranges = *static_cast<BalancedRanges *>(data);
+        for (int range=begin; range<end; ++range) {
+            ranges.kernel(ranges.bounds[range], ranges.bounds[range+1], ranges.data);
+        }
+    }
+
+    //  Cumulative cost of the components preceding a face or vertex
+    struct FaceVertexCost {
+        Vtr::internal::Level const * level;
+
+        int operator()(int face) const {
+            return (face < level->getNumFaces()) ?
+                level->getOffsetOfFaceVertices(face) : level->getNumFaceVerticesTotal();
+        }
+    };
+
+    struct VertexEdgeCost {
+        std::vector<int> offsets;
+
+        int operator()(int vert) const { return offsets[vert]; }
+    };
+
+    int const minRangeCost = 4096;
+
+    template <class COST>
+    void
+    parallelForBalancedRanges(int numComponents, COST const & cost,
+        TaskScheduler::RangeKernel kernel, void * data,
+        TaskScheduler const & scheduler) {
+
+        int totalCost = cost(numComponents),
+            numRanges = std::min(4 * scheduler.GetNumThreads(),
+                                 totalCost / minRangeCost);
+
+        BalancedRanges ranges;
+        ranges.kernel = kernel;
+        ranges.data = data;
+        ranges.bounds.resize(numRanges + 1);
+
+        //  The first component of each range is the first of cumulative cost
+        //  not less than its share of the total:
+        ranges.bounds[0] = 0;
+        for (int range=1; range<numRanges; ++range) {
+            int target = (int)((double)totalCost * range / numRanges),
+                lo = ranges.bounds[range-1],
+                hi = numComponents;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (cost(mid) < target) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            ranges.bounds[range] = lo;
+        }
+        ranges.bounds[numRanges] = numComponents;
+
+        scheduler.ParallelFor(0, numRanges, 1, applyBalancedRanges, &ranges);
+    }
+}
+
+void
+TopologyLevel::GetFaceVertexCounts(int * counts,
+                                   TaskScheduler const * scheduler) const {
+
+    copyFaceVertexRelation(*_level, counts,
+        copyFaceVertexCountsRange, scheduler);
+}
+
+void
+TopologyLevel::GetFaceVertexOffsets(int * offsets,
+                                    TaskScheduler const * scheduler) const {
+
+    copyFaceVertexRelation(*_level, offsets,
+        copyFaceVertexOffsetsRange, scheduler);
+
+    offsets[GetNumFaces()] = GetNumFaceVertices();
+}
+
+void
+TopologyLevel::ParallelForFaces(TaskScheduler::RangeKernel kernel, void * data,
+                                TaskScheduler const * scheduler) const {
+
+    int numFaces = GetNumFaces();
+    if (not scheduler or (scheduler->GetNumThreads() < 2) or
+        (GetNumFaceVertices() < 2 * minRangeCost)) {
+        kernel(0, numFaces, data);
+        return;
+    }
+
+    FaceVertexCost cost;
+    cost.level = _level;
+
+    parallelForBalancedRanges(numFaces, cost, kernel, data, *scheduler);
+}
+
+void
+TopologyLevel::ParallelForVertices(TaskScheduler::RangeKernel kernel, void * data,
+                                   TaskScheduler const * scheduler) const {
+
+    int numVertices = GetNumVertices();
+    if (not scheduler or (scheduler->GetNumThreads() < 2) or
+        (_level->getNumVertexEdgesTotal() < 2 * minRangeCost)) {
+        kernel(0, numVertices, data);
+        return;
+    }
+
+    //  The vertex-edges are not necessarily packed in order of the vertices,
+    //  their cumulative counts are accumulated instead:
+    VertexEdgeCost cost;
+    cost.offsets.resize(numVertices + 1);
+    cost.offsets[0] = 0;
+    for (int vert=0; vert<numVertices; ++vert) {
+        cost.offsets[vert+1] = cost.offsets[vert] + _level->getNumVertexEdges(vert);
+    }
+
+    parallelForBalancedRanges(numVertices, cost, kernel, data, *scheduler);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -29,6 +29,7 @@
 #include "../vtr/level.h"
 #include "../vtr/refinement.h"
 #include "../far/types.h"
+#include "../far/taskScheduler.h"
 
 #include <vector>
 
@@ -118,6 +119,103 @@ public:
     Index FindEdge(Index v0, Index v1) const { return _level->findEdge(v0, v1); }
     //@}
 
+    //@{
+    /// @name Methods to access the relations of all components at once:
+    ///
+    /// The relations of all components of a type are stored contiguously and
+    /// ordered by component, so the topology of a level can be exported to
+    /// other representations (e.g. GPU buffers) one array at a time rather
+    /// than component by component.  The face-vertex counts and offsets are
+    /// implicit in refined levels (see GetRegularFaceSize()) and are copied
+    /// into client buffers instead.
+    ///
+
+    /// \brief Return the number of vertices of all faces when they are
+    /// identical (e.g. in refined levels of quad or tri schemes), or 0
+    int GetRegularFaceSize() const { return _level->getRegularFaceSize(); }
+
+    /// \brief Access the vertices of all faces (GetNumFaceVertices() indices,
+    /// see GetFaceVertexOffsets())
+    ConstIndexArray GetFaceVertices() const { return _level->getFaceVertices(); }
+
+    /// \brief Access the edges of all faces (matching GetFaceVertices())
+    ConstIndexArray GetFaceEdges() const    { return _level->getFaceEdges(); }
+
+    /// \brief Access the vertex pairs of all edges (2 * GetNumEdges() indices)
+    ConstIndexArray GetEdgeVertices() const { return _level->getEdgeVertices(); }
+
+    /// \brief Access the sharpness of all edges
+    ConstFloatArray GetEdgeSharpnesses() const   { return _level->getEdgeSharpnesses(); }
+
+    /// \brief Access the sharpness of all vertices
+    ConstFloatArray GetVertexSharpnesses() const { return _level->getVertexSharpnesses(); }
+
+    /// \brief Copy the number of vertices of all faces (GetNumFaces() values)
+    ///
+    /// @param counts     Destination buffer
+    ///
+    /// @param scheduler  Optional scheduler copying ranges of faces concurrently
+    ///
+    void GetFaceVertexCounts(int * counts, TaskScheduler const * scheduler = 0) const;
+
+    /// \brief Copy the offsets of the vertices of all faces in GetFaceVertices(),
+    /// followed by GetNumFaceVertices() (GetNumFaces() + 1 values)
+    ///
+    /// @param offsets    Destination buffer
+    ///
+    /// @param scheduler  Optional scheduler copying ranges of faces concurrently
+    ///
+    void GetFaceVertexOffsets(int * offsets, TaskScheduler const * scheduler = 0) const;
+    //@}
+
+    //@{
+    /// @name Methods to process all components concurrently:
+    ///
+    /// The components are partitioned into ranges of balanced cost rather than
+    /// of equal size -- faces by their number of vertices and vertices by their
+    /// number of incident edges -- so that per-component passes (normals, areas,
+    /// texture tile assignment...) are evenly distributed among the workers of
+    /// a scheduler.  Without a scheduler (or with a single worker), the kernel
+    /// is applied once to all components on the calling thread.
+    ///
+
+    /// \brief Applies a kernel to ranges of faces partitioning [0, GetNumFaces())
+    ///
+    /// @param kernel     Function applied to each range of faces
+    ///
+    /// @param data       Client data passed to each invocation of the kernel
+    ///
+    /// @param scheduler  Optional scheduler processing the ranges concurrently
+    ///
+    void ParallelForFaces(TaskScheduler::RangeKernel kernel, void * data,
+                          TaskScheduler const * scheduler = 0) const;
+
+    /// \brief Applies a kernel to ranges of vertices partitioning [0, GetNumVertices())
+    ///
+    /// @param kernel     Function applied to each range of vertices
+    ///
+    /// @param data       Client data passed to each invocation of the kernel
+    ///
+    /// @param scheduler  Optional scheduler processing the ranges concurrently
+    ///
+    void ParallelForVertices(TaskScheduler::RangeKernel kernel, void * data,
+                             TaskScheduler const * scheduler = 0) const;
+
+    /// \brief Gathers the values of the vertices of all faces, in the order of
+    /// GetFaceVertices() (GetNumFaceVertices() values, see GetFaceVertexOffsets())
+    ///
+    /// @param vertexValues      Values of the vertices of the level
+    ///
+    /// @param faceVertexValues  Destination buffer
+    ///
+    /// @param scheduler         Optional scheduler gathering ranges of faces
+    ///                          concurrently
+    ///
+    template <typename T>
+    void GatherFaceVertexValues(T const * vertexValues, T * faceVertexValues,
+                                TaskScheduler const * scheduler = 0) const;
+    //@}
+
     //@{
     /// @name Methods to inspect feature tags for individual components:
     ///
@@ -205,6 +303,15 @@ public:
 private:
     friend class TopologyRefiner;
 
+    template <typename T>
+    struct FaceVertexGather {
+        Vtr::internal::Level const * level;
+        T const *                    src;
+        T *                          dst;
+
+        static void Apply(int begin, int end, void * data);
+    };
+
     Vtr::internal::Level const *      _level;
     Vtr::internal::Refinement const * _refToParent;
     Vtr::internal::Refinement const * _refToChild;
@@ -215,6 +322,36 @@ public:
     ~TopologyLevel() { }
 };
 
+template <typename T>
+inline void
+TopologyLevel::FaceVertexGather<T>::Apply(int begin, int end, void * data) {
+
+    FaceVertexGather const & gather = *static_cast<FaceVertexGather *>(data);
+    if (begin == end) return;
+
+    ConstIndexArray faceVerts = gather.level->getFaceVertices();
+
+    int first = gather.level->getOffsetOfFaceVertices(begin),
+        last  = gather.level->getOffsetOfFaceVertices(end - 1) +
+                gather.level->getNumFaceVertices(end - 1);
+    for (int i = first; i < last; ++i) {
+        gather.dst[i] = gather.src[faceVerts[i]];
+    }
+}
+
+template <typename T>
+inline void
+TopologyLevel::GatherFaceVertexValues(T const * vertexValues, T * faceVertexValues,
+                                      TaskScheduler const * scheduler) const {
+
+    FaceVertexGather<T> gather;
+    gather.level = _level;
+    gather.src = vertexValues;
+    gather.dst = faceVertexValues;
+
+    ParallelForFaces(FaceVertexGather<T>::Apply, &gather, scheduler);
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
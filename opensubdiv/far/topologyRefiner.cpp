@@ -23,13 +23,20 @@
 //
 #include "../far/topologyRefiner.h"
 #include "../far/error.h"
+#include "../far/hierarchicalEdits.h"
+#include "../far/profile.h"
+#include "../far/taskScheduler.h"
+#include "../vtr/arena.h"
 #include "../vtr/fvarLevel.h"
+#include "../vtr/fvarRefinement.h"
 #include "../vtr/sparseSelector.h"
 #include "../vtr/quadRefinement.h"
 #include "../vtr/triRefinement.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <limits>
 
 
 namespace OpenSubdiv {
@@ -37,6 +44,92 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
+namespace {
+    //
+    //  Adaptor to delegate the concurrency of Vtr refinement to a TaskScheduler:
+    //
+    void
+    schedulerParallelFor(int begin, int end,
+                         Vtr::internal::Refinement::Options::RangeKernel kernel, void * kernelData,
+                         void const * scheduler) {
+
+        static_cast<TaskScheduler const *>(scheduler)->ParallelFor(begin, end, 1, kernel, kernelData);
+    }
+
+    void
+    assignConcurrencyOptions(Vtr::internal::Refinement::Options & refineOptions,
+                             int numThreads, TaskScheduler const * scheduler) {
+
+        if (scheduler) {
+            refineOptions._numThreads = scheduler->GetNumThreads();
+            if (refineOptions._numThreads > 1) {
+                refineOptions._parallelFor     = schedulerParallelFor;
+                refineOptions._parallelForData = scheduler;
+            }
+        } else {
+            refineOptions._numThreads = numThreads;
+        }
+    }
+
+    //
+    //  Adaptor to report the phases of Vtr refinement of a level to a client function:
+    //
+    //  Phases are also reported as profiling zones (see far/profile.h):
+    //
+    struct PhaseNotifier {
+        PhaseNotifier(TopologyRefiner::PhaseCallback callbackArg, void * dataArg) :
+            callback(callbackArg), data(dataArg), level(0), zone(-1),
+            profiled(GetProfileBackend() != FAR_PROFILE_NONE) { }
+
+        void Notify(TopologyRefiner::RefinementPhase phase) const {
+            if (profiled) {
+                static char const * zoneNames[TopologyRefiner::PHASE_END] = {
+                    "TopologyRefiner::Selection", "TopologyRefiner::Mapping",
+                    "TopologyRefiner::Tags",      "TopologyRefiner::Topology",
+                    "TopologyRefiner::Sharpness", "TopologyRefiner::FVar" };
+
+                if (zone >= 0) {
+                    EndProfileZone(zoneNames[zone]);
+                }
+                zone = (phase == TopologyRefiner::PHASE_END) ? -1 : phase;
+                if (zone >= 0) {
+                    BeginProfileZone(zoneNames[zone]);
+                }
+            }
+            if (callback) {
+                callback(level, phase, data);
+            }
+        }
+
+        bool IsActive() const { return callback || profiled; }
+
+        TopologyRefiner::PhaseCallback callback;
+        void * data;
+        int    level;
+
+        mutable int zone;
+        bool        profiled;
+    };
+
+    void
+    notifierPhaseCallback(Vtr::internal::Refinement::Phase phase, void * notifier) {
+
+        //  Vtr phases are listed in the same order, following the selection:
+        static_cast<PhaseNotifier const *>(notifier)->Notify(
+            (TopologyRefiner::RefinementPhase)(TopologyRefiner::PHASE_MAPPING + phase));
+    }
+
+    void
+    assignPhaseOptions(Vtr::internal::Refinement::Options & refineOptions,
+                       PhaseNotifier & notifier) {
+
+        if (notifier.IsActive()) {
+            refineOptions._phaseCallback     = notifierPhaseCallback;
+            refineOptions._phaseCallbackData = &notifier;
+        }
+    }
+}
+
 //
 //  Relatively trivial construction/destruction -- the base level (level[0]) needs
 //  to be explicitly initialized after construction and refinement then applied
@@ -45,7 +138,10 @@ TopologyRefiner::TopologyRefiner(Sdc::SchemeType schemeType, Sdc::Options scheme
     _subdivType(schemeType),
     _subdivOptions(schemeOptions),
     _isUniform(true),
+    _isSparse(false),
+    _isTrimmed(false),
     _hasHoles(false),
+    _hasSemiSharpFeatures(true),
     _maxLevel(0),
     _uniformOptions(0),
     _adaptiveOptions(0),
@@ -53,7 +149,12 @@ TopologyRefiner::TopologyRefiner(Sdc::SchemeType schemeType, Sdc::Options scheme
     _totalEdges(0),
     _totalFaces(0),
     _totalFaceVertices(0),
-    _maxValence(0) {
+    _maxValence(0),
+    _numSharedLevels(0),
+    _validationToken(0),
+    _arena(0),
+    _memoryResource(0),
+    _edits(0) {
 
     //  Need to revisit allocation scheme here -- want to use smart-ptrs for these
     //  but will probably have to settle for explicit new/delete...
@@ -63,35 +164,594 @@ TopologyRefiner::TopologyRefiner(Sdc::SchemeType schemeType, Sdc::Options scheme
     assembleFarLevels();
 }
 
+//
+//  Instances share the levels and refinements of their source, which owns them and
+//  must outlive them -- only the levels and refinements appended later are owned
+//  (the refinement between levels i and i+1 is shared with level i+1):
+//
+TopologyRefiner::TopologyRefiner(TopologyRefiner const & source) :
+    _subdivType(source._subdivType),
+    _subdivOptions(source._subdivOptions),
+    _isUniform(source._isUniform),
+    _isSparse(source._isSparse),
+    _isTrimmed(source._isTrimmed),
+    _hasHoles(source._hasHoles),
+    _hasSemiSharpFeatures(source._hasSemiSharpFeatures),
+    _maxLevel(source._maxLevel),
+    _uniformOptions(source._uniformOptions),
+    _adaptiveOptions(source._adaptiveOptions),
+    _sparseBaseFaces(source._sparseBaseFaces),
+    _baseFaceIsolationLevels(source._baseFaceIsolationLevels),
+    _totalVertices(source._totalVertices),
+    _totalEdges(source._totalEdges),
+    _totalFaces(source._totalFaces),
+    _totalFaceVertices(source._totalFaceVertices),
+    _maxValence(source._maxValence),
+    _numSharedLevels((int)source._levels.size()),
+    _validationToken(source._validationToken),
+    _levels(source._levels),
+    _refinements(source._refinements),
+    _arena(0),
+    _memoryResource(source._memoryResource),
+    _edits(source._edits ? new HierarchicalEdits(*source._edits) : 0) {
+
+    _levels.reserve(10);
+    _farLevels.reserve(10);
+    assembleFarLevels();
+}
+
 TopologyRefiner::~TopologyRefiner() {
 
-    for (int i=0; i<(int)_levels.size(); ++i) {
+    for (int i=_numSharedLevels; i<(int)_levels.size(); ++i) {
         delete _levels[i];
     }
 
-    for (int i=0; i<(int)_refinements.size(); ++i) {
+    for (int i=(_numSharedLevels ? _numSharedLevels-1 : 0); i<(int)_refinements.size(); ++i) {
         delete _refinements[i];
     }
+    delete _arena;
+    delete _edits;
 }
 
 void
 TopologyRefiner::Unrefine() {
 
     if (_levels.size()) {
-        for (int i=1; i<(int)_levels.size(); ++i) {
+        for (int i=std::max(_numSharedLevels, 1); i<(int)_levels.size(); ++i) {
             delete _levels[i];
         }
         _levels.resize(1);
         initializeInventory();
     }
-    for (int i=0; i<(int)_refinements.size(); ++i) {
+    for (int i=(_numSharedLevels ? _numSharedLevels-1 : 0); i<(int)_refinements.size(); ++i) {
         delete _refinements[i];
     }
     _refinements.clear();
+    _numSharedLevels = std::min(_numSharedLevels, 1);
+
+    delete _arena;
+    _arena = 0;
+
+    _isUniform = true;
+    _isSparse = false;
+    _isTrimmed = false;
+    _maxLevel = 0;
+
+    _sparseBaseFaces.clear();
+    _baseFaceIsolationLevels.clear();
 
     assembleFarLevels();
 }
 
+//
+//  Child levels are optionally allocated from an Arena shared by all refined levels --
+//  memory of any levels discarded is only released with the Arena on Unrefine().  The
+//  Arena is implied when its blocks are to be allocated from a MemoryResource:
+//
+Vtr::internal::Level &
+TopologyRefiner::createChildLevel(bool allocateFromArena) {
+
+    allocateFromArena = allocateFromArena || (_memoryResource != 0);
+    if (allocateFromArena && (_arena == 0)) {
+        _arena = new Vtr::internal::Arena(256 * 1024, _memoryResource);
+    }
+    return *(new Vtr::internal::Level(allocateFromArena ? _arena : 0));
+}
+
+void
+TopologyRefiner::copyBaseLevel(bool copyFVarChannels) {
+
+    assert(_refinements.empty());
+
+    Vtr::internal::Level * baseLevel = new Vtr::internal::Level(*_levels[0], copyFVarChannels);
+    if (_numSharedLevels == 0) {
+        delete _levels[0];
+    }
+    _levels[0] = baseLevel;
+    _numSharedLevels = 0;
+
+    assembleFarLevels();
+}
+
+//
+//  Copying the shared levels of an instance -- the base level is copied and refined again
+//  as the shared levels were:
+//
+void
+TopologyRefiner::copySharedLevels() {
+
+    bool wasRefined = !_refinements.empty(),
+         wasUniform = _isUniform,
+         wasSparse  = _isSparse;
+
+    std::vector<Index> sparseBaseFaces;
+    std::vector<unsigned char> isolationLevels;
+    sparseBaseFaces.swap(_sparseBaseFaces);
+    isolationLevels.swap(_baseFaceIsolationLevels);
+
+    Unrefine();
+    copyBaseLevel(true);
+
+    if (wasRefined) {
+        if (wasUniform) {
+            RefineUniform(_uniformOptions);
+        } else if (wasSparse && !isolationLevels.empty()) {
+            RefineSparse(_adaptiveOptions, &isolationLevels[0]);
+        } else if (wasSparse) {
+            RefineSparse(_adaptiveOptions, ConstIndexArray(
+                sparseBaseFaces.empty() ? 0 : &sparseBaseFaces[0], (int)sparseBaseFaces.size()));
+        } else {
+            RefineAdaptive(_adaptiveOptions, isolationLevels.empty() ? 0 : &isolationLevels[0]);
+        }
+    }
+}
+
+void
+TopologyRefiner::discardLevels(int firstLevel) {
+
+    assert(firstLevel >= _numSharedLevels);
+
+    for (int i = firstLevel; i < (int)_levels.size(); ++i) {
+        delete _levels[i];
+        delete _refinements[i-1];
+    }
+    _levels.resize(firstLevel);
+    _refinements.resize(firstLevel-1);
+
+    initializeInventory();
+    for (int i = 1; i < firstLevel; ++i) {
+        updateInventory(*_levels[i]);
+    }
+}
+
+
+//
+//  Releasing the data of the refinements that interpolation does not require:
+//
+void
+TopologyRefiner::Trim() {
+
+    //  Shared refinements remain as is -- they are owned by the source of the instance:
+    for (int i=(_numSharedLevels ? _numSharedLevels-1 : 0); i<(int)_refinements.size(); ++i) {
+        _refinements[i]->trim();
+    }
+    std::vector<Index>().swap(_sparseBaseFaces);
+    std::vector<unsigned char>().swap(_baseFaceIsolationLevels);
+
+    _isTrimmed = (_refinements.size() > 0);
+}
+
+//
+//  Updating the sharpness of an existing refinement:
+//
+bool
+TopologyRefiner::UpdateBaseSharpness(ConstIndexArray edges,    float const * edgeSharpness,
+                                     ConstIndexArray vertices, float const * vertexSharpness) {
+
+    Vtr::internal::Level & baseLevel = getLevel(0);
+
+    if (baseLevel.getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateBaseSharpness() -- base level is uninitialized.");
+        return false;
+    }
+    if (_isTrimmed) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateBaseSharpness() -- refinements were trimmed.");
+        return false;
+    }
+    if (baseLevel.getNumFVarChannels() > 0) {
+        //  The topology of face-varying channels is dependent on sharpness:
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateBaseSharpness() -- "
+            "face-varying channels are not supported.");
+        return false;
+    }
+    for (int i = 0; i < edges.size(); ++i) {
+        if ((edges[i] < 0) || (edges[i] >= baseLevel.getNumEdges())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::UpdateBaseSharpness() -- invalid edge %d.", edges[i]);
+            return false;
+        }
+    }
+    for (int i = 0; i < vertices.size(); ++i) {
+        if ((vertices[i] < 0) || (vertices[i] >= baseLevel.getNumVertices())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::UpdateBaseSharpness() -- invalid vertex %d.", vertices[i]);
+            return false;
+        }
+    }
+
+    //
+    //  The levels of an instance are copied on write before they are updated:
+    //
+    if (_numSharedLevels > 0) {
+        copySharedLevels();
+        return UpdateBaseSharpness(edges, edgeSharpness, vertices, vertexSharpness);
+    }
+
+    //
+    //  Assign the new sharpness values and associated tags -- boundary and non-manifold
+    //  features were made infinitely sharp on construction and are preserved as such
+    //  (see TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness()):
+    //
+    std::vector<Index> affectedVerts;
+    affectedVerts.reserve(2 * edges.size() + vertices.size());
+
+    for (int i = 0; i < edges.size(); ++i) {
+        Vtr::internal::Level::ETag& eTag       = baseLevel.getEdgeTag(edges[i]);
+        float&                      eSharpness = baseLevel.getEdgeSharpness(edges[i]);
+
+        if (eTag._boundary || eTag._nonManifold) continue;
+
+        eSharpness = edgeSharpness[i];
+
+        eTag._infSharp  = Sdc::Crease::IsInfinite(eSharpness);
+        eTag._semiSharp = Sdc::Crease::IsSharp(eSharpness) && !eTag._infSharp;
+        if (eTag._semiSharp) {
+            _hasSemiSharpFeatures = true;
+        }
+
+        ConstIndexArray eVerts = baseLevel.getEdgeVertices(edges[i]);
+        affectedVerts.push_back(eVerts[0]);
+        affectedVerts.push_back(eVerts[1]);
+    }
+    for (int i = 0; i < vertices.size(); ++i) {
+        Vtr::internal::Level::VTag const& vTag = baseLevel.getVertexTag(vertices[i]);
+
+        if (vTag._corner || vTag._nonManifold) continue;
+
+        baseLevel.getVertexSharpness(vertices[i]) = vertexSharpness[i];
+        if (Sdc::Crease::IsSemiSharp(vertexSharpness[i])) {
+            _hasSemiSharpFeatures = true;
+        }
+        affectedVerts.push_back(vertices[i]);
+    }
+
+    //
+    //  Update the tags of all vertices whose sharpness or incident edges changed:
+    //
+    updateSharpnessTags(baseLevel, affectedVerts);
+
+    //
+    //  Propagate the tags and subdivide the sharpness values through the existing levels
+    //  for as long as the refined topology remains valid.  In the adaptive case, the
+    //  features selected for isolation are compared first and, if they differ, all
+    //  subsequent levels are discarded and refined again:
+    //
+    int numRefinements = (int)_refinements.size();
+    for (int i = 0; i < numRefinements; ++i) {
+        if (!_isUniform && !_isSparse && !isAdaptiveSelectionUnchanged(i)) {
+            discardLevels(i + 1);
+            refineAdaptiveLevels(i + 1);
+            assembleFarLevels();
+            return true;
+        }
+        _refinements[i]->propagateComponentTags();
+        _refinements[i]->subdivideSharpnessValues();
+        applyHierarchicalEdits(i + 1);
+    }
+
+    //  The adaptive refinement may also need to isolate new features beyond its last level
+    //  (sparse refinement only depends on the face selection):
+    if (!_isUniform && !_isSparse && (numRefinements < (int)_adaptiveOptions.isolationLevel)) {
+        refineAdaptiveLevels(numRefinements + 1);
+        assembleFarLevels();
+    }
+    return true;
+}
+
+//
+//  Updating the tags of vertices whose sharpness or incident edges changed:
+//
+void
+TopologyRefiner::updateSharpnessTags(Vtr::internal::Level & level,
+                                     std::vector<Index> const & vertices) {
+
+    Sdc::Crease creasing(_subdivOptions);
+
+    for (int i = 0; i < (int)vertices.size(); ++i) {
+        Vtr::internal::Level::VTag& vTag       = level.getVertexTag(vertices[i]);
+        float                       vSharpness = level.getVertexSharpness(vertices[i]);
+
+        ConstIndexArray vEdges = level.getVertexEdges(vertices[i]);
+
+        int infSharpEdgeCount  = 0;
+        int semiSharpEdgeCount = 0;
+        for (int j = 0; j < vEdges.size(); ++j) {
+            Vtr::internal::Level::ETag const& eTag = level.getEdgeTag(vEdges[j]);
+
+            infSharpEdgeCount  += eTag._infSharp;
+            semiSharpEdgeCount += eTag._semiSharp;
+        }
+
+        vTag._infSharp       = Sdc::Crease::IsInfinite(vSharpness);
+        vTag._semiSharp      = Sdc::Crease::IsSemiSharp(vSharpness);
+        vTag._semiSharpEdges = (semiSharpEdgeCount > 0);
+
+        vTag._rule = (Vtr::internal::Level::VTag::VTagSize)creasing.DetermineVertexVertexRule(
+                vSharpness, infSharpEdgeCount + semiSharpEdgeCount);
+    }
+}
+
+//
+//  Assigning hierarchical edits -- those of the base level are applied immediately:
+//
+bool
+TopologyRefiner::SetHierarchicalEdits(HierarchicalEdits const & edits) {
+
+    Vtr::internal::Level & baseLevel = getLevel(0);
+
+    if (baseLevel.getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetHierarchicalEdits() -- base level is uninitialized.");
+        return false;
+    }
+    if (_refinements.size()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetHierarchicalEdits() -- previous refinements already applied.");
+        return false;
+    }
+    if (edits.HasSharpnessEdits() && (baseLevel.getNumFVarChannels() > 0)) {
+        //  The topology of face-varying channels is dependent on sharpness:
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetHierarchicalEdits() -- "
+            "sharpness edits are not supported with face-varying channels.");
+        return false;
+    }
+
+    //  The base level of an instance is copied on write before it is edited:
+    if (_numSharedLevels > 0) {
+        copyBaseLevel(true);
+    }
+
+    delete _edits;
+    _edits = new HierarchicalEdits(edits);
+
+    applyHierarchicalEdits(0);
+    return true;
+}
+
+Index
+TopologyRefiner::findEditFace(int edit) const {
+
+    Index face = _edits->GetEditBaseFace(edit);
+    if (face >= _levels[0]->getNumFaces()) {
+        return INDEX_INVALID;
+    }
+
+    ConstLocalIndexArray subfaces = _edits->GetEditSubfaces(edit);
+    if (subfaces.size() >= (int)_levels.size()) {
+        return INDEX_INVALID;
+    }
+    for (int i = 0; i < subfaces.size(); ++i) {
+        ConstIndexArray childFaces = getRefinement(i).getFaceChildFaces(face);
+        if (subfaces[i] >= childFaces.size()) {
+            return INDEX_INVALID;
+        }
+        face = childFaces[subfaces[i]];
+        if (!Vtr::IndexIsValid(face)) {
+            return INDEX_INVALID;
+        }
+    }
+    return face;
+}
+
+//
+//  Applying the sharpness and hole edits of a level once it is refined (vertex edits are
+//  applied to primvar data) -- the sharpness of boundary and non-manifold features is
+//  preserved as in UpdateBaseSharpness():
+//
+void
+TopologyRefiner::applyHierarchicalEdits(int level) {
+
+    if (!_edits) return;
+
+    Vtr::internal::Level & vtrLevel = getLevel(level);
+
+    std::vector<Index> affectedVerts;
+
+    for (int i = 0; i < _edits->GetNumEdits(); ++i) {
+        HierarchicalEdits::Type type = _edits->GetEditType(i);
+
+        if ((_edits->GetEditLevel(i) != level) || (type == HierarchicalEdits::VERTEX)) continue;
+
+        Index face = findEditFace(i);
+        if (!Vtr::IndexIsValid(face)) continue;
+
+        if (type == HierarchicalEdits::HOLE) {
+            vtrLevel.getFaceTag(face)._hole = true;
+            _hasHoles = true;
+            continue;
+        }
+
+        bool edgeEdit = (type == HierarchicalEdits::EDGE_SHARPNESS);
+
+        ConstIndexArray fComps = edgeEdit ? vtrLevel.getFaceEdges(face) : vtrLevel.getFaceVertices(face);
+
+        LocalIndex component = _edits->GetEditComponent(i);
+        if (component >= fComps.size()) continue;
+
+        float * sharpness = 0;
+        if (edgeEdit) {
+            Vtr::internal::Level::ETag const& eTag = vtrLevel.getEdgeTag(fComps[component]);
+            if (eTag._boundary || eTag._nonManifold) continue;
+
+            sharpness = &vtrLevel.getEdgeSharpness(fComps[component]);
+        } else {
+            Vtr::internal::Level::VTag const& vTag = vtrLevel.getVertexTag(fComps[component]);
+            if (vTag._corner || vTag._nonManifold) continue;
+
+            sharpness = &vtrLevel.getVertexSharpness(fComps[component]);
+        }
+
+        float value = _edits->GetEditSharpness(i);
+        switch (_edits->GetEditOperation(i)) {
+            case HierarchicalEdits::ADD:      *sharpness += value; break;
+            case HierarchicalEdits::SUBTRACT: *sharpness -= value; break;
+            default:                          *sharpness  = value; break;
+        }
+        *sharpness = std::max(*sharpness, Sdc::Crease::SHARPNESS_SMOOTH);
+        if (Sdc::Crease::IsSemiSharp(*sharpness)) {
+            _hasSemiSharpFeatures = true;
+        }
+
+        if (edgeEdit) {
+            Vtr::internal::Level::ETag& eTag = vtrLevel.getEdgeTag(fComps[component]);
+
+            eTag._infSharp  = Sdc::Crease::IsInfinite(*sharpness);
+            eTag._semiSharp = Sdc::Crease::IsSharp(*sharpness) && !eTag._infSharp;
+
+            ConstIndexArray eVerts = vtrLevel.getEdgeVertices(fComps[component]);
+            affectedVerts.push_back(eVerts[0]);
+            affectedVerts.push_back(eVerts[1]);
+        } else {
+            affectedVerts.push_back(fComps[component]);
+        }
+    }
+
+    updateSharpnessTags(vtrLevel, affectedVerts);
+}
+
+//
+//  Updating (or adding) a face-varying channel of an existing refinement:
+//
+bool
+TopologyRefiner::UpdateFVarChannel(int channel, int numValues, ConstIndexArray faceValues,
+                                   Sdc::Options::FVarLinearInterpolation interpolation) {
+
+    Vtr::internal::Level & baseLevel = getLevel(0);
+
+    if (baseLevel.getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateFVarChannel() -- base level is uninitialized.");
+        return false;
+    }
+    if (_isTrimmed) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateFVarChannel() -- refinements were trimmed.");
+        return false;
+    }
+    if ((channel < 0) || (channel > baseLevel.getNumFVarChannels())) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateFVarChannel() -- invalid channel %d.", channel);
+        return false;
+    }
+    if (faceValues.size() != baseLevel.getNumFaceVerticesTotal()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateFVarChannel() -- "
+            "%d values expected for the face-vertices.", baseLevel.getNumFaceVerticesTotal());
+        return false;
+    }
+    for (int i = 0; i < faceValues.size(); ++i) {
+        if ((faceValues[i] < 0) || (faceValues[i] >= numValues)) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::UpdateFVarChannel() -- invalid value %d.", faceValues[i]);
+            return false;
+        }
+    }
+
+    //  Face-varying refinement requires the vertex-faces of all refined levels, which only
+    //  the last level of a uniform refinement lacks when refined without face-varying channels:
+    Vtr::internal::Level const & lastLevel = getLevel((int)_levels.size() - 1);
+    if (_refinements.size() && lastLevel.getNumVertices() && (lastLevel.getNumVertexFacesTotal() == 0)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::UpdateFVarChannel() -- "
+            "the last level lacks the full topology (see UniformOptions::fullTopologyInLastLevel).");
+        return false;
+    }
+
+    //  The levels of an instance are copied on write before they are updated:
+    if (_numSharedLevels > 0) {
+        copySharedLevels();
+        return UpdateFVarChannel(channel, numValues, faceValues, interpolation);
+    }
+
+    //
+    //  Create the new channel in the base level, move it in place of the channel it replaces
+    //  (if any) and subdivide it through the existing refinements -- the vertex topology and
+    //  all other channels are left intact:
+    //
+    Sdc::Options fvarOptions = _subdivOptions;
+    fvarOptions.SetFVarLinearInterpolation(interpolation);
+
+    int newChannel = baseLevel.createFVarChannel(numValues, fvarOptions);
+
+    for (int face = 0, value = 0; face < baseLevel.getNumFaces(); ++face) {
+        IndexArray dstValues = baseLevel.getFaceFVarValues(face, newChannel);
+        for (int i = 0; i < dstValues.size(); ++i) {
+            dstValues[i] = faceValues[value++];
+        }
+    }
+
+    int regBoundaryValence = Sdc::SchemeTypeTraits::GetRegularVertexValence(_subdivType) / 2;
+    baseLevel.completeFVarChannelTopology(newChannel, regBoundaryValence);
+
+    if (channel < newChannel) {
+        baseLevel.swapFVarChannels(channel, newChannel);
+        baseLevel.destroyFVarChannel(newChannel);
+    }
+
+    for (int i = 0; i < (int)_refinements.size(); ++i) {
+        _refinements[i]->subdivideFVarChannel(channel);
+    }
+    return true;
+}
+
+bool
+TopologyRefiner::isAdaptiveSelectionUnchanged(int level) {
+
+    //
+    //  Apply the feature-adaptive selection to a temporary refinement of the level and
+    //  compare with the selection of the existing refinement:
+    //
+    Vtr::internal::Level const & parentLevel = getLevel(level);
+    Vtr::internal::Level         childLevel;
+
+    Vtr::internal::QuadRefinement refinement(parentLevel, childLevel, _subdivOptions);
+
+    Vtr::internal::SparseSelector selector(refinement);
+    selectFeatureAdaptiveComponents(selector);
+    if (selector.isSelectionEmpty()) {
+        return false;
+    }
+
+    Vtr::internal::Refinement const & current = getRefinement(level);
+    for (Index face = 0; face < parentLevel.getNumFaces(); ++face) {
+        if (refinement.getParentFaceSparseTag(face)._selected !=
+               current.getParentFaceSparseTag(face)._selected) return false;
+    }
+    for (Index edge = 0; edge < parentLevel.getNumEdges(); ++edge) {
+        if (refinement.getParentEdgeSparseTag(edge)._selected !=
+               current.getParentEdgeSparseTag(edge)._selected) return false;
+    }
+    for (Index vert = 0; vert < parentLevel.getNumVertices(); ++vert) {
+        if (refinement.getParentVertexSparseTag(vert)._selected !=
+               current.getParentVertexSparseTag(vert)._selected) return false;
+    }
+    return true;
+}
+
 
 //
 //  Intializing and updating the component inventory:
@@ -100,8 +760,6 @@ void
 TopologyRefiner::initializeInventory() {
 
     if (_levels.size()) {
-        assert(_levels.size() == 1);
-
         Vtr::internal::Level const & baseLevel = *_levels[0];
 
         _totalVertices     = baseLevel.getNumVertices();
@@ -183,6 +841,150 @@ TopologyRefiner::GetNumFVarValuesTotal(int channel) const {
     return sum;
 }
 
+TopologyRefiner::LevelMemoryUsage
+TopologyRefiner::GetLevelMemoryUsage(int level) const {
+
+    LevelMemoryUsage usage;
+
+    Vtr::internal::Level const & vtrLevel = getLevel(level);
+
+    vtrLevel.getMemoryUsage(usage.topology);
+    for (int channel = 0; channel < vtrLevel.getNumFVarChannels(); ++channel) {
+        vtrLevel.getFVarLevel(channel).getMemoryUsage(usage.fvar);
+    }
+
+    if (level < (int)_refinements.size()) {
+        Vtr::internal::Refinement const & refinement = getRefinement(level);
+
+        refinement.getMemoryUsage(usage.refinement);
+        for (int channel = 0; channel < refinement.getNumFVarChannels(); ++channel) {
+            refinement.getFVarRefinement(channel).getMemoryUsage(usage.fvar);
+        }
+    }
+    return usage;
+}
+
+MemoryUsage
+TopologyRefiner::GetMemoryUsage() const {
+
+    MemoryUsage usage;
+    for (int i = 0; i < (int)_levels.size(); ++i) {
+        //  Shared levels and refinements are accounted for by their owner:
+        if (i >= _numSharedLevels) {
+            Vtr::internal::Level const & vtrLevel = getLevel(i);
+
+            vtrLevel.getMemoryUsage(usage);
+            for (int channel = 0; channel < vtrLevel.getNumFVarChannels(); ++channel) {
+                vtrLevel.getFVarLevel(channel).getMemoryUsage(usage);
+            }
+        }
+        if ((i < (int)_refinements.size()) && (i + 1 >= _numSharedLevels)) {
+            Vtr::internal::Refinement const & refinement = getRefinement(i);
+
+            refinement.getMemoryUsage(usage);
+            for (int channel = 0; channel < refinement.getNumFVarChannels(); ++channel) {
+                refinement.getFVarRefinement(channel).getMemoryUsage(usage);
+            }
+        }
+    }
+    usage.Add(_levels);
+    usage.Add(_refinements);
+    usage.Add(_farLevels);
+    usage.Add(_sparseBaseFaces);
+    usage.Add(_baseFaceIsolationLevels);
+    return usage;
+}
+
+TopologyRefiner::LevelStatistics
+TopologyRefiner::GetLevelStatistics(int level) const {
+
+    Vtr::internal::Level const & vtrLevel = getLevel(level);
+
+    LevelStatistics stats;
+    stats.numVertices     = vtrLevel.getNumVertices();
+    stats.numEdges        = vtrLevel.getNumEdges();
+    stats.numFaces        = vtrLevel.getNumFaces();
+    stats.numFaceVertices = vtrLevel.getNumFaceVerticesTotal();
+    stats.numHoles        = 0;
+    stats.numRefinedFaces = 0;
+    stats.maxValence      = vtrLevel.getMaxValence();
+
+    if (_hasHoles) {
+        for (Index face = 0; face < stats.numFaces; ++face) {
+            stats.numHoles += vtrLevel.isFaceHole(face);
+        }
+    }
+
+    //  Faces not selected for sparse refinement have no child faces:
+    if (level < (int)_refinements.size()) {
+        Vtr::internal::Refinement const & refinement = getRefinement(level);
+        if (_isSparse) {
+            for (Index face = 0; face < stats.numFaces; ++face) {
+                ConstIndexArray childFaces = refinement.getFaceChildFaces(face);
+                stats.numRefinedFaces += (childFaces.size() > 0) &&
+                                         Vtr::IndexIsValid(childFaces[0]);
+            }
+        } else {
+            stats.numRefinedFaces = stats.numFaces;
+        }
+    }
+    return stats;
+}
+
+
+namespace {
+    //
+    //  The sizes of uniformly refined levels follow from the sizes of the base
+    //  level -- they are computed with 64-bit integers to identify the first
+    //  level whose relations (or totals over all levels) would exceed the
+    //  range of Index, before any of them is allocated (0 if none).  The edges
+    //  of the last level are only counted when its full topology is required:
+    //
+    int
+    findUniformIndexOverflow(Vtr::internal::Level const & base, Sdc::Split split,
+                             int maxLevel, bool lastLevelEdges) {
+
+        typedef long long Count;
+
+        Count const maxCount = std::numeric_limits<Index>::max();
+
+        Count faces     = base.getNumFaces(),
+              edges     = base.getNumEdges(),
+              verts     = base.getNumVertices(),
+              faceVerts = base.getNumFaceVerticesTotal();
+
+        Count totalFaces = faces, totalEdges = edges, totalVerts = verts,
+              totalFaceVerts = faceVerts;
+
+        for (int level = 1; level <= maxLevel; ++level) {
+            if (split == Sdc::SPLIT_TO_QUADS) {
+                verts = verts + edges + faces;
+                edges = 2 * edges + faceVerts;
+                faces = faceVerts;
+                faceVerts = 4 * faces;
+            } else {
+                verts = verts + edges;
+                edges = 2 * edges + 3 * faces;
+                faces = 4 * faces;
+                faceVerts = 3 * faces;
+            }
+            Count levelEdges = ((level < maxLevel) || lastLevelEdges) ? edges : 0;
+
+            totalFaces     += faces;
+            totalEdges     += levelEdges;
+            totalVerts     += verts;
+            totalFaceVerts += faceVerts;
+
+            //  Edge-vertices and vertex-edges hold 2 indices per edge:
+            if ((faceVerts > maxCount) || (2 * levelEdges > maxCount) ||
+                (totalFaces > maxCount) || (totalEdges > maxCount) ||
+                (totalVerts > maxCount) || (totalFaceVerts > maxCount)) {
+                return level;
+            }
+        }
+        return 0;
+    }
+}
 
 //
 //  Main refinement method -- allocating and initializing levels and refinements:
@@ -190,6 +992,8 @@ TopologyRefiner::GetNumFVarValuesTotal(int channel) const {
 void
 TopologyRefiner::RefineUniform(UniformOptions options) {
 
+    OPENSUBDIV_PROFILE_ZONE("TopologyRefiner::RefineUniform");
+
     if (_levels[0]->getNumVertices() == 0) {
         Error(FAR_RUNTIME_ERROR,
             "Failure in TopologyRefiner::RefineUniform() -- base level is uninitialized.");
@@ -201,6 +1005,20 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
         return;
     }
 
+    Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
+
+    //  Sharpness edits of the last level require its full topology:
+    bool hasSharpnessEdits = _edits && _edits->HasSharpnessEdits();
+
+    int overflowLevel = findUniformIndexOverflow(*_levels[0], splitType,
+        options.refinementLevel, options.fullTopologyInLastLevel || hasSharpnessEdits);
+    if (overflowLevel) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::RefineUniform() -- level %d exceeds the "
+            "range of 32-bit indices (see StreamingRefiner).", overflowLevel);
+        return;
+    }
+
     //
     //  Allocate the stack of levels and the refinements between them:
     //
@@ -209,21 +1027,33 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
     _isUniform = true;
     _maxLevel = options.refinementLevel;
 
-    Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
-
     //
     //  Initialize refinement options for Vtr -- adjusting full-topology for the last level:
     //
+    //  Holes are skipped by a sparse refinement of the faces of each level that are not
+    //  holes, which refines the neighborhood supporting them (children of holes being
+    //  holes, the faces selected are all complete):
+    bool skipHoles = options.skipHoles && _hasHoles;
+
     Vtr::internal::Refinement::Options refineOptions;
-    refineOptions._sparse         = false;
+    refineOptions._sparse         = skipHoles;
     refineOptions._faceVertsFirst = options.orderVerticesFromFacesFirst;
 
+    assignConcurrencyOptions(refineOptions, options.numThreads, options.taskScheduler);
+
+    PhaseNotifier notifier(options.phaseCallback, options.phaseCallbackData);
+    assignPhaseOptions(refineOptions, notifier);
+
     for (int i = 1; i <= (int)options.refinementLevel; ++i) {
+        notifier.level = i;
+
         refineOptions._minimalTopology =
-            options.fullTopologyInLastLevel ? false : (i == (int)options.refinementLevel);
+            (options.fullTopologyInLastLevel || hasSharpnessEdits) ? false :
+                (i == (int)options.refinementLevel);
+        refineOptions._semiSharpFeatures = _hasSemiSharpFeatures;
 
         Vtr::internal::Level& parentLevel = getLevel(i-1);
-        Vtr::internal::Level& childLevel  = *(new Vtr::internal::Level);
+        Vtr::internal::Level& childLevel  = createChildLevel(options.allocateFromArena);
 
         Vtr::internal::Refinement* refinement = 0;
         if (splitType == Sdc::SPLIT_TO_QUADS) {
@@ -231,10 +1061,30 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
         } else {
             refinement = new Vtr::internal::TriRefinement(parentLevel, childLevel, _subdivOptions);
         }
+        if (skipHoles) {
+            Vtr::internal::SparseSelector selector(*refinement);
+
+            notifier.Notify(PHASE_SELECTION);
+            for (Index face = 0; face < parentLevel.getNumFaces(); ++face) {
+                if (!parentLevel.isFaceHole(face)) {
+                    selector.selectFace(face);
+                }
+            }
+            if (selector.isSelectionEmpty()) {
+                notifier.Notify(PHASE_END);
+                _maxLevel = i - 1;
+
+                delete refinement;
+                delete &childLevel;
+                break;
+            }
+        }
         refinement->refine(refineOptions);
+        notifier.Notify(PHASE_END);
 
         appendLevel(childLevel);
         appendRefinement(*refinement);
+        applyHierarchicalEdits(i);
     }
     assembleFarLevels();
 }
@@ -243,6 +1093,8 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
 void
 TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
 
+    OPENSUBDIV_PROFILE_ZONE("TopologyRefiner::RefineAdaptive");
+
     if (_levels[0]->getNumVertices() == 0) {
         Error(FAR_RUNTIME_ERROR,
             "Failure in TopologyRefiner::RefineAdaptive() -- base level is uninitialized.");
@@ -253,9 +1105,9 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             "Failure in TopologyRefiner::RefineAdaptive() -- previous refinements already applied.");
         return;
     }
-    if (_subdivType != Sdc::SCHEME_CATMARK) {
+    if (_subdivType == Sdc::SCHEME_BILINEAR) {
         Error(FAR_RUNTIME_ERROR,
-            "Failure in TopologyRefiner::RefineAdaptive() -- currently only supported for Catmark scheme.");
+            "Failure in TopologyRefiner::RefineAdaptive() -- not supported for Bilinear scheme.");
         return;
     }
 
@@ -265,6 +1117,88 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     _adaptiveOptions = options;
 
     _isUniform = false;
+
+    refineAdaptiveLevels(1);
+    assembleFarLevels();
+}
+
+void
+TopologyRefiner::RefineAdaptive(AdaptiveOptions options,
+                                unsigned char const * baseFaceIsolationLevels) {
+
+    if (baseFaceIsolationLevels && _refinements.empty()) {
+        _baseFaceIsolationLevels.assign(baseFaceIsolationLevels,
+                                        baseFaceIsolationLevels + _levels[0]->getNumFaces());
+    }
+    RefineAdaptive(options);
+
+    //  Discard the isolation levels if the refinement failed:
+    if (_isUniform) {
+        _baseFaceIsolationLevels.clear();
+    }
+}
+
+void
+TopologyRefiner::RefineSparse(AdaptiveOptions options, ConstIndexArray baseFaces) {
+
+    OPENSUBDIV_PROFILE_ZONE("TopologyRefiner::RefineSparse");
+
+    if (_levels[0]->getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::RefineSparse() -- base level is uninitialized.");
+        return;
+    }
+    if (_refinements.size()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::RefineSparse() -- previous refinements already applied.");
+        return;
+    }
+    if (_subdivType == Sdc::SCHEME_BILINEAR) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::RefineSparse() -- not supported for Bilinear scheme.");
+        return;
+    }
+
+    _adaptiveOptions = options;
+
+    _isUniform = false;
+    _isSparse = true;
+
+    _sparseBaseFaces.assign(baseFaces.begin(), baseFaces.begin() + baseFaces.size());
+
+    refineAdaptiveLevels(1);
+    assembleFarLevels();
+}
+
+void
+TopologyRefiner::RefineSparse(AdaptiveOptions options, unsigned char const * baseFaceLevels) {
+
+    //  The base faces of level 1 or more are selected, the levels of their descendants
+    //  being inspected in turn (see selectSparseComponents()):
+    std::vector<Index> baseFaces;
+    if (baseFaceLevels && _refinements.empty()) {
+        int numBaseFaces = _levels[0]->getNumFaces();
+        for (Index face = 0; face < numBaseFaces; ++face) {
+            if (baseFaceLevels[face] > 0) {
+                baseFaces.push_back(face);
+            }
+        }
+        _baseFaceIsolationLevels.assign(baseFaceLevels, baseFaceLevels + numBaseFaces);
+    }
+    RefineSparse(options, ConstIndexArray(baseFaces.empty() ? 0 : &baseFaces[0],
+                                          (int)baseFaces.size()));
+
+    //  Discard the levels if the refinement failed:
+    if (!_isSparse) {
+        _baseFaceIsolationLevels.clear();
+    }
+}
+
+void
+TopologyRefiner::refineAdaptiveLevels(int firstLevel) {
+
+    AdaptiveOptions const & options = _adaptiveOptions;
+
     _maxLevel = options.isolationLevel;
 
     //
@@ -277,12 +1211,18 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     refineOptions._minimalTopology = false;
     refineOptions._faceVertsFirst  = options.orderVerticesFromFacesFirst;
 
+    assignConcurrencyOptions(refineOptions, options.numThreads, options.taskScheduler);
+
+    PhaseNotifier notifier(options.phaseCallback, options.phaseCallbackData);
+    assignPhaseOptions(refineOptions, notifier);
+
     Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
 
-    for (int i = 1; i <= (int)options.isolationLevel; ++i) {
+    for (int i = firstLevel; i <= (int)options.isolationLevel; ++i) {
+        notifier.level = i;
 
         Vtr::internal::Level& parentLevel     = getLevel(i-1);
-        Vtr::internal::Level& childLevel      = *(new Vtr::internal::Level);
+        Vtr::internal::Level& childLevel      = createChildLevel(options.allocateFromArena);
 
         Vtr::internal::Refinement* refinement = 0;
         if (splitType == Sdc::SPLIT_TO_QUADS) {
@@ -299,8 +1239,14 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
         //
         Vtr::internal::SparseSelector selector(*refinement);
 
-        selectFeatureAdaptiveComponents(selector);
+        notifier.Notify(PHASE_SELECTION);
+        if (_isSparse) {
+            selectSparseComponents(selector);
+        } else {
+            selectFeatureAdaptiveComponents(selector);
+        }
         if (selector.isSelectionEmpty()) {
+            notifier.Notify(PHASE_END);
             _maxLevel = i - 1;
 
             delete refinement;
@@ -308,12 +1254,62 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             break;
         }
 
+        refineOptions._semiSharpFeatures = _hasSemiSharpFeatures;
         refinement->refine(refineOptions);
+        notifier.Notify(PHASE_END);
 
         appendLevel(childLevel);
         appendRefinement(*refinement);
+        applyHierarchicalEdits(i);
+    }
+}
+
+//
+//   Method for selecting components for the sparse refinement of a selection of base faces:
+//   the faces selected are refined in the first level, after which all "complete" faces are
+//   refined in turn -- the incomplete ones only exist to support the limit of their complete
+//   neighbors, so the descendants of the base faces are exactly the complete faces.
+//
+void
+TopologyRefiner::selectSparseComponents(Vtr::internal::SparseSelector& selector) {
+
+    Vtr::internal::Level const& level = selector.getRefinement().parent();
+
+    if (level.getDepth() == 0) {
+        for (int i = 0; i < (int)_sparseBaseFaces.size(); ++i) {
+            Index face = _sparseBaseFaces[i];
+            if ((face >= 0) && (face < level.getNumFaces()) && !level.isFaceHole(face)) {
+                selector.selectFace(face);
+            }
+        }
+        return;
+    }
+
+    //  Only the descendants of the selected faces are refined further -- the children of
+    //  the neighboring faces supporting them may be complete:
+    Vtr::internal::Refinement const & parentRefinement = *_refinements[level.getDepth() - 1];
+
+    for (Vtr::Index face = 0; face < level.getNumFaces(); ++face) {
+
+        if (level.isFaceHole(face) || parentRefinement.getChildFaceTag(face)._incomplete) {
+            continue;
+        }
+        //  Descendants of base faces with their own levels stop at the level of the face:
+        if (!_baseFaceIsolationLevels.empty()) {
+            Index baseFace = face;
+            for (int i = level.getDepth(); i > 0; --i) {
+                baseFace = _refinements[i-1]->getChildFaceParentFace(baseFace);
+            }
+            if (level.getDepth() >= (int)_baseFaceIsolationLevels[baseFace]) {
+                continue;
+            }
+        }
+
+        Vtr::ConstIndexArray faceVerts = level.getFaceVertices(face);
+        if (!level.getFaceCompositeVTag(faceVerts)._incomplete) {
+            selector.selectFace(face);
+        }
     }
-    assembleFarLevels();
 }
 
 //
@@ -340,6 +1336,11 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
 
     int  regularFaceSize           =  selector.getRefinement().getRegularFaceSize();
     bool considerSingleCreasePatch = _adaptiveOptions.useSingleCreasePatch && (regularFaceSize == 4);
+    bool considerInfSharpPatch     = _adaptiveOptions.useInfSharpPatch && (regularFaceSize == 4);
+
+    //  Smooth extraordinary vertices are only isolated up to the secondary level (base
+    //  faces are always isolated as the patches require at least one level):
+    bool isolateXOrdinary = (level.getDepth() < std::max((int)_adaptiveOptions.secondaryLevel, 1));
 
     //
     //  Face-varying consideration when isolating features:
@@ -399,6 +1400,20 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
             continue;
         }
 
+        //
+        //  Stop the isolation of the descendants of base faces with a lower maximum level
+        //  (base faces are always isolated as the patches require at least one level):
+        //
+        if (!_baseFaceIsolationLevels.empty() && (level.getDepth() > 0)) {
+            Index baseFace = face;
+            for (int i = level.getDepth(); i > 0; --i) {
+                baseFace = _refinements[i-1]->getChildFaceParentFace(baseFace);
+            }
+            if (level.getDepth() >= (int)_baseFaceIsolationLevels[baseFace]) {
+                continue;
+            }
+        }
+
         //
         //  Combine the tags for all vertices of the face and quickly accept/reject based on
         //  the presence/absence of properties where we can (further inspection is likely to
@@ -412,7 +1427,10 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
 
         bool selectFace = false;
         if (compFaceVTag._xordinary) {
-            selectFace = true;
+            //  Beyond the secondary level, end caps approximate extraordinary vertices unless
+            //  semi-sharp or non-manifold features around them require further isolation:
+            selectFace = isolateXOrdinary or compFaceVTag._nonManifold or
+                         compFaceVTag._semiSharp or compFaceVTag._semiSharpEdges;
         } else if (compFaceVTag._nonManifold) {
             //  Warrants further inspection in future -- isolate for now
             //    - will want to defer inf-sharp treatment to below
@@ -454,6 +1472,11 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
             } else {
                 selectFace = true;
             }
+        } else if (regularFaceSize == 3) {
+            //  Boundary triangles of Loop are regular patches only when they have a single
+            //  boundary edge, or a single boundary vertex and no boundary edge -- any Corner
+            //  vertex warrants isolation:
+            selectFace = not level.isTriRegularPatch(face);
         } else if (not (compFaceVTag._rule & Sdc::Crease::RULE_CORNER)) {
             //  We are now left with boundary faces -- if no Corner vertex, we have a mix of both
             //  regular Smooth and Crease vertices on a boundary face, which can only be a regular
@@ -481,6 +1504,16 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
             }
         }
 
+        //
+        //  When infinitely sharp edges are treated as patch boundaries, faces whose only
+        //  irregularities are inf-sharp creases, corners and boundaries are regular patches
+        //  (the composite tag excludes semi-sharp and non-manifold features cheaply first):
+        //
+        if (selectFace and considerInfSharpPatch and
+            not (compFaceVTag._semiSharp or compFaceVTag._semiSharpEdges or compFaceVTag._nonManifold)) {
+            selectFace = not level.isInfSharpRegularPatch(face);
+        }
+
         //
         //  If still not selected, inspect the face-varying channels (when present) for similar
         //  irregular features requiring isolation:
@@ -37,11 +37,14 @@
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
-namespace Vtr { namespace internal { class SparseSelector; } }
+namespace Vtr { namespace internal { class SparseSelector; class Arena; } }
 
 namespace Far {
 
 template <class MESH> class TopologyRefinerFactory;
+class TaskScheduler;
+class MemoryResource;
+class HierarchicalEdits;
 
 ///
 ///  \brief Stores topology data for a specified set of refinement options.
@@ -77,6 +80,22 @@ public:
     /// \ brief Returns true if faces have been tagged as holes
     bool HasHoles() const { return _hasHoles; }
 
+    /// \brief Returns the token of the base topology if it was validated on
+    ///        construction, 0 otherwise (see TopologyRefinerFactory::Options)
+    unsigned long long GetValidationToken() const { return _validationToken; }
+
+    /// \brief Returns the number of levels shared with the TopologyRefiner this
+    ///        instance was created from (see TopologyRefinerFactory::Create())
+    ///
+    /// Shared levels, and the refinements between them, are owned by the
+    /// source TopologyRefiner and are not included in GetMemoryUsage().
+    ///
+    int GetNumSharedLevels() const { return _numSharedLevels; }
+
+    /// \brief Returns the MemoryResource the refined levels are allocated
+    ///        from, if any (see TopologyRefinerFactory::Options)
+    MemoryResource * GetMemoryResource() const { return _memoryResource; }
+
     /// \brief Returns the total number of vertices in all levels
     int GetNumVerticesTotal() const { return _totalVertices; }
 
@@ -92,10 +111,56 @@ public:
     /// \brief Returns a handle to access data specific to a particular level
     TopologyLevel const & GetLevel(int level) const { return _farLevels[level]; }
 
+    /// \brief Memory held by a level of refinement (see GetLevelMemoryUsage)
+    struct LevelMemoryUsage {
+        MemoryUsage topology,    ///< topological relations, sharpness and tags
+                    refinement,  ///< parent-child mappings to the next level
+                                 ///< (none for the last level)
+                    fvar;        ///< face-varying channels and their refinement
+    };
+
+    /// \brief Returns the memory held by a level of refinement -- both the
+    ///        size and the capacity of its arrays
+    LevelMemoryUsage GetLevelMemoryUsage(int level) const;
+
+    /// \brief Returns the memory held by all levels of refinement
+    MemoryUsage GetMemoryUsage() const;
+
+    /// \brief Statistics of a level of refinement (see GetLevelStatistics)
+    struct LevelStatistics {
+        int numVertices,      ///< number of vertices
+            numEdges,         ///< number of edges
+            numFaces,         ///< number of faces
+            numFaceVertices,  ///< number of face-vertices
+            numHoles,         ///< number of faces tagged as holes
+            numRefinedFaces,  ///< number of faces refined in the next level
+                              ///< (all of them unless sparsely refined, none
+                              ///< for the last level)
+            maxValence;       ///< maximum vertex valence
+    };
+
+    /// \brief Returns the statistics of a level of refinement
+    LevelStatistics GetLevelStatistics(int level) const;
+
     //@{
     ///  @name High-level refinement and related methods
     ///
 
+    /// \brief Phases of the refinement of each level, in order of execution
+    enum RefinementPhase {
+        PHASE_SELECTION,  ///< Selection of the features to isolate (adaptive only)
+        PHASE_MAPPING,    ///< Mapping between parent and child components
+        PHASE_TAGS,       ///< Propagation of component tags
+        PHASE_TOPOLOGY,   ///< Subdivision of the topological relations
+        PHASE_SHARPNESS,  ///< Subdivision of edge and vertex sharpness
+        PHASE_FVAR,       ///< Refinement of face-varying channels (if any)
+        PHASE_END         ///< Refinement of the level completed
+    };
+
+    /// \brief Client function notified at the start of each phase of the
+    ///        refinement of a level (intended for profiling)
+    typedef void (*PhaseCallback)(int level, RefinementPhase phase, void * clientData);
+
     //
     // Uniform refinement
     //
@@ -106,18 +171,48 @@ public:
         UniformOptions(int level) :
             refinementLevel(level),
             orderVerticesFromFacesFirst(false),
-            fullTopologyInLastLevel(false) { }
+            fullTopologyInLastLevel(false),
+            allocateFromArena(false),
+            skipHoles(false),
+            numThreads(1),
+            taskScheduler(0),
+            phaseCallback(0),
+            phaseCallbackData(0) { }
 
         unsigned int refinementLevel:4,             ///< Number of refinement iterations
                      orderVerticesFromFacesFirst:1, ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
-                     fullTopologyInLastLevel:1;     ///< Skip topological relationships in the last
+                     fullTopologyInLastLevel:1,     ///< Skip topological relationships in the last
                                                     ///< level of refinement that are not needed for
                                                     ///< interpolation (keep false if using limit).
+                     allocateFromArena:1,           ///< Allocate the refined levels from large
+                                                    ///< blocks owned by the refiner, released
+                                                    ///< only by Unrefine() or destruction
+                     skipHoles:1;                   ///< Refine the faces that are not holes only
+                                                    ///< (see RefineUniform())
+        int          numThreads;                    ///< Number of threads used to subdivide the
+                                                    ///< topology of each level (requires OpenMP)
+        TaskScheduler const * taskScheduler;        ///< Optional scheduler used for concurrency
+                                                    ///< instead of OpenMP (overrides numThreads)
+        PhaseCallback phaseCallback;                ///< Optional function notified of the
+                                                    ///< progress of the refinement
+        void *       phaseCallbackData;             ///< Client data passed to phaseCallback
     };
 
     /// \brief Refine the topology uniformly
     ///
+    /// With options.skipHoles, faces that are holes are not refined : the
+    /// refined levels only hold the children of the faces that are not holes,
+    /// along with the ring of children of neighboring holes supporting their
+    /// limit (tagged as holes). Components used only by holes have no
+    /// children, and cost no memory or stencils. The vertices of the children
+    /// of holes are not guaranteed to be those of a full refinement.
+    ///
+    /// Indices are 32-bit : if any refined level, or the totals over all
+    /// levels, would exceed their range, a FAR_RUNTIME_ERROR is reported and
+    /// the refiner is left unrefined. Larger meshes are to be refined in
+    /// tiles with StreamingRefiner.
+    ///
     /// @param options   Options controlling uniform refinement
     ///
     void RefineUniform(UniformOptions options);
@@ -134,29 +229,232 @@ public:
 
         AdaptiveOptions(int level) :
             isolationLevel(level),
+            secondaryLevel(15),
             useSingleCreasePatch(false),
-            orderVerticesFromFacesFirst(false) { }
+            useInfSharpPatch(false),
+            orderVerticesFromFacesFirst(false),
+            allocateFromArena(false),
+            numThreads(1),
+            taskScheduler(0),
+            phaseCallback(0),
+            phaseCallbackData(0) { }
 
         unsigned int isolationLevel:4,              ///< Number of iterations applied to isolate
                                                     ///< extraordinary vertices and creases
+                     secondaryLevel:4,              ///< Shallower level (at least 1) at which
+                                                    ///< isolation of extraordinary vertices
+                                                    ///< stops, leaving them to end caps (see
+                                                    ///< RefineAdaptive())
                      useSingleCreasePatch:1,        ///< Use 'single-crease' patch and stop
                                                     ///< isolation where applicable
-                     orderVerticesFromFacesFirst:1; ///< Order child vertices from faces first
+                     useInfSharpPatch:1,            ///< Treat infinitely sharp edges as patch
+                                                    ///< boundaries and stop isolation at regular
+                                                    ///< creases, corners and boundaries
+                     orderVerticesFromFacesFirst:1, ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
+                     allocateFromArena:1;           ///< Allocate the refined levels from large
+                                                    ///< blocks owned by the refiner, released
+                                                    ///< only by Unrefine() or destruction
+        int          numThreads;                    ///< Number of threads used to subdivide the
+                                                    ///< topology of each level (requires OpenMP)
+        TaskScheduler const * taskScheduler;        ///< Optional scheduler used for concurrency
+                                                    ///< instead of OpenMP (overrides numThreads)
+        PhaseCallback phaseCallback;                ///< Optional function notified of the
+                                                    ///< progress of the refinement
+        void *       phaseCallbackData;             ///< Client data passed to phaseCallback
     };
 
-    /// \brief Feature Adaptive topology refinement (restricted to scheme Catmark)
+    /// \brief Feature Adaptive topology refinement (schemes Catmark and Loop)
+    ///
+    /// Faces are isolated up to options.isolationLevel, except for those
+    /// selected only for their smooth extraordinary vertices, which are
+    /// isolated up to options.secondaryLevel when it is lower : semi-sharp
+    /// and non-manifold features still require the full isolation. The
+    /// extraordinary vertices are then left to end cap patches at the level
+    /// where their isolation stopped, so a secondary level of 1 or 2 with
+    /// ENDCAP_GREGORY_BASIS or ENDCAP_BSPLINE_BASIS yields results close to
+    /// those of the full isolation with far fewer patches.
     ///
     /// @param options   Options controlling adaptive refinement
     ///
     void RefineAdaptive(AdaptiveOptions options);
 
+    /// \brief Feature Adaptive topology refinement with a maximum isolation
+    ///        level for each base face (schemes Catmark and Loop)
+    ///
+    /// Features of the descendants of each base face are isolated up to the
+    /// smaller of options.isolationLevel and the level of the face, so that
+    /// background faces can be isolated less than those of a hero asset. The
+    /// patch tables created from the refiner contain end cap patches at the
+    /// level where isolation of each face stopped.
+    ///
+    /// \note Levels lower than 1 are interpreted as 1 : all the base faces
+    ///       are isolated as in the first level of RefineAdaptive().
+    ///
+    /// @param options               Options controlling adaptive refinement
+    ///
+    /// @param baseFaceIsolationLevels  Maximum isolation level of each base
+    ///                                 face (a value per base face)
+    ///
+    void RefineAdaptive(AdaptiveOptions options,
+                        unsigned char const * baseFaceIsolationLevels);
+
     /// \brief Returns the options specified on refinement
     AdaptiveOptions GetAdaptiveOptions() const { return _adaptiveOptions; }
 
+    //
+    // Sparse refinement
+    //
+
+    /// \brief Sparse refinement of a selection of base faces (schemes
+    ///        Catmark and Loop)
+    ///
+    /// Only the given base faces (e.g. the faces visible from a camera) are
+    /// refined, uniformly, to options.isolationLevel -- along with the ring of
+    /// neighboring faces needed to support their limit. Stencil and patch
+    /// tables created from the refiner cover the selected faces only : patches
+    /// are all generated at the last level (B-spline or end cap patches).
+    ///
+    /// @param options   Options controlling the refinement (isolationLevel is
+    ///                  the level of refinement, useSingleCreasePatch and
+    ///                  useInfSharpPatch are ignored)
+    ///
+    /// @param baseFaces Indices of the base faces to refine (holes and invalid
+    ///                  indices are ignored)
+    ///
+    void RefineSparse(AdaptiveOptions options, ConstIndexArray baseFaces);
+
+    /// \brief Sparse refinement of each base face to its own level (schemes
+    ///        Catmark and Loop)
+    ///
+    /// The descendants of each base face are refined, uniformly, up to the
+    /// smaller of options.isolationLevel and the level of the face -- along
+    /// with the ring of neighboring faces needed to support their limit, so
+    /// that the faces of finer levels extend the coarser ones they border
+    /// (e.g. faces of constant size in world space, see
+    /// VariableLevelMeshFactory). Base faces of level 0 are not refined.
+    ///
+    /// @param options         Options controlling the refinement (see above)
+    ///
+    /// @param baseFaceLevels  Level of each base face (a value per base face)
+    ///
+    void RefineSparse(AdaptiveOptions options, unsigned char const * baseFaceLevels);
+
+    /// \brief Returns true if sparse refinement of a face selection has been
+    ///        applied (see RefineSparse)
+    bool IsSparse() const { return _isSparse; }
+
     /// \brief Unrefine the topology (keep control cage)
+    ///
+    /// An instance sharing the topology of another TopologyRefiner releases
+    /// the shared refinements but keeps sharing the base level, from which it
+    /// can be refined differently.
+    ///
     void Unrefine();
 
+    /// \brief Releases the data of the refinements only needed to refine the
+    ///        topology and create patch tables from it
+    ///
+    /// Intended for long-lived refiners, once their tables have been created :
+    /// the component tags, sparse selection tags and child-to-parent mappings
+    /// (other than the parent faces of child faces) of all refinements are
+    /// released. The levels remain available for TopologyLevel queries,
+    /// PtexIndices and PrimvarRefiner interpolation, but PatchTableFactory and
+    /// UpdateBaseSharpness() fail on a trimmed refiner (see Unrefine()).
+    ///
+    void Trim();
+
+    /// \brief Returns true if the refinements have been trimmed (see Trim())
+    bool IsTrimmed() const { return _isTrimmed; }
+
+    /// \brief Assigns new sharpness values to edges and vertices of the base
+    ///        level and updates the current refinement accordingly
+    ///
+    /// Only the sharpness values and the component tags derived from them are
+    /// subdivided again : the refined topology is preserved by uniform
+    /// refinement, and by adaptive refinement for all levels where the features
+    /// isolated are unchanged. Adaptive refinement is applied again from the
+    /// first level where the features to isolate differ.
+    ///
+    /// Boundary and non-manifold edges, as well as sharpened corners and
+    /// non-manifold vertices, remain infinitely sharp. Updates are not
+    /// supported in the presence of face-varying channels.
+    ///
+    /// Stencil and patch tables created from the refiner are not updated and
+    /// need to be created again.
+    ///
+    /// An instance sharing the topology of another TopologyRefiner first
+    /// copies the base level and then refines it again as the shared levels
+    /// were : the source TopologyRefiner is left unmodified.
+    ///
+    /// @param edges           Indices of the base edges to update
+    ///
+    /// @param edgeSharpness   New sharpness of each of the edges
+    ///
+    /// @param vertices        Indices of the base vertices to update
+    ///
+    /// @param vertexSharpness New sharpness of each of the vertices
+    ///
+    /// Returns false (and leaves the refiner unmodified) on failure
+    ///
+    bool UpdateBaseSharpness(ConstIndexArray edges,    float const * edgeSharpness,
+                             ConstIndexArray vertices, float const * vertexSharpness);
+
+    /// \brief Assigns new values to a face-varying channel of the base level
+    ///        (or to a new channel) and refines them through the current
+    ///        refinement
+    ///
+    /// Only the face-varying refinement of the channel is applied again : the
+    /// vertex topology and all other channels are preserved, so changing UV
+    /// seams does not require a new TopologyRefiner.
+    ///
+    /// The refinement of face-varying channels requires the full topology of
+    /// all refined levels (see UniformOptions::fullTopologyInLastLevel).
+    ///
+    /// Stencil tables of the channel created from the refiner are not updated,
+    /// while patch tables can be updated in place (see
+    /// PatchTableFactory::UpdateFVarChannels()).
+    ///
+    /// An instance sharing the topology of another TopologyRefiner first
+    /// copies its levels (see UpdateBaseSharpness()).
+    ///
+    /// @param channel        Channel to replace, or GetNumFVarChannels() to add
+    ///                       a new channel
+    ///
+    /// @param numValues      Number of face-varying values of the channel
+    ///
+    /// @param faceValues     Value of each face-vertex of the base level, in the
+    ///                       order of its faces and their vertices
+    ///
+    /// @param interpolation  Linear interpolation rule-set of the channel
+    ///
+    /// Returns false (and leaves the refiner unmodified) on failure
+    ///
+    bool UpdateFVarChannel(int channel, int numValues, ConstIndexArray faceValues,
+                           Sdc::Options::FVarLinearInterpolation interpolation);
+
+    /// \brief Assigns the hierarchical edits applied by the refinement
+    ///
+    /// Sharpness and hole edits are applied to each level as it is refined,
+    /// and again when the sharpness of the base level is updated. Those of the
+    /// base level modify it immediately (as UpdateBaseSharpness() does). Vertex
+    /// edits are applied to primvar data by PrimvarRefiner::ApplyVertexEdits()
+    /// and folded into the tables of StencilTableFactory.
+    ///
+    /// Edits must be assigned before the topology is refined. Sharpness edits
+    /// are not supported in the presence of face-varying channels, and the full
+    /// topology of the last level of uniform refinement is always generated to
+    /// apply them (see UniformOptions::fullTopologyInLastLevel).
+    ///
+    /// @param edits  Edits to apply (copied by the refiner)
+    ///
+    /// Returns false (and leaves the refiner unmodified) on failure
+    ///
+    bool SetHierarchicalEdits(HierarchicalEdits const & edits);
+
+    /// \brief Returns the hierarchical edits assigned (NULL if none)
+    HierarchicalEdits const * GetHierarchicalEdits() const { return _edits; }
+
 
     //@{
     /// @name Number and properties of face-varying channels:
@@ -186,6 +484,7 @@ protected:
     friend class EndCapLegacyGregoryPatchFactory;
     friend class PtexIndices;
     friend class PrimvarRefiner;
+    friend class StreamingRefiner;
 
     Vtr::internal::Level & getLevel(int l) { return *_levels[l]; }
     Vtr::internal::Level const & getLevel(int l) const { return *_levels[l]; }
@@ -193,17 +492,37 @@ protected:
     Vtr::internal::Refinement & getRefinement(int l) { return *_refinements[l]; }
     Vtr::internal::Refinement const & getRefinement(int l) const { return *_refinements[l]; }
 
+    //  Instance sharing all levels and refinements of another (see the factories):
+    TopologyRefiner(TopologyRefiner const & source);
+
+    //  Replace the shared base level of an unrefined instance with its own copy:
+    void copyBaseLevel(bool copyFVarChannels);
+
+    //  Face of the refined level addressed by the path of a hierarchical edit
+    //  (INDEX_INVALID if that face was not refined):
+    Index findEditFace(int edit) const;
+
 private:
-    //  Not default constructible or copyable:
+    //  Not default constructible or assignable:
     TopologyRefiner() : _uniformOptions(0), _adaptiveOptions(0) { }
-    TopologyRefiner(TopologyRefiner const &) : _uniformOptions(0), _adaptiveOptions(0) { }
     TopologyRefiner & operator=(TopologyRefiner const &) { return *this; }
 
     void selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector& selector);
+    void selectSparseComponents(Vtr::internal::SparseSelector& selector);
+
+    void refineAdaptiveLevels(int firstLevel);
+    bool isAdaptiveSelectionUnchanged(int level);
+    void discardLevels(int firstLevel);
+    void copySharedLevels();
+
+    void applyHierarchicalEdits(int level);
+    void updateSharpnessTags(Vtr::internal::Level & level, std::vector<Index> const & vertices);
 
     void initializeInventory();
     void updateInventory(Vtr::internal::Level const & newLevel);
 
+    Vtr::internal::Level & createChildLevel(bool allocateFromArena);
+
     void appendLevel(Vtr::internal::Level & newLevel);
     void appendRefinement(Vtr::internal::Refinement & newRefinement);
     void assembleFarLevels();
@@ -214,13 +533,22 @@ private:
     Sdc::Options    _subdivOptions;
 
     unsigned int _isUniform : 1,
+                 _isSparse : 1,
+                 _isTrimmed : 1,
                  _hasHoles : 1,
+                 _hasSemiSharpFeatures : 1,
                  _maxLevel : 4;
 
     //  Options assigned on refinement:
     UniformOptions  _uniformOptions;
     AdaptiveOptions _adaptiveOptions;
 
+    //  Base faces selected for sparse refinement:
+    std::vector<Index> _sparseBaseFaces;
+
+    //  Maximum isolation level of the base faces (optional):
+    std::vector<unsigned char> _baseFaceIsolationLevels;
+
     //  Cumulative properties of all levels:
     int _totalVertices;
     int _totalEdges;
@@ -228,10 +556,25 @@ private:
     int _totalFaceVertices;
     int _maxValence;
 
+    //  Number of leading levels (and refinements between them) owned by another
+    //  TopologyRefiner this instance shares its topology with:
+    int _numSharedLevels;
+
+    //  Hash of the base topology when fully validated by the factory:
+    unsigned long long _validationToken;
+
     //  There is some redundancy here -- to be reduced later
     std::vector<Vtr::internal::Level *>      _levels;
     std::vector<Vtr::internal::Refinement *> _refinements;
 
+    //  Optional allocator of the refined levels and refinements, and the resource
+    //  of the client its blocks are allocated from (which implies the arena):
+    Vtr::internal::Arena * _arena;
+    MemoryResource *       _memoryResource;
+
+    //  Optional hierarchical edits applied to the refined levels:
+    HierarchicalEdits * _edits;
+
     std::vector<TopologyLevel> _farLevels;
 };
 
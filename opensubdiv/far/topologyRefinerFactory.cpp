@@ -23,10 +23,13 @@
 //
 #include "../far/topologyRefinerFactory.h"
 #include "../far/topologyRefiner.h"
+#include "../far/taskScheduler.h"
 #include "../sdc/types.h"
 #include "../vtr/level.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <vector>
 #ifdef _MSC_VER
     #define snprintf _snprintf
 #endif
@@ -37,6 +40,131 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
+namespace {
+    //
+    //  Adaptor to delegate the concurrency of the completion of topology to a TaskScheduler:
+    //
+    void
+    schedulerParallelFor(int begin, int end,
+                         Vtr::internal::Level::RangeKernel kernel, void * kernelData,
+                         void const * scheduler) {
+
+        static_cast<TaskScheduler const *>(scheduler)->ParallelFor(begin, end, 1, kernel, kernelData);
+    }
+
+    Vtr::internal::Level::Concurrency
+    getConcurrency(int numThreads, TaskScheduler const * scheduler) {
+
+        Vtr::internal::Level::Concurrency concurrency(numThreads);
+        if (scheduler) {
+            concurrency._numThreads = scheduler->GetNumThreads();
+            if (concurrency._numThreads > 1) {
+                concurrency._parallelFor     = schedulerParallelFor;
+                concurrency._parallelForData = scheduler;
+            }
+        }
+        return concurrency;
+    }
+
+    //
+    //  Token of a validated topology -- a hash of all relations of the base level and of
+    //  the tags validated with them.  Components are hashed in chunks of a fixed size, so
+    //  that tokens do not depend on the concurrency.  Words are mixed as in MurmurHash64A:
+    //
+    typedef unsigned long long Hash;
+
+    const Hash hashMultiplier = 0xc6a4a7935bd1e995ULL;
+
+    inline Hash
+    mix(Hash hash, Hash word) {
+        word *= hashMultiplier;
+        word ^= word >> 47;
+        word *= hashMultiplier;
+        return (hash ^ word) * hashMultiplier;
+    }
+
+    template <class ARRAY>
+    inline Hash
+    mixArray(Hash hash, ARRAY const & array) {
+        hash = mix(hash, (Hash)array.size());
+        for (int i = 0; i < array.size(); ++i) {
+            hash = mix(hash, (Hash)array[i]);
+        }
+        return hash;
+    }
+
+    const int tokenChunkSize = 1 << 12;
+
+    struct TokenChunks {
+        Vtr::internal::Level const * level;
+        Hash *                       chunkHashes;
+    };
+
+    void
+    hashTokenChunks(int begin, int end, void * data) {
+
+        TokenChunks const & chunks = *static_cast<TokenChunks const *>(data);
+        Vtr::internal::Level const & level = *chunks.level;
+
+        int fCount = level.getNumFaces(),
+            eCount = level.getNumEdges(),
+            vCount = level.getNumVertices();
+
+        for (int chunk = begin; chunk < end; ++chunk) {
+            int first = chunk * tokenChunkSize,
+                last = std::min(first + tokenChunkSize, fCount + eCount + vCount);
+
+            Hash hash = (Hash)chunk;
+            for (int i = first; i < last; ++i) {
+                if (i < fCount) {
+                    hash = mixArray(hash, level.getFaceVertices(i));
+                    hash = mixArray(hash, level.getFaceEdges(i));
+                } else if (i < fCount + eCount) {
+                    Vtr::Index e = i - fCount;
+                    hash = mixArray(hash, level.getEdgeVertices(e));
+                    hash = mixArray(hash, level.getEdgeFaces(e));
+                    hash = mixArray(hash, level.getEdgeFaceLocalIndices(e));
+                    hash = mix(hash, (Hash)level.getEdgeTag(e)._nonManifold);
+                } else {
+                    Vtr::Index v = i - fCount - eCount;
+                    hash = mixArray(hash, level.getVertexFaces(v));
+                    hash = mixArray(hash, level.getVertexFaceLocalIndices(v));
+                    hash = mixArray(hash, level.getVertexEdges(v));
+                    hash = mixArray(hash, level.getVertexEdgeLocalIndices(v));
+                    hash = mix(hash, (Hash)level.getVertexTag(v)._nonManifold |
+                                    ((Hash)level.getVertexTag(v)._incomplete << 1));
+                }
+            }
+            chunks.chunkHashes[chunk] = hash;
+        }
+    }
+
+    Hash
+    computeValidationToken(Vtr::internal::Level const & level,
+                           Vtr::internal::Level::Concurrency const & concurrency) {
+
+        int numItems = level.getNumFaces() + level.getNumEdges() + level.getNumVertices(),
+            numChunks = (numItems + tokenChunkSize - 1) / tokenChunkSize;
+
+        std::vector<Hash> chunkHashes(numChunks);
+
+        TokenChunks chunks = { &level, numChunks ? &chunkHashes[0] : 0 };
+        Vtr::internal::Level::applyConcurrently(concurrency, numChunks, hashTokenChunks, &chunks);
+
+        Hash hash = mix(mix(mix(0, (Hash)level.getNumFaces()),
+                            (Hash)level.getNumEdges()), (Hash)level.getNumVertices());
+        for (int chunk = 0; chunk < numChunks; ++chunk) {
+            hash = mix(hash, chunkHashes[chunk]);
+        }
+        hash ^= hash >> 47;
+        hash *= hashMultiplier;
+        hash ^= hash >> 47;
+
+        //  Zero is reserved for topologies that were not validated:
+        return hash ? hash : 1;
+    }
+}
+
 //
 //  Methods for the Factory base class -- general enough to warrant including in
 //  the base class rather than the subclass template (and so replicated for each
@@ -119,13 +247,15 @@ TopologyRefinerFactoryBase::prepareComponentTopologySizing(TopologyRefiner& refi
 
 bool
 TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                               TopologyCallback callback, void const * callbackData) {
+                                                               TopologyCallback callback, void const * callbackData,
+                                                               int numThreads, TaskScheduler const * scheduler,
+                                                               unsigned long long validationToken) {
 
     Vtr::internal::Level& baseLevel = refiner.getLevel(0);
 
     bool completeMissingTopology = (baseLevel.getNumEdges() == 0);
     if (completeMissingTopology) {
-        if (not baseLevel.completeTopologyFromFaceVertices()) {
+        if (not baseLevel.completeTopologyFromFaceVertices(getConcurrency(numThreads, scheduler))) {
             char msg[1024];
             snprintf(msg, 1024, "Failure in TopologyRefinerFactory<>::Create() -- "
                     "vertex with valence %d > %d max.",
@@ -141,8 +271,13 @@ TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner&
         }
     }
 
+    //  Topologies matching the token of a previous validation are not validated again:
     if (fullValidation) {
-        if (not baseLevel.validateTopology(callback, callbackData)) {
+        Vtr::internal::Level::Concurrency concurrency = getConcurrency(numThreads, scheduler);
+
+        unsigned long long token = computeValidationToken(baseLevel, concurrency);
+        if ((token != validationToken) and
+            not baseLevel.validateTopology(callback, callbackData, concurrency)) {
             if (completeMissingTopology) {
                 Error(FAR_RUNTIME_ERROR, "Failure in TopologyRefinerFactory<>::Create() -- "
                     "invalid topology detected from partial specification.");
@@ -152,6 +287,7 @@ TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner&
             }
             return false;
         }
+        refiner._validationToken = token;
     }
 
     //  Now that we have a valid base level, initialize the Refiner's component inventory:
@@ -201,6 +337,10 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
     int schemeRegularInteriorValence = Sdc::SchemeTypeTraits::GetRegularVertexValence(refiner.GetSchemeType());
     int schemeRegularBoundaryValence = schemeRegularInteriorValence / 2;
 
+    //  Meshes without semi-sharp features are noted, as their refinement then has no
+    //  sharpness to subdivide (see Vtr::internal::Refinement::Options):
+    refiner._hasSemiSharpFeatures = false;
+
     for (Vtr::Index vIndex = 0; vIndex < baseLevel.getNumVertices(); ++vIndex) {
         Vtr::internal::Level::VTag& vTag       = baseLevel.getVertexTag(vIndex);
         float&                      vSharpness = baseLevel.getVertexSharpness(vIndex);
@@ -249,6 +389,10 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
         vTag._semiSharp      = Sdc::Crease::IsSemiSharp(vSharpness);
         vTag._semiSharpEdges = (semiSharpEdgeCount > 0);
 
+        if (vTag._semiSharp || vTag._semiSharpEdges) {
+            refiner._hasSemiSharpFeatures = true;
+        }
+
         vTag._rule = (Vtr::internal::Level::VTag::VTagSize)creasing.DetermineVertexVertexRule(vSharpness, sharpEdgeCount);
 
         //
@@ -283,7 +427,8 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
 }
 
 bool
-TopologyRefinerFactoryBase::prepareFaceVaryingChannels(TopologyRefiner& refiner) {
+TopologyRefinerFactoryBase::prepareFaceVaryingChannels(TopologyRefiner& refiner,
+                                                       int numThreads, TaskScheduler const * scheduler) {
 
     Vtr::internal::Level& baseLevel = refiner.getLevel(0);
 
@@ -298,8 +443,8 @@ TopologyRefinerFactoryBase::prepareFaceVaryingChannels(TopologyRefiner& refiner)
             Error(FAR_RUNTIME_ERROR, msg);
             return false;
         }
-        baseLevel.completeFVarChannelTopology(channel, regBoundaryValence);
     }
+    baseLevel.completeFVarChannelsTopology(regBoundaryValence, getConcurrency(numThreads, scheduler));
     return true;
 }
 
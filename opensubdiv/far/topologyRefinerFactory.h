@@ -55,9 +55,12 @@ protected:
 
     static bool prepareComponentTopologySizing(TopologyRefiner& refiner);
     static bool prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                   TopologyCallback callback, void const * callbackData);
+                                                   TopologyCallback callback, void const * callbackData,
+                                                   int numThreads = 1, TaskScheduler const * scheduler = 0,
+                                                   unsigned long long validationToken = 0);
     static bool prepareComponentTagsAndSharpness(TopologyRefiner& refiner);
-    static bool prepareFaceVaryingChannels(TopologyRefiner& refiner);
+    static bool prepareFaceVaryingChannels(TopologyRefiner& refiner,
+                                           int numThreads = 1, TaskScheduler const * scheduler = 0);
 };
 
 
@@ -86,14 +89,33 @@ public:
         Options(Sdc::SchemeType sdcType = Sdc::SCHEME_CATMARK, Sdc::Options sdcOptions = Sdc::Options()) :
             schemeType(sdcType),
             schemeOptions(sdcOptions),
-            validateFullTopology(false) { }
+            validateFullTopology(false),
+            numThreads(1),
+            taskScheduler(0),
+            memoryResource(0),
+            validationToken(0) { }
 
         Sdc::SchemeType schemeType;             ///< The subdivision scheme type identifier
         Sdc::Options    schemeOptions;          ///< The full set of options for the scheme,
                                                 ///< e.g. boundary interpolation rules...
         unsigned int validateFullTopology : 1;  ///< Apply more extensive validation of
-                                                ///< the constructed topology -- intended
-                                                ///< for debugging.
+                                                ///< the constructed topology, reporting
+                                                ///< all errors found (concurrent with
+                                                ///< numThreads or taskScheduler)
+        int             numThreads;             ///< Number of threads used to complete the
+                                                ///< topology from face-vertices only and the
+                                                ///< face-varying channels (requires OpenMP)
+        TaskScheduler const * taskScheduler;    ///< Optional scheduler used for concurrency
+                                                ///< instead of OpenMP (overrides numThreads)
+        MemoryResource * memoryResource;        ///< Optional resource of the client the
+                                                ///< refined levels are allocated from
+                                                ///< (the base level and face-varying
+                                                ///< channels remain on the heap)
+        unsigned long long validationToken;     ///< Token of a topology validated before
+                                                ///< (see TopologyRefiner::GetValidationToken()):
+                                                ///< with validateFullTopology, only the
+                                                ///< token of the new topology is computed
+                                                ///< and validation is skipped if it matches
     };
 
     /// \brief Instantiates a TopologyRefiner from client-provided topological
@@ -112,6 +134,41 @@ public:
     ///
     static TopologyRefiner* Create(MESH const& mesh, Options options = Options());
 
+    /// \brief Instantiates a TopologyRefiner sharing the topology of another
+    ///
+    ///  The new instance shares the base level and all refinements of 'source'
+    ///  rather than copying them, so many instances of the same topology only
+    ///  hold their topology once. Copies are made on write : an instance that
+    ///  is unrefined and refined again refines its own levels from the shared
+    ///  base level, and updating its sharpness copies the base level first (see
+    ///  TopologyRefiner::UpdateBaseSharpness()).
+    ///
+    ///  'source' must outlive its instances, and must not be refined, trimmed
+    ///  or updated again while they share its topology.
+    ///
+    /// @param source     TopologyRefiner to share the topology of
+    ///
+    /// @return           A new instance of TopologyRefiner
+    ///
+    static TopologyRefiner* Create(TopologyRefiner const & source);
+
+    /// \brief Instantiates a TopologyRefiner sharing the topology of another
+    ///        with the face-varying channels of a mesh
+    ///
+    ///  Face-varying channels are held by the levels, so the base level of
+    ///  'source' is copied without its face-varying channels, those of 'mesh'
+    ///  are assigned to it (see assignFaceVaryingTopology()) and the instance
+    ///  is left unrefined. This avoids completing the topology of 'mesh'
+    ///  again, which must match that of 'source'.
+    ///
+    /// @param source     TopologyRefiner to copy the topology of
+    ///
+    /// @param mesh       Client's representation of the face-varying channels
+    ///
+    /// @return           A new instance of TopologyRefiner or 0 for failure
+    ///
+    static TopologyRefiner* Create(TopologyRefiner const & source, MESH const& mesh);
+
 protected:
     typedef Vtr::internal::Level::TopologyError TopologyError;
 
@@ -318,6 +375,7 @@ TopologyRefiner*
 TopologyRefinerFactory<MESH>::Create(MESH const& mesh, Options options) {
 
     TopologyRefiner * refiner = new TopologyRefiner(options.schemeType, options.schemeOptions);
+    refiner->_memoryResource = options.memoryResource;
 
     if (not populateBaseLevel(*refiner, mesh, options)) {
         delete refiner;
@@ -331,6 +389,30 @@ TopologyRefinerFactory<MESH>::Create(MESH const& mesh, Options options) {
     return refiner;
 }
 
+template <class MESH>
+TopologyRefiner*
+TopologyRefinerFactory<MESH>::Create(TopologyRefiner const & source) {
+
+    return new TopologyRefiner(source);
+}
+
+template <class MESH>
+TopologyRefiner*
+TopologyRefinerFactory<MESH>::Create(TopologyRefiner const & source, MESH const& mesh) {
+
+    TopologyRefiner * refiner = new TopologyRefiner(source);
+
+    refiner->Unrefine();
+    refiner->copyBaseLevel(false);
+
+    if (not assignFaceVaryingTopology(*refiner, mesh) or
+        not prepareFaceVaryingChannels(*refiner)) {
+        delete refiner;
+        return 0;
+    }
+    return refiner;
+}
+
 template <class MESH>
 bool
 TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH const& mesh, Options options) {
@@ -362,7 +444,9 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     void const *     userData = &mesh;
         
     if (not assignComponentTopology(refiner, mesh)) return false;
-    if (not prepareComponentTopologyAssignment(refiner, validate, callback, userData)) return false;
+    if (not prepareComponentTopologyAssignment(refiner, validate, callback, userData,
+                                               options.numThreads, options.taskScheduler,
+                                               options.validationToken)) return false;
 
     //
     //  User assigned and internal tagging of components -- an optional specialization for
@@ -375,7 +459,7 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     //  Defining channels of face-varying primvar data -- an optional specialization for MESH.
     //
     if (not assignFaceVaryingTopology(refiner, mesh)) return false;
-    if (not prepareFaceVaryingChannels(refiner)) return false;
+    if (not prepareFaceVaryingChannels(refiner, options.numThreads, options.taskScheduler)) return false;
 
     return true;
 }
@@ -47,6 +47,10 @@ typedef Vtr::LocalIndexArray  LocalIndexArray;
 typedef Vtr::ConstIndexArray       ConstIndexArray;
 typedef Vtr::ConstLocalIndexArray  ConstLocalIndexArray;
 
+typedef Vtr::ConstArray<float>     ConstFloatArray;
+
+typedef Vtr::MemoryUsage  MemoryUsage;
+
 inline bool IndexIsValid(Index index) { return Vtr::IndexIsValid(index); }
 
 static const Index INDEX_INVALID = Vtr::INDEX_INVALID;
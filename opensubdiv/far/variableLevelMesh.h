@@ -0,0 +1,127 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_VARIABLE_LEVEL_MESH_H
+#define OPENSUBDIV3_FAR_VARIABLE_LEVEL_MESH_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+#include "../far/stencilTable.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Faces of a refinement of each base face to its own level
+///
+/// Displacement baking and similar targets want refined faces of roughly
+/// constant size in world space, whereas uniform refinement divides small and
+/// large base faces alike. The base faces are here refined sparsely, each to
+/// its own level (see TopologyRefiner::RefineSparse()), and the faces of the
+/// last level of each base face make up the mesh.
+///
+/// The faces of a coarser base face also hold the vertices inserted along
+/// their edges by a finer neighbor (e.g. a quad of level 1 bordering faces of
+/// level 2 has up to 8 vertices), so that the mesh has no cracks, and every
+/// vertex is the point of the finest level it was refined to.
+///
+/// The faces index the vertex buffer of the control vertices followed by the
+/// points evaluated by GetStencilTable(), which only holds the stencils of
+/// the refined vertices of the faces.
+///
+/// See VariableLevelMeshFactory.
+///
+class VariableLevelMesh {
+
+public:
+
+    ~VariableLevelMesh() { delete _stencils; }
+
+    /// \brief Returns the number of control vertices
+    int GetNumControlVertices() const { return _numControlVertices; }
+
+    /// \brief Returns the number of vertices of the vertex buffer (the
+    ///        control vertices and the refined vertices)
+    int GetNumVertices() const { return _numVertices; }
+
+    /// \brief Returns the number of faces
+    int GetNumFaces() const { return (int)_faceBaseFaces.size(); }
+
+    /// \brief Returns the vertices of a face (indices of the vertex buffer)
+    ConstIndexArray GetFaceVertices(int face) const {
+        return ConstIndexArray(&_faceVertices[_faceOffsets[face]],
+                               _faceOffsets[face + 1] - _faceOffsets[face]);
+    }
+
+    /// \brief Returns the number of vertices of each face
+    std::vector<int> const & GetFaceVertexCounts() const { return _faceCounts; }
+
+    /// \brief Returns the vertices of all the faces
+    std::vector<Index> const & GetFaceVertexIndices() const { return _faceVertices; }
+
+    /// \brief Returns the base face a face descends from
+    Index GetFaceBaseFace(int face) const { return _faceBaseFaces[face]; }
+
+    /// \brief Returns the level of a face
+    int GetFaceLevel(int face) const { return _faceLevels[face]; }
+
+    /// \brief Returns the stencils of the refined vertices, in the order of
+    ///        the vertex buffer (following the control vertices)
+    StencilTable const * GetStencilTable() const { return _stencils; }
+
+private:
+
+    friend class VariableLevelMeshFactory;
+
+    VariableLevelMesh() : _numControlVertices(0), _numVertices(0), _stencils(0) { }
+
+    //  Not copyable:
+    VariableLevelMesh(VariableLevelMesh const &);
+    VariableLevelMesh & operator=(VariableLevelMesh const &);
+
+    int _numControlVertices,
+        _numVertices;
+
+    std::vector<int>   _faceCounts;     // vertices of each face
+    std::vector<Index> _faceOffsets;
+    std::vector<Index> _faceVertices;
+
+    std::vector<Index>         _faceBaseFaces;
+    std::vector<unsigned char> _faceLevels;
+
+    StencilTable const * _stencils;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_VARIABLE_LEVEL_MESH_H
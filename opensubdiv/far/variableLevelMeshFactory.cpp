@@ -0,0 +1,255 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/variableLevelMeshFactory.h"
+#include "../far/error.h"
+#include "../far/stencilTableFactory.h"
+#include "../far/topologyDescriptor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    //
+    //  Gathers the vertices of an edge of a face, from its start vertex, down to the
+    //  finest level its children were refined to -- the vertices inserted by finer
+    //  neighbors of the face -- as pairs of (level, vertex):
+    //
+    void
+    gatherEdgeVertices(TopologyRefiner const & refiner, int level, Index edge,
+            Index startVertex, std::vector<std::pair<int, Index> > & vertices) {
+
+        Index edgeVertex = INDEX_INVALID;
+        ConstIndexArray childEdges;
+        if (level < refiner.GetMaxLevel()) {
+            edgeVertex = refiner.GetLevel(level).GetEdgeChildVertex(edge);
+            childEdges = refiner.GetLevel(level).GetEdgeChildEdges(edge);
+        }
+        if (not IndexIsValid(edgeVertex) or
+            not IndexIsValid(childEdges[0]) or not IndexIsValid(childEdges[1])) {
+            vertices.push_back(std::make_pair(level, startVertex));
+            return;
+        }
+        TopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        //  Orient the child edges from the child of the start vertex:
+        Index childVertex = refLevel.GetVertexChildVertex(startVertex);
+
+        ConstIndexArray firstVerts = refiner.GetLevel(level + 1).GetEdgeVertices(childEdges[0]);
+        int first = (firstVerts[0] == childVertex or firstVerts[1] == childVertex) ? 0 : 1;
+
+        gatherEdgeVertices(refiner, level + 1, childEdges[first], childVertex, vertices);
+        gatherEdgeVertices(refiner, level + 1, childEdges[1 - first], edgeVertex, vertices);
+    }
+}
+
+void
+VariableLevelMeshFactory::ComputeBaseFaceLevels(TopologyRefiner const & refiner,
+        float const * positions, int stride, float targetEdgeLength,
+            int maxLevel, std::vector<unsigned char> & levels) {
+
+    TopologyLevel const & baseLevel = refiner.GetLevel(0);
+
+    levels.assign(baseLevel.GetNumFaces(), 0);
+
+    if (not (targetEdgeLength > 0.0f)) return;
+
+    for (Index face = 0; face < baseLevel.GetNumFaces(); ++face) {
+        ConstIndexArray fVerts = baseLevel.GetFaceVertices(face);
+
+        float longest = 0.0f;
+        for (int i = 0; i < fVerts.size(); ++i) {
+            float const * p0 = positions + fVerts[i] * stride,
+                        * p1 = positions + fVerts[(i + 1) % fVerts.size()] * stride;
+            float d[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            longest = std::max(longest, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+        longest = std::sqrt(longest);
+
+        int level = 0;
+        while ((level < maxLevel) and (longest > targetEdgeLength)) {
+            longest *= 0.5f;
+            ++level;
+        }
+        levels[face] = (unsigned char)level;
+    }
+}
+
+VariableLevelMesh const *
+VariableLevelMeshFactory::Create(TopologyRefiner const & refiner,
+        unsigned char const * baseFaceLevels) {
+
+    if (refiner.GetSchemeType() == Sdc::SCHEME_BILINEAR) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in VariableLevelMeshFactory::Create() -- "
+            "not supported for Bilinear scheme.");
+        return NULL;
+    }
+
+    TopologyLevel const & baseLevel = refiner.GetLevel(0);
+    int numBaseFaces = baseLevel.GetNumFaces();
+
+    std::vector<unsigned char> levels(baseFaceLevels, baseFaceLevels + numBaseFaces);
+
+    int maxLevel = 0;
+    for (int face = 0; face < numBaseFaces; ++face) {
+        levels[face] = std::min(levels[face], (unsigned char)15);
+        maxLevel = std::max(maxLevel, (int)levels[face]);
+    }
+
+    //  An instance sharing the base level is refined sparsely to the levels:
+    TopologyRefiner * sparseRefiner =
+        TopologyRefinerFactory<TopologyDescriptor>::Create(refiner);
+    sparseRefiner->Unrefine();
+
+    TopologyRefiner::AdaptiveOptions options(maxLevel);
+    sparseRefiner->RefineSparse(options, &levels[0]);
+
+    if (not sparseRefiner->IsSparse()) {
+        delete sparseRefiner;
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in VariableLevelMeshFactory::Create() -- "
+            "sparse refinement failed.");
+        return NULL;
+    }
+    maxLevel = sparseRefiner->GetMaxLevel();
+
+    VariableLevelMesh * mesh = new VariableLevelMesh;
+
+    mesh->_numControlVertices = baseLevel.GetNumVertices();
+
+    //  The faces of each level that descend from base faces of that level are gathered
+    //  with the vertices inserted along their edges -- the other faces were either
+    //  refined further or are the incomplete neighbors supporting finer faces, whose
+    //  children may exist even when they were not refined:
+    std::vector<std::pair<int, Index> > vertices;
+    std::vector<Index> faceBaseFaces, parentBaseFaces;
+
+    mesh->_faceOffsets.push_back(0);
+    for (int level = 0; level <= maxLevel; ++level) {
+        TopologyLevel const & refLevel = sparseRefiner->GetLevel(level);
+
+        faceBaseFaces.resize(refLevel.GetNumFaces());
+        for (Index face = 0; face < refLevel.GetNumFaces(); ++face) {
+            Index baseFace = level ? parentBaseFaces[refLevel.GetFaceParentFace(face)] : face;
+            faceBaseFaces[face] = baseFace;
+
+            if (((int)levels[baseFace] != level) or refLevel.IsFaceHole(face)) continue;
+
+            ConstIndexArray fVerts = refLevel.GetFaceVertices(face),
+                            fEdges = refLevel.GetFaceEdges(face);
+
+            size_t begin = vertices.size();
+            for (int i = 0; i < fVerts.size(); ++i) {
+                gatherEdgeVertices(*sparseRefiner, level, fEdges[i], fVerts[i], vertices);
+            }
+            mesh->_faceCounts.push_back((int)(vertices.size() - begin));
+            mesh->_faceOffsets.push_back((Index)vertices.size());
+            mesh->_faceBaseFaces.push_back(baseFace);
+            mesh->_faceLevels.push_back((unsigned char)level);
+        }
+        faceBaseFaces.swap(parentBaseFaces);
+    }
+
+    //  Each vertex is replaced by its finest descendant, the refined ones being
+    //  numbered in the order they are first used:
+    std::vector<Index> levelVertexOffsets(maxLevel + 2, 0);
+    for (int level = 0; level <= maxLevel; ++level) {
+        levelVertexOffsets[level + 1] = levelVertexOffsets[level] +
+            sparseRefiner->GetLevel(level).GetNumVertices();
+    }
+    std::vector<Index> vertexIndices(levelVertexOffsets.back(), INDEX_INVALID);
+    for (Index v = 0; v < mesh->_numControlVertices; ++v) {
+        vertexIndices[v] = v;
+    }
+
+    std::vector<Index> refinedVertices;   // refined vertex of each stencil
+
+    mesh->_faceVertices.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        int level = vertices[i].first;
+        Index vertex = vertices[i].second;
+        for ( ; level < maxLevel; ++level) {
+            Index child = sparseRefiner->GetLevel(level).GetVertexChildVertex(vertex);
+            if (not IndexIsValid(child)) break;
+            vertex = child;
+        }
+        Index & index = vertexIndices[levelVertexOffsets[level] + vertex];
+        if (not IndexIsValid(index)) {
+            index = mesh->_numControlVertices + (Index)refinedVertices.size();
+            refinedVertices.push_back(levelVertexOffsets[level] + vertex);
+        }
+        mesh->_faceVertices[i] = index;
+    }
+    mesh->_numVertices = mesh->_numControlVertices + (int)refinedVertices.size();
+
+    //  Stencils of the vertices of all the levels, of which only those of the refined
+    //  vertices of the faces are kept:
+    StencilTableFactory::Options stencilOptions;
+    stencilOptions.generateOffsets = true;
+    stencilOptions.generateControlVerts = false;
+    stencilOptions.generateIntermediateLevels = true;
+    stencilOptions.maxLevel = maxLevel;
+
+    std::vector<int>   sizes;
+    std::vector<Index> indices;
+    std::vector<float> weights;
+
+    if (not refinedVertices.empty()) {
+        StencilTable const * levelStencils =
+            StencilTableFactory::Create(*sparseRefiner, stencilOptions);
+
+        sizes.reserve(refinedVertices.size());
+        for (size_t i = 0; i < refinedVertices.size(); ++i) {
+            //  Stencils start at level 1:
+            Index stencil = refinedVertices[i] - mesh->_numControlVertices;
+
+            int size = levelStencils->GetSizes()[stencil];
+            Index offset = levelStencils->GetOffsets()[stencil];
+
+            sizes.push_back(size);
+            indices.insert(indices.end(), levelStencils->GetControlIndices().begin() + offset,
+                levelStencils->GetControlIndices().begin() + offset + size);
+            weights.insert(weights.end(), levelStencils->GetWeights().begin() + offset,
+                levelStencils->GetWeights().begin() + offset + size);
+        }
+        delete levelStencils;
+    }
+    delete sparseRefiner;
+
+    mesh->_stencils = StencilTableFactory::Create(mesh->_numControlVertices,
+        sizes, indices, weights);
+    return mesh;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,94 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_VARIABLE_LEVEL_MESH_FACTORY_H
+#define OPENSUBDIV3_FAR_VARIABLE_LEVEL_MESH_FACTORY_H
+
+#include "../version.h"
+
+#include "../far/variableLevelMesh.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TopologyRefiner;
+
+/// \brief A specialized factory for VariableLevelMesh
+///
+class VariableLevelMeshFactory {
+
+public:
+
+    /// \brief Computes the level of each base face refining its edges down
+    ///        to a target length
+    ///
+    /// Each refinement halves the edges, so the level of a face is that
+    /// of its longest edge : ceil(log2(length / targetEdgeLength)), clamped
+    /// to [0, maxLevel].
+    ///
+    /// @param refiner           TopologyRefiner of the base mesh
+    ///
+    /// @param positions         Positions of the control vertices (3 floats
+    ///                          per vertex)
+    ///
+    /// @param stride            Number of floats between consecutive positions
+    ///
+    /// @param targetEdgeLength  Length of the refined edges
+    ///
+    /// @param maxLevel          Finest level of the faces
+    ///
+    /// @param levels            Level of each base face
+    ///
+    static void ComputeBaseFaceLevels(TopologyRefiner const & refiner,
+        float const * positions, int stride, float targetEdgeLength,
+            int maxLevel, std::vector<unsigned char> & levels);
+
+    /// \brief Instantiates the VariableLevelMesh of the faces of each base
+    ///        face refined to its own level (schemes Catmark and Loop)
+    ///
+    /// Levels beyond the finest level of sparse refinement (15) are clamped.
+    ///
+    /// @param refiner         TopologyRefiner of the base mesh (its topology is
+    ///                        shared by an instance refined sparsely)
+    ///
+    /// @param baseFaceLevels  Level of each base face
+    ///
+    /// @return                A new instance of VariableLevelMesh (NULL on
+    ///                        failure)
+    ///
+    static VariableLevelMesh const * Create(TopologyRefiner const & refiner,
+        unsigned char const * baseFaceLevels);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif // OPENSUBDIV3_FAR_VARIABLE_LEVEL_MESH_FACTORY_H
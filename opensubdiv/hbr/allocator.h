@@ -59,9 +59,16 @@ public:
 
     void SetMemStatsDecrement(void (*decrement)(size_t bytes)) { m_decrement = decrement; }
 
+    /// Number of objects allocated at once
+    int GetBlockSize() const { return m_blocksize; }
+
+    /// Set the number of objects allocated at once. Only possible while
+    /// no block has been allocated (returns false otherwise)
+    bool SetBlockSize(int blocksize);
+
 private:
     size_t *m_memorystat;
-    const int m_blocksize;
+    int m_blocksize;
     int m_elemsize;
     T** m_blocks;
 
@@ -112,6 +119,14 @@ void HbrAllocator<T>::Clear() {
     m_freelist = NULL;
 }
 
+template <typename T>
+bool
+HbrAllocator<T>::SetBlockSize(int blocksize) {
+    if (m_nblocks || blocksize < 1) return false;
+    m_blocksize = blocksize;
+    return true;
+}
+
 template <typename T>
 T*
 HbrAllocator<T>::Allocate() {
@@ -84,16 +84,18 @@ inline bool operator< (const HbrFacePath& x, const HbrFacePath& y) {
 }
 
 // A simple wrapper around an array of four children. Used to block
-// allocate pointers to children of HbrFace in the common case
+// allocate the IDs of the children of HbrFace in the common case (32-bit
+// IDs rather than pointers halve the size of the blocks)
 template <class T>
 class HbrFaceChildren {
 public:
-    HbrFace<T> *& operator[](const int index) {
-        return children[index];
+    // Returns the ID of the child, or -1 if it was not created
+    int GetChild(const int index) const {
+        return children[index] - 1;
     }
 
-    const HbrFace<T> *& operator[](const int index) const {
-        return children[index];
+    void SetChild(const int index, const int id) {
+        children[index] = id + 1;
     }
     
 
@@ -107,7 +109,9 @@ private:
 
     ~HbrFaceChildren() {}
 
-    HbrFace<T> *children[4];
+    // IDs are stored offset by one, so that a block whose children have
+    // all been cleared holds the null link expected by the allocator
+    int children[4];
 };
 
 template <class T> class HbrFace {
@@ -164,11 +168,14 @@ public:
     HbrFace<T>* GetChild(int index) const {
         int nchildren = mesh->GetSubdivision()->GetFaceChildrenCount(nvertices);
         if (!children.children || index < 0 || index >= nchildren) return 0;
+        int child;
         if (nchildren > 4) {
-            return children.extrachildren[index];
+            child = children.extrachildren[index];
         } else {
-            return (*children.children)[index];
+            child = children.children->GetChild(index);
         }
+        if (child == -1) return 0;
+        return mesh->GetFace(child);
     }
 
     // Subdivide the face into a vertex if needed and return
@@ -280,14 +287,14 @@ public:
             int nchildren = mesh->GetSubdivision()->GetFaceChildrenCount(p->nvertices);
             if (nchildren > 4) {
                 for (int i = 0; i < nchildren; ++i) {
-                    if (p->children.extrachildren[i] == f) {
+                    if (p->children.extrachildren[i] == f->GetID()) {
                         path.remainder.push_back(i);
                         break;
                     }
                 }
             } else {
                 for (int i = 0; i < nchildren; ++i) {
-                    if ((*p->children.children)[i] == f) {
+                    if (p->children.children->GetChild(i) == f->GetID()) {
                         path.remainder.push_back(i);
                         break;
                     }
@@ -341,12 +348,12 @@ private:
     // Edge storage if this face is not a triangle or quad
     char* extraedges;
 
-    // Pointer to children array. If there are four children or less,
-    // we use the HbrFaceChildren pointer, otherwise we use
-    // extrachildren
+    // Pointer to the array of children IDs (-1 for children not created).
+    // If there are four children or less, we use the HbrFaceChildren
+    // pointer, otherwise we use extrachildren
     union {
         HbrFaceChildren<T>* children;
-        HbrFace<T>** extrachildren;
+        int* extrachildren;
     } children;
 
     // Bits used by halfedges to track facevarying sharpnesses
@@ -496,7 +503,7 @@ HbrFace<T>::Initialize(HbrMesh<T>* m, HbrFace<T>* _parent, int childindex, int f
 
         // We also ignore the edge array and allocate extra storage -
         // this simplifies GetNext and GetPrev math in HbrHalfedge
-        const size_t edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+        const size_t edgesize = HbrHalfedge<T>::extraEdgeSize();
         extraedges = (char *) malloc(nv * edgesize);
         for (i = 0; i < nv; ++i) {
             HbrHalfedge<T>* edge = (HbrHalfedge<T>*)(extraedges + i * edgesize);
@@ -536,7 +543,7 @@ HbrFace<T>::Initialize(HbrMesh<T>* m, HbrFace<T>* _parent, int childindex, int f
     size_t edgesize;
     if (nv > 4) {
         edge = (HbrHalfedge<T>*)(extraedges);
-        edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+        edgesize = HbrHalfedge<T>::extraEdgeSize();
     } else {
         edge = edges;
         edgesize = sizeof(HbrHalfedge<T>);
@@ -581,18 +588,18 @@ HbrFace<T>::Destroy() {
             int nchildren = mesh->GetSubdivision()->GetFaceChildrenCount(nvertices);
             if (nchildren > 4) {
                 for (i = 0; i < nchildren; ++i) {
-                    if (children.extrachildren[i]) {
-                        children.extrachildren[i]->parent = -1;
-                        children.extrachildren[i] = 0;
+                    if (children.extrachildren[i] != -1) {
+                        mesh->GetFace(children.extrachildren[i])->parent = -1;
+                        children.extrachildren[i] = -1;
                     }
                 }
                 delete[] children.extrachildren;
                 children.extrachildren = 0;
             } else {
                 for (i = 0; i < nchildren; ++i) {
-                    if ((*children.children)[i]) {
-                        (*children.children)[i]->parent = -1;
-                        (*children.children)[i] = 0;
+                    if (children.children->GetChild(i) != -1) {
+                        mesh->GetFace(children.children->GetChild(i))->parent = -1;
+                        children.children->SetChild(i, -1);
                     }
                 }
                 mesh->DeleteFaceChildren(children.children);
@@ -610,7 +617,7 @@ HbrFace<T>::Destroy() {
         size_t edgesize;
         if (nvertices > 4) {
             edge = (HbrHalfedge<T>*)(extraedges);
-            edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+            edgesize = HbrHalfedge<T>::extraEdgeSize();
         } else {
             edge = edges;
             edgesize = sizeof(HbrHalfedge<T>);
@@ -647,9 +654,9 @@ HbrFace<T>::Destroy() {
             int nchildren = mesh->GetSubdivision()->GetFaceChildrenCount(parentFace->nvertices);
             if (nchildren > 4) {
                 for (i = 0; i < nchildren; ++i) {
-                    if (parentFace->children.extrachildren[i] == this) {
-                        parentFace->children.extrachildren[i] = 0;
-                    } else if (parentFace->children.extrachildren[i]) parentHasOtherKids = true;
+                    if (parentFace->children.extrachildren[i] == id) {
+                        parentFace->children.extrachildren[i] = -1;
+                    } else if (parentFace->children.extrachildren[i] != -1) parentHasOtherKids = true;
                 }
                 // After cleaning the parent's reference to self, the parent
                 // may be able to clean itself up
@@ -662,9 +669,9 @@ HbrFace<T>::Destroy() {
                 }
             } else {
                 for (i = 0; i < nchildren; ++i) {
-                    if ((*parentFace->children.children)[i] == this) {
-                        (*parentFace->children.children)[i] = 0;
-                    } else if ((*parentFace->children.children)[i]) parentHasOtherKids = true;
+                    if (parentFace->children.children->GetChild(i) == id) {
+                        parentFace->children.children->SetChild(i, -1);
+                    } else if (parentFace->children.children->GetChild(i) != -1) parentHasOtherKids = true;
                 }
                 // After cleaning the parent's reference to self, the parent
                 // may be able to clean itself up
@@ -718,7 +725,7 @@ HbrHalfedge<T>*
 HbrFace<T>::GetEdge(int index) const {
     assert(index >= 0 && index < nvertices);
     if (nvertices > 4) {
-        const size_t edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+        const size_t edgesize = HbrHalfedge<T>::extraEdgeSize();
         return (HbrHalfedge<T>*)(extraedges + index * edgesize);
     } else {
         return const_cast<HbrHalfedge<T>*>(edges + index);
@@ -730,7 +737,7 @@ HbrVertex<T>*
 HbrFace<T>::GetVertex(int index) const {
     assert(index >= 0 && index < nvertices);
     if (nvertices > 4) {
-        const size_t edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);        
+        const size_t edgesize = HbrHalfedge<T>::extraEdgeSize();        
         HbrHalfedge<T>* edge = (HbrHalfedge<T>*)(extraedges +
             index * edgesize);
         return mesh->GetVertex(edge->GetOrgVertexID());
@@ -744,7 +751,7 @@ int
 HbrFace<T>::GetVertexID(int index) const {
     assert(index >= 0 && index < nvertices);    
     if (nvertices > 4) {
-        const size_t edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);        
+        const size_t edgesize = HbrHalfedge<T>::extraEdgeSize();        
         HbrHalfedge<T>* edge = (HbrHalfedge<T>*)(extraedges +
             index * edgesize);
         return edge->GetOrgVertexID();
@@ -762,21 +769,21 @@ HbrFace<T>::SetChild(int index, HbrFace<T>* face) {
     if (!children.children) {
         int i;
         if (nchildren > 4) {
-            children.extrachildren = new HbrFace<T>*[nchildren];
+            children.extrachildren = new int[nchildren];
             for (i = 0; i < nchildren; ++i) {
-                children.extrachildren[i] = 0;
+                children.extrachildren[i] = -1;
             }
         } else {
             children.children = mesh->NewFaceChildren();
             for (i = 0; i < nchildren; ++i) {
-                (*children.children)[i] = 0;
+                children.children->SetChild(i, -1);
             }
         }
     }
     if (nchildren > 4) {
-        children.extrachildren[index] = face;
+        children.extrachildren[index] = face->GetID();
     } else {
-        (*children.children)[index] = face;
+        children.children->SetChild(index, face->GetID());
     }
     face->parent = this->id;
 }
@@ -806,13 +813,13 @@ HbrFace<T>::Unrefine() {
         int nchildren = mesh->GetSubdivision()->GetFaceChildrenCount(nvertices);
         if (nchildren > 4) {
             for (int i = 0; i < nchildren; ++i) {
-                if (children.extrachildren[i]) mesh->DeleteFace(children.extrachildren[i]);
+                if (children.extrachildren[i] != -1) mesh->DeleteFace(mesh->GetFace(children.extrachildren[i]));
             }
             delete[] children.extrachildren;
             children.extrachildren = 0;
         } else {
             for (int i = 0; i < nchildren; ++i) {
-                if ((*children.children)[i]) mesh->DeleteFace((*children.children)[i]);
+                if (children.children->GetChild(i) != -1) mesh->DeleteFace(mesh->GetFace(children.children->GetChild(i)));
             }
             mesh->DeleteFaceChildren(children.children);
             children.children = 0;
@@ -846,7 +853,7 @@ HbrFace<T>::MarkUsage() {
     size_t edgesize, eedgesize;
     if (nvertices > 4) {
         e = (HbrHalfedge<T>*)(extraedges);
-        edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+        edgesize = HbrHalfedge<T>::extraEdgeSize();
     } else {
         e = edges;
         edgesize = sizeof(HbrHalfedge<T>);
@@ -861,7 +868,7 @@ HbrFace<T>::MarkUsage() {
             int nv = f->GetNumVertices();
             if (nv > 4) {
                 eee = (HbrHalfedge<T>*)(f->extraedges);
-                eedgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+                eedgesize = HbrHalfedge<T>::extraEdgeSize();
             } else {
                 eee = f->edges;
                 eedgesize = sizeof(HbrHalfedge<T>);
@@ -887,7 +894,7 @@ HbrFace<T>::ClearUsage() {
     size_t edgesize, eedgesize;
     if (nvertices > 4) {
         e = (HbrHalfedge<T>*)(extraedges);
-        edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+        edgesize = HbrHalfedge<T>::extraEdgeSize();
     } else {
         e = edges;
         edgesize = sizeof(HbrHalfedge<T>);
@@ -901,7 +908,7 @@ HbrFace<T>::ClearUsage() {
             int nv = f->GetNumVertices();
             if (nv > 4) {
                 eee = (HbrHalfedge<T>*)(f->extraedges);
-                eedgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+                eedgesize = HbrHalfedge<T>::extraEdgeSize();
             } else {
                 eee = f->edges;
                 eedgesize = sizeof(HbrHalfedge<T>);
@@ -962,7 +969,7 @@ HbrFace<T>::GetSupportingVertices(std::vector<int> &support) {
     size_t edgesize, eedgesize;
     if (nvertices > 4) {
         e = (HbrHalfedge<T>*)(extraedges);
-        edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+        edgesize = HbrHalfedge<T>::extraEdgeSize();
     } else {
         e = edges;
         edgesize = sizeof(HbrHalfedge<T>);
@@ -977,7 +984,7 @@ HbrFace<T>::GetSupportingVertices(std::vector<int> &support) {
             int nv = f->GetNumVertices();
             if (nv > 4) {
                 eee = (HbrHalfedge<T>*)(f->extraedges);
-                eedgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+                eedgesize = HbrHalfedge<T>::extraEdgeSize();
             } else {
                 eee = f->edges;
                 eedgesize = sizeof(HbrHalfedge<T>);
@@ -51,7 +51,7 @@ template <class T> std::ostream& operator<<(std::ostream& out, const HbrHalfedge
 template <class T> class HbrHalfedge {
 
 private:
-    HbrHalfedge(): opposite(0), incidentVertex(-1), vchild(-1), sharpness(0.0f)
+    HbrHalfedge(): oppositeFace(-1), incidentVertex(-1), vchild(-1), sharpness(0.0f)
 #ifdef HBRSTITCH
     , stitchccw(1), raystitchccw(1)
 #endif
@@ -71,15 +71,18 @@ private:
 public:
 
     // Returns the opposite half edge
-    HbrHalfedge<T>* GetOpposite() const { return opposite; }
+    HbrHalfedge<T>* GetOpposite() const {
+        return (oppositeFace == -1) ? 0 :
+            GetMesh()->GetFace(oppositeFace)->GetEdge(oppositeIndex);
+    }
 
     // Sets the opposite half edge
-    void SetOpposite(HbrHalfedge<T>* opposite) { this->opposite = opposite; sharpness = opposite->sharpness; }
+    void SetOpposite(HbrHalfedge<T>* opposite) { setOpposite(opposite); sharpness = opposite->sharpness; }
 
     // Returns the next clockwise halfedge around the incident face
     HbrHalfedge<T>* GetNext() const {
         if (m_index == 4) {
-            const size_t edgesize = sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*);
+            const size_t edgesize = extraEdgeSize();
             if (lastedge) {
                 return (HbrHalfedge<T>*) ((char*) this - (GetFace()->GetNumVertices() - 1) * edgesize);
             } else {
@@ -97,7 +100,7 @@ public:
     // Returns the previous counterclockwise halfedge around the incident face
     HbrHalfedge<T>* GetPrev() const {
         const size_t edgesize = (m_index == 4) ? 
-            (sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*)) :
+            extraEdgeSize() :
             sizeof(HbrHalfedge<T>);
         if (firstedge) {
             return (HbrHalfedge<T>*) ((char*) this + (GetFace()->GetNumVertices() - 1) * edgesize);
@@ -152,7 +155,7 @@ public:
     HbrFace<T>* GetFace() const {
         if (m_index == 4) {
             // Pointer to face is stored after the data for the edge
-            return *(HbrFace<T>**)((char *) this + sizeof(HbrHalfedge<T>));
+            return *(HbrFace<T>**)((char *) this + extraEdgeFaceOffset());
         } else {
             return (HbrFace<T>*) ((char*) this - (m_index) * sizeof(HbrHalfedge<T>) -
                 offsetof(HbrFace<T>, edges));
@@ -163,19 +166,22 @@ public:
     HbrMesh<T>* GetMesh() const { return GetFace()->GetMesh(); }
 
     // Returns the face on the right
-    HbrFace<T>* GetRightFace() const { return opposite ? opposite->GetLeftFace() : NULL; }
+    HbrFace<T>* GetRightFace() const {
+        return (oppositeFace == -1) ? NULL : GetMesh()->GetFace(oppositeFace);
+    }
 
     // Return the face on the left of the halfedge
     HbrFace<T>* GetLeftFace() const { return GetFace(); }
 
     // Returns whether this is a boundary edge
-    bool IsBoundary() const { return opposite == 0; }
+    bool IsBoundary() const { return oppositeFace == -1; }
 
     // Tag the edge as being an infinitely sharp facevarying edge
     void SetFVarInfiniteSharp(int datum, bool infsharp) {
         int intindex = datum >> 4;
         unsigned int bits = infsharp << ((datum & 15) * 2);
         getFVarInfSharp()[intindex] |= bits;
+        HbrHalfedge<T>* opposite = GetOpposite();
         if (opposite) {
             opposite->getFVarInfSharp()[intindex] |= bits;
         }
@@ -211,7 +217,12 @@ public:
     float GetSharpness() const { return sharpness; }
 
     // Sets the sharpness of the edge
-    void SetSharpness(float sharp) { sharpness = sharp; if (opposite) opposite->sharpness = sharp; ClearMask(); }
+    void SetSharpness(float sharp) {
+        sharpness = sharp;
+        HbrHalfedge<T>* opposite = GetOpposite();
+        if (opposite) opposite->sharpness = sharp;
+        ClearMask();
+    }
 
     // Returns whether the edge is sharp at the current level of
     // subdivision (next = false) or at the next level of subdivision
@@ -244,6 +255,7 @@ public:
 #ifdef HBRSTITCH
     StitchEdge* GetStitchEdge(int i) {
         StitchEdge **stitchEdge = getStitchEdges();
+        HbrHalfedge<T>* opposite = GetOpposite();
         // If the stitch edge exists, the ownership is transferred to
         // the caller. Make sure the opposite edge loses ownership as
         // well.
@@ -267,7 +279,7 @@ public:
     // If stitch edge exists, and this edge has no opposite, destroy
     // it
     void DestroyStitchEdges(int stitchcount) {
-        if (!opposite) {
+        if (IsBoundary()) {
             StitchEdge **stitchEdge = getStitchEdges();
             for (int i = 0; i < stitchcount; ++i) {
                 if (stitchEdge[i]) {
@@ -290,6 +302,8 @@ public:
         HbrHalfedge<T>* eb = Subdivide()->GetEdge(GetDestVertex()->Subdivide());
         StitchEdge **ease = ea->getStitchEdges();
         StitchEdge **ebse = eb->getStitchEdges();
+        HbrHalfedge<T>* eaopposite = ea->GetOpposite();
+        HbrHalfedge<T>* ebopposite = eb->GetOpposite();
         if (i >= 2) { // ray tracing stitches
             if (!raystitchccw) {
                 StitchSplitEdge(se, &ease[i], &ebse[i], false, 0, 0, 0);
@@ -297,13 +311,13 @@ public:
                 StitchSplitEdge(se, &ebse[i], &ease[i], true, 0, 0, 0);
             }
             ea->raystitchccw = eb->raystitchccw = raystitchccw;
-            if (eb->opposite) {
-                eb->opposite->getStitchEdges()[i] = ebse[i];
-                eb->opposite->raystitchccw = raystitchccw;
+            if (ebopposite) {
+                ebopposite->getStitchEdges()[i] = ebse[i];
+                ebopposite->raystitchccw = raystitchccw;
             }
-            if (ea->opposite) {
-                ea->opposite->getStitchEdges()[i] = ease[i];
-                ea->opposite->raystitchccw = raystitchccw;
+            if (eaopposite) {
+                eaopposite->getStitchEdges()[i] = ease[i];
+                eaopposite->raystitchccw = raystitchccw;
             }
         } else {
             if (!stitchccw) {
@@ -312,13 +326,13 @@ public:
                 StitchSplitEdge(se, &ebse[i], &ease[i], true, 0, 0, 0);
             }
             ea->stitchccw = eb->stitchccw = stitchccw;
-            if (eb->opposite) {
-                eb->opposite->getStitchEdges()[i] = ebse[i];
-                eb->opposite->stitchccw = stitchccw;
+            if (ebopposite) {
+                ebopposite->getStitchEdges()[i] = ebse[i];
+                ebopposite->stitchccw = stitchccw;
             }
-            if (ea->opposite) {
-                ea->opposite->getStitchEdges()[i] = ease[i];
-                ea->opposite->stitchccw = stitchccw;
+            if (eaopposite) {
+                eaopposite->getStitchEdges()[i] = ease[i];
+                eaopposite->stitchccw = stitchccw;
             }
         }
     }
@@ -330,6 +344,7 @@ public:
     void SetStitchEdge(int i, StitchEdge* edge) {
         StitchEdge **stitchEdges = getStitchEdges();
         stitchEdges[i] = edge;
+        HbrHalfedge<T>* opposite = GetOpposite();
         if (opposite) {
             opposite->getStitchEdges()[i] = edge;
         }
@@ -338,6 +353,7 @@ public:
     void SetRayStitchEdge(int i, StitchEdge* edge) {
         StitchEdge **stitchEdges = getStitchEdges();
         stitchEdges[i+2] = edge;
+        HbrHalfedge<T>* opposite = GetOpposite();
         if (opposite) {
             opposite->getStitchEdges()[i+2] = edge;
         }
@@ -351,6 +367,7 @@ public:
     void SetStitchData(void* data) {
         GetMesh()->SetStitchData(this, data);
         stitchdatavalid = data ? 1 : 0;
+        HbrHalfedge<T>* opposite = GetOpposite();
         if (opposite) {
             opposite->GetMesh()->SetStitchData(opposite, data);
             opposite->stitchdatavalid = stitchdatavalid;
@@ -360,6 +377,7 @@ public:
     bool GetStitchCCW(bool raytraced) const { return raytraced ? raystitchccw : stitchccw; }
 
     void ClearStitchCCW(bool raytraced) {
+        HbrHalfedge<T>* opposite = GetOpposite();
         if (raytraced) {
             raystitchccw = 0;
             if (opposite) opposite->raystitchccw = 0;
@@ -370,6 +388,7 @@ public:
     }
 
     void ToggleStitchCCW(bool raytraced) {
+        HbrHalfedge<T>* opposite = GetOpposite();
         if (raytraced) {
             raystitchccw = 1 - raystitchccw;
             if (opposite) opposite->raystitchccw = raystitchccw;
@@ -390,7 +409,11 @@ public:
     friend class HbrFace<T>;
 
 private:
-    HbrHalfedge<T>* opposite;
+    // Opposite halfedge, as the ID of its face (-1 if none) and its index
+    // in that face (see oppositeIndex). IDs rather than a pointer keep the
+    // halfedges embedded in the faces compact.
+    int oppositeFace;
+
     // Index of incident vertex
     int incidentVertex;
 
@@ -414,6 +437,34 @@ private:
     // is. See getIndex()
     unsigned short m_index:3;
 
+    // Index of the opposite halfedge in its face (faces of more than
+    // 65536 vertices are not supported)
+    unsigned short oppositeIndex;
+
+    // Sets the opposite halfedge, or clears it if null
+    void setOpposite(HbrHalfedge<T>* edge) {
+        if (edge) {
+            assert(edge->getIndex() <= 0xffff);
+            oppositeFace = edge->GetFace()->GetID();
+            oppositeIndex = (unsigned short) edge->getIndex();
+        } else {
+            oppositeFace = -1;
+            oppositeIndex = 0;
+        }
+    }
+
+    // The halfedges of faces of more than four vertices are allocated in
+    // the extraedges array of the face, each followed by a pointer to
+    // the face (at an offset aligned for it)
+    static size_t extraEdgeFaceOffset() {
+        return (sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*) - 1) /
+            sizeof(HbrFace<T>*) * sizeof(HbrFace<T>*);
+    }
+
+    static size_t extraEdgeSize() {
+        return extraEdgeFaceOffset() + sizeof(HbrFace<T>*);
+    }
+
     // Returns the index of the edge relative to its incident face.
     // This relies on knowledge of the face's edge allocation pattern
     int getIndex() const {
@@ -423,9 +474,9 @@ private:
             // We allocate room for up to 4 values (to handle tri or
             // quad) in the edges array.  If there are more than that,
             // they _all_ go in the faces' extraedges array.
-            HbrFace<T>* incidentFace = *(HbrFace<T>**)((char *) this + sizeof(HbrHalfedge<T>));
+            HbrFace<T>* incidentFace = *(HbrFace<T>**)((char *) this + extraEdgeFaceOffset());
             return int(((char *) this - incidentFace->extraedges) /
-                (sizeof(HbrHalfedge<T>) + sizeof(HbrFace<T>*)));
+                extraEdgeSize());
         }
     }
 
@@ -494,10 +545,10 @@ HbrHalfedge<T>::Initialize(HbrHalfedge<T>* opposite, int index, HbrVertex<T>* or
         // Assumes upstream allocation ensured we have extra storage
         // for pointer to face after the halfedge data structure
         // itself
-        *(HbrFace<T>**)((char *) this + sizeof(HbrHalfedge<T>)) = face;
+        *(HbrFace<T>**)((char *) this + extraEdgeFaceOffset()) = face;
     }
     
-    this->opposite = opposite;
+    setOpposite(opposite);
     incidentVertex = origin->GetID();
     lastedge = (index == face->GetNumVertices() - 1);
     firstedge = (index == 0);
@@ -549,8 +600,9 @@ HbrHalfedge<T>::~HbrHalfedge() {
 template <class T>
 void
 HbrHalfedge<T>::Clear() {
+    HbrHalfedge<T>* opposite = GetOpposite();
     if (opposite) {
-        opposite->opposite = 0;
+        opposite->setOpposite(0);
         if (vchild != -1) {
             // Transfer ownership of the vchild to the opposite ptr
             opposite->vchild = vchild;
@@ -561,7 +613,7 @@ HbrHalfedge<T>::Clear() {
             vchildVert->SetParent(opposite);
             vchild = -1;
         }
-        opposite = 0;
+        setOpposite(0);
     }
     // Orphan the child vertex
     else if (vchild != -1) {
@@ -578,6 +630,7 @@ HbrHalfedge<T>::Subdivide() {
     if (vchild != -1) return mesh->GetVertex(vchild);
     // Make sure that our opposite doesn't "own" a subdivided vertex
     // already. If it does, use that
+    HbrHalfedge<T>* opposite = GetOpposite();
     if (opposite && opposite->vchild != -1) return mesh->GetVertex(opposite->vchild);
     HbrVertex<T>* vchildVert = mesh->GetSubdivision()->Subdivide(mesh, this);
     vchild = vchildVert->GetID();
@@ -609,6 +662,7 @@ HbrHalfedge<T>::GetFVarInfiniteSharp(int datum) {
         assert (bits != 2);
         return bits ? true : false;
     }
+    HbrHalfedge<T>* opposite = GetOpposite();
 
     // If there is no face varying data it can't be infinitely sharp!
     const int fvarwidth = GetMesh()->GetTotalFVarWidth();
@@ -55,6 +55,11 @@ namespace OPENSUBDIV_VERSION {
 template <class T> class HbrSubdivision;
 template <class T> class HbrHalfedge;
 
+// The faces of a mesh are refined from a single thread: refining a face
+// also creates the children of the components it shares with its
+// neighbors, and numbers all of them in the order they are created.
+// Distinct meshes (each with its own allocators and its own subdivision
+// scheme, whose state is set per mesh) may be refined in parallel threads.
 template <class T> class HbrMesh {
 public:
     HbrMesh(HbrSubdivision<T>* subdivision = 0, int fvarcount = 0, const int *fvarindices = 0, const int *fvarwidths = 0, int totalfvarwidth = 0
@@ -224,6 +229,22 @@ public:
         s_memStatsDecrement = decrement;
     }
 
+    // Set the number of faces, vertices and face children blocks
+    // allocated at once by the allocators of the mesh (512 by
+    // default). Allocators are owned by each mesh and are not
+    // locked: larger blocks mostly reduce the allocations from the
+    // heap shared by meshes built in parallel. Only possible before
+    // any face or vertex is created (returns false otherwise)
+    bool SetAllocatorBlockSizes(int faceBlockSize, int vertexBlockSize, int faceChildrenBlockSize) {
+        if (nfaces || nvertices ||
+            faceBlockSize < 1 || vertexBlockSize < 1 || faceChildrenBlockSize < 1) {
+            return false;
+        }
+        return m_faceAllocator.SetBlockSize(faceBlockSize) &&
+               m_vertexAllocator.SetBlockSize(vertexBlockSize) &&
+               m_faceChildrenAllocator.SetBlockSize(faceChildrenBlockSize);
+    }
+
     // Add a vertex to consider for garbage collection. All
     // neighboring faces of that vertex will be examined to see if
     // they can be deleted
@@ -632,8 +653,9 @@ HbrMesh<T>::NewFace(int nv, const int *vtx, int uindex) {
     } else {
         f = m_faceAllocator.Allocate();
     }
-    f->Initialize(this, NULL, -1, maxFaceID, uindex, nv, facevertices, totalfvarwidth, 0);
+    // Register the face first: its halfedges find their opposites by ID
     faces[maxFaceID] = f;
+    f->Initialize(this, NULL, -1, maxFaceID, uindex, nv, facevertices, totalfvarwidth, 0);
     maxFaceID++;
     // Update the maximum encountered uniform index
     if (uindex > maxUniformIndex) maxUniformIndex = uindex;
@@ -667,11 +689,12 @@ HbrMesh<T>::NewFace(int nv, HbrVertex<T> **vtx, HbrFace<T>* parent, int childind
     } else {
         f = m_faceAllocator.Allocate();
     }
+    // Register the face first: its halfedges find their opposites by ID
+    faces[maxFaceID] = f;
     f->Initialize(this, parent, childindex, maxFaceID, parent ? parent->GetUniformIndex() : 0, nv, vtx, totalfvarwidth, parent ? parent->GetDepth() + 1 : 0);
     if (parent) {
         f->SetPtexIndex(parent->GetPtexIndex());
     }
-    faces[maxFaceID] = f;
     maxFaceID++;
 
     // If mesh is in transient mode, add face to transient list
@@ -758,8 +781,8 @@ HbrMesh<T>::DeleteFace(HbrFace<T>* face) {
     if (face->GetID() < nfaces) {
         HbrFace<T>* f = faces[face->GetID()];
         if (f == face) {
-            faces[face->GetID()] = 0;
             face->Destroy();
+            faces[face->GetID()] = 0;
             m_faceAllocator.Deallocate(face);
         }
     }
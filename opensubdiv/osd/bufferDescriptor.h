@@ -41,7 +41,12 @@ namespace Osd {
 ///        batching offset if the data buffer is combined across multiple
 ///        objects together.
 ///
-///        * Note that each element has the same data type (float)
+///        * Note that each element has the same data type (float), with
+///          the exception of the destination buffers of the CPU stencil
+///          evaluation (see ElementType)
+///
+///        * Buffers of separate components (all X, then all Y...) are
+///          described by a plane stride (see planeStride)
 ///
 
 //  example:
@@ -58,13 +63,48 @@ namespace Osd {
 //     - uTangent (offset = n+7,  length = 3, stride = 13)
 //     - vTangent (offset = n+10, length = 3, stride = 13)
 //
+//  planar example (N vertices):
+//       n
+//  -----+--------------+--------------+--------------+----------------------
+//       | X0 X1 .. XN-1| Y0 Y1 .. YN-1| Z0 Z1 .. ZN-1|
+//  -----+--------------+--------------+--------------+----------------------
+//       <-- plane --->
+//
+//     - XYZ      (offset = n, length = 3, stride = 1, planeStride = N)
+//
 struct BufferDescriptor {
 
+    /// \brief Type of the elements of a destination buffer
+    ///
+    /// Stencils are accumulated in floats, and converted when stored to
+    /// destinations of other types (e.g. vertex attributes of compact GPU
+    /// vertex formats), saving a separate pass over the refined vertices.
+    /// The offset and stride of the descriptor are then counted in elements
+    /// of that type, from the start of the buffer.
+    ///
+    /// \note Only the stencil evaluation of Osd::CpuEvaluator (with or without
+    ///       first derivatives) supports types other than TYPE_FLOAT : other
+    ///       evaluations return false for such destinations.
+    ///
+    enum ElementType {
+        TYPE_FLOAT = 0,   ///< 32 bit floats
+        TYPE_HALF_FLOAT,  ///< 16 bit floats (rounded to nearest even)
+        TYPE_UNORM8       ///< 8 bit unsigned normalized : [0, 1] to [0, 255]
+    };
+
     /// Default Constructor
-    BufferDescriptor() : offset(0), length(0), stride(0) { }
+    BufferDescriptor() : offset(0), length(0), stride(0),
+        elementType(TYPE_FLOAT), planeStride(0) { }
 
     /// Constructor
-    BufferDescriptor(int o, int l, int s) : offset(o), length(l), stride(s) { }
+    BufferDescriptor(int o, int l, int s, ElementType t = TYPE_FLOAT,
+                     int p = 0) :
+        offset(o), length(l), stride(s), elementType(t), planeStride(p) { }
+
+    /// True if the components of the elements are stored in separate planes
+    bool IsPlanar() const {
+        return planeStride > 0;
+    }
 
     /// Returns the relative offset within a stride
     int GetLocalOffset() const {
@@ -73,20 +113,26 @@ struct BufferDescriptor {
 
     /// True if the descriptor values are internally consistent
     bool IsValid() const {
+        if (IsPlanar()) {
+            return ((length > 0) && (stride > 0));
+        }
         return ((length > 0) &&
                 (length <= stride - GetLocalOffset()));
     }
 
     /// Resets the descriptor to default
     void Reset() {
-        offset = length = stride = 0;
+        offset = length = stride = planeStride = 0;
+        elementType = TYPE_FLOAT;
     }
 
     /// True if the descriptors are identical
     bool operator == (BufferDescriptor const &other) const {
         return (offset == other.offset and
                 length == other.length and
-                stride == other.stride);
+                stride == other.stride and
+                elementType == other.elementType and
+                planeStride == other.planeStride);
     }
 
     /// True if the descriptors are not identical
@@ -100,6 +146,16 @@ struct BufferDescriptor {
     int length;
     /// stride to the next element
     int stride;
+    /// type of the elements
+    ElementType elementType;
+    /// distance between the planes of the components, or 0 for interleaved
+    /// components. The stride is then the distance between the elements of
+    /// a plane (typically 1).
+    ///
+    /// \note Only the stencil evaluation of the Cpu, Omp and Tbb evaluators
+    ///       (with or without first derivatives) supports planar buffers
+    ///       (of floats) : other evaluations return false for them.
+    int planeStride;
 };
 
 } // end namespace Osd
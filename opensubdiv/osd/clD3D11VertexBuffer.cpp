@@ -35,6 +35,7 @@
 #endif
 
 #include "../far/error.h"
+#include "../far/profile.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -127,6 +128,8 @@ void
 CLD3D11VertexBuffer::UpdateData(const float *src, int startVertex,
                                 int numVertices, cl_command_queue queue) {
 
+    OPENSUBDIV_PROFILE_ZONE("CLD3D11VertexBuffer::UpdateData");
+
     size_t size = numVertices * _numElements * sizeof(float);
     size_t offset = startVertex * _numElements * sizeof(float);
 
@@ -0,0 +1,96 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/clDisplacementTexture.h"
+
+#include "../far/error.h"
+#include "../osd/opencl.h"
+#include "../osd/cpuDisplacementTexture.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CLDisplacementTexture::CLDisplacementTexture() :
+    _numFaces(0), _numChannels(0), _faceBuffer(NULL), _texelBuffer(NULL) {
+}
+
+CLDisplacementTexture::~CLDisplacementTexture() {
+    if (_faceBuffer) clReleaseMemObject(_faceBuffer);
+    if (_texelBuffer) clReleaseMemObject(_texelBuffer);
+}
+
+CLDisplacementTexture *
+CLDisplacementTexture::Create(int numFaces, const int *faceResolutions,
+                              int numChannels, const float *texels,
+                              cl_context clContext) {
+    if (numChannels != 1 && numChannels != 3) return 0;
+
+    CLDisplacementTexture *instance = new CLDisplacementTexture();
+    if (instance->allocate(numFaces, faceResolutions, numChannels, texels,
+                           clContext)) {
+        return instance;
+    }
+    delete instance;
+    return 0;
+}
+
+bool
+CLDisplacementTexture::allocate(int numFaces, const int *faceResolutions,
+                                int numChannels, const float *texels,
+                                cl_context clContext) {
+    CpuDisplacementTexture texture(numFaces, faceResolutions,
+                                   numChannels, texels);
+
+    _numFaces = texture.GetNumFaces();
+    _numChannels = numChannels;
+    if (_numFaces == 0) return true;
+
+    cl_int err = 0;
+    _faceBuffer = clCreateBuffer(clContext,
+                                 CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR,
+                                 3 * _numFaces * sizeof(int),
+                                 (void*)texture.GetFaceBuffer(),
+                                 &err);
+    if (err != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+        return false;
+    }
+    _texelBuffer = clCreateBuffer(clContext,
+                                  CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR,
+                                  texture.GetTexelBufferSize() * sizeof(float),
+                                  (void*)texture.GetTexelBuffer(),
+                                  &err);
+    if (err != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+        return false;
+    }
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
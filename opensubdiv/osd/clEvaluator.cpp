@@ -24,14 +24,18 @@
 
 #include "../osd/clEvaluator.h"
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <cstdio>
 
+#include "../osd/clDisplacementTexture.h"
 #include "../osd/opencl.h"
+#include "../osd/programCache.h"
 #include "../far/error.h"
 #include "../far/stencilTable.h"
+#include "../far/profile.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -44,9 +48,37 @@ static const char *clSource =
 
 // ----------------------------------------------------------------------------
 
+// Arrays larger than a chunk are written a chunk at a time when a command
+// queue is given : CL_MEM_COPY_HOST_PTR may have the implementation stage a
+// host copy of the whole array, doubling the memory of large tables.
+static const size_t UPLOAD_CHUNK_SIZE = 16 << 20;
+
 template <class T> cl_mem
-createCLBuffer(std::vector<T> const & src, cl_context clContext) {
+createCLBuffer(std::vector<T> const & src, cl_context clContext,
+               cl_command_queue clCommandQueue = NULL) {
     cl_int errNum = 0;
+
+    size_t size = src.size()*sizeof(T);
+    if (clCommandQueue && size > UPLOAD_CHUNK_SIZE) {
+        cl_mem devicePtr = clCreateBuffer(clContext, CL_MEM_READ_WRITE,
+                                          size, NULL, &errNum);
+        const char *ptr = reinterpret_cast<const char *>(&src.at(0));
+        for (size_t offset = 0; errNum == CL_SUCCESS && offset < size;
+             offset += UPLOAD_CHUNK_SIZE) {
+            size_t chunk = std::min(UPLOAD_CHUNK_SIZE, size - offset);
+            errNum = clEnqueueWriteBuffer(clCommandQueue, devicePtr, CL_TRUE,
+                                          offset, chunk, ptr + offset,
+                                          0, NULL, NULL);
+        }
+        if (errNum != CL_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR, "clEnqueueWriteBuffer: %d",
+                       errNum);
+            if (devicePtr) clReleaseMemObject(devicePtr);
+            return NULL;
+        }
+        return devicePtr;
+    }
+
     cl_mem devicePtr = clCreateBuffer(clContext,
                                       CL_MEM_READ_WRITE|CL_MEM_COPY_HOST_PTR,
                                       src.size()*sizeof(T),
@@ -63,16 +95,21 @@ createCLBuffer(std::vector<T> const & src, cl_context clContext) {
 // ----------------------------------------------------------------------------
 
 CLStencilTable::CLStencilTable(Far::StencilTable const *stencilTable,
-                               cl_context clContext) {
+                               cl_context clContext,
+                               cl_command_queue clCommandQueue) {
     _numStencils = stencilTable->GetNumStencils();
 
     if (_numStencils > 0) {
-        _sizes   = createCLBuffer(stencilTable->GetSizes(), clContext);
-        _offsets = createCLBuffer(stencilTable->GetOffsets(), clContext);
+        _sizes   = createCLBuffer(stencilTable->GetSizes(),
+                                  clContext, clCommandQueue);
+        _offsets = createCLBuffer(stencilTable->GetOffsets(),
+                                  clContext, clCommandQueue);
         _indices = createCLBuffer(stencilTable->GetControlIndices(),
-                                  clContext);
-        _weights = createCLBuffer(stencilTable->GetWeights(), clContext);
+                                  clContext, clCommandQueue);
+        _weights = createCLBuffer(stencilTable->GetWeights(),
+                                  clContext, clCommandQueue);
         _duWeights = _dvWeights = NULL;
+        _passOffsets = stencilTable->GetPassOffsets();
     } else {
         _sizes = _offsets = _indices = _weights = NULL;
         _duWeights = _dvWeights = NULL;
@@ -80,25 +117,49 @@ CLStencilTable::CLStencilTable(Far::StencilTable const *stencilTable,
 }
 
 CLStencilTable::CLStencilTable(Far::LimitStencilTable const *limitStencilTable,
-                               cl_context clContext) {
+                               cl_context clContext,
+                               cl_command_queue clCommandQueue) {
     _numStencils = limitStencilTable->GetNumStencils();
 
     if (_numStencils > 0) {
-        _sizes   = createCLBuffer(limitStencilTable->GetSizes(), clContext);
-        _offsets = createCLBuffer(limitStencilTable->GetOffsets(), clContext);
+        _sizes   = createCLBuffer(limitStencilTable->GetSizes(),
+                                  clContext, clCommandQueue);
+        _offsets = createCLBuffer(limitStencilTable->GetOffsets(),
+                                  clContext, clCommandQueue);
         _indices = createCLBuffer(limitStencilTable->GetControlIndices(),
-                                  clContext);
-        _weights = createCLBuffer(limitStencilTable->GetWeights(), clContext);
+                                  clContext, clCommandQueue);
+        _weights = createCLBuffer(limitStencilTable->GetWeights(),
+                                  clContext, clCommandQueue);
         _duWeights = createCLBuffer(
-            limitStencilTable->GetDuWeights(), clContext);
+            limitStencilTable->GetDuWeights(), clContext, clCommandQueue);
         _dvWeights = createCLBuffer(
-            limitStencilTable->GetDvWeights(), clContext);
+            limitStencilTable->GetDvWeights(), clContext, clCommandQueue);
     } else {
         _sizes = _offsets = _indices = _weights = NULL;
         _duWeights = _dvWeights = NULL;
     }
 }
 
+CLStencilTable *
+CLStencilTable::CreateAndRelease(Far::StencilTable *stencilTable,
+                                 cl_context clContext,
+                                 cl_command_queue clCommandQueue) {
+    CLStencilTable *table =
+        new CLStencilTable(stencilTable, clContext, clCommandQueue);
+    stencilTable->Clear();
+    return table;
+}
+
+CLStencilTable *
+CLStencilTable::CreateAndRelease(Far::LimitStencilTable *limitStencilTable,
+                                 cl_context clContext,
+                                 cl_command_queue clCommandQueue) {
+    CLStencilTable *table =
+        new CLStencilTable(limitStencilTable, clContext, clCommandQueue);
+    limitStencilTable->Clear();
+    return table;
+}
+
 CLStencilTable::~CLStencilTable() {
     if (_sizes)   clReleaseMemObject(_sizes);
     if (_offsets) clReleaseMemObject(_offsets);
@@ -113,16 +174,87 @@ CLStencilTable::~CLStencilTable() {
 CLEvaluator::CLEvaluator(cl_context context, cl_command_queue queue)
     : _clContext(context), _clCommandQueue(queue),
       _program(NULL), _stencilKernel(NULL), _stencilDerivKernel(NULL),
-      _patchKernel(NULL) {
+      _stencilBatchKernel(NULL), _patchKernel(NULL),
+      _findPatchesKernel(NULL), _advectPatchesKernel(NULL),
+      _blendKeyframesKernel(NULL) {
 }
 
 CLEvaluator::~CLEvaluator() {
     if (_stencilKernel) clReleaseKernel(_stencilKernel);
     if (_stencilDerivKernel) clReleaseKernel(_stencilDerivKernel);
+    if (_stencilBatchKernel) clReleaseKernel(_stencilBatchKernel);
     if (_patchKernel) clReleaseKernel(_patchKernel);
+    if (_findPatchesKernel) clReleaseKernel(_findPatchesKernel);
+    if (_advectPatchesKernel) clReleaseKernel(_advectPatchesKernel);
+    if (_blendKeyframesKernel) clReleaseKernel(_blendKeyframesKernel);
     if (_program) clReleaseProgram(_program);
 }
 
+// Program binaries are specific to the device and the driver, which are part
+// of the key of the binary of a program in the ProgramCache
+static std::string
+getProgramCacheKey(cl_device_id device, const char * const *sources,
+                   int numSources) {
+    std::string key;
+    cl_device_info names[3] = { CL_DEVICE_VENDOR, CL_DEVICE_NAME,
+                                CL_DRIVER_VERSION };
+    for (int i = 0; i < 3; ++i) {
+        char str[1024] = "";
+        clGetDeviceInfo(device, names[i], sizeof(str), str, NULL);
+        key += str;
+        key += "\n";
+    }
+    for (int i = 0; i < numSources; ++i) {
+        key += sources[i];
+    }
+    return key;
+}
+
+static cl_program
+loadProgramBinary(cl_context clContext, cl_device_id device,
+                  std::string const &cacheKey) {
+
+    std::vector<char> binary;
+    if (!ProgramCache::Load(cacheKey, binary)) return NULL;
+
+    size_t size = binary.size();
+    const unsigned char *data = (const unsigned char *)&binary[0];
+
+    cl_int binaryStatus = CL_SUCCESS, errNum = CL_SUCCESS;
+    cl_program program = clCreateProgramWithBinary(
+        clContext, 1, &device, &size, &data, &binaryStatus, &errNum);
+    if (errNum != CL_SUCCESS || binaryStatus != CL_SUCCESS) {
+        if (program) clReleaseProgram(program);
+        return NULL;
+    }
+
+    // binaries of other drivers or devices are rejected
+    if (clBuildProgram(program, 1, &device, NULL, NULL, NULL) != CL_SUCCESS) {
+        clReleaseProgram(program);
+        return NULL;
+    }
+    return program;
+}
+
+static void
+storeProgramBinary(cl_program program, std::string const &cacheKey) {
+
+    size_t size = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                         sizeof(size_t), &size, NULL) != CL_SUCCESS ||
+        size == 0) {
+        return;
+    }
+
+    std::vector<unsigned char> binary(size);
+    unsigned char *data = &binary[0];
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES,
+                         sizeof(unsigned char *), &data, NULL) != CL_SUCCESS) {
+        return;
+    }
+    ProgramCache::Store(cacheKey, data, size);
+}
+
 bool
 CLEvaluator::Compile(BufferDescriptor const &srcDesc,
                      BufferDescriptor const &dstDesc,
@@ -144,35 +276,58 @@ CLEvaluator::Compile(BufferDescriptor const &srcDesc,
     std::string defineStr = defines.str();
 
     const char *sources[] = { defineStr.c_str(), clSource };
-    _program = clCreateProgramWithSource(_clContext, 2, sources, 0, &errNum);
-    if (errNum != CL_SUCCESS) {
-        Far::Error(Far::FAR_RUNTIME_ERROR,
-                   "clCreateProgramWithSource (%d)", errNum);
+
+    // programs built by previous processes are created from their binaries
+    // (contexts of a single device only)
+    cl_device_id device = NULL;
+    std::string cacheKey;
+    if (ProgramCache::IsEnabled()) {
+        cl_uint numDevices = 0;
+        clGetContextInfo(_clContext, CL_CONTEXT_NUM_DEVICES,
+                         sizeof(cl_uint), &numDevices, NULL);
+        if (numDevices == 1) {
+            clGetContextInfo(_clContext, CL_CONTEXT_DEVICES,
+                             sizeof(cl_device_id), &device, NULL);
+            cacheKey = getProgramCacheKey(device, sources, 2);
+            _program = loadProgramBinary(_clContext, device, cacheKey);
+        }
     }
 
-    errNum = clBuildProgram(_program, 0, NULL, NULL, NULL, NULL);
-    if (errNum != CL_SUCCESS) {
-        Far::Error(Far::FAR_RUNTIME_ERROR, "clBuildProgram (%d) \n", errNum);
-
-        cl_int numDevices = 0;
-        clGetContextInfo(
-            _clContext, CL_CONTEXT_NUM_DEVICES,
-            sizeof(cl_uint), &numDevices, NULL);
-
-        cl_device_id *devices = new cl_device_id[numDevices];
-        clGetContextInfo(_clContext, CL_CONTEXT_DEVICES,
-                         sizeof(cl_device_id)*numDevices, devices, NULL);
-
-        for (int i = 0; i < numDevices; ++i) {
-            char cBuildLog[10240];
-            clGetProgramBuildInfo(
-                _program, devices[i],
-                CL_PROGRAM_BUILD_LOG, sizeof(cBuildLog), cBuildLog, NULL);
-            Far::Error(Far::FAR_RUNTIME_ERROR, cBuildLog);
+    if (_program == NULL) {
+        _program = clCreateProgramWithSource(_clContext, 2, sources, 0, &errNum);
+        if (errNum != CL_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "clCreateProgramWithSource (%d)", errNum);
         }
-        delete[] devices;
 
-        return false;
+        errNum = clBuildProgram(_program, 0, NULL, NULL, NULL, NULL);
+        if (errNum != CL_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR, "clBuildProgram (%d) \n", errNum);
+
+            cl_int numDevices = 0;
+            clGetContextInfo(
+                _clContext, CL_CONTEXT_NUM_DEVICES,
+                sizeof(cl_uint), &numDevices, NULL);
+
+            cl_device_id *devices = new cl_device_id[numDevices];
+            clGetContextInfo(_clContext, CL_CONTEXT_DEVICES,
+                             sizeof(cl_device_id)*numDevices, devices, NULL);
+
+            for (int i = 0; i < numDevices; ++i) {
+                char cBuildLog[10240];
+                clGetProgramBuildInfo(
+                    _program, devices[i],
+                    CL_PROGRAM_BUILD_LOG, sizeof(cBuildLog), cBuildLog, NULL);
+                Far::Error(Far::FAR_RUNTIME_ERROR, cBuildLog);
+            }
+            delete[] devices;
+
+            return false;
+        }
+
+        if (device) {
+            storeProgramBinary(_program, cacheKey);
+        }
     }
 
     _stencilKernel = clCreateKernel(_program, "computeStencils", &errNum);
@@ -188,8 +343,36 @@ CLEvaluator::Compile(BufferDescriptor const &srcDesc,
         return false;
     }
 
+    _stencilBatchKernel = clCreateKernel(_program,
+                                         "computeStencilsBatch", &errNum);
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "buildKernel (%d)\n", errNum);
+        return false;
+    }
+
     _patchKernel = clCreateKernel(_program, "computePatches", &errNum);
 
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "buildKernel (%d)\n", errNum);
+        return false;
+    }
+
+    _findPatchesKernel = clCreateKernel(_program, "findPatchCoords", &errNum);
+
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "buildKernel (%d)\n", errNum);
+        return false;
+    }
+
+    _advectPatchesKernel = clCreateKernel(_program, "advectPatchCoords", &errNum);
+
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "buildKernel (%d)\n", errNum);
+        return false;
+    }
+
+    _blendKeyframesKernel = clCreateKernel(_program, "blendKeyframes", &errNum);
+
     if (errNum != CL_SUCCESS) {
         Far::Error(Far::FAR_RUNTIME_ERROR, "buildKernel (%d)\n", errNum);
         return false;
@@ -208,6 +391,8 @@ CLEvaluator::EvalStencils(cl_mem src, BufferDescriptor const &srcDesc,
                           unsigned int numStartEvents,
                           const cl_event* startEvents,
                           cl_event* endEvent) const {
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalStencils");
+
     if (end <= start) return true;
 
     size_t globalWorkSize = (size_t)(end - start);
@@ -240,6 +425,64 @@ CLEvaluator::EvalStencils(cl_mem src, BufferDescriptor const &srcDesc,
     return true;
 }
 
+bool
+CLEvaluator::EvalStencilsBatch(cl_mem src, BufferDescriptor const &srcDesc,
+                               cl_mem dst, BufferDescriptor const &dstDesc,
+                               cl_mem sizes,
+                               cl_mem offsets,
+                               cl_mem indices,
+                               cl_mem weights,
+                               int start, int end,
+                               int numInstances,
+                               const int * instanceOffsets,
+                               unsigned int numStartEvents,
+                               const cl_event* startEvents,
+                               cl_event* endEvent) const {
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalStencilsBatch");
+
+    if (end <= start or numInstances <= 0) return true;
+
+    std::vector<int> hostOffsets(instanceOffsets,
+                                 instanceOffsets + 2*numInstances);
+    cl_mem instanceOffsetsBuffer = createCLBuffer(hostOffsets, _clContext);
+    if (instanceOffsetsBuffer == NULL) return false;
+
+    size_t globalWorkSize[2] = { (size_t)(end - start),
+                                 (size_t)numInstances };
+
+    clSetKernelArg(_stencilBatchKernel, 0, sizeof(cl_mem), &src);
+    clSetKernelArg(_stencilBatchKernel, 1, sizeof(int), &srcDesc.offset);
+    clSetKernelArg(_stencilBatchKernel, 2, sizeof(cl_mem), &dst);
+    clSetKernelArg(_stencilBatchKernel, 3, sizeof(int), &dstDesc.offset);
+    clSetKernelArg(_stencilBatchKernel, 4, sizeof(cl_mem), &sizes);
+    clSetKernelArg(_stencilBatchKernel, 5, sizeof(cl_mem), &offsets);
+    clSetKernelArg(_stencilBatchKernel, 6, sizeof(cl_mem), &indices);
+    clSetKernelArg(_stencilBatchKernel, 7, sizeof(cl_mem), &weights);
+    clSetKernelArg(_stencilBatchKernel, 8, sizeof(int), &start);
+    clSetKernelArg(_stencilBatchKernel, 9, sizeof(int), &end);
+    clSetKernelArg(_stencilBatchKernel, 10, sizeof(cl_mem),
+                   &instanceOffsetsBuffer);
+
+    cl_int errNum = clEnqueueNDRangeKernel(
+        _clCommandQueue, _stencilBatchKernel, 2, NULL,
+        globalWorkSize, NULL, numStartEvents, startEvents, endEvent);
+
+    // the buffer is retained by the enqueued kernel
+    clReleaseMemObject(instanceOffsetsBuffer);
+
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "ApplyStencilBatchKernel (%d) ", errNum);
+        return false;
+    }
+
+    if (endEvent == NULL)
+    {
+    clFinish(_clCommandQueue);
+    }
+    return true;
+}
+
 bool
 CLEvaluator::EvalStencils(cl_mem src, BufferDescriptor const &srcDesc,
                           cl_mem dst, BufferDescriptor const &dstDesc,
@@ -255,6 +498,8 @@ CLEvaluator::EvalStencils(cl_mem src, BufferDescriptor const &srcDesc,
                           unsigned int numStartEvents,
                           const cl_event* startEvents,
                           cl_event* endEvent) const {
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalStencils");
+
     if (end <= start) return true;
 
     size_t globalWorkSize = (size_t)(end - start);
@@ -309,6 +554,136 @@ CLEvaluator::EvalPatches(cl_mem src, BufferDescriptor const &srcDesc,
                          const cl_event* startEvents,
                          cl_event* endEvent) const {
 
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalPatches");
+
+    return evalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrayBuffer, patchIndexBuffer, patchParamBuffer,
+                       EVAL_VERTEX, NULL, 0.0f,
+                       numStartEvents, startEvents, endEvent);
+}
+
+bool
+CLEvaluator::EvalPatches(cl_mem src, BufferDescriptor const &srcDesc,
+                         cl_mem dst, BufferDescriptor const &dstDesc,
+                         cl_mem du,  BufferDescriptor const &duDesc,
+                         cl_mem dv,  BufferDescriptor const &dvDesc,
+                         int numPatchCoords,
+                         cl_mem patchCoordsBuffer,
+                         cl_mem patchArrayBuffer,
+                         cl_mem patchIndexBuffer,
+                         cl_mem patchParamBuffer,
+                         CLDisplacementTexture const *displacement,
+                         float displacementScale,
+                         unsigned int numStartEvents,
+                         const cl_event* startEvents,
+                         cl_event* endEvent) const {
+
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalPatches");
+
+    if (displacement and srcDesc.length < 3) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failure in CLEvaluator::EvalPatches() -- "
+                   "displaced primvars have less than 3 components.");
+        return false;
+    }
+    return evalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrayBuffer, patchIndexBuffer, patchParamBuffer,
+                       EVAL_VERTEX, displacement, displacementScale,
+                       numStartEvents, startEvents, endEvent);
+}
+
+bool
+CLEvaluator::EvalPatchesFaceVarying(cl_mem src, BufferDescriptor const &srcDesc,
+                                    cl_mem dst, BufferDescriptor const &dstDesc,
+                                    cl_mem du,  BufferDescriptor const &duDesc,
+                                    cl_mem dv,  BufferDescriptor const &dvDesc,
+                                    int numPatchCoords,
+                                    cl_mem patchCoordsBuffer,
+                                    cl_mem fvarPatchArrayBuffer,
+                                    cl_mem fvarPatchIndexBuffer,
+                                    cl_mem fvarPatchParamBuffer,
+                                    unsigned int numStartEvents,
+                                    const cl_event* startEvents,
+                                    cl_event* endEvent) const {
+
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalPatchesFaceVarying");
+
+    return evalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       fvarPatchArrayBuffer, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer,
+                       EVAL_FACE_VARYING, NULL, 0.0f,
+                       numStartEvents, startEvents, endEvent);
+}
+
+bool
+CLEvaluator::EvalPatchesVarying(cl_mem src, BufferDescriptor const &srcDesc,
+                                cl_mem dst, BufferDescriptor const &dstDesc,
+                                cl_mem du,  BufferDescriptor const &duDesc,
+                                cl_mem dv,  BufferDescriptor const &dvDesc,
+                                int numPatchCoords,
+                                cl_mem patchCoordsBuffer,
+                                cl_mem patchArrayBuffer,
+                                cl_mem patchIndexBuffer,
+                                cl_mem patchParamBuffer,
+                                unsigned int numStartEvents,
+                                const cl_event* startEvents,
+                                cl_event* endEvent) const {
+
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalPatchesVarying");
+
+    return evalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrayBuffer, patchIndexBuffer, patchParamBuffer,
+                       EVAL_VARYING, NULL, 0.0f,
+                       numStartEvents, startEvents, endEvent);
+}
+
+bool
+CLEvaluator::EvalPatchesFaceUniform(cl_mem src, BufferDescriptor const &srcDesc,
+                                    cl_mem dst, BufferDescriptor const &dstDesc,
+                                    int numPatchCoords,
+                                    cl_mem patchCoordsBuffer,
+                                    cl_mem patchArrayBuffer,
+                                    cl_mem patchIndexBuffer,
+                                    cl_mem patchParamBuffer,
+                                    unsigned int numStartEvents,
+                                    const cl_event* startEvents,
+                                    cl_event* endEvent) const {
+
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::EvalPatchesFaceUniform");
+
+    return evalPatches(src, srcDesc, dst, dstDesc,
+                       0, BufferDescriptor(), 0, BufferDescriptor(),
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrayBuffer, patchIndexBuffer, patchParamBuffer,
+                       EVAL_FACE_UNIFORM, NULL, 0.0f,
+                       numStartEvents, startEvents, endEvent);
+}
+
+bool
+CLEvaluator::evalPatches(cl_mem src, BufferDescriptor const &srcDesc,
+                         cl_mem dst, BufferDescriptor const &dstDesc,
+                         cl_mem du,  BufferDescriptor const &duDesc,
+                         cl_mem dv,  BufferDescriptor const &dvDesc,
+                         int numPatchCoords,
+                         cl_mem patchCoordsBuffer,
+                         cl_mem patchArrayBuffer,
+                         cl_mem patchIndexBuffer,
+                         cl_mem patchParamBuffer,
+                         int evalMode,
+                         CLDisplacementTexture const *displacement,
+                         float displacementScale,
+                         unsigned int numStartEvents,
+                         const cl_event* startEvents,
+                         cl_event* endEvent) const {
+
     size_t globalWorkSize = (size_t)(numPatchCoords);
 
     clSetKernelArg(_patchKernel,  0, sizeof(cl_mem), &src);
@@ -325,6 +700,22 @@ CLEvaluator::EvalPatches(cl_mem src, BufferDescriptor const &srcDesc,
     clSetKernelArg(_patchKernel, 11, sizeof(cl_mem), &patchArrayBuffer);
     clSetKernelArg(_patchKernel, 12, sizeof(cl_mem), &patchIndexBuffer);
     clSetKernelArg(_patchKernel, 13, sizeof(cl_mem), &patchParamBuffer);
+    clSetKernelArg(_patchKernel, 14, sizeof(int),    &evalMode);
+
+    // the displacement stage is disabled by a NULL buffer of texels
+    cl_mem displacementFaces = NULL, displacementTexels = NULL;
+    int numDisplacementFaces = 0, numDisplacementChannels = 0;
+    if (displacement) {
+        displacementFaces = displacement->GetFaceBuffer();
+        displacementTexels = displacement->GetTexelBuffer();
+        numDisplacementFaces = displacement->GetNumFaces();
+        numDisplacementChannels = displacement->GetNumChannels();
+    }
+    clSetKernelArg(_patchKernel, 15, sizeof(cl_mem), &displacementFaces);
+    clSetKernelArg(_patchKernel, 16, sizeof(cl_mem), &displacementTexels);
+    clSetKernelArg(_patchKernel, 17, sizeof(int),    &numDisplacementFaces);
+    clSetKernelArg(_patchKernel, 18, sizeof(int),    &numDisplacementChannels);
+    clSetKernelArg(_patchKernel, 19, sizeof(float),  &displacementScale);
 
     cl_int errNum = clEnqueueNDRangeKernel(
         _clCommandQueue, _patchKernel, 1, NULL,
@@ -344,6 +735,137 @@ CLEvaluator::EvalPatches(cl_mem src, BufferDescriptor const &srcDesc,
 }
 
 
+bool
+CLEvaluator::FindPatchCoords(int numLocations,
+                             cl_mem faceIds, cl_mem u, cl_mem v,
+                             cl_mem patchCoordsBuffer,
+                             int numFaces,
+                             cl_mem faceBuffer,
+                             cl_mem nodeBuffer,
+                             cl_mem handleBuffer,
+                             unsigned int numStartEvents,
+                             const cl_event* startEvents,
+                             cl_event* endEvent) const {
+
+    if (numLocations <= 0) return true;
+
+    size_t globalWorkSize = (size_t)(numLocations);
+
+    clSetKernelArg(_findPatchesKernel, 0, sizeof(cl_mem), &faceIds);
+    clSetKernelArg(_findPatchesKernel, 1, sizeof(cl_mem), &u);
+    clSetKernelArg(_findPatchesKernel, 2, sizeof(cl_mem), &v);
+    clSetKernelArg(_findPatchesKernel, 3, sizeof(cl_mem), &patchCoordsBuffer);
+    clSetKernelArg(_findPatchesKernel, 4, sizeof(int),    &numFaces);
+    clSetKernelArg(_findPatchesKernel, 5, sizeof(cl_mem), &faceBuffer);
+    clSetKernelArg(_findPatchesKernel, 6, sizeof(cl_mem), &nodeBuffer);
+    clSetKernelArg(_findPatchesKernel, 7, sizeof(cl_mem), &handleBuffer);
+
+    cl_int errNum = clEnqueueNDRangeKernel(
+        _clCommandQueue, _findPatchesKernel, 1, NULL,
+        &globalWorkSize, NULL, numStartEvents, startEvents, endEvent);
+
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "FindPatchCoords (%d) ", errNum);
+        return false;
+    }
+
+    if (endEvent == NULL)
+    {
+    clFinish(_clCommandQueue);
+    }
+    return true;
+}
+
+bool
+CLEvaluator::AdvectPatchCoords(int numSamples,
+                               cl_mem faceIds, cl_mem u, cl_mem v,
+                               cl_mem velocities,
+                               float step,
+                               int numPtexFaces,
+                               cl_mem adjacencyBuffer,
+                               cl_mem patchCoordsBuffer,
+                               int numFaces,
+                               cl_mem faceBuffer,
+                               cl_mem nodeBuffer,
+                               cl_mem handleBuffer,
+                               unsigned int numStartEvents,
+                               const cl_event* startEvents,
+                               cl_event* endEvent) const {
+
+    if (numSamples <= 0) return true;
+
+    size_t globalWorkSize = (size_t)(numSamples);
+
+    clSetKernelArg(_advectPatchesKernel,  0, sizeof(cl_mem), &faceIds);
+    clSetKernelArg(_advectPatchesKernel,  1, sizeof(cl_mem), &u);
+    clSetKernelArg(_advectPatchesKernel,  2, sizeof(cl_mem), &v);
+    clSetKernelArg(_advectPatchesKernel,  3, sizeof(cl_mem), &velocities);
+    clSetKernelArg(_advectPatchesKernel,  4, sizeof(float),  &step);
+    clSetKernelArg(_advectPatchesKernel,  5, sizeof(int),    &numPtexFaces);
+    clSetKernelArg(_advectPatchesKernel,  6, sizeof(cl_mem), &adjacencyBuffer);
+    clSetKernelArg(_advectPatchesKernel,  7, sizeof(cl_mem), &patchCoordsBuffer);
+    clSetKernelArg(_advectPatchesKernel,  8, sizeof(int),    &numFaces);
+    clSetKernelArg(_advectPatchesKernel,  9, sizeof(cl_mem), &faceBuffer);
+    clSetKernelArg(_advectPatchesKernel, 10, sizeof(cl_mem), &nodeBuffer);
+    clSetKernelArg(_advectPatchesKernel, 11, sizeof(cl_mem), &handleBuffer);
+
+    cl_int errNum = clEnqueueNDRangeKernel(
+        _clCommandQueue, _advectPatchesKernel, 1, NULL,
+        &globalWorkSize, NULL, numStartEvents, startEvents, endEvent);
+
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "AdvectPatchCoords (%d) ", errNum);
+        return false;
+    }
+
+    if (endEvent == NULL)
+    {
+    clFinish(_clCommandQueue);
+    }
+    return true;
+}
+
+bool
+CLEvaluator::BlendKeyframes(cl_mem keys, BufferDescriptor const &keyDesc,
+                            cl_mem dst, BufferDescriptor const &dstDesc,
+                            int numVertices, int key0, int key1, float weight,
+                            unsigned int numStartEvents,
+                            const cl_event* startEvents,
+                            cl_event* endEvent) const {
+    OPENSUBDIV_PROFILE_ZONE("CLEvaluator::BlendKeyframes");
+
+    if (numVertices <= 0) return true;
+
+    size_t globalWorkSize = (size_t)(numVertices);
+
+    int key0Offset = keyDesc.offset + key0 * numVertices * keyDesc.stride,
+        key1Offset = keyDesc.offset + key1 * numVertices * keyDesc.stride;
+
+    clSetKernelArg(_blendKeyframesKernel, 0, sizeof(cl_mem), &keys);
+    clSetKernelArg(_blendKeyframesKernel, 1, sizeof(int), &key0Offset);
+    clSetKernelArg(_blendKeyframesKernel, 2, sizeof(int), &key1Offset);
+    clSetKernelArg(_blendKeyframesKernel, 3, sizeof(cl_mem), &dst);
+    clSetKernelArg(_blendKeyframesKernel, 4, sizeof(int), &dstDesc.offset);
+    clSetKernelArg(_blendKeyframesKernel, 5, sizeof(float), &weight);
+
+    cl_int errNum = clEnqueueNDRangeKernel(
+        _clCommandQueue, _blendKeyframesKernel, 1, NULL,
+        &globalWorkSize, NULL, numStartEvents, startEvents, endEvent);
+
+    if (errNum != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "BlendKeyframes (%d) ", errNum);
+        return false;
+    }
+
+    if (endEvent == NULL)
+    {
+    clFinish(_clCommandQueue);
+    }
+    return true;
+}
 
 /* static */
 void
@@ -27,6 +27,8 @@
 
 #include "../version.h"
 
+#include <vector>
+
 #include "../osd/opencl.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
@@ -36,10 +38,13 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
     class StencilTable;
+    class LimitStencilTable;
 }
 
 namespace Osd {
 
+class CLDisplacementTexture;
+
 /// \brief OpenCL stencil table
 ///
 /// This class is an OpenCL buffer representation of Far::StencilTable.
@@ -52,20 +57,53 @@ public:
     template <typename DEVICE_CONTEXT>
     static CLStencilTable *Create(Far::StencilTable const *stencilTable,
                                   DEVICE_CONTEXT context) {
-        return new CLStencilTable(stencilTable, context->GetContext());
+        return new CLStencilTable(stencilTable, context->GetContext(),
+                                  context->GetCommandQueue());
     }
 
     template <typename DEVICE_CONTEXT>
     static CLStencilTable *Create(
         Far::LimitStencilTable const *limitStencilTable,
         DEVICE_CONTEXT context) {
-        return new CLStencilTable(limitStencilTable, context->GetContext());
+        return new CLStencilTable(limitStencilTable, context->GetContext(),
+                                  context->GetCommandQueue());
+    }
+
+    /// \brief Creates the table, then frees the arrays of 'stencilTable' (see
+    ///        Far::StencilTable::Clear) : large tables need not be kept on
+    ///        the host once uploaded
+    template <typename DEVICE_CONTEXT>
+    static CLStencilTable *CreateAndRelease(Far::StencilTable *stencilTable,
+                                            DEVICE_CONTEXT context) {
+        return CreateAndRelease(stencilTable, context->GetContext(),
+                                context->GetCommandQueue());
+    }
+
+    template <typename DEVICE_CONTEXT>
+    static CLStencilTable *CreateAndRelease(
+        Far::LimitStencilTable *limitStencilTable,
+        DEVICE_CONTEXT context) {
+        return CreateAndRelease(limitStencilTable, context->GetContext(),
+                                context->GetCommandQueue());
     }
 
+    static CLStencilTable *CreateAndRelease(Far::StencilTable *stencilTable,
+                                            cl_context clContext,
+                                            cl_command_queue clCommandQueue);
+    static CLStencilTable *CreateAndRelease(
+        Far::LimitStencilTable *limitStencilTable,
+        cl_context clContext,
+        cl_command_queue clCommandQueue);
+
+    /// \brief Uploads the arrays of the table. Large arrays are written in
+    ///        chunks if a command queue is given, rather than copied from
+    ///        the host by clCreateBuffer.
     CLStencilTable(Far::StencilTable const *stencilTable,
-                   cl_context clContext);
+                   cl_context clContext,
+                   cl_command_queue clCommandQueue = NULL);
     CLStencilTable(Far::LimitStencilTable const *limitStencilTable,
-                   cl_context clContext);
+                   cl_context clContext,
+                   cl_command_queue clCommandQueue = NULL);
     ~CLStencilTable();
 
     // interfaces needed for CLComputeKernel
@@ -77,6 +115,10 @@ public:
     cl_mem GetDvWeightsBuffer() const { return _dvWeights; }
     int GetNumStencils()        const { return _numStencils; }
 
+    /// \brief Returns the index of the first stencil of each evaluation pass
+    ///        (see Far::StencilTable::GetPassOffsets())
+    std::vector<int> const & GetPassOffsets() const { return _passOffsets; }
+
 private:
     cl_mem _sizes;
     cl_mem _offsets;
@@ -84,6 +126,7 @@ private:
     cl_mem _weights;
     cl_mem _duWeights;
     cl_mem _dvWeights;
+    std::vector<int> _passOffsets;
     int _numStencils;
 };
 
@@ -169,7 +212,9 @@ public:
     ///                       the cl_event which indicates when all work for this
     ///                       call has completed.  This cl_event has an incremented
     ///                       reference count and should be released via
-    ///                       clReleaseEvent().  NULL if not required.
+    ///                       clReleaseEvent().  If NULL, the call blocks until
+    ///                       the work has completed (clFinish), otherwise the
+    ///                       work is only enqueued.
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename STENCIL_TABLE, typename DEVICE_CONTEXT>
@@ -206,6 +251,50 @@ public:
         }
     }
 
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    /// \note  Ranges of tables of several passes must not span passes, and
+    ///        are evaluated in the order of the passes (see
+    ///        Far::StencilTable::GetPassOffsets())
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename STENCIL_TABLE, typename DEVICE_CONTEXT>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        CLEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) {
+
+        if (end <= start) return true;
+
+        // Create an instance on demand (slow)
+        CLEvaluator const *kernel = instance ? instance :
+            Create(srcDesc, dstDesc, BufferDescriptor(), BufferDescriptor(),
+                   deviceContext);
+        if (!kernel) return false;
+
+        cl_command_queue queue = kernel->_clCommandQueue;
+        bool r = kernel->EvalStencils(srcBuffer->BindCLBuffer(queue), srcDesc,
+                                      dstBuffer->BindCLBuffer(queue), dstDesc,
+                                      stencilTable->GetSizesBuffer(),
+                                      stencilTable->GetOffsetsBuffer(),
+                                      stencilTable->GetIndicesBuffer(),
+                                      stencilTable->GetWeightsBuffer(),
+                                      start, end,
+                                      numStartEvents, startEvents, endEvent);
+        if (kernel != instance) delete kernel;
+        return r;
+    }
+
     /// \brief Generic static compute function. This function has a same
     ///        signature as other device kernels have so that it can be called
     ///        transparently from OsdMesh template interface.
@@ -259,7 +348,9 @@ public:
     ///                       the cl_event which indicates when all work for this
     ///                       call has completed.  This cl_event has an incremented
     ///                       reference count and should be released via
-    ///                       clReleaseEvent().  NULL if not required.
+    ///                       clReleaseEvent().  If NULL, the call blocks until
+    ///                       the work has completed (clFinish), otherwise the
+    ///                       work is only enqueued.
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename STENCIL_TABLE, typename DEVICE_CONTEXT>
@@ -311,15 +402,52 @@ public:
         unsigned int numStartEvents=0,
         const cl_event* startEvents=NULL,
         cl_event* endEvent=NULL) const {
-        return EvalStencils(srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
-                            dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
-                            stencilTable->GetSizesBuffer(),
-                            stencilTable->GetOffsetsBuffer(),
-                            stencilTable->GetIndicesBuffer(),
-                            stencilTable->GetWeightsBuffer(),
-                            0,
-                            stencilTable->GetNumStencils(),
-                            numStartEvents, startEvents, endEvent);
+
+        std::vector<int> const & passOffsets = stencilTable->GetPassOffsets();
+        if (passOffsets.empty()) {
+            return EvalStencils(srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+                                dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+                                stencilTable->GetSizesBuffer(),
+                                stencilTable->GetOffsetsBuffer(),
+                                stencilTable->GetIndicesBuffer(),
+                                stencilTable->GetWeightsBuffer(),
+                                0,
+                                stencilTable->GetNumStencils(),
+                                numStartEvents, startEvents, endEvent);
+        }
+
+        // Passes refer to the vertices of the previous passes (see
+        // Far::StencilTable::GetPassOffsets()) : each pass waits for the
+        // event of the previous one, the queue may execute out of order
+        int numPasses = (int)passOffsets.size();
+        cl_event passEvent = NULL;
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            cl_event previousEvent = passEvent;
+            passEvent = NULL;
+
+            bool last = (pass+1 == numPasses);
+            bool r = EvalStencils(srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+                                  dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+                                  stencilTable->GetSizesBuffer(),
+                                  stencilTable->GetOffsetsBuffer(),
+                                  stencilTable->GetIndicesBuffer(),
+                                  stencilTable->GetWeightsBuffer(),
+                                  start, end,
+                                  previousEvent ? 1 : numStartEvents,
+                                  previousEvent ? &previousEvent : startEvents,
+                                  last ? endEvent : &passEvent);
+
+            if (previousEvent) clReleaseEvent(previousEvent);
+            if (not r) {
+                if (passEvent) clReleaseEvent(passEvent);
+                return false;
+            }
+        }
+        return true;
     }
 
     /// Generic compute function.
@@ -364,6 +492,56 @@ public:
                       const cl_event* startEvents=NULL,
                       cl_event* endEvent=NULL) const;
 
+    /// \brief Generic compute function for the instances of a mesh.
+    ///        Dispatch the CL compute kernel asynchronously, over a range of
+    ///        two dimensions : the stencils of the table and the instances,
+    ///        located by offsets in the input and output buffers.
+    ///        Returns false if the kernel hasn't been compiled yet.
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance
+    ///                        (host memory), in floats, added to the offsets
+    ///                        of srcDesc and dstDesc
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencilsBatch(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int numInstances, int const * instanceOffsets,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+        return EvalStencilsBatch(srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+                                 dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+                                 stencilTable->GetSizesBuffer(),
+                                 stencilTable->GetOffsetsBuffer(),
+                                 stencilTable->GetIndicesBuffer(),
+                                 stencilTable->GetWeightsBuffer(),
+                                 0,
+                                 stencilTable->GetNumStencils(),
+                                 numInstances, instanceOffsets,
+                                 numStartEvents, startEvents, endEvent);
+    }
+
+    /// Dispatch the CL compute kernel for the instances of a mesh
+    /// asynchronously (see above).
+    /// returns false if the kernel hasn't been compiled yet.
+    bool EvalStencilsBatch(cl_mem src, BufferDescriptor const &srcDesc,
+                           cl_mem dst, BufferDescriptor const &dstDesc,
+                           cl_mem sizes,
+                           cl_mem offsets,
+                           cl_mem indices,
+                           cl_mem weights,
+                           int start,
+                           int end,
+                           int numInstances,
+                           const int * instanceOffsets,
+                           unsigned int numStartEvents=0,
+                           const cl_event* startEvents=NULL,
+                           cl_event* endEvent=NULL) const;
+
     /// Dispatch the CL compute kernel asynchronously.
     /// returns false if the kernel hasn't been compiled yet.
     bool EvalStencils(cl_mem src, BufferDescriptor const &srcDesc,
@@ -434,7 +612,9 @@ public:
     ///                       the cl_event which indicates when all work for this
     ///                       call has completed.  This cl_event has an incremented
     ///                       reference count and should be released via
-    ///                       clReleaseEvent().  NULL if not required.
+    ///                       clReleaseEvent().  If NULL, the call blocks until
+    ///                       the work has completed (clFinish), otherwise the
+    ///                       work is only enqueued.
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename PATCHCOORD_BUFFER, typename PATCH_TABLE,
@@ -531,7 +711,9 @@ public:
     ///                       the cl_event which indicates when all work for this
     ///                       call has completed.  This cl_event has an incremented
     ///                       reference count and should be released via
-    ///                       clReleaseEvent().  NULL if not required.
+    ///                       clReleaseEvent().  If NULL, the call blocks until
+    ///                       the work has completed (clFinish), otherwise the
+    ///                       work is only enqueued.
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename PATCHCOORD_BUFFER, typename PATCH_TABLE,
@@ -612,7 +794,9 @@ public:
     ///                       the cl_event which indicates when all work for this
     ///                       call has completed.  This cl_event has an incremented
     ///                       reference count and should be released via
-    ///                       clReleaseEvent().  NULL if not required.
+    ///                       clReleaseEvent().  If NULL, the call blocks until
+    ///                       the work has completed (clFinish), otherwise the
+    ///                       work is only enqueued.
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
@@ -683,7 +867,9 @@ public:
     ///                       the cl_event which indicates when all work for this
     ///                       call has completed.  This cl_event has an incremented
     ///                       reference count and should be released via
-    ///                       clReleaseEvent().  NULL if not required.
+    ///                       clReleaseEvent().  If NULL, the call blocks until
+    ///                       the work has completed (clFinish), otherwise the
+    ///                       work is only enqueued.
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
@@ -724,6 +910,522 @@ public:
                      const cl_event* startEvents=NULL,
                      cl_event* endEvent=NULL) const;
 
+    /// \brief Generic limit eval function with derivatives, displacing the
+    ///        limit points by a displacement texture in the same kernel (see
+    ///        CpuEvaluator::EvalPatches and CLDisplacementTexture).
+    ///
+    /// The first 3 components of the primvars are the displaced points.
+    /// duBuffer and dvBuffer may be NULL.
+    ///
+    /// @param displacement       CLDisplacementTexture sampled at the
+    ///                           points (NULL : no displacement)
+    ///
+    /// @param displacementScale  Scale of the sampled displacement
+    ///
+    /// (see the function with derivatives for the other parameters)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CLDisplacementTexture const *displacement,
+        float displacementScale,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+
+        return EvalPatches(srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+                           dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+                           duBuffer ? duBuffer->BindCLBuffer(_clCommandQueue) : 0, duDesc,
+                           dvBuffer ? dvBuffer->BindCLBuffer(_clCommandQueue) : 0, dvDesc,
+                           numPatchCoords,
+                           patchCoords->BindCLBuffer(_clCommandQueue),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer(),
+                           displacement, displacementScale,
+                           numStartEvents, startEvents, endEvent);
+    }
+
+    bool EvalPatches(cl_mem src, BufferDescriptor const &srcDesc,
+                     cl_mem dst, BufferDescriptor const &dstDesc,
+                     cl_mem du,  BufferDescriptor const &duDesc,
+                     cl_mem dv,  BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     cl_mem patchCoordsBuffer,
+                     cl_mem patchArrayBuffer,
+                     cl_mem patchIndexBuffer,
+                     cl_mem patchParamsBuffer,
+                     CLDisplacementTexture const *displacement,
+                     float displacementScale,
+                     unsigned int numStartEvents=0,
+                     const cl_event* startEvents=NULL,
+                     cl_event* endEvent=NULL) const;
+
+    /// \brief Generic face-varying limit eval function. It takes the
+    ///        PatchCoords of the vertex patches and evaluates the limit values
+    ///        of a face-varying channel of the PatchTable on the device (see
+    ///        CpuEvaluator::EvalPatchesFaceVarying).
+    ///
+    /// @param srcBuffer      Input face-varying primvar buffer.
+    ///                       must have BindCLBuffer() method returning a CL
+    ///                       buffer object of source data
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCLBuffer() method returning a CL
+    ///                       buffer object of destination data
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords number of patchCoords.
+    ///
+    /// @param patchCoords    array of locations to be evaluated.
+    ///                       must have BindCLBuffer() method returning an
+    ///                       array of PatchCoord struct.
+    ///
+    /// @param patchTable     CLPatchTable or equivalent
+    ///
+    /// @param fvarChannel    face-varying channel of the patch table
+    ///
+    /// @param numStartEvents, startEvents, endEvent  see EvalPatches
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+
+        return EvalPatchesFaceVarying(
+            srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+            dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+            0, BufferDescriptor(),
+            0, BufferDescriptor(),
+            numPatchCoords,
+            patchCoords->BindCLBuffer(_clCommandQueue),
+            patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+            patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+            patchTable->GetFVarPatchParamBuffer(fvarChannel),
+            numStartEvents, startEvents, endEvent);
+    }
+
+    /// \brief Generic face-varying limit eval function with derivatives
+    ///        (see EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+
+        return EvalPatchesFaceVarying(
+            srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+            dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+            duBuffer->BindCLBuffer(_clCommandQueue),  duDesc,
+            dvBuffer->BindCLBuffer(_clCommandQueue),  dvDesc,
+            numPatchCoords,
+            patchCoords->BindCLBuffer(_clCommandQueue),
+            patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+            patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+            patchTable->GetFVarPatchParamBuffer(fvarChannel),
+            numStartEvents, startEvents, endEvent);
+    }
+
+    /// \brief Face-varying limit eval function on CL buffers : the
+    ///        PatchCoords of the vertex patches are mapped to the patches of
+    ///        the channel by the kernel (see CLPatchTable for the
+    ///        face-varying buffers)
+    bool EvalPatchesFaceVarying(cl_mem src, BufferDescriptor const &srcDesc,
+                                cl_mem dst, BufferDescriptor const &dstDesc,
+                                cl_mem du,  BufferDescriptor const &duDesc,
+                                cl_mem dv,  BufferDescriptor const &dvDesc,
+                                int numPatchCoords,
+                                cl_mem patchCoordsBuffer,
+                                cl_mem fvarPatchArrayBuffer,
+                                cl_mem fvarPatchIndexBuffer,
+                                cl_mem fvarPatchParamsBuffer,
+                                unsigned int numStartEvents=0,
+                                const cl_event* startEvents=NULL,
+                                cl_event* endEvent=NULL) const;
+
+    /// \brief Generic varying eval function. Evaluates varying primvars at
+    ///        the PatchCoords of the vertex patches : the values are
+    ///        interpolated bilinearly between the corners of the patches.
+    ///
+    /// @param srcBuffer      Input varying primvar buffer (values of the
+    ///                       refined vertices and local points, indexed as
+    ///                       the vertex primvars).
+    ///                       must have BindCLBuffer() method returning a CL
+    ///                       buffer object of source data
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCLBuffer() method returning a CL
+    ///                       buffer object of destination data
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords number of patchCoords.
+    ///
+    /// @param patchCoords    array of locations to be evaluated.
+    ///                       must have BindCLBuffer() method returning an
+    ///                       array of PatchCoord struct.
+    ///
+    /// @param patchTable     CLPatchTable or equivalent
+    ///
+    /// @param numStartEvents, startEvents, endEvent  see EvalPatches
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+
+        return EvalPatchesVarying(
+            srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+            dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+            0, BufferDescriptor(),
+            0, BufferDescriptor(),
+            numPatchCoords,
+            patchCoords->BindCLBuffer(_clCommandQueue),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer(),
+            numStartEvents, startEvents, endEvent);
+    }
+
+    /// \brief Generic varying eval function with derivatives
+    ///        (see EvalPatchesVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+
+        return EvalPatchesVarying(
+            srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+            dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+            duBuffer->BindCLBuffer(_clCommandQueue),  duDesc,
+            dvBuffer->BindCLBuffer(_clCommandQueue),  dvDesc,
+            numPatchCoords,
+            patchCoords->BindCLBuffer(_clCommandQueue),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer(),
+            numStartEvents, startEvents, endEvent);
+    }
+
+    /// \brief Varying eval function on CL buffers
+    bool EvalPatchesVarying(cl_mem src, BufferDescriptor const &srcDesc,
+                            cl_mem dst, BufferDescriptor const &dstDesc,
+                            cl_mem du,  BufferDescriptor const &duDesc,
+                            cl_mem dv,  BufferDescriptor const &dvDesc,
+                            int numPatchCoords,
+                            cl_mem patchCoordsBuffer,
+                            cl_mem patchArrayBuffer,
+                            cl_mem patchIndexBuffer,
+                            cl_mem patchParamsBuffer,
+                            unsigned int numStartEvents=0,
+                            const cl_event* startEvents=NULL,
+                            cl_event* endEvent=NULL) const;
+
+    /// \brief Generic face-uniform eval function. Copies the values of the
+    ///        faces of the PatchCoords, looked up by the face id of the
+    ///        PatchParam of their patches (i.e. the ptex face, which is the
+    ///        base face of quad meshes).
+    ///
+    /// @param srcBuffer      Input face-uniform primvar buffer, one value
+    ///                       per ptex face.
+    ///                       must have BindCLBuffer() method returning a CL
+    ///                       buffer object of source data
+    ///
+    /// (see EvalPatchesVarying for the other parameters)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceUniform(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) const {
+
+        return EvalPatchesFaceUniform(
+            srcBuffer->BindCLBuffer(_clCommandQueue), srcDesc,
+            dstBuffer->BindCLBuffer(_clCommandQueue), dstDesc,
+            numPatchCoords,
+            patchCoords->BindCLBuffer(_clCommandQueue),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer(),
+            numStartEvents, startEvents, endEvent);
+    }
+
+    /// \brief Face-uniform eval function on CL buffers
+    bool EvalPatchesFaceUniform(cl_mem src, BufferDescriptor const &srcDesc,
+                                cl_mem dst, BufferDescriptor const &dstDesc,
+                                int numPatchCoords,
+                                cl_mem patchCoordsBuffer,
+                                cl_mem patchArrayBuffer,
+                                cl_mem patchIndexBuffer,
+                                cl_mem patchParamsBuffer,
+                                unsigned int numStartEvents=0,
+                                const cl_event* startEvents=NULL,
+                                cl_event* endEvent=NULL) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Patch lookups with PatchMap
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Finds the patches of an array of (faceId, u, v) locations on
+    ///        the device, and writes their PatchCoord. Locations without a
+    ///        patch (holes or invalid face ids) get a patchIndex of -1.
+    ///
+    /// @param numLocations   number of locations
+    ///
+    /// @param faceIds        must have BindCLBuffer() method returning a CL
+    ///                       buffer object of the ptex face indices
+    ///
+    /// @param u              CL buffer of the u coordinates (see faceIds)
+    ///
+    /// @param v              CL buffer of the v coordinates (see faceIds)
+    ///
+    /// @param patchCoords    output buffer of PatchCoord (see faceIds)
+    ///
+    /// @param patchMap       CLPatchMap or equivalent
+    ///
+    /// @param numStartEvents, startEvents, endEvent  see EvalPatches
+    ///
+    template <typename INDEX_BUFFER, typename COORD_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_MAP>
+    bool FindPatchCoords(int numLocations,
+                         INDEX_BUFFER *faceIds,
+                         COORD_BUFFER *u, COORD_BUFFER *v,
+                         PATCHCOORD_BUFFER *patchCoords,
+                         PATCH_MAP *patchMap,
+                         unsigned int numStartEvents=0,
+                         const cl_event* startEvents=NULL,
+                         cl_event* endEvent=NULL) const {
+
+        return FindPatchCoords(numLocations,
+                               faceIds->BindCLBuffer(_clCommandQueue),
+                               u->BindCLBuffer(_clCommandQueue),
+                               v->BindCLBuffer(_clCommandQueue),
+                               patchCoords->BindCLBuffer(_clCommandQueue),
+                               patchMap->GetNumFaces(),
+                               patchMap->GetFaceBuffer(),
+                               patchMap->GetNodeBuffer(),
+                               patchMap->GetHandleBuffer(),
+                               numStartEvents, startEvents, endEvent);
+    }
+
+    bool FindPatchCoords(int numLocations,
+                         cl_mem faceIds, cl_mem u, cl_mem v,
+                         cl_mem patchCoordsBuffer,
+                         int numFaces,
+                         cl_mem faceBuffer,
+                         cl_mem nodeBuffer,
+                         cl_mem handleBuffer,
+                         unsigned int numStartEvents=0,
+                         const cl_event* startEvents=NULL,
+                         cl_event* endEvent=NULL) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Surface samples with PtexAdjacency
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Moves an array of (faceId, u, v) samples by their (du, dv)
+    ///        velocities on the device, warping them across the edges of
+    ///        their ptex faces (see CpuEvaluator::AdvectPatchCoords), and
+    ///        writes the PatchCoord of their new locations.
+    ///
+    /// @param numSamples     number of samples
+    ///
+    /// @param faceIds        must have BindCLBuffer() method returning a CL
+    ///                       buffer object of the ptex face indices, updated
+    ///                       in place
+    ///
+    /// @param u              CL buffer of the u coordinates (see faceIds)
+    ///
+    /// @param v              CL buffer of the v coordinates (see faceIds)
+    ///
+    /// @param velocities     CL buffer of the interleaved (du, dv) velocities
+    ///                       (see faceIds)
+    ///
+    /// @param step           time step of the move
+    ///
+    /// @param adjacency      CLPtexAdjacency or equivalent
+    ///
+    /// @param patchCoords    output buffer of PatchCoord (see faceIds)
+    ///
+    /// @param patchMap       CLPatchMap or equivalent
+    ///
+    /// @param numStartEvents, startEvents, endEvent  see EvalPatches
+    ///
+    template <typename INDEX_BUFFER, typename COORD_BUFFER,
+              typename PTEX_ADJACENCY, typename PATCHCOORD_BUFFER,
+              typename PATCH_MAP>
+    bool AdvectPatchCoords(int numSamples,
+                           INDEX_BUFFER *faceIds,
+                           COORD_BUFFER *u, COORD_BUFFER *v,
+                           COORD_BUFFER *velocities,
+                           float step,
+                           PTEX_ADJACENCY *adjacency,
+                           PATCHCOORD_BUFFER *patchCoords,
+                           PATCH_MAP *patchMap,
+                           unsigned int numStartEvents=0,
+                           const cl_event* startEvents=NULL,
+                           cl_event* endEvent=NULL) const {
+
+        return AdvectPatchCoords(numSamples,
+                                 faceIds->BindCLBuffer(_clCommandQueue),
+                                 u->BindCLBuffer(_clCommandQueue),
+                                 v->BindCLBuffer(_clCommandQueue),
+                                 velocities->BindCLBuffer(_clCommandQueue),
+                                 step,
+                                 adjacency->GetNumFaces(),
+                                 adjacency->GetAdjacencyBuffer(),
+                                 patchCoords->BindCLBuffer(_clCommandQueue),
+                                 patchMap->GetNumFaces(),
+                                 patchMap->GetFaceBuffer(),
+                                 patchMap->GetNodeBuffer(),
+                                 patchMap->GetHandleBuffer(),
+                                 numStartEvents, startEvents, endEvent);
+    }
+
+    bool AdvectPatchCoords(int numSamples,
+                           cl_mem faceIds, cl_mem u, cl_mem v,
+                           cl_mem velocities,
+                           float step,
+                           int numPtexFaces,
+                           cl_mem adjacencyBuffer,
+                           cl_mem patchCoordsBuffer,
+                           int numFaces,
+                           cl_mem faceBuffer,
+                           cl_mem nodeBuffer,
+                           cl_mem handleBuffer,
+                           unsigned int numStartEvents=0,
+                           const cl_event* startEvents=NULL,
+                           cl_event* endEvent=NULL) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Keyframe blending
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static keyframe blending function. Interpolates the
+    ///        control vertices of an animation between two of its keyframes
+    ///        on the device (see CpuEvaluator::BlendKeyframes) : keyframes
+    ///        uploaded once are played back without per-frame transfers.
+    ///
+    /// @param keyBuffer      Input buffer of the keyframes : vertex i of
+    ///                       keyframe k is vertex (k * numVertices + i).
+    ///                       must have BindCLBuffer() method returning the
+    ///                       cl_mem object for read
+    ///
+    /// @param keyDesc        vertex buffer descriptor for the keyframes (the
+    ///                       source descriptor of the instance)
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCLBuffer() method returning the
+    ///                       cl_mem object for results to be written
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numVertices    number of vertices of a keyframe
+    ///
+    /// @param key0, key1     keyframes to blend
+    ///
+    /// @param weight         blend weight of key1 (0 returns key0)
+    ///
+    /// @param instance, deviceContext  see EvalStencils
+    ///
+    /// @param numStartEvents, startEvents, endEvent  see EvalStencils
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename DEVICE_CONTEXT>
+    static bool BlendKeyframes(
+        SRC_BUFFER *keyBuffer, BufferDescriptor const &keyDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight,
+        CLEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext,
+        unsigned int numStartEvents=0,
+        const cl_event* startEvents=NULL,
+        cl_event* endEvent=NULL) {
+
+        // Create an instance on demand (slow)
+        CLEvaluator const *kernel = instance ? instance :
+            Create(keyDesc, dstDesc, BufferDescriptor(), BufferDescriptor(),
+                   deviceContext);
+        if (!kernel) return false;
+
+        cl_command_queue queue = kernel->_clCommandQueue;
+        bool r = kernel->BlendKeyframes(keyBuffer->BindCLBuffer(queue), keyDesc,
+                                        dstBuffer->BindCLBuffer(queue), dstDesc,
+                                        numVertices, key0, key1, weight,
+                                        numStartEvents, startEvents, endEvent);
+        if (kernel != instance) delete kernel;
+        return r;
+    }
+
+    /// \brief Dispatches the keyframe blending kernel on the cl_mem buffers
+    ///        of the keyframes and of the output vertices
+    ///
+    bool BlendKeyframes(cl_mem keys, BufferDescriptor const &keyDesc,
+                        cl_mem dst, BufferDescriptor const &dstDesc,
+                        int numVertices, int key0, int key1, float weight,
+                        unsigned int numStartEvents=0,
+                        const cl_event* startEvents=NULL,
+                        cl_event* endEvent=NULL) const;
+
     /// ----------------------------------------------------------------------
     ///
     ///   Other methods
@@ -746,12 +1448,40 @@ public:
     static void Synchronize(cl_command_queue queue);
 
 private:
+    bool evalPatches(cl_mem src, BufferDescriptor const &srcDesc,
+                     cl_mem dst, BufferDescriptor const &dstDesc,
+                     cl_mem du,  BufferDescriptor const &duDesc,
+                     cl_mem dv,  BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     cl_mem patchCoordsBuffer,
+                     cl_mem patchArrayBuffer,
+                     cl_mem patchIndexBuffer,
+                     cl_mem patchParamsBuffer,
+                     int evalMode,
+                     CLDisplacementTexture const *displacement,
+                     float displacementScale,
+                     unsigned int numStartEvents,
+                     const cl_event* startEvents,
+                     cl_event* endEvent) const;
+
+    // primvar classes evaluated by the patch kernel (evalMode)
+    enum EvalMode {
+        EVAL_VERTEX = 0,
+        EVAL_FACE_VARYING,
+        EVAL_VARYING,
+        EVAL_FACE_UNIFORM
+    };
+
     cl_context _clContext;
     cl_command_queue _clCommandQueue;
     cl_program _program;
     cl_kernel _stencilKernel;
     cl_kernel _stencilDerivKernel;
+    cl_kernel _stencilBatchKernel;
     cl_kernel _patchKernel;
+    cl_kernel _findPatchesKernel;
+    cl_kernel _advectPatchesKernel;
+    cl_kernel _blendKeyframesKernel;
 };
 
 
@@ -23,8 +23,10 @@
 //
 
 #include "../osd/clGLVertexBuffer.h"
+#include "../far/profile.h"
 
 #include <cassert>
+#include <vector>
 
 #include "../osd/opengl.h"
 
@@ -59,13 +61,20 @@ CLGLVertexBuffer::Create(int numElements, int numVertices, cl_context clContext)
 
 void
 CLGLVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
-                             cl_command_queue queue) {
+                             cl_command_queue queue,
+                             cl_event* startEvents, unsigned int numStartEvents,
+                             cl_event* endEvent) {
+
+    OPENSUBDIV_PROFILE_ZONE("CLGLVertexBuffer::UpdateData");
 
     size_t size = numVertices * _numElements * sizeof(float);
     size_t offset = startVertex * _numElements * sizeof(float);
 
     map(queue);
-    clEnqueueWriteBuffer(queue, _clMemory, true, offset, size, src, 0, NULL, NULL);
+
+    cl_bool blocking = (endEvent == NULL) ? CL_TRUE : CL_FALSE;
+    clEnqueueWriteBuffer(queue, _clMemory, blocking, offset, size, src,
+                         numStartEvents, startEvents, endEvent);
 }
 
 int
@@ -94,6 +103,65 @@ CLGLVertexBuffer::BindVBO(void * /*deviceContext*/) {
     return _vbo;
 }
 
+void
+CLGLVertexBuffer::ReleaseGLBuffer(cl_event* startEvents,
+                                  unsigned int numStartEvents,
+                                  cl_event* endEvent) {
+
+    if (not _clMapped and endEvent) {
+        *endEvent = NULL;
+    }
+    unmap(startEvents, numStartEvents, endEvent);
+}
+
+void
+CLGLVertexBuffer::MapBuffers(CLGLVertexBuffer * const * buffers, int numBuffers,
+                             cl_command_queue queue) {
+
+    std::vector<cl_mem> memObjects;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i] && not buffers[i]->_clMapped) {
+            memObjects.push_back(buffers[i]->_clMemory);
+            buffers[i]->_clQueue = queue;
+            buffers[i]->_clMapped = true;
+        }
+    }
+    if (memObjects.empty()) return;
+
+    clEnqueueAcquireGLObjects(queue, (cl_uint)memObjects.size(),
+                              &memObjects[0], 0, 0, 0);
+}
+
+void
+CLGLVertexBuffer::UnmapBuffers(CLGLVertexBuffer * const * buffers,
+                               int numBuffers,
+                               cl_event* startEvents,
+                               unsigned int numStartEvents,
+                               cl_event* endEvent) {
+
+    cl_command_queue queue = 0;
+    std::vector<cl_mem> memObjects;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (not buffers[i] or not buffers[i]->_clMapped) continue;
+        if (not queue) {
+            queue = buffers[i]->_clQueue;
+        }
+        if (buffers[i]->_clQueue == queue) {
+            memObjects.push_back(buffers[i]->_clMemory);
+            buffers[i]->_clMapped = false;
+        } else {
+            buffers[i]->unmap();
+        }
+    }
+    if (memObjects.empty()) {
+        if (endEvent) *endEvent = NULL;
+        return;
+    }
+    clEnqueueReleaseGLObjects(queue, (cl_uint)memObjects.size(),
+                              &memObjects[0],
+                              numStartEvents, startEvents, endEvent);
+}
+
 bool
 CLGLVertexBuffer::allocate(cl_context clContext) {
 
@@ -136,10 +204,12 @@ CLGLVertexBuffer::map(cl_command_queue queue) {
 }
 
 void
-CLGLVertexBuffer::unmap() {
+CLGLVertexBuffer::unmap(cl_event* startEvents, unsigned int numStartEvents,
+                        cl_event* endEvent) {
 
     if (not _clMapped) return;
-    clEnqueueReleaseGLObjects(_clQueue, 1, &_clMemory, 0, 0, 0);
+    clEnqueueReleaseGLObjects(_clQueue, 1, &_clMemory,
+                              numStartEvents, startEvents, endEvent);
     _clMapped = false;
 }
 
@@ -62,13 +62,21 @@ public:
 
     /// This method is meant to be used in client code in order to provide
     /// coarse vertices data to Osd.
+    ///
+    /// The write is non-blocking if endEvent is not NULL : 'src' must then
+    /// remain valid until endEvent has completed (see CLVertexBuffer).
     void UpdateData(const float *src, int startVertex, int numVertices,
-                    cl_command_queue clQueue);
+                    cl_command_queue clQueue,
+                    cl_event* startEvents = NULL, unsigned int numStartEvents = 0,
+                    cl_event* endEvent = NULL);
 
     template<typename DEVICE_CONTEXT>
     void UpdateData(const float *src, int startVertex, int numVertices,
-                    DEVICE_CONTEXT context) {
-        UpdateData(src, startVertex, numVertices, context->GetCommandQueue());
+                    DEVICE_CONTEXT context,
+                    cl_event* startEvents = NULL, unsigned int numStartEvents = 0,
+                    cl_event* endEvent = NULL) {
+        UpdateData(src, startVertex, numVertices, context->GetCommandQueue(),
+                   startEvents, numStartEvents, endEvent);
     }
 
     /// Returns how many elements defined in this vertex buffer.
@@ -85,6 +93,29 @@ public:
     /// space, it will be unmapped back to GL.
     GLuint BindVBO(void *deviceContext = NULL);
 
+    /// Releases the buffer back to GL once startEvents have completed,
+    /// without blocking : GL must not use the buffer before endEvent has
+    /// completed. endEvent receives NULL if the buffer isn't mapped to CL
+    /// memory space.
+    void ReleaseGLBuffer(cl_event* startEvents = NULL,
+                         unsigned int numStartEvents = 0,
+                         cl_event* endEvent = NULL);
+
+    /// Acquires the GL buffers of 'buffers' (NULL entries and buffers already
+    /// mapped are skipped) to CL memory space in a single command on 'queue',
+    /// rather than on each BindCLBuffer.
+    static void MapBuffers(CLGLVertexBuffer * const * buffers, int numBuffers,
+                           cl_command_queue queue);
+
+    /// Releases the buffers back to GL in a single command once startEvents
+    /// have completed (see ReleaseGLBuffer). The buffers must have been mapped
+    /// on the same queue : buffers mapped on another one are released apart,
+    /// without events.
+    static void UnmapBuffers(CLGLVertexBuffer * const * buffers, int numBuffers,
+                             cl_event* startEvents = NULL,
+                             unsigned int numStartEvents = 0,
+                             cl_event* endEvent = NULL);
+
 protected:
     /// Constructor.
     CLGLVertexBuffer(int numElements, int numVertices, cl_context clContext);
@@ -97,7 +128,8 @@ protected:
     void map(cl_command_queue queue);
 
     /// Releases a resource to GL.
-    void unmap();
+    void unmap(cl_event* startEvents = NULL, unsigned int numStartEvents = 0,
+               cl_event* endEvent = NULL);
 
 private:
     int _numElements;
@@ -0,0 +1,97 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/clGpuTimer.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CLGpuTimer::CLGpuTimer() {
+    _events[0] = _events[1] = NULL;
+}
+
+CLGpuTimer::~CLGpuTimer() {
+    release();
+}
+
+void
+CLGpuTimer::release() {
+    for (int i = 0; i < 2; ++i) {
+        if (_events[i]) clReleaseEvent(_events[i]);
+        _events[i] = NULL;
+    }
+}
+
+void
+CLGpuTimer::Begin(void * deviceContext) {
+    release();
+    cl_command_queue queue = static_cast<cl_command_queue>(deviceContext);
+    if (queue == NULL) return;
+
+    // markers complete when all the commands enqueued before them have
+    clEnqueueMarkerWithWaitList(queue, 0, NULL, &_events[0]);
+}
+
+void
+CLGpuTimer::End(void * deviceContext) {
+    cl_command_queue queue = static_cast<cl_command_queue>(deviceContext);
+    if (queue == NULL or _events[0] == NULL) return;
+
+    if (_events[1]) clReleaseEvent(_events[1]);
+    clEnqueueMarkerWithWaitList(queue, 0, NULL, &_events[1]);
+    clFlush(queue);
+}
+
+double
+CLGpuTimer::GetElapsedTime(bool wait) {
+    if (_events[0] == NULL or _events[1] == NULL) return -1.0;
+
+    if (wait) {
+        clWaitForEvents(1, &_events[1]);
+    } else {
+        cl_int status = CL_QUEUED;
+        clGetEventInfo(_events[1], CL_EVENT_COMMAND_EXECUTION_STATUS,
+                       sizeof(status), &status, NULL);
+        if (status != CL_COMPLETE) return -1.0;
+    }
+
+    cl_ulong begin = 0, end = 0;
+    if (clGetEventProfilingInfo(_events[0], CL_PROFILING_COMMAND_END,
+            sizeof(begin), &begin, NULL) != CL_SUCCESS or
+        clGetEventProfilingInfo(_events[1], CL_PROFILING_COMMAND_END,
+            sizeof(end), &end, NULL) != CL_SUCCESS) {
+        return -1.0;
+    }
+
+    // nanoseconds
+    return (double)(end - begin) * 1.0e-6;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
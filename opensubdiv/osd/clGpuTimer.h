@@ -0,0 +1,78 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CL_GPU_TIMER_H
+#define OPENSUBDIV3_OSD_CL_GPU_TIMER_H
+
+#include "../version.h"
+
+#include "../osd/opencl.h"
+#include "../osd/gpuTimer.h"
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief GPU timer of the CLEvaluator, from the profiling of markers
+///        enqueued into the command queue of the evaluator
+///
+/// The deviceContext of Begin() and End() is the cl_command_queue of the
+/// evaluator, which must have been created with CL_QUEUE_PROFILING_ENABLE.
+///
+class CLGpuTimer : public GpuTimer, private NonCopyable<CLGpuTimer> {
+public:
+    /// \brief Constructor
+    CLGpuTimer();
+
+    /// \brief Destructor
+    virtual ~CLGpuTimer();
+
+    /// \brief Enqueues the start of the timed work into a cl_command_queue
+    virtual void Begin(void * deviceContext = 0);
+
+    /// \brief Enqueues the end of the timed work into a cl_command_queue
+    virtual void End(void * deviceContext = 0);
+
+    /// \brief Returns the time of the timed work in milliseconds (negative
+    ///        if the queue does not profile its commands)
+    virtual double GetElapsedTime(bool wait = true);
+
+private:
+    void release();
+
+    cl_event _events[2];
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_CL_GPU_TIMER_H
@@ -94,6 +94,57 @@ __kernel void computeStencils(
     writeVertex(dst, current, &v);
 }
 
+// the second dimension of the range is the instance of the batch
+__kernel void computeStencilsBatch(
+    __global float * src, int srcOffset,
+    __global float * dst, int dstOffset,
+    __global int * sizes,
+    __global int * offsets,
+    __global int * indices,
+    __global float * weights,
+    int batchStart, int batchEnd,
+    __global int * instanceOffsets) {
+
+    int current = get_global_id(0) + batchStart,
+        instance = get_global_id(1);
+
+    if (current>=batchEnd) {
+        return;
+    }
+
+    struct Vertex v;
+    clear(&v);
+
+    int size = sizes[current],
+        offset = offsets[current];
+
+    src += srcOffset + instanceOffsets[2*instance];
+    dst += dstOffset + instanceOffsets[2*instance+1];
+
+    for (int i=0; i<size; ++i) {
+        addWithWeight(&v, src, indices[offset+i], weights[offset+i]);
+    }
+
+    writeVertex(dst, current, &v);
+}
+
+// blends two keyframes of an animation, laid out as the source vertices
+__kernel void blendKeyframes(
+    __global float * keys, int key0Offset, int key1Offset,
+    __global float * dst, int dstOffset,
+    float weight) {
+
+    int current = get_global_id(0);
+
+    __global float *p0 = keys + key0Offset + current * SRC_STRIDE;
+    __global float *p1 = keys + key1Offset + current * SRC_STRIDE;
+
+    dst += dstOffset + current * DST_STRIDE;
+    for (int i = 0; i < LENGTH; ++i) {
+        dst[i] = p0[i] + (p1[i] - p0[i]) * weight;
+    }
+}
+
 __kernel void computeStencilsDerivatives(
     __global float * src, int srcOffset,
     __global float * dst, int dstOffset,
@@ -235,6 +286,72 @@ static void normalizePatchCoord(uint patchBits, float *uv) {
     uv[1] = (uv[1] - pv) / frac;
 }
 
+// primvar classes evaluated by computePatches (evalMode)
+#define EVAL_VERTEX        0
+#define EVAL_FACE_VARYING  1
+#define EVAL_VARYING       2  // bilinear on the corners of the patches
+#define EVAL_FACE_UNIFORM  3  // copy of the value of the base face
+
+// corners of the patches in their control vertices, for varying evaluation
+static int getPatchCorner(int patchType, int corner) {
+    const int regularCorners[4] = {5, 6, 10, 9};
+    const int gregoryBasisCorners[4] = {0, 5, 10, 15};
+    return (patchType == 6) ? regularCorners[corner] :
+           (patchType == 9) ? gregoryBasisCorners[corner] : corner;
+}
+
+// samples the texels of a displacement face bilinearly, clamped to the face
+// (see Osd::CpuDisplacementTexture)
+static void sampleDisplacement(__global int *faces, __global float *texels,
+                               int numFaces, int numChannels,
+                               int face, float u, float v, float *d) {
+    d[0] = d[1] = d[2] = 0.0f;
+    if (face < 0 || face >= numFaces) return;
+
+    __global int *faceTexels = faces + 3 * face;
+    int uRes = faceTexels[1], vRes = faceTexels[2];
+
+    float x = fmin(fmax(u * uRes - 0.5f, 0.0f), (float)(uRes - 1));
+    float y = fmin(fmax(v * vRes - 0.5f, 0.0f), (float)(vRes - 1));
+    int x0 = (int)x, x1 = min(x0 + 1, uRes - 1);
+    int y0 = (int)y, y1 = min(y0 + 1, vRes - 1);
+    float fx = x - (float)x0, fy = y - (float)y0;
+
+    int n = numChannels;
+    __global float *t = texels + faceTexels[0] * n;
+    for (int k = 0; k < n; ++k) {
+        d[k] = (1.0f - fy) * ((1.0f - fx) * t[(y0 * uRes + x0) * n + k] +
+                                      fx  * t[(y0 * uRes + x1) * n + k]) +
+                       fy  * ((1.0f - fx) * t[(y1 * uRes + x0) * n + k] +
+                                      fx  * t[(y1 * uRes + x1) * n + k]);
+    }
+}
+
+// displaces a point along the normal or in the tangent frame of the surface
+static void displacePoint(float *p, float *du, float *dv, float *d,
+                          int numChannels, float scale) {
+    float n[3] = { du[1] * dv[2] - du[2] * dv[1],
+                   du[2] * dv[0] - du[0] * dv[2],
+                   du[0] * dv[1] - du[1] * dv[0] };
+    float nLength = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (nLength == 0.0f) return;
+    for (int k = 0; k < 3; ++k) n[k] /= nLength;
+
+    if (numChannels == 1) {
+        for (int k = 0; k < 3; ++k) p[k] += scale * d[0] * n[k];
+        return;
+    }
+    float tLength = sqrt(du[0] * du[0] + du[1] * du[1] + du[2] * du[2]);
+    if (tLength == 0.0f) return;
+    float t[3] = { du[0] / tLength, du[1] / tLength, du[2] / tLength };
+    float b[3] = { n[1] * t[2] - n[2] * t[1],
+                   n[2] * t[0] - n[0] * t[2],
+                   n[0] * t[1] - n[1] * t[0] };
+    for (int k = 0; k < 3; ++k) {
+        p[k] += scale * (d[0] * t[k] + d[1] * b[k] + d[2] * n[k]);
+    }
+}
+
 __kernel void computePatches(__global float *src, int srcOffset,
                              __global float *dst, int dstOffset,
                              __global float *du,  int duOffset, int duStride,
@@ -242,7 +359,13 @@ __kernel void computePatches(__global float *src, int srcOffset,
                              __global struct PatchCoord *patchCoords,
                              __global struct PatchArray *patchArrayBuffer,
                              __global int *patchIndexBuffer,
-                             __global struct PatchParam *patchParamBuffer) {
+                             __global struct PatchParam *patchParamBuffer,
+                             int evalMode,
+                             __global int *displacementFaces,
+                             __global float *displacementTexels,
+                             int numDisplacementFaces,
+                             int numDisplacementChannels,
+                             float displacementScale) {
     int current = get_global_id(0);
 
     if (src) src += srcOffset;
@@ -251,10 +374,34 @@ __kernel void computePatches(__global float *src, int srcOffset,
     if (dv)  dv += dvOffset;
 
     struct PatchCoord coord = patchCoords[current];
+
+    if (evalMode == EVAL_FACE_UNIFORM) {
+        // note: the face id of the PatchParam is that of the ptex face
+        struct Vertex value;
+        clear(&value);
+        if (coord.patchIndex >= 0) {
+            int face = (int)(patchParamBuffer[coord.patchIndex].field0 & 0xfffffff);
+            addWithWeight(&value, src, face, 1.0f);
+        }
+        writeVertex(dst, current, &value);
+        return;
+    }
+
+    if (evalMode == EVAL_FACE_VARYING && coord.patchIndex >= 0) {
+        // map the vertex patch coord to the patches of the face-varying
+        // channel (see CpuGetFVarPatchCoords) : the patches of bicubic
+        // channels which are not regular use the second, bilinear array
+        bool bicubic = (patchArrayBuffer[0].patchType == 6);
+        uint bits = patchParamBuffer[coord.patchIndex].field1;
+        coord.arrayIndex = (bicubic && !((bits >> 5) & 0x1)) ? 1 : 0;
+        coord.vertIndex = coord.patchIndex * (bicubic ? 16 : 4);
+    }
     struct PatchArray array = patchArrayBuffer[coord.arrayIndex];
 
-    int patchType = 6; // array.patchType XXX: REGULAR only for now.
-    int numControlVertices = 16;
+    // XXX: REGULAR only for now, besides bilinear face-varying patches
+    //      and varying evaluation (bilinear on the corners of any patch)
+    int patchType = (array.patchType == 3 || evalMode == EVAL_VARYING) ? 3 : 6;
+    int numControlVertices = (patchType == 3) ? 4 : 16;
     uint patchBits = patchParamBuffer[coord.patchIndex].field1;
 
     float uv[2] = {coord.s, coord.t};
@@ -277,25 +424,72 @@ __kernel void computePatches(__global float *src, int srcOffset,
                 wDt[4*k+l] = sWeights[l]  * dtWeights[k] * dScale;
             }
         }
+    } else if (patchType == 3) {  // QUADS
+        float sC = 1.0f - uv[0], tC = 1.0f - uv[1];
+
+        wP[0] = sC * tC;
+        wP[1] = uv[0] * tC;
+        wP[2] = uv[0] * uv[1];
+        wP[3] = sC * uv[1];
+
+        wDs[0] = -tC * dScale;
+        wDs[1] =  tC * dScale;
+        wDs[2] =  uv[1] * dScale;
+        wDs[3] = -uv[1] * dScale;
+
+        wDt[0] = -sC * dScale;
+        wDt[1] = -uv[0] * dScale;
+        wDt[2] =  uv[0] * dScale;
+        wDt[3] =  sC * dScale;
     } else {
         // TODO: GREGORY BASIS
     }
 
     int indexBase = array.indexBase + coord.vertIndex;
 
+    int cvs[20];
+    for (int i = 0; i < numControlVertices; ++i) {
+        cvs[i] = patchIndexBuffer[indexBase + ((evalMode == EVAL_VARYING) ?
+                                  getPatchCorner(array.patchType, i) : i)];
+    }
+
     struct Vertex v;
     clear(&v);
     for (int i = 0; i < numControlVertices; ++i) {
-        int index = patchIndexBuffer[indexBase + i];
+        int index = cvs[i];
         addWithWeight(&v, src, index, wP[i]);
     }
+
+#if LENGTH >= 3
+    // displacement of the point (its first 3 components), before it is
+    // written (see Osd::CpuDisplacementTexture)
+    if (displacementTexels && evalMode == EVAL_VERTEX &&
+        coord.patchIndex >= 0) {
+        float pDu[3] = {0.0f, 0.0f, 0.0f}, pDv[3] = {0.0f, 0.0f, 0.0f};
+        for (int i = 0; i < numControlVertices; ++i) {
+            __global float *cv = src + cvs[i] * SRC_STRIDE;
+            for (int k = 0; k < 3; ++k) {
+                pDu[k] += cv[k] * wDs[i];
+                pDv[k] += cv[k] * wDt[i];
+            }
+        }
+        // note: the face id of the PatchParam is that of the ptex face
+        int face = (int)(patchParamBuffer[coord.patchIndex].field0 & 0xfffffff);
+        float d[3];
+        sampleDisplacement(displacementFaces, displacementTexels,
+                           numDisplacementFaces, numDisplacementChannels,
+                           face, coord.s, coord.t, d);
+        displacePoint(v.v, pDu, pDv, d,
+                      numDisplacementChannels, displacementScale);
+    }
+#endif
     writeVertex(dst, current, &v);
 
     if (du) {
         struct Vertex vdu;
         clear(&vdu);
         for (int i = 0; i < numControlVertices; ++i) {
-            int index = patchIndexBuffer[indexBase + i];
+            int index = cvs[i];
             addWithWeight(&vdu, src, index, wDs[i]);
         }
         writeVertexStride(du, current, &vdu, duStride);
@@ -304,10 +498,166 @@ __kernel void computePatches(__global float *src, int srcOffset,
         struct Vertex vdv;
         clear(&vdv);
         for (int i = 0; i < numControlVertices; ++i) {
-            int index = patchIndexBuffer[indexBase + i];
+            int index = cvs[i];
             addWithWeight(&vdv, src, index, wDt[i]);
         }
         writeVertexStride(dv, current, &vdv, dvStride);
     }
 
 }
+
+// ---------------------------------------------------------------------------
+
+struct PatchCoord findPatchCoord(int faceId, float u, float v,
+                                 int numFaces,
+                                 __global int *faceBuffer,
+                                 __global uint *nodeBuffer,
+                                 __global int *handleBuffer) {
+
+    struct PatchCoord coord;
+    coord.arrayIndex = 0;
+    coord.patchIndex = -1;
+    coord.vertIndex = 0;
+    coord.s = u;
+    coord.t = v;
+
+    if (faceId >= 0 && faceId < numFaces) {
+
+        // direct lookup of the grid cell (see Far::PatchMap::findCell)
+        int res = 1 << faceBuffer[2*faceId+1];
+
+        float scale = (float)res,
+              s = coord.s,
+              t = coord.t;
+
+        int col = min((int)(s * scale), res-1),
+            row = min((int)(t * scale), res-1);
+
+        s -= (float)col / scale;
+        t -= (float)row / scale;
+
+        float half = 0.5f / scale;
+
+        uint node = nodeBuffer[faceBuffer[2*faceId] + row*res + col];
+
+        // descend the quadtree nodes
+        while ((node & 3) == 1) {
+            int quadrant;
+            if (s < half) {
+                quadrant = (t < half) ? 0 : 1;
+            } else {
+                quadrant = (t < half) ? 3 : 2;
+                s -= half;
+            }
+            if (t >= half) t -= half;
+
+            node = nodeBuffer[(node >> 2) + quadrant];
+            half *= 0.5f;
+        }
+
+        if ((node & 3) == 3) {
+            int handle = 3*(int)(node >> 2);
+            coord.arrayIndex = handleBuffer[handle];
+            coord.patchIndex = handleBuffer[handle+1];
+            coord.vertIndex  = handleBuffer[handle+2];
+        }
+    }
+    return coord;
+}
+
+__kernel void findPatchCoords(__global int *faceIds,
+                              __global float *u, __global float *v,
+                              __global struct PatchCoord *patchCoords,
+                              int numFaces,
+                              __global int *faceBuffer,
+                              __global uint *nodeBuffer,
+                              __global int *handleBuffer) {
+    int current = get_global_id(0);
+
+    patchCoords[current] = findPatchCoord(faceIds[current],
+                                          u[current], v[current], numFaces,
+                                          faceBuffer, nodeBuffer, handleBuffer);
+}
+
+// ---------------------------------------------------------------------------
+
+// Moves the (faceId, u, v) samples by their velocities, warping them across
+// the edges of their ptex faces (see Osd::CpuAdvectSamples), and maps them
+// to PatchCoords (see findPatchCoords) in the same kernel
+__kernel void advectPatchCoords(__global int *faceIds,
+                                __global float *u, __global float *v,
+                                __global float2 *velocities,
+                                float step,
+                                int numPtexFaces,
+                                __global int *adjacencyBuffer,
+                                __global struct PatchCoord *patchCoords,
+                                int numFaces,
+                                __global int *faceBuffer,
+                                __global uint *nodeBuffer,
+                                __global int *handleBuffer) {
+    int current = get_global_id(0);
+
+    int face = faceIds[current];
+
+    float2 velocity = velocities[current];
+    float ds = velocity.x,
+          dt = velocity.y,
+          s = u[current],
+          t = v[current],
+          tmp;
+
+    if (face >= 0 && face < numPtexFaces) {
+        s += ds * step;
+        t += dt * step;
+
+        int edge = -1;
+        if (s >= 1.0f) edge = 1;
+        if (s <= 0.0f) edge = 3;
+        if (t >= 1.0f) edge = 2;
+        if (t <= 0.0f) edge = 0;
+
+        if (edge >= 0) {
+            int flags = adjacencyBuffer[5*face+4],
+                adjFace = adjacencyBuffer[5*face+edge],
+                adjEdge = (flags >> (2*edge)) & 3;
+
+            if (adjFace < 0 || adjFace >= numPtexFaces ||
+                ((flags ^ adjacencyBuffer[5*adjFace+4]) & (1 << 8))) {
+                // bounce off the edge
+                switch (edge) {
+                    case 0: t = -t;        dt = -dt; break;
+                    case 1: s = 2.0f - s;  ds = -ds; break;
+                    case 2: t = 2.0f - t;  dt = -dt; break;
+                    case 3: s = -s;        ds = -ds; break;
+                }
+            } else {
+                // warp into the frame of the adjacent face
+                if (s <  0.0f) s += 1.0f;
+                if (s >= 1.0f) s -= 1.0f;
+                if (t <  0.0f) t += 1.0f;
+                if (t >= 1.0f) t -= 1.0f;
+                switch ((edge - adjEdge + 2) & 3) {
+                    case 1: s = 1.0f - s; ds = -ds;
+                            tmp = s; s = t; t = tmp;
+                            tmp = ds; ds = dt; dt = tmp; break;
+                    case 2: s = 1.0f - s; ds = -ds;
+                            t = 1.0f - t; dt = -dt; break;
+                    case 3: t = 1.0f - t; dt = -dt;
+                            tmp = s; s = t; t = tmp;
+                            tmp = ds; ds = dt; dt = tmp; break;
+                }
+                face = adjFace;
+            }
+        }
+        s = clamp(s, 0.0f, 1.0f);
+        t = clamp(t, 0.0f, 1.0f);
+
+        faceIds[current] = face;
+        u[current] = s;
+        v[current] = t;
+        velocities[current] = (float2)(ds, dt);
+    }
+
+    patchCoords[current] = findPatchCoord(face, s, t, numFaces,
+                                          faceBuffer, nodeBuffer, handleBuffer);
+}
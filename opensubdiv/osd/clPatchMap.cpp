@@ -0,0 +1,101 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/clPatchMap.h"
+
+#include "../far/error.h"
+#include "../far/patchMap.h"
+#include "../osd/opencl.h"
+#include "../osd/cpuPatchMap.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CLPatchMap::CLPatchMap() :
+    _numFaces(0), _faceBuffer(NULL), _nodeBuffer(NULL), _handleBuffer(NULL) {
+}
+
+CLPatchMap::~CLPatchMap() {
+    if (_faceBuffer) clReleaseMemObject(_faceBuffer);
+    if (_nodeBuffer) clReleaseMemObject(_nodeBuffer);
+    if (_handleBuffer) clReleaseMemObject(_handleBuffer);
+}
+
+CLPatchMap *
+CLPatchMap::Create(Far::PatchMap const *farPatchMap,
+                   cl_context clContext) {
+    CLPatchMap *instance = new CLPatchMap();
+    if (instance->allocate(farPatchMap, clContext)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+CLPatchMap::allocate(Far::PatchMap const *farPatchMap, cl_context clContext) {
+    CpuPatchMap patchMap(farPatchMap);
+
+    _numFaces = patchMap.GetNumFaces();
+    if (_numFaces == 0) return true;
+
+    cl_int err = 0;
+    _faceBuffer = clCreateBuffer(clContext,
+                                 CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR,
+                                 2 * _numFaces * sizeof(int),
+                                 (void*)patchMap.GetFaceBuffer(),
+                                 &err);
+    if (err != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+        return false;
+    }
+
+    _nodeBuffer = clCreateBuffer(clContext,
+                                 CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR,
+                                 patchMap.GetNodeBufferSize() * sizeof(unsigned int),
+                                 (void*)patchMap.GetNodeBuffer(),
+                                 &err);
+    if (err != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+        return false;
+    }
+
+    _handleBuffer = clCreateBuffer(clContext,
+                                   CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR,
+                                   patchMap.GetHandleBufferSize() * sizeof(int),
+                                   (void*)patchMap.GetHandleBuffer(),
+                                   &err);
+    if (err != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+        return false;
+    }
+    return true;
+}
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
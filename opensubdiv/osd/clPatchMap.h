@@ -0,0 +1,95 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_CL_PATCH_MAP_H
+#define OPENSUBDIV3_OSD_CL_PATCH_MAP_H
+
+#include "../version.h"
+
+#include "../osd/opencl.h"
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class PatchMap;
+};
+
+namespace Osd {
+
+/// \brief OpenCL patch map
+///
+/// This class is an OpenCL buffer representation of Far::PatchMap (see
+/// CpuPatchMap), so that CLEvaluator::FindPatchCoords maps (faceId, u, v)
+/// locations to PatchCoords on the device.
+///
+class CLPatchMap : private NonCopyable<CLPatchMap> {
+public:
+    /// Creator. Returns NULL if error
+    static CLPatchMap *Create(Far::PatchMap const *patchMap,
+                              cl_context clContext);
+
+    template <typename DEVICE_CONTEXT>
+    static CLPatchMap * Create(Far::PatchMap const *patchMap,
+                               DEVICE_CONTEXT context) {
+        return Create(patchMap, context->GetContext());
+    }
+
+    /// Destructor
+    ~CLPatchMap();
+
+    /// Returns the number of faces of the map
+    int GetNumFaces() const { return _numFaces; }
+
+    /// Returns the CL memory of the (first cell, grid depth) pairs of the
+    /// faces
+    cl_mem GetFaceBuffer() const { return _faceBuffer; }
+
+    /// Returns the CL memory of the grid cells and quadtree nodes
+    cl_mem GetNodeBuffer() const { return _nodeBuffer; }
+
+    /// Returns the CL memory of the patch handles
+    cl_mem GetHandleBuffer() const { return _handleBuffer; }
+
+protected:
+    CLPatchMap();
+
+    bool allocate(Far::PatchMap const *patchMap, cl_context clContext);
+
+    int _numFaces;
+    cl_mem _faceBuffer;
+    cl_mem _nodeBuffer;
+    cl_mem _handleBuffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CL_PATCH_MAP_H
@@ -42,6 +42,11 @@ CLPatchTable::~CLPatchTable() {
     if (_patchArrays) clReleaseMemObject(_patchArrays);
     if (_indexBuffer) clReleaseMemObject(_indexBuffer);
     if (_patchParamBuffer) clReleaseMemObject(_patchParamBuffer);
+    for (size_t i = 0; i < _fvarPatchArrays.size(); ++i) {
+        if (_fvarPatchArrays[i]) clReleaseMemObject(_fvarPatchArrays[i]);
+        if (_fvarIndexBuffers[i]) clReleaseMemObject(_fvarIndexBuffers[i]);
+        if (_fvarParamBuffers[i]) clReleaseMemObject(_fvarParamBuffers[i]);
+    }
 }
 
 CLPatchTable *
@@ -91,6 +96,44 @@ CLPatchTable::allocate(Far::PatchTable const *farPatchTable, cl_context clContex
         Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
         return false;
     }
+
+    // face-varying channels
+    int numFVarChannels = patchTable.GetNumFVarChannels();
+    _fvarPatchArrays.resize(numFVarChannels, NULL);
+    _fvarIndexBuffers.resize(numFVarChannels, NULL);
+    _fvarParamBuffers.resize(numFVarChannels, NULL);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        size_t fvarIndexSize = patchTable.GetFVarPatchIndexSize(channel);
+        size_t fvarParamSize = patchTable.GetFVarPatchParamSize(channel);
+        if (fvarIndexSize == 0 || fvarParamSize == 0) continue;
+
+        _fvarPatchArrays[channel] = clCreateBuffer(clContext,
+            CL_MEM_READ_WRITE|CL_MEM_COPY_HOST_PTR,
+            2 * sizeof(Osd::PatchArray),
+            (void*)patchTable.GetFVarPatchArrayBuffer(channel), &err);
+        if (err != CL_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+            return false;
+        }
+
+        _fvarIndexBuffers[channel] = clCreateBuffer(clContext,
+            CL_MEM_READ_WRITE|CL_MEM_COPY_HOST_PTR,
+            fvarIndexSize * sizeof(int),
+            (void*)patchTable.GetFVarPatchIndexBuffer(channel), &err);
+        if (err != CL_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+            return false;
+        }
+
+        _fvarParamBuffers[channel] = clCreateBuffer(clContext,
+            CL_MEM_READ_WRITE|CL_MEM_COPY_HOST_PTR,
+            fvarParamSize * sizeof(Osd::PatchParam),
+            (void*)patchTable.GetFVarPatchParamBuffer(channel), &err);
+        if (err != CL_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+            return false;
+        }
+    }
     return true;
 }
 
@@ -31,6 +31,8 @@
 #include "../osd/nonCopyable.h"
 #include "../osd/types.h"
 
+#include <vector>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -71,6 +73,26 @@ public:
     /// Returns the CL memory of the array of Osd::PatchParam buffer
     cl_mem GetPatchParamBuffer() const { return _patchParamBuffer; }
 
+    /// Returns the CL memory of the Osd::PatchArray buffer of a face-varying
+    /// channel (see CpuPatchTable::GetFVarPatchArrayBuffer)
+    cl_mem GetFVarPatchArrayBuffer(int fvarChannel = 0) const {
+        return _fvarPatchArrays[fvarChannel];
+    }
+
+    /// Returns the CL memory of the face-varying values of a channel
+    cl_mem GetFVarPatchIndexBuffer(int fvarChannel = 0) const {
+        return _fvarIndexBuffers[fvarChannel];
+    }
+
+    /// Returns the CL memory of the face-varying Osd::PatchParam buffer of a
+    /// channel
+    cl_mem GetFVarPatchParamBuffer(int fvarChannel = 0) const {
+        return _fvarParamBuffers[fvarChannel];
+    }
+
+    /// Returns the number of face-varying channels
+    int GetNumFVarChannels() const { return (int)_fvarPatchArrays.size(); }
+
 protected:
     CLPatchTable();
 
@@ -79,6 +101,10 @@ protected:
     cl_mem _patchArrays;
     cl_mem _indexBuffer;
     cl_mem _patchParamBuffer;
+
+    std::vector<cl_mem> _fvarPatchArrays;
+    std::vector<cl_mem> _fvarIndexBuffers;
+    std::vector<cl_mem> _fvarParamBuffers;
 };
 
 }  // end namespace Osd
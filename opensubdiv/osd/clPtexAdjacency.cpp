@@ -0,0 +1,80 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+
+#include "../osd/clPtexAdjacency.h"
+
+#include "../far/error.h"
+#include "../osd/opencl.h"
+#include "../osd/cpuPtexAdjacency.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CLPtexAdjacency::CLPtexAdjacency() :
+    _numFaces(0), _adjacencyBuffer(NULL) {
+}
+
+CLPtexAdjacency::~CLPtexAdjacency() {
+    if (_adjacencyBuffer) clReleaseMemObject(_adjacencyBuffer);
+}
+
+CLPtexAdjacency *
+CLPtexAdjacency::Create(Far::TopologyRefiner const &refiner,
+                        cl_context clContext) {
+    CLPtexAdjacency *instance = new CLPtexAdjacency();
+    if (instance->allocate(refiner, clContext)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+CLPtexAdjacency::allocate(Far::TopologyRefiner const &refiner,
+                          cl_context clContext) {
+    CpuPtexAdjacency adjacency(refiner);
+
+    _numFaces = adjacency.GetNumFaces();
+    if (_numFaces == 0) return true;
+
+    cl_int err = 0;
+    _adjacencyBuffer = clCreateBuffer(clContext,
+                                      CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR,
+                                      5 * _numFaces * sizeof(int),
+                                      (void*)adjacency.GetAdjacencyBuffer(),
+                                      &err);
+    if (err != CL_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "clCreateBuffer: %d", err);
+        return false;
+    }
+    return true;
+}
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
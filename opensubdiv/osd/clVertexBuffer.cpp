@@ -24,6 +24,7 @@
 //
 
 #include "../osd/clVertexBuffer.h"
+#include "../far/profile.h"
 
 #include <cassert>
 
@@ -57,6 +58,8 @@ void
 CLVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices, cl_command_queue queue,
     cl_event* startEvents, unsigned int numStartEvents, cl_event* endEvent) {
 
+    OPENSUBDIV_PROFILE_ZONE("CLVertexBuffer::UpdateData");
+
     size_t size = _numElements * numVertices * sizeof(float);
     size_t offset = startVertex * _numElements * sizeof(float);
 
@@ -0,0 +1,226 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+// Note : this file is compiled with AVX2 code generation enabled, and its
+// kernels are only called when the processor supports AVX2 (see cpuKernel.cpp)
+
+#include "../osd/cpuSimdKernel.h"
+
+#include <immintrin.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    // 8 floats per vector -- masked through the sign bits of 8 integers
+    struct AVX2 {
+
+        typedef float   Real;
+        typedef __m256  Vector;
+        typedef __m256i Mask;
+
+        enum { WIDTH = 8 };
+
+        static Mask TailMask(int numElems) {
+            return _mm256_cmpgt_epi32(_mm256_set1_epi32(numElems),
+                                      _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        }
+
+        static Vector Zero() { return _mm256_setzero_ps(); }
+
+        static Vector Broadcast(float value) { return _mm256_set1_ps(value); }
+
+        static Vector Load(float const * src) { return _mm256_loadu_ps(src); }
+
+        static Vector Load(float const * src, Mask mask) {
+            return _mm256_maskload_ps(src, mask);
+        }
+
+        static void Store(float * dst, Vector v) { _mm256_storeu_ps(dst, v); }
+
+        static void Store(float * dst, Mask mask, Vector v) {
+            _mm256_maskstore_ps(dst, mask, v);
+        }
+
+        static Vector AddWithWeight(Vector result, Vector src, Vector weight) {
+            return _mm256_add_ps(result, _mm256_mul_ps(src, weight));
+        }
+
+        // gathers of packed stencils
+        typedef __m256i Offsets;
+
+        static Offsets LoadOffsets(int const * indices, int stride) {
+            return _mm256_mullo_epi32(
+                _mm256_loadu_si256((__m256i const *)indices),
+                _mm256_set1_epi32(stride));
+        }
+
+        static Vector Gather(float const * src, Offsets offsets) {
+            return _mm256_i32gather_ps(src, offsets, sizeof(float));
+        }
+    };
+
+    // 4 doubles per vector -- masked through the sign bits of 4 integers
+    struct AVX2D {
+
+        typedef double  Real;
+        typedef __m256d Vector;
+        typedef __m256i Mask;
+
+        enum { WIDTH = 4 };
+
+        static Mask TailMask(int numElems) {
+            return _mm256_cmpgt_epi64(_mm256_set1_epi64x(numElems),
+                                      _mm256_setr_epi64x(0, 1, 2, 3));
+        }
+
+        static Vector Zero() { return _mm256_setzero_pd(); }
+
+        static Vector Broadcast(double value) { return _mm256_set1_pd(value); }
+
+        static Vector Load(double const * src) { return _mm256_loadu_pd(src); }
+
+        static Vector Load(double const * src, Mask mask) {
+            return _mm256_maskload_pd(src, mask);
+        }
+
+        static void Store(double * dst, Vector v) { _mm256_storeu_pd(dst, v); }
+
+        static void Store(double * dst, Mask mask, Vector v) {
+            _mm256_maskstore_pd(dst, mask, v);
+        }
+
+        static Vector AddWithWeight(Vector result, Vector src, Vector weight) {
+            return _mm256_add_pd(result, _mm256_mul_pd(src, weight));
+        }
+    };
+}
+
+void
+CpuEvalStencilsAVX2(float const * src, int srcStride,
+                    float * dst,       int dstStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    int numStencils) {
+
+    SimdEvalStencils<AVX2>(src, srcStride, dst, dstStride,
+        length, sizes, indices, weights, numStencils);
+}
+
+void
+CpuEvalStencilsAVX2(float const * src, int srcStride,
+                    float * dst,       int dstStride,
+                    float * dstDu,     int dstDuStride,
+                    float * dstDv,     int dstDvStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    float const * duWeights,
+                    float const * dvWeights,
+                    int numStencils) {
+
+    SimdEvalStencils<AVX2>(src, srcStride, dst, dstStride,
+        dstDu, dstDuStride, dstDv, dstDvStride,
+        length, sizes, indices, weights, duWeights, dvWeights, numStencils);
+}
+
+void
+CpuEvalStencilsAVX2(double const * src, int srcStride,
+                    double * dst,       int dstStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    int numStencils) {
+
+    SimdEvalStencils<AVX2D>(src, srcStride, dst, dstStride,
+        length, sizes, indices, weights, numStencils);
+}
+
+void
+CpuEvalStencilsAVX2(double const * src, int srcStride,
+                    double * dst,       int dstStride,
+                    double * dstDu,     int dstDuStride,
+                    double * dstDv,     int dstDvStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    float const * duWeights,
+                    float const * dvWeights,
+                    int numStencils) {
+
+    SimdEvalStencils<AVX2D>(src, srcStride, dst, dstStride,
+        dstDu, dstDuStride, dstDv, dstDvStride,
+        length, sizes, indices, weights, duWeights, dvWeights, numStencils);
+}
+
+void
+CpuEvalPackedStencilsAVX2(float const * src, int srcStride,
+                          float * dst,       int dstStride,
+                          int length,
+                          int blockWidth,
+                          int const * blockOffsets,
+                          int const * indices,
+                          float const * weights,
+                          int numStencils,
+                          int startBlock, int endBlock) {
+
+    SimdEvalPackedStencils<AVX2>(src, srcStride, dst, dstStride, length,
+        blockWidth, blockOffsets, indices, weights,
+        numStencils, startBlock, endBlock);
+}
+
+void
+CpuEvalPackedStencilsAVX2(float const * src, int srcStride,
+                          float * dst,       int dstStride,
+                          float * dstDu,     int dstDuStride,
+                          float * dstDv,     int dstDvStride,
+                          int length,
+                          int blockWidth,
+                          int const * blockOffsets,
+                          int const * indices,
+                          float const * weights,
+                          float const * duWeights,
+                          float const * dvWeights,
+                          int numStencils,
+                          int startBlock, int endBlock) {
+
+    SimdEvalPackedStencils<AVX2>(src, srcStride, dst, dstStride,
+        dstDu, dstDuStride, dstDv, dstDvStride, length,
+        blockWidth, blockOffsets, indices, weights, duWeights, dvWeights,
+        numStencils, startBlock, endBlock);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,226 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+// Note : this file is compiled with AVX-512 code generation enabled, and its
+// kernels are only called when the processor supports AVX-512 (see cpuKernel.cpp)
+
+#include "../osd/cpuSimdKernel.h"
+
+#include <immintrin.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    // 16 floats per vector -- masked through a 16 bit mask register
+    struct AVX512 {
+
+        typedef float     Real;
+        typedef __m512    Vector;
+        typedef __mmask16 Mask;
+
+        enum { WIDTH = 16 };
+
+        static Mask TailMask(int numElems) {
+            return (Mask)((1u << numElems) - 1);
+        }
+
+        static Vector Zero() { return _mm512_setzero_ps(); }
+
+        static Vector Broadcast(float value) { return _mm512_set1_ps(value); }
+
+        static Vector Load(float const * src) { return _mm512_loadu_ps(src); }
+
+        static Vector Load(float const * src, Mask mask) {
+            return _mm512_maskz_loadu_ps(mask, src);
+        }
+
+        static void Store(float * dst, Vector v) { _mm512_storeu_ps(dst, v); }
+
+        static void Store(float * dst, Mask mask, Vector v) {
+            _mm512_mask_storeu_ps(dst, mask, v);
+        }
+
+        static Vector AddWithWeight(Vector result, Vector src, Vector weight) {
+            return _mm512_add_ps(result, _mm512_mul_ps(src, weight));
+        }
+
+        // gathers of packed stencils
+        typedef __m512i Offsets;
+
+        static Offsets LoadOffsets(int const * indices, int stride) {
+            return _mm512_mullo_epi32(_mm512_loadu_si512(indices),
+                                      _mm512_set1_epi32(stride));
+        }
+
+        // (gathered into zeros rather than the undefined source operand of
+        //  _mm512_i32gather_ps())
+        static Vector Gather(float const * src, Offsets offsets) {
+            return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), (__mmask16)0xFFFF,
+                                            offsets, src, sizeof(float));
+        }
+    };
+
+    // 8 doubles per vector -- masked through an 8 bit mask register
+    struct AVX512D {
+
+        typedef double    Real;
+        typedef __m512d   Vector;
+        typedef __mmask8  Mask;
+
+        enum { WIDTH = 8 };
+
+        static Mask TailMask(int numElems) {
+            return (Mask)((1u << numElems) - 1);
+        }
+
+        static Vector Zero() { return _mm512_setzero_pd(); }
+
+        static Vector Broadcast(double value) { return _mm512_set1_pd(value); }
+
+        static Vector Load(double const * src) { return _mm512_loadu_pd(src); }
+
+        static Vector Load(double const * src, Mask mask) {
+            return _mm512_maskz_loadu_pd(mask, src);
+        }
+
+        static void Store(double * dst, Vector v) { _mm512_storeu_pd(dst, v); }
+
+        static void Store(double * dst, Mask mask, Vector v) {
+            _mm512_mask_storeu_pd(dst, mask, v);
+        }
+
+        static Vector AddWithWeight(Vector result, Vector src, Vector weight) {
+            return _mm512_add_pd(result, _mm512_mul_pd(src, weight));
+        }
+    };
+}
+
+void
+CpuEvalStencilsAVX512(float const * src, int srcStride,
+                    float * dst,       int dstStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    int numStencils) {
+
+    SimdEvalStencils<AVX512>(src, srcStride, dst, dstStride,
+        length, sizes, indices, weights, numStencils);
+}
+
+void
+CpuEvalStencilsAVX512(float const * src, int srcStride,
+                    float * dst,       int dstStride,
+                    float * dstDu,     int dstDuStride,
+                    float * dstDv,     int dstDvStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    float const * duWeights,
+                    float const * dvWeights,
+                    int numStencils) {
+
+    SimdEvalStencils<AVX512>(src, srcStride, dst, dstStride,
+        dstDu, dstDuStride, dstDv, dstDvStride,
+        length, sizes, indices, weights, duWeights, dvWeights, numStencils);
+}
+
+void
+CpuEvalStencilsAVX512(double const * src, int srcStride,
+                      double * dst,       int dstStride,
+                      int length,
+                      int const * sizes,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils) {
+
+    SimdEvalStencils<AVX512D>(src, srcStride, dst, dstStride,
+        length, sizes, indices, weights, numStencils);
+}
+
+void
+CpuEvalStencilsAVX512(double const * src, int srcStride,
+                      double * dst,       int dstStride,
+                      double * dstDu,     int dstDuStride,
+                      double * dstDv,     int dstDvStride,
+                      int length,
+                      int const * sizes,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils) {
+
+    SimdEvalStencils<AVX512D>(src, srcStride, dst, dstStride,
+        dstDu, dstDuStride, dstDv, dstDvStride,
+        length, sizes, indices, weights, duWeights, dvWeights, numStencils);
+}
+
+void
+CpuEvalPackedStencilsAVX512(float const * src, int srcStride,
+                            float * dst,       int dstStride,
+                            int length,
+                            int blockWidth,
+                            int const * blockOffsets,
+                            int const * indices,
+                            float const * weights,
+                            int numStencils,
+                            int startBlock, int endBlock) {
+
+    SimdEvalPackedStencils<AVX512>(src, srcStride, dst, dstStride, length,
+        blockWidth, blockOffsets, indices, weights,
+        numStencils, startBlock, endBlock);
+}
+
+void
+CpuEvalPackedStencilsAVX512(float const * src, int srcStride,
+                            float * dst,       int dstStride,
+                            float * dstDu,     int dstDuStride,
+                            float * dstDv,     int dstDvStride,
+                            int length,
+                            int blockWidth,
+                            int const * blockOffsets,
+                            int const * indices,
+                            float const * weights,
+                            float const * duWeights,
+                            float const * dvWeights,
+                            int numStencils,
+                            int startBlock, int endBlock) {
+
+    SimdEvalPackedStencils<AVX512>(src, srcStride, dst, dstStride,
+        dstDu, dstDuStride, dstDv, dstDvStride, length,
+        blockWidth, blockOffsets, indices, weights, duWeights, dvWeights,
+        numStencils, startBlock, endBlock);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,166 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuCompactStencilTable.h"
+#include "../far/stencilTable.h"
+
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    // Rounds to the nearest half precision float (ties to even)
+    unsigned short
+    floatToHalf(float value) {
+
+        unsigned int bits;
+        memcpy(&bits, &value, sizeof(float));
+
+        unsigned int sign = (bits >> 16) & 0x8000;
+        bits &= 0x7fffffff;
+
+        unsigned int half;
+        if (bits >= 0x47800000) {
+            // overflow to infinity, or NaN
+            half = bits > 0x7f800000 ? 0x7e00 : 0x7c00;
+        } else if (bits < 0x38800000) {
+            // denormal : let the fpu round the mantissa, aligned by a
+            // magic number so that it ends up in the low bits
+            unsigned int const magicBits = 126u << 23;
+            float magic, shifted;
+            memcpy(&magic, &magicBits, sizeof(float));
+            memcpy(&shifted, &bits, sizeof(float));
+            shifted += magic;
+            memcpy(&half, &shifted, sizeof(float));
+            half -= magicBits;
+        } else {
+            // normal : re-bias the exponent and round the mantissa
+            unsigned int odd = (bits >> 13) & 1;
+            bits += 0xc8000fff + odd;
+            half = bits >> 13;
+        }
+        return (unsigned short)(half | sign);
+    }
+
+    template <typename T> void
+    copyArray(std::vector<unsigned char> & dst, T const * src, int n) {
+        dst.resize(n * sizeof(T));
+        if (n > 0) {
+            memcpy(&dst[0], src, n * sizeof(T));
+        }
+    }
+}
+
+CpuCompactStencilTable::CpuCompactStencilTable(
+    Far::StencilTable const *stencilTable, WeightFormat weightFormat) :
+        _weightFormat(weightFormat), _byteSizes(false), _shortIndices(false) {
+
+    encode(stencilTable, 0, 0);
+}
+
+CpuCompactStencilTable::CpuCompactStencilTable(
+    Far::LimitStencilTable const *limitStencilTable, WeightFormat weightFormat) :
+        _weightFormat(weightFormat), _byteSizes(false), _shortIndices(false) {
+
+    encode(limitStencilTable, &limitStencilTable->GetDuWeights(),
+                              &limitStencilTable->GetDvWeights());
+}
+
+void
+CpuCompactStencilTable::encode(Far::StencilTable const *stencilTable,
+                               std::vector<float> const *duWeights,
+                               std::vector<float> const *dvWeights) {
+
+    std::vector<int> const & sizes = stencilTable->GetSizes();
+    std::vector<Far::Index> const & indices = stencilTable->GetControlIndices();
+
+    int numStencils = stencilTable->GetNumStencils(),
+        numWeights = (int)indices.size();
+
+    _offsets = stencilTable->GetOffsets();
+
+    int maxSize = 0;
+    for (int i=0; i<numStencils; ++i) {
+        if (sizes[i] > maxSize) maxSize = sizes[i];
+    }
+    _byteSizes = maxSize <= 0xff;
+    if (_byteSizes) {
+        std::vector<unsigned char> byteSizes(sizes.begin(), sizes.end());
+        copyArray(_sizes, numStencils ? &byteSizes[0] : 0, numStencils);
+    } else {
+        copyArray(_sizes, numStencils ? &sizes[0] : 0, numStencils);
+    }
+
+    Far::Index maxIndex = 0;
+    for (int i=0; i<numWeights; ++i) {
+        if (indices[i] > maxIndex) maxIndex = indices[i];
+    }
+    _shortIndices = maxIndex <= 0xffff;
+    if (_shortIndices) {
+        std::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+        copyArray(_indices, numWeights ? &shortIndices[0] : 0, numWeights);
+    } else {
+        copyArray(_indices, numWeights ? &indices[0] : 0, numWeights);
+    }
+
+    encodeWeights(stencilTable->GetWeights(), _weights);
+    if (duWeights and dvWeights) {
+        encodeWeights(*duWeights, _duWeights);
+        encodeWeights(*dvWeights, _dvWeights);
+    }
+}
+
+void
+CpuCompactStencilTable::encodeWeights(std::vector<float> const & weights,
+                                      std::vector<unsigned char> & encoded) const {
+
+    int numWeights = (int)weights.size();
+    if (numWeights == 0) {
+        encoded.clear();
+    } else if (_weightFormat == WEIGHTS_HALF) {
+        std::vector<unsigned short> halfWeights(numWeights);
+        for (int i=0; i<numWeights; ++i) {
+            halfWeights[i] = floatToHalf(weights[i]);
+        }
+        copyArray(encoded, &halfWeights[0], numWeights);
+    } else {
+        copyArray(encoded, &weights[0], numWeights);
+    }
+}
+
+size_t
+CpuCompactStencilTable::GetByteSize() const {
+
+    return _offsets.size() * sizeof(int) + _sizes.size() + _indices.size() +
+           _weights.size() + _duWeights.size() + _dvWeights.size();
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
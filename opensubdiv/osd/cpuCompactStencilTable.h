@@ -0,0 +1,153 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_COMPACT_STENCIL_TABLE_H
+#define OPENSUBDIV3_OSD_CPU_COMPACT_STENCIL_TABLE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class StencilTable;
+    class LimitStencilTable;
+}
+
+namespace Osd {
+
+/// \brief Stencil table with a compact encoding, for the CPU evaluators
+///
+/// This class is a copy of Far::StencilTable (or Far::LimitStencilTable)
+/// using the smallest storage its contents allow : stencil sizes are stored
+/// as 8 bit integers, and control vertex indices as 16 bit integers, when
+/// they fit. Weights can also be stored with half precision (16 bit) floats,
+/// which is lossy : weights keep about 3 significant decimal digits, and
+/// magnitudes below 3.0e-8 round to zero.
+///
+/// Compact tables are evaluated by CpuEvaluator, OmpEvaluator and
+/// TbbEvaluator, which decode them on the fly.
+///
+/// \note Stencil tables of several passes (see
+///       Far::StencilTable::GetPassOffsets()) are not supported.
+///
+class CpuCompactStencilTable {
+public:
+    enum WeightFormat {
+        WEIGHTS_FLOAT = 0,  ///< 32 bit weights (lossless)
+        WEIGHTS_HALF        ///< 16 bit weights
+    };
+
+    static CpuCompactStencilTable *Create(Far::StencilTable const *stencilTable,
+                                          void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuCompactStencilTable(stencilTable);
+    }
+
+    static CpuCompactStencilTable *Create(
+        Far::LimitStencilTable const *limitStencilTable,
+        void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuCompactStencilTable(limitStencilTable);
+    }
+
+    explicit CpuCompactStencilTable(Far::StencilTable const *stencilTable,
+                                    WeightFormat weightFormat = WEIGHTS_HALF);
+
+    explicit CpuCompactStencilTable(Far::LimitStencilTable const *limitStencilTable,
+                                    WeightFormat weightFormat = WEIGHTS_HALF);
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return (int)_offsets.size(); }
+
+    /// \brief Returns the format of the weights
+    WeightFormat GetWeightFormat() const { return _weightFormat; }
+
+    /// \brief Returns true if stencil sizes are stored as 8 bit integers
+    ///        (int otherwise)
+    bool HasByteSizes() const { return _byteSizes; }
+
+    /// \brief Returns true if control vertex indices are stored as 16 bit
+    ///        integers (int otherwise)
+    bool HasShortIndices() const { return _shortIndices; }
+
+    /// \brief Returns true if the table has derivative weights (limit
+    ///        stencils only)
+    bool HasDerivatives() const { return not _duWeights.empty(); }
+
+    /// \brief Returns the encoded stencil sizes
+    void const * GetSizes() const { return &_sizes[0]; }
+
+    /// \brief Returns the offset of each stencil (not encoded)
+    int const * GetOffsets() const { return &_offsets[0]; }
+
+    /// \brief Returns the encoded control vertex indices
+    void const * GetControlIndices() const { return &_indices[0]; }
+
+    /// \brief Returns the encoded stencil weights
+    void const * GetWeights() const { return &_weights[0]; }
+
+    /// \brief Returns the encoded u-derivative weights
+    void const * GetDuWeights() const { return &_duWeights[0]; }
+
+    /// \brief Returns the encoded v-derivative weights
+    void const * GetDvWeights() const { return &_dvWeights[0]; }
+
+    /// \brief Returns the size of the table data in bytes
+    size_t GetByteSize() const;
+
+private:
+    void encode(Far::StencilTable const *stencilTable,
+                std::vector<float> const *duWeights,
+                std::vector<float> const *dvWeights);
+
+    void encodeWeights(std::vector<float> const & weights,
+                       std::vector<unsigned char> & encoded) const;
+
+    WeightFormat _weightFormat;
+
+    bool _byteSizes,
+         _shortIndices;
+
+    std::vector<int> _offsets;
+
+    // type-less storage (operator new aligns it for any of the encodings)
+    std::vector<unsigned char> _sizes,
+                               _indices,
+                               _weights,
+                               _duWeights,
+                               _dvWeights;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_COMPACT_STENCIL_TABLE_H
@@ -24,6 +24,7 @@
 
 #include "../osd/cpuD3D11VertexBuffer.h"
 #include "../far/error.h"
+#include "../far/profile.h"
 
 #include <D3D11.h>
 #include <cassert>
@@ -64,6 +65,8 @@ CpuD3D11VertexBuffer::UpdateData(const float *src, int startVertex,
                                  int numVertices,
                                  void * /*deviceContext*/) {
 
+    OPENSUBDIV_PROFILE_ZONE("CpuD3D11VertexBuffer::UpdateData");
+
     memcpy(_cpuBuffer + startVertex * _numElements, src,
            _numElements * numVertices * sizeof(float));
 }
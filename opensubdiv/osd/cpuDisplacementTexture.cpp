@@ -0,0 +1,101 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuDisplacementTexture.h"
+
+#include <algorithm>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CpuDisplacementTexture::CpuDisplacementTexture(int numFaces,
+                                               const int *faceResolutions,
+                                               int numChannels,
+                                               const float *texels) :
+    _numChannels(numChannels), _callback(NULL), _callbackData(NULL) {
+
+    _faceBuffer.resize(3 * numFaces);
+
+    int numTexels = 0;
+    for (int face = 0; face < numFaces; ++face) {
+        int uRes = std::max(faceResolutions[2*face], 1),
+            vRes = std::max(faceResolutions[2*face+1], 1);
+        _faceBuffer[3*face]   = numTexels;
+        _faceBuffer[3*face+1] = uRes;
+        _faceBuffer[3*face+2] = vRes;
+        numTexels += uRes * vRes;
+    }
+    _texelBuffer.assign(texels, texels + numTexels * numChannels);
+}
+
+CpuDisplacementTexture::CpuDisplacementTexture(Callback callback,
+                                               void *callbackData,
+                                               int numChannels) :
+    _numChannels(numChannels),
+    _callback(callback), _callbackData(callbackData) {
+}
+
+void
+CpuDisplacementTexture::Sample(int face, float u, float v,
+                               float *displacement) const {
+
+    if (_callback) {
+        _callback(face, u, v, displacement, _callbackData);
+        return;
+    }
+    for (int k = 0; k < _numChannels; ++k) {
+        displacement[k] = 0.0f;
+    }
+    if (face < 0 || face >= GetNumFaces()) return;
+
+    int const * faceTexels = &_faceBuffer[3*face];
+    int uRes = faceTexels[1],
+        vRes = faceTexels[2];
+
+    // bilinear between the centers of the texels, clamped to the face
+    float x = std::min(std::max(u * uRes - 0.5f, 0.0f), (float)(uRes - 1)),
+          y = std::min(std::max(v * vRes - 0.5f, 0.0f), (float)(vRes - 1));
+    int x0 = (int)x, x1 = std::min(x0 + 1, uRes - 1),
+        y0 = (int)y, y1 = std::min(y0 + 1, vRes - 1);
+    float fx = x - (float)x0,
+          fy = y - (float)y0;
+
+    float const * texels = &_texelBuffer[faceTexels[0] * _numChannels];
+    float const * t00 = texels + (y0 * uRes + x0) * _numChannels,
+                * t10 = texels + (y0 * uRes + x1) * _numChannels,
+                * t01 = texels + (y1 * uRes + x0) * _numChannels,
+                * t11 = texels + (y1 * uRes + x1) * _numChannels;
+
+    for (int k = 0; k < _numChannels; ++k) {
+        displacement[k] = (1.0f - fy) * ((1.0f - fx) * t00[k] + fx * t10[k]) +
+                                  fy  * ((1.0f - fx) * t01[k] + fx * t11[k]);
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,144 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_DISPLACEMENT_TEXTURE_H
+#define OPENSUBDIV3_OSD_CPU_DISPLACEMENT_TEXTURE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief Cpu displacement texture
+///
+/// Displacement sampled by the evaluators right after the evaluation of the
+/// limit surface, in the same pass (see CpuEvaluator::EvalPatches) : scalar
+/// displacements (1 channel) move the limit points along the normal of the
+/// limit surface, and vector displacements (3 channels) are expressed in
+/// the tangent frame of the point (normalized dPdu, normal x dPdu, normal).
+///
+/// The displacement is either sampled from the texels of each ptex face
+/// (e.g. read from a Ptex file with PtexTexture::getData), or returned by
+/// a callback of the client. Texels are sampled bilinearly within their
+/// face, so the texels along the edges of adjacent faces should match for
+/// the displaced surface to be continuous.
+///
+/// The texels of each face are stored row after row (a row per texel in v),
+/// the channels of each texel together. Each face is encoded by 3 integers
+/// : the index of its first texel, and its resolution in u and in v.
+/// Device-specific textures use it as a staging buffer.
+///
+class CpuDisplacementTexture {
+public:
+    /// \brief Callback returning the displacement (numChannels values) at
+    ///        (u, v) on a ptex face
+    typedef void (*Callback)(int face, float u, float v,
+                             float *displacement, void *callbackData);
+
+    /// \brief Creates a texture of the texels of each ptex face
+    ///
+    /// @param numFaces         Number of ptex faces
+    ///
+    /// @param faceResolutions  Resolution of each face in u and v (2 integers
+    ///                         per face)
+    ///
+    /// @param numChannels      1 (scalar) or 3 (vector displacement)
+    ///
+    /// @param texels           Texels of the faces, face after face
+    ///
+    /// @param deviceContext    not used in the cpu texture
+    ///
+    static CpuDisplacementTexture *Create(int numFaces,
+                                          const int *faceResolutions,
+                                          int numChannels,
+                                          const float *texels,
+                                          void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        if (numChannels != 1 && numChannels != 3) return NULL;
+        return new CpuDisplacementTexture(numFaces, faceResolutions,
+                                          numChannels, texels);
+    }
+
+    /// \brief Creates a texture sampled by a callback of the client
+    static CpuDisplacementTexture *Create(Callback callback,
+                                          void *callbackData,
+                                          int numChannels) {
+        if (!callback || (numChannels != 1 && numChannels != 3)) return NULL;
+        return new CpuDisplacementTexture(callback, callbackData, numChannels);
+    }
+
+    CpuDisplacementTexture(int numFaces, const int *faceResolutions,
+                           int numChannels, const float *texels);
+
+    CpuDisplacementTexture(Callback callback, void *callbackData,
+                           int numChannels);
+
+    ~CpuDisplacementTexture() {}
+
+    /// \brief Returns the number of channels (1 or 3)
+    int GetNumChannels() const { return _numChannels; }
+
+    /// \brief Returns the number of ptex faces (0 for callbacks)
+    int GetNumFaces() const { return (int)_faceBuffer.size() / 3; }
+
+    /// \brief Returns the encoded faces (3 integers per face)
+    const int *GetFaceBuffer() const {
+        return _faceBuffer.empty() ? NULL : &_faceBuffer[0];
+    }
+
+    /// \brief Returns the texels of all the faces
+    const float *GetTexelBuffer() const {
+        return _texelBuffer.empty() ? NULL : &_texelBuffer[0];
+    }
+
+    /// \brief Returns the number of floats of the texels
+    int GetTexelBufferSize() const { return (int)_texelBuffer.size(); }
+
+    /// \brief Samples the displacement at (u, v) on a ptex face (zero
+    ///        outside of the faces of the texture)
+    void Sample(int face, float u, float v, float *displacement) const;
+
+protected:
+    int _numChannels;
+
+    std::vector<int>   _faceBuffer;
+    std::vector<float> _texelBuffer;
+
+    Callback _callback;
+    void *   _callbackData;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_DISPLACEMENT_TEXTURE_H
@@ -23,10 +23,17 @@
 //
 
 #include "../osd/cpuEvaluator.h"
+#include "../osd/cpuDisplacementTexture.h"
 #include "../osd/cpuKernel.h"
 #include "../far/patchBasis.h"
+#include "../far/profile.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -43,8 +50,13 @@ CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                            const float * weights,
                            int start, int end) {
 
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
     if (end <= start) return true;
     if (srcDesc.length != dstDesc.length) return false;
+    // planar destinations are stored as floats
+    if (dstDesc.IsPlanar() and
+        dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
 
     // XXX: we can probably expand cpuKernel.cpp to here.
     CpuEvalStencils(src, srcDesc, dst, dstDesc,
@@ -53,63 +65,851 @@ CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
     return true;
 }
 
+/* static */
+bool
+CpuEvaluator::EvalStencils(const double *src, BufferDescriptor const &srcDesc,
+                           double *dst,       BufferDescriptor const &dstDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const float * weights,
+                           int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    CpuEvalStencils(src, srcDesc, dst, dstDesc,
+                    sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(const double *src, BufferDescriptor const &srcDesc,
+                           double *dst,       BufferDescriptor const &dstDesc,
+                           double *du,        BufferDescriptor const &duDesc,
+                           double *dv,        BufferDescriptor const &dvDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const float * weights,
+                           const float * duWeights,
+                           const float * dvWeights,
+                           int start, int end) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    CpuEvalStencils(src, srcDesc,
+                    dst, dstDesc,
+                    du,  duDesc,
+                    dv,  dvDesc,
+                    sizes, offsets, indices,
+                    weights, duWeights, dvWeights,
+                    start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencilsBatch(const float *src, BufferDescriptor const &srcDesc,
+                                float *dst,       BufferDescriptor const &dstDesc,
+                                const int * sizes,
+                                const int * offsets,
+                                const int * indices,
+                                const float * weights,
+                                int start, int end,
+                                int numInstances, const int * instanceOffsets) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencilsBatch");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    CpuEvalStencilsBatch(src, srcDesc, dst, dstDesc,
+                         sizes, offsets, indices, weights, start, end,
+                         numInstances, instanceOffsets);
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
+                           float *dst,       BufferDescriptor const &dstDesc,
+                           float *du,        BufferDescriptor const &duDesc,
+                           float *dv,        BufferDescriptor const &dvDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const float * weights,
+                           const float * duWeights,
+                           const float * dvWeights,
+                           int start, int end) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+    // planar destinations are stored as floats
+    if ((dstDesc.IsPlanar() or duDesc.IsPlanar() or dvDesc.IsPlanar()) and
+        (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+         duDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+         dvDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    CpuEvalStencils(src, srcDesc,
+                    dst, dstDesc,
+                    du,  duDesc,
+                    dv,  dvDesc,
+                    sizes, offsets, indices,
+                    weights, duWeights, dvWeights,
+                    start, end);
+
+    return true;
+}
+
 /* static */
 bool
 CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                            float *dst,       BufferDescriptor const &dstDesc,
                            float *du,        BufferDescriptor const &duDesc,
                            float *dv,        BufferDescriptor const &dvDesc,
+                           float *duu,       BufferDescriptor const &duuDesc,
+                           float *duv,       BufferDescriptor const &duvDesc,
+                           float *dvv,       BufferDescriptor const &dvvDesc,
                            const int * sizes,
                            const int * offsets,
                            const int * indices,
                            const float * weights,
                            const float * duWeights,
                            const float * dvWeights,
+                           const float * duuWeights,
+                           const float * duvWeights,
+                           const float * dvvWeights,
                            int start, int end) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
     if (end <= start) return true;
     if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
     if (srcDesc.length != duDesc.length) return false;
     if (srcDesc.length != dvDesc.length) return false;
+    if (srcDesc.length != duuDesc.length) return false;
+    if (srcDesc.length != duvDesc.length) return false;
+    if (srcDesc.length != dvvDesc.length) return false;
 
     CpuEvalStencils(src, srcDesc,
                     dst, dstDesc,
                     du,  duDesc,
                     dv,  dvDesc,
+                    duu, duuDesc,
+                    duv, duvDesc,
+                    dvv, dvvDesc,
                     sizes, offsets, indices,
                     weights, duWeights, dvWeights,
+                    duuWeights, duvWeights, dvvWeights,
                     start, end);
 
     return true;
 }
 
-template <typename T>
-struct BufferAdapter {
-    BufferAdapter(T *p, int length, int stride) :
-        _p(p), _length(length), _stride(stride) { }
-    void Clear() {
-        for (int i = 0; i < _length; ++i) _p[i] = 0;
+/* static */
+bool
+CpuEvaluator::EvalStencilsWithNormals(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *normal,    BufferDescriptor const &normalDesc,
+    float *tangent,   BufferDescriptor const &tangentDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    int start, int end) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencilsWithNormals");
+
+    if (end <= start) return true;
+    if (not src or not normal) return false;
+    if (not duWeights or not dvWeights) return false;
+    // the normals are computed from the first 3 elements of the primvars
+    if (srcDesc.length < 3 or srcDesc.IsPlanar()) return false;
+    if (dst and (srcDesc.length != dstDesc.length or not weights or
+                 dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+                 dstDesc.IsPlanar())) return false;
+    if (normalDesc.length != 3 or normalDesc.IsPlanar() or
+        normalDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (tangent and (tangentDesc.length != 3 or tangentDesc.IsPlanar() or
+        tangentDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    CpuEvalStencilNormals(src, srcDesc,
+                          dst, dstDesc,
+                          normal, normalDesc,
+                          tangent, tangentDesc,
+                          sizes, offsets, indices,
+                          weights, duWeights, dvWeights,
+                          start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuPackedStencilTable const *stencilTable,
+    int startBlock, int endBlock) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (endBlock <= startBlock) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    CpuEvalPackedStencils(src, srcDesc, dst, dstDesc,
+        stencilTable->GetBlockWidth(),
+        &stencilTable->GetBlockOffsets()[0],
+        &stencilTable->GetControlIndices()[0],
+        &stencilTable->GetWeights()[0],
+        stencilTable->GetNumStencils(),
+        startBlock, endBlock);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuPackedStencilTable const *stencilTable,
+    int startBlock, int endBlock) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (endBlock <= startBlock) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    // derivative weights are only packed from limit stencil tables
+    if (stencilTable->GetDuWeights().empty()) return false;
+
+    CpuEvalPackedStencils(src, srcDesc,
+        dst, dstDesc,
+        du,  duDesc,
+        dv,  dvDesc,
+        stencilTable->GetBlockWidth(),
+        &stencilTable->GetBlockOffsets()[0],
+        &stencilTable->GetControlIndices()[0],
+        &stencilTable->GetWeights()[0],
+        &stencilTable->GetDuWeights()[0],
+        &stencilTable->GetDvWeights()[0],
+        stencilTable->GetNumStencils(),
+        startBlock, endBlock);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    CpuEvalCompactStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    // derivative weights are only encoded from limit stencil tables
+    if (not stencilTable->HasDerivatives()) return false;
+
+    CpuEvalCompactStencils(src, srcDesc,
+        dst, dstDesc,
+        du,  duDesc,
+        dv,  dvDesc,
+        *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuInstancedStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    CpuEvalInstancedStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuVaryingStencilTable const *stencilTable) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalStencils");
+
+    if (stencilTable->GetNumStencils() == 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    CpuEvalVaryingStencils(src, srcDesc, dst, dstDesc, *stencilTable);
+
+    return true;
+}
+
+namespace {
+
+// Patch coordinates are evaluated in blocks of coordinates on patches of the
+// same type : the basis weights of a block are transposed into the rows of a
+// packed stencil block (see CpuPackedStencilTable), so that the control
+// vertices of all its coordinates are gathered by a single evaluation of the
+// block with the SIMD kernels of the packed stencils.
+class PatchCoordBlock {
+public:
+    enum { WIDTH = 8, MAX_ROWS = 20 };
+
+    explicit PatchCoordBlock(int patchType) :
+        _patchType(patchType), _numCoords(0), _numRows(0) { }
+
+    bool IsFull() const { return _numCoords == WIDTH; }
+
+    // Adds the coordinate evaluated into row 'coordIndex' of the outputs
+    // (coordinates on patches of unsupported types are evaluated to zero)
+    void Add(int coordIndex, Far::PatchParam const & param,
+             float s, float t, int const * cvs);
+
+    // Evaluates the coordinates of the block (outputs other than dst may be
+    // NULL) and empties the block. Pointers are expected at the offset of
+    // their descriptor, and 'scratch' must hold 3*WIDTH primvars. The points
+    // are displaced by 'displacement' when given.
+    void Eval(float const * src, BufferDescriptor const & srcDesc,
+              float * dst,       BufferDescriptor const & dstDesc,
+              float * du,        BufferDescriptor const & duDesc,
+              float * dv,        BufferDescriptor const & dvDesc,
+              float * scratch,
+              CpuDisplacementTexture const * displacement = NULL,
+              float displacementScale = 1.0f);
+
+private:
+
+    void computeBSplineWeights();
+
+    int _patchType,
+        _numCoords,
+        _numRows;
+
+    int _coords[WIDTH];
+
+    // coordinates (the weights of B-spline coordinates are computed together)
+    Far::PatchParam _params[WIDTH];
+    float _s[WIDTH],
+          _t[WIDTH];
+
+    // transposed control vertex indices & weights (row * WIDTH + lane)
+    int   _indices[MAX_ROWS * WIDTH];
+    float _wP[MAX_ROWS * WIDTH],
+          _wDs[MAX_ROWS * WIDTH],
+          _wDt[MAX_ROWS * WIDTH];
+};
+
+void
+PatchCoordBlock::Add(int coordIndex, Far::PatchParam const & param,
+                     float s, float t, int const * cvs) {
+
+    assert(_numCoords < WIDTH);
+
+    int lane = _numCoords++;
+
+    _coords[lane] = coordIndex;
+
+    _params[lane] = param;
+    _s[lane] = s;
+    _t[lane] = t;
+
+    float wP[MAX_ROWS], wDs[MAX_ROWS], wDt[MAX_ROWS];
+
+    if (_patchType == Far::PatchDescriptor::REGULAR) {
+        _numRows = 16;
+    } else if (_patchType == Far::PatchDescriptor::GREGORY_BASIS) {
+        Far::internal::GetGregoryWeights(param, s, t, wP, wDs, wDt);
+        _numRows = 20;
+    } else if (_patchType == Far::PatchDescriptor::QUADS) {
+        Far::internal::GetBilinearWeights(param, s, t, wP, wDs, wDt);
+        _numRows = 4;
+    } else if (_patchType == Far::PatchDescriptor::LOOP) {
+        Far::internal::GetLoopWeights(param, s, t, wP, wDs, wDt);
+        _numRows = 12;
+    } else if (_patchType == Far::PatchDescriptor::TRIANGLES) {
+        Far::internal::GetTriangleWeights(param, s, t, wP, wDs, wDt);
+        _numRows = 3;
+    } else {
+        _numRows = 0;
+    }
+
+    for (int row = 0; row < _numRows; ++row) {
+        _indices[row * WIDTH + lane] = cvs[row];
+    }
+    if (_patchType != Far::PatchDescriptor::REGULAR) {
+        for (int row = 0; row < _numRows; ++row) {
+            _wP [row * WIDTH + lane] = wP[row];
+            _wDs[row * WIDTH + lane] = wDs[row];
+            _wDt[row * WIDTH + lane] = wDt[row];
+        }
+    }
+}
+
+// B-spline basis functions of the lanes (see Far::internal::Spline)
+static inline void
+getBSplineWeights(float const t[PatchCoordBlock::WIDTH],
+                  float point[4][PatchCoordBlock::WIDTH],
+                  float deriv[4][PatchCoordBlock::WIDTH]) {
+
+    float const one6th = 1.0f / 6.0f;
+
+    for (int lane = 0; lane < PatchCoordBlock::WIDTH; ++lane) {
+        float t1 = t[lane],
+              t2 = t1 * t1,
+              t3 = t1 * t2;
+
+        point[0][lane] = one6th * (1.0f - 3.0f*(t1 -      t2) -      t3);
+        point[1][lane] = one6th * (4.0f            - 6.0f*t2  + 3.0f*t3);
+        point[2][lane] = one6th * (1.0f + 3.0f*(t1 +      t2  -      t3));
+        point[3][lane] = one6th * (                                  t3);
+
+        deriv[0][lane] = -0.5f*t2 +      t1 - 0.5f;
+        deriv[1][lane] =  1.5f*t2 - 2.0f*t1;
+        deriv[2][lane] = -1.5f*t2 +      t1 + 0.5f;
+        deriv[3][lane] =  0.5f*t2;
+    }
+}
+
+// Boundary adjustments of the basis functions of the lanes
+// (see Far::internal::Spline::AdjustBoundaryWeights)
+static inline void
+adjustBoundaryWeights(int const boundary[PatchCoordBlock::WIDTH],
+                      float sWeights[4][PatchCoordBlock::WIDTH],
+                      float tWeights[4][PatchCoordBlock::WIDTH]) {
+
+    for (int lane = 0; lane < PatchCoordBlock::WIDTH; ++lane) {
+        float s0 = sWeights[0][lane], s1 = sWeights[1][lane],
+              s2 = sWeights[2][lane], s3 = sWeights[3][lane],
+              t0 = tWeights[0][lane], t1 = tWeights[1][lane],
+              t2 = tWeights[2][lane], t3 = tWeights[3][lane];
+
+        bool b0 = (boundary[lane] & 1) != 0,
+             b1 = (boundary[lane] & 2) != 0,
+             b2 = (boundary[lane] & 4) != 0,
+             b3 = (boundary[lane] & 8) != 0;
+
+        t2 = b0 ? t2 - t0 : t2;
+        t1 = b0 ? t1 + 2*t0 : t1;
+        t0 = b0 ? 0.0f : t0;
+
+        s1 = b1 ? s1 - s3 : s1;
+        s2 = b1 ? s2 + 2*s3 : s2;
+        s3 = b1 ? 0.0f : s3;
+
+        t1 = b2 ? t1 - t3 : t1;
+        t2 = b2 ? t2 + 2*t3 : t2;
+        t3 = b2 ? 0.0f : t3;
+
+        s2 = b3 ? s2 - s0 : s2;
+        s1 = b3 ? s1 + 2*s0 : s1;
+        s0 = b3 ? 0.0f : s0;
+
+        sWeights[0][lane] = s0; sWeights[1][lane] = s1;
+        sWeights[2][lane] = s2; sWeights[3][lane] = s3;
+        tWeights[0][lane] = t0; tWeights[1][lane] = t1;
+        tWeights[2][lane] = t2; tWeights[3][lane] = t3;
+    }
+}
+
+// Displaces a point (its first 3 components) by the displacement sampled at
+// (u, v) on a ptex face, along the normal of the surface or in its tangent
+// frame (see CpuDisplacementTexture)
+static inline void
+displacePoint(float * point, float const * du, float const * dv,
+              CpuDisplacementTexture const & displacement, float scale,
+              int face, float u, float v) {
+
+    float d[3] = { 0.0f, 0.0f, 0.0f };
+    displacement.Sample(face, u, v, d);
+
+    float n[3] = { du[1] * dv[2] - du[2] * dv[1],
+                   du[2] * dv[0] - du[0] * dv[2],
+                   du[0] * dv[1] - du[1] * dv[0] };
+    float nLength = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (nLength == 0.0f) return;
+    for (int k = 0; k < 3; ++k) n[k] /= nLength;
+
+    if (displacement.GetNumChannels() == 1) {
+        for (int k = 0; k < 3; ++k) point[k] += scale * d[0] * n[k];
+        return;
+    }
+
+    float tLength = std::sqrt(du[0] * du[0] + du[1] * du[1] + du[2] * du[2]);
+    if (tLength == 0.0f) return;
+    float t[3] = { du[0] / tLength, du[1] / tLength, du[2] / tLength };
+    float b[3] = { n[1] * t[2] - n[2] * t[1],
+                   n[2] * t[0] - n[0] * t[2],
+                   n[0] * t[1] - n[1] * t[0] };
+    for (int k = 0; k < 3; ++k) {
+        point[k] += scale * (d[0] * t[k] + d[1] * b[k] + d[2] * n[k]);
+    }
+}
+
+void
+PatchCoordBlock::computeBSplineWeights() {
+
+    // the lanes are computed together, with the operations of
+    // Far::internal::GetBSplineWeights() in the same order (the weights are
+    // identical) : the loops over the lanes are meant to be vectorized
+    float s[WIDTH], t[WIDTH], dScale[WIDTH];
+    int boundary[WIDTH];
+
+    for (int lane = 0; lane < WIDTH; ++lane) {
+        if (lane < _numCoords) {
+            s[lane] = _s[lane];
+            t[lane] = _t[lane];
+            _params[lane].Normalize(s[lane], t[lane]);
+            dScale[lane] = (float)(1 << _params[lane].GetDepth());
+            boundary[lane] = _params[lane].GetBoundary();
+        } else {
+            s[lane] = t[lane] = 0.0f;
+            dScale[lane] = 1.0f;
+            boundary[lane] = 0;
+        }
     }
-    void AddWithWeight(T const *src, float w) {
-        if (_p) {
-            for (int i = 0; i < _length; ++i) {
-                _p[i] += src[i] * w;
+
+    float sWeights[4][WIDTH], tWeights[4][WIDTH],
+          dsWeights[4][WIDTH], dtWeights[4][WIDTH];
+
+    getBSplineWeights(s, sWeights, dsWeights);
+    getBSplineWeights(t, tWeights, dtWeights);
+
+    adjustBoundaryWeights(boundary, sWeights, tWeights);
+    adjustBoundaryWeights(boundary, dsWeights, dtWeights);
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            float * wP  = _wP  + (4*i+j) * WIDTH,
+                  * wDs = _wDs + (4*i+j) * WIDTH,
+                  * wDt = _wDt + (4*i+j) * WIDTH;
+            for (int lane = 0; lane < WIDTH; ++lane) {
+                wP[lane]  = sWeights[j][lane] * tWeights[i][lane];
+                wDs[lane] = dsWeights[j][lane] * tWeights[i][lane] * dScale[lane];
+                wDt[lane] = sWeights[j][lane] * dtWeights[i][lane] * dScale[lane];
             }
         }
     }
-    const T *operator[] (int index) const {
-        return _p + _stride * index;
+}
+
+void
+PatchCoordBlock::Eval(float const * src, BufferDescriptor const & srcDesc,
+                      float * dst,       BufferDescriptor const & dstDesc,
+                      float * du,        BufferDescriptor const & duDesc,
+                      float * dv,        BufferDescriptor const & dvDesc,
+                      float * scratch,
+                      CpuDisplacementTexture const * displacement,
+                      float displacementScale) {
+
+    if (_numCoords == 0) return;
+
+    if (_patchType == Far::PatchDescriptor::REGULAR) {
+        computeBSplineWeights();
     }
-    BufferAdapter<T> & operator ++() {
-        if (_p) {
-            _p += _stride;
+
+    // pad the lanes of an incomplete block with zero weights
+    for (int row = 0; row < _numRows; ++row) {
+        for (int lane = _numCoords; lane < WIDTH; ++lane) {
+            _indices[row * WIDTH + lane] = 0;
+            _wP[row * WIDTH + lane] = 0.0f;
+            _wDs[row * WIDTH + lane] = 0.0f;
+            _wDt[row * WIDTH + lane] = 0.0f;
         }
-        return *this;
     }
 
-    T *_p;
-    int _length;
-    int _stride;
-};
+    // the block is evaluated into consecutive primvars of the scratch
+    // buffer, then copied to the rows of its coordinates
+    int length = srcDesc.length;
+
+    BufferDescriptor blockSrcDesc(0, length, srcDesc.stride),
+                     blockDesc(0, length, length);
+
+    float * blockDst = scratch,
+          * blockDu  = scratch + WIDTH * length,
+          * blockDv  = scratch + 2 * WIDTH * length;
+
+    int blockOffsets[2] = { 0, _numRows };
+
+    // displacement requires the derivatives of the points
+    if (_patchType == Far::PatchDescriptor::NON_PATCH) {
+        displacement = NULL;
+    }
+
+    if (du or dv or displacement) {
+        CpuEvalPackedStencils(src, blockSrcDesc,
+                              blockDst, blockDesc,
+                              blockDu, blockDesc,
+                              blockDv, blockDesc,
+                              WIDTH, blockOffsets, _indices,
+                              _wP, _wDs, _wDt, _numCoords, 0, 1);
+    } else {
+        CpuEvalPackedStencils(src, blockSrcDesc, blockDst, blockDesc,
+                              WIDTH, blockOffsets, _indices, _wP,
+                              _numCoords, 0, 1);
+    }
+
+    for (int lane = 0; lane < _numCoords; ++lane) {
+        int coord = _coords[lane];
+        if (displacement) {
+            displacePoint(blockDst + lane * length,
+                          blockDu + lane * length, blockDv + lane * length,
+                          *displacement, displacementScale,
+                          _params[lane].GetFaceId(), _s[lane], _t[lane]);
+        }
+        if (dst) {
+            memcpy(dst + coord * dstDesc.stride,
+                   blockDst + lane * length, length * sizeof(float));
+        }
+        if (du) {
+            memcpy(du + coord * duDesc.stride,
+                   blockDu + lane * length, length * sizeof(float));
+        }
+        if (dv) {
+            memcpy(dv + coord * dvDesc.stride,
+                   blockDv + lane * length, length * sizeof(float));
+        }
+    }
+    _numCoords = 0;
+}
+
+// Cubic Bernstein polynomials and their derivatives
+static inline void
+getBernsteinWeights(float t, float point[4], float deriv[4]) {
+
+    float tC = 1.0f - t;
+
+    point[0] = tC * tC * tC;
+    point[1] = 3.0f * t * tC * tC;
+    point[2] = 3.0f * t * t * tC;
+    point[3] = t * t * t;
+
+    deriv[0] = -3.0f * tC * tC;
+    deriv[1] =  3.0f * tC * (1.0f - 3.0f * t);
+    deriv[2] =  3.0f * t * (2.0f - 3.0f * t);
+    deriv[3] =  3.0f * t * t;
+}
+
+// Evaluates a coordinate of a regular patch from its 16 Bezier points (see
+// Far::StencilTableFactory::CreateBezierPatchStencilTable) in tensor product
+// form : each row of points is combined along s, and the rows along t
+static void
+evalBezierPatchCoord(float const * points, BufferDescriptor const & pointDesc,
+                     Far::PatchParam const & param, float s, float t,
+                     float * dst, float * du, float * dv, float * rows) {
+
+    param.Normalize(s, t);
+
+    float dScale = (float)(1 << param.GetDepth());
+
+    float sWeights[4], dsWeights[4], tWeights[4], dtWeights[4];
+    getBernsteinWeights(s, sWeights, dsWeights);
+    getBernsteinWeights(t, tWeights, dtWeights);
+
+    int length = pointDesc.length;
+
+    // rows combined along s (and their derivatives)
+    float * r  = rows,
+          * dr = rows + 4 * length;
+
+    for (int i = 0; i < 4 * length; ++i) {
+        r[i] = dr[i] = 0.0f;
+    }
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            float const * p = points + (4*i+j) * pointDesc.stride;
+            float w = sWeights[j], dw = dsWeights[j];
+            for (int k = 0; k < length; ++k) {
+                r [i*length + k] += w  * p[k];
+                dr[i*length + k] += dw * p[k];
+            }
+        }
+    }
+
+    for (int k = 0; k < length; ++k) {
+        if (dst) {
+            dst[k] = tWeights[0] * r[k] + tWeights[1] * r[length + k] +
+                     tWeights[2] * r[2*length + k] + tWeights[3] * r[3*length + k];
+        }
+        if (du) {
+            du[k] = dScale *
+                   (tWeights[0] * dr[k] + tWeights[1] * dr[length + k] +
+                    tWeights[2] * dr[2*length + k] + tWeights[3] * dr[3*length + k]);
+        }
+        if (dv) {
+            dv[k] = dScale *
+                   (dtWeights[0] * r[k] + dtWeights[1] * r[length + k] +
+                    dtWeights[2] * r[2*length + k] + dtWeights[3] * r[3*length + k]);
+        }
+    }
+}
+
+// Evaluates the coordinates in blocks of the coordinates of each type of
+// patch (returns false if the type of a patch is not supported). Coordinates
+// of regular patches are evaluated from their Bezier points when given, and
+// the points of the others displaced by 'displacement' when given.
+static bool
+evalPatchCoordBlocks(float const * src, BufferDescriptor const & srcDesc,
+                     float * dst,       BufferDescriptor const & dstDesc,
+                     float * du,        BufferDescriptor const & duDesc,
+                     float * dv,        BufferDescriptor const & dvDesc,
+                     int numPatchCoords,
+                     PatchCoord const * patchCoords,
+                     PatchArray const * patchArrays,
+                     int const * patchIndexBuffer,
+                     PatchParam const * patchParamBuffer,
+                     float const * bezier = NULL,
+                     BufferDescriptor const & bezierDesc = BufferDescriptor(),
+                     CpuDisplacementTexture const * displacement = NULL,
+                     float displacementScale = 1.0f) {
+
+    PatchCoordBlock regularBlock(Far::PatchDescriptor::REGULAR),
+                    gregoryBlock(Far::PatchDescriptor::GREGORY_BASIS),
+                    quadsBlock(Far::PatchDescriptor::QUADS),
+                    loopBlock(Far::PatchDescriptor::LOOP),
+                    trianglesBlock(Far::PatchDescriptor::TRIANGLES),
+                    otherBlock(Far::PatchDescriptor::NON_PATCH);
+
+    std::vector<float> scratch(3 * PatchCoordBlock::WIDTH * srcDesc.length);
+
+    std::vector<float> bezierRows(bezier ? 8 * bezierDesc.length : 0);
+
+    bool supported = true;
+
+    for (int i = 0; i < numPatchCoords; ++i) {
+        PatchCoord const &coord = patchCoords[i];
+        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
+
+        int patchType = array.GetPatchType();
+        // XXX: patchIndex is absolute. not sure it's consistent.
+        //      (should be offsetted by array.primitiveIdBase?)
+        //    patchParamBuffer[array.primitiveIdBase + coord.handle.patchIndex]
+        Far::PatchParam const & param =
+            patchParamBuffer[std::max(coord.handle.patchIndex, 0)];
+
+        PatchCoordBlock * block = &otherBlock;
+        if (coord.handle.patchIndex < 0) {
+            // location not found in a patch map (see FindPatchCoords)
+        } else if (patchType == Far::PatchDescriptor::REGULAR) {
+            if (bezier) {
+                evalBezierPatchCoord(bezier + (array.indexBase +
+                        coord.handle.vertIndex) * bezierDesc.stride,
+                    bezierDesc, param, coord.s, coord.t,
+                    dst ? dst + i * dstDesc.stride : NULL,
+                    du  ? du  + i * duDesc.stride  : NULL,
+                    dv  ? dv  + i * dvDesc.stride  : NULL,
+                    &bezierRows[0]);
+                continue;
+            }
+            block = &regularBlock;
+        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
+            block = &gregoryBlock;
+        } else if (patchType == Far::PatchDescriptor::QUADS) {
+            block = &quadsBlock;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            block = &loopBlock;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            block = &trianglesBlock;
+        } else {
+            supported = false;
+        }
+
+        if (block->IsFull()) {
+            block->Eval(src, srcDesc, dst, dstDesc, du, duDesc, dv, dvDesc,
+                        &scratch[0], displacement, displacementScale);
+        }
+
+        const int *cvs =
+            &patchIndexBuffer[array.indexBase + coord.handle.vertIndex];
+
+        block->Add(i, param, coord.s, coord.t, cvs);
+    }
+
+    PatchCoordBlock * blocks[6] = { &regularBlock, &gregoryBlock,
+        &quadsBlock, &loopBlock, &trianglesBlock, &otherBlock };
+    for (int i = 0; i < 6; ++i) {
+        blocks[i]->Eval(src, srcDesc, dst, dstDesc, du, duDesc, dv, dvDesc,
+                        &scratch[0], displacement, displacementScale);
+    }
+    return supported;
+}
+
+} // end namespace
 
 /* static */
 bool
@@ -120,6 +920,8 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
                           const PatchArray *patchArrays,
                           const int *patchIndexBuffer,
                           const PatchParam *patchParamBuffer) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatches");
+
     if (src) {
         src += srcDesc.offset;
     } else {
@@ -128,52 +930,146 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
     if (dst) {
         dst += dstDesc.offset;
         if (srcDesc.length != dstDesc.length) return false;
+        if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+        if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
     } else {
         return false;
     }
 
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-    BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
+    bool supported = evalPatchCoordBlocks(src, srcDesc,
+                                          dst, dstDesc,
+                                          NULL, BufferDescriptor(),
+                                          NULL, BufferDescriptor(),
+                                          numPatchCoords, patchCoords,
+                                          patchArrays, patchIndexBuffer,
+                                          patchParamBuffer);
+    assert(supported);
+    return supported;
+}
 
-    float wP[20], wDs[20], wDt[20];
+/* static */
+bool
+CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
+                          float *dst,       BufferDescriptor const &dstDesc,
+                          float *du,        BufferDescriptor const &duDesc,
+                          float *dv,        BufferDescriptor const &dvDesc,
+                          int numPatchCoords,
+                          const PatchCoord *patchCoords,
+                          const PatchArray *patchArrays,
+                          const int *patchIndexBuffer,
+                          const PatchParam *patchParamBuffer) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatches");
 
-    for (int i = 0; i < numPatchCoords; ++i) {
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
+    if (src) {
+        src += srcDesc.offset;
+    } else {
+        return false;
+    }
+    if (dst) {
+        if (srcDesc.length != dstDesc.length) return false;
+        if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+        if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+        dst += dstDesc.offset;
+    }
+    if (du) {
+        du  += duDesc.offset;
+        if (srcDesc.length != duDesc.length) return false;
+    }
+    if (dv) {
+        dv  += dvDesc.offset;
+        if (srcDesc.length != dvDesc.length) return false;
+    }
 
-        int patchType = array.GetPatchType();
-        // XXX: patchIndex is absolute. not sure it's consistent.
-        //      (should be offsetted by array.primitiveIdBase?)
-        //    patchParamBuffer[array.primitiveIdBase + coord.handle.patchIndex]
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
+    // coordinates on patches of unsupported types are evaluated to zero
+    bool supported = evalPatchCoordBlocks(src, srcDesc,
+                                          dst, dstDesc,
+                                          du,  duDesc,
+                                          dv,  dvDesc,
+                                          numPatchCoords, patchCoords,
+                                          patchArrays, patchIndexBuffer,
+                                          patchParamBuffer);
+    assert(supported);
+    (void)supported;
+    return true;
+}
 
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 4;
-        } else {
-            assert(0);
-            return false;
-        }
-        const int *cvs =
-            &patchIndexBuffer[array.indexBase + coord.handle.vertIndex];
+/* static */
+bool
+CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
+                          float *dst,       BufferDescriptor const &dstDesc,
+                          float *du,        BufferDescriptor const &duDesc,
+                          float *dv,        BufferDescriptor const &dvDesc,
+                          float *duu,       BufferDescriptor const &duuDesc,
+                          float *duv,       BufferDescriptor const &duvDesc,
+                          float *dvv,       BufferDescriptor const &dvvDesc,
+                          int numPatchCoords,
+                          const PatchCoord *patchCoords,
+                          const PatchArray *patchArrays,
+                          const int *patchIndexBuffer,
+                          const PatchParam *patchParamBuffer) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatches");
 
-        dstT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-        }
-        ++dstT;
-    }
+    if (!src) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (dst && dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (du  && srcDesc.length != duDesc.length)  return false;
+    if (dv  && srcDesc.length != dvDesc.length)  return false;
+    if (duu && srcDesc.length != duuDesc.length) return false;
+    if (duv && srcDesc.length != duvDesc.length) return false;
+    if (dvv && srcDesc.length != dvvDesc.length) return false;
+
+    // coordinates on patches of unsupported types are evaluated to zero
+    bool supported = CpuEvalPatches(src, srcDesc,
+                                    dst, dstDesc,
+                                    du,  duDesc,
+                                    dv,  dvDesc,
+                                    duu, duuDesc,
+                                    duv, duvDesc,
+                                    dvv, dvvDesc,
+                                    numPatchCoords, patchCoords,
+                                    patchArrays, patchIndexBuffer,
+                                    patchParamBuffer);
+    assert(supported);
+    (void)supported;
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalPatchesWithNormals(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *normal,    BufferDescriptor const &normalDesc,
+    float *tangent,   BufferDescriptor const &tangentDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrays,
+    const int *patchIndexBuffer,
+    const PatchParam *patchParamBuffer) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatchesWithNormals");
+
+    if (not src or not normal) return false;
+    // the normals are computed from the first 3 elements of the primvars
+    if (srcDesc.length < 3 or srcDesc.IsPlanar()) return false;
+    if (dst and (srcDesc.length != dstDesc.length or
+                 dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+                 dstDesc.IsPlanar())) return false;
+    if (normalDesc.length != 3 or normalDesc.IsPlanar() or
+        normalDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (tangent and (tangentDesc.length != 3 or tangentDesc.IsPlanar() or
+        tangentDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    // coordinates on patches of unsupported types are evaluated to zero
+    bool supported = CpuEvalPatchNormals(src, srcDesc,
+                                         dst, dstDesc,
+                                         normal, normalDesc,
+                                         tangent, tangentDesc,
+                                         numPatchCoords, patchCoords,
+                                         patchArrays, patchIndexBuffer,
+                                         patchParamBuffer);
+    assert(supported);
+    (void)supported;
     return true;
 }
 
@@ -187,7 +1083,20 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
                           const PatchCoord *patchCoords,
                           const PatchArray *patchArrays,
                           const int *patchIndexBuffer,
-                          const PatchParam *patchParamBuffer) {
+                          const PatchParam *patchParamBuffer,
+                          CpuDisplacementTexture const *displacement,
+                          float displacementScale) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatches");
+
+    if (not displacement) {
+        return EvalPatches(src, srcDesc, dst, dstDesc, du, duDesc, dv, dvDesc,
+                           numPatchCoords, patchCoords, patchArrays,
+                           patchIndexBuffer, patchParamBuffer);
+    }
+
+    // the displaced points are the first 3 components of the primvars
+    if (srcDesc.length < 3) return false;
+
     if (src) {
         src += srcDesc.offset;
     } else {
@@ -195,7 +1104,11 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
     }
     if (dst) {
         if (srcDesc.length != dstDesc.length) return false;
+        if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+        if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
         dst += dstDesc.offset;
+    } else {
+        return false;
     }
     if (du) {
         du  += duDesc.offset;
@@ -206,55 +1119,342 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
         if (srcDesc.length != dvDesc.length) return false;
     }
 
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-    BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
-    BufferAdapter<float>        duT(du,  duDesc.length,  duDesc.stride);
-    BufferAdapter<float>        dvT(dv,  dvDesc.length,  dvDesc.stride);
+    // coordinates on patches of unsupported types are evaluated to zero
+    bool supported = evalPatchCoordBlocks(src, srcDesc,
+                                          dst, dstDesc,
+                                          du,  duDesc,
+                                          dv,  dvDesc,
+                                          numPatchCoords, patchCoords,
+                                          patchArrays, patchIndexBuffer,
+                                          patchParamBuffer,
+                                          NULL, BufferDescriptor(),
+                                          displacement, displacementScale);
+    assert(supported);
+    (void)supported;
+    return true;
+}
 
-    float wP[20], wDs[20], wDt[20];
+/* static */
+bool
+CpuEvaluator::EvalBezierPatches(const float *src, BufferDescriptor const &srcDesc,
+                                const float *bezier, BufferDescriptor const &bezierDesc,
+                                float *dst,       BufferDescriptor const &dstDesc,
+                                float *du,        BufferDescriptor const &duDesc,
+                                float *dv,        BufferDescriptor const &dvDesc,
+                                int numPatchCoords,
+                                PatchCoord const *patchCoords,
+                                PatchArray const *patchArrays,
+                                const int *patchIndexBuffer,
+                                PatchParam const *patchParamBuffer) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalBezierPatches");
 
-    for (int i = 0; i < numPatchCoords; ++i) {
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
+    if (src) {
+        src += srcDesc.offset;
+    } else {
+        return false;
+    }
+    if (bezier) {
+        bezier += bezierDesc.offset;
+        if (srcDesc.length != bezierDesc.length) return false;
+    } else {
+        return false;
+    }
+    if (dst) {
+        if (srcDesc.length != dstDesc.length) return false;
+        if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+        if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+        dst += dstDesc.offset;
+    }
+    if (du) {
+        du  += duDesc.offset;
+        if (srcDesc.length != duDesc.length) return false;
+    }
+    if (dv) {
+        dv  += dvDesc.offset;
+        if (srcDesc.length != dvDesc.length) return false;
+    }
 
-        int patchType = array.GetPatchType();
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
+    // coordinates on patches of unsupported types are evaluated to zero
+    bool supported = evalPatchCoordBlocks(src, srcDesc,
+                                          dst, dstDesc,
+                                          du,  duDesc,
+                                          dv,  dvDesc,
+                                          numPatchCoords, patchCoords,
+                                          patchArrays, patchIndexBuffer,
+                                          patchParamBuffer,
+                                          bezier, bezierDesc);
+    assert(supported);
+    (void)supported;
+    return true;
+}
 
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 4;
-        } else {
-            assert(0);
+/* static */
+bool
+CpuEvaluator::EvalPatchGrids(const float *src, BufferDescriptor const &srcDesc,
+                             float *dst,       BufferDescriptor const &dstDesc,
+                             float *du,        BufferDescriptor const &duDesc,
+                             float *dv,        BufferDescriptor const &dvDesc,
+                             CpuPatchGridBasis const *gridBasis,
+                             int numPatchArrays,
+                             const PatchArray *patchArrays,
+                             const int *patchIndexBuffer,
+                             const PatchParam *patchParamBuffer) {
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatchGrids");
+
+    if (not src or not gridBasis) return false;
+    if (srcDesc.IsPlanar()) return false;
+
+    BufferDescriptor const * descs[3] = { &dstDesc, &duDesc, &dvDesc };
+    float const * outputs[3] = { dst, du, dv };
+    for (int o = 0; o < 3; ++o) {
+        if (not outputs[o]) continue;
+        if (srcDesc.length != descs[o]->length) return false;
+        if (descs[o]->elementType != BufferDescriptor::TYPE_FLOAT) return false;
+        if (descs[o]->IsPlanar()) return false;
+    }
+    if ((du or dv) and not gridBasis->HasDerivatives()) return false;
+
+    // points on patches of unsupported types are evaluated to zero
+    return CpuEvalPatchGrids(src, srcDesc, dst, dstDesc,
+                             du, duDesc, dv, dvDesc, *gridBasis,
+                             numPatchArrays, patchArrays,
+                             patchIndexBuffer, patchParamBuffer);
+}
+
+/* static */
+bool
+CpuEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatchesFaceVarying");
+
+    std::vector<PatchCoord> fvarPatchCoords(numPatchCoords);
+    if (numPatchCoords) {
+        CpuGetFVarPatchCoords(numPatchCoords, patchCoords, fvarPatchArrays,
+                              fvarPatchParamBuffer, &fvarPatchCoords[0]);
+    }
+    return EvalPatches(src, srcDesc, dst, dstDesc,
+                       numPatchCoords, numPatchCoords ? &fvarPatchCoords[0] : 0,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer);
+}
+
+/* static */
+bool
+CpuEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::EvalPatchesFaceVarying");
+
+    std::vector<PatchCoord> fvarPatchCoords(numPatchCoords);
+    if (numPatchCoords) {
+        CpuGetFVarPatchCoords(numPatchCoords, patchCoords, fvarPatchArrays,
+                              fvarPatchParamBuffer, &fvarPatchCoords[0]);
+    }
+    return EvalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, numPatchCoords ? &fvarPatchCoords[0] : 0,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer);
+}
+
+/* static */
+bool
+CpuEvaluator::FindPatchCoords(int numLocations,
+                              const int *faceIds,
+                              const float *u,
+                              const float *v,
+                              PatchCoord *patchCoords,
+                              int numFaces,
+                              const int *faceBuffer,
+                              const unsigned int *nodeBuffer,
+                              const int *handleBuffer) {
+
+    for (int i = 0; i < numLocations; ++i) {
+        PatchCoord & coord = patchCoords[i];
+
+        coord.s = u[i];
+        coord.t = v[i];
+        coord.handle.arrayIndex = 0;
+        coord.handle.patchIndex = -1;
+        coord.handle.vertIndex = 0;
+
+        int faceId = faceIds[i];
+        if (faceId < 0 or faceId >= numFaces) continue;
+
+        // direct lookup of the grid cell (see Far::PatchMap::findCell)
+        int res = 1 << faceBuffer[2*faceId+1];
+
+        float scale = (float)res,
+              s = u[i],
+              t = v[i];
+
+        int col = std::min((int)(s * scale), res-1),
+            row = std::min((int)(t * scale), res-1);
+
+        s -= (float)col / scale;
+        t -= (float)row / scale;
+
+        float half = 0.5f / scale;
+
+        unsigned int node = nodeBuffer[faceBuffer[2*faceId] + row*res + col];
+
+        // descend the quadtree nodes (see Far::PatchMap::resolveQuadrant)
+        while ((node & 3) == 1) {
+            int quadrant;
+            if (s < half) {
+                quadrant = (t < half) ? 0 : 1;
+            } else {
+                quadrant = (t < half) ? 3 : 2;
+                s -= half;
+            }
+            if (t >= half) t -= half;
+
+            node = nodeBuffer[(node >> 2) + quadrant];
+            half *= 0.5f;
         }
-        const int *cvs =
-            &patchIndexBuffer[array.indexBase + coord.handle.vertIndex];
 
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight (srcT[cvs[j]], wDs[j]);
-            dvT.AddWithWeight (srcT[cvs[j]], wDt[j]);
+        // descend the triangle nodes of Loop faces
+        // (see Far::PatchMap::resolveTriangleQuadrant)
+        while ((node & 3) == 2) {
+            int quadrant;
+            if (s >= half) {
+                quadrant = 3;
+                s -= half;
+            } else if (t >= half) {
+                quadrant = 1;
+                t -= half;
+            } else if (s + t >= half) {
+                quadrant = 2;
+                s = half - s;
+                t = half - t;
+            } else {
+                quadrant = 0;
+            }
+
+            node = nodeBuffer[(node >> 2) + quadrant];
+            half *= 0.5f;
+        }
+
+        if ((node & 3) == 3) {
+            int const * handle = handleBuffer + 3*(node >> 2);
+            coord.handle.arrayIndex = handle[0];
+            coord.handle.patchIndex = handle[1];
+            coord.handle.vertIndex  = handle[2];
         }
-        ++dstT;
-        ++duT;
-        ++dvT;
     }
     return true;
 }
 
+// returns true if a location of a quad face is in the domain of a sub-patch,
+// with the bounds of the descent of FindPatchCoords (see
+// Far::PatchMap::isInPatch)
+static bool
+isInPatch(PatchParam const & param, int faceId, float u, float v) {
+
+    if (param.GetFaceId() != faceId) return false;
+
+    float frac = param.GetParamFraction(),
+          u0 = (float)param.GetU() * frac,
+          v0 = (float)param.GetV() * frac,
+          u1 = u0 + frac,
+          v1 = v0 + frac;
+
+    return (u >= u0) and (v >= v0) and
+           ((u < u1) or (u1 >= 1.0f)) and ((v < v1) or (v1 >= 1.0f));
+}
+
+/* static */
+bool
+CpuEvaluator::UpdatePatchCoords(int numLocations,
+                                const int *faceIds,
+                                const float *u,
+                                const float *v,
+                                PatchCoord *patchCoords,
+                                int numFaces,
+                                const int *faceBuffer,
+                                const unsigned int *nodeBuffer,
+                                const int *handleBuffer,
+                                const PatchParam *patchParamBuffer) {
+
+    for (int i = 0; i < numLocations; ++i) {
+        PatchCoord & coord = patchCoords[i];
+
+        int faceId = faceIds[i],
+            patchIndex = coord.handle.patchIndex;
+
+        // the sub-domains of triangle nodes are not tested
+        if (patchIndex >= 0 and faceId >= 0 and faceId < numFaces and
+            (nodeBuffer[faceBuffer[2*faceId]] & 3) != 2 and
+            isInPatch(patchParamBuffer[patchIndex], faceId, u[i], v[i])) {
+            coord.s = u[i];
+            coord.t = v[i];
+            continue;
+        }
+
+        FindPatchCoords(1, faceIds + i, u + i, v + i, &coord,
+                        numFaces, faceBuffer, nodeBuffer, handleBuffer);
+    }
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::AdvectPatchCoords(int numSamples,
+                                int *faceIds,
+                                float *u,
+                                float *v,
+                                float *velocities,
+                                float step,
+                                int numPtexFaces,
+                                const int *adjacencyBuffer,
+                                PatchCoord *patchCoords,
+                                int numFaces,
+                                const int *faceBuffer,
+                                const unsigned int *nodeBuffer,
+                                const int *handleBuffer) {
+
+    if (numSamples <= 0) return true;
+
+    CpuAdvectSamples(0, numSamples, faceIds, u, v, velocities, step,
+                     numPtexFaces, adjacencyBuffer);
+
+    return FindPatchCoords(numSamples, faceIds, u, v, patchCoords,
+                           numFaces, faceBuffer, nodeBuffer, handleBuffer);
+}
+
+/* static */
+bool
+CpuEvaluator::BlendKeyframes(const float *keys,
+                             BufferDescriptor const &keyDesc,
+                             float *dst,
+                             BufferDescriptor const &dstDesc,
+                             int numVertices, int key0, int key1,
+                             float weight) {
+
+    OPENSUBDIV_PROFILE_ZONE("CpuEvaluator::BlendKeyframes");
+
+    if (numVertices <= 0) return true;
+    if (keyDesc.length != dstDesc.length) return false;
+
+    CpuBlendKeyframes(keys, keyDesc, dst, dstDesc,
+                      numVertices, key0, key1, weight, 0, numVertices);
+    return true;
+}
 
 }  // end namespace Osd
 
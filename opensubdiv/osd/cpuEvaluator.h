@@ -30,6 +30,12 @@
 #include <cstddef>
 #include <vector>
 #include "../osd/bufferDescriptor.h"
+#include "../osd/cpuCompactStencilTable.h"
+#include "../osd/cpuFixedStencilKernel.h"
+#include "../osd/cpuInstancedStencilTable.h"
+#include "../osd/cpuPackedStencilTable.h"
+#include "../osd/cpuPatchGridBasis.h"
+#include "../osd/cpuVaryingStencilTable.h"
 #include "../osd/types.h"
 
 namespace OpenSubdiv {
@@ -37,6 +43,8 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
+class CpuDisplacementTexture;
+
 class CpuEvaluator {
 public:
     /// ----------------------------------------------------------------------
@@ -61,7 +69,10 @@ public:
     ///
     /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param stencilTable   Far::StencilTable or equivalent
+    /// @param stencilTable   Far::StencilTable or equivalent (tables of
+    ///                       several passes are evaluated in order, the
+    ///                       output buffer must then follow the control
+    ///                       vertices in the input buffer)
     ///
     /// @param instance       not used in the cpu kernel
     ///                       (declared as a typed pointer to prevent
@@ -83,14 +94,77 @@ public:
         if (stencilTable->GetNumStencils() == 0)
             return false;
 
+        // Passes refer to the vertices of the previous passes : they are
+        // evaluated in order (see Far::StencilTable::GetPassOffsets())
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            // the kernels write the first stencil of the range at the
+            // offset of the descriptor
+            BufferDescriptor passDesc = dstDesc;
+            passDesc.offset += start * dstDesc.stride;
+
+            if (not EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                                 dstBuffer->BindCpuBuffer(), passDesc,
+                                 &stencilTable->GetSizes()[0],
+                                 &stencilTable->GetOffsets()[0],
+                                 &stencilTable->GetControlIndices()[0],
+                                 &stencilTable->GetWeights()[0],
+                                 start, end)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Generic static eval stencils function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    /// \note  Ranges of tables of several passes must not span passes, and
+    ///        are evaluated in the order of the passes (see
+    ///        Far::StencilTable::GetPassOffsets())
+    ///
+    /// @param start          index of the first stencil of the range
+    ///
+    /// @param end            index of the stencil following the range
+    ///
+    /// (see the evaluation of the whole table above for the other arguments)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (end <= start) return true;
+
+        // the kernels write the first stencil of the range at the
+        // offset of the descriptor
+        BufferDescriptor rangeDesc = dstDesc;
+        rangeDesc.offset += start * dstDesc.stride;
+
         return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
-                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            dstBuffer->BindCpuBuffer(), rangeDesc,
                             &stencilTable->GetSizes()[0],
                             &stencilTable->GetOffsets()[0],
                             &stencilTable->GetControlIndices()[0],
                             &stencilTable->GetWeights()[0],
-                            /*start = */ 0,
-                            /*end   = */ stencilTable->GetNumStencils());
+                            start, end);
     }
 
     /// \brief Static eval stencils function which takes raw CPU pointers for
@@ -129,6 +203,207 @@ public:
         const float * weights,
         int start, int end);
 
+    /// \brief Generic static eval stencils function specialized at compile
+    ///        time for primvars of LENGTH floats, interleaved every SRC_STRIDE
+    ///        floats of the input buffer and every DST_STRIDE floats of the
+    ///        output buffer, e.g. EvalStencils<3, 3, 3>() for packed
+    ///        positions (see cpuFixedStencilKernel.h). Returns false if the
+    ///        descriptors do not describe this layout.
+    ///
+    /// (see the generic evaluation above for the arguments)
+    ///
+    template <int LENGTH, int SRC_STRIDE, int DST_STRIDE,
+              typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable) {
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            BufferDescriptor passDesc = dstDesc;
+            passDesc.offset += start * dstDesc.stride;
+
+            if (not EvalStencils<LENGTH, SRC_STRIDE, DST_STRIDE>(
+                    srcBuffer->BindCpuBuffer(), srcDesc,
+                    dstBuffer->BindCpuBuffer(), passDesc,
+                    &stencilTable->GetSizes()[0],
+                    &stencilTable->GetOffsets()[0],
+                    &stencilTable->GetControlIndices()[0],
+                    &stencilTable->GetWeights()[0],
+                    start, end)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Static eval stencils function specialized at compile time for
+    ///        a primvar layout (see above), which takes raw CPU pointers for
+    ///        input and output. As with the function of any layout, dst is
+    ///        indexed from the first stencil of the range.
+    ///
+    template <int LENGTH, int SRC_STRIDE, int DST_STRIDE>
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end) {
+
+        if (end <= start) return true;
+        if (not IsFixedLayout<LENGTH, SRC_STRIDE>(srcDesc) or
+            not IsFixedLayout<LENGTH, DST_STRIDE>(dstDesc)) return false;
+
+        CpuEvalFixedStencils<LENGTH, SRC_STRIDE, DST_STRIDE>(
+            src + srcDesc.offset, dst + dstDesc.offset,
+            sizes + start, indices + offsets[start], weights + offsets[start],
+            end - start);
+        return true;
+    }
+
+    /// \brief Static eval stencils functions for primvars of doubles, which
+    ///        take raw CPU pointers for input and output (see above).
+    ///
+    /// Values are accumulated in double precision from the float weights of
+    /// the table, e.g. for the coordinates of very large scenes. The generic
+    /// functions above resolve to these for buffers whose BindCpuBuffer()
+    /// method returns double pointers (descriptors count doubles).
+    ///
+    static bool EvalStencils(
+        const double *src, BufferDescriptor const &srcDesc,
+        double *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end);
+
+    static bool EvalStencils(
+        const double *src, BufferDescriptor const &srcDesc,
+        double *dst,       BufferDescriptor const &dstDesc,
+        double *du,        BufferDescriptor const &duDesc,
+        double *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function for the instances of a
+    ///        mesh. The stencils of the table are applied to each instance
+    ///        in a single dispatch, the instances being located by offsets
+    ///        in the input and output buffers.
+    ///
+    ///        The instances may also be the time samples of a frame (e.g.
+    ///        for motion blur). Samples interleaved within the elements of
+    ///        the buffers (the offsets of sample i being those of sample 0
+    ///        plus i * srcDesc.length, within the stride) are evaluated as
+    ///        a single primvar of their combined length, reading the table
+    ///        once for all of them.
+    ///
+    /// @param srcBuffer       Input primvar buffer.
+    ///                        must have BindCpuBuffer() method returning a
+    ///                        const float pointer for read
+    ///
+    /// @param srcDesc         vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer       Output primvar buffer
+    ///                        must have BindCpuBuffer() method returning a
+    ///                        float pointer for write
+    ///
+    /// @param dstDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable    Far::StencilTable or equivalent, shared by the
+    ///                        instances
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance,
+    ///                        in floats, added to the offsets of srcDesc and
+    ///                        dstDesc
+    ///
+    /// @param instance        not used in the cpu kernel
+    ///                        (declared as a typed pointer to prevent
+    ///                         undesirable template resolution)
+    ///
+    /// @param deviceContext   not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsBatch(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int numInstances, int const * instanceOffsets,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            BufferDescriptor passDesc = dstDesc;
+            passDesc.offset += start * dstDesc.stride;
+
+            if (not EvalStencilsBatch(srcBuffer->BindCpuBuffer(), srcDesc,
+                                      dstBuffer->BindCpuBuffer(), passDesc,
+                                      &stencilTable->GetSizes()[0],
+                                      &stencilTable->GetOffsets()[0],
+                                      &stencilTable->GetControlIndices()[0],
+                                      &stencilTable->GetWeights()[0],
+                                      start, end,
+                                      numInstances, instanceOffsets)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Static eval stencils function for the instances of a mesh,
+    ///        which takes raw CPU pointers for input and output (see
+    ///        EvalStencils).
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance,
+    ///                        in floats, added to the offsets of srcDesc and
+    ///                        dstDesc
+    ///
+    static bool EvalStencilsBatch(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end,
+        int numInstances, const int * instanceOffsets);
+
     /// \brief Generic static eval stencils function with derivatives.
     ///        This function has a same signature as other device kernels
     ///        have so that it can be called in the same way from OsdMesh
@@ -246,217 +521,1728 @@ public:
         const float * dvWeights,
         int start, int end);
 
-    /// ----------------------------------------------------------------------
-    ///
-    ///   Limit evaluations with PatchTable
+    /// \brief Generic static eval stencils function writing the unit normals
+    ///        of the limit surface rather than its derivatives.
+    ///
+    /// The normals are the normalized cross products of the derivatives of
+    /// the first 3 components of the primvars, computed by the kernel so
+    /// that no derivative buffer is written or read back. The optional
+    /// tangents are the derivatives along u, orthogonalized against the
+    /// normals and normalized. Limit stencils having no parametric location,
+    /// the normals of degenerate derivatives are zero (see
+    /// EvalPatchesWithNormals).
+    ///
+    /// @param srcBuffer      Input primvar buffer (at least 3 elements).
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
     ///
-    /// ----------------------------------------------------------------------
-
-    /// \brief Generic limit eval function. This function has a same
-    ///        signature as other device kernels have so that it can be called
-    ///        in the same way.
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
     ///
-    /// @param srcBuffer        Input primvar buffer.
-    ///                         must have BindCpuBuffer() method returning a
-    ///                         const float pointer for read
+    /// @param dstBuffer      Output primvar buffer (optional)
     ///
-    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param dstBuffer        Output primvar buffer
-    ///                         must have BindCpuBuffer() method returning a
-    ///                         float pointer for write
+    /// @param normalBuffer   Output normal buffer
     ///
-    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    /// @param normalDesc     vertex buffer descriptor for the normals (of
+    ///                       length 3)
     ///
-    /// @param numPatchCoords   number of patchCoords.
+    /// @param tangentBuffer  Output tangent buffer (optional)
     ///
-    /// @param patchCoords      array of locations to be evaluated.
+    /// @param tangentDesc    vertex buffer descriptor for the tangents (of
+    ///                       length 3)
     ///
-    /// @param patchTable       CpuPatchTable or equivalent
-    ///                         XXX: currently Far::PatchTable can't be used
-    ///                              due to interface mismatch
+    /// @param stencilTable   Far::LimitStencilTable or equivalent
     ///
-    /// @param instance         not used in the cpu evaluator
+    /// @param instance       not used in the cpu kernel
     ///
-    /// @param deviceContext    not used in the cpu evaluator
+    /// @param deviceContext  not used in the cpu kernel
     ///
-    template <typename SRC_BUFFER, typename DST_BUFFER,
-              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
-    static bool EvalPatches(
-        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
-        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
-        int numPatchCoords,
-        PATCHCOORD_BUFFER *patchCoords,
-        PATCH_TABLE *patchTable,
-        CpuEvaluator const *instance = NULL,
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsWithNormals(
+        SRC_BUFFER *srcBuffer,     BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,     BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer,  BufferDescriptor const &normalDesc,
+        DST_BUFFER *tangentBuffer, BufferDescriptor const &tangentDesc,
+        STENCIL_TABLE const *stencilTable,
+        const CpuEvaluator *instance = NULL,
         void * deviceContext = NULL) {
 
         (void)instance;       // unused
         (void)deviceContext;  // unused
 
-        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
-                           dstBuffer->BindCpuBuffer(), dstDesc,
-                           numPatchCoords,
-                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
-                           patchTable->GetPatchArrayBuffer(),
-                           patchTable->GetPatchIndexBuffer(),
-                           patchTable->GetPatchParamBuffer());
+        return EvalStencilsWithNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            normalBuffer->BindCpuBuffer(), normalDesc,
+            tangentBuffer ? tangentBuffer->BindCpuBuffer() : NULL, tangentDesc,
+            &stencilTable->GetSizes()[0],
+            &stencilTable->GetOffsets()[0],
+            &stencilTable->GetControlIndices()[0],
+            &stencilTable->GetWeights()[0],
+            &stencilTable->GetDuWeights()[0],
+            &stencilTable->GetDvWeights()[0],
+            /*start = */ 0,
+            /*end   = */ stencilTable->GetNumStencils());
     }
 
-    /// \brief Generic limit eval function with derivatives. This function has
-    ///        a same signature as other device kernels have so that it can be
-    ///        called in the same way.
+    /// \brief Static eval stencils function writing the unit normals of the
+    ///        limit surface, which takes raw CPU pointers for input and
+    ///        output (see the generic function above).
     ///
-    /// @param srcBuffer        Input primvar buffer.
-    ///                         must have BindCpuBuffer() method returning a
-    ///                         const float pointer for read
+    static bool EvalStencilsWithNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        float *tangent,   BufferDescriptor const &tangentDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with first and second
+    ///        derivatives, evaluated in a single pass over the control
+    ///        vertices of the stencils.
     ///
-    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
     ///
-    /// @param dstBuffer        Output primvar buffer
-    ///                         must have BindCpuBuffer() method returning a
-    ///                         float pointer for write
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
     ///
-    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
     ///
-    /// @param duBuffer         Output U-derivatives buffer
-    ///                         must have BindCpuBuffer() method returning a
-    ///                         float pointer for write
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param duDesc           vertex buffer descriptor for the duBuffer
+    /// @param duBuffer       Output U-derivative buffer
     ///
-    /// @param dvBuffer         Output V-derivatives buffer
-    ///                         must have BindCpuBuffer() method returning a
-    ///                         float pointer for write
+    /// @param duDesc         vertex buffer descriptor for the output buffer
     ///
-    /// @param dvDesc           vertex buffer descriptor for the dvBuffer
+    /// @param dvBuffer       Output V-derivative buffer
     ///
-    /// @param numPatchCoords   number of patchCoords.
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
     ///
-    /// @param patchCoords      array of locations to be evaluated.
+    /// @param duuBuffer      Output UU-derivative buffer
     ///
-    /// @param patchTable       CpuPatchTable or equivalent
-    ///                         XXX: currently Far::PatchTable can't be used
-    ///                              due to interface mismatch
+    /// @param duuDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param instance         not used in the cpu evaluator
+    /// @param duvBuffer      Output UV-derivative buffer
     ///
-    /// @param deviceContext    not used in the cpu evaluator
+    /// @param duvDesc        vertex buffer descriptor for the output buffer
     ///
-    template <typename SRC_BUFFER, typename DST_BUFFER,
-              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
-    static bool EvalPatches(
+    /// @param dvvBuffer      Output VV-derivative buffer
+    ///
+    /// @param dvvDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   Far::LimitStencilTable or equivalent (with
+    ///                       second derivatives)
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
         SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
         DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
         DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
         DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
-        int numPatchCoords,
-        PATCHCOORD_BUFFER *patchCoords,
-        PATCH_TABLE *patchTable,
-        CpuEvaluator const *instance = NULL,
+        DST_BUFFER *duuBuffer, BufferDescriptor const &duuDesc,
+        DST_BUFFER *duvBuffer, BufferDescriptor const &duvDesc,
+        DST_BUFFER *dvvBuffer, BufferDescriptor const &dvvDesc,
+        STENCIL_TABLE const *stencilTable,
+        const CpuEvaluator *instance = NULL,
         void * deviceContext = NULL) {
+
         (void)instance;       // unused
         (void)deviceContext;  // unused
 
-        // XXX: PatchCoords is somewhat abusing vertex primvar buffer interop.
-        //      ideally all buffer classes should have templated by datatype
-        //      so that downcast isn't needed there.
-        //      (e.g. Osd::CpuBuffer<PatchCoord> )
-        //
-        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
-                           dstBuffer->BindCpuBuffer(), dstDesc,
-                           duBuffer->BindCpuBuffer(),  duDesc,
-                           dvBuffer->BindCpuBuffer(),  dvDesc,
-                           numPatchCoords,
-                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
-                           patchTable->GetPatchArrayBuffer(),
-                           patchTable->GetPatchIndexBuffer(),
-                           patchTable->GetPatchParamBuffer());
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            duuBuffer->BindCpuBuffer(), duuDesc,
+                            duvBuffer->BindCpuBuffer(), duvDesc,
+                            dvvBuffer->BindCpuBuffer(), dvvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            &stencilTable->GetDuuWeights()[0],
+                            &stencilTable->GetDuvWeights()[0],
+                            &stencilTable->GetDvvWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
     }
 
-    /// \brief Static limit eval function. It takes an array of PatchCoord
-    ///        and evaluate limit values on given PatchTable.
+    /// \brief Static eval stencils function with first and second
+    ///        derivatives, which takes raw CPU pointers for input and output
+    ///        (see the function with first derivatives).
     ///
-    /// @param src              Input primvar pointer. An offset of srcDesc
+    /// @param duu            Output UU-derivatives pointer. An offset of
+    ///                       duuDesc will be applied internally.
+    ///
+    /// @param duv            Output UV-derivatives pointer. An offset of
+    ///                       duvDesc will be applied internally.
+    ///
+    /// @param dvv            Output VV-derivatives pointer. An offset of
+    ///                       dvvDesc will be applied internally.
+    ///
+    /// @param duuWeights     pointer to the duu-weights buffer of the stencil table
+    ///
+    /// @param duvWeights     pointer to the duv-weights buffer of the stencil table
+    ///
+    /// @param dvvWeights     pointer to the dvv-weights buffer of the stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        float *duu,       BufferDescriptor const &duuDesc,
+        float *duv,       BufferDescriptor const &duvDesc,
+        float *dvv,       BufferDescriptor const &dvvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        const float * duuWeights,
+        const float * duvWeights,
+        const float * dvvWeights,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuPackedStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        packed for SIMD evaluation (see CpuPackedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuPackedStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*startBlock = */ 0,
+                            /*endBlock   = */ stencilTable->GetNumBlocks());
+    }
+
+    /// \brief Static eval stencils function for packed stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer, at the first stencil of
+    ///                       the table. An offset of dstDesc will be applied
+    ///                       internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable
+    ///
+    /// @param startBlock     first block of stencils to evaluate
+    ///
+    /// @param endBlock       end block of stencils to evaluate
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuPackedStencilTable const *stencilTable,
+        int startBlock, int endBlock);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        packed limit stencil tables (see CpuPackedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuPackedStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            stencilTable,
+                            /*startBlock = */ 0,
+                            /*endBlock   = */ stencilTable->GetNumBlocks());
+    }
+
+    /// \brief Static eval stencils function with derivatives for packed
+    ///        limit stencil tables, which takes raw CPU pointers for input
+    ///        and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output U-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output V-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param startBlock     first block of stencils to evaluate
+    ///
+    /// @param endBlock       end block of stencils to evaluate
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuPackedStencilTable const *stencilTable,
+        int startBlock, int endBlock);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuCompactStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        with a compact encoding (see CpuCompactStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for compact stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        compact limit stencil tables (see CpuCompactStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with derivatives for compact
+    ///        limit stencil tables, which takes raw CPU pointers for input
+    ///        and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output U-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output V-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuInstancedStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        sharing their weights (see CpuInstancedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuInstancedStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuInstancedStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for instanced stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuInstancedStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuInstancedStencilTable const *stencilTable,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuVaryingStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for implicit varying
+    ///        stencil tables (see CpuVaryingStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer (control vertices).
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer (refined vertices).
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuVaryingStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuVaryingStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        // (the const source selects the raw function over this template)
+        return EvalStencils((const float *)srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable);
+    }
+
+    /// \brief Static eval stencils function for implicit varying stencil
+    ///        tables, which takes raw CPU pointers for input and output.
+    ///
+    /// The refined vertices of each level are interpolated from those of
+    /// the previous level : dst holds the refined vertices of all levels
+    /// from the first one (unless the table has no intermediate levels),
+    /// and may follow the control vertices in the same buffer as src.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuVaryingStencilTable
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuVaryingStencilTable const *stencilTable);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Limit evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic limit eval function. This function has a same
+    ///        signature as other device kernels have so that it can be called
+    ///        in the same way.
+    ///
+    /// @param srcBuffer        Input primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///                         XXX: currently Far::PatchTable can't be used
+    ///                              due to interface mismatch
+    ///
+    /// @param instance         not used in the cpu evaluator
+    ///
+    /// @param deviceContext    not used in the cpu evaluator
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Generic limit eval function with derivatives. This function has
+    ///        a same signature as other device kernels have so that it can be
+    ///        called in the same way.
+    ///
+    /// @param srcBuffer        Input primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer         Output U-derivatives buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param duDesc           vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dvBuffer         Output V-derivatives buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dvDesc           vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///                         XXX: currently Far::PatchTable can't be used
+    ///                              due to interface mismatch
+    ///
+    /// @param instance         not used in the cpu evaluator
+    ///
+    /// @param deviceContext    not used in the cpu evaluator
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        // XXX: PatchCoords is somewhat abusing vertex primvar buffer interop.
+        //      ideally all buffer classes should have templated by datatype
+        //      so that downcast isn't needed there.
+        //      (e.g. Osd::CpuBuffer<PatchCoord> )
+        //
+        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function. It takes an array of PatchCoord
+    ///        and evaluate limit values on given PatchTable.
+    ///
+    /// @param src              Input primvar pointer. An offset of srcDesc
+    ///                         will be applied internally (i.e. the pointer
+    ///                         should not include the offset)
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst              Output primvar pointer. An offset of dstDesc
+    ///                         will be applied internally.
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchArrays      an array of Osd::PatchArray struct
+    ///                         indexed by PatchCoord::arrayIndex
+    ///
+    /// @param patchIndexBuffer an array of patch indices
+    ///                         indexed by PatchCoord::vertIndex
+    ///
+    /// @param patchParamBuffer an array of Osd::PatchParam struct
+    ///                         indexed by PatchCoord::patchIndex
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *patchArrays,
+        const int *patchIndexBuffer,
+        const PatchParam *patchParamBuffer);
+
+    /// \brief Static limit eval function. It takes an array of PatchCoord
+    ///        and evaluate limit values on given PatchTable.
+    ///
+    /// @param src              Input primvar pointer. An offset of srcDesc
     ///                         will be applied internally (i.e. the pointer
     ///                         should not include the offset)
     ///
-    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst              Output primvar pointer. An offset of dstDesc
+    ///                         will be applied internally.
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param du               Output U-derivatives pointer. An offset of
+    ///                         duDesc will be applied internally.
+    ///
+    /// @param duDesc           vertex buffer descriptor for the du buffer
+    ///
+    /// @param dv               Output V-derivatives pointer. An offset of
+    ///                         dvDesc will be applied internally.
+    ///
+    /// @param dvDesc           vertex buffer descriptor for the dv buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchArrays      an array of Osd::PatchArray struct
+    ///                         indexed by PatchCoord::arrayIndex
+    ///
+    /// @param patchIndexBuffer an array of patch indices
+    ///                         indexed by PatchCoord::vertIndex
+    ///
+    /// @param patchParamBuffer an array of Osd::PatchParam struct
+    ///                         indexed by PatchCoord::patchIndex
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// \brief Generic limit eval function with derivatives, displacing the
+    ///        limit points by a displacement texture in the same pass (see
+    ///        CpuDisplacementTexture).
+    ///
+    /// The first 3 components of the primvars are the displaced points,
+    /// moved along the normal of the limit surface or in its tangent frame
+    /// by the displacement sampled at the ptex coordinates of the points.
+    /// The derivatives are those of the limit surface : duBuffer and
+    /// dvBuffer may be NULL, the derivatives of the points being computed
+    /// anyway.
+    ///
+    /// @param displacement       CpuDisplacementTexture sampled at the
+    ///                           points (NULL : no displacement)
+    ///
+    /// @param displacementScale  Scale of the sampled displacement
+    ///
+    /// (see the function with derivatives for the other parameters)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CpuDisplacementTexture const *displacement,
+        float displacementScale,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer ? duBuffer->BindCpuBuffer() : NULL, duDesc,
+                           dvBuffer ? dvBuffer->BindCpuBuffer() : NULL, dvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer(),
+                           displacement, displacementScale);
+    }
+
+    /// \brief Static limit eval function with derivatives, displacing the
+    ///        limit points by a displacement texture in the same pass (see
+    ///        the generic function above).
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer,
+        CpuDisplacementTexture const *displacement,
+        float displacementScale);
+
+    /// \brief Generic limit eval function with first and second derivatives,
+    ///        evaluated in a single pass over the control vertices of the
+    ///        patches (see the function with first derivatives).
+    ///
+    /// @param duuBuffer        Output UU-derivatives buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param duuDesc          vertex buffer descriptor for the duuBuffer
+    ///
+    /// @param duvBuffer        Output UV-derivatives buffer
+    ///
+    /// @param duvDesc          vertex buffer descriptor for the duvBuffer
+    ///
+    /// @param dvvBuffer        Output VV-derivatives buffer
+    ///
+    /// @param dvvDesc          vertex buffer descriptor for the dvvBuffer
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        DST_BUFFER *duuBuffer, BufferDescriptor const &duuDesc,
+        DST_BUFFER *duvBuffer, BufferDescriptor const &duvDesc,
+        DST_BUFFER *dvvBuffer, BufferDescriptor const &dvvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           duuBuffer->BindCpuBuffer(), duuDesc,
+                           duvBuffer->BindCpuBuffer(), duvDesc,
+                           dvvBuffer->BindCpuBuffer(), dvvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function with first and second derivatives
+    ///        (see the function with first derivatives).
+    ///
+    /// @param duu              Output UU-derivatives pointer. An offset of
+    ///                         duuDesc will be applied internally.
+    ///
+    /// @param duv              Output UV-derivatives pointer. An offset of
+    ///                         duvDesc will be applied internally.
+    ///
+    /// @param dvv              Output VV-derivatives pointer. An offset of
+    ///                         dvvDesc will be applied internally.
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        float *duu,       BufferDescriptor const &duuDesc,
+        float *duv,       BufferDescriptor const &duvDesc,
+        float *dvv,       BufferDescriptor const &dvvDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// \brief Generic limit eval function writing the unit normals of the
+    ///        limit surface rather than its derivatives.
+    ///
+    /// The normals are the normalized cross products of the derivatives of
+    /// the first 3 components of the primvars, computed by the kernel so
+    /// that no derivative buffer is written or read back. The optional
+    /// tangents are the derivatives along u, orthogonalized against the
+    /// normals and normalized.
+    ///
+    /// Where the derivatives are degenerate (zero or parallel, as at
+    /// collapsed control points or some extraordinary vertices), the normal
+    /// is the limit of the normals of the surface from the interior of the
+    /// patch : the derivative of du x dv toward the center of the patch, from
+    /// the second derivatives of the patch.
+    ///
+    /// @param srcBuffer        Input primvar buffer (at least 3 elements).
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer (optional)
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param normalBuffer     Output normal buffer
+    ///
+    /// @param normalDesc       vertex buffer descriptor for the normals (of
+    ///                         length 3)
+    ///
+    /// @param tangentBuffer    Output tangent buffer (optional)
+    ///
+    /// @param tangentDesc      vertex buffer descriptor for the tangents (of
+    ///                         length 3)
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///
+    /// @param instance         not used in the cpu evaluator
+    ///
+    /// @param deviceContext    not used in the cpu evaluator
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesWithNormals(
+        SRC_BUFFER *srcBuffer,     BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,     BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer,  BufferDescriptor const &normalDesc,
+        DST_BUFFER *tangentBuffer, BufferDescriptor const &tangentDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesWithNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            normalBuffer->BindCpuBuffer(), normalDesc,
+            tangentBuffer ? tangentBuffer->BindCpuBuffer() : NULL, tangentDesc,
+            numPatchCoords,
+            (const PatchCoord*)patchCoords->BindCpuBuffer(),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function writing the unit normals of the
+    ///        limit surface (see the generic function above).
+    ///
+    static bool EvalPatchesWithNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        float *tangent,   BufferDescriptor const &tangentDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// \brief Generic limit eval function evaluating the coordinates of
+    ///        regular patches from their Bezier points (see EvalPatches)
+    ///
+    /// The Bezier points are computed once from the patch points (the
+    /// srcBuffer) by the stencils of
+    /// Far::StencilTableFactory::CreateBezierPatchStencilTable(), and are
+    /// combined in tensor product form without evaluating the B-spline basis
+    /// of the patches. Coordinates of other patches are evaluated from the
+    /// srcBuffer as EvalPatches does.
+    ///
+    /// @param srcBuffer        Input primvar buffer of the patch points
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param bezierBuffer     Input buffer of the Bezier points
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param bezierDesc       vertex buffer descriptor for the bezierBuffer
+    ///
+    /// @param dstBuffer        Output primvar buffer (optional)
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer         Output U-derivatives buffer (optional)
+    ///
+    /// @param duDesc           vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dvBuffer         Output V-derivatives buffer (optional)
+    ///
+    /// @param dvDesc           vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///
+    /// @param instance         not used in the cpu evaluator
+    ///
+    /// @param deviceContext    not used in the cpu evaluator
     ///
-    /// @param dst              Output primvar pointer. An offset of dstDesc
-    ///                         will be applied internally.
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalBezierPatches(
+        SRC_BUFFER *srcBuffer,    BufferDescriptor const &srcDesc,
+        SRC_BUFFER *bezierBuffer, BufferDescriptor const &bezierDesc,
+        DST_BUFFER *dstBuffer,    BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,     BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,     BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalBezierPatches(
+            srcBuffer->BindCpuBuffer(), srcDesc,
+            bezierBuffer->BindCpuBuffer(), bezierDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            duBuffer  ? duBuffer->BindCpuBuffer()  : NULL, duDesc,
+            dvBuffer  ? dvBuffer->BindCpuBuffer()  : NULL, dvDesc,
+            numPatchCoords,
+            (const PatchCoord*)patchCoords->BindCpuBuffer(),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function evaluating the coordinates of
+    ///        regular patches from their Bezier points (see above)
     ///
-    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    /// @param src              Input primvar pointer of the patch points. An
+    ///                         offset of srcDesc will be applied internally.
     ///
-    /// @param numPatchCoords   number of patchCoords.
+    /// @param bezier           Input pointer of the Bezier points. An offset
+    ///                         of bezierDesc will be applied internally.
     ///
-    /// @param patchCoords      array of locations to be evaluated.
+    /// @param dst              Output primvar pointer (optional)
+    ///
+    /// @param du               Output U-derivatives pointer (optional)
+    ///
+    /// @param dv               Output V-derivatives pointer (optional)
+    ///
+    static bool EvalBezierPatches(
+        const float *src,    BufferDescriptor const &srcDesc,
+        const float *bezier, BufferDescriptor const &bezierDesc,
+        float *dst,          BufferDescriptor const &dstDesc,
+        float *du,           BufferDescriptor const &duDesc,
+        float *dv,           BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// \brief Generic limit eval function evaluating all the patches of a
+    ///        patch table at the points of the grid of a CpuPatchGridBasis,
+    ///        e.g. for uniform tessellation or baking. The weights of the
+    ///        control vertices being tabulated, each patch is evaluated by a
+    ///        dense product of its table with its control vertices.
+    ///
+    /// @param srcBuffer        Input primvar buffer (including the local
+    ///                         points of the end caps)
+    ///
+    /// @param dstBuffer        Output primvar buffer (optional) : the points
+    ///                         of the patch of PatchParam p are written from
+    ///                         index p * gridBasis->GetNumPoints()
+    ///
+    /// @param duBuffer         Output U-derivatives buffer (optional, requires
+    ///                         the derivatives in the grid basis)
+    ///
+    /// @param dvBuffer         Output V-derivatives buffer (optional, requires
+    ///                         the derivatives in the grid basis)
+    ///
+    /// @param gridBasis        Tables of the basis weights at the points
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///
+    /// @return                 False if a patch is not of a type supported
+    ///                         by CpuPatchGridBasis (its points are then
+    ///                         evaluated to zero)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchGrids(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuPatchGridBasis const *gridBasis,
+        PATCH_TABLE *patchTable) {
+
+        return EvalPatchGrids(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            duBuffer  ? duBuffer->BindCpuBuffer()  : NULL, duDesc,
+            dvBuffer  ? dvBuffer->BindCpuBuffer()  : NULL, dvDesc,
+            gridBasis,
+            (int)patchTable->GetNumPatchArrays(),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function evaluating the patches at the
+    ///        points of the grid of a CpuPatchGridBasis (see above), which
+    ///        takes raw CPU pointers
+    ///
+    /// @param numPatchArrays   number of patch arrays
     ///
     /// @param patchArrays      an array of Osd::PatchArray struct
-    ///                         indexed by PatchCoord::arrayIndex
     ///
     /// @param patchIndexBuffer an array of patch indices
-    ///                         indexed by PatchCoord::vertIndex
     ///
     /// @param patchParamBuffer an array of Osd::PatchParam struct
-    ///                         indexed by PatchCoord::patchIndex
     ///
-    static bool EvalPatches(
+    static bool EvalPatchGrids(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
-        int numPatchCoords,
-        const PatchCoord *patchCoords,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuPatchGridBasis const *gridBasis,
+        int numPatchArrays,
         const PatchArray *patchArrays,
         const int *patchIndexBuffer,
         const PatchParam *patchParamBuffer);
 
-    /// \brief Static limit eval function. It takes an array of PatchCoord
-    ///        and evaluate limit values on given PatchTable.
+    /// ----------------------------------------------------------------------
     ///
-    /// @param src              Input primvar pointer. An offset of srcDesc
-    ///                         will be applied internally (i.e. the pointer
-    ///                         should not include the offset)
+    ///   Face-varying limit evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic face-varying limit eval function. Evaluates the values
+    ///        of a face-varying channel at the same PatchCoords as the vertex
+    ///        primvars (see EvalPatches).
+    ///
+    /// @param srcBuffer        Input face-varying primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
     ///
     /// @param srcDesc          vertex buffer descriptor for the input buffer
     ///
-    /// @param dst              Output primvar pointer. An offset of dstDesc
-    ///                         will be applied internally.
+    /// @param dstBuffer        Output face-varying primvar buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
     ///
     /// @param dstDesc          vertex buffer descriptor for the output buffer
     ///
-    /// @param du               Output U-derivatives pointer. An offset of
-    ///                         duDesc will be applied internally.
+    /// @param numPatchCoords   number of patchCoords.
     ///
-    /// @param duDesc           vertex buffer descriptor for the du buffer
+    /// @param patchCoords      array of locations to be evaluated.
     ///
-    /// @param dv               Output V-derivatives pointer. An offset of
-    ///                         dvDesc will be applied internally.
+    /// @param patchTable       CpuPatchTable or equivalent
     ///
-    /// @param dvDesc           vertex buffer descriptor for the dv buffer
+    /// @param fvarChannel      face-varying channel of the patch table
     ///
-    /// @param numPatchCoords   number of patchCoords.
+    /// @param instance         not used in the cpu evaluator
     ///
-    /// @param patchCoords      array of locations to be evaluated.
+    /// @param deviceContext    not used in the cpu evaluator
     ///
-    /// @param patchArrays      an array of Osd::PatchArray struct
-    ///                         indexed by PatchCoord::arrayIndex
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesFaceVarying(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Generic face-varying limit eval function with derivatives
+    ///        (see EvalPatchesFaceVarying above and EvalPatches)
     ///
-    /// @param patchIndexBuffer an array of patch indices
-    ///                         indexed by PatchCoord::vertIndex
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        CpuEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesFaceVarying(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Static face-varying limit eval function. It takes an array of
+    ///        PatchCoord of the vertex patches and evaluates the limit values
+    ///        of a face-varying channel of a PatchTable : the coordinates are
+    ///        mapped to the patches of the channel and evaluated with the
+    ///        same blocks as the vertex patches.
     ///
-    /// @param patchParamBuffer an array of Osd::PatchParam struct
-    ///                         indexed by PatchCoord::patchIndex
+    /// @param src                  Input face-varying primvar pointer. An
+    ///                             offset of srcDesc will be applied
+    ///                             internally
     ///
-    static bool EvalPatches(
+    /// @param srcDesc              vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst                  Output primvar pointer. An offset of
+    ///                             dstDesc will be applied internally.
+    ///
+    /// @param dstDesc              vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords       number of patchCoords.
+    ///
+    /// @param patchCoords          array of locations to be evaluated.
+    ///
+    /// @param fvarPatchArrays      patch arrays of the channel (see
+    ///                             CpuPatchTable::GetFVarPatchArrayBuffer)
+    ///
+    /// @param fvarPatchIndexBuffer face-varying values of the patches
+    ///
+    /// @param fvarPatchParamBuffer face-varying PatchParam of the patches
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndexBuffer,
+        const PatchParam *fvarPatchParamBuffer);
+
+    /// \brief Static face-varying limit eval function with derivatives (see
+    ///        EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    static bool EvalPatchesFaceVarying(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
         float *du,        BufferDescriptor const &duDesc,
         float *dv,        BufferDescriptor const &dvDesc,
         int numPatchCoords,
-        PatchCoord const *patchCoords,
-        PatchArray const *patchArrays,
-        const int *patchIndexBuffer,
-        PatchParam const *patchParamBuffer);
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndexBuffer,
+        const PatchParam *fvarPatchParamBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Patch lookups with PatchMap
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static patch lookup function. Maps (faceId, u, v)
+    ///        locations to the PatchCoords of their sub-patches, as
+    ///        Far::PatchMap::FindPatch does, to be evaluated with EvalPatches.
+    ///
+    /// Locations in holes, or on faces missing from the map, are mapped to
+    /// PatchCoords of patchIndex -1 : EvalPatches evaluates them to zero.
+    ///
+    /// @param numLocations   number of locations
+    ///
+    /// @param faceIds        face index of each location
+    ///
+    /// @param u              u parameter of each location
+    ///
+    /// @param v              v parameter of each location
+    ///
+    /// @param patchCoords    output patch coordinates
+    ///
+    /// @param patchMap       CpuPatchMap or equivalent
+    ///
+    /// @param instance       not used in the cpu evaluator
+    ///
+    /// @param deviceContext  not used in the cpu evaluator
+    ///
+    template <typename PATCH_MAP>
+    static bool FindPatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        CpuEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return FindPatchCoords(numLocations, faceIds, u, v, patchCoords,
+                               patchMap->GetNumFaces(),
+                               patchMap->GetFaceBuffer(),
+                               patchMap->GetNodeBuffer(),
+                               patchMap->GetHandleBuffer());
+    }
+
+    /// \brief Static patch lookup function which takes the raw buffers of a
+    ///        CpuPatchMap (see Far::PatchMap::GetEncodedTables)
+    ///
+    /// @param numLocations   number of locations
+    ///
+    /// @param faceIds        face index of each location
+    ///
+    /// @param u              u parameter of each location
+    ///
+    /// @param v              v parameter of each location
+    ///
+    /// @param patchCoords    output patch coordinates
+    ///
+    /// @param numFaces       number of faces of the map
+    ///
+    /// @param faceBuffer     (first cell, grid depth) pair of each face
+    ///
+    /// @param nodeBuffer     grid cells and quadtree nodes
+    ///
+    /// @param handleBuffer   (arrayIndex, patchIndex, vertIndex) of each patch
+    ///
+    static bool FindPatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer);
+
+    /// \brief Generic static patch update function. Maps moving (faceId, u,
+    ///        v) locations to the PatchCoords of their sub-patches, testing
+    ///        first the sub-patches of their previous PatchCoords (see
+    ///        Far::PatchMap::UpdatePatches).
+    ///
+    /// The PatchParam of the previous sub-patch of a location bounds its
+    /// domain : the lookup of FindPatchCoords only runs for the locations
+    /// which have left it (or were not found).
+    ///
+    /// @param numLocations   number of locations
+    ///
+    /// @param faceIds        face index of each location
+    ///
+    /// @param u              u parameter of each location
+    ///
+    /// @param v              v parameter of each location
+    ///
+    /// @param patchCoords    previous patch coordinates of the locations
+    ///                       (hints), replaced by the updated coordinates
+    ///
+    /// @param patchMap       CpuPatchMap or equivalent
+    ///
+    /// @param patchTable     CpuPatchTable or equivalent (the PatchParams of
+    ///                       the sub-patches of the map)
+    ///
+    /// @param instance       not used in the cpu evaluator
+    ///
+    /// @param deviceContext  not used in the cpu evaluator
+    ///
+    template <typename PATCH_MAP, typename PATCH_TABLE>
+    static bool UpdatePatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        PATCH_TABLE *patchTable,
+        CpuEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return UpdatePatchCoords(numLocations, faceIds, u, v, patchCoords,
+                                 patchMap->GetNumFaces(),
+                                 patchMap->GetFaceBuffer(),
+                                 patchMap->GetNodeBuffer(),
+                                 patchMap->GetHandleBuffer(),
+                                 patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static patch update function which takes the raw buffers of a
+    ///        CpuPatchMap and the PatchParams of a CpuPatchTable
+    ///
+    static bool UpdatePatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        const PatchParam *patchParamBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Surface samples with PtexAdjacency
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static surface sample function. Moves (faceId, u, v)
+    ///        samples of a limit surface by their parametric velocities,
+    ///        then maps them to the PatchCoords of their sub-patches (see
+    ///        FindPatchCoords), to be evaluated with EvalPatches.
+    ///
+    /// Samples crossing an edge of their ptex face are warped to the
+    /// adjacent face (rotating their velocity into its parameterization),
+    /// or bounce off boundaries. A sample crosses one edge per step at most :
+    /// velocities times 'step' should not exceed the size of a face.
+    ///
+    /// @param numSamples     number of samples
+    ///
+    /// @param faceIds        ptex face index of each sample (updated)
+    ///
+    /// @param u              u parameter of each sample (updated)
+    ///
+    /// @param v              v parameter of each sample (updated)
+    ///
+    /// @param velocities     (du, dv) velocity of each sample (updated)
+    ///
+    /// @param step           time step of the velocities
+    ///
+    /// @param ptexAdjacency  CpuPtexAdjacency or equivalent
+    ///
+    /// @param patchCoords    output patch coordinates
+    ///
+    /// @param patchMap       CpuPatchMap or equivalent
+    ///
+    /// @param instance       not used in the cpu evaluator
+    ///
+    /// @param deviceContext  not used in the cpu evaluator
+    ///
+    template <typename PTEX_ADJACENCY, typename PATCH_MAP>
+    static bool AdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        PTEX_ADJACENCY *ptexAdjacency,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        CpuEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return AdvectPatchCoords(numSamples, faceIds, u, v, velocities, step,
+                                 ptexAdjacency->GetNumFaces(),
+                                 ptexAdjacency->GetAdjacencyBuffer(),
+                                 patchCoords,
+                                 patchMap->GetNumFaces(),
+                                 patchMap->GetFaceBuffer(),
+                                 patchMap->GetNodeBuffer(),
+                                 patchMap->GetHandleBuffer());
+    }
+
+    /// \brief Static surface sample function which takes the raw buffers of
+    ///        a CpuPtexAdjacency and of a CpuPatchMap
+    ///
+    static bool AdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        int numPtexFaces,
+        const int *adjacencyBuffer,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Keyframe blending
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static keyframe blending function. Interpolates the
+    ///        control vertices of an animation between two of its keyframes,
+    ///        to be refined by EvalStencils. The keyframes are uploaded once
+    ///        one after the other in 'keyBuffer', so that playing back the
+    ///        animation does not transfer vertices each frame.
+    ///
+    /// @param keyBuffer      Input buffer of the keyframes : vertex i of
+    ///                       keyframe k is vertex (k * numVertices + i).
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param keyDesc        vertex buffer descriptor for the keyframes
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numVertices    number of vertices of a keyframe
+    ///
+    /// @param key0, key1     keyframes to blend
+    ///
+    /// @param weight         blend weight of key1 (0 returns key0)
+    ///
+    /// @param instance       not used in the cpu evaluator
+    ///
+    /// @param deviceContext  not used in the cpu evaluator
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool BlendKeyframes(
+        SRC_BUFFER *keyBuffer, BufferDescriptor const &keyDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight,
+        CpuEvaluator const *instance,
+        void *deviceContext) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return BlendKeyframes(keyBuffer->BindCpuBuffer(), keyDesc,
+                              dstBuffer->BindCpuBuffer(), dstDesc,
+                              numVertices, key0, key1, weight);
+    }
+
+    /// \brief Static keyframe blending function which takes raw CPU pointers
+    ///        for input and output (offsets of the descriptors are applied
+    ///        internally)
+    ///
+    static bool BlendKeyframes(
+        const float *keys, BufferDescriptor const &keyDesc,
+        float *dst, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight);
 
     /// ----------------------------------------------------------------------
     ///
@@ -0,0 +1,180 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cpuFaceLevelSelector.h"
+#include "../osd/cpuTessellator.h"
+#include "../far/error.h"
+#include "../far/faceLevelTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+void
+transformPoint(float const m[16], float const p[3], float q[4]) {
+
+    for (int i = 0; i < 4; ++i) {
+        q[i] = m[i] * p[0] + m[4+i] * p[1] + m[8+i] * p[2] + m[12+i];
+    }
+}
+
+float
+distance(float const p0[3], float const p1[3]) {
+
+    return std::sqrt((p0[0] - p1[0]) * (p0[0] - p1[0]) +
+                     (p0[1] - p1[1]) * (p0[1] - p1[1]) +
+                     (p0[2] - p1[2]) * (p0[2] - p1[2]));
+}
+
+} // end namespace
+
+int
+CpuFaceLevelSelector::ComputeFaceLevels(Far::FaceLevelTable const & table,
+                                        float const * src,
+                                        BufferDescriptor const & srcDesc,
+                                        float const modelViewMatrix[16],
+                                        float const projectionMatrix[16],
+                                        float detail, float curvatureWeight,
+                                        std::vector<int> & faceLevels) {
+
+    if (srcDesc.length < 3) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in CpuFaceLevelSelector::ComputeFaceLevels() -- "
+            "positions of less than 3 elements.");
+        return -1;
+    }
+
+    float modelViewProjectionMatrix[16];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                sum += projectionMatrix[k*4+j] * modelViewMatrix[i*4+k];
+            }
+            modelViewProjectionMatrix[i*4+j] = sum;
+        }
+    }
+
+    int numFaces = table.GetNumBaseFaces(),
+        maxLevel = table.GetMaxLevel(),
+        maxFaceLevel = -1;
+
+    faceLevels.resize(numFaces);
+
+    for (int face = 0; face < numFaces; ++face) {
+        Far::ConstIndexArray corners = table.GetFaceCorners(face),
+                             refinedCorners = table.GetFaceRefinedCorners(face);
+        int numCorners = corners.size();
+
+        //  The face is culled if its corners and refined corners are all
+        //  outside of a same plane of the frustum:
+        int clipFlags[3] = { 0, 0, 0 };
+        for (int i = 0; i < 2 * numCorners; ++i) {
+            Far::Index vertex = (i < numCorners) ? corners[i] : refinedCorners[i - numCorners];
+            float clipPos[4];
+            transformPoint(modelViewProjectionMatrix,
+                src + srcDesc.offset + vertex * srcDesc.stride, clipPos);
+            for (int k = 0; k < 3; ++k) {
+                clipFlags[k] |= ((clipPos[k] < clipPos[3]) ? 1 : 0) |
+                                ((clipPos[k] > -clipPos[3]) ? 2 : 0);
+            }
+        }
+        if ((clipFlags[0] != 3) or (clipFlags[1] != 3) or (clipFlags[2] != 3)) {
+            faceLevels[face] = -1;
+            continue;
+        }
+
+        //  Normal of the face (Newell's method), along which the offsets of
+        //  the refined corners are measured -- refined corners may also slide
+        //  within the plane of flat faces, e.g. at boundaries:
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < numCorners; ++i) {
+            float const * p0 = src + srcDesc.offset + corners[i] * srcDesc.stride,
+                        * p1 = src + srcDesc.offset +
+                               corners[(i + 1) % numCorners] * srcDesc.stride;
+            normal[0] += (p0[1] - p1[1]) * (p0[2] + p1[2]);
+            normal[1] += (p0[2] - p1[2]) * (p0[0] + p1[0]);
+            normal[2] += (p0[0] - p1[0]) * (p0[1] + p1[1]);
+        }
+        float normalLength = std::sqrt(normal[0] * normal[0] +
+            normal[1] * normal[1] + normal[2] * normal[2]);
+
+        float rate = 1.0f, maxEdgeLength = 0.0f, maxOffset = 0.0f;
+        for (int i = 0; i < numCorners; ++i) {
+            float const * p0 = src + srcDesc.offset + corners[i] * srcDesc.stride,
+                        * p1 = src + srcDesc.offset +
+                               corners[(i + 1) % numCorners] * srcDesc.stride,
+                        * r0 = src + srcDesc.offset + refinedCorners[i] * srcDesc.stride;
+
+            rate = std::max(rate, CpuTessellator::ComputeTessLevel(p0, p1,
+                modelViewMatrix, projectionMatrix, detail));
+
+            maxEdgeLength = std::max(maxEdgeLength, distance(p0, p1));
+
+            float offset = (r0[0] - p0[0]) * normal[0] +
+                           (r0[1] - p0[1]) * normal[1] +
+                           (r0[2] - p0[2]) * normal[2];
+            maxOffset = std::max(maxOffset, (normalLength > 0.0f) ?
+                std::fabs(offset) / normalLength : distance(p0, r0));
+        }
+        if ((curvatureWeight > 0.0f) and (maxEdgeLength > 0.0f)) {
+            rate *= std::min(1.0f, curvatureWeight * maxOffset / maxEdgeLength);
+        }
+
+        int level = (rate > 1.0f) ? (int)std::ceil(std::log(rate) / std::log(2.0f)) : 0;
+        faceLevels[face] = std::min(level, maxLevel);
+
+        maxFaceLevel = std::max(maxFaceLevel, faceLevels[face]);
+    }
+    return maxFaceLevel;
+}
+
+void
+CpuFaceLevelSelector::GatherTriangles(Far::FaceLevelTable const & table,
+                                      std::vector<int> const & faceLevels,
+                                      std::vector<int> & indices) {
+
+    indices.clear();
+
+    int numFaces = std::min(table.GetNumBaseFaces(), (int)faceLevels.size());
+    for (int face = 0; face < numFaces; ++face) {
+        if (faceLevels[face] < 0) continue;
+
+        Far::ConstIndexArray triangles = table.GetTriangles(face,
+            std::min(faceLevels[face], table.GetMaxLevel()));
+        indices.insert(indices.end(), triangles.begin(), triangles.end());
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,129 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_FACE_LEVEL_SELECTOR_H
+#define OPENSUBDIV3_OSD_CPU_FACE_LEVEL_SELECTOR_H
+
+#include "../version.h"
+
+#include "../osd/bufferDescriptor.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class FaceLevelTable;
+}
+
+namespace Osd {
+
+/// \brief View-dependent selection of the level of each base face of a
+///        Far::FaceLevelTable on the CPU
+///
+/// Each frame, the level of each base face is picked from the vertices of
+/// the levels 0 and 1 (the control vertices and the first level of the
+/// StencilTable), the finer levels are refined up to the finest level
+/// picked only, and the triangles of the visible faces at their level are
+/// gathered into a compact index buffer :
+///
+///   1. evaluate the stencils of level 1
+///   2. ComputeFaceLevels()
+///   3. evaluate the stencils of the levels 2 to the returned level
+///   4. GatherTriangles()
+///
+/// (see Far::StencilTableFactory::GetLevelStencilCounts() for the ranges of
+/// the stencils of each level).
+///
+/// The level of a face is the number of halvings of its edges reaching an
+/// extent of one segment of CpuTessellator::ComputeTessLevel() : it grows
+/// by 1 each time the distance of the face to the camera is halved. With a
+/// positive curvature weight, the rate of the edges of a face is scaled by
+/// its curvature times the weight (clamped to 1) : the largest offset of
+/// the child vertex of a corner along the normal of the face, relative to
+/// the longest edge of the face, so that flat faces remain coarse. Faces outside of the view frustum
+/// (corners and refined corners) are culled.
+///
+/// GLFaceLevelSelector is the same selection as a GLSL compute kernel.
+///
+class CpuFaceLevelSelector {
+public:
+    /// \brief Computes the level of each base face
+    ///
+    /// @param table            FaceLevelTable of the faces
+    ///
+    /// @param src              Vertex buffer of the levels (the levels 0 and
+    ///                         1 evaluated)
+    ///
+    /// @param srcDesc          Position of the vertices in 'src' (at least 3
+    ///                         elements)
+    ///
+    /// @param modelViewMatrix  Column-major model-view matrix
+    ///
+    /// @param projectionMatrix Column-major projection matrix
+    ///
+    /// @param detail           Rate of an edge of unit projected extent
+    ///                         (see CpuTessellator::ComputeTessLevel())
+    ///
+    /// @param curvatureWeight  Scale of the curvature of the faces (0 to
+    ///                         ignore the curvature)
+    ///
+    /// @param faceLevels       Returned level of each base face (-1 if the
+    ///                         face is culled)
+    ///
+    /// @return                 The finest level of the faces (-1 if all
+    ///                         faces are culled or 'srcDesc' has less than 3
+    ///                         elements)
+    ///
+    static int ComputeFaceLevels(Far::FaceLevelTable const & table,
+                                 float const * src,
+                                 BufferDescriptor const & srcDesc,
+                                 float const modelViewMatrix[16],
+                                 float const projectionMatrix[16],
+                                 float detail, float curvatureWeight,
+                                 std::vector<int> & faceLevels);
+
+    /// \brief Gathers the triangles of each face at its level
+    ///
+    /// @param table       FaceLevelTable of the faces
+    ///
+    /// @param faceLevels  Level of each base face (culled if negative)
+    ///
+    /// @param indices     Returned vertices of the triangles (3 indices of
+    ///                    the vertex buffer of the levels per triangle)
+    ///
+    static void GatherTriangles(Far::FaceLevelTable const & table,
+                                std::vector<int> const & faceLevels,
+                                std::vector<int> & indices);
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_FACE_LEVEL_SELECTOR_H
@@ -0,0 +1,122 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_FIXED_STENCIL_KERNEL_H
+#define OPENSUBDIV3_OSD_CPU_FIXED_STENCIL_KERNEL_H
+
+#include "../version.h"
+#include "../osd/bufferDescriptor.h"
+
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+//
+// Stencil kernels specialized at compile time for a primvar layout
+//
+// Applications that know the layout of their primvars when they are compiled
+// instantiate these kernels for it (see the EvalStencils<LENGTH, SRC_STRIDE,
+// DST_STRIDE>() functions of CpuEvaluator and TbbEvaluator) : the loops over
+// the elements of the primvars are then fully unrolled and vectorized by the
+// compiler, and the dispatch on the buffer descriptors is skipped.
+//
+
+#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
+    #define __ALIGN_DATA __declspec(align(32))
+#else
+    #define __ALIGN_DATA
+#endif
+
+/// \brief Evaluates 'numStencils' stencils for primvars of LENGTH floats,
+///        stored every SRC_STRIDE floats in the input and every DST_STRIDE
+///        floats in the output. All pointers are expected at the first
+///        stencil to evaluate (and the first element of its primvar), and
+///        only LENGTH floats are written for each stencil.
+template <int LENGTH, int SRC_STRIDE, int DST_STRIDE> void
+CpuEvalFixedStencils(float const * src,
+                     float * dst,
+                     int const * sizes,
+                     int const * indices,
+                     float const * weights,
+                     int numStencils) {
+
+    __ALIGN_DATA float result[LENGTH];
+
+    for (int i=0; i<numStencils; ++i, dst += DST_STRIDE) {
+
+        // Clear
+#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
+    #pragma simd
+    #pragma vector aligned
+#endif
+        for (int k=0; k<LENGTH; ++k)
+            result[k] = 0.0f;
+
+        for (int j=0; j<sizes[i]; ++j, ++indices, ++weights) {
+
+            float const * element = src + (*indices)*SRC_STRIDE;
+            float weight = *weights;
+
+            // AddWithWeight
+#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
+    #pragma simd
+    #pragma vector aligned
+#endif
+            for (int k=0; k<LENGTH; ++k) {
+                result[k] += element[k] * weight;
+            }
+        }
+
+        memcpy(dst, result, LENGTH*sizeof(float));
+    }
+}
+
+/// \brief Type of the instances of CpuEvalFixedStencils
+typedef void (*CpuFixedStencilKernel)(float const * src,
+                                      float * dst,
+                                      int const * sizes,
+                                      int const * indices,
+                                      float const * weights,
+                                      int numStencils);
+
+/// \brief Returns true if a descriptor describes interleaved floats of the
+///        given length and stride
+template <int LENGTH, int STRIDE> inline bool
+IsFixedLayout(BufferDescriptor const & desc) {
+    return desc.length == LENGTH and desc.stride == STRIDE and
+           not desc.IsPlanar() and
+           desc.elementType == BufferDescriptor::TYPE_FLOAT;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_FIXED_STENCIL_KERNEL_H
@@ -23,6 +23,7 @@
 //
 
 #include "../osd/cpuGLVertexBuffer.h"
+#include "../far/profile.h"
 
 #include <string.h>
 
@@ -61,6 +62,8 @@ CpuGLVertexBuffer::UpdateData(const float *src,
                               int startVertex, int numVertices,
                               void * /*deviceContext*/) {
 
+    OPENSUBDIV_PROFILE_ZONE("CpuGLVertexBuffer::UpdateData");
+
     memcpy(_cpuBuffer + startVertex * GetNumElements(), src,
            GetNumElements() * numVertices * sizeof(float));
     _dataDirty = true;
@@ -0,0 +1,96 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cpuInstancedStencilTable.h"
+#include "../far/stencilTable.h"
+
+#include <cstring>
+#include <map>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    // Weight vectors are compared bit for bit, so that shared weights
+    // evaluate exactly as the weights they replace
+    typedef std::vector<unsigned int> ShapeKey;
+}
+
+CpuInstancedStencilTable::CpuInstancedStencilTable(
+    Far::StencilTable const *stencilTable) {
+
+    std::vector<int> const & sizes = stencilTable->GetSizes();
+    std::vector<Far::Index> const & offsets = stencilTable->GetOffsets();
+    std::vector<float> const & weights = stencilTable->GetWeights();
+
+    int numStencils = stencilTable->GetNumStencils();
+
+    _shapes.resize(numStencils);
+    _offsets = offsets;
+    _indices = stencilTable->GetControlIndices();
+
+    std::map<ShapeKey, int> shapeIndices;
+    ShapeKey key;
+
+    for (int i=0; i<numStencils; ++i) {
+
+        int size = sizes[i];
+
+        key.resize(size);
+        if (size > 0) {
+            memcpy(&key[0], &weights[offsets[i]], size * sizeof(float));
+        }
+
+        std::map<ShapeKey, int>::iterator it = shapeIndices.find(key);
+        if (it == shapeIndices.end()) {
+            int shape = (int)_shapeSizes.size();
+
+            _shapeSizes.push_back(size);
+            _shapeOffsets.push_back((int)_shapeWeights.size());
+            _shapeWeights.insert(_shapeWeights.end(),
+                weights.begin() + offsets[i],
+                weights.begin() + offsets[i] + size);
+
+            it = shapeIndices.insert(std::make_pair(key, shape)).first;
+        }
+        _shapes[i] = it->second;
+    }
+}
+
+size_t
+CpuInstancedStencilTable::GetByteSize() const {
+
+    return (_shapes.size() + _offsets.size() + _indices.size() +
+            _shapeSizes.size() + _shapeOffsets.size()) * sizeof(int) +
+           _shapeWeights.size() * sizeof(float);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
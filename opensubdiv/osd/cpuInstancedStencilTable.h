@@ -0,0 +1,118 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_CPU_INSTANCED_STENCIL_TABLE_H
+#define OPENSUBDIV3_OSD_CPU_INSTANCED_STENCIL_TABLE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class StencilTable;
+}
+
+namespace Osd {
+
+/// \brief Stencil table sharing identical weight vectors between stencils,
+///        for the CPU evaluators
+///
+/// Most stencils of a refinement have the same weights as many others :
+/// the masks of regular faces, edges and vertices only differ by their
+/// control vertices. This class is a copy of a Far::StencilTable storing
+/// each distinct weight vector (a "shape") once, in a dictionary small
+/// enough to stay in cache : stencils keep their control vertex indices and
+/// the index of their shape.
+///
+/// Weights are shared when they are equal bit for bit, so instanced tables
+/// evaluate exactly as the tables they copy.
+///
+/// Instanced tables are evaluated by CpuEvaluator, OmpEvaluator and
+/// TbbEvaluator.
+///
+/// \note Limit stencil tables (whose derivative weights are rarely shared)
+///       and stencil tables of several passes (see
+///       Far::StencilTable::GetPassOffsets()) are not supported.
+///
+class CpuInstancedStencilTable {
+public:
+    static CpuInstancedStencilTable *Create(Far::StencilTable const *stencilTable,
+                                            void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuInstancedStencilTable(stencilTable);
+    }
+
+    explicit CpuInstancedStencilTable(Far::StencilTable const *stencilTable);
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return (int)_shapes.size(); }
+
+    /// \brief Returns the number of distinct weight vectors of the table
+    int GetNumShapes() const { return (int)_shapeSizes.size(); }
+
+    /// \brief Returns the shape of each stencil
+    int const * GetShapes() const { return &_shapes[0]; }
+
+    /// \brief Returns the offset of the control vertex indices of each
+    ///        stencil
+    int const * GetOffsets() const { return &_offsets[0]; }
+
+    /// \brief Returns the control vertex indices of all the stencils
+    int const * GetControlIndices() const { return &_indices[0]; }
+
+    /// \brief Returns the number of weights of each shape
+    int const * GetShapeSizes() const { return &_shapeSizes[0]; }
+
+    /// \brief Returns the offset of the weights of each shape
+    int const * GetShapeOffsets() const { return &_shapeOffsets[0]; }
+
+    /// \brief Returns the weights of all the shapes
+    float const * GetShapeWeights() const { return &_shapeWeights[0]; }
+
+    /// \brief Returns the size of the table data in bytes
+    size_t GetByteSize() const;
+
+private:
+    std::vector<int> _shapes,
+                     _offsets,
+                     _indices;
+
+    std::vector<int> _shapeSizes,
+                     _shapeOffsets;
+    std::vector<float> _shapeWeights;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_INSTANCED_STENCIL_TABLE_H
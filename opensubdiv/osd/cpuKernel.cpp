@@ -23,13 +23,28 @@
 //
 
 #include "../osd/cpuKernel.h"
+#include "../osd/cpuSimdKernel.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/cpuCompactStencilTable.h"
+#include "../osd/cpuInstancedStencilTable.h"
+#include "../osd/cpuPatchGridBasis.h"
+#include "../osd/cpuVaryingStencilTable.h"
+#include "../osd/types.h"
+#include "../far/patchBasis.h"
+#include "../far/primvarRefiner.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <vector>
 
+#if defined(_MSC_VER) and (defined(OPENSUBDIV_HAS_AVX2_KERNELS) or \
+                           defined(OPENSUBDIV_HAS_AVX512_KERNELS))
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -41,15 +56,15 @@ elementAtIndex(T * src, int index, BufferDescriptor const &desc) {
     return src + index * desc.stride;
 }
 
-static inline void
-clear(float *dst, BufferDescriptor const &desc) {
+template <class T> static inline void
+clear(T *dst, BufferDescriptor const &desc) {
 
     assert(dst);
-    memset(dst, 0, desc.length*sizeof(float));
+    memset(dst, 0, desc.length*sizeof(T));
 }
 
-static inline void
-addWithWeight(float *dst, const float *src, int srcIndex, float weight,
+template <class T> static inline void
+addWithWeight(T *dst, const T *src, int srcIndex, float weight,
               BufferDescriptor const &desc) {
 
     assert(src and dst);
@@ -59,13 +74,219 @@ addWithWeight(float *dst, const float *src, int srcIndex, float weight,
     }
 }
 
-static inline void
-copy(float *dst, int dstIndex, const float *src, BufferDescriptor const &desc) {
+template <class T> static inline void
+copy(T *dst, int dstIndex, const T *src, BufferDescriptor const &desc) {
 
     assert(src and dst);
 
     dst = elementAtIndex(dst, dstIndex, desc);
-    memcpy(dst, src, desc.length*sizeof(float));
+    memcpy(dst, src, desc.length*sizeof(T));
+}
+
+//
+//  Conversions to the element types of destination buffers
+//
+static inline unsigned short
+floatToHalf(float value) {
+
+    union { float f; unsigned int u; } bits;
+    bits.f = value;
+
+    unsigned int sign = (bits.u >> 16) & 0x8000,
+                 mantissa = bits.u & 0x7fffff;
+    int exponent = (int)((bits.u >> 23) & 0xff);
+
+    if (exponent == 0xff) {
+        // infinities and NaNs
+        return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    }
+
+    exponent += 15 - 127;
+    if (exponent >= 31) {
+        return (unsigned short)(sign | 0x7c00);
+    }
+
+    // round the discarded bits to nearest even
+    unsigned int half, rest, midpoint;
+    if (exponent <= 0) {
+        // denormals
+        if (exponent < -10) return (unsigned short)sign;
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        half = mantissa >> shift;
+        rest = mantissa & ((1u << shift) - 1);
+        midpoint = 1u << (shift - 1);
+    } else {
+        half = ((unsigned int)exponent << 10) | (mantissa >> 13);
+        rest = mantissa & 0x1fff;
+        midpoint = 0x1000;
+    }
+    // a carry into the exponent rounds up to the next power of 2 (or inf)
+    if (rest > midpoint or (rest == midpoint and (half & 1))) {
+        ++half;
+    }
+    return (unsigned short)(sign | half);
+}
+
+static inline unsigned char
+floatToUnorm8(float value) {
+
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+// Stores 'count' primvars of dstDesc.length floats packed in 'src' to the
+// primvars of 'dst' following 'dstIndex', converted to the element type of
+// the descriptor
+static void
+storeElements(float const * src, int count,
+              float * dst, BufferDescriptor const &dstDesc, int dstIndex) {
+
+    int length = dstDesc.length;
+
+    switch (dstDesc.elementType) {
+    case BufferDescriptor::TYPE_HALF_FLOAT: {
+        unsigned short * elements = (unsigned short *)dst +
+            dstDesc.offset + dstIndex * dstDesc.stride;
+        for (int i = 0; i < count; ++i, src += length, elements += dstDesc.stride) {
+            for (int k = 0; k < length; ++k) {
+                elements[k] = floatToHalf(src[k]);
+            }
+        }
+    } break;
+    case BufferDescriptor::TYPE_UNORM8: {
+        unsigned char * elements = (unsigned char *)dst +
+            dstDesc.offset + dstIndex * dstDesc.stride;
+        for (int i = 0; i < count; ++i, src += length, elements += dstDesc.stride) {
+            for (int k = 0; k < length; ++k) {
+                elements[k] = floatToUnorm8(src[k]);
+            }
+        }
+    } break;
+    default: {
+        float * elements = dst + dstDesc.offset + dstIndex * dstDesc.stride;
+        for (int i = 0; i < count; ++i, src += length, elements += dstDesc.stride) {
+            memcpy(elements, src, length * sizeof(float));
+        }
+    } break;
+    }
+}
+
+//
+//  Planar buffers
+//
+static inline int
+getComponentStride(BufferDescriptor const &desc) {
+
+    return desc.IsPlanar() ? desc.planeStride : 1;
+}
+
+// Evaluates the stencils one component at a time, for planar source or
+// destination buffers (src and dst are offset to their first element) :
+// the planes of unit stride are then read and written as contiguous streams
+// rather than gathered across interleaved elements
+static void
+evalPlanarStencils(float const * src, BufferDescriptor const &srcDesc,
+                   float * dst,       BufferDescriptor const &dstDesc,
+                   int const * sizes,
+                   int const * indices,
+                   float const * weights,
+                   int nStencils) {
+
+    int srcComponentStride = getComponentStride(srcDesc),
+        dstComponentStride = getComponentStride(dstDesc);
+
+    for (int k = 0; k < dstDesc.length; ++k) {
+
+        float const * srcPlane = src + k * srcComponentStride;
+        float * dstPlane = dst + k * dstComponentStride;
+
+        int const * index = indices;
+        float const * weight = weights;
+
+        for (int i = 0; i < nStencils; ++i) {
+            float sum = 0.0f;
+            for (int j = 0; j < sizes[i]; ++j) {
+                sum += srcPlane[index[j] * srcDesc.stride] * weight[j];
+            }
+            dstPlane[i * dstDesc.stride] = sum;
+            index += sizes[i];
+            weight += sizes[i];
+        }
+    }
+}
+
+// Number of stencils evaluated in floats at once for converted destinations
+static int const CONVERTED_BLOCK_SIZE = 64;
+
+//
+//  Vector instruction sets supported by both the build and the processor
+//
+enum SimdKernels {
+    SIMD_KERNELS_NONE = 0,
+    SIMD_KERNELS_AVX2,
+    SIMD_KERNELS_AVX512
+};
+
+static SimdKernels
+detectSimdKernels() {
+
+    bool hasAVX2 = false,
+         hasAVX512 = false;
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+    __builtin_cpu_init();
+  #if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    hasAVX2 = __builtin_cpu_supports("avx2");
+  #endif
+  #if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    hasAVX512 = __builtin_cpu_supports("avx512f");
+  #endif
+#elif defined(_MSC_VER) and (defined(_M_X64) or defined(_M_IX86)) and \
+      (defined(OPENSUBDIV_HAS_AVX2_KERNELS) or defined(OPENSUBDIV_HAS_AVX512_KERNELS))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        // the OS must save the ymm (and zmm) registers on context switches
+        if (info[2] & (1 << 27)) {
+            unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+  #if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+            hasAVX2 = (info[1] & (1 << 5)) and ((xcr0 & 0x06) == 0x06);
+  #endif
+  #if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+            hasAVX512 = (info[1] & (1 << 16)) and ((xcr0 & 0xe6) == 0xe6);
+  #endif
+        }
+    }
+#endif
+    return hasAVX512 ? SIMD_KERNELS_AVX512 :
+           hasAVX2   ? SIMD_KERNELS_AVX2   : SIMD_KERNELS_NONE;
+}
+
+static SimdKernels
+getSimdKernels(int length) {
+
+    static SimdKernels const simdKernels = detectSimdKernels();
+
+    // 512 bits vectors only pay off for primvars wider than 8 floats
+    if (simdKernels==SIMD_KERNELS_AVX512 and length <= 8) {
+        return SIMD_KERNELS_AVX2;
+    }
+    return simdKernels;
+}
+
+static SimdKernels
+getPackedSimdKernels(int blockWidth) {
+
+    SimdKernels simdKernels = getSimdKernels(/*length=*/16);
+
+    // a 16 lanes vector spans 2 blocks of 8 stencils
+    if (simdKernels==SIMD_KERNELS_AVX512 and (blockWidth % 16) != 0) {
+        return SIMD_KERNELS_AVX2;
+    }
+    return simdKernels;
 }
 
 void
@@ -79,6 +300,22 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
 
     assert(start>=0 and start<end);
 
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) {
+        // evaluate blocks of stencils in floats, then convert them
+        assert(not dstDesc.IsPlanar());
+        BufferDescriptor blockDesc(0, dstDesc.length, dstDesc.length);
+        float * block = (float*)alloca(
+            CONVERTED_BLOCK_SIZE * dstDesc.length * sizeof(float));
+
+        for (int first = start; first < end; first += CONVERTED_BLOCK_SIZE) {
+            int last = std::min(first + CONVERTED_BLOCK_SIZE, end);
+            CpuEvalStencils(src, srcDesc, block, blockDesc,
+                            sizes, offsets, indices, weights, first, last);
+            storeElements(block, last - first, dst, dstDesc, first - start);
+        }
+        return;
+    }
+
     if (start>0) {
         sizes += start;
         indices += offsets[start];
@@ -88,26 +325,51 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     src += srcDesc.offset;
     dst += dstDesc.offset;
 
+    int nstencils = end-start;
+
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) {
+        evalPlanarStencils(src, srcDesc, dst, dstDesc,
+                           sizes, indices, weights, nstencils);
+        return;
+    }
+
+    switch (srcDesc.length == dstDesc.length ?
+            getSimdKernels(srcDesc.length) : SIMD_KERNELS_NONE) {
+#if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    case SIMD_KERNELS_AVX512:
+        CpuEvalStencilsAVX512(src, srcDesc.stride, dst, dstDesc.stride,
+            srcDesc.length, sizes, indices, weights, nstencils);
+        return;
+#endif
+#if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    case SIMD_KERNELS_AVX2:
+        CpuEvalStencilsAVX2(src, srcDesc.stride, dst, dstDesc.stride,
+            srcDesc.length, sizes, indices, weights, nstencils);
+        return;
+#endif
+    default:
+        break;
+    }
+
     if (srcDesc.length == 4 and dstDesc.length == 4 and
         srcDesc.stride == 4 and dstDesc.stride == 4) {
 
         // SIMD fast path for aligned primvar data (4 floats)
         ComputeStencilKernel<4>(src, dst,
-            sizes, indices, weights, start,  end);
+            sizes, indices, weights, 0, nstencils);
 
     } else if (srcDesc.length == 8 and dstDesc.length == 8 and
                srcDesc.stride == 8 and dstDesc.stride == 8) {
 
         // SIMD fast path for aligned primvar data (8 floats)
         ComputeStencilKernel<8>(src, dst,
-            sizes, indices, weights, start,  end);
+            sizes, indices, weights, 0, nstencils);
     } else {
 
         // Slow path for non-aligned data
 
         float * result = (float*)alloca(srcDesc.length * sizeof(float));
 
-        int nstencils = end-start;
         for (int i=0; i<nstencils; ++i, ++sizes) {
 
             clear(result, srcDesc);
@@ -133,6 +395,34 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * duWeights,
                 float const * dvWeights,
                 int start, int end) {
+
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+        dstDuDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+        dstDvDesc.elementType != BufferDescriptor::TYPE_FLOAT) {
+        // evaluate blocks of stencils in floats, then convert them
+        assert(not (dstDesc.IsPlanar() or dstDuDesc.IsPlanar() or
+                    dstDvDesc.IsPlanar()));
+        BufferDescriptor blockDesc(0, dstDesc.length, dstDesc.length),
+                         blockDuDesc(0, dstDuDesc.length, dstDuDesc.length),
+                         blockDvDesc(0, dstDvDesc.length, dstDvDesc.length);
+        float * block = (float*)alloca(CONVERTED_BLOCK_SIZE * sizeof(float) *
+            (dstDesc.length + dstDuDesc.length + dstDvDesc.length));
+        float * blockDu = block + CONVERTED_BLOCK_SIZE * dstDesc.length,
+              * blockDv = blockDu + CONVERTED_BLOCK_SIZE * dstDuDesc.length;
+
+        for (int first = start; first < end; first += CONVERTED_BLOCK_SIZE) {
+            int last = std::min(first + CONVERTED_BLOCK_SIZE, end);
+            CpuEvalStencils(src, srcDesc, block, blockDesc,
+                            blockDu, blockDuDesc, blockDv, blockDvDesc,
+                            sizes, offsets, indices,
+                            weights, duWeights, dvWeights, first, last);
+            storeElements(block, last - first, dst, dstDesc, first - start);
+            storeElements(blockDu, last - first, dstDu, dstDuDesc, first - start);
+            storeElements(blockDv, last - first, dstDv, dstDvDesc, first - start);
+        }
+        return;
+    }
+
     if (start > 0) {
         sizes += start;
         indices += offsets[start];
@@ -146,12 +436,48 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     dstDu += dstDuDesc.offset;
     dstDv += dstDvDesc.offset;
 
+    int nStencils = end - start;
+
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar() or
+        dstDuDesc.IsPlanar() or dstDvDesc.IsPlanar()) {
+        // one pass per output, each streaming through its planes
+        evalPlanarStencils(src, srcDesc, dst, dstDesc,
+                           sizes, indices, weights, nStencils);
+        evalPlanarStencils(src, srcDesc, dstDu, dstDuDesc,
+                           sizes, indices, duWeights, nStencils);
+        evalPlanarStencils(src, srcDesc, dstDv, dstDvDesc,
+                           sizes, indices, dvWeights, nStencils);
+        return;
+    }
+
+    bool sameLengths = srcDesc.length == dstDesc.length and
+                       srcDesc.length == dstDuDesc.length and
+                       srcDesc.length == dstDvDesc.length;
+
+    switch (sameLengths ? getSimdKernels(srcDesc.length) : SIMD_KERNELS_NONE) {
+#if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    case SIMD_KERNELS_AVX512:
+        CpuEvalStencilsAVX512(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDu, dstDuDesc.stride, dstDv, dstDvDesc.stride, srcDesc.length,
+            sizes, indices, weights, duWeights, dvWeights, nStencils);
+        return;
+#endif
+#if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    case SIMD_KERNELS_AVX2:
+        CpuEvalStencilsAVX2(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDu, dstDuDesc.stride, dstDv, dstDvDesc.stride, srcDesc.length,
+            sizes, indices, weights, duWeights, dvWeights, nStencils);
+        return;
+#endif
+    default:
+        break;
+    }
+
     int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length;
     float * result   = (float*)alloca(nOutLength * sizeof(float));
     float * resultDu = result + dstDesc.length;
     float * resultDv = resultDu + dstDuDesc.length;
 
-    int nStencils = end - start;
     for (int i = 0; i < nStencils; ++i, ++sizes) {
 
         // clear
@@ -169,6 +495,1329 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     }
 }
 
+void
+CpuGetStencilRanges(int const * sizes, int const * offsets,
+                    int start, int end, int numRanges, int * bounds) {
+
+    bounds[0] = start;
+    bounds[numRanges] = end;
+    if (numRanges < 2) return;
+
+    if (end <= start) {
+        std::fill(bounds + 1, bounds + numRanges, start);
+        return;
+    }
+
+    long long firstWeight = offsets[start],
+              numWeights = offsets[end-1] + sizes[end-1] - firstWeight;
+
+    // the first stencil of range i is the first one starting at or past
+    // i/numRanges of the weights
+    for (int i = 1; i < numRanges; ++i) {
+        int target = (int)(firstWeight + (numWeights * i) / numRanges);
+        bounds[i] = (int)(std::lower_bound(offsets + bounds[i-1],
+                                           offsets + end, target) - offsets);
+    }
+}
+
+//
+//  Batches of instances
+//
+
+// Instances interleaved within the elements of the buffers (e.g. the time
+// samples of each vertex) are a single primvar of their combined length
+static bool
+areInstancesInterleaved(BufferDescriptor const &srcDesc,
+                        BufferDescriptor const &dstDesc,
+                        int numInstances, int const * instanceOffsets) {
+
+    int length = srcDesc.length;
+    if ((dstDesc.length != length) or (numInstances * length > dstDesc.stride)) {
+        return false;
+    }
+    for (int i = 1; i < numInstances; ++i) {
+        if ((instanceOffsets[2*i]   != instanceOffsets[0] + i * length) or
+            (instanceOffsets[2*i+1] != instanceOffsets[1] + i * length)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+CpuEvalStencilsBatch(float const * src, BufferDescriptor const &srcDesc,
+                     float * dst,       BufferDescriptor const &dstDesc,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances, int const * instanceOffsets) {
+
+    assert(start>=0 and start<end);
+    assert(not srcDesc.IsPlanar() and not dstDesc.IsPlanar());
+    assert(srcDesc.length == dstDesc.length);
+
+    if (numInstances <= 0) return;
+
+    if (areInstancesInterleaved(srcDesc, dstDesc, numInstances, instanceOffsets)) {
+        BufferDescriptor batchSrcDesc = srcDesc,
+                         batchDstDesc = dstDesc;
+        batchSrcDesc.offset += instanceOffsets[0];
+        batchDstDesc.offset += instanceOffsets[1];
+        batchSrcDesc.length = batchDstDesc.length = numInstances * srcDesc.length;
+
+        CpuEvalStencils(src, batchSrcDesc, dst, batchDstDesc,
+                        sizes, offsets, indices, weights, start, end);
+        return;
+    }
+
+    // instances in separate buffers share no cache lines, so each is best
+    // left to the vectorized kernels in turn
+    for (int i = 0; i < numInstances; ++i) {
+        BufferDescriptor instanceSrcDesc = srcDesc,
+                         instanceDstDesc = dstDesc;
+        instanceSrcDesc.offset += instanceOffsets[2*i];
+        instanceDstDesc.offset += instanceOffsets[2*i+1];
+
+        CpuEvalStencils(src, instanceSrcDesc, dst, instanceDstDesc,
+                        sizes, offsets, indices, weights, start, end);
+    }
+}
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                int start, int end) {
+
+    assert(start>=0 and start<end);
+
+    if (start>0) {
+        sizes += start;
+        indices += offsets[start];
+        weights += offsets[start];
+    }
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+
+    int nstencils = end-start;
+
+    // vectors hold half as many doubles as floats
+    switch (srcDesc.length == dstDesc.length ?
+            getSimdKernels(2*srcDesc.length) : SIMD_KERNELS_NONE) {
+#if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    case SIMD_KERNELS_AVX512:
+        CpuEvalStencilsAVX512(src, srcDesc.stride, dst, dstDesc.stride,
+            srcDesc.length, sizes, indices, weights, nstencils);
+        return;
+#endif
+#if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    case SIMD_KERNELS_AVX2:
+        CpuEvalStencilsAVX2(src, srcDesc.stride, dst, dstDesc.stride,
+            srcDesc.length, sizes, indices, weights, nstencils);
+        return;
+#endif
+    default:
+        break;
+    }
+
+    double * result = (double*)alloca(srcDesc.length * sizeof(double));
+
+    for (int i=0; i<nstencils; ++i, ++sizes) {
+
+        clear(result, srcDesc);
+
+        for (int j=0; j<*sizes; ++j) {
+            addWithWeight(result, src, *indices++, *weights++, srcDesc);
+        }
+
+        copy(dst, i, result, dstDesc);
+    }
+}
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                double * dstDu,     BufferDescriptor const &dstDuDesc,
+                double * dstDv,     BufferDescriptor const &dstDvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                int start, int end) {
+    if (start > 0) {
+        sizes += start;
+        indices += offsets[start];
+        weights += offsets[start];
+        duWeights += offsets[start];
+        dvWeights += offsets[start];
+    }
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+    dstDu += dstDuDesc.offset;
+    dstDv += dstDvDesc.offset;
+
+    int nStencils = end - start;
+
+    bool sameLengths = srcDesc.length == dstDesc.length and
+                       srcDesc.length == dstDuDesc.length and
+                       srcDesc.length == dstDvDesc.length;
+
+    switch (sameLengths ? getSimdKernels(2*srcDesc.length) : SIMD_KERNELS_NONE) {
+#if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    case SIMD_KERNELS_AVX512:
+        CpuEvalStencilsAVX512(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDu, dstDuDesc.stride, dstDv, dstDvDesc.stride, srcDesc.length,
+            sizes, indices, weights, duWeights, dvWeights, nStencils);
+        return;
+#endif
+#if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    case SIMD_KERNELS_AVX2:
+        CpuEvalStencilsAVX2(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDu, dstDuDesc.stride, dstDv, dstDvDesc.stride, srcDesc.length,
+            sizes, indices, weights, duWeights, dvWeights, nStencils);
+        return;
+#endif
+    default:
+        break;
+    }
+
+    int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length;
+    double * result   = (double*)alloca(nOutLength * sizeof(double));
+    double * resultDu = result + dstDesc.length;
+    double * resultDv = resultDu + dstDuDesc.length;
+
+    for (int i = 0; i < nStencils; ++i, ++sizes) {
+
+        memset(result, 0, nOutLength * sizeof(double));
+
+        for (int j=0; j<*sizes; ++j) {
+            addWithWeight(result,   src, *indices, *weights++,   srcDesc);
+            addWithWeight(resultDu, src, *indices, *duWeights++, srcDesc);
+            addWithWeight(resultDv, src, *indices, *dvWeights++, srcDesc);
+            ++indices;
+        }
+        copy(dst,   i, result, dstDesc);
+        copy(dstDu, i, resultDu, dstDuDesc);
+        copy(dstDv, i, resultDv, dstDvDesc);
+    }
+}
+
+void
+CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                float * dstDu,     BufferDescriptor const &dstDuDesc,
+                float * dstDv,     BufferDescriptor const &dstDvDesc,
+                float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+                float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+                float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                float const * duuWeights,
+                float const * duvWeights,
+                float const * dvvWeights,
+                int start, int end) {
+
+    enum { NUM_OUTPUTS = 6 };
+
+    float * outputs[NUM_OUTPUTS] =
+        { dst, dstDu, dstDv, dstDuu, dstDuv, dstDvv };
+    BufferDescriptor const * descs[NUM_OUTPUTS] =
+        { &dstDesc, &dstDuDesc, &dstDvDesc, &dstDuuDesc, &dstDuvDesc, &dstDvvDesc };
+    float const * outWeights[NUM_OUTPUTS] =
+        { weights, duWeights, dvWeights, duuWeights, duvWeights, dvvWeights };
+
+    if (start > 0) {
+        sizes += start;
+        indices += offsets[start];
+    }
+
+    src += srcDesc.offset;
+
+    // the outputs share the length of the source (see CpuEvaluator)
+    int length = srcDesc.length;
+
+    for (int o = 0; o < NUM_OUTPUTS; ++o) {
+        if (outputs[o]) {
+            assert(outWeights[o] and descs[o]->length == length);
+            outputs[o] += descs[o]->offset;
+            outWeights[o] += start > 0 ? offsets[start] : 0;
+        }
+    }
+
+    int nStencils = end - start;
+
+    float * result = (float*)alloca(NUM_OUTPUTS * length * sizeof(float));
+
+    for (int i = 0; i < nStencils; ++i, ++sizes) {
+
+        // clear
+        memset(result, 0, NUM_OUTPUTS * length * sizeof(float));
+
+        // all the outputs are accumulated in a single pass over the control
+        // vertices of the stencil
+        for (int j=0; j<*sizes; ++j, ++indices) {
+            float const * cv = elementAtIndex(src, *indices, srcDesc);
+
+            for (int o = 0; o < NUM_OUTPUTS; ++o) {
+                if (not outputs[o]) continue;
+
+                float w = outWeights[o][j];
+                float * r = result + o * length;
+                for (int k = 0; k < length; ++k) {
+                    r[k] += cv[k] * w;
+                }
+            }
+        }
+        for (int o = 0; o < NUM_OUTPUTS; ++o) {
+            if (outputs[o]) {
+                copy(outputs[o], i, result + o * length, *descs[o]);
+                outWeights[o] += *sizes;
+            }
+        }
+    }
+}
+
+void
+CpuEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils,
+                      int startBlock, int endBlock) {
+
+    assert(startBlock>=0 and startBlock<endBlock);
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+
+    switch (srcDesc.length == dstDesc.length ?
+            getPackedSimdKernels(blockWidth) : SIMD_KERNELS_NONE) {
+#if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    case SIMD_KERNELS_AVX512:
+        CpuEvalPackedStencilsAVX512(src, srcDesc.stride, dst, dstDesc.stride,
+            srcDesc.length, blockWidth, blockOffsets, indices, weights,
+            numStencils, startBlock, endBlock);
+        return;
+#endif
+#if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    case SIMD_KERNELS_AVX2:
+        CpuEvalPackedStencilsAVX2(src, srcDesc.stride, dst, dstDesc.stride,
+            srcDesc.length, blockWidth, blockOffsets, indices, weights,
+            numStencils, startBlock, endBlock);
+        return;
+#endif
+    default:
+        break;
+    }
+
+    // Scalar path : the lanes of each row are accumulated in turn
+    float * result = (float*)alloca(blockWidth * srcDesc.length * sizeof(float));
+
+    for (int block=startBlock; block<endBlock; ++block) {
+
+        int firstStencil = block * blockWidth,
+            numLanes = std::min(blockWidth, numStencils - firstStencil);
+
+        memset(result, 0, numLanes * srcDesc.length * sizeof(float));
+
+        for (int row=blockOffsets[block]; row<blockOffsets[block+1]; ++row) {
+            int const * rowIndices = indices + row * blockWidth;
+            float const * rowWeights = weights + row * blockWidth;
+            for (int lane=0; lane<numLanes; ++lane) {
+                addWithWeight(result + lane * srcDesc.length, src,
+                    rowIndices[lane], rowWeights[lane], srcDesc);
+            }
+        }
+        for (int lane=0; lane<numLanes; ++lane) {
+            copy(dst, firstStencil + lane,
+                result + lane * srcDesc.length, dstDesc);
+        }
+    }
+}
+
+void
+CpuEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstDu,     BufferDescriptor const &dstDuDesc,
+                      float * dstDv,     BufferDescriptor const &dstDvDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils,
+                      int startBlock, int endBlock) {
+
+    assert(startBlock>=0 and startBlock<endBlock);
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+    dstDu += dstDuDesc.offset;
+    dstDv += dstDvDesc.offset;
+
+    bool sameLengths = srcDesc.length == dstDesc.length and
+                       srcDesc.length == dstDuDesc.length and
+                       srcDesc.length == dstDvDesc.length;
+
+    switch (sameLengths ? getPackedSimdKernels(blockWidth) : SIMD_KERNELS_NONE) {
+#if defined(OPENSUBDIV_HAS_AVX512_KERNELS)
+    case SIMD_KERNELS_AVX512:
+        CpuEvalPackedStencilsAVX512(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDu, dstDuDesc.stride, dstDv, dstDvDesc.stride, srcDesc.length,
+            blockWidth, blockOffsets, indices, weights, duWeights, dvWeights,
+            numStencils, startBlock, endBlock);
+        return;
+#endif
+#if defined(OPENSUBDIV_HAS_AVX2_KERNELS)
+    case SIMD_KERNELS_AVX2:
+        CpuEvalPackedStencilsAVX2(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDu, dstDuDesc.stride, dstDv, dstDvDesc.stride, srcDesc.length,
+            blockWidth, blockOffsets, indices, weights, duWeights, dvWeights,
+            numStencils, startBlock, endBlock);
+        return;
+#endif
+    default:
+        break;
+    }
+
+    int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length;
+    float * result = (float*)alloca(blockWidth * nOutLength * sizeof(float));
+
+    for (int block=startBlock; block<endBlock; ++block) {
+
+        int firstStencil = block * blockWidth,
+            numLanes = std::min(blockWidth, numStencils - firstStencil);
+
+        memset(result, 0, numLanes * nOutLength * sizeof(float));
+
+        for (int row=blockOffsets[block]; row<blockOffsets[block+1]; ++row) {
+            int ofs = row * blockWidth;
+            for (int lane=0; lane<numLanes; ++lane) {
+                float * laneResult   = result + lane * nOutLength,
+                      * laneResultDu = laneResult + dstDesc.length,
+                      * laneResultDv = laneResultDu + dstDuDesc.length;
+                addWithWeight(laneResult,   src, indices[ofs + lane],
+                    weights[ofs + lane],   srcDesc);
+                addWithWeight(laneResultDu, src, indices[ofs + lane],
+                    duWeights[ofs + lane], srcDesc);
+                addWithWeight(laneResultDv, src, indices[ofs + lane],
+                    dvWeights[ofs + lane], srcDesc);
+            }
+        }
+        for (int lane=0; lane<numLanes; ++lane) {
+            float * laneResult   = result + lane * nOutLength,
+                  * laneResultDu = laneResult + dstDesc.length,
+                  * laneResultDv = laneResultDu + dstDuDesc.length;
+            copy(dst,   firstStencil + lane, laneResult,   dstDesc);
+            copy(dstDu, firstStencil + lane, laneResultDu, dstDuDesc);
+            copy(dstDv, firstStencil + lane, laneResultDv, dstDvDesc);
+        }
+    }
+}
+
+//
+//  Compact stencils
+//
+static inline float
+decodeWeight(float const * weights, int index) {
+    return weights[index];
+}
+
+static inline float
+decodeWeight(unsigned short const * weights, int index) {
+
+    // half precision float : shift the exponent and mantissa bits in place,
+    // then re-bias the exponent with a multiply (which also normalizes half
+    // denormals), infinities and NaNs not being valid weights
+    unsigned int half = weights[index],
+                 bits = (half & 0x7fff) << 13;
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    value *= 5.192296858534828e+33f;  // 2^112
+    memcpy(&bits, &value, sizeof(float));
+    bits |= (half & 0x8000) << 16;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+typedef void (*CompactStencilKernel)(
+    float const * src, BufferDescriptor const &srcDesc,
+    float * dst,       BufferDescriptor const &dstDesc,
+    float * dstDu,     BufferDescriptor const &dstDuDesc,
+    float * dstDv,     BufferDescriptor const &dstDvDesc,
+    CpuCompactStencilTable const & stencilTable,
+    int start, int end);
+
+template <typename SIZE, typename INDEX, typename WEIGHT> static void
+evalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                    float * dst,       BufferDescriptor const &dstDesc,
+                    float * dstDu,     BufferDescriptor const &dstDuDesc,
+                    float * dstDv,     BufferDescriptor const &dstDvDesc,
+                    CpuCompactStencilTable const & stencilTable,
+                    int start, int end) {
+
+    SIZE const * sizes = (SIZE const *)stencilTable.GetSizes();
+    int const * offsets = stencilTable.GetOffsets();
+    INDEX const * indices = (INDEX const *)stencilTable.GetControlIndices();
+    WEIGHT const * weights = (WEIGHT const *)stencilTable.GetWeights();
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+
+    if (dstDu == NULL and dstDv == NULL) {
+
+        float * result = (float*)alloca(srcDesc.length * sizeof(float));
+
+        for (int i=start; i<end; ++i) {
+
+            clear(result, srcDesc);
+
+            for (int j=offsets[i]; j<offsets[i]+(int)sizes[i]; ++j) {
+                addWithWeight(result, src,
+                    indices[j], decodeWeight(weights, j), srcDesc);
+            }
+            copy(dst, i-start, result, dstDesc);
+        }
+    } else {
+
+        WEIGHT const * duWeights = (WEIGHT const *)stencilTable.GetDuWeights(),
+                     * dvWeights = (WEIGHT const *)stencilTable.GetDvWeights();
+
+        dstDu += dstDuDesc.offset;
+        dstDv += dstDvDesc.offset;
+
+        int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length;
+        float * result   = (float*)alloca(nOutLength * sizeof(float));
+        float * resultDu = result + dstDesc.length;
+        float * resultDv = resultDu + dstDuDesc.length;
+
+        for (int i=start; i<end; ++i) {
+
+            memset(result, 0, nOutLength * sizeof(float));
+
+            for (int j=offsets[i]; j<offsets[i]+(int)sizes[i]; ++j) {
+                addWithWeight(result,   src, indices[j],
+                    decodeWeight(weights, j),   srcDesc);
+                addWithWeight(resultDu, src, indices[j],
+                    decodeWeight(duWeights, j), srcDesc);
+                addWithWeight(resultDv, src, indices[j],
+                    decodeWeight(dvWeights, j), srcDesc);
+            }
+            copy(dst,   i-start, result,   dstDesc);
+            copy(dstDu, i-start, resultDu, dstDuDesc);
+            copy(dstDv, i-start, resultDv, dstDvDesc);
+        }
+    }
+}
+
+static CompactStencilKernel
+getCompactStencilKernel(CpuCompactStencilTable const & stencilTable) {
+
+    typedef unsigned char  Byte;
+    typedef unsigned short Short;
+
+    static CompactStencilKernel const kernels[8] = {
+        evalCompactStencils<int,  int,   float>,
+        evalCompactStencils<int,  int,   Short>,
+        evalCompactStencils<int,  Short, float>,
+        evalCompactStencils<int,  Short, Short>,
+        evalCompactStencils<Byte, int,   float>,
+        evalCompactStencils<Byte, int,   Short>,
+        evalCompactStencils<Byte, Short, float>,
+        evalCompactStencils<Byte, Short, Short> };
+
+    bool halfWeights = stencilTable.GetWeightFormat() ==
+                       CpuCompactStencilTable::WEIGHTS_HALF;
+
+    return kernels[(stencilTable.HasByteSizes()    ? 4 : 0) +
+                   (stencilTable.HasShortIndices() ? 2 : 0) +
+                   (halfWeights                    ? 1 : 0)];
+}
+
+void
+CpuEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end) {
+
+    assert(start>=0 and start<end);
+
+    getCompactStencilKernel(stencilTable)(src, srcDesc, dst, dstDesc,
+        NULL, BufferDescriptor(), NULL, BufferDescriptor(),
+        stencilTable, start, end);
+}
+
+void
+CpuEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       float * dstDu,     BufferDescriptor const &dstDuDesc,
+                       float * dstDv,     BufferDescriptor const &dstDvDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end) {
+
+    assert(start>=0 and start<end and stencilTable.HasDerivatives());
+
+    getCompactStencilKernel(stencilTable)(src, srcDesc, dst, dstDesc,
+        dstDu, dstDuDesc, dstDv, dstDvDesc, stencilTable, start, end);
+}
+
+//
+//  Instanced stencils
+//
+void
+CpuEvalInstancedStencils(float const * src, BufferDescriptor const &srcDesc,
+                         float * dst,       BufferDescriptor const &dstDesc,
+                         CpuInstancedStencilTable const & stencilTable,
+                         int start, int end) {
+
+    assert(start>=0 and start<end);
+
+    int const * shapes = stencilTable.GetShapes();
+    int const * offsets = stencilTable.GetOffsets();
+    int const * indices = stencilTable.GetControlIndices();
+    int const * shapeSizes = stencilTable.GetShapeSizes();
+    int const * shapeOffsets = stencilTable.GetShapeOffsets();
+    float const * shapeWeights = stencilTable.GetShapeWeights();
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+
+    float * result = (float*)alloca(srcDesc.length * sizeof(float));
+
+    for (int i=start; i<end; ++i) {
+
+        int shape = shapes[i],
+            size = shapeSizes[shape];
+
+        int const * stencilIndices = indices + offsets[i];
+        float const * weights = shapeWeights + shapeOffsets[shape];
+
+        clear(result, srcDesc);
+
+        for (int j=0; j<size; ++j) {
+            addWithWeight(result, src, stencilIndices[j], weights[j], srcDesc);
+        }
+        copy(dst, i-start, result, dstDesc);
+    }
+}
+
+namespace {
+
+// Views of the elements of a primvar buffer, interpolated by the
+// Far::PrimvarRefiner
+class VaryingElement {
+public:
+    VaryingElement(float * data, int length) : _data(data), _length(length) { }
+
+    void Clear() {
+        memset(_data, 0, _length*sizeof(float));
+    }
+
+    void AddWithWeight(VaryingElement const & src, float weight) {
+        for (int k = 0; k < _length; ++k) {
+            _data[k] += weight * src._data[k];
+        }
+    }
+
+private:
+    float * _data;
+    int _length;
+};
+
+class VaryingBuffer {
+public:
+    VaryingBuffer(float * data, int length, int stride) :
+        _data(data), _length(length), _stride(stride) { }
+
+    VaryingElement operator[](int index) const {
+        return VaryingElement(_data + index*_stride, _length);
+    }
+
+private:
+    float * _data;
+    int _length,
+        _stride;
+};
+
+} // end namespace
+
+void
+CpuEvalVaryingStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuVaryingStencilTable const & stencilTable) {
+
+    Far::TopologyRefiner const & refiner = *stencilTable.GetTopologyRefiner();
+    Far::PrimvarRefiner primvarRefiner(refiner);
+
+    int maxLevel = refiner.GetMaxLevel(),
+        length = dstDesc.length;
+
+    // the source buffer is only read from
+    VaryingBuffer parents(const_cast<float *>(src) + srcDesc.offset,
+                          length, srcDesc.stride);
+
+    // intermediate levels that are not generated are refined in turn into
+    // the two halves of a temporary buffer
+    std::vector<float> intermediate;
+    int maxIntermediateVerts = 0;
+    if (not stencilTable.HasIntermediateLevels()) {
+        for (int level = 1; level < maxLevel; ++level) {
+            maxIntermediateVerts = std::max(maxIntermediateVerts,
+                refiner.GetLevel(level).GetNumVertices());
+        }
+        intermediate.resize(2 * maxIntermediateVerts * length);
+    }
+
+    float * levelDst = dst + dstDesc.offset;
+    for (int level = 1; level <= maxLevel; ++level) {
+
+        bool generated = stencilTable.HasIntermediateLevels() or
+                         (level == maxLevel);
+
+        VaryingBuffer children = generated ?
+            VaryingBuffer(levelDst, length, dstDesc.stride) :
+            VaryingBuffer(&intermediate[(level & 1) * maxIntermediateVerts * length],
+                          length, length);
+
+        primvarRefiner.InterpolateVarying(level, parents, children);
+
+        if (generated) {
+            levelDst += refiner.GetLevel(level).GetNumVertices() * dstDesc.stride;
+        }
+        parents = children;
+    }
+}
+
+// Weights of a location of a patch of the given type (the derivatives may be
+// NULL, see Far::internal::GetBSplineWeights) : returns the number of control
+// vertices of the patch, or 0 if the type is not supported.
+static int
+getPatchWeights(int patchType, Far::PatchParam const & param,
+                float s, float t, float * wP, float * wDs, float * wDt,
+                float * wDss, float * wDst, float * wDtt) {
+
+    if (patchType == Far::PatchDescriptor::REGULAR) {
+        Far::internal::GetBSplineWeights(param, s, t,
+            wP, wDs, wDt, wDss, wDst, wDtt);
+        return 16;
+    } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
+        Far::internal::GetGregoryWeights(param, s, t,
+            wP, wDs, wDt, wDss, wDst, wDtt);
+        return 20;
+    } else if (patchType == Far::PatchDescriptor::QUADS) {
+        Far::internal::GetBilinearWeights(param, s, t,
+            wP, wDs, wDt, wDss, wDst, wDtt);
+        return 4;
+    } else if (patchType == Far::PatchDescriptor::LOOP) {
+        Far::internal::GetLoopWeights(param, s, t,
+            wP, wDs, wDt, wDss, wDst, wDtt);
+        return 12;
+    } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+        Far::internal::GetTriangleWeights(param, s, t,
+            wP, wDs, wDt, wDss, wDst, wDtt);
+        return 3;
+    }
+    return 0;
+}
+
+bool
+CpuEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               float * dst,       BufferDescriptor const &dstDesc,
+               float * dstDu,     BufferDescriptor const &dstDuDesc,
+               float * dstDv,     BufferDescriptor const &dstDvDesc,
+               float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+               float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+               float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+               int numPatchCoords,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer) {
+
+    enum { NUM_OUTPUTS = 6, MAX_CVS = 20 };
+
+    float * outputs[NUM_OUTPUTS] =
+        { dst, dstDu, dstDv, dstDuu, dstDuv, dstDvv };
+    BufferDescriptor const * descs[NUM_OUTPUTS] =
+        { &dstDesc, &dstDuDesc, &dstDvDesc, &dstDuuDesc, &dstDuvDesc, &dstDvvDesc };
+
+    src += srcDesc.offset;
+
+    // the outputs share the length of the source (see CpuEvaluator)
+    int length = srcDesc.length;
+
+    for (int o = 0; o < NUM_OUTPUTS; ++o) {
+        if (outputs[o]) {
+            assert(descs[o]->length == length);
+            outputs[o] += descs[o]->offset;
+        }
+    }
+
+    float * result = (float*)alloca(NUM_OUTPUTS * length * sizeof(float));
+
+    float w[NUM_OUTPUTS][MAX_CVS];
+
+    bool supported = true;
+
+    for (int i = 0; i < numPatchCoords; ++i) {
+        PatchCoord const &coord = patchCoords[i];
+        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
+
+        int patchType = array.GetPatchType();
+
+        // the weights of all the outputs are needed for the second
+        // derivatives (see Far::internal::GetBSplineWeights)
+        int numControlVertices = 0;
+        if (coord.handle.patchIndex < 0) {
+            // location not found in a patch map (see FindPatchCoords)
+        } else {
+            numControlVertices = getPatchWeights(patchType,
+                patchParamBuffer[coord.handle.patchIndex], coord.s, coord.t,
+                w[0], w[1], w[2], w[3], w[4], w[5]);
+            supported = supported and (numControlVertices > 0);
+        }
+
+        const int *cvs =
+            &patchIndexBuffer[array.indexBase + coord.handle.vertIndex];
+
+        memset(result, 0, NUM_OUTPUTS * length * sizeof(float));
+
+        for (int j = 0; j < numControlVertices; ++j) {
+            float const * cv = elementAtIndex(src, cvs[j], srcDesc);
+
+            for (int o = 0; o < NUM_OUTPUTS; ++o) {
+                if (not outputs[o]) continue;
+
+                float weight = w[o][j];
+                float * r = result + o * length;
+                for (int k = 0; k < length; ++k) {
+                    r[k] += cv[k] * weight;
+                }
+            }
+        }
+        for (int o = 0; o < NUM_OUTPUTS; ++o) {
+            if (outputs[o]) {
+                copy(outputs[o], i, result + o * length, *descs[o]);
+            }
+        }
+    }
+    return supported;
+}
+
+//
+//  Normals and tangents of the limit surface
+//
+static inline float
+dot3(float const a[3], float const b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static inline void
+cross3(float const a[3], float const b[3], float c[3]) {
+    c[0] = a[1] * b[2] - a[2] * b[1];
+    c[1] = a[2] * b[0] - a[0] * b[2];
+    c[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// The cross product n of derivatives du and dv is degenerate if zero or if
+// they are (nearly) parallel
+static inline bool
+isDegenerateNormal(float const n[3], float const du[3], float const dv[3]) {
+    float nn = dot3(n, n);
+    return (nn == 0.0f) or (nn <= 1.0e-12f * dot3(du, du) * dot3(dv, dv));
+}
+
+// Writes the unit normal n and the unit tangent t, orthogonalized against n
+// (both zero if degenerate)
+static inline void
+writeSurfaceFrame(float const n[3], float const t[3],
+                  float * normal, float * tangent) {
+
+    float nLength = std::sqrt(dot3(n, n));
+    float nUnit[3] = { 0.0f, 0.0f, 0.0f };
+    if (nLength > 0.0f) {
+        for (int k = 0; k < 3; ++k) nUnit[k] = n[k] / nLength;
+    }
+    for (int k = 0; k < 3; ++k) normal[k] = nUnit[k];
+
+    if (tangent) {
+        float tn = dot3(t, nUnit);
+        float tOrtho[3] = { t[0] - tn * nUnit[0],
+                            t[1] - tn * nUnit[1],
+                            t[2] - tn * nUnit[2] };
+        float tLength = std::sqrt(dot3(tOrtho, tOrtho));
+        for (int k = 0; k < 3; ++k) {
+            tangent[k] = (tLength > 0.0f) ? tOrtho[k] / tLength : 0.0f;
+        }
+    }
+}
+
+bool
+CpuEvalPatchNormals(float const * src, BufferDescriptor const &srcDesc,
+                    float * dst,       BufferDescriptor const &dstDesc,
+                    float * normal,    BufferDescriptor const &normalDesc,
+                    float * tangent,   BufferDescriptor const &tangentDesc,
+                    int numPatchCoords,
+                    PatchCoord const * patchCoords,
+                    PatchArray const * patchArrays,
+                    int const * patchIndexBuffer,
+                    PatchParam const * patchParamBuffer) {
+
+    enum { MAX_CVS = 20 };
+
+    src += srcDesc.offset;
+
+    int length = srcDesc.length;
+    assert(length >= 3 and normal);
+
+    if (dst) {
+        assert(dstDesc.length == length);
+        dst += dstDesc.offset;
+    }
+    normal += normalDesc.offset;
+    if (tangent) {
+        tangent += tangentDesc.offset;
+    }
+
+    float * point = (float*)alloca(length * sizeof(float));
+
+    float w[6][MAX_CVS];
+
+    bool supported = true;
+
+    for (int i = 0; i < numPatchCoords; ++i) {
+        PatchCoord const &coord = patchCoords[i];
+        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
+
+        int patchType = array.GetPatchType();
+
+        // the second derivatives are only needed at degenerate points
+        int numControlVertices = 0;
+        if (coord.handle.patchIndex >= 0) {
+            numControlVertices = getPatchWeights(patchType,
+                patchParamBuffer[coord.handle.patchIndex], coord.s, coord.t,
+                w[0], w[1], w[2], NULL, NULL, NULL);
+            supported = supported and (numControlVertices > 0);
+        }
+
+        const int *cvs =
+            &patchIndexBuffer[array.indexBase + coord.handle.vertIndex];
+
+        // the derivatives of the first 3 components only
+        float du[3] = { 0.0f, 0.0f, 0.0f },
+              dv[3] = { 0.0f, 0.0f, 0.0f };
+
+        if (dst) {
+            memset(point, 0, length * sizeof(float));
+        }
+        for (int j = 0; j < numControlVertices; ++j) {
+            float const * cv = elementAtIndex(src, cvs[j], srcDesc);
+            if (dst) {
+                float weight = w[0][j];
+                for (int k = 0; k < length; ++k) {
+                    point[k] += cv[k] * weight;
+                }
+            }
+            for (int k = 0; k < 3; ++k) {
+                du[k] += cv[k] * w[1][j];
+                dv[k] += cv[k] * w[2][j];
+            }
+        }
+        if (dst) {
+            copy(dst, i, point, dstDesc);
+        }
+
+        float n[3], t[3] = { du[0], du[1], du[2] };
+        cross3(du, dv, n);
+
+        if (numControlVertices > 0 and isDegenerateNormal(n, du, dv)) {
+            // the normal is the limit of the normals from the interior of
+            // the patch : the derivative of du x dv along the direction
+            // (ds, dt) of the center of the patch
+            Far::PatchParam const & param =
+                patchParamBuffer[coord.handle.patchIndex];
+
+            getPatchWeights(patchType, param, coord.s, coord.t,
+                            w[0], w[1], w[2], w[3], w[4], w[5]);
+
+            float duu[3] = { 0.0f, 0.0f, 0.0f },
+                  duv[3] = { 0.0f, 0.0f, 0.0f },
+                  dvv[3] = { 0.0f, 0.0f, 0.0f };
+            for (int j = 0; j < numControlVertices; ++j) {
+                float const * cv = elementAtIndex(src, cvs[j], srcDesc);
+                for (int k = 0; k < 3; ++k) {
+                    duu[k] += cv[k] * w[3][j];
+                    duv[k] += cv[k] * w[4][j];
+                    dvv[k] += cv[k] * w[5][j];
+                }
+            }
+
+            bool triangle = (patchType == Far::PatchDescriptor::LOOP) or
+                            (patchType == Far::PatchDescriptor::TRIANGLES);
+            float cs = triangle ? (1.0f / 3.0f) : 0.5f,
+                  ct = cs;
+            if (triangle) {
+                param.UnnormalizeTriangle(cs, ct);
+            } else {
+                param.Unnormalize(cs, ct);
+            }
+            float ds = cs - coord.s,
+                  dt = ct - coord.t;
+
+            float duDir[3], dvDir[3];
+            for (int k = 0; k < 3; ++k) {
+                duDir[k] = duu[k] * ds + duv[k] * dt;
+                dvDir[k] = duv[k] * ds + dvv[k] * dt;
+            }
+
+            float n0[3], n1[3];
+            cross3(duDir, dv, n0);
+            cross3(du, dvDir, n1);
+            for (int k = 0; k < 3; ++k) {
+                n[k] = n0[k] + n1[k];
+            }
+            if (dot3(n, n) == 0.0f) {
+                // both derivatives vanish
+                cross3(duDir, dvDir, n);
+            }
+            if (dot3(du, du) == 0.0f) {
+                for (int k = 0; k < 3; ++k) t[k] = duDir[k];
+            }
+        }
+
+        writeSurfaceFrame(n, t, elementAtIndex(normal, i, normalDesc),
+            tangent ? elementAtIndex(tangent, i, tangentDesc) : NULL);
+    }
+    return supported;
+}
+
+void
+CpuEvalStencilNormals(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * normal,    BufferDescriptor const &normalDesc,
+                      float * tangent,   BufferDescriptor const &tangentDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int start, int end) {
+
+    if (start > 0) {
+        sizes += start;
+        indices += offsets[start];
+        if (weights) weights += offsets[start];
+        duWeights += offsets[start];
+        dvWeights += offsets[start];
+    }
+
+    src += srcDesc.offset;
+
+    int length = srcDesc.length;
+    assert(length >= 3 and normal and duWeights and dvWeights);
+
+    if (dst) {
+        assert(weights and dstDesc.length == length);
+        dst += dstDesc.offset;
+    }
+    normal += normalDesc.offset;
+    if (tangent) {
+        tangent += tangentDesc.offset;
+    }
+
+    float * point = (float*)alloca(length * sizeof(float));
+
+    int nStencils = end - start;
+    for (int i = 0; i < nStencils; ++i, ++sizes) {
+
+        float du[3] = { 0.0f, 0.0f, 0.0f },
+              dv[3] = { 0.0f, 0.0f, 0.0f };
+
+        if (dst) {
+            memset(point, 0, length * sizeof(float));
+        }
+        for (int j = 0; j < *sizes; ++j, ++indices) {
+            float const * cv = elementAtIndex(src, *indices, srcDesc);
+            if (dst) {
+                float weight = *weights++;
+                for (int k = 0; k < length; ++k) {
+                    point[k] += cv[k] * weight;
+                }
+            }
+            float duWeight = *duWeights++,
+                  dvWeight = *dvWeights++;
+            for (int k = 0; k < 3; ++k) {
+                du[k] += cv[k] * duWeight;
+                dv[k] += cv[k] * dvWeight;
+            }
+        }
+        if (dst) {
+            copy(dst, i, point, dstDesc);
+        }
+
+        // stencils have no parametric location to approach degenerate
+        // points from : their normals are left zero
+        float n[3];
+        cross3(du, dv, n);
+        if (isDegenerateNormal(n, du, dv)) {
+            n[0] = n[1] = n[2] = 0.0f;
+        }
+        writeSurfaceFrame(n, du, elementAtIndex(normal, i, normalDesc),
+            tangent ? elementAtIndex(tangent, i, tangentDesc) : NULL);
+    }
+}
+
+bool
+CpuEvalPatchGrids(float const * src, BufferDescriptor const &srcDesc,
+                  float * dst,       BufferDescriptor const &dstDesc,
+                  float * dstDu,     BufferDescriptor const &dstDuDesc,
+                  float * dstDv,     BufferDescriptor const &dstDvDesc,
+                  CpuPatchGridBasis const & basis,
+                  int numPatchArrays,
+                  PatchArray const * patchArrays,
+                  int const * patchIndexBuffer,
+                  PatchParam const * patchParamBuffer) {
+
+    enum { NUM_OUTPUTS = 3, MAX_CVS = 20 };
+
+    float * outputs[NUM_OUTPUTS] = { dst, dstDu, dstDv };
+    BufferDescriptor const * descs[NUM_OUTPUTS] =
+        { &dstDesc, &dstDuDesc, &dstDvDesc };
+
+    src += srcDesc.offset;
+
+    int length = srcDesc.length,
+        numPoints = basis.GetNumPoints();
+
+    for (int o = 0; o < NUM_OUTPUTS; ++o) {
+        if (outputs[o]) {
+            assert(descs[o]->length == length);
+            outputs[o] += descs[o]->offset;
+        }
+    }
+    assert(basis.HasDerivatives() or not (dstDu or dstDv));
+
+    // the control vertices of a patch and the values at the points of the
+    // grid are stored by element : the weights of a control vertex at all the
+    // points are then applied in a single loop over the points
+    std::vector<float> cvValues(length * MAX_CVS),
+                       values(length * numPoints);
+
+    bool supported = true;
+
+    for (int a = 0; a < numPatchArrays; ++a) {
+        PatchArray const & array = patchArrays[a];
+
+        Far::PatchDescriptor::Type type =
+            (Far::PatchDescriptor::Type)array.GetPatchType();
+        int numCVs = array.GetDescriptor().GetNumControlVertices();
+
+        bool arraySupported = (basis.GetWeights(type, 0) != NULL);
+        supported &= arraySupported;
+
+        for (int i = 0; i < array.GetNumPatches(); ++i) {
+            int patch = array.GetPrimitiveIdBase() + i;
+
+            Far::PatchParam const & param = patchParamBuffer[patch];
+            float const * weights =
+                basis.GetWeights(type, param.GetBoundary());
+
+            if (arraySupported) {
+                int const * cvs =
+                    patchIndexBuffer + array.GetIndexBase() + i * numCVs;
+                for (int j = 0; j < numCVs; ++j) {
+                    float const * cv = elementAtIndex(src, cvs[j], srcDesc);
+                    for (int k = 0; k < length; ++k) {
+                        cvValues[k * numCVs + j] = cv[k];
+                    }
+                }
+            }
+
+            // derivatives are tabulated at depth 0 : the scale by a power
+            // of 2 is exact, as when applied to the weights
+            float dScale = (float)(1 << param.GetDepth());
+
+            for (int o = 0; o < NUM_OUTPUTS; ++o) {
+                if (not outputs[o]) continue;
+
+                std::fill(values.begin(), values.end(), 0.0f);
+
+                if (arraySupported) {
+                    float const * rows = weights + o * numCVs * numPoints;
+                    for (int k = 0; k < length; ++k) {
+                        float * value = &values[k * numPoints];
+                        for (int j = 0; j < numCVs; ++j) {
+                            float const * row = rows + j * numPoints;
+                            float cv = cvValues[k * numCVs + j];
+                            for (int p = 0; p < numPoints; ++p) {
+                                value[p] += row[p] * cv;
+                            }
+                        }
+                    }
+                }
+
+                float scale = (o == 0) ? 1.0f : dScale;
+                float * out = outputs[o] + patch * numPoints * descs[o]->stride;
+                for (int p = 0; p < numPoints; ++p, out += descs[o]->stride) {
+                    for (int k = 0; k < length; ++k) {
+                        out[k] = values[k * numPoints + p] * scale;
+                    }
+                }
+            }
+        }
+    }
+    return supported;
+}
+
+void
+CpuGetFVarPatchCoords(int numPatchCoords,
+                      PatchCoord const * patchCoords,
+                      PatchArray const * fvarPatchArrays,
+                      PatchParam const * fvarPatchParamBuffer,
+                      PatchCoord * fvarPatchCoords) {
+
+    // the patches of bicubic channels which are not regular are evaluated
+    // with the bilinear array from their corner values (the first values)
+    bool bicubic =
+        (fvarPatchArrays[0].GetPatchType() == Far::PatchDescriptor::REGULAR);
+    int ncvs = fvarPatchArrays[0].GetDescriptor().GetNumFVarControlVertices();
+
+    for (int i = 0; i < numPatchCoords; ++i) {
+        PatchCoord coord = patchCoords[i];
+
+        int patchIndex = coord.handle.patchIndex;
+        if (patchIndex >= 0) {
+            coord.handle.arrayIndex = (bicubic and
+                not fvarPatchParamBuffer[patchIndex].IsRegular()) ? 1 : 0;
+            coord.handle.vertIndex = patchIndex * ncvs;
+        }
+        fvarPatchCoords[i] = coord;
+    }
+}
+
+namespace {
+
+    // bounces a sample off the edge of a boundary
+    inline void
+    bounceSample(int edge, float & s, float & t, float & ds, float & dt) {
+        switch (edge) {
+            case 0: t = -t;        dt = -dt; break;
+            case 1: s = 2.0f - s;  ds = -ds; break;
+            case 2: t = 2.0f - t;  dt = -dt; break;
+            case 3: s = -s;        ds = -ds; break;
+        }
+    }
+
+    // rotates the (s, t) frame of a sample into the frame of the face it
+    // was warped into
+    inline void
+    rotateSample(int rot, float & s, float & t, float & ds, float & dt) {
+        switch (rot & 3) {
+            default: return;
+            case 1: s = 1.0f - s; ds = -ds;
+                    std::swap(s, t); std::swap(ds, dt); break;
+            case 2: s = 1.0f - s; ds = -ds;
+                    t = 1.0f - t; dt = -dt; break;
+            case 3: t = 1.0f - t; dt = -dt;
+                    std::swap(s, t); std::swap(ds, dt); break;
+        }
+    }
+}
+
+void
+CpuAdvectSamples(int start, int end,
+                 int * faceIds, float * u, float * v, float * velocities,
+                 float step,
+                 int numFaces, int const * adjacencyBuffer) {
+
+    for (int i = start; i < end; ++i) {
+        int face = faceIds[i];
+        if (face < 0 or face >= numFaces) continue;
+
+        float ds = velocities[2*i],
+              dt = velocities[2*i+1],
+              s = u[i] + ds * step,
+              t = v[i] + dt * step;
+
+        // edge crossed by the sample ('diagonal' crossings are resolved
+        // across one of the edges)
+        int edge = -1;
+        if (s >= 1.0f) edge = 1;
+        if (s <= 0.0f) edge = 3;
+        if (t >= 1.0f) edge = 2;
+        if (t <= 0.0f) edge = 0;
+
+        if (edge >= 0) {
+            int const * adjacency = adjacencyBuffer + 5*face;
+
+            int adjFace = adjacency[edge],
+                adjEdge = (adjacency[4] >> (2*edge)) & 3;
+
+            // samples bounce off boundaries, and off the edges between
+            // quads and the sub-faces of non-quads (their parameterizations
+            // do not match)
+            if (adjFace < 0 or adjFace >= numFaces or
+                ((adjacency[4] ^ adjacencyBuffer[5*adjFace+4]) & (1 << 8))) {
+                bounceSample(edge, s, t, ds, dt);
+            } else {
+                if (s <  0.0f) s += 1.0f;
+                if (s >= 1.0f) s -= 1.0f;
+                if (t <  0.0f) t += 1.0f;
+                if (t >= 1.0f) t -= 1.0f;
+                rotateSample(edge - adjEdge + 2, s, t, ds, dt);
+                face = adjFace;
+            }
+        }
+
+        faceIds[i] = face;
+        u[i] = std::max(0.0f, std::min(s, 1.0f));
+        v[i] = std::max(0.0f, std::min(t, 1.0f));
+        velocities[2*i] = ds;
+        velocities[2*i+1] = dt;
+    }
+}
+
+void
+CpuBlendKeyframes(float const * keys, BufferDescriptor const &keyDesc,
+                  float * dst, BufferDescriptor const &dstDesc,
+                  int numVertices, int key0, int key1, float weight,
+                  int start, int end) {
+
+    int length = dstDesc.length;
+
+    float const * src0 = keys + keyDesc.offset
+                       + (key0 * numVertices + start) * keyDesc.stride;
+    float const * src1 = keys + keyDesc.offset
+                       + (key1 * numVertices + start) * keyDesc.stride;
+    dst += dstDesc.offset + start * dstDesc.stride;
+
+    for (int i = start; i < end; ++i) {
+        for (int k = 0; k < length; ++k) {
+            dst[k] = src0[k] + (src1[k] - src0[k]) * weight;
+        }
+        src0 += keyDesc.stride;
+        src1 += keyDesc.stride;
+        dst += dstDesc.stride;
+    }
+}
+
 }  // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
@@ -26,6 +26,8 @@
 #define OPENSUBDIV3_OSD_CPU_KERNEL_H
 
 #include "../version.h"
+#include "../osd/cpuFixedStencilKernel.h"
+
 #include <cstring>
 
 namespace OpenSubdiv {
@@ -34,6 +36,13 @@ namespace OPENSUBDIV_VERSION {
 namespace Osd {
 
 struct BufferDescriptor;
+class CpuCompactStencilTable;
+class CpuInstancedStencilTable;
+class CpuPatchGridBasis;
+class CpuVaryingStencilTable;
+struct PatchArray;
+struct PatchCoord;
+struct PatchParam;
 
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
@@ -57,15 +66,231 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvWeights,
                 int start, int end);
 
-//
-// SIMD ICC optimization of the stencil kernel
-//
+// Splits the stencils [start, end) into 'numRanges' consecutive ranges of
+// (nearly) equal numbers of weights, searching the offsets of the stencils
+// (the prefix sums of their sizes) : range i spans the stencils
+// [bounds[i], bounds[i+1]), so 'bounds' holds numRanges+1 entries.
+void
+CpuGetStencilRanges(int const * sizes, int const * offsets,
+                    int start, int end, int numRanges, int * bounds);
+
+// Evaluates the stencils [start, end) for the instances of a batch, located by
+// (srcOffset, dstOffset) pairs added to the offsets of srcDesc and dstDesc.
+// Instances interleaved within each element (e.g. the time samples of a
+// vertex) are evaluated in a single pass over the stencils. As with
+// CpuEvalStencils, dst is indexed from the first stencil of the range.
+void
+CpuEvalStencilsBatch(float const * src, BufferDescriptor const &srcDesc,
+                     float * dst,       BufferDescriptor const &dstDesc,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances, int const * instanceOffsets);
+
+// Evaluates primvars of doubles : weights remain floats, but values are
+// accumulated in double precision (e.g. for the coordinates of large scenes).
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                int start, int end);
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                double * dstDu,     BufferDescriptor const &dstDuDesc,
+                double * dstDv,     BufferDescriptor const &dstDvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                int start, int end);
+
+// Evaluates the stencils with first and second derivatives in a single pass
+// over their control vertices (outputs other than dst may be NULL).
+void
+CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                float * dstDu,     BufferDescriptor const &dstDuDesc,
+                float * dstDv,     BufferDescriptor const &dstDvDesc,
+                float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+                float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+                float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                float const * duuWeights,
+                float const * duvWeights,
+                float const * dvvWeights,
+                int start, int end);
+
+// Evaluates the blocks [startBlock, endBlock) of a CpuPackedStencilTable :
+// unlike CpuEvalStencils, dst is indexed from the first stencil of the
+// table, so that ranges of blocks can be evaluated concurrently.
+void
+CpuEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils,
+                      int startBlock, int endBlock);
+
+void
+CpuEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstDu,     BufferDescriptor const &dstDuDesc,
+                      float * dstDv,     BufferDescriptor const &dstDvDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils,
+                      int startBlock, int endBlock);
+
+// Evaluates the stencils [start, end) of a CpuCompactStencilTable : as with
+// CpuEvalStencils, dst is indexed from the first stencil of the range.
+void
+CpuEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end);
+
+void
+CpuEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       float * dstDu,     BufferDescriptor const &dstDuDesc,
+                       float * dstDv,     BufferDescriptor const &dstDvDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end);
+
+// Evaluates the stencils [start, end) of a CpuInstancedStencilTable : as with
+// CpuEvalStencils, dst is indexed from the first stencil of the range.
+void
+CpuEvalInstancedStencils(float const * src, BufferDescriptor const &srcDesc,
+                         float * dst,       BufferDescriptor const &dstDesc,
+                         CpuInstancedStencilTable const & stencilTable,
+                         int start, int end);
+
+// Evaluates all the stencils of a CpuVaryingStencilTable, level by level :
+// the vertices of a level are interpolated from those of the previous level
+// (read from src for the first level, from dst for the next ones).
+void
+CpuEvalVaryingStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuVaryingStencilTable const & stencilTable);
+
+// Evaluates PatchCoords with first and second derivatives in a single pass
+// over the control vertices of their patches (outputs other than dst may be
+// NULL, and are indexed from the first coordinate so that ranges of
+// coordinates can be evaluated concurrently). Coordinates on patches of
+// unsupported types are evaluated to zero (returns false if any).
+bool
+CpuEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               float * dst,       BufferDescriptor const &dstDesc,
+               float * dstDu,     BufferDescriptor const &dstDuDesc,
+               float * dstDv,     BufferDescriptor const &dstDvDesc,
+               float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+               float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+               float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+               int numPatchCoords,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer);
 
-#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
-    #define __ALIGN_DATA __declspec(align(32))
-#else
-    #define __ALIGN_DATA
-#endif
+// Evaluates the unit normals of the limit surface at PatchCoords (and their
+// unit tangents, along du, if 'tangent') from the derivatives of the first 3
+// components of the primvars, without writing the derivatives : normal and
+// tangent are 3 floats, dst and tangent may be NULL. Where the derivatives
+// are degenerate (zero or parallel, e.g. at collapsed points), the normal is
+// the limit of the normals from the interior of the patch, from the second
+// derivatives. Patches of unsupported types are evaluated to zero (returns
+// false if any).
+bool
+CpuEvalPatchNormals(float const * src, BufferDescriptor const &srcDesc,
+                    float * dst,       BufferDescriptor const &dstDesc,
+                    float * normal,    BufferDescriptor const &normalDesc,
+                    float * tangent,   BufferDescriptor const &tangentDesc,
+                    int numPatchCoords,
+                    PatchCoord const * patchCoords,
+                    PatchArray const * patchArrays,
+                    int const * patchIndexBuffer,
+                    PatchParam const * patchParamBuffer);
+
+// Evaluates the unit normals (and tangents) of limit stencils from their
+// derivative weights (see CpuEvalPatchNormals) : stencils having no
+// parametric location, their degenerate normals are zero. weights may be
+// NULL if dst is.
+void
+CpuEvalStencilNormals(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * normal,    BufferDescriptor const &normalDesc,
+                      float * tangent,   BufferDescriptor const &tangentDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int start, int end);
+
+// Evaluates the points of the grid of a CpuPatchGridBasis on all the patches
+// of the patch arrays : the points of the patch of PatchParam p are written
+// from index p * basis.GetNumPoints() of the outputs (du and dv may be NULL).
+// Patches of unsupported types are evaluated to zero (returns false if any).
+bool
+CpuEvalPatchGrids(float const * src, BufferDescriptor const &srcDesc,
+                  float * dst,       BufferDescriptor const &dstDesc,
+                  float * dstDu,     BufferDescriptor const &dstDuDesc,
+                  float * dstDv,     BufferDescriptor const &dstDvDesc,
+                  CpuPatchGridBasis const & basis,
+                  int numPatchArrays,
+                  PatchArray const * patchArrays,
+                  int const * patchIndexBuffer,
+                  PatchParam const * patchParamBuffer);
+
+// Maps PatchCoords of the vertex patches to the PatchCoords of the patches of
+// a face-varying channel (see CpuPatchTable::GetFVarPatchArrayBuffer), to be
+// evaluated as vertex patches.
+void
+CpuGetFVarPatchCoords(int numPatchCoords,
+                      PatchCoord const * patchCoords,
+                      PatchArray const * fvarPatchArrays,
+                      PatchParam const * fvarPatchParamBuffer,
+                      PatchCoord * fvarPatchCoords);
+
+// Moves the (faceId, u, v) surface samples [start, end) by their parametric
+// velocities (du, dv) times 'step', warping the samples crossing an edge of
+// their ptex face to the adjacent face, or bouncing them off boundaries
+// (see CpuPtexAdjacency). Samples move across one edge per step at most.
+void
+CpuAdvectSamples(int start, int end,
+                 int * faceIds, float * u, float * v, float * velocities,
+                 float step,
+                 int numFaces, int const * adjacencyBuffer);
+
+// Blends the primvars of the vertices [start, end) of two keyframes stored
+// one after the other in 'keys' (numVertices vertices per keyframe), and
+// writes them to 'dst' : dst = keys[key0] * (1 - weight) + keys[key1] * weight
+void
+CpuBlendKeyframes(float const * keys, BufferDescriptor const &keyDesc,
+                  float * dst, BufferDescriptor const &dstDesc,
+                  int numVertices, int key0, int key1, float weight,
+                  int start, int end);
 
 // Note : this function is re-used in the TBB Compute kernel
 template <int numElems> void
@@ -77,48 +302,9 @@ ComputeStencilKernel(float const * vertexSrc,
                      int start,
                      int end) {
 
-    __ALIGN_DATA float result[numElems],
-                       result1[numElems];
-
-    float const * src;
-    float * dst, weight;
-
-    for (int i=start; i<end; ++i) {
-
-        // Clear
-#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
-    #pragma simd
-    #pragma vector aligned
-#endif
-        for (int k = 0; k<numElems; ++k)
-            result[k] = 0.0f;
-
-        for (int j=0; j<sizes[i]; ++j, ++indices, ++weights) {
-
-            src = vertexSrc + (*indices)*numElems;
-            weight = *weights;
-
-            // AddWithWeight
-#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
-    #pragma simd
-    #pragma vector aligned
-#endif
-            for (int k=0; k<numElems; ++k) {
-                result[k] += src[k] * weight;
-            }
-        }
-
-#if defined ( __INTEL_COMPILER ) or defined ( __ICC )
-    #pragma simd
-    #pragma vector aligned
-#endif
-        for (int k=0; k<numElems; ++k) {
-            result1[k] = result[k];
-        }
-
-        dst = vertexDst + i*numElems;
-        memcpy(dst, result1, numElems*sizeof(float));
-    }
+    CpuEvalFixedStencils<numElems, numElems, numElems>(vertexSrc,
+        vertexDst + start*numElems, sizes + start, indices, weights,
+        end - start);
 }
 
 }  // end namespace Osd
@@ -0,0 +1,122 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuPackedStencilTable.h"
+#include "../far/stencilTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CpuPackedStencilTable::CpuPackedStencilTable(
+    Far::StencilTable const *stencilTable, int blockWidth) :
+        _numStencils(0), _blockWidth(blockWidth > 12 ? 16 : 8) {
+
+    pack(stencilTable, 0, 0);
+}
+
+CpuPackedStencilTable::CpuPackedStencilTable(
+    Far::LimitStencilTable const *limitStencilTable, int blockWidth) :
+        _numStencils(0), _blockWidth(blockWidth > 12 ? 16 : 8) {
+
+    pack(limitStencilTable, &limitStencilTable->GetDuWeights(),
+                            &limitStencilTable->GetDvWeights());
+}
+
+void
+CpuPackedStencilTable::pack(Far::StencilTable const *stencilTable,
+                            std::vector<float> const *duWeights,
+                            std::vector<float> const *dvWeights) {
+
+    _numStencils = stencilTable->GetNumStencils();
+
+    std::vector<int> const & sizes = stencilTable->GetSizes();
+    std::vector<Far::Index> const & offsets = stencilTable->GetOffsets();
+    std::vector<Far::Index> const & indices = stencilTable->GetControlIndices();
+    std::vector<float> const & weights = stencilTable->GetWeights();
+
+    int numBlocks = (_numStencils + _blockWidth - 1) / _blockWidth;
+
+    // each block has as many rows as its largest stencil has weights
+    _blockOffsets.resize(numBlocks + 1);
+    _blockOffsets[0] = 0;
+    for (int block=0; block<numBlocks; ++block) {
+        int firstStencil = block * _blockWidth,
+            numRows = 0;
+        for (int i=firstStencil; i<firstStencil+_blockWidth and
+                                 i<_numStencils; ++i) {
+            if (sizes[i] > numRows) numRows = sizes[i];
+        }
+        _blockOffsets[block+1] = _blockOffsets[block] + numRows;
+    }
+
+    int numEntries = _blockOffsets[numBlocks] * _blockWidth;
+
+    _indices.resize(numEntries);
+    _weights.resize(numEntries);
+    if (duWeights and dvWeights) {
+        _duWeights.resize(numEntries);
+        _dvWeights.resize(numEntries);
+    }
+
+    // pad with zero weights of the last control vertex of each stencil (so
+    // that gathers of padded lanes stay within cache lines already loaded),
+    // or of the first control vertex for lanes past the last stencil
+    for (int block=0; block<numBlocks; ++block) {
+        int numRows = _blockOffsets[block+1] - _blockOffsets[block];
+        for (int lane=0; lane<_blockWidth; ++lane) {
+
+            int stencil = block * _blockWidth + lane,
+                size = stencil < _numStencils ? sizes[stencil] : 0,
+                ofs = size > 0 ? offsets[stencil] : 0;
+
+            Far::Index padIndex = size > 0 ? indices[ofs + size - 1] : 0;
+
+            for (int row=0; row<numRows; ++row) {
+                int entry = (_blockOffsets[block] + row) * _blockWidth + lane;
+                if (row < size) {
+                    _indices[entry] = indices[ofs + row];
+                    _weights[entry] = weights[ofs + row];
+                    if (not _duWeights.empty()) {
+                        _duWeights[entry] = (*duWeights)[ofs + row];
+                        _dvWeights[entry] = (*dvWeights)[ofs + row];
+                    }
+                } else {
+                    _indices[entry] = padIndex;
+                    _weights[entry] = 0.0f;
+                    if (not _duWeights.empty()) {
+                        _duWeights[entry] = 0.0f;
+                        _dvWeights[entry] = 0.0f;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,131 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_PACKED_STENCIL_TABLE_H
+#define OPENSUBDIV3_OSD_CPU_PACKED_STENCIL_TABLE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class StencilTable;
+    class LimitStencilTable;
+}
+
+namespace Osd {
+
+/// \brief Stencil table packed for SIMD evaluation on the CPU
+///
+/// This class is a re-arrangement of Far::StencilTable (or
+/// Far::LimitStencilTable) into blocks of BlockWidth consecutive stencils,
+/// each padded with zero weights to the size of the largest stencil of its
+/// block. The control vertex indices and weights of a block are transposed :
+/// row j of a block holds the j-th index and weight of each of its stencils,
+/// so that each lane of a vector instruction evaluates a different stencil.
+///
+/// Tables of 8 stencil wide blocks match AVX2 vectors, while tables of 16
+/// stencil wide blocks also match AVX-512 vectors. Packed tables are evaluated
+/// by CpuEvaluator, OmpEvaluator and TbbEvaluator.
+///
+/// \note Stencil tables of several passes (see
+///       Far::StencilTable::GetPassOffsets()) are not supported.
+///
+class CpuPackedStencilTable {
+public:
+    static CpuPackedStencilTable *Create(Far::StencilTable const *stencilTable,
+                                         void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuPackedStencilTable(stencilTable);
+    }
+
+    static CpuPackedStencilTable *Create(
+        Far::LimitStencilTable const *limitStencilTable,
+        void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuPackedStencilTable(limitStencilTable);
+    }
+
+    /// \brief Packs a stencil table in blocks of 8 or 16 stencils (other
+    ///        block widths are rounded to the nearest of the two)
+    explicit CpuPackedStencilTable(Far::StencilTable const *stencilTable,
+                                   int blockWidth = 8);
+
+    explicit CpuPackedStencilTable(Far::LimitStencilTable const *limitStencilTable,
+                                   int blockWidth = 8);
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return _numStencils; }
+
+    /// \brief Returns the number of stencils in each block
+    int GetBlockWidth() const { return _blockWidth; }
+
+    /// \brief Returns the number of blocks (the last one may be incomplete)
+    int GetNumBlocks() const { return (int)_blockOffsets.size() - 1; }
+
+    /// \brief Returns the first row of each block, followed by the total
+    ///        number of rows (GetNumBlocks() + 1 entries)
+    std::vector<int> const & GetBlockOffsets() const { return _blockOffsets; }
+
+    /// \brief Returns the transposed control vertex indices
+    ///        (row * BlockWidth + lane)
+    std::vector<int> const & GetControlIndices() const { return _indices; }
+
+    /// \brief Returns the transposed stencil weights
+    std::vector<float> const & GetWeights() const { return _weights; }
+
+    /// \brief Returns the transposed u-derivative weights (limit stencils only)
+    std::vector<float> const & GetDuWeights() const { return _duWeights; }
+
+    /// \brief Returns the transposed v-derivative weights (limit stencils only)
+    std::vector<float> const & GetDvWeights() const { return _dvWeights; }
+
+private:
+    void pack(Far::StencilTable const *stencilTable,
+              std::vector<float> const *duWeights,
+              std::vector<float> const *dvWeights);
+
+    int _numStencils,
+        _blockWidth;
+
+    std::vector<int> _blockOffsets,
+                     _indices;
+
+    std::vector<float> _weights,
+                       _duWeights,
+                       _dvWeights;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_PACKED_STENCIL_TABLE_H
@@ -0,0 +1,148 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuPatchGridBasis.h"
+#include "../far/patchBasis.h"
+#include "../far/patchParam.h"
+
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static int const numRegularMasks = 16;
+
+static int
+getNumControlVertices(Far::PatchDescriptor::Type type) {
+    switch (type) {
+        case Far::PatchDescriptor::REGULAR       : return 16;
+        case Far::PatchDescriptor::GREGORY_BASIS : return 20;
+        case Far::PatchDescriptor::QUADS         : return 4;
+        default : return 0;
+    }
+}
+
+CpuPatchGridBasis::CpuPatchGridBasis(int resolution, bool derivatives) :
+    _resolution(resolution), _derivatives(derivatives) {
+}
+
+CpuPatchGridBasis *
+CpuPatchGridBasis::Create(int resolution, bool derivatives) {
+
+    if (resolution < 2) return NULL;
+
+    CpuPatchGridBasis * basis = new CpuPatchGridBasis(resolution, derivatives);
+
+    int rows = derivatives ? 3 : 1,
+        tableSize = rows * basis->GetNumPoints();
+
+    int regularSize =
+        tableSize * getNumControlVertices(Far::PatchDescriptor::REGULAR);
+    basis->_regularWeights.resize(numRegularMasks * regularSize);
+    for (int boundary = 0; boundary < numRegularMasks; ++boundary) {
+        basis->buildTable(Far::PatchDescriptor::REGULAR, boundary,
+                          &basis->_regularWeights[boundary * regularSize]);
+    }
+
+    basis->_gregoryWeights.resize(
+        tableSize * getNumControlVertices(Far::PatchDescriptor::GREGORY_BASIS));
+    basis->buildTable(Far::PatchDescriptor::GREGORY_BASIS, 0,
+                      &basis->_gregoryWeights[0]);
+
+    basis->_bilinearWeights.resize(
+        tableSize * getNumControlVertices(Far::PatchDescriptor::QUADS));
+    basis->buildTable(Far::PatchDescriptor::QUADS, 0,
+                      &basis->_bilinearWeights[0]);
+
+    return basis;
+}
+
+void
+CpuPatchGridBasis::buildTable(Far::PatchDescriptor::Type type, int boundary,
+                              float * table) const {
+
+    enum { MAX_CVS = 20 };
+
+    // a patch of depth 0 covering its base face : the (u,v) of the points
+    // are those of the domain of the patch
+    Far::PatchParam param;
+    param.Set(0, 0, 0, 0, false, (unsigned short)boundary, 0);
+
+    int numCVs = getNumControlVertices(type),
+        numPoints = GetNumPoints();
+
+    float w[3][MAX_CVS];
+    float * wDu = _derivatives ? w[1] : NULL,
+          * wDv = _derivatives ? w[2] : NULL;
+
+    for (int k = 0; k < numPoints; ++k) {
+        float u = (float)(k % _resolution) / (float)(_resolution - 1),
+              v = (float)(k / _resolution) / (float)(_resolution - 1);
+
+        switch (type) {
+        case Far::PatchDescriptor::REGULAR:
+            Far::internal::GetBSplineWeights(param, u, v, w[0], wDu, wDv);
+            break;
+        case Far::PatchDescriptor::GREGORY_BASIS:
+            Far::internal::GetGregoryWeights(param, u, v, w[0], wDu, wDv);
+            break;
+        case Far::PatchDescriptor::QUADS:
+            Far::internal::GetBilinearWeights(param, u, v, w[0], wDu, wDv);
+            break;
+        default:
+            assert(0);
+        }
+
+        // rows of the weights of a control vertex at all the points
+        for (int row = 0; row < (_derivatives ? 3 : 1); ++row) {
+            for (int j = 0; j < numCVs; ++j) {
+                table[(row * numCVs + j) * numPoints + k] = w[row][j];
+            }
+        }
+    }
+}
+
+float const *
+CpuPatchGridBasis::GetWeights(Far::PatchDescriptor::Type type,
+                              int boundary) const {
+
+    switch (type) {
+        case Far::PatchDescriptor::REGULAR :
+            return &_regularWeights[(boundary & (numRegularMasks-1)) *
+                (_regularWeights.size() / numRegularMasks)];
+        case Far::PatchDescriptor::GREGORY_BASIS :
+            return &_gregoryWeights[0];
+        case Far::PatchDescriptor::QUADS :
+            return &_bilinearWeights[0];
+        default :
+            return NULL;
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
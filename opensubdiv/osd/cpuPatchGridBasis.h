@@ -0,0 +1,114 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_PATCH_GRID_BASIS_H
+#define OPENSUBDIV3_OSD_CPU_PATCH_GRID_BASIS_H
+
+#include "../version.h"
+
+#include <vector>
+#include "../far/patchDescriptor.h"
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief Basis weights of the patches at the points of a uniform grid
+///
+/// Uniform tessellation, baking and preview sampling evaluate every patch at
+/// the same locations of its domain : the weights of the control vertices of
+/// the patches at these locations are tabulated once, and the evaluation of
+/// the grid of a patch reduces to a dense product of a table with the control
+/// vertices of the patch (see CpuEvaluator::EvalPatchGrids()).
+///
+/// The grid has 'resolution' points along u and v, at i / (resolution - 1),
+/// numbered row by row : point (i + j * resolution) is at (u_i, v_j) in the
+/// domain of the patch (rather than of its base face).
+///
+/// A table is built for each boundary mask of the regular (B-spline) patches,
+/// and one for each of the Gregory basis and bilinear (QUADS) patches. The
+/// depth of a patch only scales its derivatives, and is applied during the
+/// evaluation rather than tabulated.
+///
+class CpuPatchGridBasis : private NonCopyable<CpuPatchGridBasis> {
+public:
+    /// \brief Creates the tables of a grid
+    ///
+    /// @param resolution   Number of points along u and v (at least 2)
+    ///
+    /// @param derivatives  Tabulates the weights of the first derivatives
+    ///
+    static CpuPatchGridBasis * Create(int resolution,
+                                      bool derivatives = false);
+
+    /// \brief Returns the number of points along u and v
+    int GetResolution() const { return _resolution; }
+
+    /// \brief Returns the number of points of the grid
+    int GetNumPoints() const { return _resolution * _resolution; }
+
+    /// \brief True if the weights of the first derivatives are tabulated
+    bool HasDerivatives() const { return _derivatives; }
+
+    /// \brief Returns the table of a type of patch, NULL if the type is not
+    ///        supported
+    ///
+    /// The table of a patch of N control vertices holds the N rows of the
+    /// weights of its control vertices at the GetNumPoints() points, followed
+    /// by the N rows of the weights of the U and V derivatives (at depth 0)
+    /// if tabulated.
+    ///
+    /// @param type      Type of the patches
+    ///
+    /// @param boundary  Boundary mask of the patches (only used for the
+    ///                  regular patches, see Far::PatchParam::GetBoundary())
+    ///
+    float const * GetWeights(Far::PatchDescriptor::Type type,
+                             int boundary) const;
+
+protected:
+    CpuPatchGridBasis(int resolution, bool derivatives);
+
+private:
+    void buildTable(Far::PatchDescriptor::Type type, int boundary,
+                    float * table) const;
+
+    int  _resolution;
+    bool _derivatives;
+
+    std::vector<float> _regularWeights,    // 16 tables, one per boundary mask
+                       _gregoryWeights,
+                       _bilinearWeights;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_PATCH_GRID_BASIS_H
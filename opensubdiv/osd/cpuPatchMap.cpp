@@ -0,0 +1,51 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cpuPatchMap.h"
+#include "../far/patchMap.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CpuPatchMap::CpuPatchMap(Far::PatchMap const *patchMap) {
+
+    patchMap->GetEncodedTables(_faceBuffer, _nodeBuffer);
+
+    std::vector<Far::PatchMap::Handle> const & handles = patchMap->GetHandles();
+
+    _handleBuffer.resize(3 * handles.size());
+    for (int i = 0; i < (int)handles.size(); ++i) {
+        _handleBuffer[3*i  ] = handles[i].arrayIndex;
+        _handleBuffer[3*i+1] = handles[i].patchIndex;
+        _handleBuffer[3*i+2] = handles[i].vertIndex;
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
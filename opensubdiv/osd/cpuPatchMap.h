@@ -0,0 +1,99 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_CPU_PATCH_MAP_H
+#define OPENSUBDIV3_OSD_CPU_PATCH_MAP_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class PatchMap;
+};
+
+namespace Osd {
+
+/// \brief Cpu patch map
+///
+/// Encoding of a Far::PatchMap in buffers of integers (see
+/// Far::PatchMap::GetEncodedTables), so that the patches of (faceId, u, v)
+/// locations can be found by the kernels of the evaluators
+/// (see CpuEvaluator::FindPatchCoords). Device-specific patch maps use it as
+/// a staging buffer.
+///
+class CpuPatchMap {
+public:
+    static CpuPatchMap *Create(Far::PatchMap const *patchMap,
+                               void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuPatchMap(patchMap);
+    }
+
+    explicit CpuPatchMap(Far::PatchMap const *patchMap);
+    ~CpuPatchMap() {}
+
+    /// \brief Returns the (first cell, grid depth) pair of each face
+    const int *GetFaceBuffer() const {
+        return _faceBuffer.empty() ? NULL : &_faceBuffer[0];
+    }
+    /// \brief Returns the grid cells and the quadtree nodes
+    const unsigned int *GetNodeBuffer() const {
+        return _nodeBuffer.empty() ? NULL : &_nodeBuffer[0];
+    }
+    /// \brief Returns the handles of the patches
+    ///        (arrayIndex, patchIndex, vertIndex)
+    const int *GetHandleBuffer() const {
+        return _handleBuffer.empty() ? NULL : &_handleBuffer[0];
+    }
+
+    int GetNumFaces() const {
+        return (int)_faceBuffer.size() / 2;
+    }
+    size_t GetNodeBufferSize() const {
+        return _nodeBuffer.size();
+    }
+    size_t GetHandleBufferSize() const {
+        return _handleBuffer.size();
+    }
+
+protected:
+    std::vector<int>          _faceBuffer;
+    std::vector<unsigned int> _nodeBuffer;
+    std::vector<int>          _handleBuffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_PATCH_MAP_H
@@ -24,12 +24,15 @@
 
 #include "../osd/cpuPatchTable.h"
 
+#include <algorithm>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
-CpuPatchTable::CpuPatchTable(const Far::PatchTable *farPatchTable) {
+CpuPatchTable::CpuPatchTable(const Far::PatchTable *farPatchTable,
+                             bool compactIndices) {
     int nPatchArrays = farPatchTable->GetNumPatchArrays();
 
     // count
@@ -97,6 +100,102 @@ CpuPatchTable::CpuPatchTable(const Far::PatchTable *farPatchTable) {
         }
 #endif
     }
+
+    // face-varying channels
+    int nChannels = farPatchTable->GetNumFVarChannels();
+    _fvarPatchArrays.resize(nChannels);
+    _fvarIndexBuffers.resize(nChannels);
+    _fvarParamBuffers.resize(nChannels);
+    for (int channel = 0; channel < nChannels; ++channel) {
+        Far::PatchDescriptor desc =
+            farPatchTable->GetFVarChannelPatchDescriptor(channel);
+
+        _fvarPatchArrays[channel].push_back(
+            PatchArray(desc, numPatches, 0, 0));
+        _fvarPatchArrays[channel].push_back(
+            PatchArray(Far::PatchDescriptor::QUADS, numPatches, 0, 0));
+
+        Far::ConstIndexArray values = farPatchTable->GetFVarValues(channel);
+        _fvarIndexBuffers[channel].assign(values.begin(), values.end());
+
+        Far::ConstPatchParamArray params =
+            farPatchTable->GetFVarPatchParams(channel);
+        _fvarParamBuffers[channel].resize(params.size());
+        for (int k = 0; k < params.size(); ++k) {
+            PatchParam & param = _fvarParamBuffers[channel][k];
+            param.field0 = params[k].field0;
+            param.field1 = params[k].field1;
+            param.sharpness = 0.0f;
+        }
+    }
+
+    if (compactIndices) {
+        compactPatchIndices();
+    }
+}
+
+void
+CpuPatchTable::compactPatchIndices() {
+
+    // patches are appended to a range as long as all the control vertices of
+    // the range are within 16 bits of its lowest vertex
+    int const maxSpan = 0xffff;
+
+    for (int j = 0; j < (int)_patchArrays.size(); ++j) {
+        PatchArray const &patchArray = _patchArrays[j];
+
+        int numPatches = patchArray.GetNumPatches();
+        int numCVs = patchArray.GetDescriptor().GetNumControlVertices();
+        int const *indices = _indexBuffer.empty() ?
+            NULL : &_indexBuffer[patchArray.GetIndexBase()];
+
+        int first = 0, rangeMin = 0, rangeMax = 0;
+        bool rangeWide = false;
+        for (int patch = 0; patch <= numPatches; ++patch) {
+            int patchMin = 0, patchMax = 0;
+            if (patch < numPatches) {
+                int const *cvs = indices + patch * numCVs;
+                patchMin = *std::min_element(cvs, cvs + numCVs);
+                patchMax = *std::max_element(cvs, cvs + numCVs);
+            }
+            bool patchWide = (patchMax - patchMin) > maxSpan;
+
+            if (patch > first) {
+                int spanMin = std::min(rangeMin, patchMin),
+                    spanMax = std::max(rangeMax, patchMax);
+                bool extends = (patch < numPatches) and
+                               (patchWide == rangeWide) and
+                               (rangeWide or (spanMax - spanMin) <= maxSpan);
+                if (extends) {
+                    rangeMin = spanMin;
+                    rangeMax = spanMax;
+                    continue;
+                }
+
+                // close the range [first, patch)
+                int indexBase = rangeWide ? (int)_wideIndexBuffer.size() :
+                                            (int)_compactIndexBuffer.size();
+                PatchArray range(patchArray.GetDescriptor(), patch - first,
+                                 indexBase,
+                                 patchArray.GetPrimitiveIdBase() + first);
+                _compactPatchArrays.push_back(CompactPatchArray(range,
+                    rangeWide ? 0 : rangeMin, rangeWide ? 4 : 2));
+
+                for (int k = first * numCVs; k < patch * numCVs; ++k) {
+                    if (rangeWide) {
+                        _wideIndexBuffer.push_back(indices[k]);
+                    } else {
+                        _compactIndexBuffer.push_back(
+                            (unsigned short)(indices[k] - rangeMin));
+                    }
+                }
+                first = patch;
+            }
+            rangeMin = patchMin;
+            rangeMax = patchMax;
+            rangeWide = patchWide;
+        }
+    }
 }
 
 }  // end namespace Osd
@@ -62,7 +62,16 @@ public:
         return new CpuPatchTable(patchTable);
     }
 
-    explicit CpuPatchTable(const Far::PatchTable *patchTable);
+    /// \brief Constructor
+    ///
+    /// @param patchTable      Far patch table
+    ///
+    /// @param compactIndices  also encode the control vertices of the patches
+    ///                        as 16-bit offsets where possible (see
+    ///                        GetCompactPatchArrayBuffer)
+    ///
+    explicit CpuPatchTable(const Far::PatchTable *patchTable,
+                           bool compactIndices = false);
     ~CpuPatchTable() {}
 
     const PatchArray *GetPatchArrayBuffer() const {
@@ -85,10 +94,74 @@ public:
         return _patchParamBuffer.size();
     }
 
+    /// \brief Returns the patch arrays of a face-varying channel : both
+    ///        arrays span all the patches of the channel, the first with the
+    ///        patch type of the channel, the second bilinear to evaluate the
+    ///        bilinear patches of bicubic channels (see
+    ///        CpuEvaluator::EvalPatchesFaceVarying)
+    const PatchArray *GetFVarPatchArrayBuffer(int fvarChannel = 0) const {
+        return &_fvarPatchArrays[fvarChannel][0];
+    }
+    const int *GetFVarPatchIndexBuffer(int fvarChannel = 0) const {
+        return _fvarIndexBuffers[fvarChannel].empty() ?
+            NULL : &_fvarIndexBuffers[fvarChannel][0];
+    }
+    const PatchParam *GetFVarPatchParamBuffer(int fvarChannel = 0) const {
+        return _fvarParamBuffers[fvarChannel].empty() ?
+            NULL : &_fvarParamBuffers[fvarChannel][0];
+    }
+
+    int GetNumFVarChannels() const {
+        return (int)_fvarPatchArrays.size();
+    }
+    size_t GetFVarPatchIndexSize(int fvarChannel = 0) const {
+        return _fvarIndexBuffers[fvarChannel].size();
+    }
+    size_t GetFVarPatchParamSize(int fvarChannel = 0) const {
+        return _fvarParamBuffers[fvarChannel].size();
+    }
+
+    /// \brief Returns the patch arrays of the compact encoding of the patch
+    ///        indices : the patch arrays split into ranges of patches whose
+    ///        control vertices are 16-bit offsets from a common base vertex
+    ///        in GetCompactPatchIndexBuffer(), or 32-bit indices in
+    ///        GetWidePatchIndexBuffer() when a patch spans more than 16 bits
+    ///        of vertices.  Patch params are indexed as in the patch arrays.
+    ///        Empty unless the table was constructed with compactIndices.
+    const CompactPatchArray *GetCompactPatchArrayBuffer() const {
+        return _compactPatchArrays.empty() ? NULL : &_compactPatchArrays[0];
+    }
+    const unsigned short *GetCompactPatchIndexBuffer() const {
+        return _compactIndexBuffer.empty() ? NULL : &_compactIndexBuffer[0];
+    }
+    const int *GetWidePatchIndexBuffer() const {
+        return _wideIndexBuffer.empty() ? NULL : &_wideIndexBuffer[0];
+    }
+
+    size_t GetNumCompactPatchArrays() const {
+        return _compactPatchArrays.size();
+    }
+    size_t GetCompactPatchIndexSize() const {
+        return _compactIndexBuffer.size();
+    }
+    size_t GetWidePatchIndexSize() const {
+        return _wideIndexBuffer.size();
+    }
+
 protected:
+    void compactPatchIndices();
+
     PatchArrayVector _patchArrays;
     std::vector<int> _indexBuffer;
     PatchParamVector _patchParamBuffer;
+
+    std::vector<PatchArrayVector> _fvarPatchArrays;
+    std::vector< std::vector<int> > _fvarIndexBuffers;
+    std::vector<PatchParamVector> _fvarParamBuffers;
+
+    CompactPatchArrayVector     _compactPatchArrays;
+    std::vector<unsigned short> _compactIndexBuffer;
+    std::vector<int>            _wideIndexBuffer;
 };
 
 }  // end namespace Osd
@@ -0,0 +1,68 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cpuPtexAdjacency.h"
+#include "../far/ptexIndices.h"
+#include "../far/topologyRefiner.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CpuPtexAdjacency::CpuPtexAdjacency(Far::TopologyRefiner const &refiner) {
+
+    Far::PtexIndices ptexIndices(refiner);
+
+    Far::TopologyLevel const & baseLevel = refiner.GetLevel(0);
+
+    _adjacencyBuffer.resize(5 * ptexIndices.GetNumFaces());
+
+    int * dst = _adjacencyBuffer.empty() ? NULL : &_adjacencyBuffer[0];
+
+    int adjFaces[4],
+        adjEdges[4];
+    for (int face = 0; face < baseLevel.GetNumFaces(); ++face) {
+
+        int nverts = baseLevel.GetFaceVertices(face).size(),
+            nsubfaces = (nverts == 4) ? 1 : nverts;
+
+        // non-quads are split into a quad sub-face per vertex
+        for (int quadrant = 0; quadrant < nsubfaces; ++quadrant, dst += 5) {
+            ptexIndices.GetAdjacency(refiner, face, quadrant,
+                                     adjFaces, adjEdges);
+            dst[4] = (nverts == 4) ? 0 : (1 << 8);
+            for (int edge = 0; edge < 4; ++edge) {
+                dst[edge] = adjFaces[edge];
+                dst[4] |= (adjEdges[edge] & 3) << (2*edge);
+            }
+        }
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,86 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_PTEX_ADJACENCY_H
+#define OPENSUBDIV3_OSD_CPU_PTEX_ADJACENCY_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class TopologyRefiner;
+};
+
+namespace Osd {
+
+/// \brief Cpu ptex adjacency
+///
+/// Encoding of the adjacency of the ptex faces of a mesh (see
+/// Far::PtexIndices::GetAdjacency) in a buffer of integers, so that surface
+/// samples moving in the (u, v) space of their ptex faces can be warped
+/// across the edges of the faces by the kernels of the evaluators (see
+/// CpuEvaluator::AdvectPatchCoords). Device-specific adjacency tables use
+/// it as a staging buffer.
+///
+/// Each ptex face is encoded by 5 integers : the adjacent faces across its
+/// 4 edges (-1 on boundaries), then the edges of the adjacent faces (2 bits
+/// each) and a flag of the sub-faces of non-quads (bit 8).
+///
+class CpuPtexAdjacency {
+public:
+    static CpuPtexAdjacency *Create(Far::TopologyRefiner const &refiner,
+                                    void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuPtexAdjacency(refiner);
+    }
+
+    explicit CpuPtexAdjacency(Far::TopologyRefiner const &refiner);
+    ~CpuPtexAdjacency() {}
+
+    /// \brief Returns the encoded adjacency of the ptex faces
+    const int *GetAdjacencyBuffer() const {
+        return _adjacencyBuffer.empty() ? NULL : &_adjacencyBuffer[0];
+    }
+
+    int GetNumFaces() const {
+        return (int)_adjacencyBuffer.size() / 5;
+    }
+
+protected:
+    std::vector<int> _adjacencyBuffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_PTEX_ADJACENCY_H
@@ -0,0 +1,682 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_SIMD_KERNEL_H
+#define OPENSUBDIV3_OSD_CPU_SIMD_KERNEL_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+//
+// Stencil kernels using vector instruction sets selected at run time
+//
+// Each instruction set is compiled in its own translation unit, which
+// instantiates the kernel templates below with a set of wrappers around its
+// intrinsics (see cpuAvx2Kernel.cpp and cpuAvx512Kernel.cpp). Source and
+// destination pointers are expected at the first stencil to evaluate, and
+// primvars of any length are supported: the last vector of each primvar is
+// loaded and stored with a mask, so that neither reads nor writes extend past
+// 'length' into interleaved data.
+//
+// Weights are accumulated in the same order, with separate multiplies and
+// adds, as the scalar kernels, so results are identical to theirs.
+//
+// Primvars of doubles are evaluated by the same templates, with vectors of
+// half as many lanes (the weights of the stencils remain floats).
+//
+
+void
+CpuEvalStencilsAVX2(float const * src, int srcStride,
+                    float * dst,       int dstStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    int numStencils);
+
+void
+CpuEvalStencilsAVX2(float const * src, int srcStride,
+                    float * dst,       int dstStride,
+                    float * dstDu,     int dstDuStride,
+                    float * dstDv,     int dstDvStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    float const * duWeights,
+                    float const * dvWeights,
+                    int numStencils);
+
+void
+CpuEvalStencilsAVX2(double const * src, int srcStride,
+                    double * dst,       int dstStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    int numStencils);
+
+void
+CpuEvalStencilsAVX2(double const * src, int srcStride,
+                    double * dst,       int dstStride,
+                    double * dstDu,     int dstDuStride,
+                    double * dstDv,     int dstDvStride,
+                    int length,
+                    int const * sizes,
+                    int const * indices,
+                    float const * weights,
+                    float const * duWeights,
+                    float const * dvWeights,
+                    int numStencils);
+
+void
+CpuEvalStencilsAVX512(float const * src, int srcStride,
+                      float * dst,       int dstStride,
+                      int length,
+                      int const * sizes,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils);
+
+void
+CpuEvalStencilsAVX512(float const * src, int srcStride,
+                      float * dst,       int dstStride,
+                      float * dstDu,     int dstDuStride,
+                      float * dstDv,     int dstDvStride,
+                      int length,
+                      int const * sizes,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils);
+
+void
+CpuEvalStencilsAVX512(double const * src, int srcStride,
+                      double * dst,       int dstStride,
+                      int length,
+                      int const * sizes,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils);
+
+void
+CpuEvalStencilsAVX512(double const * src, int srcStride,
+                      double * dst,       int dstStride,
+                      double * dstDu,     int dstDuStride,
+                      double * dstDv,     int dstDvStride,
+                      int length,
+                      int const * sizes,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils);
+
+//
+// Packed stencil kernels (see CpuPackedStencilTable) : each lane of a vector
+// evaluates a different stencil, gathering one primvar element at a time from
+// the control vertices of WIDTH stencils. Blocks [startBlock, endBlock) are
+// evaluated, and destination pointers are expected at the first stencil of
+// the table (not of startBlock).
+//
+
+void
+CpuEvalPackedStencilsAVX2(float const * src, int srcStride,
+                          float * dst,       int dstStride,
+                          int length,
+                          int blockWidth,
+                          int const * blockOffsets,
+                          int const * indices,
+                          float const * weights,
+                          int numStencils,
+                          int startBlock, int endBlock);
+
+void
+CpuEvalPackedStencilsAVX2(float const * src, int srcStride,
+                          float * dst,       int dstStride,
+                          float * dstDu,     int dstDuStride,
+                          float * dstDv,     int dstDvStride,
+                          int length,
+                          int blockWidth,
+                          int const * blockOffsets,
+                          int const * indices,
+                          float const * weights,
+                          float const * duWeights,
+                          float const * dvWeights,
+                          int numStencils,
+                          int startBlock, int endBlock);
+
+void
+CpuEvalPackedStencilsAVX512(float const * src, int srcStride,
+                            float * dst,       int dstStride,
+                            int length,
+                            int blockWidth,
+                            int const * blockOffsets,
+                            int const * indices,
+                            float const * weights,
+                            int numStencils,
+                            int startBlock, int endBlock);
+
+void
+CpuEvalPackedStencilsAVX512(float const * src, int srcStride,
+                            float * dst,       int dstStride,
+                            float * dstDu,     int dstDuStride,
+                            float * dstDv,     int dstDvStride,
+                            int length,
+                            int blockWidth,
+                            int const * blockOffsets,
+                            int const * indices,
+                            float const * weights,
+                            float const * duWeights,
+                            float const * dvWeights,
+                            int numStencils,
+                            int startBlock, int endBlock);
+
+//
+// Kernel templates
+//
+// Note : the translation units instantiating these templates are compiled for
+// an instruction set that may not be available at run time -- they must not
+// instantiate any inline function that could be shared with other translation
+// units (this excludes the standard library).
+//
+
+// Fixed primvar length : all the vectors of a primvar are kept in registers
+template <class SIMD, int NUM_ELEMS> void
+SimdStencilKernel(typename SIMD::Real const * src, int srcStride,
+                  typename SIMD::Real * dst,       int dstStride,
+                  int const * sizes,
+                  int const * indices,
+                  float const * weights,
+                  int numStencils) {
+
+    typedef typename SIMD::Vector Vector;
+
+    enum { NUM_VECTORS = (NUM_ELEMS + SIMD::WIDTH - 1) / SIMD::WIDTH,
+           LAST = NUM_VECTORS - 1,
+           TAIL = NUM_ELEMS - LAST * SIMD::WIDTH };
+
+    typename SIMD::Mask const tailMask = SIMD::TailMask(TAIL);
+
+    Vector result[NUM_VECTORS];
+
+    for (int i=0; i<numStencils; ++i, dst+=dstStride) {
+
+        for (int k=0; k<NUM_VECTORS; ++k) {
+            result[k] = SIMD::Zero();
+        }
+
+        for (int j=0; j<sizes[i]; ++j, ++indices, ++weights) {
+
+            typename SIMD::Real const * srcVert = src + (*indices)*srcStride;
+            Vector weight = SIMD::Broadcast(*weights);
+
+            for (int k=0; k<LAST; ++k) {
+                result[k] = SIMD::AddWithWeight(result[k],
+                    SIMD::Load(srcVert + k*SIMD::WIDTH), weight);
+            }
+            result[LAST] = SIMD::AddWithWeight(result[LAST],
+                SIMD::Load(srcVert + LAST*SIMD::WIDTH, tailMask), weight);
+        }
+
+        for (int k=0; k<LAST; ++k) {
+            SIMD::Store(dst + k*SIMD::WIDTH, result[k]);
+        }
+        SIMD::Store(dst + LAST*SIMD::WIDTH, tailMask, result[LAST]);
+    }
+}
+
+// Any primvar length : each vector of a primvar is accumulated in turn
+template <class SIMD> void
+SimdStencilKernel(typename SIMD::Real const * src, int srcStride,
+                  typename SIMD::Real * dst,       int dstStride,
+                  int length,
+                  int const * sizes,
+                  int const * indices,
+                  float const * weights,
+                  int numStencils) {
+
+    typedef typename SIMD::Vector Vector;
+
+    int last = (length - 1) / SIMD::WIDTH;
+
+    typename SIMD::Mask const tailMask = SIMD::TailMask(length - last*SIMD::WIDTH);
+
+    for (int i=0; i<numStencils; ++i, dst+=dstStride) {
+
+        for (int k=0, ofs=0; k<=last; ++k, ofs+=SIMD::WIDTH) {
+
+            Vector result = SIMD::Zero();
+
+            for (int j=0; j<sizes[i]; ++j) {
+
+                typename SIMD::Real const * srcVert = src + indices[j]*srcStride + ofs;
+                Vector weight = SIMD::Broadcast(weights[j]);
+
+                result = SIMD::AddWithWeight(result, (k < last) ?
+                    SIMD::Load(srcVert) : SIMD::Load(srcVert, tailMask), weight);
+            }
+
+            if (k < last) {
+                SIMD::Store(dst + ofs, result);
+            } else {
+                SIMD::Store(dst + ofs, tailMask, result);
+            }
+        }
+        indices += sizes[i];
+        weights += sizes[i];
+    }
+}
+
+// Fixed primvar length, with derivatives
+template <class SIMD, int NUM_ELEMS> void
+SimdStencilKernel(typename SIMD::Real const * src, int srcStride,
+                  typename SIMD::Real * dst,       int dstStride,
+                  typename SIMD::Real * dstDu,     int dstDuStride,
+                  typename SIMD::Real * dstDv,     int dstDvStride,
+                  int const * sizes,
+                  int const * indices,
+                  float const * weights,
+                  float const * duWeights,
+                  float const * dvWeights,
+                  int numStencils) {
+
+    typedef typename SIMD::Vector Vector;
+
+    enum { NUM_VECTORS = (NUM_ELEMS + SIMD::WIDTH - 1) / SIMD::WIDTH,
+           LAST = NUM_VECTORS - 1,
+           TAIL = NUM_ELEMS - LAST * SIMD::WIDTH };
+
+    typename SIMD::Mask const tailMask = SIMD::TailMask(TAIL);
+
+    Vector result[NUM_VECTORS],
+           resultDu[NUM_VECTORS],
+           resultDv[NUM_VECTORS];
+
+    for (int i=0; i<numStencils; ++i,
+        dst+=dstStride, dstDu+=dstDuStride, dstDv+=dstDvStride) {
+
+        for (int k=0; k<NUM_VECTORS; ++k) {
+            result[k] = resultDu[k] = resultDv[k] = SIMD::Zero();
+        }
+
+        for (int j=0; j<sizes[i]; ++j) {
+
+            typename SIMD::Real const * srcVert = src + (*indices++)*srcStride;
+            Vector weight   = SIMD::Broadcast(*weights++),
+                   duWeight = SIMD::Broadcast(*duWeights++),
+                   dvWeight = SIMD::Broadcast(*dvWeights++);
+
+            for (int k=0; k<NUM_VECTORS; ++k) {
+                Vector srcVec = (k < LAST) ?
+                    SIMD::Load(srcVert + k*SIMD::WIDTH) :
+                    SIMD::Load(srcVert + k*SIMD::WIDTH, tailMask);
+
+                result[k]   = SIMD::AddWithWeight(result[k],   srcVec, weight);
+                resultDu[k] = SIMD::AddWithWeight(resultDu[k], srcVec, duWeight);
+                resultDv[k] = SIMD::AddWithWeight(resultDv[k], srcVec, dvWeight);
+            }
+        }
+
+        for (int k=0; k<LAST; ++k) {
+            SIMD::Store(dst   + k*SIMD::WIDTH, result[k]);
+            SIMD::Store(dstDu + k*SIMD::WIDTH, resultDu[k]);
+            SIMD::Store(dstDv + k*SIMD::WIDTH, resultDv[k]);
+        }
+        SIMD::Store(dst   + LAST*SIMD::WIDTH, tailMask, result[LAST]);
+        SIMD::Store(dstDu + LAST*SIMD::WIDTH, tailMask, resultDu[LAST]);
+        SIMD::Store(dstDv + LAST*SIMD::WIDTH, tailMask, resultDv[LAST]);
+    }
+}
+
+// Any primvar length, with derivatives
+template <class SIMD> void
+SimdStencilKernel(typename SIMD::Real const * src, int srcStride,
+                  typename SIMD::Real * dst,       int dstStride,
+                  typename SIMD::Real * dstDu,     int dstDuStride,
+                  typename SIMD::Real * dstDv,     int dstDvStride,
+                  int length,
+                  int const * sizes,
+                  int const * indices,
+                  float const * weights,
+                  float const * duWeights,
+                  float const * dvWeights,
+                  int numStencils) {
+
+    typedef typename SIMD::Vector Vector;
+
+    int last = (length - 1) / SIMD::WIDTH;
+
+    typename SIMD::Mask const tailMask = SIMD::TailMask(length - last*SIMD::WIDTH);
+
+    for (int i=0; i<numStencils; ++i,
+        dst+=dstStride, dstDu+=dstDuStride, dstDv+=dstDvStride) {
+
+        for (int k=0, ofs=0; k<=last; ++k, ofs+=SIMD::WIDTH) {
+
+            Vector result   = SIMD::Zero(),
+                   resultDu = SIMD::Zero(),
+                   resultDv = SIMD::Zero();
+
+            for (int j=0; j<sizes[i]; ++j) {
+
+                typename SIMD::Real const * srcVert = src + indices[j]*srcStride + ofs;
+                Vector srcVec = (k < last) ?
+                    SIMD::Load(srcVert) : SIMD::Load(srcVert, tailMask);
+
+                result   = SIMD::AddWithWeight(result,   srcVec,
+                                               SIMD::Broadcast(weights[j]));
+                resultDu = SIMD::AddWithWeight(resultDu, srcVec,
+                                               SIMD::Broadcast(duWeights[j]));
+                resultDv = SIMD::AddWithWeight(resultDv, srcVec,
+                                               SIMD::Broadcast(dvWeights[j]));
+            }
+
+            if (k < last) {
+                SIMD::Store(dst   + ofs, result);
+                SIMD::Store(dstDu + ofs, resultDu);
+                SIMD::Store(dstDv + ofs, resultDv);
+            } else {
+                SIMD::Store(dst   + ofs, tailMask, result);
+                SIMD::Store(dstDu + ofs, tailMask, resultDu);
+                SIMD::Store(dstDv + ofs, tailMask, resultDv);
+            }
+        }
+        indices += sizes[i];
+        weights += sizes[i];
+        duWeights += sizes[i];
+        dvWeights += sizes[i];
+    }
+}
+
+// Dispatches the common primvar lengths to kernels of fixed length
+template <class SIMD> void
+SimdEvalStencils(typename SIMD::Real const * src, int srcStride,
+                 typename SIMD::Real * dst,       int dstStride,
+                 int length,
+                 int const * sizes,
+                 int const * indices,
+                 float const * weights,
+                 int numStencils) {
+
+#define OSD_SIMD_STENCIL_KERNEL(n) \
+    case n : SimdStencilKernel<SIMD, n>(src, srcStride, dst, dstStride, \
+        sizes, indices, weights, numStencils); break;
+
+    switch (length) {
+        OSD_SIMD_STENCIL_KERNEL(3)
+        OSD_SIMD_STENCIL_KERNEL(4)
+        OSD_SIMD_STENCIL_KERNEL(6)
+        OSD_SIMD_STENCIL_KERNEL(8)
+        OSD_SIMD_STENCIL_KERNEL(12)
+        OSD_SIMD_STENCIL_KERNEL(16)
+        default:
+            SimdStencilKernel<SIMD>(src, srcStride, dst, dstStride,
+                length, sizes, indices, weights, numStencils);
+    }
+#undef OSD_SIMD_STENCIL_KERNEL
+}
+
+template <class SIMD> void
+SimdEvalStencils(typename SIMD::Real const * src, int srcStride,
+                 typename SIMD::Real * dst,       int dstStride,
+                 typename SIMD::Real * dstDu,     int dstDuStride,
+                 typename SIMD::Real * dstDv,     int dstDvStride,
+                 int length,
+                 int const * sizes,
+                 int const * indices,
+                 float const * weights,
+                 float const * duWeights,
+                 float const * dvWeights,
+                 int numStencils) {
+
+#define OSD_SIMD_STENCIL_KERNEL(n) \
+    case n : SimdStencilKernel<SIMD, n>(src, srcStride, dst, dstStride, \
+        dstDu, dstDuStride, dstDv, dstDvStride, \
+        sizes, indices, weights, duWeights, dvWeights, numStencils); break;
+
+    switch (length) {
+        OSD_SIMD_STENCIL_KERNEL(3)
+        OSD_SIMD_STENCIL_KERNEL(4)
+        OSD_SIMD_STENCIL_KERNEL(6)
+        OSD_SIMD_STENCIL_KERNEL(8)
+        OSD_SIMD_STENCIL_KERNEL(12)
+        OSD_SIMD_STENCIL_KERNEL(16)
+        default:
+            SimdStencilKernel<SIMD>(src, srcStride, dst, dstStride,
+                dstDu, dstDuStride, dstDv, dstDvStride,
+                length, sizes, indices, weights, duWeights, dvWeights, numStencils);
+    }
+#undef OSD_SIMD_STENCIL_KERNEL
+}
+
+// Packed stencils : evaluates NUM_ELEMS primvar elements of the (up to) WIDTH
+// stencils of a lane group, over the rows of their block
+template <class SIMD, int NUM_ELEMS> void
+SimdPackedStencilKernel(float const * src, int srcStride,
+                        float * dst,       int dstStride,
+                        int blockWidth, int numRows,
+                        int const * indices,
+                        float const * weights,
+                        int numLanes) {
+
+    typedef typename SIMD::Vector Vector;
+
+    Vector result[NUM_ELEMS];
+
+    for (int k=0; k<NUM_ELEMS; ++k) {
+        result[k] = SIMD::Zero();
+    }
+
+    for (int row=0; row<numRows; ++row,
+        indices+=blockWidth, weights+=blockWidth) {
+
+        typename SIMD::Offsets srcOffsets =
+            SIMD::LoadOffsets(indices, srcStride);
+        Vector weight = SIMD::Load(weights);
+
+        for (int k=0; k<NUM_ELEMS; ++k) {
+            result[k] = SIMD::AddWithWeight(result[k],
+                SIMD::Gather(src + k, srcOffsets), weight);
+        }
+    }
+
+    float lanes[SIMD::WIDTH];
+    for (int k=0; k<NUM_ELEMS; ++k) {
+        SIMD::Store(lanes, result[k]);
+        for (int lane=0; lane<numLanes; ++lane) {
+            dst[lane*dstStride + k] = lanes[lane];
+        }
+    }
+}
+
+// Packed stencils, with derivatives
+template <class SIMD, int NUM_ELEMS> void
+SimdPackedStencilKernel(float const * src, int srcStride,
+                        float * dst,       int dstStride,
+                        float * dstDu,     int dstDuStride,
+                        float * dstDv,     int dstDvStride,
+                        int blockWidth, int numRows,
+                        int const * indices,
+                        float const * weights,
+                        float const * duWeights,
+                        float const * dvWeights,
+                        int numLanes) {
+
+    typedef typename SIMD::Vector Vector;
+
+    Vector result[NUM_ELEMS],
+           resultDu[NUM_ELEMS],
+           resultDv[NUM_ELEMS];
+
+    for (int k=0; k<NUM_ELEMS; ++k) {
+        result[k] = resultDu[k] = resultDv[k] = SIMD::Zero();
+    }
+
+    for (int row=0; row<numRows; ++row, indices+=blockWidth,
+        weights+=blockWidth, duWeights+=blockWidth, dvWeights+=blockWidth) {
+
+        typename SIMD::Offsets srcOffsets =
+            SIMD::LoadOffsets(indices, srcStride);
+        Vector weight   = SIMD::Load(weights),
+               duWeight = SIMD::Load(duWeights),
+               dvWeight = SIMD::Load(dvWeights);
+
+        for (int k=0; k<NUM_ELEMS; ++k) {
+            Vector srcVec = SIMD::Gather(src + k, srcOffsets);
+
+            result[k]   = SIMD::AddWithWeight(result[k],   srcVec, weight);
+            resultDu[k] = SIMD::AddWithWeight(resultDu[k], srcVec, duWeight);
+            resultDv[k] = SIMD::AddWithWeight(resultDv[k], srcVec, dvWeight);
+        }
+    }
+
+    float lanes[SIMD::WIDTH];
+    for (int k=0; k<NUM_ELEMS; ++k) {
+        SIMD::Store(lanes, result[k]);
+        for (int lane=0; lane<numLanes; ++lane) {
+            dst[lane*dstStride + k] = lanes[lane];
+        }
+        SIMD::Store(lanes, resultDu[k]);
+        for (int lane=0; lane<numLanes; ++lane) {
+            dstDu[lane*dstDuStride + k] = lanes[lane];
+        }
+        SIMD::Store(lanes, resultDv[k]);
+        for (int lane=0; lane<numLanes; ++lane) {
+            dstDv[lane*dstDvStride + k] = lanes[lane];
+        }
+    }
+}
+
+// Evaluates each lane group of the blocks, by groups of primvar elements,
+// which share the cache lines of their control vertices
+template <class SIMD> void
+SimdEvalPackedStencils(float const * src, int srcStride,
+                       float * dst,       int dstStride,
+                       int length,
+                       int blockWidth,
+                       int const * blockOffsets,
+                       int const * indices,
+                       float const * weights,
+                       int numStencils,
+                       int startBlock, int endBlock) {
+
+#define OSD_SIMD_PACKED_STENCIL_KERNEL(n) \
+    case n : SimdPackedStencilKernel<SIMD, n>(src + k, srcStride, \
+        dstGroup + k, dstStride, blockWidth, numRows, \
+        indices + ofs, weights + ofs, numLanes); break;
+
+    for (int block=startBlock; block<endBlock; ++block) {
+
+        int numRows = blockOffsets[block+1] - blockOffsets[block];
+
+        for (int group=0; group<blockWidth; group+=SIMD::WIDTH) {
+
+            int firstStencil = block*blockWidth + group;
+            if (firstStencil >= numStencils) break;
+
+            int numLanes = numStencils - firstStencil,
+                ofs = blockOffsets[block]*blockWidth + group;
+            if (numLanes > SIMD::WIDTH) numLanes = SIMD::WIDTH;
+
+            float * dstGroup = dst + firstStencil*dstStride;
+
+            for (int k=0; k<length; k+=4) {
+                switch (length - k) {
+                    OSD_SIMD_PACKED_STENCIL_KERNEL(1)
+                    OSD_SIMD_PACKED_STENCIL_KERNEL(2)
+                    OSD_SIMD_PACKED_STENCIL_KERNEL(3)
+                    default:
+                    OSD_SIMD_PACKED_STENCIL_KERNEL(4)
+                }
+            }
+        }
+    }
+#undef OSD_SIMD_PACKED_STENCIL_KERNEL
+}
+
+template <class SIMD> void
+SimdEvalPackedStencils(float const * src, int srcStride,
+                       float * dst,       int dstStride,
+                       float * dstDu,     int dstDuStride,
+                       float * dstDv,     int dstDvStride,
+                       int length,
+                       int blockWidth,
+                       int const * blockOffsets,
+                       int const * indices,
+                       float const * weights,
+                       float const * duWeights,
+                       float const * dvWeights,
+                       int numStencils,
+                       int startBlock, int endBlock) {
+
+#define OSD_SIMD_PACKED_STENCIL_KERNEL(n) \
+    case n : SimdPackedStencilKernel<SIMD, n>(src + k, srcStride, \
+        dstGroup + k, dstStride, dstDuGroup + k, dstDuStride, \
+        dstDvGroup + k, dstDvStride, blockWidth, numRows, indices + ofs, \
+        weights + ofs, duWeights + ofs, dvWeights + ofs, numLanes); break;
+
+    for (int block=startBlock; block<endBlock; ++block) {
+
+        int numRows = blockOffsets[block+1] - blockOffsets[block];
+
+        for (int group=0; group<blockWidth; group+=SIMD::WIDTH) {
+
+            int firstStencil = block*blockWidth + group;
+            if (firstStencil >= numStencils) break;
+
+            int numLanes = numStencils - firstStencil,
+                ofs = blockOffsets[block]*blockWidth + group;
+            if (numLanes > SIMD::WIDTH) numLanes = SIMD::WIDTH;
+
+            float * dstGroup   = dst   + firstStencil*dstStride,
+                  * dstDuGroup = dstDu + firstStencil*dstDuStride,
+                  * dstDvGroup = dstDv + firstStencil*dstDvStride;
+
+            // fewer elements per group : 3 accumulators per element
+            for (int k=0; k<length; k+=2) {
+                switch (length - k) {
+                    OSD_SIMD_PACKED_STENCIL_KERNEL(1)
+                    default:
+                    OSD_SIMD_PACKED_STENCIL_KERNEL(2)
+                }
+            }
+        }
+    }
+#undef OSD_SIMD_PACKED_STENCIL_KERNEL
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_SIMD_KERNEL_H
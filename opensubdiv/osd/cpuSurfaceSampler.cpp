@@ -0,0 +1,389 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuSurfaceSampler.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static int const maxOrder = 5;
+
+// Gauss-Legendre nodes and weights on [-1, 1] of the orders 1 to 5, in
+// increasing order of the nodes
+static double const gaussNodes[maxOrder][maxOrder] = {
+    { 0.0 },
+    { -0.5773502691896257, 0.5773502691896257 },
+    { -0.7745966692414834, 0.0, 0.7745966692414834 },
+    { -0.8611363115940526, -0.3399810435848563,
+       0.3399810435848563,  0.8611363115940526 },
+    { -0.9061798459386640, -0.5384693101056831, 0.0,
+       0.5384693101056831,  0.9061798459386640 } };
+
+static double const gaussWeights[maxOrder][maxOrder] = {
+    { 2.0 },
+    { 1.0, 1.0 },
+    { 0.5555555555555556, 0.8888888888888888, 0.5555555555555556 },
+    { 0.3478548451374538, 0.6521451548625461,
+      0.6521451548625461, 0.3478548451374538 },
+    { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+      0.4786286704993665, 0.2369268850561891 } };
+
+// Builds the alias table of n weights with Vose's method, 'scaled' and
+// 'work' being scratch arrays of n values. Zero weights are sampled
+// uniformly.
+static void
+buildAliasTable(int n, float const * weights, float * probs, int * aliases,
+                double * scaled, int * work) {
+
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        sum += weights[i];
+    }
+    if (not (sum > 0.0)) {
+        for (int i = 0; i < n; ++i) {
+            probs[i] = 1.0f;
+            aliases[i] = i;
+        }
+        return;
+    }
+
+    // the small columns are stacked from the front of 'work', the large
+    // ones from its back
+    int numSmall = 0,
+        numLarge = 0;
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * n / sum;
+        if (scaled[i] < 1.0) {
+            work[numSmall++] = i;
+        } else {
+            work[n - 1 - numLarge++] = i;
+        }
+    }
+    while (numSmall > 0 and numLarge > 0) {
+        int small = work[--numSmall],
+            large = work[n - numLarge];
+
+        probs[small] = (float)scaled[small];
+        aliases[small] = large;
+
+        scaled[large] = (scaled[large] + scaled[small]) - 1.0;
+        if (scaled[large] < 1.0) {
+            --numLarge;
+            work[numSmall++] = large;
+        }
+    }
+    // the remaining columns are full, up to rounding
+    while (numSmall > 0) {
+        int i = work[--numSmall];
+        probs[i] = 1.0f;
+        aliases[i] = i;
+    }
+    while (numLarge > 0) {
+        int i = work[n - numLarge--];
+        probs[i] = 1.0f;
+        aliases[i] = i;
+    }
+}
+
+// Maps a location of the square [0, 1]^2 to the domain of the base face of
+// a patch, the square being collapsed onto the domain of triangular patches
+static inline void
+getFaceLocation(Far::PatchParam const & param, bool triangular,
+                float a, float b, float & u, float & v) {
+
+    u = a;
+    if (triangular) {
+        v = b * (1.0f - a);
+        param.UnnormalizeTriangle(u, v);
+    } else {
+        v = b;
+        param.Unnormalize(u, v);
+    }
+}
+
+CpuSurfaceSampler *
+CpuSurfaceSampler::Create(Far::PatchTable const * patchTable, int order) {
+
+    if (not patchTable or order < 1 or order > maxOrder) return NULL;
+
+    return new CpuSurfaceSampler(patchTable, order);
+}
+
+CpuSurfaceSampler::CpuSurfaceSampler(Far::PatchTable const * patchTable,
+                                     int order) :
+    _order(order), _area(0.0f) {
+
+    _nodes.resize(order);
+    _weights.resize(order);
+    _bounds.resize(order + 1);
+    _bounds[0] = 0.0f;
+    for (int i = 0; i < order; ++i) {
+        _nodes[i] = (float)(0.5 * (gaussNodes[order-1][i] + 1.0));
+        _weights[i] = (float)(0.5 * gaussWeights[order-1][i]);
+        _bounds[i+1] = _bounds[i] + _weights[i];
+    }
+    _bounds[order] = 1.0f;
+
+    // patches
+    int numArrays = patchTable->GetNumPatchArrays(),
+        numPatches = patchTable->GetNumPatchesTotal();
+
+    _handles.reserve(numPatches);
+    _params.reserve(numPatches);
+    _triangular.resize(numArrays);
+    for (int array = 0; array < numArrays; ++array) {
+        Far::PatchDescriptor desc = patchTable->GetPatchArrayDescriptor(array);
+
+        _triangular[array] =
+            desc.GetType() == Far::PatchDescriptor::LOOP or
+            desc.GetType() == Far::PatchDescriptor::TRIANGLES;
+
+        int numCVs = desc.GetNumControlVertices();
+        for (int j = 0; j < patchTable->GetNumPatches(array); ++j) {
+            Far::PatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = (int)_handles.size();
+            handle.vertIndex = j * numCVs;
+
+            _handles.push_back(handle);
+            _params.push_back(patchTable->GetPatchParam(array, j));
+        }
+    }
+
+    // quadrature points, cell (i + j * order) being at node i along u and
+    // node j along v
+    int numCells = GetNumCellsPerPatch();
+
+    _coords.resize(numPatches * numCells);
+    for (int patch = 0; patch < numPatches; ++patch) {
+        Far::PatchParam const & param = _params[patch];
+        bool triangular = _triangular[_handles[patch].arrayIndex] != 0;
+
+        PatchCoord * coords = &_coords[patch * numCells];
+        for (int j = 0; j < order; ++j) {
+            for (int i = 0; i < order; ++i) {
+                float u, v;
+                getFaceLocation(param, triangular, _nodes[i], _nodes[j], u, v);
+                coords[i + j * order] = PatchCoord(_handles[patch], u, v);
+            }
+        }
+    }
+
+    // patches of the ptex faces
+    int numFaces = patchTable->GetNumPtexFaces();
+
+    _faceOffsets.assign(numFaces + 1, 0);
+    for (int patch = 0; patch < numPatches; ++patch) {
+        ++_faceOffsets[_params[patch].GetFaceId() + 1];
+    }
+    for (int face = 0; face < numFaces; ++face) {
+        _faceOffsets[face + 1] += _faceOffsets[face];
+    }
+    _facePatches.resize(numPatches);
+    {
+        std::vector<int> counts(_faceOffsets.begin(), _faceOffsets.end() - 1);
+        for (int patch = 0; patch < numPatches; ++patch) {
+            _facePatches[counts[_params[patch].GetFaceId()]++] = patch;
+        }
+    }
+    _facePatchSums.assign(numPatches, 0.0f);
+
+    // zero areas, sampled uniformly until refit
+    _cellAreas.assign(numPatches * numCells, 0.0f);
+    _cellProbs.assign(numPatches * numCells, 1.0f);
+    _cellAliases.resize(numPatches * numCells);
+    for (int i = 0; i < (int)_cellAliases.size(); ++i) {
+        _cellAliases[i] = i % numCells;
+    }
+    _patchAreas.assign(numPatches, 0.0f);
+    _patchProbs.resize(numPatches);
+    _patchAliases.resize(numPatches);
+
+    Update();
+}
+
+void
+CpuSurfaceSampler::SetPatchAreas(int numPatches, int const * patchIndices,
+                                 float const * du,
+                                 BufferDescriptor const & duDesc,
+                                 float const * dv,
+                                 BufferDescriptor const & dvDesc) {
+
+    assert(duDesc.length >= 3 and dvDesc.length >= 3);
+
+    int numCells = GetNumCellsPerPatch();
+
+    std::vector<double> scaled(numCells);
+    std::vector<int> work(numCells);
+
+    du += duDesc.offset;
+    dv += dvDesc.offset;
+    for (int i = 0; i < numPatches; ++i) {
+        int patch = patchIndices ? patchIndices[i] : i;
+
+        // the derivatives are along the domain of the base face, of which
+        // the patch covers a fraction along u and v
+        float frac = _params[patch].GetParamFraction();
+        bool triangular = _triangular[_handles[patch].arrayIndex] != 0;
+
+        float * cellAreas = &_cellAreas[patch * numCells];
+        double area = 0.0;
+        for (int c = 0; c < numCells; ++c) {
+            int ci = c % _order,
+                cj = c / _order;
+
+            float nx = du[1] * dv[2] - du[2] * dv[1],
+                  ny = du[2] * dv[0] - du[0] * dv[2],
+                  nz = du[0] * dv[1] - du[1] * dv[0];
+
+            float w = _weights[ci] * _weights[cj] * frac * frac;
+            if (triangular) {
+                // Jacobian of the square collapsed onto the triangle
+                w *= 1.0f - _nodes[ci];
+            }
+            cellAreas[c] = w * std::sqrt(nx * nx + ny * ny + nz * nz);
+            area += cellAreas[c];
+
+            du += duDesc.stride;
+            dv += dvDesc.stride;
+        }
+        _patchAreas[patch] = (float)area;
+
+        buildAliasTable(numCells, cellAreas,
+                        &_cellProbs[patch * numCells],
+                        &_cellAliases[patch * numCells],
+                        &scaled[0], &work[0]);
+    }
+}
+
+void
+CpuSurfaceSampler::Update() {
+
+    int numPatches = GetNumPatches();
+    if (numPatches == 0) {
+        _area = 0.0f;
+        return;
+    }
+
+    std::vector<double> scaled(numPatches);
+    std::vector<int> work(numPatches);
+
+    buildAliasTable(numPatches, &_patchAreas[0],
+                    &_patchProbs[0], &_patchAliases[0],
+                    &scaled[0], &work[0]);
+
+    double area = 0.0;
+    for (int face = 0; face < GetNumFaces(); ++face) {
+        double faceArea = 0.0;
+        for (int i = _faceOffsets[face]; i < _faceOffsets[face + 1]; ++i) {
+            faceArea += _patchAreas[_facePatches[i]];
+            _facePatchSums[i] = (float)faceArea;
+        }
+        area += faceArea;
+    }
+    _area = (float)area;
+}
+
+PatchCoord
+CpuSurfaceSampler::samplePatch(int patch, float xi0, float xi1,
+                               float xi2) const {
+
+    int numCells = GetNumCellsPerPatch();
+
+    // cell of the patch, from its alias table
+    float x = xi0 * (float)numCells;
+    int cell = std::min((int)x, numCells - 1);
+    if (x - (float)cell >= _cellProbs[patch * numCells + cell]) {
+        cell = _cellAliases[patch * numCells + cell];
+    }
+    int ci = cell % _order,
+        cj = cell / _order;
+
+    // uniform location in the cell
+    float a = _bounds[ci] + xi1 * (_bounds[ci + 1] - _bounds[ci]),
+          b = _bounds[cj] + xi2 * (_bounds[cj + 1] - _bounds[cj]);
+
+    float u, v;
+    getFaceLocation(_params[patch],
+                    _triangular[_handles[patch].arrayIndex] != 0,
+                    a, b, u, v);
+    return PatchCoord(_handles[patch], u, v);
+}
+
+PatchCoord
+CpuSurfaceSampler::Sample(float const xi[4]) const {
+
+    int numPatches = GetNumPatches();
+    assert(numPatches > 0);
+
+    // the column of the alias table is drawn from xi[0] and its coin from
+    // xi[1], of which the remainder draws the cell
+    int patch = std::min((int)(xi[0] * (double)numPatches), numPatches - 1);
+
+    float prob = _patchProbs[patch],
+          xiCell;
+    if (xi[1] < prob) {
+        xiCell = xi[1] / prob;
+    } else {
+        xiCell = (xi[1] - prob) / (1.0f - prob);
+        patch = _patchAliases[patch];
+    }
+    return samplePatch(patch, std::min(xiCell, 1.0f), xi[2], xi[3]);
+}
+
+void
+CpuSurfaceSampler::Sample(int numSamples, float const * xi,
+                          PatchCoord * coords) const {
+
+    for (int i = 0; i < numSamples; ++i, xi += 4) {
+        coords[i] = Sample(xi);
+    }
+}
+
+PatchCoord
+CpuSurfaceSampler::SampleFace(int face, float const xi[4]) const {
+
+    int begin = _faceOffsets[face],
+        end = _faceOffsets[face + 1];
+    assert(end > begin);
+
+    // patch of the face, from the prefix sums of its patches
+    float const * sums = &_facePatchSums[0];
+    float x = xi[0] * sums[end - 1];
+
+    int i = (int)(std::upper_bound(sums + begin, sums + end, x) - sums);
+    i = std::min(i, end - 1);
+
+    return samplePatch(_facePatches[i], xi[1], xi[2], xi[3]);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
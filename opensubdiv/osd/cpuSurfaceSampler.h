@@ -0,0 +1,292 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_SURFACE_SAMPLER_H
+#define OPENSUBDIV3_OSD_CPU_SURFACE_SAMPLER_H
+
+#include "../version.h"
+
+#include <algorithm>
+#include <vector>
+#include "../far/patchTable.h"
+#include "../osd/bufferDescriptor.h"
+#include "../osd/cpuEvaluator.h"
+#include "../osd/cpuPatchTable.h"
+#include "../osd/nonCopyable.h"
+#include "../osd/types.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief Area-uniform sampling of the limit surface of a patch table
+///
+/// The area of each patch is integrated by a Gauss-Legendre quadrature of
+/// order N over its domain : the lengths of the cross products of the
+/// derivatives are evaluated at the N x N quadrature points of the patch,
+/// which also split its domain into N x N cells of the sizes of the
+/// quadrature weights. Triangular patches are integrated over the square
+/// collapsed onto their triangle.
+///
+/// An alias table over the areas of the patches, and one over the areas of
+/// the cells of each patch, turn 4 uniform random numbers into a PatchCoord
+/// in constant time : a patch and one of its cells are drawn from their
+/// alias tables, and the location is uniform in the cell. The density of
+/// the samples is thus constant by cell, and converges to the density by
+/// area with the order of the quadrature. Prefix sums of the areas of the
+/// patches of each ptex face sample locations of a given face.
+///
+/// The quadrature points of patch i are the GetNumCellsPerPatch() PatchCoords
+/// from GetQuadratureCoords() + i * GetNumCellsPerPatch() : after a
+/// deformation, the areas of all or of some of the patches are refit from the
+/// derivatives at their quadrature points, evaluated by any Osd evaluator
+/// (read back from the device with the GPU evaluators, see SetPatchAreas()),
+/// or evaluated with a CPU evaluator by Refit().
+///
+class CpuSurfaceSampler : private NonCopyable<CpuSurfaceSampler> {
+public:
+    /// \brief Creates the quadrature and the sampling tables of the patches
+    ///        of a patch table, with zero areas until refit
+    ///
+    /// @param patchTable  Far::PatchTable of the surface
+    ///
+    /// @param order       Order of the Gauss-Legendre quadrature (1 to 5)
+    ///
+    static CpuSurfaceSampler * Create(Far::PatchTable const * patchTable,
+                                      int order = 3);
+
+    /// \brief Returns the number of patches
+    int GetNumPatches() const { return (int)_handles.size(); }
+
+    /// \brief Returns the order of the quadrature
+    int GetOrder() const { return _order; }
+
+    /// \brief Returns the number of quadrature points and cells of a patch
+    int GetNumCellsPerPatch() const { return _order * _order; }
+
+    /// \brief Returns the quadrature points of the patches, indexed by patch
+    ///        then by cell
+    PatchCoord const * GetQuadratureCoords() const {
+        return _coords.empty() ? NULL : &_coords[0];
+    }
+
+    /// \brief Returns the number of quadrature points of all the patches
+    int GetNumQuadratureCoords() const { return (int)_coords.size(); }
+
+    /// \brief Sets the areas of patches from the derivatives of the
+    ///        positions at their quadrature points
+    ///
+    /// The cells of the patches are resampled, but the tables over all the
+    /// patches and faces are only rebuilt by Update().
+    ///
+    /// @param numPatches    Number of patches
+    ///
+    /// @param patchIndices  Indices of the patches, or NULL for the patches
+    ///                      [0, numPatches)
+    ///
+    /// @param du            U-derivatives of the positions (the 3 first
+    ///                      elements) at the GetNumCellsPerPatch() quadrature
+    ///                      points of each of the patches, in the order of
+    ///                      patchIndices. An offset of duDesc is applied.
+    ///
+    /// @param duDesc        vertex buffer descriptor for du
+    ///
+    /// @param dv            V-derivatives of the positions (see du)
+    ///
+    /// @param dvDesc        vertex buffer descriptor for dv
+    ///
+    void SetPatchAreas(int numPatches, int const * patchIndices,
+                       float const * du, BufferDescriptor const & duDesc,
+                       float const * dv, BufferDescriptor const & dvDesc);
+
+    /// \brief Rebuilds the alias table over the patches and the prefix sums
+    ///        of the faces from the areas of the patches
+    void Update();
+
+    /// \brief Evaluates the derivatives at the quadrature points of patches
+    ///        with a CPU evaluator, and refits their areas and the sampling
+    ///        tables
+    ///
+    /// @param src           Input primvar pointer, positions being its 3
+    ///                      first elements. An offset of srcDesc is applied.
+    ///
+    /// @param srcDesc       vertex buffer descriptor for the input buffer
+    ///
+    /// @param patchTable    CpuPatchTable of the Far::PatchTable of the
+    ///                      sampler
+    ///
+    /// @param numPatches    Number of patches to refit
+    ///
+    /// @param patchIndices  Indices of the patches to refit, or NULL for the
+    ///                      patches [0, numPatches)
+    ///
+    /// @param evaluator     CpuEvaluator, OmpEvaluator or TbbEvaluator (only
+    ///                      used for the resolution of the template)
+    ///
+    template <class EVALUATOR>
+    bool Refit(float const * src, BufferDescriptor const & srcDesc,
+               CpuPatchTable const * patchTable,
+               int numPatches, int const * patchIndices,
+               EVALUATOR const * evaluator) {
+
+        (void)evaluator;  // unused
+
+        int numCells = GetNumCellsPerPatch(),
+            numCoords = numPatches * numCells;
+        if (numCoords == 0) {
+            Update();
+            return true;
+        }
+
+        PatchCoord const * coords = &_coords[0];
+        std::vector<PatchCoord> patchCoords;
+        if (patchIndices) {
+            patchCoords.resize(numCoords);
+            for (int i = 0; i < numPatches; ++i) {
+                std::copy(coords + patchIndices[i] * numCells,
+                          coords + (patchIndices[i] + 1) * numCells,
+                          &patchCoords[i * numCells]);
+            }
+            coords = &patchCoords[0];
+        }
+
+        // only the positions are evaluated
+        BufferDescriptor posDesc(srcDesc.offset, 3, srcDesc.stride),
+                         derivDesc(0, 3, 3);
+        std::vector<float> du(numCoords * 3), dv(numCoords * 3);
+
+        if (not EVALUATOR::EvalPatches(src, posDesc,
+                                       NULL, BufferDescriptor(),
+                                       &du[0], derivDesc, &dv[0], derivDesc,
+                                       NULL, BufferDescriptor(),
+                                       NULL, BufferDescriptor(),
+                                       NULL, BufferDescriptor(),
+                                       numCoords, coords,
+                                       patchTable->GetPatchArrayBuffer(),
+                                       patchTable->GetPatchIndexBuffer(),
+                                       patchTable->GetPatchParamBuffer())) {
+            return false;
+        }
+        SetPatchAreas(numPatches, patchIndices,
+                      &du[0], derivDesc, &dv[0], derivDesc);
+        Update();
+        return true;
+    }
+
+    /// \brief Refits the areas of all the patches with the CpuEvaluator
+    bool Refit(float const * src, BufferDescriptor const & srcDesc,
+               CpuPatchTable const * patchTable) {
+        return Refit(src, srcDesc, patchTable, GetNumPatches(), NULL,
+                     (CpuEvaluator const *)NULL);
+    }
+
+    /// \brief Returns the area of the surface
+    float GetArea() const { return _area; }
+
+    /// \brief Returns the area of a patch
+    float GetPatchArea(int patch) const { return _patchAreas[patch]; }
+
+    /// \brief Returns the number of ptex faces
+    int GetNumFaces() const { return (int)_faceOffsets.size() - 1; }
+
+    /// \brief Returns the area of a ptex face
+    float GetFaceArea(int face) const {
+        int end = _faceOffsets[face + 1];
+        return end > _faceOffsets[face] ? _facePatchSums[end - 1] : 0.0f;
+    }
+
+    /// \brief Returns a location uniformly distributed by area over the
+    ///        surface
+    ///
+    /// @param xi  4 uniform random numbers in [0, 1)
+    ///
+    PatchCoord Sample(float const xi[4]) const;
+
+    /// \brief Returns locations uniformly distributed by area over the
+    ///        surface
+    ///
+    /// @param numSamples  Number of samples
+    ///
+    /// @param xi          4 uniform random numbers in [0, 1) per sample
+    ///
+    /// @param coords      Output array of numSamples PatchCoords
+    ///
+    void Sample(int numSamples, float const * xi, PatchCoord * coords) const;
+
+    /// \brief Returns a location uniformly distributed by area over a ptex
+    ///        face (the face must have patches)
+    ///
+    /// @param face  Index of the ptex face
+    ///
+    /// @param xi    4 uniform random numbers in [0, 1)
+    ///
+    PatchCoord SampleFace(int face, float const xi[4]) const;
+
+protected:
+    CpuSurfaceSampler(Far::PatchTable const * patchTable, int order);
+
+private:
+    PatchCoord samplePatch(int patch, float xi0, float xi1,
+                           float xi2) const;
+
+    int _order;
+
+    // Gauss-Legendre nodes and weights on [0, 1], and the bounds of the
+    // cells of the nodes
+    std::vector<float> _nodes,
+                       _weights,
+                       _bounds;
+
+    // patches
+    std::vector<Far::PatchTable::PatchHandle> _handles;
+    std::vector<Far::PatchParam>              _params;
+    std::vector<unsigned char>                _triangular;  // per array
+    std::vector<PatchCoord>                   _coords;
+
+    // areas and alias tables of the cells of the patches
+    std::vector<float> _cellAreas,
+                       _cellProbs;
+    std::vector<int>   _cellAliases;
+
+    // areas and alias table of the patches
+    float              _area;
+    std::vector<float> _patchAreas,
+                       _patchProbs;
+    std::vector<int>   _patchAliases;
+
+    // patches of the ptex faces and the prefix sums of their areas
+    std::vector<int>   _faceOffsets,
+                       _facePatches;
+    std::vector<float> _facePatchSums;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_SURFACE_SAMPLER_H
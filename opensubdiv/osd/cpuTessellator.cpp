@@ -0,0 +1,612 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cpuTessellator.h"
+#include "../far/error.h"
+#include "../far/patchTable.h"
+#include "../far/taskScheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+//
+//  Tessellation pattern of a patch of given edge rates : the points of the
+//  interior grid come first, then the points of each edge from its first
+//  corner (the last corner of an edge is the first of the next edge). Each
+//  edge is stitched to the side of the interior grid facing it.
+//
+struct TessellationPattern {
+
+    TessellationPattern(bool triangle, int const rates[8]) :
+        _triangle(triangle), _numEdges(triangle ? 3 : 4), _innerRate(1) {
+
+        for (int i = 0; i < _numEdges; ++i) {
+            _splitRates[i] = std::max(0, rates[2*i+1]);
+            _rates[i] = std::max(1, rates[2*i]) + _splitRates[i];
+            _innerRate = std::max(_innerRate, _rates[i]);
+        }
+    }
+
+    int GetNumPoints() const {
+        int numPoints = getNumInnerPoints();
+        for (int i = 0; i < _numEdges; ++i) {
+            numPoints += _rates[i];
+        }
+        return numPoints;
+    }
+
+    int GetNumTriangles() const {
+        int n = _innerRate;
+        if (n == 1) {
+            return _triangle ? 1 : 2;
+        }
+        int numTriangles = _triangle ? (n>2 ? (n-3)*(n-3) : 0) : 2*(n-2)*(n-2);
+        for (int i = 0; i < _numEdges; ++i) {
+            numTriangles += _rates[i] + getNumInnerSegments();
+        }
+        return numTriangles;
+    }
+
+    //  Fills the (u,v) locations of the points and the triangles (offset by
+    //  'base')
+    void Generate(float * uvs, int * triangles, int base) const;
+
+private:
+
+    int getNumInnerPoints() const {
+        int n = _innerRate;
+        if (n == 1) return 0;
+        return _triangle ? std::max(1, (n-2)*(n-1)/2) : (n-1)*(n-1);
+    }
+
+    int getNumInnerSegments() const {
+        return std::max(0, _innerRate - (_triangle ? 3 : 2));
+    }
+
+    int innerIndex(int i, int j) const;
+
+    int innerSideIndex(int side, int k) const;
+
+    int outerIndex(int edge, int k) const {
+        if (k == _rates[edge]) {
+            edge = (edge + 1) % _numEdges;
+            k = 0;
+        }
+        int index = getNumInnerPoints();
+        for (int i = 0; i < edge; ++i) {
+            index += _rates[i];
+        }
+        return index + k;
+    }
+
+    //  Location of the k-th point of an edge along the edge, the two halves
+    //  of split edges having their own rates
+    float edgeFraction(int edge, int k) const {
+        int m = _rates[edge], hi = _splitRates[edge];
+        if (hi == 0) {
+            return (float)k / (float)m;
+        }
+        int lo = m - hi;
+        return (k <= lo) ? 0.5f * (float)k / (float)lo :
+                           0.5f + 0.5f * (float)(k - lo) / (float)hi;
+    }
+
+    void corner(int c, float & u, float & v) const {
+        static float const quadCorners[4][2] = { {0,0}, {1,0}, {1,1}, {0,1} },
+                           triCorners[3][2] = { {0,0}, {1,0}, {0,1} };
+        u = _triangle ? triCorners[c][0] : quadCorners[c][0];
+        v = _triangle ? triCorners[c][1] : quadCorners[c][1];
+    }
+
+    bool _triangle;
+    int _numEdges,
+        _rates[4],
+        _splitRates[4],
+        _innerRate;
+};
+
+//  Index of the interior point (i,j) : quads have points 1 <= i,j <= n-1,
+//  triangles points i,j >= 1, i+j <= n-1 (or a single center point if n==2)
+int
+TessellationPattern::innerIndex(int i, int j) const {
+    int n = _innerRate;
+    if (_triangle) {
+        // rows j of (n-1-j) points
+        int index = 0;
+        for (int row = 1; row < j; ++row) {
+            index += n - 1 - row;
+        }
+        return index + i - 1;
+    }
+    return (j-1) * (n-1) + (i-1);
+}
+
+//  Index of the k-th interior point of the side facing an edge, from the
+//  corner of the edge
+int
+TessellationPattern::innerSideIndex(int side, int k) const {
+    int n = _innerRate;
+    if (_triangle) {
+        if (n == 2) return 0;
+        switch (side) {
+            case 0  : return innerIndex(1 + k, 1);
+            case 1  : return innerIndex(n - 2 - k, 1 + k);
+            default : return innerIndex(1, n - 2 - k);
+        }
+    }
+    switch (side) {
+        case 0  : return innerIndex(1 + k, 1);
+        case 1  : return innerIndex(n - 1, 1 + k);
+        case 2  : return innerIndex(n - 1 - k, n - 1);
+        default : return innerIndex(1, n - 1 - k);
+    }
+}
+
+void
+TessellationPattern::Generate(float * uvs, int * triangles, int base) const {
+
+    int n = _innerRate;
+    float dn = 1.0f / (float)n;
+
+    //  Interior points and triangles:
+    if (_triangle) {
+        if (n == 2) {
+            uvs[0] = uvs[1] = 1.0f / 3.0f;
+        }
+        for (int j = 1; j <= n-2; ++j) {
+            for (int i = 1; i+j <= n-1; ++i) {
+                float * uv = uvs + 2 * innerIndex(i, j);
+                uv[0] = (float)i * dn;
+                uv[1] = (float)j * dn;
+
+                if (i+j <= n-2) {
+                    *triangles++ = base + innerIndex(i, j);
+                    *triangles++ = base + innerIndex(i+1, j);
+                    *triangles++ = base + innerIndex(i, j+1);
+                }
+                if (i+j <= n-3) {
+                    *triangles++ = base + innerIndex(i+1, j);
+                    *triangles++ = base + innerIndex(i+1, j+1);
+                    *triangles++ = base + innerIndex(i, j+1);
+                }
+            }
+        }
+    } else {
+        for (int j = 1; j <= n-1; ++j) {
+            for (int i = 1; i <= n-1; ++i) {
+                float * uv = uvs + 2 * innerIndex(i, j);
+                uv[0] = (float)i * dn;
+                uv[1] = (float)j * dn;
+
+                if (i <= n-2 and j <= n-2) {
+                    *triangles++ = base + innerIndex(i, j);
+                    *triangles++ = base + innerIndex(i+1, j);
+                    *triangles++ = base + innerIndex(i+1, j+1);
+                    *triangles++ = base + innerIndex(i, j);
+                    *triangles++ = base + innerIndex(i+1, j+1);
+                    *triangles++ = base + innerIndex(i, j+1);
+                }
+            }
+        }
+    }
+
+    //  Edge points:
+    for (int edge = 0; edge < _numEdges; ++edge) {
+        float u0, v0, u1, v1;
+        corner(edge, u0, v0);
+        corner((edge + 1) % _numEdges, u1, v1);
+
+        for (int k = 0; k < _rates[edge]; ++k) {
+            float t = edgeFraction(edge, k);
+            float * uv = uvs + 2 * outerIndex(edge, k);
+            uv[0] = u0 + t * (u1 - u0);
+            uv[1] = v0 + t * (v1 - v0);
+        }
+    }
+
+    if (n == 1) {
+        *triangles++ = base + outerIndex(0, 0);
+        *triangles++ = base + outerIndex(1, 0);
+        *triangles++ = base + outerIndex(2, 0);
+        if (not _triangle) {
+            *triangles++ = base + outerIndex(0, 0);
+            *triangles++ = base + outerIndex(2, 0);
+            *triangles++ = base + outerIndex(3, 0);
+        }
+        return;
+    }
+
+    //  Stitch each edge to the facing side of the interior, advancing along
+    //  the side whose next point is closest to the corner of the edge : the
+    //  k-th point of the inner side lies at (1+k)/n along the edge.
+    int numSegments = getNumInnerSegments();
+    for (int edge = 0; edge < _numEdges; ++edge) {
+        int m = _rates[edge];
+        for (int i = 0, k = 0; (i < m) or (k < numSegments); ) {
+            bool outer = (k == numSegments) or ((i < m) and
+                (edgeFraction(edge, i + 1) <= (float)(k + 2) * dn));
+            if (outer) {
+                *triangles++ = base + outerIndex(edge, i);
+                *triangles++ = base + outerIndex(edge, i + 1);
+                *triangles++ = base + innerSideIndex(edge, k);
+                ++i;
+            } else {
+                *triangles++ = base + outerIndex(edge, i);
+                *triangles++ = base + innerSideIndex(edge, k + 1);
+                *triangles++ = base + innerSideIndex(edge, k);
+                ++k;
+            }
+        }
+    }
+}
+
+//  Locations of the patch (u,v) domain in the parameterization of the face
+//  of the patch
+inline void
+unnormalize(Far::PatchParam const & param, bool triangle, float & u, float & v) {
+
+    if (triangle) {
+        param.UnnormalizeTriangle(u, v);
+    } else {
+        param.Unnormalize(u, v);
+    }
+}
+
+struct TessellationContext {
+    Far::PatchTable const * patchTable;
+    int const * edgeRates;
+    std::vector<Far::PatchTable::PatchHandle> const * handles;
+    std::vector<int> const * pointOffsets;
+    std::vector<int> const * triangleOffsets;
+    PatchCoord * patchCoords;
+    int * triangles;
+};
+
+inline bool
+isTriangular(Far::PatchDescriptor::Type type) {
+    return (type == Far::PatchDescriptor::LOOP) or
+           (type == Far::PatchDescriptor::TRIANGLES);
+}
+
+void
+tessellatePatchRange(int begin, int end, void * data) {
+
+    TessellationContext const & context =
+        *static_cast<TessellationContext const *>(data);
+
+    std::vector<float> uvs;
+    for (int patch = begin; patch < end; ++patch) {
+
+        Far::PatchTable::PatchHandle const & handle = (*context.handles)[patch];
+
+        bool triangle = isTriangular(context.patchTable->GetPatchArrayDescriptor(
+            handle.arrayIndex).GetType());
+
+        TessellationPattern pattern(triangle, context.edgeRates + 8 * patch);
+
+        int pointOffset = (*context.pointOffsets)[patch],
+            numPoints = pattern.GetNumPoints();
+
+        uvs.resize(2 * numPoints);
+        pattern.Generate(&uvs[0],
+            context.triangles + 3 * (*context.triangleOffsets)[patch],
+            pointOffset);
+
+        Far::PatchParam param = context.patchTable->GetPatchParam(handle);
+        for (int i = 0; i < numPoints; ++i) {
+            float u = uvs[2*i], v = uvs[2*i+1];
+            unnormalize(param, triangle, u, v);
+            context.patchCoords[pointOffset + i] = PatchCoord(handle, u, v);
+        }
+    }
+}
+
+//  Handles of the patches of a table, in the order of the table
+void
+getPatchHandles(Far::PatchTable const & patchTable,
+                std::vector<Far::PatchTable::PatchHandle> & handles) {
+
+    handles.resize(patchTable.GetNumPatchesTotal());
+    for (int array = 0, patch = 0; array < patchTable.GetNumPatchArrays(); ++array) {
+
+        int ncvs = patchTable.GetPatchArrayDescriptor(array).GetNumControlVertices();
+        for (int i = 0; i < patchTable.GetNumPatches(array); ++i, ++patch) {
+            handles[patch].arrayIndex = array;
+            handles[patch].patchIndex = patch;
+            handles[patch].vertIndex = i * ncvs;
+        }
+    }
+}
+
+//  Product of a column-major matrix and a point (w = 1)
+inline void
+transformPoint(float const m[16], float const p[3], float q[4]) {
+
+    for (int i = 0; i < 4; ++i) {
+        q[i] = m[i] * p[0] + m[4+i] * p[1] + m[8+i] * p[2] + m[12+i];
+    }
+}
+
+struct ScreenSpaceContext {
+    Far::PatchTable const * patchTable;
+    std::vector<Far::PatchTable::PatchHandle> const * handles;
+    float const * src;
+    BufferDescriptor srcDesc;
+    float const * modelViewMatrix;
+    float const * projectionMatrix;
+    float tessLevel;
+    int maxSegmentRate;
+    int * edgeRates;
+};
+
+//  Limit position at (u,v) in the domain of a patch
+void
+evaluateLimitPoint(ScreenSpaceContext const & context,
+                   Far::PatchTable::PatchHandle const & handle,
+                   Far::PatchParam const & param, bool triangle,
+                   float u, float v, float point[3]) {
+
+    unnormalize(param, triangle, u, v);
+
+    float weights[20];
+    context.patchTable->EvaluateBasis(handle, u, v, weights, 0, 0);
+
+    Far::ConstIndexArray cvs = context.patchTable->GetPatchVertices(handle);
+    assert(cvs.size() <= 20);
+
+    point[0] = point[1] = point[2] = 0.0f;
+    for (int i = 0; i < cvs.size(); ++i) {
+        float const * cv = context.src + context.srcDesc.offset +
+                           cvs[i] * context.srcDesc.stride;
+        point[0] += weights[i] * cv[0];
+        point[1] += weights[i] * cv[1];
+        point[2] += weights[i] * cv[2];
+    }
+}
+
+inline int
+computeSegmentRate(ScreenSpaceContext const & context,
+                   float const p0[3], float const p1[3]) {
+
+    float level = CpuTessellator::ComputeTessLevel(p0, p1,
+        context.modelViewMatrix, context.projectionMatrix, context.tessLevel);
+    return (int)std::ceil(std::min(level, (float)context.maxSegmentRate));
+}
+
+void
+computeScreenSpaceRateRange(int begin, int end, void * data) {
+
+    ScreenSpaceContext const & context =
+        *static_cast<ScreenSpaceContext const *>(data);
+
+    static float const quadCorners[4][2] = { {0,0}, {1,0}, {1,1}, {0,1} },
+                       triCorners[3][2] = { {0,0}, {1,0}, {0,1} };
+
+    for (int patch = begin; patch < end; ++patch) {
+
+        Far::PatchTable::PatchHandle const & handle = (*context.handles)[patch];
+
+        bool triangle = isTriangular(context.patchTable->GetPatchArrayDescriptor(
+            handle.arrayIndex).GetType());
+
+        int numEdges = triangle ? 3 : 4;
+        float const (*corners)[2] = triangle ? triCorners : quadCorners;
+
+        Far::PatchParam param = context.patchTable->GetPatchParam(handle);
+
+        float points[4][3];
+        for (int i = 0; i < numEdges; ++i) {
+            evaluateLimitPoint(context, handle, param, triangle,
+                corners[i][0], corners[i][1], points[i]);
+        }
+
+        int * rates = context.edgeRates + 8 * patch;
+        for (int edge = 0; edge < 4; ++edge) {
+            if (edge == numEdges) {
+                rates[2*edge] = 1;
+                rates[2*edge+1] = 0;
+                continue;
+            }
+            int next = (edge + 1) % numEdges;
+            if ((param.GetTransition() >> edge) & 1) {
+                float mid[3];
+                evaluateLimitPoint(context, handle, param, triangle,
+                    0.5f * (corners[edge][0] + corners[next][0]),
+                    0.5f * (corners[edge][1] + corners[next][1]), mid);
+                rates[2*edge] = computeSegmentRate(context, points[edge], mid);
+                rates[2*edge+1] = computeSegmentRate(context, mid, points[next]);
+            } else {
+                rates[2*edge] = computeSegmentRate(context, points[edge], points[next]);
+                rates[2*edge+1] = 0;
+            }
+        }
+    }
+}
+
+}  // end namespace
+
+float
+CpuTessellator::ComputeTessLevel(float const p0[3], float const p1[3],
+                                 float const modelViewMatrix[16],
+                                 float const projectionMatrix[16],
+                                 float tessLevel) {
+
+    float q0[4], q1[4];
+    transformPoint(modelViewMatrix, p0, q0);
+    transformPoint(modelViewMatrix, p1, q1);
+
+    float center[3], diameter = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        center[i] = (q0[i] + q1[i]) * 0.5f;
+        diameter += (q0[i] - q1[i]) * (q0[i] - q1[i]);
+    }
+    diameter = std::sqrt(diameter);
+
+    float p[4];
+    transformPoint(projectionMatrix, center, p);
+    float projLength = std::fabs(diameter * projectionMatrix[5] / p[3]);
+
+    return std::max(1.0f, tessLevel * projLength);
+}
+
+bool
+CpuTessellator::ComputeScreenSpaceEdgeRates(Far::PatchTable const & patchTable,
+                                            float const * src,
+                                            BufferDescriptor const & srcDesc,
+                                            float const modelViewMatrix[16],
+                                            float const projectionMatrix[16],
+                                            float tessLevel, int maxRate,
+                                            std::vector<int> & edgeRates,
+                                            Far::TaskScheduler const * scheduler) {
+
+    if (srcDesc.length < 3) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in CpuTessellator::ComputeScreenSpaceEdgeRates() -- "
+            "positions of less than 3 elements.");
+        return false;
+    }
+
+    int numPatches = patchTable.GetNumPatchesTotal();
+    edgeRates.resize(8 * numPatches);
+    if (numPatches == 0) {
+        return true;
+    }
+
+    std::vector<Far::PatchTable::PatchHandle> handles;
+    getPatchHandles(patchTable, handles);
+
+    ScreenSpaceContext context;
+    context.patchTable = &patchTable;
+    context.handles = &handles;
+    context.src = src;
+    context.srcDesc = srcDesc;
+    context.modelViewMatrix = modelViewMatrix;
+    context.projectionMatrix = projectionMatrix;
+    context.tessLevel = tessLevel;
+    context.maxSegmentRate = std::max(1, maxRate / 2);
+    context.edgeRates = &edgeRates[0];
+
+    if (scheduler) {
+        scheduler->ParallelFor(0, numPatches, 64, computeScreenSpaceRateRange, &context);
+    } else {
+        computeScreenSpaceRateRange(0, numPatches, &context);
+    }
+    return true;
+}
+
+void
+CpuTessellator::ComputeUniformEdgeRates(Far::PatchTable const & patchTable,
+                                        int tessLevel,
+                                        std::vector<int> & edgeRates) {
+
+    edgeRates.resize(8 * patchTable.GetNumPatchesTotal());
+
+    Far::PatchParamTable const & params = patchTable.GetPatchParamTable();
+    for (int patch = 0; patch < (int)params.size(); ++patch) {
+        Far::PatchParam const & param = params[patch];
+
+        // the depth of the patches of non-quad faces is their level too
+        int level = param.GetDepth(),
+            rate = std::max(1, tessLevel >> level);
+
+        for (int edge = 0; edge < 4; ++edge) {
+            int * rates = &edgeRates[8 * patch + 2 * edge];
+            if ((param.GetTransition() >> edge) & 1) {
+                rates[0] = rates[1] = std::max(1, tessLevel >> (level + 1));
+            } else {
+                rates[0] = rate;
+                rates[1] = 0;
+            }
+        }
+    }
+}
+
+bool
+CpuTessellator::Tessellate(Far::PatchTable const & patchTable,
+                           int const * edgeRates,
+                           std::vector<PatchCoord> & patchCoords,
+                           std::vector<int> & triangles,
+                           Far::TaskScheduler const * scheduler) {
+
+    int numPatches = patchTable.GetNumPatchesTotal();
+    if (numPatches and (edgeRates == NULL)) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in CpuTessellator::Tessellate() -- no edge rates.");
+        return false;
+    }
+
+    //  The points and triangles of each patch follow those of the previous
+    //  patches:
+    std::vector<Far::PatchTable::PatchHandle> handles;
+    getPatchHandles(patchTable, handles);
+
+    std::vector<int> pointOffsets(numPatches + 1, 0),
+                     triangleOffsets(numPatches + 1, 0);
+
+    for (int patch = 0; patch < numPatches; ++patch) {
+
+        bool triangle = isTriangular(patchTable.GetPatchArrayDescriptor(
+            handles[patch].arrayIndex).GetType());
+
+        TessellationPattern pattern(triangle, edgeRates + 8 * patch);
+        pointOffsets[patch + 1] = pointOffsets[patch] + pattern.GetNumPoints();
+        triangleOffsets[patch + 1] = triangleOffsets[patch] + pattern.GetNumTriangles();
+    }
+
+    patchCoords.resize(pointOffsets[numPatches]);
+    triangles.resize(3 * triangleOffsets[numPatches]);
+    if (numPatches == 0) {
+        return true;
+    }
+
+    TessellationContext context;
+    context.patchTable = &patchTable;
+    context.edgeRates = edgeRates;
+    context.handles = &handles;
+    context.pointOffsets = &pointOffsets;
+    context.triangleOffsets = &triangleOffsets;
+    context.patchCoords = &patchCoords[0];
+    context.triangles = &triangles[0];
+
+    if (scheduler) {
+        scheduler->ParallelFor(0, numPatches, 64, tessellatePatchRange, &context);
+    } else {
+        tessellatePatchRange(0, numPatches, &context);
+    }
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,187 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_CPU_TESSELLATOR_H
+#define OPENSUBDIV3_OSD_CPU_TESSELLATOR_H
+
+#include "../version.h"
+
+#include "../osd/bufferDescriptor.h"
+#include "../osd/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class PatchTable;
+    class TaskScheduler;
+}
+
+namespace Osd {
+
+/// \brief Tessellation of the patches of a PatchTable on the CPU
+///
+/// Each patch is tessellated into triangles from the rates of its edges : the
+/// number of segments along the edges (0,0)-(1,0), (1,0)-(1,1), (1,1)-(0,1)
+/// and (0,1)-(0,0) of its (u,v) domain -- or (0,0)-(1,0), (1,0)-(0,1) and
+/// (0,1)-(0,0) for triangular patches, the 4th edge being ignored. The
+/// interior of the patch is tessellated at the highest rate of its edges.
+///
+/// Each edge has 2 rates, as the outer levels "Lo" and "Hi" of the patch
+/// shaders : an edge whose second rate is 0 is divided uniformly, otherwise
+/// each half of the edge is divided at its own rate.
+///
+/// The tessellation is free of cracks as long as each edge has the rates of
+/// the edge of the adjacent patch : the halves of a transition edge (see
+/// Far::PatchParam::GetTransition()) must have the rates of the edges of the
+/// finer patches along it, as ComputeUniformEdgeRates() and
+/// ComputeScreenSpaceEdgeRates() do.
+///
+/// The tessellated vertices are returned as PatchCoords, to be evaluated by
+/// the EvalPatches() methods of the evaluators.
+///
+class CpuTessellator {
+public:
+    /// \brief Computes uniform edge rates, halved at each level of isolation
+    ///
+    /// The edges of the patches of a base face have 'tessLevel' segments, and
+    /// those of the patches isolated at level L have (tessLevel >> L) (at
+    /// least 1) : the halves of transition edges get the rate of the next
+    /// level.
+    ///
+    /// @param patchTable  PatchTable of the patches
+    ///
+    /// @param tessLevel   Rate of the edges of the base faces
+    ///
+    /// @param edgeRates   Returned 2 rates of the 4 edges of each patch
+    ///
+    static void ComputeUniformEdgeRates(Far::PatchTable const & patchTable,
+                                        int tessLevel,
+                                        std::vector<int> & edgeRates);
+
+    /// \brief Computes the tessellation level of an edge from its screen space
+    /// extent (as OsdComputeTessLevel() of the GLSL and HLSL patch shaders)
+    ///
+    /// The level is 'tessLevel' times the diameter of the bounding sphere of
+    /// the edge, projected at the distance of its center (at least 1). The
+    /// projection of the sphere rather than of the edge itself avoids small
+    /// levels near silhouettes.
+    ///
+    /// @param p0               First end point of the edge
+    ///
+    /// @param p1               Second end point of the edge
+    ///
+    /// @param modelViewMatrix  Column-major model-view matrix
+    ///
+    /// @param projectionMatrix Column-major projection matrix
+    ///
+    /// @param tessLevel        Level of an edge of unit projected extent
+    ///
+    static float ComputeTessLevel(float const p0[3], float const p1[3],
+                                  float const modelViewMatrix[16],
+                                  float const projectionMatrix[16],
+                                  float tessLevel);
+
+    /// \brief Computes edge rates from the screen space extent of the edges
+    ///
+    /// The rate of an edge is ComputeTessLevel() of the limit points at its
+    /// corners, rounded up, and the halves of transition edges get their own
+    /// rates from the limit point at their middle. The rates depending only
+    /// on the limit points at the ends of the edges and halves, adjacent
+    /// patches get the same rates for the edges they share.
+    ///
+    /// As in the patch shaders, the rates of edges and halves of transition
+    /// edges are clamped to maxRate / 2, for transition edges not to exceed
+    /// 'maxRate'.
+    ///
+    /// @param patchTable       PatchTable of the patches
+    ///
+    /// @param src              Control vertices of the patches (including the
+    ///                         local points of the end caps)
+    ///
+    /// @param srcDesc          Position of the vertices in 'src' (at least 3
+    ///                         elements)
+    ///
+    /// @param modelViewMatrix  Column-major model-view matrix
+    ///
+    /// @param projectionMatrix Column-major projection matrix
+    ///
+    /// @param tessLevel        Level of an edge of unit projected extent
+    ///
+    /// @param maxRate          Largest rate of an edge
+    ///
+    /// @param edgeRates        Returned 2 rates of the 4 edges of each patch
+    ///
+    /// @param scheduler        Scheduler computing the rates of the patches
+    ///                         concurrently (serially if null)
+    ///
+    /// @return                 False if 'srcDesc' has less than 3 elements
+    ///
+    static bool ComputeScreenSpaceEdgeRates(Far::PatchTable const & patchTable,
+                                            float const * src,
+                                            BufferDescriptor const & srcDesc,
+                                            float const modelViewMatrix[16],
+                                            float const projectionMatrix[16],
+                                            float tessLevel, int maxRate,
+                                            std::vector<int> & edgeRates,
+                                            Far::TaskScheduler const * scheduler = NULL);
+
+    /// \brief Tessellates all the patches of a PatchTable
+    ///
+    /// The patches are tessellated concurrently by 'scheduler' (serially if
+    /// null) : the coordinates and the triangles of each patch follow those
+    /// of the previous patch, in the order of the table.
+    ///
+    /// @param patchTable  PatchTable of the patches
+    ///
+    /// @param edgeRates   2 rates of the 4 edges of each patch (the first at
+    ///                    least 1)
+    ///
+    /// @param patchCoords Returned locations of the tessellated vertices
+    ///
+    /// @param triangles   Returned triangles (3 indices of patchCoords per
+    ///                    triangle, counter-clockwise in (u,v))
+    ///
+    /// @param scheduler   Scheduler of the concurrent tessellation
+    ///
+    /// @return            False if the rates are missing
+    ///
+    static bool Tessellate(Far::PatchTable const & patchTable,
+                           int const * edgeRates,
+                           std::vector<PatchCoord> & patchCoords,
+                           std::vector<int> & triangles,
+                           Far::TaskScheduler const * scheduler = NULL);
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_TESSELLATOR_H
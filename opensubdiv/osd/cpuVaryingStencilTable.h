@@ -0,0 +1,96 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_VARYING_STENCIL_TABLE_H
+#define OPENSUBDIV3_OSD_CPU_VARYING_STENCIL_TABLE_H
+
+#include "../version.h"
+
+#include <cstddef>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class TopologyRefiner;
+}
+
+namespace Osd {
+
+/// \brief Implicit varying stencil table, for the CPU evaluators
+///
+/// Varying primvars are interpolated linearly : a refined vertex is the
+/// average of the vertices of its parent face, the midpoint of its parent
+/// edge, or a copy of its parent vertex. Rather than storing these weights
+/// in a Far::StencilTable created with INTERPOLATE_VARYING, this table
+/// derives them on the fly from the refinement topology when evaluated by
+/// CpuEvaluator, one level after the other (see
+/// Far::PrimvarRefiner::InterpolateVarying()).
+///
+/// The table evaluates the same refined vertices as the varying stencil
+/// table created with the same generateIntermediateLevels option (and
+/// without control vertices), and holds no data : the refiner must outlive
+/// it. Intermediate levels are refined into a temporary buffer when they
+/// are not generated.
+///
+/// \note Trimmed refinements are not supported (see
+///       Far::TopologyRefiner::IsTrimmed()), nor are ranges of stencils
+///       (the table is evaluated as a whole) or the varying stencils of
+///       local points (see Far::PatchTable::GetLocalPointVaryingStencilTable()).
+///
+class CpuVaryingStencilTable {
+public:
+    static CpuVaryingStencilTable *Create(Far::TopologyRefiner const *refiner,
+                                          void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new CpuVaryingStencilTable(refiner);
+    }
+
+    explicit CpuVaryingStencilTable(Far::TopologyRefiner const *refiner,
+                                    bool generateIntermediateLevels = true);
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return _numStencils; }
+
+    /// \brief Returns the refiner the stencils are derived from
+    Far::TopologyRefiner const * GetTopologyRefiner() const { return _refiner; }
+
+    /// \brief Returns true if the vertices of all refined levels are
+    ///        evaluated (the last level only otherwise)
+    bool HasIntermediateLevels() const { return _intermediateLevels; }
+
+private:
+    Far::TopologyRefiner const * _refiner;
+    bool _intermediateLevels;
+    int _numStencils;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_VARYING_STENCIL_TABLE_H
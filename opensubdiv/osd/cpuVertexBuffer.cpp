@@ -23,6 +23,7 @@
 //
 
 #include "../osd/cpuVertexBuffer.h"
+#include "../far/profile.h"
 
 #include <string.h>
 
@@ -34,14 +35,25 @@ namespace Osd {
 CpuVertexBuffer::CpuVertexBuffer(int numElements, int numVertices)
     : _numElements(numElements),
       _numVertices(numVertices),
-      _cpuBuffer(NULL) {
+      _cpuBuffer(NULL),
+      _ownsBuffer(true) {
 
     _cpuBuffer = new float[numElements * numVertices];
 }
 
+CpuVertexBuffer::CpuVertexBuffer(int numElements, int numVertices,
+                                 float *buffer)
+    : _numElements(numElements),
+      _numVertices(numVertices),
+      _cpuBuffer(buffer),
+      _ownsBuffer(false) {
+}
+
 CpuVertexBuffer::~CpuVertexBuffer() {
 
-    delete[] _cpuBuffer;
+    if (_ownsBuffer) {
+        delete[] _cpuBuffer;
+    }
 }
 
 CpuVertexBuffer *
@@ -51,12 +63,31 @@ CpuVertexBuffer::Create(int numElements, int numVertices,
     return new CpuVertexBuffer(numElements, numVertices);
 }
 
+CpuVertexBuffer *
+CpuVertexBuffer::Wrap(float *buffer, int numElements, int numVertices) {
+
+    if (!buffer) return NULL;
+    return new CpuVertexBuffer(numElements, numVertices, buffer);
+}
+
+bool
+CpuVertexBuffer::SetCpuBuffer(float *buffer) {
+
+    if (_ownsBuffer || !buffer) return false;
+    _cpuBuffer = buffer;
+    return true;
+}
+
 void
 CpuVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
                             void * /*deviceContext*/) {
 
-    memcpy(_cpuBuffer + startVertex * _numElements,
-           src, GetNumElements() * numVertices * sizeof(float));
+    OPENSUBDIV_PROFILE_ZONE("CpuVertexBuffer::UpdateData");
+
+    float *dst = _cpuBuffer + startVertex * _numElements;
+    if (dst != src) {
+        memcpy(dst, src, GetNumElements() * numVertices * sizeof(float));
+    }
 }
 
 int
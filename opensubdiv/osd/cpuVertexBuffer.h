@@ -39,17 +39,28 @@ namespace Osd {
 /// CpuVertexBuffer implements the VertexBufferInterface. An instance
 /// of this buffer class can be passed to CpuEvaluator
 ///
+/// Buffers either own their memory, or wrap memory owned by the client (see
+/// Wrap()) : e.g. control vertices written in place by a deformer, refined
+/// into the vertices of a renderer without any copy.
+///
 class CpuVertexBuffer {
 public:
     /// Creator. Returns NULL if error.
     static CpuVertexBuffer * Create(int numElements, int numVertices,
                                     void *deviceContext = NULL);
 
+    /// Creator of a buffer wrapping the 'numVertices' vertices of
+    /// 'numElements' floats of 'buffer', which remains owned by the client
+    /// and must outlive the wrapping buffer. Returns NULL if error.
+    static CpuVertexBuffer * Wrap(float *buffer,
+                                  int numElements, int numVertices);
+
     /// Destructor.
     ~CpuVertexBuffer();
 
     /// This method is meant to be used in client code in order to provide
-    /// coarse vertices data to Osd.
+    /// coarse vertices data to Osd. Data already in place in the buffer
+    /// (e.g. written by the client into wrapped memory) is not copied.
     void UpdateData(const float *src, int startVertex, int numVertices,
                     void *deviceContext = NULL);
 
@@ -62,14 +73,26 @@ public:
     /// Returns the address of CPU buffer
     float * BindCpuBuffer();
 
+    /// Returns true if the buffer wraps memory owned by the client
+    bool IsWrapping() const { return !_ownsBuffer; }
+
+    /// Wraps another client buffer of the same size, e.g. the buffer mapped
+    /// by a renderer for the current frame. Returns false if the buffer
+    /// owns its memory.
+    bool SetCpuBuffer(float *buffer);
+
 protected:
     /// Constructor.
     CpuVertexBuffer(int numElements, int numVertices);
 
+    /// Constructor of a buffer wrapping client memory.
+    CpuVertexBuffer(int numElements, int numVertices, float *buffer);
+
 private:
     int _numElements;
     int _numVertices;
     float *_cpuBuffer;
+    bool _ownsBuffer;
 };
 
 
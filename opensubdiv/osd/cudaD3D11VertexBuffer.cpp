@@ -24,11 +24,13 @@
 
 #include "../osd/cudaD3D11VertexBuffer.h"
 #include "../far/error.h"
+#include "../far/profile.h"
 
 #include <D3D11.h>
 #include <cuda_runtime.h>
 #include <cuda_d3d11_interop.h>
 #include <cassert>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -65,6 +67,8 @@ CudaD3D11VertexBuffer::UpdateData(const float *src,
                                   int startVertex, int numVertices,
                                   void * /*deviceContext*/) {
 
+    OPENSUBDIV_PROFILE_ZONE("CudaD3D11VertexBuffer::UpdateData");
+
     map();
     cudaMemcpy((float*)_cudaBuffer + _numElements * startVertex,
                src, _numElements * numVertices * sizeof(float),
@@ -124,6 +128,63 @@ CudaD3D11VertexBuffer::allocate(ID3D11Device *device) {
     return true;
 }
 
+bool
+CudaD3D11VertexBuffer::MapBuffers(CudaD3D11VertexBuffer * const * buffers,
+                                  int numBuffers) {
+
+    std::vector<CudaD3D11VertexBuffer *> unmapped;
+    std::vector<cudaGraphicsResource *> resources;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i] && buffers[i]->_cudaBuffer == NULL) {
+            unmapped.push_back(buffers[i]);
+            resources.push_back(buffers[i]->_cudaResource);
+        }
+    }
+    if (unmapped.empty()) return true;
+
+    if (cudaGraphicsMapResources((int)resources.size(), &resources[0], 0)
+        != cudaSuccess) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "CudaD3D11VertexBuffer::MapBuffers failed.\n");
+        return false;
+    }
+    for (int i = 0; i < (int)unmapped.size(); ++i) {
+        size_t num_bytes;
+        void *ptr;
+        if (cudaGraphicsResourceGetMappedPointer(&ptr, &num_bytes,
+                                                 resources[i])
+            != cudaSuccess) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "CudaD3D11VertexBuffer::MapBuffers failed.\n");
+            return false;
+        }
+        unmapped[i]->_cudaBuffer = ptr;
+    }
+    return true;
+}
+
+bool
+CudaD3D11VertexBuffer::UnmapBuffers(CudaD3D11VertexBuffer * const * buffers,
+                                    int numBuffers) {
+
+    std::vector<cudaGraphicsResource *> resources;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i] && buffers[i]->_cudaBuffer) {
+            resources.push_back(buffers[i]->_cudaResource);
+            buffers[i]->_cudaBuffer = NULL;
+        }
+    }
+    if (resources.empty()) return true;
+
+    if (cudaGraphicsUnmapResources((int)resources.size(), &resources[0], 0)
+        != cudaSuccess) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "CudaD3D11VertexBuffer::UnmapBuffers failed.\n");
+        return false;
+    }
+    return true;
+}
+
 void
 CudaD3D11VertexBuffer::map() {
 
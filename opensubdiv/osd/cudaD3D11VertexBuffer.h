@@ -79,6 +79,17 @@ public:
         return BindD3D11Buffer(deviceContext);
     }
 
+    /// Maps the DX buffers of 'buffers' (NULL entries and buffers already
+    /// mapped are skipped) to cuda resources in a single call, rather than
+    /// on each BindCudaBuffer. Returns false if error.
+    static bool MapBuffers(CudaD3D11VertexBuffer * const * buffers,
+                           int numBuffers);
+
+    /// Unmaps the cuda resources of 'buffers' back to DX11 in a single call.
+    /// Returns false if error.
+    static bool UnmapBuffers(CudaD3D11VertexBuffer * const * buffers,
+                             int numBuffers);
+
 protected:
     /// Constructor.
     CudaD3D11VertexBuffer(int numElements, int numVertices);
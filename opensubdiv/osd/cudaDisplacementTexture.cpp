@@ -0,0 +1,93 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cudaDisplacementTexture.h"
+
+#include <cuda_runtime.h>
+
+#include "../osd/cpuDisplacementTexture.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CudaDisplacementTexture::CudaDisplacementTexture() :
+    _numFaces(0), _numChannels(0), _faceBuffer(NULL), _texelBuffer(NULL) {
+}
+
+CudaDisplacementTexture::~CudaDisplacementTexture() {
+    if (_faceBuffer) cudaFree(_faceBuffer);
+    if (_texelBuffer) cudaFree(_texelBuffer);
+}
+
+CudaDisplacementTexture *
+CudaDisplacementTexture::Create(int numFaces, const int *faceResolutions,
+                                int numChannels, const float *texels,
+                                void * /*deviceContext*/) {
+    if (numChannels != 1 && numChannels != 3) return 0;
+
+    CudaDisplacementTexture *instance = new CudaDisplacementTexture();
+    if (instance->allocate(numFaces, faceResolutions, numChannels, texels)) {
+        return instance;
+    }
+    delete instance;
+    return 0;
+}
+
+bool
+CudaDisplacementTexture::allocate(int numFaces, const int *faceResolutions,
+                                  int numChannels, const float *texels) {
+    CpuDisplacementTexture texture(numFaces, faceResolutions,
+                                   numChannels, texels);
+
+    _numFaces = texture.GetNumFaces();
+    _numChannels = numChannels;
+    if (_numFaces == 0) return true;
+
+    size_t faceSize = 3 * _numFaces * sizeof(int),
+           texelSize = texture.GetTexelBufferSize() * sizeof(float);
+
+    cudaError_t err;
+    err = cudaMalloc(&_faceBuffer, faceSize);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMemcpy(_faceBuffer, texture.GetFaceBuffer(),
+                     faceSize, cudaMemcpyHostToDevice);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMalloc(&_texelBuffer, texelSize);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMemcpy(_texelBuffer, texture.GetTexelBuffer(),
+                     texelSize, cudaMemcpyHostToDevice);
+    if (err != cudaSuccess) return false;
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
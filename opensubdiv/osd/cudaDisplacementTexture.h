@@ -0,0 +1,86 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CUDA_DISPLACEMENT_TEXTURE_H
+#define OPENSUBDIV3_OSD_CUDA_DISPLACEMENT_TEXTURE_H
+
+#include "../version.h"
+
+#include <cstddef>
+
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief CUDA displacement texture
+///
+/// This class is a CUDA buffer representation of the texels of the ptex
+/// faces of a CpuDisplacementTexture, so that CudaEvaluator::EvalPatches
+/// displaces the limit points on the device. Displacement callbacks are
+/// not supported on the device.
+///
+class CudaDisplacementTexture : private NonCopyable<CudaDisplacementTexture> {
+public:
+    static CudaDisplacementTexture *Create(int numFaces,
+                                           const int *faceResolutions,
+                                           int numChannels,
+                                           const float *texels,
+                                           void *deviceContext = NULL);
+    ~CudaDisplacementTexture();
+
+    /// Returns the number of ptex faces
+    int GetNumFaces() const { return _numFaces; }
+
+    /// Returns the number of channels (1 or 3)
+    int GetNumChannels() const { return _numChannels; }
+
+    /// Returns the CUDA memory of the encoded faces
+    void *GetFaceBuffer() const { return _faceBuffer; }
+
+    /// Returns the CUDA memory of the texels
+    void *GetTexelBuffer() const { return _texelBuffer; }
+
+protected:
+    CudaDisplacementTexture();
+
+    bool allocate(int numFaces, const int *faceResolutions,
+                  int numChannels, const float *texels);
+
+    int _numFaces,
+        _numChannels;
+    void *_faceBuffer,
+         *_texelBuffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CUDA_DISPLACEMENT_TEXTURE_H
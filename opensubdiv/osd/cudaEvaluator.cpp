@@ -25,9 +25,13 @@
 #include "../osd/cudaEvaluator.h"
 
 #include <cuda_runtime.h>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "../far/stencilTable.h"
+#include "../far/profile.h"
+#include "../osd/cudaDisplacementTexture.h"
 #include "../osd/types.h"
 
 extern "C" {
@@ -41,7 +45,70 @@ extern "C" {
                           const int * indices,
                           const float * weights,
                           int start,
-                          int end);
+                          int end,
+                          cudaStream_t stream);
+
+    void CudaEvalStencilsWithDerivatives(const float *src,
+                                         float *dst,
+                                         float *du,
+                                         float *dv,
+                                         int length,
+                                         int srcStride,
+                                         int dstStride,
+                                         int duStride,
+                                         int dvStride,
+                                         const int * sizes,
+                                         const int * offsets,
+                                         const int * indices,
+                                         const float * weights,
+                                         const float * duWeights,
+                                         const float * dvWeights,
+                                         int start,
+                                         int end,
+                                         cudaStream_t stream);
+
+    void CudaEvalStencilsBatch(const float *src,
+                               float *dst,
+                               int length,
+                               int srcStride,
+                               int dstStride,
+                               const int * sizes,
+                               const int * offsets,
+                               const int * indices,
+                               const float * weights,
+                               int start,
+                               int end,
+                               int numInstances,
+                               const int * instanceOffsets,
+                               cudaStream_t stream);
+
+    void CudaEvalStencilBuckets(const float *src,
+                                float *dst,
+                                int length,
+                                int srcStride,
+                                int dstStride,
+                                const int * sizes,
+                                const int * offsets,
+                                const int * indices,
+                                const float * weights,
+                                const int * stencils,
+                                int numSmallStencils,
+                                int numLargeStencils,
+                                cudaStream_t stream);
+
+    bool CudaEvalStencilPasses(const float *src,
+                               float *dst,
+                               int length,
+                               int srcStride,
+                               int dstStride,
+                               const int * sizes,
+                               const int * offsets,
+                               const int * indices,
+                               const float * weights,
+                               const int * passOffsets,
+                               int numPasses,
+                               int numStencils,
+                               cudaStream_t stream);
 
     void CudaEvalPatches(
         const float *src, float *dst,
@@ -50,7 +117,8 @@ extern "C" {
         const void *patchCoords,
         const void *patchArrays,
         const int *patchIndices,
-        const void *patchParams);
+        const void *patchParams,
+        cudaStream_t stream);
 
     void CudaEvalPatchesWithDerivatives(
         const float *src, float *dst, float *du, float *dv,
@@ -60,7 +128,96 @@ extern "C" {
         const void *patchCoords,
         const void *patchArrays,
         const int *patchIndices,
-        const void *patchParams);
+        const void *patchParams,
+        cudaStream_t stream);
+
+    void CudaEvalPatchesDisplaced(
+        const float *src, float *dst, float *du, float *dv,
+        int length,
+        int srcStride, int dstStride, int duStride, int dvStride,
+        int numPatchCoords,
+        const void *patchCoords,
+        const void *patchArrays,
+        const int *patchIndices,
+        const void *patchParams,
+        const void *displacementFaces,
+        const void *displacementTexels,
+        int numDisplacementFaces,
+        int numDisplacementChannels,
+        float displacementScale,
+        cudaStream_t stream);
+
+    void CudaEvalPatchesFaceVarying(
+        const float *src, float *dst, float *du, float *dv,
+        int length,
+        int srcStride, int dstStride, int duStride, int dvStride,
+        int numPatchCoords,
+        const void *patchCoords,
+        const void *fvarPatchArrays,
+        const int *fvarPatchIndices,
+        const void *fvarPatchParams,
+        cudaStream_t stream);
+
+    void CudaEvalPatchesVarying(
+        const float *src, float *dst, float *du, float *dv,
+        int length,
+        int srcStride, int dstStride, int duStride, int dvStride,
+        int numPatchCoords,
+        const void *patchCoords,
+        const void *patchArrays,
+        const int *patchIndices,
+        const void *patchParams,
+        cudaStream_t stream);
+
+    void CudaEvalPatchesFaceUniform(
+        const float *src, float *dst,
+        int length, int srcStride, int dstStride,
+        int numPatchCoords,
+        const void *patchCoords,
+        const void *patchArrays,
+        const int *patchIndices,
+        const void *patchParams,
+        cudaStream_t stream);
+
+    void CudaFindPatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        void *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        cudaStream_t stream);
+
+    void CudaUpdatePatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        void *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        const void *patchParamBuffer,
+        cudaStream_t stream);
+
+    void CudaAdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        int numPtexFaces,
+        const int *adjacencyBuffer,
+        void *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        cudaStream_t stream);
+
+    void CudaBlendKeyframes(
+        const float *key0, const float *key1, float *dst,
+        int length, int keyStride, int dstStride,
+        int numVertices, float weight,
+        cudaStream_t stream);
 }
 
 namespace OpenSubdiv {
@@ -68,6 +225,46 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
+// Arrays larger than a chunk are uploaded a chunk at a time through two
+// pinned staging buffers : a chunk is copied into one of them while the other
+// is transferred, rather than having the driver stage pageable memory.
+static const size_t UPLOAD_CHUNK_SIZE = 16 << 20;
+
+static cudaError_t
+uploadChunks(void *devicePtr, const void *src, size_t size) {
+    void *staging[2] = { NULL, NULL };
+    cudaEvent_t transferred[2] = { NULL, NULL };
+
+    cudaError_t err = cudaSuccess;
+    for (int i = 0; i < 2 && err == cudaSuccess; ++i) {
+        err = cudaMallocHost(&staging[i], UPLOAD_CHUNK_SIZE);
+        if (err == cudaSuccess) err = cudaEventCreate(&transferred[i]);
+    }
+
+    size_t offset = 0;
+    for (int i = 0; offset < size && err == cudaSuccess; i = 1 - i) {
+        size_t chunk = std::min(UPLOAD_CHUNK_SIZE, size - offset);
+
+        // wait for the previous transfer from this staging buffer
+        err = cudaEventSynchronize(transferred[i]);
+        if (err != cudaSuccess) break;
+
+        memcpy(staging[i], static_cast<const char *>(src) + offset, chunk);
+        err = cudaMemcpyAsync(static_cast<char *>(devicePtr) + offset,
+                              staging[i], chunk, cudaMemcpyHostToDevice, 0);
+        if (err == cudaSuccess) err = cudaEventRecord(transferred[i], 0);
+        offset += chunk;
+    }
+    cudaError_t syncErr = cudaStreamSynchronize(0);
+    if (err == cudaSuccess) err = syncErr;
+
+    for (int i = 0; i < 2; ++i) {
+        if (staging[i]) cudaFreeHost(staging[i]);
+        if (transferred[i]) cudaEventDestroy(transferred[i]);
+    }
+    return err;
+}
+
 template <class T> void *
 createCudaBuffer(std::vector<T> const & src) {
     void * devicePtr = 0;
@@ -79,7 +276,11 @@ createCudaBuffer(std::vector<T> const & src) {
         return devicePtr;
     }
 
-    err = cudaMemcpy(devicePtr, &src.at(0), size, cudaMemcpyHostToDevice);
+    if (size > UPLOAD_CHUNK_SIZE) {
+        err = uploadChunks(devicePtr, &src.at(0), size);
+    } else {
+        err = cudaMemcpy(devicePtr, &src.at(0), size, cudaMemcpyHostToDevice);
+    }
     if (err != cudaSuccess) {
         cudaFree(devicePtr);
         return 0;
@@ -89,6 +290,45 @@ createCudaBuffer(std::vector<T> const & src) {
 
 // ----------------------------------------------------------------------------
 
+// Stencils of at least this size are applied one warp per stencil : below it,
+// most lanes of the warp would have no term of the stencil to accumulate.
+static const int LARGE_STENCIL_SIZE = 16;
+
+// The buckets are only worth the indirection if enough of the stencils
+// are large, e.g. the limit stencils of a mesh, or the stencils of the
+// extraordinary vertices of a deep level.
+static const float LARGE_STENCIL_FRACTION = 0.05f;
+
+void
+CudaStencilTable::createBuckets(std::vector<int> const & sizes) {
+    _buckets = NULL;
+    _numLargeStencils = 0;
+
+    std::vector<int> buckets;
+    buckets.reserve(sizes.size());
+    for (int i = 0; i < (int)sizes.size(); ++i) {
+        if (sizes[i] < LARGE_STENCIL_SIZE) buckets.push_back(i);
+    }
+    _numLargeStencils = (int)sizes.size() - (int)buckets.size();
+
+    if (_numLargeStencils < LARGE_STENCIL_FRACTION * (float)sizes.size()) {
+        _numLargeStencils = 0;
+        return;
+    }
+    for (int i = 0; i < (int)sizes.size(); ++i) {
+        if (sizes[i] >= LARGE_STENCIL_SIZE) buckets.push_back(i);
+    }
+    _buckets = createCudaBuffer(buckets);
+    if (_buckets == NULL) _numLargeStencils = 0;
+}
+
+void
+CudaStencilTable::createPasses(std::vector<int> const & passOffsets) {
+    _passOffsets = passOffsets;
+    _passOffsetsBuffer = _passOffsets.empty() ? NULL :
+        createCudaBuffer(_passOffsets);
+}
+
 CudaStencilTable::CudaStencilTable(Far::StencilTable const *stencilTable) {
     _numStencils = stencilTable->GetNumStencils();
     if (_numStencils > 0) {
@@ -97,9 +337,19 @@ CudaStencilTable::CudaStencilTable(Far::StencilTable const *stencilTable) {
         _indices = createCudaBuffer(stencilTable->GetControlIndices());
         _weights = createCudaBuffer(stencilTable->GetWeights());
         _duWeights = _dvWeights = NULL;
+        createPasses(stencilTable->GetPassOffsets());
+        if (_passOffsets.empty()) {
+            // (buckets would not follow the order of the passes)
+            createBuckets(stencilTable->GetSizes());
+        } else {
+            _buckets = NULL;
+            _numLargeStencils = 0;
+        }
     } else {
         _sizes = _offsets = _indices = _weights = NULL;
         _duWeights = _dvWeights = NULL;
+        _buckets = _passOffsetsBuffer = NULL;
+        _numLargeStencils = 0;
     }
 }
 
@@ -112,10 +362,39 @@ CudaStencilTable::CudaStencilTable(Far::LimitStencilTable const *limitStencilTab
         _weights = createCudaBuffer(limitStencilTable->GetWeights());
         _duWeights = createCudaBuffer(limitStencilTable->GetDuWeights());
         _dvWeights = createCudaBuffer(limitStencilTable->GetDvWeights());
+        createBuckets(limitStencilTable->GetSizes());
     } else {
         _sizes = _offsets = _indices = _weights = NULL;
         _duWeights = _dvWeights = NULL;
+        _buckets = NULL;
+        _numLargeStencils = 0;
     }
+    _passOffsetsBuffer = NULL;
+}
+
+CudaStencilTable::CudaStencilTable(int numStencils, void *sizes,
+                                   void *offsets, void *indices,
+                                   void *weights) :
+    _sizes(sizes), _offsets(offsets), _indices(indices), _weights(weights),
+    _duWeights(NULL), _dvWeights(NULL), _buckets(NULL),
+    _passOffsetsBuffer(NULL), _numStencils(numStencils),
+    _numLargeStencils(0) {
+}
+
+CudaStencilTable *
+CudaStencilTable::CreateAndRelease(Far::StencilTable *stencilTable,
+                                   void *deviceContext) {
+    CudaStencilTable *table = Create(stencilTable, deviceContext);
+    stencilTable->Clear();
+    return table;
+}
+
+CudaStencilTable *
+CudaStencilTable::CreateAndRelease(Far::LimitStencilTable *limitStencilTable,
+                                   void *deviceContext) {
+    CudaStencilTable *table = Create(limitStencilTable, deviceContext);
+    limitStencilTable->Clear();
+    return table;
 }
 
 CudaStencilTable::~CudaStencilTable() {
@@ -125,6 +404,8 @@ CudaStencilTable::~CudaStencilTable() {
     if (_weights) cudaFree(_weights);
     if (_duWeights) cudaFree(_duWeights);
     if (_dvWeights) cudaFree(_dvWeights);
+    if (_buckets) cudaFree(_buckets);
+    if (_passOffsetsBuffer) cudaFree(_passOffsetsBuffer);
 }
 
 // ---------------------------------------------------------------------------
@@ -138,7 +419,10 @@ CudaEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                             const int * indices,
                             const float * weights,
                             int start,
-                            int end) {
+                            int end,
+                            void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalStencils");
+
     if (dst == NULL) return false;
 
     CudaEvalStencils(src + srcDesc.offset,
@@ -147,7 +431,127 @@ CudaEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                      srcDesc.stride,
                      dstDesc.stride,
                      sizes, offsets, indices, weights,
-                     start, end);
+                     start, end,
+                     static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::EvalStencilBuckets(const float *src, BufferDescriptor const &srcDesc,
+                                  float *dst,       BufferDescriptor const &dstDesc,
+                                  const int * sizes,
+                                  const int * offsets,
+                                  const int * indices,
+                                  const float * weights,
+                                  const int * buckets,
+                                  int numSmallStencils,
+                                  int numLargeStencils,
+                                  void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalStencilBuckets");
+
+    if (dst == NULL) return false;
+
+    CudaEvalStencilBuckets(src + srcDesc.offset,
+                           dst + dstDesc.offset,
+                           srcDesc.length,
+                           srcDesc.stride,
+                           dstDesc.stride,
+                           sizes, offsets, indices, weights,
+                           buckets, numSmallStencils, numLargeStencils,
+                           static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::EvalStencilPasses(const float *src, BufferDescriptor const &srcDesc,
+                                 float *dst,       BufferDescriptor const &dstDesc,
+                                 const int * sizes,
+                                 const int * offsets,
+                                 const int * indices,
+                                 const float * weights,
+                                 const int * passOffsets,
+                                 const int * passOffsetsBuffer,
+                                 int numPasses,
+                                 int numStencils,
+                                 void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalStencilPasses");
+
+    if (dst == NULL) return false;
+
+    cudaStream_t stream = static_cast<cudaStream_t>(deviceContext);
+
+    // cooperative launches are not captured into graphs (see CudaGraph)
+    cudaStreamCaptureStatus captureStatus = cudaStreamCaptureStatusNone;
+    if (stream) cudaStreamIsCapturing(stream, &captureStatus);
+
+    // a single cooperative launch for all the passes
+    if (passOffsetsBuffer and captureStatus == cudaStreamCaptureStatusNone and
+        CudaEvalStencilPasses(src + srcDesc.offset,
+                              dst + dstDesc.offset,
+                              srcDesc.length,
+                              srcDesc.stride,
+                              dstDesc.stride,
+                              sizes, offsets, indices, weights,
+                              passOffsetsBuffer, numPasses, numStencils,
+                              stream)) {
+        return true;
+    }
+
+    // otherwise one launch per pass : launches in the same stream complete
+    // in order
+    for (int pass = 0; pass < numPasses; ++pass) {
+        int start = passOffsets[pass];
+        int end = (pass+1 < numPasses) ? passOffsets[pass+1] : numStencils;
+
+        CudaEvalStencils(src + srcDesc.offset,
+                         dst + dstDesc.offset,
+                         srcDesc.length,
+                         srcDesc.stride,
+                         dstDesc.stride,
+                         sizes, offsets, indices, weights,
+                         start, end,
+                         stream);
+    }
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::EvalStencilsBatch(const float *src, BufferDescriptor const &srcDesc,
+                                 float *dst,       BufferDescriptor const &dstDesc,
+                                 const int * sizes,
+                                 const int * offsets,
+                                 const int * indices,
+                                 const float * weights,
+                                 int start,
+                                 int end,
+                                 int numInstances,
+                                 const int * instanceOffsets,
+                                 void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalStencilsBatch");
+
+    if (dst == NULL) return false;
+    if (numInstances <= 0 or end <= start) return true;
+
+    std::vector<int> hostOffsets(instanceOffsets,
+                                 instanceOffsets + 2*numInstances);
+    int * deviceOffsets = (int *)createCudaBuffer(hostOffsets);
+    if (deviceOffsets == NULL) return false;
+
+    CudaEvalStencilsBatch(src + srcDesc.offset,
+                          dst + dstDesc.offset,
+                          srcDesc.length,
+                          srcDesc.stride,
+                          dstDesc.stride,
+                          sizes, offsets, indices, weights,
+                          start, end,
+                          numInstances, deviceOffsets,
+                          static_cast<cudaStream_t>(deviceContext));
+
+    // cudaFree() waits for the launch to complete
+    cudaFree(deviceOffsets);
     return true;
 }
 
@@ -164,34 +568,36 @@ CudaEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                             const float * duWeights,
                             const float * dvWeights,
                             int start,
-                            int end) {
-    // PERFORMANCE: need to combine 3 launches together
-    if (dst) {
+                            int end,
+                            void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalStencils");
+
+    // derivatives are only written from the weights of limit stencils
+    if (!duWeights) du = NULL;
+    if (!dvWeights) dv = NULL;
+
+    if (du || dv) {
+        // a single launch for the primvar and its derivatives
+        CudaEvalStencilsWithDerivatives(src + srcDesc.offset,
+                         dst ? dst + dstDesc.offset : NULL,
+                         du  ? du  + duDesc.offset  : NULL,
+                         dv  ? dv  + dvDesc.offset  : NULL,
+                         srcDesc.length,
+                         srcDesc.stride,
+                         dstDesc.stride, duDesc.stride, dvDesc.stride,
+                         sizes, offsets, indices,
+                         weights, duWeights, dvWeights,
+                         start, end,
+                         static_cast<cudaStream_t>(deviceContext));
+    } else if (dst) {
         CudaEvalStencils(src + srcDesc.offset,
                          dst + dstDesc.offset,
                          srcDesc.length,
                          srcDesc.stride,
                          dstDesc.stride,
                          sizes, offsets, indices, weights,
-                         start, end);
-    }
-    if (du) {
-        CudaEvalStencils(src + srcDesc.offset,
-                         du +  duDesc.offset,
-                         srcDesc.length,
-                         srcDesc.stride,
-                         duDesc.stride,
-                         sizes, offsets, indices, duWeights,
-                         start, end);
-    }
-    if (dv) {
-        CudaEvalStencils(src + srcDesc.offset,
-                         dv  + dvDesc.offset,
-                         srcDesc.length,
-                         srcDesc.stride,
-                         dvDesc.stride,
-                         sizes, offsets, indices, dvWeights,
-                         start, end);
+                         start, end,
+                         static_cast<cudaStream_t>(deviceContext));
     }
     return true;
 }
@@ -206,13 +612,17 @@ CudaEvaluator::EvalPatches(const float *src,
                            const PatchCoord *patchCoords,
                            const PatchArray *patchArrays,
                            const int *patchIndices,
-                           const PatchParam *patchParams) {
+                           const PatchParam *patchParams,
+                           void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalPatches");
+
     if (src) src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
 
     CudaEvalPatches(src, dst,
                     srcDesc.length, srcDesc.stride, dstDesc.stride,
-                    numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams);
+                    numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams,
+                    static_cast<cudaStream_t>(deviceContext));
 
     return true;
 }
@@ -228,7 +638,10 @@ CudaEvaluator::EvalPatches(
     const PatchCoord *patchCoords,
     const PatchArray *patchArrays,
     const int *patchIndices,
-    const PatchParam *patchParams) {
+    const PatchParam *patchParams,
+    void * deviceContext) {
+
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalPatches");
 
     if (src) src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
@@ -239,16 +652,286 @@ CudaEvaluator::EvalPatches(
         src, dst, du, dv,
         srcDesc.length, srcDesc.stride,
         dstDesc.stride, duDesc.stride, dvDesc.stride,
-        numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams);
+        numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams,
+        static_cast<cudaStream_t>(deviceContext));
     return true;
 }
 
+/* static */
+bool
+CudaEvaluator::EvalPatches(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrays,
+    const int *patchIndices,
+    const PatchParam *patchParams,
+    CudaDisplacementTexture const *displacement,
+    float displacementScale,
+    void * deviceContext) {
+
+    if (!displacement) {
+        return EvalPatches(src, srcDesc, dst, dstDesc, du, duDesc, dv, dvDesc,
+                           numPatchCoords, patchCoords, patchArrays,
+                           patchIndices, patchParams, deviceContext);
+    }
+
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalPatches");
+
+    // the displaced points are the first 3 components of the primvars
+    if (srcDesc.length < 3 || !dst) return false;
+
+    if (src) src += srcDesc.offset;
+    if (dst) dst += dstDesc.offset;
+    if (du)  du  += duDesc.offset;
+    if (dv)  dv  += dvDesc.offset;
+
+    CudaEvalPatchesDisplaced(
+        src, dst, du, dv,
+        srcDesc.length, srcDesc.stride,
+        dstDesc.stride, duDesc.stride, dvDesc.stride,
+        numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams,
+        displacement->GetFaceBuffer(), displacement->GetTexelBuffer(),
+        displacement->GetNumFaces(), displacement->GetNumChannels(),
+        displacementScale,
+        static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndices,
+    const PatchParam *fvarPatchParams,
+    void * deviceContext) {
+
+    return EvalPatchesFaceVarying(src, srcDesc, dst, dstDesc,
+                                  NULL, BufferDescriptor(),
+                                  NULL, BufferDescriptor(),
+                                  numPatchCoords, patchCoords,
+                                  fvarPatchArrays, fvarPatchIndices,
+                                  fvarPatchParams, deviceContext);
+}
+
+/* static */
+bool
+CudaEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndices,
+    const PatchParam *fvarPatchParams,
+    void * deviceContext) {
+
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalPatchesFaceVarying");
+
+    if (src) src += srcDesc.offset;
+    if (dst) dst += dstDesc.offset;
+    if (du)  du  += duDesc.offset;
+    if (dv)  dv  += dvDesc.offset;
+
+    CudaEvalPatchesFaceVarying(
+        src, dst, du, dv,
+        srcDesc.length, srcDesc.stride,
+        dstDesc.stride, duDesc.stride, dvDesc.stride,
+        numPatchCoords, patchCoords,
+        fvarPatchArrays, fvarPatchIndices, fvarPatchParams,
+        static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::EvalPatchesVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrays,
+    const int *patchIndices,
+    const PatchParam *patchParams,
+    void * deviceContext) {
+
+    return EvalPatchesVarying(src, srcDesc, dst, dstDesc,
+                              NULL, BufferDescriptor(),
+                              NULL, BufferDescriptor(),
+                              numPatchCoords, patchCoords,
+                              patchArrays, patchIndices, patchParams,
+                              deviceContext);
+}
+
+/* static */
+bool
+CudaEvaluator::EvalPatchesVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrays,
+    const int *patchIndices,
+    const PatchParam *patchParams,
+    void * deviceContext) {
+
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalPatchesVarying");
+
+    if (src) src += srcDesc.offset;
+    if (dst) dst += dstDesc.offset;
+    if (du)  du  += duDesc.offset;
+    if (dv)  dv  += dvDesc.offset;
+
+    CudaEvalPatchesVarying(
+        src, dst, du, dv,
+        srcDesc.length, srcDesc.stride,
+        dstDesc.stride, duDesc.stride, dvDesc.stride,
+        numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams,
+        static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::EvalPatchesFaceUniform(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrays,
+    const int *patchIndices,
+    const PatchParam *patchParams,
+    void * deviceContext) {
+
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::EvalPatchesFaceUniform");
+
+    if (src) src += srcDesc.offset;
+    if (dst) dst += dstDesc.offset;
+
+    CudaEvalPatchesFaceUniform(
+        src, dst,
+        srcDesc.length, srcDesc.stride, dstDesc.stride,
+        numPatchCoords, patchCoords, patchArrays, patchIndices, patchParams,
+        static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::FindPatchCoords(int numLocations,
+                               const int *faceIds,
+                               const float *u,
+                               const float *v,
+                               PatchCoord *patchCoords,
+                               int numFaces,
+                               const int *faceBuffer,
+                               const unsigned int *nodeBuffer,
+                               const int *handleBuffer,
+                               void * deviceContext) {
+
+    CudaFindPatchCoords(numLocations, faceIds, u, v, patchCoords,
+                        numFaces, faceBuffer, nodeBuffer, handleBuffer,
+                        static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::UpdatePatchCoords(int numLocations,
+                                 const int *faceIds,
+                                 const float *u,
+                                 const float *v,
+                                 PatchCoord *patchCoords,
+                                 int numFaces,
+                                 const int *faceBuffer,
+                                 const unsigned int *nodeBuffer,
+                                 const int *handleBuffer,
+                                 const void *patchParamBuffer,
+                                 void * deviceContext) {
+
+    CudaUpdatePatchCoords(numLocations, faceIds, u, v, patchCoords,
+                          numFaces, faceBuffer, nodeBuffer, handleBuffer,
+                          patchParamBuffer,
+                          static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::AdvectPatchCoords(int numSamples,
+                                 int *faceIds,
+                                 float *u,
+                                 float *v,
+                                 float *velocities,
+                                 float step,
+                                 int numPtexFaces,
+                                 const int *adjacencyBuffer,
+                                 PatchCoord *patchCoords,
+                                 int numFaces,
+                                 const int *faceBuffer,
+                                 const unsigned int *nodeBuffer,
+                                 const int *handleBuffer,
+                                 void * deviceContext) {
+
+    CudaAdvectPatchCoords(numSamples, faceIds, u, v, velocities, step,
+                          numPtexFaces, adjacencyBuffer, patchCoords,
+                          numFaces, faceBuffer, nodeBuffer, handleBuffer,
+                          static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
+
+/* static */
+bool
+CudaEvaluator::BlendKeyframes(const float *keys,
+                              BufferDescriptor const &keyDesc,
+                              float *dst,
+                              BufferDescriptor const &dstDesc,
+                              int numVertices, int key0, int key1,
+                              float weight,
+                              void * deviceContext) {
+    OPENSUBDIV_PROFILE_ZONE("CudaEvaluator::BlendKeyframes");
+
+    if (dst == NULL) return false;
+    if (keyDesc.length != dstDesc.length) return false;
+
+    const float *keyframes = keys + keyDesc.offset;
+    CudaBlendKeyframes(keyframes + key0 * numVertices * keyDesc.stride,
+                       keyframes + key1 * numVertices * keyDesc.stride,
+                       dst + dstDesc.offset,
+                       dstDesc.length, keyDesc.stride, dstDesc.stride,
+                       numVertices, weight,
+                       static_cast<cudaStream_t>(deviceContext));
+    return true;
+}
 
 
 /* static */
 void
-CudaEvaluator::Synchronize(void * /*deviceContext*/) {
-    cudaThreadSynchronize();
+CudaEvaluator::Synchronize(void * deviceContext) {
+    if (deviceContext) {
+        cudaStreamSynchronize(static_cast<cudaStream_t>(deviceContext));
+    } else {
+        cudaThreadSynchronize();
+    }
+}
+
+/* static */
+bool
+CudaEvaluator::IsComplete(void * deviceContext) {
+    // the default stream (NULL) is queried as any other stream
+    return cudaStreamQuery(
+        static_cast<cudaStream_t>(deviceContext)) != cudaErrorNotReady;
 }
 
 }  // end namespace Osd
@@ -42,6 +42,8 @@ namespace Far {
 
 namespace Osd {
 
+class CudaDisplacementTexture;
+
 /// \brief CUDA stencil table
 ///
 /// This class is a cuda buffer representation of Far::StencilTable.
@@ -62,6 +64,15 @@ public:
         return new CudaStencilTable(limitStencilTable);
     }
 
+    /// \brief Creates the table, then frees the arrays of 'stencilTable'
+    ///        (see Far::StencilTable::Clear) : large tables need not be kept
+    ///        on the host once uploaded
+    static CudaStencilTable *CreateAndRelease(Far::StencilTable *stencilTable,
+                                              void *deviceContext = NULL);
+    static CudaStencilTable *CreateAndRelease(
+        Far::LimitStencilTable *limitStencilTable,
+        void *deviceContext = NULL);
+
     explicit CudaStencilTable(Far::StencilTable const *stencilTable);
     explicit CudaStencilTable(Far::LimitStencilTable const *limitStencilTable);
     ~CudaStencilTable();
@@ -75,14 +86,47 @@ public:
     void *GetDvWeightsBuffer() const { return _dvWeights; }
     int GetNumStencils() const { return _numStencils; }
 
+    /// \brief Returns the indices of the stencils sorted into two buckets,
+    ///        the small stencils followed by the large ones (NULL if the
+    ///        table has no large stencils)
+    ///
+    /// Tables of large stencils (e.g. limit stencils, or stencils of deep
+    /// levels) are applied one warp per large stencil with the indices and
+    /// weights staged in shared memory, rather than one thread per stencil.
+    /// The buckets are set from the sizes of the stencils on creation.
+    ///
+    void *GetBucketsBuffer() const { return _buckets; }
+    int GetNumSmallStencils() const { return _numStencils - _numLargeStencils; }
+    int GetNumLargeStencils() const { return _numLargeStencils; }
+
+    /// \brief Returns the index of the first stencil of each evaluation pass
+    ///        (see Far::StencilTable::GetPassOffsets()) : on the host, and
+    ///        in a cuda buffer (NULL if the table has a single pass)
+    std::vector<int> const & GetPassOffsets() const { return _passOffsets; }
+    void *GetPassOffsetsBuffer() const { return _passOffsetsBuffer; }
+
 private:
+    friend class CudaStencilTableFactory;
+
+    // takes ownership of the cuda buffers of a table built on the device
+    // (see CudaStencilTableFactory)
+    CudaStencilTable(int numStencils, void *sizes, void *offsets,
+                     void *indices, void *weights);
+
+    void createBuckets(std::vector<int> const & sizes);
+    void createPasses(std::vector<int> const & passOffsets);
+
     void * _sizes,
          * _offsets,
          * _indices,
          * _weights,
          * _duWeights,
-         * _dvWeights;
-    int _numStencils;
+         * _dvWeights,
+         * _buckets,
+         * _passOffsetsBuffer;
+    std::vector<int> _passOffsets;
+    int _numStencils,
+        _numLargeStencils;
 };
 
 class CudaEvaluator {
@@ -114,7 +158,8 @@ public:
     ///
     /// @param instance       not used in the CudaEvaluator
     ///
-    /// @param deviceContext  not used in the CudaEvaluator
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
     static bool EvalStencils(
@@ -125,7 +170,31 @@ public:
         void * deviceContext = NULL) {
 
         (void)instance;  // unused
-        (void)deviceContext;  // unused
+        if (not stencilTable->GetPassOffsets().empty()) {
+            return EvalStencilPasses(srcBuffer->BindCudaBuffer(), srcDesc,
+                            dstBuffer->BindCudaBuffer(), dstDesc,
+                            (int const *)stencilTable->GetSizesBuffer(),
+                            (int const *)stencilTable->GetOffsetsBuffer(),
+                            (int const *)stencilTable->GetIndicesBuffer(),
+                            (float const *)stencilTable->GetWeightsBuffer(),
+                            &stencilTable->GetPassOffsets()[0],
+                            (int const *)stencilTable->GetPassOffsetsBuffer(),
+                            (int)stencilTable->GetPassOffsets().size(),
+                            stencilTable->GetNumStencils(),
+                            deviceContext);
+        }
+        if (stencilTable->GetBucketsBuffer()) {
+            return EvalStencilBuckets(srcBuffer->BindCudaBuffer(), srcDesc,
+                            dstBuffer->BindCudaBuffer(), dstDesc,
+                            (int const *)stencilTable->GetSizesBuffer(),
+                            (int const *)stencilTable->GetOffsetsBuffer(),
+                            (int const *)stencilTable->GetIndicesBuffer(),
+                            (float const *)stencilTable->GetWeightsBuffer(),
+                            (int const *)stencilTable->GetBucketsBuffer(),
+                            stencilTable->GetNumSmallStencils(),
+                            stencilTable->GetNumLargeStencils(),
+                            deviceContext);
+        }
         return EvalStencils(srcBuffer->BindCudaBuffer(), srcDesc,
                             dstBuffer->BindCudaBuffer(), dstDesc,
                             (int const *)stencilTable->GetSizesBuffer(),
@@ -133,7 +202,40 @@ public:
                             (int const *)stencilTable->GetIndicesBuffer(),
                             (float const *)stencilTable->GetWeightsBuffer(),
                             /*start = */ 0,
-                            /*end   = */ stencilTable->GetNumStencils());
+                            /*end   = */ stencilTable->GetNumStencils(),
+                            deviceContext);
+    }
+
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    /// \note  Ranges of tables of several passes must not span passes, and
+    ///        are evaluated in the order of the passes (see
+    ///        Far::StencilTable::GetPassOffsets())
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        const void *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;  // unused
+        if (end <= start) return true;
+
+        return EvalStencils(srcBuffer->BindCudaBuffer(), srcDesc,
+                            dstBuffer->BindCudaBuffer(), dstDesc,
+                            (int const *)stencilTable->GetSizesBuffer(),
+                            (int const *)stencilTable->GetOffsetsBuffer(),
+                            (int const *)stencilTable->GetIndicesBuffer(),
+                            (float const *)stencilTable->GetWeightsBuffer(),
+                            start, end,
+                            deviceContext);
     }
 
     /// \brief Static eval stencils function which takes raw cuda buffers for
@@ -162,6 +264,9 @@ public:
     ///
     /// @param end            end index of stencil table
     ///
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
+    ///
     static bool EvalStencils(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
@@ -169,7 +274,143 @@ public:
         const int * offsets,
         const int * indices,
         const float * weights,
-        int start, int end);
+        int start, int end,
+        void * deviceContext = NULL);
+
+    /// \brief Static eval stencils function applying the stencils of the
+    ///        buckets of a table (see CudaStencilTable::GetBucketsBuffer) :
+    ///        the small stencils one thread per stencil, the large ones one
+    ///        warp per stencil. Interleaved primvars of a multiple of 4
+    ///        elements are read and written as float4.
+    ///
+    /// @param buckets          indices of the small then the large stencils
+    ///
+    /// @param numSmallStencils number of small stencils in 'buckets'
+    ///
+    /// @param numLargeStencils number of large stencils in 'buckets'
+    ///
+    /// (see EvalStencils for the other parameters)
+    ///
+    static bool EvalStencilBuckets(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const int * buckets,
+        int numSmallStencils, int numLargeStencils,
+        void * deviceContext = NULL);
+
+    /// \brief Static eval stencils function applying the passes of a table
+    ///        in order (see Far::StencilTable::GetPassOffsets()) : the
+    ///        stencils of a pass refer to the vertices interpolated by the
+    ///        previous passes, following the control vertices in the same
+    ///        buffer.
+    ///
+    /// Devices supporting cooperative launches apply all the passes in a
+    /// single launch synchronizing the grid between passes, other devices
+    /// one launch per pass.
+    ///
+    /// @param passOffsets       first stencil of each pass (host memory)
+    ///
+    /// @param passOffsetsBuffer first stencil of each pass (device memory)
+    ///
+    /// @param numPasses         number of passes
+    ///
+    /// @param numStencils       number of stencils of the table
+    ///
+    /// (see EvalStencils for the other parameters)
+    ///
+    static bool EvalStencilPasses(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const int * passOffsets,
+        const int * passOffsetsBuffer,
+        int numPasses, int numStencils,
+        void * deviceContext = NULL);
+
+    /// \brief Generic static compute function for the instances of a mesh.
+    ///        The stencils of the table are applied to every instance in a
+    ///        single kernel launch, the instances being located by offsets
+    ///        in the input and output buffers.
+    ///
+    /// @param srcBuffer       Input primvar buffer.
+    ///                        must have BindCudaBuffer() method returning a
+    ///                        const float pointer for read
+    ///
+    /// @param srcDesc         vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer       Output primvar buffer
+    ///                        must have BindCudaBuffer() method returning a
+    ///                        float pointer for write
+    ///
+    /// @param dstDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable    stencil table shared by the instances. The
+    ///                        table must have Cuda memory interfaces.
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance
+    ///                        (host memory), in floats, added to the offsets
+    ///                        of srcDesc and dstDesc
+    ///
+    /// @param instance        not used in the CudaEvaluator
+    ///
+    /// @param deviceContext   cudaStream_t of the launch (optional: the
+    ///                        default stream if NULL)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsBatch(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int numInstances, int const * instanceOffsets,
+        const void *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;  // unused
+        return EvalStencilsBatch(srcBuffer->BindCudaBuffer(), srcDesc,
+                                 dstBuffer->BindCudaBuffer(), dstDesc,
+                                 (int const *)stencilTable->GetSizesBuffer(),
+                                 (int const *)stencilTable->GetOffsetsBuffer(),
+                                 (int const *)stencilTable->GetIndicesBuffer(),
+                                 (float const *)stencilTable->GetWeightsBuffer(),
+                                 /*start = */ 0,
+                                 /*end   = */ stencilTable->GetNumStencils(),
+                                 numInstances, instanceOffsets,
+                                 deviceContext);
+    }
+
+    /// \brief Static compute function for the instances of a mesh, which
+    ///        takes raw cuda buffers for input and output (see
+    ///        EvalStencils). The instance offsets are copied to the device
+    ///        for the launch, which is then waited for (even on a stream).
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance
+    ///                        (host memory), in floats, added to the offsets
+    ///                        of srcDesc and dstDesc
+    ///
+    /// @param deviceContext   cudaStream_t of the launch (optional: the
+    ///                        default stream if NULL)
+    ///
+    static bool EvalStencilsBatch(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end,
+        int numInstances, const int * instanceOffsets,
+        void * deviceContext = NULL);
 
     /// \brief Generic static eval stencils function with derivatives.
     ///        This function has a same signature as other device kernels
@@ -206,7 +447,8 @@ public:
     ///                       (declared as a typed pointer to prevent
     ///                        undesirable template resolution)
     ///
-    /// @param deviceContext  not used in the cuda kernel
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
     static bool EvalStencils(
@@ -219,8 +461,6 @@ public:
         void * deviceContext = NULL) {
 
         (void)instance;   // unused
-        (void)deviceContext;   // unused
-
         return EvalStencils(srcBuffer->BindCudaBuffer(), srcDesc,
                             dstBuffer->BindCudaBuffer(), dstDesc,
                             duBuffer->BindCudaBuffer(),  duDesc,
@@ -232,7 +472,8 @@ public:
                             (float const *)stencilTable->GetDuWeightsBuffer(),
                             (float const *)stencilTable->GetDvWeightsBuffer(),
                             /*start = */ 0,
-                            /*end   = */ stencilTable->GetNumStencils());
+                            /*end   = */ stencilTable->GetNumStencils(),
+                            deviceContext);
     }
 
     /// \brief Static eval stencils function with derivatives, which takes
@@ -275,6 +516,9 @@ public:
     ///
     /// @param end            end index of stencil table
     ///
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
+    ///
     static bool EvalStencils(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
@@ -286,7 +530,8 @@ public:
         const float * weights,
         const float * duWeights,
         const float * dvWeights,
-        int start, int end);
+        int start, int end,
+        void * deviceContext = NULL);
 
     /// ----------------------------------------------------------------------
     ///
@@ -320,7 +565,8 @@ public:
     ///
     /// @param instance         not used in the cuda evaluator
     ///
-    /// @param deviceContext    not used in the cuda evaluator
+    /// @param deviceContext    cudaStream_t of the launch (optional: the
+    ///                         default stream if NULL)
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
@@ -334,15 +580,14 @@ public:
         void * deviceContext = NULL) {
 
         (void)instance;   // unused
-        (void)deviceContext;   // unused
-
         return EvalPatches(srcBuffer->BindCudaBuffer(), srcDesc,
                            dstBuffer->BindCudaBuffer(), dstDesc,
                            numPatchCoords,
                            (const PatchCoord *)patchCoords->BindCudaBuffer(),
                            (const PatchArray *)patchTable->GetPatchArrayBuffer(),
                            (const int *)patchTable->GetPatchIndexBuffer(),
-                           (const PatchParam *)patchTable->GetPatchParamBuffer());
+                           (const PatchParam *)patchTable->GetPatchParamBuffer(),
+                           deviceContext);
     }
 
     /// \brief Generic limit eval function with derivatives. This function has
@@ -381,7 +626,8 @@ public:
     ///
     /// @param instance         not used in the cuda evaluator
     ///
-    /// @param deviceContext    not used in the cuda evaluator
+    /// @param deviceContext    cudaStream_t of the launch (optional: the
+    ///                         default stream if NULL)
     ///
     template <typename SRC_BUFFER, typename DST_BUFFER,
               typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
@@ -397,8 +643,6 @@ public:
         void * deviceContext = NULL) {
 
         (void)instance;   // unused
-        (void)deviceContext;   // unused
-
         return EvalPatches(srcBuffer->BindCudaBuffer(), srcDesc,
                            dstBuffer->BindCudaBuffer(), dstDesc,
                            duBuffer->BindCudaBuffer(),  duDesc,
@@ -407,7 +651,8 @@ public:
                            (const PatchCoord *)patchCoords->BindCudaBuffer(),
                            (const PatchArray *)patchTable->GetPatchArrayBuffer(),
                            (const int *)patchTable->GetPatchIndexBuffer(),
-                           (const PatchParam *)patchTable->GetPatchParamBuffer());
+                           (const PatchParam *)patchTable->GetPatchParamBuffer(),
+                           deviceContext);
     }
 
     /// \brief Static limit eval function. It takes an array of PatchCoord
@@ -437,6 +682,9 @@ public:
     /// @param patchParams      an array of Osd::PatchParam struct
     ///                         indexed by PatchCoord::patchIndex
     ///
+    /// @param deviceContext    cudaStream_t of the launch (optional: the
+    ///                         default stream if NULL)
+    ///
     static bool EvalPatches(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
@@ -444,7 +692,8 @@ public:
         const PatchCoord *patchCoords,
         const PatchArray *patchArrays,
         const int *patchIndices,
-        const PatchParam *patchParams);
+        const PatchParam *patchParams,
+        void * deviceContext = NULL);
 
     /// \brief Static limit eval function. It takes an array of PatchCoord
     ///        and evaluate limit values on given PatchTable.
@@ -483,6 +732,9 @@ public:
     /// @param patchParams      an array of Osd::PatchParam struct
     ///                         indexed by PatchCoord::patchIndex
     ///
+    /// @param deviceContext    cudaStream_t of the launch (optional: the
+    ///                         default stream if NULL)
+    ///
     static bool EvalPatches(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
@@ -492,14 +744,614 @@ public:
         const PatchCoord *patchCoords,
         const PatchArray *patchArrays,
         const int *patchIndices,
-        const PatchParam *patchParams);
+        const PatchParam *patchParams,
+        void * deviceContext = NULL);
+
+    /// \brief Generic limit eval function with derivatives, displacing the
+    ///        limit points by a displacement texture in the same kernel (see
+    ///        CpuEvaluator::EvalPatches and CudaDisplacementTexture).
+    ///
+    /// The first 3 components of the primvars are the displaced points.
+    /// duBuffer and dvBuffer may be NULL.
+    ///
+    /// @param displacement       CudaDisplacementTexture sampled at the
+    ///                           points (NULL : no displacement)
+    ///
+    /// @param displacementScale  Scale of the sampled displacement
+    ///
+    /// (see the function with derivatives for the other parameters)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CudaDisplacementTexture const *displacement,
+        float displacementScale,
+        CudaEvaluator const *instance,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return EvalPatches(srcBuffer->BindCudaBuffer(), srcDesc,
+                           dstBuffer->BindCudaBuffer(), dstDesc,
+                           duBuffer ? duBuffer->BindCudaBuffer() : NULL, duDesc,
+                           dvBuffer ? dvBuffer->BindCudaBuffer() : NULL, dvDesc,
+                           numPatchCoords,
+                           (const PatchCoord *)patchCoords->BindCudaBuffer(),
+                           (const PatchArray *)patchTable->GetPatchArrayBuffer(),
+                           (const int *)patchTable->GetPatchIndexBuffer(),
+                           (const PatchParam *)patchTable->GetPatchParamBuffer(),
+                           displacement, displacementScale,
+                           deviceContext);
+    }
+
+    /// \brief Static limit eval function with derivatives, displacing the
+    ///        limit points by a displacement texture in the same kernel (see
+    ///        the generic function above).
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *patchArrays,
+        const int *patchIndices,
+        const PatchParam *patchParams,
+        CudaDisplacementTexture const *displacement,
+        float displacementScale,
+        void * deviceContext = NULL);
+
+    /// \brief Generic face-varying limit eval function. It takes the
+    ///        PatchCoords of the vertex patches and evaluates the limit values
+    ///        of a face-varying channel of the PatchTable on the device (see
+    ///        CpuEvaluator::EvalPatchesFaceVarying).
+    ///
+    /// @param srcBuffer        Input face-varying primvar buffer.
+    ///                         must have BindCudaBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer
+    ///                         must have BindCudaBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CudaPatchTable or equivalent
+    ///
+    /// @param fvarChannel      face-varying channel of the patch table
+    ///
+    /// @param instance         not used in the cuda evaluator
+    ///
+    /// @param deviceContext    cudaStream_t of the launch (optional: the
+    ///                         default stream if NULL)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        CudaEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return EvalPatchesFaceVarying(srcBuffer->BindCudaBuffer(), srcDesc,
+            dstBuffer->BindCudaBuffer(), dstDesc,
+            numPatchCoords,
+            (const PatchCoord *)patchCoords->BindCudaBuffer(),
+            (const PatchArray *)patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+            (const int *)patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+            (const PatchParam *)patchTable->GetFVarPatchParamBuffer(fvarChannel),
+            deviceContext);
+    }
+
+    /// \brief Generic face-varying limit eval function with derivatives
+    ///        (see EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        CudaEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return EvalPatchesFaceVarying(srcBuffer->BindCudaBuffer(), srcDesc,
+            dstBuffer->BindCudaBuffer(), dstDesc,
+            duBuffer->BindCudaBuffer(),  duDesc,
+            dvBuffer->BindCudaBuffer(),  dvDesc,
+            numPatchCoords,
+            (const PatchCoord *)patchCoords->BindCudaBuffer(),
+            (const PatchArray *)patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+            (const int *)patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+            (const PatchParam *)patchTable->GetFVarPatchParamBuffer(fvarChannel),
+            deviceContext);
+    }
+
+    /// \brief Static face-varying limit eval function. The PatchCoords of
+    ///        the vertex patches are mapped to the patches of the channel by
+    ///        the kernel.
+    ///
+    /// @param fvarPatchArrays      patch arrays of the channel (see
+    ///                             CudaPatchTable::GetFVarPatchArrayBuffer)
+    ///
+    /// @param fvarPatchIndices     face-varying values of the patches
+    ///
+    /// @param fvarPatchParams      face-varying PatchParam of the patches
+    ///
+    /// (see EvalPatches for the other parameters)
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndices,
+        const PatchParam *fvarPatchParams,
+        void * deviceContext = NULL);
+
+    /// \brief Static face-varying limit eval function with derivatives (see
+    ///        EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndices,
+        const PatchParam *fvarPatchParams,
+        void * deviceContext = NULL);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Varying and face-uniform evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic varying eval function. Evaluates varying primvars at
+    ///        the PatchCoords of the vertex patches : the values are
+    ///        interpolated bilinearly between the corners of the patches.
+    ///
+    /// @param srcBuffer        Input varying primvar buffer (values of the
+    ///                         refined vertices and local points, indexed as
+    ///                         the vertex primvars).
+    ///                         must have BindCudaBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer
+    ///                         must have BindCudaBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CudaPatchTable or equivalent
+    ///
+    /// @param instance         not used in the cuda evaluator
+    ///
+    /// @param deviceContext    cudaStream_t of the launch (optional: the
+    ///                         default stream if NULL)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CudaEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return EvalPatchesVarying(srcBuffer->BindCudaBuffer(), srcDesc,
+            dstBuffer->BindCudaBuffer(), dstDesc,
+            numPatchCoords,
+            (const PatchCoord *)patchCoords->BindCudaBuffer(),
+            (const PatchArray *)patchTable->GetPatchArrayBuffer(),
+            (const int *)patchTable->GetPatchIndexBuffer(),
+            (const PatchParam *)patchTable->GetPatchParamBuffer(),
+            deviceContext);
+    }
+
+    /// \brief Generic varying eval function with derivatives (see
+    ///        EvalPatchesVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CudaEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return EvalPatchesVarying(srcBuffer->BindCudaBuffer(), srcDesc,
+            dstBuffer->BindCudaBuffer(), dstDesc,
+            duBuffer->BindCudaBuffer(),  duDesc,
+            dvBuffer->BindCudaBuffer(),  dvDesc,
+            numPatchCoords,
+            (const PatchCoord *)patchCoords->BindCudaBuffer(),
+            (const PatchArray *)patchTable->GetPatchArrayBuffer(),
+            (const int *)patchTable->GetPatchIndexBuffer(),
+            (const PatchParam *)patchTable->GetPatchParamBuffer(),
+            deviceContext);
+    }
+
+    /// \brief Static varying eval function (see EvalPatchesVarying above
+    ///        and EvalPatches for the parameters)
+    ///
+    static bool EvalPatchesVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *patchArrays,
+        const int *patchIndices,
+        const PatchParam *patchParams,
+        void * deviceContext = NULL);
+
+    /// \brief Static varying eval function with derivatives (see
+    ///        EvalPatchesVarying above and EvalPatches)
+    ///
+    static bool EvalPatchesVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *patchArrays,
+        const int *patchIndices,
+        const PatchParam *patchParams,
+        void * deviceContext = NULL);
+
+    /// \brief Generic face-uniform eval function. Copies the values of the
+    ///        faces of the PatchCoords, looked up by the face id of the
+    ///        PatchParam of their patches (i.e. the ptex face, which is the
+    ///        base face of quad meshes).
+    ///
+    /// @param srcBuffer        Input face-uniform primvar buffer, one value
+    ///                         per ptex face.
+    ///                         must have BindCudaBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// (see EvalPatchesVarying for the other parameters)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceUniform(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        CudaEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return EvalPatchesFaceUniform(srcBuffer->BindCudaBuffer(), srcDesc,
+            dstBuffer->BindCudaBuffer(), dstDesc,
+            numPatchCoords,
+            (const PatchCoord *)patchCoords->BindCudaBuffer(),
+            (const PatchArray *)patchTable->GetPatchArrayBuffer(),
+            (const int *)patchTable->GetPatchIndexBuffer(),
+            (const PatchParam *)patchTable->GetPatchParamBuffer(),
+            deviceContext);
+    }
+
+    /// \brief Static face-uniform eval function (see EvalPatchesFaceUniform
+    ///        above and EvalPatches for the parameters)
+    ///
+    static bool EvalPatchesFaceUniform(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *patchArrays,
+        const int *patchIndices,
+        const PatchParam *patchParams,
+        void * deviceContext = NULL);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Patch lookups with PatchMap
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static patch lookup function. Maps (faceId, u, v)
+    ///        locations to the PatchCoords of their sub-patches on the device
+    ///        (see CpuEvaluator::FindPatchCoords), to be evaluated with
+    ///        EvalPatches without leaving the device.
+    ///
+    /// Locations in holes, or on faces missing from the map, are mapped to
+    /// PatchCoords of patchIndex -1 which must not be evaluated.
+    ///
+    /// @param numLocations   number of locations
+    ///
+    /// @param faceIds        CUDA memory of the face index of each location
+    ///
+    /// @param u              CUDA memory of the u parameter of each location
+    ///
+    /// @param v              CUDA memory of the v parameter of each location
+    ///
+    /// @param patchCoords    CUDA memory of the output patch coordinates
+    ///
+    /// @param patchMap       CudaPatchMap or equivalent
+    ///
+    /// @param instance       not used in the cuda evaluator
+    ///
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
+    ///
+    template <typename PATCH_MAP>
+    static bool FindPatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        CudaEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return FindPatchCoords(numLocations, faceIds, u, v, patchCoords,
+                               patchMap->GetNumFaces(),
+                               (const int *)patchMap->GetFaceBuffer(),
+                               (const unsigned int *)patchMap->GetNodeBuffer(),
+                               (const int *)patchMap->GetHandleBuffer(),
+                               deviceContext);
+    }
+
+    /// \brief Static patch lookup function which takes the CUDA memory of
+    ///        the buffers of a CudaPatchMap
+    ///
+    static bool FindPatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        void *deviceContext = NULL);
+
+    /// \brief Generic static patch update function. Maps moving (faceId, u,
+    ///        v) locations to the PatchCoords of their sub-patches on the
+    ///        device, testing first the sub-patches of their previous
+    ///        PatchCoords (see CpuEvaluator::UpdatePatchCoords).
+    ///
+    /// @param numLocations   number of locations
+    ///
+    /// @param faceIds        CUDA memory of the face index of each location
+    ///
+    /// @param u              CUDA memory of the u parameter of each location
+    ///
+    /// @param v              CUDA memory of the v parameter of each location
+    ///
+    /// @param patchCoords    CUDA memory of the previous patch coordinates
+    ///                       (hints), replaced by the updated coordinates
+    ///
+    /// @param patchMap       CudaPatchMap or equivalent
+    ///
+    /// @param patchTable     CudaPatchTable or equivalent
+    ///
+    /// @param instance       not used in the cuda evaluator
+    ///
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
+    ///
+    template <typename PATCH_MAP, typename PATCH_TABLE>
+    static bool UpdatePatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        PATCH_TABLE *patchTable,
+        CudaEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return UpdatePatchCoords(numLocations, faceIds, u, v, patchCoords,
+                                 patchMap->GetNumFaces(),
+                                 (const int *)patchMap->GetFaceBuffer(),
+                                 (const unsigned int *)patchMap->GetNodeBuffer(),
+                                 (const int *)patchMap->GetHandleBuffer(),
+                                 patchTable->GetPatchParamBuffer(),
+                                 deviceContext);
+    }
+
+    /// \brief Static patch update function which takes the CUDA memory of
+    ///        the buffers of a CudaPatchMap and the PatchParams of a
+    ///        CudaPatchTable
+    ///
+    static bool UpdatePatchCoords(
+        int numLocations,
+        const int *faceIds, const float *u, const float *v,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        const void *patchParamBuffer,
+        void *deviceContext = NULL);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Surface samples with PtexAdjacency
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static surface sample function. Moves (faceId, u, v)
+    ///        samples across the ptex faces by their (du, dv) velocities and
+    ///        maps them to PatchCoords in a single kernel (see
+    ///        CpuEvaluator::AdvectPatchCoords), so that samples stay on the
+    ///        device from one step to the next.
+    ///
+    /// @param faceIds, u, v, velocities  CUDA memory of the samples (updated)
+    ///
+    /// @param ptexAdjacency  CudaPtexAdjacency or equivalent
+    ///
+    /// @param patchCoords    CUDA memory of the output patch coordinates
+    ///
+    /// @param patchMap       CudaPatchMap or equivalent
+    ///
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
+    ///
+    template <typename PTEX_ADJACENCY, typename PATCH_MAP>
+    static bool AdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        PTEX_ADJACENCY *ptexAdjacency,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        CudaEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;   // unused
+        return AdvectPatchCoords(numSamples, faceIds, u, v, velocities, step,
+                                 ptexAdjacency->GetNumFaces(),
+                                 (const int *)ptexAdjacency->GetAdjacencyBuffer(),
+                                 patchCoords,
+                                 patchMap->GetNumFaces(),
+                                 (const int *)patchMap->GetFaceBuffer(),
+                                 (const unsigned int *)patchMap->GetNodeBuffer(),
+                                 (const int *)patchMap->GetHandleBuffer(),
+                                 deviceContext);
+    }
+
+    /// \brief Static surface sample function which takes the CUDA memory of
+    ///        the buffers of a CudaPtexAdjacency and of a CudaPatchMap
+    ///
+    static bool AdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        int numPtexFaces,
+        const int *adjacencyBuffer,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer,
+        void *deviceContext = NULL);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Keyframe blending
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static keyframe blending function. Interpolates the
+    ///        control vertices of an animation between two of its keyframes
+    ///        on the device (see CpuEvaluator::BlendKeyframes) : keyframes
+    ///        uploaded once are played back without per-frame transfers.
+    ///
+    /// @param keyBuffer      Input buffer of the keyframes : vertex i of
+    ///                       keyframe k is vertex (k * numVertices + i).
+    ///                       must have BindCudaBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param keyDesc        vertex buffer descriptor for the keyframes
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCudaBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numVertices    number of vertices of a keyframe
+    ///
+    /// @param key0, key1     keyframes to blend
+    ///
+    /// @param weight         blend weight of key1 (0 returns key0)
+    ///
+    /// @param deviceContext  cudaStream_t of the launch (optional: the
+    ///                       default stream if NULL)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool BlendKeyframes(
+        SRC_BUFFER *keyBuffer, BufferDescriptor const &keyDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight,
+        CudaEvaluator const *instance,
+        void *deviceContext) {
+
+        (void)instance;   // unused
+        return BlendKeyframes(keyBuffer->BindCudaBuffer(), keyDesc,
+                              dstBuffer->BindCudaBuffer(), dstDesc,
+                              numVertices, key0, key1, weight,
+                              deviceContext);
+    }
+
+    /// \brief Static keyframe blending function which takes CUDA memory
+    ///        for input and output
+    ///
+    static bool BlendKeyframes(
+        const float *keys, BufferDescriptor const &keyDesc,
+        float *dst, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight,
+        void *deviceContext = NULL);
 
     /// ----------------------------------------------------------------------
     ///
     ///   Other methods
     ///
     /// ----------------------------------------------------------------------
+
+    /// \brief Waits for the kernels launched on a stream to complete
+    ///
+    /// @param deviceContext  cudaStream_t to wait for (optional: all the
+    ///                       streams of the device if NULL)
+    ///
     static void Synchronize(void *deviceContext = NULL);
+
+    /// \brief Returns true if the kernels launched on a stream have
+    ///        completed, without blocking (to overlap host work with the
+    ///        evaluation)
+    ///
+    /// @param deviceContext  cudaStream_t to query (optional: the default
+    ///                       stream if NULL)
+    ///
+    static bool IsComplete(void *deviceContext = NULL);
 };
 
 
@@ -25,11 +25,13 @@
 #include "../osd/cudaGLVertexBuffer.h"
 #include "../osd/opengl.h"
 #include "../far/error.h"
+#include "../far/profile.h"
 
 #include <cuda_runtime.h>
 #include <cuda_gl_interop.h>
 
 #include <cassert>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -63,6 +65,8 @@ CudaGLVertexBuffer::UpdateData(const float *src,
                                int startVertex, int numVertices,
                                void * /*deviceContext*/) {
 
+    OPENSUBDIV_PROFILE_ZONE("CudaGLVertexBuffer::UpdateData");
+
     map();
     cudaError_t err = cudaMemcpy((float*)_devicePtr + _numElements * startVertex,
                                  src,
@@ -100,6 +104,68 @@ CudaGLVertexBuffer::BindVBO(void * /*deviceContext*/) {
     return _vbo;
 }
 
+bool
+CudaGLVertexBuffer::MapBuffers(CudaGLVertexBuffer * const * buffers,
+                               int numBuffers) {
+
+    std::vector<CudaGLVertexBuffer *> unmapped;
+    std::vector<cudaGraphicsResource *> resources;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i] && buffers[i]->_devicePtr == NULL) {
+            unmapped.push_back(buffers[i]);
+            resources.push_back(buffers[i]->_cudaResource);
+        }
+    }
+    if (unmapped.empty()) return true;
+
+    cudaError_t err = cudaGraphicsMapResources(
+        (int)resources.size(), &resources[0], 0);
+    if (err != cudaSuccess) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "CudaGLVertexBuffer::MapBuffers failed.\n%s\n",
+                   cudaGetErrorString(err));
+        return false;
+    }
+    for (int i = 0; i < (int)unmapped.size(); ++i) {
+        size_t num_bytes;
+        void *ptr;
+        err = cudaGraphicsResourceGetMappedPointer(&ptr, &num_bytes,
+                                                   resources[i]);
+        if (err != cudaSuccess) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "CudaGLVertexBuffer::MapBuffers failed.\n%s\n",
+                       cudaGetErrorString(err));
+            return false;
+        }
+        unmapped[i]->_devicePtr = ptr;
+    }
+    return true;
+}
+
+bool
+CudaGLVertexBuffer::UnmapBuffers(CudaGLVertexBuffer * const * buffers,
+                                 int numBuffers) {
+
+    std::vector<cudaGraphicsResource *> resources;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i] && buffers[i]->_devicePtr) {
+            resources.push_back(buffers[i]->_cudaResource);
+            buffers[i]->_devicePtr = NULL;
+        }
+    }
+    if (resources.empty()) return true;
+
+    cudaError_t err = cudaGraphicsUnmapResources(
+        (int)resources.size(), &resources[0], 0);
+    if (err != cudaSuccess) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "CudaGLVertexBuffer::UnmapBuffers failed.\n%s\n",
+                   cudaGetErrorString(err));
+        return false;
+    }
+    return true;
+}
+
 bool
 CudaGLVertexBuffer::allocate() {
 
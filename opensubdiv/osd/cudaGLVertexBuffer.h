@@ -76,6 +76,18 @@ public:
     /// resource, it will be unmapped back to GL.
     GLuint BindVBO(void *deviceContext = NULL);
 
+    /// Maps the GL buffers of 'buffers' (NULL entries and buffers already
+    /// mapped are skipped) to cuda resources in a single call, e.g. once per
+    /// frame for all meshes before their refinement, rather than on each
+    /// BindCudaBuffer. Returns false if error.
+    static bool MapBuffers(CudaGLVertexBuffer * const * buffers,
+                           int numBuffers);
+
+    /// Unmaps the cuda resources of 'buffers' back to GL in a single call,
+    /// e.g. once per frame before drawing. Returns false if error.
+    static bool UnmapBuffers(CudaGLVertexBuffer * const * buffers,
+                             int numBuffers);
+
 protected:
     /// Constructor.
     CudaGLVertexBuffer(int numElements, int numVertices);
@@ -0,0 +1,89 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cudaGpuTimer.h"
+
+#include <cuda_runtime.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CudaGpuTimer::CudaGpuTimer() : _recorded(false) {
+    _events[0] = _events[1] = NULL;
+}
+
+CudaGpuTimer::~CudaGpuTimer() {
+    for (int i = 0; i < 2; ++i) {
+        if (_events[i]) cudaEventDestroy(static_cast<cudaEvent_t>(_events[i]));
+    }
+}
+
+void
+CudaGpuTimer::Begin(void * deviceContext) {
+    if (_events[0] == NULL) {
+        for (int i = 0; i < 2; ++i) {
+            cudaEvent_t event = NULL;
+            cudaEventCreate(&event);
+            _events[i] = event;
+        }
+    }
+    _recorded = false;
+    cudaEventRecord(static_cast<cudaEvent_t>(_events[0]),
+                    static_cast<cudaStream_t>(deviceContext));
+}
+
+void
+CudaGpuTimer::End(void * deviceContext) {
+    if (_events[1] == NULL) return;
+
+    _recorded = cudaEventRecord(static_cast<cudaEvent_t>(_events[1]),
+        static_cast<cudaStream_t>(deviceContext)) == cudaSuccess;
+}
+
+double
+CudaGpuTimer::GetElapsedTime(bool wait) {
+    if (not _recorded) return -1.0;
+
+    cudaEvent_t end = static_cast<cudaEvent_t>(_events[1]);
+    if (wait) {
+        cudaEventSynchronize(end);
+    } else if (cudaEventQuery(end) != cudaSuccess) {
+        return -1.0;
+    }
+
+    float milliseconds = 0.0f;
+    if (cudaEventElapsedTime(&milliseconds,
+            static_cast<cudaEvent_t>(_events[0]), end) != cudaSuccess) {
+        return -1.0;
+    }
+    return milliseconds;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,129 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cudaGraph.h"
+
+#include <cuda_runtime.h>
+
+#include "../far/error.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CudaGraph::CudaGraph() : _graph(NULL), _graphExec(NULL) {
+}
+
+CudaGraph::~CudaGraph() {
+    Clear();
+}
+
+void
+CudaGraph::Clear() {
+    if (_graphExec) {
+        cudaGraphExecDestroy(static_cast<cudaGraphExec_t>(_graphExec));
+        _graphExec = NULL;
+    }
+    if (_graph) {
+        cudaGraphDestroy(static_cast<cudaGraph_t>(_graph));
+        _graph = NULL;
+    }
+}
+
+bool
+CudaGraph::BeginCapture(void * deviceContext) {
+    if (deviceContext == NULL) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in CudaGraph::BeginCapture() -- "
+            "the default stream cannot be captured.");
+        return false;
+    }
+
+    // thread local mode : other threads may keep issuing operations into
+    // their own streams during the capture
+    return cudaStreamBeginCapture(static_cast<cudaStream_t>(deviceContext),
+        cudaStreamCaptureModeThreadLocal) == cudaSuccess;
+}
+
+bool
+CudaGraph::EndCapture(void * deviceContext) {
+    cudaGraph_t graph = NULL;
+    if (cudaStreamEndCapture(static_cast<cudaStream_t>(deviceContext),
+            &graph) != cudaSuccess or graph == NULL) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in CudaGraph::EndCapture() -- "
+            "an operation of the sequence could not be captured.");
+        return false;
+    }
+
+    // a sequence recaptured with other buffers updates the parameters of
+    // the instantiated graph
+    if (_graphExec) {
+#if CUDART_VERSION >= 12000
+        cudaGraphExecUpdateResultInfo resultInfo;
+        cudaError_t err = cudaGraphExecUpdate(
+            static_cast<cudaGraphExec_t>(_graphExec), graph, &resultInfo);
+#else
+        cudaGraphExecUpdateResult result;
+        cudaGraphNode_t errorNode;
+        cudaError_t err = cudaGraphExecUpdate(
+            static_cast<cudaGraphExec_t>(_graphExec), graph, &errorNode,
+            &result);
+#endif
+        if (err == cudaSuccess) {
+            cudaGraphDestroy(static_cast<cudaGraph_t>(_graph));
+            _graph = graph;
+            return true;
+        }
+        // the error of the failed update is not sticky
+        cudaGetLastError();
+    }
+
+    Clear();
+
+    cudaGraphExec_t graphExec = NULL;
+    if (cudaGraphInstantiate(&graphExec, graph, NULL, NULL, 0) !=
+            cudaSuccess) {
+        cudaGraphDestroy(graph);
+        return false;
+    }
+    _graph = graph;
+    _graphExec = graphExec;
+    return true;
+}
+
+bool
+CudaGraph::Launch(void * deviceContext) const {
+    if (_graphExec == NULL) return false;
+
+    return cudaGraphLaunch(static_cast<cudaGraphExec_t>(_graphExec),
+        static_cast<cudaStream_t>(deviceContext)) == cudaSuccess;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,118 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CUDA_GRAPH_H
+#define OPENSUBDIV3_OSD_CUDA_GRAPH_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Sequence of CUDA operations captured once and replayed every frame
+///
+/// The uploads, stencil and patch evaluations issued into a stream between
+/// BeginCapture() and EndCapture() are recorded as a CUDA graph instead of
+/// being executed, and Launch() replays the whole sequence with a single
+/// call : the launch overhead of the many small kernels of a frame is paid
+/// once for all, e.g. for the sequences of all the meshes of a scene
+/// captured into one graph.
+///
+/// \code
+///   graph.BeginCapture(stream);
+///   for (each mesh) {
+///       mesh->UpdateVertexBuffer(pinnedControlPoints, 0, numControlVertices);
+///       mesh->Refine();
+///   }
+///   graph.EndCapture(stream);
+///   ...
+///   graph.Launch(stream);   // every frame
+/// \endcode
+///
+/// The operations are replayed with the buffers captured : host sources of
+/// the uploads must be pinned (cudaMallocHost) and stay at the same address,
+/// their contents being read at each launch. When buffers are reallocated,
+/// the sequence is captured again : EndCapture() then updates the graph in
+/// place if the sequence is unchanged but for its buffers, which is cheaper
+/// than instantiating a new one.
+///
+/// \note The operations must be issued into a stream (the deviceContext of
+///       the Osd::Mesh or of the evaluator calls), and must not synchronize
+///       with the host : CudaEvaluator::EvalStencilsBatch() and the uploads
+///       without stream cannot be captured.
+///
+class CudaGraph : private NonCopyable<CudaGraph> {
+public:
+    /// \brief Constructor
+    CudaGraph();
+
+    /// \brief Destructor
+    ~CudaGraph();
+
+    /// \brief Starts capturing the operations issued into a stream
+    ///
+    /// @param deviceContext  cudaStream_t to capture (must not be NULL)
+    ///
+    bool BeginCapture(void * deviceContext);
+
+    /// \brief Ends the capture, instantiating the graph of the sequence (or
+    ///        updating the one previously instantiated)
+    ///
+    /// @param deviceContext  cudaStream_t passed to BeginCapture()
+    ///
+    bool EndCapture(void * deviceContext);
+
+    /// \brief Replays the captured sequence into a stream
+    ///
+    /// @param deviceContext  cudaStream_t to launch into (optional: the
+    ///                       default stream if NULL)
+    ///
+    bool Launch(void * deviceContext = NULL) const;
+
+    /// \brief Returns true if a sequence has been captured
+    bool IsCaptured() const { return _graphExec != NULL; }
+
+    /// \brief Releases the captured sequence
+    void Clear();
+
+private:
+    void * _graph;      // cudaGraph_t
+    void * _graphExec;  // cudaGraphExec_t
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_CUDA_GRAPH_H
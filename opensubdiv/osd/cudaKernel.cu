@@ -23,6 +23,14 @@
 //
 
 #include <assert.h>
+#include <cooperative_groups.h>
+
+#include <thrust/device_ptr.h>
+#include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
 
 // -----------------------------------------------------------------------------
 template<int N> struct DeviceVertex {
@@ -126,6 +134,260 @@ computeStencils(float const * cvs, float * dst,
     }
 }
 
+// the primvar and its derivatives in a single pass : each source vertex is
+// read once for the three sets of weights (any destination can be NULL)
+__global__ void
+computeStencilsWithDerivatives(float const * cvs,
+                               float * dst, float * du, float * dv,
+                               int length,
+                               int srcStride,
+                               int dstStride, int duStride, int dvStride,
+                               int const * sizes,
+                               int const * offsets,
+                               int const * indices,
+                               float const * weights,
+                               float const * duWeights,
+                               float const * dvWeights,
+                               int start, int end) {
+
+    int first = start + threadIdx.x + blockIdx.x*blockDim.x;
+
+    for (int i=first; i<end; i += blockDim.x * gridDim.x) {
+
+        int const * lindices = indices + offsets[i];
+
+        float * dstVert = dst ? dst + i*dstStride : NULL;
+        float * duVert  = du  ? du  + i*duStride  : NULL;
+        float * dvVert  = dv  ? dv  + i*dvStride  : NULL;
+        if (dstVert) clear(dstVert, length);
+        if (duVert)  clear(duVert, length);
+        if (dvVert)  clear(dvVert, length);
+
+        for (int j=0; j<sizes[i]; ++j) {
+
+            float const * srcVert = cvs + lindices[j]*srcStride;
+            int w = offsets[i] + j;
+
+            if (dstVert) addWithWeight(dstVert, srcVert, weights[w], length);
+            if (duVert)  addWithWeight(duVert, srcVert, duWeights[w], length);
+            if (dvVert)  addWithWeight(dvVert, srcVert, dvWeights[w], length);
+        }
+    }
+}
+
+// the instances of the batch are the rows of the grid
+__global__ void
+computeStencilsBatch(float const * cvs, float * dst,
+                     int length,
+                     int srcStride,
+                     int dstStride,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances,
+                     int const * instanceOffsets) {
+
+    int first = start + threadIdx.x + blockIdx.x*blockDim.x;
+
+    for (int k=blockIdx.y; k<numInstances; k += gridDim.y) {
+
+        float const * instanceCvs = cvs + instanceOffsets[2*k];
+        float * instanceDst = dst + instanceOffsets[2*k+1];
+
+        for (int i=first; i<end; i += blockDim.x * gridDim.x) {
+
+            int const * lindices = indices + offsets[i];
+            float const * lweights = weights + offsets[i];
+
+            float * dstVert = instanceDst + i*dstStride;
+            clear(dstVert, length);
+
+            for (int j=0; j<sizes[i]; ++j) {
+
+                float const * srcVert = instanceCvs + lindices[j]*srcStride;
+
+                addWithWeight(dstVert, srcVert, lweights[j], length);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// the stencils of a list, one thread per stencil (see CudaStencilTable for
+// the buckets of stencils)
+__global__ void
+computeStencilList(float const * cvs, float * dst,
+                   int length,
+                   int srcStride,
+                   int dstStride,
+                   int const * sizes,
+                   int const * offsets,
+                   int const * indices,
+                   float const * weights,
+                   int const * stencils, int numStencils) {
+
+    int first = threadIdx.x + blockIdx.x*blockDim.x;
+
+    for (int n=first; n<numStencils; n += blockDim.x * gridDim.x) {
+
+        int i = stencils[n];
+
+        int const * lindices = indices + offsets[i];
+        float const * lweights = weights + offsets[i];
+
+        float * dstVert = dst + i*dstStride;
+        clear(dstVert, length);
+
+        for (int j=0; j<sizes[i]; ++j) {
+
+            float const * srcVert = cvs + lindices[j]*srcStride;
+
+            addWithWeight(dstVert, srcVert, lweights[j], length);
+        }
+    }
+}
+
+// the passes of a table in a single launch (see CudaEvalStencilPasses) : the
+// grid is synchronized between passes, the stencils of a pass referring to
+// the vertices interpolated by the previous ones
+__global__ void
+computeStencilPasses(float const * cvs, float * dst,
+                     int length,
+                     int srcStride,
+                     int dstStride,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int const * passOffsets, int numPasses,
+                     int numStencils) {
+
+    cooperative_groups::grid_group grid = cooperative_groups::this_grid();
+
+    int first = threadIdx.x + blockIdx.x*blockDim.x;
+
+    for (int pass=0; pass<numPasses; ++pass) {
+
+        int start = passOffsets[pass],
+            end = (pass+1 < numPasses) ? passOffsets[pass+1] : numStencils;
+
+        for (int i=start+first; i<end; i += blockDim.x * gridDim.x) {
+
+            int const * lindices = indices + offsets[i];
+            float const * lweights = weights + offsets[i];
+
+            float * dstVert = dst + i*dstStride;
+            clear(dstVert, length);
+
+            for (int j=0; j<sizes[i]; ++j) {
+
+                float const * srcVert = cvs + lindices[j]*srcStride;
+
+                addWithWeight(dstVert, srcVert, lweights[j], length);
+            }
+        }
+        __threadfence();
+        grid.sync();
+    }
+}
+
+__device__ inline void zero(float & x) { x = 0.0f; }
+__device__ inline void zero(float4 & x) { x = make_float4(0.f, 0.f, 0.f, 0.f); }
+
+__device__ inline void madd(float & x, float w, float s) { x += w * s; }
+__device__ inline void madd(float4 & x, float w, float4 s) {
+    x.x += w*s.x; x.y += w*s.y; x.z += w*s.z; x.w += w*s.w;
+}
+
+__device__ inline void add(float & x, float s) { x += s; }
+__device__ inline void add(float4 & x, float4 s) {
+    x.x += s.x; x.y += s.y; x.z += s.z; x.w += s.w;
+}
+
+// the large stencils of a list, one warp per stencil : the indices and weights
+// are staged in shared memory a warp wide tile at a time, the lanes of the
+// warp being split into groups of 'length' lanes (one per element) which
+// accumulate every other term of the tile. The groups are then summed
+// through shared memory. T is float, or float4 for interleaved primvars of
+// a multiple of 4 elements (length and strides are then counted in float4).
+template <class T, int NUM_WARPS_PER_BLOCK>
+__global__ void
+computeStencilListWarp(T const * __restrict cvs, T * dst,
+                       int length,
+                       int srcStride,
+                       int dstStride,
+                       int const * __restrict sizes,
+                       int const * __restrict offsets,
+                       int const * __restrict indices,
+                       float const * __restrict weights,
+                       int const * __restrict stencils, int numStencils) {
+
+    const int WARP_SIZE = 32;
+
+    __shared__ int   smem_indices_buffer[NUM_WARPS_PER_BLOCK*WARP_SIZE];
+    __shared__ float smem_weights_buffer[NUM_WARPS_PER_BLOCK*WARP_SIZE];
+    __shared__ T     smem_sums_buffer[NUM_WARPS_PER_BLOCK*WARP_SIZE];
+
+    const int warpId = threadIdx.x / WARP_SIZE;
+    const int laneId = threadIdx.x % WARP_SIZE;
+
+    volatile int   * smem_indices = smem_indices_buffer + warpId*WARP_SIZE;
+    volatile float * smem_weights = smem_weights_buffer + warpId*WARP_SIZE;
+    T * smem_sums = smem_sums_buffer + warpId*WARP_SIZE;
+
+    // primvars wider than a warp are accumulated a warp of elements at a time
+    const int width  = min(length, WARP_SIZE);
+    const int groups = WARP_SIZE / width;
+    const int group = laneId / width, element = laneId % width;
+
+    for (int n = blockIdx.x*NUM_WARPS_PER_BLOCK + warpId; n < numStencils;
+         n += gridDim.x*NUM_WARPS_PER_BLOCK) {
+
+        int i = stencils[n];
+        int const offset_i = offsets[i], size_i = sizes[i];
+
+        for (int e0 = 0; e0 < length; e0 += width) {
+            int e = e0 + element;
+            bool active = (group < groups) && (e < length);
+
+            T x;
+            zero(x);
+
+            for (int j = 0; j < size_i; j += WARP_SIZE) {
+                int j_it = j + laneId;
+
+                // coalesced load of a tile of the stencil
+                __syncwarp();
+                smem_indices[laneId] = j_it < size_i ? indices[offset_i+j_it] : 0;
+                smem_weights[laneId] = j_it < size_i ? weights[offset_i+j_it] : 0.f;
+                __syncwarp();
+
+                int k_end = min(WARP_SIZE, size_i - j);
+                if (active) {
+                    for (int k = group; k < k_end; k += groups) {
+                        madd(x, smem_weights[k],
+                             cvs[smem_indices[k]*srcStride + e]);
+                    }
+                }
+            }
+
+            // sum the groups
+            smem_sums[laneId] = x;
+            __syncwarp();
+            if (group == 0 && e < length) {
+                for (int g = 1; g < groups; ++g) {
+                    add(x, smem_sums[g*width + element]);
+                }
+                dst[i*dstStride + e] = x;
+            }
+            __syncwarp();
+        }
+    }
+}
+
 // -----------------------------------------------------------------------------
 
 #define USE_NVIDIA_OPTIMIZATION
@@ -338,13 +600,95 @@ void normalizePatchCoord(unsigned int patchBits, float *u, float *v) {
     *v = (*v - pv) / frac;
 }
 
+// primvar classes evaluated by computePatches
+enum PatchEvalMode {
+    EVAL_VERTEX = 0,
+    EVAL_FACE_VARYING,
+    EVAL_VARYING,       // bilinear on the corners of the patches
+    EVAL_FACE_UNIFORM   // copy of the value of the base face (ptex face)
+};
+
+// corners of the patches in their control vertices, for varying evaluation
+__device__ inline int
+getPatchCorner(int patchType, int corner) {
+    const int regularCorners[4] = { 5, 6, 10, 9 };
+    const int gregoryBasisCorners[4] = { 0, 5, 10, 15 };
+    return (patchType == 6) ? regularCorners[corner] :
+           (patchType == 9) ? gregoryBasisCorners[corner] : corner;
+}
+
+// displacement texture of the limit points (see Osd::CpuDisplacementTexture)
+struct DisplacementTexture {
+    const int *faces;       // first texel and resolution in u and v per face
+    const float *texels;
+    int numFaces;
+    int numChannels;        // 1 (along the normal) or 3 (tangent frame)
+    float scale;
+};
+
+static const DisplacementTexture noDisplacement = { NULL, NULL, 0, 0, 0.0f };
+
+// samples the texels of a face bilinearly, clamped to the face
+__device__ void
+sampleDisplacement(DisplacementTexture const &texture,
+                   int face, float u, float v, float *d) {
+    d[0] = d[1] = d[2] = 0.0f;
+    if (face < 0 || face >= texture.numFaces) return;
+
+    const int *faceTexels = texture.faces + 3 * face;
+    int uRes = faceTexels[1], vRes = faceTexels[2];
+
+    float x = fminf(fmaxf(u * uRes - 0.5f, 0.0f), (float)(uRes - 1));
+    float y = fminf(fmaxf(v * vRes - 0.5f, 0.0f), (float)(vRes - 1));
+    int x0 = (int)x, x1 = min(x0 + 1, uRes - 1);
+    int y0 = (int)y, y1 = min(y0 + 1, vRes - 1);
+    float fx = x - (float)x0, fy = y - (float)y0;
+
+    int n = texture.numChannels;
+    const float *texels = texture.texels + faceTexels[0] * n;
+    for (int k = 0; k < n; ++k) {
+        d[k] = (1.0f - fy) * ((1.0f - fx) * texels[(y0 * uRes + x0) * n + k] +
+                                      fx  * texels[(y0 * uRes + x1) * n + k]) +
+                       fy  * ((1.0f - fx) * texels[(y1 * uRes + x0) * n + k] +
+                                      fx  * texels[(y1 * uRes + x1) * n + k]);
+    }
+}
+
+// displaces a point along the normal or in the tangent frame of the surface
+__device__ void
+displacePoint(float *p, const float *du, const float *dv, const float *d,
+              int numChannels, float scale) {
+    float n[3] = { du[1] * dv[2] - du[2] * dv[1],
+                   du[2] * dv[0] - du[0] * dv[2],
+                   du[0] * dv[1] - du[1] * dv[0] };
+    float nLength = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (nLength == 0.0f) return;
+    for (int k = 0; k < 3; ++k) n[k] /= nLength;
+
+    if (numChannels == 1) {
+        for (int k = 0; k < 3; ++k) p[k] += scale * d[0] * n[k];
+        return;
+    }
+    float tLength = sqrtf(du[0] * du[0] + du[1] * du[1] + du[2] * du[2]);
+    if (tLength == 0.0f) return;
+    float t[3] = { du[0] / tLength, du[1] / tLength, du[2] / tLength };
+    float b[3] = { n[1] * t[2] - n[2] * t[1],
+                   n[2] * t[0] - n[0] * t[2],
+                   n[0] * t[1] - n[1] * t[0] };
+    for (int k = 0; k < 3; ++k) {
+        p[k] += scale * (d[0] * t[k] + d[1] * b[k] + d[2] * n[k]);
+    }
+}
+
 __global__ void
 computePatches(const float *src, float *dst, float *dstDu, float *dstDv,
                int length, int srcStride, int dstStride, int dstDuStride, int dstDvStride,
                int numPatchCoords, const PatchCoord *patchCoords,
                const PatchArray *patchArrayBuffer,
                const int *patchIndexBuffer,
-               const PatchParam *patchParamBuffer) {
+               const PatchParam *patchParamBuffer,
+               int evalMode,
+               DisplacementTexture displacement) {
 
     int first = threadIdx.x + blockIdx.x * blockDim.x;
 
@@ -354,11 +698,32 @@ computePatches(const float *src, float *dst, float *dstDu, float *dstDv,
 
     for (int i = first; i < numPatchCoords; i += blockDim.x * gridDim.x) {
 
-        PatchCoord const &coord = patchCoords[i];
+        PatchCoord coord = patchCoords[i];
+        if (evalMode == EVAL_FACE_UNIFORM) {
+            // note: the face id of the PatchParam is that of the ptex face
+            float * dstVert = dst + i * dstStride;
+            clear(dstVert, length);
+            if (coord.patchIndex >= 0) {
+                int face = patchParamBuffer[coord.patchIndex].field0 & 0xfffffff;
+                addWithWeight(dstVert, src + face * srcStride, 1.0f, length);
+            }
+            continue;
+        }
+        if (evalMode == EVAL_FACE_VARYING && coord.patchIndex >= 0) {
+            // map the vertex patch coord to the patches of the face-varying
+            // channel (see CpuGetFVarPatchCoords) : the patches of bicubic
+            // channels which are not regular use the second, bilinear array
+            bool bicubic = (patchArrayBuffer[0].patchType == 6);
+            unsigned int bits = patchParamBuffer[coord.patchIndex].field1;
+            coord.arrayIndex = (bicubic && !((bits >> 5) & 0x1)) ? 1 : 0;
+            coord.vertIndex = coord.patchIndex * (bicubic ? 16 : 4);
+        }
         PatchArray const &array = patchArrayBuffer[coord.arrayIndex];
 
-        int patchType = 6; // array.patchType XXX: REGULAR only for now.
-        int numControlVertices = 16;
+        // XXX: REGULAR only for now, besides bilinear face-varying patches
+        //      and varying evaluation (bilinear on the corners of any patch)
+        int patchType = (array.patchType == 3 || evalMode == EVAL_VARYING) ? 3 : 6;
+        int numControlVertices = (patchType == 3) ? 4 : 16;
         // note: patchIndex is absolute.
         unsigned int patchBits = patchParamBuffer[coord.patchIndex].field1;
 
@@ -385,12 +750,37 @@ computePatches(const float *src, float *dst, float *dstDu, float *dstDv,
                     wDt[4*k+l] = sWeights[l]  * dtWeights[k] * dScale;
                 }
             }
+        } else if (patchType == 3) {
+            float sC = 1.0f - s, tC = 1.0f - t;
+
+            wP[0] = sC * tC;
+            wP[1] =  s * tC;
+            wP[2] =  s * t;
+            wP[3] = sC * t;
+
+            wDs[0] = -tC * dScale;
+            wDs[1] =  tC * dScale;
+            wDs[2] =   t * dScale;
+            wDs[3] =  -t * dScale;
+
+            wDt[0] = -sC * dScale;
+            wDt[1] =  -s * dScale;
+            wDt[2] =   s * dScale;
+            wDt[3] =  sC * dScale;
         } else {
             // TODO: Gregory Basis.
             continue;
         }
         const int *cvs = patchIndexBuffer + array.indexBase + coord.vertIndex;
 
+        int corners[4];
+        if (evalMode == EVAL_VARYING) {
+            for (int j = 0; j < 4; ++j) {
+                corners[j] = cvs[getPatchCorner(array.patchType, j)];
+            }
+            cvs = corners;
+        }
+
         float * dstVert = dst + i * dstStride;
         clear(dstVert, length);
         for (int j = 0; j < numControlVertices; ++j) {
@@ -413,6 +803,116 @@ computePatches(const float *src, float *dst, float *dstDu, float *dstDv,
                 addWithWeight(d, srcVert, wDt[j], length);
             }
         }
+
+        // displacement of the point (its first 3 components), in the same
+        // pass over the control vertices for the derivatives of the point
+        if (displacement.texels && evalMode == EVAL_VERTEX &&
+            coord.patchIndex >= 0) {
+            float pDu[3] = { 0.0f, 0.0f, 0.0f }, pDv[3] = { 0.0f, 0.0f, 0.0f };
+            for (int j = 0; j < numControlVertices; ++j) {
+                const float * srcVert = src + cvs[j] * srcStride;
+                addWithWeight(pDu, srcVert, wDs[j], 3);
+                addWithWeight(pDv, srcVert, wDt[j], 3);
+            }
+            // note: the face id of the PatchParam is that of the ptex face
+            int face = patchParamBuffer[coord.patchIndex].field0 & 0xfffffff;
+            float d[3];
+            sampleDisplacement(displacement, face, coord.s, coord.t, d);
+            displacePoint(dstVert, pDu, pDv, d,
+                          displacement.numChannels, displacement.scale);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Factorization of the stencils of a level (see CudaStencilTableFactory) :
+// the stencils of the level refer to the vertices of the previous level, or
+// to control vertices, and the stencils of the previous level are already
+// factorized. Each term of a stencil is expanded into the terms of the
+// stencil of its vertex, keyed by (stencil, control vertex), then the terms
+// sorted by key are merged.
+
+__device__ inline int
+getSourceStencilSize(int index, int numControlVerts, int prevFirstVertex,
+                     int const * prevSizes) {
+    return (index < numControlVerts) ? 1 : prevSizes[index - prevFirstVertex];
+}
+
+__global__ void
+countFactorizedStencils(int numStencils,
+                        int const * sizes, int const * offsets,
+                        int const * indices,
+                        int numControlVerts, int prevFirstVertex,
+                        int const * prevSizes,
+                        int * bounds) {
+
+    int first = threadIdx.x + blockIdx.x * blockDim.x;
+
+    for (int i = first; i < numStencils; i += blockDim.x * gridDim.x) {
+        int const * lindices = indices + offsets[i];
+
+        int bound = 0;
+        for (int j = 0; j < sizes[i]; ++j) {
+            bound += getSourceStencilSize(lindices[j], numControlVerts,
+                                          prevFirstVertex, prevSizes);
+        }
+        bounds[i] = bound;
+    }
+}
+
+__global__ void
+expandFactorizedStencils(int numStencils,
+                         int const * sizes, int const * offsets,
+                         int const * indices, float const * weights,
+                         int numControlVerts, int prevFirstVertex,
+                         int const * prevSizes, int const * prevOffsets,
+                         int const * prevIndices, float const * prevWeights,
+                         int const * termOffsets,
+                         unsigned long long * keys, float * termWeights) {
+
+    int first = threadIdx.x + blockIdx.x * blockDim.x;
+
+    for (int i = first; i < numStencils; i += blockDim.x * gridDim.x) {
+        int const * lindices = indices + offsets[i];
+        float const * lweights = weights + offsets[i];
+
+        unsigned long long stencilKey = ((unsigned long long)i) << 32;
+
+        int term = termOffsets[i];
+        for (int j = 0; j < sizes[i]; ++j) {
+            int index = lindices[j];
+            float weight = lweights[j];
+
+            if (index < numControlVerts) {
+                keys[term] = stencilKey | (unsigned int)index;
+                termWeights[term] = weight;
+                ++term;
+                continue;
+            }
+
+            int src = index - prevFirstVertex;
+            int const * srcIndices = prevIndices + prevOffsets[src];
+            float const * srcWeights = prevWeights + prevOffsets[src];
+            for (int k = 0; k < prevSizes[src]; ++k, ++term) {
+                keys[term] = stencilKey | (unsigned int)srcIndices[k];
+                termWeights[term] = weight * srcWeights[k];
+            }
+        }
+    }
+}
+
+__global__ void
+splitFactorizedStencils(int numTerms,
+                        unsigned long long const * keys,
+                        int * sizes, int * indices) {
+
+    int first = threadIdx.x + blockIdx.x * blockDim.x;
+
+    for (int i = first; i < numTerms; i += blockDim.x * gridDim.x) {
+        unsigned long long key = keys[i];
+        indices[i] = (int)(key & 0xffffffffULL);
+        atomicAdd(&sizes[(int)(key >> 32)], 1);
     }
 }
 
@@ -422,7 +922,7 @@ computePatches(const float *src, float *dst, float *dstDu, float *dstDv,
 
 #define OPT_KERNEL(NUM_ELEMENTS, KERNEL, X, Y, ARG) \
     if (length==NUM_ELEMENTS && srcStride==length && dstStride==length) {   \
-        KERNEL<NUM_ELEMENTS><<<X,Y>>>ARG;             \
+        KERNEL<NUM_ELEMENTS><<<X,Y,0,stream>>>ARG;    \
         return;                                     \
     }
 
@@ -430,11 +930,246 @@ computePatches(const float *src, float *dst, float *dstDu, float *dstDv,
 #define OPT_KERNEL_NVIDIA(NUM_ELEMENTS, KERNEL, X, Y, ARG) \
     if (length==NUM_ELEMENTS && srcStride==length && dstStride==length) {   \
         int gridDim = min(X, (end-start+Y-1)/Y); \
-        KERNEL<NUM_ELEMENTS, Y><<<gridDim, Y>>>ARG; \
+        KERNEL<NUM_ELEMENTS, Y><<<gridDim, Y, 0, stream>>>ARG; \
         return;                                     \
     }
 #endif
 
+// ---------------------------------------------------------------------------
+
+__device__ PatchCoord
+findPatchCoord(int faceId, float u, float v,
+               int numFaces,
+               const int *faceBuffer,
+               const unsigned int *nodeBuffer,
+               const int *handleBuffer) {
+
+    PatchCoord coord;
+    coord.arrayIndex = 0;
+    coord.patchIndex = -1;
+    coord.vertIndex = 0;
+    coord.s = u;
+    coord.t = v;
+
+    if (faceId >= 0 && faceId < numFaces) {
+
+        // direct lookup of the grid cell (see Far::PatchMap::findCell)
+        int res = 1 << faceBuffer[2*faceId+1];
+
+        float scale = (float)res,
+              s = coord.s,
+              t = coord.t;
+
+        int col = min((int)(s * scale), res-1),
+            row = min((int)(t * scale), res-1);
+
+        s -= (float)col / scale;
+        t -= (float)row / scale;
+
+        float half = 0.5f / scale;
+
+        unsigned int node =
+            nodeBuffer[faceBuffer[2*faceId] + row*res + col];
+
+        // descend the quadtree nodes
+        while ((node & 3) == 1) {
+            int quadrant;
+            if (s < half) {
+                quadrant = (t < half) ? 0 : 1;
+            } else {
+                quadrant = (t < half) ? 3 : 2;
+                s -= half;
+            }
+            if (t >= half) t -= half;
+
+            node = nodeBuffer[(node >> 2) + quadrant];
+            half *= 0.5f;
+        }
+
+        if ((node & 3) == 3) {
+            const int *handle = handleBuffer + 3*(node >> 2);
+            coord.arrayIndex = handle[0];
+            coord.patchIndex = handle[1];
+            coord.vertIndex  = handle[2];
+        }
+    }
+    return coord;
+}
+
+__global__ void
+computePatchCoords(int numLocations,
+                   const int *faceIds, const float *u, const float *v,
+                   PatchCoord *patchCoords,
+                   int numFaces,
+                   const int *faceBuffer,
+                   const unsigned int *nodeBuffer,
+                   const int *handleBuffer) {
+
+    int first = threadIdx.x + blockIdx.x * blockDim.x;
+
+    for (int i = first; i < numLocations; i += blockDim.x * gridDim.x) {
+        patchCoords[i] = findPatchCoord(faceIds[i], u[i], v[i], numFaces,
+                                        faceBuffer, nodeBuffer, handleBuffer);
+    }
+}
+
+// returns true if a location of a quad face is in the domain of a sub-patch
+// (see Far::PatchMap::isInPatch)
+__device__ bool
+isInPatch(const PatchParam &param, int faceId, float u, float v) {
+
+    if ((int)(param.field0 & 0xfffffff) != faceId) return false;
+
+    int depth = param.field1 & 0xf;
+    if ((param.field1 >> 4) & 1) --depth;   // non-quad root
+
+    float frac = 1.0f / (float)(1 << depth),
+          u0 = (float)((param.field1 >> 22) & 0x3ff) * frac,
+          v0 = (float)((param.field1 >> 12) & 0x3ff) * frac,
+          u1 = u0 + frac,
+          v1 = v0 + frac;
+
+    return (u >= u0) && (v >= v0) &&
+           ((u < u1) || (u1 >= 1.0f)) && ((v < v1) || (v1 >= 1.0f));
+}
+
+__global__ void
+updatePatchCoords(int numLocations,
+                  const int *faceIds, const float *u, const float *v,
+                  PatchCoord *patchCoords,
+                  int numFaces,
+                  const int *faceBuffer,
+                  const unsigned int *nodeBuffer,
+                  const int *handleBuffer,
+                  const PatchParam *patchParamBuffer) {
+
+    int first = threadIdx.x + blockIdx.x * blockDim.x;
+
+    for (int i = first; i < numLocations; i += blockDim.x * gridDim.x) {
+        PatchCoord coord = patchCoords[i];
+        int faceId = faceIds[i];
+
+        if (coord.patchIndex >= 0 && faceId >= 0 && faceId < numFaces &&
+            (nodeBuffer[faceBuffer[2*faceId]] & 3) != 2 &&
+            isInPatch(patchParamBuffer[coord.patchIndex], faceId, u[i], v[i])) {
+            coord.s = u[i];
+            coord.t = v[i];
+        } else {
+            coord = findPatchCoord(faceId, u[i], v[i], numFaces,
+                                   faceBuffer, nodeBuffer, handleBuffer);
+        }
+        patchCoords[i] = coord;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+__device__ void
+swapFloats(float &a, float &b) {
+    float tmp = a; a = b; b = tmp;
+}
+
+// Moves the (faceId, u, v) samples by their velocities, warping them across
+// the edges of their ptex faces (see Osd::CpuAdvectSamples), and maps them
+// to PatchCoords (see computePatchCoords) in the same kernel
+__global__ void
+advectPatchCoords(int numSamples,
+                  int *faceIds, float *u, float *v, float2 *velocities,
+                  float step,
+                  int numPtexFaces,
+                  const int *adjacencyBuffer,
+                  PatchCoord *patchCoords,
+                  int numFaces,
+                  const int *faceBuffer,
+                  const unsigned int *nodeBuffer,
+                  const int *handleBuffer) {
+
+    int first = threadIdx.x + blockIdx.x * blockDim.x;
+
+    for (int i = first; i < numSamples; i += blockDim.x * gridDim.x) {
+        int face = faceIds[i];
+
+        float2 velocity = velocities[i];
+        float ds = velocity.x,
+              dt = velocity.y,
+              s = u[i],
+              t = v[i];
+
+        if (face >= 0 && face < numPtexFaces) {
+            s += ds * step;
+            t += dt * step;
+
+            int edge = -1;
+            if (s >= 1.0f) edge = 1;
+            if (s <= 0.0f) edge = 3;
+            if (t >= 1.0f) edge = 2;
+            if (t <= 0.0f) edge = 0;
+
+            if (edge >= 0) {
+                const int *adjacency = adjacencyBuffer + 5*face;
+
+                int adjFace = adjacency[edge],
+                    adjEdge = (adjacency[4] >> (2*edge)) & 3;
+
+                if (adjFace < 0 || adjFace >= numPtexFaces ||
+                    ((adjacency[4] ^ adjacencyBuffer[5*adjFace+4]) & (1 << 8))) {
+                    // bounce off the edge
+                    switch (edge) {
+                        case 0: t = -t;        dt = -dt; break;
+                        case 1: s = 2.0f - s;  ds = -ds; break;
+                        case 2: t = 2.0f - t;  dt = -dt; break;
+                        case 3: s = -s;        ds = -ds; break;
+                    }
+                } else {
+                    // warp into the frame of the adjacent face
+                    if (s <  0.0f) s += 1.0f;
+                    if (s >= 1.0f) s -= 1.0f;
+                    if (t <  0.0f) t += 1.0f;
+                    if (t >= 1.0f) t -= 1.0f;
+                    switch ((edge - adjEdge + 2) & 3) {
+                        case 1: s = 1.0f - s; ds = -ds;
+                                swapFloats(s, t); swapFloats(ds, dt); break;
+                        case 2: s = 1.0f - s; ds = -ds;
+                                t = 1.0f - t; dt = -dt; break;
+                        case 3: t = 1.0f - t; dt = -dt;
+                                swapFloats(s, t); swapFloats(ds, dt); break;
+                    }
+                    face = adjFace;
+                }
+            }
+            s = fminf(fmaxf(s, 0.0f), 1.0f);
+            t = fminf(fmaxf(t, 0.0f), 1.0f);
+
+            faceIds[i] = face;
+            u[i] = s;
+            v[i] = t;
+            velocities[i] = make_float2(ds, dt);
+        }
+
+        patchCoords[i] = findPatchCoord(face, s, t, numFaces,
+                                        faceBuffer, nodeBuffer, handleBuffer);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+__global__ void
+blendKeyframes(float const *key0, float const *key1, float *dst,
+               int length, int keyStride, int dstStride,
+               int numVertices, float weight) {
+
+    for (int i = threadIdx.x + blockIdx.x*blockDim.x;
+         i < numVertices*length; i += blockDim.x * gridDim.x) {
+        int vertex = i / length,
+            element = i - vertex * length;
+
+        float p0 = key0[vertex*keyStride + element],
+              p1 = key1[vertex*keyStride + element];
+
+        dst[vertex*dstStride + element] = p0 + (p1 - p0) * weight;
+    }
+}
+
 extern "C" {
 
 void CudaEvalStencils(
@@ -442,7 +1177,8 @@ void CudaEvalStencils(
     int length, int srcStride, int dstStride,
     const int * sizes, const int * offsets, const int * indices,
     const float * weights,
-    int start, int end) {
+    int start, int end,
+    cudaStream_t stream) {
     if (length == 0 or srcStride == 0 or dstStride == 0 or (end <= start)) {
         return;
     }
@@ -454,7 +1190,7 @@ void CudaEvalStencils(
     //                  (cvs, dst, sizes, offsets, indices, weights, start, end));
     if (length == 4 && srcStride == length && dstStride == length) {
       int gridDim = min(2048, (end-start+256-1)/256);
-      computeStencilsNv_v4<256><<<gridDim, 256>>>(
+      computeStencilsNv_v4<256><<<gridDim, 256, 0, stream>>>(
           src, dst, sizes, offsets, indices, weights, start, end);
       return;
     }
@@ -466,27 +1202,156 @@ void CudaEvalStencils(
 #endif
 
     // generic case (slow)
-    computeStencils <<<512, 32>>>(
+    computeStencils <<<512, 32, 0, stream>>>(
         src, dst, length, srcStride, dstStride,
         sizes, offsets, indices, weights, start, end);
 }
 
 // -----------------------------------------------------------------------------
 
+void CudaEvalStencilsWithDerivatives(
+    const float *src, float *dst, float *du, float *dv,
+    int length, int srcStride, int dstStride, int duStride, int dvStride,
+    const int * sizes, const int * offsets, const int * indices,
+    const float * weights, const float * duWeights, const float * dvWeights,
+    int start, int end,
+    cudaStream_t stream) {
+    if (length == 0 or srcStride == 0 or (end <= start)) {
+        return;
+    }
+
+    computeStencilsWithDerivatives <<<512, 32, 0, stream>>>(
+        src, dst, du, dv, length, srcStride, dstStride, duStride, dvStride,
+        sizes, offsets, indices, weights, duWeights, dvWeights, start, end);
+}
+
+// -----------------------------------------------------------------------------
+
+void CudaEvalStencilsBatch(
+    const float *src, float *dst,
+    int length, int srcStride, int dstStride,
+    const int * sizes, const int * offsets, const int * indices,
+    const float * weights,
+    int start, int end,
+    int numInstances, const int * instanceOffsets,
+    cudaStream_t stream) {
+    if (length == 0 or srcStride == 0 or dstStride == 0 or (end <= start) or
+        numInstances <= 0) {
+        return;
+    }
+
+    // a single launch for all the instances : blocks of stencils per
+    // instance (the rows are looped over past the limit of the grid)
+    dim3 gridDim(min(512, (end-start+32-1)/32), min(numInstances, 65535));
+    computeStencilsBatch <<<gridDim, 32, 0, stream>>>(
+        src, dst, length, srcStride, dstStride,
+        sizes, offsets, indices, weights, start, end,
+        numInstances, instanceOffsets);
+}
+
+// Returns false if the device does not support cooperative launches, in
+// which case the passes are launched one at a time by the caller.
+bool CudaEvalStencilPasses(
+    const float *src, float *dst,
+    int length, int srcStride, int dstStride,
+    const int * sizes, const int * offsets, const int * indices,
+    const float * weights,
+    const int * passOffsets, int numPasses, int numStencils,
+    cudaStream_t stream) {
+    if (length == 0 or srcStride == 0 or dstStride == 0 or numStencils == 0) {
+        return true;
+    }
+
+    int device = 0, cooperative = 0;
+    if (cudaGetDevice(&device) != cudaSuccess or
+        cudaDeviceGetAttribute(&cooperative, cudaDevAttrCooperativeLaunch,
+                               device) != cudaSuccess or
+        not cooperative) {
+        return false;
+    }
+
+    // the blocks of a cooperative launch must all be resident
+    int numSMs = 0, blocksPerSM = 0;
+    cudaDeviceGetAttribute(&numSMs, cudaDevAttrMultiProcessorCount, device);
+    cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blocksPerSM,
+        computeStencilPasses, 256, 0);
+    int numBlocks = min(numSMs * blocksPerSM, (numStencils+256-1)/256);
+    if (numBlocks <= 0) return false;
+
+    void *args[] = { (void *)&src, (void *)&dst,
+                     (void *)&length, (void *)&srcStride, (void *)&dstStride,
+                     (void *)&sizes, (void *)&offsets, (void *)&indices,
+                     (void *)&weights,
+                     (void *)&passOffsets, (void *)&numPasses,
+                     (void *)&numStencils };
+
+    return cudaLaunchCooperativeKernel((void *)computeStencilPasses,
+                                       dim3(numBlocks), dim3(256),
+                                       args, 0, stream) == cudaSuccess;
+}
+
+void CudaEvalStencilBuckets(
+    const float *src, float *dst,
+    int length, int srcStride, int dstStride,
+    const int * sizes, const int * offsets, const int * indices,
+    const float * weights,
+    const int * stencils, int numSmallStencils, int numLargeStencils,
+    cudaStream_t stream) {
+    if (length == 0 or srcStride == 0 or dstStride == 0) {
+        return;
+    }
+
+    // the small stencils first : one thread per stencil
+    if (numSmallStencils > 0) {
+        int gridDim = min(512, (numSmallStencils+32-1)/32);
+        computeStencilList <<<gridDim, 32, 0, stream>>>(
+            src, dst, length, srcStride, dstStride,
+            sizes, offsets, indices, weights,
+            stencils, numSmallStencils);
+    }
+
+    // then the large ones : one warp per stencil, 8 warps per block
+    if (numLargeStencils > 0) {
+        int gridDim = min(2048, (numLargeStencils+8-1)/8);
+        stencils += numSmallStencils;
+
+        bool vectorize = (length % 4 == 0) and
+                         (srcStride % 4 == 0) and (dstStride % 4 == 0) and
+                         ((size_t)src % sizeof(float4) == 0) and
+                         ((size_t)dst % sizeof(float4) == 0);
+        if (vectorize) {
+            computeStencilListWarp<float4, 8><<<gridDim, 256, 0, stream>>>(
+                (const float4 *)src, (float4 *)dst,
+                length/4, srcStride/4, dstStride/4,
+                sizes, offsets, indices, weights,
+                stencils, numLargeStencils);
+        } else {
+            computeStencilListWarp<float, 8><<<gridDim, 256, 0, stream>>>(
+                src, dst, length, srcStride, dstStride,
+                sizes, offsets, indices, weights,
+                stencils, numLargeStencils);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 void CudaEvalPatches(
     const float *src, float *dst,
     int length, int srcStride, int dstStride,
     int numPatchCoords, const PatchCoord *patchCoords,
     const PatchArray *patchArrayBuffer,
     const int *patchIndexBuffer,
-    const PatchParam *patchParamBuffer) {
+    const PatchParam *patchParamBuffer,
+    cudaStream_t stream) {
 
     // PERFORMANCE: not optimized at all
 
-    computePatches <<<512, 32>>>(
+    computePatches <<<512, 32, 0, stream>>>(
         src, dst, NULL, NULL, length, srcStride, dstStride, 0, 0,
         numPatchCoords, patchCoords,
-        patchArrayBuffer, patchIndexBuffer, patchParamBuffer);
+        patchArrayBuffer, patchIndexBuffer, patchParamBuffer, EVAL_VERTEX,
+        noDisplacement);
 }
 
 void CudaEvalPatchesWithDerivatives(
@@ -495,14 +1360,254 @@ void CudaEvalPatchesWithDerivatives(
     int numPatchCoords, const PatchCoord *patchCoords,
     const PatchArray *patchArrayBuffer,
     const int *patchIndexBuffer,
-    const PatchParam *patchParamBuffer) {
+    const PatchParam *patchParamBuffer,
+    cudaStream_t stream) {
 
     // PERFORMANCE: not optimized at all
 
-    computePatches <<<512, 32>>>(
+    computePatches <<<512, 32, 0, stream>>>(
         src, dst, dstDu, dstDv, length, srcStride, dstStride, dstDuStride, dstDvStride,
         numPatchCoords, patchCoords,
-        patchArrayBuffer, patchIndexBuffer, patchParamBuffer);
+        patchArrayBuffer, patchIndexBuffer, patchParamBuffer, EVAL_VERTEX,
+        noDisplacement);
+}
+
+void CudaEvalPatchesDisplaced(
+    const float *src, float *dst, float *dstDu, float *dstDv,
+    int length, int srcStride, int dstStride, int dstDuStride, int dstDvStride,
+    int numPatchCoords, const PatchCoord *patchCoords,
+    const PatchArray *patchArrayBuffer,
+    const int *patchIndexBuffer,
+    const PatchParam *patchParamBuffer,
+    const int *displacementFaces, const float *displacementTexels,
+    int numDisplacementFaces, int numDisplacementChannels,
+    float displacementScale,
+    cudaStream_t stream) {
+
+    DisplacementTexture displacement = {
+        displacementFaces, displacementTexels,
+        numDisplacementFaces, numDisplacementChannels, displacementScale };
+
+    computePatches <<<512, 32, 0, stream>>>(
+        src, dst, dstDu, dstDv, length, srcStride, dstStride, dstDuStride, dstDvStride,
+        numPatchCoords, patchCoords,
+        patchArrayBuffer, patchIndexBuffer, patchParamBuffer, EVAL_VERTEX,
+        displacement);
+}
+
+void CudaEvalPatchesFaceVarying(
+    const float *src, float *dst, float *dstDu, float *dstDv,
+    int length, int srcStride, int dstStride, int dstDuStride, int dstDvStride,
+    int numPatchCoords, const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrayBuffer,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer,
+    cudaStream_t stream) {
+
+    // PERFORMANCE: not optimized at all
+
+    computePatches <<<512, 32, 0, stream>>>(
+        src, dst, dstDu, dstDv, length, srcStride, dstStride, dstDuStride, dstDvStride,
+        numPatchCoords, patchCoords,
+        fvarPatchArrayBuffer, fvarPatchIndexBuffer, fvarPatchParamBuffer,
+        EVAL_FACE_VARYING, noDisplacement);
+}
+
+void CudaEvalPatchesVarying(
+    const float *src, float *dst, float *dstDu, float *dstDv,
+    int length, int srcStride, int dstStride, int dstDuStride, int dstDvStride,
+    int numPatchCoords, const PatchCoord *patchCoords,
+    const PatchArray *patchArrayBuffer,
+    const int *patchIndexBuffer,
+    const PatchParam *patchParamBuffer,
+    cudaStream_t stream) {
+
+    // PERFORMANCE: not optimized at all
+
+    computePatches <<<512, 32, 0, stream>>>(
+        src, dst, dstDu, dstDv, length, srcStride, dstStride, dstDuStride, dstDvStride,
+        numPatchCoords, patchCoords,
+        patchArrayBuffer, patchIndexBuffer, patchParamBuffer, EVAL_VARYING,
+        noDisplacement);
+}
+
+void CudaEvalPatchesFaceUniform(
+    const float *src, float *dst,
+    int length, int srcStride, int dstStride,
+    int numPatchCoords, const PatchCoord *patchCoords,
+    const PatchArray *patchArrayBuffer,
+    const int *patchIndexBuffer,
+    const PatchParam *patchParamBuffer,
+    cudaStream_t stream) {
+
+    computePatches <<<512, 32, 0, stream>>>(
+        src, dst, NULL, NULL, length, srcStride, dstStride, 0, 0,
+        numPatchCoords, patchCoords,
+        patchArrayBuffer, patchIndexBuffer, patchParamBuffer, EVAL_FACE_UNIFORM,
+        noDisplacement);
+}
+
+void CudaFindPatchCoords(
+    int numLocations,
+    const int *faceIds, const float *u, const float *v,
+    void *patchCoords,
+    int numFaces,
+    const int *faceBuffer,
+    const unsigned int *nodeBuffer,
+    const int *handleBuffer,
+    cudaStream_t stream) {
+
+    if (numLocations <= 0 || numFaces <= 0) return;
+
+    computePatchCoords <<<512, 32, 0, stream>>>(
+        numLocations, faceIds, u, v, (PatchCoord *)patchCoords,
+        numFaces, faceBuffer, nodeBuffer, handleBuffer);
+}
+
+void CudaUpdatePatchCoords(
+    int numLocations,
+    const int *faceIds, const float *u, const float *v,
+    void *patchCoords,
+    int numFaces,
+    const int *faceBuffer,
+    const unsigned int *nodeBuffer,
+    const int *handleBuffer,
+    const void *patchParamBuffer,
+    cudaStream_t stream) {
+
+    if (numLocations <= 0 || numFaces <= 0) return;
+
+    updatePatchCoords <<<512, 32, 0, stream>>>(
+        numLocations, faceIds, u, v, (PatchCoord *)patchCoords,
+        numFaces, faceBuffer, nodeBuffer, handleBuffer,
+        (const PatchParam *)patchParamBuffer);
+}
+
+void CudaAdvectPatchCoords(
+    int numSamples,
+    int *faceIds, float *u, float *v, float *velocities,
+    float step,
+    int numPtexFaces,
+    const int *adjacencyBuffer,
+    void *patchCoords,
+    int numFaces,
+    const int *faceBuffer,
+    const unsigned int *nodeBuffer,
+    const int *handleBuffer,
+    cudaStream_t stream) {
+
+    if (numSamples <= 0) return;
+
+    int numBlocks = min(512, (numSamples + 255) / 256);
+    advectPatchCoords <<<numBlocks, 256, 0, stream>>>(
+        numSamples, faceIds, u, v, (float2 *)velocities, step,
+        numPtexFaces, adjacencyBuffer, (PatchCoord *)patchCoords,
+        numFaces, faceBuffer, nodeBuffer, handleBuffer);
+}
+
+
+void CudaBlendKeyframes(
+    const float *key0, const float *key1, float *dst,
+    int length, int keyStride, int dstStride,
+    int numVertices, float weight,
+    cudaStream_t stream) {
+
+    if (numVertices <= 0 or length <= 0) return;
+
+    int numBlocks = min(512, (numVertices*length + 255) / 256);
+    blendKeyframes <<<numBlocks, 256, 0, stream>>>(
+        key0, key1, dst, length, keyStride, dstStride, numVertices, weight);
+}
+
+// Factorizes the stencils of a level with the factorized stencils of the
+// previous level (see countFactorizedStencils). The sizes and offsets of the
+// result are written to 'factorizedSizes' and 'factorizedOffsets', its
+// indices and weights allocated in '*factorizedIndices' and
+// '*factorizedWeights'. Returns the number of weights of the result, or -1
+// on failure.
+int CudaFactorizeStencils(
+    int numStencils,
+    const int * sizes, const int * offsets, const int * indices,
+    const float * weights,
+    int numControlVerts, int prevFirstVertex,
+    const int * prevSizes, const int * prevOffsets, const int * prevIndices,
+    const float * prevWeights,
+    int * factorizedSizes, int * factorizedOffsets,
+    int ** factorizedIndices, float ** factorizedWeights,
+    cudaStream_t stream) {
+
+    *factorizedIndices = NULL;
+    *factorizedWeights = NULL;
+    if (numStencils <= 0) return 0;
+
+    int numBlocks = min(512, (numStencils+256-1)/256);
+
+    // upper bound of the size of each stencil
+    thrust::device_vector<int> bounds(numStencils), termOffsets(numStencils);
+    countFactorizedStencils<<<numBlocks, 256, 0, stream>>>(
+        numStencils, sizes, offsets, indices,
+        numControlVerts, prevFirstVertex, prevSizes,
+        thrust::raw_pointer_cast(bounds.data()));
+    thrust::exclusive_scan(thrust::cuda::par.on(stream),
+                           bounds.begin(), bounds.end(), termOffsets.begin());
+
+    int numTerms = termOffsets.back() + bounds.back();
+
+    // expanded terms, sorted by stencil and control vertex
+    thrust::device_vector<unsigned long long> keys(numTerms);
+    thrust::device_vector<float> termWeights(numTerms);
+    expandFactorizedStencils<<<numBlocks, 256, 0, stream>>>(
+        numStencils, sizes, offsets, indices, weights,
+        numControlVerts, prevFirstVertex,
+        prevSizes, prevOffsets, prevIndices, prevWeights,
+        thrust::raw_pointer_cast(termOffsets.data()),
+        thrust::raw_pointer_cast(keys.data()),
+        thrust::raw_pointer_cast(termWeights.data()));
+    thrust::sort_by_key(thrust::cuda::par.on(stream),
+                        keys.begin(), keys.end(), termWeights.begin());
+
+    // merge the terms of the same control vertex
+    thrust::device_vector<unsigned long long> mergedKeys(numTerms);
+    thrust::device_vector<float> mergedWeights(numTerms);
+    int numWeights = (int)(thrust::reduce_by_key(
+        thrust::cuda::par.on(stream),
+        keys.begin(), keys.end(), termWeights.begin(),
+        mergedKeys.begin(), mergedWeights.begin()).first - mergedKeys.begin());
+
+    if (cudaMalloc(factorizedIndices, numWeights*sizeof(int)) != cudaSuccess or
+        cudaMalloc(factorizedWeights, numWeights*sizeof(float)) != cudaSuccess) {
+        cudaFree(*factorizedIndices);
+        *factorizedIndices = NULL;
+        *factorizedWeights = NULL;
+        return -1;
+    }
+
+    // the merged terms of each stencil are contiguous
+    cudaMemsetAsync(factorizedSizes, 0, numStencils*sizeof(int), stream);
+    splitFactorizedStencils<<<min(512, (numWeights+256-1)/256), 256, 0, stream>>>(
+        numWeights, thrust::raw_pointer_cast(mergedKeys.data()),
+        factorizedSizes, *factorizedIndices);
+    cudaMemcpyAsync(*factorizedWeights,
+                    thrust::raw_pointer_cast(mergedWeights.data()),
+                    numWeights*sizeof(float), cudaMemcpyDeviceToDevice, stream);
+    thrust::exclusive_scan(thrust::cuda::par.on(stream),
+                           thrust::device_pointer_cast(factorizedSizes),
+                           thrust::device_pointer_cast(factorizedSizes) + numStencils,
+                           thrust::device_pointer_cast(factorizedOffsets));
+
+    // (the temporary vectors are freed on return)
+    cudaStreamSynchronize(stream);
+    return numWeights;
+}
+
+// Offsets of the stencils of the given sizes
+void CudaScanStencilSizes(const int * sizes, int * offsets, int numStencils,
+                          cudaStream_t stream) {
+    if (numStencils <= 0) return;
+    thrust::exclusive_scan(thrust::cuda::par.on(stream),
+                           thrust::device_pointer_cast(sizes),
+                           thrust::device_pointer_cast(sizes) + numStencils,
+                           thrust::device_pointer_cast(offsets));
 }
 
 }  /* extern "C" */
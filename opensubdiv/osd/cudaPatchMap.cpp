@@ -0,0 +1,97 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cudaPatchMap.h"
+
+#include <cuda_runtime.h>
+
+#include "../far/patchMap.h"
+#include "../osd/cpuPatchMap.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CudaPatchMap::CudaPatchMap() :
+    _numFaces(0), _faceBuffer(NULL), _nodeBuffer(NULL), _handleBuffer(NULL) {
+}
+
+CudaPatchMap::~CudaPatchMap() {
+    if (_faceBuffer) cudaFree(_faceBuffer);
+    if (_nodeBuffer) cudaFree(_nodeBuffer);
+    if (_handleBuffer) cudaFree(_handleBuffer);
+}
+
+CudaPatchMap *
+CudaPatchMap::Create(Far::PatchMap const *farPatchMap,
+                     void * /*deviceContext*/) {
+    CudaPatchMap *instance = new CudaPatchMap();
+    if (instance->allocate(farPatchMap)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+CudaPatchMap::allocate(Far::PatchMap const *farPatchMap) {
+    CpuPatchMap patchMap(farPatchMap);
+
+    _numFaces = patchMap.GetNumFaces();
+    if (_numFaces == 0) return true;
+
+    size_t faceSize = 2 * _numFaces * sizeof(int);
+    size_t nodeSize = patchMap.GetNodeBufferSize() * sizeof(unsigned int);
+    size_t handleSize = patchMap.GetHandleBufferSize() * sizeof(int);
+
+    cudaError_t err;
+    err = cudaMalloc(&_faceBuffer, faceSize);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMalloc(&_nodeBuffer, nodeSize);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMalloc(&_handleBuffer, handleSize);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMemcpy(_faceBuffer, patchMap.GetFaceBuffer(),
+                     faceSize, cudaMemcpyHostToDevice);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMemcpy(_nodeBuffer, patchMap.GetNodeBuffer(),
+                     nodeSize, cudaMemcpyHostToDevice);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMemcpy(_handleBuffer, patchMap.GetHandleBuffer(),
+                     handleSize, cudaMemcpyHostToDevice);
+    if (err != cudaSuccess) return false;
+
+    return true;
+}
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,85 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_CUDA_PATCH_MAP_H
+#define OPENSUBDIV3_OSD_CUDA_PATCH_MAP_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class PatchMap;
+};
+
+namespace Osd {
+
+/// \brief CUDA patch map
+///
+/// This class is a CUDA buffer representation of Far::PatchMap (see
+/// CpuPatchMap), so that CudaEvaluator::FindPatchCoords maps (faceId, u, v)
+/// locations to PatchCoords on the device.
+///
+class CudaPatchMap : private NonCopyable<CudaPatchMap> {
+public:
+    static CudaPatchMap *Create(Far::PatchMap const *patchMap,
+                                void *deviceContext = NULL);
+    ~CudaPatchMap();
+
+    /// Returns the number of faces of the map
+    int GetNumFaces() const { return _numFaces; }
+
+    /// Returns the CUDA memory of the (first cell, grid depth) pairs of
+    /// the faces
+    void *GetFaceBuffer() const { return _faceBuffer; }
+
+    /// Returns the CUDA memory of the grid cells and quadtree nodes
+    void *GetNodeBuffer() const { return _nodeBuffer; }
+
+    /// Returns the CUDA memory of the patch handles
+    void *GetHandleBuffer() const { return _handleBuffer; }
+
+protected:
+    CudaPatchMap();
+
+    bool allocate(Far::PatchMap const *patchMap);
+
+    int _numFaces;
+    void *_faceBuffer;
+    void *_nodeBuffer;
+    void *_handleBuffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CUDA_PATCH_MAP_H
@@ -42,6 +42,22 @@ CudaPatchTable::~CudaPatchTable() {
     if (_patchArrays) cudaFree(_patchArrays);
     if (_indexBuffer) cudaFree(_indexBuffer);
     if (_patchParamBuffer) cudaFree(_patchParamBuffer);
+    for (size_t i = 0; i < _fvarPatchArrays.size(); ++i) {
+        if (_fvarPatchArrays[i]) cudaFree(_fvarPatchArrays[i]);
+        if (_fvarIndexBuffers[i]) cudaFree(_fvarIndexBuffers[i]);
+        if (_fvarParamBuffers[i]) cudaFree(_fvarParamBuffers[i]);
+    }
+}
+
+static void *
+uploadBuffer(const void *data, size_t size) {
+    void *buffer = NULL;
+    if (cudaMalloc(&buffer, size) != cudaSuccess) return NULL;
+    if (cudaMemcpy(buffer, data, size, cudaMemcpyHostToDevice) != cudaSuccess) {
+        cudaFree(buffer);
+        return NULL;
+    }
+    return buffer;
 }
 
 CudaPatchTable *
@@ -92,6 +108,29 @@ CudaPatchTable::allocate(Far::PatchTable const *farPatchTable) {
                      cudaMemcpyHostToDevice);
     if (err != cudaSuccess) return false;
 
+    // face-varying channels
+    int numFVarChannels = patchTable.GetNumFVarChannels();
+    _fvarPatchArrays.resize(numFVarChannels, NULL);
+    _fvarIndexBuffers.resize(numFVarChannels, NULL);
+    _fvarParamBuffers.resize(numFVarChannels, NULL);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        size_t fvarIndexSize = patchTable.GetFVarPatchIndexSize(channel);
+        size_t fvarParamSize = patchTable.GetFVarPatchParamSize(channel);
+        if (fvarIndexSize == 0 || fvarParamSize == 0) continue;
+
+        _fvarPatchArrays[channel] = uploadBuffer(
+            patchTable.GetFVarPatchArrayBuffer(channel),
+            2 * sizeof(Osd::PatchArray));
+        _fvarIndexBuffers[channel] = uploadBuffer(
+            patchTable.GetFVarPatchIndexBuffer(channel),
+            fvarIndexSize * sizeof(int));
+        _fvarParamBuffers[channel] = uploadBuffer(
+            patchTable.GetFVarPatchParamBuffer(channel),
+            fvarParamSize * sizeof(Osd::PatchParam));
+        if (!_fvarPatchArrays[channel] || !_fvarIndexBuffers[channel] ||
+            !_fvarParamBuffers[channel]) return false;
+    }
+
     return true;
 }
 
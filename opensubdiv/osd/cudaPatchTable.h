@@ -30,6 +30,8 @@
 #include "../osd/nonCopyable.h"
 #include "../osd/types.h"
 
+#include <vector>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -63,6 +65,26 @@ public:
     /// Returns the cuda memory of the array of Osd::PatchParam buffer
     void *GetPatchParamBuffer() const { return _patchParamBuffer; }
 
+    /// Returns the cuda memory of the Osd::PatchArray buffer of a
+    /// face-varying channel (see CpuPatchTable::GetFVarPatchArrayBuffer)
+    void *GetFVarPatchArrayBuffer(int fvarChannel = 0) const {
+        return _fvarPatchArrays[fvarChannel];
+    }
+
+    /// Returns the cuda memory of the face-varying values of a channel
+    void *GetFVarPatchIndexBuffer(int fvarChannel = 0) const {
+        return _fvarIndexBuffers[fvarChannel];
+    }
+
+    /// Returns the cuda memory of the face-varying Osd::PatchParam buffer
+    /// of a channel
+    void *GetFVarPatchParamBuffer(int fvarChannel = 0) const {
+        return _fvarParamBuffers[fvarChannel];
+    }
+
+    /// Returns the number of face-varying channels
+    int GetNumFVarChannels() const { return (int)_fvarPatchArrays.size(); }
+
 protected:
     CudaPatchTable();
 
@@ -71,6 +93,10 @@ protected:
     void *_patchArrays;
     void *_indexBuffer;
     void *_patchParamBuffer;
+
+    std::vector<void *> _fvarPatchArrays;
+    std::vector<void *> _fvarIndexBuffers;
+    std::vector<void *> _fvarParamBuffers;
 };
 
 }  // end namespace Osd
@@ -0,0 +1,77 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/cudaPtexAdjacency.h"
+
+#include <cuda_runtime.h>
+
+#include "../osd/cpuPtexAdjacency.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+CudaPtexAdjacency::CudaPtexAdjacency() :
+    _numFaces(0), _adjacencyBuffer(NULL) {
+}
+
+CudaPtexAdjacency::~CudaPtexAdjacency() {
+    if (_adjacencyBuffer) cudaFree(_adjacencyBuffer);
+}
+
+CudaPtexAdjacency *
+CudaPtexAdjacency::Create(Far::TopologyRefiner const &refiner,
+                          void * /*deviceContext*/) {
+    CudaPtexAdjacency *instance = new CudaPtexAdjacency();
+    if (instance->allocate(refiner)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+CudaPtexAdjacency::allocate(Far::TopologyRefiner const &refiner) {
+    CpuPtexAdjacency adjacency(refiner);
+
+    _numFaces = adjacency.GetNumFaces();
+    if (_numFaces == 0) return true;
+
+    size_t size = 5 * _numFaces * sizeof(int);
+
+    cudaError_t err;
+    err = cudaMalloc(&_adjacencyBuffer, size);
+    if (err != cudaSuccess) return false;
+
+    err = cudaMemcpy(_adjacencyBuffer, adjacency.GetAdjacencyBuffer(),
+                     size, cudaMemcpyHostToDevice);
+    if (err != cudaSuccess) return false;
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,76 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_CUDA_PTEX_ADJACENCY_H
+#define OPENSUBDIV3_OSD_CUDA_PTEX_ADJACENCY_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class TopologyRefiner;
+};
+
+namespace Osd {
+
+/// \brief CUDA ptex adjacency
+///
+/// This class is a CUDA buffer representation of the adjacency of the ptex
+/// faces of a mesh (see CpuPtexAdjacency), so that CudaEvaluator::
+/// AdvectPatchCoords moves surface samples across the faces on the device.
+///
+class CudaPtexAdjacency : private NonCopyable<CudaPtexAdjacency> {
+public:
+    static CudaPtexAdjacency *Create(Far::TopologyRefiner const &refiner,
+                                     void *deviceContext = NULL);
+    ~CudaPtexAdjacency();
+
+    /// Returns the number of ptex faces
+    int GetNumFaces() const { return _numFaces; }
+
+    /// Returns the CUDA memory of the encoded adjacency of the faces
+    void *GetAdjacencyBuffer() const { return _adjacencyBuffer; }
+
+protected:
+    CudaPtexAdjacency();
+
+    bool allocate(Far::TopologyRefiner const &refiner);
+
+    int _numFaces;
+    void *_adjacencyBuffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CUDA_PTEX_ADJACENCY_H
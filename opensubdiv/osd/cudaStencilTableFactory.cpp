@@ -0,0 +1,257 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cudaStencilTableFactory.h"
+
+#include <cuda_runtime.h>
+#include <algorithm>
+#include <vector>
+
+#include "../far/error.h"
+#include "../far/hierarchicalEdits.h"
+#include "../far/stencilTable.h"
+#include "../far/topologyRefiner.h"
+#include "../osd/cudaEvaluator.h"
+
+extern "C" {
+    int CudaFactorizeStencils(int numStencils,
+                              const int * sizes,
+                              const int * offsets,
+                              const int * indices,
+                              const float * weights,
+                              int numControlVerts,
+                              int prevFirstVertex,
+                              const int * prevSizes,
+                              const int * prevOffsets,
+                              const int * prevIndices,
+                              const float * prevWeights,
+                              int * factorizedSizes,
+                              int * factorizedOffsets,
+                              int ** factorizedIndices,
+                              float ** factorizedWeights,
+                              cudaStream_t stream);
+
+    void CudaScanStencilSizes(const int * sizes,
+                              int * offsets,
+                              int numStencils,
+                              cudaStream_t stream);
+}
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+    // Stencils of a level on the device : the offsets index 'indices' and
+    // 'weights', which are only freed if 'owned'
+    struct LevelStencils {
+        int numStencils,
+            numWeights;
+        int * sizes,
+            * offsets,
+            * indices;
+        float * weights;
+        bool owned;
+    };
+
+    void
+    freeLevels(std::vector<LevelStencils> & levels) {
+        for (int i = 0; i < (int)levels.size(); ++i) {
+            if (not levels[i].owned) continue;
+            cudaFree(levels[i].sizes);
+            cudaFree(levels[i].offsets);
+            cudaFree(levels[i].indices);
+            cudaFree(levels[i].weights);
+        }
+        levels.clear();
+    }
+}
+
+CudaStencilTable *
+CudaStencilTableFactory::Create(Far::TopologyRefiner const &refiner,
+                                Options options,
+                                void *deviceContext) {
+
+    cudaStream_t stream = static_cast<cudaStream_t>(deviceContext);
+
+    Far::HierarchicalEdits const * edits = refiner.GetHierarchicalEdits();
+    int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
+
+    if ((edits and edits->GetNumVertexEdits() > 0) or maxlevel < 2 or
+        (not options.factorizeIntermediateLevels) or
+        options.shareIntermediateLevels) {
+        Far::StencilTable * table = const_cast<Far::StencilTable *>(
+            Far::StencilTableFactory::Create(refiner, options));
+        CudaStencilTable * result =
+            CudaStencilTable::CreateAndRelease(table, deviceContext);
+        delete table;
+        return result;
+    }
+
+    // Stencils of each level interpolated from the previous level, with one
+    // pass per level (see Far::StencilTable::GetPassOffsets())
+    Options maskOptions = options;
+    maskOptions.generateOffsets = true;
+    maskOptions.generateControlVerts = false;
+    maskOptions.generateIntermediateLevels = true;
+    maskOptions.factorizeIntermediateLevels = false;
+
+    Far::StencilTable const * maskTable =
+        Far::StencilTableFactory::Create(refiner, maskOptions);
+
+    int numControlVerts = maskTable->GetNumControlVertices();
+    std::vector<int> levelStarts = maskTable->GetPassOffsets();
+    levelStarts.push_back(maskTable->GetNumStencils());
+
+    int numLevel1Weights = 0;
+    for (int i = 0; i < levelStarts[1]; ++i) {
+        numLevel1Weights += maskTable->GetSizes()[i];
+    }
+
+    CudaStencilTable masks(maskTable);
+    delete maskTable;
+
+    int * maskSizes = static_cast<int *>(masks.GetSizesBuffer());
+    int * maskOffsets = static_cast<int *>(masks.GetOffsetsBuffer());
+    int * maskIndices = static_cast<int *>(masks.GetIndicesBuffer());
+    float * maskWeights = static_cast<float *>(masks.GetWeightsBuffer());
+
+    // The stencils of the first level are factorized : those of each
+    // following level are factorized with the stencils of the previous one
+    std::vector<LevelStencils> levels(1);
+    levels[0].numStencils = levelStarts[1];
+    levels[0].numWeights = numLevel1Weights;
+    levels[0].sizes = maskSizes;
+    levels[0].offsets = maskOffsets;
+    levels[0].indices = maskIndices;
+    levels[0].weights = maskWeights;
+    levels[0].owned = false;
+
+    for (int level = 2; level <= maxlevel; ++level) {
+        int start = levelStarts[level-1],
+            numStencils = levelStarts[level] - start;
+
+        LevelStencils const & prev = levels.back();
+        LevelStencils factorized;
+        factorized.numStencils = numStencils;
+        factorized.sizes = factorized.offsets = factorized.indices = NULL;
+        factorized.weights = NULL;
+        factorized.owned = true;
+
+        factorized.numWeights = -1;
+        if (cudaMalloc(&factorized.sizes, numStencils*sizeof(int)) == cudaSuccess and
+            cudaMalloc(&factorized.offsets, numStencils*sizeof(int)) == cudaSuccess) {
+            factorized.numWeights = CudaFactorizeStencils(numStencils,
+                maskSizes + start, maskOffsets + start, maskIndices, maskWeights,
+                numControlVerts, numControlVerts + levelStarts[level-2],
+                prev.sizes, prev.offsets, prev.indices, prev.weights,
+                factorized.sizes, factorized.offsets,
+                &factorized.indices, &factorized.weights, stream);
+        }
+        levels.push_back(factorized);
+
+        if (factorized.numWeights < 0) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                "Failure in CudaStencilTableFactory::Create() -- "
+                "cannot factorize the stencils of level %d.", level);
+            freeLevels(levels);
+            return NULL;
+        }
+    }
+
+    // Assemble the control-vertex stencils and the stencils of the levels
+    int firstLevel = options.generateIntermediateLevels ? 0 : maxlevel-1,
+        numControlStencils = options.generateControlVerts ? numControlVerts : 0;
+
+    int numStencils = numControlStencils,
+        numWeights = numControlStencils;
+    for (int i = firstLevel; i < maxlevel; ++i) {
+        numStencils += levels[i].numStencils;
+        numWeights += levels[i].numWeights;
+    }
+
+    int * sizes = NULL,
+        * offsets = NULL,
+        * indices = NULL;
+    float * weights = NULL;
+    if (cudaMalloc(&sizes, numStencils*sizeof(int)) != cudaSuccess or
+        cudaMalloc(&offsets, numStencils*sizeof(int)) != cudaSuccess or
+        cudaMalloc(&indices, numWeights*sizeof(int)) != cudaSuccess or
+        cudaMalloc(&weights, numWeights*sizeof(float)) != cudaSuccess) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in CudaStencilTableFactory::Create() -- "
+            "cannot allocate %d stencils.", numStencils);
+        cudaFree(sizes);
+        cudaFree(offsets);
+        cudaFree(indices);
+        cudaFree(weights);
+        freeLevels(levels);
+        return NULL;
+    }
+
+    if (numControlStencils > 0) {
+        // Control vertices contribute a single index with a weight of 1.0
+        std::vector<int> controlSizes(numControlStencils, 1),
+                         controlIndices(numControlStencils);
+        std::vector<float> controlWeights(numControlStencils, 1.0f);
+        for (int i = 0; i < numControlStencils; ++i) {
+            controlIndices[i] = i;
+        }
+        cudaMemcpy(sizes, &controlSizes[0],
+                   numControlStencils*sizeof(int), cudaMemcpyHostToDevice);
+        cudaMemcpy(indices, &controlIndices[0],
+                   numControlStencils*sizeof(int), cudaMemcpyHostToDevice);
+        cudaMemcpy(weights, &controlWeights[0],
+                   numControlStencils*sizeof(float), cudaMemcpyHostToDevice);
+    }
+
+    int stencil = numControlStencils,
+        weight = numControlStencils;
+    for (int i = firstLevel; i < maxlevel; ++i) {
+        LevelStencils const & level = levels[i];
+        cudaMemcpyAsync(sizes + stencil, level.sizes,
+                        level.numStencils*sizeof(int),
+                        cudaMemcpyDeviceToDevice, stream);
+        cudaMemcpyAsync(indices + weight, level.indices,
+                        level.numWeights*sizeof(int),
+                        cudaMemcpyDeviceToDevice, stream);
+        cudaMemcpyAsync(weights + weight, level.weights,
+                        level.numWeights*sizeof(float),
+                        cudaMemcpyDeviceToDevice, stream);
+        stencil += level.numStencils;
+        weight += level.numWeights;
+    }
+    CudaScanStencilSizes(sizes, offsets, numStencils, stream);
+    cudaStreamSynchronize(stream);
+
+    freeLevels(levels);
+
+    return new CudaStencilTable(numStencils, sizes, offsets, indices, weights);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,83 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CUDA_STENCIL_TABLE_FACTORY_H
+#define OPENSUBDIV3_OSD_CUDA_STENCIL_TABLE_FACTORY_H
+
+#include "../version.h"
+
+#include "../far/stencilTableFactory.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class TopologyRefiner;
+}
+
+namespace Osd {
+
+class CudaStencilTable;
+
+/// \brief Builds CudaStencilTables on the device
+///
+/// The stencils of each level are interpolated on the host with the
+/// stencils of the previous level as sources (unfactorized), which is
+/// cheap, and the factorization of the deep levels, which expands each
+/// stencil into the stencils of its sources and dominates the cost of
+/// Far::StencilTableFactory::Create() for dense meshes, runs on the device.
+/// The factorized table is left on the device.
+///
+/// Tables with vertex edits, shared intermediate levels or unfactorized
+/// levels, or of no more than one level, are created on the host and
+/// uploaded (they have no deep levels to factorize).
+///
+class CudaStencilTableFactory {
+public:
+    typedef Far::StencilTableFactory::Options Options;
+
+    /// \brief Returns a CudaStencilTable with the same stencils (up to the
+    ///        order of the terms of each stencil) as the Far::StencilTable
+    ///        of the same options
+    ///
+    /// @param refiner        The TopologyRefiner containing the topology
+    ///
+    /// @param options        Options controlling the creation of the table
+    ///
+    /// @param deviceContext  cudaStream_t of the factorization (optional :
+    ///                       the default stream if NULL)
+    ///
+    static CudaStencilTable *Create(Far::TopologyRefiner const &refiner,
+                                    Options options = Options(),
+                                    void *deviceContext = NULL);
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CUDA_STENCIL_TABLE_FACTORY_H
@@ -23,6 +23,8 @@
 //
 
 #include "../osd/cudaVertexBuffer.h"
+#include "../far/error.h"
+#include "../far/profile.h"
 
 #include <cuda_runtime.h>
 #include <cassert>
@@ -35,7 +37,8 @@ namespace Osd {
 CudaVertexBuffer::CudaVertexBuffer(int numElements, int numVertices)
     : _numElements(numElements),
       _numVertices(numVertices),
-      _cudaMem(0) {
+      _cudaMem(0),
+      _managed(false) {
 }
 
 CudaVertexBuffer::~CudaVertexBuffer() {
@@ -52,14 +55,45 @@ CudaVertexBuffer::Create(int numElements, int numVertices,
     return NULL;
 }
 
+CudaVertexBuffer *
+CudaVertexBuffer::CreateManaged(int numElements, int numVertices) {
+
+    int device = 0, managed = 0;
+    if (cudaGetDevice(&device) != cudaSuccess ||
+        cudaDeviceGetAttribute(&managed, cudaDevAttrManagedMemory, device)
+            != cudaSuccess || !managed) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "CudaVertexBuffer::CreateManaged failed : "
+                   "managed memory not supported.\n");
+        return NULL;
+    }
+    CudaVertexBuffer *instance =
+        new CudaVertexBuffer(numElements, numVertices);
+    if (instance->allocate(true)) return instance;
+    delete instance;
+    return NULL;
+}
+
 void
 CudaVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
-                             void * /*deviceContext*/) {
+                             void * deviceContext) {
+
+    OPENSUBDIV_PROFILE_ZONE("CudaVertexBuffer::UpdateData");
 
     size_t size = _numElements * numVertices * sizeof(float);
 
-    cudaMemcpy((float*)_cudaMem + _numElements * startVertex,
-               src, size, cudaMemcpyHostToDevice);
+    // managed memory may be the source or the destination of copies on the
+    // host or on the device, as resolved by cudaMemcpyDefault
+    cudaMemcpyKind kind = _managed ? cudaMemcpyDefault : cudaMemcpyHostToDevice;
+
+    if (deviceContext) {
+        cudaMemcpyAsync((float*)_cudaMem + _numElements * startVertex,
+                        src, size, kind,
+                        static_cast<cudaStream_t>(deviceContext));
+    } else {
+        cudaMemcpy((float*)_cudaMem + _numElements * startVertex,
+                   src, size, kind);
+    }
 }
 
 int
@@ -80,13 +114,22 @@ CudaVertexBuffer::BindCudaBuffer() {
     return static_cast<float*>(_cudaMem);
 }
 
+float *
+CudaVertexBuffer::BindCpuBuffer() {
+
+    return _managed ? static_cast<float*>(_cudaMem) : NULL;
+}
+
 bool
-CudaVertexBuffer::allocate() {
+CudaVertexBuffer::allocate(bool managed) {
     int size = _numElements * _numVertices * sizeof(float);
 
-    cudaError_t err = cudaMalloc(&_cudaMem, size);
+    cudaError_t err = managed ?
+        cudaMallocManaged(&_cudaMem, size, cudaMemAttachGlobal) :
+        cudaMalloc(&_cudaMem, size);
 
     if (err != cudaSuccess) return false;
+    _managed = managed;
     return true;
 }
 
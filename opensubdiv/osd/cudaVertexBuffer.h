@@ -46,11 +46,22 @@ public:
     static CudaVertexBuffer * Create(int numElements, int numVertices,
                                      void *deviceContext = NULL);
 
+    /// Creator of a buffer in unified (managed) memory, which the host
+    /// writes directly through BindCpuBuffer() instead of UpdateData.
+    /// Returns NULL if error, e.g. if the device doesn't support managed
+    /// memory.
+    static CudaVertexBuffer * CreateManaged(int numElements, int numVertices);
+
     /// Destructor.
     ~CudaVertexBuffer();
 
     /// This method is meant to be used in client code in order to provide coarse
     /// vertices data to Osd.
+    ///
+    /// The copy is asynchronous if deviceContext is a cudaStream_t : 'src'
+    /// must then remain valid until the copy has completed (see
+    /// CudaEvaluator::Synchronize), and must be page-locked (cudaMallocHost)
+    /// for the copy to overlap with the kernels of other streams.
     void UpdateData(const float *src, int startVertex, int numVertices,
                     void *deviceContext=NULL);
 
@@ -63,18 +74,27 @@ public:
     /// Returns cuda memory.
     float * BindCudaBuffer();
 
+    /// Returns the host address of a managed buffer (NULL otherwise). The
+    /// host must not access it while kernels are running on the buffer (see
+    /// CudaEvaluator::Synchronize).
+    float * BindCpuBuffer();
+
+    /// Returns true if the buffer is in unified (managed) memory
+    bool IsManaged() const { return _managed; }
+
 protected:
     /// Constructor.
     CudaVertexBuffer(int numElements, int numVertices);
 
     /// Allocates Cuda memory for this buffer.
     /// Returns true if success.
-    bool allocate();
+    bool allocate(bool managed = false);
 
 private:
     int _numElements;
     int _numVertices;
     void *_cudaMem;
+    bool _managed;
 
 };
 
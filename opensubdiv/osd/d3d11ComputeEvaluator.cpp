@@ -23,6 +23,7 @@
 //
 
 #include "../osd/d3d11ComputeEvaluator.h"
+#include "../osd/programCache.h"
 
 #include <cassert>
 #include <sstream>
@@ -31,11 +32,13 @@
 
 #define INITGUID        // for IID_ID3D11ShaderReflection
 #include <D3D11.h>
+#include <dxgi.h>
 #include <D3D11shader.h>
 #include <D3Dcompiler.h>
 
 #include "../far/error.h"
 #include "../far/stencilTable.h"
+#include "../far/profile.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -136,6 +139,7 @@ D3D11StencilTable::D3D11StencilTable(Far::StencilTable const *stencilTable,
                              stencilTable->GetControlIndices().size());
         _weights= createSRV(_weightsBuffer, DXGI_FORMAT_R32_FLOAT, device,
                             stencilTable->GetWeights().size());
+        _passOffsets = stencilTable->GetPassOffsets();
     } else {
         _sizes = _offsets = _indices = _weights = NULL;
         _sizesBuffer = _offsetsBuffer = _indicesBuffer = _weightsBuffer = NULL;
@@ -166,19 +170,61 @@ D3D11ComputeEvaluator::D3D11ComputeEvaluator() :
 
 }
 
+D3D11ComputeEvaluator::D3D11ComputeEvaluator(int workGroupSize) :
+    _computeShader(NULL),
+    _classLinkage(NULL),
+    _singleBufferKernel(NULL),
+    _separateBufferKernel(NULL),
+    _uniformArgs(NULL),
+    _workGroupSize(workGroupSize) {
+
+}
+
+/* static */
+int
+D3D11ComputeEvaluator::GetWorkGroupSize(ID3D11DeviceContext *deviceContext) {
+    int workGroupSize = 64;
+    if (deviceContext == NULL) return workGroupSize;
+
+    ID3D11Device *device = NULL;
+    IDXGIDevice *dxgiDevice = NULL;
+    IDXGIAdapter *adapter = NULL;
+
+    deviceContext->GetDevice(&device);
+    if (device &&
+        SUCCEEDED(device->QueryInterface(__uuidof(IDXGIDevice),
+                                         (void **)&dxgiDevice)) &&
+        SUCCEEDED(dxgiDevice->GetAdapter(&adapter))) {
+
+        DXGI_ADAPTER_DESC desc;
+        if (SUCCEEDED(adapter->GetDesc(&desc))) {
+            // several warps (32 threads) or wavefronts (64 threads) per
+            // work group
+            if (desc.VendorId == 0x10de) {          // NVIDIA
+                workGroupSize = 128;
+            } else if (desc.VendorId == 0x1002) {   // AMD
+                workGroupSize = 256;
+            }
+        }
+    }
+    SAFE_RELEASE(adapter);
+    SAFE_RELEASE(dxgiDevice);
+    SAFE_RELEASE(device);
+    return workGroupSize;
+}
+
 D3D11ComputeEvaluator *
 D3D11ComputeEvaluator::Create(BufferDescriptor const &srcDesc,
                               BufferDescriptor const &dstDesc,
                               BufferDescriptor const &duDesc,
                               BufferDescriptor const &dvDesc,
                               ID3D11DeviceContext *deviceContext) {
-    (void)deviceContext;  // not used
-
     // TODO: implements derivatives
     (void)duDesc;
     (void)dvDesc;
 
-    D3D11ComputeEvaluator *instance = new D3D11ComputeEvaluator();
+    D3D11ComputeEvaluator *instance =
+        new D3D11ComputeEvaluator(GetWorkGroupSize(deviceContext));
     if (instance->Compile(srcDesc, dstDesc, deviceContext)) return instance;
     delete instance;
     return NULL;
@@ -226,22 +272,41 @@ D3D11ComputeEvaluator::Compile(BufferDescriptor const &srcDesc,
           "WORK_GROUP_SIZE", workgroupSizeValue.c_str(),
           0, 0 };
 
-    ID3DBlob * computeShaderBuffer = NULL;
-    ID3DBlob * errorBuffer = NULL;
-
-    HRESULT hr = D3DCompile(shaderSource, strlen(shaderSource),
-                            NULL, &defines[0], NULL,
-                            "cs_main", "cs_5_0",
-                            dwShaderFlags, 0,
-                            &computeShaderBuffer, &errorBuffer);
-    if (FAILED(hr)) {
-        if (errorBuffer != NULL) {
-            Far::Error(Far::FAR_RUNTIME_ERROR,
-                       "Error compiling HLSL shader: %s\n",
-                       (CHAR*)errorBuffer->GetBufferPointer());
-            errorBuffer->Release();
+    // shader blobs compiled by previous processes are loaded from the
+    // ProgramCache : blobs are specific to the compiler, not to the device
+    std::ostringstream key;
+    key << "cs_5_0 " << D3D_COMPILER_VERSION << " " << dwShaderFlags << "\n";
+    for (int i = 0; defines[i].Name; ++i) {
+        key << defines[i].Name << " " << defines[i].Definition << "\n";
+    }
+    key << shaderSource;
+    std::string cacheKey = key.str();
+
+    std::vector<char> bytecode;
+    if (!ProgramCache::Load(cacheKey, bytecode)) {
+        ID3DBlob * computeShaderBuffer = NULL;
+        ID3DBlob * errorBuffer = NULL;
+
+        HRESULT hr = D3DCompile(shaderSource, strlen(shaderSource),
+                                NULL, &defines[0], NULL,
+                                "cs_main", "cs_5_0",
+                                dwShaderFlags, 0,
+                                &computeShaderBuffer, &errorBuffer);
+        if (FAILED(hr)) {
+            if (errorBuffer != NULL) {
+                Far::Error(Far::FAR_RUNTIME_ERROR,
+                           "Error compiling HLSL shader: %s\n",
+                           (CHAR*)errorBuffer->GetBufferPointer());
+                errorBuffer->Release();
+            }
             return false;
         }
+
+        const char *data = (const char *)computeShaderBuffer->GetBufferPointer();
+        bytecode.assign(data, data + computeShaderBuffer->GetBufferSize());
+        computeShaderBuffer->Release();
+
+        ProgramCache::Store(cacheKey, &bytecode[0], bytecode.size());
     }
 
     ID3D11Device *device = NULL;
@@ -251,23 +316,19 @@ D3D11ComputeEvaluator::Compile(BufferDescriptor const &srcDesc,
     device->CreateClassLinkage(&_classLinkage);
     assert(_classLinkage);
 
-    device->CreateComputeShader(computeShaderBuffer->GetBufferPointer(),
-                                computeShaderBuffer->GetBufferSize(),
+    device->CreateComputeShader(&bytecode[0], bytecode.size(),
                                 _classLinkage,
                                 &_computeShader);
     assert(_computeShader);
 
     ID3D11ShaderReflection *reflector;
-    D3DReflect(computeShaderBuffer->GetBufferPointer(),
-               computeShaderBuffer->GetBufferSize(),
+    D3DReflect(&bytecode[0], bytecode.size(),
                IID_ID3D11ShaderReflection, (void**) &reflector);
     assert(reflector);
 
     assert(reflector->GetNumInterfaceSlots() == 1);
     reflector->Release();
 
-    computeShaderBuffer->Release();
-
     _classLinkage->GetClassInstance("singleBufferCompute", 0, &_singleBufferKernel);
     assert(_singleBufferKernel);
     _classLinkage->GetClassInstance("separateBufferCompute", 0, &_separateBufferKernel);
@@ -293,6 +354,10 @@ D3D11ComputeEvaluator::Synchronize(ID3D11DeviceContext *deviceContext) {
     // XXXFIXME!
     ID3D11Query *query = NULL;
 
+    // commands recorded into a deferred context are only submitted by
+    // ExecuteCommandList() on the immediate context
+    if (deviceContext->GetType() == D3D11_DEVICE_CONTEXT_DEFERRED) return;
+
     ID3D11Device *device = NULL;
     deviceContext->GetDevice(&device);
     assert(device);
@@ -321,10 +386,51 @@ D3D11ComputeEvaluator::EvalStencils(ID3D11UnorderedAccessView *srcUAV,
                                     int start,
                                     int end,
                                     ID3D11DeviceContext *deviceContext) const {
+    OPENSUBDIV_PROFILE_ZONE("D3D11ComputeEvaluator::EvalStencils");
+
     assert(deviceContext);
 
+    if (end - start <= 0) return true;
+
+    ID3D11ClassInstance *boundKernel = NULL;
+    beginDispatches(deviceContext);
+    dispatchStencils(srcUAV, srcDesc, dstUAV, dstDesc,
+                     sizesSRV, offsetsSRV, indicesSRV, weightsSRV,
+                     start, end, &boundKernel, deviceContext);
+    endDispatches(deviceContext);
+
+    return true;
+}
+
+void
+D3D11ComputeEvaluator::beginDispatches(
+    ID3D11DeviceContext *deviceContext) const {
+
+    deviceContext->CSSetConstantBuffers(0, 1, &_uniformArgs); // b0
+
+    // Unbind the vertexBuffer from the input assembler
+    ID3D11Buffer *NULLBuffer = 0;
+    UINT voffset = 0, vstride = 0;
+    deviceContext->IASetVertexBuffers(0, 1, &NULLBuffer, &voffset, &vstride);
+    ID3D11ShaderResourceView *NULLSRV = 0;
+    deviceContext->VSSetShaderResources(0, 1, &NULLSRV);
+}
+
+void
+D3D11ComputeEvaluator::dispatchStencils(ID3D11UnorderedAccessView *srcUAV,
+                                        BufferDescriptor const &srcDesc,
+                                        ID3D11UnorderedAccessView *dstUAV,
+                                        BufferDescriptor const &dstDesc,
+                                        ID3D11ShaderResourceView *sizesSRV,
+                                        ID3D11ShaderResourceView *offsetsSRV,
+                                        ID3D11ShaderResourceView *indicesSRV,
+                                        ID3D11ShaderResourceView *weightsSRV,
+                                        int start,
+                                        int end,
+                                        ID3D11ClassInstance **boundKernel,
+                                        ID3D11DeviceContext *deviceContext) const {
     int count = end - start;
-    if (count <= 0) return true;
+    if (count <= 0) return;
 
     KernelUniformArgs args;
     args.start = start;
@@ -332,19 +438,12 @@ D3D11ComputeEvaluator::EvalStencils(ID3D11UnorderedAccessView *srcUAV,
     args.srcOffset = srcDesc.offset;
     args.dstOffset = dstDesc.offset;
 
+    // (WRITE_DISCARD renames the buffer : it may be mapped for each
+    // dispatch, also when recording into a deferred context)
     D3D11_MAPPED_SUBRESOURCE mappedResource;
     deviceContext->Map(_uniformArgs, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
     CopyMemory(mappedResource.pData, &args, sizeof(KernelUniformArgs));
-
     deviceContext->Unmap(_uniformArgs, 0);
-    deviceContext->CSSetConstantBuffers(0, 1, &_uniformArgs); // b0
-
-    // Unbind the vertexBuffer from the input assembler
-    ID3D11Buffer *NULLBuffer = 0;
-    UINT voffset = 0, vstride = 0;
-    deviceContext->IASetVertexBuffers(0, 1, &NULLBuffer, &voffset, &vstride);
-    ID3D11ShaderResourceView *NULLSRV = 0;
-    deviceContext->VSSetShaderResources(0, 1, &NULLSRV);
 
     // bind UAV
     ID3D11UnorderedAccessView *UAViews[] = { srcUAV, dstUAV };
@@ -354,26 +453,33 @@ D3D11ComputeEvaluator::EvalStencils(ID3D11UnorderedAccessView *srcUAV,
     // bind source vertex and stencil table
     deviceContext->CSSetShaderResources(1, 4, SRViews); // t1-t4
 
+    ID3D11ClassInstance *kernel = NULL;
     if (srcUAV == dstUAV) {
         deviceContext->CSSetUnorderedAccessViews(0, 1, UAViews, 0); // u0
         // Dispatch src == dst buffer
-        deviceContext->CSSetShader(_computeShader, &_singleBufferKernel, 1);
-        deviceContext->Dispatch((count + _workGroupSize - 1) / _workGroupSize, 1, 1);
+        kernel = _singleBufferKernel;
     } else {
         deviceContext->CSSetUnorderedAccessViews(0, 2, UAViews, 0); // u0, u1
         // Dispatch src != dst buffer
-        deviceContext->CSSetShader(_computeShader, &_separateBufferKernel, 1);
-        deviceContext->Dispatch((count + _workGroupSize - 1) / _workGroupSize, 1, 1);
+        kernel = _separateBufferKernel;
+    }
+    if (kernel != *boundKernel) {
+        deviceContext->CSSetShader(_computeShader, &kernel, 1);
+        *boundKernel = kernel;
     }
+    deviceContext->Dispatch((count + _workGroupSize - 1) / _workGroupSize, 1, 1);
+}
+
+void
+D3D11ComputeEvaluator::endDispatches(
+    ID3D11DeviceContext *deviceContext) const {
 
     // unbind stencil table and vertexbuffers
-    SRViews[0] = SRViews[1] = SRViews[2] = SRViews[3] = NULL;
+    ID3D11ShaderResourceView *SRViews[] = { NULL, NULL, NULL, NULL };
     deviceContext->CSSetShaderResources(1, 4, SRViews);
 
-    UAViews[0] = UAViews[1] = NULL;
+    ID3D11UnorderedAccessView *UAViews[] = { NULL, NULL };
     deviceContext->CSSetUnorderedAccessViews(0, 2, UAViews, 0);
-
-    return true;
 }
 
 }  // end namespace Osd
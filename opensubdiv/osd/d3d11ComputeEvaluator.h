@@ -27,6 +27,8 @@
 
 #include "../version.h"
 
+#include <vector>
+
 struct ID3D11DeviceContext;
 struct ID3D11Buffer;
 struct ID3D11ComputeShader;
@@ -78,6 +80,10 @@ public:
     ID3D11ShaderResourceView *GetWeightsSRV() const { return _weights; }
     int GetNumStencils() const { return _numStencils; }
 
+    /// \brief Returns the index of the first stencil of each evaluation pass
+    ///        (see Far::StencilTable::GetPassOffsets())
+    std::vector<int> const & GetPassOffsets() const { return _passOffsets; }
+
 private:
     ID3D11ShaderResourceView *_sizes;
     ID3D11ShaderResourceView *_offsets;
@@ -88,6 +94,7 @@ private:
     ID3D11Buffer *_indicesBuffer;
     ID3D11Buffer *_weightsBuffer;
 
+    std::vector<int> _passOffsets;
     int _numStencils;
 };
 
@@ -102,9 +109,12 @@ public:
                                           BufferDescriptor const &dvDesc,
                                           ID3D11DeviceContext *deviceContext);
 
-    /// Constructor.
+    /// Constructor. The kernels are compiled with a work group size of 64
     D3D11ComputeEvaluator();
 
+    /// Constructor compiling the kernels with the given work group size.
+    explicit D3D11ComputeEvaluator(int workGroupSize);
+
     /// Destructor.
     ~D3D11ComputeEvaluator();
 
@@ -166,6 +176,40 @@ public:
         }
     }
 
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        D3D11ComputeEvaluator const *instance,
+        ID3D11DeviceContext * deviceContext) {
+
+        if (end <= start) return true;
+
+        // Create an instance on demand (slow)
+        D3D11ComputeEvaluator const *kernel = instance ? instance :
+            Create(srcDesc, dstDesc, BufferDescriptor(), BufferDescriptor(),
+                   deviceContext);
+        if (!kernel) return false;
+
+        bool r = kernel->EvalStencils(srcBuffer->BindD3D11UAV(deviceContext), srcDesc,
+                                      dstBuffer->BindD3D11UAV(deviceContext), dstDesc,
+                                      stencilTable->GetSizesSRV(),
+                                      stencilTable->GetOffsetsSRV(),
+                                      stencilTable->GetIndicesSRV(),
+                                      stencilTable->GetWeightsSRV(),
+                                      start, end, deviceContext);
+        if (kernel != instance) delete kernel;
+        return r;
+    }
+
     /// Dispatch the DX compute kernel on GPU asynchronously.
     /// returns false if the kernel hasn't been compiled yet.
     template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
@@ -174,15 +218,69 @@ public:
         DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
         STENCIL_TABLE const *stencilTable,
         ID3D11DeviceContext *deviceContext) const {
-        return EvalStencils(srcBuffer->BindD3D11UAV(deviceContext), srcDesc,
-                            dstBuffer->BindD3D11UAV(deviceContext), dstDesc,
-                            stencilTable->GetSizesSRV(),
-                            stencilTable->GetOffsetsSRV(),
-                            stencilTable->GetIndicesSRV(),
-                            stencilTable->GetWeightsSRV(),
-                            /* start = */ 0,
-                            /* end   = */ stencilTable->GetNumStencils(),
-                            deviceContext);
+
+        return EvalStencilsBatch(1, &srcBuffer, srcDesc, &dstBuffer, dstDesc,
+                                 &stencilTable, deviceContext);
+    }
+
+    /// \brief Dispatches the stencils of several meshes evaluated with the
+    ///        same buffer descriptors (e.g. the meshes of a scene sharing an
+    ///        instance of an EvaluatorCacheT), binding the compute shader and
+    ///        its constant buffer once rather than once per mesh.
+    ///
+    /// 'deviceContext' may be a deferred context (see
+    /// ID3D11Device::CreateDeferredContext()) : every dispatch binds the
+    /// state it depends on, so that the stencils of many meshes may be
+    /// recorded on worker threads -- one deferred context per thread, an
+    /// instance of the evaluator may be shared -- and their command lists
+    /// executed on the immediate context.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencilsBatch(
+        int numMeshes,
+        SRC_BUFFER * const *srcBuffers, BufferDescriptor const &srcDesc,
+        DST_BUFFER * const *dstBuffers, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const * const *stencilTables,
+        ID3D11DeviceContext *deviceContext) const {
+
+        if (numMeshes <= 0) return true;
+        if (_computeShader == NULL) return false;
+
+        ID3D11ClassInstance *boundKernel = NULL;
+        beginDispatches(deviceContext);
+
+        for (int mesh = 0; mesh < numMeshes; ++mesh) {
+            STENCIL_TABLE const *stencilTable = stencilTables[mesh];
+
+            ID3D11UnorderedAccessView *srcUAV =
+                srcBuffers[mesh]->BindD3D11UAV(deviceContext);
+            ID3D11UnorderedAccessView *dstUAV =
+                dstBuffers[mesh]->BindD3D11UAV(deviceContext);
+
+            // Passes refer to the vertices of the previous passes : they are
+            // dispatched in order (see Far::StencilTable::GetPassOffsets()),
+            // D3D11 completing the writes of a dispatch to an unordered
+            // access view before the next dispatch
+            std::vector<int> const & passOffsets =
+                stencilTable->GetPassOffsets();
+
+            int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+            for (int pass = 0; pass < numPasses; ++pass) {
+                int start = passOffsets.empty() ? 0 : passOffsets[pass];
+                int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                                 stencilTable->GetNumStencils();
+
+                dispatchStencils(srcUAV, srcDesc, dstUAV, dstDesc,
+                                 stencilTable->GetSizesSRV(),
+                                 stencilTable->GetOffsetsSRV(),
+                                 stencilTable->GetIndicesSRV(),
+                                 stencilTable->GetWeightsSRV(),
+                                 start, end, &boundKernel, deviceContext);
+            }
+        }
+
+        endDispatches(deviceContext);
+        return true;
     }
 
     /// Dispatch the DX compute kernel on GPU asynchronously.
@@ -204,10 +302,36 @@ public:
                  BufferDescriptor const &dstDesc,
                  ID3D11DeviceContext *deviceContext);
 
-    /// Wait the dispatched kernel finishes.
+    /// Wait the dispatched kernel finishes (no-op on a deferred context).
     static void Synchronize(ID3D11DeviceContext *deviceContext);
 
+    /// \brief Returns the work group size of the kernels compiled on the
+    ///        device of 'deviceContext' by Create() : a multiple of the
+    ///        SIMD width of the vendor of its adapter.
+    static int GetWorkGroupSize(ID3D11DeviceContext *deviceContext);
+
 private:
+    // binds the state shared by the dispatches of a batch
+    void beginDispatches(ID3D11DeviceContext *deviceContext) const;
+
+    // dispatches the stencils [start, end) of a table, setting the compute
+    // shader only if it differs from 'boundKernel'
+    void dispatchStencils(ID3D11UnorderedAccessView *srcUAV,
+                          BufferDescriptor const &srcDesc,
+                          ID3D11UnorderedAccessView *dstUAV,
+                          BufferDescriptor const &dstDesc,
+                          ID3D11ShaderResourceView *sizesSRV,
+                          ID3D11ShaderResourceView *offsetsSRV,
+                          ID3D11ShaderResourceView *indicesSRV,
+                          ID3D11ShaderResourceView *weightsSRV,
+                          int start,
+                          int end,
+                          ID3D11ClassInstance **boundKernel,
+                          ID3D11DeviceContext *deviceContext) const;
+
+    // unbinds the stencil tables and vertex buffers of a batch
+    void endDispatches(ID3D11DeviceContext *deviceContext) const;
+
     ID3D11ComputeShader * _computeShader;
     ID3D11ClassLinkage  * _classLinkage;
     ID3D11ClassInstance * _singleBufferKernel;
@@ -0,0 +1,111 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/d3d11GpuTimer.h"
+
+#include <D3D11.h>
+
+#define SAFE_RELEASE(p) { if(p) { (p)->Release(); (p)=NULL; } }
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+D3D11GpuTimer::D3D11GpuTimer() :
+    _deviceContext(NULL), _disjoint(NULL), _begin(NULL), _end(NULL) {
+}
+
+D3D11GpuTimer::~D3D11GpuTimer() {
+    SAFE_RELEASE(_disjoint);
+    SAFE_RELEASE(_begin);
+    SAFE_RELEASE(_end);
+}
+
+void
+D3D11GpuTimer::Begin(void * deviceContext) {
+    ID3D11DeviceContext * context =
+        static_cast<ID3D11DeviceContext *>(deviceContext);
+    if (context == NULL) return;
+
+    if (_disjoint == NULL) {
+        ID3D11Device *device = NULL;
+        context->GetDevice(&device);
+
+        D3D11_QUERY_DESC desc;
+        desc.MiscFlags = 0;
+        desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        device->CreateQuery(&desc, &_disjoint);
+        desc.Query = D3D11_QUERY_TIMESTAMP;
+        device->CreateQuery(&desc, &_begin);
+        device->CreateQuery(&desc, &_end);
+        SAFE_RELEASE(device);
+
+        if (not (_disjoint and _begin and _end)) {
+            SAFE_RELEASE(_disjoint);
+            SAFE_RELEASE(_begin);
+            SAFE_RELEASE(_end);
+            return;
+        }
+    }
+    _deviceContext = deviceContext;
+
+    context->Begin(_disjoint);
+    context->End(_begin);
+}
+
+void
+D3D11GpuTimer::End(void * deviceContext) {
+    ID3D11DeviceContext * context =
+        static_cast<ID3D11DeviceContext *>(deviceContext);
+    if (context == NULL or _disjoint == NULL) return;
+
+    context->End(_end);
+    context->End(_disjoint);
+}
+
+double
+D3D11GpuTimer::GetElapsedTime(bool wait) {
+    ID3D11DeviceContext * context =
+        static_cast<ID3D11DeviceContext *>(_deviceContext);
+    if (context == NULL) return -1.0;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+    UINT64 begin = 0, end = 0;
+    for (;;) {
+        if (context->GetData(_disjoint, &disjoint, sizeof(disjoint), 0) == S_OK
+            and context->GetData(_begin, &begin, sizeof(begin), 0) == S_OK
+            and context->GetData(_end, &end, sizeof(end), 0) == S_OK) break;
+        if (not wait) return -1.0;
+    }
+    if (disjoint.Disjoint or disjoint.Frequency == 0) return -1.0;
+
+    return (double)(end - begin) * 1000.0 / (double)disjoint.Frequency;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
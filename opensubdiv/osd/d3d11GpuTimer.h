@@ -0,0 +1,81 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_D3D11_GPU_TIMER_H
+#define OPENSUBDIV3_OSD_D3D11_GPU_TIMER_H
+
+#include "../version.h"
+
+struct ID3D11Query;
+
+#include "../osd/gpuTimer.h"
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief GPU timer of the D3D11ComputeEvaluator, from timestamp queries
+///        issued into the immediate context of the device
+///
+/// The deviceContext of Begin() and End() is the ID3D11DeviceContext of the
+/// evaluator calls (deferred contexts cannot time their commands).
+///
+class D3D11GpuTimer : public GpuTimer, private NonCopyable<D3D11GpuTimer> {
+public:
+    /// \brief Constructor (the queries are created on the first Begin())
+    D3D11GpuTimer();
+
+    /// \brief Destructor
+    virtual ~D3D11GpuTimer();
+
+    /// \brief Records the start of the timed work into an
+    ///        ID3D11DeviceContext
+    virtual void Begin(void * deviceContext = 0);
+
+    /// \brief Records the end of the timed work into an ID3D11DeviceContext
+    virtual void End(void * deviceContext = 0);
+
+    /// \brief Returns the time of the timed work in milliseconds (negative
+    ///        if the GPU frequency changed meanwhile, e.g. unplugged laptop)
+    virtual double GetElapsedTime(bool wait = true);
+
+private:
+    void * _deviceContext;      // ID3D11DeviceContext of the queries
+    ID3D11Query * _disjoint,
+                * _begin,
+                * _end;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_D3D11_GPU_TIMER_H
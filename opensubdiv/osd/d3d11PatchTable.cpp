@@ -34,13 +34,16 @@ namespace OPENSUBDIV_VERSION {
 namespace Osd {
 
 D3D11PatchTable::D3D11PatchTable() :
-    _indexBuffer(0), _patchParamBuffer(0), _patchParamBufferSRV(0) {
+    _indexBuffer(0), _patchParamBuffer(0), _patchParamBufferSRV(0),
+    _compactIndexBuffer(0), _wideIndexBuffer(0) {
 }
 
 D3D11PatchTable::~D3D11PatchTable() {
     if (_indexBuffer) _indexBuffer->Release();
     if (_patchParamBuffer) _patchParamBuffer->Release();
     if (_patchParamBufferSRV) _patchParamBufferSRV->Release();
+    if (_compactIndexBuffer) _compactIndexBuffer->Release();
+    if (_wideIndexBuffer) _wideIndexBuffer->Release();
 }
 
 D3D11PatchTable *
@@ -53,51 +56,92 @@ D3D11PatchTable::Create(Far::PatchTable const *farPatchTable,
     return 0;
 }
 
-bool
-D3D11PatchTable::allocate(Far::PatchTable const *farPatchTable,
-                          ID3D11DeviceContext *pd3d11DeviceContext) {
-    ID3D11Device *pd3d11Device = NULL;
-    pd3d11DeviceContext->GetDevice(&pd3d11Device);
-    assert(pd3d11Device);
-
-    CpuPatchTable patchTable(farPatchTable);
-
-    size_t numPatchArrays = patchTable.GetNumPatchArrays();
-    size_t indexSize = patchTable.GetPatchIndexSize();
-    size_t patchParamSize = patchTable.GetPatchParamSize();
-
-    // copy patch array
-    _patchArrays.assign(patchTable.GetPatchArrayBuffer(),
-                        patchTable.GetPatchArrayBuffer() + numPatchArrays);
+D3D11PatchTable *
+D3D11PatchTable::CreateCompact(Far::PatchTable const *farPatchTable,
+                               ID3D11DeviceContext *pd3d11DeviceContext) {
+    D3D11PatchTable *instance = new D3D11PatchTable();
+    if (instance->allocate(farPatchTable, pd3d11DeviceContext,
+                           /*compactIndices*/ true))
+        return instance;
+    delete instance;
+    return 0;
+}
 
-    // index buffer
+static bool
+createIndexBuffer(ID3D11Device *pd3d11Device,
+                  ID3D11DeviceContext *pd3d11DeviceContext,
+                  void const *indices, size_t numIndices, int indexSize,
+                  ID3D11Buffer **buffer) {
     D3D11_BUFFER_DESC bd;
     ZeroMemory(&bd, sizeof(bd));
-    bd.ByteWidth = (int)indexSize * sizeof(int);
+    bd.ByteWidth = (int)numIndices * indexSize;
     bd.Usage = D3D11_USAGE_DYNAMIC;
     bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
     bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     bd.MiscFlags = 0;
-    bd.StructureByteStride = sizeof(int);
-    HRESULT hr = pd3d11Device->CreateBuffer(&bd, NULL, &_indexBuffer);
+    bd.StructureByteStride = indexSize;
+    HRESULT hr = pd3d11Device->CreateBuffer(&bd, NULL, buffer);
     if (FAILED(hr)) {
         return false;
     }
 
     D3D11_MAPPED_SUBRESOURCE mappedResource;
-    hr = pd3d11DeviceContext->Map(_indexBuffer, 0,
+    hr = pd3d11DeviceContext->Map(*buffer, 0,
                                   D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
     if (FAILED(hr)) {
         return false;
     }
-    unsigned int * indexBuffer = (unsigned int *) mappedResource.pData;
-    memcpy(indexBuffer,
-           patchTable.GetPatchIndexBuffer(),
-           indexSize * sizeof(unsigned int));
+    memcpy(mappedResource.pData, indices, numIndices * indexSize);
+
+    pd3d11DeviceContext->Unmap(*buffer, 0);
+    return true;
+}
 
-    pd3d11DeviceContext->Unmap(_indexBuffer, 0);
+bool
+D3D11PatchTable::allocate(Far::PatchTable const *farPatchTable,
+                          ID3D11DeviceContext *pd3d11DeviceContext,
+                          bool compactIndices) {
+    ID3D11Device *pd3d11Device = NULL;
+    pd3d11DeviceContext->GetDevice(&pd3d11Device);
+    assert(pd3d11Device);
+
+    CpuPatchTable patchTable(farPatchTable, compactIndices);
+
+    size_t numPatchArrays = patchTable.GetNumPatchArrays();
+    size_t indexSize = patchTable.GetPatchIndexSize();
+    size_t patchParamSize = patchTable.GetPatchParamSize();
+
+    // copy patch array
+    _patchArrays.assign(patchTable.GetPatchArrayBuffer(),
+                        patchTable.GetPatchArrayBuffer() + numPatchArrays);
+
+    // index buffers
+    if (compactIndices) {
+        _compactPatchArrays.assign(patchTable.GetCompactPatchArrayBuffer(),
+            patchTable.GetCompactPatchArrayBuffer() +
+                patchTable.GetNumCompactPatchArrays());
+
+        if (!createIndexBuffer(pd3d11Device, pd3d11DeviceContext,
+                patchTable.GetCompactPatchIndexBuffer(),
+                patchTable.GetCompactPatchIndexSize(), sizeof(unsigned short),
+                &_compactIndexBuffer)) {
+            return false;
+        }
+        if (patchTable.GetWidePatchIndexSize() &&
+            !createIndexBuffer(pd3d11Device, pd3d11DeviceContext,
+                patchTable.GetWidePatchIndexBuffer(),
+                patchTable.GetWidePatchIndexSize(), sizeof(unsigned int),
+                &_wideIndexBuffer)) {
+            return false;
+        }
+    } else if (!createIndexBuffer(pd3d11Device, pd3d11DeviceContext,
+                   patchTable.GetPatchIndexBuffer(), indexSize,
+                   sizeof(unsigned int), &_indexBuffer)) {
+        return false;
+    }
 
     // patchparam buffer
+    D3D11_BUFFER_DESC bd;
     ZeroMemory(&bd, sizeof(bd));
     bd.ByteWidth = (int)patchParamSize * sizeof(PatchParam);
     bd.Usage = D3D11_USAGE_DYNAMIC;
@@ -105,7 +149,7 @@ D3D11PatchTable::allocate(Far::PatchTable const *farPatchTable,
     bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
     bd.MiscFlags = 0;
     bd.StructureByteStride = sizeof(PatchParam);
-    hr = pd3d11Device->CreateBuffer(&bd, NULL, &_patchParamBuffer);
+    HRESULT hr = pd3d11Device->CreateBuffer(&bd, NULL, &_patchParamBuffer);
     if (FAILED(hr)) {
         return false;
     }
@@ -121,6 +165,7 @@ D3D11PatchTable::allocate(Far::PatchTable const *farPatchTable,
     if (FAILED(hr)) {
         return false;
     }
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
     hr = pd3d11DeviceContext->Map(_patchParamBuffer, 0,
                                   D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
     if (FAILED(hr)) {
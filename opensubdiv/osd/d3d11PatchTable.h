@@ -62,6 +62,21 @@ public:
     static D3D11PatchTable *Create(Far::PatchTable const *farPatchTable,
                                    ID3D11DeviceContext *deviceContext);
 
+    /// \brief Creates a patch table with the control vertices of the
+    /// patches encoded as 16-bit offsets where possible (see
+    /// CpuPatchTable::GetCompactPatchArrayBuffer) : each compact patch array
+    /// is drawn from the index buffer matching its index size
+    /// (DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT), with its vertex base
+    /// as BaseVertexLocation of DrawIndexed().
+    template<typename DEVICE_CONTEXT>
+    static D3D11PatchTable *CreateCompact(Far::PatchTable const *farPatchTable,
+                                          DEVICE_CONTEXT context) {
+        return CreateCompact(farPatchTable, context->GetDeviceContext());
+    }
+
+    static D3D11PatchTable *CreateCompact(Far::PatchTable const *farPatchTable,
+                                          ID3D11DeviceContext *deviceContext);
+
     PatchArrayVector const &GetPatchArrays() const {
         return _patchArrays;
     }
@@ -76,16 +91,39 @@ public:
         return _patchParamBufferSRV;
     }
 
+    /// Returns the patch arrays of the compact encoding (empty unless
+    /// created with CreateCompact)
+    CompactPatchArrayVector const &GetCompactPatchArrays() const {
+        return _compactPatchArrays;
+    }
+
+    /// Returns the index buffer containing the 16-bit control vertices of
+    /// the compact patch arrays
+    ID3D11Buffer* GetCompactPatchIndexBuffer() const {
+        return _compactIndexBuffer;
+    }
+
+    /// Returns the index buffer containing the 32-bit control vertices of
+    /// the compact patch arrays spanning more than 16 bits (NULL if none)
+    ID3D11Buffer* GetWidePatchIndexBuffer() const {
+        return _wideIndexBuffer;
+    }
+
 protected:
     // allocate buffers from patchTable
     bool allocate(Far::PatchTable const *farPatchTable,
-                  ID3D11DeviceContext *deviceContext);
+                  ID3D11DeviceContext *deviceContext,
+                  bool compactIndices = false);
 
     PatchArrayVector _patchArrays;
 
     ID3D11Buffer             *_indexBuffer;
     ID3D11Buffer             *_patchParamBuffer;
     ID3D11ShaderResourceView *_patchParamBufferSRV;
+
+    CompactPatchArrayVector   _compactPatchArrays;
+    ID3D11Buffer             *_compactIndexBuffer;
+    ID3D11Buffer             *_wideIndexBuffer;
 };
 
 
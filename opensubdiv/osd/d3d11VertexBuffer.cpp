@@ -24,6 +24,7 @@
 
 #include "../osd/d3d11VertexBuffer.h"
 #include "../far/error.h"
+#include "../far/profile.h"
 
 #include <D3D11.h>
 #include <cassert>
@@ -64,6 +65,8 @@ void
 D3D11VertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
                               ID3D11DeviceContext *deviceContext) {
 
+    OPENSUBDIV_PROFILE_ZONE("D3D11VertexBuffer::UpdateData");
+
     assert(deviceContext);
 
     D3D11_MAPPED_SUBRESOURCE resource;
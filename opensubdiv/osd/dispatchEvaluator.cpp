@@ -0,0 +1,283 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/dispatchEvaluator.h"
+#include "../osd/cpuEvaluator.h"
+#include "../far/profile.h"
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include "../osd/ompEvaluator.h"
+    #include <omp.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include "../osd/tbbEvaluator.h"
+    #include <tbb/tick_count.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+    //  Workload (weights times primvar elements) from which the threaded
+    //  backend is selected until calibrated -- about a thousand stencils of
+    //  xyz coordinates, below which starting threads costs more than it gains
+    size_t g_threshold = 16 * 1024 * 3;
+
+    DispatchEvaluator::Backend
+    threadedBackend() {
+#if defined(OPENSUBDIV_HAS_OPENMP)
+        return DispatchEvaluator::BACKEND_OMP;
+#elif defined(OPENSUBDIV_HAS_TBB)
+        return DispatchEvaluator::BACKEND_TBB;
+#else
+        return DispatchEvaluator::BACKEND_CPU;
+#endif
+    }
+
+    //  Offsets of the stencils of a range are increasing :
+    inline size_t
+    countWeights(const int * sizes, const int * offsets, int start, int end) {
+        return (end > start) ?
+            (size_t)(offsets[end-1] + sizes[end-1] - offsets[start]) : 0;
+    }
+
+#if defined(OPENSUBDIV_HAS_OPENMP) || defined(OPENSUBDIV_HAS_TBB)
+    inline double
+    getTime() {
+#if defined(OPENSUBDIV_HAS_OPENMP)
+        return omp_get_wtime();
+#else
+        static tbb::tick_count const origin = tbb::tick_count::now();
+        return (tbb::tick_count::now() - origin).seconds();
+#endif
+    }
+
+    //  Returns the best of a few evaluations of the range [0, end) of the
+    //  stencils of the calibration table with a backend
+    double
+    timeEvaluation(DispatchEvaluator::Backend backend,
+                   std::vector<float> const & src, BufferDescriptor const & srcDesc,
+                   std::vector<float> & dst, BufferDescriptor const & dstDesc,
+                   std::vector<int> const & sizes, std::vector<int> const & offsets,
+                   std::vector<int> const & indices, std::vector<float> const & weights,
+                   int end) {
+
+        double best = 0.0;
+        for (int run = 0; run < 3; ++run) {
+            double start = getTime();
+            if (backend == DispatchEvaluator::BACKEND_CPU) {
+                CpuEvaluator::EvalStencils(&src[0], srcDesc, &dst[0], dstDesc,
+                    &sizes[0], &offsets[0], &indices[0], &weights[0], 0, end);
+            } else {
+#if defined(OPENSUBDIV_HAS_OPENMP)
+                OmpEvaluator::EvalStencils(&src[0], srcDesc, &dst[0], dstDesc,
+                    &sizes[0], &offsets[0], &indices[0], &weights[0], 0, end);
+#else
+                TbbEvaluator::EvalStencils(&src[0], srcDesc, &dst[0], dstDesc,
+                    &sizes[0], &offsets[0], &indices[0], &weights[0], 0, end);
+#endif
+            }
+            double elapsed = getTime() - start;
+            best = (run == 0) ? elapsed : std::min(best, elapsed);
+        }
+        return best;
+    }
+#endif
+}
+
+/* static */
+bool
+DispatchEvaluator::IsAvailable(Backend backend) {
+
+    switch (backend) {
+        case BACKEND_CPU:
+            return true;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        case BACKEND_OMP:
+            return true;
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+        case BACKEND_TBB:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/* static */
+DispatchEvaluator::Backend
+DispatchEvaluator::SelectBackend(size_t numWeights, int length) {
+
+    return (numWeights * (size_t)std::max(length, 1) < g_threshold) ?
+        BACKEND_CPU : threadedBackend();
+}
+
+/* static */
+size_t
+DispatchEvaluator::GetThreshold() {
+    return g_threshold;
+}
+
+/* static */
+void
+DispatchEvaluator::SetThreshold(size_t workload) {
+    g_threshold = workload;
+}
+
+/* static */
+bool
+DispatchEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end) {
+
+    Backend backend = SelectBackend(
+        countWeights(sizes, offsets, start, end), srcDesc.length);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    if (backend == BACKEND_OMP) {
+        return OmpEvaluator::EvalStencils(src, srcDesc, dst, dstDesc,
+            sizes, offsets, indices, weights, start, end);
+    }
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    if (backend == BACKEND_TBB) {
+        return TbbEvaluator::EvalStencils(src, srcDesc, dst, dstDesc,
+            sizes, offsets, indices, weights, start, end);
+    }
+#endif
+    (void)backend;
+    return CpuEvaluator::EvalStencils(src, srcDesc, dst, dstDesc,
+        sizes, offsets, indices, weights, start, end);
+}
+
+/* static */
+bool
+DispatchEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    int start, int end) {
+
+    //  Derivatives triple the weights accumulated:
+    Backend backend = SelectBackend(
+        3 * countWeights(sizes, offsets, start, end), srcDesc.length);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    if (backend == BACKEND_OMP) {
+        return OmpEvaluator::EvalStencils(src, srcDesc, dst, dstDesc,
+            du, duDesc, dv, dvDesc, sizes, offsets, indices,
+            weights, duWeights, dvWeights, start, end);
+    }
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    if (backend == BACKEND_TBB) {
+        return TbbEvaluator::EvalStencils(src, srcDesc, dst, dstDesc,
+            du, duDesc, dv, dvDesc, sizes, offsets, indices,
+            weights, duWeights, dvWeights, start, end);
+    }
+#endif
+    (void)backend;
+    return CpuEvaluator::EvalStencils(src, srcDesc, dst, dstDesc,
+        du, duDesc, dv, dvDesc, sizes, offsets, indices,
+        weights, duWeights, dvWeights, start, end);
+}
+
+/* static */
+size_t
+DispatchEvaluator::Calibrate() {
+
+#if defined(OPENSUBDIV_HAS_OPENMP) || defined(OPENSUBDIV_HAS_TBB)
+    OPENSUBDIV_PROFILE_ZONE("DispatchEvaluator::Calibrate");
+
+    //  Stencils of the size of those of refined vertices around valence 4
+    //  vertices, gathering xyz coordinates scattered over the control vertices
+    int const numControlVerts = 16 * 1024,
+              stencilSize = 16,
+              maxStencils = 64 * 1024,
+              length = 3;
+
+    std::vector<float> src(numControlVerts * length, 1.0f),
+                       dst(maxStencils * length);
+    std::vector<int> sizes(maxStencils, stencilSize),
+                     offsets(maxStencils),
+                     indices(maxStencils * stencilSize);
+    std::vector<float> weights(maxStencils * stencilSize, 1.0f / stencilSize);
+
+    for (int i = 0; i < maxStencils; ++i) {
+        offsets[i] = i * stencilSize;
+        for (int j = 0; j < stencilSize; ++j) {
+            indices[i * stencilSize + j] =
+                (int)(((unsigned int)i * 7 + (unsigned int)j * 131) % numControlVerts);
+        }
+    }
+    BufferDescriptor srcDesc(0, length, length),
+                     dstDesc(0, length, length);
+
+    //  The threshold is the workload of the smallest table, of doubling
+    //  sizes, evaluated faster by the threaded backend
+    size_t threshold = (size_t)maxStencils * stencilSize * length * 2;
+#if defined(OPENSUBDIV_HAS_OPENMP)
+    if (omp_get_max_threads() < 2) {
+        g_threshold = threshold;
+        return g_threshold;
+    }
+#endif
+    for (int numStencils = 64; numStencils <= maxStencils; numStencils *= 2) {
+        double serial = timeEvaluation(BACKEND_CPU, src, srcDesc, dst, dstDesc,
+            sizes, offsets, indices, weights, numStencils);
+        double threaded = timeEvaluation(threadedBackend(), src, srcDesc, dst, dstDesc,
+            sizes, offsets, indices, weights, numStencils);
+        if (threaded < serial) {
+            threshold = (size_t)numStencils * stencilSize * length;
+            break;
+        }
+    }
+    g_threshold = threshold;
+#endif
+    return g_threshold;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,268 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_DISPATCH_EVALUATOR_H
+#define OPENSUBDIV3_OSD_DISPATCH_EVALUATOR_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+#include "../osd/types.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+///  \brief Evaluator choosing between the serial and threaded CPU backends
+///         on each call, based on the size of the workload
+///
+///  Small tables are evaluated faster by the CpuEvaluator than by a threaded
+///  backend, whose cost of starting threads dominates.  The DispatchEvaluator
+///  evaluates the stencils of a call with the CpuEvaluator when the number of
+///  weights of the stencils times the number of elements of the primvar is
+///  below a threshold, and with the OmpEvaluator or TbbEvaluator (whichever
+///  the library was built with, OpenMP first) otherwise.
+///
+///  The threshold is either measured by Calibrate() on the machine, or set
+///  from a value the client measured earlier and persisted (e.g. per host).
+///
+///  Like the CPU backends it dispatches to, the DispatchEvaluator evaluates
+///  buffers resident in host memory (with a BindCpuBuffer() method).
+///
+class DispatchEvaluator {
+public:
+    /// \brief Backends the evaluations are dispatched to
+    enum Backend {
+        BACKEND_CPU = 0,  ///< CpuEvaluator (serial)
+        BACKEND_OMP,      ///< OmpEvaluator
+        BACKEND_TBB       ///< TbbEvaluator
+    };
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with StencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function. This function has a same
+    ///        signature as other device kernels have so that it can be called
+    ///        in the same way from OsdMesh template interface.
+    ///
+    /// (see CpuEvaluator::EvalStencils() for the arguments -- each pass of
+    /// a table of several passes is dispatched on its own)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        const DispatchEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        // Passes refer to the vertices of the previous passes : they are
+        // evaluated in order (see Far::StencilTable::GetPassOffsets())
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            // the kernels write the first stencil of the range at the
+            // offset of the descriptor
+            BufferDescriptor passDesc = dstDesc;
+            passDesc.offset += start * dstDesc.stride;
+
+            if (not EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                                 dstBuffer->BindCpuBuffer(), passDesc,
+                                 &stencilTable->GetSizes()[0],
+                                 &stencilTable->GetOffsets()[0],
+                                 &stencilTable->GetControlIndices()[0],
+                                 &stencilTable->GetWeights()[0],
+                                 start, end)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Generic static eval stencils function evaluating the range
+    ///        [start, end) of the stencils of a table only (see
+    ///        CpuEvaluator::EvalStencilRange())
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        const DispatchEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (end <= start) return true;
+
+        // the kernels write the first stencil of the range at the
+        // offset of the descriptor
+        BufferDescriptor rangeDesc = dstDesc;
+        rangeDesc.offset += start * dstDesc.stride;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), rangeDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            start, end);
+    }
+
+    /// \brief Static eval stencils function which takes raw CPU pointers for
+    ///        input and output (see CpuEvaluator::EvalStencils())
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with derivatives (see
+    ///        CpuEvaluator::EvalStencils())
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        const DispatchEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with derivatives, which takes
+    ///        raw CPU pointers for input and output (see
+    ///        CpuEvaluator::EvalStencils())
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Backend selection
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Returns true if the library was built with the backend
+    static bool IsAvailable(Backend backend);
+
+    /// \brief Returns the backend evaluating 'numWeights' weights of stencils
+    ///        for primvars of 'length' elements
+    static Backend SelectBackend(size_t numWeights, int length);
+
+    /// \brief Returns the workload (weights times primvar elements) from
+    ///        which the threaded backend is selected
+    static size_t GetThreshold();
+
+    /// \brief Sets the workload from which the threaded backend is selected,
+    ///        e.g. as measured by an earlier Calibrate() on the same machine
+    static void SetThreshold(size_t workload);
+
+    /// \brief Measures the workload from which the threaded backend evaluates
+    ///        stencils faster than the serial one with a short benchmark (a
+    ///        fraction of a second at most), then sets and returns it as the
+    ///        threshold
+    ///
+    /// The threshold is left unchanged, and returned, when no threaded
+    /// backend is available.  It selects the serial backend for all the
+    /// workloads benchmarked when the threaded one is never faster (e.g.
+    /// on a single core).
+    ///
+    static size_t Calibrate();
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Other methods
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief synchronize all asynchronous computation invoked on this device.
+    static void Synchronize(void * /*deviceContext = NULL*/) {
+        // nothing.
+    }
+};
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_DISPATCH_EVALUATOR_H
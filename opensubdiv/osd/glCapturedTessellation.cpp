@@ -0,0 +1,92 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/glCapturedTessellation.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+GLCapturedTessellation::GLCapturedTessellation() : _numElements(0) {
+}
+
+GLCapturedTessellation::~GLCapturedTessellation() {
+    for (int i = 0; i < (int)_tessellatedTables.size(); ++i) {
+        delete _tessellatedTables[i];
+    }
+    for (int i = 0; i < (int)_vertexBuffers.size(); ++i) {
+        delete _vertexBuffers[i];
+    }
+}
+
+GLCapturedTessellation *
+GLCapturedTessellation::Create(int numElements,
+                               int maxVertices, int maxTriangles,
+                               int numLevels, void * /*deviceContext*/) {
+    if (numElements <= 0 || numLevels <= 0) return 0;
+
+    GLCapturedTessellation *instance = new GLCapturedTessellation();
+    if (instance->allocate(numElements, maxVertices, maxTriangles, numLevels)) {
+        return instance;
+    }
+    delete instance;
+    return 0;
+}
+
+bool
+GLCapturedTessellation::allocate(int numElements,
+                                 int maxVertices, int maxTriangles,
+                                 int numLevels) {
+
+    _numElements = numElements;
+
+    for (int level = 0; level < numLevels; ++level) {
+        GLTessellatedPatchTable *table =
+            GLTessellatedPatchTable::Create(maxVertices, maxTriangles);
+        if (!table) return false;
+        _tessellatedTables.push_back(table);
+
+        GLVertexBuffer *vertexBuffer =
+            GLVertexBuffer::Create(numElements, maxVertices);
+        if (!vertexBuffer) return false;
+        _vertexBuffers.push_back(vertexBuffer);
+    }
+    return true;
+}
+
+GLuint
+GLCapturedTessellation::GetVertexBuffer(int level) const {
+    return _vertexBuffers[level]->BindVBO();
+}
+
+void
+GLCapturedTessellation::endCapture() const {
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
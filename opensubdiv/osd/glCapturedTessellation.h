@@ -0,0 +1,184 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_GL_CAPTURED_TESSELLATION_H
+#define OPENSUBDIV3_OSD_GL_CAPTURED_TESSELLATION_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+#include "../osd/opengl.h"
+#include "../osd/bufferDescriptor.h"
+#include "../osd/glComputeTessellator.h"
+#include "../osd/glVertexBuffer.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+class GLPatchTable;
+
+///
+/// \brief Tessellated vertices of the patches of a GLPatchTable, captured
+///        once to be drawn as plain triangles by several passes
+///
+/// Rather than running the tessellation stages of the patch shaders for
+/// each view (depth prepass, cascades of shadow maps...), the patches are
+/// tessellated by a GLComputeTessellator and their vertices evaluated once
+/// per frame, after the control vertices are refined. Each pass then draws
+/// the captured triangles :
+///
+///   glBindBuffer(GL_ARRAY_BUFFER, capture->GetVertexBuffer(level));
+///   ... attributes in the layout of GetNumElements() floats per vertex
+///   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, capture->GetIndexBuffer(level));
+///   glBindBuffer(GL_DRAW_INDIRECT_BUFFER,
+///                capture->GetDrawIndirectBuffer(level));
+///   glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0);
+///
+/// A capture can hold several levels of tessellation : level L is
+/// tessellated at the edge rates divided by 2^L (see the rateShift of
+/// GLComputeTessellator::Tessellate()), so that views needing less detail
+/// (e.g. distant shadow cascades) can draw a coarser level. All the levels
+/// have the same capacity.
+///
+class GLCapturedTessellation : private NonCopyable<GLCapturedTessellation> {
+public:
+    /// \brief Creates the buffers of the levels of a capture
+    ///
+    /// @param numElements   Number of floats of each evaluated vertex
+    ///
+    /// @param maxVertices   Maximum number of vertices of each level
+    ///
+    /// @param maxTriangles  Maximum number of triangles of each level
+    ///
+    /// @param numLevels     Number of levels of tessellation
+    ///
+    static GLCapturedTessellation *Create(int numElements,
+                                          int maxVertices, int maxTriangles,
+                                          int numLevels = 1,
+                                          void *deviceContext = NULL);
+
+    /// Destructor. note that the GL context must be made current.
+    ~GLCapturedTessellation();
+
+    /// \brief Tessellates the patches and evaluates the vertices of all the
+    ///        levels
+    ///
+    /// @param srcBuffer       Control vertices of the patches, with a
+    ///                        BindVBO() method
+    ///
+    /// @param srcDesc         Vertex buffer descriptor of the control
+    ///                        vertices (of length GetNumElements())
+    ///
+    /// @param patchTable      GLPatchTable of the patches
+    ///
+    /// @param edgeRateBuffer  GL buffer of the edge rates of the patches (see
+    ///                        GLComputeTessellator::Tessellate())
+    ///
+    /// @param tessellator     Tessellator of the patches
+    ///
+    /// @param evaluator       GLComputeEvaluator (or equivalent) compiled for
+    ///                        srcDesc and the layout of the captured
+    ///                        vertices (BufferDescriptor(0, n, n) with n =
+    ///                        GetNumElements())
+    ///
+    template <typename SRC_BUFFER, typename EVALUATOR>
+    bool Capture(SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+                 GLPatchTable const *patchTable, GLuint edgeRateBuffer,
+                 GLComputeTessellator const *tessellator,
+                 EVALUATOR const *evaluator) {
+
+        if (!tessellator || !evaluator || srcDesc.length != _numElements) {
+            return false;
+        }
+
+        BufferDescriptor dstDesc(0, _numElements, _numElements);
+        for (int level = 0; level < GetNumLevels(); ++level) {
+            GLTessellatedPatchTable *table = _tessellatedTables[level];
+            if (!tessellator->Tessellate(patchTable, edgeRateBuffer,
+                                         table, level)) {
+                return false;
+            }
+            if (!evaluator->EvalPatches(srcBuffer, srcDesc,
+                                        _vertexBuffers[level], dstDesc,
+                                        table->GetMaxVertices(), table,
+                                        patchTable)) {
+                return false;
+            }
+        }
+        endCapture();
+        return true;
+    }
+
+    /// Returns the number of levels of tessellation
+    int GetNumLevels() const { return (int)_tessellatedTables.size(); }
+
+    /// Returns the number of floats of each evaluated vertex
+    int GetNumElements() const { return _numElements; }
+
+    /// Returns the tessellated patches of a level
+    GLTessellatedPatchTable const *GetTessellatedPatchTable(int level) const {
+        return _tessellatedTables[level];
+    }
+
+    /// Returns the GL buffer of the evaluated vertices of a level
+    GLuint GetVertexBuffer(int level) const;
+
+    /// Returns the GL buffer of the indices of the triangles of a level
+    GLuint GetIndexBuffer(int level) const {
+        return _tessellatedTables[level]->GetIndexBuffer();
+    }
+
+    /// Returns the GL_DRAW_INDIRECT_BUFFER of the triangles of a level
+    GLuint GetDrawIndirectBuffer(int level) const {
+        return _tessellatedTables[level]->GetDrawIndirectBuffer();
+    }
+
+protected:
+    GLCapturedTessellation();
+
+    // allocate the buffers of the levels
+    bool allocate(int numElements, int maxVertices, int maxTriangles,
+                  int numLevels);
+
+    // make the vertices visible to the draws of the following passes
+    void endCapture() const;
+
+    int _numElements;
+
+    std::vector<GLTessellatedPatchTable *> _tessellatedTables;
+    std::vector<GLVertexBuffer *> _vertexBuffers;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_CAPTURED_TESSELLATION_H
@@ -23,14 +23,19 @@
 //
 
 #include "../osd/glComputeEvaluator.h"
+#include "../osd/programCache.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "../far/error.h"
 #include "../far/stencilTable.h"
+#include "../far/profile.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -41,11 +46,45 @@ static const char *shaderSource =
 #include "../osd/glslComputeKernel.gen.h"
 ;
 
+// Arrays larger than a chunk are uploaded a chunk at a time through mapped
+// ranges of the buffer : a single glBufferData call may have the driver stage
+// a host copy of the whole array, doubling the memory of large tables.
+static const GLsizeiptr UPLOAD_CHUNK_SIZE = 16 << 20;
+
+static void
+uploadBufferChunks(GLenum target, GLsizeiptr size, const void *data) {
+    glBufferData(target, size, NULL, GL_STATIC_DRAW);
+
+    const unsigned char *src = static_cast<const unsigned char *>(data);
+    for (GLsizeiptr offset = 0; offset < size; offset += UPLOAD_CHUNK_SIZE) {
+        GLsizeiptr chunk = std::min(UPLOAD_CHUNK_SIZE, size - offset);
+        void *dst = glMapBufferRange(target, offset, chunk,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            memcpy(dst, src + offset, chunk);
+            glUnmapBuffer(target);
+        } else {
+            glBufferSubData(target, offset, chunk, src + offset);
+        }
+    }
+}
+
 template <class T> GLuint
 createSSBO(std::vector<T> const & src) {
     GLuint devicePtr = 0;
     glGenBuffers(1, &devicePtr);
 
+    GLsizeiptr size = src.size()*sizeof(T);
+    if (size > UPLOAD_CHUNK_SIZE) {
+        GLint prev = 0;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_BINDING, &prev);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, devicePtr);
+        uploadBufferChunks(GL_SHADER_STORAGE_BUFFER, size, &src.at(0));
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, prev);
+        return devicePtr;
+    }
+
 #if defined(GL_EXT_direct_state_access)
     if (glNamedBufferDataEXT) {
         glNamedBufferDataEXT(devicePtr, src.size()*sizeof(T),
@@ -74,6 +113,7 @@ GLStencilTableSSBO::GLStencilTableSSBO(
         _indices = createSSBO(stencilTable->GetControlIndices());
         _weights = createSSBO(stencilTable->GetWeights());
         _duWeights = _dvWeights = 0;
+        _passOffsets = stencilTable->GetPassOffsets();
     } else {
         _sizes = _offsets = _indices = _weights = 0;
         _duWeights = _dvWeights = 0;
@@ -96,6 +136,22 @@ GLStencilTableSSBO::GLStencilTableSSBO(
     }
 }
 
+GLStencilTableSSBO *
+GLStencilTableSSBO::CreateAndRelease(Far::StencilTable *stencilTable,
+                                     void *deviceContext) {
+    GLStencilTableSSBO *table = Create(stencilTable, deviceContext);
+    stencilTable->Clear();
+    return table;
+}
+
+GLStencilTableSSBO *
+GLStencilTableSSBO::CreateAndRelease(Far::LimitStencilTable *limitStencilTable,
+                                     void *deviceContext) {
+    GLStencilTableSSBO *table = Create(limitStencilTable, deviceContext);
+    limitStencilTable->Clear();
+    return table;
+}
+
 GLStencilTableSSBO::~GLStencilTableSSBO() {
     if (_sizes)   glDeleteBuffers(1, &_sizes);
     if (_offsets) glDeleteBuffers(1, &_offsets);
@@ -108,14 +164,85 @@ GLStencilTableSSBO::~GLStencilTableSSBO() {
 // ---------------------------------------------------------------------------
 
 
-GLComputeEvaluator::GLComputeEvaluator() : _workGroupSize(64) {
+GLComputeEvaluator::GLComputeEvaluator() :
+    _workGroupSize(GetWorkGroupSize()) {
+    memset (&_stencilKernel, 0, sizeof(_stencilKernel));
+    memset (&_stencilBatchKernel, 0, sizeof(_stencilBatchKernel));
+    memset (&_patchKernel, 0, sizeof(_patchKernel));
+}
+
+GLComputeEvaluator::GLComputeEvaluator(int workGroupSize) :
+    _workGroupSize(workGroupSize) {
     memset (&_stencilKernel, 0, sizeof(_stencilKernel));
+    memset (&_stencilBatchKernel, 0, sizeof(_stencilBatchKernel));
     memset (&_patchKernel, 0, sizeof(_patchKernel));
 }
 
 GLComputeEvaluator::~GLComputeEvaluator() {
 }
 
+// Program binaries are specific to the GPU and the driver, which are part of
+// the key of the binary of a program in the ProgramCache
+static std::string
+getProgramCacheKey(const char * const *sources, int numSources) {
+    std::string key;
+    GLenum names[3] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (int i = 0; i < 3; ++i) {
+        const GLubyte *str = glGetString(names[i]);
+        if (str) key += (const char *)str;
+        key += "\n";
+    }
+    for (int i = 0; i < numSources; ++i) {
+        key += sources[i];
+    }
+    return key;
+}
+
+static GLuint
+loadProgramBinary(std::string const &cacheKey) {
+
+    std::vector<char> binary;
+    if (!ProgramCache::Load(cacheKey, binary) ||
+        binary.size() <= sizeof(GLenum)) {
+        return 0;
+    }
+
+    GLenum format = 0;
+    memcpy(&format, &binary[0], sizeof(GLenum));
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, &binary[sizeof(GLenum)],
+                    (GLsizei)(binary.size() - sizeof(GLenum)));
+
+    // binaries of other drivers or GPUs are rejected
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void
+storeProgramBinary(GLuint program, std::string const &cacheKey) {
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(sizeof(GLenum) + length);
+
+    GLenum format = 0;
+    GLsizei size = 0;
+    glGetProgramBinary(program, length, &size, &format,
+                       &binary[sizeof(GLenum)]);
+    if (size <= 0) return;
+
+    memcpy(&binary[0], &format, sizeof(GLenum));
+    ProgramCache::Store(cacheKey, &binary[0], sizeof(GLenum) + size);
+}
+
 static GLuint
 compileKernel(BufferDescriptor const &srcDesc,
               BufferDescriptor const &dstDesc,
@@ -123,9 +250,6 @@ compileKernel(BufferDescriptor const &srcDesc,
               BufferDescriptor const & /* dvDesc */,
               const char *kernelDefine,
               int workGroupSize) {
-    GLuint program = glCreateProgram();
-
-    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
 
     std::ostringstream defines;
     defines << "#define LENGTH "     << srcDesc.length << "\n"
@@ -138,10 +262,32 @@ compileKernel(BufferDescriptor const &srcDesc,
     const char *shaderSources[3] = {"#version 430\n", 0, 0};
     shaderSources[1] = defineStr.c_str();
     shaderSources[2] = shaderSource;
+
+    // programs compiled by previous processes are loaded from their binaries
+    GLint numBinaryFormats = 0;
+    if (ProgramCache::IsEnabled()) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+    }
+    std::string cacheKey;
+    if (numBinaryFormats > 0) {
+        cacheKey = getProgramCacheKey(shaderSources, 3);
+        GLuint program = loadProgramBinary(cacheKey);
+        if (program) return program;
+    }
+
+    GLuint program = glCreateProgram();
+
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+
     glShaderSource(shader, 3, shaderSources, NULL);
     glCompileShader(shader);
     glAttachShader(program, shader);
 
+    if (numBinaryFormats > 0) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+    }
+
     GLint linked = 0;
     glLinkProgram(program);
     glGetProgramiv(program, GL_LINK_STATUS, &linked);
@@ -160,6 +306,10 @@ compileKernel(BufferDescriptor const &srcDesc,
 
     glDeleteShader(shader);
 
+    if (numBinaryFormats > 0) {
+        storeProgramBinary(program, cacheKey);
+    }
+
     return program;
 }
 
@@ -175,6 +325,13 @@ GLComputeEvaluator::Compile(BufferDescriptor const &srcDesc,
         return false;
     }
 
+    // create a stencil kernel for the instances of a batch
+    if (!_stencilBatchKernel.Compile(srcDesc, dstDesc,
+                                     BufferDescriptor(), BufferDescriptor(),
+                                     _workGroupSize, /*instances=*/true)) {
+        return false;
+    }
+
     // create a patch kernel
     if (!_patchKernel.Compile(srcDesc, dstDesc, duDesc, dvDesc,
                               _workGroupSize)) {
@@ -192,6 +349,126 @@ GLComputeEvaluator::Synchronize(void * /*kernel*/) {
     glFinish();
 }
 
+// ---------------------------------------------------------------------------
+
+// the work group sizes retained by TuneWorkGroupSize() for each device
+typedef std::map<std::string, int> WorkGroupSizeMap;
+static WorkGroupSizeMap tunedWorkGroupSizes;
+
+static std::string
+getDeviceName() {
+    std::string name;
+    GLenum names[2] = { GL_VENDOR, GL_RENDERER };
+    for (int i = 0; i < 2; ++i) {
+        const GLubyte *str = glGetString(names[i]);
+        if (str) name += (const char *)str;
+        name += "\n";
+    }
+    return name;
+}
+
+static int
+getMaxWorkGroupSize() {
+    GLint maxInvocations = 0, maxSizeX = 0;
+    glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &maxInvocations);
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, 0, &maxSizeX);
+    return std::min((int)maxInvocations, (int)maxSizeX);
+}
+
+/* static */
+int
+GLComputeEvaluator::GetWorkGroupSize() {
+    std::string device = getDeviceName();
+
+    WorkGroupSizeMap::const_iterator it = tunedWorkGroupSizes.find(device);
+    if (it != tunedWorkGroupSizes.end()) return it->second;
+
+    // several warps (32 threads) or wavefronts (64 threads) per work group
+    if (device.find("NVIDIA") != std::string::npos) return 128;
+    if (device.find("AMD") != std::string::npos ||
+        device.find("ATI") != std::string::npos) return 256;
+    return 64;
+}
+
+/* static */
+int
+GLComputeEvaluator::TuneWorkGroupSize() {
+    std::string device = getDeviceName();
+
+    // a synthetic table of stencils of 8 scattered control vertices
+    const int numVertices = 1 << 14,
+              numStencils = 1 << 16,
+              stencilSize = 8;
+
+    std::vector<int> sizes(numStencils, stencilSize),
+                     offsets(numStencils),
+                     indices(numStencils * stencilSize);
+    std::vector<float> weights(numStencils * stencilSize,
+                               1.0f / stencilSize);
+    for (int i = 0; i < numStencils; ++i) {
+        offsets[i] = i * stencilSize;
+        for (int j = 0; j < stencilSize; ++j) {
+            indices[i * stencilSize + j] = (i / 4 + j * 131) % numVertices;
+        }
+    }
+    std::vector<float> srcVertices(numVertices * 3, 1.0f),
+                       dstVertices(numStencils * 3, 0.0f);
+
+    GLuint sizesBuffer   = createSSBO(sizes),
+           offsetsBuffer = createSSBO(offsets),
+           indicesBuffer = createSSBO(indices),
+           weightsBuffer = createSSBO(weights),
+           srcBuffer     = createSSBO(srcVertices),
+           dstBuffer     = createSSBO(dstVertices);
+
+    BufferDescriptor desc(0, 3, 3);
+
+    GLuint query = 0;
+    glGenQueries(1, &query);
+
+    int maxWorkGroupSize = getMaxWorkGroupSize();
+
+    int bestWorkGroupSize = GetWorkGroupSize();
+    GLuint64 bestTime = 0;
+    for (int size = 32; size <= std::min(512, maxWorkGroupSize); size *= 2) {
+        GLComputeEvaluator evaluator(size);
+        if (!evaluator.Compile(desc, desc,
+                               BufferDescriptor(), BufferDescriptor())) {
+            continue;
+        }
+
+        // the first dispatch is not timed (program setup)
+        for (int pass = 0; pass < 2; ++pass) {
+            if (pass == 1) glBeginQuery(GL_TIME_ELAPSED, query);
+            for (int k = 0; k < 4; ++k) {
+                evaluator.EvalStencils(srcBuffer, desc, dstBuffer, desc,
+                                       0, BufferDescriptor(),
+                                       0, BufferDescriptor(),
+                                       sizesBuffer, offsetsBuffer,
+                                       indicesBuffer, weightsBuffer,
+                                       0, 0, 0, numStencils);
+            }
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+
+        GLuint64 time = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &time);
+        if (bestTime == 0 || time < bestTime) {
+            bestTime = time;
+            bestWorkGroupSize = size;
+        }
+    }
+
+    glDeleteQueries(1, &query);
+
+    GLuint buffers[6] = { sizesBuffer, offsetsBuffer, indicesBuffer,
+                          weightsBuffer, srcBuffer, dstBuffer };
+    glDeleteBuffers(6, buffers);
+
+    tunedWorkGroupSizes[device] = bestWorkGroupSize;
+    return bestWorkGroupSize;
+}
+
 bool
 GLComputeEvaluator::EvalStencils(
     GLuint srcBuffer, BufferDescriptor const &srcDesc,
@@ -206,6 +483,8 @@ GLComputeEvaluator::EvalStencils(
     GLuint dvWeightsBuffer,
     int start, int end) const {
 
+    OPENSUBDIV_PROFILE_ZONE("GLComputeEvaluator::EvalStencils");
+
     if (!_stencilKernel.program) return false;
     int count = end - start;
     if (count <= 0) {
@@ -244,7 +523,9 @@ GLComputeEvaluator::EvalStencils(
 
     glUseProgram(0);
 
-    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    // (the following passes of the table read the vertices written)
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT |
+                    GL_SHADER_STORAGE_BARRIER_BIT);
     for (int i = 0; i < 10; ++i) {
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
     }
@@ -252,6 +533,66 @@ GLComputeEvaluator::EvalStencils(
     return true;
 }
 
+bool
+GLComputeEvaluator::EvalStencilsBatch(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    GLuint sizesBuffer,
+    GLuint offsetsBuffer,
+    GLuint indicesBuffer,
+    GLuint weightsBuffer,
+    int start, int end,
+    int numInstances, int const * instanceOffsets) const {
+
+    OPENSUBDIV_PROFILE_ZONE("GLComputeEvaluator::EvalStencilsBatch");
+
+    if (!_stencilBatchKernel.program) return false;
+    int count = end - start;
+    if (count <= 0 || numInstances <= 0) {
+        return true;
+    }
+
+    std::vector<int> offsets(instanceOffsets,
+                             instanceOffsets + 2*numInstances);
+    GLuint instanceOffsetsBuffer = createSSBO(offsets);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, srcBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, dstBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, sizesBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, offsetsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, indicesBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, weightsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, instanceOffsetsBuffer);
+
+    glUseProgram(_stencilBatchKernel.program);
+
+    glUniform1i(_stencilBatchKernel.uniformStart,     start);
+    glUniform1i(_stencilBatchKernel.uniformEnd,       end);
+    glUniform1i(_stencilBatchKernel.uniformSrcOffset, srcDesc.offset);
+    glUniform1i(_stencilBatchKernel.uniformDstOffset, dstDesc.offset);
+
+    // the instances are the second dimension of the dispatch (split in
+    // several dispatches past the minimum work group count of GL)
+    int const maxInstances = 65535;
+    for (int base = 0; base < numInstances; base += maxInstances) {
+        glUniform1i(_stencilBatchKernel.uniformInstanceStart, base);
+        glDispatchCompute((count + _workGroupSize - 1) / _workGroupSize,
+                          std::min(maxInstances, numInstances - base), 1);
+    }
+
+    glUseProgram(0);
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    for (int i = 0; i < 11; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+    }
+
+    // deletion is deferred by GL until the dispatches complete
+    glDeleteBuffers(1, &instanceOffsetsBuffer);
+
+    return true;
+}
+
 bool
 GLComputeEvaluator::EvalPatches(
     GLuint srcBuffer, BufferDescriptor const &srcDesc,
@@ -264,6 +605,89 @@ GLComputeEvaluator::EvalPatches(
     GLuint patchIndexBuffer,
     GLuint patchParamsBuffer) const {
 
+    OPENSUBDIV_PROFILE_ZONE("GLComputeEvaluator::EvalPatches");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrays, patchIndexBuffer, patchParamsBuffer,
+                       EVAL_VERTEX);
+}
+
+bool
+GLComputeEvaluator::EvalPatchesFaceVarying(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    GLuint duBuffer,  BufferDescriptor const &duDesc,
+    GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    GLuint patchCoordsBuffer,
+    const PatchArrayVector &fvarPatchArrays,
+    GLuint fvarPatchIndexBuffer,
+    GLuint fvarPatchParamsBuffer) const {
+
+    OPENSUBDIV_PROFILE_ZONE("GLComputeEvaluator::EvalPatchesFaceVarying");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamsBuffer, EVAL_FACE_VARYING);
+}
+
+bool
+GLComputeEvaluator::EvalPatchesVarying(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    GLuint duBuffer,  BufferDescriptor const &duDesc,
+    GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    GLuint patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    GLuint patchIndexBuffer,
+    GLuint patchParamsBuffer) const {
+
+    OPENSUBDIV_PROFILE_ZONE("GLComputeEvaluator::EvalPatchesVarying");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrays, patchIndexBuffer, patchParamsBuffer,
+                       EVAL_VARYING);
+}
+
+bool
+GLComputeEvaluator::EvalPatchesFaceUniform(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    GLuint patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    GLuint patchIndexBuffer,
+    GLuint patchParamsBuffer) const {
+
+    OPENSUBDIV_PROFILE_ZONE("GLComputeEvaluator::EvalPatchesFaceUniform");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       0, BufferDescriptor(), 0, BufferDescriptor(),
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrays, patchIndexBuffer, patchParamsBuffer,
+                       EVAL_FACE_UNIFORM);
+}
+
+bool
+GLComputeEvaluator::evalPatches(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    GLuint duBuffer,  BufferDescriptor const &duDesc,
+    GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    GLuint patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    GLuint patchIndexBuffer,
+    GLuint patchParamsBuffer,
+    int evalMode) const {
+
     if (!_patchKernel.program) return false;
 
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, srcBuffer);
@@ -282,6 +706,7 @@ GLComputeEvaluator::EvalPatches(
                  (const GLint*)&patchArrays[0]);
     glUniform3i(_patchKernel.uniformDuDesc, duDesc.offset, duDesc.length, duDesc.stride);
     glUniform3i(_patchKernel.uniformDvDesc, dvDesc.offset, dvDesc.length, dvDesc.stride);
+    glUniform1i(_patchKernel.uniformEvalMode, evalMode);
 
     glDispatchCompute((numPatchCoords + _workGroupSize - 1) / _workGroupSize, 1, 1);
 
@@ -312,7 +737,8 @@ GLComputeEvaluator::_StencilKernel::Compile(BufferDescriptor const &srcDesc,
                                             BufferDescriptor const &dstDesc,
                                             BufferDescriptor const &duDesc,
                                             BufferDescriptor const &dvDesc,
-                                            int workGroupSize) {
+                                            int workGroupSize,
+                                            bool instances) {
     // create stencil kernel
     if (program) {
         glDeleteProgram(program);
@@ -322,7 +748,10 @@ GLComputeEvaluator::_StencilKernel::Compile(BufferDescriptor const &srcDesc,
     const char *kernelDef = derivatives
         ? "#define OPENSUBDIV_GLSL_COMPUTE_KERNEL_EVAL_STENCILS\n"
           "#define OPENSUBDIV_GLSL_COMPUTE_USE_DERIVATIVES\n"
-        : "#define OPENSUBDIV_GLSL_COMPUTE_KERNEL_EVAL_STENCILS\n";
+        : (instances
+        ? "#define OPENSUBDIV_GLSL_COMPUTE_KERNEL_EVAL_STENCILS\n"
+          "#define OPENSUBDIV_GLSL_COMPUTE_USE_INSTANCES\n"
+        : "#define OPENSUBDIV_GLSL_COMPUTE_KERNEL_EVAL_STENCILS\n");
 
     if (program) {
         glDeleteProgram(program);
@@ -338,6 +767,7 @@ GLComputeEvaluator::_StencilKernel::Compile(BufferDescriptor const &srcDesc,
     uniformDstOffset = glGetUniformLocation(program, "dstOffset");
     uniformDuDesc    = glGetUniformLocation(program, "duDesc");
     uniformDvDesc    = glGetUniformLocation(program, "dvDesc");
+    uniformInstanceStart = glGetUniformLocation(program, "instanceStart");
 
     return true;
 }
@@ -382,6 +812,7 @@ GLComputeEvaluator::_PatchKernel::Compile(BufferDescriptor const &srcDesc,
     uniformPatchArray = glGetUniformLocation(program, "patchArray");
     uniformDuDesc     = glGetUniformLocation(program, "duDesc");
     uniformDvDesc     = glGetUniformLocation(program, "dvDesc");
+    uniformEvalMode   = glGetUniformLocation(program, "evalMode");
 
     return true;
 }
@@ -27,6 +27,8 @@
 
 #include "../version.h"
 
+#include <vector>
+
 #include "../osd/opengl.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
@@ -62,6 +64,15 @@ public:
         return new GLStencilTableSSBO(limitStencilTable);
     }
 
+    /// \brief Creates the table, then frees the arrays of 'stencilTable'
+    ///        (see Far::StencilTable::Clear) : large tables need not be kept
+    ///        on the host once uploaded
+    static GLStencilTableSSBO *CreateAndRelease(Far::StencilTable *stencilTable,
+                                                void *deviceContext = NULL);
+    static GLStencilTableSSBO *CreateAndRelease(
+        Far::LimitStencilTable *limitStencilTable,
+        void *deviceContext = NULL);
+
     explicit GLStencilTableSSBO(Far::StencilTable const *stencilTable);
     explicit GLStencilTableSSBO(Far::LimitStencilTable const *limitStencilTable);
     ~GLStencilTableSSBO();
@@ -75,6 +86,10 @@ public:
     GLuint GetDvWeightsBuffer() const { return _dvWeights; }
     int GetNumStencils() const { return _numStencils; }
 
+    /// \brief Returns the index of the first stencil of each evaluation pass
+    ///        (see Far::StencilTable::GetPassOffsets())
+    std::vector<int> const & GetPassOffsets() const { return _passOffsets; }
+
 private:
     GLuint _sizes;
     GLuint _offsets;
@@ -82,6 +97,7 @@ private:
     GLuint _weights;
     GLuint _duWeights;
     GLuint _dvWeights;
+    std::vector<int> _passOffsets;
     int _numStencils;
 };
 
@@ -102,9 +118,13 @@ public:
         return NULL;
     }
 
-    /// Constructor.
+    /// Constructor. The kernels are compiled with the work group size of
+    /// the current device (see GetWorkGroupSize).
     GLComputeEvaluator();
 
+    /// Constructor compiling the kernels with the given work group size.
+    explicit GLComputeEvaluator(int workGroupSize);
+
     /// Destructor. note that the GL context must be made current.
     ~GLComputeEvaluator();
 
@@ -170,6 +190,49 @@ public:
         }
     }
 
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    /// \note  Ranges of tables of several passes must not span passes, and
+    ///        are evaluated in the order of the passes (see
+    ///        Far::StencilTable::GetPassOffsets())
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        GLComputeEvaluator const *instance,
+        void * deviceContext = NULL) {
+
+        (void)deviceContext;  // unused
+
+        if (end <= start) return true;
+
+        // Create a kernel on demand (slow)
+        GLComputeEvaluator const *kernel = instance ? instance :
+            Create(srcDesc, dstDesc, BufferDescriptor(), BufferDescriptor());
+        if (!kernel) return false;
+
+        bool r = kernel->EvalStencils(srcBuffer->BindVBO(), srcDesc,
+                                      dstBuffer->BindVBO(), dstDesc,
+                                      0, BufferDescriptor(),
+                                      0, BufferDescriptor(),
+                                      stencilTable->GetSizesBuffer(),
+                                      stencilTable->GetOffsetsBuffer(),
+                                      stencilTable->GetIndicesBuffer(),
+                                      stencilTable->GetWeightsBuffer(),
+                                      0,
+                                      0,
+                                      start, end);
+        if (kernel != instance) delete kernel;
+        return r;
+    }
+
     /// \brief Generic static compute function. This function has a same
     ///        signature as other device kernels have so that it can be called
     ///        transparently from OsdMesh template interface.
@@ -249,18 +312,33 @@ public:
         SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
         DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
         STENCIL_TABLE const *stencilTable) const {
-        return EvalStencils(srcBuffer->BindVBO(), srcDesc,
-                            dstBuffer->BindVBO(), dstDesc,
-                            0, BufferDescriptor(),
-                            0, BufferDescriptor(),
-                            stencilTable->GetSizesBuffer(),
-                            stencilTable->GetOffsetsBuffer(),
-                            stencilTable->GetIndicesBuffer(),
-                            stencilTable->GetWeightsBuffer(),
-                            0,
-                            0,
-                            /* start = */ 0,
-                            /* end   = */ stencilTable->GetNumStencils());
+
+        // Passes refer to the vertices of the previous passes : they are
+        // dispatched in order, separated by memory barriers (see
+        // Far::StencilTable::GetPassOffsets())
+        std::vector<int> const & passOffsets = stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            if (!EvalStencils(srcBuffer->BindVBO(), srcDesc,
+                              dstBuffer->BindVBO(), dstDesc,
+                              0, BufferDescriptor(),
+                              0, BufferDescriptor(),
+                              stencilTable->GetSizesBuffer(),
+                              stencilTable->GetOffsetsBuffer(),
+                              stencilTable->GetIndicesBuffer(),
+                              stencilTable->GetWeightsBuffer(),
+                              0,
+                              0,
+                              start, end)) {
+                return false;
+            }
+        }
+        return true;
     }
 
     /// Dispatch the GLSL compute kernel on GPU asynchronously.
@@ -301,6 +379,49 @@ public:
                       int start,
                       int end) const;
 
+    /// \brief Dispatch the GLSL compute kernel for the instances of a mesh
+    ///        on GPU asynchronously : the stencils of the table are applied
+    ///        to every instance in a single dispatch, the instances being
+    ///        located by offsets in the input and output buffers.
+    ///        returns false if the kernel hasn't been compiled yet.
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance
+    ///                        (host memory), in floats, added to the offsets
+    ///                        of srcDesc and dstDesc
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencilsBatch(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int numInstances, int const * instanceOffsets) const {
+        return EvalStencilsBatch(srcBuffer->BindVBO(), srcDesc,
+                                 dstBuffer->BindVBO(), dstDesc,
+                                 stencilTable->GetSizesBuffer(),
+                                 stencilTable->GetOffsetsBuffer(),
+                                 stencilTable->GetIndicesBuffer(),
+                                 stencilTable->GetWeightsBuffer(),
+                                 /* start = */ 0,
+                                 /* end   = */ stencilTable->GetNumStencils(),
+                                 numInstances, instanceOffsets);
+    }
+
+    /// Dispatch the GLSL compute kernel for the instances of a mesh on GPU
+    /// asynchronously (see above).
+    /// returns false if the kernel hasn't been compiled yet.
+    bool EvalStencilsBatch(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                           GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                           GLuint sizesBuffer,
+                           GLuint offsetsBuffer,
+                           GLuint indicesBuffer,
+                           GLuint weightsBuffer,
+                           int start,
+                           int end,
+                           int numInstances,
+                           int const * instanceOffsets) const;
+
     /// ----------------------------------------------------------------------
     ///
     ///   Limit evaluations with PatchTable
@@ -561,6 +682,221 @@ public:
                      GLuint patchIndexBuffer,
                      GLuint patchParamsBuffer) const;
 
+    /// \brief Generic face-varying limit eval function. It takes the
+    ///        PatchCoords of the vertex patches and evaluates the limit values
+    ///        of a face-varying channel of the PatchTable on the device (see
+    ///        CpuEvaluator::EvalPatchesFaceVarying).
+    ///
+    /// @param srcBuffer      Input face-varying primvar buffer.
+    ///                       must have BindVBO() method returning a GL
+    ///                       buffer object of source data
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindVBO() method returning a GL
+    ///                       buffer object of destination data
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords number of patchCoords.
+    ///
+    /// @param patchCoords    array of locations to be evaluated.
+    ///                       must have BindVBO() method returning an
+    ///                       array of PatchCoord struct in VBO.
+    ///
+    /// @param patchTable     GLPatchTable or equivalent
+    ///
+    /// @param fvarChannel    face-varying channel of the patch table
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0) const {
+
+        return EvalPatchesFaceVarying(srcBuffer->BindVBO(), srcDesc,
+                           dstBuffer->BindVBO(), dstDesc,
+                           0, BufferDescriptor(),
+                           0, BufferDescriptor(),
+                           numPatchCoords,
+                           patchCoords->BindVBO(),
+                           patchTable->GetFVarPatchArrays(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Generic face-varying limit eval function with derivatives
+    ///        (see EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0) const {
+
+        return EvalPatchesFaceVarying(srcBuffer->BindVBO(), srcDesc,
+                           dstBuffer->BindVBO(), dstDesc,
+                           duBuffer->BindVBO(),  duDesc,
+                           dvBuffer->BindVBO(),  dvDesc,
+                           numPatchCoords,
+                           patchCoords->BindVBO(),
+                           patchTable->GetFVarPatchArrays(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Face-varying limit eval function on GL buffers : the
+    ///        PatchCoords of the vertex patches are mapped to the patches of
+    ///        the channel by the kernel (see GLPatchTable for the
+    ///        face-varying buffers)
+    bool EvalPatchesFaceVarying(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                                GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                                GLuint duBuffer, BufferDescriptor const &duDesc,
+                                GLuint dvBuffer, BufferDescriptor const &dvDesc,
+                                int numPatchCoords,
+                                GLuint patchCoordsBuffer,
+                                const PatchArrayVector &fvarPatchArrays,
+                                GLuint fvarPatchIndexBuffer,
+                                GLuint fvarPatchParamsBuffer) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Varying and face-uniform evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic varying eval function. Evaluates varying primvars at
+    ///        the PatchCoords of the vertex patches : the values are
+    ///        interpolated bilinearly between the corners of the patches.
+    ///
+    /// @param srcBuffer      Input varying primvar buffer (values of the
+    ///                       refined vertices and local points, indexed as
+    ///                       the vertex primvars).
+    ///                       must have BindVBO() method returning a GL
+    ///                       buffer object of source data
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindVBO() method returning a GL
+    ///                       buffer object of destination data
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords number of patchCoords.
+    ///
+    /// @param patchCoords    array of locations to be evaluated.
+    ///                       must have BindVBO() method returning an
+    ///                       array of PatchCoord struct in VBO.
+    ///
+    /// @param patchTable     GLPatchTable or equivalent
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable) const {
+
+        return EvalPatchesVarying(srcBuffer->BindVBO(), srcDesc,
+                           dstBuffer->BindVBO(), dstDesc,
+                           0, BufferDescriptor(),
+                           0, BufferDescriptor(),
+                           numPatchCoords,
+                           patchCoords->BindVBO(),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Generic varying eval function with derivatives (see
+    ///        EvalPatchesVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable) const {
+
+        return EvalPatchesVarying(srcBuffer->BindVBO(), srcDesc,
+                           dstBuffer->BindVBO(), dstDesc,
+                           duBuffer->BindVBO(),  duDesc,
+                           dvBuffer->BindVBO(),  dvDesc,
+                           numPatchCoords,
+                           patchCoords->BindVBO(),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Varying eval function on GL buffers
+    bool EvalPatchesVarying(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                            GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                            GLuint duBuffer, BufferDescriptor const &duDesc,
+                            GLuint dvBuffer, BufferDescriptor const &dvDesc,
+                            int numPatchCoords,
+                            GLuint patchCoordsBuffer,
+                            const PatchArrayVector &patchArrays,
+                            GLuint patchIndexBuffer,
+                            GLuint patchParamsBuffer) const;
+
+    /// \brief Generic face-uniform eval function. Copies the values of the
+    ///        faces of the PatchCoords, looked up by the face id of the
+    ///        PatchParam of their patches (i.e. the ptex face, which is the
+    ///        base face of quad meshes).
+    ///
+    /// @param srcBuffer      Input face-uniform primvar buffer, one value
+    ///                       per ptex face.
+    ///                       must have BindVBO() method returning a GL
+    ///                       buffer object of source data
+    ///
+    /// (see EvalPatchesVarying for the other parameters)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceUniform(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable) const {
+
+        return EvalPatchesFaceUniform(srcBuffer->BindVBO(), srcDesc,
+                           dstBuffer->BindVBO(), dstDesc,
+                           numPatchCoords,
+                           patchCoords->BindVBO(),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Face-uniform eval function on GL buffers
+    bool EvalPatchesFaceUniform(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                                GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                                int numPatchCoords,
+                                GLuint patchCoordsBuffer,
+                                const PatchArrayVector &patchArrays,
+                                GLuint patchIndexBuffer,
+                                GLuint patchParamsBuffer) const;
+
     /// ----------------------------------------------------------------------
     ///
     ///   Other methods
@@ -577,7 +913,39 @@ public:
     /// Wait the dispatched kernel finishes.
     static void Synchronize(void *deviceContext);
 
+    /// \brief Returns the work group size of the kernels compiled on the
+    ///        device of the current GL context : the size retained by
+    ///        TuneWorkGroupSize() for the device if any, else a multiple of
+    ///        the SIMD width of its vendor.
+    static int GetWorkGroupSize();
+
+    /// \brief Times a synthetic stencil evaluation with each work group size
+    ///        supported by the device of the current GL context, and retains
+    ///        the fastest for the evaluators created afterwards on this
+    ///        device (evaluators already cached keep their size). Returns
+    ///        the work group size retained.
+    static int TuneWorkGroupSize();
+
 private:
+    bool evalPatches(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                     GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                     GLuint duBuffer, BufferDescriptor const &duDesc,
+                     GLuint dvBuffer, BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     GLuint patchCoordsBuffer,
+                     const PatchArrayVector &patchArrays,
+                     GLuint patchIndexBuffer,
+                     GLuint patchParamsBuffer,
+                     int evalMode) const;
+
+    // primvar classes evaluated by the patch kernel (evalMode)
+    enum EvalMode {
+        EVAL_VERTEX = 0,
+        EVAL_FACE_VARYING,
+        EVAL_VARYING,
+        EVAL_FACE_UNIFORM
+    };
+
     struct _StencilKernel {
         _StencilKernel();
         ~_StencilKernel();
@@ -585,7 +953,8 @@ private:
                      BufferDescriptor const &dstDesc,
                      BufferDescriptor const &duDesc,
                      BufferDescriptor const &dvDesc,
-                     int workGroupSize);
+                     int workGroupSize,
+                     bool instances=false);
         GLuint program;
         GLuint uniformStart;
         GLuint uniformEnd;
@@ -593,7 +962,8 @@ private:
         GLuint uniformDstOffset;
         GLuint uniformDuDesc;
         GLuint uniformDvDesc;
-    } _stencilKernel;
+        GLuint uniformInstanceStart;
+    } _stencilKernel, _stencilBatchKernel;
 
     struct _PatchKernel {
         _PatchKernel();
@@ -609,6 +979,7 @@ private:
         GLuint uniformPatchArray;
         GLuint uniformDuDesc;
         GLuint uniformDvDesc;
+        GLuint uniformEvalMode;
 
     } _patchKernel;
 
@@ -0,0 +1,331 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/glComputePatchCuller.h"
+#include "../osd/glPatchTable.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "../far/error.h"
+#include "../far/patchDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const char *shaderSource =
+#include "../osd/glslPatchCullKernel.gen.h"
+;
+
+// ---------------------------------------------------------------------------
+
+static bool
+isCulled(Far::PatchDescriptor const &desc) {
+    // quad offsets of legacy Gregory patches are indexed by primitive id
+    return desc.GetType() != Far::PatchDescriptor::GREGORY &&
+           desc.GetType() != Far::PatchDescriptor::GREGORY_BOUNDARY;
+}
+
+GLCulledPatchTable::GLCulledPatchTable() :
+    _patchIndexBuffer(0), _culledPatchBuffer(0), _culledPatchTexture(0),
+    _tessLevelBuffer(0), _tessLevelTexture(0), _drawIndirectBuffer(0) {
+}
+
+GLCulledPatchTable::~GLCulledPatchTable() {
+    if (_patchIndexBuffer) glDeleteBuffers(1, &_patchIndexBuffer);
+    if (_culledPatchBuffer) glDeleteBuffers(1, &_culledPatchBuffer);
+    if (_culledPatchTexture) glDeleteTextures(1, &_culledPatchTexture);
+    if (_tessLevelBuffer) glDeleteBuffers(1, &_tessLevelBuffer);
+    if (_tessLevelTexture) glDeleteTextures(1, &_tessLevelTexture);
+    if (_drawIndirectBuffer) glDeleteBuffers(1, &_drawIndirectBuffer);
+}
+
+GLCulledPatchTable *
+GLCulledPatchTable::Create(GLPatchTable const *patchTable,
+                           void * /*deviceContext*/) {
+    if (patchTable == NULL) return 0;
+
+    GLCulledPatchTable *instance = new GLCulledPatchTable();
+    if (instance->allocate(patchTable)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+GLCulledPatchTable::allocate(GLPatchTable const *patchTable) {
+
+    _patchArrays = patchTable->GetPatchArrays();
+
+    // the buffers span the ranges of all the patch arrays
+    int numIndices = 0, numPatches = 0;
+    for (int i = 0; i < (int)_patchArrays.size(); ++i) {
+        PatchArray const &patchArray = _patchArrays[i];
+        int numArrayPatches = patchArray.GetNumPatches();
+        numIndices = std::max(numIndices, patchArray.GetIndexBase() +
+            numArrayPatches * patchArray.GetDescriptor().GetNumControlVertices());
+        numPatches = std::max(numPatches,
+            patchArray.GetPrimitiveIdBase() + numArrayPatches);
+    }
+
+    glGenBuffers(1, &_patchIndexBuffer);
+    glGenBuffers(1, &_culledPatchBuffer);
+    glGenBuffers(1, &_tessLevelBuffer);
+    glGenBuffers(1, &_drawIndirectBuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _patchIndexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, numIndices * sizeof(GLint), NULL,
+                 GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _culledPatchBuffer);
+    glBufferData(GL_ARRAY_BUFFER, numPatches * sizeof(GLint), NULL,
+                 GL_DYNAMIC_DRAW);
+
+    // tessOuterLo and tessOuterHi of each patch
+    glBindBuffer(GL_ARRAY_BUFFER, _tessLevelBuffer);
+    glBufferData(GL_ARRAY_BUFFER, numPatches * 8 * sizeof(GLfloat), NULL,
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // the draw commands draw nothing until the patches have been culled
+    std::vector<DrawCommand> commands(_patchArrays.size());
+    for (int i = 0; i < (int)_patchArrays.size(); ++i) {
+        commands[i].count = 0;
+        commands[i].instanceCount = 1;
+        commands[i].firstIndex = _patchArrays[i].GetIndexBase();
+        commands[i].baseVertex = 0;
+        commands[i].baseInstance = 0;
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                 commands.size() * sizeof(DrawCommand),
+                 commands.empty() ? NULL : &commands[0],
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glGenTextures(1, &_culledPatchTexture);
+    glGenTextures(1, &_tessLevelTexture);
+
+    glBindTexture(GL_TEXTURE_BUFFER, _culledPatchTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, _culledPatchBuffer);
+
+    glBindTexture(GL_TEXTURE_BUFFER, _tessLevelTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _tessLevelBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+GLComputePatchCuller::GLComputePatchCuller() :
+    _program(0), _workGroupSize(64), _maxTessLevel(64) {
+}
+
+GLComputePatchCuller::~GLComputePatchCuller() {
+    if (_program) {
+        glDeleteProgram(_program);
+    }
+}
+
+GLComputePatchCuller *
+GLComputePatchCuller::Create(void * /*deviceContext*/) {
+    GLComputePatchCuller *instance = new GLComputePatchCuller();
+    if (instance->Compile()) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+GLComputePatchCuller::Compile() {
+
+    if (_program) {
+        glDeleteProgram(_program);
+        _program = 0;
+    }
+
+    GLint maxTessLevel = 0;
+    glGetIntegerv(GL_MAX_TESS_GEN_LEVEL, &maxTessLevel);
+    if (maxTessLevel > 0) _maxTessLevel = maxTessLevel;
+
+    GLuint program = glCreateProgram();
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+
+    char define[64];
+    snprintf(define, sizeof(define), "#define WORK_GROUP_SIZE %d\n",
+             _workGroupSize);
+
+    const char *shaderSources[3] = {"#version 430\n", define, shaderSource};
+    glShaderSource(shader, 3, shaderSources, NULL);
+    glCompileShader(shader);
+    glAttachShader(program, shader);
+
+    GLint linked = 0;
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    if (linked == GL_FALSE) {
+        char buffer[1024];
+        glGetShaderInfoLog(shader, 1024, NULL, buffer);
+        Far::Error(Far::FAR_RUNTIME_ERROR, buffer);
+
+        glGetProgramInfoLog(program, 1024, NULL, buffer);
+        Far::Error(Far::FAR_RUNTIME_ERROR, buffer);
+
+        glDeleteShader(shader);
+        glDeleteProgram(program);
+        return false;
+    }
+
+    glDeleteShader(shader);
+
+    _program = program;
+
+    _uniformSrcOffset = glGetUniformLocation(program, "srcOffset");
+    _uniformSrcStride = glGetUniformLocation(program, "srcStride");
+    _uniformModelViewMatrix = glGetUniformLocation(program, "modelViewMatrix");
+    _uniformProjectionMatrix =
+        glGetUniformLocation(program, "projectionMatrix");
+    _uniformTessLevel = glGetUniformLocation(program, "tessLevel");
+    _uniformMaxTessLevel = glGetUniformLocation(program, "maxTessLevel");
+    _uniformScreenSpaceTessellation =
+        glGetUniformLocation(program, "screenSpaceTessellation");
+    _uniformPatchArray = glGetUniformLocation(program, "patchArray");
+    _uniformPatchType = glGetUniformLocation(program, "patchType");
+    _uniformDrawCommand = glGetUniformLocation(program, "drawCommand");
+    _uniformEnableCull = glGetUniformLocation(program, "enableCull");
+
+    return true;
+}
+
+/* static */
+void
+GLComputePatchCuller::Synchronize(void * /*kernel*/) {
+    // XXX: this is currently just for the performance measuring purpose.
+    // need to be reimplemented by fence and sync.
+    glFinish();
+}
+
+bool
+GLComputePatchCuller::Cull(GLuint vertexBuffer,
+                           BufferDescriptor const &vertexDesc,
+                           GLPatchTable const *patchTable,
+                           GLCulledPatchTable *culledTable,
+                           float const *modelViewMatrix,
+                           float const *projectionMatrix,
+                           float tessLevel,
+                           bool screenSpaceTessellation) const {
+
+    if (!_program || !patchTable || !culledTable) return false;
+
+    PatchArrayVector const &patchArrays = patchTable->GetPatchArrays();
+    if (patchArrays.size() != culledTable->GetPatchArrays().size()) {
+        return false;
+    }
+
+    // reset the draw commands : culled arrays are counted by the kernel
+    std::vector<GLCulledPatchTable::DrawCommand> commands(patchArrays.size());
+    for (int i = 0; i < (int)patchArrays.size(); ++i) {
+        PatchArray const &patchArray = patchArrays[i];
+        commands[i].count = isCulled(patchArray.GetDescriptor()) ? 0 :
+            patchArray.GetNumPatches() *
+                patchArray.GetDescriptor().GetNumControlVertices();
+        commands[i].instanceCount = 1;
+        commands[i].firstIndex = patchArray.GetIndexBase();
+        commands[i].baseVertex = 0;
+        commands[i].baseInstance = 0;
+    }
+    if (!commands.empty()) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER,
+                     culledTable->GetDrawIndirectBuffer());
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0,
+            commands.size() * sizeof(GLCulledPatchTable::DrawCommand),
+            &commands[0]);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                     patchTable->GetPatchIndexBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                     patchTable->GetPatchParamBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3,
+                     culledTable->GetPatchIndexBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4,
+                     culledTable->GetCulledPatchBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5,
+                     culledTable->GetTessLevelBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6,
+                     culledTable->GetDrawIndirectBuffer());
+
+    glUseProgram(_program);
+
+    glUniform1i(_uniformSrcOffset, vertexDesc.offset);
+    glUniform1i(_uniformSrcStride, vertexDesc.stride);
+    glUniformMatrix4fv(_uniformModelViewMatrix, 1, GL_FALSE, modelViewMatrix);
+    glUniformMatrix4fv(_uniformProjectionMatrix, 1, GL_FALSE,
+                       projectionMatrix);
+    glUniform1f(_uniformTessLevel, tessLevel);
+    glUniform1f(_uniformMaxTessLevel, (float)_maxTessLevel);
+    glUniform1i(_uniformScreenSpaceTessellation,
+                screenSpaceTessellation ? 1 : 0);
+
+    for (int i = 0; i < (int)patchArrays.size(); ++i) {
+        PatchArray const &patchArray = patchArrays[i];
+        int numPatches = patchArray.GetNumPatches();
+        if (numPatches == 0) continue;
+
+        glUniform4i(_uniformPatchArray, numPatches,
+                    patchArray.GetIndexBase(),
+                    patchArray.GetPrimitiveIdBase(),
+                    patchArray.GetDescriptor().GetNumControlVertices());
+        glUniform1i(_uniformPatchType, patchArray.GetPatchType());
+        glUniform1i(_uniformDrawCommand, i);
+        glUniform1i(_uniformEnableCull,
+                    isCulled(patchArray.GetDescriptor()) ? 1 : 0);
+
+        glDispatchCompute((numPatches + _workGroupSize - 1) / _workGroupSize,
+                          1, 1);
+    }
+
+    glUseProgram(0);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT |
+                    GL_ELEMENT_ARRAY_BARRIER_BIT |
+                    GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    for (int i = 0; i < 7; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+    }
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
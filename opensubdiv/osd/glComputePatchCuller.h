@@ -0,0 +1,238 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_GL_COMPUTE_PATCH_CULLER_H
+#define OPENSUBDIV3_OSD_GL_COMPUTE_PATCH_CULLER_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+#include "../osd/opengl.h"
+#include "../osd/types.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+class GLPatchTable;
+
+///
+/// \brief Patches of a GLPatchTable remaining after a culling pre-pass
+///
+/// The buffers are partitioned as those of the GLPatchTable : the visible
+/// patches of each patch array are compacted at the start of the range of the
+/// array, and the draw indirect buffer holds one command for each patch array
+/// (in the order of GetPatchArrays()).
+///
+/// Shaders compiled with OSD_ENABLE_PATCH_CULL_PREPASS (see
+/// glslPatchCommon.glsl) draw the culled patches :
+///
+///   - the GL_ELEMENT_ARRAY_BUFFER is GetPatchIndexBuffer()
+///   - OsdCulledPatchBuffer is GetCulledPatchTextureBuffer()
+///   - OsdCulledTessLevelBuffer is GetTessLevelTextureBuffer()
+///   - OsdPatchParamBuffer is still the GLPatchTable patch param buffer
+///   - OsdPrimitiveIdBase() still returns the primitive id base of the array
+///
+/// and each patch array is drawn with glDrawElementsIndirect at
+/// GetDrawIndirectOffset(array).
+///
+class GLCulledPatchTable : private NonCopyable<GLCulledPatchTable> {
+public:
+    /// \brief Layout of the commands of the draw indirect buffer
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    ~GLCulledPatchTable();
+
+    /// Creates the buffers of the culled patches of 'patchTable'
+    static GLCulledPatchTable *Create(GLPatchTable const *patchTable,
+                                      void *deviceContext = NULL);
+
+    /// Returns the patch arrays (same as those of the GLPatchTable)
+    PatchArrayVector const &GetPatchArrays() const {
+        return _patchArrays;
+    }
+
+    /// Returns the GL index buffer of the control vertices of the visible
+    /// patches
+    GLuint GetPatchIndexBuffer() const {
+        return _patchIndexBuffer;
+    }
+
+    /// Returns the GL buffer of the index of each visible patch in the patch
+    /// param buffer
+    GLuint GetCulledPatchBuffer() const {
+        return _culledPatchBuffer;
+    }
+
+    /// Returns the GL texture buffer of the index of each visible patch
+    GLuint GetCulledPatchTextureBuffer() const {
+        return _culledPatchTexture;
+    }
+
+    /// Returns the GL buffer of the tessellation levels of the visible
+    /// patches (tessOuterLo and tessOuterHi of each patch)
+    GLuint GetTessLevelBuffer() const {
+        return _tessLevelBuffer;
+    }
+
+    /// Returns the GL texture buffer of the tessellation levels
+    GLuint GetTessLevelTextureBuffer() const {
+        return _tessLevelTexture;
+    }
+
+    /// Returns the GL_DRAW_INDIRECT_BUFFER of the patch arrays
+    GLuint GetDrawIndirectBuffer() const {
+        return _drawIndirectBuffer;
+    }
+
+    /// Returns the offset of the draw command of a patch array in the draw
+    /// indirect buffer
+    static void const *GetDrawIndirectOffset(int patchArray) {
+        return (void const *)(patchArray * sizeof(DrawCommand));
+    }
+
+protected:
+    GLCulledPatchTable();
+
+    // allocate buffers for the patches of patchTable
+    bool allocate(GLPatchTable const *patchTable);
+
+    PatchArrayVector _patchArrays;
+
+    GLuint _patchIndexBuffer;
+    GLuint _culledPatchBuffer;
+    GLuint _culledPatchTexture;
+    GLuint _tessLevelBuffer;
+    GLuint _tessLevelTexture;
+    GLuint _drawIndirectBuffer;
+};
+
+///
+/// \brief GLSL compute pre-pass culling patches and computing their
+///        tessellation levels
+///
+/// Patches are culled against the view frustum (with the convex hull of
+/// their control vertices, as OSD_PATCH_CULL) before any of them is drawn,
+/// and the tessellation levels of the edges of the visible patches are
+/// precomputed (as OsdGetTessLevels), so that the tess control shaders only
+/// run for visible patches and read their levels.
+///
+/// Screen-space levels of regular patches are computed from the refined
+/// points of the B-spline control vertices (see
+/// OsdGetTessLevelsRefinedPoints) rather than from their limit points.
+///
+/// Legacy Gregory patches are not culled (their quad offsets are indexed by
+/// primitive id) : their arrays are copied as is.
+///
+class GLComputePatchCuller {
+public:
+    /// Creates and compiles the culler (returns NULL on failure)
+    static GLComputePatchCuller *Create(void *deviceContext = NULL);
+
+    /// Destructor. note that the GL context must be made current.
+    ~GLComputePatchCuller();
+
+    /// \brief Generic culling function
+    ///
+    /// @param vertexBuffer     Buffer of the refined vertices (positions
+    ///                         are the 3 first elements of 'vertexDesc')
+    ///
+    /// @param vertexDesc       Vertex buffer descriptor of the positions
+    ///
+    /// @param patchTable       GLPatchTable of the patches
+    ///
+    /// @param culledTable      Culled patches of 'patchTable'
+    ///
+    /// @param modelViewMatrix  Column major model-view matrix
+    ///
+    /// @param projectionMatrix Column major projection matrix
+    ///
+    /// @param tessLevel        Tessellation level (see OsdTessLevel)
+    ///
+    /// @param screenSpaceTessellation  Screen-space or uniform levels (see
+    ///                         OSD_ENABLE_SCREENSPACE_TESSELLATION)
+    ///
+    template <typename VERTEX_BUFFER>
+    bool Cull(VERTEX_BUFFER *vertexBuffer, BufferDescriptor const &vertexDesc,
+              GLPatchTable const *patchTable, GLCulledPatchTable *culledTable,
+              float const *modelViewMatrix, float const *projectionMatrix,
+              float tessLevel, bool screenSpaceTessellation = true) const {
+
+        return Cull(vertexBuffer->BindVBO(), vertexDesc,
+                    patchTable, culledTable,
+                    modelViewMatrix, projectionMatrix,
+                    tessLevel, screenSpaceTessellation);
+    }
+
+    /// \brief Culls the patches of 'patchTable' into 'culledTable' (see
+    ///        above)
+    bool Cull(GLuint vertexBuffer, BufferDescriptor const &vertexDesc,
+              GLPatchTable const *patchTable, GLCulledPatchTable *culledTable,
+              float const *modelViewMatrix, float const *projectionMatrix,
+              float tessLevel, bool screenSpaceTessellation = true) const;
+
+    /// Configures the compute shader
+    bool Compile();
+
+    /// Wait the dispatched kernel finishes.
+    static void Synchronize(void *deviceContext);
+
+private:
+    GLComputePatchCuller();
+
+    GLuint _program;
+
+    GLuint _uniformSrcOffset;
+    GLuint _uniformSrcStride;
+    GLuint _uniformModelViewMatrix;
+    GLuint _uniformProjectionMatrix;
+    GLuint _uniformTessLevel;
+    GLuint _uniformMaxTessLevel;
+    GLuint _uniformScreenSpaceTessellation;
+    GLuint _uniformPatchArray;
+    GLuint _uniformPatchType;
+    GLuint _uniformDrawCommand;
+    GLuint _uniformEnableCull;
+
+    int _workGroupSize;
+    int _maxTessLevel;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_COMPUTE_PATCH_CULLER_H
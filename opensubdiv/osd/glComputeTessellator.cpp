@@ -0,0 +1,292 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/glComputeTessellator.h"
+#include "../osd/glPatchTable.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "../far/error.h"
+#include "../far/patchDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const char *shaderSource =
+#include "../osd/glslTessellationKernel.gen.h"
+;
+
+// layout of the PatchCoords of the patch kernel of GLComputeEvaluator
+static const int patchCoordSize = 5 * sizeof(GLint);
+
+// minimum of GL_MAX_COMPUTE_WORK_GROUP_COUNT
+static const int maxWorkGroupCount = 65535;
+
+// ---------------------------------------------------------------------------
+
+static bool
+isTessellated(Far::PatchDescriptor::Type type) {
+    return type != Far::PatchDescriptor::NON_PATCH &&
+           type != Far::PatchDescriptor::POINTS &&
+           type != Far::PatchDescriptor::LINES;
+}
+
+static bool
+isTriangular(Far::PatchDescriptor::Type type) {
+    return type == Far::PatchDescriptor::LOOP ||
+           type == Far::PatchDescriptor::TRIANGLES;
+}
+
+GLTessellatedPatchTable::GLTessellatedPatchTable() :
+    _maxVertices(0), _maxTriangles(0),
+    _patchCoordBuffer(0), _indexBuffer(0), _drawIndirectBuffer(0),
+    _vertexCountBuffer(0) {
+}
+
+GLTessellatedPatchTable::~GLTessellatedPatchTable() {
+    if (_patchCoordBuffer) glDeleteBuffers(1, &_patchCoordBuffer);
+    if (_indexBuffer) glDeleteBuffers(1, &_indexBuffer);
+    if (_drawIndirectBuffer) glDeleteBuffers(1, &_drawIndirectBuffer);
+    if (_vertexCountBuffer) glDeleteBuffers(1, &_vertexCountBuffer);
+}
+
+GLTessellatedPatchTable *
+GLTessellatedPatchTable::Create(int maxVertices, int maxTriangles,
+                                void * /*deviceContext*/) {
+    if (maxVertices <= 0 || maxTriangles <= 0) return 0;
+
+    GLTessellatedPatchTable *instance = new GLTessellatedPatchTable();
+    if (instance->allocate(maxVertices, maxTriangles)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+GLTessellatedPatchTable::allocate(int maxVertices, int maxTriangles) {
+
+    _maxVertices = maxVertices;
+    _maxTriangles = maxTriangles;
+
+    glGenBuffers(1, &_patchCoordBuffer);
+    glGenBuffers(1, &_indexBuffer);
+    glGenBuffers(1, &_drawIndirectBuffer);
+    glGenBuffers(1, &_vertexCountBuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _patchCoordBuffer);
+    glBufferData(GL_ARRAY_BUFFER, maxVertices * patchCoordSize, NULL,
+                 GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _indexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, maxTriangles * 3 * sizeof(GLint), NULL,
+                 GL_DYNAMIC_DRAW);
+
+    GLuint vertexCount = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexCountBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint), &vertexCount,
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // the draw command draws nothing until the patches are tessellated
+    DrawCommand command = { 0, 1, 0, 0, 0 };
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawCommand), &command,
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+GLComputeTessellator::GLComputeTessellator() :
+    _program(0), _workGroupSize(64) {
+}
+
+GLComputeTessellator::~GLComputeTessellator() {
+    if (_program) {
+        glDeleteProgram(_program);
+    }
+}
+
+GLComputeTessellator *
+GLComputeTessellator::Create(void * /*deviceContext*/) {
+    GLComputeTessellator *instance = new GLComputeTessellator();
+    if (instance->Compile()) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+GLComputeTessellator::Compile() {
+
+    if (_program) {
+        glDeleteProgram(_program);
+        _program = 0;
+    }
+
+    GLuint program = glCreateProgram();
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+
+    char define[64];
+    snprintf(define, sizeof(define), "#define WORK_GROUP_SIZE %d\n",
+             _workGroupSize);
+
+    const char *shaderSources[3] = {"#version 430\n", define, shaderSource};
+    glShaderSource(shader, 3, shaderSources, NULL);
+    glCompileShader(shader);
+    glAttachShader(program, shader);
+
+    GLint linked = 0;
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    if (linked == GL_FALSE) {
+        char buffer[1024];
+        glGetShaderInfoLog(shader, 1024, NULL, buffer);
+        Far::Error(Far::FAR_RUNTIME_ERROR, buffer);
+
+        glGetProgramInfoLog(program, 1024, NULL, buffer);
+        Far::Error(Far::FAR_RUNTIME_ERROR, buffer);
+
+        glDeleteShader(shader);
+        glDeleteProgram(program);
+        return false;
+    }
+
+    glDeleteShader(shader);
+
+    _program = program;
+
+    _uniformPatchArray = glGetUniformLocation(program, "patchArray");
+    _uniformArrayIndex = glGetUniformLocation(program, "arrayIndex");
+    _uniformTriangular = glGetUniformLocation(program, "triangular");
+    _uniformRateShift = glGetUniformLocation(program, "rateShift");
+    _uniformMaxVertices = glGetUniformLocation(program, "maxVertices");
+    _uniformMaxIndices = glGetUniformLocation(program, "maxIndices");
+    _uniformFinalize = glGetUniformLocation(program, "finalize");
+
+    return true;
+}
+
+/* static */
+void
+GLComputeTessellator::Synchronize(void * /*kernel*/) {
+    // XXX: this is currently just for the performance measuring purpose.
+    // need to be reimplemented by fence and sync.
+    glFinish();
+}
+
+bool
+GLComputeTessellator::Tessellate(GLPatchTable const *patchTable,
+                                 GLuint edgeRateBuffer,
+                                 GLTessellatedPatchTable *tessellatedTable,
+                                 int rateShift) const {
+
+    if (!_program || !patchTable || !edgeRateBuffer || !tessellatedTable ||
+        rateShift < 0) {
+        return false;
+    }
+
+    // reset the counters, and the PatchCoords of the vertices left unused
+    // to valid locations (the evaluation covers all the vertices)
+    GLTessellatedPatchTable::DrawCommand command = { 0, 1, 0, 0, 0 };
+    glBindBuffer(GL_COPY_WRITE_BUFFER,
+                 tessellatedTable->GetDrawIndirectBuffer());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(command), &command);
+
+    GLuint zero = 0;
+    glBindBuffer(GL_COPY_WRITE_BUFFER,
+                 tessellatedTable->GetVertexCountBuffer());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(zero), &zero);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER,
+                 tessellatedTable->GetPatchCoordBuffer());
+    glClearBufferData(GL_COPY_WRITE_BUFFER, GL_R32UI, GL_RED_INTEGER,
+                      GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, edgeRateBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                     patchTable->GetPatchParamBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                     tessellatedTable->GetPatchCoordBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3,
+                     tessellatedTable->GetIndexBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4,
+                     tessellatedTable->GetDrawIndirectBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5,
+                     tessellatedTable->GetVertexCountBuffer());
+
+    glUseProgram(_program);
+
+    glUniform1i(_uniformMaxVertices, tessellatedTable->GetMaxVertices());
+    glUniform1i(_uniformMaxIndices, tessellatedTable->GetMaxTriangles() * 3);
+    glUniform1i(_uniformRateShift, std::min(rateShift, 16));
+    glUniform1i(_uniformFinalize, 0);
+
+    PatchArrayVector const &patchArrays = patchTable->GetPatchArrays();
+    for (int i = 0; i < (int)patchArrays.size(); ++i) {
+        PatchArray const &patchArray = patchArrays[i];
+        Far::PatchDescriptor::Type type = patchArray.GetDescriptor().GetType();
+        int numPatches = patchArray.GetNumPatches();
+        if (numPatches == 0 || !isTessellated(type)) continue;
+
+        glUniform4i(_uniformPatchArray, numPatches,
+                    patchArray.GetIndexBase(),
+                    patchArray.GetPrimitiveIdBase(),
+                    patchArray.GetDescriptor().GetNumControlVertices());
+        glUniform1i(_uniformArrayIndex, i);
+        glUniform1i(_uniformTriangular, isTriangular(type) ? 1 : 0);
+
+        // a work group per patch
+        int numGroupsX = std::min(numPatches, maxWorkGroupCount);
+        int numGroupsY = (numPatches + numGroupsX - 1) / numGroupsX;
+        glDispatchCompute(numGroupsX, numGroupsY, 1);
+    }
+
+    // clamp the counters of the patches which did not fit
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUniform1i(_uniformFinalize, 1);
+    glDispatchCompute(1, 1, 1);
+
+    glUseProgram(0);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT |
+                    GL_ELEMENT_ARRAY_BARRIER_BIT |
+                    GL_SHADER_STORAGE_BARRIER_BIT);
+
+    for (int i = 0; i < 6; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+    }
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,198 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_GL_COMPUTE_TESSELLATOR_H
+#define OPENSUBDIV3_OSD_GL_COMPUTE_TESSELLATOR_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+#include "../osd/opengl.h"
+
+#include <cstddef>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+class GLPatchTable;
+
+///
+/// \brief Triangles of the patches of a GLPatchTable tessellated by a
+///        GLComputeTessellator
+///
+/// The buffers are allocated once for a maximum number of vertices and
+/// triangles, and filled on the GPU : the vertices are PatchCoords, to be
+/// evaluated by GLComputeEvaluator::EvalPatches() (the table has a BindVBO()
+/// method returning its patch coord buffer), and the triangles are indices of
+/// the evaluated vertices, drawn with
+///
+///   glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0)
+///
+/// with GetIndexBuffer() as GL_ELEMENT_ARRAY_BUFFER and
+/// GetDrawIndirectBuffer() as GL_DRAW_INDIRECT_BUFFER. The table keeps its
+/// triangles until the next tessellation, so that the evaluated vertices can
+/// be drawn by several passes (e.g. shadow and reflection passes).
+///
+/// Patches which do not fit in the buffers are skipped (their triangles are
+/// degenerate).
+///
+class GLTessellatedPatchTable : private NonCopyable<GLTessellatedPatchTable> {
+public:
+    /// \brief Layout of the command of the draw indirect buffer
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    ~GLTessellatedPatchTable();
+
+    /// Creates the buffers of at most 'maxVertices' vertices and
+    /// 'maxTriangles' triangles
+    static GLTessellatedPatchTable *Create(int maxVertices, int maxTriangles,
+                                           void *deviceContext = NULL);
+
+    /// Returns the maximum number of vertices
+    int GetMaxVertices() const { return _maxVertices; }
+
+    /// Returns the maximum number of triangles
+    int GetMaxTriangles() const { return _maxTriangles; }
+
+    /// Returns the GL buffer of the PatchCoords of the vertices (the unused
+    /// ones are valid PatchCoords of the first patch)
+    GLuint GetPatchCoordBuffer() const { return _patchCoordBuffer; }
+
+    /// Returns the GL buffer of the PatchCoords of the vertices
+    GLuint BindVBO() const { return _patchCoordBuffer; }
+
+    /// Returns the GL buffer of the indices of the triangles
+    GLuint GetIndexBuffer() const { return _indexBuffer; }
+
+    /// Returns the GL_DRAW_INDIRECT_BUFFER of the triangles (a DrawCommand)
+    GLuint GetDrawIndirectBuffer() const { return _drawIndirectBuffer; }
+
+    /// Returns the GL buffer of the number of tessellated vertices (a single
+    /// GLuint)
+    GLuint GetVertexCountBuffer() const { return _vertexCountBuffer; }
+
+protected:
+    GLTessellatedPatchTable();
+
+    // allocate buffers for maxVertices and maxTriangles
+    bool allocate(int maxVertices, int maxTriangles);
+
+    int _maxVertices;
+    int _maxTriangles;
+
+    GLuint _patchCoordBuffer;
+    GLuint _indexBuffer;
+    GLuint _drawIndirectBuffer;
+    GLuint _vertexCountBuffer;
+};
+
+///
+/// \brief GLSL compute tessellation of the patches of a GLPatchTable
+///
+/// An alternative to the tessellation stages of the patch shaders : the
+/// patches are tessellated into triangles by a compute shader, with the
+/// crack-free pattern of CpuTessellator (see CpuTessellator for the rates of
+/// the edges), and the vertices and triangles of each patch are allocated in
+/// a GLTessellatedPatchTable by atomic counters, so that the tessellation
+/// never leaves the GPU.
+///
+/// The vertices are then evaluated as any PatchCoords, by the patch kernels
+/// of GLComputeEvaluator :
+///
+///   tessellator->Tessellate(patchTable, edgeRateBuffer, tessellatedTable);
+///   evaluator->EvalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+///                          tessellatedTable->GetMaxVertices(),
+///                          tessellatedTable, patchTable);
+///
+/// The edge rates can be those of CpuTessellator::ComputeUniformEdgeRates()
+/// or CpuTessellator::ComputeScreenSpaceEdgeRates() (uploaded once), or be
+/// computed on the GPU.
+///
+class GLComputeTessellator {
+public:
+    /// Creates and compiles the tessellator (returns NULL on failure)
+    static GLComputeTessellator *Create(void *deviceContext = NULL);
+
+    /// Destructor. note that the GL context must be made current.
+    ~GLComputeTessellator();
+
+    /// \brief Tessellates all the patches of a GLPatchTable
+    ///
+    /// @param patchTable        GLPatchTable of the patches
+    ///
+    /// @param edgeRateBuffer    GL buffer of the 2 rates of the 4 edges of
+    ///                          each patch (8 GLints per patch, in the order
+    ///                          of the table)
+    ///
+    /// @param tessellatedTable  Returned vertices and triangles (the previous
+    ///                          ones are discarded)
+    ///
+    /// @param rateShift         Coarsening of the tessellation : the rates
+    ///                          are divided by 2^rateShift (at least 1, the
+    ///                          halves of split edges remaining split, so
+    ///                          that the coarser tessellation is still free
+    ///                          of cracks)
+    ///
+    bool Tessellate(GLPatchTable const *patchTable, GLuint edgeRateBuffer,
+                    GLTessellatedPatchTable *tessellatedTable,
+                    int rateShift = 0) const;
+
+    /// Configures the compute shader
+    bool Compile();
+
+    /// Wait the dispatched kernel finishes.
+    static void Synchronize(void *deviceContext);
+
+private:
+    GLComputeTessellator();
+
+    GLuint _program;
+
+    GLuint _uniformPatchArray;
+    GLuint _uniformArrayIndex;
+    GLuint _uniformTriangular;
+    GLuint _uniformRateShift;
+    GLuint _uniformMaxVertices;
+    GLuint _uniformMaxIndices;
+    GLuint _uniformFinalize;
+
+    int _workGroupSize;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_COMPUTE_TESSELLATOR_H
@@ -0,0 +1,304 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/glFaceLevelSelector.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "../far/error.h"
+#include "../far/faceLevelTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const char *shaderSource =
+#include "../osd/glslFaceLevelKernel.gen.h"
+;
+
+// ---------------------------------------------------------------------------
+
+static GLuint
+createBuffer(std::vector<Far::Index> const &src) {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, std::max((size_t)1, src.size()) * sizeof(GLint),
+                 src.empty() ? NULL : &src[0], GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return buffer;
+}
+
+GLFaceLevelTable::GLFaceLevelTable() :
+    _numBaseFaces(0), _maxLevel(0),
+    _triangleOffsetBuffer(0), _triangleBuffer(0), _cornerOffsetBuffer(0),
+    _cornerBuffer(0), _refinedCornerBuffer(0), _indexBuffer(0),
+    _faceLevelBuffer(0), _drawIndirectBuffer(0) {
+}
+
+GLFaceLevelTable::~GLFaceLevelTable() {
+    if (_triangleOffsetBuffer) glDeleteBuffers(1, &_triangleOffsetBuffer);
+    if (_triangleBuffer) glDeleteBuffers(1, &_triangleBuffer);
+    if (_cornerOffsetBuffer) glDeleteBuffers(1, &_cornerOffsetBuffer);
+    if (_cornerBuffer) glDeleteBuffers(1, &_cornerBuffer);
+    if (_refinedCornerBuffer) glDeleteBuffers(1, &_refinedCornerBuffer);
+    if (_indexBuffer) glDeleteBuffers(1, &_indexBuffer);
+    if (_faceLevelBuffer) glDeleteBuffers(1, &_faceLevelBuffer);
+    if (_drawIndirectBuffer) glDeleteBuffers(1, &_drawIndirectBuffer);
+}
+
+GLFaceLevelTable *
+GLFaceLevelTable::Create(Far::FaceLevelTable const *faceLevelTable,
+                         void * /*deviceContext*/) {
+    if (faceLevelTable == NULL) return 0;
+
+    GLFaceLevelTable *instance = new GLFaceLevelTable();
+    if (instance->allocate(faceLevelTable)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+GLFaceLevelTable::allocate(Far::FaceLevelTable const *faceLevelTable) {
+
+    _numBaseFaces = faceLevelTable->GetNumBaseFaces();
+    _maxLevel = faceLevelTable->GetMaxLevel();
+
+    _triangleOffsetBuffer = createBuffer(faceLevelTable->GetTriangleOffsets());
+    _triangleBuffer = createBuffer(faceLevelTable->GetTriangleVertices());
+    _cornerOffsetBuffer = createBuffer(faceLevelTable->GetCornerOffsets());
+    _cornerBuffer = createBuffer(faceLevelTable->GetCorners());
+    _refinedCornerBuffer = createBuffer(faceLevelTable->GetRefinedCorners());
+
+    // the index buffer holds the triangles of all the faces at the level of
+    // the most triangles
+    std::vector<Far::Index> const &offsets =
+        faceLevelTable->GetTriangleOffsets();
+    int numIndices = 0;
+    for (int face = 0; face < _numBaseFaces; ++face) {
+        int faceIndices = 0;
+        for (int level = 0; level <= _maxLevel; ++level) {
+            int range = face * (_maxLevel + 1) + level;
+            faceIndices = std::max(faceIndices,
+                                   offsets[range + 1] - offsets[range]);
+        }
+        numIndices += faceIndices;
+    }
+
+    glGenBuffers(1, &_indexBuffer);
+    glGenBuffers(1, &_faceLevelBuffer);
+    glGenBuffers(1, &_drawIndirectBuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _indexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, std::max(1, numIndices) * sizeof(GLint),
+                 NULL, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _faceLevelBuffer);
+    glBufferData(GL_ARRAY_BUFFER, std::max(1, _numBaseFaces) * sizeof(GLint),
+                 NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // the draw command draws nothing until the levels have been selected
+    DrawCommand command = { 0, 1, 0, 0, 0, 0 };
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawCommand), &command,
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    return true;
+}
+
+int
+GLFaceLevelTable::ReadSelectedMaxLevel() const {
+
+    DrawCommand command;
+    glBindBuffer(GL_COPY_READ_BUFFER, _drawIndirectBuffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(DrawCommand), &command);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    return (int)command.maxLevel - 1;
+}
+
+// ---------------------------------------------------------------------------
+
+GLFaceLevelSelector::GLFaceLevelSelector() :
+    _program(0), _workGroupSize(64) {
+}
+
+GLFaceLevelSelector::~GLFaceLevelSelector() {
+    if (_program) {
+        glDeleteProgram(_program);
+    }
+}
+
+GLFaceLevelSelector *
+GLFaceLevelSelector::Create(void * /*deviceContext*/) {
+    GLFaceLevelSelector *instance = new GLFaceLevelSelector();
+    if (instance->Compile()) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+GLFaceLevelSelector::Compile() {
+
+    if (_program) {
+        glDeleteProgram(_program);
+        _program = 0;
+    }
+
+    GLuint program = glCreateProgram();
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+
+    char define[64];
+    snprintf(define, sizeof(define), "#define WORK_GROUP_SIZE %d\n",
+             _workGroupSize);
+
+    const char *shaderSources[3] = {"#version 430\n", define, shaderSource};
+    glShaderSource(shader, 3, shaderSources, NULL);
+    glCompileShader(shader);
+    glAttachShader(program, shader);
+
+    GLint linked = 0;
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    if (linked == GL_FALSE) {
+        char buffer[1024];
+        glGetShaderInfoLog(shader, 1024, NULL, buffer);
+        Far::Error(Far::FAR_RUNTIME_ERROR, buffer);
+
+        glGetProgramInfoLog(program, 1024, NULL, buffer);
+        Far::Error(Far::FAR_RUNTIME_ERROR, buffer);
+
+        glDeleteShader(shader);
+        glDeleteProgram(program);
+        return false;
+    }
+
+    glDeleteShader(shader);
+
+    _program = program;
+
+    _uniformSrcOffset = glGetUniformLocation(program, "srcOffset");
+    _uniformSrcStride = glGetUniformLocation(program, "srcStride");
+    _uniformModelViewMatrix = glGetUniformLocation(program, "modelViewMatrix");
+    _uniformProjectionMatrix =
+        glGetUniformLocation(program, "projectionMatrix");
+    _uniformDetail = glGetUniformLocation(program, "detail");
+    _uniformCurvatureWeight = glGetUniformLocation(program, "curvatureWeight");
+    _uniformNumFaces = glGetUniformLocation(program, "numFaces");
+    _uniformMaxLevel = glGetUniformLocation(program, "maxLevel");
+
+    return true;
+}
+
+/* static */
+void
+GLFaceLevelSelector::Synchronize(void * /*kernel*/) {
+    // XXX: this is currently just for the performance measuring purpose.
+    // need to be reimplemented by fence and sync.
+    glFinish();
+}
+
+bool
+GLFaceLevelSelector::Select(GLuint vertexBuffer,
+                            BufferDescriptor const &vertexDesc,
+                            GLFaceLevelTable *faceLevelTable,
+                            float const *modelViewMatrix,
+                            float const *projectionMatrix,
+                            float detail, float curvatureWeight) const {
+
+    if (!_program || !faceLevelTable) return false;
+
+    if (vertexDesc.length < 3) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+            "Failure in GLFaceLevelSelector::Select() -- "
+            "positions of less than 3 elements.");
+        return false;
+    }
+
+    // reset the draw command : the triangles are counted by the kernel
+    GLFaceLevelTable::DrawCommand command = { 0, 1, 0, 0, 0, 0 };
+    glBindBuffer(GL_COPY_WRITE_BUFFER,
+                 faceLevelTable->GetDrawIndirectBuffer());
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(command), &command);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    int numFaces = faceLevelTable->GetNumBaseFaces();
+    if (numFaces == 0) return true;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, vertexBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1,
+                     faceLevelTable->GetTriangleOffsetBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2,
+                     faceLevelTable->GetTriangleBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3,
+                     faceLevelTable->GetCornerOffsetBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4,
+                     faceLevelTable->GetCornerBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5,
+                     faceLevelTable->GetRefinedCornerBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6,
+                     faceLevelTable->GetIndexBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7,
+                     faceLevelTable->GetFaceLevelBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8,
+                     faceLevelTable->GetDrawIndirectBuffer());
+
+    glUseProgram(_program);
+
+    glUniform1i(_uniformSrcOffset, vertexDesc.offset);
+    glUniform1i(_uniformSrcStride, vertexDesc.stride);
+    glUniformMatrix4fv(_uniformModelViewMatrix, 1, GL_FALSE, modelViewMatrix);
+    glUniformMatrix4fv(_uniformProjectionMatrix, 1, GL_FALSE,
+                       projectionMatrix);
+    glUniform1f(_uniformDetail, detail);
+    glUniform1f(_uniformCurvatureWeight, curvatureWeight);
+    glUniform1i(_uniformNumFaces, numFaces);
+    glUniform1i(_uniformMaxLevel, faceLevelTable->GetMaxLevel());
+
+    glDispatchCompute((numFaces + _workGroupSize - 1) / _workGroupSize, 1, 1);
+
+    glUseProgram(0);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT |
+                    GL_ELEMENT_ARRAY_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    for (int i = 0; i < 9; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+    }
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
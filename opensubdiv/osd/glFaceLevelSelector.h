@@ -0,0 +1,218 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_GL_FACE_LEVEL_SELECTOR_H
+#define OPENSUBDIV3_OSD_GL_FACE_LEVEL_SELECTOR_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+#include "../osd/opengl.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class FaceLevelTable;
+}
+
+namespace Osd {
+
+///
+/// \brief GL buffers of a Far::FaceLevelTable, and of the triangles of the
+///        faces at the levels selected by a GLFaceLevelSelector
+///
+/// The triangles of the visible faces are compacted at the start of the
+/// index buffer, and drawn with glDrawElementsIndirect at offset 0 of the
+/// draw indirect buffer (GL_TRIANGLES, GL_UNSIGNED_INT), the vertex buffer
+/// being that of all the levels of the table.
+///
+class GLFaceLevelTable : private NonCopyable<GLFaceLevelTable> {
+public:
+    /// \brief Layout of the draw indirect buffer : the command drawing the
+    ///        triangles, followed by the finest level selected plus one (0
+    ///        if all faces are culled)
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+        GLuint maxLevel;
+    };
+
+    ~GLFaceLevelTable();
+
+    /// Creates the buffers of 'faceLevelTable'
+    static GLFaceLevelTable *Create(Far::FaceLevelTable const *faceLevelTable,
+                                    void *deviceContext = NULL);
+
+    /// Returns the number of base faces
+    int GetNumBaseFaces() const { return _numBaseFaces; }
+
+    /// Returns the finest level of the table
+    int GetMaxLevel() const { return _maxLevel; }
+
+    /// Returns the GL buffer of the triangle offsets of the faces and levels
+    GLuint GetTriangleOffsetBuffer() const { return _triangleOffsetBuffer; }
+
+    /// Returns the GL buffer of the triangles of all the faces and levels
+    GLuint GetTriangleBuffer() const { return _triangleBuffer; }
+
+    /// Returns the GL buffer of the corner offsets of the base faces
+    GLuint GetCornerOffsetBuffer() const { return _cornerOffsetBuffer; }
+
+    /// Returns the GL buffer of the corners of the base faces
+    GLuint GetCornerBuffer() const { return _cornerBuffer; }
+
+    /// Returns the GL buffer of the refined corners of the base faces
+    GLuint GetRefinedCornerBuffer() const { return _refinedCornerBuffer; }
+
+    /// Returns the GL index buffer of the triangles of the selected levels
+    GLuint GetIndexBuffer() const { return _indexBuffer; }
+
+    /// Returns the GL buffer of the level of each base face (-1 if culled)
+    GLuint GetFaceLevelBuffer() const { return _faceLevelBuffer; }
+
+    /// Returns the GL_DRAW_INDIRECT_BUFFER of the triangles
+    GLuint GetDrawIndirectBuffer() const { return _drawIndirectBuffer; }
+
+    /// \brief Returns the finest level selected (-1 if all faces are culled)
+    ///
+    /// \note Reads the draw indirect buffer back, waiting for the selection
+    ///       to complete
+    ///
+    int ReadSelectedMaxLevel() const;
+
+protected:
+    GLFaceLevelTable();
+
+    // allocate and fill the buffers of faceLevelTable
+    bool allocate(Far::FaceLevelTable const *faceLevelTable);
+
+    int _numBaseFaces;
+    int _maxLevel;
+
+    GLuint _triangleOffsetBuffer;
+    GLuint _triangleBuffer;
+    GLuint _cornerOffsetBuffer;
+    GLuint _cornerBuffer;
+    GLuint _refinedCornerBuffer;
+    GLuint _indexBuffer;
+    GLuint _faceLevelBuffer;
+    GLuint _drawIndirectBuffer;
+};
+
+///
+/// \brief GLSL compute kernel selecting the level of each base face of a
+///        GLFaceLevelTable from the view
+///
+/// The selection of CpuFaceLevelSelector::ComputeFaceLevels(), followed by
+/// the gathering of the triangles of the visible faces at their level (as
+/// CpuFaceLevelSelector::GatherTriangles(), although the triangles of the
+/// faces are not ordered by face) in a single pass. Each frame :
+///
+///   1. evaluate the stencils of level 1 into the vertex buffer
+///   2. Select()
+///   3. evaluate the stencils of the levels 2 to the finest level selected
+///      (GLFaceLevelTable::ReadSelectedMaxLevel(), or GetMaxLevel() to avoid
+///      waiting for the selection)
+///   4. draw the triangles of the GLFaceLevelTable
+///
+class GLFaceLevelSelector {
+public:
+    /// Creates and compiles the selector (returns NULL on failure)
+    static GLFaceLevelSelector *Create(void *deviceContext = NULL);
+
+    /// Destructor. note that the GL context must be made current.
+    ~GLFaceLevelSelector();
+
+    /// \brief Generic selection function
+    ///
+    /// @param vertexBuffer     Buffer of the vertices of the levels (the
+    ///                         levels 0 and 1 evaluated)
+    ///
+    /// @param vertexDesc       Vertex buffer descriptor of the positions
+    ///
+    /// @param faceLevelTable   GLFaceLevelTable of the faces
+    ///
+    /// @param modelViewMatrix  Column major model-view matrix
+    ///
+    /// @param projectionMatrix Column major projection matrix
+    ///
+    /// @param detail           Rate of an edge of unit projected extent
+    ///
+    /// @param curvatureWeight  Scale of the curvature of the faces (0 to
+    ///                         ignore the curvature)
+    ///
+    template <typename VERTEX_BUFFER>
+    bool Select(VERTEX_BUFFER *vertexBuffer, BufferDescriptor const &vertexDesc,
+                GLFaceLevelTable *faceLevelTable,
+                float const *modelViewMatrix, float const *projectionMatrix,
+                float detail, float curvatureWeight = 0.0f) const {
+
+        return Select(vertexBuffer->BindVBO(), vertexDesc, faceLevelTable,
+                      modelViewMatrix, projectionMatrix,
+                      detail, curvatureWeight);
+    }
+
+    /// \brief Selects the levels of the faces of 'faceLevelTable' (see
+    ///        above)
+    bool Select(GLuint vertexBuffer, BufferDescriptor const &vertexDesc,
+                GLFaceLevelTable *faceLevelTable,
+                float const *modelViewMatrix, float const *projectionMatrix,
+                float detail, float curvatureWeight = 0.0f) const;
+
+    /// Configures the compute shader
+    bool Compile();
+
+    /// Wait the dispatched kernel finishes.
+    static void Synchronize(void *deviceContext);
+
+private:
+    GLFaceLevelSelector();
+
+    GLuint _program;
+
+    GLuint _uniformSrcOffset;
+    GLuint _uniformSrcStride;
+    GLuint _uniformModelViewMatrix;
+    GLuint _uniformProjectionMatrix;
+    GLuint _uniformDetail;
+    GLuint _uniformCurvatureWeight;
+    GLuint _uniformNumFaces;
+    GLuint _uniformMaxLevel;
+
+    int _workGroupSize;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_FACE_LEVEL_SELECTOR_H
@@ -0,0 +1,74 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/glGpuTimer.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+GLGpuTimer::GLGpuTimer() {
+    _queries[0] = _queries[1] = 0;
+}
+
+GLGpuTimer::~GLGpuTimer() {
+    if (_queries[0]) glDeleteQueries(2, _queries);
+}
+
+void
+GLGpuTimer::Begin(void * /*deviceContext*/) {
+    if (_queries[0] == 0) glGenQueries(2, _queries);
+    glQueryCounter(_queries[0], GL_TIMESTAMP);
+}
+
+void
+GLGpuTimer::End(void * /*deviceContext*/) {
+    if (_queries[0] == 0) return;
+    glQueryCounter(_queries[1], GL_TIMESTAMP);
+}
+
+double
+GLGpuTimer::GetElapsedTime(bool wait) {
+    if (_queries[0] == 0) return -1.0;
+
+    if (not wait) {
+        GLint available = 0;
+        glGetQueryObjectiv(_queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (not available) return -1.0;
+    }
+
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(_queries[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(_queries[1], GL_QUERY_RESULT, &end);
+
+    // nanoseconds
+    return (double)(end - begin) * 1.0e-6;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,75 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_GL_GPU_TIMER_H
+#define OPENSUBDIV3_OSD_GL_GPU_TIMER_H
+
+#include "../version.h"
+
+#include "../osd/opengl.h"
+#include "../osd/gpuTimer.h"
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief GPU timer of the OpenGL evaluators (GLComputeEvaluator and
+///        GLXFBEvaluator), from GL_TIMESTAMP queries of the current context
+///
+/// Timestamps rather than GL_TIME_ELAPSED queries are recorded, so that the
+/// timed work may include other elapsed time queries of the client.
+///
+class GLGpuTimer : public GpuTimer, private NonCopyable<GLGpuTimer> {
+public:
+    /// \brief Constructor (the queries are created on the first Begin())
+    GLGpuTimer();
+
+    /// \brief Destructor (the GL context of the queries must be current)
+    virtual ~GLGpuTimer();
+
+    /// \brief Records the start of the timed work (deviceContext unused)
+    virtual void Begin(void * deviceContext = 0);
+
+    /// \brief Records the end of the timed work (deviceContext unused)
+    virtual void End(void * deviceContext = 0);
+
+    /// \brief Returns the time of the timed work in milliseconds
+    virtual double GetElapsedTime(bool wait = true);
+
+private:
+    GLuint _queries[2];
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_GL_GPU_TIMER_H
@@ -31,7 +31,8 @@ namespace Osd {
 
 GLLegacyGregoryPatchTable::GLLegacyGregoryPatchTable() :
     _vertexTextureBuffer(0), _vertexValenceTextureBuffer(0),
-    _quadOffsetsTextureBuffer(0) {
+    _quadOffsetsTextureBuffer(0),
+    _vertexValenceBuffer(0), _quadOffsetsBuffer(0) {
     _quadOffsetsBase[0] = _quadOffsetsBase[1] = 0;
 }
 
@@ -42,6 +43,10 @@ GLLegacyGregoryPatchTable::~GLLegacyGregoryPatchTable() {
         glDeleteTextures(1, &_vertexValenceTextureBuffer);
     if (_quadOffsetsTextureBuffer)
         glDeleteTextures(1, &_quadOffsetsTextureBuffer);
+    if (_vertexValenceBuffer)
+        glDeleteBuffers(1, &_vertexValenceBuffer);
+    if (_quadOffsetsBuffer)
+        glDeleteBuffers(1, &_quadOffsetsBuffer);
 }
 
 GLLegacyGregoryPatchTable *
@@ -57,8 +62,9 @@ GLLegacyGregoryPatchTable::Create(Far::PatchTable const *farPatchTable) {
     Far::PatchTable::QuadOffsetsTable const &
         quadOffsetsTable = farPatchTable->GetQuadOffsetsTable();
 
+    // the buffers are kept to be bound as shader storage buffers too
     if (not valenceTable.empty()) {
-        GLuint buffer;
+        GLuint &buffer = result->_vertexValenceBuffer;
         glGenBuffers(1, &buffer);
         glBindBuffer(GL_ARRAY_BUFFER, buffer);
         glBufferData(GL_ARRAY_BUFFER, valenceTable.size() * sizeof(int),
@@ -68,11 +74,10 @@ GLLegacyGregoryPatchTable::Create(Far::PatchTable const *farPatchTable) {
         glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, buffer);
         glBindTexture(GL_TEXTURE_BUFFER, 0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDeleteBuffers(1, &buffer);
     }
 
     if (not quadOffsetsTable.empty()) {
-        GLuint buffer;
+        GLuint &buffer = result->_quadOffsetsBuffer;
         glGenBuffers(1, &buffer);
         glBindBuffer(GL_ARRAY_BUFFER, buffer);
         glBufferData(GL_ARRAY_BUFFER, quadOffsetsTable.size() * sizeof(int),
@@ -82,7 +87,6 @@ GLLegacyGregoryPatchTable::Create(Far::PatchTable const *farPatchTable) {
         glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, buffer);
         glBindTexture(GL_TEXTURE_BUFFER, 0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDeleteBuffers(1, &buffer);
     }
 
     result->_quadOffsetsBase[0] = 0;
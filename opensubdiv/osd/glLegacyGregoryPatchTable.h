@@ -57,6 +57,18 @@ public:
         return _quadOffsetsTextureBuffer;
     }
 
+    /// Returns the GL buffer of the vertex valences (to be bound as a shader
+    /// storage buffer, see OSD_ENABLE_SHADER_STORAGE_BUFFERS)
+    GLuint GetVertexValenceBuffer() const {
+        return _vertexValenceBuffer;
+    }
+
+    /// Returns the GL buffer of the quad offsets (to be bound as a shader
+    /// storage buffer, see OSD_ENABLE_SHADER_STORAGE_BUFFERS)
+    GLuint GetQuadOffsetsBuffer() const {
+        return _quadOffsetsBuffer;
+    }
+
     GLuint GetQuadOffsetsBase(Far::PatchDescriptor::Type type) {
         if (type == Far::PatchDescriptor::GREGORY_BOUNDARY) {
             return _quadOffsetsBase[1];
@@ -71,6 +83,8 @@ private:
     GLuint _vertexTextureBuffer;
     GLuint _vertexValenceTextureBuffer;
     GLuint _quadOffsetsTextureBuffer;
+    GLuint _vertexValenceBuffer;
+    GLuint _quadOffsetsBuffer;
     GLuint _quadOffsetsBase[2];       // gregory, boundaryGregory
 };
 
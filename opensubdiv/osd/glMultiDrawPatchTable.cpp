@@ -0,0 +1,219 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/glMultiDrawPatchTable.h"
+
+#include "../far/patchTable.h"
+#include "../osd/opengl.h"
+#include "../osd/cpuPatchTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+GLMultiDrawPatchTable::GLMultiDrawPatchTable() :
+    _numDraws(0),
+    _drawIndirectBuffer(0), _drawParamBuffer(0), _drawParamTexture(0),
+    _patchIndexBuffer(0), _patchParamBuffer(0),
+    _patchIndexTexture(0), _patchParamTexture(0) {
+}
+
+GLMultiDrawPatchTable::~GLMultiDrawPatchTable() {
+    if (_drawIndirectBuffer) glDeleteBuffers(1, &_drawIndirectBuffer);
+    if (_drawParamBuffer) glDeleteBuffers(1, &_drawParamBuffer);
+    if (_drawParamTexture) glDeleteTextures(1, &_drawParamTexture);
+    if (_patchIndexBuffer) glDeleteBuffers(1, &_patchIndexBuffer);
+    if (_patchParamBuffer) glDeleteBuffers(1, &_patchParamBuffer);
+    if (_patchIndexTexture) glDeleteTextures(1, &_patchIndexTexture);
+    if (_patchParamTexture) glDeleteTextures(1, &_patchParamTexture);
+}
+
+GLMultiDrawPatchTable *
+GLMultiDrawPatchTable::Create(int numTables,
+                              Far::PatchTable const * const *patchTables,
+                              int const *baseVertices,
+                              void * /*deviceContext*/) {
+    if (numTables <= 0 || patchTables == NULL) return 0;
+
+    GLMultiDrawPatchTable *instance = new GLMultiDrawPatchTable();
+    if (instance->allocate(numTables, patchTables, baseVertices)) {
+        return instance;
+    }
+    delete instance;
+    return 0;
+}
+
+void
+GLMultiDrawPatchTable::Draw(DrawBatch const &batch, GLenum mode) const {
+
+    if (batch.numDraws == 0) return;
+
+    if (mode == GL_PATCHES) {
+        glPatchParameteri(GL_PATCH_VERTICES,
+                          batch.desc.GetNumControlVertices());
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawIndirectBuffer);
+    glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT,
+        (void const *)(batch.firstDraw * sizeof(DrawCommand)),
+        batch.numDraws, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+namespace {
+    // draw command of a patch array, before grouping by descriptor
+    struct PatchArrayDraw {
+        GLMultiDrawPatchTable::DrawCommand command;
+        int drawParam[4];
+    };
+}
+
+bool
+GLMultiDrawPatchTable::allocate(int numTables,
+                                Far::PatchTable const * const *patchTables,
+                                int const *baseVertices) {
+
+    std::vector<int> indices;
+    PatchParamVector patchParams;
+
+    // draws of each descriptor, in the order the descriptors are met
+    std::vector<Far::PatchDescriptor> descriptors;
+    std::vector< std::vector<PatchArrayDraw> > draws;
+
+    for (int table = 0; table < numTables; ++table) {
+        if (patchTables[table] == NULL) return false;
+
+        CpuPatchTable patchTable(patchTables[table]);
+
+        int indexOffset = (int)indices.size();
+        int paramOffset = (int)patchParams.size();
+        int baseVertex = baseVertices ? baseVertices[table] : 0;
+
+        indices.insert(indices.end(), patchTable.GetPatchIndexBuffer(),
+            patchTable.GetPatchIndexBuffer() + patchTable.GetPatchIndexSize());
+        patchParams.insert(patchParams.end(), patchTable.GetPatchParamBuffer(),
+            patchTable.GetPatchParamBuffer() + patchTable.GetPatchParamSize());
+
+        for (int i = 0; i < (int)patchTable.GetNumPatchArrays(); ++i) {
+            PatchArray const &patchArray = patchTable.GetPatchArrayBuffer()[i];
+            if (patchArray.GetNumPatches() == 0) continue;
+
+            int batch = 0;
+            while (batch < (int)descriptors.size() &&
+                   !(descriptors[batch] == patchArray.GetDescriptor())) {
+                ++batch;
+            }
+            if (batch == (int)descriptors.size()) {
+                descriptors.push_back(patchArray.GetDescriptor());
+                draws.push_back(std::vector<PatchArrayDraw>());
+            }
+
+            PatchArrayDraw draw;
+            draw.command.count = patchArray.GetNumPatches() *
+                patchArray.GetDescriptor().GetNumControlVertices();
+            draw.command.instanceCount = 1;
+            draw.command.firstIndex = indexOffset + patchArray.GetIndexBase();
+            draw.command.baseVertex = baseVertex;
+            draw.command.baseInstance = 0;
+            draw.drawParam[0] = paramOffset + patchArray.GetPrimitiveIdBase();
+            draw.drawParam[1] = baseVertex;
+            draw.drawParam[2] = table;
+            draw.drawParam[3] = 0;
+            draws[batch].push_back(draw);
+        }
+    }
+
+    // flatten the draws grouped by descriptor
+    std::vector<DrawCommand> commands;
+    std::vector<int> drawParams;
+    for (int batch = 0; batch < (int)descriptors.size(); ++batch) {
+        DrawBatch drawBatch;
+        drawBatch.desc = descriptors[batch];
+        drawBatch.firstDraw = (int)commands.size();
+        drawBatch.numDraws = (int)draws[batch].size();
+        _drawBatches.push_back(drawBatch);
+
+        for (int i = 0; i < (int)draws[batch].size(); ++i) {
+            commands.push_back(draws[batch][i].command);
+            drawParams.insert(drawParams.end(), draws[batch][i].drawParam,
+                              draws[batch][i].drawParam + 4);
+        }
+    }
+    _numDraws = (int)commands.size();
+
+    glGenBuffers(1, &_drawIndirectBuffer);
+    glGenBuffers(1, &_drawParamBuffer);
+    glGenBuffers(1, &_patchIndexBuffer);
+    glGenBuffers(1, &_patchParamBuffer);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _drawIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                 commands.size() * sizeof(DrawCommand),
+                 commands.empty() ? NULL : &commands[0],
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _drawParamBuffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 drawParams.size() * sizeof(GLint),
+                 drawParams.empty() ? NULL : &drawParams[0],
+                 GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _patchIndexBuffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 indices.size() * sizeof(GLint),
+                 indices.empty() ? NULL : &indices[0],
+                 GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _patchParamBuffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 patchParams.size() * sizeof(PatchParam),
+                 patchParams.empty() ? NULL : &patchParams[0],
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenTextures(1, &_drawParamTexture);
+    glGenTextures(1, &_patchIndexTexture);
+    glGenTextures(1, &_patchParamTexture);
+
+    glBindTexture(GL_TEXTURE_BUFFER, _drawParamTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, _drawParamBuffer);
+
+    glBindTexture(GL_TEXTURE_BUFFER, _patchIndexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, _patchIndexBuffer);
+
+    glBindTexture(GL_TEXTURE_BUFFER, _patchParamTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGB32I, _patchParamBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    return true;
+}
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,198 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_GL_MULTI_DRAW_PATCH_TABLE_H
+#define OPENSUBDIV3_OSD_GL_MULTI_DRAW_PATCH_TABLE_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+#include "../osd/opengl.h"
+#include "../osd/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class PatchTable;
+};
+
+namespace Osd {
+
+///
+/// \brief Patches of many meshes, drawn with one glMultiDrawElementsIndirect
+///        call for each patch descriptor.
+///
+/// The index and patch parameter buffers of the patch tables are
+/// concatenated, and each patch array of each table becomes a draw command.
+/// Commands are grouped by patch descriptor into DrawBatches, so that all the
+/// meshes sharing a patch type (and a shader permutation) are drawn at once.
+///
+/// The vertices of all the meshes are expected in a single vertex buffer :
+/// the vertices of patch table 'i' start at baseVertices[i], which becomes
+/// the base vertex of its draw commands.
+///
+/// Shaders compiled with OSD_ENABLE_MULTI_DRAW_INDIRECT (see
+/// glslPatchCommon.glsl) fetch the primitive id base of the draw from the
+/// draw parameter texture buffer, indexed by the draw id, instead of calling
+/// OsdPrimitiveIdBase(). Each draw parameter is an ivec4 :
+///
+///     x : primitive id base (offset of the draw in the patch param buffer)
+///     y : base vertex
+///     z : index of the patch table (to fetch per-mesh client data)
+///     w : unused
+///
+/// \note Legacy Gregory patches (see GLLegacyGregoryPatchTable) need buffers
+///       of their own mesh and are not supported by the multi-draw path.
+///
+class GLMultiDrawPatchTable : private NonCopyable<GLMultiDrawPatchTable> {
+public:
+    typedef GLuint VertexBufferBinding;
+
+    /// \brief Layout of the commands of the draw indirect buffer
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint  baseVertex;
+        GLuint baseInstance;
+    };
+
+    /// \brief Draw commands of the patches of one descriptor
+    struct DrawBatch {
+        Far::PatchDescriptor desc;
+        int firstDraw;  // index of the first command of the batch
+        int numDraws;   // number of commands of the batch
+    };
+
+    typedef std::vector<DrawBatch> DrawBatchVector;
+
+    ~GLMultiDrawPatchTable();
+
+    /// \brief Creates the draw buffers of 'numTables' patch tables (returns
+    ///        NULL on failure).
+    ///
+    /// @param numTables     Number of patch tables
+    ///
+    /// @param patchTables   Array of the patch tables
+    ///
+    /// @param baseVertices  Offset of the vertices of each patch table in the
+    ///                      shared vertex buffer (optional : all the tables
+    ///                      start at vertex 0 if NULL)
+    ///
+    /// @param deviceContext Unused
+    ///
+    static GLMultiDrawPatchTable *Create(int numTables,
+                                         Far::PatchTable const * const *patchTables,
+                                         int const *baseVertices = NULL,
+                                         void *deviceContext = NULL);
+
+    /// Returns the draw batches (one for each patch descriptor)
+    DrawBatchVector const &GetDrawBatches() const {
+        return _drawBatches;
+    }
+
+    /// Returns the total number of draw commands
+    int GetNumDraws() const {
+        return _numDraws;
+    }
+
+    /// Returns the GL_DRAW_INDIRECT_BUFFER of the draw commands
+    GLuint GetDrawIndirectBuffer() const {
+        return _drawIndirectBuffer;
+    }
+
+    /// Returns the GL buffer containing the draw parameters
+    GLuint GetDrawParamBuffer() const {
+        return _drawParamBuffer;
+    }
+
+    /// Returns the GL texture buffer containing the draw parameters
+    GLuint GetDrawParamTextureBuffer() const {
+        return _drawParamTexture;
+    }
+
+    /// Returns the GL index buffer containing the patch control vertices
+    GLuint GetPatchIndexBuffer() const {
+        return _patchIndexBuffer;
+    }
+
+    /// Returns the GL index buffer containing the patch parameter
+    GLuint GetPatchParamBuffer() const {
+        return _patchParamBuffer;
+    }
+
+    /// Returns the GL texture buffer containing the patch control vertices
+    GLuint GetPatchIndexTextureBuffer() const {
+        return _patchIndexTexture;
+    }
+
+    /// Returns the GL texture buffer containing the patch parameter
+    GLuint GetPatchParamTextureBuffer() const {
+        return _patchParamTexture;
+    }
+
+    /// \brief Draws the patches of a batch with a single
+    ///        glMultiDrawElementsIndirect call.
+    ///
+    /// The program (with the draw parameter and patch parameter texture
+    /// buffers bound), the vertex array and the patch index buffer (as
+    /// GL_ELEMENT_ARRAY_BUFFER) must be bound by the client. The number of
+    /// patch vertices is set from the descriptor when mode is GL_PATCHES.
+    ///
+    void Draw(DrawBatch const &batch, GLenum mode = GL_PATCHES) const;
+
+protected:
+    GLMultiDrawPatchTable();
+
+    // allocate buffers from the patch tables
+    bool allocate(int numTables, Far::PatchTable const * const *patchTables,
+                  int const *baseVertices);
+
+    DrawBatchVector _drawBatches;
+    int _numDraws;
+
+    GLuint _drawIndirectBuffer;
+    GLuint _drawParamBuffer;
+    GLuint _drawParamTexture;
+
+    GLuint _patchIndexBuffer;
+    GLuint _patchParamBuffer;
+
+    GLuint _patchIndexTexture;
+    GLuint _patchParamTexture;
+};
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_MULTI_DRAW_PATCH_TABLE_H
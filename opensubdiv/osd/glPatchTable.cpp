@@ -35,7 +35,8 @@ namespace Osd {
 
 GLPatchTable::GLPatchTable() :
     _patchIndexBuffer(0), _patchParamBuffer(0),
-    _patchIndexTexture(0), _patchParamTexture(0) {
+    _patchIndexTexture(0), _patchParamTexture(0),
+    _compactIndexBuffer(0), _wideIndexBuffer(0) {
 }
 
 GLPatchTable::~GLPatchTable() {
@@ -43,6 +44,14 @@ GLPatchTable::~GLPatchTable() {
     if (_patchParamBuffer) glDeleteBuffers(1, &_patchParamBuffer);
     if (_patchIndexTexture) glDeleteTextures(1, &_patchIndexTexture);
     if (_patchParamTexture) glDeleteTextures(1, &_patchParamTexture);
+    if (_compactIndexBuffer) glDeleteBuffers(1, &_compactIndexBuffer);
+    if (_wideIndexBuffer) glDeleteBuffers(1, &_wideIndexBuffer);
+    if (!_fvarIndexBuffers.empty()) {
+        glDeleteBuffers((GLsizei)_fvarIndexBuffers.size(),
+                        &_fvarIndexBuffers[0]);
+        glDeleteBuffers((GLsizei)_fvarParamBuffers.size(),
+                        &_fvarParamBuffers[0]);
+    }
 }
 
 GLPatchTable *
@@ -54,12 +63,22 @@ GLPatchTable::Create(Far::PatchTable const *farPatchTable,
     return 0;
 }
 
+GLPatchTable *
+GLPatchTable::CreateCompact(Far::PatchTable const *farPatchTable,
+                            void * /*deviceContext*/) {
+    GLPatchTable *instance = new GLPatchTable();
+    if (instance->allocate(farPatchTable, /*compactIndices*/ true))
+        return instance;
+    delete instance;
+    return 0;
+}
+
 bool
-GLPatchTable::allocate(Far::PatchTable const *farPatchTable) {
-    glGenBuffers(1, &_patchIndexBuffer);
+GLPatchTable::allocate(Far::PatchTable const *farPatchTable,
+                       bool compactIndices) {
     glGenBuffers(1, &_patchParamBuffer);
 
-    CpuPatchTable patchTable(farPatchTable);
+    CpuPatchTable patchTable(farPatchTable, compactIndices);
 
     size_t numPatchArrays = patchTable.GetNumPatchArrays();
     GLsizei indexSize = (GLsizei)patchTable.GetPatchIndexSize();
@@ -69,12 +88,36 @@ GLPatchTable::allocate(Far::PatchTable const *farPatchTable) {
     _patchArrays.assign(patchTable.GetPatchArrayBuffer(),
                         patchTable.GetPatchArrayBuffer() + numPatchArrays);
 
-    // copy index buffer
-    glBindBuffer(GL_ARRAY_BUFFER, _patchIndexBuffer);
-    glBufferData(GL_ARRAY_BUFFER,
-                 indexSize * sizeof(GLint),
-                 patchTable.GetPatchIndexBuffer(),
-                 GL_STATIC_DRAW);
+    if (compactIndices) {
+        // copy compact index buffers
+        _compactPatchArrays.assign(patchTable.GetCompactPatchArrayBuffer(),
+            patchTable.GetCompactPatchArrayBuffer() +
+                patchTable.GetNumCompactPatchArrays());
+
+        glGenBuffers(1, &_compactIndexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, _compactIndexBuffer);
+        glBufferData(GL_ARRAY_BUFFER,
+                     patchTable.GetCompactPatchIndexSize() * sizeof(GLushort),
+                     patchTable.GetCompactPatchIndexBuffer(),
+                     GL_STATIC_DRAW);
+
+        if (patchTable.GetWidePatchIndexSize()) {
+            glGenBuffers(1, &_wideIndexBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, _wideIndexBuffer);
+            glBufferData(GL_ARRAY_BUFFER,
+                         patchTable.GetWidePatchIndexSize() * sizeof(GLint),
+                         patchTable.GetWidePatchIndexBuffer(),
+                         GL_STATIC_DRAW);
+        }
+    } else {
+        // copy index buffer
+        glGenBuffers(1, &_patchIndexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, _patchIndexBuffer);
+        glBufferData(GL_ARRAY_BUFFER,
+                     indexSize * sizeof(GLint),
+                     patchTable.GetPatchIndexBuffer(),
+                     GL_STATIC_DRAW);
+    }
 
     // copy patchparam buffer
     glBindBuffer(GL_ARRAY_BUFFER, _patchParamBuffer);
@@ -85,16 +128,45 @@ GLPatchTable::allocate(Far::PatchTable const *farPatchTable) {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     // make both buffer as texture buffers too.
-    glGenTextures(1, &_patchIndexTexture);
-    glGenTextures(1, &_patchParamTexture);
-
-    glBindTexture(GL_TEXTURE_BUFFER, _patchIndexTexture);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, _patchIndexBuffer);
+    if (_patchIndexBuffer) {
+        glGenTextures(1, &_patchIndexTexture);
+        glBindTexture(GL_TEXTURE_BUFFER, _patchIndexTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, _patchIndexBuffer);
+    }
 
+    glGenTextures(1, &_patchParamTexture);
     glBindTexture(GL_TEXTURE_BUFFER, _patchParamTexture);
     glTexBuffer(GL_TEXTURE_BUFFER, GL_RGB32I, _patchParamBuffer);
     glBindTexture(GL_TEXTURE_BUFFER, 0);
 
+    // face-varying channels
+    int numFVarChannels = patchTable.GetNumFVarChannels();
+    _fvarPatchArrays.resize(numFVarChannels);
+    _fvarIndexBuffers.resize(numFVarChannels, 0);
+    _fvarParamBuffers.resize(numFVarChannels, 0);
+    if (numFVarChannels > 0) {
+        glGenBuffers(numFVarChannels, &_fvarIndexBuffers[0]);
+        glGenBuffers(numFVarChannels, &_fvarParamBuffers[0]);
+    }
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        _fvarPatchArrays[channel].assign(
+            patchTable.GetFVarPatchArrayBuffer(channel),
+            patchTable.GetFVarPatchArrayBuffer(channel) + 2);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _fvarIndexBuffers[channel]);
+        glBufferData(GL_ARRAY_BUFFER,
+                     patchTable.GetFVarPatchIndexSize(channel) * sizeof(GLint),
+                     patchTable.GetFVarPatchIndexBuffer(channel),
+                     GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _fvarParamBuffers[channel]);
+        glBufferData(GL_ARRAY_BUFFER,
+                     patchTable.GetFVarPatchParamSize(channel) * sizeof(PatchParam),
+                     patchTable.GetFVarPatchParamBuffer(channel),
+                     GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
     return true;
 }
 
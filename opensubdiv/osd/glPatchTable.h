@@ -31,6 +31,8 @@
 #include "../osd/opengl.h"
 #include "../osd/types.h"
 
+#include <vector>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -49,6 +51,26 @@ public:
     static GLPatchTable *Create(Far::PatchTable const *farPatchTable,
                                 void *deviceContext = NULL);
 
+    /// \brief Creates a patch table for drawing only, with the control
+    /// vertices of the patches encoded as 16-bit offsets where possible (see
+    /// CpuPatchTable::GetCompactPatchArrayBuffer). The 32-bit index buffer
+    /// and texture used by the evaluators are not allocated.
+    ///
+    /// Each compact patch array is drawn with the index buffer matching its
+    /// index size, e.g. :
+    ///
+    ///     glDrawElementsBaseVertex(GL_PATCHES,
+    ///         array.GetNumPatches() * numControlVertices,
+    ///         GL_UNSIGNED_SHORT,
+    ///         (void *)(array.GetIndexBase() * sizeof(GLushort)),
+    ///         array.GetVertexBase());
+    ///
+    /// with the primitive id base of the array added to gl_PrimitiveID to
+    /// fetch the patch params.
+    ///
+    static GLPatchTable *CreateCompact(Far::PatchTable const *farPatchTable,
+                                       void *deviceContext = NULL);
+
     PatchArrayVector const &GetPatchArrays() const {
         return _patchArrays;
     }
@@ -58,7 +80,9 @@ public:
         return _patchIndexBuffer;
     }
 
-    /// Returns the GL index buffer containing the patch parameter
+    /// Returns the GL index buffer containing the patch parameter (can be
+    /// bound as a shader storage buffer, see
+    /// OSD_ENABLE_SHADER_STORAGE_BUFFERS)
     GLuint GetPatchParamBuffer() const {
         return _patchParamBuffer;
     }
@@ -73,11 +97,50 @@ public:
         return _patchParamTexture;
     }
 
+    /// Returns the patch arrays of a face-varying channel (see
+    /// CpuPatchTable::GetFVarPatchArrayBuffer)
+    PatchArrayVector const &GetFVarPatchArrays(int fvarChannel = 0) const {
+        return _fvarPatchArrays[fvarChannel];
+    }
+
+    /// Returns the GL buffer containing the face-varying values of a channel
+    GLuint GetFVarPatchIndexBuffer(int fvarChannel = 0) const {
+        return _fvarIndexBuffers[fvarChannel];
+    }
+
+    /// Returns the GL buffer containing the face-varying patch parameters of
+    /// a channel
+    GLuint GetFVarPatchParamBuffer(int fvarChannel = 0) const {
+        return _fvarParamBuffers[fvarChannel];
+    }
+
+    /// Returns the number of face-varying channels
+    int GetNumFVarChannels() const { return (int)_fvarPatchArrays.size(); }
+
+    /// Returns the patch arrays of the compact encoding (empty unless
+    /// created with CreateCompact)
+    CompactPatchArrayVector const &GetCompactPatchArrays() const {
+        return _compactPatchArrays;
+    }
+
+    /// Returns the GL index buffer containing the 16-bit control vertices
+    /// of the compact patch arrays
+    GLuint GetCompactPatchIndexBuffer() const {
+        return _compactIndexBuffer;
+    }
+
+    /// Returns the GL index buffer containing the 32-bit control vertices
+    /// of the compact patch arrays spanning more than 16 bits (0 if none)
+    GLuint GetWidePatchIndexBuffer() const {
+        return _wideIndexBuffer;
+    }
+
 protected:
     GLPatchTable();
 
     // allocate buffers from patchTable
-    bool allocate(Far::PatchTable const *farPatchTable);
+    bool allocate(Far::PatchTable const *farPatchTable,
+                  bool compactIndices = false);
 
     PatchArrayVector _patchArrays;
 
@@ -86,6 +149,14 @@ protected:
 
     GLuint _patchIndexTexture;
     GLuint _patchParamTexture;
+
+    std::vector<PatchArrayVector> _fvarPatchArrays;
+    std::vector<GLuint> _fvarIndexBuffers;
+    std::vector<GLuint> _fvarParamBuffers;
+
+    CompactPatchArrayVector _compactPatchArrays;
+    GLuint _compactIndexBuffer;
+    GLuint _wideIndexBuffer;
 };
 
 
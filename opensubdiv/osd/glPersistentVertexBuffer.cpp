@@ -0,0 +1,219 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/glPersistentVertexBuffer.h"
+#include "../far/profile.h"
+
+#include "../osd/opengl.h"
+
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+// timeout of each wait for the fence of a buffer still in flight (in ns)
+static const GLuint64 FENCE_TIMEOUT = 1000000;
+
+GLPersistentVertexBuffer::GLPersistentVertexBuffer(int numElements,
+                                                   int numVertices,
+                                                   int numFrames)
+    : _numElements(numElements),
+      _numVertices(numVertices),
+      _numFrames(numFrames),
+      _frame(0) {
+}
+
+GLPersistentVertexBuffer::~GLPersistentVertexBuffer() {
+
+    for (int i = 0; i < (int)_fences.size(); ++i) {
+        if (_fences[i]) glDeleteSync(_fences[i]);
+    }
+    // deleting the buffers unmaps them
+    if (not _vbos.empty()) {
+        glDeleteBuffers((GLsizei)_vbos.size(), &_vbos[0]);
+    }
+}
+
+GLPersistentVertexBuffer *
+GLPersistentVertexBuffer::Create(int numElements, int numVertices, void *,
+                                 int numFrames) {
+
+    if (numFrames < 1) return 0;
+
+    GLPersistentVertexBuffer *instance =
+        new GLPersistentVertexBuffer(numElements, numVertices, numFrames);
+    if (instance->allocate()) return instance;
+    delete instance;
+    return 0;
+}
+
+void
+GLPersistentVertexBuffer::UpdateData(const float *src, int startVertex,
+                                     int numVertices,
+                                     void * /*deviceContext*/) {
+
+    OPENSUBDIV_PROFILE_ZONE("GLPersistentVertexBuffer::UpdateData");
+
+    size_t offset = startVertex * _numElements;
+    size_t size = numVertices * _numElements * sizeof(float);
+
+    if (_mappedData[_frame]) {
+        // the buffer is coherent : waiting for the GPU to be done with the
+        // previous frame that used it is the only synchronization required
+        waitFence(_frame);
+        memcpy(_mappedData[_frame] + offset, src, size);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, _vbos[_frame]);
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        offset * sizeof(float), size, src);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void
+GLPersistentVertexBuffer::NextFrame() {
+
+    if (_mappedData[_frame]) {
+        if (_fences[_frame]) glDeleteSync(_fences[_frame]);
+        _fences[_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    _frame = (_frame + 1) % _numFrames;
+}
+
+int
+GLPersistentVertexBuffer::GetNumElements() const {
+
+    return _numElements;
+}
+
+int
+GLPersistentVertexBuffer::GetNumVertices() const {
+
+    return _numVertices;
+}
+
+int
+GLPersistentVertexBuffer::GetNumFrames() const {
+
+    return _numFrames;
+}
+
+int
+GLPersistentVertexBuffer::GetFrame() const {
+
+    return _frame;
+}
+
+bool
+GLPersistentVertexBuffer::IsPersistent() const {
+
+    return _mappedData[0] != 0;
+}
+
+GLuint
+GLPersistentVertexBuffer::BindVBO(void * /*deviceContext*/) {
+
+    return _vbos[_frame];
+}
+
+bool
+GLPersistentVertexBuffer::allocate() {
+
+    GLsizeiptr size = _numElements * _numVertices * sizeof(float);
+
+    _vbos.resize(_numFrames, 0);
+    _mappedData.resize(_numFrames, 0);
+    _fences.resize(_numFrames, 0);
+
+    glGenBuffers(_numFrames, &_vbos[0]);
+
+    GLint prev = 0;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &prev);
+
+    for (int i = 0; i < _numFrames; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, _vbos[i]);
+
+        bool immutable = false;
+#if defined(GL_ARB_buffer_storage) || defined(GL_VERSION_4_4)
+        if (glBufferStorage) {
+            GLbitfield mapFlags = GL_MAP_WRITE_BIT |
+                                  GL_MAP_PERSISTENT_BIT |
+                                  GL_MAP_COHERENT_BIT;
+            // dynamic storage keeps glBufferSubData updates possible if the
+            // mapping fails
+            glBufferStorage(GL_ARRAY_BUFFER, size, 0,
+                            mapFlags | GL_DYNAMIC_STORAGE_BIT);
+            immutable = (glGetError() == GL_NO_ERROR);
+            if (immutable and size > 0) {
+                _mappedData[i] = static_cast<float *>(
+                    glMapBufferRange(GL_ARRAY_BUFFER, 0, size, mapFlags));
+            }
+        }
+#endif
+        if (not immutable) {
+            glBufferData(GL_ARRAY_BUFFER, size, 0, GL_DYNAMIC_DRAW);
+        }
+    }
+
+    // either all the buffers of the ring are mapped, or none of them
+    for (int i = 0; i < _numFrames; ++i) {
+        if (_mappedData[i] == 0) {
+            for (int j = 0; j < _numFrames; ++j) {
+                if (_mappedData[j]) {
+                    glBindBuffer(GL_ARRAY_BUFFER, _vbos[j]);
+                    glUnmapBuffer(GL_ARRAY_BUFFER);
+                    _mappedData[j] = 0;
+                }
+            }
+            break;
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, prev);
+
+    return true;
+}
+
+void
+GLPersistentVertexBuffer::waitFence(int frame) {
+
+    if (_fences[frame] == 0) return;
+
+    GLenum status = glClientWaitSync(_fences[frame],
+                                     GL_SYNC_FLUSH_COMMANDS_BIT,
+                                     FENCE_TIMEOUT);
+    while (status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(_fences[frame], 0, FENCE_TIMEOUT);
+    }
+    glDeleteSync(_fences[frame]);
+    _fences[frame] = 0;
+}
+
+}  // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
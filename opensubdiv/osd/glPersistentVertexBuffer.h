@@ -0,0 +1,133 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_GL_PERSISTENT_VERTEX_BUFFER_H
+#define OPENSUBDIV3_OSD_GL_PERSISTENT_VERTEX_BUFFER_H
+
+#include "../version.h"
+
+#include "../osd/opengl.h"
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Concrete vertex buffer class for GLSL subdivision and OpenGL
+///        drawing of control points updated every frame.
+///
+/// GLPersistentVertexBuffer is a drop-in replacement of GLVertexBuffer
+/// (it can be used with Osd::Mesh and passed to the GL evaluators) that
+/// keeps a ring of buffers, one for each frame in flight. BindVBO() returns
+/// the buffer of the current frame, so that the evaluators and the draw
+/// calls follow the ring without any change.
+///
+/// When ARB_buffer_storage is available, the buffers are mapped persistently
+/// and UpdateData() copies the vertices directly into the buffer of the
+/// current frame, without any driver synchronization : it only waits for
+/// the fence of the frame that last used that buffer (if it is still in
+/// flight). Otherwise, the data is uploaded with glBufferSubData.
+///
+/// NextFrame() must be called once the commands of a frame have been
+/// issued (after the draw calls) to fence the buffer and move to the next.
+///
+/// \note Each buffer of the ring is only written by the frame that uses it :
+///       the coarse vertices must be updated every frame (all of them, or
+///       all of those that differ from the frame that last used the buffer),
+///       before the evaluation of the refined vertices.
+///
+class GLPersistentVertexBuffer {
+public:
+    /// Default number of buffers of the ring (triple buffering)
+    enum { DEFAULT_NUM_FRAMES = 3 };
+
+    /// Creator. Returns NULL if error.
+    static GLPersistentVertexBuffer * Create(int numElements, int numVertices,
+                                             void *deviceContext = NULL,
+                                             int numFrames = DEFAULT_NUM_FRAMES);
+
+    /// Destructor.
+    ~GLPersistentVertexBuffer();
+
+    /// This method is meant to be used in client code in order to provide coarse
+    /// vertices data to Osd (writes the buffer of the current frame).
+    void UpdateData(const float *src, int startVertex, int numVertices,
+                    void *deviceContext = NULL);
+
+    /// Fences the buffer of the current frame and moves to the buffer of the
+    /// next frame.
+    void NextFrame();
+
+    /// Returns how many elements defined in this vertex buffer.
+    int GetNumElements() const;
+
+    /// Returns how many vertices allocated in this vertex buffer.
+    int GetNumVertices() const;
+
+    /// Returns the number of buffers of the ring.
+    int GetNumFrames() const;
+
+    /// Returns the index of the buffer of the current frame in the ring.
+    int GetFrame() const;
+
+    /// Returns true if the buffers are persistently mapped.
+    bool IsPersistent() const;
+
+    /// Returns the GL buffer object of the current frame.
+    GLuint BindVBO(void *deviceContext = NULL);
+
+protected:
+    /// Constructor.
+    GLPersistentVertexBuffer(int numElements, int numVertices, int numFrames);
+
+    /// Allocates the VBOs for this buffer.
+    /// Returns true if success.
+    bool allocate();
+
+    /// Waits until the GPU is done with the buffer of 'frame'.
+    void waitFence(int frame);
+
+private:
+    int _numElements;
+    int _numVertices;
+    int _numFrames;
+    int _frame;
+
+    std::vector<GLuint> _vbos;
+    std::vector<float *> _mappedData;
+    std::vector<GLsync> _fences;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_PERSISTENT_VERTEX_BUFFER_H
@@ -0,0 +1,394 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/glProgramCache.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "../far/error.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const GLenum shaderTypes[GLProgramCache::NUM_STAGES] = {
+    GL_VERTEX_SHADER,
+    GL_TESS_CONTROL_SHADER,
+    GL_TESS_EVALUATION_SHADER,
+    GL_GEOMETRY_SHADER,
+    GL_FRAGMENT_SHADER
+};
+
+// header of the files of program binaries
+struct FileHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned int numBinaries;
+};
+
+struct BinaryHeader {
+    unsigned long long key;
+    unsigned int format;
+    unsigned int size;
+};
+
+static const char fileMagic[4] = { 'O', 'S', 'D', 'P' };
+static const unsigned int fileVersion = 1;
+
+GLProgramCache::GLProgramCache() {
+}
+
+GLProgramCache::~GLProgramCache() {
+    Reset();
+}
+
+void
+GLProgramCache::Reset() {
+    for (ProgramMap::iterator it = _programs.begin();
+         it != _programs.end(); ++it) {
+        glDeleteProgram(it->second);
+    }
+    _programs.clear();
+    _binaries.clear();
+}
+
+/*static*/
+unsigned long long
+GLProgramCache::GetKey(ProgramSource const &source) {
+    // FNV-1a of the sources of the stages
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int stage = 0; stage < NUM_STAGES; ++stage) {
+        std::string const &str = source.stages[stage];
+        for (size_t i = 0; i < str.size(); ++i) {
+            hash ^= (unsigned char)str[i];
+            hash *= 1099511628211ULL;
+        }
+        // separate the stages : moving a source to another stage changes
+        // the key
+        hash ^= (unsigned long long)(stage + 1);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+GLuint
+GLProgramCache::GetProgram(ProgramSource const &source) {
+
+    unsigned long long key = GetKey(source);
+
+    ProgramMap::const_iterator it = _programs.find(key);
+    if (it != _programs.end()) {
+        return it->second;
+    }
+
+    GLuint program = 0;
+
+    BinaryMap::iterator binary = _binaries.find(key);
+    if (binary != _binaries.end()) {
+        // the binary of a program is retrieved from the program once created
+        program = loadProgram(binary->second);
+        _binaries.erase(binary);
+    }
+    if (program == 0) {
+        program = compileProgram(source);
+    }
+    if (program) {
+        _programs[key] = program;
+    }
+    return program;
+}
+
+GLuint
+GLProgramCache::compileProgram(ProgramSource const &source) const {
+
+    GLuint program = glCreateProgram();
+
+    GLuint shaders[NUM_STAGES];
+    int numShaders = 0;
+
+    bool success = true;
+    for (int stage = 0; stage < NUM_STAGES && success; ++stage) {
+        if (source.stages[stage].empty()) continue;
+
+        GLuint shader = glCreateShader(shaderTypes[stage]);
+        char const *src = source.stages[stage].c_str();
+        glShaderSource(shader, 1, &src, NULL);
+        glCompileShader(shader);
+
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE) {
+            GLint infoLogLength = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+            std::vector<char> infoLog(infoLogLength + 1, 0);
+            glGetShaderInfoLog(shader, infoLogLength, NULL, &infoLog[0]);
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "Error compiling GLSL shader: %s\n", &infoLog[0]);
+            success = false;
+        }
+        glAttachShader(program, shader);
+        shaders[numShaders++] = shader;
+    }
+
+    if (success) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+        glLinkProgram(program);
+
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE) {
+            GLint infoLogLength = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+            std::vector<char> infoLog(infoLogLength + 1, 0);
+            glGetProgramInfoLog(program, infoLogLength, NULL, &infoLog[0]);
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "Error linking GLSL program: %s\n", &infoLog[0]);
+            success = false;
+        }
+    }
+
+    for (int i = 0; i < numShaders; ++i) {
+        glDetachShader(program, shaders[i]);
+        glDeleteShader(shaders[i]);
+    }
+
+    if (!success) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+GLuint
+GLProgramCache::loadProgram(Binary const &binary) const {
+
+    if (binary.data.empty()) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, binary.format,
+                    &binary.data[0], (GLsizei)binary.data.size());
+
+    // binaries of other drivers or GPUs are rejected
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+int
+GLProgramCache::Warmup(PatchPermutationVector const &permutations,
+                       ProgramSourceCallback callback, void *clientData) {
+
+    if (callback == NULL) return 0;
+
+    int numPrograms = 0;
+    for (int i = 0; i < (int)permutations.size(); ++i) {
+        ProgramSource source;
+        if (callback(permutations[i], source, clientData) &&
+            GetProgram(source)) {
+            ++numPrograms;
+        }
+    }
+    return numPrograms;
+}
+
+bool
+GLProgramCache::Save(char const *filename) const {
+
+    // binaries of the programs, and of the loaded binaries not requested yet
+    std::vector<unsigned char> data;
+
+    FileHeader fileHeader;
+    memcpy(fileHeader.magic, fileMagic, sizeof(fileMagic));
+    fileHeader.version = fileVersion;
+    fileHeader.numBinaries = 0;
+    data.resize(sizeof(FileHeader));
+
+    for (ProgramMap::const_iterator it = _programs.begin();
+         it != _programs.end(); ++it) {
+        GLint length = 0;
+        glGetProgramiv(it->second, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) continue;
+
+        size_t offset = data.size();
+        data.resize(offset + sizeof(BinaryHeader) + length);
+
+        GLenum format = 0;
+        GLsizei size = 0;
+        glGetProgramBinary(it->second, length, &size, &format,
+                           &data[offset + sizeof(BinaryHeader)]);
+        if (size <= 0) {
+            data.resize(offset);
+            continue;
+        }
+        data.resize(offset + sizeof(BinaryHeader) + size);
+
+        BinaryHeader header;
+        header.key = it->first;
+        header.format = format;
+        header.size = (unsigned int)size;
+        memcpy(&data[offset], &header, sizeof(BinaryHeader));
+        ++fileHeader.numBinaries;
+    }
+
+    for (BinaryMap::const_iterator it = _binaries.begin();
+         it != _binaries.end(); ++it) {
+        if (it->second.data.empty()) continue;
+
+        BinaryHeader header;
+        header.key = it->first;
+        header.format = it->second.format;
+        header.size = (unsigned int)it->second.data.size();
+
+        size_t offset = data.size();
+        data.resize(offset + sizeof(BinaryHeader));
+        memcpy(&data[offset], &header, sizeof(BinaryHeader));
+        data.insert(data.end(), it->second.data.begin(),
+                    it->second.data.end());
+        ++fileHeader.numBinaries;
+    }
+
+    memcpy(&data[0], &fileHeader, sizeof(FileHeader));
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Cannot write program binaries to %s", filename);
+        return false;
+    }
+    bool success = fwrite(&data[0], 1, data.size(), file) == data.size();
+    success = (fclose(file) == 0) && success;
+    return success;
+}
+
+bool
+GLProgramCache::Load(char const *filename) {
+
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) return false;
+
+    std::vector<unsigned char> data;
+    unsigned char buffer[4096];
+    size_t size = 0;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + size);
+    }
+    fclose(file);
+
+    FileHeader fileHeader;
+    if (data.size() < sizeof(FileHeader)) return false;
+    memcpy(&fileHeader, &data[0], sizeof(FileHeader));
+    if (memcmp(fileHeader.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+        fileHeader.version != fileVersion) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Invalid program binaries in %s", filename);
+        return false;
+    }
+
+    size_t offset = sizeof(FileHeader);
+    for (unsigned int i = 0; i < fileHeader.numBinaries; ++i) {
+        BinaryHeader header;
+        if (data.size() - offset < sizeof(BinaryHeader)) return false;
+        memcpy(&header, &data[offset], sizeof(BinaryHeader));
+        offset += sizeof(BinaryHeader);
+        if (data.size() - offset < header.size) return false;
+
+        // programs already created are kept
+        if (_programs.find(header.key) == _programs.end()) {
+            Binary &binary = _binaries[header.key];
+            binary.format = header.format;
+            binary.data.assign(data.begin() + offset,
+                               data.begin() + offset + header.size);
+        }
+        offset += header.size;
+    }
+    return true;
+}
+
+/*static*/
+std::string
+GLProgramCache::GetPatchDefines(unsigned int defines) {
+    std::string str;
+    if (defines & SCREENSPACE_TESSELLATION) {
+        str += "#define OSD_ENABLE_SCREENSPACE_TESSELLATION\n";
+    }
+    if (defines & FRACTIONAL_ODD_SPACING) {
+        str += "#define OSD_FRACTIONAL_ODD_SPACING\n";
+    }
+    if (defines & FRACTIONAL_EVEN_SPACING) {
+        str += "#define OSD_FRACTIONAL_EVEN_SPACING\n";
+    }
+    if (defines & SINGLE_CREASE) {
+        str += "#define OSD_PATCH_ENABLE_SINGLE_CREASE\n";
+    }
+    if (defines & PATCH_CULL) {
+        str += "#define OSD_ENABLE_PATCH_CULL\n";
+    }
+    if (defines & NORMAL_DERIVATIVES) {
+        str += "#define OSD_COMPUTE_NORMAL_DERIVATIVES\n";
+    }
+    return str;
+}
+
+/*static*/
+GLProgramCache::PatchPermutationVector
+GLProgramCache::EnumeratePatchPermutations() {
+
+    static const Far::PatchDescriptor::Type types[] = {
+        Far::PatchDescriptor::REGULAR,
+        Far::PatchDescriptor::GREGORY,
+        Far::PatchDescriptor::GREGORY_BOUNDARY,
+        Far::PatchDescriptor::GREGORY_BASIS
+    };
+    static const unsigned int numDefines = 1 << 6;
+
+    PatchPermutationVector permutations;
+    for (int i = 0; i < (int)(sizeof(types) / sizeof(types[0])); ++i) {
+        for (unsigned int defines = 0; defines < numDefines; ++defines) {
+            unsigned int spacing = defines &
+                (FRACTIONAL_ODD_SPACING | FRACTIONAL_EVEN_SPACING);
+            if (spacing == (FRACTIONAL_ODD_SPACING | FRACTIONAL_EVEN_SPACING))
+                continue;
+            if (spacing && !(defines & SCREENSPACE_TESSELLATION))
+                continue;
+            if ((defines & SINGLE_CREASE) &&
+                types[i] != Far::PatchDescriptor::REGULAR)
+                continue;
+            permutations.push_back(PatchPermutation(types[i], defines));
+        }
+    }
+    return permutations;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,168 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_GL_PROGRAM_CACHE_H
+#define OPENSUBDIV3_OSD_GL_PROGRAM_CACHE_H
+
+#include "../version.h"
+
+#include "../osd/nonCopyable.h"
+#include "../osd/opengl.h"
+#include "../far/patchDescriptor.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Cache of the GLSL programs of the permutations of the patch shaders
+///
+/// Programs are keyed by a hash of the sources of their stages (including the
+/// defines of the permutation). Program binaries (ARB_get_program_binary)
+/// can be saved to a file and loaded by the next session : the programs are
+/// then created from their binaries instead of being compiled, and programs
+/// whose binary is rejected by the driver (another GPU or driver version) are
+/// compiled again.
+///
+/// Attribute and output locations are expected in the sources (layout
+/// qualifiers), as in the Osd patch shaders : programs created from binaries
+/// are never relinked.
+///
+class GLProgramCache : private NonCopyable<GLProgramCache> {
+public:
+    /// \brief Stages of a program
+    enum Stage {
+        VERTEX_SHADER = 0,
+        TESS_CONTROL_SHADER,
+        TESS_EVAL_SHADER,
+        GEOMETRY_SHADER,
+        FRAGMENT_SHADER,
+        NUM_STAGES
+    };
+
+    /// \brief Sources of the stages of a program (stages with an empty
+    ///        source are not attached)
+    struct ProgramSource {
+        std::string stages[NUM_STAGES];
+    };
+
+    /// \brief Defines of the permutations of the Osd patch shaders
+    enum PatchDefine {
+        SCREENSPACE_TESSELLATION = 1 << 0,  ///< OSD_ENABLE_SCREENSPACE_TESSELLATION
+        FRACTIONAL_ODD_SPACING   = 1 << 1,  ///< OSD_FRACTIONAL_ODD_SPACING
+        FRACTIONAL_EVEN_SPACING  = 1 << 2,  ///< OSD_FRACTIONAL_EVEN_SPACING
+        SINGLE_CREASE            = 1 << 3,  ///< OSD_PATCH_ENABLE_SINGLE_CREASE
+        PATCH_CULL               = 1 << 4,  ///< OSD_ENABLE_PATCH_CULL
+        NORMAL_DERIVATIVES       = 1 << 5   ///< OSD_COMPUTE_NORMAL_DERIVATIVES
+    };
+
+    /// \brief Permutation of the Osd patch shaders
+    struct PatchPermutation {
+        PatchPermutation(Far::PatchDescriptor::Type type_in,
+                         unsigned int defines_in) :
+            type(type_in), defines(defines_in) { }
+
+        Far::PatchDescriptor::Type type;
+        unsigned int defines;   ///< combination of PatchDefine
+    };
+
+    typedef std::vector<PatchPermutation> PatchPermutationVector;
+
+    /// \brief Client callback returning the sources of the program of a
+    ///        permutation (see GLSLPatchShaderSource and GetPatchDefines)
+    typedef bool (*ProgramSourceCallback)(PatchPermutation const &permutation,
+                                          ProgramSource &source,
+                                          void *clientData);
+
+    GLProgramCache();
+
+    /// Destructor. note that the GL context must be made current.
+    ~GLProgramCache();
+
+    /// \brief Returns the program of 'source' : the program is created from
+    ///        its loaded binary, or compiled the first time it is requested
+    ///        (returns 0 on failure)
+    GLuint GetProgram(ProgramSource const &source);
+
+    /// \brief Returns the number of programs of the cache
+    int GetNumPrograms() const { return (int)_programs.size(); }
+
+    /// \brief Deletes all the programs (and the loaded binaries)
+    void Reset();
+
+    /// \brief Creates the programs of the permutations before their first
+    ///        use (returns the number of programs ready)
+    int Warmup(PatchPermutationVector const &permutations,
+               ProgramSourceCallback callback, void *clientData = NULL);
+
+    /// \brief Saves the binaries of the programs (returns false on failure)
+    bool Save(char const *filename) const;
+
+    /// \brief Loads the binaries saved by a previous session (returns false
+    ///        on failure). Programs are created from the binaries when they
+    ///        are requested.
+    bool Load(char const *filename);
+
+    /// \brief Returns the '#define' lines of a combination of PatchDefine
+    static std::string GetPatchDefines(unsigned int defines);
+
+    /// \brief Returns all the valid permutations of the patch types of
+    ///        GLSLPatchShaderSource (fractional spacing requires screen-space
+    ///        tessellation, single crease applies to regular patches only)
+    static PatchPermutationVector EnumeratePatchPermutations();
+
+    /// \brief Returns the key of a program
+    static unsigned long long GetKey(ProgramSource const &source);
+
+private:
+    struct Binary {
+        GLenum format;
+        std::vector<unsigned char> data;
+    };
+
+    typedef std::map<unsigned long long, GLuint> ProgramMap;
+    typedef std::map<unsigned long long, Binary> BinaryMap;
+
+    GLuint compileProgram(ProgramSource const &source) const;
+
+    GLuint loadProgram(Binary const &binary) const;
+
+    ProgramMap _programs;
+    BinaryMap _binaries;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_GL_PROGRAM_CACHE_H
@@ -23,6 +23,7 @@
 //
 
 #include "../osd/glVertexBuffer.h"
+#include "../far/profile.h"
 
 #include "../osd/opengl.h"
 
@@ -56,6 +57,8 @@ void
 GLVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
                            void * /*deviceContext*/) {
 
+    OPENSUBDIV_PROFILE_ZONE("GLVertexBuffer::UpdateData");
+
     int size = numVertices * _numElements * sizeof(float);
 #if defined(GL_EXT_direct_state_access)
     if (glNamedBufferSubDataEXT) {
@@ -24,13 +24,16 @@
 
 #include "../osd/glXFBEvaluator.h"
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <cstdio>
+#include <cstring>
 
 #include "../far/error.h"
 #include "../far/stencilTable.h"
+#include "../far/profile.h"
 
 #if _MSC_VER
     #define snprintf _snprintf
@@ -45,10 +48,35 @@ static const char *shaderSource =
 #include "../osd/glslXFBKernel.gen.h"
 ;
 
+// Arrays larger than a chunk are uploaded a chunk at a time through mapped
+// ranges of the buffer : a single glBufferData call may have the driver stage
+// a host copy of the whole array, doubling the memory of large tables.
+static const GLsizeiptr UPLOAD_CHUNK_SIZE = 16 << 20;
+
+static void
+uploadBufferChunks(GLenum target, GLsizeiptr size, const void *data) {
+    glBufferData(target, size, NULL, GL_STATIC_DRAW);
+
+    const unsigned char *src = static_cast<const unsigned char *>(data);
+    for (GLsizeiptr offset = 0; offset < size; offset += UPLOAD_CHUNK_SIZE) {
+        GLsizeiptr chunk = std::min(UPLOAD_CHUNK_SIZE, size - offset);
+        void *dst = glMapBufferRange(target, offset, chunk,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            memcpy(dst, src + offset, chunk);
+            glUnmapBuffer(target);
+        } else {
+            glBufferSubData(target, offset, chunk, src + offset);
+        }
+    }
+}
+
 template <class T> GLuint
 createGLTextureBuffer(std::vector<T> const & src, GLenum type) {
-    GLint size = static_cast<int>(src.size()*sizeof(T));
+    GLsizeiptr size = static_cast<GLsizeiptr>(src.size()*sizeof(T));
     void const * ptr = &src.at(0);
+    bool chunked = (size > UPLOAD_CHUNK_SIZE);
 
     GLuint buffer;
     glGenBuffers(1, &buffer);
@@ -57,7 +85,7 @@ createGLTextureBuffer(std::vector<T> const & src, GLenum type) {
     glGenTextures(1, &devicePtr);
 
 #if defined(GL_EXT_direct_state_access)
-    if (glNamedBufferDataEXT && glTextureBufferEXT) {
+    if (!chunked && glNamedBufferDataEXT && glTextureBufferEXT) {
         glNamedBufferDataEXT(buffer, size, ptr, GL_STATIC_DRAW);
         glTextureBufferEXT(devicePtr, GL_TEXTURE_BUFFER, type, buffer);
     } else {
@@ -68,7 +96,11 @@ createGLTextureBuffer(std::vector<T> const & src, GLenum type) {
 
         glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &prev);
         glBindBuffer(GL_ARRAY_BUFFER, buffer);
-        glBufferData(GL_ARRAY_BUFFER, size, ptr, GL_STATIC_DRAW);
+        if (chunked) {
+            uploadBufferChunks(GL_ARRAY_BUFFER, size, ptr);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, size, ptr, GL_STATIC_DRAW);
+        }
         glBindBuffer(GL_ARRAY_BUFFER, prev);
 
         glGetIntegerv(GL_TEXTURE_BINDING_BUFFER, &prev);
@@ -94,6 +126,7 @@ GLStencilTableTBO::GLStencilTableTBO(
             stencilTable->GetControlIndices(), GL_R32I);
         _weights = createGLTextureBuffer(stencilTable->GetWeights(), GL_R32F);
         _duWeights = _dvWeights = 0;
+        _passOffsets = stencilTable->GetPassOffsets();
     } else {
         _sizes = _offsets = _indices = _weights = 0;
         _duWeights = _dvWeights = 0;
@@ -123,6 +156,22 @@ GLStencilTableTBO::GLStencilTableTBO(
     }
 }
 
+GLStencilTableTBO *
+GLStencilTableTBO::CreateAndRelease(Far::StencilTable *stencilTable,
+                                    void *deviceContext) {
+    GLStencilTableTBO *table = Create(stencilTable, deviceContext);
+    stencilTable->Clear();
+    return table;
+}
+
+GLStencilTableTBO *
+GLStencilTableTBO::CreateAndRelease(Far::LimitStencilTable *limitStencilTable,
+                                    void *deviceContext) {
+    GLStencilTableTBO *table = Create(limitStencilTable, deviceContext);
+    limitStencilTable->Clear();
+    return table;
+}
+
 GLStencilTableTBO::~GLStencilTableTBO() {
     if (_sizes) glDeleteTextures(1, &_sizes);
     if (_offsets) glDeleteTextures(1, &_offsets);
@@ -300,6 +349,57 @@ bindTexture(GLint sampler, GLuint texture, int unit) {
     glActiveTexture(GL_TEXTURE0);
 }
 
+GLuint
+GLXFBEvaluator::beginDispatches(GLuint program) const {
+
+    // bind vertex array
+    // always create new one, to be safe with multiple contexts (slow though) :
+    // a batch of dispatches shares it
+    GLuint vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glUseProgram(program);
+
+    return vao;
+}
+
+void
+GLXFBEvaluator::endDispatches(GLuint vao, int numTextures) const {
+
+    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+
+    // unbind textures
+    for (int i = 0; i < numTextures; ++i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+
+    glDisable(GL_RASTERIZER_DISCARD);
+    glUseProgram(0);
+    glActiveTexture(GL_TEXTURE0);
+
+    // revert vao
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void
+GLXFBEvaluator::bindSrcBuffer(GLuint srcBuffer, GLint uniformSrcBufferTexture,
+                              BatchState *state) const {
+
+    // Set input VBO as a texture buffer (once per source buffer of a batch)
+    if (srcBuffer != state->srcBuffer) {
+        glBindTexture(GL_TEXTURE_BUFFER, _srcBufferTexture);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, srcBuffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+        bindTexture(uniformSrcBufferTexture, _srcBufferTexture, 0);
+        state->srcBuffer = srcBuffer;
+    }
+}
+
 bool
 GLXFBEvaluator::EvalStencils(
     GLuint srcBuffer, BufferDescriptor const &srcDesc,
@@ -314,37 +414,60 @@ GLXFBEvaluator::EvalStencils(
     GLuint dvWeightsTexture,
     int start, int end) const {
 
+    OPENSUBDIV_PROFILE_ZONE("GLXFBEvaluator::EvalStencils");
+
     if (!_stencilKernel.program) return false;
-    int count = end - start;
-    if (count <= 0) {
+    if (end - start <= 0) {
         return true;
     }
 
-    // bind vertex array
-    // always create new one, to be safe with multiple contexts (slow though)
-    GLuint vao = 0;
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+    BatchState state;
+    GLuint vao = beginDispatches(_stencilKernel.program);
+    dispatchStencils(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                     duBuffer, duDesc, dvBuffer, dvDesc,
+                     sizesTexture, offsetsTexture,
+                     indicesTexture, weightsTexture,
+                     duWeightsTexture, dvWeightsTexture,
+                     start, end, &state);
+    endDispatches(vao, 7);
 
-    glEnable(GL_RASTERIZER_DISCARD);
-    glUseProgram(_stencilKernel.program);
+    return true;
+}
 
-    // Set input VBO as a texture buffer.
-    glBindTexture(GL_TEXTURE_BUFFER, _srcBufferTexture);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, srcBuffer);
-    glBindTexture(GL_TEXTURE_BUFFER, 0);
+void
+GLXFBEvaluator::dispatchStencils(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    GLuint duBuffer,  BufferDescriptor const &duDesc,
+    GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+    GLuint sizesTexture,
+    GLuint offsetsTexture,
+    GLuint indicesTexture,
+    GLuint weightsTexture,
+    GLuint duWeightsTexture,
+    GLuint dvWeightsTexture,
+    int start, int end,
+    BatchState *state) const {
 
-    bindTexture(_stencilKernel.uniformSrcBufferTexture, _srcBufferTexture, 0);
+    int count = end - start;
+    if (count <= 0) {
+        return;
+    }
 
-    // bind stencil table textures.
-    bindTexture(_stencilKernel.uniformSizesTexture,   sizesTexture, 1);
-    bindTexture(_stencilKernel.uniformOffsetsTexture, offsetsTexture, 2);
-    bindTexture(_stencilKernel.uniformIndicesTexture, indicesTexture, 3);
-    bindTexture(_stencilKernel.uniformWeightsTexture, weightsTexture, 4);
-    if (_stencilKernel.uniformDuWeightsTexture >= 0 && duWeightsTexture)
-        bindTexture(_stencilKernel.uniformDuWeightsTexture, duWeightsTexture, 5);
-    if (_stencilKernel.uniformDvWeightsTexture >= 0 && dvWeightsTexture)
-        bindTexture(_stencilKernel.uniformDvWeightsTexture, dvWeightsTexture, 6);
+    bindSrcBuffer(srcBuffer, _stencilKernel.uniformSrcBufferTexture, state);
+
+    // bind stencil table textures (once per table of a batch)
+    if (sizesTexture != state->sizesTexture) {
+        bindTexture(_stencilKernel.uniformSizesTexture,   sizesTexture, 1);
+        bindTexture(_stencilKernel.uniformOffsetsTexture, offsetsTexture, 2);
+        bindTexture(_stencilKernel.uniformIndicesTexture, indicesTexture, 3);
+        bindTexture(_stencilKernel.uniformWeightsTexture, weightsTexture, 4);
+        if (_stencilKernel.uniformDuWeightsTexture >= 0 && duWeightsTexture)
+            bindTexture(_stencilKernel.uniformDuWeightsTexture, duWeightsTexture, 5);
+        if (_stencilKernel.uniformDvWeightsTexture >= 0 && dvWeightsTexture)
+            bindTexture(_stencilKernel.uniformDvWeightsTexture, dvWeightsTexture, 6);
+        state->sizesTexture = sizesTexture;
+    }
 
     // set batch range
     glUniform1i(_stencilKernel.uniformStart,     start);
@@ -408,23 +531,6 @@ GLXFBEvaluator::EvalStencils(
     glBeginTransformFeedback(GL_POINTS);
     glDrawArrays(GL_POINTS, 0, count);
     glEndTransformFeedback();
-
-    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
-
-    for (int i = 0; i < 5; ++i) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_BUFFER, 0);
-    }
-
-    glDisable(GL_RASTERIZER_DISCARD);
-    glUseProgram(0);
-    glActiveTexture(GL_TEXTURE0);
-
-    // revert vao
-    glBindVertexArray(0);
-    glDeleteVertexArrays(1, &vao);
-
-    return true;
 }
 
 
@@ -440,38 +546,76 @@ GLXFBEvaluator::EvalPatches(
     GLuint patchIndexTexture,
     GLuint patchParamTexture) const {
 
-    bool derivatives = (duDesc.length > 0 || dvDesc.length > 0);
+    OPENSUBDIV_PROFILE_ZONE("GLXFBEvaluator::EvalPatches");
 
     if (!_patchKernel.program) return false;
 
-    // bind vertex array
-    // always create new one, to be safe with multiple contexts (slow though)
-    GLuint vao = 0;
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
+    BatchState state;
+    GLuint vao = beginPatchDispatches();
+    dispatchPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                    duBuffer, duDesc, dvBuffer, dvDesc,
+                    numPatchCoords, patchCoordsBuffer, patchArrays,
+                    patchIndexTexture, patchParamTexture, &state);
+    endPatchDispatches(vao);
 
-    glEnable(GL_RASTERIZER_DISCARD);
-    glUseProgram(_patchKernel.program);
+    return true;
+}
+
+GLuint
+GLXFBEvaluator::beginPatchDispatches() const {
+
+    GLuint vao = beginDispatches(_patchKernel.program);
+
+    // input patchcoords
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+
+    return vao;
+}
+
+void
+GLXFBEvaluator::endPatchDispatches(GLuint vao) const {
+
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+
+    endDispatches(vao, 3);
+}
 
-    // Set input VBO as a texture buffer.
-    glBindTexture(GL_TEXTURE_BUFFER, _srcBufferTexture);
-    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, srcBuffer);
-    glBindTexture(GL_TEXTURE_BUFFER, 0);
+void
+GLXFBEvaluator::dispatchPatches(
+    GLuint srcBuffer, BufferDescriptor const &srcDesc,
+    GLuint dstBuffer, BufferDescriptor const &dstDesc,
+    GLuint duBuffer,  BufferDescriptor const &duDesc,
+    GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    GLuint patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    GLuint patchIndexTexture,
+    GLuint patchParamTexture,
+    BatchState *state) const {
 
-    bindTexture(_patchKernel.uniformSrcBufferTexture, _srcBufferTexture, 0);
+    if (numPatchCoords <= 0) return;
 
-    // bind patch index and patch param textures.
-    bindTexture(_patchKernel.uniformPatchParamTexture, patchParamTexture, 1);
-    bindTexture(_patchKernel.uniformPatchIndexTexture, patchIndexTexture, 2);
+    bool derivatives = (duDesc.length > 0 || dvDesc.length > 0);
+
+    bindSrcBuffer(srcBuffer, _patchKernel.uniformSrcBufferTexture, state);
+
+    // bind patch index and patch param textures (once per patch table of
+    // a batch)
+    if (patchIndexTexture != state->patchIndexTexture) {
+        bindTexture(_patchKernel.uniformPatchParamTexture, patchParamTexture, 1);
+        bindTexture(_patchKernel.uniformPatchIndexTexture, patchIndexTexture, 2);
+
+        glUniform4iv(_patchKernel.uniformPatchArray, (int)patchArrays.size(),
+                     (const GLint*)&patchArrays[0]);
+        state->patchIndexTexture = patchIndexTexture;
+    }
 
     // set other uniforms
-    glUniform4iv(_patchKernel.uniformPatchArray, (int)patchArrays.size(),
-                 (const GLint*)&patchArrays[0]);
     glUniform1i(_patchKernel.uniformSrcOffset, srcDesc.offset);
 
     // input patchcoords
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
     int stride = sizeof(int) * 5; // patchcoord = int*5 struct
     glBindBuffer(GL_ARRAY_BUFFER, patchCoordsBuffer);
     glVertexAttribIPointer(0, 3, GL_UNSIGNED_INT, stride, (void*)0);
@@ -508,28 +652,6 @@ GLXFBEvaluator::EvalPatches(
     glBeginTransformFeedback(GL_POINTS);
     glDrawArrays(GL_POINTS, 0, numPatchCoords);
     glEndTransformFeedback();
-
-    glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
-
-    // unbind textures
-    for (int i = 0; i < 3; ++i) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_BUFFER, 0);
-    }
-
-    glDisable(GL_RASTERIZER_DISCARD);
-    glUseProgram(0);
-    glActiveTexture(GL_TEXTURE0);
-
-    glDisableVertexAttribArray(0);
-    glDisableVertexAttribArray(1);
-
-    // revert vao
-    glBindVertexArray(0);
-    glDeleteVertexArrays(1, &vao);
-
-
-    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -27,6 +27,8 @@
 
 #include "../version.h"
 
+#include <vector>
+
 #include "../osd/opengl.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
@@ -64,6 +66,15 @@ public:
         return new GLStencilTableTBO(limitStencilTable);
     }
 
+    /// \brief Creates the table, then frees the arrays of 'stencilTable'
+    ///        (see Far::StencilTable::Clear) : large tables need not be kept
+    ///        on the host once uploaded
+    static GLStencilTableTBO *CreateAndRelease(Far::StencilTable *stencilTable,
+                                               void *deviceContext = NULL);
+    static GLStencilTableTBO *CreateAndRelease(
+        Far::LimitStencilTable *limitStencilTable,
+        void *deviceContext = NULL);
+
     explicit GLStencilTableTBO(Far::StencilTable const *stencilTable);
     explicit GLStencilTableTBO(Far::LimitStencilTable const *limitStencilTable);
     ~GLStencilTableTBO();
@@ -77,6 +88,10 @@ public:
     GLuint GetDvWeightsTexture() const { return _dvWeights; }
     int GetNumStencils() const { return _numStencils; }
 
+    /// \brief Returns the index of the first stencil of each evaluation pass
+    ///        (see Far::StencilTable::GetPassOffsets())
+    std::vector<int> const & GetPassOffsets() const { return _passOffsets; }
+
 private:
     GLuint _sizes;
     GLuint _offsets;
@@ -84,6 +99,7 @@ private:
     GLuint _weights;
     GLuint _duWeights;
     GLuint _dvWeights;
+    std::vector<int> _passOffsets;
     int _numStencils;
 };
 
@@ -173,6 +189,50 @@ public:
         }
     }
 
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        GLXFBEvaluator const *instance,
+        void * deviceContext = NULL) {
+
+        (void)deviceContext;  // unused
+
+        if (end <= start) return true;
+
+        // Create an instance on demand (slow)
+        GLXFBEvaluator const *kernel = instance ? instance :
+            Create(srcDesc, dstDesc, BufferDescriptor(), BufferDescriptor());
+        if (!kernel) return false;
+
+        // the transform feedback writes the first stencil of the range at
+        // the offset of the descriptor
+        BufferDescriptor rangeDesc = dstDesc;
+        rangeDesc.offset += start * dstDesc.stride;
+
+        bool r = kernel->EvalStencils(srcBuffer->BindVBO(), srcDesc,
+                                      dstBuffer->BindVBO(), rangeDesc,
+                                      0, BufferDescriptor(),
+                                      0, BufferDescriptor(),
+                                      stencilTable->GetSizesTexture(),
+                                      stencilTable->GetOffsetsTexture(),
+                                      stencilTable->GetIndicesTexture(),
+                                      stencilTable->GetWeightsTexture(),
+                                      0,
+                                      0,
+                                      start, end);
+        if (kernel != instance) delete kernel;
+        return r;
+    }
+
     /// \brief Generic static stencil function. This function has a same
     ///        signature as other device kernels have so that it can be called
     ///        transparently from OsdMesh template interface.
@@ -267,18 +327,68 @@ public:
         DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
         STENCIL_TABLE const *stencilTable) const {
 
-        return EvalStencils(srcBuffer->BindVBO(), srcDesc,
-                            dstBuffer->BindVBO(), dstDesc,
-                            0, BufferDescriptor(),
-                            0, BufferDescriptor(),
-                            stencilTable->GetSizesTexture(),
-                            stencilTable->GetOffsetsTexture(),
-                            stencilTable->GetIndicesTexture(),
-                            stencilTable->GetWeightsTexture(),
-                            0,
-                            0,
-                            /* start = */ 0,
-                            /* end   = */ stencilTable->GetNumStencils());
+        return EvalStencilsBatch(1, &srcBuffer, srcDesc, &dstBuffer, dstDesc,
+                                 &stencilTable);
+    }
+
+    /// \brief Evaluates the stencils of several meshes (or primvars) with
+    ///        the same buffer descriptors, e.g. the meshes of a scene sharing
+    ///        an instance of an EvaluatorCacheT.
+    ///
+    /// The vertex array, program and rasterizer discard state are set once
+    /// for the batch, and the source texture buffer and stencil table
+    /// textures are only rebound when they change from one mesh to the
+    /// next : each mesh (and each pass of its table, see
+    /// Far::StencilTable::GetPassOffsets()) is a single transform feedback
+    /// draw.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencilsBatch(
+        int numMeshes,
+        SRC_BUFFER * const *srcBuffers, BufferDescriptor const &srcDesc,
+        DST_BUFFER * const *dstBuffers, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const * const *stencilTables) const {
+
+        if (!_stencilKernel.program) return false;
+        if (numMeshes <= 0) return true;
+
+        BatchState state;
+        GLuint vao = beginDispatches(_stencilKernel.program);
+
+        for (int mesh = 0; mesh < numMeshes; ++mesh) {
+            STENCIL_TABLE const *stencilTable = stencilTables[mesh];
+
+            // Passes refer to the vertices of the previous passes : they are
+            // drawn in order, the transform feedback of a pass writing its
+            // first stencil at the offset of the descriptor
+            std::vector<int> const & passOffsets =
+                stencilTable->GetPassOffsets();
+
+            int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+            for (int pass = 0; pass < numPasses; ++pass) {
+                int start = passOffsets.empty() ? 0 : passOffsets[pass];
+                int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                                 stencilTable->GetNumStencils();
+
+                BufferDescriptor passDesc = dstDesc;
+                passDesc.offset += start * dstDesc.stride;
+
+                dispatchStencils(srcBuffers[mesh]->BindVBO(), srcDesc,
+                                 dstBuffers[mesh]->BindVBO(), passDesc,
+                                 0, BufferDescriptor(),
+                                 0, BufferDescriptor(),
+                                 stencilTable->GetSizesTexture(),
+                                 stencilTable->GetOffsetsTexture(),
+                                 stencilTable->GetIndicesTexture(),
+                                 stencilTable->GetWeightsTexture(),
+                                 0,
+                                 0,
+                                 start, end, &state);
+            }
+        }
+
+        endDispatches(vao, 7);
+        return true;
     }
 
     /// \brief Generic eval stencils function with derivative evaluation.
@@ -635,6 +745,44 @@ public:
                      GLuint patchIndexBuffer,
                      GLuint patchParamsBuffer) const;
 
+    /// \brief Evaluates the limits of several meshes (or primvars) with the
+    ///        same buffer descriptors, setting the vertex array, program and
+    ///        rasterizer discard state once for the batch (see
+    ///        EvalStencilsBatch()).
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesBatch(
+        int numMeshes,
+        SRC_BUFFER * const *srcBuffers, BufferDescriptor const &srcDesc,
+        DST_BUFFER * const *dstBuffers, BufferDescriptor const &dstDesc,
+        int const *numPatchCoords,
+        PATCHCOORD_BUFFER * const *patchCoords,
+        PATCH_TABLE * const *patchTables) const {
+
+        if (!_patchKernel.program) return false;
+        if (numMeshes <= 0) return true;
+
+        BatchState state;
+        GLuint vao = beginPatchDispatches();
+
+        for (int mesh = 0; mesh < numMeshes; ++mesh) {
+            dispatchPatches(srcBuffers[mesh]->BindVBO(), srcDesc,
+                            dstBuffers[mesh]->BindVBO(), dstDesc,
+                            0, BufferDescriptor(),
+                            0, BufferDescriptor(),
+                            numPatchCoords[mesh],
+                            patchCoords[mesh]->BindVBO(),
+                            patchTables[mesh]->GetPatchArrays(),
+                            patchTables[mesh]->GetPatchIndexTextureBuffer(),
+                            patchTables[mesh]->GetPatchParamTextureBuffer(),
+                            &state);
+        }
+
+        endPatchDispatches(vao);
+        return true;
+    }
+
     /// ----------------------------------------------------------------------
     ///
     ///   Other methods
@@ -652,6 +800,52 @@ public:
     static void Synchronize(void *kernel);
 
 private:
+    // bindings of the dispatches of a batch, rebound only when they change
+    struct BatchState {
+        BatchState() : srcBuffer(0), sizesTexture(0), patchIndexTexture(0) { }
+
+        GLuint srcBuffer;
+        GLuint sizesTexture;
+        GLuint patchIndexTexture;
+    };
+
+    // binds a vertex array, enables the rasterizer discard and uses
+    // 'program' for the dispatches of a batch, returning the vertex array
+    GLuint beginDispatches(GLuint program) const;
+    GLuint beginPatchDispatches() const;
+
+    // reverts the state of beginDispatches() and unbinds the textures of
+    // the dispatches
+    void endDispatches(GLuint vao, int numTextures) const;
+    void endPatchDispatches(GLuint vao) const;
+
+    void bindSrcBuffer(GLuint srcBuffer, GLint uniformSrcBufferTexture,
+                       BatchState *state) const;
+
+    void dispatchStencils(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                          GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                          GLuint duBuffer,  BufferDescriptor const &duDesc,
+                          GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+                          GLuint sizesTexture,
+                          GLuint offsetsTexture,
+                          GLuint indicesTexture,
+                          GLuint weightsTexture,
+                          GLuint duWeightsTexture,
+                          GLuint dvWeightsTexture,
+                          int start, int end,
+                          BatchState *state) const;
+
+    void dispatchPatches(GLuint srcBuffer, BufferDescriptor const &srcDesc,
+                         GLuint dstBuffer, BufferDescriptor const &dstDesc,
+                         GLuint duBuffer,  BufferDescriptor const &duDesc,
+                         GLuint dvBuffer,  BufferDescriptor const &dvDesc,
+                         int numPatchCoords,
+                         GLuint patchCoordsBuffer,
+                         const PatchArrayVector &patchArrays,
+                         GLuint patchIndexTexture,
+                         GLuint patchParamTexture,
+                         BatchState *state) const;
+
     GLuint _srcBufferTexture;
 
     struct _StencilKernel {
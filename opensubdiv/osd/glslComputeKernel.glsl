@@ -25,21 +25,52 @@
 //------------------------------------------------------------------------------
 
 
+#if defined(OPENSUBDIV_GLSL_COMPUTE_VULKAN)
+
+// Vulkan kernels are compiled to SPIR-V offline (see vkComputeKernel.comp) :
+// the layout of the vertices is specialized when the pipelines are created,
+// the uniforms are push constants and the buffers are bound to descriptor
+// set 0 (see VkEvaluator).
+
+layout(constant_id=0) const int LENGTH = 1;
+layout(constant_id=1) const int SRC_STRIDE = 1;
+layout(constant_id=2) const int DST_STRIDE = 1;
+
+layout(local_size_x_id=3, local_size_y=1, local_size_z=1) in;
+
+layout(push_constant) uniform OsdComputePushConstants {
+    ivec4 patchArray[2];
+    ivec3 duDesc;
+    int srcOffset;
+    ivec3 dvDesc;
+    int dstOffset;
+    int batchStart;
+    int batchEnd;
+    int evalMode;
+};
+
+#else
 layout(local_size_x=WORK_GROUP_SIZE, local_size_y=1, local_size_z=1) in;
+#endif
+
 layout(std430) buffer;
 
 // source and destination buffers
 
+#if !defined(OPENSUBDIV_GLSL_COMPUTE_VULKAN)
 uniform int srcOffset = 0;
 uniform int dstOffset = 0;
+#endif
 layout(binding=0) buffer src_buffer      { float    srcVertexBuffer[]; };
 layout(binding=1) buffer dst_buffer      { float    dstVertexBuffer[]; };
 
 // derivative buffers (if needed)
 
 #if defined(OPENSUBDIV_GLSL_COMPUTE_USE_DERIVATIVES)
+#if !defined(OPENSUBDIV_GLSL_COMPUTE_VULKAN)
 uniform ivec3 duDesc;
 uniform ivec3 dvDesc;
+#endif
 layout(binding=2) buffer du_buffer   { float duBuffer[]; };
 layout(binding=3) buffer dv_buffer   { float dvBuffer[]; };
 #endif
@@ -48,8 +79,10 @@ layout(binding=3) buffer dv_buffer   { float dvBuffer[]; };
 
 #if defined(OPENSUBDIV_GLSL_COMPUTE_KERNEL_EVAL_STENCILS)
 
+#if !defined(OPENSUBDIV_GLSL_COMPUTE_VULKAN)
 uniform int batchStart = 0;
 uniform int batchEnd = 0;
+#endif
 layout(binding=4) buffer stencilSizes    { int      _sizes[];   };
 layout(binding=5) buffer stencilOffsets  { int      _offsets[]; };
 layout(binding=6) buffer stencilIndices  { int      _indices[]; };
@@ -60,8 +93,18 @@ layout(binding=8) buffer stencilDuWeights { float  _duWeights[]; };
 layout(binding=9) buffer stencilDvWeights { float  _dvWeights[]; };
 #endif
 
+// (srcOffset, dstOffset) pairs of the instances of a batch
+#if defined(OPENSUBDIV_GLSL_COMPUTE_USE_INSTANCES)
+uniform int instanceStart = 0;
+layout(binding=10) buffer instanceOffsetsBuffer { int _instanceOffsets[]; };
 #endif
 
+#endif
+
+// offsets of the instance being evaluated (if any)
+int srcInstanceOffset = 0;
+int dstInstanceOffset = 0;
+
 // patch buffers
 
 #if defined(OPENSUBDIV_GLSL_COMPUTE_KERNEL_EVAL_PATCHES)
@@ -78,7 +121,10 @@ struct PatchParam {
     uint field1;
     float sharpness;
 };
+#if !defined(OPENSUBDIV_GLSL_COMPUTE_VULKAN)
 uniform ivec4 patchArray[2];
+uniform int evalMode = 0;
+#endif
 layout(binding=4) buffer patchCoord_buffer { PatchCoord patchCoords[]; };
 layout(binding=5) buffer patchIndex_buffer { int patchIndexBuffer[]; };
 layout(binding=6) buffer patchParam_buffer { PatchParam patchParamBuffer[]; };
@@ -99,7 +145,7 @@ void clear(out Vertex v) {
 
 Vertex readVertex(int index) {
     Vertex v;
-    int vertexIndex = srcOffset + index * SRC_STRIDE;
+    int vertexIndex = srcOffset + srcInstanceOffset + index * SRC_STRIDE;
     for (int i = 0; i < LENGTH; ++i) {
         v.vertexData[i] = srcVertexBuffer[vertexIndex + i];
     }
@@ -107,7 +153,7 @@ Vertex readVertex(int index) {
 }
 
 void writeVertex(int index, Vertex v) {
-    int vertexIndex = dstOffset + index * DST_STRIDE;
+    int vertexIndex = dstOffset + dstInstanceOffset + index * DST_STRIDE;
     for (int i = 0; i < LENGTH; ++i) {
         dstVertexBuffer[vertexIndex + i] = v.vertexData[i];
     }
@@ -146,6 +192,12 @@ void main() {
         return;
     }
 
+#if defined(OPENSUBDIV_GLSL_COMPUTE_USE_INSTANCES)
+    int instance = int(gl_GlobalInvocationID.y) + instanceStart;
+    srcInstanceOffset = _instanceOffsets[2*instance];
+    dstInstanceOffset = _instanceOffsets[2*instance+1];
+#endif
+
     Vertex dst;
     clear(dst);
 
@@ -267,16 +319,62 @@ void adjustBoundaryWeights(uint bits, inout vec4 sWeights, inout vec4 tWeights)
     }
 }
 
+// primvar classes evaluated by the patch kernel (evalMode)
+const int EVAL_VERTEX = 0;
+const int EVAL_FACE_VARYING = 1;
+const int EVAL_VARYING = 2;       // bilinear on the corners of the patches
+const int EVAL_FACE_UNIFORM = 3;  // copy of the value of the base face
+
+// corners of the patches in their control vertices, for varying evaluation
+int getPatchCorner(int patchType, int corner) {
+    const int regularCorners[4] = int[4](5, 6, 10, 9);
+    const int gregoryBasisCorners[4] = int[4](0, 5, 10, 15);
+    return (patchType == 6) ? regularCorners[corner] :
+           (patchType == 9) ? gregoryBasisCorners[corner] : corner;
+}
+
 void main() {
 
     int current = int(gl_GlobalInvocationID.x);
 
+#if defined(OPENSUBDIV_GLSL_COMPUTE_VULKAN)
+    // Vulkan dispatches are split past the maximum work group count
+    current += batchStart;
+    if (current >= batchEnd) {
+        return;
+    }
+#endif
+
     PatchCoord coord = patchCoords[current];
     int patchIndex = coord.patchIndex;
 
+    if (evalMode == EVAL_FACE_UNIFORM) {
+        // note: the face id of the PatchParam is that of the ptex face
+        Vertex value;
+        clear(value);
+        if (patchIndex >= 0) {
+            int face = int(patchParamBuffer[patchIndex].field0 & 0xfffffffU);
+            value = readVertex(face);
+        }
+        writeVertex(current, value);
+        return;
+    }
+
+    if (evalMode == EVAL_FACE_VARYING && patchIndex >= 0) {
+        // map the vertex patch coord to the patches of the face-varying
+        // channel (see CpuGetFVarPatchCoords) : the patches of bicubic
+        // channels which are not regular use the second, bilinear array
+        bool bicubic = (patchArray[0].x == 6);
+        uint bits = patchParamBuffer[patchIndex].field1;
+        coord.arrayIndex = (bicubic && ((bits >> 5) & 0x1) == 0) ? 1 : 0;
+        coord.vertIndex = patchIndex * (bicubic ? 16 : 4);
+    }
+
     ivec4 array = patchArray[coord.arrayIndex];
-    int patchType = 6; // array.x XXX: REGULAR only for now.
-    int numControlVertices = 16;
+    // XXX: REGULAR only for now, besides bilinear face-varying patches
+    //      and varying evaluation (bilinear on the corners of any patch)
+    int patchType = (array.x == 3 || evalMode == EVAL_VARYING) ? 3 : 6;
+    int numControlVertices = (patchType == 3) ? 4 : 16;
 
     uint patchBits = patchParamBuffer[patchIndex].field1;
     vec2 uv = normalizePatchCoord(patchBits, vec2(coord.s, coord.t));
@@ -298,6 +396,23 @@ void main() {
                 wDt[4*k+l] = sWeights[l]  * dtWeights[k] * dScale;
             }
         }
+    } else if (patchType == 3) {  // QUADS
+        float sC = 1.0f - uv.x, tC = 1.0f - uv.y;
+
+        wP[0] = sC * tC;
+        wP[1] = uv.x * tC;
+        wP[2] = uv.x * uv.y;
+        wP[3] = sC * uv.y;
+
+        wDs[0] = -tC * dScale;
+        wDs[1] =  tC * dScale;
+        wDs[2] =  uv.y * dScale;
+        wDs[3] = -uv.y * dScale;
+
+        wDt[0] = -sC * dScale;
+        wDt[1] = -uv.x * dScale;
+        wDt[2] =  uv.x * dScale;
+        wDt[3] =  sC * dScale;
     } else {
         // TODO: GREGORY BASIS
     }
@@ -309,7 +424,8 @@ void main() {
 
     int indexBase = array.z + coord.vertIndex;
     for (int cv = 0; cv < numControlVertices; ++cv) {
-        int index = patchIndexBuffer[indexBase + cv];
+        int index = patchIndexBuffer[indexBase +
+            ((evalMode == EVAL_VARYING) ? getPatchCorner(array.x, cv) : cv)];
         addWithWeight(dst, readVertex(index), wP[cv]);
         addWithWeight(du, readVertex(index), wDs[cv]);
         addWithWeight(dv, readVertex(index), wDt[cv]);
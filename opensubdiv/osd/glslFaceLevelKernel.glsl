@@ -0,0 +1,147 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+//------------------------------------------------------------------------------
+//
+// View-dependent level selection : picks the level of each base face of a
+// face level table from its screen space extent and its curvature, and
+// compacts the triangles of the visible faces at their level for an indirect
+// draw (see GLFaceLevelSelector and CpuFaceLevelSelector).
+//
+
+layout(local_size_x=WORK_GROUP_SIZE, local_size_y=1, local_size_z=1) in;
+layout(std430) buffer;
+
+uniform int srcOffset = 0;
+uniform int srcStride = 3;
+
+uniform mat4 modelViewMatrix;
+uniform mat4 projectionMatrix;
+uniform float detail = 1;
+uniform float curvatureWeight = 0;
+uniform int numFaces = 0;
+uniform int maxLevel = 0;
+
+layout(binding=0) buffer src_buffer            { float srcVertexBuffer[]; };
+layout(binding=1) buffer triangleOffset_buffer { int triangleOffsets[]; };
+layout(binding=2) buffer triangle_buffer       { int triangles[]; };
+layout(binding=3) buffer cornerOffset_buffer   { int cornerOffsets[]; };
+layout(binding=4) buffer corner_buffer         { int corners[]; };
+layout(binding=5) buffer refinedCorner_buffer  { int refinedCorners[]; };
+layout(binding=6) buffer index_buffer          { int indexBuffer[]; };
+layout(binding=7) buffer faceLevel_buffer      { int faceLevels[]; };
+layout(binding=8) buffer draw_buffer           { uint drawCommand[]; };
+
+//------------------------------------------------------------------------------
+
+vec3 readVertex(int index) {
+    int offset = srcOffset + index * srcStride;
+    return vec3(srcVertexBuffer[offset],
+                srcVertexBuffer[offset + 1],
+                srcVertexBuffer[offset + 2]);
+}
+
+// see CpuTessellator::ComputeTessLevel
+float computeTessLevel(vec3 p0, vec3 p1) {
+    p0 = (modelViewMatrix * vec4(p0, 1.0)).xyz;
+    p1 = (modelViewMatrix * vec4(p1, 1.0)).xyz;
+    vec3 center = (p0 + p1) / 2.0;
+    float diameter = distance(p0, p1);
+    vec4 p = projectionMatrix * vec4(center, 1.0);
+    float projLength = abs(diameter * projectionMatrix[1][1] / p.w);
+    return max(1.0, detail * projLength);
+}
+
+//------------------------------------------------------------------------------
+
+void main() {
+
+    int face = int(gl_GlobalInvocationID.x);
+    if (face >= numFaces) return;
+
+    int firstCorner = cornerOffsets[face];
+    int numCorners = cornerOffsets[face + 1] - firstCorner;
+
+    // the face is culled if its corners and refined corners are all outside
+    // of a same plane of the frustum
+    mat4 modelViewProjectionMatrix = projectionMatrix * modelViewMatrix;
+    ivec3 clipFlag = ivec3(0);
+    for (int i = 0; i < 2 * numCorners; ++i) {
+        int vertex = (i < numCorners) ? corners[firstCorner + i] :
+                                        refinedCorners[firstCorner + i - numCorners];
+        vec4 clipPos = modelViewProjectionMatrix * vec4(readVertex(vertex), 1.0);
+        bvec3 clip0 = lessThan(clipPos.xyz, vec3(clipPos.w));
+        bvec3 clip1 = greaterThan(clipPos.xyz, -vec3(clipPos.w));
+        clipFlag |= ivec3(clip0) + 2*ivec3(clip1);
+    }
+    if (clipFlag != ivec3(3)) {
+        faceLevels[face] = -1;
+        return;
+    }
+
+    // see CpuFaceLevelSelector::ComputeFaceLevels
+    vec3 normal = vec3(0);
+    for (int i = 0; i < numCorners; ++i) {
+        vec3 p0 = readVertex(corners[firstCorner + i]);
+        vec3 p1 = readVertex(corners[firstCorner + (i + 1) % numCorners]);
+        normal += vec3((p0.y - p1.y) * (p0.z + p1.z),
+                       (p0.z - p1.z) * (p0.x + p1.x),
+                       (p0.x - p1.x) * (p0.y + p1.y));
+    }
+    float normalLength = length(normal);
+
+    float rate = 1.0, maxEdgeLength = 0.0, maxOffset = 0.0;
+    for (int i = 0; i < numCorners; ++i) {
+        vec3 p0 = readVertex(corners[firstCorner + i]);
+        vec3 p1 = readVertex(corners[firstCorner + (i + 1) % numCorners]);
+        vec3 r0 = readVertex(refinedCorners[firstCorner + i]);
+
+        rate = max(rate, computeTessLevel(p0, p1));
+
+        maxEdgeLength = max(maxEdgeLength, distance(p0, p1));
+        maxOffset = max(maxOffset, (normalLength > 0.0) ?
+            abs(dot(r0 - p0, normal)) / normalLength : distance(p0, r0));
+    }
+    if (curvatureWeight > 0.0 && maxEdgeLength > 0.0) {
+        rate *= min(1.0, curvatureWeight * maxOffset / maxEdgeLength);
+    }
+
+    int level = (rate > 1.0) ? int(ceil(log2(rate))) : 0;
+    level = min(level, maxLevel);
+    faceLevels[face] = level;
+
+    atomicMax(drawCommand[5], uint(level + 1));
+
+    int range = face * (maxLevel + 1) + level;
+    int firstIndex = triangleOffsets[range];
+    int numIndices = triangleOffsets[range + 1] - firstIndex;
+    if (numIndices == 0) return;
+
+    int dst = int(atomicAdd(drawCommand[0], uint(numIndices)));
+    for (int i = 0; i < numIndices; ++i) {
+        indexBuffer[dst + i] = triangles[firstIndex + i];
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -39,6 +39,7 @@ void main()
 {
     outpt.v.position = position;
     OSD_PATCH_CULL_COMPUTE_CLIPFLAGS(position);
+    OSD_PATCH_DRAW_ID_COMPUTE();
     OSD_USER_VARYING_PER_VERTEX();
 }
 
@@ -70,6 +71,7 @@ void main()
         cv[i] = inpt[i].v.position.xyz;
     }
 
+    OSD_PATCH_DRAW_ID();
     ivec3 patchParam = OsdGetPatchParam(OsdGetPatchIndex(gl_PrimitiveID));
     OsdComputePerPatchVertexBSpline(patchParam, gl_InvocationID, cv, outpt[gl_InvocationID].v);
 
@@ -85,7 +87,11 @@ void main()
 
         OSD_PATCH_CULL(16);
 
-#if defined OSD_ENABLE_SCREENSPACE_TESSELLATION
+#if defined OSD_ENABLE_PATCH_CULL_PREPASS
+        OsdGetTessLevelsCulled(gl_PrimitiveID,
+                         tessLevelOuter, tessLevelInner,
+                         tessOuterLo, tessOuterHi);
+#elif defined OSD_ENABLE_SCREENSPACE_TESSELLATION
         // Gather bezier control points to compute limit surface tess levels
         OsdPerPatchVertexBezier cpBezier[16];
 #if 0
@@ -44,6 +44,31 @@
 // Patches.Common
 //----------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+// Vulkan
+// ----------------------------------------------------------------------------
+//
+// With OSD_PATCH_VULKAN (see VkPatchShaderSource), the shaders are compiled
+// to SPIR-V : the patch parameters and the buffers of legacy Gregory patches
+// are shader storage buffers (OSD_ENABLE_SHADER_STORAGE_BUFFERS), the
+// face-varying data is a uniform texel buffer bound at
+// OSD_FVAR_DATA_BUFFER_BINDING, and the constant tables are not uniforms.
+// The interface blocks between stages have no explicit locations : compile
+// with automatic location mapping (glslangValidator --auto-map-locations).
+// Multi-draw-indirect and the patch culling pre-pass below are GL only.
+//
+
+#ifdef OSD_PATCH_VULKAN
+    #ifndef OSD_ENABLE_SHADER_STORAGE_BUFFERS
+    #define OSD_ENABLE_SHADER_STORAGE_BUFFERS
+    #endif
+    #define OSD_CONSTANT const
+    #define OSD_VERTEX_ID gl_VertexIndex
+#else
+    #define OSD_CONSTANT uniform
+    #define OSD_VERTEX_ID gl_VertexID
+#endif
+
 // XXXdyu all handling of varying data can be managed by client code
 #ifndef OSD_USER_VARYING_DECLARE
 #define OSD_USER_VARYING_DECLARE
@@ -97,6 +122,9 @@ struct ControlVertex {
 #ifdef OSD_ENABLE_PATCH_CULL
     ivec3 clipFlag;
 #endif
+#ifdef OSD_ENABLE_MULTI_DRAW_INDIRECT
+    int drawId;
+#endif
 };
 
 // XXXdyu all downstream data can be handled by client code
@@ -143,16 +171,127 @@ int OsdBaseVertex();
 // along with an optional client provided offset.
 //
 
+// ----------------------------------------------------------------------------
+// Shader storage buffers
+// ----------------------------------------------------------------------------
+//
+// With OSD_ENABLE_SHADER_STORAGE_BUFFERS (GL 4.3), the patch parameters and
+// the buffers of legacy Gregory patches are read from shader storage buffers
+// instead of texture buffers, which are limited in size. Clients bind the
+// buffers of GLPatchTable and GLLegacyGregoryPatchTable (and the vertex
+// buffer) with glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ...) at the binding
+// points below (they can be overridden).
+//
+// Note : shader storage blocks are not required to be supported by the
+// tessellation stages : check GL_MAX_TESS_CONTROL_SHADER_STORAGE_BLOCKS.
+//
+
+#ifdef OSD_ENABLE_SHADER_STORAGE_BUFFERS
+
+#ifndef OSD_PATCH_PARAM_BUFFER_BINDING
+#define OSD_PATCH_PARAM_BUFFER_BINDING 0
+#endif
+#ifndef OSD_VERTEX_BUFFER_BINDING
+#define OSD_VERTEX_BUFFER_BINDING 1
+#endif
+#ifndef OSD_VALENCE_BUFFER_BINDING
+#define OSD_VALENCE_BUFFER_BINDING 2
+#endif
+#ifndef OSD_QUAD_OFFSET_BUFFER_BINDING
+#define OSD_QUAD_OFFSET_BUFFER_BINDING 3
+#endif
+
+layout(std430, binding=OSD_PATCH_PARAM_BUFFER_BINDING)
+readonly buffer OsdPatchParamBlock { int OsdPatchParamBuffer[]; };
+
+#else
+
 uniform isamplerBuffer OsdPatchParamBuffer;
 
+#endif
+
+// ----------------------------------------------------------------------------
+// Multi-draw-indirect
+// ----------------------------------------------------------------------------
+//
+// Patches drawn with glMultiDrawElementsIndirect (see GLMultiDrawPatchTable)
+// fetch the offset of their draw in OsdPatchParamBuffer from
+// OsdDrawParamBuffer instead of calling OsdPrimitiveIdBase().
+//
+// The draw id is read in the vertex shader (the client must enable
+// GL_ARB_shader_draw_parameters before GLSL 4.60) and passed along with the
+// control vertices : Osd tess control shaders set OsdDrawId from it, client
+// shaders of the other stages must set OsdDrawId themselves before fetching
+// patch parameters.
+//
+
+#ifdef OSD_ENABLE_MULTI_DRAW_INDIRECT
+
+#if __VERSION__ >= 460
+    #define OSD_DRAW_ID gl_DrawID
+#else
+    #define OSD_DRAW_ID gl_DrawIDARB
+#endif
+
+uniform isamplerBuffer OsdDrawParamBuffer;
+
+int OsdDrawId = 0;
+
+// x : primitive id base, y : base vertex, z : patch table index
+ivec4 OsdGetDrawParam(int drawId)
+{
+    return texelFetch(OsdDrawParamBuffer, drawId);
+}
+
+#define OSD_PATCH_DRAW_ID_COMPUTE()                  \
+    outpt.v.drawId = OSD_DRAW_ID;
+
+#define OSD_PATCH_DRAW_ID()                          \
+    OsdDrawId = inpt[0].v.drawId;
+
+#else
+
+#define OSD_PATCH_DRAW_ID_COMPUTE()
+#define OSD_PATCH_DRAW_ID()
+
+#endif
+
+// ----------------------------------------------------------------------------
+// Patch culling pre-pass
+// ----------------------------------------------------------------------------
+//
+// Patches culled by GLComputePatchCuller are compacted : the index of each
+// visible patch in OsdPatchParamBuffer is read from OsdCulledPatchBuffer, and
+// its tessellation levels from OsdCulledTessLevelBuffer (see
+// OsdGetTessLevelsCulled).
+//
+
+#ifdef OSD_ENABLE_PATCH_CULL_PREPASS
+uniform isamplerBuffer OsdCulledPatchBuffer;
+uniform samplerBuffer OsdCulledTessLevelBuffer;
+#endif
+
 int OsdGetPatchIndex(int primitiveId)
 {
+#if defined OSD_ENABLE_PATCH_CULL_PREPASS
+    return texelFetch(OsdCulledPatchBuffer,
+                      primitiveId + OsdPrimitiveIdBase()).x;
+#elif defined OSD_ENABLE_MULTI_DRAW_INDIRECT
+    return (primitiveId + OsdGetDrawParam(OsdDrawId).x);
+#else
     return (primitiveId + OsdPrimitiveIdBase());
+#endif
 }
 
 ivec3 OsdGetPatchParam(int patchIndex)
 {
+#ifdef OSD_ENABLE_SHADER_STORAGE_BUFFERS
+    return ivec3(OsdPatchParamBuffer[3*patchIndex],
+                 OsdPatchParamBuffer[3*patchIndex+1],
+                 OsdPatchParamBuffer[3*patchIndex+2]);
+#else
     return texelFetch(OsdPatchParamBuffer, patchIndex).xyz;
+#endif
 }
 
 int OsdGetPatchFaceId(ivec3 patchParam)
@@ -231,6 +370,12 @@ vec4 OsdInterpolatePatchCoord(vec2 localUV, ivec3 patchParam)
 // face varyings
 // ----------------------------------------------------------------------------
 
+#ifdef OSD_PATCH_VULKAN
+#ifndef OSD_FVAR_DATA_BUFFER_BINDING
+#define OSD_FVAR_DATA_BUFFER_BINDING 4
+#endif
+layout(binding=OSD_FVAR_DATA_BUFFER_BINDING)
+#endif
 uniform samplerBuffer OsdFVarDataBuffer;
 
 #ifndef OSD_FVAR_WIDTH
@@ -929,6 +1074,22 @@ OsdGetTessLevelsAdaptiveLimitPoints(OsdPerPatchVertexBezier cpBezier[16],
                          tessLevelOuter, tessLevelInner);
 }
 
+#ifdef OSD_ENABLE_PATCH_CULL_PREPASS
+void
+OsdGetTessLevelsCulled(int primitiveId,
+                 out vec4 tessLevelOuter, out vec2 tessLevelInner,
+                 out vec4 tessOuterLo, out vec4 tessOuterHi)
+{
+    // levels precomputed by the culling pre-pass
+    int index = 2 * (primitiveId + OsdPrimitiveIdBase());
+    tessOuterLo = texelFetch(OsdCulledTessLevelBuffer, index);
+    tessOuterHi = texelFetch(OsdCulledTessLevelBuffer, index + 1);
+
+    OsdComputeTessLevels(tessOuterLo, tessOuterHi,
+                         tessLevelOuter, tessLevelInner);
+}
+#endif
+
 void
 OsdGetTessLevels(vec3 cp0, vec3 cp1, vec3 cp2, vec3 cp3,
                  ivec3 patchParam,
@@ -1093,7 +1254,7 @@ OsdFlipMatrix(mat4 m)
 }
 
 // Regular BSpline to Bezier
-uniform mat4 Q = mat4(
+OSD_CONSTANT mat4 Q = mat4(
     1.f/6.f, 4.f/6.f, 1.f/6.f, 0.f,
     0.f,     4.f/6.f, 2.f/6.f, 0.f,
     0.f,     2.f/6.f, 4.f/6.f, 0.f,
@@ -1101,7 +1262,7 @@ uniform mat4 Q = mat4(
 );
 
 // Infinitely Sharp (boundary)
-uniform mat4 Mi = mat4(
+OSD_CONSTANT mat4 Mi = mat4(
     1.f/6.f, 4.f/6.f, 1.f/6.f, 0.f,
     0.f,     4.f/6.f, 2.f/6.f, 0.f,
     0.f,     2.f/6.f, 4.f/6.f, 0.f,
@@ -1501,7 +1662,7 @@ OsdEvalPatchGregory(ivec3 patchParam, vec2 UV, vec3 cv[20],
 #if defined(OSD_PATCH_GREGORY) || defined(OSD_PATCH_GREGORY_BOUNDARY)
 
 // precomputed catmark coefficient table up to valence 29
-uniform float OsdCatmarkCoefficient[30] = float[](
+OSD_CONSTANT float OsdCatmarkCoefficient[30] = float[](
     0, 0, 0, 0.812816, 0.500000, 0.363644, 0.287514,
     0.238688, 0.204544, 0.179229, 0.159657,
     0.144042, 0.131276, 0.120632, 0.111614,
@@ -1567,35 +1728,55 @@ struct OsdPerPatchVertexGregory {
 #define OSD_NUM_ELEMENTS 3
 #endif
 
+#ifdef OSD_ENABLE_SHADER_STORAGE_BUFFERS
+
+layout(std430, binding=OSD_VERTEX_BUFFER_BINDING)
+readonly buffer OsdVertexBlock { float OsdVertexBuffer[]; };
+layout(std430, binding=OSD_VALENCE_BUFFER_BINDING)
+readonly buffer OsdValenceBlock { int OsdValenceBuffer[]; };
+layout(std430, binding=OSD_QUAD_OFFSET_BUFFER_BINDING)
+readonly buffer OsdQuadOffsetBlock { int OsdQuadOffsetBuffer[]; };
+
+#define OSD_FETCH_VERTEX(index) OsdVertexBuffer[index]
+#define OSD_FETCH_VALENCE(index) OsdValenceBuffer[index]
+#define OSD_FETCH_QUAD_OFFSET(index) OsdQuadOffsetBuffer[index]
+
+#else
+
 uniform samplerBuffer OsdVertexBuffer;
 uniform isamplerBuffer OsdValenceBuffer;
+uniform isamplerBuffer OsdQuadOffsetBuffer;
+
+#define OSD_FETCH_VERTEX(index) texelFetch(OsdVertexBuffer, index).x
+#define OSD_FETCH_VALENCE(index) texelFetch(OsdValenceBuffer, index).x
+#define OSD_FETCH_QUAD_OFFSET(index) texelFetch(OsdQuadOffsetBuffer, index).x
+
+#endif
 
 vec3 OsdReadVertex(int vertexIndex)
 {
     int index = int(OSD_NUM_ELEMENTS * (vertexIndex + OsdBaseVertex()));
-    return vec3(texelFetch(OsdVertexBuffer, index).x,
-                texelFetch(OsdVertexBuffer, index+1).x,
-                texelFetch(OsdVertexBuffer, index+2).x);
+    return vec3(OSD_FETCH_VERTEX(index),
+                OSD_FETCH_VERTEX(index+1),
+                OSD_FETCH_VERTEX(index+2));
 }
 
 int OsdReadVertexValence(int vertexID)
 {
     int index = int(vertexID * (2 * OSD_MAX_VALENCE + 1));
-    return texelFetch(OsdValenceBuffer, index).x;
+    return OSD_FETCH_VALENCE(index);
 }
 
 int OsdReadVertexIndex(int vertexID, int valenceVertex)
 {
     int index = int(vertexID * (2 * OSD_MAX_VALENCE + 1) + 1 + valenceVertex);
-    return texelFetch(OsdValenceBuffer, index).x;
+    return OSD_FETCH_VALENCE(index);
 }
 
-uniform isamplerBuffer OsdQuadOffsetBuffer;
-
 int OsdReadQuadOffset(int primitiveID, int offsetVertex)
 {
     int index = int(4*primitiveID+OsdGregoryQuadOffsetBase() + offsetVertex);
-    return texelFetch(OsdQuadOffsetBuffer, index).x;
+    return OSD_FETCH_QUAD_OFFSET(index);
 }
 
 void
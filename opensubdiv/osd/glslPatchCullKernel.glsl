@@ -0,0 +1,250 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+//------------------------------------------------------------------------------
+//
+// Patch culling pre-pass : culls the patches of a patch array against the
+// view frustum, computes the tessellation levels of the edges of the visible
+// patches and compacts them for an indirect draw (see GLComputePatchCuller).
+//
+
+layout(local_size_x=WORK_GROUP_SIZE, local_size_y=1, local_size_z=1) in;
+layout(std430) buffer;
+
+uniform int srcOffset = 0;
+uniform int srcStride = 3;
+
+uniform mat4 modelViewMatrix;
+uniform mat4 projectionMatrix;
+uniform float tessLevel = 1;
+uniform float maxTessLevel = 64;
+uniform int screenSpaceTessellation = 1;
+
+// numPatches, indexBase, primitiveIdBase, numControlVertices
+uniform ivec4 patchArray;
+uniform int patchType = 0;
+uniform int drawCommand = 0;
+uniform int enableCull = 1;
+
+layout(binding=0) buffer src_buffer       { float srcVertexBuffer[]; };
+layout(binding=1) buffer patchIndex_buffer { int patchIndexBuffer[]; };
+layout(binding=2) buffer patchParam_buffer { int patchParamBuffer[]; };
+layout(binding=3) buffer culledIndex_buffer { int culledIndexBuffer[]; };
+layout(binding=4) buffer culledPatch_buffer { int culledPatchBuffer[]; };
+layout(binding=5) buffer tessLevel_buffer  { vec4 tessLevelBuffer[]; };
+layout(binding=6) buffer draw_buffer       { uint drawCommands[]; };
+
+#define PATCH_TYPE_REGULAR          6
+#define PATCH_TYPE_GREGORY_BASIS    9
+
+//------------------------------------------------------------------------------
+
+vec3 readVertex(int index) {
+    int offset = srcOffset + index * srcStride;
+    return vec3(srcVertexBuffer[offset],
+                srcVertexBuffer[offset + 1],
+                srcVertexBuffer[offset + 2]);
+}
+
+// see OsdComputeTessLevel (glslPatchCommon.glsl)
+float computeTessLevel(vec3 p0, vec3 p1) {
+    p0 = (modelViewMatrix * vec4(p0, 1.0)).xyz;
+    p1 = (modelViewMatrix * vec4(p1, 1.0)).xyz;
+    vec3 center = (p0 + p1) / 2.0;
+    float diameter = distance(p0, p1);
+    vec4 p = projectionMatrix * vec4(center, 1.0);
+    float projLength = abs(diameter * projectionMatrix[1][1] / p.w);
+    float level = max(1.0, tessLevel * projLength);
+    return min(level, maxTessLevel / 2);
+}
+
+// see OsdGetTessLevelsUniform (glslPatchCommon.glsl)
+void getTessLevelsUniform(ivec3 patchParam,
+                          out vec4 tessOuterLo, out vec4 tessOuterHi) {
+    int refinementLevel = (patchParam.y & 0xf);
+    float level = min(tessLevel, maxTessLevel) / pow(2, refinementLevel-1);
+
+    int transitionMask = ((patchParam.x >> 28) & 0xf);
+    vec4 tessLevelMin = vec4(1) + vec4(((transitionMask & 8) >> 3),
+                                       ((transitionMask & 1) >> 0),
+                                       ((transitionMask & 2) >> 1),
+                                       ((transitionMask & 4) >> 2));
+
+    tessOuterLo = max(vec4(level), tessLevelMin);
+    tessOuterHi = vec4(0);
+}
+
+// see OsdComputeBSplineBoundaryPoints (glslPatchCommon.glsl)
+void computeBSplineBoundaryPoints(inout vec3 cpt[20], ivec3 patchParam) {
+    int boundaryMask = ((patchParam.y >> 8) & 0xf);
+
+    if ((boundaryMask & 1) != 0) {
+        cpt[0] = 2*cpt[4] - cpt[8];
+        cpt[1] = 2*cpt[5] - cpt[9];
+        cpt[2] = 2*cpt[6] - cpt[10];
+        cpt[3] = 2*cpt[7] - cpt[11];
+    }
+    if ((boundaryMask & 2) != 0) {
+        cpt[3] = 2*cpt[2] - cpt[1];
+        cpt[7] = 2*cpt[6] - cpt[5];
+        cpt[11] = 2*cpt[10] - cpt[9];
+        cpt[15] = 2*cpt[14] - cpt[13];
+    }
+    if ((boundaryMask & 4) != 0) {
+        cpt[12] = 2*cpt[8] - cpt[4];
+        cpt[13] = 2*cpt[9] - cpt[5];
+        cpt[14] = 2*cpt[10] - cpt[6];
+        cpt[15] = 2*cpt[11] - cpt[7];
+    }
+    if ((boundaryMask & 8) != 0) {
+        cpt[0] = 2*cpt[1] - cpt[2];
+        cpt[4] = 2*cpt[5] - cpt[6];
+        cpt[8] = 2*cpt[9] - cpt[10];
+        cpt[12] = 2*cpt[13] - cpt[14];
+    }
+}
+
+// see OsdGetTessLevelsRefinedPoints (glslPatchCommon.glsl)
+void getTessLevelsRefinedPoints(vec3 cp[20], ivec3 patchParam,
+                                out vec4 tessOuterLo, out vec4 tessOuterHi) {
+    vec3 vv0 = (cp[0] + cp[2] + cp[8] + cp[10]) * 0.015625 +
+               (cp[1] + cp[4] + cp[6] + cp[9]) * 0.09375 + cp[5] * 0.5625;
+    vec3 ev01 = (cp[1] + cp[2] + cp[9] + cp[10]) * 0.0625 +
+                (cp[5] + cp[6]) * 0.375;
+
+    vec3 vv1 = (cp[1] + cp[3] + cp[9] + cp[11]) * 0.015625 +
+               (cp[2] + cp[5] + cp[7] + cp[10]) * 0.09375 + cp[6] * 0.5625;
+    vec3 ev12 = (cp[5] + cp[7] + cp[9] + cp[11]) * 0.0625 +
+                (cp[6] + cp[10]) * 0.375;
+
+    vec3 vv2 = (cp[5] + cp[7] + cp[13] + cp[15]) * 0.015625 +
+               (cp[6] + cp[9] + cp[11] + cp[14]) * 0.09375 + cp[10] * 0.5625;
+    vec3 ev23 = (cp[5] + cp[6] + cp[13] + cp[14]) * 0.0625 +
+                (cp[9] + cp[10]) * 0.375;
+
+    vec3 vv3 = (cp[4] + cp[6] + cp[12] + cp[14]) * 0.015625 +
+               (cp[5] + cp[8] + cp[10] + cp[13]) * 0.09375 + cp[9] * 0.5625;
+    vec3 ev03 = (cp[4] + cp[6] + cp[8] + cp[10]) * 0.0625 +
+                (cp[5] + cp[9]) * 0.375;
+
+    tessOuterLo = vec4(0);
+    tessOuterHi = vec4(0);
+
+    int transitionMask = ((patchParam.x >> 28) & 0xf);
+
+    if ((transitionMask & 8) != 0) {
+        tessOuterLo[0] = computeTessLevel(vv0, ev03);
+        tessOuterHi[0] = computeTessLevel(vv3, ev03);
+    } else {
+        tessOuterLo[0] = computeTessLevel(cp[5], cp[9]);
+    }
+    if ((transitionMask & 1) != 0) {
+        tessOuterLo[1] = computeTessLevel(vv0, ev01);
+        tessOuterHi[1] = computeTessLevel(vv1, ev01);
+    } else {
+        tessOuterLo[1] = computeTessLevel(cp[5], cp[6]);
+    }
+    if ((transitionMask & 2) != 0) {
+        tessOuterLo[2] = computeTessLevel(vv1, ev12);
+        tessOuterHi[2] = computeTessLevel(vv2, ev12);
+    } else {
+        tessOuterLo[2] = computeTessLevel(cp[6], cp[10]);
+    }
+    if ((transitionMask & 4) != 0) {
+        tessOuterLo[3] = computeTessLevel(vv3, ev23);
+        tessOuterHi[3] = computeTessLevel(vv2, ev23);
+    } else {
+        tessOuterLo[3] = computeTessLevel(cp[9], cp[10]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void main() {
+
+    int current = int(gl_GlobalInvocationID.x);
+    if (current >= patchArray.x) return;
+
+    int numControlVertices = patchArray.w;
+    int indexBase = patchArray.y + current * numControlVertices;
+    int patchIndex = patchArray.z + current;
+
+    ivec3 patchParam = ivec3(patchParamBuffer[patchIndex * 3],
+                             patchParamBuffer[patchIndex * 3 + 1],
+                             patchParamBuffer[patchIndex * 3 + 2]);
+
+    vec3 cp[20];
+    for (int i = 0; i < numControlVertices && i < 20; ++i) {
+        cp[i] = readVertex(patchIndexBuffer[indexBase + i]);
+    }
+
+    // patches kept in place are not culled (and their draw command is
+    // already complete)
+    int slot = current;
+    if (enableCull != 0) {
+        // the patches lie in the convex hull of their control vertices
+        // (see OSD_PATCH_CULL)
+        mat4 modelViewProjectionMatrix = projectionMatrix * modelViewMatrix;
+        ivec3 clipFlag = ivec3(0);
+        for (int i = 0; i < numControlVertices && i < 20; ++i) {
+            vec4 clipPos = modelViewProjectionMatrix * vec4(cp[i], 1.0);
+            bvec3 clip0 = lessThan(clipPos.xyz, vec3(clipPos.w));
+            bvec3 clip1 = greaterThan(clipPos.xyz, -vec3(clipPos.w));
+            clipFlag |= ivec3(clip0) + 2*ivec3(clip1);
+        }
+        if (clipFlag != ivec3(3)) return;
+
+        slot = int(atomicAdd(drawCommands[5 * drawCommand],
+                             uint(numControlVertices))) / numControlVertices;
+    }
+
+    vec4 tessOuterLo = vec4(0);
+    vec4 tessOuterHi = vec4(0);
+    if (screenSpaceTessellation == 0) {
+        getTessLevelsUniform(patchParam, tessOuterLo, tessOuterHi);
+    } else if (patchType == PATCH_TYPE_REGULAR) {
+        computeBSplineBoundaryPoints(cp, patchParam);
+        getTessLevelsRefinedPoints(cp, patchParam, tessOuterLo, tessOuterHi);
+    } else if (patchType == PATCH_TYPE_GREGORY_BASIS) {
+        // see OsdGetTessLevels : corners of the patch
+        tessOuterLo[0] = computeTessLevel(cp[0], cp[15]);
+        tessOuterLo[1] = computeTessLevel(cp[0], cp[5]);
+        tessOuterLo[2] = computeTessLevel(cp[10], cp[5]);
+        tessOuterLo[3] = computeTessLevel(cp[15], cp[10]);
+    } else {
+        getTessLevelsUniform(patchParam, tessOuterLo, tessOuterHi);
+    }
+
+    int dstIndexBase = patchArray.y + slot * numControlVertices;
+    for (int i = 0; i < numControlVertices; ++i) {
+        culledIndexBuffer[dstIndexBase + i] = patchIndexBuffer[indexBase + i];
+    }
+
+    int dstPatch = patchArray.z + slot;
+    culledPatchBuffer[dstPatch] = patchIndex;
+    tessLevelBuffer[2 * dstPatch] = tessOuterLo;
+    tessLevelBuffer[2 * dstPatch + 1] = tessOuterHi;
+}
+
+//------------------------------------------------------------------------------
@@ -37,7 +37,7 @@ out block {
 
 void main()
 {
-    OsdComputePerVertexGregory(gl_VertexID, position.xyz, outpt.v);
+    OsdComputePerVertexGregory(OSD_VERTEX_ID, position.xyz, outpt.v);
     OSD_PATCH_CULL_COMPUTE_CLIPFLAGS(position);
     OSD_USER_VARYING_PER_VERTEX();
 }
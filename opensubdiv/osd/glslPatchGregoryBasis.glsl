@@ -39,6 +39,7 @@ void main()
 {
     outpt.v.position = position;
     OSD_PATCH_CULL_COMPUTE_CLIPFLAGS(position);
+    OSD_PATCH_DRAW_ID_COMPUTE();
     OSD_USER_VARYING_PER_VERTEX();
 }
 
@@ -65,6 +66,7 @@ void main()
 {
     vec3 cv = inpt[gl_InvocationID].v.position.xyz;
 
+    OSD_PATCH_DRAW_ID();
     ivec3 patchParam = OsdGetPatchParam(OsdGetPatchIndex(gl_PrimitiveID));
     OsdComputePerPatchVertexGregoryBasis(patchParam, gl_InvocationID, cv, outpt[gl_InvocationID].v);
 
@@ -76,9 +78,17 @@ void main()
 
         OSD_PATCH_CULL(20);
 
+#if defined OSD_ENABLE_PATCH_CULL_PREPASS
+        vec4 tessOuterLo = vec4(0);
+        vec4 tessOuterHi = vec4(0);
+        OsdGetTessLevelsCulled(gl_PrimitiveID,
+                         tessLevelOuter, tessLevelInner,
+                         tessOuterLo, tessOuterHi);
+#else
         OsdGetTessLevels(inpt[0].v.position.xyz, inpt[15].v.position.xyz,
                          inpt[10].v.position.xyz, inpt[5].v.position.xyz,
                          patchParam, tessLevelOuter, tessLevelInner);
+#endif
 
         gl_TessLevelOuter[0] = tessLevelOuter[0];
         gl_TessLevelOuter[1] = tessLevelOuter[1];
@@ -0,0 +1,353 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+//------------------------------------------------------------------------------
+//
+// Tessellation of the patches of a patch array into triangles, from the 2
+// rates of each of their edges (see GLComputeTessellator and CpuTessellator).
+//
+// Each work group tessellates a patch : its points and indices are allocated
+// at the end of the output buffers by atomic counters, the rows of the
+// interior of the patch are generated by the invocations of the group, and
+// each of its edges is stitched to the interior by one invocation.
+//
+// The points are written as the PatchCoords of the patch kernel of
+// glslComputeKernel.glsl, and the indices as the triangles of a draw command
+// (its count being the counter of the indices).
+//
+
+layout(local_size_x=WORK_GROUP_SIZE, local_size_y=1, local_size_z=1) in;
+layout(std430) buffer;
+
+// numPatches, indexBase, primitiveIdBase, numControlVertices
+uniform ivec4 patchArray;
+uniform int arrayIndex = 0;
+uniform int triangular = 0;
+uniform int rateShift = 0;
+uniform int maxVertices = 0;
+uniform int maxIndices = 0;
+uniform int finalize = 0;
+
+struct PatchCoord {
+   int arrayIndex;
+   int patchIndex;
+   int vertIndex;
+   float s;
+   float t;
+};
+
+layout(binding=0) buffer edgeRate_buffer   { int edgeRateBuffer[]; };
+layout(binding=1) buffer patchParam_buffer { int patchParamBuffer[]; };
+layout(binding=2) buffer patchCoord_buffer { PatchCoord patchCoords[]; };
+layout(binding=3) buffer index_buffer      { int indexBuffer[]; };
+layout(binding=4) buffer draw_buffer       { uint drawCommand[]; };
+layout(binding=5) buffer counter_buffer    { uint vertexCounter[]; };
+
+// allocation of the points and indices of the patch of the work group
+shared int vertexBase;
+shared int indexBase;
+shared bool allocated;
+
+int patchIndex = 0;
+int vertIndex = 0;
+
+//------------------------------------------------------------------------------
+
+// see TessellationPattern (cpuTessellator.cpp)
+
+int numEdges = 4;
+int rates[4];
+int splitRates[4];
+int innerRate = 1;
+
+// the rates are divided by 2^rateShift for coarser tessellations : split
+// edges remain split, as the edges of the finer patches along them
+void initPattern(int patch) {
+    numEdges = (triangular != 0) ? 3 : 4;
+    innerRate = 1;
+    for (int i = 0; i < 4; ++i) {
+        int lo = edgeRateBuffer[8*patch + 2*i];
+        int hi = edgeRateBuffer[8*patch + 2*i + 1];
+        splitRates[i] = (hi > 0) ? max(1, hi >> rateShift) : 0;
+        rates[i] = max(1, lo >> rateShift) + splitRates[i];
+        if (i < numEdges) {
+            innerRate = max(innerRate, rates[i]);
+        }
+    }
+}
+
+int getNumInnerPoints() {
+    int n = innerRate;
+    if (n == 1) return 0;
+    return (triangular != 0) ? max(1, (n-2)*(n-1)/2) : (n-1)*(n-1);
+}
+
+int getNumInnerSegments() {
+    return max(0, innerRate - ((triangular != 0) ? 3 : 2));
+}
+
+int getNumInnerTriangles() {
+    int n = innerRate;
+    if (triangular != 0) {
+        return (n > 2) ? (n-3)*(n-3) : 0;
+    }
+    return (n > 1) ? 2*(n-2)*(n-2) : 0;
+}
+
+int getNumPoints() {
+    int numPoints = getNumInnerPoints();
+    for (int i = 0; i < numEdges; ++i) {
+        numPoints += rates[i];
+    }
+    return numPoints;
+}
+
+int getNumTriangles() {
+    if (innerRate == 1) {
+        return (triangular != 0) ? 1 : 2;
+    }
+    int numTriangles = getNumInnerTriangles();
+    for (int i = 0; i < numEdges; ++i) {
+        numTriangles += rates[i] + getNumInnerSegments();
+    }
+    return numTriangles;
+}
+
+int innerIndex(int i, int j) {
+    int n = innerRate;
+    if (triangular != 0) {
+        // rows j of (n-1-j) points
+        return (j-1)*(n-1) - (j-1)*j/2 + i - 1;
+    }
+    return (j-1)*(n-1) + (i-1);
+}
+
+int innerSideIndex(int side, int k) {
+    int n = innerRate;
+    if (triangular != 0) {
+        if (n == 2) return 0;
+        if (side == 0) return innerIndex(1 + k, 1);
+        if (side == 1) return innerIndex(n - 2 - k, 1 + k);
+        return innerIndex(1, n - 2 - k);
+    }
+    if (side == 0) return innerIndex(1 + k, 1);
+    if (side == 1) return innerIndex(n - 1, 1 + k);
+    if (side == 2) return innerIndex(n - 1 - k, n - 1);
+    return innerIndex(1, n - 1 - k);
+}
+
+int outerIndex(int edge, int k) {
+    if (k == rates[edge]) {
+        edge = (edge + 1) % numEdges;
+        k = 0;
+    }
+    int index = getNumInnerPoints();
+    for (int i = 0; i < edge; ++i) {
+        index += rates[i];
+    }
+    return index + k;
+}
+
+float edgeFraction(int edge, int k) {
+    int m = rates[edge], hi = splitRates[edge];
+    if (hi == 0) {
+        return float(k) / float(m);
+    }
+    int lo = m - hi;
+    return (k <= lo) ? 0.5 * float(k) / float(lo) :
+                       0.5 + 0.5 * float(k - lo) / float(hi);
+}
+
+vec2 corner(int c) {
+    const vec2 quadCorners[4] =
+        vec2[4](vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1));
+    const vec2 triCorners[4] =
+        vec2[4](vec2(0, 0), vec2(1, 0), vec2(0, 1), vec2(0, 0));
+    return (triangular != 0) ? triCorners[c] : quadCorners[c];
+}
+
+//------------------------------------------------------------------------------
+
+// see PatchParam::Unnormalize() and PatchParam::UnnormalizeTriangle()
+vec2 unnormalize(vec2 uv) {
+    uint bits = uint(patchParamBuffer[3*patchIndex + 1]);
+
+    uint depth = (bits & 0xf);
+    uint nonQuadRoot = (bits >> 4) & 0x1;
+    float frac = (nonQuadRoot == 1) ? 1.0 / float(1 << (depth-1)) :
+                                      1.0 / float(1 << depth);
+
+    uint iu = (bits >> 22) & 0x3ff;
+    uint iv = (bits >> 12) & 0x3ff;
+
+    if (triangular != 0 && (iu + iv) >= (1u << depth)) {
+        // rotated triangles are reversed from the far corner of their cell
+        return vec2(1.0) - (vec2(iu, iv) + uv) * frac;
+    }
+    return (vec2(iu, iv) + uv) * frac;
+}
+
+void writePoint(int index, vec2 uv) {
+    uv = unnormalize(uv);
+    patchCoords[vertexBase + index] =
+        PatchCoord(arrayIndex, patchIndex, vertIndex, uv.x, uv.y);
+}
+
+void writeTriangle(int triangle, int i0, int i1, int i2) {
+    int index = indexBase + 3 * triangle;
+    indexBuffer[index]     = vertexBase + i0;
+    indexBuffer[index + 1] = vertexBase + i1;
+    indexBuffer[index + 2] = vertexBase + i2;
+}
+
+//------------------------------------------------------------------------------
+
+void main() {
+
+    if (finalize != 0) {
+        // patches which did not fit were skipped : the counters are clamped
+        // to the sizes of the buffers
+        if (gl_GlobalInvocationID.x == 0) {
+            drawCommand[0] = min(drawCommand[0], uint(maxIndices));
+            vertexCounter[0] = min(vertexCounter[0], uint(maxVertices));
+        }
+        return;
+    }
+
+    int current = int(gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x);
+    if (current >= patchArray.x) return;
+
+    patchIndex = patchArray.z + current;
+    vertIndex = current * patchArray.w;
+
+    initPattern(patchIndex);
+
+    int numPoints = getNumPoints();
+    int numIndices = 3 * getNumTriangles();
+
+    int lid = int(gl_LocalInvocationIndex);
+    if (lid == 0) {
+        vertexBase = int(atomicAdd(vertexCounter[0], uint(numPoints)));
+        indexBase = int(atomicAdd(drawCommand[0], uint(numIndices)));
+        allocated = (vertexBase + numPoints <= maxVertices) &&
+                    (indexBase + numIndices <= maxIndices);
+    }
+    barrier();
+
+    if (!allocated) {
+        // the indices reserved in the buffer are degenerate triangles
+        int end = min(indexBase + numIndices, maxIndices);
+        for (int i = indexBase + lid; i < end; i += WORK_GROUP_SIZE) {
+            indexBuffer[i] = 0;
+        }
+        return;
+    }
+
+    int n = innerRate;
+    float dn = 1.0 / float(n);
+
+    // interior points and triangles, by rows
+    if (triangular != 0) {
+        if (n == 2 && lid == 0) {
+            writePoint(0, vec2(1.0 / 3.0));
+        }
+        for (int j = 1 + lid; j <= n-2; j += WORK_GROUP_SIZE) {
+            for (int i = 1; i+j <= n-1; ++i) {
+                writePoint(innerIndex(i, j), vec2(i, j) * dn);
+            }
+            // rows r < j have (n-2-r) + (n-3-r) triangles
+            int triangle = (j-1)*(2*n-5) - (j-1)*j;
+            for (int i = 1; i+j <= n-2; ++i) {
+                writeTriangle(triangle++, innerIndex(i, j),
+                              innerIndex(i+1, j), innerIndex(i, j+1));
+                if (i+j <= n-3) {
+                    writeTriangle(triangle++, innerIndex(i+1, j),
+                                  innerIndex(i+1, j+1), innerIndex(i, j+1));
+                }
+            }
+        }
+    } else {
+        for (int j = 1 + lid; j <= n-1; j += WORK_GROUP_SIZE) {
+            for (int i = 1; i <= n-1; ++i) {
+                writePoint(innerIndex(i, j), vec2(i, j) * dn);
+            }
+            if (j <= n-2) {
+                int triangle = 2*(j-1)*(n-2);
+                for (int i = 1; i <= n-2; ++i) {
+                    writeTriangle(triangle++, innerIndex(i, j),
+                                  innerIndex(i+1, j), innerIndex(i+1, j+1));
+                    writeTriangle(triangle++, innerIndex(i, j),
+                                  innerIndex(i+1, j+1), innerIndex(i, j+1));
+                }
+            }
+        }
+    }
+
+    // edge points and stitches, an edge per invocation
+    int edge = lid;
+    if (edge >= numEdges) return;
+
+    vec2 c0 = corner(edge);
+    vec2 c1 = corner((edge + 1) % numEdges);
+    for (int k = 0; k < rates[edge]; ++k) {
+        writePoint(outerIndex(edge, k), mix(c0, c1, edgeFraction(edge, k)));
+    }
+
+    if (n == 1) {
+        if (edge == 0) {
+            writeTriangle(0, outerIndex(0, 0), outerIndex(1, 0),
+                          outerIndex(2, 0));
+            if (triangular == 0) {
+                writeTriangle(1, outerIndex(0, 0), outerIndex(2, 0),
+                              outerIndex(3, 0));
+            }
+        }
+        return;
+    }
+
+    // stitch the edge to the facing side of the interior, advancing along
+    // the side whose next point is closest to the corner of the edge
+    int numSegments = getNumInnerSegments();
+    int triangle = getNumInnerTriangles();
+    for (int e = 0; e < edge; ++e) {
+        triangle += rates[e] + numSegments;
+    }
+
+    int m = rates[edge];
+    for (int i = 0, k = 0; (i < m) || (k < numSegments); ) {
+        bool outer = (k == numSegments) || ((i < m) &&
+            (edgeFraction(edge, i + 1) <= float(k + 2) * dn));
+        if (outer) {
+            writeTriangle(triangle++, outerIndex(edge, i),
+                          outerIndex(edge, i + 1), innerSideIndex(edge, k));
+            ++i;
+        } else {
+            writeTriangle(triangle++, outerIndex(edge, i),
+                          innerSideIndex(edge, k + 1), innerSideIndex(edge, k));
+            ++k;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_GPU_TIMER_H
+#define OPENSUBDIV3_OSD_GPU_TIMER_H
+
+#include "../version.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Interface of the timers of the GPU work of the device evaluators
+///
+/// The CPU time measured around the calls of a device evaluator (e.g. with
+/// the Stopwatch of the examples) is the time of issuing the work : a
+/// GpuTimer records timestamps into the queue of the device instead, and
+/// measures the time the device spent executing the work issued between
+/// Begin() and End(), e.g. the EvalStencils() and EvalPatches() calls of a
+/// frame. The results are read back later (typically a frame later), so
+/// that the measurement does not stall the device.
+///
+/// Each backend provides its own timer (GLGpuTimer for GLComputeEvaluator
+/// and GLXFBEvaluator, D3D11GpuTimer, CudaGpuTimer and CLGpuTimer), behind
+/// this common query API.
+///
+class GpuTimer {
+public:
+    virtual ~GpuTimer() { }
+
+    /// \brief Records the start of the timed work into the device queue
+    ///
+    /// @param deviceContext  queue of the device evaluator calls (see the
+    ///                       timer of each backend)
+    ///
+    virtual void Begin(void * deviceContext = 0) = 0;
+
+    /// \brief Records the end of the timed work into the device queue
+    ///
+    /// @param deviceContext  the queue passed to Begin()
+    ///
+    virtual void End(void * deviceContext = 0) = 0;
+
+    /// \brief Returns the time spent by the device on the timed work, in
+    ///        milliseconds
+    ///
+    /// @param wait  wait for the device to complete the timed work if true,
+    ///              otherwise return a negative time if it has not yet
+    ///
+    virtual double GetElapsedTime(bool wait = true) = 0;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_GPU_TIMER_H
@@ -43,6 +43,7 @@ struct Vertex {
 };
 
 void clear(out Vertex v) {
+    [unroll]
     for (int i = 0; i < LENGTH; ++i) {
         v.vertexData[i] = 0;
     }
@@ -51,6 +52,7 @@ void clear(out Vertex v) {
 Vertex readVertex(int index) {
     Vertex v;
     int vertexIndex = srcOffset + index * SRC_STRIDE;
+    [unroll]
     for (int i = 0; i < LENGTH; ++i) {
         v.vertexData[i] = vertexBuffer[vertexIndex + i];
     }
@@ -59,6 +61,7 @@ Vertex readVertex(int index) {
 
 void writeVertex(int index, Vertex v) {
     int vertexIndex = dstOffset + index * DST_STRIDE;
+    [unroll]
     for (int i = 0; i < LENGTH; ++i) {
         vertexBuffer[vertexIndex + i] = v.vertexData[i];
     }
@@ -66,12 +69,14 @@ void writeVertex(int index, Vertex v) {
 
 void writeVertexSeparate(int index, Vertex v) {
     int vertexIndex = dstOffset + index * DST_STRIDE;
+    [unroll]
     for (int i = 0; i < LENGTH; ++i) {
         dstVertexBuffer[vertexIndex + i] = v.vertexData[i];
     }
 }
 
 void addWithWeight(inout Vertex v, const Vertex src, float weight) {
+    [unroll]
     for (int i = 0; i < LENGTH; ++i) {
         v.vertexData[i] += weight * src.vertexData[i];
     }
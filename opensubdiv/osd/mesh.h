@@ -27,18 +27,25 @@
 
 #include "../version.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <cstring>
+#include <string>
 #include <vector>
 
 #include "../far/topologyRefiner.h"
 #include "../far/patchTableFactory.h"
 #include "../far/stencilTable.h"
 #include "../far/stencilTableFactory.h"
+#include "../far/stencilReverseIndex.h"
 
 #include "../osd/bufferDescriptor.h"
 
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
 struct ID3D11DeviceContext;
 
 namespace OpenSubdiv {
@@ -54,12 +61,47 @@ enum MeshBits {
     MeshEndCapBSplineBasis   = 4,  // exclusive
     MeshEndCapGregoryBasis   = 5,  // exclusive
     MeshEndCapLegacyGregory  = 6,  // exclusive
-    NUM_MESH_BITS            = 7,
+    MeshDirtyUpdate          = 7,  // refine only the stencils of updated vertices
+    MeshLevelsOfDetail       = 8,  // patch tables of all isolation levels
+    MeshOptimizeVertexCache  = 9,  // reorder uniform faces for the vertex cache
+    MeshUseInfSharpPatch     = 10, // stop isolation at regular inf-sharp features
+    MeshConvertLegacyGregory = 11, // build legacy Gregory end caps as Gregory basis
+    MeshAsyncRefine          = 12, // double-buffered vertices, see RefineAsync()
+    MeshProgressiveLevels    = 13, // levels refined selectively, see SetRefinedLevel()
+    MeshSkipUnchanged        = 14, // Refine() is a no-op until buffers are updated
+    MeshHashControlVertices  = 15, // updates of unchanged control vertices are ignored
+    MeshLocalPointPass       = 16, // local points refined from the refined vertices
+    MeshSortPatchesByFace    = 17, // patches drawn in order of their ptex faces
+    NUM_MESH_BITS            = 18,
 };
 typedef std::bitset<NUM_MESH_BITS> MeshBitset;
 
 // ---------------------------------------------------------------------------
 
+///
+///  \brief Interface to a worker thread of the client, on which
+///         Mesh::RefineAsync() refines the vertices of the next frame
+///
+///  As with Far::TaskScheduler, the threads remain those of the client : a
+///  worker need only run one task at a time, on a thread other than the one
+///  calling RefineAsync() (e.g. a thread of an existing job system).
+///
+class MeshWorker {
+public:
+    /// \brief Function run by the worker
+    typedef void (*Task)(void * data);
+
+    virtual ~MeshWorker() { }
+
+    /// \brief Starts running the task, and returns without waiting for it
+    virtual void Launch(Task task, void * data) = 0;
+
+    /// \brief Returns once the last task launched has completed
+    virtual void Wait() = 0;
+};
+
+// ---------------------------------------------------------------------------
+
 template <class PATCH_TABLE>
 class MeshInterface {
 public:
@@ -78,6 +120,11 @@ public:
     virtual void UpdateVertexBuffer(float const *vertexData,
                                     int startVertex, int numVerts) = 0;
 
+    /// Updates the scattered control vertices 'vertexIndices', whose
+    /// data is packed in 'vertexData'
+    virtual void UpdateVertexBuffer(float const *vertexData,
+                                    int numVerts, int const *vertexIndices) = 0;
+
     virtual void UpdateVaryingBuffer(float const *varyingData,
                                      int startVertex, int numVerts) = 0;
 
@@ -96,10 +143,12 @@ public:
 protected:
     static inline void refineMesh(Far::TopologyRefiner & refiner,
                                   int level, bool adaptive,
-                                  bool singleCreasePatch) {
+                                  bool singleCreasePatch,
+                                  bool infSharpPatch = false) {
         if (adaptive) {
             Far::TopologyRefiner::AdaptiveOptions options(level);
             options.useSingleCreasePatch = singleCreasePatch;
+            options.useInfSharpPatch = infSharpPatch;
             refiner.RefineAdaptive(options);
         } else {
             //  This dependency on FVar channels should not be necessary
@@ -161,13 +210,67 @@ convertToCompatibleStencilTable<Far::StencilTable, Far::StencilTable, ID3D11Devi
 // note: this is just an example usage and client applications are supposed
 //       to implement their own structure for Evaluator instance.
 //
+// The cache can be shared by meshes refined from concurrent threads : the
+// lookups of existing evaluators take no lock, and the creations of missing
+// ones are serialized (each evaluator is created once).
+//
+
+/// @cond INTERNAL
+
+// Atomic accesses to the state of EvaluatorCacheT shared across threads
+// (compiler intrinsics, as the library does not require C++11)
+struct EvaluatorCacheAtomics {
+
+    template <typename T>
+    static T * LoadAcquire(T * volatile const &p) {
+#if defined(_MSC_VER)
+        return static_cast<T *>(_InterlockedCompareExchangePointer(
+            (void * volatile *)&p, NULL, NULL));
+#else
+        return __atomic_load_n(&p, __ATOMIC_ACQUIRE);
+#endif
+    }
+
+    template <typename T>
+    static void StoreRelease(T * volatile &p, T *value) {
+#if defined(_MSC_VER)
+        _InterlockedExchangePointer((void * volatile *)&p, value);
+#else
+        __atomic_store_n(&p, value, __ATOMIC_RELEASE);
+#endif
+    }
+
+    static bool TryLock(long volatile &lock) {
+#if defined(_MSC_VER)
+        return _InterlockedExchange(&lock, 1) == 0;
+#else
+        return __atomic_exchange_n(&lock, 1L, __ATOMIC_ACQUIRE) == 0;
+#endif
+    }
+
+    static void Unlock(long volatile &lock) {
+#if defined(_MSC_VER)
+        _InterlockedExchange(&lock, 0);
+#else
+        __atomic_store_n(&lock, 0L, __ATOMIC_RELEASE);
+#endif
+    }
+};
+
+/// @endcond
+
 template <typename EVALUATOR>
 class EvaluatorCacheT {
 public:
+    EvaluatorCacheT() : _evaluators(NULL), _lock(0) { }
+
     ~EvaluatorCacheT() {
-        for(typename Evaluators::iterator it = _evaluators.begin();
-            it != _evaluators.end(); ++it) {
-            delete it->evaluator;
+        Entry *entry = _evaluators;
+        while (entry) {
+            Entry *next = entry->next;
+            delete entry->evaluator;
+            delete entry;
+            entry = next;
         }
     }
 
@@ -178,11 +281,12 @@ public:
               BufferDescriptor const &duDescArg,
               BufferDescriptor const &dvDescArg,
               EVALUATOR *evalArg) : srcDesc(srcDescArg), dstDesc(dstDescArg),
-                              duDesc(duDescArg), dvDesc(dvDescArg), evaluator(evalArg) {}
+                              duDesc(duDescArg), dvDesc(dvDescArg), evaluator(evalArg),
+                              next(NULL) {}
         BufferDescriptor srcDesc, dstDesc, duDesc, dvDesc;
         EVALUATOR *evaluator;
+        Entry *next;  // entries are not modified once published
     };
-    typedef std::vector<Entry> Evaluators;
 
     template <typename DEVICE_CONTEXT>
     EVALUATOR *GetEvaluator(BufferDescriptor const &srcDesc,
@@ -201,23 +305,85 @@ public:
                             BufferDescriptor const &dvDesc,
                             DEVICE_CONTEXT *deviceContext) {
 
-        for(typename Evaluators::iterator it = _evaluators.begin();
-            it != _evaluators.end(); ++it) {
-            if (isEqual(srcDesc, it->srcDesc) &&
-                isEqual(dstDesc, it->dstDesc) &&
-                isEqual(duDesc, it->duDesc) &&
-                isEqual(dvDesc, it->dvDesc)) {
-                return it->evaluator;
-            }
+        // lock-free lookup of the published entries
+        Entry const *found =
+            findEntry(EvaluatorCacheAtomics::LoadAcquire(_evaluators),
+                      srcDesc, dstDesc, duDesc, dvDesc);
+        if (found) return found->evaluator;
+
+        // misses are serialized : the entries published in the meantime
+        // are looked up again before creating the evaluator
+        while (!EvaluatorCacheAtomics::TryLock(_lock)) { }
+
+        Entry *head = _evaluators;
+        found = findEntry(head, srcDesc, dstDesc, duDesc, dvDesc);
+
+        EVALUATOR *e = NULL;
+        if (found) {
+            e = found->evaluator;
+        } else {
+            e = EVALUATOR::Create(srcDesc, dstDesc,
+                                  duDesc, dvDesc,
+                                  deviceContext);
+            Entry *entry = new Entry(srcDesc, dstDesc, duDesc, dvDesc, e);
+            entry->next = head;
+            EvaluatorCacheAtomics::StoreRelease(_evaluators, entry);
         }
-        EVALUATOR *e = EVALUATOR::Create(srcDesc, dstDesc,
-                                         duDesc, dvDesc,
-                                         deviceContext);
-        _evaluators.push_back(Entry(srcDesc, dstDesc, duDesc, dvDesc, e));
+
+        EvaluatorCacheAtomics::Unlock(_lock);
         return e;
     }
 
+    /// \brief Buffer descriptors of an evaluator (see Warmup())
+    struct Descriptors {
+        Descriptors(BufferDescriptor const &srcDescArg,
+                    BufferDescriptor const &dstDescArg,
+                    BufferDescriptor const &duDescArg = BufferDescriptor(),
+                    BufferDescriptor const &dvDescArg = BufferDescriptor()) :
+            srcDesc(srcDescArg), dstDesc(dstDescArg),
+            duDesc(duDescArg), dvDesc(dvDescArg) {}
+        BufferDescriptor srcDesc, dstDesc, duDesc, dvDesc;
+    };
+    typedef std::vector<Descriptors> DescriptorsVector;
+
+    /// \brief Creates the evaluators of the expected descriptors before
+    ///        their first use, e.g. at startup (returns the number of
+    ///        evaluators ready)
+    ///
+    /// Kernels persisted by previous processes in the ProgramCache are
+    /// loaded rather than compiled.
+    ///
+    template <typename DEVICE_CONTEXT>
+    int Warmup(DescriptorsVector const &descriptors,
+               DEVICE_CONTEXT *deviceContext) {
+        int numEvaluators = 0;
+        for (int i = 0; i < (int)descriptors.size(); ++i) {
+            Descriptors const &d = descriptors[i];
+            if (GetEvaluator(d.srcDesc, d.dstDesc, d.duDesc, d.dvDesc,
+                             deviceContext)) {
+                ++numEvaluators;
+            }
+        }
+        return numEvaluators;
+    }
+
 private:
+    static Entry const * findEntry(Entry const *entry,
+                                   BufferDescriptor const &srcDesc,
+                                   BufferDescriptor const &dstDesc,
+                                   BufferDescriptor const &duDesc,
+                                   BufferDescriptor const &dvDesc) {
+        for (; entry; entry = entry->next) {
+            if (isEqual(srcDesc, entry->srcDesc) &&
+                isEqual(dstDesc, entry->dstDesc) &&
+                isEqual(duDesc, entry->duDesc) &&
+                isEqual(dvDesc, entry->dvDesc)) {
+                return entry;
+            }
+        }
+        return NULL;
+    }
+
     static bool isEqual(BufferDescriptor const &a,
                         BufferDescriptor const &b) {
         int offsetA = a.stride ? (a.offset % a.stride) : 0;
@@ -230,7 +396,8 @@ private:
                 a.stride == b.stride);
     }
 
-    Evaluators _evaluators;
+    Entry * volatile _evaluators;
+    long volatile _lock;
 };
 
 /// @cond INTERNAL
@@ -337,9 +504,23 @@ public:
             _numVertices(0),
             _maxValence(0),
             _vertexBuffer(NULL),
+            _backVertexBuffer(NULL),
             _varyingBuffer(NULL),
             _vertexStencilTable(NULL),
             _varyingStencilTable(NULL),
+            _vertexStencilIndex(NULL),
+            _varyingStencilIndex(NULL),
+            _allVerticesDirty(true),
+            _skipUnchanged(bits.test(MeshSkipUnchanged)),
+            _hashControlVertices(bits.test(MeshHashControlVertices)),
+            _updated(true),
+            _worker(NULL),
+            _asyncVertexInstance(NULL),
+            _asyncVaryingInstance(NULL),
+            _numFrames(0),
+            _pendingFrame(-1),
+            _refinedFrame(-1),
+            _refinedLevel(0),
             _evaluatorCache(evaluatorCache),
             _patchTable(NULL),
             _deviceContext(deviceContext) {
@@ -349,7 +530,8 @@ public:
         MeshInterface<PATCH_TABLE>::refineMesh(
             *_refiner, level,
             bits.test(MeshAdaptive),
-            bits.test(MeshUseSingleCreasePatch));
+            bits.test(MeshUseSingleCreasePatch),
+            bits.test(MeshUseInfSharpPatch));
 
         int vertexBufferStride = numVertexElements +
             (bits.test(MeshInterleaveVarying) ? numVaryingElements : 0);
@@ -360,9 +542,12 @@ public:
                           numVaryingElements,
                           level, bits);
 
+        _refinedLevel = _refiner->GetMaxLevel();
+
         initializeVertexBuffers(_numVertices,
                                 vertexBufferStride,
-                                varyingBufferStride);
+                                varyingBufferStride,
+                                bits.test(MeshAsyncRefine));
 
         // configure vertex buffer descriptor
         _vertexDesc =
@@ -377,77 +562,240 @@ public:
     }
 
     virtual ~Mesh() {
+        if (_pendingFrame >= 0 && _worker) {
+            _worker->Wait();
+        }
         delete _refiner;
         delete _farPatchTable;
         delete _vertexBuffer;
+        delete _backVertexBuffer;
         delete _varyingBuffer;
+        for (int i = 0; i < (int)_primvarBuffers.size(); ++i) {
+            delete _primvarBuffers[i].buffer;
+        }
         delete _vertexStencilTable;
         delete _varyingStencilTable;
+        delete _vertexStencilIndex;
+        delete _varyingStencilIndex;
         delete _patchTable;
+        for (int i = 0; i < (int)_lodPatchTables.size(); ++i) {
+            delete _farLodPatchTables[i];
+            delete _lodPatchTables[i];
+        }
         // deviceContext and evaluatorCache are not owned by this class.
     }
 
+    /// Updates control vertices : with MeshHashControlVertices, only the
+    /// vertices which differ from their previous update are uploaded and
+    /// marked for refinement (see Refine())
     virtual void UpdateVertexBuffer(float const *vertexData,
                                     int startVertex, int numVerts) {
-        _vertexBuffer->UpdateData(vertexData, startVertex, numVerts,
-                                  _deviceContext);
+        updateVertexBuffer(vertexData, startVertex, numVerts);
+    }
+
+    virtual void UpdateVertexBuffer(float const *vertexData,
+                                    int numVerts, int const *vertexIndices) {
+        // upload runs of consecutive vertices at once
+        int stride = _vertexBuffer->GetNumElements();
+        for (int i = 0; i < numVerts; ) {
+            int n = 1;
+            while (i + n < numVerts &&
+                   vertexIndices[i + n] == vertexIndices[i] + n) {
+                ++n;
+            }
+            updateVertexBuffer(vertexData + i * stride, vertexIndices[i], n);
+            i += n;
+        }
     }
 
     virtual void UpdateVaryingBuffer(float const *varyingData,
                                      int startVertex, int numVerts) {
-        _varyingBuffer->UpdateData(varyingData, startVertex, numVerts,
-                                   _deviceContext);
+        int numElements = _varyingBuffer->GetNumElements();
+        int numRuns = getChangedRuns(_varyingHashes, varyingData,
+                                     numElements, startVertex, numVerts);
+        for (int i = 0; i < numRuns; i += 2) {
+            _varyingBuffer->UpdateData(
+                varyingData + _changedRuns[i] * numElements,
+                startVertex + _changedRuns[i], _changedRuns[i+1],
+                _deviceContext);
+            markDirtyVertices(startVertex + _changedRuns[i],
+                              _changedRuns[i+1]);
+        }
     }
 
+    /// Refines the mesh : with MeshDirtyUpdate, only the stencils depending
+    /// on the control vertices updated since the previous refinement are
+    /// evaluated again (the first refinement evaluates all of them).
+    ///
+    /// With MeshSkipUnchanged, nothing is evaluated unless a buffer or the
+    /// refined level was updated since the previous refinement, so that
+    /// static meshes cost nothing per frame. Values written into the
+    /// buffers other than through the Update methods of the mesh (e.g.
+    /// wrapped client memory) are then not detected : see MarkUpdated().
     virtual void Refine() {
 
-        int numControlVertices = _refiner->GetLevel(0).GetNumVertices();
+        if (_backVertexBuffer) {
+            // double-buffered : refine the next frame and wait for it
+            RefineAsync();
+            completeRefine();
+            return;
+        }
 
-        BufferDescriptor srcDesc = _vertexDesc;
-        BufferDescriptor dstDesc(srcDesc);
-        dstDesc.offset += numControlVertices * dstDesc.stride;
-
-        // note that the _evaluatorCache can be NULL and thus
-        // the evaluatorInstance can be NULL
-        //  (for uninstantiatable kernels CPU,TBB etc)
-        Evaluator const *instance = GetEvaluator<Evaluator>(
-            _evaluatorCache, srcDesc, dstDesc,
-            _deviceContext);
-
-        Evaluator::EvalStencils(_vertexBuffer, srcDesc,
-                                _vertexBuffer, dstDesc,
-                                _vertexStencilTable,
-                                instance, _deviceContext);
-
-        if (_varyingDesc.length > 0) {
-            BufferDescriptor vSrcDesc = _varyingDesc;
-            BufferDescriptor vDstDesc(vSrcDesc);
-            vDstDesc.offset += numControlVertices * vDstDesc.stride;
-
-            instance = GetEvaluator<Evaluator>(
-                _evaluatorCache, vSrcDesc, vDstDesc,
-                _deviceContext);
+        if (_skipUnchanged && !_updated) return;
+        _updated = false;
+
+        std::vector<Far::Index> const *vertexRanges = NULL,
+                                      *varyingRanges = NULL;
+        bool partial = !_refinedLevelRanges.empty();
+        if (partial) {
+            vertexRanges = varyingRanges = &_refinedLevelRanges;
+        } else if (_vertexStencilIndex && !_allVerticesDirty) {
+            vertexRanges = getDirtyStencilRanges(
+                _vertexStencilIndex, _vertexStencilRanges);
+            varyingRanges = getDirtyStencilRanges(
+                _varyingStencilIndex, _varyingStencilRanges);
+        }
+        _dirtyVertices.clear();
+        // (the vertices of the levels which are not refined are all refined
+        // once their level is selected again)
+        _allVerticesDirty = partial;
 
-            if (_varyingBuffer) {
-                // non-interleaved
-                Evaluator::EvalStencils(_varyingBuffer, vSrcDesc,
-                                        _varyingBuffer, vDstDesc,
-                                        _varyingStencilTable,
-                                        instance, _deviceContext);
-            } else {
-                // interleaved
-                Evaluator::EvalStencils(_vertexBuffer, vSrcDesc,
-                                        _vertexBuffer, vDstDesc,
-                                        _varyingStencilTable,
-                                        instance, _deviceContext);
-            }
+        refineVertexBuffer(_vertexBuffer, vertexRanges, varyingRanges,
+            getEvaluator(_vertexDesc),
+            _varyingDesc.length > 0 ? getEvaluator(_varyingDesc) : NULL);
+
+        refinePrimvarBuffers(vertexRanges, varyingRanges);
+    }
+
+    /// Refines the vertices of the next frame of a mesh created with
+    /// MeshAsyncRefine, on its worker (see SetWorker()) : the control
+    /// vertices updated since the previous refinement are refined in a back
+    /// vertex buffer, while BindVertexBuffer() keeps returning the vertices
+    /// of the current frame to draw. Synchronize() then waits for the
+    /// refinement and swaps the buffers.
+    ///
+    /// All the stencils are evaluated (MeshDirtyUpdate is ignored), and the
+    /// varying and primvar buffers which are not interleaved with the
+    /// vertices are refined by Synchronize(), on the calling thread. The
+    /// evaluator must not depend on the thread (e.g. CPU evaluators).
+    ///
+    /// Control vertices updated before Synchronize() wait for the
+    /// refinement, and go to the following frame. Meshes without a worker
+    /// or MeshAsyncRefine are refined at once.
+    ///
+    /// Returns a handle of the frame refined, i.e. the value returned by
+    /// GetRefinedFrame() once it is drawn.
+    int RefineAsync() {
+
+        if (!_backVertexBuffer) {
+            Refine();
+            _refinedFrame = _numFrames++;
+            return _refinedFrame;
+        }
+
+        completeRefine();
+
+        // the vertices of the current frame are up to date
+        if (_skipUnchanged && !_updated && _refinedFrame >= 0) {
+            return _refinedFrame;
+        }
+        _updated = false;
+
+        // the evaluators are looked up on the calling thread
+        _asyncVertexInstance = getEvaluator(_vertexDesc);
+        _asyncVaryingInstance =
+            _varyingDesc.length > 0 ? getEvaluator(_varyingDesc) : NULL;
+
+        _pendingFrame = _numFrames++;
+        if (_worker) {
+            _worker->Launch(refineTask, this);
+        } else {
+            refineTask(this);
         }
+        return _pendingFrame;
     }
 
     virtual void Synchronize() {
+        completeRefine();
         Evaluator::Synchronize(_deviceContext);
     }
 
+    /// Sets the worker refining the vertices of RefineAsync() (not owned by
+    /// the mesh), or NULL to refine them on the calling thread
+    void SetWorker(MeshWorker *worker) {
+        completeRefine();
+        _worker = worker;
+    }
+
+    /// Marks the mesh for refinement by the next Refine(), for meshes created
+    /// with MeshSkipUnchanged whose buffers were written directly
+    void MarkUpdated() {
+        _updated = true;
+        _allVerticesDirty = true;
+        _dirtyVertices.clear();
+    }
+
+    /// Returns true if the next Refine() evaluates stencils (see
+    /// MeshSkipUnchanged)
+    bool IsUpdated() const { return _updated || !_skipUnchanged; }
+
+    /// Returns the handle of the frame of the vertices of BindVertexBuffer()
+    /// (see RefineAsync()), or -1 before the first refinement
+    int GetRefinedFrame() const { return _refinedFrame; }
+
+    /// Selects the level refined by Refine() in a mesh created with
+    /// MeshProgressiveLevels, from 1 to the last level of the refiner :
+    /// only the vertices of the levels up to 'level' (and the local points
+    /// of its patches) are refined, e.g. to display the first levels as
+    /// long as the frame time allows no more, without rebuilding the mesh
+    /// or reallocating its buffers. The faces of the level are the patch
+    /// array level-1 of GetPatchTable() for uniform meshes, and the patches
+    /// of GetPatchTable(level-1) for adaptive meshes.
+    ///
+    /// Returns false if the level can't be selected (adaptive meshes other
+    /// than Catmark have no patches of the intermediate levels).
+    bool SetRefinedLevel(int level) {
+        int maxLevel = _refiner->GetMaxLevel();
+        if (level == _refinedLevel) return true;
+        if (level < 1 || level > maxLevel || _levelStencilCounts.empty()) {
+            return false;
+        }
+        bool uniform = _refiner->IsUniform();
+        if (!uniform && level < maxLevel &&
+            level > (int)_lodPatchTables.size()) {
+            return false;
+        }
+        completeRefine();
+
+        _refinedLevelRanges.clear();
+        if (level < maxLevel) {
+            // stencils of the levels up to 'level', and of the local points
+            // of its level of detail (following those of the last level)
+            _refinedLevelRanges.push_back(0);
+            _refinedLevelRanges.push_back(_levelStencilCounts[level]);
+            if (!uniform) {
+                Far::Index begin = _levelStencilCounts.back() +
+                                   _lodLocalPointOffsets[level-1],
+                           end = _levelStencilCounts.back() +
+                                   _lodLocalPointOffsets[level];
+                if (begin < end) {
+                    _refinedLevelRanges.push_back(begin);
+                    _refinedLevelRanges.push_back(end);
+                }
+            }
+        }
+        if (level > _refinedLevel) {
+            _allVerticesDirty = true;
+            _dirtyVertices.clear();
+        }
+        _refinedLevel = level;
+        _updated = true;
+        return true;
+    }
+
+    /// Returns the level refined by Refine() (see SetRefinedLevel())
+    int GetRefinedLevel() const { return _refinedLevel; }
+
     virtual PatchTable * GetPatchTable() const {
         return _patchTable;
     }
@@ -456,6 +804,28 @@ public:
         return _farPatchTable;
     }
 
+    /// Returns the number of levels of detail of an adaptive mesh created
+    /// with MeshLevelsOfDetail (1 otherwise) : the patch tables of levels of
+    /// detail 0 to GetNumLevelsOfDetail()-1, isolated to levels 1 and up,
+    /// share the vertex buffer, and any can be drawn after Refine().
+    int GetNumLevelsOfDetail() const {
+        return (int)_lodPatchTables.size() + 1;
+    }
+
+    /// Returns the patch table of a level of detail (the last one is
+    /// GetPatchTable())
+    PatchTable * GetPatchTable(int lod) const {
+        assert(lod >= 0 && lod < GetNumLevelsOfDetail());
+        return lod < (int)_lodPatchTables.size() ?
+            _lodPatchTables[lod] : _patchTable;
+    }
+
+    Far::PatchTable const *GetFarPatchTable(int lod) const {
+        assert(lod >= 0 && lod < GetNumLevelsOfDetail());
+        return lod < (int)_farLodPatchTables.size() ?
+            _farLodPatchTables[lod] : _farPatchTable;
+    }
+
     virtual int GetNumVertices() const { return _numVertices; }
 
     virtual int GetMaxValence() const { return _maxValence; }
@@ -476,20 +846,356 @@ public:
         return _varyingBuffer;
     }
 
+    /// Replaces the vertex buffer of the mesh, e.g. by a buffer wrapping the
+    /// memory of the client (see CpuVertexBuffer::Wrap()). The mesh takes
+    /// ownership of the buffer, which must hold GetNumVertices() vertices
+    /// of the same elements. All the vertices are refined by the next
+    /// Refine(). Returns false (and the buffer is not retained) otherwise,
+    /// or if the vertices are double-buffered (MeshAsyncRefine).
+    bool SetVertexBuffer(VertexBuffer *vertexBuffer) {
+        if (_backVertexBuffer) return false;
+        if (!replaceBuffer(_vertexBuffer, vertexBuffer)) return false;
+        _vertexHashes.clear();
+        MarkUpdated();
+        return true;
+    }
+
+    /// Replaces the non-interleaved varying buffer of the mesh (see above)
+    bool SetVaryingBuffer(VertexBuffer *varyingBuffer) {
+        if (!replaceBuffer(_varyingBuffer, varyingBuffer)) return false;
+        _varyingHashes.clear();
+        MarkUpdated();
+        return true;
+    }
+
     virtual Far::TopologyRefiner const * GetTopologyRefiner() const {
         return _refiner;
     }
 
+    /// Adds a buffer of 'numElements' per vertex for a primvar other than
+    /// those of the vertex and varying buffers. Primvar buffers share the
+    /// stencil tables of the mesh -- its vertex stencils, or its varying
+    /// stencils if 'varying' (which requires numVaryingElements > 0 at
+    /// construction) -- and are refined along with the vertex buffer by
+    /// Refine(). Returns the index of the buffer, or -1 if the name is
+    /// already used or the mesh has no varying stencils.
+    int AddPrimvarBuffer(char const *name, int numElements,
+                         bool varying = false) {
+        if (numElements <= 0 || FindPrimvarBuffer(name) >= 0) return -1;
+        if (varying && !_varyingStencilTable) return -1;
+
+        PrimvarBuffer primvar;
+        primvar.name = name;
+        primvar.buffer = VertexBuffer::Create(numElements, _numVertices,
+                                              _deviceContext);
+        if (!primvar.buffer) return -1;
+        primvar.desc = BufferDescriptor(0, numElements, numElements);
+        primvar.varying = varying;
+        _primvarBuffers.push_back(primvar);
+        return (int)_primvarBuffers.size() - 1;
+    }
+
+    /// Returns the index of the primvar buffer 'name', or -1
+    int FindPrimvarBuffer(char const *name) const {
+        for (int i = 0; i < (int)_primvarBuffers.size(); ++i) {
+            if (_primvarBuffers[i].name == name) return i;
+        }
+        return -1;
+    }
+
+    int GetNumPrimvarBuffers() const {
+        return (int)_primvarBuffers.size();
+    }
+
+    void UpdatePrimvarBuffer(int index, float const *primvarData,
+                             int startVertex, int numVerts) {
+        PrimvarBuffer &primvar = _primvarBuffers[index];
+        int numElements = primvar.desc.stride;
+        int numRuns = getChangedRuns(primvar.hashes, primvarData,
+                                     numElements, startVertex, numVerts);
+        for (int i = 0; i < numRuns; i += 2) {
+            primvar.buffer->UpdateData(
+                primvarData + _changedRuns[i] * numElements,
+                startVertex + _changedRuns[i], _changedRuns[i+1],
+                _deviceContext);
+            markDirtyVertices(startVertex + _changedRuns[i],
+                              _changedRuns[i+1]);
+        }
+    }
+
+    VertexBufferBinding BindPrimvarBuffer(int index) {
+        return _primvarBuffers[index].buffer->BindVBO(_deviceContext);
+    }
+
+    VertexBuffer * GetPrimvarBuffer(int index) {
+        return _primvarBuffers[index].buffer;
+    }
+
 private:
+    void updateVertexBuffer(float const *vertexData, int startVertex,
+                            int numVerts) {
+        int stride = _vertexBuffer->GetNumElements();
+        int numRuns = getChangedRuns(_vertexHashes, vertexData, stride,
+                                     startVertex, numVerts);
+        for (int i = 0; i < numRuns; i += 2) {
+            updateVertices(vertexData + _changedRuns[i] * stride,
+                           startVertex + _changedRuns[i], _changedRuns[i+1]);
+            markDirtyVertices(startVertex + _changedRuns[i],
+                              _changedRuns[i+1]);
+        }
+    }
+
+    // Returns the runs of control vertices of an update (pairs of offset in
+    // the update and number of vertices in _changedRuns) : those whose hash
+    // differs from their previous update with MeshHashControlVertices, or
+    // the whole update otherwise
+    int getChangedRuns(std::vector<unsigned int> &hashes, float const *data,
+                       int numElements, int startVertex, int numVerts) {
+        _changedRuns.clear();
+        if (numVerts <= 0) return 0;
+
+        int numControlVertices = _refiner->GetLevel(0).GetNumVertices();
+        if (!_hashControlVertices || startVertex < 0 ||
+            startVertex + numVerts > numControlVertices) {
+            _changedRuns.push_back(0);
+            _changedRuns.push_back(numVerts);
+            return 2;
+        }
+        // (a hash of 0 denotes a vertex never updated)
+        if (hashes.empty()) hashes.resize(numControlVertices, 0);
+
+        for (int i = 0; i < numVerts; ++i) {
+            // FNV-1a of the bits of the elements of the vertex
+            unsigned int hash = 2166136261u;
+            for (int j = 0; j < numElements; ++j) {
+                unsigned int bits;
+                std::memcpy(&bits, data + i * numElements + j, sizeof(bits));
+                hash = (hash ^ bits) * 16777619u;
+            }
+            hash |= 1;
+
+            if (hashes[startVertex + i] == hash) continue;
+            hashes[startVertex + i] = hash;
+
+            int numRuns = (int)_changedRuns.size();
+            if (numRuns &&
+                _changedRuns[numRuns-2] + _changedRuns[numRuns-1] == i) {
+                ++_changedRuns[numRuns-1];
+            } else {
+                _changedRuns.push_back(i);
+                _changedRuns.push_back(1);
+            }
+        }
+        return (int)_changedRuns.size();
+    }
+
+    // Updates control vertices : those of double-buffered meshes are written
+    // to the back buffer, and carried over to the other buffer when swapped
+    void updateVertices(float const *vertexData, int startVertex,
+                        int numVerts) {
+        if (!_backVertexBuffer) {
+            _vertexBuffer->UpdateData(vertexData, startVertex, numVerts,
+                                      _deviceContext);
+            return;
+        }
+        completeRefine();
+
+        _backVertexBuffer->UpdateData(vertexData, startVertex, numVerts,
+                                      _deviceContext);
+
+        int stride = _backVertexBuffer->GetNumElements();
+        _carriedVertexRanges.push_back(startVertex);
+        _carriedVertexRanges.push_back(numVerts);
+        _carriedVertexData.insert(_carriedVertexData.end(),
+                                  vertexData, vertexData + numVerts * stride);
+    }
+
+    static void refineTask(void *data) {
+        Mesh *mesh = static_cast<Mesh *>(data);
+        std::vector<Far::Index> const *ranges = mesh->getRefinedLevelRanges();
+        mesh->refineVertexBuffer(mesh->_backVertexBuffer, ranges, ranges,
+                                 mesh->_asyncVertexInstance,
+                                 mesh->_asyncVaryingInstance);
+    }
+
+    // Returns the ranges of the stencils of the levels selected by
+    // SetRefinedLevel(), or NULL when all the levels are refined
+    std::vector<Far::Index> const *getRefinedLevelRanges() const {
+        return _refinedLevelRanges.empty() ? NULL : &_refinedLevelRanges;
+    }
+
+    // Waits for the pending asynchronous refinement, swaps the vertex
+    // buffers and refines the other buffers
+    void completeRefine() {
+        if (_pendingFrame < 0) return;
+
+        if (_worker) {
+            _worker->Wait();
+        }
+        std::swap(_vertexBuffer, _backVertexBuffer);
+        _refinedFrame = _pendingFrame;
+        _pendingFrame = -1;
+
+        // the control vertices updated for the frame carry over to the next
+        int stride = _vertexBuffer->GetNumElements();
+        float const *vertexData = _carriedVertexData.empty() ?
+            NULL : &_carriedVertexData[0];
+        for (int i = 0; i < (int)_carriedVertexRanges.size(); i += 2) {
+            _backVertexBuffer->UpdateData(vertexData,
+                _carriedVertexRanges[i], _carriedVertexRanges[i+1],
+                _deviceContext);
+            vertexData += _carriedVertexRanges[i+1] * stride;
+        }
+        _carriedVertexRanges.clear();
+        _carriedVertexData.clear();
+
+        refinePrimvarBuffers(getRefinedLevelRanges(), getRefinedLevelRanges());
+    }
+
+    // Refines the vertices of a vertex buffer, with the varying primvars
+    // interleaved with them
+    void refineVertexBuffer(VertexBuffer *buffer,
+                            std::vector<Far::Index> const *vertexRanges,
+                            std::vector<Far::Index> const *varyingRanges,
+                            Evaluator const *vertexInstance,
+                            Evaluator const *varyingInstance) {
+
+        evalStencils(buffer, _vertexDesc, getRefinedDesc(_vertexDesc),
+                     _vertexStencilTable, vertexRanges, vertexInstance);
+
+        if (_varyingDesc.length > 0 && !_varyingBuffer) {
+            // interleaved
+            evalStencils(buffer, _varyingDesc, getRefinedDesc(_varyingDesc),
+                         _varyingStencilTable, varyingRanges,
+                         varyingInstance);
+        }
+    }
+
+    // Refines the non-interleaved varying buffer and the primvar buffers
+    void refinePrimvarBuffers(std::vector<Far::Index> const *vertexRanges,
+                              std::vector<Far::Index> const *varyingRanges) {
+
+        if (_varyingDesc.length > 0 && _varyingBuffer) {
+            // non-interleaved
+            evalStencils(_varyingBuffer,
+                         _varyingDesc, getRefinedDesc(_varyingDesc),
+                         _varyingStencilTable, varyingRanges,
+                         getEvaluator(_varyingDesc));
+        }
+
+        for (int i = 0; i < (int)_primvarBuffers.size(); ++i) {
+            PrimvarBuffer const &primvar = _primvarBuffers[i];
+
+            if (primvar.varying) {
+                evalStencils(primvar.buffer,
+                             primvar.desc, getRefinedDesc(primvar.desc),
+                             _varyingStencilTable, varyingRanges,
+                             getEvaluator(primvar.desc));
+            } else {
+                evalStencils(primvar.buffer,
+                             primvar.desc, getRefinedDesc(primvar.desc),
+                             _vertexStencilTable, vertexRanges,
+                             getEvaluator(primvar.desc));
+            }
+        }
+    }
+
+    // Returns the descriptor of the refined vertices following the control
+    // vertices of a buffer
+    BufferDescriptor getRefinedDesc(BufferDescriptor const &desc) const {
+        BufferDescriptor refinedDesc(desc);
+        refinedDesc.offset +=
+            _refiner->GetLevel(0).GetNumVertices() * desc.stride;
+        return refinedDesc;
+    }
+
+    // note that the _evaluatorCache can be NULL and thus
+    // the evaluatorInstance can be NULL
+    //  (for uninstantiatable kernels CPU,TBB etc)
+    Evaluator const * getEvaluator(BufferDescriptor const &desc) {
+        return GetEvaluator<Evaluator>(
+            _evaluatorCache, desc, getRefinedDesc(desc), _deviceContext);
+    }
+
+    bool replaceBuffer(VertexBuffer *&buffer, VertexBuffer *newBuffer) {
+        if (!buffer || !newBuffer || newBuffer == buffer ||
+            newBuffer->GetNumElements() != buffer->GetNumElements() ||
+            newBuffer->GetNumVertices() < _numVertices) {
+            return false;
+        }
+        delete buffer;
+        buffer = newBuffer;
+        return true;
+    }
+
+    void markDirtyVertices(int startVertex, int numVerts) {
+        _updated = true;
+        if (!_vertexStencilIndex || _allVerticesDirty) return;
+
+        int numControlVertices = _vertexStencilIndex->GetNumControlVertices();
+        int end = std::min(startVertex + numVerts, numControlVertices);
+        for (int i = std::max(startVertex, 0); i < end; ++i) {
+            _dirtyVertices.push_back(i);
+        }
+        // past half of the control vertices, a full refinement is cheaper
+        // than gathering the stencils
+        if ((int)_dirtyVertices.size() * 2 > numControlVertices) {
+            _allVerticesDirty = true;
+            _dirtyVertices.clear();
+        }
+    }
+
+    // Returns the ranges of stencils of the dirty vertices, or NULL when
+    // the whole table is to be evaluated
+    std::vector<Far::Index> const * getDirtyStencilRanges(
+        Far::StencilReverseIndex const *index,
+        std::vector<Far::Index> &ranges) const {
+
+        if (!index) return NULL;
+
+        int numStencils = index->GetStencilRanges(
+            _dirtyVertices.empty() ? NULL : &_dirtyVertices[0],
+            (int)_dirtyVertices.size(), ranges);
+        if (numStencils * 2 > index->GetNumStencils()) return NULL;
+        return &ranges;
+    }
+
+    void evalStencils(VertexBuffer *buffer,
+                      BufferDescriptor const &srcDesc,
+                      BufferDescriptor const &dstDesc,
+                      StencilTable const *stencilTable,
+                      std::vector<Far::Index> const *ranges,
+                      Evaluator const *instance) {
+        if (!ranges) {
+            Evaluator::EvalStencils(buffer, srcDesc, buffer, dstDesc,
+                                    stencilTable, instance, _deviceContext);
+            return;
+        }
+        for (size_t i = 0; i < ranges->size(); i += 2) {
+            Evaluator::EvalStencilRange(buffer, srcDesc, buffer, dstDesc,
+                                        stencilTable,
+                                        (*ranges)[i], (*ranges)[i+1],
+                                        instance, _deviceContext);
+        }
+    }
+
     void initializeContext(int numVertexElements,
                            int numVaryingElements,
                            int level, MeshBitset bits) {
         assert(_refiner);
 
+        // the levels of progressive meshes share the prefixes of the stencil
+        // tables and the vertex buffers
+        bool progressive = bits.test(MeshProgressiveLevels);
+
         Far::StencilTableFactory::Options options;
         options.generateOffsets = true;
         options.generateIntermediateLevels =
-            _refiner->IsUniform() ? false : true;
+            (_refiner->IsUniform() && !progressive) ? false : true;
+        if (progressive) {
+            Far::StencilTableFactory::GetLevelStencilCounts(
+                *_refiner, options, _levelStencilCounts);
+        }
 
         Far::StencilTable const * vertexStencils = NULL;
         Far::StencilTable const * varyingStencils = NULL;
@@ -512,6 +1218,8 @@ private:
         Far::PatchTableFactory::Options poptions(level);
         poptions.generateFVarTables = bits.test(MeshFVarData);
         poptions.useSingleCreasePatch = bits.test(MeshUseSingleCreasePatch);
+        poptions.useInfSharpPatch = bits.test(MeshUseInfSharpPatch);
+        poptions.generateAllLevels = progressive;
 
         if (bits.test(MeshEndCapBSplineBasis)) {
             poptions.SetEndCapType(
@@ -525,19 +1233,60 @@ private:
         } else if (bits.test(MeshEndCapLegacyGregory)) {
             poptions.SetEndCapType(
                 Far::PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
+            poptions.convertLegacyGregory = bits.test(MeshConvertLegacyGregory);
         }
 
         _farPatchTable = Far::PatchTableFactory::Create(*_refiner, poptions);
 
-        // if there's endcap stencils, merge it into regular stencils.
-        if (_farPatchTable->GetLocalPointStencilTable()) {
+        // reorder the faces of uniform meshes for the vertex cache, and the
+        // refined vertices (following the control vertices) as they are used.
+        if (bits.test(MeshOptimizeVertexCache) && _refiner->IsUniform() &&
+            !progressive) {
+            std::vector<Far::Index> permutation;
+            if (Far::PatchTableFactory::OptimizeVertexCache(
+                    *_farPatchTable, &permutation,
+                    _refiner->GetLevel(0).GetNumVertices())) {
+                permuteStencils(&vertexStencils, permutation);
+                permuteStencils(&varyingStencils, permutation);
+            }
+        } else if (bits.test(MeshSortPatchesByFace)) {
+            // consecutive patches sample the same or nearby ptex pages.
+            Far::PatchTableFactory::SortPatchesByFace(*_farPatchTable);
+        }
+
+        Far::StencilTable const * localPointStencils =
+            _farPatchTable->GetLocalPointStencilTable();
+        Far::StencilTable const * localPointVaryingStencils =
+            _farPatchTable->GetLocalPointVaryingStencilTable();
+
+        // the local points of the levels of detail follow those of the
+        // last level.
+        bool levelsOfDetail =
+            (bits.test(MeshLevelsOfDetail) || progressive) &&
+            !_refiner->IsUniform();
+        if (levelsOfDetail) {
+            initializeLevelsOfDetail(poptions,
+                                     bits.test(MeshSortPatchesByFace),
+                                     &localPointStencils,
+                                     &localPointVaryingStencils);
+        }
+
+        // if there's endcap stencils, merge it into regular stencils : with
+        // MeshLocalPointPass, the local points are not factorized into the
+        // control vertices but refined from the refined vertices, in a pass
+        // following the refined vertices within the same evaluation (their
+        // stencils are much smaller around extraordinary vertices of high
+        // valence)
+        bool factorizeLocalPoints = !bits.test(MeshLocalPointPass);
+        if (localPointStencils) {
             // append stencils
             if (Far::StencilTable const *vertexStencilsWithLocalPoints =
                 Far::StencilTableFactory::AppendLocalPointStencilTable(
                     *_refiner,
                     vertexStencils,
-                    _farPatchTable->GetLocalPointStencilTable())) {
-                delete vertexStencils;
+                    localPointStencils,
+                    factorizeLocalPoints,
+                    /*deleteBaseTable*/ true)) {
                 vertexStencils = vertexStencilsWithLocalPoints;
             }
             if (varyingStencils) {
@@ -545,12 +1294,17 @@ private:
                     Far::StencilTableFactory::AppendLocalPointStencilTable(
                         *_refiner,
                         varyingStencils,
-                        _farPatchTable->GetLocalPointVaryingStencilTable())) {
-                    delete varyingStencils;
+                        localPointVaryingStencils,
+                        factorizeLocalPoints,
+                        /*deleteBaseTable*/ true)) {
                     varyingStencils = varyingStencilsWithLocalPoints;
                 }
             }
         }
+        if (levelsOfDetail) {
+            delete localPointStencils;
+            delete localPointVaryingStencils;
+        }
 
         _maxValence = _farPatchTable->GetMaxValence();
         _patchTable = PatchTable::Create(_farPatchTable, _deviceContext);
@@ -559,6 +1313,16 @@ private:
         _numVertices = vertexStencils->GetNumControlVertices()
             + vertexStencils->GetNumStencils();
 
+        // index the stencils of each control vertex for partial refinements
+        // (all the stencils of double-buffered vertices are refined)
+        if (bits.test(MeshDirtyUpdate) && !bits.test(MeshAsyncRefine)) {
+            _vertexStencilIndex = new Far::StencilReverseIndex(*vertexStencils);
+            if (varyingStencils) {
+                _varyingStencilIndex =
+                    new Far::StencilReverseIndex(*varyingStencils);
+            }
+        }
+
         // convert to device stenciltable if necessary.
         _vertexStencilTable =
             convertToCompatibleStencilTable<StencilTable>(
@@ -572,13 +1336,69 @@ private:
         delete varyingStencils;
     }
 
+    static void permuteStencils(Far::StencilTable const ** stencils,
+                                std::vector<Far::Index> const & permutation) {
+        if (Far::StencilTable const * permuted =
+            Far::StencilTableFactory::PermuteStencils(*stencils, permutation)) {
+            delete *stencils;
+            *stencils = permuted;
+        }
+    }
+
+    // Creates the patch tables of the isolation levels from 1 to the last one
+    // (excluded), and returns the concatenation of the local point stencils
+    // of all levels (owned by the caller).
+    void initializeLevelsOfDetail(
+        Far::PatchTableFactory::Options const & poptions,
+        bool sortPatchesByFace,
+        Far::StencilTable const ** localPointStencils,
+        Far::StencilTable const ** localPointVaryingStencils) {
+
+        std::vector<Far::StencilTable const *> vertexTables, varyingTables;
+        vertexTables.push_back(*localPointStencils);
+        varyingTables.push_back(*localPointVaryingStencils);
+
+        Far::Index localPointOffset = _farPatchTable->GetNumLocalPoints();
+        _lodLocalPointOffsets.push_back(localPointOffset);
+        for (int level = 1; level < _refiner->GetMaxLevel(); ++level) {
+            Far::PatchTable * farPatchTable =
+                Far::PatchTableFactory::CreateLevelOfDetail(
+                    *_refiner, level, localPointOffset, poptions);
+            if (!farPatchTable) break;
+
+            if (sortPatchesByFace) {
+                Far::PatchTableFactory::SortPatchesByFace(*farPatchTable);
+            }
+            _farLodPatchTables.push_back(farPatchTable);
+            _lodPatchTables.push_back(
+                PatchTable::Create(farPatchTable, _deviceContext));
+
+            vertexTables.push_back(
+                farPatchTable->GetLocalPointStencilTable());
+            varyingTables.push_back(
+                farPatchTable->GetLocalPointVaryingStencilTable());
+            localPointOffset += farPatchTable->GetNumLocalPoints();
+            _lodLocalPointOffsets.push_back(localPointOffset);
+        }
+
+        *localPointStencils = Far::StencilTableFactory::Create(
+            (int)vertexTables.size(), &vertexTables[0]);
+        *localPointVaryingStencils = Far::StencilTableFactory::Create(
+            (int)varyingTables.size(), &varyingTables[0]);
+    }
+
     void initializeVertexBuffers(int numVertices,
                                  int numVertexElements,
-                                 int numVaryingElements) {
+                                 int numVaryingElements,
+                                 bool doubleBuffered) {
 
         if (numVertexElements) {
             _vertexBuffer = VertexBuffer::Create(numVertexElements,
                                                  numVertices, _deviceContext);
+            if (doubleBuffered) {
+                _backVertexBuffer = VertexBuffer::Create(
+                    numVertexElements, numVertices, _deviceContext);
+            }
         }
 
         if (numVaryingElements) {
@@ -594,16 +1414,66 @@ private:
     int _maxValence;
 
     VertexBuffer * _vertexBuffer;
+    VertexBuffer * _backVertexBuffer;  // refined by RefineAsync()
     VertexBuffer * _varyingBuffer;
 
     BufferDescriptor _vertexDesc;
     BufferDescriptor _varyingDesc;
 
+    struct PrimvarBuffer {
+        std::string name;
+        VertexBuffer * buffer;
+        BufferDescriptor desc;
+        bool varying;
+        std::vector<unsigned int> hashes;   // MeshHashControlVertices
+    };
+    std::vector<PrimvarBuffer> _primvarBuffers;
+
     StencilTable const * _vertexStencilTable;
     StencilTable const * _varyingStencilTable;
+
+    Far::StencilReverseIndex const * _vertexStencilIndex;
+    Far::StencilReverseIndex const * _varyingStencilIndex;
+    std::vector<Far::Index> _dirtyVertices;
+    std::vector<Far::Index> _vertexStencilRanges;
+    std::vector<Far::Index> _varyingStencilRanges;
+    bool _allVerticesDirty;
+
+    // change detection (MeshSkipUnchanged, MeshHashControlVertices) : hash
+    // of each control vertex of the buffers, and changed runs of an update
+    bool _skipUnchanged;
+    bool _hashControlVertices;
+    bool _updated;
+    std::vector<unsigned int> _vertexHashes;
+    std::vector<unsigned int> _varyingHashes;
+    std::vector<int> _changedRuns;
+
+    // asynchronous refinement of the back vertex buffer
+    MeshWorker * _worker;
+    Evaluator const * _asyncVertexInstance;
+    Evaluator const * _asyncVaryingInstance;
+    std::vector<int> _carriedVertexRanges;
+    std::vector<float> _carriedVertexData;
+    int _numFrames;
+    int _pendingFrame;
+    int _refinedFrame;
+
+    // levels refined selectively (MeshProgressiveLevels) : number of
+    // stencils of the levels up to each level, offsets of the local points
+    // of each level of detail, and ranges of stencils of the level refined
+    std::vector<Far::Index> _levelStencilCounts;
+    std::vector<Far::Index> _lodLocalPointOffsets;
+    std::vector<Far::Index> _refinedLevelRanges;
+    int _refinedLevel;
+
     EvaluatorCache * _evaluatorCache;
 
     PatchTable *_patchTable;
+
+    // patch tables of the isolation levels from 1 to the last one (excluded)
+    std::vector<Far::PatchTable *> _farLodPatchTables;
+    std::vector<PatchTable *> _lodPatchTables;
+
     DeviceContext *_deviceContext;
 };
 
@@ -0,0 +1,85 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_MTL_COMMON_H
+#define OPENSUBDIV3_OSD_MTL_COMMON_H
+
+#include "../version.h"
+
+#include <objc/objc.h>
+#include <cstddef>
+
+// The Metal classes of Osd are declared with Objective-C protocol types :
+// their headers must be included from Objective-C++ sources.
+@protocol MTLDevice;
+@protocol MTLCommandQueue;
+@protocol MTLCommandBuffer;
+@protocol MTLBuffer;
+@protocol MTLComputePipelineState;
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief Device context of the Metal classes
+///
+/// Evaluations are encoded into 'commandBuffer' when it is set, to be
+/// committed by the client along with its other work. Otherwise each
+/// evaluation is encoded into a command buffer of its own, created from
+/// 'commandQueue' and committed right away.
+///
+class MTLContext {
+public:
+    MTLContext() : device(nil), commandQueue(nil), commandBuffer(nil) { }
+
+    id<MTLDevice> device;
+    id<MTLCommandQueue> commandQueue;
+    id<MTLCommandBuffer> commandBuffer;
+};
+
+namespace internal {
+
+/// Creates a buffer accessible from the CPU (managed on macOS, shared on
+/// other platforms), initialized with 'data' if not NULL.
+/// Returns nil if error.
+id<MTLBuffer> MTLNewBuffer(MTLContext *context, void const *data,
+                           size_t size);
+
+/// Copies 'size' bytes of 'data' into 'buffer' at 'offset', and marks the
+/// range as modified for the GPU copy of managed buffers.
+void MTLUpdateBuffer(id<MTLBuffer> buffer, void const *data,
+                     size_t offset, size_t size);
+
+}  // end namespace internal
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_MTL_COMMON_H
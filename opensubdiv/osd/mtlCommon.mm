@@ -0,0 +1,88 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/mtlCommon.h"
+#include "../far/error.h"
+
+#import <Metal/Metal.h>
+#include <TargetConditionals.h>
+
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace internal {
+
+id<MTLBuffer>
+MTLNewBuffer(MTLContext *context, void const *data, size_t size) {
+
+    if (!context || !context->device) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "No Metal device");
+        return nil;
+    }
+
+#if TARGET_OS_OSX
+    MTLResourceOptions options = MTLResourceStorageModeManaged;
+#else
+    MTLResourceOptions options = MTLResourceStorageModeShared;
+#endif
+
+    // Metal buffers can't be empty
+    size_t length = size ? size : 4;
+
+    id<MTLBuffer> buffer = data
+        ? [context->device newBufferWithBytes:data
+                                       length:length options:options]
+        : [context->device newBufferWithLength:length options:options];
+
+    if (!buffer) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failed to allocate a Metal buffer of %lu bytes",
+                   (unsigned long)size);
+    }
+    return buffer;
+}
+
+void
+MTLUpdateBuffer(id<MTLBuffer> buffer, void const *data,
+                size_t offset, size_t size) {
+
+    if (size == 0) return;
+
+    memcpy((unsigned char *)[buffer contents] + offset, data, size);
+#if TARGET_OS_OSX
+    [buffer didModifyRange:NSMakeRange(offset, size)];
+#endif
+}
+
+}  // end namespace internal
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,581 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_MTL_COMPUTE_EVALUATOR_H
+#define OPENSUBDIV3_OSD_MTL_COMPUTE_EVALUATOR_H
+
+#include "../version.h"
+
+#include "../osd/mtlCommon.h"
+#include "../osd/nonCopyable.h"
+#include "../osd/types.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class PatchTable;
+    class StencilTable;
+    class LimitStencilTable;
+}
+
+namespace Osd {
+
+/// \brief Metal stencil table
+///
+/// This class is a Metal buffer representation of Far::StencilTable.
+///
+/// MTLComputeEvaluator consumes this table to apply stencils
+///
+class MTLStencilTable : private NonCopyable<MTLStencilTable> {
+public:
+    static MTLStencilTable *Create(Far::StencilTable const *stencilTable,
+                                   MTLContext *context) {
+        return new MTLStencilTable(stencilTable, context);
+    }
+    static MTLStencilTable *Create(
+        Far::LimitStencilTable const *limitStencilTable,
+        MTLContext *context) {
+        return new MTLStencilTable(limitStencilTable, context);
+    }
+
+    MTLStencilTable(Far::StencilTable const *stencilTable,
+                    MTLContext *context);
+    MTLStencilTable(Far::LimitStencilTable const *limitStencilTable,
+                    MTLContext *context);
+    ~MTLStencilTable();
+
+    // interfaces needed for MTLComputeEvaluator
+    id<MTLBuffer> GetSizesBuffer() const { return _sizes; }
+    id<MTLBuffer> GetOffsetsBuffer() const { return _offsets; }
+    id<MTLBuffer> GetIndicesBuffer() const { return _indices; }
+    id<MTLBuffer> GetWeightsBuffer() const { return _weights; }
+    id<MTLBuffer> GetDuWeightsBuffer() const { return _duWeights; }
+    id<MTLBuffer> GetDvWeightsBuffer() const { return _dvWeights; }
+    int GetNumStencils() const { return _numStencils; }
+
+private:
+    id<MTLBuffer> _sizes;
+    id<MTLBuffer> _offsets;
+    id<MTLBuffer> _indices;
+    id<MTLBuffer> _weights;
+    id<MTLBuffer> _duWeights;
+    id<MTLBuffer> _dvWeights;
+    int _numStencils;
+};
+
+// ---------------------------------------------------------------------------
+
+/// \brief Metal compute evaluator
+///
+/// MTLComputeEvaluator encodes the dispatches of the Metal compute kernels
+/// (see mtlComputeKernel.metal, compiled at run time for the primvar layout
+/// of the evaluator) into the command buffer of the MTLContext, or into a
+/// command buffer of its own committed right away (see MTLContext).
+///
+/// Command buffers retain the resources they use : an evaluator instantiated
+/// on demand by the static Eval functions can be released before the
+/// commands it encoded have completed.
+///
+class MTLComputeEvaluator : private NonCopyable<MTLComputeEvaluator> {
+public:
+    typedef bool Instantiatable;
+
+    /// Creator. Returns NULL if error.
+    static MTLComputeEvaluator *Create(BufferDescriptor const &srcDesc,
+                                       BufferDescriptor const &dstDesc,
+                                       BufferDescriptor const &duDesc,
+                                       BufferDescriptor const &dvDesc,
+                                       MTLContext *context) {
+        MTLComputeEvaluator *instance = new MTLComputeEvaluator();
+        if (instance->Compile(srcDesc, dstDesc, duDesc, dvDesc, context))
+            return instance;
+        delete instance;
+        return NULL;
+    }
+
+    /// Destructor.
+    ~MTLComputeEvaluator();
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with StencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static compute function. This function has a same
+    ///        signature as other device kernels have so that it can be called
+    ///        transparently from OsdMesh template interface.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindMTLBuffer() method returning the
+    ///                       Metal buffer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindMTLBuffer() method returning the
+    ///                       Metal buffer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   MTLStencilTable or equivalent
+    ///
+    /// @param instance       cached compiled instance. Clients are supposed to
+    ///                       pre-compile an instance of this class and provide
+    ///                       to this function. If it's null the kernel still
+    ///                       compute by instantiating on-demand kernel although
+    ///                       it may cause a performance problem.
+    ///
+    /// @param context        the MTLContext the commands are encoded with
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        MTLComputeEvaluator const *instance,
+        MTLContext *context) {
+
+        if (instance) {
+            return instance->EvalStencils(srcBuffer, srcDesc,
+                                          dstBuffer, dstDesc,
+                                          stencilTable, context);
+        } else {
+            // Create a kernel on demand (slow)
+            instance = Create(srcDesc, dstDesc,
+                              BufferDescriptor(),
+                              BufferDescriptor(), context);
+            if (instance) {
+                bool r = instance->EvalStencils(srcBuffer, srcDesc,
+                                                dstBuffer, dstDesc,
+                                                stencilTable, context);
+                delete instance;
+                return r;
+            }
+            return false;
+        }
+    }
+
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        MTLComputeEvaluator const *instance,
+        MTLContext *context) {
+
+        if (end <= start) return true;
+
+        // Create a kernel on demand (slow)
+        MTLComputeEvaluator const *kernel = instance ? instance :
+            Create(srcDesc, dstDesc, BufferDescriptor(), BufferDescriptor(),
+                   context);
+        if (!kernel) return false;
+
+        bool r = kernel->EvalStencils(srcBuffer->BindMTLBuffer(context), srcDesc,
+                                      dstBuffer->BindMTLBuffer(context), dstDesc,
+                                      nil, BufferDescriptor(),
+                                      nil, BufferDescriptor(),
+                                      stencilTable->GetSizesBuffer(),
+                                      stencilTable->GetOffsetsBuffer(),
+                                      stencilTable->GetIndicesBuffer(),
+                                      stencilTable->GetWeightsBuffer(),
+                                      nil,
+                                      nil,
+                                      start, end,
+                                      context);
+        if (kernel != instance) delete kernel;
+        return r;
+    }
+
+    /// \brief Generic static compute function with derivatives (see above)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        MTLComputeEvaluator const *instance,
+        MTLContext *context) {
+
+        if (instance) {
+            return instance->EvalStencils(srcBuffer, srcDesc,
+                                          dstBuffer, dstDesc,
+                                          duBuffer,  duDesc,
+                                          dvBuffer,  dvDesc,
+                                          stencilTable, context);
+        } else {
+            // Create a kernel on demand (slow)
+            instance = Create(srcDesc, dstDesc, duDesc, dvDesc, context);
+            if (instance) {
+                bool r = instance->EvalStencils(srcBuffer, srcDesc,
+                                                dstBuffer, dstDesc,
+                                                duBuffer,  duDesc,
+                                                dvBuffer,  dvDesc,
+                                                stencilTable, context);
+                delete instance;
+                return r;
+            }
+            return false;
+        }
+    }
+
+    /// Encodes the dispatch of the stencil kernel.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        MTLContext *context) const {
+        return EvalStencils(srcBuffer->BindMTLBuffer(context), srcDesc,
+                            dstBuffer->BindMTLBuffer(context), dstDesc,
+                            nil, BufferDescriptor(),
+                            nil, BufferDescriptor(),
+                            stencilTable->GetSizesBuffer(),
+                            stencilTable->GetOffsetsBuffer(),
+                            stencilTable->GetIndicesBuffer(),
+                            stencilTable->GetWeightsBuffer(),
+                            nil,
+                            nil,
+                            /* start = */ 0,
+                            /* end   = */ stencilTable->GetNumStencils(),
+                            context);
+    }
+
+    /// Encodes the dispatch of the stencil kernel with derivatives.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        MTLContext *context) const {
+        return EvalStencils(srcBuffer->BindMTLBuffer(context), srcDesc,
+                            dstBuffer->BindMTLBuffer(context), dstDesc,
+                            duBuffer->BindMTLBuffer(context),  duDesc,
+                            dvBuffer->BindMTLBuffer(context),  dvDesc,
+                            stencilTable->GetSizesBuffer(),
+                            stencilTable->GetOffsetsBuffer(),
+                            stencilTable->GetIndicesBuffer(),
+                            stencilTable->GetWeightsBuffer(),
+                            stencilTable->GetDuWeightsBuffer(),
+                            stencilTable->GetDvWeightsBuffer(),
+                            /* start = */ 0,
+                            /* end   = */ stencilTable->GetNumStencils(),
+                            context);
+    }
+
+    /// Encodes the dispatch of the stencil kernel on Metal buffers.
+    /// returns false if the kernel hasn't been compiled yet.
+    bool EvalStencils(id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+                      id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+                      id<MTLBuffer> duBuffer,  BufferDescriptor const &duDesc,
+                      id<MTLBuffer> dvBuffer,  BufferDescriptor const &dvDesc,
+                      id<MTLBuffer> sizesBuffer,
+                      id<MTLBuffer> offsetsBuffer,
+                      id<MTLBuffer> indicesBuffer,
+                      id<MTLBuffer> weightsBuffer,
+                      id<MTLBuffer> duWeightsBuffer,
+                      id<MTLBuffer> dvWeightsBuffer,
+                      int start,
+                      int end,
+                      MTLContext *context) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Limit evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic limit eval function. This function has a same
+    ///        signature as other device kernels have so that it can be called
+    ///        in the same way.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindMTLBuffer() method returning the
+    ///                       Metal buffer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindMTLBuffer() method returning the
+    ///                       Metal buffer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords number of patchCoords.
+    ///
+    /// @param patchCoords    array of locations to be evaluated.
+    ///                       must have BindMTLBuffer() method returning an
+    ///                       array of PatchCoord struct in a Metal buffer.
+    ///
+    /// @param patchTable     MTLPatchTable or equivalent
+    ///
+    /// @param instance       cached compiled instance (see EvalStencils)
+    ///
+    /// @param context        the MTLContext the commands are encoded with
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        MTLComputeEvaluator const *instance,
+        MTLContext *context) {
+
+        if (instance) {
+            return instance->EvalPatches(srcBuffer, srcDesc,
+                                         dstBuffer, dstDesc,
+                                         numPatchCoords, patchCoords,
+                                         patchTable, context);
+        } else {
+            // Create a kernel on demand (slow)
+            instance = Create(srcDesc, dstDesc,
+                              BufferDescriptor(),
+                              BufferDescriptor(), context);
+            if (instance) {
+                bool r = instance->EvalPatches(srcBuffer, srcDesc,
+                                               dstBuffer, dstDesc,
+                                               numPatchCoords, patchCoords,
+                                               patchTable, context);
+                delete instance;
+                return r;
+            }
+            return false;
+        }
+    }
+
+    /// \brief Generic limit eval function with derivatives (see above)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        MTLComputeEvaluator const *instance,
+        MTLContext *context) {
+
+        if (instance) {
+            return instance->EvalPatches(srcBuffer, srcDesc,
+                                         dstBuffer, dstDesc,
+                                         duBuffer, duDesc,
+                                         dvBuffer, dvDesc,
+                                         numPatchCoords, patchCoords,
+                                         patchTable, context);
+        } else {
+            // Create a kernel on demand (slow)
+            instance = Create(srcDesc, dstDesc, duDesc, dvDesc, context);
+            if (instance) {
+                bool r = instance->EvalPatches(srcBuffer, srcDesc,
+                                               dstBuffer, dstDesc,
+                                               duBuffer, duDesc,
+                                               dvBuffer, dvDesc,
+                                               numPatchCoords, patchCoords,
+                                               patchTable, context);
+                delete instance;
+                return r;
+            }
+            return false;
+        }
+    }
+
+    /// Encodes the dispatch of the patch kernel.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        MTLContext *context) const {
+
+        return EvalPatches(srcBuffer->BindMTLBuffer(context), srcDesc,
+                           dstBuffer->BindMTLBuffer(context), dstDesc,
+                           nil, BufferDescriptor(),
+                           nil, BufferDescriptor(),
+                           numPatchCoords,
+                           patchCoords->BindMTLBuffer(context),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer(),
+                           context);
+    }
+
+    /// Encodes the dispatch of the patch kernel with derivatives.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        MTLContext *context) const {
+
+        return EvalPatches(srcBuffer->BindMTLBuffer(context), srcDesc,
+                           dstBuffer->BindMTLBuffer(context), dstDesc,
+                           duBuffer->BindMTLBuffer(context),  duDesc,
+                           dvBuffer->BindMTLBuffer(context),  dvDesc,
+                           numPatchCoords,
+                           patchCoords->BindMTLBuffer(context),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer(),
+                           context);
+    }
+
+    /// Encodes the dispatch of the patch kernel on Metal buffers.
+    /// returns false if the kernel hasn't been compiled yet.
+    bool EvalPatches(id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+                     id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+                     id<MTLBuffer> duBuffer, BufferDescriptor const &duDesc,
+                     id<MTLBuffer> dvBuffer, BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     id<MTLBuffer> patchCoordsBuffer,
+                     const PatchArrayVector &patchArrays,
+                     id<MTLBuffer> patchIndexBuffer,
+                     id<MTLBuffer> patchParamsBuffer,
+                     MTLContext *context) const;
+
+    /// \brief Generic face-varying limit eval function : the PatchCoords of
+    ///        the vertex patches are mapped to the patches of the channel by
+    ///        the kernel (see GLComputeEvaluator::EvalPatchesFaceVarying)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel,
+        MTLContext *context) const {
+
+        return EvalPatchesFaceVarying(srcBuffer->BindMTLBuffer(context), srcDesc,
+                           dstBuffer->BindMTLBuffer(context), dstDesc,
+                           nil, BufferDescriptor(),
+                           nil, BufferDescriptor(),
+                           numPatchCoords,
+                           patchCoords->BindMTLBuffer(context),
+                           patchTable->GetFVarPatchArrays(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel),
+                           context);
+    }
+
+    /// \brief Face-varying limit eval function on Metal buffers
+    bool EvalPatchesFaceVarying(id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+                                id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+                                id<MTLBuffer> duBuffer, BufferDescriptor const &duDesc,
+                                id<MTLBuffer> dvBuffer, BufferDescriptor const &dvDesc,
+                                int numPatchCoords,
+                                id<MTLBuffer> patchCoordsBuffer,
+                                const PatchArrayVector &fvarPatchArrays,
+                                id<MTLBuffer> fvarPatchIndexBuffer,
+                                id<MTLBuffer> fvarPatchParamsBuffer,
+                                MTLContext *context) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Other methods
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// Compiles the kernels for the primvar layout. Returns false if it
+    /// fails to compile them.
+    bool Compile(BufferDescriptor const &srcDesc,
+                 BufferDescriptor const &dstDesc,
+                 BufferDescriptor const &duDesc,
+                 BufferDescriptor const &dvDesc,
+                 MTLContext *context);
+
+    /// Wait the command buffers committed to the command queue of the
+    /// context complete.
+    static void Synchronize(MTLContext *context);
+
+private:
+    MTLComputeEvaluator();
+
+    bool evalPatches(id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+                     id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+                     id<MTLBuffer> duBuffer, BufferDescriptor const &duDesc,
+                     id<MTLBuffer> dvBuffer, BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     id<MTLBuffer> patchCoordsBuffer,
+                     const PatchArrayVector &patchArrays,
+                     id<MTLBuffer> patchIndexBuffer,
+                     id<MTLBuffer> patchParamsBuffer,
+                     bool faceVarying,
+                     MTLContext *context) const;
+
+    // encodes the dispatch of 'count' threads of 'kernel' (offset by the
+    // batchStart of the uniforms) with 'buffers' bound at the first indices
+    // and the uniforms bound last
+    void dispatch(MTLContext *context, id<MTLComputePipelineState> kernel,
+                  int numBuffers, id<MTLBuffer> const *buffers,
+                  void const *uniforms, size_t uniformsSize,
+                  int count) const;
+
+    id<MTLComputePipelineState> _stencilKernel;
+    id<MTLComputePipelineState> _patchKernel;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_MTL_COMPUTE_EVALUATOR_H
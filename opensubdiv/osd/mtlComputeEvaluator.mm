@@ -0,0 +1,364 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/mtlComputeEvaluator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "../far/error.h"
+#include "../far/stencilTable.h"
+#include "../far/profile.h"
+
+#import <Metal/Metal.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const char *shaderSource =
+#include "../osd/mtlComputeKernel.gen.h"
+;
+
+// Layout of the KernelUniforms of mtlComputeKernel.metal
+struct KernelUniforms {
+    int srcOffset;
+    int dstOffset;
+    int batchStart;
+    int batchEnd;
+    int duDesc[4];
+    int dvDesc[4];
+    int patchArray[8];
+    int faceVarying;
+    int pad[3];
+};
+
+// Index of the uniforms in the argument table of the kernels
+static const int UNIFORMS_INDEX = 10;
+
+template <class T> static id<MTLBuffer>
+createBuffer(std::vector<T> const & src, MTLContext *context) {
+    return internal::MTLNewBuffer(context, src.empty() ? NULL : &src[0],
+                                  src.size() * sizeof(T));
+}
+
+MTLStencilTable::MTLStencilTable(Far::StencilTable const *stencilTable,
+                                 MTLContext *context)
+    : _sizes(nil), _offsets(nil), _indices(nil), _weights(nil),
+      _duWeights(nil), _dvWeights(nil) {
+    _numStencils = stencilTable->GetNumStencils();
+    if (_numStencils > 0) {
+        _sizes   = createBuffer(stencilTable->GetSizes(), context);
+        _offsets = createBuffer(stencilTable->GetOffsets(), context);
+        _indices = createBuffer(stencilTable->GetControlIndices(), context);
+        _weights = createBuffer(stencilTable->GetWeights(), context);
+    }
+}
+
+MTLStencilTable::MTLStencilTable(
+    Far::LimitStencilTable const *limitStencilTable, MTLContext *context)
+    : _sizes(nil), _offsets(nil), _indices(nil), _weights(nil),
+      _duWeights(nil), _dvWeights(nil) {
+    _numStencils = limitStencilTable->GetNumStencils();
+    if (_numStencils > 0) {
+        _sizes     = createBuffer(limitStencilTable->GetSizes(), context);
+        _offsets   = createBuffer(limitStencilTable->GetOffsets(), context);
+        _indices   = createBuffer(limitStencilTable->GetControlIndices(),
+                                  context);
+        _weights   = createBuffer(limitStencilTable->GetWeights(), context);
+        _duWeights = createBuffer(limitStencilTable->GetDuWeights(), context);
+        _dvWeights = createBuffer(limitStencilTable->GetDvWeights(), context);
+    }
+}
+
+MTLStencilTable::~MTLStencilTable() {
+}
+
+// ---------------------------------------------------------------------------
+
+MTLComputeEvaluator::MTLComputeEvaluator() :
+    _stencilKernel(nil), _patchKernel(nil) {
+}
+
+MTLComputeEvaluator::~MTLComputeEvaluator() {
+}
+
+static id<MTLComputePipelineState>
+compileKernel(id<MTLLibrary> library, NSString *name, id<MTLDevice> device) {
+
+    id<MTLFunction> function = [library newFunctionWithName:name];
+    if (!function) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Metal kernel %s not found", [name UTF8String]);
+        return nil;
+    }
+
+    NSError *error = nil;
+    id<MTLComputePipelineState> kernel =
+        [device newComputePipelineStateWithFunction:function error:&error];
+    if (!kernel) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failed to create Metal compute pipeline : %s",
+                   [[error localizedDescription] UTF8String]);
+    }
+    return kernel;
+}
+
+bool
+MTLComputeEvaluator::Compile(BufferDescriptor const &srcDesc,
+                             BufferDescriptor const &dstDesc,
+                             BufferDescriptor const &duDesc,
+                             BufferDescriptor const &dvDesc,
+                             MTLContext *context) {
+
+    if (!context || !context->device) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "No Metal device");
+        return false;
+    }
+
+    _stencilKernel = nil;
+    _patchKernel = nil;
+
+    bool derivatives = (duDesc.length > 0 || dvDesc.length > 0);
+
+    NSMutableDictionary *macros = [NSMutableDictionary dictionary];
+    macros[@"LENGTH"] = @(srcDesc.length);
+    macros[@"SRC_STRIDE"] = @(srcDesc.stride);
+    macros[@"DST_STRIDE"] = @(dstDesc.stride);
+    if (derivatives) {
+        macros[@"OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES"] = @1;
+    }
+
+    MTLCompileOptions *options = [[MTLCompileOptions alloc] init];
+    options.preprocessorMacros = macros;
+
+    NSError *error = nil;
+    id<MTLLibrary> library =
+        [context->device newLibraryWithSource:@(shaderSource)
+                                      options:options
+                                        error:&error];
+    if (!library) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failed to compile Metal kernels : %s",
+                   [[error localizedDescription] UTF8String]);
+        return false;
+    }
+
+    _stencilKernel = compileKernel(library, @"eval_stencils", context->device);
+    _patchKernel = compileKernel(library, @"eval_patches", context->device);
+
+    return (_stencilKernel != nil && _patchKernel != nil);
+}
+
+/* static */
+void
+MTLComputeEvaluator::Synchronize(MTLContext *context) {
+
+    // command buffers of a queue complete in order
+    id<MTLCommandBuffer> commandBuffer = [context->commandQueue commandBuffer];
+    [commandBuffer commit];
+    [commandBuffer waitUntilCompleted];
+}
+
+void
+MTLComputeEvaluator::dispatch(MTLContext *context,
+                              id<MTLComputePipelineState> kernel,
+                              int numBuffers, id<MTLBuffer> const *buffers,
+                              void const *uniforms, size_t uniformsSize,
+                              int count) const {
+
+    id<MTLCommandBuffer> commandBuffer = context->commandBuffer;
+    bool commit = false;
+    if (!commandBuffer) {
+        commandBuffer = [context->commandQueue commandBuffer];
+        commit = true;
+    }
+
+    // the encoders of a command buffer are ordered by the hazard tracking of
+    // the buffers : the results are visible to the following passes
+    id<MTLComputeCommandEncoder> encoder =
+        [commandBuffer computeCommandEncoder];
+
+    [encoder setComputePipelineState:kernel];
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i]) {
+            [encoder setBuffer:buffers[i] offset:0 atIndex:i];
+        }
+    }
+    [encoder setBytes:uniforms length:uniformsSize atIndex:UNIFORMS_INDEX];
+
+    NSUInteger threads = [kernel threadExecutionWidth];
+    NSUInteger groups = (count + threads - 1) / threads;
+    [encoder dispatchThreadgroups:MTLSizeMake(groups, 1, 1)
+            threadsPerThreadgroup:MTLSizeMake(threads, 1, 1)];
+    [encoder endEncoding];
+
+    if (commit) {
+        [commandBuffer commit];
+    }
+}
+
+bool
+MTLComputeEvaluator::EvalStencils(
+    id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+    id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+    id<MTLBuffer> duBuffer,  BufferDescriptor const &duDesc,
+    id<MTLBuffer> dvBuffer,  BufferDescriptor const &dvDesc,
+    id<MTLBuffer> sizesBuffer,
+    id<MTLBuffer> offsetsBuffer,
+    id<MTLBuffer> indicesBuffer,
+    id<MTLBuffer> weightsBuffer,
+    id<MTLBuffer> duWeightsBuffer,
+    id<MTLBuffer> dvWeightsBuffer,
+    int start, int end,
+    MTLContext *context) const {
+
+    OPENSUBDIV_PROFILE_ZONE("MTLComputeEvaluator::EvalStencils");
+
+    if (!_stencilKernel) return false;
+    int count = end - start;
+    if (count <= 0) {
+        return true;
+    }
+
+    id<MTLBuffer> buffers[10] = {
+        srcBuffer, dstBuffer, duBuffer, dvBuffer,
+        sizesBuffer, offsetsBuffer, indicesBuffer, weightsBuffer,
+        duWeightsBuffer, dvWeightsBuffer };
+
+    KernelUniforms uniforms;
+    memset(&uniforms, 0, sizeof(uniforms));
+    uniforms.srcOffset = srcDesc.offset;
+    uniforms.dstOffset = dstDesc.offset;
+    uniforms.batchStart = start;
+    uniforms.batchEnd = end;
+    uniforms.duDesc[0] = duDesc.offset;
+    uniforms.duDesc[1] = duDesc.length;
+    uniforms.duDesc[2] = duDesc.stride;
+    uniforms.dvDesc[0] = dvDesc.offset;
+    uniforms.dvDesc[1] = dvDesc.length;
+    uniforms.dvDesc[2] = dvDesc.stride;
+
+    dispatch(context, _stencilKernel, 10, buffers,
+             &uniforms, sizeof(uniforms), count);
+
+    return true;
+}
+
+bool
+MTLComputeEvaluator::EvalPatches(
+    id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+    id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+    id<MTLBuffer> duBuffer,  BufferDescriptor const &duDesc,
+    id<MTLBuffer> dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    id<MTLBuffer> patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    id<MTLBuffer> patchIndexBuffer,
+    id<MTLBuffer> patchParamsBuffer,
+    MTLContext *context) const {
+
+    OPENSUBDIV_PROFILE_ZONE("MTLComputeEvaluator::EvalPatches");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrays, patchIndexBuffer, patchParamsBuffer,
+                       false, context);
+}
+
+bool
+MTLComputeEvaluator::EvalPatchesFaceVarying(
+    id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+    id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+    id<MTLBuffer> duBuffer,  BufferDescriptor const &duDesc,
+    id<MTLBuffer> dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    id<MTLBuffer> patchCoordsBuffer,
+    const PatchArrayVector &fvarPatchArrays,
+    id<MTLBuffer> fvarPatchIndexBuffer,
+    id<MTLBuffer> fvarPatchParamsBuffer,
+    MTLContext *context) const {
+
+    OPENSUBDIV_PROFILE_ZONE("MTLComputeEvaluator::EvalPatchesFaceVarying");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamsBuffer, true, context);
+}
+
+bool
+MTLComputeEvaluator::evalPatches(
+    id<MTLBuffer> srcBuffer, BufferDescriptor const &srcDesc,
+    id<MTLBuffer> dstBuffer, BufferDescriptor const &dstDesc,
+    id<MTLBuffer> duBuffer,  BufferDescriptor const &duDesc,
+    id<MTLBuffer> dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    id<MTLBuffer> patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    id<MTLBuffer> patchIndexBuffer,
+    id<MTLBuffer> patchParamsBuffer,
+    bool faceVarying,
+    MTLContext *context) const {
+
+    if (!_patchKernel) return false;
+    if (numPatchCoords <= 0 || patchArrays.empty()) {
+        return true;
+    }
+
+    id<MTLBuffer> buffers[7] = {
+        srcBuffer, dstBuffer, duBuffer, dvBuffer,
+        patchCoordsBuffer, patchIndexBuffer, patchParamsBuffer };
+
+    KernelUniforms uniforms;
+    memset(&uniforms, 0, sizeof(uniforms));
+    memcpy(uniforms.patchArray, &patchArrays[0],
+           std::min(patchArrays.size(), (size_t)2) * sizeof(PatchArray));
+    uniforms.srcOffset = srcDesc.offset;
+    uniforms.dstOffset = dstDesc.offset;
+    uniforms.batchStart = 0;
+    uniforms.batchEnd = numPatchCoords;
+    uniforms.duDesc[0] = duDesc.offset;
+    uniforms.duDesc[1] = duDesc.length;
+    uniforms.duDesc[2] = duDesc.stride;
+    uniforms.dvDesc[0] = dvDesc.offset;
+    uniforms.dvDesc[1] = dvDesc.length;
+    uniforms.dvDesc[2] = dvDesc.stride;
+    uniforms.faceVarying = faceVarying ? 1 : 0;
+
+    dispatch(context, _patchKernel, 7, buffers,
+             &uniforms, sizeof(uniforms), numPatchCoords);
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,338 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+//------------------------------------------------------------------------------
+
+// Metal compute kernels, compiled at run time by MTLComputeEvaluator with
+// LENGTH, SRC_STRIDE and DST_STRIDE defined (and optionally
+// OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES) : see glslComputeKernel.glsl.
+
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct KernelUniforms {
+    int srcOffset;
+    int dstOffset;
+    int batchStart;
+    int batchEnd;
+    int4 duDesc;        // offset, length, stride
+    int4 dvDesc;
+    int4 patchArray[2];
+    int faceVarying;
+};
+
+struct PatchCoord {
+    int arrayIndex;
+    int patchIndex;
+    int vertIndex;
+    float s;
+    float t;
+};
+
+struct PatchParam {
+    uint field0;
+    uint field1;
+    float sharpness;
+};
+
+//------------------------------------------------------------------------------
+
+struct Vertex {
+    float vertexData[LENGTH];
+};
+
+void clear(thread Vertex &v) {
+    for (int i = 0; i < LENGTH; ++i) {
+        v.vertexData[i] = 0;
+    }
+}
+
+Vertex readVertex(int index, device const float *srcVertexBuffer,
+                  constant KernelUniforms &uniforms) {
+    Vertex v;
+    int vertexIndex = uniforms.srcOffset + index * SRC_STRIDE;
+    for (int i = 0; i < LENGTH; ++i) {
+        v.vertexData[i] = srcVertexBuffer[vertexIndex + i];
+    }
+    return v;
+}
+
+void writeVertex(int index, Vertex v, device float *dstVertexBuffer,
+                 constant KernelUniforms &uniforms) {
+    int vertexIndex = uniforms.dstOffset + index * DST_STRIDE;
+    for (int i = 0; i < LENGTH; ++i) {
+        dstVertexBuffer[vertexIndex + i] = v.vertexData[i];
+    }
+}
+
+void writeDerivative(int index, Vertex v, device float *buffer, int4 desc) {
+    int vertexIndex = desc.x + index * desc.z;
+    for (int i = 0; i < LENGTH; ++i) {
+        buffer[vertexIndex + i] = v.vertexData[i];
+    }
+}
+
+void addWithWeight(thread Vertex &v, Vertex src, float weight) {
+    for (int i = 0; i < LENGTH; ++i) {
+        v.vertexData[i] += weight * src.vertexData[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+
+kernel void eval_stencils(
+    uint thread_position_in_grid [[thread_position_in_grid]],
+    device const float *srcVertexBuffer [[buffer(0)]],
+    device float *dstVertexBuffer [[buffer(1)]],
+#if defined(OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES)
+    device float *duBuffer [[buffer(2)]],
+    device float *dvBuffer [[buffer(3)]],
+#endif
+    device const int *sizes [[buffer(4)]],
+    device const int *offsets [[buffer(5)]],
+    device const int *indices [[buffer(6)]],
+    device const float *weights [[buffer(7)]],
+#if defined(OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES)
+    device const float *duWeights [[buffer(8)]],
+    device const float *dvWeights [[buffer(9)]],
+#endif
+    constant KernelUniforms &uniforms [[buffer(10)]]) {
+
+    int current = int(thread_position_in_grid) + uniforms.batchStart;
+
+    if (current >= uniforms.batchEnd) {
+        return;
+    }
+
+    Vertex dst;
+    clear(dst);
+
+    int offset = offsets[current],
+        size   = sizes[current];
+
+    for (int stencil = 0; stencil < size; ++stencil) {
+        int vindex = offset + stencil;
+        addWithWeight(dst,
+            readVertex(indices[vindex], srcVertexBuffer, uniforms),
+            weights[vindex]);
+    }
+
+    writeVertex(current, dst, dstVertexBuffer, uniforms);
+
+#if defined(OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES)
+    Vertex du, dv;
+    clear(du);
+    clear(dv);
+    for (int i = 0; i < size; ++i) {
+        Vertex src = readVertex(indices[offset+i], srcVertexBuffer, uniforms);
+        addWithWeight(du, src, duWeights[offset+i]);
+        addWithWeight(dv, src, dvWeights[offset+i]);
+    }
+
+    if (uniforms.duDesc.y > 0) { // length
+        writeDerivative(current, du, duBuffer, uniforms.duDesc);
+    }
+    if (uniforms.dvDesc.y > 0) {
+        writeDerivative(current, dv, dvBuffer, uniforms.dvDesc);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+void getBSplineWeights(float t, thread float4 &point, thread float4 &deriv) {
+    // The four uniform cubic B-Spline basis functions evaluated at t:
+    float one6th = 1.0f / 6.0f;
+
+    float t2 = t * t;
+    float t3 = t * t2;
+
+    point.x = one6th * (1.0f - 3.0f*(t -      t2) -      t3);
+    point.y = one6th * (4.0f           - 6.0f*t2  + 3.0f*t3);
+    point.z = one6th * (1.0f + 3.0f*(t +      t2  -      t3));
+    point.w = one6th * (                                 t3);
+
+    // Derivatives of the above four basis functions at t:
+    deriv.x = -0.5f*t2 +      t - 0.5f;
+    deriv.y =  1.5f*t2 - 2.0f*t;
+    deriv.z = -1.5f*t2 +      t + 0.5f;
+    deriv.w =  0.5f*t2;
+}
+
+uint getDepth(uint patchBits) {
+    return (patchBits & 0xf);
+}
+
+float getParamFraction(uint patchBits) {
+    uint nonQuadRoot = (patchBits >> 4) & 0x1;
+    uint depth = getDepth(patchBits);
+    if (nonQuadRoot == 1) {
+        return 1.0f / float( 1 << (depth-1) );
+    } else {
+        return 1.0f / float( 1 << depth );
+    }
+}
+
+float2 normalizePatchCoord(uint patchBits, float2 uv) {
+    float frac = getParamFraction(patchBits);
+
+    uint iu = (patchBits >> 22) & 0x3ff;
+    uint iv = (patchBits >> 12) & 0x3ff;
+
+    // top left corner
+    float pu = float(iu)*frac;
+    float pv = float(iv)*frac;
+
+    // normalize u,v coordinates
+    return float2((uv.x - pu) / frac, (uv.y - pv) / frac);
+}
+
+void adjustBoundaryWeights(uint bits, thread float4 &sWeights,
+                           thread float4 &tWeights) {
+    uint boundary = ((bits >> 8) & 0xf);
+
+    if ((boundary & 1) != 0) {
+        tWeights[2] -= tWeights[0];
+        tWeights[1] += 2*tWeights[0];
+        tWeights[0] = 0;
+    }
+    if ((boundary & 2) != 0) {
+        sWeights[1] -= sWeights[3];
+        sWeights[2] += 2*sWeights[3];
+        sWeights[3] = 0;
+    }
+    if ((boundary & 4) != 0) {
+        tWeights[1] -= tWeights[3];
+        tWeights[2] += 2*tWeights[3];
+        tWeights[3] = 0;
+    }
+    if ((boundary & 8) != 0) {
+        sWeights[2] -= sWeights[0];
+        sWeights[1] += 2*sWeights[0];
+        sWeights[0] = 0;
+    }
+}
+
+kernel void eval_patches(
+    uint thread_position_in_grid [[thread_position_in_grid]],
+    device const float *srcVertexBuffer [[buffer(0)]],
+    device float *dstVertexBuffer [[buffer(1)]],
+#if defined(OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES)
+    device float *duBuffer [[buffer(2)]],
+    device float *dvBuffer [[buffer(3)]],
+#endif
+    device const PatchCoord *patchCoords [[buffer(4)]],
+    device const int *patchIndexBuffer [[buffer(5)]],
+    device const PatchParam *patchParamBuffer [[buffer(6)]],
+    constant KernelUniforms &uniforms [[buffer(10)]]) {
+
+    int current = int(thread_position_in_grid) + uniforms.batchStart;
+
+    if (current >= uniforms.batchEnd) {
+        return;
+    }
+
+    PatchCoord coord = patchCoords[current];
+    int patchIndex = coord.patchIndex;
+
+    if (uniforms.faceVarying != 0 && patchIndex >= 0) {
+        // map the vertex patch coord to the patches of the face-varying
+        // channel (see CpuGetFVarPatchCoords) : the patches of bicubic
+        // channels which are not regular use the second, bilinear array
+        bool bicubic = (uniforms.patchArray[0].x == 6);
+        uint bits = patchParamBuffer[patchIndex].field1;
+        coord.arrayIndex = (bicubic && ((bits >> 5) & 0x1) == 0) ? 1 : 0;
+        coord.vertIndex = patchIndex * (bicubic ? 16 : 4);
+    }
+
+    int4 array = uniforms.patchArray[coord.arrayIndex];
+    // XXX: REGULAR only for now, besides bilinear face-varying patches.
+    int patchType = (array.x == 3) ? 3 : 6;
+    int numControlVertices = (patchType == 3) ? 4 : 16;
+
+    uint patchBits = patchParamBuffer[patchIndex].field1;
+    float2 uv = normalizePatchCoord(patchBits, float2(coord.s, coord.t));
+    float dScale = float(1 << getDepth(patchBits));
+
+    float wP[16], wDs[16], wDt[16];
+    if (patchType == 6) {  // REGULAR
+        float4 sWeights, tWeights, dsWeights, dtWeights;
+        getBSplineWeights(uv.x, sWeights, dsWeights);
+        getBSplineWeights(uv.y, tWeights, dtWeights);
+
+        adjustBoundaryWeights(patchBits, sWeights, tWeights);
+        adjustBoundaryWeights(patchBits, dsWeights, dtWeights);
+
+        for (int k = 0; k < 4; ++k) {
+            for (int l = 0; l < 4; ++l) {
+                wP[4*k+l]  = sWeights[l]  * tWeights[k];
+                wDs[4*k+l] = dsWeights[l] * tWeights[k]  * dScale;
+                wDt[4*k+l] = sWeights[l]  * dtWeights[k] * dScale;
+            }
+        }
+    } else {  // QUADS
+        float sC = 1.0f - uv.x, tC = 1.0f - uv.y;
+
+        wP[0] = sC * tC;
+        wP[1] = uv.x * tC;
+        wP[2] = uv.x * uv.y;
+        wP[3] = sC * uv.y;
+
+        wDs[0] = -tC * dScale;
+        wDs[1] =  tC * dScale;
+        wDs[2] =  uv.y * dScale;
+        wDs[3] = -uv.y * dScale;
+
+        wDt[0] = -sC * dScale;
+        wDt[1] = -uv.x * dScale;
+        wDt[2] =  uv.x * dScale;
+        wDt[3] =  sC * dScale;
+    }
+
+    Vertex dst, du, dv;
+    clear(dst);
+    clear(du);
+    clear(dv);
+
+    int indexBase = array.z + coord.vertIndex;
+    for (int cv = 0; cv < numControlVertices; ++cv) {
+        int index = patchIndexBuffer[indexBase + cv];
+        Vertex src = readVertex(index, srcVertexBuffer, uniforms);
+        addWithWeight(dst, src, wP[cv]);
+        addWithWeight(du, src, wDs[cv]);
+        addWithWeight(dv, src, wDt[cv]);
+    }
+    writeVertex(current, dst, dstVertexBuffer, uniforms);
+
+#if defined(OPENSUBDIV_MTL_COMPUTE_USE_DERIVATIVES)
+    if (uniforms.duDesc.y > 0) { // length
+        writeDerivative(current, du, duBuffer, uniforms.duDesc);
+    }
+    if (uniforms.dvDesc.y > 0) {
+        writeDerivative(current, dv, dvBuffer, uniforms.dvDesc);
+    }
+#endif
+}
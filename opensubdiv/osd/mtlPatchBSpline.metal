@@ -0,0 +1,248 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+// ----------------------------------------------------------------------------
+// BSpline
+// ----------------------------------------------------------------------------
+
+void OsdGetBSplineWeights(float t, thread float4 &point, thread float4 &deriv)
+{
+    // The four uniform cubic B-Spline basis functions evaluated at t:
+    float one6th = 1.0f / 6.0f;
+
+    float t2 = t * t;
+    float t3 = t * t2;
+
+    point.x = one6th * (1.0f - 3.0f*(t -      t2) -      t3);
+    point.y = one6th * (4.0f           - 6.0f*t2  + 3.0f*t3);
+    point.z = one6th * (1.0f + 3.0f*(t +      t2  -      t3));
+    point.w = one6th * (                                 t3);
+
+    // Derivatives of the above four basis functions at t:
+    deriv.x = -0.5f*t2 +      t - 0.5f;
+    deriv.y =  1.5f*t2 - 2.0f*t;
+    deriv.z = -1.5f*t2 +      t + 0.5f;
+    deriv.w =  0.5f*t2;
+}
+
+void OsdAdjustBoundaryWeights(int boundary, thread float4 &sWeights,
+                              thread float4 &tWeights)
+{
+    if ((boundary & 1) != 0) {
+        tWeights[2] -= tWeights[0];
+        tWeights[1] += 2*tWeights[0];
+        tWeights[0] = 0;
+    }
+    if ((boundary & 2) != 0) {
+        sWeights[1] -= sWeights[3];
+        sWeights[2] += 2*sWeights[3];
+        sWeights[3] = 0;
+    }
+    if ((boundary & 4) != 0) {
+        tWeights[1] -= tWeights[3];
+        tWeights[2] += 2*tWeights[3];
+        tWeights[3] = 0;
+    }
+    if ((boundary & 8) != 0) {
+        sWeights[2] -= sWeights[0];
+        sWeights[1] += 2*sWeights[0];
+        sWeights[0] = 0;
+    }
+}
+
+// Evaluates the B-spline patch of the 16 control points 'cp' at 'UV'
+// (boundary points are extrapolated from the boundary mask of the patch)
+void OsdEvalPatchBSpline(int3 patchParam, float2 UV, thread const float3 *cp,
+                         thread float3 &P, thread float3 &dPu,
+                         thread float3 &dPv)
+{
+    float4 sWeights, tWeights, dsWeights, dtWeights;
+    OsdGetBSplineWeights(UV.x, sWeights, dsWeights);
+    OsdGetBSplineWeights(UV.y, tWeights, dtWeights);
+
+    int boundary = OsdGetPatchBoundaryMask(patchParam);
+    OsdAdjustBoundaryWeights(boundary, sWeights, tWeights);
+    OsdAdjustBoundaryWeights(boundary, dsWeights, dtWeights);
+
+    P = float3(0);
+    dPu = float3(0);
+    dPv = float3(0);
+    for (int k = 0; k < 4; ++k) {
+        for (int l = 0; l < 4; ++l) {
+            float3 A = cp[4*k+l];
+            P   += A * (sWeights[l]  * tWeights[k]);
+            dPu += A * (dsWeights[l] * tWeights[k]);
+            dPv += A * (sWeights[l]  * dtWeights[k]);
+        }
+    }
+
+    float level = float(OsdGetPatchFaceLevel(patchParam));
+    dPu *= level;
+    dPv *= level;
+}
+
+void OsdGetTessLevelsRefinedPoints(thread const float3 *cp, int3 patchParam,
+                                   constant OsdPatchDrawUniforms &u,
+                                   thread float4 &tessOuterLo,
+                                   thread float4 &tessOuterHi)
+{
+    // Each edge of a transition patch is adjacent to one or two patches
+    // at the next refined level of subdivision. We compute the corresponding
+    // vertex-vertex and edge-vertex refined points along the edges of the
+    // patch using Catmull-Clark subdivision stencil weights.
+
+    float3 vv0 = (cp[0] + cp[2] + cp[8] + cp[10]) * 0.015625 +
+                 (cp[1] + cp[4] + cp[6] + cp[9]) * 0.09375 + cp[5] * 0.5625;
+    float3 ev01 = (cp[1] + cp[2] + cp[9] + cp[10]) * 0.0625 +
+                  (cp[5] + cp[6]) * 0.375;
+
+    float3 vv1 = (cp[1] + cp[3] + cp[9] + cp[11]) * 0.015625 +
+                 (cp[2] + cp[5] + cp[7] + cp[10]) * 0.09375 + cp[6] * 0.5625;
+    float3 ev12 = (cp[5] + cp[7] + cp[9] + cp[11]) * 0.0625 +
+                  (cp[6] + cp[10]) * 0.375;
+
+    float3 vv2 = (cp[5] + cp[7] + cp[13] + cp[15]) * 0.015625 +
+                 (cp[6] + cp[9] + cp[11] + cp[14]) * 0.09375 + cp[10] * 0.5625;
+    float3 ev23 = (cp[5] + cp[6] + cp[13] + cp[14]) * 0.0625 +
+                  (cp[9] + cp[10]) * 0.375;
+
+    float3 vv3 = (cp[4] + cp[6] + cp[12] + cp[14]) * 0.015625 +
+                 (cp[5] + cp[8] + cp[10] + cp[13]) * 0.09375 + cp[9] * 0.5625;
+    float3 ev03 = (cp[4] + cp[6] + cp[8] + cp[10]) * 0.0625 +
+                  (cp[5] + cp[9]) * 0.375;
+
+    tessOuterLo = float4(0);
+    tessOuterHi = float4(0);
+
+    int transitionMask = OsdGetPatchTransitionMask(patchParam);
+
+    if ((transitionMask & 8) != 0) {
+        tessOuterLo[0] = OsdComputeTessLevel(vv0, ev03, u);
+        tessOuterHi[0] = OsdComputeTessLevel(vv3, ev03, u);
+    } else {
+        tessOuterLo[0] = OsdComputeTessLevel(cp[5], cp[9], u);
+    }
+    if ((transitionMask & 1) != 0) {
+        tessOuterLo[1] = OsdComputeTessLevel(vv0, ev01, u);
+        tessOuterHi[1] = OsdComputeTessLevel(vv1, ev01, u);
+    } else {
+        tessOuterLo[1] = OsdComputeTessLevel(cp[5], cp[6], u);
+    }
+    if ((transitionMask & 2) != 0) {
+        tessOuterLo[2] = OsdComputeTessLevel(vv1, ev12, u);
+        tessOuterHi[2] = OsdComputeTessLevel(vv2, ev12, u);
+    } else {
+        tessOuterLo[2] = OsdComputeTessLevel(cp[6], cp[10], u);
+    }
+    if ((transitionMask & 4) != 0) {
+        tessOuterLo[3] = OsdComputeTessLevel(vv3, ev23, u);
+        tessOuterHi[3] = OsdComputeTessLevel(vv2, ev23, u);
+    } else {
+        tessOuterLo[3] = OsdComputeTessLevel(cp[9], cp[10], u);
+    }
+}
+
+//----------------------------------------------------------
+// Patches.TessFactorsBSpline
+//----------------------------------------------------------
+#ifdef OSD_PATCH_TESS_FACTORS_SHADER
+
+kernel void OsdComputeTessFactors(
+    uint patchID [[thread_position_in_grid]],
+    device const float *vertexBuffer [[buffer(OSD_VERTEX_BUFFER_INDEX)]],
+    device const int *indexBuffer [[buffer(OSD_INDEX_BUFFER_INDEX)]],
+    device const int *patchParamBuffer [[buffer(OSD_PATCH_PARAM_BUFFER_INDEX)]],
+    device MTLQuadTessellationFactorsHalf *tessFactors
+        [[buffer(OSD_TESS_FACTORS_BUFFER_INDEX)]],
+    device float4 *tessLevels [[buffer(OSD_TESS_LEVELS_BUFFER_INDEX)]],
+    constant OsdPatchDrawUniforms &uniforms
+        [[buffer(OSD_DRAW_UNIFORMS_INDEX)]])
+{
+    if (int(patchID) >= uniforms.numPatches) {
+        return;
+    }
+
+    int3 patchParam = OsdGetPatchParam(patchParamBuffer,
+                                       uniforms.primitiveIdBase + int(patchID));
+
+    float4 tessOuterLo, tessOuterHi;
+    if (uniforms.screenSpaceTess != 0) {
+        float3 cp[16];
+        int indexBase = uniforms.indexBase + int(patchID) * 16;
+        for (int i = 0; i < 16; ++i) {
+            cp[i] = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + i]);
+        }
+        OsdGetTessLevelsRefinedPoints(cp, patchParam, uniforms,
+                                      tessOuterLo, tessOuterHi);
+    } else {
+        OsdGetTessLevelsUniform(patchParam, uniforms,
+                                tessOuterLo, tessOuterHi);
+    }
+
+    OsdWriteTessFactors(tessOuterLo, tessOuterHi, tessFactors[patchID]);
+
+    // kept for the parameterization of the transition edges
+    tessLevels[2*patchID] = tessOuterLo;
+    tessLevels[2*patchID+1] = tessOuterHi;
+}
+
+#endif
+
+//----------------------------------------------------------
+// Patches.PostTessellationVertexBSpline
+//----------------------------------------------------------
+#ifdef OSD_PATCH_POST_TESSELLATION_VERTEX_SHADER
+
+[[patch(quad, 16)]]
+vertex OsdOutputVertex OsdPostTessellationVertex(
+    uint patchID [[patch_id]],
+    float2 tessCoord [[position_in_patch]],
+    device const float *vertexBuffer [[buffer(OSD_VERTEX_BUFFER_INDEX)]],
+    device const int *indexBuffer [[buffer(OSD_INDEX_BUFFER_INDEX)]],
+    device const int *patchParamBuffer [[buffer(OSD_PATCH_PARAM_BUFFER_INDEX)]],
+    device const float4 *tessLevels [[buffer(OSD_TESS_LEVELS_BUFFER_INDEX)]],
+    constant OsdPatchDrawUniforms &uniforms
+        [[buffer(OSD_DRAW_UNIFORMS_INDEX)]])
+{
+    int3 patchParam = OsdGetPatchParam(patchParamBuffer,
+                                       uniforms.primitiveIdBase + int(patchID));
+
+    float3 cp[16];
+    int indexBase = uniforms.indexBase + int(patchID) * 16;
+    for (int i = 0; i < 16; ++i) {
+        cp[i] = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + i]);
+    }
+
+    float2 UV = OsdGetTessParameterization(tessCoord,
+                                           tessLevels[2*patchID],
+                                           tessLevels[2*patchID+1]);
+
+    float3 P, dPu, dPv;
+    OsdEvalPatchBSpline(patchParam, UV, cp, P, dPu, dPv);
+
+    return OsdGetOutputVertex(P, dPu, dPv, UV, patchParam, uniforms);
+}
+
+#endif
@@ -0,0 +1,273 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+//
+// Metal patch drawing : the tessellation factors of each patch are computed
+// by a compute kernel (OsdComputeTessFactors), and the patches are drawn with
+// a post-tessellation vertex function (OsdPostTessellationVertex) evaluating
+// the limit surface at each tessellated point. See mtlPatchShaderSource.h.
+//
+
+#include <metal_stdlib>
+
+using namespace metal;
+
+#ifndef OSD_NUM_ELEMENTS
+#define OSD_NUM_ELEMENTS 3
+#endif
+
+#ifndef OSD_MAX_TESS_LEVEL
+#define OSD_MAX_TESS_LEVEL 64
+#endif
+
+// Indices of the arguments of the kernels and vertex functions
+#define OSD_VERTEX_BUFFER_INDEX 0
+#define OSD_INDEX_BUFFER_INDEX 1
+#define OSD_PATCH_PARAM_BUFFER_INDEX 2
+#define OSD_TESS_FACTORS_BUFFER_INDEX 3
+#define OSD_TESS_LEVELS_BUFFER_INDEX 4
+#define OSD_DRAW_UNIFORMS_INDEX 5
+
+// Uniforms of a draw (mirrored by the client)
+struct OsdPatchDrawUniforms {
+    float4x4 modelViewMatrix;
+    float4x4 projectionMatrix;
+    float tessLevel;
+    int screenSpaceTess;    // non-zero for screen space tessellation
+    int primitiveIdBase;    // index of the first patch param of the draw
+    int indexBase;          // index of the first control vertex of the draw
+    int numPatches;
+};
+
+struct OsdOutputVertex {
+    float4 position [[position]];
+    float4 eyePosition;
+    float3 normal;
+    float3 tangent;
+    float3 bitangent;
+    float2 tessCoord;
+    float4 patchCoord;
+};
+
+// ----------------------------------------------------------------------------
+// Patch Parameters
+// ----------------------------------------------------------------------------
+
+int3 OsdGetPatchParam(device const int *patchParamBuffer, int patchIndex)
+{
+    return int3(patchParamBuffer[3*patchIndex],
+                patchParamBuffer[3*patchIndex+1],
+                patchParamBuffer[3*patchIndex+2]);
+}
+
+int OsdGetPatchFaceId(int3 patchParam)
+{
+    return (patchParam.x & 0xfffffff);
+}
+
+int OsdGetPatchFaceLevel(int3 patchParam)
+{
+    return (1 << ((patchParam.y & 0xf) - ((patchParam.y >> 4) & 1)));
+}
+
+int OsdGetPatchRefinementLevel(int3 patchParam)
+{
+    return (patchParam.y & 0xf);
+}
+
+int OsdGetPatchBoundaryMask(int3 patchParam)
+{
+    return ((patchParam.y >> 8) & 0xf);
+}
+
+int OsdGetPatchTransitionMask(int3 patchParam)
+{
+    return ((patchParam.x >> 28) & 0xf);
+}
+
+int2 OsdGetPatchFaceUV(int3 patchParam)
+{
+    int u = (patchParam.y >> 22) & 0x3ff;
+    int v = (patchParam.y >> 12) & 0x3ff;
+    return int2(u,v);
+}
+
+float4 OsdInterpolatePatchCoord(float2 localUV, int3 patchParam)
+{
+    int faceId = OsdGetPatchFaceId(patchParam);
+    int faceLevel = OsdGetPatchFaceLevel(patchParam);
+    float2 faceUV = float2(OsdGetPatchFaceUV(patchParam));
+    float2 uv = (localUV + faceUV) / float(faceLevel);
+    // add 0.5 to integer values for more robust interpolation
+    return float4(uv.x, uv.y, faceLevel+0.5f, faceId+0.5f);
+}
+
+float3 OsdReadVertex(device const float *vertexBuffer, int vertexIndex)
+{
+    int index = vertexIndex * OSD_NUM_ELEMENTS;
+    return float3(vertexBuffer[index],
+                  vertexBuffer[index+1],
+                  vertexBuffer[index+2]);
+}
+
+// ----------------------------------------------------------------------------
+// Tessellation levels
+// ----------------------------------------------------------------------------
+
+float OsdComputePostProjectionSphereExtent(float3 center, float diameter,
+                                           constant OsdPatchDrawUniforms &u)
+{
+    float4 p = u.projectionMatrix * float4(center, 1.0);
+    return abs(diameter * u.projectionMatrix[1][1] / p.w);
+}
+
+float OsdComputeTessLevel(float3 p0, float3 p1,
+                          constant OsdPatchDrawUniforms &u)
+{
+    // Project the diameter of the edge's bounding sphere instead of using the
+    // length of the projected edge itself to avoid problems near silhouettes.
+    p0 = (u.modelViewMatrix * float4(p0, 1.0)).xyz;
+    p1 = (u.modelViewMatrix * float4(p1, 1.0)).xyz;
+    float3 center = (p0 + p1) / 2.0;
+    float diameter = distance(p0, p1);
+    float projLength = OsdComputePostProjectionSphereExtent(center, diameter, u);
+    float tessLevel = max(1.0f, u.tessLevel * projLength);
+
+    // Transition edges are split into two halves, the sum of which must not
+    // exceed the device maximum (see glslPatchCommon.glsl).
+    return min(tessLevel, float(OSD_MAX_TESS_LEVEL / 2));
+}
+
+void OsdGetTessLevelsUniform(int3 patchParam, constant OsdPatchDrawUniforms &u,
+                             thread float4 &tessOuterLo,
+                             thread float4 &tessOuterHi)
+{
+    // Uniform factors are simple powers of two for each level.
+    int refinementLevel = OsdGetPatchRefinementLevel(patchParam);
+    float tessLevel = min(u.tessLevel, float(OSD_MAX_TESS_LEVEL)) /
+                        pow(2.0f, float(refinementLevel-1));
+
+    // tessLevels of transition edge should be clamped to 2.
+    int transitionMask = OsdGetPatchTransitionMask(patchParam);
+    float4 tessLevelMin = float4(1) + float4(float((transitionMask & 8) >> 3),
+                                             float((transitionMask & 1) >> 0),
+                                             float((transitionMask & 2) >> 1),
+                                             float((transitionMask & 4) >> 2));
+
+    tessOuterLo = max(float4(tessLevel), tessLevelMin);
+    tessOuterHi = float4(0);
+}
+
+// Rounds the levels (integer spacing) and writes the factors of the
+// tessellator : edges are ordered as the outer levels of GLSL quads
+// (u=0, v=0, u=1, v=1), which is also the order of the Metal quad factors.
+void OsdWriteTessFactors(thread float4 &tessOuterLo, thread float4 &tessOuterHi,
+                         device MTLQuadTessellationFactorsHalf &factors)
+{
+    tessOuterLo = round(tessOuterLo);
+    tessOuterHi = round(tessOuterHi);
+
+    float4 combinedOuter = tessOuterLo + tessOuterHi;
+
+    for (int i = 0; i < 4; ++i) {
+        factors.edgeTessellationFactor[i] = half(combinedOuter[i]);
+    }
+    // Inner levels are the averages the corresponding outer levels.
+    factors.insideTessellationFactor[0] =
+        half((combinedOuter[1] + combinedOuter[3]) * 0.5);
+    factors.insideTessellationFactor[1] =
+        half((combinedOuter[0] + combinedOuter[2]) * 0.5);
+}
+
+float OsdGetTessTransitionSplit(float t, float lo, float hi)
+{
+    // Convert the parametric t into a segment index along the combined edge.
+    float ti = round(t * (lo + hi));
+
+    if (ti <= lo) {
+        return (ti / lo) * 0.5;
+    } else {
+        return ((ti - lo) / hi) * 0.5 + 0.5;
+    }
+}
+
+float2 OsdGetTessParameterization(float2 uv, float4 tessOuterLo,
+                                  float4 tessOuterHi)
+{
+    float2 UV = uv;
+    if (UV.x == 0 && tessOuterHi[0] > 0) {
+        UV.y = OsdGetTessTransitionSplit(UV.y, tessOuterLo[0], tessOuterHi[0]);
+    } else
+    if (UV.y == 0 && tessOuterHi[1] > 0) {
+        UV.x = OsdGetTessTransitionSplit(UV.x, tessOuterLo[1], tessOuterHi[1]);
+    } else
+    if (UV.x == 1 && tessOuterHi[2] > 0) {
+        UV.y = OsdGetTessTransitionSplit(UV.y, tessOuterLo[2], tessOuterHi[2]);
+    } else
+    if (UV.y == 1 && tessOuterHi[3] > 0) {
+        UV.x = OsdGetTessTransitionSplit(UV.x, tessOuterLo[3], tessOuterHi[3]);
+    }
+    return UV;
+}
+
+// ----------------------------------------------------------------------------
+
+void OsdUnivar4x4(float u, thread float *B, thread float *D)
+{
+    float t = u;
+    float s = 1.0f - u;
+
+    float A0 = s * s;
+    float A1 = 2 * s * t;
+    float A2 = t * t;
+
+    B[0] = s * A0;
+    B[1] = t * A0 + s * A1;
+    B[2] = t * A1 + s * A2;
+    B[3] = t * A2;
+
+    D[0] =    - A0;
+    D[1] = A0 - A1;
+    D[2] = A1 - A2;
+    D[3] = A2;
+}
+
+// Outputs of the limit evaluation, transformed by the draw uniforms
+OsdOutputVertex OsdGetOutputVertex(float3 P, float3 dPu, float3 dPv,
+                                   float2 UV, int3 patchParam,
+                                   constant OsdPatchDrawUniforms &u)
+{
+    float3 N = normalize(cross(dPu, dPv));
+
+    OsdOutputVertex outpt;
+    outpt.eyePosition = u.modelViewMatrix * float4(P, 1.0f);
+    outpt.normal = (u.modelViewMatrix * float4(N, 0.0f)).xyz;
+    outpt.tangent = (u.modelViewMatrix * float4(dPu, 0.0f)).xyz;
+    outpt.bitangent = (u.modelViewMatrix * float4(dPv, 0.0f)).xyz;
+    outpt.tessCoord = UV;
+    outpt.patchCoord = OsdInterpolatePatchCoord(UV, patchParam);
+    outpt.position = u.projectionMatrix * outpt.eyePosition;
+    return outpt;
+}
@@ -0,0 +1,178 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+// ----------------------------------------------------------------------------
+// Gregory Basis
+// ----------------------------------------------------------------------------
+
+// Evaluates the Gregory patch of the 20 control points 'cv' at 'UV' (see
+// OsdEvalPatchGregory in glslPatchCommon.glsl for the layout of the points)
+void OsdEvalPatchGregory(int3 patchParam, float2 UV, thread const float3 *cv,
+                         thread float3 &P, thread float3 &dPu,
+                         thread float3 &dPv)
+{
+    float u = UV.x, v = UV.y;
+    float U = 1-u, V = 1-v;
+
+    float d11 = u+v;
+    float d12 = U+v;
+    float d21 = u+V;
+    float d22 = U+V;
+
+    float3 q[16];
+
+    q[ 5] = (d11 == 0.0) ? cv[3]  : (u*cv[3] + v*cv[4])/d11;
+    q[ 6] = (d12 == 0.0) ? cv[8]  : (U*cv[9] + v*cv[8])/d12;
+    q[ 9] = (d21 == 0.0) ? cv[18] : (u*cv[19] + V*cv[18])/d21;
+    q[10] = (d22 == 0.0) ? cv[13] : (U*cv[13] + V*cv[14])/d22;
+
+    q[ 0] = cv[0];
+    q[ 1] = cv[1];
+    q[ 2] = cv[7];
+    q[ 3] = cv[5];
+    q[ 4] = cv[2];
+    q[ 7] = cv[6];
+    q[ 8] = cv[16];
+    q[11] = cv[12];
+    q[12] = cv[15];
+    q[13] = cv[17];
+    q[14] = cv[11];
+    q[15] = cv[10];
+
+    P   = float3(0);
+    dPu = float3(0);
+    dPv = float3(0);
+
+    float B[4], D[4];
+    float3 BUCP[4] = { float3(0), float3(0), float3(0), float3(0) },
+           DUCP[4] = { float3(0), float3(0), float3(0), float3(0) };
+
+    OsdUnivar4x4(UV.x, B, D);
+
+    for (int i=0; i<4; ++i) {
+        for (int j=0; j<4; ++j) {
+            float3 A = q[4*i + j];
+            BUCP[i] += A * B[j];
+            DUCP[i] += A * D[j];
+        }
+    }
+
+    OsdUnivar4x4(UV.y, B, D);
+
+    for (int i=0; i<4; ++i) {
+        P += B[i] * BUCP[i];
+        dPu += B[i] * DUCP[i];
+        dPv += D[i] * BUCP[i];
+    }
+
+    float level = float(OsdGetPatchFaceLevel(patchParam));
+    dPu *= 3 * level;
+    dPv *= 3 * level;
+}
+
+//----------------------------------------------------------
+// Patches.TessFactorsGregoryBasis
+//----------------------------------------------------------
+#ifdef OSD_PATCH_TESS_FACTORS_SHADER
+
+kernel void OsdComputeTessFactors(
+    uint patchID [[thread_position_in_grid]],
+    device const float *vertexBuffer [[buffer(OSD_VERTEX_BUFFER_INDEX)]],
+    device const int *indexBuffer [[buffer(OSD_INDEX_BUFFER_INDEX)]],
+    device const int *patchParamBuffer [[buffer(OSD_PATCH_PARAM_BUFFER_INDEX)]],
+    device MTLQuadTessellationFactorsHalf *tessFactors
+        [[buffer(OSD_TESS_FACTORS_BUFFER_INDEX)]],
+    device float4 *tessLevels [[buffer(OSD_TESS_LEVELS_BUFFER_INDEX)]],
+    constant OsdPatchDrawUniforms &uniforms
+        [[buffer(OSD_DRAW_UNIFORMS_INDEX)]])
+{
+    if (int(patchID) >= uniforms.numPatches) {
+        return;
+    }
+
+    int3 patchParam = OsdGetPatchParam(patchParamBuffer,
+                                       uniforms.primitiveIdBase + int(patchID));
+
+    float4 tessOuterLo, tessOuterHi;
+    if (uniforms.screenSpaceTess != 0) {
+        // the corners of the patch : P0, P3, P2, P1 (counter clockwise from
+        // the u=0 edge, as the outer levels)
+        int indexBase = uniforms.indexBase + int(patchID) * 20;
+        float3 cp0 = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + 0]);
+        float3 cp1 = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + 15]);
+        float3 cp2 = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + 10]);
+        float3 cp3 = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + 5]);
+
+        tessOuterLo[0] = OsdComputeTessLevel(cp0, cp1, uniforms);
+        tessOuterLo[1] = OsdComputeTessLevel(cp0, cp3, uniforms);
+        tessOuterLo[2] = OsdComputeTessLevel(cp2, cp3, uniforms);
+        tessOuterLo[3] = OsdComputeTessLevel(cp1, cp2, uniforms);
+        tessOuterHi = float4(0);
+    } else {
+        OsdGetTessLevelsUniform(patchParam, uniforms,
+                                tessOuterLo, tessOuterHi);
+    }
+
+    OsdWriteTessFactors(tessOuterLo, tessOuterHi, tessFactors[patchID]);
+
+    tessLevels[2*patchID] = tessOuterLo;
+    tessLevels[2*patchID+1] = tessOuterHi;
+}
+
+#endif
+
+//----------------------------------------------------------
+// Patches.PostTessellationVertexGregoryBasis
+//----------------------------------------------------------
+#ifdef OSD_PATCH_POST_TESSELLATION_VERTEX_SHADER
+
+[[patch(quad, 20)]]
+vertex OsdOutputVertex OsdPostTessellationVertex(
+    uint patchID [[patch_id]],
+    float2 tessCoord [[position_in_patch]],
+    device const float *vertexBuffer [[buffer(OSD_VERTEX_BUFFER_INDEX)]],
+    device const int *indexBuffer [[buffer(OSD_INDEX_BUFFER_INDEX)]],
+    device const int *patchParamBuffer [[buffer(OSD_PATCH_PARAM_BUFFER_INDEX)]],
+    constant OsdPatchDrawUniforms &uniforms
+        [[buffer(OSD_DRAW_UNIFORMS_INDEX)]])
+{
+    int3 patchParam = OsdGetPatchParam(patchParamBuffer,
+                                       uniforms.primitiveIdBase + int(patchID));
+
+    float3 cv[20];
+    int indexBase = uniforms.indexBase + int(patchID) * 20;
+    for (int i = 0; i < 20; ++i) {
+        cv[i] = OsdReadVertex(vertexBuffer, indexBuffer[indexBase + i]);
+    }
+
+    float2 UV = tessCoord;
+
+    float3 P, dPu, dPv;
+    OsdEvalPatchGregory(patchParam, UV, cv, P, dPu, dPv);
+
+    return OsdGetOutputVertex(P, dPu, dPv, UV, patchParam, uniforms);
+}
+
+#endif
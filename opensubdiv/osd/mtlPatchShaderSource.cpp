@@ -0,0 +1,97 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/mtlPatchShaderSource.h"
+#include <sstream>
+#include <string>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const char *commonShaderSource =
+#include "mtlPatchCommon.gen.h"
+;
+static const char *bsplineShaderSource =
+#include "mtlPatchBSpline.gen.h"
+;
+static const char *gregoryBasisShaderSource =
+#include "mtlPatchGregoryBasis.gen.h"
+;
+
+enum Stage {
+    TESS_FACTORS,
+    POST_TESSELLATION_VERTEX
+};
+
+static std::string
+getStageShaderSource(Far::PatchDescriptor::Type type, Stage stage) {
+    static const char *stageNames[2] = {
+        "TESS_FACTORS", "POST_TESSELLATION_VERTEX"
+    };
+
+    std::stringstream ss;
+    switch (type) {
+    case Far::PatchDescriptor::REGULAR:
+        ss << "#define OSD_PATCH_BSPLINE\n"
+           << "#define OSD_PATCH_" << stageNames[stage] << "_SHADER\n"
+           << bsplineShaderSource;
+        break;
+    case Far::PatchDescriptor::GREGORY_BASIS:
+        ss << "#define OSD_PATCH_GREGORY_BASIS\n"
+           << "#define OSD_PATCH_" << stageNames[stage] << "_SHADER\n"
+           << gregoryBasisShaderSource;
+        break;
+    default:
+        break;  // returns empty (legacy gregory, points, lines, quads, ...)
+    }
+    return ss.str();
+}
+
+/*static*/
+std::string
+MTLPatchShaderSource::GetCommonShaderSource() {
+    return std::string(commonShaderSource);
+}
+
+/*static*/
+std::string
+MTLPatchShaderSource::GetTessFactorsShaderSource(
+    Far::PatchDescriptor::Type type) {
+    return getStageShaderSource(type, TESS_FACTORS);
+}
+
+/*static*/
+std::string
+MTLPatchShaderSource::GetPostTessellationVertexShaderSource(
+    Far::PatchDescriptor::Type type) {
+    return getStageShaderSource(type, POST_TESSELLATION_VERTEX);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,102 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/mtlPatchTable.h"
+
+#include "../far/patchTable.h"
+#include "../osd/cpuPatchTable.h"
+
+#import <Metal/Metal.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+MTLPatchTable::MTLPatchTable() :
+    _patchIndexBuffer(nil), _patchParamBuffer(nil) {
+}
+
+MTLPatchTable::~MTLPatchTable() {
+}
+
+MTLPatchTable *
+MTLPatchTable::Create(Far::PatchTable const *farPatchTable,
+                      MTLContext *context) {
+    MTLPatchTable *instance = new MTLPatchTable();
+    if (instance->allocate(farPatchTable, context)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+MTLPatchTable::allocate(Far::PatchTable const *farPatchTable,
+                        MTLContext *context) {
+    CpuPatchTable patchTable(farPatchTable);
+
+    size_t numPatchArrays = patchTable.GetNumPatchArrays();
+    size_t indexSize = patchTable.GetPatchIndexSize();
+    size_t patchParamSize = patchTable.GetPatchParamSize();
+
+    // copy patch array
+    _patchArrays.assign(patchTable.GetPatchArrayBuffer(),
+                        patchTable.GetPatchArrayBuffer() + numPatchArrays);
+
+    // copy index and patchparam buffers
+    _patchIndexBuffer = internal::MTLNewBuffer(context,
+        patchTable.GetPatchIndexBuffer(), indexSize * sizeof(int));
+    _patchParamBuffer = internal::MTLNewBuffer(context,
+        patchTable.GetPatchParamBuffer(), patchParamSize * sizeof(PatchParam));
+    if (!_patchIndexBuffer || !_patchParamBuffer) {
+        return false;
+    }
+
+    // face-varying channels
+    int numFVarChannels = patchTable.GetNumFVarChannels();
+    _fvarPatchArrays.resize(numFVarChannels);
+    _fvarIndexBuffers.resize(numFVarChannels);
+    _fvarParamBuffers.resize(numFVarChannels);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        _fvarPatchArrays[channel].assign(
+            patchTable.GetFVarPatchArrayBuffer(channel),
+            patchTable.GetFVarPatchArrayBuffer(channel) + 2);
+
+        _fvarIndexBuffers[channel] = internal::MTLNewBuffer(context,
+            patchTable.GetFVarPatchIndexBuffer(channel),
+            patchTable.GetFVarPatchIndexSize(channel) * sizeof(int));
+        _fvarParamBuffers[channel] = internal::MTLNewBuffer(context,
+            patchTable.GetFVarPatchParamBuffer(channel),
+            patchTable.GetFVarPatchParamSize(channel) * sizeof(PatchParam));
+        if (!_fvarIndexBuffers[channel] || !_fvarParamBuffers[channel]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,96 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_MTL_VERTEX_BUFFER_H
+#define OPENSUBDIV3_OSD_MTL_VERTEX_BUFFER_H
+
+#include "../version.h"
+
+#include "../osd/mtlCommon.h"
+#include "../osd/nonCopyable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Concrete vertex buffer class for Metal subdivision and drawing.
+///
+/// An instance of this buffer class can be passed to MTLComputeEvaluator,
+/// and bound as the vertex buffer of the Metal patch shaders.
+///
+/// The buffer is accessible from the CPU : on macOS its storage is managed
+/// (the GPU copy is updated by UpdateData), it is shared on other platforms.
+///
+class MTLVertexBuffer : private NonCopyable<MTLVertexBuffer> {
+public:
+    /// Creator. Returns NULL if error.
+    static MTLVertexBuffer * Create(int numElements, int numVertices,
+                                    MTLContext *context);
+
+    /// Destructor.
+    ~MTLVertexBuffer();
+
+    /// This method is meant to be used in client code in order to provide
+    /// coarse vertices data to Osd.
+    void UpdateData(const float *src, int startVertex, int numVertices,
+                    MTLContext *context = NULL);
+
+    /// Returns how many elements defined in this vertex buffer.
+    int GetNumElements() const { return _numElements; }
+
+    /// Returns how many vertices allocated in this vertex buffer.
+    int GetNumVertices() const { return _numVertices; }
+
+    /// Returns the Metal buffer.
+    id<MTLBuffer> BindMTLBuffer(MTLContext *context = NULL);
+
+    /// Returns the Metal buffer (to be bound as a vertex buffer).
+    id<MTLBuffer> BindVBO(MTLContext *context = NULL) {
+        return BindMTLBuffer(context);
+    }
+
+protected:
+    /// Constructor.
+    MTLVertexBuffer(int numElements, int numVertices);
+
+    /// Allocates the Metal buffer. Returns true if success.
+    bool allocate(MTLContext *context);
+
+private:
+    int _numElements;
+    int _numVertices;
+    id<MTLBuffer> _buffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_MTL_VERTEX_BUFFER_H
@@ -0,0 +1,85 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/mtlVertexBuffer.h"
+#include "../far/profile.h"
+
+#import <Metal/Metal.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+MTLVertexBuffer::MTLVertexBuffer(int numElements, int numVertices)
+    : _numElements(numElements), _numVertices(numVertices), _buffer(nil) {
+}
+
+MTLVertexBuffer::~MTLVertexBuffer() {
+
+    _buffer = nil;
+}
+
+MTLVertexBuffer *
+MTLVertexBuffer::Create(int numElements, int numVertices,
+                        MTLContext *context) {
+    MTLVertexBuffer *instance =
+        new MTLVertexBuffer(numElements, numVertices);
+    if (instance->allocate(context)) return instance;
+    delete instance;
+    return NULL;
+}
+
+void
+MTLVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
+                            MTLContext * /*context*/) {
+
+    OPENSUBDIV_PROFILE_ZONE("MTLVertexBuffer::UpdateData");
+
+    size_t elementSize = _numElements * sizeof(float);
+
+    internal::MTLUpdateBuffer(_buffer, src, elementSize * startVertex,
+                              elementSize * numVertices);
+}
+
+id<MTLBuffer>
+MTLVertexBuffer::BindMTLBuffer(MTLContext * /*context*/) {
+
+    return _buffer;
+}
+
+bool
+MTLVertexBuffer::allocate(MTLContext *context) {
+
+    size_t size = (size_t)_numElements * _numVertices * sizeof(float);
+
+    _buffer = internal::MTLNewBuffer(context, NULL, size);
+    return _buffer != nil;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -24,14 +24,30 @@
 
 #include "../osd/ompEvaluator.h"
 #include "../osd/ompKernel.h"
+#include "../osd/cpuKernel.h"
 #include "../far/patchBasis.h"
+#include "../far/profile.h"
 #include <omp.h>
+#include <algorithm>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
+namespace {
+    // Ranges of stencils and patch coordinates evaluated by each thread with
+    // the kernels of the CpuEvaluator
+    int const RANGE_SIZE = 256;
+
+    // Offsets an optional output pointer by 'n' elements
+    inline float *
+    offsetElements(float * p, int n, BufferDescriptor const & desc) {
+        return p ? p + n * desc.stride : NULL;
+    }
+}
+
 /* static */
 bool
 OmpEvaluator::EvalStencils(
@@ -43,8 +59,11 @@ OmpEvaluator::EvalStencils(
     const float * weights,
     int start, int end) {
 
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
     if (end <= start) return true;
     if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
 
     // XXX: we can probably expand cpuKernel.cpp to here.
     OmpEvalStencils(src, srcDesc, dst, dstDesc,
@@ -53,6 +72,32 @@ OmpEvaluator::EvalStencils(
     return true;
 }
 
+/* static */
+bool
+OmpEvaluator::EvalStencilsBatch(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end,
+    int numInstances, const int * instanceOffsets) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencilsBatch");
+
+    if (end <= start or numInstances <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    OmpEvalStencilsBatch(src, srcDesc, dst, dstDesc,
+                         sizes, offsets, indices, weights, start, end,
+                         numInstances, instanceOffsets);
+
+    return true;
+}
+
 /* static */
 bool
 OmpEvaluator::EvalStencils(
@@ -68,8 +113,11 @@ OmpEvaluator::EvalStencils(
     const float * dvWeights,
     int start, int end) {
 
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
     if (end <= start) return true;
     if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
     if (srcDesc.length != duDesc.length) return false;
     if (srcDesc.length != dvDesc.length) return false;
 
@@ -84,6 +132,248 @@ OmpEvaluator::EvalStencils(
     return true;
 }
 
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    float *duu,       BufferDescriptor const &duuDesc,
+    float *duv,       BufferDescriptor const &duvDesc,
+    float *dvv,       BufferDescriptor const &dvvDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    const float * duuWeights,
+    const float * duvWeights,
+    const float * dvvWeights,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+    if (srcDesc.length != duuDesc.length) return false;
+    if (srcDesc.length != duvDesc.length) return false;
+    if (srcDesc.length != dvvDesc.length) return false;
+
+    int numRanges = (end - start + RANGE_SIZE - 1) / RANGE_SIZE;
+
+#pragma omp parallel for
+    for (int r = 0; r < numRanges; ++r) {
+        int n = r * RANGE_SIZE;
+        int rangeStart = start + n,
+            rangeEnd = std::min(rangeStart + RANGE_SIZE, end);
+
+        CpuEvalStencils(src, srcDesc,
+                        offsetElements(dst, n, dstDesc), dstDesc,
+                        offsetElements(du,  n, duDesc),  duDesc,
+                        offsetElements(dv,  n, dvDesc),  dvDesc,
+                        offsetElements(duu, n, duuDesc), duuDesc,
+                        offsetElements(duv, n, duvDesc), duvDesc,
+                        offsetElements(dvv, n, dvvDesc), dvvDesc,
+                        sizes, offsets, indices,
+                        weights, duWeights, dvWeights,
+                        duuWeights, duvWeights, dvvWeights,
+                        rangeStart, rangeEnd);
+    }
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencilsWithNormals(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *normal,    BufferDescriptor const &normalDesc,
+    float *tangent,   BufferDescriptor const &tangentDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencilsWithNormals");
+
+    if (end <= start) return true;
+    if (dst and not weights) return false;
+    if (not duWeights or not dvWeights) return false;
+    if (not src or not normal) return false;
+    // the normals are computed from the first 3 elements of the primvars
+    if (srcDesc.length < 3 or srcDesc.IsPlanar()) return false;
+    if (dst and (srcDesc.length != dstDesc.length or
+                 dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+                 dstDesc.IsPlanar())) return false;
+    if (normalDesc.length != 3 or normalDesc.IsPlanar() or
+        normalDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (tangent and (tangentDesc.length != 3 or tangentDesc.IsPlanar() or
+        tangentDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    int numRanges = (end - start + RANGE_SIZE - 1) / RANGE_SIZE;
+
+#pragma omp parallel for
+    for (int r = 0; r < numRanges; ++r) {
+        int n = r * RANGE_SIZE;
+        int rangeStart = start + n,
+            rangeEnd = std::min(rangeStart + RANGE_SIZE, end);
+
+        CpuEvalStencilNormals(src, srcDesc,
+                              offsetElements(dst, n, dstDesc), dstDesc,
+                              offsetElements(normal, n, normalDesc), normalDesc,
+                              offsetElements(tangent, n, tangentDesc),
+                              tangentDesc,
+                              sizes, offsets, indices,
+                              weights, duWeights, dvWeights,
+                              rangeStart, rangeEnd);
+    }
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuPackedStencilTable const *stencilTable,
+    int startBlock, int endBlock) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
+    if (endBlock <= startBlock) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    OmpEvalPackedStencils(src, srcDesc, dst, dstDesc,
+        stencilTable->GetBlockWidth(),
+        &stencilTable->GetBlockOffsets()[0],
+        &stencilTable->GetControlIndices()[0],
+        &stencilTable->GetWeights()[0],
+        stencilTable->GetNumStencils(),
+        startBlock, endBlock);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuPackedStencilTable const *stencilTable,
+    int startBlock, int endBlock) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
+    if (endBlock <= startBlock) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    // derivative weights are only packed from limit stencil tables
+    if (stencilTable->GetDuWeights().empty()) return false;
+
+    OmpEvalPackedStencils(src, srcDesc,
+        dst, dstDesc,
+        du,  duDesc,
+        dv,  dvDesc,
+        stencilTable->GetBlockWidth(),
+        &stencilTable->GetBlockOffsets()[0],
+        &stencilTable->GetControlIndices()[0],
+        &stencilTable->GetWeights()[0],
+        &stencilTable->GetDuWeights()[0],
+        &stencilTable->GetDvWeights()[0],
+        stencilTable->GetNumStencils(),
+        startBlock, endBlock);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    OmpEvalCompactStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    // derivative weights are only encoded from limit stencil tables
+    if (not stencilTable->HasDerivatives()) return false;
+
+    OmpEvalCompactStencils(src, srcDesc,
+        dst, dstDesc,
+        du,  duDesc,
+        dv,  dvDesc,
+        *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuInstancedStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    OmpEvalInstancedStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
 template <typename T>
 struct BufferAdapter {
     BufferAdapter(T *p, int length, int stride) :
@@ -125,6 +415,8 @@ OmpEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     const PatchParam *patchParamBuffer){
 
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalPatches");
+
     src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
     else return false;
@@ -158,6 +450,14 @@ OmpEvaluator::EvalPatches(
             Far::internal::GetBilinearWeights(param,
                                               coord.s, coord.t, wP, wDs, wDt);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetTriangleWeights(param,
+                                              coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 3;
         } else {
             continue;
         }
@@ -185,6 +485,8 @@ OmpEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     PatchParam const *patchParamBuffer) {
 
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalPatches");
+
     src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
     if (du)  du += duDesc.offset;
@@ -219,6 +521,14 @@ OmpEvaluator::EvalPatches(
             Far::internal::GetBilinearWeights(param,
                                               coord.s, coord.t, wP, wDs, wDt);
             numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param,
+                                          coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetTriangleWeights(param,
+                                              coord.s, coord.t, wP, wDs, wDt);
+            numControlVertices = 3;
         } else {
             continue;
         }
@@ -240,6 +550,150 @@ OmpEvaluator::EvalPatches(
     return true;
 }
 
+/* static */
+bool
+OmpEvaluator::EvalPatches(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    float *duu,       BufferDescriptor const &duuDesc,
+    float *duv,       BufferDescriptor const &duvDesc,
+    float *dvv,       BufferDescriptor const &dvvDesc,
+    int numPatchCoords,
+    PatchCoord const *patchCoords,
+    PatchArray const *patchArrays,
+    const int *patchIndexBuffer,
+    PatchParam const *patchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalPatches");
+
+    if (!src) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (dst && dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (du  && srcDesc.length != duDesc.length)  return false;
+    if (dv  && srcDesc.length != dvDesc.length)  return false;
+    if (duu && srcDesc.length != duuDesc.length) return false;
+    if (duv && srcDesc.length != duvDesc.length) return false;
+    if (dvv && srcDesc.length != dvvDesc.length) return false;
+
+    int numRanges = (numPatchCoords + RANGE_SIZE - 1) / RANGE_SIZE;
+
+#pragma omp parallel for
+    for (int r = 0; r < numRanges; ++r) {
+        int n = r * RANGE_SIZE;
+
+        // coordinates on patches of unsupported types are evaluated to zero
+        CpuEvalPatches(src, srcDesc,
+                       offsetElements(dst, n, dstDesc), dstDesc,
+                       offsetElements(du,  n, duDesc),  duDesc,
+                       offsetElements(dv,  n, dvDesc),  dvDesc,
+                       offsetElements(duu, n, duuDesc), duuDesc,
+                       offsetElements(duv, n, duvDesc), duvDesc,
+                       offsetElements(dvv, n, dvvDesc), dvvDesc,
+                       std::min(RANGE_SIZE, numPatchCoords - n),
+                       patchCoords + n,
+                       patchArrays, patchIndexBuffer, patchParamBuffer);
+    }
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalPatchesWithNormals(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *normal,    BufferDescriptor const &normalDesc,
+    float *tangent,   BufferDescriptor const &tangentDesc,
+    int numPatchCoords,
+    PatchCoord const *patchCoords,
+    PatchArray const *patchArrays,
+    const int *patchIndexBuffer,
+    PatchParam const *patchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalPatchesWithNormals");
+
+    if (not src or not normal) return false;
+    // the normals are computed from the first 3 elements of the primvars
+    if (srcDesc.length < 3 or srcDesc.IsPlanar()) return false;
+    if (dst and (srcDesc.length != dstDesc.length or
+                 dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+                 dstDesc.IsPlanar())) return false;
+    if (normalDesc.length != 3 or normalDesc.IsPlanar() or
+        normalDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (tangent and (tangentDesc.length != 3 or tangentDesc.IsPlanar() or
+        tangentDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    int numRanges = (numPatchCoords + RANGE_SIZE - 1) / RANGE_SIZE;
+
+#pragma omp parallel for
+    for (int r = 0; r < numRanges; ++r) {
+        int n = r * RANGE_SIZE;
+
+        // coordinates on patches of unsupported types are evaluated to zero
+        CpuEvalPatchNormals(src, srcDesc,
+                            offsetElements(dst, n, dstDesc), dstDesc,
+                            offsetElements(normal, n, normalDesc), normalDesc,
+                            offsetElements(tangent, n, tangentDesc), tangentDesc,
+                            std::min(RANGE_SIZE, numPatchCoords - n),
+                            patchCoords + n,
+                            patchArrays, patchIndexBuffer, patchParamBuffer);
+    }
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalPatchesFaceVarying");
+
+    std::vector<PatchCoord> fvarPatchCoords(numPatchCoords);
+    if (numPatchCoords) {
+        CpuGetFVarPatchCoords(numPatchCoords, patchCoords, fvarPatchArrays,
+                              fvarPatchParamBuffer, &fvarPatchCoords[0]);
+    }
+    return EvalPatches(src, srcDesc, dst, dstDesc,
+                       numPatchCoords, numPatchCoords ? &fvarPatchCoords[0] : 0,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer);
+}
+
+/* static */
+bool
+OmpEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("OmpEvaluator::EvalPatchesFaceVarying");
+
+    std::vector<PatchCoord> fvarPatchCoords(numPatchCoords);
+    if (numPatchCoords) {
+        CpuGetFVarPatchCoords(numPatchCoords, patchCoords, fvarPatchArrays,
+                              fvarPatchParamBuffer, &fvarPatchCoords[0]);
+    }
+    return EvalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, numPatchCoords ? &fvarPatchCoords[0] : 0,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer);
+}
+
 /* static */
 void
 OmpEvaluator::Synchronize(void * /*deviceContext*/) {
@@ -28,8 +28,12 @@
 #include "../version.h"
 
 #include <cstddef>
+#include <vector>
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/cpuCompactStencilTable.h"
+#include "../osd/cpuInstancedStencilTable.h"
+#include "../osd/cpuPackedStencilTable.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -60,7 +64,10 @@ public:
     ///
     /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param stencilTable   Far::StencilTable or equivalent
+    /// @param stencilTable   Far::StencilTable or equivalent (tables of
+    ///                       several passes are evaluated in order, the
+    ///                       output buffer must then follow the control
+    ///                       vertices in the input buffer)
     ///
     /// @param instance       not used in the omp kernel
     ///                       (declared as a typed pointer to prevent
@@ -82,14 +89,77 @@ public:
         if (stencilTable->GetNumStencils() == 0)
             return false;
 
+        // Passes refer to the vertices of the previous passes : they are
+        // evaluated in order (see Far::StencilTable::GetPassOffsets())
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            // the kernels write the first stencil of the range at the
+            // offset of the descriptor
+            BufferDescriptor passDesc = dstDesc;
+            passDesc.offset += start * dstDesc.stride;
+
+            if (not EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                                 dstBuffer->BindCpuBuffer(), passDesc,
+                                 &stencilTable->GetSizes()[0],
+                                 &stencilTable->GetOffsets()[0],
+                                 &stencilTable->GetControlIndices()[0],
+                                 &stencilTable->GetWeights()[0],
+                                 start, end)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Generic static eval stencils function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    /// \note  Ranges of tables of several passes must not span passes, and
+    ///        are evaluated in the order of the passes (see
+    ///        Far::StencilTable::GetPassOffsets())
+    ///
+    /// @param start          index of the first stencil of the range
+    ///
+    /// @param end            index of the stencil following the range
+    ///
+    /// (see the evaluation of the whole table above for the other arguments)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (end <= start) return true;
+
+        // the kernels write the first stencil of the range at the
+        // offset of the descriptor
+        BufferDescriptor rangeDesc = dstDesc;
+        rangeDesc.offset += start * dstDesc.stride;
+
         return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
-                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            dstBuffer->BindCpuBuffer(), rangeDesc,
                             &stencilTable->GetSizes()[0],
                             &stencilTable->GetOffsets()[0],
                             &stencilTable->GetControlIndices()[0],
                             &stencilTable->GetWeights()[0],
-                            /*start = */ 0,
-                            /*end   = */ stencilTable->GetNumStencils());
+                            start, end);
     }
 
     /// \brief Static eval stencils function which takes raw CPU pointers for
@@ -128,6 +198,99 @@ public:
         const float * weights,
         int start, int end);
 
+    /// \brief Generic static eval stencils function for the instances of a
+    ///        mesh. The stencils of the table are applied to each instance
+    ///        in a single dispatch, the instances being located by offsets
+    ///        in the input and output buffers.
+    ///
+    /// @param srcBuffer       Input primvar buffer.
+    ///                        must have BindCpuBuffer() method returning a
+    ///                        const float pointer for read
+    ///
+    /// @param srcDesc         vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer       Output primvar buffer
+    ///                        must have BindCpuBuffer() method returning a
+    ///                        float pointer for write
+    ///
+    /// @param dstDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable    Far::StencilTable or equivalent, shared by the
+    ///                        instances
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance,
+    ///                        in floats, added to the offsets of srcDesc and
+    ///                        dstDesc
+    ///
+    /// @param instance        not used in the omp kernel
+    ///                        (declared as a typed pointer to prevent
+    ///                         undesirable template resolution)
+    ///
+    /// @param deviceContext   not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsBatch(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int numInstances, int const * instanceOffsets,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            BufferDescriptor passDesc = dstDesc;
+            passDesc.offset += start * dstDesc.stride;
+
+            if (not EvalStencilsBatch(srcBuffer->BindCpuBuffer(), srcDesc,
+                                      dstBuffer->BindCpuBuffer(), passDesc,
+                                      &stencilTable->GetSizes()[0],
+                                      &stencilTable->GetOffsets()[0],
+                                      &stencilTable->GetControlIndices()[0],
+                                      &stencilTable->GetWeights()[0],
+                                      start, end,
+                                      numInstances, instanceOffsets)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Static eval stencils function for the instances of a mesh,
+    ///        which takes raw CPU pointers for input and output (see
+    ///        EvalStencils).
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance,
+    ///                        in floats, added to the offsets of srcDesc and
+    ///                        dstDesc
+    ///
+    static bool EvalStencilsBatch(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end,
+        int numInstances, const int * instanceOffsets);
+
     /// \brief Generic static eval stencils function with derivatives.
     ///        This function has a same signature as other device kernels
     ///        have so that it can be called in the same way from OsdMesh
@@ -157,7 +320,541 @@ public:
     ///
     /// @param dvDesc         vertex buffer descriptor for the output buffer
     ///
-    /// @param stencilTable   Far::StencilTable or equivalent
+    /// @param stencilTable   Far::StencilTable or equivalent
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with derivatives, which takes
+    ///        raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output U-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output V-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param duWeights      pointer to the du-weights buffer of the stencil table
+    ///
+    /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function writing the unit normals
+    ///        and optional tangents of the limit surface rather than its
+    ///        derivatives (see CpuEvaluator::EvalStencilsWithNormals).
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsWithNormals(
+        SRC_BUFFER *srcBuffer,     BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,     BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer,  BufferDescriptor const &normalDesc,
+        DST_BUFFER *tangentBuffer, BufferDescriptor const &tangentDesc,
+        STENCIL_TABLE const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencilsWithNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            normalBuffer->BindCpuBuffer(), normalDesc,
+            tangentBuffer ? tangentBuffer->BindCpuBuffer() : NULL, tangentDesc,
+            &stencilTable->GetSizes()[0],
+            &stencilTable->GetOffsets()[0],
+            &stencilTable->GetControlIndices()[0],
+            &stencilTable->GetWeights()[0],
+            &stencilTable->GetDuWeights()[0],
+            &stencilTable->GetDvWeights()[0],
+            /*start = */ 0,
+            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function writing the unit normals of the
+    ///        limit surface, which takes raw CPU pointers for input and
+    ///        output (see the generic function above).
+    ///
+    static bool EvalStencilsWithNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        float *tangent,   BufferDescriptor const &tangentDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with first and second
+    ///        derivatives, evaluated in a single pass over the control
+    ///        vertices of the stencils.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param duuBuffer      Output UU-derivative buffer
+    ///
+    /// @param duuDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duvBuffer      Output UV-derivative buffer
+    ///
+    /// @param duvDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvvBuffer      Output VV-derivative buffer
+    ///
+    /// @param dvvDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   Far::LimitStencilTable or equivalent (with
+    ///                       second derivatives)
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        DST_BUFFER *duuBuffer, BufferDescriptor const &duuDesc,
+        DST_BUFFER *duvBuffer, BufferDescriptor const &duvDesc,
+        DST_BUFFER *dvvBuffer, BufferDescriptor const &dvvDesc,
+        STENCIL_TABLE const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            duuBuffer->BindCpuBuffer(), duuDesc,
+                            duvBuffer->BindCpuBuffer(), duvDesc,
+                            dvvBuffer->BindCpuBuffer(), dvvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            &stencilTable->GetDuuWeights()[0],
+                            &stencilTable->GetDuvWeights()[0],
+                            &stencilTable->GetDvvWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with first and second
+    ///        derivatives, which takes raw CPU pointers for input and output
+    ///        (see the function with first derivatives).
+    ///
+    /// @param duu            Output UU-derivatives pointer. An offset of
+    ///                       duuDesc will be applied internally.
+    ///
+    /// @param duv            Output UV-derivatives pointer. An offset of
+    ///                       duvDesc will be applied internally.
+    ///
+    /// @param dvv            Output VV-derivatives pointer. An offset of
+    ///                       dvvDesc will be applied internally.
+    ///
+    /// @param duuWeights     pointer to the duu-weights buffer of the stencil table
+    ///
+    /// @param duvWeights     pointer to the duv-weights buffer of the stencil table
+    ///
+    /// @param dvvWeights     pointer to the dvv-weights buffer of the stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        float *duu,       BufferDescriptor const &duuDesc,
+        float *duv,       BufferDescriptor const &duvDesc,
+        float *dvv,       BufferDescriptor const &dvvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        const float * duuWeights,
+        const float * duvWeights,
+        const float * dvvWeights,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuPackedStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        packed for SIMD evaluation (see CpuPackedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuPackedStencilTable const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*startBlock = */ 0,
+                            /*endBlock   = */ stencilTable->GetNumBlocks());
+    }
+
+    /// \brief Static eval stencils function for packed stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer, at the first stencil of
+    ///                       the table. An offset of dstDesc will be applied
+    ///                       internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable
+    ///
+    /// @param startBlock     first block of stencils to evaluate
+    ///
+    /// @param endBlock       end block of stencils to evaluate
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuPackedStencilTable const *stencilTable,
+        int startBlock, int endBlock);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        packed limit stencil tables (see CpuPackedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuPackedStencilTable const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            stencilTable,
+                            /*startBlock = */ 0,
+                            /*endBlock   = */ stencilTable->GetNumBlocks());
+    }
+
+    /// \brief Static eval stencils function with derivatives for packed
+    ///        limit stencil tables, which takes raw CPU pointers for input
+    ///        and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output U-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output V-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param startBlock     first block of stencils to evaluate
+    ///
+    /// @param endBlock       end block of stencils to evaluate
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuPackedStencilTable const *stencilTable,
+        int startBlock, int endBlock);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuCompactStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        with a compact encoding (see CpuCompactStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for compact stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        compact limit stencil tables (see CpuCompactStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable
     ///
     /// @param instance       not used in the omp kernel
     ///                       (declared as a typed pointer to prevent
@@ -165,13 +862,13 @@ public:
     ///
     /// @param deviceContext  not used in the omp kernel
     ///
-    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    template <typename SRC_BUFFER, typename DST_BUFFER>
     static bool EvalStencils(
         SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
         DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
         DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
         DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
-        STENCIL_TABLE const *stencilTable,
+        CpuCompactStencilTable const *stencilTable,
         const OmpEvaluator *instance = NULL,
         void * deviceContext = NULL) {
 
@@ -182,18 +879,14 @@ public:
                             dstBuffer->BindCpuBuffer(), dstDesc,
                             duBuffer->BindCpuBuffer(),  duDesc,
                             dvBuffer->BindCpuBuffer(),  dvDesc,
-                            &stencilTable->GetSizes()[0],
-                            &stencilTable->GetOffsets()[0],
-                            &stencilTable->GetControlIndices()[0],
-                            &stencilTable->GetWeights()[0],
-                            &stencilTable->GetDuWeights()[0],
-                            &stencilTable->GetDvWeights()[0],
+                            stencilTable,
                             /*start = */ 0,
                             /*end   = */ stencilTable->GetNumStencils());
     }
 
-    /// \brief Static eval stencils function with derivatives, which takes
-    ///        raw CPU pointers for input and output.
+    /// \brief Static eval stencils function with derivatives for compact
+    ///        limit stencil tables, which takes raw CPU pointers for input
+    ///        and output.
     ///
     /// @param src            Input primvar pointer. An offset of srcDesc
     ///                       will be applied internally (i.e. the pointer
@@ -216,33 +909,95 @@ public:
     ///
     /// @param dvDesc         vertex buffer descriptor for the output buffer
     ///
-    /// @param sizes          pointer to the sizes buffer of the stencil table
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable
     ///
-    /// @param offsets        pointer to the offsets buffer of the stencil table
+    /// @param start          start index of stencil table
     ///
-    /// @param indices        pointer to the indices buffer of the stencil table
+    /// @param end            end index of stencil table
     ///
-    /// @param weights        pointer to the weights buffer of the stencil table
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
     ///
-    /// @param duWeights      pointer to the du-weights buffer of the stencil table
+    ///   Stencil evaluations with CpuInstancedStencilTable
     ///
-    /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        sharing their weights (see CpuInstancedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuInstancedStencilTable
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuInstancedStencilTable const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for instanced stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuInstancedStencilTable
     ///
     /// @param start          start index of stencil table
     ///
     /// @param end            end index of stencil table
     ///
     static bool EvalStencils(
-        const float *src, BufferDescriptor const &srcDesc,
-        float *dst,       BufferDescriptor const &dstDesc,
-        float *du,        BufferDescriptor const &duDesc,
-        float *dv,        BufferDescriptor const &dvDesc,
-        const int * sizes,
-        const int * offsets,
-        const int * indices,
-        const float * weights,
-        const float * duWeights,
-        const float * dvWeights,
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuInstancedStencilTable const *stencilTable,
         int start, int end);
 
     /// ----------------------------------------------------------------------
@@ -457,6 +1212,266 @@ public:
         const int *patchIndexBuffer,
         PatchParam const *patchParamBuffer);
 
+    /// \brief Generic limit eval function with first and second derivatives,
+    ///        evaluated in a single pass over the control vertices of the
+    ///        patches (see the function with first derivatives).
+    ///
+    /// @param duuBuffer        Output UU-derivatives buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param duuDesc          vertex buffer descriptor for the duuBuffer
+    ///
+    /// @param duvBuffer        Output UV-derivatives buffer
+    ///
+    /// @param duvDesc          vertex buffer descriptor for the duvBuffer
+    ///
+    /// @param dvvBuffer        Output VV-derivatives buffer
+    ///
+    /// @param dvvDesc          vertex buffer descriptor for the dvvBuffer
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        DST_BUFFER *duuBuffer, BufferDescriptor const &duuDesc,
+        DST_BUFFER *duvBuffer, BufferDescriptor const &duvDesc,
+        DST_BUFFER *dvvBuffer, BufferDescriptor const &dvvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        OmpEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           duuBuffer->BindCpuBuffer(), duuDesc,
+                           duvBuffer->BindCpuBuffer(), duvDesc,
+                           dvvBuffer->BindCpuBuffer(), dvvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function with first and second derivatives
+    ///        (see the function with first derivatives).
+    ///
+    /// @param duu              Output UU-derivatives pointer. An offset of
+    ///                         duuDesc will be applied internally.
+    ///
+    /// @param duv              Output UV-derivatives pointer. An offset of
+    ///                         duvDesc will be applied internally.
+    ///
+    /// @param dvv              Output VV-derivatives pointer. An offset of
+    ///                         dvvDesc will be applied internally.
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        float *duu,       BufferDescriptor const &duuDesc,
+        float *duv,       BufferDescriptor const &duvDesc,
+        float *dvv,       BufferDescriptor const &dvvDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// \brief Generic limit eval function writing the unit normals and
+    ///        optional tangents of the limit surface rather than its
+    ///        derivatives (see CpuEvaluator::EvalPatchesWithNormals).
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesWithNormals(
+        SRC_BUFFER *srcBuffer,     BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,     BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer,  BufferDescriptor const &normalDesc,
+        DST_BUFFER *tangentBuffer, BufferDescriptor const &tangentDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        OmpEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesWithNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            normalBuffer->BindCpuBuffer(), normalDesc,
+            tangentBuffer ? tangentBuffer->BindCpuBuffer() : NULL, tangentDesc,
+            numPatchCoords,
+            (const PatchCoord*)patchCoords->BindCpuBuffer(),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function writing the unit normals of the
+    ///        limit surface (see the generic function above).
+    ///
+    static bool EvalPatchesWithNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        float *tangent,   BufferDescriptor const &tangentDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Face-varying limit evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic face-varying limit eval function. Evaluates the values
+    ///        of a face-varying channel at the same PatchCoords as the vertex
+    ///        primvars (see EvalPatches).
+    ///
+    /// @param srcBuffer        Input face-varying primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output face-varying primvar buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///
+    /// @param fvarChannel      face-varying channel of the patch table
+    ///
+    /// @param instance         not used in the omp evaluator
+    ///
+    /// @param deviceContext    not used in the omp evaluator
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        OmpEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesFaceVarying(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Generic face-varying limit eval function with derivatives
+    ///        (see EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        OmpEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesFaceVarying(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Static face-varying limit eval function. It takes an array of
+    ///        PatchCoord of the vertex patches and evaluates the limit values
+    ///        of a face-varying channel of a PatchTable : the coordinates are
+    ///        mapped to the patches of the channel and evaluated with the
+    ///        same blocks as the vertex patches.
+    ///
+    /// @param src                  Input face-varying primvar pointer. An
+    ///                             offset of srcDesc will be applied
+    ///                             internally
+    ///
+    /// @param srcDesc              vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst                  Output primvar pointer. An offset of
+    ///                             dstDesc will be applied internally.
+    ///
+    /// @param dstDesc              vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords       number of patchCoords.
+    ///
+    /// @param patchCoords          array of locations to be evaluated.
+    ///
+    /// @param fvarPatchArrays      patch arrays of the channel (see
+    ///                             CpuPatchTable::GetFVarPatchArrayBuffer)
+    ///
+    /// @param fvarPatchIndexBuffer face-varying values of the patches
+    ///
+    /// @param fvarPatchParamBuffer face-varying PatchParam of the patches
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndexBuffer,
+        const PatchParam *fvarPatchParamBuffer);
+
+    /// \brief Static face-varying limit eval function with derivatives (see
+    ///        EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndexBuffer,
+        const PatchParam *fvarPatchParamBuffer);
+
     /// ----------------------------------------------------------------------
     ///
     ///   Other methods
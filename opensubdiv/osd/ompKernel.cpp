@@ -22,9 +22,11 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include "../osd/cpuKernel.h"
 #include "../osd/ompKernel.h"
 #include "../osd/bufferDescriptor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <omp.h>
@@ -69,6 +71,22 @@ copy(float *dst, int dstIndex, const float *src,
     memcpy(dst, src, desc.length*sizeof(float));
 }
 
+// Planar buffers are evaluated by the CPU kernel over ranges of stencils, each
+// thread streaming through the planes of its range
+static int const planarStencilsPerRange = 1024;
+
+static inline int
+getNumPlanarRanges(int start, int end) {
+    return (end - start + planarStencilsPerRange - 1) / planarStencilsPerRange;
+}
+
+// Offsets a destination descriptor to the first stencil of a range
+static inline BufferDescriptor
+getRangeDesc(BufferDescriptor const &desc, int first, int start) {
+    BufferDescriptor rangeDesc = desc;
+    rangeDesc.offset += (first - start) * desc.stride;
+    return rangeDesc;
+}
 
 // XXXX manuelk this should be optimized further by using SIMD - considering
 //              OMP is somewhat obsolete - this is probably not worth it.
@@ -81,36 +99,67 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end) {
     start = (start > 0 ? start : 0);
-    
-    src += srcDesc.offset;
-    dst += dstDesc.offset;
-
-    int numThreads = omp_get_max_threads();
-    int n = end - start;
-
-    float * result = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-
-#pragma omp parallel for
-    for (int i = 0; i < n; ++i) {
-
-        int index = i + start; // Stencil index
 
-        // Get thread-local pointers
-        int const           * threadIndices = indices + offsets[index];
-        float const         * threadWeights = weights + offsets[index];
-
-        int threadId = omp_get_thread_num();
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) {
+        int numRanges = getNumPlanarRanges(start, end);
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < numRanges; ++i) {
+            int first = start + i * planarStencilsPerRange,
+                last = std::min(first + planarStencilsPerRange, end);
+            CpuEvalStencils(src, srcDesc,
+                            dst, getRangeDesc(dstDesc, first, start),
+                            sizes, offsets, indices, weights, first, last);
+        }
+        return;
+    }
 
-        float * threadResult = result + threadId*srcDesc.length;
+    // one range of stencils per thread, balanced by numbers of weights : the
+    // sizes of the stencils vary widely from a level of a table to the next
+    int numRanges = omp_get_max_threads();
+
+    int * bounds = (int*)alloca((numRanges + 1) * sizeof(int));
+    CpuGetStencilRanges(sizes, offsets, start, end, numRanges, bounds);
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numRanges; ++i) {
+        int first = bounds[i],
+            last = bounds[i+1];
+        if (first < last) {
+            CpuEvalStencils(src, srcDesc,
+                            dst, getRangeDesc(dstDesc, first, start),
+                            sizes, offsets, indices, weights, first, last);
+        }
+    }
+}
 
-        clear(threadResult, dstDesc);
+void
+OmpEvalStencilsBatch(float const * src, BufferDescriptor const &srcDesc,
+                     float * dst,       BufferDescriptor const &dstDesc,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances, int const * instanceOffsets) {
+    start = (start > 0 ? start : 0);
 
-        for (int j=0; j<(int)sizes[index]; ++j) {
-            addWithWeight(threadResult, src,
-                threadIndices[j], threadWeights[j], srcDesc);
+    // ranges of stencils balanced by numbers of weights, each evaluated for
+    // all the instances in a single pass (see CpuEvalStencilsBatch)
+    int numRanges = omp_get_max_threads();
+
+    int * bounds = (int*)alloca((numRanges + 1) * sizeof(int));
+    CpuGetStencilRanges(sizes, offsets, start, end, numRanges, bounds);
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numRanges; ++i) {
+        int first = bounds[i],
+            last = bounds[i+1];
+        if (first < last) {
+            CpuEvalStencilsBatch(src, srcDesc,
+                                 dst, getRangeDesc(dstDesc, first, start),
+                                 sizes, offsets, indices, weights, first, last,
+                                 numInstances, instanceOffsets);
         }
-
-        copy(dst, i, threadResult, dstDesc);
     }
 }
 
@@ -128,53 +177,177 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 int start, int end) {
     start = (start > 0 ? start : 0);
 
-    src += srcDesc.offset;
-    dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar() or
+        dstDuDesc.IsPlanar() or dstDvDesc.IsPlanar()) {
+        int numRanges = getNumPlanarRanges(start, end);
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < numRanges; ++i) {
+            int first = start + i * planarStencilsPerRange,
+                last = std::min(first + planarStencilsPerRange, end);
+            CpuEvalStencils(src, srcDesc,
+                            dst,   getRangeDesc(dstDesc, first, start),
+                            dstDu, getRangeDesc(dstDuDesc, first, start),
+                            dstDv, getRangeDesc(dstDvDesc, first, start),
+                            sizes, offsets, indices,
+                            weights, duWeights, dvWeights, first, last);
+        }
+        return;
+    }
+
+    int numRanges = omp_get_max_threads();
+
+    int * bounds = (int*)alloca((numRanges + 1) * sizeof(int));
+    CpuGetStencilRanges(sizes, offsets, start, end, numRanges, bounds);
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numRanges; ++i) {
+        int first = bounds[i],
+            last = bounds[i+1];
+        if (first < last) {
+            CpuEvalStencils(src, srcDesc,
+                            dst,   getRangeDesc(dstDesc, first, start),
+                            dstDu, getRangeDesc(dstDuDesc, first, start),
+                            dstDv, getRangeDesc(dstDvDesc, first, start),
+                            sizes, offsets, indices,
+                            weights, duWeights, dvWeights, first, last);
+        }
+    }
+}
+
+// Packed stencils are evaluated by ranges of blocks, large enough to amortize
+// the dispatch of the SIMD kernels
+static int const packedBlocksPerRange = 16;
+
+void
+OmpEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils,
+                      int startBlock, int endBlock) {
+
+    int numRanges = (endBlock - startBlock + packedBlocksPerRange - 1) /
+                    packedBlocksPerRange;
+
+#pragma omp parallel for
+    for (int i = 0; i < numRanges; ++i) {
 
-    int numThreads = omp_get_max_threads();
-    int n = end - start;
+        int rangeStart = startBlock + i * packedBlocksPerRange,
+            rangeEnd = std::min(rangeStart + packedBlocksPerRange, endBlock);
 
-    float * result = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDu = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDv = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
+        CpuEvalPackedStencils(src, srcDesc, dst, dstDesc,
+            blockWidth, blockOffsets, indices, weights,
+            numStencils, rangeStart, rangeEnd);
+    }
+}
+
+void
+OmpEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstDu,     BufferDescriptor const &dstDuDesc,
+                      float * dstDv,     BufferDescriptor const &dstDvDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils,
+                      int startBlock, int endBlock) {
+
+    int numRanges = (endBlock - startBlock + packedBlocksPerRange - 1) /
+                    packedBlocksPerRange;
 
 #pragma omp parallel for
-    for (int i = 0; i < n; ++i) {
+    for (int i = 0; i < numRanges; ++i) {
+
+        int rangeStart = startBlock + i * packedBlocksPerRange,
+            rangeEnd = std::min(rangeStart + packedBlocksPerRange, endBlock);
+
+        CpuEvalPackedStencils(src, srcDesc, dst, dstDesc,
+            dstDu, dstDuDesc, dstDv, dstDvDesc,
+            blockWidth, blockOffsets, indices,
+            weights, duWeights, dvWeights,
+            numStencils, rangeStart, rangeEnd);
+    }
+}
 
-        int index = i + start; // Stencil index
+// Compact stencils are evaluated by ranges, large enough to amortize the
+// dispatch of their decoding kernels
+static int const compactStencilsPerRange = 256;
 
-        // Get thread-local pointers
-        int const           * threadIndices = indices + offsets[index];
-        float const         * threadWeights = weights + offsets[index];
-        float const         * threadWeightsDu = duWeights + offsets[index];
-        float const         * threadWeightsDv = dvWeights + offsets[index];
+void
+OmpEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end) {
 
-        int threadId = omp_get_thread_num();
+    int numRanges = (end - start + compactStencilsPerRange - 1) /
+                    compactStencilsPerRange;
 
-        float * threadResult = result + threadId*srcDesc.length;
-        float * threadResultDu = resultDu + threadId*srcDesc.length;
-        float * threadResultDv = resultDv + threadId*srcDesc.length;
+#pragma omp parallel for
+    for (int i = 0; i < numRanges; ++i) {
 
-        clear(threadResult, dstDesc);
-        clear(threadResultDu, dstDuDesc);
-        clear(threadResultDv, dstDvDesc);
+        int rangeStart = start + i * compactStencilsPerRange,
+            rangeEnd = std::min(rangeStart + compactStencilsPerRange, end);
 
-        for (int j=0; j<(int)sizes[index]; ++j) {
-            addWithWeight(threadResult, src,
-                threadIndices[j], threadWeights[j], srcDesc);
-            addWithWeight(threadResultDu, src,
-                threadIndices[j], threadWeightsDu[j], srcDesc);
-            addWithWeight(threadResultDv, src,
-                threadIndices[j], threadWeightsDv[j], srcDesc);
-        }
+        CpuEvalCompactStencils(src, srcDesc,
+            elementAtIndex(dst, rangeStart - start, dstDesc), dstDesc,
+            stencilTable, rangeStart, rangeEnd);
+    }
+}
 
-        copy(dst, i, threadResult, dstDesc);
-        copy(dstDu, i, threadResultDu, dstDuDesc);
-        copy(dstDv, i, threadResultDv, dstDvDesc);
+void
+OmpEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       float * dstDu,     BufferDescriptor const &dstDuDesc,
+                       float * dstDv,     BufferDescriptor const &dstDvDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end) {
+
+    int numRanges = (end - start + compactStencilsPerRange - 1) /
+                    compactStencilsPerRange;
+
+#pragma omp parallel for
+    for (int i = 0; i < numRanges; ++i) {
+
+        int rangeStart = start + i * compactStencilsPerRange,
+            rangeEnd = std::min(rangeStart + compactStencilsPerRange, end);
+
+        CpuEvalCompactStencils(src, srcDesc,
+            elementAtIndex(dst,   rangeStart - start, dstDesc),   dstDesc,
+            elementAtIndex(dstDu, rangeStart - start, dstDuDesc), dstDuDesc,
+            elementAtIndex(dstDv, rangeStart - start, dstDvDesc), dstDvDesc,
+            stencilTable, rangeStart, rangeEnd);
     }
+}
 
+// Instanced stencils are evaluated by ranges as well : the shapes of
+// neighboring stencils are mostly the same, and stay in the cache of the
+// thread evaluating them
+static int const instancedStencilsPerRange = 256;
+
+void
+OmpEvalInstancedStencils(float const * src, BufferDescriptor const &srcDesc,
+                         float * dst,       BufferDescriptor const &dstDesc,
+                         CpuInstancedStencilTable const & stencilTable,
+                         int start, int end) {
+
+    int numRanges = (end - start + instancedStencilsPerRange - 1) /
+                    instancedStencilsPerRange;
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numRanges; ++i) {
+
+        int rangeStart = start + i * instancedStencilsPerRange,
+            rangeEnd = std::min(rangeStart + instancedStencilsPerRange, end);
+
+        CpuEvalInstancedStencils(src, srcDesc,
+            elementAtIndex(dst, rangeStart - start, dstDesc), dstDesc,
+            stencilTable, rangeStart, rangeEnd);
+    }
 }
 
 }  // end namespace Osd
@@ -33,6 +33,8 @@ namespace OPENSUBDIV_VERSION {
 namespace Osd {
 
 struct BufferDescriptor;
+class CpuCompactStencilTable;
+class CpuInstancedStencilTable;
 
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
@@ -43,6 +45,16 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end);
 
+void
+OmpEvalStencilsBatch(float const * src, BufferDescriptor const &srcDesc,
+                     float * dst,       BufferDescriptor const &dstDesc,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances, int const * instanceOffsets);
+
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -56,6 +68,50 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvWeights,
                 int start, int end);
 
+void
+OmpEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils,
+                      int startBlock, int endBlock);
+
+void
+OmpEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstDu,     BufferDescriptor const &dstDuDesc,
+                      float * dstDv,     BufferDescriptor const &dstDvDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils,
+                      int startBlock, int endBlock);
+
+void
+OmpEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end);
+
+void
+OmpEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       float * dstDu,     BufferDescriptor const &dstDuDesc,
+                       float * dstDv,     BufferDescriptor const &dstDvDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end);
+
+void
+OmpEvalInstancedStencils(float const * src, BufferDescriptor const &srcDesc,
+                         float * dst,       BufferDescriptor const &dstDesc,
+                         CpuInstancedStencilTable const & stencilTable,
+                         int start, int end);
+
 } // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
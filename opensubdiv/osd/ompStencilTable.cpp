@@ -0,0 +1,86 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/ompStencilTable.h"
+#include "../far/stencilTable.h"
+
+#include <omp.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+OmpStencilTable::OmpStencilTable(Far::StencilTable const *stencilTable) :
+    _numStencils(stencilTable->GetNumStencils()),
+    _passOffsets(stencilTable->GetPassOffsets()),
+    _sizes(0), _offsets(0), _indices(0), _weights(0) {
+
+    if (_numStencils == 0) return;
+
+    int numWeights = (int)stencilTable->GetControlIndices().size();
+
+    _sizes = new int[_numStencils];
+    _offsets = new Far::Index[_numStencils];
+    _indices = new Far::Index[numWeights];
+    _weights = new float[numWeights];
+
+    int const * sizes = &stencilTable->GetSizes()[0];
+    Far::Index const * offsets = &stencilTable->GetOffsets()[0];
+    Far::Index const * indices = &stencilTable->GetControlIndices()[0];
+    float const * weights = &stencilTable->GetWeights()[0];
+
+    // copy each pass with the schedule of its evaluation (see
+    // OmpEvalStencils) so that each thread places the stencils it evaluates
+    int numPasses = _passOffsets.empty() ? 1 : (int)_passOffsets.size();
+    for (int pass = 0; pass < numPasses; ++pass) {
+        int start = _passOffsets.empty() ? 0 : _passOffsets[pass];
+        int end = (pass+1 < numPasses) ? _passOffsets[pass+1] : _numStencils;
+
+#pragma omp parallel for schedule(static)
+        for (int i = start; i < end; ++i) {
+            int offset = offsets[i];
+
+            _sizes[i] = sizes[i];
+            _offsets[i] = offset;
+            for (int j = 0; j < sizes[i]; ++j) {
+                _indices[offset+j] = indices[offset+j];
+                _weights[offset+j] = weights[offset+j];
+            }
+        }
+    }
+}
+
+OmpStencilTable::~OmpStencilTable() {
+    delete [] _sizes;
+    delete [] _offsets;
+    delete [] _indices;
+    delete [] _weights;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,120 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_OMP_STENCIL_TABLE_H
+#define OPENSUBDIV3_OSD_OMP_STENCIL_TABLE_H
+
+#include "../version.h"
+#include "../far/types.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class StencilTable;
+}
+
+namespace Osd {
+
+/// \brief Stencil table placed in the memory of the threads evaluating it
+///
+/// On NUMA systems, the pages of memory are placed on the node of the thread
+/// that first writes to them. Far::StencilTable is populated by a single
+/// thread, so that all of its arrays reside on one node, and the threads of
+/// the other nodes read the stencils across the interconnect.
+///
+/// OmpStencilTable copies the arrays of a Far::StencilTable with the static
+/// schedule of OmpEvaluator::EvalStencils() : the stencils of each thread are
+/// written, and placed, by that thread. The table is evaluated by
+/// OmpEvaluator as a Far::StencilTable.
+///
+/// Output primvar buffers are placed the same way by their first write : the
+/// vertices evaluated by a new CpuVertexBuffer should not be initialized
+/// before their first evaluation.
+///
+/// \note The placement only holds while the number of OpenMP threads (see
+///       omp_get_max_threads()) and their binding to the cores (OMP_PROC_BIND)
+///       are those of the construction of the table.
+///
+class OmpStencilTable {
+public:
+    static OmpStencilTable *Create(Far::StencilTable const *stencilTable,
+                                   void *deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new OmpStencilTable(stencilTable);
+    }
+
+    explicit OmpStencilTable(Far::StencilTable const *stencilTable);
+
+    ~OmpStencilTable();
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return _numStencils; }
+
+    /// \brief Returns the first stencil of each pass
+    ///        (see Far::StencilTable::GetPassOffsets())
+    std::vector<Far::Index> const & GetPassOffsets() const {
+        return _passOffsets;
+    }
+
+    /// \brief Returns the number of control vertices of each stencil
+    int const * GetSizes() const { return _sizes; }
+
+    /// \brief Returns the offset of the weights of each stencil
+    Far::Index const * GetOffsets() const { return _offsets; }
+
+    /// \brief Returns the control vertex indices of the stencils
+    Far::Index const * GetControlIndices() const { return _indices; }
+
+    /// \brief Returns the weights of the stencils
+    float const * GetWeights() const { return _weights; }
+
+private:
+    OmpStencilTable(OmpStencilTable const &);
+    OmpStencilTable & operator=(OmpStencilTable const &);
+
+    int _numStencils;
+
+    std::vector<Far::Index> _passOffsets;
+
+    // allocated without initialization : the pages are placed by the
+    // threads copying the stencils
+    int *        _sizes;
+    Far::Index * _offsets,
+               * _indices;
+    float *      _weights;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_OMP_STENCIL_TABLE_H
@@ -0,0 +1,62 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#include "../osd/ompTaskScheduler.h"
+
+#include <algorithm>
+#include <omp.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+OmpTaskScheduler::OmpTaskScheduler(int numThreads) :
+    _numThreads((numThreads > 0) ? numThreads : omp_get_max_threads()) {
+}
+
+void
+OmpTaskScheduler::ParallelFor(int begin, int end, int grainSize,
+                              RangeKernel kernel, void * data) const {
+
+    if (end <= begin) return;
+
+    grainSize = std::max(grainSize, 1);
+
+    int numRanges = (end - begin + grainSize - 1) / grainSize;
+    if (numRanges == 1 || _numThreads == 1) {
+        kernel(begin, end, data);
+        return;
+    }
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+    for (int i = 0; i < numRanges; ++i) {
+        int rangeBegin = begin + i * grainSize;
+        kernel(rangeBegin, std::min(rangeBegin + grainSize, end), data);
+    }
+}
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,65 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_OSD_OMP_TASK_SCHEDULER_H
+#define OPENSUBDIV3_OSD_OMP_TASK_SCHEDULER_H
+
+#include "../version.h"
+
+#include "../far/taskScheduler.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+///  \brief Far::TaskScheduler executing ranges with an OpenMP parallel loop
+///
+class OmpTaskScheduler : public Far::TaskScheduler {
+
+public:
+    /// \brief Constructor
+    ///
+    /// @param numThreads  Number of OpenMP threads to use (the OpenMP default
+    ///                    when zero or less)
+    ///
+    explicit OmpTaskScheduler(int numThreads = 0);
+
+    virtual void ParallelFor(int begin, int end, int grainSize,
+                             RangeKernel kernel, void * data) const;
+
+    virtual int GetNumThreads() const { return _numThreads; }
+
+private:
+    int _numThreads;
+};
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_OMP_TASK_SCHEDULER_H
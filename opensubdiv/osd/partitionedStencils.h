@@ -0,0 +1,255 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_PARTITIONED_STENCILS_H
+#define OPENSUBDIV3_OSD_PARTITIONED_STENCILS_H
+
+#include "../version.h"
+
+#include <vector>
+#include "../far/stencilTable.h"
+#include "../far/stencilTableFactory.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+///  \brief Stencils of a mesh partitioned across several devices
+///
+///  The stencils of a table are partitioned by ranges of refined vertices of
+///  about the same number of weights (see
+///  Far::StencilTableFactory::CreatePartition), one per device. Each device
+///  holds the stencils of its partition, the control vertices referenced by
+///  them only and the refined vertices of its range, so that meshes too large
+///  for the memory of a single device can be refined. The refined vertices
+///  are kept distributed : each device draws the patches of its range, or
+///  the client gathers them from the buffers of the partitions.
+///
+///  STENCIL_TABLE and VERTEX_BUFFER are the types of the EVALUATOR (e.g.
+///  CudaStencilTable, CudaVertexBuffer and CudaEvaluator, or CLStencilTable,
+///  CLVertexBuffer and CLEvaluator), created with the device context of each
+///  partition.
+///
+///  \note Backends whose current device is a global state (CUDA) require
+///        the device of a partition to be made current before the calls
+///        for that partition : use the methods taking a partition index.
+///
+template <class VERTEX_BUFFER, class STENCIL_TABLE, class EVALUATOR,
+          class DEVICE_CONTEXT = void>
+class PartitionedStencils {
+public:
+    /// \brief Constructor
+    ///
+    /// @param table           Far::StencilTable of a single pass
+    ///
+    /// @param numElements     number of elements of each vertex
+    ///
+    /// @param numPartitions   number of partitions (devices)
+    ///
+    /// @param deviceContexts  device context of each partition
+    ///
+    /// @param evaluators      evaluator instance of each partition (if the
+    ///                        EVALUATOR requires instances, e.g. CLEvaluator)
+    ///
+    PartitionedStencils(Far::StencilTable const * table, int numElements,
+                        int numPartitions,
+                        DEVICE_CONTEXT * const * deviceContexts = NULL,
+                        EVALUATOR const * const * evaluators = NULL) :
+        _numElements(numElements) {
+
+        int numStencils = table->GetNumStencils();
+        if (numPartitions < 1) numPartitions = 1;
+
+        // ranges of about the same number of weights
+        std::vector<int> const & sizes = table->GetSizes();
+        long long numWeights = 0;
+        for (int i = 0; i < numStencils; ++i) numWeights += sizes[i];
+
+        _partitions.resize(numPartitions);
+        long long weight = 0;
+        for (int p = 0, i = 0; p < numPartitions; ++p) {
+            Partition & partition = _partitions[p];
+            partition.start = i;
+            long long target = numWeights * (p + 1) / numPartitions;
+            for ( ; i < numStencils and
+                (weight < target or p == numPartitions - 1); ++i) {
+                weight += sizes[i];
+            }
+            partition.end = i;
+
+            partition.deviceContext =
+                deviceContexts ? deviceContexts[p] : NULL;
+            partition.evaluator = evaluators ? evaluators[p] : NULL;
+
+            Far::StencilTable const * partitionTable =
+                Far::StencilTableFactory::CreatePartition(
+                    table, partition.start, partition.end,
+                    partition.controlVertices);
+
+            int numControlVertices = (int)partition.controlVertices.size();
+            partition.stencilTable = partitionTable ?
+                STENCIL_TABLE::Create(partitionTable,
+                                      partition.deviceContext) : NULL;
+            partition.srcBuffer = numControlVertices ?
+                VERTEX_BUFFER::Create(numElements, numControlVertices,
+                                      partition.deviceContext) : NULL;
+            partition.dstBuffer = partition.end > partition.start ?
+                VERTEX_BUFFER::Create(numElements,
+                                      partition.end - partition.start,
+                                      partition.deviceContext) : NULL;
+            delete partitionTable;
+        }
+    }
+
+    /// \brief Destructor
+    ~PartitionedStencils() {
+        for (int p = 0; p < GetNumPartitions(); ++p) {
+            delete _partitions[p].stencilTable;
+            delete _partitions[p].srcBuffer;
+            delete _partitions[p].dstBuffer;
+        }
+    }
+
+    /// \brief Returns the number of partitions
+    int GetNumPartitions() const { return (int)_partitions.size(); }
+
+    /// \brief Returns the first refined vertex (stencil) of a partition
+    int GetPartitionStart(int p) const { return _partitions[p].start; }
+
+    /// \brief Returns the refined vertex past the last one of a partition
+    int GetPartitionEnd(int p) const { return _partitions[p].end; }
+
+    /// \brief Returns the control vertices of the mesh held by a partition
+    std::vector<Far::Index> const & GetControlVertices(int p) const {
+        return _partitions[p].controlVertices;
+    }
+
+    /// \brief Returns the buffer of the control vertices of a partition
+    VERTEX_BUFFER * GetSrcBuffer(int p) const {
+        return _partitions[p].srcBuffer;
+    }
+
+    /// \brief Returns the buffer of the refined vertices of a partition (the
+    ///        vertex GetPartitionStart(p) of the mesh being its first)
+    VERTEX_BUFFER * GetDstBuffer(int p) const {
+        return _partitions[p].dstBuffer;
+    }
+
+    /// \brief Updates the control vertices of a partition from those of the
+    ///        mesh
+    ///
+    /// @param p       partition index
+    ///
+    /// @param src     values of all the control vertices of the mesh
+    ///
+    void UpdateControlVertices(int p, float const * src) {
+        Partition & partition = _partitions[p];
+        int numControlVertices = (int)partition.controlVertices.size();
+        if (numControlVertices == 0) return;
+
+        partition.staging.resize((size_t)numControlVertices * _numElements);
+        for (int i = 0; i < numControlVertices; ++i) {
+            float const * value =
+                src + (size_t)partition.controlVertices[i] * _numElements;
+            std::copy(value, value + _numElements,
+                      &partition.staging[(size_t)i * _numElements]);
+        }
+        partition.srcBuffer->UpdateData(&partition.staging[0], 0,
+            numControlVertices, partition.deviceContext);
+    }
+
+    /// \brief Updates the control vertices of all the partitions
+    void UpdateControlVertices(float const * src) {
+        for (int p = 0; p < GetNumPartitions(); ++p) {
+            UpdateControlVertices(p, src);
+        }
+    }
+
+    /// \brief Evaluates the refined vertices of a partition
+    bool Refine(int p) {
+        Partition & partition = _partitions[p];
+        if (not partition.dstBuffer) return true;
+
+        BufferDescriptor desc(0, _numElements, _numElements);
+        return EVALUATOR::EvalStencils(partition.srcBuffer, desc,
+                                       partition.dstBuffer, desc,
+                                       partition.stencilTable,
+                                       partition.evaluator,
+                                       partition.deviceContext);
+    }
+
+    /// \brief Evaluates the refined vertices of all the partitions, each
+    ///        device computing concurrently with the others
+    bool Refine() {
+        bool result = true;
+        for (int p = 0; p < GetNumPartitions(); ++p) {
+            result = Refine(p) and result;
+        }
+        return result;
+    }
+
+    /// \brief Waits for the evaluation of a partition
+    void Synchronize(int p) {
+        EVALUATOR::Synchronize(_partitions[p].deviceContext);
+    }
+
+    /// \brief Waits for the evaluation of all the partitions
+    void Synchronize() {
+        for (int p = 0; p < GetNumPartitions(); ++p) {
+            Synchronize(p);
+        }
+    }
+
+private:
+    struct Partition {
+        Partition() : start(0), end(0), deviceContext(NULL), evaluator(NULL),
+            stencilTable(NULL), srcBuffer(NULL), dstBuffer(NULL) { }
+
+        int start, end;
+        std::vector<Far::Index> controlVertices;
+        std::vector<float> staging;
+
+        DEVICE_CONTEXT * deviceContext;
+        EVALUATOR const * evaluator;
+        STENCIL_TABLE const * stencilTable;
+        VERTEX_BUFFER * srcBuffer,
+                      * dstBuffer;
+    };
+
+    int _numElements;
+    std::vector<Partition> _partitions;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_PARTITIONED_STENCILS_H
@@ -0,0 +1,169 @@
+//
+//  Copyright 2016 Pixar
+//
+//  Licensed under the Apache License, Version 2.0 (the "Apache License")
+//  with the following modification; you may not use this file except in
+//  compliance with the Apache License and the following modification to it:
+//  Section 6. Trademarks. is deleted and replaced with:
+//
+//  6. Trademarks. This License does not grant permission to use the trade
+//     names, trademarks, service marks, or product names of the Licensor
+//     and its affiliates, except as required to comply with Section 4(c) of
+//     the License and to reproduce the content of the NOTICE file.
+//
+//  You may obtain a copy of the Apache License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the Apache License with the above modification is
+//  distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//  KIND, either express or implied. See the Apache License for the specific
+//  language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/programCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#if defined(_WIN32)
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+//
+// Each file holds a header, the key and the binary : the key is compared
+// to the one requested, so that collisions of the hashed file names are
+// misses rather than invalid binaries.
+//
+static const unsigned int CACHE_MAGIC = 0x4350534f;  // "OSPC"
+static const unsigned int CACHE_VERSION = 1;
+
+static std::string &
+cacheDirectory() {
+    // the environment is read on first use, unless a directory was set
+    static bool initialized = false;
+    static std::string directory;
+    if (!initialized) {
+        initialized = true;
+        const char *env = getenv("OPENSUBDIV_PROGRAM_CACHE");
+        if (env) directory = env;
+    }
+    return directory;
+}
+
+static std::string
+cacheFilePath(std::string const &key) {
+
+    // FNV-1a of the key
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < key.size(); ++i) {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+
+    char name[32];
+    sprintf(name, "osd_%016llx.bin", hash);
+
+    std::string path = cacheDirectory();
+    char last = path[path.size()-1];
+    if (last != '/' && last != '\\') path += '/';
+    return path + name;
+}
+
+void
+ProgramCache::SetDirectory(const char *path) {
+    cacheDirectory() = path ? path : "";
+}
+
+std::string const &
+ProgramCache::GetDirectory() {
+    return cacheDirectory();
+}
+
+bool
+ProgramCache::Load(std::string const &key, std::vector<char> &binary) {
+
+    if (!IsEnabled()) return false;
+
+    FILE *fp = fopen(cacheFilePath(key).c_str(), "rb");
+    if (!fp) return false;
+
+    unsigned int header[3] = { 0, 0, 0 };
+    bool valid = fread(header, sizeof(header), 1, fp) == 1 &&
+                 header[0] == CACHE_MAGIC &&
+                 header[1] == CACHE_VERSION &&
+                 header[2] == (unsigned int)key.size();
+
+    if (valid && !key.empty()) {
+        std::string storedKey(key.size(), '\0');
+        valid = fread(&storedKey[0], key.size(), 1, fp) == 1 &&
+                storedKey == key;
+    }
+
+    unsigned int size = 0;
+    if (valid) {
+        valid = fread(&size, sizeof(size), 1, fp) == 1 && size > 0;
+    }
+    if (valid) {
+        binary.resize(size);
+        valid = fread(&binary[0], size, 1, fp) == 1;
+    }
+    fclose(fp);
+
+    if (!valid) binary.clear();
+    return valid;
+}
+
+bool
+ProgramCache::Store(std::string const &key, const void *binary, size_t size) {
+
+    if (!IsEnabled() || !binary || size == 0) return false;
+
+    std::string path = cacheFilePath(key);
+
+    // a temporary file of this process is renamed once complete
+    std::ostringstream tmp;
+#if defined(_WIN32)
+    tmp << path << "." << _getpid() << ".tmp";
+#else
+    tmp << path << "." << getpid() << ".tmp";
+#endif
+    std::string tmpPath = tmp.str();
+
+    FILE *fp = fopen(tmpPath.c_str(), "wb");
+    if (!fp) return false;
+
+    unsigned int header[3] = { CACHE_MAGIC, CACHE_VERSION,
+                               (unsigned int)key.size() };
+    unsigned int binarySize = (unsigned int)size;
+
+    bool written = fwrite(header, sizeof(header), 1, fp) == 1 &&
+                   (key.empty() || fwrite(key.data(), key.size(), 1, fp) == 1) &&
+                   fwrite(&binarySize, sizeof(binarySize), 1, fp) == 1 &&
+                   fwrite(binary, size, 1, fp) == 1;
+    written = (fclose(fp) == 0) && written;
+
+    if (written && rename(tmpPath.c_str(), path.c_str()) != 0) {
+        // rename() does not replace existing files on Windows
+        remove(path.c_str());
+        written = rename(tmpPath.c_str(), path.c_str()) == 0;
+    }
+    if (!written) {
+        remove(tmpPath.c_str());
+    }
+    return written;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
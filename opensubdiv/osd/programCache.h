@@ -0,0 +1,87 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_PROGRAM_CACHE_H
+#define OPENSUBDIV3_OSD_PROGRAM_CACHE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+/// \brief Disk cache of the compiled kernels of the GPU evaluators
+///
+/// The kernels compiled by GLComputeEvaluator (program binaries),
+/// CLEvaluator (program binaries) and D3D11ComputeEvaluator (shader blobs)
+/// for each combination of buffer descriptors are stored in a directory,
+/// so that the evaluators of later processes are created without compiling
+/// them again (see also EvaluatorCacheT::Prewarm()).
+///
+/// Kernels are keyed by their full source and by a description of the
+/// device and driver : binaries rejected by the driver are compiled from
+/// source again, and replaced.
+///
+/// The cache is disabled until a directory is set, either by SetDirectory()
+/// or by the OPENSUBDIV_PROGRAM_CACHE environment variable.
+///
+class ProgramCache {
+public:
+    /// \brief Sets the directory of the cache (an existing directory, shared
+    ///        by processes) -- a NULL or empty path disables the cache
+    ///
+    /// \note This function is not thread-safe !
+    ///
+    static void SetDirectory(const char *path);
+
+    /// \brief Returns the directory of the cache (empty if disabled)
+    static std::string const & GetDirectory();
+
+    /// \brief Returns true if a directory is set
+    static bool IsEnabled() { return !GetDirectory().empty(); }
+
+    /// \brief Reads the binary stored for 'key' (returns false if missing)
+    static bool Load(std::string const &key, std::vector<char> &binary);
+
+    /// \brief Stores the binary of 'key' (returns false on failure)
+    ///
+    /// The file is written under a temporary name first, so that concurrent
+    /// processes never read a partial binary.
+    ///
+    static bool Store(std::string const &key, const void *binary, size_t size);
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_PROGRAM_CACHE_H
@@ -0,0 +1,109 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/splitEvaluator.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <sys/time.h>
+#endif
+
+#include <algorithm>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+    //  Bounds of an adaptive fraction, and the share of the CPU duration under
+    //  which the GPU is considered to have completed first (idle):
+    float const MIN_FRACTION = 0.02f,
+                MAX_FRACTION = 0.98f;
+    double const IDLE_SHARE = 0.05;
+}
+
+SplitBalance::SplitBalance(float cpuFraction, bool adaptive) :
+    _cpuFraction(0.0f), _adaptive(adaptive) {
+
+    SetCpuFraction(cpuFraction);
+}
+
+void
+SplitBalance::SetCpuFraction(float cpuFraction) {
+
+    _cpuFraction = _adaptive ?
+        std::min(std::max(cpuFraction, MIN_FRACTION), MAX_FRACTION) :
+        std::min(std::max(cpuFraction, 0.0f), 1.0f);
+}
+
+int
+SplitBalance::GetNumCpuStencils(int numStencils) const {
+
+    return std::min(numStencils, (int)((float)numStencils * _cpuFraction + 0.5f));
+}
+
+void
+SplitBalance::Rebalance(int numCpuStencils, double cpuSeconds,
+                        int numGpuStencils, double gpuSeconds) {
+
+    if (not _adaptive or numCpuStencils <= 0 or numGpuStencils <= 0 or
+        cpuSeconds <= 0.0) return;
+
+    //  When the GPU completed first, its duration is that of the CPU and only
+    //  bounds its throughput : the GPU share is then increased stepwise
+    float target;
+    if (gpuSeconds - cpuSeconds < IDLE_SHARE * cpuSeconds) {
+        target = _cpuFraction * 0.8f;
+    } else {
+        double cpuRate = numCpuStencils / cpuSeconds,
+               gpuRate = numGpuStencils / gpuSeconds;
+        target = (float)(cpuRate / (cpuRate + gpuRate));
+    }
+
+    //  Halfway to the target, to damp variations from frame to frame
+    SetCpuFraction(_cpuFraction + 0.5f * (target - _cpuFraction));
+}
+
+double
+SplitBalance::GetTime() {
+
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timeval now;
+    gettimeofday(&now, 0);
+    return now.tv_sec + now.tv_usec / 1000000.0;
+#endif
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
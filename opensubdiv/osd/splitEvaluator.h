@@ -0,0 +1,229 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_SPLIT_EVALUATOR_H
+#define OPENSUBDIV3_OSD_SPLIT_EVALUATOR_H
+
+#include "../version.h"
+
+#include <vector>
+#include "../osd/types.h"
+#include "../osd/bufferDescriptor.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+///  \brief Proportion of the stencils of a table evaluated on the CPU by a
+///         SplitEvaluator, rebalanced from the throughput measured on each
+///         evaluation
+///
+class SplitBalance {
+public:
+    /// \brief Constructor
+    ///
+    /// @param cpuFraction  initial fraction of the stencils evaluated on
+    ///                     the CPU
+    ///
+    /// @param adaptive     rebalance the fraction after each evaluation
+    ///
+    SplitBalance(float cpuFraction = 0.25f, bool adaptive = true);
+
+    /// \brief Returns the fraction of the stencils evaluated on the CPU
+    float GetCpuFraction() const { return _cpuFraction; }
+
+    /// \brief Sets the fraction of the stencils evaluated on the CPU (kept
+    ///        from 2% to 98% while adaptive, for both rates to be measured)
+    void SetCpuFraction(float cpuFraction);
+
+    /// \brief Returns true if the fraction is rebalanced on each evaluation
+    bool IsAdaptive() const { return _adaptive; }
+
+    /// \brief Enables or disables the rebalancing of the fraction
+    void SetAdaptive(bool adaptive) { _adaptive = adaptive; }
+
+    /// \brief Returns the number of the first stencils of a table of
+    ///        'numStencils' evaluated on the CPU
+    int GetNumCpuStencils(int numStencils) const;
+
+    /// \brief Rebalances the fraction from the durations of an evaluation
+    ///
+    /// @param numCpuStencils  number of stencils evaluated on the CPU
+    ///
+    /// @param cpuSeconds      duration of the CPU evaluation
+    ///
+    /// @param numGpuStencils  number of stencils evaluated on the GPU
+    ///
+    /// @param gpuSeconds      duration from the launch of the GPU evaluation
+    ///                        to its completion, awaited after the CPU
+    ///                        evaluation
+    ///
+    void Rebalance(int numCpuStencils, double cpuSeconds,
+                   int numGpuStencils, double gpuSeconds);
+
+    /// \brief Returns the current time in seconds (for the durations above)
+    static double GetTime();
+
+private:
+    float _cpuFraction;
+    bool  _adaptive;
+};
+
+///
+///  \brief Cooperative evaluation of stencils by a CPU and a GPU evaluator
+///
+///  The first stencils of a table (in the proportion of a SplitBalance) are
+///  evaluated by CPU_EVALUATOR (e.g. OmpEvaluator or TbbEvaluator) from host
+///  copies of the control values, while the others are evaluated by
+///  GPU_EVALUATOR (e.g. CudaEvaluator or CLEvaluator) in the device buffer.
+///  Only the values computed on the CPU are then uploaded to the device
+///  buffer.  The proportion is rebalanced after each evaluation so that both
+///  devices complete at the same time.
+///
+///  GPU_EVALUATOR must provide EvalStencilRange() and Synchronize(), and
+///  CPU_EVALUATOR the static EvalStencils() taking raw CPU pointers.
+///
+template <class CPU_EVALUATOR, class GPU_EVALUATOR>
+class SplitEvaluator : public SplitBalance {
+public:
+    /// \brief Constructor (see SplitBalance)
+    SplitEvaluator(float cpuFraction = 0.25f, bool adaptive = true) :
+        SplitBalance(cpuFraction, adaptive), _pendingUpload(false) { }
+
+    /// \brief Evaluates the stencils of a table on both devices
+    ///
+    /// @param srcValues      Host copy of the control values, with the
+    ///                       layout of srcDesc
+    ///
+    /// @param srcBuffer      Input primvar buffer of the GPU evaluator
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer of the GPU evaluator,
+    ///                       with an UpdateData() method
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer,
+    ///                       which must span whole vertices of the buffer
+    ///                       (offset multiple of the stride, and length
+    ///                       equal to the stride and the number of elements
+    ///                       of the buffer) for the CPU values to be uploaded
+    ///
+    /// @param cpuTable       Far::StencilTable or equivalent
+    ///
+    /// @param gpuTable       the same stencils for the GPU evaluator (e.g.
+    ///                       CudaStencilTable)
+    ///
+    /// @param gpuInstance    GPU evaluator instance (if any)
+    ///
+    /// @param deviceContext  client providing context class of the GPU
+    ///
+    /// Tables of several passes, whose passes refer to the values of the
+    /// previous ones, are evaluated on the GPU only.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename CPU_STENCIL_TABLE, typename GPU_STENCIL_TABLE>
+    bool EvalStencils(
+        float const *srcValues,
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CPU_STENCIL_TABLE const *cpuTable,
+        GPU_STENCIL_TABLE const *gpuTable,
+        GPU_EVALUATOR const *gpuInstance = NULL,
+        void * deviceContext = NULL) {
+
+        int numStencils = cpuTable->GetNumStencils();
+        if (numStencils == 0) return false;
+
+        // the staging values of the previous upload may still be read
+        if (_pendingUpload) {
+            GPU_EVALUATOR::Synchronize(deviceContext);
+            _pendingUpload = false;
+        }
+
+        bool wholeVertices = dstDesc.length == dstDesc.stride and
+            dstDesc.stride == dstBuffer->GetNumElements() and
+            dstDesc.offset % dstDesc.stride == 0;
+
+        int numCpuStencils = (wholeVertices and
+            cpuTable->GetPassOffsets().empty()) ?
+                GetNumCpuStencils(numStencils) : 0;
+
+        double start = GetTime();
+
+        // the GPU range is launched first, and completes asynchronously
+        if (not GPU_EVALUATOR::EvalStencilRange(srcBuffer, srcDesc,
+                dstBuffer, dstDesc, gpuTable, numCpuStencils, numStencils,
+                gpuInstance, deviceContext)) {
+            return false;
+        }
+        if (numCpuStencils == 0) return true;
+
+        _staging.resize((size_t)numCpuStencils * dstDesc.stride);
+        if (not CPU_EVALUATOR::EvalStencils(
+                srcValues, srcDesc,
+                &_staging[0], BufferDescriptor(0, dstDesc.length, dstDesc.stride),
+                &cpuTable->GetSizes()[0],
+                &cpuTable->GetOffsets()[0],
+                &cpuTable->GetControlIndices()[0],
+                &cpuTable->GetWeights()[0],
+                0, numCpuStencils)) {
+            return false;
+        }
+        double cpuEnd = GetTime();
+
+        if (IsAdaptive()) {
+            GPU_EVALUATOR::Synchronize(deviceContext);
+            Rebalance(numCpuStencils, cpuEnd - start,
+                      numStencils - numCpuStencils, GetTime() - start);
+        }
+
+        dstBuffer->UpdateData(&_staging[0], dstDesc.offset / dstDesc.stride,
+                              numCpuStencils, deviceContext);
+        _pendingUpload = true;
+        return true;
+    }
+
+    /// \brief synchronize all asynchronous computation invoked on the GPU.
+    void Synchronize(void *deviceContext = NULL) {
+        GPU_EVALUATOR::Synchronize(deviceContext);
+        _pendingUpload = false;
+    }
+
+private:
+    std::vector<float> _staging;
+    bool _pendingUpload;
+};
+
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_SPLIT_EVALUATOR_H
@@ -23,30 +23,314 @@
 //
 
 #include "../osd/tbbEvaluator.h"
+#include "../far/profile.h"
 #include "../osd/tbbKernel.h"
+#include "../osd/cpuKernel.h"
 
-#include <tbb/task_scheduler_init.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+    // oneTBB replaces task_scheduler_init with global_control
+    #include <tbb/global_control.h>
+#else
+    #include <tbb/task_scheduler_init.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
+// Task arena of an instance, created once, and affinity partitioners of the
+// ranges of stencils evaluated by the instance
+struct TbbEvaluator::Scheduler {
+
+    Scheduler(int numThreads) :
+        arena(numThreads > 0 ? numThreads : tbb::task_arena::automatic) {
+        arena.initialize();
+    }
+
+    ~Scheduler() {
+        for (PartitionerMap::iterator it = partitioners.begin();
+            it != partitioners.end(); ++it) {
+            delete it->second;
+        }
+    }
+
+    tbb::affinity_partitioner * GetPartitioner(int const * offsets, int start) {
+        tbb::affinity_partitioner * & partitioner =
+            partitioners[std::make_pair(offsets, start)];
+        if (not partitioner) {
+            partitioner = new tbb::affinity_partitioner;
+        }
+        return partitioner;
+    }
+
+    // ranges are identified by the offsets of their table and their first
+    // stencil
+    typedef std::map<std::pair<int const *, int>,
+                     tbb::affinity_partitioner *> PartitionerMap;
+
+    tbb::task_arena arena;
+    PartitionerMap  partitioners;
+};
+
+namespace {
+
+// Evaluation of a range of stencils executed in a task arena
+struct StencilRangeTask {
+
+    void operator()() const {
+        TbbEvalStencils(src, *srcDesc, dst, *dstDesc,
+                        sizes, offsets, indices, weights, start, end,
+                        grainSize, partitioner);
+    }
+
+    float const * src;
+    BufferDescriptor const * srcDesc;
+    float * dst;
+    BufferDescriptor const * dstDesc;
+    int const * sizes;
+    int const * offsets;
+    int const * indices;
+    float const * weights;
+    int start, end;
+    int grainSize;
+    tbb::affinity_partitioner * partitioner;
+};
+
+} // end namespace
+
+TbbEvaluator::TbbEvaluator(Options const & options) :
+    _options(options), _scheduler(new Scheduler(options.numThreads)) {
+}
+
+TbbEvaluator::~TbbEvaluator() {
+    delete _scheduler;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end,
+    TbbEvaluator const * instance) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    // planar destinations are stored as floats
+    if (dstDesc.IsPlanar() and
+        dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+
+    if (instance) {
+        instance->evalStencils(src, srcDesc, dst, dstDesc,
+                               sizes, offsets, indices, weights, start, end);
+    } else {
+        TbbEvalStencils(src, srcDesc, dst, dstDesc,
+                        sizes, offsets, indices, weights, start, end);
+    }
+    return true;
+}
+
+void
+TbbEvaluator::evalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end) const {
+
+    int numStencils = end - start,
+        numWeights = offsets[end-1] + sizes[end-1] - offsets[start];
+
+    if (numWeights < _options.serialThreshold) {
+        // not worth waking up the threads of the arena
+        TbbEvalStencils(src, srcDesc, dst, dstDesc,
+                        sizes, offsets, indices, weights, start, end,
+                        numStencils, NULL);
+        return;
+    }
+
+    // size the tasks from the average number of weights of the stencils,
+    // leaving a few tasks to each thread to balance the load
+    int avgWeights = std::max(numWeights / numStencils, 1),
+        maxGrainSize = numStencils / (4 * _scheduler->arena.max_concurrency());
+
+    StencilRangeTask task;
+    task.src = src;
+    task.srcDesc = &srcDesc;
+    task.dst = dst;
+    task.dstDesc = &dstDesc;
+    task.sizes = sizes;
+    task.offsets = offsets;
+    task.indices = indices;
+    task.weights = weights;
+    task.start = start;
+    task.end = end;
+    task.grainSize = std::max(
+        std::min(_options.grainWeights / avgWeights, maxGrainSize), 1);
+    task.partitioner = _options.affinityPartitioning ?
+        _scheduler->GetPartitioner(offsets, start) : NULL;
+
+    _scheduler->arena.execute(task);
+}
+
+namespace {
+
+// Evaluation of ranges of stencils [bounds[i], bounds[i+1]) with a kernel of
+// a fixed layout, executed in a task arena
+struct FixedStencilRangeTask {
+
+    void operator()(tbb::blocked_range<int> const & r) const {
+        for (int i = r.begin(); i < r.end(); ++i) {
+            int first = bounds[i],
+                last = bounds[i+1];
+            if (first < last) {
+                kernel(src, dst + first * dstStride, sizes + first,
+                       indices + offsets[first], weights + offsets[first],
+                       last - first);
+            }
+        }
+    }
+
+    void operator()() const {
+        tbb::parallel_for(tbb::blocked_range<int>(0, numRanges, 1), *this);
+    }
+
+    CpuFixedStencilKernel kernel;
+    float const * src;
+    float * dst;
+    int dstStride;
+    int const * sizes;
+    int const * offsets;
+    int const * indices;
+    float const * weights;
+    int const * bounds;
+    int numRanges;
+};
+
+} // end namespace
+
+/* static */
+void
+TbbEvaluator::evalFixedStencils(
+    CpuFixedStencilKernel kernel,
+    const float *src,
+    float *dst, int dstStride,
+    const int *sizes,
+    const int *offsets,
+    const int *indices,
+    const float *weights,
+    int start, int end,
+    TbbEvaluator const *instance) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    int numWeights = offsets[end-1] + sizes[end-1] - offsets[start];
+
+    if (instance and numWeights < instance->_options.serialThreshold) {
+        // not worth waking up the threads of the arena
+        kernel(src, dst + start * dstStride, sizes + start,
+               indices + offsets[start], weights + offsets[start],
+               end - start);
+        return;
+    }
+
+    // a few ranges of equal numbers of weights per thread
+    int numThreads = instance ? instance->_scheduler->arena.max_concurrency() :
+                                tbb::this_task_arena::max_concurrency(),
+        numRanges = std::min(end - start, 4 * numThreads);
+
+    std::vector<int> bounds(numRanges + 1);
+    CpuGetStencilRanges(sizes, offsets, start, end, numRanges, &bounds[0]);
+
+    FixedStencilRangeTask task;
+    task.kernel = kernel;
+    task.src = src;
+    task.dst = dst;
+    task.dstStride = dstStride;
+    task.sizes = sizes;
+    task.offsets = offsets;
+    task.indices = indices;
+    task.weights = weights;
+    task.bounds = &bounds[0];
+    task.numRanges = numRanges;
+
+    if (instance) {
+        instance->_scheduler->arena.execute(task);
+    } else {
+        task();
+    }
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencilsBatch(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end,
+    int numInstances, const int * instanceOffsets) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencilsBatch");
+
+    if (end <= start or numInstances <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    TbbEvalStencilsBatch(src, srcDesc, dst, dstDesc,
+                         sizes, offsets, indices, weights, start, end,
+                         numInstances, instanceOffsets);
+
+    return true;
+}
+
 /* static */
 bool
 TbbEvaluator::EvalStencils(
     const float *src, BufferDescriptor const &srcDesc,
     float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
     const int * sizes,
     const int * offsets,
     const int * indices,
     const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
     int start, int end) {
 
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
     if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
 
-    TbbEvalStencils(src, srcDesc, dst, dstDesc,
-                    sizes, offsets, indices, weights, start, end);
+    TbbEvalStencils(src, srcDesc,
+                    dst, dstDesc,
+                    du,  duDesc,
+                    dv,  dvDesc,
+                    sizes, offsets, indices,
+                    weights, duWeights, dvWeights,
+                    start, end);
 
     return true;
 }
@@ -58,30 +342,224 @@ TbbEvaluator::EvalStencils(
     float *dst,       BufferDescriptor const &dstDesc,
     float *du,        BufferDescriptor const &duDesc,
     float *dv,        BufferDescriptor const &dvDesc,
+    float *duu,       BufferDescriptor const &duuDesc,
+    float *duv,       BufferDescriptor const &duvDesc,
+    float *dvv,       BufferDescriptor const &dvvDesc,
     const int * sizes,
     const int * offsets,
     const int * indices,
     const float * weights,
     const float * duWeights,
     const float * dvWeights,
+    const float * duuWeights,
+    const float * duvWeights,
+    const float * dvvWeights,
     int start, int end) {
 
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
     if (end <= start) return true;
     if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
     if (srcDesc.length != duDesc.length) return false;
     if (srcDesc.length != dvDesc.length) return false;
+    if (srcDesc.length != duuDesc.length) return false;
+    if (srcDesc.length != duvDesc.length) return false;
+    if (srcDesc.length != dvvDesc.length) return false;
 
     TbbEvalStencils(src, srcDesc,
                     dst, dstDesc,
                     du,  duDesc,
                     dv,  dvDesc,
+                    duu, duuDesc,
+                    duv, duvDesc,
+                    dvv, dvvDesc,
                     sizes, offsets, indices,
                     weights, duWeights, dvWeights,
+                    duuWeights, duvWeights, dvvWeights,
                     start, end);
 
     return true;
 }
 
+/* static */
+bool
+TbbEvaluator::EvalStencilsWithNormals(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *normal,    BufferDescriptor const &normalDesc,
+    float *tangent,   BufferDescriptor const &tangentDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencilsWithNormals");
+
+    if (end <= start) return true;
+    if (dst and not weights) return false;
+    if (not duWeights or not dvWeights) return false;
+    if (not src or not normal) return false;
+    // the normals are computed from the first 3 elements of the primvars
+    if (srcDesc.length < 3 or srcDesc.IsPlanar()) return false;
+    if (dst and (srcDesc.length != dstDesc.length or
+                 dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+                 dstDesc.IsPlanar())) return false;
+    if (normalDesc.length != 3 or normalDesc.IsPlanar() or
+        normalDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (tangent and (tangentDesc.length != 3 or tangentDesc.IsPlanar() or
+        tangentDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    TbbEvalStencilNormals(src, srcDesc,
+                          dst, dstDesc,
+                          normal, normalDesc,
+                          tangent, tangentDesc,
+                          sizes, offsets, indices,
+                          weights, duWeights, dvWeights,
+                          start, end);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuPackedStencilTable const *stencilTable,
+    int startBlock, int endBlock) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    if (endBlock <= startBlock) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    TbbEvalPackedStencils(src, srcDesc, dst, dstDesc,
+        stencilTable->GetBlockWidth(),
+        &stencilTable->GetBlockOffsets()[0],
+        &stencilTable->GetControlIndices()[0],
+        &stencilTable->GetWeights()[0],
+        stencilTable->GetNumStencils(),
+        startBlock, endBlock);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuPackedStencilTable const *stencilTable,
+    int startBlock, int endBlock) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    if (endBlock <= startBlock) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    // derivative weights are only packed from limit stencil tables
+    if (stencilTable->GetDuWeights().empty()) return false;
+
+    TbbEvalPackedStencils(src, srcDesc,
+        dst, dstDesc,
+        du,  duDesc,
+        dv,  dvDesc,
+        stencilTable->GetBlockWidth(),
+        &stencilTable->GetBlockOffsets()[0],
+        &stencilTable->GetControlIndices()[0],
+        &stencilTable->GetWeights()[0],
+        &stencilTable->GetDuWeights()[0],
+        &stencilTable->GetDvWeights()[0],
+        stencilTable->GetNumStencils(),
+        startBlock, endBlock);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    TbbEvalCompactStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    // derivative weights are only encoded from limit stencil tables
+    if (not stencilTable->HasDerivatives()) return false;
+
+    TbbEvalCompactStencils(src, srcDesc,
+        dst, dstDesc,
+        du,  duDesc,
+        dv,  dvDesc,
+        *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuInstancedStencilTable const *stencilTable,
+    int start, int end) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalStencils");
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    TbbEvalInstancedStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
 /* static */
 bool
 TbbEvaluator::EvalPatches(
@@ -93,7 +571,11 @@ TbbEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     const PatchParam *patchParamBuffer) {
 
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalPatches");
+
     if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
 
     TbbEvalPatches(src, srcDesc, dst, dstDesc,
                    NULL, BufferDescriptor(),
@@ -117,16 +599,189 @@ TbbEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     const PatchParam *patchParamBuffer) {
 
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalPatches");
+
     if (srcDesc.length != dstDesc.length) return false;
+    if (dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+
+    TbbEvalPatches(src, srcDesc, dst, dstDesc,
+                   du,  duDesc,  dv,  dvDesc,
+                   numPatchCoords, patchCoords,
+                   patchArrayBuffer, patchIndexBuffer, patchParamBuffer);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalPatches(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    float *duu,       BufferDescriptor const &duuDesc,
+    float *duv,       BufferDescriptor const &duvDesc,
+    float *dvv,       BufferDescriptor const &dvvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrayBuffer,
+    const int *patchIndexBuffer,
+    const PatchParam *patchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalPatches");
+
+    if (!src) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (dst && dstDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) return false;
+    if (du  && srcDesc.length != duDesc.length)  return false;
+    if (dv  && srcDesc.length != dvDesc.length)  return false;
+    if (duu && srcDesc.length != duuDesc.length) return false;
+    if (duv && srcDesc.length != duvDesc.length) return false;
+    if (dvv && srcDesc.length != dvvDesc.length) return false;
 
     TbbEvalPatches(src, srcDesc, dst, dstDesc,
                    du,  duDesc,  dv,  dvDesc,
+                   duu, duuDesc, duv, duvDesc, dvv, dvvDesc,
                    numPatchCoords, patchCoords,
                    patchArrayBuffer, patchIndexBuffer, patchParamBuffer);
 
     return true;
 }
 
+/* static */
+bool
+TbbEvaluator::EvalPatchesWithNormals(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *normal,    BufferDescriptor const &normalDesc,
+    float *tangent,   BufferDescriptor const &tangentDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *patchArrayBuffer,
+    const int *patchIndexBuffer,
+    const PatchParam *patchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalPatchesWithNormals");
+
+    if (not src or not normal) return false;
+    // the normals are computed from the first 3 elements of the primvars
+    if (srcDesc.length < 3 or srcDesc.IsPlanar()) return false;
+    if (dst and (srcDesc.length != dstDesc.length or
+                 dstDesc.elementType != BufferDescriptor::TYPE_FLOAT or
+                 dstDesc.IsPlanar())) return false;
+    if (normalDesc.length != 3 or normalDesc.IsPlanar() or
+        normalDesc.elementType != BufferDescriptor::TYPE_FLOAT) return false;
+    if (tangent and (tangentDesc.length != 3 or tangentDesc.IsPlanar() or
+        tangentDesc.elementType != BufferDescriptor::TYPE_FLOAT)) return false;
+
+    TbbEvalPatchNormals(src, srcDesc,
+                        dst, dstDesc,
+                        normal, normalDesc,
+                        tangent, tangentDesc,
+                        numPatchCoords, patchCoords,
+                        patchArrayBuffer, patchIndexBuffer, patchParamBuffer);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalPatchesFaceVarying");
+
+    std::vector<PatchCoord> fvarPatchCoords(numPatchCoords);
+    if (numPatchCoords) {
+        CpuGetFVarPatchCoords(numPatchCoords, patchCoords, fvarPatchArrays,
+                              fvarPatchParamBuffer, &fvarPatchCoords[0]);
+    }
+    return EvalPatches(src, srcDesc, dst, dstDesc,
+                       numPatchCoords, numPatchCoords ? &fvarPatchCoords[0] : 0,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer);
+}
+
+/* static */
+bool
+TbbEvaluator::EvalPatchesFaceVarying(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const PatchArray *fvarPatchArrays,
+    const int *fvarPatchIndexBuffer,
+    const PatchParam *fvarPatchParamBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::EvalPatchesFaceVarying");
+
+    std::vector<PatchCoord> fvarPatchCoords(numPatchCoords);
+    if (numPatchCoords) {
+        CpuGetFVarPatchCoords(numPatchCoords, patchCoords, fvarPatchArrays,
+                              fvarPatchParamBuffer, &fvarPatchCoords[0]);
+    }
+    return EvalPatches(src, srcDesc, dst, dstDesc,
+                       du, duDesc, dv, dvDesc,
+                       numPatchCoords, numPatchCoords ? &fvarPatchCoords[0] : 0,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamBuffer);
+}
+
+/* static */
+bool
+TbbEvaluator::AdvectPatchCoords(int numSamples,
+                                int *faceIds,
+                                float *u,
+                                float *v,
+                                float *velocities,
+                                float step,
+                                int numPtexFaces,
+                                const int *adjacencyBuffer,
+                                PatchCoord *patchCoords,
+                                int numFaces,
+                                const int *faceBuffer,
+                                const unsigned int *nodeBuffer,
+                                const int *handleBuffer) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::AdvectPatchCoords");
+
+    if (numSamples <= 0) return true;
+
+    TbbAdvectPatchCoords(numSamples, faceIds, u, v, velocities, step,
+                         numPtexFaces, adjacencyBuffer, patchCoords,
+                         numFaces, faceBuffer, nodeBuffer, handleBuffer);
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::BlendKeyframes(const float *keys,
+                             BufferDescriptor const &keyDesc,
+                             float *dst,
+                             BufferDescriptor const &dstDesc,
+                             int numVertices, int key0, int key1,
+                             float weight) {
+
+    OPENSUBDIV_PROFILE_ZONE("TbbEvaluator::BlendKeyframes");
+
+    if (numVertices <= 0) return true;
+    if (keyDesc.length != dstDesc.length) return false;
+
+    TbbBlendKeyframes(keys, keyDesc, dst, dstDesc,
+                      numVertices, key0, key1, weight);
+    return true;
+}
+
 /* static */
 void
 TbbEvaluator::Synchronize(void *) {
@@ -135,11 +790,20 @@ TbbEvaluator::Synchronize(void *) {
 /* static */
 void
 TbbEvaluator::SetNumThreads(int numThreads) {
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+    // the limit holds until the next call
+    static tbb::global_control * control = 0;
+    delete control;
+    control = (numThreads == -1) ? 0 :
+        new tbb::global_control(
+            tbb::global_control::max_allowed_parallelism, numThreads);
+#else
     if (numThreads == -1) {
         tbb::task_scheduler_init init;
     } else {
         tbb::task_scheduler_init init(numThreads);
     }
+#endif
 }
 
 }  // end namespace Osd
@@ -28,9 +28,14 @@
 #include "../version.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/cpuCompactStencilTable.h"
+#include "../osd/cpuFixedStencilKernel.h"
+#include "../osd/cpuInstancedStencilTable.h"
+#include "../osd/cpuPackedStencilTable.h"
 #include "../far/patchTable.h"
 
 #include <cstddef>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -39,6 +44,57 @@ namespace Osd {
 
 class TbbEvaluator {
 public:
+    typedef bool Instantiatable;
+
+    /// \brief Scheduling options of the evaluator instances
+    ///
+    /// The static functions evaluate the stencils in the default task arena
+    /// with a fixed grain size. Instances own a task arena, created once, and
+    /// size the sub-ranges of stencils from the weights of the table.
+    ///
+    /// \note An instance evaluates one table at a time : concurrent
+    ///       evaluations require an instance per thread.
+    ///
+    struct Options {
+
+        Options() : numThreads(-1),
+                    serialThreshold(4096),
+                    grainWeights(1024),
+                    affinityPartitioning(true) { }
+
+        int  numThreads;           ///< threads of the task arena (-1 : default
+                                   ///  number of threads)
+        int  serialThreshold;      ///< ranges of stencils with fewer weights
+                                   ///  are evaluated on the calling thread
+        int  grainWeights;         ///< number of weights evaluated by each task
+        bool affinityPartitioning; ///< replay the mapping of the tasks to the
+                                   ///  threads when a stencil table is
+                                   ///  evaluated repeatedly
+    };
+
+    /// \brief Constructor
+    explicit TbbEvaluator(Options const & options = Options());
+
+    /// \brief Destructor
+    ~TbbEvaluator();
+
+    /// \brief Generic creator template (see EvaluatorCacheT)
+    static TbbEvaluator * Create(BufferDescriptor const &srcDesc,
+                                 BufferDescriptor const &dstDesc,
+                                 BufferDescriptor const &duDesc,
+                                 BufferDescriptor const &dvDesc,
+                                 void *deviceContext = NULL) {
+        (void)srcDesc;        // unused
+        (void)dstDesc;        // unused
+        (void)duDesc;         // unused
+        (void)dvDesc;         // unused
+        (void)deviceContext;  // unused
+        return new TbbEvaluator();
+    }
+
+    /// \brief Returns the scheduling options of the instance
+    Options const & GetOptions() const { return _options; }
+
     /// ----------------------------------------------------------------------
     ///
     ///   Stencil evaluations with StencilTable
@@ -61,11 +117,14 @@ public:
     ///
     /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param stencilTable   stencil table to be applied.
+    /// @param stencilTable   stencil table to be applied (tables of several
+    ///                       passes are evaluated in order, the output buffer
+    ///                       must then follow the control vertices in the
+    ///                       input buffer).
     ///
-    /// @param instance       not used in the tbb kernel
-    ///                       (declared as a typed pointer to prevent
-    ///                        undesirable template resolution)
+    /// @param instance       optional evaluator instance scheduling the
+    ///                       evaluation in its task arena (see Options),
+    ///                       evaluated in the default task arena if NULL
     ///
     /// @param deviceContext  not used in the tbb kernel
     ///
@@ -77,20 +136,73 @@ public:
         TbbEvaluator const *instance = NULL,
         void *deviceContext = NULL) {
 
-        (void)instance;   // unused
         (void)deviceContext;  // unused
 
         if (stencilTable->GetNumStencils() == 0)
             return false;
 
+        // Passes refer to the vertices of the previous passes : they are
+        // evaluated in order (see Far::StencilTable::GetPassOffsets())
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            // unlike the cpu kernels, the tbb kernels index the output
+            // from the first stencil of the table
+            if (not EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                                 dstBuffer->BindCpuBuffer(), dstDesc,
+                                 &stencilTable->GetSizes()[0],
+                                 &stencilTable->GetOffsets()[0],
+                                 &stencilTable->GetControlIndices()[0],
+                                 &stencilTable->GetWeights()[0],
+                                 start, end, instance)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Generic static eval stencils function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    /// \note  Ranges of tables of several passes must not span passes, and
+    ///        are evaluated in the order of the passes (see
+    ///        Far::StencilTable::GetPassOffsets())
+    ///
+    /// @param start          index of the first stencil of the range
+    ///
+    /// @param end            index of the stencil following the range
+    ///
+    /// (see the evaluation of the whole table above for the other arguments)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        TbbEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)deviceContext;  // unused
+
+        if (end <= start) return true;
+
         return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
                             dstBuffer->BindCpuBuffer(), dstDesc,
                             &stencilTable->GetSizes()[0],
                             &stencilTable->GetOffsets()[0],
                             &stencilTable->GetControlIndices()[0],
                             &stencilTable->GetWeights()[0],
-                            /*start = */ 0,
-                            /*end   = */ stencilTable->GetNumStencils());
+                            start, end, instance);
     }
 
     /// \brief Static eval stencils function which takes raw CPU pointers for
@@ -120,6 +232,9 @@ public:
     ///
     /// @param end            end index of stencil table
     ///
+    /// @param instance       optional evaluator instance scheduling the
+    ///                       evaluation in its task arena (see Options)
+    ///
     static bool EvalStencils(
         const float *src, BufferDescriptor const &srcDesc,
         float *dst,       BufferDescriptor const &dstDesc,
@@ -127,7 +242,170 @@ public:
         const int *offsets,
         const int *indices,
         const float *weights,
-        int start, int end);
+        int start, int end,
+        TbbEvaluator const *instance = NULL);
+
+    /// \brief Generic static eval stencils function specialized at compile
+    ///        time for primvars of LENGTH floats, interleaved every SRC_STRIDE
+    ///        floats of the input buffer and every DST_STRIDE floats of the
+    ///        output buffer, e.g. EvalStencils<3, 3, 3>() for packed
+    ///        positions (see cpuFixedStencilKernel.h). Returns false if the
+    ///        descriptors do not describe this layout.
+    ///
+    /// (see the generic evaluation above for the arguments)
+    ///
+    template <int LENGTH, int SRC_STRIDE, int DST_STRIDE,
+              typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        TbbEvaluator const *instance = NULL) {
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            if (not EvalStencils<LENGTH, SRC_STRIDE, DST_STRIDE>(
+                    srcBuffer->BindCpuBuffer(), srcDesc,
+                    dstBuffer->BindCpuBuffer(), dstDesc,
+                    &stencilTable->GetSizes()[0],
+                    &stencilTable->GetOffsets()[0],
+                    &stencilTable->GetControlIndices()[0],
+                    &stencilTable->GetWeights()[0],
+                    start, end, instance)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Static eval stencils function specialized at compile time for
+    ///        a primvar layout (see above), which takes raw CPU pointers for
+    ///        input and output. As with the function of any layout, dst is
+    ///        indexed from the first stencil of the table.
+    ///
+    template <int LENGTH, int SRC_STRIDE, int DST_STRIDE>
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int *sizes,
+        const int *offsets,
+        const int *indices,
+        const float *weights,
+        int start, int end,
+        TbbEvaluator const *instance = NULL) {
+
+        if (end <= start) return true;
+        if (not IsFixedLayout<LENGTH, SRC_STRIDE>(srcDesc) or
+            not IsFixedLayout<LENGTH, DST_STRIDE>(dstDesc)) return false;
+
+        // the kernel is instantiated here, and dispatched over ranges of
+        // stencils by the library
+        evalFixedStencils(&CpuEvalFixedStencils<LENGTH, SRC_STRIDE, DST_STRIDE>,
+                          src + srcDesc.offset, dst + dstDesc.offset,
+                          DST_STRIDE, sizes, offsets, indices, weights,
+                          start, end, instance);
+        return true;
+    }
+
+    /// \brief Generic static eval stencils function for the instances of a
+    ///        mesh. The stencils of the table are applied to each instance
+    ///        in a single dispatch, the instances being located by offsets
+    ///        in the input and output buffers.
+    ///
+    /// @param srcBuffer       Input primvar buffer.
+    ///                        must have BindCpuBuffer() method returning a
+    ///                        const float pointer for read
+    ///
+    /// @param srcDesc         vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer       Output primvar buffer
+    ///                        must have BindCpuBuffer() method returning a
+    ///                        float pointer for write
+    ///
+    /// @param dstDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable    Far::StencilTable or equivalent, shared by the
+    ///                        instances
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance,
+    ///                        in floats, added to the offsets of srcDesc and
+    ///                        dstDesc
+    ///
+    /// @param instance        not used in the tbb kernel
+    ///                        (declared as a typed pointer to prevent
+    ///                         undesirable template resolution)
+    ///
+    /// @param deviceContext   not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsBatch(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int numInstances, int const * instanceOffsets,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        std::vector<Far::Index> const & passOffsets =
+            stencilTable->GetPassOffsets();
+
+        int numPasses = passOffsets.empty() ? 1 : (int)passOffsets.size();
+        for (int pass = 0; pass < numPasses; ++pass) {
+            int start = passOffsets.empty() ? 0 : passOffsets[pass];
+            int end = (pass+1 < numPasses) ? passOffsets[pass+1] :
+                                             stencilTable->GetNumStencils();
+
+            if (not EvalStencilsBatch(srcBuffer->BindCpuBuffer(), srcDesc,
+                                      dstBuffer->BindCpuBuffer(), dstDesc,
+                                      &stencilTable->GetSizes()[0],
+                                      &stencilTable->GetOffsets()[0],
+                                      &stencilTable->GetControlIndices()[0],
+                                      &stencilTable->GetWeights()[0],
+                                      start, end,
+                                      numInstances, instanceOffsets)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief Static eval stencils function for the instances of a mesh,
+    ///        which takes raw CPU pointers for input and output (see
+    ///        EvalStencils).
+    ///
+    /// @param numInstances    number of instances
+    ///
+    /// @param instanceOffsets (srcOffset, dstOffset) pair of each instance,
+    ///                        in floats, added to the offsets of srcDesc and
+    ///                        dstDesc
+    ///
+    static bool EvalStencilsBatch(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end,
+        int numInstances, const int * instanceOffsets);
 
     /// \brief Generic static eval stencils function with derivatives.
     ///        This function has a same signature as other device kernels
@@ -150,15 +428,641 @@ public:
     ///                       must have BindCpuBuffer() method returning a
     ///                       float pointer for write
     ///
-    /// @param duDesc         vertex buffer descriptor for the output buffer
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   stencil table to be applied.
+    ///
+    /// @param instance       not used in the tbb kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;   // unused
+        (void)deviceContext;   // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with derivatives, which takes
+    ///        raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output s-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output t-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///                       to apply for the range [start, end)
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param duWeights      pointer to the u-weights buffer of the stencil table
+    ///
+    /// @param dvWeights      pointer to the v-weights buffer of the stencil table
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function writing the unit normals
+    ///        and optional tangents of the limit surface rather than its
+    ///        derivatives (see CpuEvaluator::EvalStencilsWithNormals).
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilsWithNormals(
+        SRC_BUFFER *srcBuffer,     BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,     BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer,  BufferDescriptor const &normalDesc,
+        DST_BUFFER *tangentBuffer, BufferDescriptor const &tangentDesc,
+        STENCIL_TABLE const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencilsWithNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            normalBuffer->BindCpuBuffer(), normalDesc,
+            tangentBuffer ? tangentBuffer->BindCpuBuffer() : NULL, tangentDesc,
+            &stencilTable->GetSizes()[0],
+            &stencilTable->GetOffsets()[0],
+            &stencilTable->GetControlIndices()[0],
+            &stencilTable->GetWeights()[0],
+            &stencilTable->GetDuWeights()[0],
+            &stencilTable->GetDvWeights()[0],
+            /*start = */ 0,
+            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function writing the unit normals of the
+    ///        limit surface, which takes raw CPU pointers for input and
+    ///        output (see the generic function above).
+    ///
+    static bool EvalStencilsWithNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        float *tangent,   BufferDescriptor const &tangentDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with first and second
+    ///        derivatives, evaluated in a single pass over the control
+    ///        vertices of the stencils.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param duuBuffer      Output UU-derivative buffer
+    ///
+    /// @param duuDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duvBuffer      Output UV-derivative buffer
+    ///
+    /// @param duvDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvvBuffer      Output VV-derivative buffer
+    ///
+    /// @param dvvDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   Far::LimitStencilTable or equivalent (with
+    ///                       second derivatives)
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        DST_BUFFER *duuBuffer, BufferDescriptor const &duuDesc,
+        DST_BUFFER *duvBuffer, BufferDescriptor const &duvDesc,
+        DST_BUFFER *dvvBuffer, BufferDescriptor const &dvvDesc,
+        STENCIL_TABLE const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            duuBuffer->BindCpuBuffer(), duuDesc,
+                            duvBuffer->BindCpuBuffer(), duvDesc,
+                            dvvBuffer->BindCpuBuffer(), dvvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            &stencilTable->GetDuuWeights()[0],
+                            &stencilTable->GetDuvWeights()[0],
+                            &stencilTable->GetDvvWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with first and second
+    ///        derivatives, which takes raw CPU pointers for input and output
+    ///        (see the function with first derivatives).
+    ///
+    /// @param duu            Output UU-derivatives pointer. An offset of
+    ///                       duuDesc will be applied internally.
+    ///
+    /// @param duv            Output UV-derivatives pointer. An offset of
+    ///                       duvDesc will be applied internally.
+    ///
+    /// @param dvv            Output VV-derivatives pointer. An offset of
+    ///                       dvvDesc will be applied internally.
+    ///
+    /// @param duuWeights     pointer to the duu-weights buffer of the stencil table
+    ///
+    /// @param duvWeights     pointer to the duv-weights buffer of the stencil table
+    ///
+    /// @param dvvWeights     pointer to the dvv-weights buffer of the stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        float *duu,       BufferDescriptor const &duuDesc,
+        float *duv,       BufferDescriptor const &duvDesc,
+        float *dvv,       BufferDescriptor const &dvvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        const float * duuWeights,
+        const float * duvWeights,
+        const float * dvvWeights,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuPackedStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        packed for SIMD evaluation (see CpuPackedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable
+    ///
+    /// @param instance       not used in the tbb kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuPackedStencilTable const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*startBlock = */ 0,
+                            /*endBlock   = */ stencilTable->GetNumBlocks());
+    }
+
+    /// \brief Static eval stencils function for packed stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer, at the first stencil of
+    ///                       the table. An offset of dstDesc will be applied
+    ///                       internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable
+    ///
+    /// @param startBlock     first block of stencils to evaluate
+    ///
+    /// @param endBlock       end block of stencils to evaluate
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuPackedStencilTable const *stencilTable,
+        int startBlock, int endBlock);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        packed limit stencil tables (see CpuPackedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param instance       not used in the tbb kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuPackedStencilTable const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            stencilTable,
+                            /*startBlock = */ 0,
+                            /*endBlock   = */ stencilTable->GetNumBlocks());
+    }
+
+    /// \brief Static eval stencils function with derivatives for packed
+    ///        limit stencil tables, which takes raw CPU pointers for input
+    ///        and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output U-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output V-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuPackedStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param startBlock     first block of stencils to evaluate
+    ///
+    /// @param endBlock       end block of stencils to evaluate
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuPackedStencilTable const *stencilTable,
+        int startBlock, int endBlock);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuCompactStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        with a compact encoding (see CpuCompactStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param instance       not used in the tbb kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for compact stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        compact limit stencil tables (see CpuCompactStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output U-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dvBuffer       Output V-derivative buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param instance       not used in the tbb kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const TbbEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with derivatives for compact
+    ///        limit stencil tables, which takes raw CPU pointers for input
+    ///        and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output U-derivatives pointer. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param dv             Output V-derivatives pointer. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuInstancedStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for stencil tables
+    ///        sharing their weights (see CpuInstancedStencilTable).
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
     ///
-    /// @param dvBuffer       Output V-derivative buffer
+    /// @param dstBuffer      Output primvar buffer
     ///                       must have BindCpuBuffer() method returning a
     ///                       float pointer for write
     ///
-    /// @param dvDesc         vertex buffer descriptor for the output buffer
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param stencilTable   stencil table to be applied.
+    /// @param stencilTable   CpuInstancedStencilTable
     ///
     /// @param instance       not used in the tbb kernel
     ///                       (declared as a typed pointer to prevent
@@ -166,35 +1070,29 @@ public:
     ///
     /// @param deviceContext  not used in the tbb kernel
     ///
-    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    template <typename SRC_BUFFER, typename DST_BUFFER>
     static bool EvalStencils(
         SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
         DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
-        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
-        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
-        STENCIL_TABLE const *stencilTable,
+        CpuInstancedStencilTable const *stencilTable,
         const TbbEvaluator *instance = NULL,
         void * deviceContext = NULL) {
 
-        (void)instance;   // unused
-        (void)deviceContext;   // unused
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0)
+            return false;
 
         return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
                             dstBuffer->BindCpuBuffer(), dstDesc,
-                            duBuffer->BindCpuBuffer(),  duDesc,
-                            dvBuffer->BindCpuBuffer(),  dvDesc,
-                            &stencilTable->GetSizes()[0],
-                            &stencilTable->GetOffsets()[0],
-                            &stencilTable->GetControlIndices()[0],
-                            &stencilTable->GetWeights()[0],
-                            &stencilTable->GetDuWeights()[0],
-                            &stencilTable->GetDvWeights()[0],
+                            stencilTable,
                             /*start = */ 0,
                             /*end   = */ stencilTable->GetNumStencils());
     }
 
-    /// \brief Static eval stencils function with derivatives, which takes
-    ///        raw CPU pointers for input and output.
+    /// \brief Static eval stencils function for instanced stencil tables,
+    ///        which takes raw CPU pointers for input and output.
     ///
     /// @param src            Input primvar pointer. An offset of srcDesc
     ///                       will be applied internally (i.e. the pointer
@@ -207,44 +1105,16 @@ public:
     ///
     /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param du             Output s-derivatives pointer. An offset of
-    ///                       duDesc will be applied internally.
-    ///
-    /// @param duDesc         vertex buffer descriptor for the output buffer
-    ///
-    /// @param dv             Output t-derivatives pointer. An offset of
-    ///                       dvDesc will be applied internally.
-    ///
-    /// @param dvDesc         vertex buffer descriptor for the output buffer
-    ///
-    /// @param sizes          pointer to the sizes buffer of the stencil table
-    ///                       to apply for the range [start, end)
-    ///
-    /// @param offsets        pointer to the offsets buffer of the stencil table
-    ///
-    /// @param indices        pointer to the indices buffer of the stencil table
-    ///
-    /// @param weights        pointer to the weights buffer of the stencil table
-    ///
-    /// @param duWeights      pointer to the u-weights buffer of the stencil table
-    ///
-    /// @param dvWeights      pointer to the v-weights buffer of the stencil table
+    /// @param stencilTable   CpuInstancedStencilTable
     ///
     /// @param start          start index of stencil table
     ///
     /// @param end            end index of stencil table
     ///
     static bool EvalStencils(
-        const float *src, BufferDescriptor const &srcDesc,
-        float *dst,       BufferDescriptor const &dstDesc,
-        float *du,        BufferDescriptor const &duDesc,
-        float *dv,        BufferDescriptor const &dvDesc,
-        const int * sizes,
-        const int * offsets,
-        const int * indices,
-        const float * weights,
-        const float * duWeights,
-        const float * dvWeights,
+        const float *src,  BufferDescriptor const &srcDesc,
+        float *dst,        BufferDescriptor const &dstDesc,
+        CpuInstancedStencilTable const *stencilTable,
         int start, int end);
 
     /// ----------------------------------------------------------------------
@@ -454,6 +1324,349 @@ public:
         const int *patchIndexBuffer,
         const PatchParam *patchParamBuffer);
 
+    /// \brief Generic limit eval function with first and second derivatives,
+    ///        evaluated in a single pass over the control vertices of the
+    ///        patches (see the function with first derivatives).
+    ///
+    /// @param duuBuffer        Output UU-derivatives buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param duuDesc          vertex buffer descriptor for the duuBuffer
+    ///
+    /// @param duvBuffer        Output UV-derivatives buffer
+    ///
+    /// @param duvDesc          vertex buffer descriptor for the duvBuffer
+    ///
+    /// @param dvvBuffer        Output VV-derivatives buffer
+    ///
+    /// @param dvvDesc          vertex buffer descriptor for the dvvBuffer
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        DST_BUFFER *duuBuffer, BufferDescriptor const &duuDesc,
+        DST_BUFFER *duvBuffer, BufferDescriptor const &duvDesc,
+        DST_BUFFER *dvvBuffer, BufferDescriptor const &dvvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        TbbEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatches(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           duuBuffer->BindCpuBuffer(), duuDesc,
+                           duvBuffer->BindCpuBuffer(), duvDesc,
+                           dvvBuffer->BindCpuBuffer(), dvvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetPatchArrayBuffer(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function with first and second derivatives
+    ///        (see the function with first derivatives).
+    ///
+    /// @param duu              Output UU-derivatives pointer. An offset of
+    ///                         duuDesc will be applied internally.
+    ///
+    /// @param duv              Output UV-derivatives pointer. An offset of
+    ///                         duvDesc will be applied internally.
+    ///
+    /// @param dvv              Output VV-derivatives pointer. An offset of
+    ///                         dvvDesc will be applied internally.
+    ///
+    static bool EvalPatches(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        float *duu,       BufferDescriptor const &duuDesc,
+        float *duv,       BufferDescriptor const &duvDesc,
+        float *dvv,       BufferDescriptor const &dvvDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// \brief Generic limit eval function writing the unit normals and
+    ///        optional tangents of the limit surface rather than its
+    ///        derivatives (see CpuEvaluator::EvalPatchesWithNormals).
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesWithNormals(
+        SRC_BUFFER *srcBuffer,     BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,     BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer,  BufferDescriptor const &normalDesc,
+        DST_BUFFER *tangentBuffer, BufferDescriptor const &tangentDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        TbbEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesWithNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+            dstBuffer ? dstBuffer->BindCpuBuffer() : NULL, dstDesc,
+            normalBuffer->BindCpuBuffer(), normalDesc,
+            tangentBuffer ? tangentBuffer->BindCpuBuffer() : NULL, tangentDesc,
+            numPatchCoords,
+            (const PatchCoord*)patchCoords->BindCpuBuffer(),
+            patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+
+    /// \brief Static limit eval function writing the unit normals of the
+    ///        limit surface (see the generic function above).
+    ///
+    static bool EvalPatchesWithNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        float *tangent,   BufferDescriptor const &tangentDesc,
+        int numPatchCoords,
+        PatchCoord const *patchCoords,
+        PatchArray const *patchArrays,
+        const int *patchIndexBuffer,
+        PatchParam const *patchParamBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Face-varying limit evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic face-varying limit eval function. Evaluates the values
+    ///        of a face-varying channel at the same PatchCoords as the vertex
+    ///        primvars (see EvalPatches).
+    ///
+    /// @param srcBuffer        Input face-varying primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output face-varying primvar buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords   number of patchCoords.
+    ///
+    /// @param patchCoords      array of locations to be evaluated.
+    ///
+    /// @param patchTable       CpuPatchTable or equivalent
+    ///
+    /// @param fvarChannel      face-varying channel of the patch table
+    ///
+    /// @param instance         not used in the tbb evaluator
+    ///
+    /// @param deviceContext    not used in the tbb evaluator
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        TbbEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesFaceVarying(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Generic face-varying limit eval function with derivatives
+    ///        (see EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    static bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel = 0,
+        TbbEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalPatchesFaceVarying(srcBuffer->BindCpuBuffer(), srcDesc,
+                           dstBuffer->BindCpuBuffer(), dstDesc,
+                           duBuffer->BindCpuBuffer(),  duDesc,
+                           dvBuffer->BindCpuBuffer(),  dvDesc,
+                           numPatchCoords,
+                           (const PatchCoord*)patchCoords->BindCpuBuffer(),
+                           patchTable->GetFVarPatchArrayBuffer(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel));
+    }
+
+    /// \brief Static face-varying limit eval function. It takes an array of
+    ///        PatchCoord of the vertex patches and evaluates the limit values
+    ///        of a face-varying channel of a PatchTable : the coordinates are
+    ///        mapped to the patches of the channel and evaluated with the
+    ///        same blocks as the vertex patches.
+    ///
+    /// @param src                  Input face-varying primvar pointer. An
+    ///                             offset of srcDesc will be applied
+    ///                             internally
+    ///
+    /// @param srcDesc              vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst                  Output primvar pointer. An offset of
+    ///                             dstDesc will be applied internally.
+    ///
+    /// @param dstDesc              vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords       number of patchCoords.
+    ///
+    /// @param patchCoords          array of locations to be evaluated.
+    ///
+    /// @param fvarPatchArrays      patch arrays of the channel (see
+    ///                             CpuPatchTable::GetFVarPatchArrayBuffer)
+    ///
+    /// @param fvarPatchIndexBuffer face-varying values of the patches
+    ///
+    /// @param fvarPatchParamBuffer face-varying PatchParam of the patches
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndexBuffer,
+        const PatchParam *fvarPatchParamBuffer);
+
+    /// \brief Static face-varying limit eval function with derivatives (see
+    ///        EvalPatchesFaceVarying above and EvalPatches)
+    ///
+    static bool EvalPatchesFaceVarying(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        const PatchCoord *patchCoords,
+        const PatchArray *fvarPatchArrays,
+        const int *fvarPatchIndexBuffer,
+        const PatchParam *fvarPatchParamBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Surface samples with PtexAdjacency
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static surface sample function : moves the samples
+    ///        and maps them to PatchCoords in parallel (see
+    ///        CpuEvaluator::AdvectPatchCoords)
+    ///
+    template <typename PTEX_ADJACENCY, typename PATCH_MAP>
+    static bool AdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        PTEX_ADJACENCY *ptexAdjacency,
+        PatchCoord *patchCoords,
+        PATCH_MAP *patchMap,
+        TbbEvaluator const *instance = NULL,
+        void *deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return AdvectPatchCoords(numSamples, faceIds, u, v, velocities, step,
+                                 ptexAdjacency->GetNumFaces(),
+                                 ptexAdjacency->GetAdjacencyBuffer(),
+                                 patchCoords,
+                                 patchMap->GetNumFaces(),
+                                 patchMap->GetFaceBuffer(),
+                                 patchMap->GetNodeBuffer(),
+                                 patchMap->GetHandleBuffer());
+    }
+
+    /// \brief Static surface sample function which takes the raw buffers of
+    ///        a CpuPtexAdjacency and of a CpuPatchMap
+    ///
+    static bool AdvectPatchCoords(
+        int numSamples,
+        int *faceIds, float *u, float *v, float *velocities,
+        float step,
+        int numPtexFaces,
+        const int *adjacencyBuffer,
+        PatchCoord *patchCoords,
+        int numFaces,
+        const int *faceBuffer,
+        const unsigned int *nodeBuffer,
+        const int *handleBuffer);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Keyframe blending
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static keyframe blending function : interpolates the
+    ///        control vertices of an animation between two of its keyframes
+    ///        in parallel (see CpuEvaluator::BlendKeyframes)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool BlendKeyframes(
+        SRC_BUFFER *keyBuffer, BufferDescriptor const &keyDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight,
+        TbbEvaluator const *instance,
+        void *deviceContext) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return BlendKeyframes(keyBuffer->BindCpuBuffer(), keyDesc,
+                              dstBuffer->BindCpuBuffer(), dstDesc,
+                              numVertices, key0, key1, weight);
+    }
+
+    /// \brief Static keyframe blending function which takes raw CPU pointers
+    ///        for input and output
+    ///
+    static bool BlendKeyframes(
+        const float *keys, BufferDescriptor const &keyDesc,
+        float *dst, BufferDescriptor const &dstDesc,
+        int numVertices, int key0, int key1, float weight);
+
     /// ----------------------------------------------------------------------
     ///
     ///   Other methods
@@ -469,6 +1682,40 @@ public:
     /// @param numThreads      how many threads
     ///
     static void SetNumThreads(int numThreads);
+
+private:
+
+    TbbEvaluator(TbbEvaluator const &);
+    TbbEvaluator & operator=(TbbEvaluator const &);
+
+    // Evaluates the stencils [start, end) in the task arena of the instance
+    void evalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int *sizes,
+        const int *offsets,
+        const int *indices,
+        const float *weights,
+        int start, int end) const;
+
+    // Evaluates the stencils [start, end) with a kernel of a fixed layout,
+    // over ranges of equal numbers of weights (dst is indexed from the first
+    // stencil of the table)
+    static void evalFixedStencils(
+        CpuFixedStencilKernel kernel,
+        const float *src,
+        float *dst, int dstStride,
+        const int *sizes,
+        const int *offsets,
+        const int *indices,
+        const float *weights,
+        int start, int end,
+        TbbEvaluator const *instance);
+
+    struct Scheduler;  // task arena & affinity partitioners (tbbEvaluator.cpp)
+
+    Options     _options;
+    Scheduler * _scheduler;
 };
 
 
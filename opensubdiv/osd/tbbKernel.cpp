@@ -22,15 +22,19 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include "../osd/cpuEvaluator.h"
 #include "../osd/cpuKernel.h"
 #include "../osd/tbbKernel.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
 #include "../far/patchBasis.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -160,6 +164,90 @@ public:
     }
 };
 
+// Evaluates ranges of stencils of planar buffers with the CPU kernel : as
+// with TBBStencilKernel, dst is indexed from the first stencil of the table
+class TBBPlanarStencilKernel {
+
+    BufferDescriptor _srcDesc;
+    BufferDescriptor _dstDesc;
+    float const * _vertexSrc;
+    float * _vertexDst;
+
+    int const * _sizes;
+    int const * _offsets,
+              * _indices;
+    float const * _weights;
+
+public:
+    TBBPlanarStencilKernel(float const *src, BufferDescriptor srcDesc,
+                           float *dst,       BufferDescriptor dstDesc,
+                           int const * sizes, int const * offsets,
+                           int const * indices, float const * weights) :
+         _srcDesc(srcDesc),
+         _dstDesc(dstDesc),
+         _vertexSrc(src),
+         _vertexDst(dst),
+         _sizes(sizes),
+         _offsets(offsets),
+         _indices(indices),
+         _weights(weights) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+
+        BufferDescriptor rangeDesc = _dstDesc;
+        rangeDesc.offset += r.begin() * _dstDesc.stride;
+
+        CpuEvalStencils(_vertexSrc, _srcDesc, _vertexDst, rangeDesc,
+                        _sizes, _offsets, _indices, _weights,
+                        r.begin(), r.end());
+    }
+};
+
+// Evaluates the ranges of stencils [bounds[i], bounds[i+1]) with a
+// TBBStencilKernel (or TBBStencilBatchKernel)
+template <class KERNEL>
+class TBBStencilRangesKernel {
+
+    KERNEL const * _kernel;
+    int const * _bounds;
+
+public:
+    TBBStencilRangesKernel(KERNEL const * kernel,
+                           int const * bounds) :
+        _kernel(kernel), _bounds(bounds) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+        for (int i = r.begin(); i < r.end(); ++i) {
+            if (_bounds[i] < _bounds[i+1]) {
+                (*_kernel)(tbb::blocked_range<int>(_bounds[i], _bounds[i+1]));
+            }
+        }
+    }
+};
+
+// The stencils are split into ranges of equal numbers of weights rather than
+// of stencils, as their sizes vary widely from a level of a table to the
+// next : a few ranges per thread let the scheduler even out the remaining
+// differences in cost
+static int const stencilRangesPerThread = 4;
+
+template <class KERNEL>
+static void
+evalStencilRanges(KERNEL const & kernel,
+                  int const * sizes, int const * offsets,
+                  int start, int end) {
+
+    int numRanges = std::min(end - start, stencilRangesPerThread *
+                             tbb::this_task_arena::max_concurrency());
+    if (numRanges < 1) return;
+
+    std::vector<int> bounds(numRanges + 1);
+    CpuGetStencilRanges(sizes, offsets, start, end, numRanges, &bounds[0]);
+
+    tbb::parallel_for(tbb::blocked_range<int>(0, numRanges, 1),
+                      TBBStencilRangesKernel<KERNEL>(&kernel, &bounds[0]));
+}
+
 void
 TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -169,15 +257,129 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end) {
 
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) {
+        TBBPlanarStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                      sizes, offsets, indices, weights);
+        tbb::blocked_range<int> range(start, end, grain_size);
+        tbb::parallel_for(range, kernel);
+        return;
+    }
+
     src += srcDesc.offset;
     dst += dstDesc.offset;
 
     TBBStencilKernel kernel(src, srcDesc, dst, dstDesc,
                             sizes, offsets, indices, weights);
 
-    tbb::blocked_range<int> range(start, end, grain_size);
+    evalStencilRanges(kernel, sizes, offsets, start, end);
+}
 
-    tbb::parallel_for(range, kernel);
+void
+TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                int start, int end,
+                int grainSize,
+                tbb::affinity_partitioner * partitioner) {
+
+    tbb::blocked_range<int> range(start, end, std::max(grainSize, 1));
+
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar()) {
+        TBBPlanarStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                      sizes, offsets, indices, weights);
+        if (grainSize >= (end-start)) {
+            kernel(range);
+        } else if (partitioner) {
+            tbb::parallel_for(range, kernel, *partitioner);
+        } else {
+            tbb::parallel_for(range, kernel);
+        }
+        return;
+    }
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+
+    TBBStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                            sizes, offsets, indices, weights);
+
+    if (grainSize >= (end-start)) {
+        // not worth spawning tasks : evaluate the range on the calling thread
+        kernel(range);
+    } else if (partitioner) {
+        tbb::parallel_for(range, kernel, *partitioner);
+    } else {
+        tbb::parallel_for(range, kernel);
+    }
+}
+
+class TBBStencilBatchKernel {
+
+    BufferDescriptor _srcDesc;
+    BufferDescriptor _dstDesc;
+    float const * _vertexSrc;
+    float * _vertexDst;
+
+    int const * _sizes;
+    int const * _offsets,
+              * _indices;
+    float const * _weights;
+
+    int _start;
+    int _numInstances;
+    int const * _instanceOffsets;
+
+public:
+    TBBStencilBatchKernel(float const *src, BufferDescriptor srcDesc,
+                          float *dst,       BufferDescriptor dstDesc,
+                          int const * sizes, int const * offsets,
+                          int const * indices, float const * weights,
+                          int start,
+                          int numInstances, int const * instanceOffsets) :
+         _srcDesc(srcDesc),
+         _dstDesc(dstDesc),
+         _vertexSrc(src),
+         _vertexDst(dst),
+         _sizes(sizes),
+         _offsets(offsets),
+         _indices(indices),
+         _weights(weights),
+         _start(start),
+         _numInstances(numInstances),
+         _instanceOffsets(instanceOffsets) { }
+
+    // each range of stencils is evaluated for all the instances in a single
+    // pass (see CpuEvalStencilsBatch)
+    void operator() (tbb::blocked_range<int> const &r) const {
+
+        BufferDescriptor rangeDesc = _dstDesc;
+        rangeDesc.offset += (r.begin() - _start) * _dstDesc.stride;
+
+        CpuEvalStencilsBatch(_vertexSrc, _srcDesc, _vertexDst, rangeDesc,
+                             _sizes, _offsets, _indices, _weights,
+                             r.begin(), r.end(),
+                             _numInstances, _instanceOffsets);
+    }
+};
+
+void
+TbbEvalStencilsBatch(float const * src, BufferDescriptor const &srcDesc,
+                     float * dst,       BufferDescriptor const &dstDesc,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances, int const * instanceOffsets) {
+
+    TBBStencilBatchKernel kernel(src, srcDesc, dst, dstDesc,
+                                 sizes, offsets, indices, weights,
+                                 start, numInstances, instanceOffsets);
+
+    evalStencilRanges(kernel, sizes, offsets, start, end);
 }
 
 void
@@ -193,6 +395,25 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvWeights,
                 int start, int end) {
 
+    if (srcDesc.IsPlanar() or dstDesc.IsPlanar() or
+        duDesc.IsPlanar() or dvDesc.IsPlanar()) {
+        // each output streams through its own planes
+        tbb::blocked_range<int> range(start, end, grain_size);
+        if (dst) {
+            tbb::parallel_for(range, TBBPlanarStencilKernel(src, srcDesc,
+                dst, dstDesc, sizes, offsets, indices, weights));
+        }
+        if (du) {
+            tbb::parallel_for(range, TBBPlanarStencilKernel(src, srcDesc,
+                du, duDesc, sizes, offsets, indices, duWeights));
+        }
+        if (dv) {
+            tbb::parallel_for(range, TBBPlanarStencilKernel(src, srcDesc,
+                dv, dvDesc, sizes, offsets, indices, dvWeights));
+        }
+        return;
+    }
+
     if (src) src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
     if (du)  du  += duDesc.offset;
@@ -202,23 +423,508 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     if (dst) {
         TBBStencilKernel kernel(src, srcDesc, dst, dstDesc,
                                 sizes, offsets, indices, weights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
+        evalStencilRanges(kernel, sizes, offsets, start, end);
     }
 
     if (du) {
         TBBStencilKernel kernel(src, srcDesc, du, duDesc,
                                 sizes, offsets, indices, duWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
+        evalStencilRanges(kernel, sizes, offsets, start, end);
     }
 
     if (dv) {
         TBBStencilKernel kernel(src, srcDesc, dv, dvDesc,
                                 sizes, offsets, indices, dvWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
+        evalStencilRanges(kernel, sizes, offsets, start, end);
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+// Offsets an optional output pointer by 'n' elements
+static inline float *
+offsetElements(float * p, int n, BufferDescriptor const & desc) {
+    return p ? p + n * desc.stride : NULL;
+}
+
+// The outputs of the first and second derivatives are accumulated together
+// by the CPU kernels, over ranges of stencils or patch coordinates
+class TBBSecondDerivKernel {
+
+    enum { NUM_OUTPUTS = 6 };
+
+    float const * _src;
+    BufferDescriptor _srcDesc;
+    float * _dst[NUM_OUTPUTS];
+    BufferDescriptor _dstDesc[NUM_OUTPUTS];
+
+    // stencils
+    int const * _sizes;
+    int const * _offsets,
+              * _indices;
+    float const * _weights[NUM_OUTPUTS];
+
+    // patches
+    PatchCoord const * _patchCoords;
+    PatchArray const * _patchArrayBuffer;
+    int const *        _patchIndexBuffer;
+    PatchParam const * _patchParamBuffer;
+
+public:
+    TBBSecondDerivKernel(float const * src, BufferDescriptor const & srcDesc,
+                         float * const dst[NUM_OUTPUTS],
+                         BufferDescriptor const * const dstDesc[NUM_OUTPUTS]) :
+        _src(src), _srcDesc(srcDesc),
+        _sizes(0), _offsets(0), _indices(0),
+        _patchCoords(0), _patchArrayBuffer(0),
+        _patchIndexBuffer(0), _patchParamBuffer(0) {
+
+        for (int i = 0; i < NUM_OUTPUTS; ++i) {
+            _dst[i] = dst[i];
+            _dstDesc[i] = *dstDesc[i];
+            _weights[i] = 0;
+        }
+    }
+
+    void SetStencils(int const * sizes, int const * offsets,
+                     int const * indices,
+                     float const * const weights[NUM_OUTPUTS]) {
+        _sizes = sizes;
+        _offsets = offsets;
+        _indices = indices;
+        for (int i = 0; i < NUM_OUTPUTS; ++i) {
+            _weights[i] = weights[i];
+        }
+    }
+
+    void SetPatches(PatchCoord const * patchCoords,
+                    PatchArray const * patchArrayBuffer,
+                    int const * patchIndexBuffer,
+                    PatchParam const * patchParamBuffer) {
+        _patchCoords = patchCoords;
+        _patchArrayBuffer = patchArrayBuffer;
+        _patchIndexBuffer = patchIndexBuffer;
+        _patchParamBuffer = patchParamBuffer;
+    }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+
+        // outputs are indexed from the first stencil or coordinate
+        int n = r.begin();
+
+        float * dst[NUM_OUTPUTS];
+        for (int i = 0; i < NUM_OUTPUTS; ++i) {
+            dst[i] = offsetElements(_dst[i], n, _dstDesc[i]);
+        }
+
+        if (_patchCoords) {
+            CpuEvalPatches(_src, _srcDesc,
+                           dst[0], _dstDesc[0], dst[1], _dstDesc[1],
+                           dst[2], _dstDesc[2], dst[3], _dstDesc[3],
+                           dst[4], _dstDesc[4], dst[5], _dstDesc[5],
+                           r.end() - r.begin(), _patchCoords + n,
+                           _patchArrayBuffer, _patchIndexBuffer,
+                           _patchParamBuffer);
+        } else {
+            CpuEvalStencils(_src, _srcDesc,
+                            dst[0], _dstDesc[0], dst[1], _dstDesc[1],
+                            dst[2], _dstDesc[2], dst[3], _dstDesc[3],
+                            dst[4], _dstDesc[4], dst[5], _dstDesc[5],
+                            _sizes, _offsets, _indices,
+                            _weights[0], _weights[1], _weights[2],
+                            _weights[3], _weights[4], _weights[5],
+                            r.begin(), r.end());
+        }
+    }
+};
+
+void
+TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                float * du,        BufferDescriptor const &duDesc,
+                float * dv,        BufferDescriptor const &dvDesc,
+                float * duu,       BufferDescriptor const &duuDesc,
+                float * duv,       BufferDescriptor const &duvDesc,
+                float * dvv,       BufferDescriptor const &dvvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                float const * duuWeights,
+                float const * duvWeights,
+                float const * dvvWeights,
+                int start, int end) {
+
+    float * outputs[6] = { dst, du, dv, duu, duv, dvv };
+    BufferDescriptor const * descs[6] =
+        { &dstDesc, &duDesc, &dvDesc, &duuDesc, &duvDesc, &dvvDesc };
+    float const * outWeights[6] =
+        { weights, duWeights, dvWeights, duuWeights, duvWeights, dvvWeights };
+
+    TBBSecondDerivKernel kernel(src, srcDesc, outputs, descs);
+    kernel.SetStencils(sizes, offsets, indices, outWeights);
+
+    tbb::blocked_range<int> range(start, end, grain_size);
+    tbb::parallel_for(range, kernel);
+}
+
+// The normals and tangents of the limit surface are computed by the CPU
+// kernels from the derivatives they accumulate, over ranges of stencils or
+// patch coordinates
+class TBBNormalKernel {
+
+    float const * _src;
+    BufferDescriptor _srcDesc;
+    float * _dst,
+          * _normal,
+          * _tangent;
+    BufferDescriptor _dstDesc,
+                     _normalDesc,
+                     _tangentDesc;
+
+    // stencils
+    int const * _sizes;
+    int const * _offsets,
+              * _indices;
+    float const * _weights,
+                * _duWeights,
+                * _dvWeights;
+
+    // patches
+    PatchCoord const * _patchCoords;
+    PatchArray const * _patchArrayBuffer;
+    int const *        _patchIndexBuffer;
+    PatchParam const * _patchParamBuffer;
+
+public:
+    TBBNormalKernel(float const * src, BufferDescriptor const & srcDesc,
+                    float * dst,       BufferDescriptor const & dstDesc,
+                    float * normal,    BufferDescriptor const & normalDesc,
+                    float * tangent,   BufferDescriptor const & tangentDesc) :
+        _src(src), _srcDesc(srcDesc),
+        _dst(dst), _normal(normal), _tangent(tangent),
+        _dstDesc(dstDesc), _normalDesc(normalDesc), _tangentDesc(tangentDesc),
+        _sizes(0), _offsets(0), _indices(0),
+        _weights(0), _duWeights(0), _dvWeights(0),
+        _patchCoords(0), _patchArrayBuffer(0),
+        _patchIndexBuffer(0), _patchParamBuffer(0) { }
+
+    void SetStencils(int const * sizes, int const * offsets,
+                     int const * indices, float const * weights,
+                     float const * duWeights, float const * dvWeights) {
+        _sizes = sizes;
+        _offsets = offsets;
+        _indices = indices;
+        _weights = weights;
+        _duWeights = duWeights;
+        _dvWeights = dvWeights;
+    }
+
+    void SetPatches(PatchCoord const * patchCoords,
+                    PatchArray const * patchArrayBuffer,
+                    int const * patchIndexBuffer,
+                    PatchParam const * patchParamBuffer) {
+        _patchCoords = patchCoords;
+        _patchArrayBuffer = patchArrayBuffer;
+        _patchIndexBuffer = patchIndexBuffer;
+        _patchParamBuffer = patchParamBuffer;
     }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+
+        // outputs are indexed from the first stencil or coordinate
+        int n = r.begin();
+
+        float * dst = offsetElements(_dst, n, _dstDesc),
+              * normal = offsetElements(_normal, n, _normalDesc),
+              * tangent = offsetElements(_tangent, n, _tangentDesc);
+
+        if (_patchCoords) {
+            CpuEvalPatchNormals(_src, _srcDesc,
+                                dst, _dstDesc,
+                                normal, _normalDesc,
+                                tangent, _tangentDesc,
+                                r.end() - r.begin(), _patchCoords + n,
+                                _patchArrayBuffer, _patchIndexBuffer,
+                                _patchParamBuffer);
+        } else {
+            CpuEvalStencilNormals(_src, _srcDesc,
+                                  dst, _dstDesc,
+                                  normal, _normalDesc,
+                                  tangent, _tangentDesc,
+                                  _sizes, _offsets, _indices,
+                                  _weights, _duWeights, _dvWeights,
+                                  r.begin(), r.end());
+        }
+    }
+};
+
+void
+TbbEvalStencilNormals(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * normal,    BufferDescriptor const &normalDesc,
+                      float * tangent,   BufferDescriptor const &tangentDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int start, int end) {
+
+    TBBNormalKernel kernel(src, srcDesc, dst, dstDesc,
+                           normal, normalDesc, tangent, tangentDesc);
+    kernel.SetStencils(sizes, offsets, indices,
+                       weights, duWeights, dvWeights);
+
+    tbb::blocked_range<int> range(start, end, grain_size);
+    tbb::parallel_for(range, kernel);
+}
+
+void
+TbbEvalPatchNormals(float const *src, BufferDescriptor const &srcDesc,
+                    float *dst,       BufferDescriptor const &dstDesc,
+                    float *normal,    BufferDescriptor const &normalDesc,
+                    float *tangent,   BufferDescriptor const &tangentDesc,
+                    int numPatchCoords,
+                    const PatchCoord *patchCoords,
+                    const PatchArray *patchArrayBuffer,
+                    const int *patchIndexBuffer,
+                    const PatchParam *patchParamBuffer) {
+
+    TBBNormalKernel kernel(src, srcDesc, dst, dstDesc,
+                           normal, normalDesc, tangent, tangentDesc);
+    kernel.SetPatches(patchCoords, patchArrayBuffer,
+                      patchIndexBuffer, patchParamBuffer);
+
+    tbb::blocked_range<int> range(0, numPatchCoords, grain_size);
+    tbb::parallel_for(range, kernel);
+}
+
+// ---------------------------------------------------------------------------
+
+// Ranges of blocks of packed stencils, large enough to amortize the dispatch
+// of the SIMD kernels
+#define packed_grain_size  16
+
+class TBBPackedStencilKernel {
+
+    BufferDescriptor _srcDesc,
+                     _dstDesc,
+                     _dstDuDesc,
+                     _dstDvDesc;
+    float const * _src;
+    float * _dst,
+          * _dstDu,
+          * _dstDv;
+
+    int _blockWidth;
+    int const * _blockOffsets,
+              * _indices;
+    float const * _weights,
+                * _duWeights,
+                * _dvWeights;
+    int _numStencils;
+
+public:
+    TBBPackedStencilKernel(float const *src, BufferDescriptor srcDesc,
+                           float *dst,       BufferDescriptor dstDesc,
+                           float *dstDu,     BufferDescriptor dstDuDesc,
+                           float *dstDv,     BufferDescriptor dstDvDesc,
+                           int blockWidth, int const * blockOffsets,
+                           int const * indices, float const * weights,
+                           float const * duWeights, float const * dvWeights,
+                           int numStencils) :
+        _srcDesc(srcDesc), _dstDesc(dstDesc),
+        _dstDuDesc(dstDuDesc), _dstDvDesc(dstDvDesc),
+        _src(src), _dst(dst), _dstDu(dstDu), _dstDv(dstDv),
+        _blockWidth(blockWidth),
+        _blockOffsets(blockOffsets),
+        _indices(indices),
+        _weights(weights),
+        _duWeights(duWeights),
+        _dvWeights(dvWeights),
+        _numStencils(numStencils) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+        if (_dstDu == NULL && _dstDv == NULL) {
+            CpuEvalPackedStencils(_src, _srcDesc, _dst, _dstDesc,
+                _blockWidth, _blockOffsets, _indices, _weights,
+                _numStencils, r.begin(), r.end());
+        } else {
+            CpuEvalPackedStencils(_src, _srcDesc, _dst, _dstDesc,
+                _dstDu, _dstDuDesc, _dstDv, _dstDvDesc,
+                _blockWidth, _blockOffsets, _indices,
+                _weights, _duWeights, _dvWeights,
+                _numStencils, r.begin(), r.end());
+        }
+    }
+};
+
+void
+TbbEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils,
+                      int startBlock, int endBlock) {
+
+    TBBPackedStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                  NULL, BufferDescriptor(),
+                                  NULL, BufferDescriptor(),
+                                  blockWidth, blockOffsets, indices,
+                                  weights, NULL, NULL, numStencils);
+
+    tbb::blocked_range<int> range(startBlock, endBlock, packed_grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
+void
+TbbEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstDu,     BufferDescriptor const &dstDuDesc,
+                      float * dstDv,     BufferDescriptor const &dstDvDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils,
+                      int startBlock, int endBlock) {
+
+    TBBPackedStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                  dstDu, dstDuDesc, dstDv, dstDvDesc,
+                                  blockWidth, blockOffsets, indices,
+                                  weights, duWeights, dvWeights, numStencils);
+
+    tbb::blocked_range<int> range(startBlock, endBlock, packed_grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
+class TBBCompactStencilKernel {
+
+    BufferDescriptor _srcDesc,
+                     _dstDesc,
+                     _dstDuDesc,
+                     _dstDvDesc;
+    float const * _src;
+    float * _dst,
+          * _dstDu,
+          * _dstDv;
+
+    CpuCompactStencilTable const * _stencilTable;
+    int _start;
+
+public:
+    TBBCompactStencilKernel(float const *src, BufferDescriptor srcDesc,
+                            float *dst,       BufferDescriptor dstDesc,
+                            float *dstDu,     BufferDescriptor dstDuDesc,
+                            float *dstDv,     BufferDescriptor dstDvDesc,
+                            CpuCompactStencilTable const * stencilTable,
+                            int start) :
+        _srcDesc(srcDesc), _dstDesc(dstDesc),
+        _dstDuDesc(dstDuDesc), _dstDvDesc(dstDvDesc),
+        _src(src), _dst(dst), _dstDu(dstDu), _dstDv(dstDv),
+        _stencilTable(stencilTable),
+        _start(start) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+        // destinations are indexed from the first stencil of the range
+        int ofs = r.begin() - _start;
+        if (_dstDu == NULL && _dstDv == NULL) {
+            CpuEvalCompactStencils(_src, _srcDesc,
+                elementAtIndex(_dst, ofs, _dstDesc), _dstDesc,
+                *_stencilTable, r.begin(), r.end());
+        } else {
+            CpuEvalCompactStencils(_src, _srcDesc,
+                elementAtIndex(_dst,   ofs, _dstDesc),   _dstDesc,
+                elementAtIndex(_dstDu, ofs, _dstDuDesc), _dstDuDesc,
+                elementAtIndex(_dstDv, ofs, _dstDvDesc), _dstDvDesc,
+                *_stencilTable, r.begin(), r.end());
+        }
+    }
+};
+
+void
+TbbEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end) {
+
+    TBBCompactStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                   NULL, BufferDescriptor(),
+                                   NULL, BufferDescriptor(),
+                                   &stencilTable, start);
+
+    tbb::blocked_range<int> range(start, end, grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
+void
+TbbEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       float * dstDu,     BufferDescriptor const &dstDuDesc,
+                       float * dstDv,     BufferDescriptor const &dstDvDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end) {
+
+    TBBCompactStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                   dstDu, dstDuDesc, dstDv, dstDvDesc,
+                                   &stencilTable, start);
+
+    tbb::blocked_range<int> range(start, end, grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
+class TBBInstancedStencilKernel {
+
+    BufferDescriptor _srcDesc,
+                     _dstDesc;
+    float const * _src;
+    float * _dst;
+
+    CpuInstancedStencilTable const * _stencilTable;
+    int _start;
+
+public:
+    TBBInstancedStencilKernel(float const *src, BufferDescriptor srcDesc,
+                              float *dst,       BufferDescriptor dstDesc,
+                              CpuInstancedStencilTable const * stencilTable,
+                              int start) :
+        _srcDesc(srcDesc), _dstDesc(dstDesc),
+        _src(src), _dst(dst),
+        _stencilTable(stencilTable),
+        _start(start) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+        // destinations are indexed from the first stencil of the range
+        CpuEvalInstancedStencils(_src, _srcDesc,
+            elementAtIndex(_dst, r.begin() - _start, _dstDesc), _dstDesc,
+            *_stencilTable, r.begin(), r.end());
+    }
+};
+
+void
+TbbEvalInstancedStencils(float const * src, BufferDescriptor const &srcDesc,
+                         float * dst,       BufferDescriptor const &dstDesc,
+                         CpuInstancedStencilTable const & stencilTable,
+                         int start, int end) {
+
+    TBBInstancedStencilKernel kernel(src, srcDesc, dst, dstDesc,
+                                     &stencilTable, start);
+
+    tbb::blocked_range<int> range(start, end, grain_size);
+
+    tbb::parallel_for(range, kernel);
 }
 
 // ---------------------------------------------------------------------------
@@ -333,6 +1039,14 @@ public:
                 Far::internal::GetBilinearWeights(param,
                                                   coord.s, coord.t, wP, wDs, wDt);
                 numControlVertices = 4;
+            } else if (patchType == Far::PatchDescriptor::LOOP) {
+                Far::internal::GetLoopWeights(param,
+                                              coord.s, coord.t, wP, wDs, wDt);
+                numControlVertices = 12;
+            } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+                Far::internal::GetTriangleWeights(param,
+                                                  coord.s, coord.t, wP, wDs, wDt);
+                numControlVertices = 3;
             } else {
                 assert(0);
             }
@@ -387,6 +1101,14 @@ public:
                 Far::internal::GetBilinearWeights(param,
                                                   coord.s, coord.t, wP, wDs, wDt);
                 numControlVertices = 4;
+            } else if (patchType == Far::PatchDescriptor::LOOP) {
+                Far::internal::GetLoopWeights(param,
+                                              coord.s, coord.t, wP, wDs, wDt);
+                numControlVertices = 12;
+            } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+                Far::internal::GetTriangleWeights(param,
+                                                  coord.s, coord.t, wP, wDs, wDt);
+                numControlVertices = 3;
             } else {
                 assert(0);
             }
@@ -433,6 +1155,127 @@ TbbEvalPatches(float const *src, BufferDescriptor const &srcDesc,
 
 }
 
+void
+TbbEvalPatches(float const *src, BufferDescriptor const &srcDesc,
+               float *dst,       BufferDescriptor const &dstDesc,
+               float *dstDu,     BufferDescriptor const &dstDuDesc,
+               float *dstDv,     BufferDescriptor const &dstDvDesc,
+               float *dstDuu,    BufferDescriptor const &dstDuuDesc,
+               float *dstDuv,    BufferDescriptor const &dstDuvDesc,
+               float *dstDvv,    BufferDescriptor const &dstDvvDesc,
+               int numPatchCoords,
+               const PatchCoord *patchCoords,
+               const PatchArray *patchArrayBuffer,
+               const int *patchIndexBuffer,
+               const PatchParam *patchParamBuffer) {
+
+    float * outputs[6] = { dst, dstDu, dstDv, dstDuu, dstDuv, dstDvv };
+    BufferDescriptor const * descs[6] = { &dstDesc, &dstDuDesc, &dstDvDesc,
+                                          &dstDuuDesc, &dstDuvDesc, &dstDvvDesc };
+
+    TBBSecondDerivKernel kernel(src, srcDesc, outputs, descs);
+    kernel.SetPatches(patchCoords, patchArrayBuffer,
+                      patchIndexBuffer, patchParamBuffer);
+
+    tbb::blocked_range<int> range(0, numPatchCoords, grain_size);
+    tbb::parallel_for(range, kernel);
+}
+
+class TbbAdvectPatchCoordsKernel {
+    int *_faceIds;
+    float *_u, *_v, *_velocities;
+    float _step;
+    int _numPtexFaces;
+    const int *_adjacencyBuffer;
+    PatchCoord *_patchCoords;
+    int _numFaces;
+    const int *_faceBuffer;
+    const unsigned int *_nodeBuffer;
+    const int *_handleBuffer;
+
+public:
+    TbbAdvectPatchCoordsKernel(int *faceIds, float *u, float *v,
+                               float *velocities, float step,
+                               int numPtexFaces, const int *adjacencyBuffer,
+                               PatchCoord *patchCoords,
+                               int numFaces, const int *faceBuffer,
+                               const unsigned int *nodeBuffer,
+                               const int *handleBuffer) :
+        _faceIds(faceIds), _u(u), _v(v), _velocities(velocities),
+        _step(step), _numPtexFaces(numPtexFaces),
+        _adjacencyBuffer(adjacencyBuffer), _patchCoords(patchCoords),
+        _numFaces(numFaces), _faceBuffer(faceBuffer),
+        _nodeBuffer(nodeBuffer), _handleBuffer(handleBuffer) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+        CpuAdvectSamples(r.begin(), r.end(), _faceIds, _u, _v, _velocities,
+                         _step, _numPtexFaces, _adjacencyBuffer);
+
+        int start = r.begin();
+        CpuEvaluator::FindPatchCoords(r.end() - start,
+                                      _faceIds + start, _u + start, _v + start,
+                                      _patchCoords + start,
+                                      _numFaces, _faceBuffer,
+                                      _nodeBuffer, _handleBuffer);
+    }
+};
+
+void
+TbbAdvectPatchCoords(int numSamples,
+                     int *faceIds, float *u, float *v, float *velocities,
+                     float step,
+                     int numPtexFaces, const int *adjacencyBuffer,
+                     PatchCoord *patchCoords,
+                     int numFaces, const int *faceBuffer,
+                     const unsigned int *nodeBuffer,
+                     const int *handleBuffer) {
+
+    TbbAdvectPatchCoordsKernel kernel(faceIds, u, v, velocities, step,
+                                      numPtexFaces, adjacencyBuffer,
+                                      patchCoords, numFaces, faceBuffer,
+                                      nodeBuffer, handleBuffer);
+
+    tbb::blocked_range<int> range(0, numSamples, grain_size);
+    tbb::parallel_for(range, kernel);
+}
+
+class TbbBlendKeyframesKernel {
+    float const *_keys;
+    BufferDescriptor _keyDesc;
+    float *_dst;
+    BufferDescriptor _dstDesc;
+    int _numVertices, _key0, _key1;
+    float _weight;
+
+public:
+    TbbBlendKeyframesKernel(float const *keys,
+                            BufferDescriptor const &keyDesc,
+                            float *dst, BufferDescriptor const &dstDesc,
+                            int numVertices, int key0, int key1,
+                            float weight) :
+        _keys(keys), _keyDesc(keyDesc), _dst(dst), _dstDesc(dstDesc),
+        _numVertices(numVertices), _key0(key0), _key1(key1),
+        _weight(weight) { }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+        CpuBlendKeyframes(_keys, _keyDesc, _dst, _dstDesc,
+                          _numVertices, _key0, _key1, _weight,
+                          r.begin(), r.end());
+    }
+};
+
+void
+TbbBlendKeyframes(float const *keys, BufferDescriptor const &keyDesc,
+                  float *dst, BufferDescriptor const &dstDesc,
+                  int numVertices, int key0, int key1, float weight) {
+
+    TbbBlendKeyframesKernel kernel(keys, keyDesc, dst, dstDesc,
+                                   numVertices, key0, key1, weight);
+
+    tbb::blocked_range<int> range(0, numVertices, grain_size);
+    tbb::parallel_for(range, kernel);
+}
+
 }  // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
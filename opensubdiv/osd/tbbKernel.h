@@ -27,6 +27,8 @@
 
 #include "../version.h"
 
+#include <tbb/partitioner.h>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -36,6 +38,8 @@ struct PatchArray;
 struct PatchCoord;
 struct PatchParam;
 struct BufferDescriptor;
+class CpuCompactStencilTable;
+class CpuInstancedStencilTable;
 
 void
 TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
@@ -46,6 +50,32 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end);
 
+// Evaluates the stencils [start, end) over sub-ranges of 'grainSize'
+// stencils (serially if the range does not exceed 'grainSize'), mapped to
+// the threads of the previous evaluations by 'partitioner' if not NULL
+void
+TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                int start, int end,
+                int grainSize,
+                tbb::affinity_partitioner * partitioner);
+
+// Evaluates the stencils [start, end) for each instance, located by the
+// (srcOffset, dstOffset) pairs of instanceOffsets
+void
+TbbEvalStencilsBatch(float const * src, BufferDescriptor const &srcDesc,
+                     float * dst,       BufferDescriptor const &dstDesc,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end,
+                     int numInstances, int const * instanceOffsets);
+
 void
 TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -59,17 +89,144 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvWeights,
                 int start, int end);
 
+// Evaluates the stencils with first and second derivatives in a single pass
+// over their control vertices (see CpuEvalStencils)
+void
+TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                float * dstDu,     BufferDescriptor const &dstDuDesc,
+                float * dstDv,     BufferDescriptor const &dstDvDesc,
+                float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+                float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+                float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                float const * duuWeights,
+                float const * duvWeights,
+                float const * dvvWeights,
+                int start, int end);
+
+// Evaluates the unit normals and optional tangents of limit stencils (see
+// CpuEvalStencilNormals)
+void
+TbbEvalStencilNormals(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * normal,    BufferDescriptor const &normalDesc,
+                      float * tangent,   BufferDescriptor const &tangentDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int start, int end);
+
+void
+TbbEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      int numStencils,
+                      int startBlock, int endBlock);
+
+void
+TbbEvalPackedStencils(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstDu,     BufferDescriptor const &dstDuDesc,
+                      float * dstDv,     BufferDescriptor const &dstDvDesc,
+                      int blockWidth,
+                      int const * blockOffsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int numStencils,
+                      int startBlock, int endBlock);
+
+void
+TbbEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end);
+
+void
+TbbEvalCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                       float * dst,       BufferDescriptor const &dstDesc,
+                       float * dstDu,     BufferDescriptor const &dstDuDesc,
+                       float * dstDv,     BufferDescriptor const &dstDvDesc,
+                       CpuCompactStencilTable const & stencilTable,
+                       int start, int end);
+
+void
+TbbEvalInstancedStencils(float const * src, BufferDescriptor const &srcDesc,
+                         float * dst,       BufferDescriptor const &dstDesc,
+                         CpuInstancedStencilTable const & stencilTable,
+                         int start, int end);
+
+void
+TbbEvalPatches(float const *src, BufferDescriptor const &srcDesc,
+               float *dst,       BufferDescriptor const &dstDesc,
+               float *dstDu,     BufferDescriptor const &dstDuDesc,
+               float *dstDv,     BufferDescriptor const &dstDvDesc,
+               int numPatchCoords,
+               const PatchCoord *patchCoords,
+               const PatchArray *patchArrayBuffer,
+               const int *patchIndexBuffer,
+               const PatchParam *patchParamBuffer);
+
+// Evaluates PatchCoords with first and second derivatives in a single pass
+// over the control vertices of their patches (see CpuEvalPatches)
 void
 TbbEvalPatches(float const *src, BufferDescriptor const &srcDesc,
                float *dst,       BufferDescriptor const &dstDesc,
                float *dstDu,     BufferDescriptor const &dstDuDesc,
                float *dstDv,     BufferDescriptor const &dstDvDesc,
+               float *dstDuu,    BufferDescriptor const &dstDuuDesc,
+               float *dstDuv,    BufferDescriptor const &dstDuvDesc,
+               float *dstDvv,    BufferDescriptor const &dstDvvDesc,
                int numPatchCoords,
                const PatchCoord *patchCoords,
                const PatchArray *patchArrayBuffer,
                const int *patchIndexBuffer,
                const PatchParam *patchParamBuffer);
 
+// Evaluates the unit normals and optional tangents of the limit surface at
+// PatchCoords (see CpuEvalPatchNormals)
+void
+TbbEvalPatchNormals(float const *src, BufferDescriptor const &srcDesc,
+                    float *dst,       BufferDescriptor const &dstDesc,
+                    float *normal,    BufferDescriptor const &normalDesc,
+                    float *tangent,   BufferDescriptor const &tangentDesc,
+                    int numPatchCoords,
+                    const PatchCoord *patchCoords,
+                    const PatchArray *patchArrayBuffer,
+                    const int *patchIndexBuffer,
+                    const PatchParam *patchParamBuffer);
+
+// Moves surface samples and maps them to PatchCoords (see
+// CpuEvaluator::AdvectPatchCoords)
+void
+TbbAdvectPatchCoords(int numSamples,
+                     int *faceIds, float *u, float *v, float *velocities,
+                     float step,
+                     int numPtexFaces, const int *adjacencyBuffer,
+                     PatchCoord *patchCoords,
+                     int numFaces, const int *faceBuffer,
+                     const unsigned int *nodeBuffer,
+                     const int *handleBuffer);
+
+// Blends two keyframes of an animation (see CpuEvaluator::BlendKeyframes)
+void
+TbbBlendKeyframes(float const *keys, BufferDescriptor const &keyDesc,
+                  float *dst, BufferDescriptor const &dstDesc,
+                  int numVertices, int key0, int key1, float weight);
+
 }  // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
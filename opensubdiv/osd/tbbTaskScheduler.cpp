@@ -0,0 +1,74 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#include "../osd/tbbTaskScheduler.h"
+
+#include <algorithm>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    class TbbRangeKernel {
+    public:
+        TbbRangeKernel(Far::TaskScheduler::RangeKernel kernel, void * data) :
+            _kernel(kernel), _data(data) { }
+
+        void operator() (tbb::blocked_range<int> const &r) const {
+            _kernel(r.begin(), r.end(), _data);
+        }
+
+    private:
+        Far::TaskScheduler::RangeKernel _kernel;
+        void *                          _data;
+    };
+
+} // end namespace
+
+void
+TbbTaskScheduler::ParallelFor(int begin, int end, int grainSize,
+                              RangeKernel kernel, void * data) const {
+
+    if (end <= begin) return;
+
+    tbb::blocked_range<int> range(begin, end, std::max(grainSize, 1));
+
+    tbb::parallel_for(range, TbbRangeKernel(kernel, data));
+}
+
+int
+TbbTaskScheduler::GetNumThreads() const {
+
+    return tbb::this_task_arena::max_concurrency();
+}
+
+} // end namespace Osd
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -90,12 +90,38 @@ struct PatchArray {
     int primitiveIdBase;  // an offset within the patch param buffer
 };
 
+/// \brief Range of consecutive patches of a PatchArray in the compact index
+/// buffers of a patch table (see CpuPatchTable::GetCompactPatchArrayBuffer)
+///
+/// The control vertices of the patches are either 16-bit offsets from
+/// vertexBase (indexSize 2, e.g. drawn with glDrawElementsBaseVertex and
+/// GL_UNSIGNED_SHORT indices), or 32-bit indices for the patches spanning
+/// more than 16 bits of vertices (indexSize 4, vertexBase 0).  indexBase is
+/// an offset within the index buffer of the matching size.
+///
+struct CompactPatchArray : public PatchArray {
+    CompactPatchArray(PatchArray const &array_in, int vertexBase_in,
+                      int indexSize_in) :
+        PatchArray(array_in), vertexBase(vertexBase_in),
+        indexSize(indexSize_in) {}
+
+    int GetVertexBase() const {
+        return vertexBase;
+    }
+    int GetIndexSize() const {
+        return indexSize;
+    }
+    int vertexBase;       // added to the 16-bit indices
+    int indexSize;        // size of the indices in bytes (2 or 4)
+};
+
 struct PatchParam : public Far::PatchParam {
     // int3 struct.
     float sharpness;
 };
 
 typedef std::vector<PatchArray> PatchArrayVector;
+typedef std::vector<CompactPatchArray> CompactPatchArrayVector;
 typedef std::vector<PatchParam> PatchParamVector;
 
 }  // end namespace Osd
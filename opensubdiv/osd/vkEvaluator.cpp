@@ -0,0 +1,515 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/vkEvaluator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "../far/error.h"
+#include "../far/stencilTable.h"
+#include "../far/profile.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+// SPIR-V kernels compiled from vkComputeKernel.comp (see osd/CMakeLists.txt)
+#include "vkEvalStencilsKernel.spv.h"
+#include "vkEvalStencilsDerivKernel.spv.h"
+#include "vkEvalPatchesKernel.spv.h"
+#include "vkEvalPatchesDerivKernel.spv.h"
+
+// Layout of the push constants of glslComputeKernel.glsl
+struct PushConstants {
+    int patchArray[8];
+    int duDesc[3];
+    int srcOffset;
+    int dvDesc[3];
+    int dstOffset;
+    int batchStart;
+    int batchEnd;
+    int evalMode;
+};
+
+// Bindings of the storage buffers of glslComputeKernel.glsl
+static const int NUM_BINDINGS = 10;
+
+// Minimum of VkPhysicalDeviceLimits::maxComputeWorkGroupCount
+static const int MAX_WORK_GROUP_COUNT = 65535;
+
+template <class T> static bool
+createBuffer(internal::VkMappedBuffer & buffer, std::vector<T> const & src,
+             VkDevice device, VkPhysicalDevice physicalDevice) {
+    return buffer.Create(device, physicalDevice, src.size()*sizeof(T),
+                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                         src.empty() ? NULL : &src[0]);
+}
+
+VkStencilTable::VkStencilTable(Far::StencilTable const *stencilTable,
+                               VkDevice device,
+                               VkPhysicalDevice physicalDevice)
+    : _device(device) {
+    _numStencils = stencilTable->GetNumStencils();
+    if (_numStencils > 0) {
+        createBuffer(_sizes, stencilTable->GetSizes(),
+                     device, physicalDevice);
+        createBuffer(_offsets, stencilTable->GetOffsets(),
+                     device, physicalDevice);
+        createBuffer(_indices, stencilTable->GetControlIndices(),
+                     device, physicalDevice);
+        createBuffer(_weights, stencilTable->GetWeights(),
+                     device, physicalDevice);
+    }
+}
+
+VkStencilTable::VkStencilTable(Far::LimitStencilTable const *limitStencilTable,
+                               VkDevice device,
+                               VkPhysicalDevice physicalDevice)
+    : _device(device) {
+    _numStencils = limitStencilTable->GetNumStencils();
+    if (_numStencils > 0) {
+        createBuffer(_sizes, limitStencilTable->GetSizes(),
+                     device, physicalDevice);
+        createBuffer(_offsets, limitStencilTable->GetOffsets(),
+                     device, physicalDevice);
+        createBuffer(_indices, limitStencilTable->GetControlIndices(),
+                     device, physicalDevice);
+        createBuffer(_weights, limitStencilTable->GetWeights(),
+                     device, physicalDevice);
+        createBuffer(_duWeights, limitStencilTable->GetDuWeights(),
+                     device, physicalDevice);
+        createBuffer(_dvWeights, limitStencilTable->GetDvWeights(),
+                     device, physicalDevice);
+    }
+}
+
+VkStencilTable::~VkStencilTable() {
+    _sizes.Destroy(_device);
+    _offsets.Destroy(_device);
+    _indices.Destroy(_device);
+    _weights.Destroy(_device);
+    _duWeights.Destroy(_device);
+    _dvWeights.Destroy(_device);
+}
+
+// ---------------------------------------------------------------------------
+
+VkEvaluator::VkEvaluator(VkDevice device) :
+    _device(device),
+    _descriptorSetLayout(VK_NULL_HANDLE), _pipelineLayout(VK_NULL_HANDLE),
+    _stencilKernel(VK_NULL_HANDLE), _patchKernel(VK_NULL_HANDLE),
+    _vkCmdPushDescriptorSet(NULL),
+    _workGroupSize(64) {
+}
+
+VkEvaluator::~VkEvaluator() {
+    if (_stencilKernel != VK_NULL_HANDLE)
+        vkDestroyPipeline(_device, _stencilKernel, NULL);
+    if (_patchKernel != VK_NULL_HANDLE)
+        vkDestroyPipeline(_device, _patchKernel, NULL);
+    if (_pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(_device, _pipelineLayout, NULL);
+    if (_descriptorSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(_device, _descriptorSetLayout, NULL);
+}
+
+static VkPipeline
+createPipeline(VkDevice device, VkPipelineLayout pipelineLayout,
+               uint32_t const *code, size_t codeSize,
+               BufferDescriptor const &srcDesc,
+               BufferDescriptor const &dstDesc,
+               int workGroupSize) {
+
+    VkShaderModuleCreateInfo moduleInfo;
+    memset(&moduleInfo, 0, sizeof(moduleInfo));
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = codeSize;
+    moduleInfo.pCode = code;
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device, &moduleInfo, NULL, &module) !=
+        VK_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failed to create Vulkan shader module");
+        return VK_NULL_HANDLE;
+    }
+
+    // LENGTH, SRC_STRIDE, DST_STRIDE and the work group size
+    int32_t constants[4] = {
+        srcDesc.length, srcDesc.stride, dstDesc.stride, workGroupSize };
+
+    VkSpecializationMapEntry entries[4];
+    for (int i = 0; i < 4; ++i) {
+        entries[i].constantID = i;
+        entries[i].offset = i * sizeof(int32_t);
+        entries[i].size = sizeof(int32_t);
+    }
+
+    VkSpecializationInfo specialization;
+    specialization.mapEntryCount = 4;
+    specialization.pMapEntries = entries;
+    specialization.dataSize = sizeof(constants);
+    specialization.pData = constants;
+
+    VkComputePipelineCreateInfo pipelineInfo;
+    memset(&pipelineInfo, 0, sizeof(pipelineInfo));
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.stage.pSpecializationInfo = &specialization;
+    pipelineInfo.layout = pipelineLayout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo,
+                                 NULL, &pipeline) != VK_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failed to create Vulkan compute pipeline");
+        pipeline = VK_NULL_HANDLE;
+    }
+
+    vkDestroyShaderModule(device, module, NULL);
+
+    return pipeline;
+}
+
+bool
+VkEvaluator::Compile(BufferDescriptor const &srcDesc,
+                     BufferDescriptor const &dstDesc,
+                     BufferDescriptor const &duDesc,
+                     BufferDescriptor const &dvDesc) {
+
+    _vkCmdPushDescriptorSet = (PFN_vkCmdPushDescriptorSetKHR)
+        vkGetDeviceProcAddr(_device, "vkCmdPushDescriptorSetKHR");
+    if (!_vkCmdPushDescriptorSet) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "VkEvaluator requires VK_KHR_push_descriptor");
+        return false;
+    }
+
+    if (_descriptorSetLayout == VK_NULL_HANDLE) {
+        VkDescriptorSetLayoutBinding bindings[NUM_BINDINGS];
+        memset(bindings, 0, sizeof(bindings));
+        for (int i = 0; i < NUM_BINDINGS; ++i) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo;
+        memset(&layoutInfo, 0, sizeof(layoutInfo));
+        layoutInfo.sType =
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.flags =
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        layoutInfo.bindingCount = NUM_BINDINGS;
+        layoutInfo.pBindings = bindings;
+
+        if (vkCreateDescriptorSetLayout(_device, &layoutInfo, NULL,
+                                        &_descriptorSetLayout) != VK_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "Failed to create Vulkan descriptor set layout");
+            _descriptorSetLayout = VK_NULL_HANDLE;
+            return false;
+        }
+
+        VkPushConstantRange pushConstantRange;
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(PushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo;
+        memset(&pipelineLayoutInfo, 0, sizeof(pipelineLayoutInfo));
+        pipelineLayoutInfo.sType =
+            VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(_device, &pipelineLayoutInfo, NULL,
+                                   &_pipelineLayout) != VK_SUCCESS) {
+            Far::Error(Far::FAR_RUNTIME_ERROR,
+                       "Failed to create Vulkan pipeline layout");
+            _pipelineLayout = VK_NULL_HANDLE;
+            return false;
+        }
+    }
+
+    if (_stencilKernel != VK_NULL_HANDLE) {
+        vkDestroyPipeline(_device, _stencilKernel, NULL);
+    }
+    if (_patchKernel != VK_NULL_HANDLE) {
+        vkDestroyPipeline(_device, _patchKernel, NULL);
+    }
+
+    bool derivatives = (duDesc.length > 0 || dvDesc.length > 0);
+
+    // create a stencil kernel
+    _stencilKernel = derivatives
+        ? createPipeline(_device, _pipelineLayout,
+                         vkEvalStencilsDerivKernel,
+                         sizeof(vkEvalStencilsDerivKernel),
+                         srcDesc, dstDesc, _workGroupSize)
+        : createPipeline(_device, _pipelineLayout,
+                         vkEvalStencilsKernel,
+                         sizeof(vkEvalStencilsKernel),
+                         srcDesc, dstDesc, _workGroupSize);
+
+    // create a patch kernel
+    _patchKernel = derivatives
+        ? createPipeline(_device, _pipelineLayout,
+                         vkEvalPatchesDerivKernel,
+                         sizeof(vkEvalPatchesDerivKernel),
+                         srcDesc, dstDesc, _workGroupSize)
+        : createPipeline(_device, _pipelineLayout,
+                         vkEvalPatchesKernel,
+                         sizeof(vkEvalPatchesKernel),
+                         srcDesc, dstDesc, _workGroupSize);
+
+    return (_stencilKernel != VK_NULL_HANDLE &&
+            _patchKernel != VK_NULL_HANDLE);
+}
+
+/* static */
+void
+VkEvaluator::Synchronize(VkDevice device) {
+    vkDeviceWaitIdle(device);
+}
+
+/* static */
+bool
+VkEvaluator::noInstance() {
+    Far::Error(Far::FAR_RUNTIME_ERROR,
+               "VkEvaluator can't be instantiated on demand : "
+               "a cached instance is required");
+    return false;
+}
+
+void
+VkEvaluator::dispatch(VkCommandBuffer commandBuffer, VkPipeline pipeline,
+                      int numBuffers, VkBuffer const *buffers,
+                      void *pushConstants, int start, int count) const {
+
+    VkDescriptorBufferInfo bufferInfos[NUM_BINDINGS];
+    VkWriteDescriptorSet writes[NUM_BINDINGS];
+    uint32_t numWrites = 0;
+    for (int i = 0; i < numBuffers; ++i) {
+        if (buffers[i] == VK_NULL_HANDLE) continue;
+
+        bufferInfos[numWrites].buffer = buffers[i];
+        bufferInfos[numWrites].offset = 0;
+        bufferInfos[numWrites].range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet &write = writes[numWrites];
+        memset(&write, 0, sizeof(write));
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstBinding = i;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfos[numWrites];
+        ++numWrites;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    _vkCmdPushDescriptorSet(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            _pipelineLayout, 0, numWrites, writes);
+
+    PushConstants *constants = static_cast<PushConstants *>(pushConstants);
+
+    // split the dispatch past the maximum work group count
+    int const maxThreads = MAX_WORK_GROUP_COUNT * _workGroupSize;
+    int const end = start + count;
+    for (int batchStart = start; batchStart < end; batchStart += maxThreads) {
+        int batchCount = std::min(maxThreads, end - batchStart);
+
+        constants->batchStart = batchStart;
+        constants->batchEnd = end;
+        vkCmdPushConstants(commandBuffer, _pipelineLayout,
+                           VK_SHADER_STAGE_COMPUTE_BIT,
+                           0, sizeof(PushConstants), constants);
+
+        vkCmdDispatch(commandBuffer,
+                      (batchCount + _workGroupSize - 1) / _workGroupSize, 1, 1);
+    }
+
+    VkMemoryBarrier barrier;
+    memset(&barrier, 0, sizeof(barrier));
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT |
+                            VK_ACCESS_SHADER_WRITE_BIT |
+                            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                         VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         0, 1, &barrier, 0, NULL, 0, NULL);
+}
+
+bool
+VkEvaluator::EvalStencils(
+    VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+    VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+    VkBuffer duBuffer,  BufferDescriptor const &duDesc,
+    VkBuffer dvBuffer,  BufferDescriptor const &dvDesc,
+    VkBuffer sizesBuffer,
+    VkBuffer offsetsBuffer,
+    VkBuffer indicesBuffer,
+    VkBuffer weightsBuffer,
+    VkBuffer duWeightsBuffer,
+    VkBuffer dvWeightsBuffer,
+    int start, int end,
+    VkCommandBuffer commandBuffer) const {
+
+    OPENSUBDIV_PROFILE_ZONE("VkEvaluator::EvalStencils");
+
+    if (_stencilKernel == VK_NULL_HANDLE) return false;
+    int count = end - start;
+    if (count <= 0) {
+        return true;
+    }
+
+    VkBuffer buffers[NUM_BINDINGS] = {
+        srcBuffer, dstBuffer, duBuffer, dvBuffer,
+        sizesBuffer, offsetsBuffer, indicesBuffer, weightsBuffer,
+        duWeightsBuffer, dvWeightsBuffer };
+
+    PushConstants constants;
+    memset(&constants, 0, sizeof(constants));
+    constants.srcOffset = srcDesc.offset;
+    constants.dstOffset = dstDesc.offset;
+    constants.duDesc[0] = duDesc.offset;
+    constants.duDesc[1] = duDesc.length;
+    constants.duDesc[2] = duDesc.stride;
+    constants.dvDesc[0] = dvDesc.offset;
+    constants.dvDesc[1] = dvDesc.length;
+    constants.dvDesc[2] = dvDesc.stride;
+
+    dispatch(commandBuffer, _stencilKernel, NUM_BINDINGS, buffers,
+             &constants, start, count);
+
+    return true;
+}
+
+bool
+VkEvaluator::EvalPatches(
+    VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+    VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+    VkBuffer duBuffer,  BufferDescriptor const &duDesc,
+    VkBuffer dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    VkBuffer patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    VkBuffer patchIndexBuffer,
+    VkBuffer patchParamsBuffer,
+    VkCommandBuffer commandBuffer) const {
+
+    OPENSUBDIV_PROFILE_ZONE("VkEvaluator::EvalPatches");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       patchArrays, patchIndexBuffer, patchParamsBuffer,
+                       false, commandBuffer);
+}
+
+bool
+VkEvaluator::EvalPatchesFaceVarying(
+    VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+    VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+    VkBuffer duBuffer,  BufferDescriptor const &duDesc,
+    VkBuffer dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    VkBuffer patchCoordsBuffer,
+    const PatchArrayVector &fvarPatchArrays,
+    VkBuffer fvarPatchIndexBuffer,
+    VkBuffer fvarPatchParamsBuffer,
+    VkCommandBuffer commandBuffer) const {
+
+    OPENSUBDIV_PROFILE_ZONE("VkEvaluator::EvalPatchesFaceVarying");
+
+    return evalPatches(srcBuffer, srcDesc, dstBuffer, dstDesc,
+                       duBuffer, duDesc, dvBuffer, dvDesc,
+                       numPatchCoords, patchCoordsBuffer,
+                       fvarPatchArrays, fvarPatchIndexBuffer,
+                       fvarPatchParamsBuffer, true, commandBuffer);
+}
+
+bool
+VkEvaluator::evalPatches(
+    VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+    VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+    VkBuffer duBuffer,  BufferDescriptor const &duDesc,
+    VkBuffer dvBuffer,  BufferDescriptor const &dvDesc,
+    int numPatchCoords,
+    VkBuffer patchCoordsBuffer,
+    const PatchArrayVector &patchArrays,
+    VkBuffer patchIndexBuffer,
+    VkBuffer patchParamsBuffer,
+    bool faceVarying,
+    VkCommandBuffer commandBuffer) const {
+
+    if (_patchKernel == VK_NULL_HANDLE) return false;
+    if (numPatchCoords <= 0 || patchArrays.empty()) {
+        return true;
+    }
+
+    VkBuffer buffers[7] = {
+        srcBuffer, dstBuffer, duBuffer, dvBuffer,
+        patchCoordsBuffer, patchIndexBuffer, patchParamsBuffer };
+
+    PushConstants constants;
+    memset(&constants, 0, sizeof(constants));
+    memcpy(constants.patchArray, &patchArrays[0],
+           std::min(patchArrays.size(), (size_t)2) * sizeof(PatchArray));
+    constants.srcOffset = srcDesc.offset;
+    constants.dstOffset = dstDesc.offset;
+    constants.duDesc[0] = duDesc.offset;
+    constants.duDesc[1] = duDesc.length;
+    constants.duDesc[2] = duDesc.stride;
+    constants.dvDesc[0] = dvDesc.offset;
+    constants.dvDesc[1] = dvDesc.length;
+    constants.dvDesc[2] = dvDesc.stride;
+    constants.evalMode = faceVarying ? 1 : 0;
+
+    dispatch(commandBuffer, _patchKernel, 7, buffers,
+             &constants, 0, numPatchCoords);
+
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
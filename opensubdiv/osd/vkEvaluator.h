@@ -0,0 +1,582 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_VK_EVALUATOR_H
+#define OPENSUBDIV3_OSD_VK_EVALUATOR_H
+
+#include "../version.h"
+
+#include "../osd/vulkan.h"
+#include "../osd/nonCopyable.h"
+#include "../osd/types.h"
+#include "../osd/bufferDescriptor.h"
+#include "../osd/vkMappedBuffer.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    class PatchTable;
+    class StencilTable;
+    class LimitStencilTable;
+}
+
+namespace Osd {
+
+/// \brief Vulkan stencil table
+///
+/// This class is a Vulkan storage buffer representation of
+/// Far::StencilTable.
+///
+/// VkEvaluator consumes this table to apply stencils
+///
+class VkStencilTable : private NonCopyable<VkStencilTable> {
+public:
+    static VkStencilTable *Create(Far::StencilTable const *stencilTable,
+                                  VkDevice device,
+                                  VkPhysicalDevice physicalDevice) {
+        return new VkStencilTable(stencilTable, device, physicalDevice);
+    }
+    static VkStencilTable *Create(
+        Far::LimitStencilTable const *limitStencilTable,
+        VkDevice device, VkPhysicalDevice physicalDevice) {
+        return new VkStencilTable(limitStencilTable, device, physicalDevice);
+    }
+
+    /// Creators from a client device context providing
+    ///   VkDevice GetDevice()
+    ///   VkPhysicalDevice GetPhysicalDevice()
+    /// methods.
+    template <typename DEVICE_CONTEXT>
+    static VkStencilTable *Create(Far::StencilTable const *stencilTable,
+                                  DEVICE_CONTEXT context) {
+        return new VkStencilTable(stencilTable, context->GetDevice(),
+                                  context->GetPhysicalDevice());
+    }
+    template <typename DEVICE_CONTEXT>
+    static VkStencilTable *Create(
+        Far::LimitStencilTable const *limitStencilTable,
+        DEVICE_CONTEXT context) {
+        return new VkStencilTable(limitStencilTable, context->GetDevice(),
+                                  context->GetPhysicalDevice());
+    }
+
+    VkStencilTable(Far::StencilTable const *stencilTable,
+                   VkDevice device, VkPhysicalDevice physicalDevice);
+    VkStencilTable(Far::LimitStencilTable const *limitStencilTable,
+                   VkDevice device, VkPhysicalDevice physicalDevice);
+    ~VkStencilTable();
+
+    // interfaces needed for VkEvaluator
+    VkBuffer GetSizesBuffer() const { return _sizes.buffer; }
+    VkBuffer GetOffsetsBuffer() const { return _offsets.buffer; }
+    VkBuffer GetIndicesBuffer() const { return _indices.buffer; }
+    VkBuffer GetWeightsBuffer() const { return _weights.buffer; }
+    VkBuffer GetDuWeightsBuffer() const { return _duWeights.buffer; }
+    VkBuffer GetDvWeightsBuffer() const { return _dvWeights.buffer; }
+    int GetNumStencils() const { return _numStencils; }
+
+private:
+    VkDevice _device;
+    internal::VkMappedBuffer _sizes;
+    internal::VkMappedBuffer _offsets;
+    internal::VkMappedBuffer _indices;
+    internal::VkMappedBuffer _weights;
+    internal::VkMappedBuffer _duWeights;
+    internal::VkMappedBuffer _dvWeights;
+    int _numStencils;
+};
+
+// ---------------------------------------------------------------------------
+
+/// \brief Vulkan compute evaluator
+///
+/// VkEvaluator records the dispatches of the GLSL compute kernels (compiled
+/// to SPIR-V, see vkComputeKernel.comp) into a command buffer provided by the
+/// client : evaluations are batched with the other work of the command
+/// buffer, and execute when it is submitted. Each dispatch is followed by a
+/// memory barrier making its results visible to the compute and vertex input
+/// stages of the following commands.
+///
+/// The buffers are bound with push descriptors : the device must be created
+/// with the VK_KHR_push_descriptor extension enabled.
+///
+/// Unlike the other evaluators, an evaluator can't be instantiated on demand
+/// by the static Eval functions (its pipelines must outlive the execution of
+/// the command buffer) : clients must provide a cached instance.
+///
+class VkEvaluator : private NonCopyable<VkEvaluator> {
+public:
+    typedef bool Instantiatable;
+
+    /// Creator from a client device context providing
+    ///   VkDevice GetDevice()
+    /// method. Returns NULL if error.
+    template <typename DEVICE_CONTEXT>
+    static VkEvaluator *Create(BufferDescriptor const &srcDesc,
+                               BufferDescriptor const &dstDesc,
+                               BufferDescriptor const &duDesc,
+                               BufferDescriptor const &dvDesc,
+                               DEVICE_CONTEXT deviceContext) {
+        return Create(srcDesc, dstDesc, duDesc, dvDesc,
+                      deviceContext->GetDevice());
+    }
+
+    static VkEvaluator *Create(BufferDescriptor const &srcDesc,
+                               BufferDescriptor const &dstDesc,
+                               BufferDescriptor const &duDesc,
+                               BufferDescriptor const &dvDesc,
+                               VkDevice device) {
+        VkEvaluator *instance = new VkEvaluator(device);
+        if (instance->Compile(srcDesc, dstDesc, duDesc, dvDesc)) return instance;
+        delete instance;
+        return NULL;
+    }
+
+    /// Destructor. Note that the commands recorded with this evaluator must
+    /// have completed.
+    ~VkEvaluator();
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with StencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static compute function. This function has a same
+    ///        signature as other device kernels have so that it can be called
+    ///        transparently from OsdMesh template interface.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindVkBuffer() method returning the
+    ///                       VkBuffer object for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindVkBuffer() method returning the
+    ///                       VkBuffer object for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   VkStencilTable or equivalent
+    ///
+    /// @param instance       cached compiled instance (required, see above)
+    ///
+    /// @param deviceContext  client providing context class which supports
+    ///                         VkCommandBuffer GetCommandBuffer()
+    ///                       method, returning the command buffer being
+    ///                       recorded.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename STENCIL_TABLE, typename DEVICE_CONTEXT>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        VkEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext) {
+
+        if (!instance) return noInstance();
+        return instance->EvalStencils(srcBuffer, srcDesc,
+                                      dstBuffer, dstDesc,
+                                      stencilTable,
+                                      deviceContext->GetCommandBuffer());
+    }
+
+    /// \brief Generic static compute function evaluating the range
+    ///        [start, end) of the stencils of a table only, e.g. the stencils
+    ///        affected by the control vertices updated since the previous
+    ///        evaluation (see Osd::Mesh). Stencils are written at their index
+    ///        in the output buffer, as by the evaluation of the whole table.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename STENCIL_TABLE, typename DEVICE_CONTEXT>
+    static bool EvalStencilRange(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        int start, int end,
+        VkEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext) {
+
+        if (!instance) return noInstance();
+        if (end <= start) return true;
+
+        return instance->EvalStencils(srcBuffer->BindVkBuffer(), srcDesc,
+                                      dstBuffer->BindVkBuffer(), dstDesc,
+                                      VK_NULL_HANDLE, BufferDescriptor(),
+                                      VK_NULL_HANDLE, BufferDescriptor(),
+                                      stencilTable->GetSizesBuffer(),
+                                      stencilTable->GetOffsetsBuffer(),
+                                      stencilTable->GetIndicesBuffer(),
+                                      stencilTable->GetWeightsBuffer(),
+                                      VK_NULL_HANDLE,
+                                      VK_NULL_HANDLE,
+                                      start, end,
+                                      deviceContext->GetCommandBuffer());
+    }
+
+    /// \brief Generic static compute function with derivatives (see above)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename STENCIL_TABLE, typename DEVICE_CONTEXT>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        VkEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext) {
+
+        if (!instance) return noInstance();
+        return instance->EvalStencils(srcBuffer, srcDesc,
+                                      dstBuffer, dstDesc,
+                                      duBuffer,  duDesc,
+                                      dvBuffer,  dvDesc,
+                                      stencilTable,
+                                      deviceContext->GetCommandBuffer());
+    }
+
+    /// Records the dispatch of the stencil kernel into 'commandBuffer'.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        VkCommandBuffer commandBuffer) const {
+        return EvalStencils(srcBuffer->BindVkBuffer(), srcDesc,
+                            dstBuffer->BindVkBuffer(), dstDesc,
+                            VK_NULL_HANDLE, BufferDescriptor(),
+                            VK_NULL_HANDLE, BufferDescriptor(),
+                            stencilTable->GetSizesBuffer(),
+                            stencilTable->GetOffsetsBuffer(),
+                            stencilTable->GetIndicesBuffer(),
+                            stencilTable->GetWeightsBuffer(),
+                            VK_NULL_HANDLE,
+                            VK_NULL_HANDLE,
+                            /* start = */ 0,
+                            /* end   = */ stencilTable->GetNumStencils(),
+                            commandBuffer);
+    }
+
+    /// Records the dispatch of the stencil kernel with derivatives into
+    /// 'commandBuffer'.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        VkCommandBuffer commandBuffer) const {
+        return EvalStencils(srcBuffer->BindVkBuffer(), srcDesc,
+                            dstBuffer->BindVkBuffer(), dstDesc,
+                            duBuffer->BindVkBuffer(),  duDesc,
+                            dvBuffer->BindVkBuffer(),  dvDesc,
+                            stencilTable->GetSizesBuffer(),
+                            stencilTable->GetOffsetsBuffer(),
+                            stencilTable->GetIndicesBuffer(),
+                            stencilTable->GetWeightsBuffer(),
+                            stencilTable->GetDuWeightsBuffer(),
+                            stencilTable->GetDvWeightsBuffer(),
+                            /* start = */ 0,
+                            /* end   = */ stencilTable->GetNumStencils(),
+                            commandBuffer);
+    }
+
+    /// Records the dispatch of the stencil kernel on Vulkan buffers into
+    /// 'commandBuffer'.
+    /// returns false if the kernel hasn't been compiled yet.
+    bool EvalStencils(VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+                      VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+                      VkBuffer duBuffer,  BufferDescriptor const &duDesc,
+                      VkBuffer dvBuffer,  BufferDescriptor const &dvDesc,
+                      VkBuffer sizesBuffer,
+                      VkBuffer offsetsBuffer,
+                      VkBuffer indicesBuffer,
+                      VkBuffer weightsBuffer,
+                      VkBuffer duWeightsBuffer,
+                      VkBuffer dvWeightsBuffer,
+                      int start,
+                      int end,
+                      VkCommandBuffer commandBuffer) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Limit evaluations with PatchTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic limit eval function. This function has a same
+    ///        signature as other device kernels have so that it can be called
+    ///        in the same way.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindVkBuffer() method returning the
+    ///                       VkBuffer object for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindVkBuffer() method returning the
+    ///                       VkBuffer object for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param numPatchCoords number of patchCoords.
+    ///
+    /// @param patchCoords    array of locations to be evaluated.
+    ///                       must have BindVkBuffer() method returning an
+    ///                       array of PatchCoord struct in a VkBuffer.
+    ///
+    /// @param patchTable     VkPatchTable or equivalent
+    ///
+    /// @param instance       cached compiled instance (required, see above)
+    ///
+    /// @param deviceContext  client providing context class which supports
+    ///                         VkCommandBuffer GetCommandBuffer()
+    ///                       method, returning the command buffer being
+    ///                       recorded.
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE,
+              typename DEVICE_CONTEXT>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        VkEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext) {
+
+        if (!instance) return noInstance();
+        return instance->EvalPatches(srcBuffer, srcDesc,
+                                     dstBuffer, dstDesc,
+                                     numPatchCoords, patchCoords,
+                                     patchTable,
+                                     deviceContext->GetCommandBuffer());
+    }
+
+    /// \brief Generic limit eval function with derivatives (see above)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE,
+              typename DEVICE_CONTEXT>
+    static bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        VkEvaluator const *instance,
+        DEVICE_CONTEXT deviceContext) {
+
+        if (!instance) return noInstance();
+        return instance->EvalPatches(srcBuffer, srcDesc,
+                                     dstBuffer, dstDesc,
+                                     duBuffer, duDesc,
+                                     dvBuffer, dvDesc,
+                                     numPatchCoords, patchCoords,
+                                     patchTable,
+                                     deviceContext->GetCommandBuffer());
+    }
+
+    /// Records the dispatch of the patch kernel into 'commandBuffer'.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        VkCommandBuffer commandBuffer) const {
+
+        return EvalPatches(srcBuffer->BindVkBuffer(), srcDesc,
+                           dstBuffer->BindVkBuffer(), dstDesc,
+                           VK_NULL_HANDLE, BufferDescriptor(),
+                           VK_NULL_HANDLE, BufferDescriptor(),
+                           numPatchCoords,
+                           patchCoords->BindVkBuffer(),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer(),
+                           commandBuffer);
+    }
+
+    /// Records the dispatch of the patch kernel with derivatives into
+    /// 'commandBuffer'.
+    /// returns false if the kernel hasn't been compiled yet.
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatches(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        VkCommandBuffer commandBuffer) const {
+
+        return EvalPatches(srcBuffer->BindVkBuffer(), srcDesc,
+                           dstBuffer->BindVkBuffer(), dstDesc,
+                           duBuffer->BindVkBuffer(),  duDesc,
+                           dvBuffer->BindVkBuffer(),  dvDesc,
+                           numPatchCoords,
+                           patchCoords->BindVkBuffer(),
+                           patchTable->GetPatchArrays(),
+                           patchTable->GetPatchIndexBuffer(),
+                           patchTable->GetPatchParamBuffer(),
+                           commandBuffer);
+    }
+
+    /// Records the dispatch of the patch kernel on Vulkan buffers into
+    /// 'commandBuffer'.
+    /// returns false if the kernel hasn't been compiled yet.
+    bool EvalPatches(VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+                     VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+                     VkBuffer duBuffer, BufferDescriptor const &duDesc,
+                     VkBuffer dvBuffer, BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     VkBuffer patchCoordsBuffer,
+                     const PatchArrayVector &patchArrays,
+                     VkBuffer patchIndexBuffer,
+                     VkBuffer patchParamsBuffer,
+                     VkCommandBuffer commandBuffer) const;
+
+    /// \brief Generic face-varying limit eval function : the PatchCoords of
+    ///        the vertex patches are mapped to the patches of the channel by
+    ///        the kernel (see GLComputeEvaluator::EvalPatchesFaceVarying)
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER,
+              typename PATCHCOORD_BUFFER, typename PATCH_TABLE>
+    bool EvalPatchesFaceVarying(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int numPatchCoords,
+        PATCHCOORD_BUFFER *patchCoords,
+        PATCH_TABLE *patchTable,
+        int fvarChannel,
+        VkCommandBuffer commandBuffer) const {
+
+        return EvalPatchesFaceVarying(srcBuffer->BindVkBuffer(), srcDesc,
+                           dstBuffer->BindVkBuffer(), dstDesc,
+                           VK_NULL_HANDLE, BufferDescriptor(),
+                           VK_NULL_HANDLE, BufferDescriptor(),
+                           numPatchCoords,
+                           patchCoords->BindVkBuffer(),
+                           patchTable->GetFVarPatchArrays(fvarChannel),
+                           patchTable->GetFVarPatchIndexBuffer(fvarChannel),
+                           patchTable->GetFVarPatchParamBuffer(fvarChannel),
+                           commandBuffer);
+    }
+
+    /// \brief Face-varying limit eval function on Vulkan buffers
+    bool EvalPatchesFaceVarying(VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+                                VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+                                VkBuffer duBuffer, BufferDescriptor const &duDesc,
+                                VkBuffer dvBuffer, BufferDescriptor const &dvDesc,
+                                int numPatchCoords,
+                                VkBuffer patchCoordsBuffer,
+                                const PatchArrayVector &fvarPatchArrays,
+                                VkBuffer fvarPatchIndexBuffer,
+                                VkBuffer fvarPatchParamsBuffer,
+                                VkCommandBuffer commandBuffer) const;
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Other methods
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// Creates the compute pipelines of the kernels. Returns false if it
+    /// fails to create them.
+    bool Compile(BufferDescriptor const &srcDesc,
+                 BufferDescriptor const &dstDesc,
+                 BufferDescriptor const &duDesc,
+                 BufferDescriptor const &dvDesc);
+
+    /// Wait the submitted commands finish.
+    static void Synchronize(VkDevice device);
+
+    template <typename DEVICE_CONTEXT>
+    static void Synchronize(DEVICE_CONTEXT deviceContext) {
+        Synchronize(deviceContext->GetDevice());
+    }
+
+private:
+    explicit VkEvaluator(VkDevice device);
+
+    static bool noInstance();
+
+    bool evalPatches(VkBuffer srcBuffer, BufferDescriptor const &srcDesc,
+                     VkBuffer dstBuffer, BufferDescriptor const &dstDesc,
+                     VkBuffer duBuffer, BufferDescriptor const &duDesc,
+                     VkBuffer dvBuffer, BufferDescriptor const &dvDesc,
+                     int numPatchCoords,
+                     VkBuffer patchCoordsBuffer,
+                     const PatchArrayVector &patchArrays,
+                     VkBuffer patchIndexBuffer,
+                     VkBuffer patchParamsBuffer,
+                     bool faceVarying,
+                     VkCommandBuffer commandBuffer) const;
+
+    // records the push constants, the dispatches of 'count' threads (split
+    // past the maximum work group count) and the barrier following them
+    void dispatch(VkCommandBuffer commandBuffer, VkPipeline pipeline,
+                  int numBuffers, VkBuffer const *buffers,
+                  void *pushConstants, int start, int count) const;
+
+    VkDevice _device;
+
+    VkDescriptorSetLayout _descriptorSetLayout;
+    VkPipelineLayout _pipelineLayout;
+
+    VkPipeline _stencilKernel;
+    VkPipeline _patchKernel;
+
+    PFN_vkCmdPushDescriptorSetKHR _vkCmdPushDescriptorSet;
+
+    int _workGroupSize;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+
+#endif  // OPENSUBDIV3_OSD_VK_EVALUATOR_H
@@ -0,0 +1,159 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/vkMappedBuffer.h"
+
+#include "../far/error.h"
+
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+namespace internal {
+
+static bool
+findMemoryType(VkPhysicalDevice physicalDevice, unsigned int typeBits,
+               VkMemoryPropertyFlags properties, unsigned int *typeIndex) {
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+    for (unsigned int i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((typeBits & (1u << i)) &&
+            (memoryProperties.memoryTypes[i].propertyFlags & properties) ==
+                properties) {
+            *typeIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+VkMappedBuffer::Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                       VkDeviceSize bufferSize, VkBufferUsageFlags usage) {
+
+    // Vulkan doesn't allow empty buffers (the derivative weights of stencil
+    // tables may be empty)
+    size = (bufferSize > 0) ? bufferSize : sizeof(float);
+
+    VkBufferCreateInfo bufferInfo;
+    memset(&bufferInfo, 0, sizeof(bufferInfo));
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &bufferInfo, NULL, &buffer) != VK_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "Failed to create Vulkan buffer");
+        buffer = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+    VkMemoryPropertyFlags const hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    unsigned int typeIndex = 0;
+    if (!findMemoryType(physicalDevice, requirements.memoryTypeBits,
+                        hostVisible | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                        &typeIndex) &&
+        !findMemoryType(physicalDevice, requirements.memoryTypeBits,
+                        hostVisible, &typeIndex)) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "No host visible Vulkan memory type for buffer");
+        Destroy(device);
+        return false;
+    }
+
+    VkMemoryAllocateInfo allocateInfo;
+    memset(&allocateInfo, 0, sizeof(allocateInfo));
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.allocationSize = requirements.size;
+    allocateInfo.memoryTypeIndex = typeIndex;
+
+    if (vkAllocateMemory(device, &allocateInfo, NULL, &memory) != VK_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR,
+                   "Failed to allocate Vulkan buffer memory");
+        memory = VK_NULL_HANDLE;
+        Destroy(device);
+        return false;
+    }
+
+    if (vkBindBufferMemory(device, buffer, memory, 0) != VK_SUCCESS ||
+        vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS) {
+        Far::Error(Far::FAR_RUNTIME_ERROR, "Failed to map Vulkan buffer");
+        data = 0;
+        Destroy(device);
+        return false;
+    }
+    return true;
+}
+
+bool
+VkMappedBuffer::Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                       VkDeviceSize bufferSize, VkBufferUsageFlags usage,
+                       void const *src) {
+
+    if (!Create(device, physicalDevice, bufferSize, usage)) return false;
+    if (src && bufferSize > 0) {
+        Write(src, 0, bufferSize);
+    }
+    return true;
+}
+
+void
+VkMappedBuffer::Write(void const *src, VkDeviceSize offset,
+                      VkDeviceSize writeSize) {
+
+    if (data && offset + writeSize <= size) {
+        memcpy(static_cast<unsigned char *>(data) + offset, src,
+               (size_t)writeSize);
+    }
+}
+
+void
+VkMappedBuffer::Destroy(VkDevice device) {
+
+    if (data) vkUnmapMemory(device, memory);
+    if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(device, buffer, NULL);
+    if (memory != VK_NULL_HANDLE) vkFreeMemory(device, memory, NULL);
+
+    buffer = VK_NULL_HANDLE;
+    memory = VK_NULL_HANDLE;
+    size = 0;
+    data = 0;
+}
+
+}  // end namespace internal
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,83 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_VK_MAPPED_BUFFER_H
+#define OPENSUBDIV3_OSD_VK_MAPPED_BUFFER_H
+
+#include "../version.h"
+
+#include "../osd/vulkan.h"
+
+#include <cstddef>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+namespace internal {
+
+/// \brief Vulkan buffer bound to host visible memory (internal)
+///
+/// The memory is coherent and stays mapped for the lifetime of the buffer, so
+/// that the buffers of the Vulkan backend are written directly by the host
+/// without staging copies (device local memory is preferred when it is also
+/// host visible). The buffer must not be written while commands reading it
+/// are pending.
+///
+struct VkMappedBuffer {
+
+    VkMappedBuffer() : buffer(VK_NULL_HANDLE), memory(VK_NULL_HANDLE),
+                       size(0), data(0) { }
+
+    /// Creates the buffer and maps its memory (returns false on failure)
+    bool Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                VkDeviceSize size, VkBufferUsageFlags usage);
+
+    /// Creates the buffer and copies 'size' bytes of 'src' to it
+    bool Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                VkDeviceSize size, VkBufferUsageFlags usage,
+                void const *src);
+
+    /// Copies 'size' bytes of 'src' at 'offset' in the buffer
+    void Write(void const *src, VkDeviceSize offset, VkDeviceSize size);
+
+    /// Destroys the buffer and frees its memory
+    void Destroy(VkDevice device);
+
+    VkBuffer       buffer;
+    VkDeviceMemory memory;
+    VkDeviceSize   size;
+    void *         data;
+};
+
+}  // end namespace internal
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_VK_MAPPED_BUFFER_H
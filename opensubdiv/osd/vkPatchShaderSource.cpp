@@ -0,0 +1,118 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/vkPatchShaderSource.h"
+#include <sstream>
+#include <string>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static const char *commonShaderSource =
+#include "glslPatchCommon.gen.h"
+;
+static const char *bsplineShaderSource =
+#include "glslPatchBSpline.gen.h"
+;
+static const char *gregoryShaderSource =
+#include "glslPatchGregory.gen.h"
+;
+static const char *gregoryBasisShaderSource =
+#include "glslPatchGregoryBasis.gen.h"
+;
+
+enum Stage {
+    VERTEX,
+    TESS_CONTROL,
+    TESS_EVAL
+};
+
+static std::string
+getStageShaderSource(Far::PatchDescriptor::Type type, Stage stage) {
+    static const char *stageNames[3] = {
+        "VERTEX", "TESS_CONTROL", "TESS_EVAL"
+    };
+
+    std::stringstream ss;
+    switch (type) {
+    case Far::PatchDescriptor::REGULAR:
+        ss << "#define OSD_PATCH_BSPLINE\n"
+           << "#define OSD_PATCH_" << stageNames[stage] << "_BSPLINE_SHADER\n"
+           << bsplineShaderSource;
+        break;
+    case Far::PatchDescriptor::GREGORY:
+        ss << "#define OSD_PATCH_GREGORY\n"
+           << "#define OSD_PATCH_" << stageNames[stage] << "_GREGORY_SHADER\n"
+           << gregoryShaderSource;
+        break;
+    case Far::PatchDescriptor::GREGORY_BOUNDARY:
+        ss << "#define OSD_PATCH_GREGORY_BOUNDARY\n"
+           << "#define OSD_PATCH_" << stageNames[stage] << "_GREGORY_SHADER\n"
+           << gregoryShaderSource;
+        break;
+    case Far::PatchDescriptor::GREGORY_BASIS:
+        ss << "#define OSD_PATCH_GREGORY_BASIS\n"
+           << "#define OSD_PATCH_" << stageNames[stage]
+           << "_GREGORY_BASIS_SHADER\n"
+           << gregoryBasisShaderSource;
+        break;
+    default:
+        break;  // returns empty (points, lines, quads, ...)
+    }
+    return ss.str();
+}
+
+/*static*/
+std::string
+VkPatchShaderSource::GetCommonShaderSource() {
+    return std::string("#define OSD_PATCH_VULKAN\n") + commonShaderSource;
+}
+
+/*static*/
+std::string
+VkPatchShaderSource::GetVertexShaderSource(Far::PatchDescriptor::Type type) {
+    return getStageShaderSource(type, VERTEX);
+}
+
+/*static*/
+std::string
+VkPatchShaderSource::GetTessControlShaderSource(
+    Far::PatchDescriptor::Type type) {
+    return getStageShaderSource(type, TESS_CONTROL);
+}
+
+/*static*/
+std::string
+VkPatchShaderSource::GetTessEvalShaderSource(
+    Far::PatchDescriptor::Type type) {
+    return getStageShaderSource(type, TESS_EVAL);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,112 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/vkPatchTable.h"
+
+#include "../far/patchTable.h"
+#include "../osd/cpuPatchTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+static VkBufferUsageFlags const patchBufferUsage =
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+    VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+VkPatchTable::VkPatchTable(VkDevice device) : _device(device) {
+}
+
+VkPatchTable::~VkPatchTable() {
+    _indexBuffer.Destroy(_device);
+    _patchParamBuffer.Destroy(_device);
+    for (size_t i = 0; i < _fvarIndexBuffers.size(); ++i) {
+        _fvarIndexBuffers[i].Destroy(_device);
+        _fvarParamBuffers[i].Destroy(_device);
+    }
+}
+
+VkPatchTable *
+VkPatchTable::Create(Far::PatchTable const *farPatchTable,
+                     VkDevice device, VkPhysicalDevice physicalDevice) {
+    VkPatchTable *instance = new VkPatchTable(device);
+    if (instance->allocate(farPatchTable, physicalDevice)) return instance;
+    delete instance;
+    return 0;
+}
+
+bool
+VkPatchTable::allocate(Far::PatchTable const *farPatchTable,
+                       VkPhysicalDevice physicalDevice) {
+    CpuPatchTable patchTable(farPatchTable);
+
+    size_t numPatchArrays = patchTable.GetNumPatchArrays();
+    VkDeviceSize indexSize = patchTable.GetPatchIndexSize();
+    VkDeviceSize patchParamSize = patchTable.GetPatchParamSize();
+
+    // copy patch array
+    _patchArrays.assign(patchTable.GetPatchArrayBuffer(),
+                        patchTable.GetPatchArrayBuffer() + numPatchArrays);
+
+    // copy index and patchparam buffers
+    if (!_indexBuffer.Create(_device, physicalDevice,
+                             indexSize * sizeof(int), patchBufferUsage,
+                             patchTable.GetPatchIndexBuffer()) ||
+        !_patchParamBuffer.Create(_device, physicalDevice,
+                                  patchParamSize * sizeof(PatchParam),
+                                  patchBufferUsage,
+                                  patchTable.GetPatchParamBuffer())) {
+        return false;
+    }
+
+    // face-varying channels
+    int numFVarChannels = patchTable.GetNumFVarChannels();
+    _fvarPatchArrays.resize(numFVarChannels);
+    _fvarIndexBuffers.resize(numFVarChannels);
+    _fvarParamBuffers.resize(numFVarChannels);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        _fvarPatchArrays[channel].assign(
+            patchTable.GetFVarPatchArrayBuffer(channel),
+            patchTable.GetFVarPatchArrayBuffer(channel) + 2);
+
+        if (!_fvarIndexBuffers[channel].Create(_device, physicalDevice,
+                patchTable.GetFVarPatchIndexSize(channel) * sizeof(int),
+                patchBufferUsage,
+                patchTable.GetFVarPatchIndexBuffer(channel)) ||
+            !_fvarParamBuffers[channel].Create(_device, physicalDevice,
+                patchTable.GetFVarPatchParamSize(channel) * sizeof(PatchParam),
+                patchBufferUsage,
+                patchTable.GetFVarPatchParamBuffer(channel))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
@@ -0,0 +1,133 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_VK_PATCH_TABLE_H
+#define OPENSUBDIV3_OSD_VK_PATCH_TABLE_H
+
+#include "../version.h"
+
+#include "../osd/vulkan.h"
+#include "../osd/nonCopyable.h"
+#include "../osd/types.h"
+#include "../osd/vkMappedBuffer.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far{
+    class PatchTable;
+};
+
+namespace Osd {
+
+/// \brief Vulkan patch table
+///
+/// This class is a Vulkan buffer representation of Far::PatchTable.
+///
+/// VkEvaluator consumes this table to evaluate on the patches. The index
+/// buffer can also be bound to draw the patches (VK_INDEX_TYPE_UINT32), and
+/// the patch parameter buffer read by the patch shaders as a storage buffer
+/// (see VkPatchShaderSource).
+///
+class VkPatchTable : private NonCopyable<VkPatchTable> {
+public:
+    typedef VkBuffer VertexBufferBinding;
+
+    /// Creator. Returns NULL if error
+    static VkPatchTable *Create(Far::PatchTable const *patchTable,
+                                VkDevice device,
+                                VkPhysicalDevice physicalDevice);
+
+    /// Creator from a client device context providing
+    ///   VkDevice GetDevice()
+    ///   VkPhysicalDevice GetPhysicalDevice()
+    /// methods.
+    template <typename DEVICE_CONTEXT>
+    static VkPatchTable * Create(Far::PatchTable const *patchTable,
+                                 DEVICE_CONTEXT context) {
+        return Create(patchTable,
+                      context->GetDevice(), context->GetPhysicalDevice());
+    }
+
+    /// Destructor
+    ~VkPatchTable();
+
+    /// Returns the patch arrays
+    PatchArrayVector const &GetPatchArrays() const { return _patchArrays; }
+
+    /// Returns the Vulkan buffer of the patch control vertices
+    VkBuffer GetPatchIndexBuffer() const { return _indexBuffer.buffer; }
+
+    /// Returns the Vulkan buffer of the array of Osd::PatchParam
+    VkBuffer GetPatchParamBuffer() const { return _patchParamBuffer.buffer; }
+
+    /// Returns the patch arrays of a face-varying channel (see
+    /// CpuPatchTable::GetFVarPatchArrayBuffer)
+    PatchArrayVector const &GetFVarPatchArrays(int fvarChannel = 0) const {
+        return _fvarPatchArrays[fvarChannel];
+    }
+
+    /// Returns the Vulkan buffer of the face-varying values of a channel
+    VkBuffer GetFVarPatchIndexBuffer(int fvarChannel = 0) const {
+        return _fvarIndexBuffers[fvarChannel].buffer;
+    }
+
+    /// Returns the Vulkan buffer of the face-varying Osd::PatchParam of a
+    /// channel
+    VkBuffer GetFVarPatchParamBuffer(int fvarChannel = 0) const {
+        return _fvarParamBuffers[fvarChannel].buffer;
+    }
+
+    /// Returns the number of face-varying channels
+    int GetNumFVarChannels() const { return (int)_fvarPatchArrays.size(); }
+
+protected:
+    explicit VkPatchTable(VkDevice device);
+
+    bool allocate(Far::PatchTable const *patchTable,
+                  VkPhysicalDevice physicalDevice);
+
+    VkDevice _device;
+
+    PatchArrayVector _patchArrays;
+
+    internal::VkMappedBuffer _indexBuffer;
+    internal::VkMappedBuffer _patchParamBuffer;
+
+    std::vector<PatchArrayVector> _fvarPatchArrays;
+    std::vector<internal::VkMappedBuffer> _fvarIndexBuffers;
+    std::vector<internal::VkMappedBuffer> _fvarParamBuffers;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_VK_PATCH_TABLE_H
@@ -0,0 +1,83 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../osd/vkVertexBuffer.h"
+#include "../far/profile.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+VkVertexBuffer::VkVertexBuffer(int numElements, int numVertices,
+                               VkDevice device)
+    : _numElements(numElements), _numVertices(numVertices), _device(device) {
+}
+
+VkVertexBuffer::~VkVertexBuffer() {
+
+    _buffer.Destroy(_device);
+}
+
+VkVertexBuffer *
+VkVertexBuffer::Create(int numElements, int numVertices,
+                       VkDevice device, VkPhysicalDevice physicalDevice) {
+    VkVertexBuffer *instance =
+        new VkVertexBuffer(numElements, numVertices, device);
+    if (instance->allocate(physicalDevice)) return instance;
+    delete instance;
+    return NULL;
+}
+
+void
+VkVertexBuffer::UpdateData(const float *src, int startVertex, int numVertices,
+                           void * /*deviceContext*/) {
+
+    OPENSUBDIV_PROFILE_ZONE("VkVertexBuffer::UpdateData");
+
+    VkDeviceSize elementSize = _numElements * sizeof(float);
+    VkDeviceSize size = elementSize * numVertices;
+    VkDeviceSize offset = elementSize * startVertex;
+
+    _buffer.Write(src, offset, size);
+}
+
+bool
+VkVertexBuffer::allocate(VkPhysicalDevice physicalDevice) {
+
+    VkDeviceSize size =
+        (VkDeviceSize)_numElements * _numVertices * sizeof(float);
+
+    return _buffer.Create(_device, physicalDevice, size,
+                          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
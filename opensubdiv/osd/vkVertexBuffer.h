@@ -0,0 +1,112 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_OSD_VK_VERTEX_BUFFER_H
+#define OPENSUBDIV3_OSD_VK_VERTEX_BUFFER_H
+
+#include "../version.h"
+
+#include "../osd/vulkan.h"
+#include "../osd/nonCopyable.h"
+#include "../osd/vkMappedBuffer.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+///
+/// \brief Concrete vertex buffer class for Vulkan subdivision.
+///
+/// VkVertexBuffer is a Vulkan buffer usable as a storage buffer by
+/// VkEvaluator and as a vertex buffer for drawing. Its memory is host visible
+/// and stays mapped : UpdateData writes the vertices directly, the client
+/// must not update vertices read or written by pending commands.
+///
+class VkVertexBuffer : private NonCopyable<VkVertexBuffer> {
+
+public:
+    /// Creator. Returns NULL if error.
+    static VkVertexBuffer * Create(int numElements, int numVertices,
+                                   VkDevice device,
+                                   VkPhysicalDevice physicalDevice);
+
+    /// Creator from a client device context providing
+    ///   VkDevice GetDevice()
+    ///   VkPhysicalDevice GetPhysicalDevice()
+    /// methods.
+    template <typename DEVICE_CONTEXT>
+    static VkVertexBuffer * Create(int numElements, int numVertices,
+                                   DEVICE_CONTEXT context) {
+        return Create(numElements, numVertices,
+                      context->GetDevice(), context->GetPhysicalDevice());
+    }
+
+    /// Destructor.
+    ~VkVertexBuffer();
+
+    /// This method is meant to be used in client code in order to provide
+    /// coarse vertices data to Osd.
+    void UpdateData(const float *src, int startVertex, int numVertices,
+                    void *deviceContext = NULL);
+
+    /// Returns how many elements defined in this vertex buffer.
+    int GetNumElements() const { return _numElements; }
+
+    /// Returns how many vertices allocated in this vertex buffer.
+    int GetNumVertices() const { return _numVertices; }
+
+    /// Returns the Vulkan buffer.
+    VkBuffer BindVkBuffer() const { return _buffer.buffer; }
+
+    /// Returns the Vulkan buffer (to be bound as a vertex buffer).
+    VkBuffer BindVBO(void *deviceContext = NULL) const {
+        (void)deviceContext;  // unused
+        return _buffer.buffer;
+    }
+
+protected:
+    /// Constructor.
+    VkVertexBuffer(int numElements, int numVertices, VkDevice device);
+
+    /// Allocates Vulkan memory for this buffer.
+    /// Returns true if success.
+    bool allocate(VkPhysicalDevice physicalDevice);
+
+private:
+    int _numElements;
+    int _numVertices;
+    VkDevice _device;
+    internal::VkMappedBuffer _buffer;
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_VK_VERTEX_BUFFER_H
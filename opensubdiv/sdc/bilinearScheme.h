@@ -52,6 +52,16 @@ inline int Scheme<SCHEME_BILINEAR>::GetRegularVertexValence() { return 4; }
 template <>
 inline int Scheme<SCHEME_BILINEAR>::GetLocalNeighborhoodSize() { return 0; }
 
+//  Vertices are always assigned the Corner mask:
+template <>
+inline float Scheme<SCHEME_BILINEAR>::GetRegularSmoothVertexWeight() { return 1.0f; }
+
+template <>
+inline float Scheme<SCHEME_BILINEAR>::GetRegularSmoothEdgeWeight() { return 0.0f; }
+
+template <>
+inline float Scheme<SCHEME_BILINEAR>::GetRegularSmoothFaceWeight() { return 0.0f; }
+
 
 //
 //  Refinement masks:
@@ -55,6 +55,16 @@ inline int Scheme<SCHEME_CATMARK>::GetRegularVertexValence() { return 4; }
 template <>
 inline int Scheme<SCHEME_CATMARK>::GetLocalNeighborhoodSize() { return 1; }
 
+//  (n-2)/n for the vertex and 1/n^2 per edge and face, with n = 4:
+template <>
+inline float Scheme<SCHEME_CATMARK>::GetRegularSmoothVertexWeight() { return 0.5f; }
+
+template <>
+inline float Scheme<SCHEME_CATMARK>::GetRegularSmoothEdgeWeight() { return 0.0625f; }
+
+template <>
+inline float Scheme<SCHEME_CATMARK>::GetRegularSmoothFaceWeight() { return 0.0625f; }
+
 
 //
 //  Masks for edge-vertices:  the hard Crease mask does not need to be specialized
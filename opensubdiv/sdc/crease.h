@@ -132,6 +132,17 @@ public:
     void SubdivideEdgeSharpnessesAroundVertex(int          incidentEdgeCountAtVertex,
                                               float const* incidentEdgeSharpnessAroundVertex,
                                               float*       childEdgesSharpnessAroundVertex) const;
+
+    ///  Batched versions of the Uniform and vertex sharpness subdivision, applied to arrays of
+    ///  values without branching on each (the parent and child arrays may be the same):
+    ///
+    void SubdivideUniformSharpnesses(int          count,
+                                     float const* sharpness,
+                                     float*       childSharpness) const;
+
+    void SubdivideVertexSharpnesses(int          count,
+                                    float const* vertexSharpness,
+                                    float*       childVertexSharpness) const;
     //@}
 
     //@{
@@ -146,6 +157,14 @@ public:
                                    float const* incidentEdgeSharpness) const;
     Rule DetermineVertexVertexRule(float        vertexSharpness,
                                    int          sharpEdgeCount) const;
+
+    ///  Batched version of the above for arrays of vertices given their count of sharp
+    ///  incident edges (all vertices are considered Smooth if no sharpness is given):
+    ///
+    void DetermineVertexVertexRules(int          count,
+                                    float const* vertexSharpness,
+                                    int const*   sharpEdgeCounts,
+                                    Rule*        rules) const;
     //@}
 
     ///  \brief Transitional weighting:
@@ -224,6 +243,36 @@ Crease::SubdivideVertexSharpness(float vertexSharpness) const {
     return decrementSharpness(vertexSharpness);
 }
 
+inline void
+Crease::SubdivideUniformSharpnesses(int count, float const* sharpness,
+                                    float* childSharpness) const {
+
+    //  Equivalent to decrementSharpness() for each value, reduced to selections:
+    for (int i = 0; i < count; ++i) {
+        float s = sharpness[i];
+        childSharpness[i] = (s >= SHARPNESS_INFINITE) ? SHARPNESS_INFINITE :
+                           ((s > 1.0f) ? (s - 1.0f) : SHARPNESS_SMOOTH);
+    }
+}
+
+inline void
+Crease::SubdivideVertexSharpnesses(int count, float const* vertexSharpness,
+                                   float* childVertexSharpness) const {
+
+    SubdivideUniformSharpnesses(count, vertexSharpness, childVertexSharpness);
+}
+
+inline void
+Crease::DetermineVertexVertexRules(int count, float const* vertexSharpness,
+                                   int const* sharpEdgeCounts, Rule* rules) const {
+
+    for (int i = 0; i < count; ++i) {
+        bool isCorner = (sharpEdgeCounts[i] > 2) ||
+                        (vertexSharpness && IsSharp(vertexSharpness[i]));
+        rules[i] = isCorner ? RULE_CORNER : (Rule)(1 << sharpEdgeCounts[i]);
+    }
+}
+
 inline void
 Crease::GetSharpEdgePairOfCrease(float const * incidentEdgeSharpness, int incidentEdgeCount,
                                  int sharpEdgePair[2]) const {
@@ -55,6 +55,16 @@ inline int Scheme<SCHEME_LOOP>::GetRegularVertexValence() { return 6; }
 template <>
 inline int Scheme<SCHEME_LOOP>::GetLocalNeighborhoodSize() { return 1; }
 
+//  5/8 for the vertex and 1/16 per edge:
+template <>
+inline float Scheme<SCHEME_LOOP>::GetRegularSmoothVertexWeight() { return 0.625f; }
+
+template <>
+inline float Scheme<SCHEME_LOOP>::GetRegularSmoothEdgeWeight() { return 0.0625f; }
+
+template <>
+inline float Scheme<SCHEME_LOOP>::GetRegularSmoothFaceWeight() { return 0.0f; }
+
 
 //
 //  Protected methods to assign the two types of masks for an edge-vertex --
@@ -155,6 +155,16 @@ public:
     static int   GetRegularVertexValence();
     static int   GetLocalNeighborhoodSize();
 
+    //
+    //  Constant weights of the vertex-vertex mask of a Smooth interior vertex of regular
+    //  valence -- applied to the vertex itself, to the vertex opposite each incident edge and
+    //  to the child vertex of each incident face -- allowing the most common vertices to be
+    //  refined without computing their mask:
+    //
+    static float GetRegularSmoothVertexWeight();
+    static float GetRegularSmoothEdgeWeight();
+    static float GetRegularSmoothFaceWeight();
+
 protected:
 
     //
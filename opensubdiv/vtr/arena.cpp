@@ -0,0 +1,112 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../vtr/arena.h"
+#include "../far/memoryResource.h"
+
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Vtr {
+namespace internal {
+
+Arena::Arena(size_t blockSize, Far::MemoryResource * resource) :
+    _resource(resource),
+    _next(0),
+    _remaining(0),
+    _blockSize(alignSize(blockSize)),
+    _bytesAllocated(0),
+    _bytesReserved(0) {
+}
+
+Arena::~Arena() {
+    clear();
+}
+
+void
+Arena::clear() {
+
+    for (int i = 0; i < (int)_blocks.size(); ++i) {
+        if (_resource) {
+            _resource->Deallocate(_blocks[i], _blockSizes[i]);
+        } else {
+            ::operator delete(_blocks[i]);
+        }
+    }
+    std::vector<char *>().swap(_blocks);
+    std::vector<size_t>().swap(_blockSizes);
+
+    _next = 0;
+    _remaining = 0;
+    _bytesAllocated = 0;
+    _bytesReserved = 0;
+}
+
+void
+Arena::allocateBlock(size_t size) {
+
+    //  Blocks are allocated from operator new (or a resource aligning as it does)
+    //  and so are suitably aligned:
+    _next = static_cast<char *>(_resource ? _resource->Allocate(size) : ::operator new(size));
+    _remaining = size;
+
+    _blocks.push_back(_next);
+    _blockSizes.push_back(size);
+    _bytesReserved += size;
+}
+
+void
+Arena::reserve(size_t size) {
+
+    size = alignSize(size);
+    if (size > _remaining) {
+        allocateBlock(size);
+    }
+}
+
+void *
+Arena::allocate(size_t size) {
+
+    size = alignSize(size);
+    if (size > _remaining) {
+        //  Large requests get a block of their own rather than wasting the
+        //  remainder of a new default block:
+        allocateBlock((size > _blockSize / 2) ? size : _blockSize);
+    }
+    assert(size <= _remaining);
+
+    void * ptr = _next;
+    _next += size;
+    _remaining -= size;
+    _bytesAllocated += size;
+    return ptr;
+}
+
+} // end namespace internal
+} // end namespace Vtr
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,168 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_VTR_ARENA_H
+#define OPENSUBDIV3_VTR_ARENA_H
+
+#include "../version.h"
+
+#include "../vtr/types.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far { class MemoryResource; }
+
+namespace Vtr {
+namespace internal {
+
+//
+//  The Arena class is a simple monotonic allocator -- memory is carved from large
+//  blocks and is only released when the Arena is cleared or destroyed.  It is
+//  intended to hold the vectors of the refined Levels and Refinements of a single
+//  TopologyRefiner:  these vectors are sized once from the child component counts
+//  determined early in refinement and live as long as the refinement itself, so
+//  allocating them contiguously avoids hundreds of small heap allocations (and the
+//  contention on the global heap when many refiners are built concurrently).
+//
+//  Blocks are allocated from the heap unless a MemoryResource of the client is
+//  assigned, in which case they are allocated from and returned to it.
+//
+//  An Arena is not thread-safe -- it must only be used by the thread refining its
+//  TopologyRefiner (allocation always precedes any concurrent population of the
+//  vectors within a Refinement).
+//
+class Arena {
+public:
+    Arena(size_t blockSize = 256 * 1024, Far::MemoryResource * resource = 0);
+    ~Arena();
+
+    //  Allocation is aligned for any of the types stored in a Level:
+    void * allocate(size_t size);
+
+    //  Ensure the current block can hold 'size' bytes, allocating a block of
+    //  exactly that size when not:
+    void reserve(size_t size);
+
+    //  Release all blocks -- any memory previously allocated becomes invalid:
+    void clear();
+
+    size_t getNumBlocks() const { return _blocks.size(); }
+    size_t getBytesAllocated() const { return _bytesAllocated; }
+    size_t getBytesReserved() const { return _bytesReserved; }
+
+private:
+    //  Non-copyable:
+    Arena(Arena const &);
+    Arena & operator=(Arena const &);
+
+    void allocateBlock(size_t size);
+
+    static size_t alignSize(size_t size) { return (size + 15) & ~size_t(15); }
+
+private:
+    std::vector<char *> _blocks;
+    std::vector<size_t> _blockSizes;
+
+    Far::MemoryResource * _resource;
+
+    char * _next;
+    size_t _remaining;
+
+    size_t _blockSize;
+    size_t _bytesAllocated;
+    size_t _bytesReserved;
+};
+
+//
+//  STL allocator drawing from an optional Arena -- when no Arena is assigned (the
+//  default) memory is allocated from the heap as with std::allocator, so vectors
+//  using this allocator behave as any other unless explicitly constructed with an
+//  Arena.  Deallocation of memory from an Arena is a no-op.
+//
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T              value_type;
+    typedef T *            pointer;
+    typedef T const *      const_pointer;
+    typedef T &            reference;
+    typedef T const &      const_reference;
+    typedef std::size_t    size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U> struct rebind { typedef ArenaAllocator<U> other; };
+
+public:
+    ArenaAllocator(Arena * arena = 0) : _arena(arena) { }
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const & a) : _arena(a.getArena()) { }
+
+    Arena * getArena() const { return _arena; }
+
+    pointer allocate(size_type n, void const * = 0) {
+        size_t size = n * sizeof(T);
+        return static_cast<pointer>(_arena ? _arena->allocate(size) : ::operator new(size));
+    }
+    void deallocate(pointer p, size_type) {
+        if (!_arena) ::operator delete(p);
+    }
+
+    void construct(pointer p, T const & value) { new (p) T(value); }
+    void destroy(pointer p) { p->~T(); }
+
+    pointer       address(reference r) const       { return &r; }
+    const_pointer address(const_reference r) const { return &r; }
+
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+    template <typename U>
+    bool operator==(ArenaAllocator<U> const & a) const { return _arena == a.getArena(); }
+    template <typename U>
+    bool operator!=(ArenaAllocator<U> const & a) const { return _arena != a.getArena(); }
+
+private:
+    Arena * _arena;
+};
+
+//
+//  Vectors of the refined topology optionally allocated from an Arena:
+//
+typedef std::vector<Index,      ArenaAllocator<Index> >      ArenaIndexVector;
+typedef std::vector<LocalIndex, ArenaAllocator<LocalIndex> > ArenaLocalIndexVector;
+typedef std::vector<float,      ArenaAllocator<float> >      ArenaFloatVector;
+
+} // end namespace internal
+} // end namespace Vtr
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_VTR_ARENA_H */
@@ -55,7 +55,31 @@ FVarLevel::FVarLevel(Level const& level) :
     _isLinear(false),
     _hasLinearBoundaries(false),
     _hasDependentSharpness(false),
+    _isVertexTopologyAlias(false),
     _valueCount(0) {
+
+    _edgeTagMatch.clear();
+    _valueTagMatch.clear();
+}
+
+FVarLevel::FVarLevel(Level const& level, FVarLevel const& source) :
+    _level(level),
+    _options(source._options),
+    _isLinear(source._isLinear),
+    _hasLinearBoundaries(source._hasLinearBoundaries),
+    _hasDependentSharpness(source._hasDependentSharpness),
+    _isVertexTopologyAlias(source._isVertexTopologyAlias),
+    _valueCount(source._valueCount),
+    _edgeTagMatch(source._edgeTagMatch),
+    _valueTagMatch(source._valueTagMatch),
+    _faceVertValues(source._faceVertValues),
+    _edgeTags(source._edgeTags),
+    _vertSiblingCounts(source._vertSiblingCounts),
+    _vertSiblingOffsets(source._vertSiblingOffsets),
+    _vertFaceSiblings(source._vertFaceSiblings),
+    _vertValueIndices(source._vertValueIndices),
+    _vertValueTags(source._vertValueTags),
+    _vertValueCreaseEnds(source._vertValueCreaseEnds) {
 }
 
 FVarLevel::~FVarLevel() {
@@ -120,8 +144,60 @@ FVarLevel::resizeValues(int valueCount) {
 //  the tags to child values using more simplified logic (child values inherit the
 //  topology of their parent) and no futher analysis is required.
 //
+//  Each of the passes through vertices (and edges) writes only to the components being
+//  iterated, so each is applied concurrently to sub-ranges of its components when
+//  concurrency is specified.  What was once accomplished in a single pass through the
+//  vertices is split in several to avoid the tagging of one vertex or edge from another,
+//  and the results are identical to those of the serial pass that preceded it.
+//
+struct FVarLevel::CompletionState {
+    FVarLevel * fvarLevel;
+
+    //  Discontinuities detected at each end of each edge (inspected from that end), and
+    //  vertices mismatching topology (2 when also making their boundary edges linear):
+    std::vector<LocalIndex> edgeEndDiscts;
+    std::vector<LocalIndex> vertexMismatch;
+
+    int  regularBoundaryValence;
+    bool makeSmoothCornersSharp;
+    bool fvarCornersAreSharp;
+    bool sharpenBothIfOneCorner;
+    bool sharpenDarts;
+};
+
+namespace {
+    void
+    identifyVertexSiblingRanges(int vBegin, int vEnd, void * data) {
+
+        FVarLevel::CompletionState & state = *static_cast<FVarLevel::CompletionState *>(data);
+        state.fvarLevel->identifyVertexSiblings(vBegin, vEnd, state);
+    }
+
+    void
+    identifyVertexMismatchRanges(int vBegin, int vEnd, void * data) {
+
+        FVarLevel::CompletionState & state = *static_cast<FVarLevel::CompletionState *>(data);
+        state.fvarLevel->identifyVertexMismatches(vBegin, vEnd, state);
+    }
+
+    void
+    tagEdgeRanges(int eBegin, int eEnd, void * data) {
+
+        FVarLevel::CompletionState & state = *static_cast<FVarLevel::CompletionState *>(data);
+        state.fvarLevel->tagEdges(eBegin, eEnd, state);
+    }
+
+    void
+    tagVertexValueRanges(int vBegin, int vEnd, void * data) {
+
+        FVarLevel::CompletionState & state = *static_cast<FVarLevel::CompletionState *>(data);
+        state.fvarLevel->tagVertexValues(vBegin, vEnd, state);
+    }
+}
+
 void
-FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
+FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence,
+                                          Level::Concurrency const & concurrency) {
 
     //
     //  Assign some members and local variables based on the interpolation options (the
@@ -146,27 +222,35 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
                              (fvarOptions == Options::FVAR_LINEAR_CORNERS_PLUS2);
 
     bool geomCornersAreSmooth = (geomOptions != Options::VTX_BOUNDARY_EDGE_AND_CORNER);
-    bool fvarCornersAreSharp  = (fvarOptions != Options::FVAR_LINEAR_NONE);
-
-    bool makeSmoothCornersSharp = geomCornersAreSmooth && fvarCornersAreSharp;
-
-    bool sharpenBothIfOneCorner  = (fvarOptions == Options::FVAR_LINEAR_CORNERS_PLUS2);
 
-    bool sharpenDarts = sharpenBothIfOneCorner || _hasLinearBoundaries;
+    CompletionState state;
+    state.fvarLevel = this;
+    state.regularBoundaryValence = regularBoundaryValence;
 
+    state.fvarCornersAreSharp    = (fvarOptions != Options::FVAR_LINEAR_NONE);
+    state.makeSmoothCornersSharp = geomCornersAreSmooth && state.fvarCornersAreSharp;
+    state.sharpenBothIfOneCorner = (fvarOptions == Options::FVAR_LINEAR_CORNERS_PLUS2);
+    state.sharpenDarts           = state.sharpenBothIfOneCorner || _hasLinearBoundaries;
 
     //
-    //  Its awkward and potentially inefficient to try and accomplish everything in one
-    //  pass over the vertices...
+    //  Channels whose face-values are the face-vertices and that the options do not
+    //  make mismatch anywhere require none of the analysis that follows -- they are
+    //  simply an alias of the vertex topology:
+    //
+    if (faceValuesMatchVertexTopology(state)) {
+        aliasVertexTopology();
+        return;
+    }
+
     //
     //  Make a first pass through the vertices to identify discts edges and to determine
     //  the number of values-per-vertex for subsequent allocation.  The presence of a
     //  discts edge warrants marking vertices at BOTH ends as having mismatched topology
     //  wrt the vertices (part of why full topological analysis is deferred).
     //
-    //  So this first pass will allocate/initialize the overall structure of the topology.
-    //  Given N vertices and M (as yet unknown) sibling values, the first pass achieves
-    //  the following:
+    //  So this first pass (and those immediately following it) will allocate/initialize
+    //  the overall structure of the topology.  Given N vertices and M (as yet unknown)
+    //  sibling values, these first passes achieve the following:
     //
     //      - assigns a local vector indicating which of the N vertices "match"
     //          - requires a single value but must also have no discts incident edges
@@ -176,25 +260,110 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
     //  and
     //      - tags any incident edges as discts
     //
-    //  The second pass initializes remaining members based on the total number of siblings
+    //  The final pass initializes remaining members based on the total number of siblings
     //  M after allocating appropriate vectors dependent on M.
     //
-    std::vector<LocalIndex> vertexMismatch(_level.getNumVertices(), 0);
+    state.edgeEndDiscts.resize(2 * _level.getNumEdges(), 0);
+    state.vertexMismatch.resize(_level.getNumVertices(), 0);
 
     _vertFaceSiblings.resize(_level.getNumVertexFacesTotal(), 0);
 
+    Level::applyConcurrently(concurrency, _level.getNumVertices(), identifyVertexSiblingRanges, &state);
+    Level::applyConcurrently(concurrency, _level.getNumVertices(), identifyVertexMismatchRanges, &state);
+    Level::applyConcurrently(concurrency, _level.getNumEdges(), tagEdgeRanges, &state);
+
+    //
+    //  Update the value offsets for all vertices from the cumulative totals:
+    //
+    int totalValueCount = 0;
+    for (int vIndex = 0; vIndex < _level.getNumVertices(); ++vIndex) {
+        _vertSiblingOffsets[vIndex] = totalValueCount;
+
+        totalValueCount += _vertSiblingCounts[vIndex];
+    }
+
+    //
+    //  Now that we know the total number of additional sibling values (M values in addition
+    //  to the N vertex values) allocate space to accomodate all N + M vertex values.  The
+    //  vertex value tags will be initialized to match, and we proceed to sparsely mark the
+    //  vertices that mismatch:
+    //
+    resizeVertexValues(totalValueCount);
+
+    Level::applyConcurrently(concurrency, _level.getNumVertices(), tagVertexValueRanges, &state);
+
+    //printf("completed fvar topology...\n");
+    //print();
+    //printf("validating...\n");
+    //assert(validate());
+}
+
+//
+//  Identify a channel whose values are exactly those of the vertices and none of which
+//  would be tagged as mismatched -- without discts edges, only the boundary vertices
+//  inspected for the interpolation options in identifyVertexMismatches() may mismatch:
+//
+bool
+FVarLevel::faceValuesMatchVertexTopology(CompletionState const & state) const {
+
+    if (_valueCount != _level.getNumVertices()) return false;
+
+    ConstIndexArray faceVerts = _level.getFaceVertices();
+    if (!std::equal(faceVerts.begin(), faceVerts.end(), _faceVertValues.begin())) {
+        return false;
+    }
+
+    for (int vIndex = 0; vIndex < _level.getNumVertices(); ++vIndex) {
+        if (!_level.getVertexTag(vIndex)._boundary) continue;
+
+        int vFaceCount = _level.getNumVertexFaces(vIndex);
+        if (_hasLinearBoundaries && (vFaceCount > 0)) {
+            return false;
+        }
+        if ((vFaceCount == 1) && state.makeSmoothCornersSharp) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+//  Release the topology of a channel aliasing that of the vertices -- all that remains
+//  is the mapping of vertices to their values, which is the identity:
+//
+void
+FVarLevel::aliasVertexTopology() {
+
+    _isVertexTopologyAlias = true;
+    _valueCount = _level.getNumVertices();
+
+    std::vector<Index>().swap(_faceVertValues);
+    std::vector<ETag>().swap(_edgeTags);
+    std::vector<Sibling>().swap(_vertSiblingCounts);
+    std::vector<int>().swap(_vertSiblingOffsets);
+    std::vector<Sibling>().swap(_vertFaceSiblings);
+    std::vector<ValueTag>().swap(_vertValueTags);
+    std::vector<CreaseEndPair>().swap(_vertValueCreaseEnds);
+
+    _vertValueIndices.resize(_valueCount);
+    for (int i = 0; i < _valueCount; ++i) {
+        _vertValueIndices[i] = i;
+    }
+}
+
+void
+FVarLevel::identifyVertexSiblings(Index vBegin, Index vEnd, CompletionState & state) {
+
     int const maxValence = _level.getMaxValence();
 
     internal::StackBuffer<Index,16>     indexBuffer(maxValence);
     internal::StackBuffer<int,16>       valueBuffer(maxValence);
     internal::StackBuffer<Sibling,16>   siblingBuffer(maxValence);
-    internal::StackBuffer<ValueSpan,16> spanBuffer(maxValence);
 
     int *     uniqueValues   = valueBuffer;
     Sibling * vValueSiblings = siblingBuffer;
 
-    int totalValueCount = 0;
-    for (int vIndex = 0; vIndex < _level.getNumVertices(); ++vIndex) {
+    for (int vIndex = vBegin; vIndex < vEnd; ++vIndex) {
         //
         //  Retrieve the FVar values from each incident face and store locally for
         //  use -- we will identify the index of its corresponding "sibling" as we
@@ -210,12 +379,15 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
         }
 
         //
-        //  Inspect the incident edges of the vertex and tag those whose FVar values are
+        //  Inspect the incident edges of the vertex and identify those whose FVar values are
         //  discts between the two (or more) faces sharing that edge.  When manifold, we
         //  know an edge is discts when two successive fvar-values differ -- so we will
         //  make use of the local buffer of values.  Unfortunately we can't infer anything
         //  about the edges for a non-manifold vertex, so that case will be more complex.
         //
+        //  The edges and their end vertices are tagged in later passes -- here only the
+        //  end of the edge corresponding to this vertex is marked:
+        //
         ConstIndexArray       vEdges  = _level.getVertexEdges(vIndex);
         ConstLocalIndexArray  vInEdge = _level.getVertexEdgeLocalIndices(vIndex);
 
@@ -233,20 +405,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
                 int vFacePrev = i ? (i - 1) : (vFaces.size() - 1);
 
                 if (vValues[vFaceNext] != vValues[vFacePrev]) {
-                    Index eIndex = vEdges[i];
-
-                    //  Tag both end vertices as not matching topology:
-                    ConstIndexArray eVerts = _level.getEdgeVertices(eIndex);
-                    vertexMismatch[eVerts[0]] = true;
-                    vertexMismatch[eVerts[1]] = true;
-
-                    //  Tag the corresponding edge as discts:
-                    ETag& eTag = _edgeTags[eIndex];
-
-                    eTag._disctsV0 = (eVerts[0] == vIndex);
-                    eTag._disctsV1 = (eVerts[1] == vIndex);
-                    eTag._mismatch = true;
-                    eTag._linear = (ETag::ETagSize) _hasLinearBoundaries;
+                    state.edgeEndDiscts[2 * vEdges[i] + vInEdge[i]] = true;
                 }
             }
         } else if (vFaces.size() > 0) {
@@ -286,44 +445,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
                     }
                 }
                 if (markEdgeDiscts) {
-                    //  Tag both end vertices as not matching topology:
-                    vertexMismatch[eVerts[0]] = true;
-                    vertexMismatch[eVerts[1]] = true;
-
-                    //  Tag the corresponding edge as discts:
-                    ETag& eTag = _edgeTags[eIndex];
-
-                    eTag._disctsV0 = (eVerts[0] == vIndex);
-                    eTag._disctsV1 = (eVerts[1] == vIndex);
-                    eTag._mismatch = true;
-                    eTag._linear = (ETag::ETagSize) _hasLinearBoundaries;
-                }
-            }
-        }
-
-        //
-        //  While we've tagged the vertex as having mismatched FVar topology in the presence of
-        //  any discts edges, we also need to account for different treatment of vertices along
-        //  geometric boundaries if the FVar interpolation rules affect them.  So inspect all
-        //  boundary vertices that have not already been tagged.
-        //
-        if (vIsBoundary && !vertexMismatch[vIndex]) {
-            if (_hasLinearBoundaries && (vFaces.size() > 0)) {
-                vertexMismatch[vIndex] = true;
-
-                if (vIsManifold) {
-                    _edgeTags[vEdges[0]]._linear = true;
-                    _edgeTags[vEdges[vEdges.size()-1]]._linear = true;
-                } else {
-                    for (int i = 0; i < vEdges.size(); ++i) {
-                        if (_level.getEdgeTag(vEdges[i])._boundary) {
-                            _edgeTags[vEdges[i]]._linear = true;
-                        }
-                    }
-                }
-            } else if (vFaces.size() == 1) {
-                if (makeSmoothCornersSharp) {
-                    vertexMismatch[vIndex] = true;
+                    state.edgeEndDiscts[2 * eIndex + vertInEdge] = true;
                 }
             }
         }
@@ -365,12 +487,9 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
         }
 
         //
-        //  Update the value count and offset for this vertex and cumulative totals:
+        //  Update the value count for this vertex (offsets follow from the totals later):
         //
-        _vertSiblingCounts[vIndex]  = (LocalIndex) uniqueValueCount;
-        _vertSiblingOffsets[vIndex] = totalValueCount;
-
-        totalValueCount += uniqueValueCount;
+        _vertSiblingCounts[vIndex] = (LocalIndex) uniqueValueCount;
 
         //  Update the vert-face siblings from the local array above:
         if (uniqueValueCount > 1) {
@@ -380,16 +499,104 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
             }
         }
     }
+}
+
+void
+FVarLevel::identifyVertexMismatches(Index vBegin, Index vEnd, CompletionState & state) {
+
+    for (int vIndex = vBegin; vIndex < vEnd; ++vIndex) {
+        //
+        //  A discts edge marks vertices at both ends as having mismatched topology.  When
+        //  inspected in order, vertices along geometric boundaries that were not already
+        //  marked -- by a discts edge detected at this vertex or at a preceding one -- are
+        //  then inspected in case the FVar interpolation rules affect them.  Both are
+        //  determined here as they were in that order:
+        //
+        ConstIndexArray vEdges = _level.getVertexEdges(vIndex);
+
+        bool vIsMismatched      = false;
+        bool vIsMismatchedEarly = false;
+        for (int i = 0; i < vEdges.size(); ++i) {
+            ConstIndexArray eVerts = _level.getEdgeVertices(vEdges[i]);
+
+            for (int j = 0; j < 2; ++j) {
+                if (state.edgeEndDiscts[2 * vEdges[i] + j]) {
+                    vIsMismatched       = true;
+                    vIsMismatchedEarly |= (eVerts[j] <= vIndex);
+                }
+            }
+        }
+
+        LocalIndex vMismatch = vIsMismatched;
+
+        if (_level.getVertexTag(vIndex)._boundary && !vIsMismatchedEarly) {
+            int vFaceCount = _level.getNumVertexFaces(vIndex);
+
+            if (_hasLinearBoundaries && (vFaceCount > 0)) {
+                vMismatch = 2;
+            } else if (vFaceCount == 1) {
+                if (state.makeSmoothCornersSharp) {
+                    vMismatch = true;
+                }
+            }
+        }
+        state.vertexMismatch[vIndex] = vMismatch;
+    }
+}
+
+void
+FVarLevel::tagEdges(Index eBegin, Index eEnd, CompletionState & state) {
+
+    for (int eIndex = eBegin; eIndex < eEnd; ++eIndex) {
+        ConstIndexArray eVerts = _level.getEdgeVertices(eIndex);
+
+        ETag& eTag = _edgeTags[eIndex];
+
+        //
+        //  Tag the edge as discts -- its end is that of the last vertex (in order) at
+        //  which it was found discts:
+        //
+        bool disctsAtV0 = (state.edgeEndDiscts[2 * eIndex]     != 0);
+        bool disctsAtV1 = (state.edgeEndDiscts[2 * eIndex + 1] != 0);
+
+        if (disctsAtV0 || disctsAtV1) {
+            Index vLast = !disctsAtV1 ? eVerts[0] :
+                          !disctsAtV0 ? eVerts[1] : std::max(eVerts[0], eVerts[1]);
+
+            eTag._disctsV0 = (eVerts[0] == vLast);
+            eTag._disctsV1 = (eVerts[1] == vLast);
+            eTag._mismatch = true;
+            eTag._linear = (ETag::ETagSize) _hasLinearBoundaries;
+        }
+
+        //
+        //  Tag the edge as linear if a boundary edge of either end vertex inspected
+        //  for linear boundaries above:
+        //
+        for (int i = 0; i < 2; ++i) {
+            Index vIndex = eVerts[i];
+            if (state.vertexMismatch[vIndex] != 2) continue;
+
+            if (!_level.getVertexTag(vIndex)._nonManifold) {
+                ConstIndexArray vEdges = _level.getVertexEdges(vIndex);
+                if ((vEdges[0] == eIndex) || (vEdges[vEdges.size()-1] == eIndex)) {
+                    eTag._linear = true;
+                }
+            } else if (_level.getEdgeTag(eIndex)._boundary) {
+                eTag._linear = true;
+            }
+        }
+    }
+}
+
+void
+FVarLevel::tagVertexValues(Index vBegin, Index vEnd, CompletionState & state) {
 
     //
-    //  Now that we know the total number of additional sibling values (M values in addition
-    //  to the N vertex values) allocate space to accomodate all N + M vertex values.  The
-    //  vertex value tags will be initialized to match, and we proceed to sparsely mark the
+    //  The vertex value tags were initialized to match, and we proceed to sparsely mark the
     //  vertices that mismatch, so initialize a few local ValueTag constants for that purpose
     //  (assigning entire Tag structs is much more efficient than setting individual bits)
     //
-    resizeVertexValues(totalValueCount);
-
     ValueTag valueTagMismatch;
     valueTagMismatch.clear();
     valueTagMismatch._mismatch = true;
@@ -403,11 +610,13 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
     ValueTag valueTagDepSharp = valueTagSemiSharp;
     valueTagDepSharp._depSharp = true;
 
+    internal::StackBuffer<ValueSpan,16> spanBuffer(_level.getMaxValence());
+
     //
-    //  Now the second pass through the vertices to identify the values associated with the
+    //  Now the final pass through the vertices to identify the values associated with the
     //  vertex and to inspect and tag local face-varying topology for those that don't match:
     //
-    for (int vIndex = 0; vIndex < _level.getNumVertices(); ++vIndex) {
+    for (int vIndex = vBegin; vIndex < vEnd; ++vIndex) {
         ConstIndexArray       vFaces  = _level.getVertexFaces(vIndex);
         ConstLocalIndexArray  vInFace = _level.getVertexFaceLocalIndices(vIndex);
 
@@ -424,7 +633,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
         } else {
             vValues[0] = 0;
         }
-        if (!vertexMismatch[vIndex]) {
+        if (!state.vertexMismatch[vIndex]) {
             continue;
         }
         if (vValues.size() > 1) {
@@ -465,7 +674,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
 
         bool allCornersAreSharp = _hasLinearBoundaries || vTag._infSharp || vTag._nonManifold ||
                                   (_hasDependentSharpness && (vValues.size() > 2)) ||
-                                  (sharpenDarts && (vValues.size() == 1) && !vTag._boundary);
+                                  (state.sharpenDarts && (vValues.size() == 1) && !vTag._boundary);
         if (allCornersAreSharp) {
             std::fill(vValueTags.begin(), vValueTags.end(), valueTagMismatch);
             continue;
@@ -501,7 +710,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
             allCornersAreSharp = vValueSpans[0]._disjoint || vValueSpans[1]._disjoint;
 
             //  Detect a sharp corner, making both sharp:
-            if (sharpenBothIfOneCorner) {
+            if (state.sharpenBothIfOneCorner) {
                 allCornersAreSharp |= (vValueSpans[0]._size == 1) || (vValueSpans[1]._size == 1);
             }
 
@@ -525,7 +734,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
         for (int i = 0; i < vValues.size(); ++i) {
             ValueSpan const & vSpan = vValueSpans[i];
 
-            if (vSpan._disjoint || ((vSpan._size == 1) && fvarCornersAreSharp)) {
+            if (vSpan._disjoint || ((vSpan._size == 1) && state.fvarCornersAreSharp)) {
                 vValueTags[i] = valueTagMismatch;
             } else {
                 if ((vSpan._semiSharp > 0) || vTag._semiSharp) {
@@ -535,7 +744,7 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
                 } else {
                     vValueTags[i] = valueTagCrease;
                 }
-                if (vSpan._size != regularBoundaryValence) {
+                if (vSpan._size != state.regularBoundaryValence) {
                     vValueTags[i]._xordinary = true;
                 }
 
@@ -548,10 +757,6 @@ FVarLevel::completeTopologyFromFaceValues(int regularBoundaryValence) {
             }
         }
     }
-    //printf("completed fvar topology...\n");
-    //print();
-    //printf("validating...\n");
-    //assert(validate());
 }
 
 //
@@ -589,6 +794,17 @@ FVarLevel::getVertexCreaseEndValues(Index vIndex, Sibling vSibling, Index endVal
 bool
 FVarLevel::validate() const {
 
+    //
+    //  An alias of the vertex topology retains only the identity mapping of values:
+    //
+    if (_isVertexTopologyAlias) {
+        if ((_valueCount != _level.getNumVertices()) || ((int)_vertValueIndices.size() != _valueCount)) {
+            printf("Error:  value/vertex count mismatch for alias of vertex topology\n");
+            return false;
+        }
+        return true;
+    }
+
     //
     //  Verify that member sizes match sizes for the associated level:
     //
@@ -672,6 +888,19 @@ FVarLevel::validate() const {
     return true;
 }
 
+void
+FVarLevel::getMemoryUsage(MemoryUsage & usage) const {
+
+    usage.Add(_faceVertValues);
+    usage.Add(_edgeTags);
+    usage.Add(_vertSiblingCounts);
+    usage.Add(_vertSiblingOffsets);
+    usage.Add(_vertFaceSiblings);
+    usage.Add(_vertValueIndices);
+    usage.Add(_vertValueTags);
+    usage.Add(_vertValueCreaseEnds);
+}
+
 void
 FVarLevel::print() const {
 
@@ -1001,7 +1230,7 @@ FVarLevel::getFaceCompositeValueTag(ConstIndexArray & faceValues,
         Index srcValueIndex = findVertexValueIndex(faceVerts[i], faceValues[i]);
         assert(_vertValueIndices[srcValueIndex] == faceValues[i]);
 
-        ValueTag const &     srcTag = _vertValueTags[srcValueIndex];
+        ValueTag const       srcTag = getValueTag(srcValueIndex);
         ValueTagSize const & srcInt = *(reinterpret_cast<ValueTagSize const *>(&srcTag));
 
         compInt |= srcInt;
@@ -1035,7 +1264,7 @@ FVarLevel::getFaceCompositeValueAndVTag(ConstIndexArray & faceValues,
         Index srcValueIndex = findVertexValueIndex(faceVerts[i], faceValues[i]);
         assert(_vertValueIndices[srcValueIndex] == faceValues[i]);
 
-        ValueTag const & srcValueTag = _vertValueTags[srcValueIndex];
+        ValueTag const srcValueTag = getValueTag(srcValueIndex);
         if (srcValueTag._mismatch) {
             if (srcValueTag.isCorner()) {
                 srcVTag._rule = (VertTagSize) Sdc::Crease::RULE_CORNER;
@@ -1075,7 +1304,7 @@ FVarLevel::getFaceCompositeCombinedEdgeTag(ConstIndexArray & faceEdges,
 
         srcETag = _level.getEdgeTag(faceEdges[i]);
 
-        FVarLevel::ETag const & fvarETag = _edgeTags[faceEdges[i]];
+        FVarLevel::ETag const fvarETag = getEdgeTag(faceEdges[i]);
         if (fvarETag._mismatch) {
             srcETag._boundary = true;
         }
@@ -69,6 +69,13 @@ namespace internal {
 //  subsequent levels is very familar to that of face-vertices for clients.  So
 //  having them available for such access is convenient.
 //
+//  When the face-values of a channel are those of the face-vertices, and the channel
+//  does not mismatch the vertex topology anywhere (e.g. linear boundaries make all
+//  boundary values mismatch), the channel is an "alias" of the vertex topology:
+//  none of the per-face, per-edge or per-vertex vectors are allocated, the face-
+//  values are the face-vertices of the level and every vertex has a single value
+//  matching its topology.  Refinement of an alias yields an alias in the child.
+//
 //  Regarding scope and access...
 //      Unclear at this early state, but leaning towards nesting this class within
 //  Level, given the intimate dependency between the two.
@@ -159,11 +166,17 @@ public:
     FVarLevel(Level const& level);
     ~FVarLevel();
 
+    //  Copy of another channel for a copy of its Level (see Level copy construction):
+    FVarLevel(Level const& level, FVarLevel const& source);
+
     //  Queries for the entire channel:
     Level const& getLevel() const { return _level; }
 
     int getNumValues() const          { return _valueCount; }
-    int getNumFaceValuesTotal() const { return (int) _faceVertValues.size(); }
+    int getNumFaceValuesTotal() const { return _isVertexTopologyAlias ? _level.getNumFaceVerticesTotal()
+                                                                      : (int) _faceVertValues.size(); }
+
+    bool isVertexTopologyAlias() const { return _isVertexTopologyAlias; }
 
     bool isLinear() const            { return _isLinear; }
     bool hasLinearBoundaries() const { return _hasLinearBoundaries; }
@@ -176,12 +189,12 @@ public:
     IndexArray       getFaceValues(Index fIndex);
 
     //  Queries per edge:
-    ETag getEdgeTag(Index eIndex) const          { return _edgeTags[eIndex]; }
+    ETag getEdgeTag(Index eIndex) const          { return _isVertexTopologyAlias ? _edgeTagMatch : _edgeTags[eIndex]; }
     bool edgeTopologyMatches(Index eIndex) const { return !getEdgeTag(eIndex)._mismatch; }
 
     //  Queries per vertex (and its potential sibling values):
-    int   getNumVertexValues(Index v) const                  { return _vertSiblingCounts[v]; }
-    Index getVertexValueOffset(Index v, Sibling i = 0) const { return _vertSiblingOffsets[v] + i; }
+    int   getNumVertexValues(Index v) const                  { return _isVertexTopologyAlias ? 1 : _vertSiblingCounts[v]; }
+    Index getVertexValueOffset(Index v, Sibling i = 0) const { return (_isVertexTopologyAlias ? v : _vertSiblingOffsets[v]) + i; }
 
     Index getVertexValue(Index v, Sibling i = 0) const { return _vertValueIndices[getVertexValueOffset(v,i)]; }
 
@@ -201,7 +214,7 @@ public:
     SiblingArray       getVertexFaceSiblings(Index vIndex);
 
     //  Queries per value:
-    ValueTag getValueTag(Index valueIndex) const          { return _vertValueTags[valueIndex]; }
+    ValueTag getValueTag(Index valueIndex) const          { return _isVertexTopologyAlias ? _valueTagMatch : _vertValueTags[valueIndex]; }
     bool     valueTopologyMatches(Index valueIndex) const { return !getValueTag(valueIndex)._mismatch; }
 
     //  Higher-level topological queries, i.e. values in a neighborhood:
@@ -216,7 +229,9 @@ public:
     void resizeComponents();
 
     //  Topological analysis methods -- tagging and face-value population:
-    void completeTopologyFromFaceValues(int regBoundaryValence);
+    void completeTopologyFromFaceValues(int regBoundaryValence,
+                                        Level::Concurrency const & concurrency = Level::Concurrency());
+    void aliasVertexTopology();
     void initializeFaceValuesFromFaceVertices();
     void initializeFaceValuesFromVertexFaceSiblings();
 
@@ -229,9 +244,21 @@ public:
     };
     void gatherValueSpans(Index vIndex, ValueSpan * vValueSpans) const;
 
+    //  Passes completing the topology over sub-ranges of vertices or edges -- applied
+    //  concurrently with the state shared between them:
+    struct CompletionState;
+
+    bool faceValuesMatchVertexTopology(CompletionState const & state) const;
+    void identifyVertexSiblings(  Index vBegin, Index vEnd, CompletionState & state);
+    void identifyVertexMismatches(Index vBegin, Index vEnd, CompletionState & state);
+    void tagEdges(                Index eBegin, Index eEnd, CompletionState & state);
+    void tagVertexValues(         Index vBegin, Index vEnd, CompletionState & state);
+
     //  Debugging methods:
     bool validate() const;
     void print() const;
+
+    void getMemoryUsage(MemoryUsage & usage) const;
     void buildFaceVertexSiblingsFromVertexFaceSiblings(std::vector<Sibling>& fvSiblings) const;
 
 private:
@@ -246,8 +273,13 @@ private:
     bool _isLinear;
     bool _hasLinearBoundaries;
     bool _hasDependentSharpness;
+    bool _isVertexTopologyAlias;
     int  _valueCount;
 
+    //  Matching tags for all edges and values when aliasing the vertex topology:
+    ETag     _edgeTagMatch;
+    ValueTag _valueTagMatch;
+
     //
     //  Vectors recording face-varying topology including tags that help propagate
     //  data through the refinement hierarchy.  Vectors are not sparse but most use
@@ -270,7 +302,7 @@ private:
     std::vector<int>      _vertSiblingOffsets;
     std::vector<Sibling>  _vertFaceSiblings;
 
-    //  Per-value:
+    //  Per-value (only the identity mapping of values is retained for an alias):
     std::vector<Index>         _vertValueIndices;
     std::vector<ValueTag>      _vertValueTags;
     std::vector<CreaseEndPair> _vertValueCreaseEnds;
@@ -282,6 +314,8 @@ private:
 inline ConstIndexArray
 FVarLevel::getFaceValues(Index fIndex) const {
 
+    if (_isVertexTopologyAlias) return _level.getFaceVertices(fIndex);
+
     int vCount  = _level.getNumFaceVertices(fIndex);
     int vOffset = _level.getOffsetOfFaceVertices(fIndex);
     return ConstIndexArray(&_faceVertValues[vOffset], vCount);
@@ -289,6 +323,8 @@ FVarLevel::getFaceValues(Index fIndex) const {
 inline IndexArray
 FVarLevel::getFaceValues(Index fIndex) {
 
+    assert(!_isVertexTopologyAlias);
+
     int vCount  = _level.getNumFaceVertices(fIndex);
     int vOffset = _level.getOffsetOfFaceVertices(fIndex);
     return IndexArray(&_faceVertValues[vOffset], vCount);
@@ -297,6 +333,8 @@ FVarLevel::getFaceValues(Index fIndex) {
 inline FVarLevel::ConstSiblingArray
 FVarLevel::getVertexFaceSiblings(Index vIndex) const {
 
+    assert(!_isVertexTopologyAlias);
+
     int vCount  = _level.getNumVertexFaces(vIndex);
     int vOffset = _level.getOffsetOfVertexFaces(vIndex);
     return ConstSiblingArray(&_vertFaceSiblings[vOffset], vCount);
@@ -304,6 +342,8 @@ FVarLevel::getVertexFaceSiblings(Index vIndex) const {
 inline FVarLevel::SiblingArray
 FVarLevel::getVertexFaceSiblings(Index vIndex) {
 
+    assert(!_isVertexTopologyAlias);
+
     int vCount  = _level.getNumVertexFaces(vIndex);
     int vOffset = _level.getOffsetOfVertexFaces(vIndex);
     return SiblingArray(&_vertFaceSiblings[vOffset], vCount);
@@ -327,6 +367,8 @@ FVarLevel::getVertexValues(Index vIndex)
 inline FVarLevel::ConstValueTagArray
 FVarLevel::getVertexValueTags(Index vIndex) const
 {
+    if (_isVertexTopologyAlias) return ConstValueTagArray(&_valueTagMatch, 1);
+
     int vCount  = getNumVertexValues(vIndex);
     int vOffset = getVertexValueOffset(vIndex);
     return ConstValueTagArray(&_vertValueTags[vOffset], vCount);
@@ -334,6 +376,8 @@ FVarLevel::getVertexValueTags(Index vIndex) const
 inline FVarLevel::ValueTagArray
 FVarLevel::getVertexValueTags(Index vIndex)
 {
+    assert(!_isVertexTopologyAlias);
+
     int vCount  = getNumVertexValues(vIndex);
     int vOffset = getVertexValueOffset(vIndex);
     return ValueTagArray(&_vertValueTags[vOffset], vCount);
@@ -342,6 +386,8 @@ FVarLevel::getVertexValueTags(Index vIndex)
 inline FVarLevel::ConstCreaseEndPairArray
 FVarLevel::getVertexValueCreaseEnds(Index vIndex) const
 {
+    assert(!_isVertexTopologyAlias);
+
     int vCount  = getNumVertexValues(vIndex);
     int vOffset = getVertexValueOffset(vIndex);
     return ConstCreaseEndPairArray(&_vertValueCreaseEnds[vOffset], vCount);
@@ -349,6 +395,8 @@ FVarLevel::getVertexValueCreaseEnds(Index vIndex) const
 inline FVarLevel::CreaseEndPairArray
 FVarLevel::getVertexValueCreaseEnds(Index vIndex)
 {
+    assert(!_isVertexTopologyAlias);
+
     int vCount  = getNumVertexValues(vIndex);
     int vOffset = getVertexValueOffset(vIndex);
     return CreaseEndPairArray(&_vertValueCreaseEnds[vOffset], vCount);
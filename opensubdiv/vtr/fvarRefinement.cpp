@@ -82,6 +82,16 @@ FVarRefinement::applyRefinement() {
     _childFVar._hasLinearBoundaries   = _parentFVar._hasLinearBoundaries;
     _childFVar._hasDependentSharpness = _parentFVar._hasDependentSharpness;
 
+    //
+    //  The child of an alias of the vertex topology is an alias of the child vertex
+    //  topology -- its values correspond 1-to-1 with the vertices as those of the
+    //  parent do, all matching, so there is nothing to populate or propagate:
+    //
+    if (_parentFVar.isVertexTopologyAlias()) {
+        _childFVar.aliasVertexTopology();
+        return;
+    }
+
     //
     //  It's difficult to know immediately how many child values arise from the
     //  refinement -- particularly when sparse, so we get a close upper bound,
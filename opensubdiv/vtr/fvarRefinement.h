@@ -62,12 +62,15 @@ public:
     ~FVarRefinement();
 
     int getChildValueParentSource(Index vIndex, int sibling) const {
-        return _childValueParentSource[_childFVar.getVertexValueOffset(vIndex, (LocalIndex)sibling)];
+        return _childFVar.isVertexTopologyAlias() ? 0 :
+               _childValueParentSource[_childFVar.getVertexValueOffset(vIndex, (LocalIndex)sibling)];
     }
 
     float getFractionalWeight(Index pVert, LocalIndex pSibling,
                               Index cVert, LocalIndex cSibling) const;
 
+    void getMemoryUsage(MemoryUsage & usage) const { usage.Add(_childValueParentSource); }
+
 
     //  Modifiers supporting application of the refinement:
     void applyRefinement();
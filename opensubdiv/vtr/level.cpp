@@ -58,13 +58,76 @@ namespace internal {
 //
 //  Simple (for now) constructor and destructor:
 //
-Level::Level() :
+Level::Level(Arena * arena) :
     _faceCount(0),
     _edgeCount(0),
     _vertCount(0),
     _depth(0),
     _maxEdgeFaces(0),
-    _maxValence(0) {
+    _maxValence(0),
+    _regFaceSize(0),
+    _arena(arena),
+    _faceVertCountsAndOffsets(arena),
+    _faceVertIndices(arena),
+    _faceEdgeIndices(arena),
+    _faceTags(arena),
+    _edgeVertIndices(arena),
+    _edgeFaceCountsAndOffsets(arena),
+    _edgeFaceIndices(arena),
+    _edgeFaceLocalIndices(arena),
+    _edgeSharpness(arena),
+    _edgeTags(arena),
+    _vertFaceCountsAndOffsets(arena),
+    _vertFaceIndices(arena),
+    _vertFaceLocalIndices(arena),
+    _vertEdgeCountsAndOffsets(arena),
+    _vertEdgeIndices(arena),
+    _vertEdgeLocalIndices(arena),
+    _vertSharpness(arena),
+    _vertTags(arena) {
+}
+
+Level::Level(Level const & source, bool copyFVarChannels) :
+    _faceCount(source._faceCount),
+    _edgeCount(source._edgeCount),
+    _vertCount(source._vertCount),
+    _depth(source._depth),
+    _maxEdgeFaces(source._maxEdgeFaces),
+    _maxValence(source._maxValence),
+    _regFaceSize(source._regFaceSize),
+    _arena(0),
+    _faceVertCountsAndOffsets(source._faceVertCountsAndOffsets.begin(),
+        source._faceVertCountsAndOffsets.end()),
+    _faceVertIndices(source._faceVertIndices.begin(), source._faceVertIndices.end()),
+    _faceEdgeIndices(source._faceEdgeIndices.begin(), source._faceEdgeIndices.end()),
+    _faceTags(source._faceTags.begin(), source._faceTags.end()),
+    _edgeVertIndices(source._edgeVertIndices.begin(), source._edgeVertIndices.end()),
+    _edgeFaceCountsAndOffsets(source._edgeFaceCountsAndOffsets.begin(),
+        source._edgeFaceCountsAndOffsets.end()),
+    _edgeFaceIndices(source._edgeFaceIndices.begin(), source._edgeFaceIndices.end()),
+    _edgeFaceLocalIndices(source._edgeFaceLocalIndices.begin(),
+        source._edgeFaceLocalIndices.end()),
+    _edgeSharpness(source._edgeSharpness.begin(), source._edgeSharpness.end()),
+    _edgeTags(source._edgeTags.begin(), source._edgeTags.end()),
+    _vertFaceCountsAndOffsets(source._vertFaceCountsAndOffsets.begin(),
+        source._vertFaceCountsAndOffsets.end()),
+    _vertFaceIndices(source._vertFaceIndices.begin(), source._vertFaceIndices.end()),
+    _vertFaceLocalIndices(source._vertFaceLocalIndices.begin(),
+        source._vertFaceLocalIndices.end()),
+    _vertEdgeCountsAndOffsets(source._vertEdgeCountsAndOffsets.begin(),
+        source._vertEdgeCountsAndOffsets.end()),
+    _vertEdgeIndices(source._vertEdgeIndices.begin(), source._vertEdgeIndices.end()),
+    _vertEdgeLocalIndices(source._vertEdgeLocalIndices.begin(),
+        source._vertEdgeLocalIndices.end()),
+    _vertSharpness(source._vertSharpness.begin(), source._vertSharpness.end()),
+    _vertTags(source._vertTags.begin(), source._vertTags.end()) {
+
+    if (copyFVarChannels) {
+        _fvarChannels.reserve(source._fvarChannels.size());
+        for (int i = 0; i < (int)source._fvarChannels.size(); ++i) {
+            _fvarChannels.push_back(new FVarLevel(*this, *source._fvarChannels[i]));
+        }
+    }
 }
 
 Level::~Level() {
@@ -156,48 +219,25 @@ Level::getTopologyErrorString(TopologyError errCode) {
         callback(code, msg, clientData); \
     }
 
-bool
-Level::validateTopology(ValidationCallback callback, void const * clientData) const {
+//
+//  Each component is validated independently -- all components are first validated
+//  concurrently without reporting, noting the checks that failed, and the failures
+//  are then reported serially in the order of the checks and components, so that all
+//  errors are reported in the same order whatever the concurrency:
+//
+int
+Level::validateFaceTopology(Index fIndex, int checks,
+                            ValidationCallback callback, void const * clientData) const {
 
-    //
-    //  Verify internal topological consistency (eventually a Level method?):
-    //      - each face-vert has corresponding vert-face (and child)
-    //      - each face-edge has corresponding edge-face
-    //      - each edge-vert has corresponding vert-edge (and child)
-    //  The above three are enough for most cases, but it is still possible
-    //  the latter relation in each above has no correspondent in the former,
-    //  so apply the symmetric tests:
-    //      - each edge-face has corresponding face-edge
-    //      - each vert-face has corresponding face-vert
-    //      - each vert-edge has corresponding edge-vert
-    //  We are still left with the possibility of duplicate references in
-    //  places we don't want them.  Currently a component can exist multiple
-    //  times in a component of higher dimension.
-    //      - each vert-face <face,child> pair is unique
-    //      - each vert-edge <edge,child> pair is unique
-    //
-    bool returnOnFirstError = true;
-    bool isValid = true;
+    int failures = 0;
 
-    //  Verify each face-vert has corresponding vert-face and child:
-    if ((getNumFaceVerticesTotal() == 0) || (getNumVertexFacesTotal() == 0)) {
-        if (getNumFaceVerticesTotal() == 0) {
-            REPORT(TOPOLOGY_MISSING_FACE_VERTS, "missing face-verts");
-        }
-        if (getNumVertexFacesTotal() == 0) {
-            REPORT(TOPOLOGY_MISSING_VERT_FACES, "missing vert-faces");
-        }
-        return false;
-    }
-    for (int fIndex = 0; fIndex < getNumFaces(); ++fIndex) {
-        ConstIndexArray     fVerts      = getFaceVertices(fIndex);
-        int                 fVertCount  = fVerts.size();
-
-        for (int i = 0; i < fVertCount; ++i) {
-            Index vIndex = fVerts[i];
+    //  Verify each face-vert has corresponding vert-face:
+    if (checks & VALIDATE_FACE_VERTS) {
+        ConstIndexArray fVerts = getFaceVertices(fIndex);
 
-            ConstIndexArray        vFaces = getVertexFaces(vIndex);
-            ConstLocalIndexArray  vInFace = getVertexFaceLocalIndices(vIndex);
+        for (int i = 0; i < fVerts.size(); ++i) {
+            ConstIndexArray       vFaces = getVertexFaces(fVerts[i]);
+            ConstLocalIndexArray vInFace = getVertexFaceLocalIndices(fVerts[i]);
 
             bool vertFaceOfFaceExists = false;
             for (int j = 0; j < vFaces.size(); ++j) {
@@ -209,31 +249,18 @@ Level::validateTopology(ValidationCallback callback, void const * clientData) co
             if (!vertFaceOfFaceExists) {
                 REPORT(TOPOLOGY_FAILED_CORRELATION_FACE_VERT,
                     "face %d correlation of vert %d failed", fIndex, i);
-                if (returnOnFirstError) return false;
-                isValid = false;
+                failures |= VALIDATE_FACE_VERTS;
             }
         }
     }
 
     //  Verify each face-edge has corresponding edge-face:
-    if ((getNumEdgeFacesTotal() == 0) || (getNumFaceEdgesTotal() == 0)) {
-        if (getNumEdgeFacesTotal() == 0) {
-            REPORT(TOPOLOGY_MISSING_EDGE_FACES, "missing edge-faces");
-        }
-        if (getNumFaceEdgesTotal() == 0) {
-            REPORT(TOPOLOGY_MISSING_FACE_EDGES, "missing face-edges");
-        }
-        return false;
-    }
-    for (int fIndex = 0; fIndex < getNumFaces(); ++fIndex) {
-        ConstIndexArray  fEdges      = getFaceEdges(fIndex);
-        int              fEdgeCount  = fEdges.size();
-
-        for (int i = 0; i < fEdgeCount; ++i) {
-            int eIndex = fEdges[i];
+    if (checks & VALIDATE_FACE_EDGES) {
+        ConstIndexArray fEdges = getFaceEdges(fIndex);
 
-            ConstIndexArray       eFaces = getEdgeFaces(eIndex);
-            ConstLocalIndexArray eInFace = getEdgeFaceLocalIndices(eIndex);
+        for (int i = 0; i < fEdges.size(); ++i) {
+            ConstIndexArray       eFaces = getEdgeFaces(fEdges[i]);
+            ConstLocalIndexArray eInFace = getEdgeFaceLocalIndices(fEdges[i]);
 
             bool edgeFaceOfFaceExists = false;
             for (int j = 0; j < eFaces.size(); ++j) {
@@ -245,30 +272,26 @@ Level::validateTopology(ValidationCallback callback, void const * clientData) co
             if (!edgeFaceOfFaceExists) {
                 REPORT(TOPOLOGY_FAILED_CORRELATION_FACE_EDGE,
                      "face %d correlation of edge %d failed", fIndex, i);
-                if (returnOnFirstError) return false;
-                isValid = false;
+                failures |= VALIDATE_FACE_EDGES;
             }
         }
     }
+    return failures;
+}
 
-    //  Verify each edge-vert has corresponding vert-edge and child:
-    if ((getNumEdgeVerticesTotal() == 0) || (getNumVertexEdgesTotal() == 0)) {
-        if (getNumEdgeVerticesTotal() == 0) {
-            REPORT(TOPOLOGY_MISSING_EDGE_VERTS, "missing edge-verts");
-        }
-        if (getNumVertexEdgesTotal() == 0) {
-            REPORT(TOPOLOGY_MISSING_VERT_EDGES, "missing vert-edges");
-        }
-        return false;
-    }
-    for (int eIndex = 0; eIndex < getNumEdges(); ++eIndex) {
-        ConstIndexArray  eVerts = getEdgeVertices(eIndex);
+int
+Level::validateEdgeTopology(Index eIndex, int checks,
+                            ValidationCallback callback, void const * clientData) const {
 
-        for (int i = 0; i < 2; ++i) {
-            Index vIndex = eVerts[i];
+    int failures = 0;
 
-            ConstIndexArray       vEdges = getVertexEdges(vIndex);
-            ConstLocalIndexArray  vInEdge = getVertexEdgeLocalIndices(vIndex);
+    ConstIndexArray eVerts = getEdgeVertices(eIndex);
+
+    //  Verify each edge-vert has corresponding vert-edge:
+    if (checks & VALIDATE_EDGE_VERTS) {
+        for (int i = 0; i < 2; ++i) {
+            ConstIndexArray       vEdges = getVertexEdges(eVerts[i]);
+            ConstLocalIndexArray vInEdge = getVertexEdgeLocalIndices(eVerts[i]);
 
             bool vertEdgeOfEdgeExists = false;
             for (int j = 0; j < vEdges.size(); ++j) {
@@ -280,72 +303,205 @@ Level::validateTopology(ValidationCallback callback, void const * clientData) co
             if (!vertEdgeOfEdgeExists) {
                 REPORT(TOPOLOGY_FAILED_CORRELATION_FACE_VERT,
                     "edge %d correlation of vert %d failed", eIndex, i);
-                if (returnOnFirstError) return false;
-                isValid = false;
+                failures |= VALIDATE_EDGE_VERTS;
             }
         }
     }
 
+    //  Verify non-manifold tags are appropriately assigned to edges:
+    //      - note we have to validate orientation of vertex neighbors to do this rigorously
+    if ((checks & VALIDATE_EDGE_TAGS) && !_edgeTags[eIndex]._nonManifold) {
+        if (eVerts[0] == eVerts[1]) {
+            REPORT(TOPOLOGY_DEGENERATE_EDGE,
+                "Error in eIndex = %d:  degenerate edge not tagged marked non-manifold", eIndex);
+            failures |= VALIDATE_EDGE_TAGS;
+        }
+
+        ConstIndexArray eFaces = getEdgeFaces(eIndex);
+        if ((eFaces.size() < 1) || (eFaces.size() > 2)) {
+            REPORT(TOPOLOGY_NON_MANIFOLD_EDGE,
+                "edge %d with %d incident faces not tagged non-manifold", eIndex, eFaces.size());
+            failures |= VALIDATE_EDGE_TAGS;
+        }
+    }
+    return failures;
+}
+
+int
+Level::validateVertexTopology(Index vIndex, int checks,
+                              ValidationCallback callback, void const * clientData) const {
+
     //  Verify that vert-faces and vert-edges are properly ordered and in sync:
     //      - currently this requires the relations exactly match those that we construct from
     //        the ordering method, i.e. we do not allow rotations for interior vertices.
-    internal::StackBuffer<Index,32> indexBuffer(2 * _maxValence);
+    if (!(checks & VALIDATE_VERT_ORIENTATION) ||
+        _vertTags[vIndex]._incomplete || _vertTags[vIndex]._nonManifold) return 0;
 
-    for (int vIndex = 0; vIndex < getNumVertices(); ++vIndex) {
-        if (_vertTags[vIndex]._incomplete || _vertTags[vIndex]._nonManifold) continue;
+    ConstIndexArray vFaces = getVertexFaces(vIndex);
+    ConstIndexArray vEdges = getVertexEdges(vIndex);
 
-        ConstIndexArray  vFaces = getVertexFaces(vIndex);
-        ConstIndexArray  vEdges = getVertexEdges(vIndex);
+    internal::StackBuffer<Index,32> indexBuffer(vFaces.size() + vEdges.size());
 
-        Index * vFacesOrdered = indexBuffer;
-        Index * vEdgesOrdered = indexBuffer + vFaces.size();
+    Index * vFacesOrdered = indexBuffer;
+    Index * vEdgesOrdered = indexBuffer + vFaces.size();
 
-        if (!orderVertexFacesAndEdges(vIndex, vFacesOrdered, vEdgesOrdered)) {
-            REPORT(TOPOLOGY_FAILED_ORIENTATION_INCIDENT_FACES_EDGES,
-                "vertex %d cannot orient incident faces and edges", vIndex);
-            if (returnOnFirstError) return false;
-            isValid = false;
+    int failures = 0;
+    if (!orderVertexFacesAndEdges(vIndex, vFacesOrdered, vEdgesOrdered)) {
+        REPORT(TOPOLOGY_FAILED_ORIENTATION_INCIDENT_FACES_EDGES,
+            "vertex %d cannot orient incident faces and edges", vIndex);
+        failures |= VALIDATE_VERT_ORIENTATION;
+    }
+    for (int i = 0; i < vFaces.size(); ++i) {
+        if (vFaces[i] != vFacesOrdered[i]) {
+            REPORT(TOPOLOGY_FAILED_ORIENTATION_INCIDENT_FACE,
+                "vertex %d orientation failure at incident face %d", vIndex, i);
+            failures |= VALIDATE_VERT_ORIENTATION;
+            break;
         }
-        for (int i = 0; i < vFaces.size(); ++i) {
-            if (vFaces[i] != vFacesOrdered[i]) {
-                REPORT(TOPOLOGY_FAILED_ORIENTATION_INCIDENT_FACE,
-                    "vertex %d orientation failure at incident face %d", vIndex, i);
-                if (returnOnFirstError) return false;
-                isValid = false;
-                break;
-            }
+    }
+    for (int i = 0; i < vEdges.size(); ++i) {
+        if (vEdges[i] != vEdgesOrdered[i]) {
+            REPORT(TOPOLOGY_FAILED_ORIENTATION_INCIDENT_EDGE,
+                "vertex %d orientation failure at incident edge %d", vIndex, i);
+            failures |= VALIDATE_VERT_ORIENTATION;
+            break;
         }
-        for (int i = 0; i < vEdges.size(); ++i) {
-            if (vEdges[i] != vEdgesOrdered[i]) {
-                REPORT(TOPOLOGY_FAILED_ORIENTATION_INCIDENT_EDGE,
-                    "vertex %d orientation failure at incident edge %d", vIndex, i);
-                if (returnOnFirstError) return false;
-                isValid = false;
-                break;
-            }
+    }
+    return failures;
+}
+
+namespace {
+    struct ValidationRanges {
+        Level const *   level;
+        unsigned char * failures;
+    };
+
+    void
+    validateFaceRanges(int begin, int end, void * data) {
+
+        ValidationRanges const & ranges = *static_cast<ValidationRanges const *>(data);
+        for (int i = begin; i < end; ++i) {
+            ranges.failures[i] = (unsigned char)ranges.level->validateFaceTopology(i, ~0);
         }
     }
 
-    //  Verify non-manifold tags are appropriately assigned to edges and vertices:
-    //      - note we have to validate orientation of vertex neighbors to do this rigorously
-    for (int eIndex = 0; eIndex < getNumEdges(); ++eIndex) {
-        Level::ETag const& eTag = _edgeTags[eIndex];
-        if (eTag._nonManifold) continue;
+    void
+    validateEdgeRanges(int begin, int end, void * data) {
 
-        ConstIndexArray  eVerts = getEdgeVertices(eIndex);
-        if (eVerts[0] == eVerts[1]) {
-            REPORT(TOPOLOGY_DEGENERATE_EDGE,
-                "Error in eIndex = %d:  degenerate edge not tagged marked non-manifold", eIndex);
-            if (returnOnFirstError) return false;
-            isValid = false;
+        ValidationRanges const & ranges = *static_cast<ValidationRanges const *>(data);
+        for (int i = begin; i < end; ++i) {
+            ranges.failures[i] = (unsigned char)ranges.level->validateEdgeTopology(i, ~0);
         }
+    }
 
-        ConstIndexArray  eFaces = getEdgeFaces(eIndex);
-        if ((eFaces.size() < 1) || (eFaces.size() > 2)) {
-            REPORT(TOPOLOGY_NON_MANIFOLD_EDGE,
-                "edge %d with %d incident faces not tagged non-manifold", eIndex, eFaces.size());
-            if (returnOnFirstError) return false;
-            isValid = false;
+    void
+    validateVertexRanges(int begin, int end, void * data) {
+
+        ValidationRanges const & ranges = *static_cast<ValidationRanges const *>(data);
+        for (int i = begin; i < end; ++i) {
+            ranges.failures[i] = (unsigned char)ranges.level->validateVertexTopology(i, ~0);
+        }
+    }
+}
+
+bool
+Level::validateTopology(ValidationCallback callback, void const * clientData,
+                        Concurrency const & concurrency) const {
+
+    //
+    //  Verify internal topological consistency (eventually a Level method?):
+    //      - each face-vert has corresponding vert-face (and child)
+    //      - each face-edge has corresponding edge-face
+    //      - each edge-vert has corresponding vert-edge (and child)
+    //  The above three are enough for most cases, but it is still possible
+    //  the latter relation in each above has no correspondent in the former,
+    //  so apply the symmetric tests:
+    //      - each edge-face has corresponding face-edge
+    //      - each vert-face has corresponding face-vert
+    //      - each vert-edge has corresponding edge-vert
+    //  We are still left with the possibility of duplicate references in
+    //  places we don't want them.  Currently a component can exist multiple
+    //  times in a component of higher dimension.
+    //      - each vert-face <face,child> pair is unique
+    //      - each vert-edge <edge,child> pair is unique
+    //
+    //  All errors are reported, rather than only the first one found.
+    //
+    bool isMissing = false;
+    if (getNumFaceVerticesTotal() == 0) {
+        REPORT(TOPOLOGY_MISSING_FACE_VERTS, "missing face-verts");
+        isMissing = true;
+    }
+    if (getNumVertexFacesTotal() == 0) {
+        REPORT(TOPOLOGY_MISSING_VERT_FACES, "missing vert-faces");
+        isMissing = true;
+    }
+    if (getNumEdgeFacesTotal() == 0) {
+        REPORT(TOPOLOGY_MISSING_EDGE_FACES, "missing edge-faces");
+        isMissing = true;
+    }
+    if (getNumFaceEdgesTotal() == 0) {
+        REPORT(TOPOLOGY_MISSING_FACE_EDGES, "missing face-edges");
+        isMissing = true;
+    }
+    if (getNumEdgeVerticesTotal() == 0) {
+        REPORT(TOPOLOGY_MISSING_EDGE_VERTS, "missing edge-verts");
+        isMissing = true;
+    }
+    if (getNumVertexEdgesTotal() == 0) {
+        REPORT(TOPOLOGY_MISSING_VERT_EDGES, "missing vert-edges");
+        isMissing = true;
+    }
+    if (isMissing) return false;
+
+    int fCount = getNumFaces(),
+        eCount = getNumEdges(),
+        vCount = getNumVertices();
+
+    std::vector<unsigned char> failures(fCount + eCount + vCount);
+
+    unsigned char * faceFailures = &failures[0],
+                  * edgeFailures = faceFailures + fCount,
+                  * vertFailures = edgeFailures + eCount;
+
+    ValidationRanges faceRanges = { this, faceFailures },
+                     edgeRanges = { this, edgeFailures },
+                     vertRanges = { this, vertFailures };
+
+    applyConcurrently(concurrency, fCount, validateFaceRanges,   &faceRanges);
+    applyConcurrently(concurrency, eCount, validateEdgeRanges,   &edgeRanges);
+    applyConcurrently(concurrency, vCount, validateVertexRanges, &vertRanges);
+
+    bool isValid = true;
+    for (int i = 0; isValid && (i < (int)failures.size()); ++i) {
+        isValid = (failures[i] == 0);
+    }
+
+    if (!isValid && callback) {
+        for (int f = 0; f < fCount; ++f) {
+            if (faceFailures[f] & VALIDATE_FACE_VERTS) {
+                validateFaceTopology(f, VALIDATE_FACE_VERTS, callback, clientData);
+            }
+        }
+        for (int f = 0; f < fCount; ++f) {
+            if (faceFailures[f] & VALIDATE_FACE_EDGES) {
+                validateFaceTopology(f, VALIDATE_FACE_EDGES, callback, clientData);
+            }
+        }
+        for (int e = 0; e < eCount; ++e) {
+            if (edgeFailures[e] & VALIDATE_EDGE_VERTS) {
+                validateEdgeTopology(e, VALIDATE_EDGE_VERTS, callback, clientData);
+            }
+        }
+        for (int v = 0; v < vCount; ++v) {
+            if (vertFailures[v]) {
+                validateVertexTopology(v, VALIDATE_VERT_ORIENTATION, callback, clientData);
+            }
+        }
+        for (int e = 0; e < eCount; ++e) {
+            if (edgeFailures[e] & VALIDATE_EDGE_TAGS) {
+                validateEdgeTopology(e, VALIDATE_EDGE_TAGS, callback, clientData);
+            }
         }
     }
     return isValid;
@@ -391,6 +547,33 @@ namespace {
 #endif
 }
 
+void
+Level::getMemoryUsage(MemoryUsage & usage) const {
+
+    usage.Add(_faceVertCountsAndOffsets);
+    usage.Add(_faceVertIndices);
+    usage.Add(_faceEdgeIndices);
+    usage.Add(_faceTags);
+
+    usage.Add(_edgeVertIndices);
+    usage.Add(_edgeFaceCountsAndOffsets);
+    usage.Add(_edgeFaceIndices);
+    usage.Add(_edgeFaceLocalIndices);
+    usage.Add(_edgeSharpness);
+    usage.Add(_edgeTags);
+
+    usage.Add(_vertFaceCountsAndOffsets);
+    usage.Add(_vertFaceIndices);
+    usage.Add(_vertFaceLocalIndices);
+    usage.Add(_vertEdgeCountsAndOffsets);
+    usage.Add(_vertEdgeIndices);
+    usage.Add(_vertEdgeLocalIndices);
+    usage.Add(_vertSharpness);
+    usage.Add(_vertTags);
+
+    usage.Add(_fvarChannels);
+}
+
 void
 Level::print(const Refinement* pRefinement) const {
 
@@ -979,6 +1162,97 @@ Level::gatherQuadRegularCornerPatchPoints(
     return 9;
 }
 
+//
+//  Gathering the 16 vertices of a quad-regular patch bounded by infinitely sharp edges:
+//      - the neighborhood of the face within its sharp edges is assumed to be quad-regular
+//        (see isInfSharpRegularPatch() below)
+//      - any combination of the edges of the face may be infinitely sharp
+//
+//  Ordering of resulting vertices:
+//      Since there is no rotation to accommodate, the points are returned in the row-major
+//  order of the patch, with the vertices of the face in the central four.  Points beyond the
+//  sharp edges are not used by the patch (they are extrapolated from those on the interior)
+//  and so are assigned the first point of the face:
+//
+//      0-----1-----2-----3---
+//      |     |     |     |
+//      |     |     |     |
+//      4-----5-----6-----7---
+//      |     |x   x|     |
+//      |     |x   x|     |
+//      8-----9-----10----11--
+//      |     |     |     |
+//      |     |     |     |
+//      12----13----14----15--
+//      |     |     |     |
+//
+int
+Level::gatherQuadRegularInfSharpPatchPoints(
+    Index face, Index patchPoints[], int infSharpEdgeMask, int fvarChannel) const {
+
+    Level const& level = *this;
+
+    //  Positions of the face vertices within the patch, and the offsets to the positions
+    //  beyond each edge of the face:
+    static int const facePointInPatch[4]   = { 5, 6, 10, 9 };
+    static int const edgeOffsetInPatch[4]  = { -4, 1, 4, -1 };
+
+    ConstIndexArray faceVerts = level.getFaceVertices(face);
+    ConstIndexArray faceEdges = level.getFaceEdges(face);
+
+    ConstIndexArray facePoints = (fvarChannel < 0) ? faceVerts :
+                                 level.getFaceFVarValues(face, fvarChannel);
+
+    for (int i = 0; i < 16; ++i) {
+        patchPoints[i] = facePoints[0];
+    }
+    for (int i = 0; i < 4; ++i) {
+        patchPoints[facePointInPatch[i]] = facePoints[i];
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        if (infSharpEdgeMask & (1 << i)) continue;
+
+        //
+        //  The face opposite edge i contains the two points beyond the edge, following
+        //  V(i) in the opposing orientation of that face:
+        //
+        ConstIndexArray eFaces = level.getEdgeFaces(faceEdges[i]);
+        Index oppFace = eFaces[eFaces[0] == face];
+
+        ConstIndexArray oppVerts  = level.getFaceVertices(oppFace);
+        ConstIndexArray oppPoints = (fvarChannel < 0) ? oppVerts :
+                                    level.getFaceFVarValues(oppFace, fvarChannel);
+
+        int vInOppFace = oppVerts.FindIndexIn4Tuple(faceVerts[i]);
+
+        patchPoints[facePointInPatch[i] + edgeOffsetInPatch[i]] =
+                oppPoints[fastMod4(vInOppFace + 1)];
+        patchPoints[facePointInPatch[fastMod4(i + 1)] + edgeOffsetInPatch[i]] =
+                oppPoints[fastMod4(vInOppFace + 2)];
+
+        //
+        //  When the preceding edge is also smooth, V(i) is a regular interior vertex and
+        //  the diagonal point lies in the face beyond the leading edge of V(i) in the
+        //  opposite face:
+        //
+        if (infSharpEdgeMask & (1 << fastMod4(i + 3))) continue;
+
+        ConstIndexArray dEdgeFaces = level.getEdgeFaces(level.getFaceEdges(oppFace)[vInOppFace]);
+        Index diagFace = dEdgeFaces[dEdgeFaces[0] == oppFace];
+
+        ConstIndexArray diagVerts  = level.getFaceVertices(diagFace);
+        ConstIndexArray diagPoints = (fvarChannel < 0) ? diagVerts :
+                                     level.getFaceFVarValues(diagFace, fvarChannel);
+
+        int vInDiagFace = diagVerts.FindIndexIn4Tuple(faceVerts[i]);
+
+        patchPoints[facePointInPatch[i] + edgeOffsetInPatch[i] + edgeOffsetInPatch[fastMod4(i + 3)]] =
+                diagPoints[fastMod4(vInDiagFace + 2)];
+    }
+    return 16;
+}
+
 //
 //  Gathering the 12 vertices of a tri-regular interior patch:
 //      - the neighborhood of the face is assumed to be tri-regular
@@ -1238,6 +1512,58 @@ Level::gatherTriRegularCornerEdgePatchPoints(Index fIndex, Index points[], int c
     return 8;
 }
 
+//
+//  Identifying the regular patches of the Loop scheme:
+//      - all vertices are Smooth interior vertices, or Crease boundary vertices
+//      - a single boundary edge, or a single boundary vertex with no boundary edge
+//
+//  The optional boundary mask returned is that of the boundary edge, or that of the boundary
+//  vertex combined with bit 3 (see Far::PatchParam for the triangular patches).
+//
+bool
+Level::isTriRegularPatch(Index face, int *boundaryMaskOut) const {
+
+    ConstIndexArray fVerts = getFaceVertices(face);
+    if (fVerts.size() != 3) return false;
+
+    VTag compVTag = getFaceCompositeVTag(fVerts);
+    if (compVTag._xordinary || compVTag._nonManifold ||
+        compVTag._semiSharp || compVTag._semiSharpEdges) {
+        return false;
+    }
+
+    ConstIndexArray fEdges = getFaceEdges(face);
+
+    int boundaryVertMask = 0,
+        boundaryEdgeMask = 0;
+    for (int i = 0; i < 3; ++i) {
+        VTag vTag = getVertexTag(fVerts[i]);
+        if (vTag._boundary) {
+            if (vTag._rule != Sdc::Crease::RULE_CREASE) return false;
+            boundaryVertMask |= 1 << i;
+        } else if (vTag._rule != Sdc::Crease::RULE_SMOOTH) {
+            return false;
+        }
+        boundaryEdgeMask |= getEdgeTag(fEdges[i])._boundary << i;
+    }
+
+    int boundaryMask = 0;
+    if (boundaryEdgeMask) {
+        //  A single boundary edge, with the opposite vertex interior:
+        if ((boundaryEdgeMask & (boundaryEdgeMask - 1)) || (boundaryVertMask == 7)) return false;
+        boundaryMask = boundaryEdgeMask;
+    } else if (boundaryVertMask) {
+        //  A single boundary vertex:
+        if (boundaryVertMask & (boundaryVertMask - 1)) return false;
+        boundaryMask = boundaryVertMask | 8;
+    }
+
+    if (boundaryMaskOut) {
+        *boundaryMaskOut = boundaryMask;
+    }
+    return true;
+}
+
 bool
 Level::isSingleCreasePatch(Index face, float *sharpnessOut, int *rotationOut) const {
 
@@ -1325,6 +1651,74 @@ Level::isSingleCreasePatch(Index face, float *sharpnessOut, int *rotationOut) co
     return true;
 }
 
+//
+//  Identifying the regular patches of the Catmark scheme when infinitely sharp edges are
+//  treated as boundaries:
+//      - no semi-sharp or non-manifold features at the vertices of the face
+//      - each corner of the face lies in a regular sector bounded by the infinitely sharp
+//        edges (boundary edges included), i.e. a Smooth regular interior vertex, a Crease
+//        vertex with two faces on the side of the face, or a Corner with the face alone
+//
+//  Unlike the single-crease patch, any number of edges of the face may be sharp, and the
+//  sharp edges need not continue smoothly through the corners of the face.  The optional
+//  mask of infinitely sharp edges returned serves as the boundary mask of the patch.
+//
+bool
+Level::isInfSharpRegularPatch(Index face, int *infSharpEdgeMaskOut) const {
+
+    ConstIndexArray fVerts = getFaceVertices(face);
+    if (fVerts.size() != 4) return false;
+
+    VTag compVTag = getFaceCompositeVTag(fVerts);
+    if (compVTag._nonManifold || compVTag._semiSharp || compVTag._semiSharpEdges) {
+        return false;
+    }
+
+    ConstIndexArray fEdges = getFaceEdges(face);
+
+    int infSharpEdgeMask = 0;
+    for (int i = 0; i < 4; ++i) {
+        infSharpEdgeMask |= getEdgeTag(fEdges[i])._infSharp << i;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        VTag vTag = getVertexTag(fVerts[i]);
+
+        bool leadingSharp  = (infSharpEdgeMask & (1 << i)) != 0;
+        bool trailingSharp = (infSharpEdgeMask & (1 << fastMod4(i + 3))) != 0;
+
+        if (!leadingSharp && !trailingSharp) {
+            if ((vTag._rule != Sdc::Crease::RULE_SMOOTH) || vTag._xordinary) return false;
+        } else if (leadingSharp && trailingSharp) {
+            if (vTag._rule != Sdc::Crease::RULE_CORNER) return false;
+        } else {
+            //  The neighbor across the smooth edge must close the sector with its other
+            //  edge at the vertex -- the second of the two sharp edges of the Crease:
+            if (vTag._rule != Sdc::Crease::RULE_CREASE) return false;
+
+            Index smoothEdge = leadingSharp ? fEdges[fastMod4(i + 3)] : fEdges[i];
+
+            ConstIndexArray eFaces = getEdgeFaces(smoothEdge);
+            Index nbrFace = eFaces[eFaces[0] == face];
+
+            ConstIndexArray nbrVerts = getFaceVertices(nbrFace);
+            if (nbrVerts.size() != 4) return false;
+
+            ConstIndexArray nbrEdges = getFaceEdges(nbrFace);
+
+            int   vInNbrFace = nbrVerts.FindIndexIn4Tuple(fVerts[i]);
+            Index otherEdge  = (nbrEdges[vInNbrFace] == smoothEdge) ?
+                               nbrEdges[fastMod4(vInNbrFace + 3)] : nbrEdges[vInNbrFace];
+            if (!getEdgeTag(otherEdge)._infSharp) return false;
+        }
+    }
+
+    if (infSharpEdgeMaskOut) {
+        *infSharpEdgeMaskOut = infSharpEdgeMask;
+    }
+    return true;
+}
+
 //
 //  What follows is an internal/anonymous class and protected methods to complete all
 //  topological relations when only the face-vertex relations is defined.
@@ -1359,7 +1753,7 @@ namespace {
 
     class DynamicRelation {
     public:
-        DynamicRelation(IndexVector& countAndOffsets, IndexVector& indices, int membersPerComp);
+        DynamicRelation(ArenaIndexVector& countAndOffsets, ArenaIndexVector& indices, int membersPerComp);
         ~DynamicRelation() { }
 
     public:
@@ -1375,14 +1769,14 @@ namespace {
         int _compCount;
         int _memberCountPerComp;
 
-        IndexVector & _countsAndOffsets;
-        IndexVector & _regIndices;
+        ArenaIndexVector & _countsAndOffsets;
+        ArenaIndexVector & _regIndices;
 
         IrregIndexMap _irregIndices;
     };
 
     inline
-    DynamicRelation::DynamicRelation(IndexVector& countAndOffsets, IndexVector& indices, int membersPerComp) :
+    DynamicRelation::DynamicRelation(ArenaIndexVector& countAndOffsets, ArenaIndexVector& indices, int membersPerComp) :
             _compCount(0),
             _memberCountPerComp(membersPerComp),
             _countsAndOffsets(countAndOffsets),
@@ -1472,11 +1866,11 @@ namespace {
             cannotBeCompressedInPlace |= (memberCount > (_memberCountPerComp * _compCount));
 
             //  Copy members into the original or temporary vector accordingly:
-            IndexVector  tmpIndices;
+            ArenaIndexVector  tmpIndices(_regIndices.get_allocator());
             if (cannotBeCompressedInPlace) {
                 tmpIndices.resize(memberCount);
             }
-            IndexVector& dstIndices = cannotBeCompressedInPlace ? tmpIndices : _regIndices;
+            ArenaIndexVector& dstIndices = cannotBeCompressedInPlace ? tmpIndices : _regIndices;
 
             int memberMax = _memberCountPerComp;
             for (int i = 0; i < _compCount; ++i) {
@@ -1534,7 +1928,7 @@ Level::findEdge(Index v0Index, Index v1Index) const {
 }
 
 bool
-Level::completeTopologyFromFaceVertices() {
+Level::completeTopologyFromFaceVertices(Concurrency const & concurrency) {
 
     //
     //  Its assumed (a pre-condition) that face-vertices have been fully specified and that we
@@ -1546,6 +1940,13 @@ Level::completeTopologyFromFaceVertices() {
     int eCount = this->getNumEdges();
     assert((vCount > 0) && (fCount > 0) && (eCount == 0));
 
+    //  Manifold meshes are completed with the faster identification of edges by sorting,
+    //  which leaves all else to the incremental search below if it fails:
+    if (identifyManifoldEdgesFromFaceVertices(eCount, concurrency)) {
+        return completeTopologyFromFaceEdges(eCount, concurrency);
+    }
+    eCount = 0;
+
     //  May be unnecessary depending on how the vertices and faces were defined, but worth a
     //  call to ensure all data related to verts and faces is available -- this will be a
     //  harmless call if all has been taken care of).
@@ -1707,20 +2108,373 @@ Level::completeTopologyFromFaceVertices() {
     return true;
 }
 
+//
+//  Concurrency for the completion of topology -- items are partitioned into ranges that
+//  are applied by the client function or by OpenMP (serially if neither is specified):
+//
+namespace {
+    struct ConcurrentRanges {
+        Level::RangeKernel kernel;
+        void *             kernelData;
+        int                numItems;
+        int                rangeSize;
+    };
+
+    void
+    applyConcurrentRanges(int begin, int end, void * data) {
+
+        ConcurrentRanges const & ranges = *static_cast<ConcurrentRanges const *>(data);
+
+        for (int i = begin; i < end; ++i) {
+            int itemBegin = i * ranges.rangeSize;
+            int itemEnd   = std::min(itemBegin + ranges.rangeSize, ranges.numItems);
+
+            ranges.kernel(itemBegin, itemEnd, ranges.kernelData);
+        }
+    }
+}
+
+void
+Level::applyConcurrently(Concurrency const & concurrency, int numItems,
+                         RangeKernel kernel, void * kernelData) {
+
+    if ((concurrency._numThreads <= 1) && !concurrency._parallelFor) {
+        kernel(0, numItems, kernelData);
+        return;
+    }
+
+    ConcurrentRanges ranges;
+    ranges.kernel     = kernel;
+    ranges.kernelData = kernelData;
+    ranges.numItems   = numItems;
+    ranges.rangeSize  = std::max(1024, numItems / (4 * std::max(1, concurrency._numThreads)) + 1);
+
+    int numRanges = (numItems + ranges.rangeSize - 1) / ranges.rangeSize;
+
+    if (concurrency._parallelFor) {
+        concurrency._parallelFor(0, numRanges, applyConcurrentRanges, &ranges,
+                                 concurrency._parallelForData);
+    } else {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(concurrency._numThreads)
+#endif
+        for (int i = 0; i < numRanges; ++i) {
+            applyConcurrentRanges(i, i + 1, &ranges);
+        }
+    }
+}
+
+//
+//  Faster alternative to the incremental search of edges in completeTopologyFromFaceVertices()
+//  for manifold meshes:
+//
+//  The face-vertices are bucketed by the lower vertex of the edge they start (a counting sort
+//  that preserves their order), and the edges of each bucket are identified by sorting it by
+//  the other vertex of the edge -- buckets are independent and sorted concurrently.  Edges
+//  are numbered in order of their first occurrence, as they are by the search, so the order
+//  and the resulting topology are identical and deterministic.  Any non-manifold feature --
+//  a degenerate edge, or an edge shared by more than two faces, twice by a face or by two
+//  faces of the same winding order -- is rejected and left to the search to deal with.
+//
+namespace {
+    struct EdgeBuckets {
+        Level const *       level;
+        std::vector<int>  & offsets;      // offsets of the face-vertices of each bucket
+        std::vector<int>  & faceVerts;    // face-vertices in order within each bucket
+        std::vector<Index>& nextVerts;    // vertex following each face-vertex in its face
+        std::vector<int>  & firstFaceVert;// first face-vertex of the edge (-1 if non-manifold)
+        IndexVector const & faceVertFaces;// face of each face-vertex
+
+        EdgeBuckets(Level const * l, std::vector<int> & o, std::vector<int> & fv,
+                    std::vector<Index> & nv, std::vector<int> & ffv, IndexVector const & fvf) :
+            level(l), offsets(o), faceVerts(fv), nextVerts(nv), firstFaceVert(ffv),
+            faceVertFaces(fvf) { }
+    };
+
+    inline Index
+    getOtherEdgeVertex(EdgeBuckets const & buckets, ConstIndexArray faceVertIndices,
+                       int faceVert, Index vertex) {
+
+        Index v0 = faceVertIndices[faceVert];
+        return (v0 == vertex) ? buckets.nextVerts[faceVert] : v0;
+    }
+
+    void
+    identifyBucketEdges(int vBegin, int vEnd, void * data) {
+
+        EdgeBuckets & buckets = *static_cast<EdgeBuckets *>(data);
+
+        ConstIndexArray faceVertIndices(&buckets.level->getFaceVertices(0)[0],
+                                        buckets.level->getNumFaceVerticesTotal());
+
+        for (Index vLow = vBegin; vLow < vEnd; ++vLow) {
+            int * bucket = &buckets.faceVerts[0] + buckets.offsets[vLow];
+            int   size   = buckets.offsets[vLow + 1] - buckets.offsets[vLow];
+
+            //  Insertion sort by the other vertex -- stable, buckets being of the
+            //  size of the valence:
+            for (int i = 1; i < size; ++i) {
+                int   fv    = bucket[i];
+                Index vHigh = getOtherEdgeVertex(buckets, faceVertIndices, fv, vLow);
+
+                int j = i;
+                for ( ; j > 0; --j) {
+                    if (getOtherEdgeVertex(buckets, faceVertIndices, bucket[j-1], vLow) <= vHigh) break;
+                    bucket[j] = bucket[j-1];
+                }
+                bucket[j] = fv;
+            }
+
+            for (int i = 0; i < size; ) {
+                int   fv    = bucket[i];
+                Index vHigh = getOtherEdgeVertex(buckets, faceVertIndices, fv, vLow);
+
+                int n = 1;
+                while ((i + n < size) &&
+                       (getOtherEdgeVertex(buckets, faceVertIndices, bucket[i+n], vLow) == vHigh)) {
+                    ++n;
+                }
+                bool manifold = (n == 1) ||
+                    ((n == 2) && (buckets.faceVertFaces[fv] != buckets.faceVertFaces[bucket[i+1]]) &&
+                                 (faceVertIndices[fv] != faceVertIndices[bucket[i+1]]));
+
+                for (int j = 0; j < n; ++j) {
+                    buckets.firstFaceVert[bucket[i+j]] = manifold ? fv : -1;
+                }
+                i += n;
+            }
+        }
+    }
+}
+
+bool
+Level::identifyManifoldEdgesFromFaceVertices(int & edgeCount, Concurrency const & concurrency) {
+
+    int vCount  = getNumVertices();
+    int fvCount = getNumFaceVerticesTotal();
+
+    //  Face-vertices are first counted per bucket, then assigned in order:
+    std::vector<int>   offsets(vCount + 1, 0);
+    std::vector<Index> nextVerts(fvCount);
+    IndexVector        faceVertFaces(fvCount);
+
+    for (Index fIndex = 0; fIndex < getNumFaces(); ++fIndex) {
+        ConstIndexArray fVerts = getFaceVertices(fIndex);
+
+        int fvOffset = getOffsetOfFaceVertices(fIndex);
+        for (int i = 0; i < fVerts.size(); ++i) {
+            Index v0 = fVerts[i];
+            Index v1 = fVerts[(i+1) % fVerts.size()];
+            if (v0 == v1) return false;
+
+            nextVerts[fvOffset + i]     = v1;
+            faceVertFaces[fvOffset + i] = fIndex;
+            offsets[std::min(v0, v1) + 1] ++;
+        }
+    }
+    for (int i = 0; i < vCount; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<int> faceVerts(fvCount);
+    {
+        std::vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (int fv = 0; fv < fvCount; ++fv) {
+            faceVerts[next[std::min(_faceVertIndices[fv], nextVerts[fv])]++] = fv;
+        }
+    }
+
+    std::vector<int> firstFaceVert(fvCount);
+
+    EdgeBuckets buckets(this, offsets, faceVerts, nextVerts, firstFaceVert, faceVertFaces);
+    applyConcurrently(concurrency, vCount, identifyBucketEdges, &buckets);
+
+    //  Number the edges in order of their first face-vertex:
+    _faceEdgeIndices.resize(fvCount);
+
+    edgeCount = 0;
+    for (int fv = 0; fv < fvCount; ++fv) {
+        int fvFirst = firstFaceVert[fv];
+        if (fvFirst < 0) return false;
+
+        _faceEdgeIndices[fv] = (fvFirst == fv) ? edgeCount++ : _faceEdgeIndices[fvFirst];
+    }
+    return true;
+}
+
+//
+//  Complete the topology given the face-edges (the edge from each face-vertex to the next)
+//  of all faces -- the incident components are counted and assigned directly in the order
+//  they would be incrementally by completeTopologyFromFaceVertices(), and non-manifold
+//  edges are tagged from the faces incident them.  The orientation of the vertices and
+//  their local indices are then independent and determined concurrently:
+//
+namespace {
+    void
+    orientAndPopulateVertexRanges(int vBegin, int vEnd, void * data) {
+
+        Level & level = *static_cast<Level *>(data);
+
+        level.orientIncidentComponents(vBegin, vEnd);
+        level.populateVertexLocalIndices(vBegin, vEnd);
+    }
+
+    void
+    populateEdgeRanges(int eBegin, int eEnd, void * data) {
+
+        static_cast<Level *>(data)->populateEdgeLocalIndices(eBegin, eEnd);
+    }
+}
+
+bool
+Level::completeTopologyFromFaceEdges(int eCount, Concurrency const & concurrency) {
+
+    int vCount = getNumVertices();
+    int fCount = getNumFaces();
+    assert((vCount > 0) && (fCount > 0) && (getNumEdges() == 0) && (eCount > 0));
+    assert((int)_faceEdgeIndices.size() == getNumFaceVerticesTotal());
+
+    resizeEdges(eCount);
+    resizeEdgeVertices();
+    std::fill(_edgeVertIndices.begin(), _edgeVertIndices.end(), INDEX_INVALID);
+
+    //  Count the incident faces of edges and vertices, assigning the vertices of each edge
+    //  from its first occurrence and tagging the occurrences that are non-manifold:
+    IndexVector edgeLastFace(eCount, INDEX_INVALID);
+
+    std::fill(_edgeFaceCountsAndOffsets.begin(), _edgeFaceCountsAndOffsets.end(), 0);
+    std::fill(_vertFaceCountsAndOffsets.begin(), _vertFaceCountsAndOffsets.end(), 0);
+    std::fill(_vertEdgeCountsAndOffsets.begin(), _vertEdgeCountsAndOffsets.end(), 0);
+
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        ConstIndexArray fVerts = getFaceVertices(fIndex);
+        ConstIndexArray fEdges = getFaceEdges(fIndex);
+
+        for (int i = 0; i < fVerts.size(); ++i) {
+            Index v0Index = fVerts[i];
+            Index v1Index = fVerts[(i+1) % fVerts.size()];
+            Index eIndex  = fEdges[i];
+
+            Index * eVerts = &_edgeVertIndices[2*eIndex];
+            int &   eFaceCount = _edgeFaceCountsAndOffsets[2*eIndex];
+            if (eFaceCount == 0) {
+                eVerts[0] = v0Index;
+                eVerts[1] = v1Index;
+                _vertEdgeCountsAndOffsets[2*v0Index] ++;
+                _vertEdgeCountsAndOffsets[2*v1Index] ++;
+            }
+            if ((v0Index == v1Index) || (eFaceCount > 1) || (edgeLastFace[eIndex] == fIndex) ||
+                ((eFaceCount == 1) && (v0Index == eVerts[0]))) {
+                _edgeTags[eIndex]._nonManifold = true;
+            }
+            edgeLastFace[eIndex] = fIndex;
+
+            eFaceCount ++;
+            _vertFaceCountsAndOffsets[2*v0Index] ++;
+        }
+    }
+
+    //  Accumulate the offsets and the maximum counts, then assign the incident members:
+    int maxEdgeFaces = 0;
+    int maxVertFaces = 0;
+    int maxVertEdges = 0;
+    for (Index eIndex = 0, offset = 0; eIndex < eCount; ++eIndex) {
+        if (_edgeVertIndices[2*eIndex] == INDEX_INVALID) return false;
+
+        _edgeFaceCountsAndOffsets[2*eIndex+1] = offset;
+        offset += _edgeFaceCountsAndOffsets[2*eIndex];
+        maxEdgeFaces = std::max(maxEdgeFaces, _edgeFaceCountsAndOffsets[2*eIndex]);
+    }
+    for (Index vIndex = 0, fOffset = 0, eOffset = 0; vIndex < vCount; ++vIndex) {
+        _vertFaceCountsAndOffsets[2*vIndex+1] = fOffset;
+        _vertEdgeCountsAndOffsets[2*vIndex+1] = eOffset;
+        fOffset += _vertFaceCountsAndOffsets[2*vIndex];
+        eOffset += _vertEdgeCountsAndOffsets[2*vIndex];
+        maxVertFaces = std::max(maxVertFaces, _vertFaceCountsAndOffsets[2*vIndex]);
+        maxVertEdges = std::max(maxVertEdges, _vertEdgeCountsAndOffsets[2*vIndex]);
+    }
+    _edgeFaceIndices.resize(getNumFaceVerticesTotal());
+    _vertFaceIndices.resize(getNumFaceVerticesTotal());
+    _vertEdgeIndices.resize(2 * eCount);
+
+    //  Counts are reset and incremented again as members are assigned:
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        _edgeFaceCountsAndOffsets[2*eIndex] = 0;
+    }
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        _vertFaceCountsAndOffsets[2*vIndex] = 0;
+        _vertEdgeCountsAndOffsets[2*vIndex] = 0;
+    }
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        for (int i = 0; i < 2; ++i) {
+            Index vIndex = _edgeVertIndices[2*eIndex+i];
+            int * vEdgeCountAndOffset = &_vertEdgeCountsAndOffsets[2*vIndex];
+            _vertEdgeIndices[vEdgeCountAndOffset[1] + vEdgeCountAndOffset[0]++] = eIndex;
+        }
+    }
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        ConstIndexArray fVerts = getFaceVertices(fIndex);
+        ConstIndexArray fEdges = getFaceEdges(fIndex);
+
+        for (int i = 0; i < fVerts.size(); ++i) {
+            int * eFaceCountAndOffset = &_edgeFaceCountsAndOffsets[2*fEdges[i]];
+            _edgeFaceIndices[eFaceCountAndOffset[1] + eFaceCountAndOffset[0]++] = fIndex;
+
+            int * vFaceCountAndOffset = &_vertFaceCountsAndOffsets[2*fVerts[i]];
+            _vertFaceIndices[vFaceCountAndOffset[1] + vFaceCountAndOffset[0]++] = fIndex;
+        }
+    }
+
+    _maxEdgeFaces = maxEdgeFaces;
+
+    assert(_maxValence > 0);
+    _maxValence = std::max(maxVertFaces, _maxValence);
+    _maxValence = std::max(maxVertEdges, _maxValence);
+
+    if (_maxValence > VALENCE_LIMIT) {
+        return false;
+    }
+
+    //  Tag the vertices of non-manifold edges before orienting and populating local indices
+    //  as completeTopologyFromFaceVertices() does:
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        if (_edgeTags[eIndex]._nonManifold) {
+            _vertTags[_edgeVertIndices[2*eIndex]]._nonManifold = true;
+            _vertTags[_edgeVertIndices[2*eIndex+1]]._nonManifold = true;
+        }
+    }
+
+    _vertFaceLocalIndices.resize(_vertFaceIndices.size());
+    _vertEdgeLocalIndices.resize(_vertEdgeIndices.size());
+    _edgeFaceLocalIndices.resize(_edgeFaceIndices.size());
+
+    applyConcurrently(concurrency, vCount, orientAndPopulateVertexRanges, this);
+    applyConcurrently(concurrency, eCount, populateEdgeRanges, this);
+    return true;
+}
+
 void
 Level::populateLocalIndices() {
 
     //
     //  We have three sets of local indices -- edge-faces, vert-faces and vert-edges:
     //
-    int eCount = this->getNumEdges();
-    int vCount = this->getNumVertices();
-
     this->_vertFaceLocalIndices.resize(this->_vertFaceIndices.size());
     this->_vertEdgeLocalIndices.resize(this->_vertEdgeIndices.size());
     this->_edgeFaceLocalIndices.resize(this->_edgeFaceIndices.size());
 
-    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+    populateVertexLocalIndices(0, this->getNumVertices());
+    populateEdgeLocalIndices(0, this->getNumEdges());
+
+    for (Index vIndex = 0; vIndex < this->getNumVertices(); ++vIndex) {
+        _maxValence = std::max(_maxValence, this->getNumVertexEdges(vIndex));
+    }
+}
+
+void
+Level::populateVertexLocalIndices(Index vBegin, Index vEnd) {
+
+    for (Index vIndex = vBegin; vIndex < vEnd; ++vIndex) {
         IndexArray      vFaces   = this->getVertexFaces(vIndex);
         LocalIndexArray vInFaces = this->getVertexFaceLocalIndices(vIndex);
 
@@ -1741,9 +2495,7 @@ Level::populateLocalIndices() {
 
             vFaceLast = vFaces[i];
         }
-    }
 
-    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         IndexArray      vEdges   = this->getVertexEdges(vIndex);
         LocalIndexArray vInEdges = this->getVertexEdgeLocalIndices(vIndex);
 
@@ -1760,10 +2512,13 @@ Level::populateLocalIndices() {
                 vInEdges[i] = (i && (vEdges[i] == vEdges[i-1]));
             }
         }
-        _maxValence = std::max(_maxValence, vEdges.size());
     }
+}
 
-    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+void
+Level::populateEdgeLocalIndices(Index eBegin, Index eEnd) {
+
+    for (Index eIndex = eBegin; eIndex < eEnd; ++eIndex) {
         IndexArray      eFaces   = this->getEdgeFaces(eIndex);
         LocalIndexArray eInFaces = this->getEdgeFaceLocalIndices(eIndex);
 
@@ -1788,11 +2543,11 @@ Level::populateLocalIndices() {
 }
 
 void
-Level::orientIncidentComponents() {
+Level::orientIncidentComponents(Index vBegin, Index vEnd) {
 
-    int vCount = getNumVertices();
+    if (vEnd < 0) vEnd = getNumVertices();
 
-    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+    for (Index vIndex = vBegin; vIndex < vEnd; ++vIndex) {
         Level::VTag & vTag = _vertTags[vIndex];
         if (!vTag._nonManifold) {
             if (!orderVertexFacesAndEdges(vIndex)) {
@@ -1949,6 +2704,12 @@ Level::destroyFVarChannel(int channel) {
     _fvarChannels.erase(_fvarChannels.begin() + channel);
 }
 
+void
+Level::swapFVarChannels(int channel, int otherChannel) {
+
+    std::swap(_fvarChannels[channel], _fvarChannels[otherChannel]);
+}
+
 int
 Level::getNumFVarValues(int channel) const {
     return _fvarChannels[channel]->getNumValues();
@@ -1961,7 +2722,7 @@ Level::getFVarOptions(int channel) const {
 
 ConstIndexArray
 Level::getFaceFVarValues(Index faceIndex, int channel) const {
-    return _fvarChannels[channel]->getFaceValues(faceIndex);
+    return getFVarLevel(channel).getFaceValues(faceIndex);
 }
 
 IndexArray
@@ -1970,8 +2731,60 @@ Level::getFaceFVarValues(Index faceIndex, int channel) {
 }
 
 void
-Level::completeFVarChannelTopology(int channel, int regBoundaryValence) {
-    return _fvarChannels[channel]->completeTopologyFromFaceValues(regBoundaryValence);
+Level::completeFVarChannelTopology(int channel, int regBoundaryValence,
+                                   Concurrency const & concurrency) {
+    return _fvarChannels[channel]->completeTopologyFromFaceValues(regBoundaryValence, concurrency);
+}
+
+//
+//  Channels are independent of each other, so when there are several they are completed
+//  concurrently (each serially) rather than each completed concurrently in turn:
+//
+namespace {
+    struct FVarChannelCompletion {
+        Level * level;
+        int     regBoundaryValence;
+    };
+
+    void
+    completeFVarChannelRange(int begin, int end, void * data) {
+
+        FVarChannelCompletion const & completion = *static_cast<FVarChannelCompletion const *>(data);
+
+        for (int channel = begin; channel < end; ++channel) {
+            completion.level->completeFVarChannelTopology(channel, completion.regBoundaryValence);
+        }
+    }
+}
+
+void
+Level::completeFVarChannelsTopology(int regBoundaryValence, Concurrency const & concurrency) {
+
+    int numChannels = getNumFVarChannels();
+
+    bool isConcurrent = (concurrency._numThreads > 1) || concurrency._parallelFor;
+    if ((numChannels == 1) || !isConcurrent) {
+        for (int channel = 0; channel < numChannels; ++channel) {
+            completeFVarChannelTopology(channel, regBoundaryValence, concurrency);
+        }
+        return;
+    }
+
+    FVarChannelCompletion completion;
+    completion.level              = this;
+    completion.regBoundaryValence = regBoundaryValence;
+
+    if (concurrency._parallelFor) {
+        concurrency._parallelFor(0, numChannels, completeFVarChannelRange, &completion,
+                                 concurrency._parallelForData);
+    } else {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(concurrency._numThreads)
+#endif
+        for (int channel = 0; channel < numChannels; ++channel) {
+            completeFVarChannelRange(channel, channel + 1, &completion);
+        }
+    }
 }
 
 } // end namespace internal
@@ -30,6 +30,7 @@
 #include "../sdc/crease.h"
 #include "../sdc/options.h"
 #include "../vtr/types.h"
+#include "../vtr/arena.h"
 
 #include <algorithm>
 #include <vector>
@@ -149,10 +150,42 @@ public:
 
     ETag getFaceCompositeETag(ConstIndexArray & faceEdges) const;
 
+    //  Vectors of tags (see Arena for the optional allocation of refined levels):
+    typedef std::vector<VTag, ArenaAllocator<VTag> > VTagVector;
+    typedef std::vector<ETag, ArenaAllocator<ETag> > ETagVector;
+    typedef std::vector<FTag, ArenaAllocator<FTag> > FTagVector;
+
+    //  Optional concurrency -- a client function to apply a kernel to sub-ranges of
+    //  [begin, end) concurrently (as for Refinement), or OpenMP threads otherwise:
+    typedef void (*RangeKernel)(int begin, int end, void * kernelData);
+    typedef void (*ParallelFor)(int begin, int end, RangeKernel kernel, void * kernelData,
+                                void const * clientData);
+
+    struct Concurrency {
+        Concurrency(int numThreads = 1, ParallelFor parallelFor = 0, void const * parallelForData = 0) :
+            _numThreads(numThreads), _parallelFor(parallelFor), _parallelForData(parallelForData) { }
+
+        int          _numThreads;
+        ParallelFor  _parallelFor;
+        void const * _parallelForData;
+    };
+
+    //  Application of a kernel to sub-ranges of numItems given the above (serially when
+    //  no concurrency is specified):
+    static void applyConcurrently(Concurrency const & concurrency, int numItems,
+                                  RangeKernel kernel, void * kernelData);
+
 public:
-    Level();
+    //  All vectors of the Level are allocated from the given Arena (if any):
+    Level(Arena * arena = 0);
     ~Level();
 
+    //  Copy of all topology, sharpness and tags of another Level -- not allocated
+    //  from any Arena and with or without copies of its face-varying channels:
+    Level(Level const & source, bool copyFVarChannels);
+
+    Arena * getArena() const { return _arena; }
+
     //  Simple accessors:
     int getDepth() const { return _depth; }
 
@@ -259,14 +292,37 @@ public:
 
     typedef void (* ValidationCallback)(TopologyError errCode, char const * msg, void const * clientData);
 
-    bool validateTopology(ValidationCallback callback=0, void const * clientData=0) const;
+    bool validateTopology(ValidationCallback callback=0, void const * clientData=0,
+                          Concurrency const & concurrency = Concurrency()) const;
+
+    //  Validation of a single component (returning the subset of the given checks
+    //  that failed) -- components are independent and validated concurrently:
+    enum ValidationChecks {
+        VALIDATE_FACE_VERTS       = 1,
+        VALIDATE_FACE_EDGES       = 2,
+        VALIDATE_EDGE_VERTS       = 1,
+        VALIDATE_EDGE_TAGS        = 2,
+        VALIDATE_VERT_ORIENTATION = 1
+    };
+
+    int validateFaceTopology(  Index face, int checks,
+                               ValidationCallback callback=0, void const * clientData=0) const;
+    int validateEdgeTopology(  Index edge, int checks,
+                               ValidationCallback callback=0, void const * clientData=0) const;
+    int validateVertexTopology(Index vert, int checks,
+                               ValidationCallback callback=0, void const * clientData=0) const;
 
     void print(const Refinement* parentRefinement = 0) const;
 
+    //  Memory held by the topology (face-varying channels excluded):
+    void getMemoryUsage(MemoryUsage & usage) const;
+
 public:
     //  High-level topology queries -- these may be moved elsewhere:
 
     bool isSingleCreasePatch(Index face, float* sharpnessOut=NULL, int* rotationOut=NULL) const;
+    bool isTriRegularPatch(Index face, int* boundaryMaskOut=NULL) const;
+    bool isInfSharpRegularPatch(Index face, int* infSharpEdgeMaskOut=NULL) const;
 
     //
     //  When gathering "patch points" we may want the indices of the vertices or the corresponding
@@ -284,6 +340,9 @@ public:
     int gatherQuadRegularCornerPatchPoints(  Index fIndex, Index patchPoints[], int cornerVertInFace,
                                                                                 int fvarChannel = -1) const;
 
+    int gatherQuadRegularInfSharpPatchPoints(Index fIndex, Index patchPoints[], int infSharpEdgeMask,
+                                                                                int fvarChannel = -1) const;
+
     int gatherQuadRegularRingAroundVertex(Index vIndex, Index ringPoints[], int fvarChannel = -1) const;
 
     //  WIP -- for future use, need to extend for face-varying...
@@ -328,15 +387,25 @@ public:
     //  Create, destroy and populate face-varying channels:
     int  createFVarChannel(int fvarValueCount, Sdc::Options const& options);
     void destroyFVarChannel(int channel);
+    void swapFVarChannels(int channel, int otherChannel);
 
     IndexArray getFaceFVarValues(Index faceIndex, int channel);
 
-    void completeFVarChannelTopology(int channel, int regBoundaryValence);
+    void completeFVarChannelTopology(int channel, int regBoundaryValence,
+                                     Concurrency const & concurrency = Concurrency());
+    void completeFVarChannelsTopology(int regBoundaryValence,
+                                      Concurrency const & concurrency = Concurrency());
 
     //  Counts and offsets for all relation types:
     //      - these may be unwarranted if we let Refinement access members directly...
-    int getNumFaceVertices(     Index faceIndex) const { return _faceVertCountsAndOffsets[2*faceIndex]; }
-    int getOffsetOfFaceVertices(Index faceIndex) const { return _faceVertCountsAndOffsets[2*faceIndex + 1]; }
+    //      - face-vertex counts/offsets are implicit when all faces are regular (see
+    //        getRegularFaceSize() below)
+    int getNumFaceVertices(Index faceIndex) const {
+        return _regFaceSize ? _regFaceSize : _faceVertCountsAndOffsets[2*faceIndex];
+    }
+    int getOffsetOfFaceVertices(Index faceIndex) const {
+        return _regFaceSize ? (faceIndex * _regFaceSize) : _faceVertCountsAndOffsets[2*faceIndex + 1];
+    }
 
     int getNumFaceEdges(     Index faceIndex) const { return getNumFaceVertices(faceIndex); }
     int getOffsetOfFaceEdges(Index faceIndex) const { return getOffsetOfFaceVertices(faceIndex); }
@@ -353,7 +422,13 @@ public:
     int getNumVertexEdges(     Index vertIndex) const { return _vertEdgeCountsAndOffsets[2*vertIndex]; }
     int getOffsetOfVertexEdges(Index vertIndex) const { return _vertEdgeCountsAndOffsets[2*vertIndex + 1]; }
 
+    //  Relations of all components of a type at once (ordered by component):
     ConstIndexArray getFaceVertices() const;
+    ConstIndexArray getFaceEdges() const;
+    ConstIndexArray getEdgeVertices() const;
+
+    ConstArray<float> getEdgeSharpnesses() const;
+    ConstArray<float> getVertexSharpnesses() const;
 
     //
     //  Note that for some relations, the size of the relations for a child component
@@ -375,6 +450,13 @@ public:
     void resizeVertexEdges(Index vertIndex, int count);
     void trimVertexEdges(  Index vertIndex, int count);
 
+    //  Variants assigning the offset explicitly rather than deriving it from the
+    //  preceding component -- these do not update the maximal counts (valence,
+    //  etc.) and so are safe to use when components are populated concurrently:
+    void resizeEdgeFaces(  Index edgeIndex, int count, int offset);
+    void resizeVertexFaces(Index vertIndex, int count, int offset);
+    void resizeVertexEdges(Index vertIndex, int count, int offset);
+
 public:
     //
     //  Initial plans were to have a few specific classes properly construct the
@@ -384,17 +466,31 @@ public:
     //  it necessary to write code to define and orient all relations -- and most
     //  of that seemed best placed here.
     //
-    bool completeTopologyFromFaceVertices();
+
+    bool completeTopologyFromFaceVertices(Concurrency const & concurrency = Concurrency());
     Index findEdge(Index v0, Index v1, ConstIndexArray v0Edges) const;
 
-    //  Methods supporting the above:
-    void orientIncidentComponents();
+    //  Faster alternatives -- identification of the edges of a manifold mesh by sorting its
+    //  face-vertices (fails, leaving the face-edges incomplete, if any non-manifold feature
+    //  is detected), and completion of the topology given both face-vertices and face-edges:
+    bool identifyManifoldEdgesFromFaceVertices(int & edgeCount,
+                                               Concurrency const & concurrency = Concurrency());
+    bool completeTopologyFromFaceEdges(int edgeCount,
+                                       Concurrency const & concurrency = Concurrency());
+
+    //  Methods supporting the above (over all or a range of components):
+    void orientIncidentComponents(Index vBegin = 0, Index vEnd = -1);
     bool orderVertexFacesAndEdges(Index vIndex, Index* vFaces, Index* vEdges) const;
     bool orderVertexFacesAndEdges(Index vIndex);
     void populateLocalIndices();
+    void populateVertexLocalIndices(Index vBegin, Index vEnd);
+    void populateEdgeLocalIndices(Index eBegin, Index eEnd);
 
     IndexArray shareFaceVertCountsAndOffsets() const;
 
+    //  Size of all faces when their counts/offsets are implicit, or 0 when stored:
+    int getRegularFaceSize() const { return _regFaceSize; }
+
 private:
     //  Refinement classes (including all subclasses) build a Level:
     friend class Refinement;
@@ -423,6 +519,13 @@ private:
     int _maxEdgeFaces;
     int _maxValence;
 
+    //  Refined levels of quads or tris do not store the face-vertex counts/offsets --
+    //  each face has this many vertices (0 when counts/offsets are stored):
+    int _regFaceSize;
+
+    //  Optional allocator of all of the vectors below:
+    Arena * _arena;
+
     //
     //  Topology vectors:
     //      Note that of all of these, only data for the face-edge relation is not
@@ -442,34 +545,44 @@ private:
     //
 
     //  Per-face:
-    std::vector<Index> _faceVertCountsAndOffsets;  // 2 per face, redundant after level 0
-    std::vector<Index> _faceVertIndices;           // 3 or 4 per face, variable at level 0
-    std::vector<Index> _faceEdgeIndices;           // matches face-vert indices
-    std::vector<FTag>  _faceTags;                  // 1 per face:  includes "hole" tag
+    ArenaIndexVector _faceVertCountsAndOffsets;  // 2 per face, implicit after level 0
+    ArenaIndexVector _faceVertIndices;           // 3 or 4 per face, variable at level 0
+    ArenaIndexVector _faceEdgeIndices;           // matches face-vert indices
+    FTagVector       _faceTags;                  // 1 per face:  includes "hole" tag
 
     //  Per-edge:
-    std::vector<Index>      _edgeVertIndices;           // 2 per edge
-    std::vector<Index>      _edgeFaceCountsAndOffsets;  // 2 per edge
-    std::vector<Index>      _edgeFaceIndices;           // varies with faces per edge
-    std::vector<LocalIndex> _edgeFaceLocalIndices;      // varies with faces per edge
+    ArenaIndexVector      _edgeVertIndices;           // 2 per edge
+    ArenaIndexVector      _edgeFaceCountsAndOffsets;  // 2 per edge
+    ArenaIndexVector      _edgeFaceIndices;           // varies with faces per edge
+    ArenaLocalIndexVector _edgeFaceLocalIndices;      // varies with faces per edge
 
-    std::vector<float>      _edgeSharpness;             // 1 per edge
-    std::vector<ETag>       _edgeTags;                  // 1 per edge:  manifold, boundary, etc.
+    ArenaFloatVector      _edgeSharpness;             // 1 per edge
+    ETagVector            _edgeTags;                  // 1 per edge:  manifold, boundary, etc.
 
     //  Per-vertex:
-    std::vector<Index>      _vertFaceCountsAndOffsets;  // 2 per vertex
-    std::vector<Index>      _vertFaceIndices;           // varies with valence
-    std::vector<LocalIndex> _vertFaceLocalIndices;      // varies with valence, 8-bit for now
-
-    std::vector<Index>      _vertEdgeCountsAndOffsets;  // 2 per vertex
-    std::vector<Index>      _vertEdgeIndices;           // varies with valence
-    std::vector<LocalIndex> _vertEdgeLocalIndices;      // varies with valence, 8-bit for now
-
-    std::vector<float>      _vertSharpness;             // 1 per vertex
-    std::vector<VTag>       _vertTags;                  // 1 per vertex:  manifold, Sdc::Rule, etc.
+    //      Unlike face-vertices, the counts/offsets remain explicit at all levels as
+    //      valences vary around extraordinary and boundary vertices.  There is no
+    //      compact 16-bit mode for the counts:  the pairs are interleaved so that
+    //      offsets follow incrementally from the preceding vertex, and only the
+    //      local indices are 16-bit.
+    ArenaIndexVector      _vertFaceCountsAndOffsets;  // 2 per vertex
+    ArenaIndexVector      _vertFaceIndices;           // varies with valence
+    ArenaLocalIndexVector _vertFaceLocalIndices;      // varies with valence, 16-bit
+
+    ArenaIndexVector      _vertEdgeCountsAndOffsets;  // 2 per vertex
+    ArenaIndexVector      _vertEdgeIndices;           // varies with valence
+    ArenaLocalIndexVector _vertEdgeLocalIndices;      // varies with valence, 16-bit
+
+    ArenaFloatVector      _vertSharpness;             // 1 per vertex
+    VTagVector            _vertTags;                  // 1 per vertex:  manifold, Sdc::Rule, etc.
 
     //  Face-varying channels:
     std::vector<FVarLevel*> _fvarChannels;
+
+private:
+    //  Not copyable other than explicitly (the face-varying channels are owned):
+    Level(Level const &);
+    Level & operator=(Level const &);
 };
 
 //
@@ -477,18 +590,20 @@ private:
 //
 inline ConstIndexArray
 Level::getFaceVertices(Index faceIndex) const {
-    return ConstIndexArray(&_faceVertIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return ConstIndexArray(&_faceVertIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 inline IndexArray
 Level::getFaceVertices(Index faceIndex) {
-    return IndexArray(&_faceVertIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return IndexArray(&_faceVertIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 
 inline void
 Level::resizeFaceVertices(Index faceIndex, int count) {
 
+    assert(_regFaceSize == 0);
+
     int* countOffsetPair = &_faceVertCountsAndOffsets[faceIndex*2];
 
     countOffsetPair[0] = count;
@@ -501,19 +616,40 @@ inline ConstIndexArray
 Level::getFaceVertices() const {
     return ConstIndexArray(&_faceVertIndices[0], (int)_faceVertIndices.size());
 }
+inline ConstIndexArray
+Level::getFaceEdges() const {
+    return ConstIndexArray(_faceEdgeIndices.empty() ? 0 : &_faceEdgeIndices[0],
+                           (int)_faceEdgeIndices.size());
+}
+inline ConstIndexArray
+Level::getEdgeVertices() const {
+    return ConstIndexArray(_edgeVertIndices.empty() ? 0 : &_edgeVertIndices[0],
+                           (int)_edgeVertIndices.size());
+}
+
+inline ConstArray<float>
+Level::getEdgeSharpnesses() const {
+    return ConstArray<float>(_edgeSharpness.empty() ? 0 : &_edgeSharpness[0],
+                             (int)_edgeSharpness.size());
+}
+inline ConstArray<float>
+Level::getVertexSharpnesses() const {
+    return ConstArray<float>(_vertSharpness.empty() ? 0 : &_vertSharpness[0],
+                             (int)_vertSharpness.size());
+}
 
 //
 //  Access/modify the edges indicent a given face:
 //
 inline ConstIndexArray
 Level::getFaceEdges(Index faceIndex) const {
-    return ConstIndexArray(&_faceEdgeIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return ConstIndexArray(&_faceEdgeIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 inline IndexArray
 Level::getFaceEdges(Index faceIndex) {
-    return IndexArray(&_faceEdgeIndices[_faceVertCountsAndOffsets[faceIndex*2+1]],
-                          _faceVertCountsAndOffsets[faceIndex*2]);
+    return IndexArray(&_faceEdgeIndices[getOffsetOfFaceVertices(faceIndex)],
+                          getNumFaceVertices(faceIndex));
 }
 
 //
@@ -549,6 +685,13 @@ Level::resizeVertexFaces(Index vertIndex, int count) {
     countOffsetPair[1] = (vertIndex == 0) ? 0 : (countOffsetPair[-2] + countOffsetPair[-1]);
 }
 inline void
+Level::resizeVertexFaces(Index vertIndex, int count, int offset) {
+    int* countOffsetPair = &_vertFaceCountsAndOffsets[vertIndex*2];
+
+    countOffsetPair[0] = count;
+    countOffsetPair[1] = offset;
+}
+inline void
 Level::trimVertexFaces(Index vertIndex, int count) {
     _vertFaceCountsAndOffsets[vertIndex*2] = count;
 }
@@ -588,6 +731,13 @@ Level::resizeVertexEdges(Index vertIndex, int count) {
     _maxValence = std::max(_maxValence, count);
 }
 inline void
+Level::resizeVertexEdges(Index vertIndex, int count, int offset) {
+    int* countOffsetPair = &_vertEdgeCountsAndOffsets[vertIndex*2];
+
+    countOffsetPair[0] = count;
+    countOffsetPair[1] = offset;
+}
+inline void
 Level::trimVertexEdges(Index vertIndex, int count) {
     _vertEdgeCountsAndOffsets[vertIndex*2] = count;
 }
@@ -648,6 +798,13 @@ Level::resizeEdgeFaces(Index edgeIndex, int count) {
     _maxEdgeFaces = std::max(_maxEdgeFaces, count);
 }
 inline void
+Level::resizeEdgeFaces(Index edgeIndex, int count, int offset) {
+    int* countOffsetPair = &_edgeFaceCountsAndOffsets[edgeIndex*2];
+
+    countOffsetPair[0] = count;
+    countOffsetPair[1] = offset;
+}
+inline void
 Level::trimEdgeFaces(Index edgeIndex, int count) {
     _edgeFaceCountsAndOffsets[edgeIndex*2] = count;
 }
@@ -784,6 +941,7 @@ inline IndexArray
 Level::shareFaceVertCountsAndOffsets() const {
     // XXXX manuelk we have to force const casting here (classes don't 'share'
     // members usually...)
+    assert(_regFaceSize == 0);
     return IndexArray(const_cast<Index *>(&_faceVertCountsAndOffsets[0]),
         (int)_faceVertCountsAndOffsets.size());
 }
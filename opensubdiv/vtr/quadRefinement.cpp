@@ -41,7 +41,8 @@ namespace internal {
 //  Simple constructor, destructor and basic initializers:
 //
 QuadRefinement::QuadRefinement(Level const & parentArg, Level & childArg, Sdc::Options const & optionsArg) :
-    Refinement(parentArg, childArg, optionsArg) {
+    Refinement(parentArg, childArg, optionsArg),
+    _quadParent(false) {
 
     _splitType   = Sdc::SPLIT_TO_QUADS;
     _regFaceSize = 4;
@@ -72,15 +73,33 @@ QuadRefinement::allocateParentChildIndices() {
     //
     //  First reference the parent Level's face-vertex counts/offsets -- they can be used
     //  here for both the face-child-faces and face-child-edges as they both have one per
-    //  face-vertex.
+    //  face-vertex.  When the parent is a refined level they are implicit, as they are
+    //  here -- as they also are for a base level of quads only.
     //
     //  Given we will be ignoring initial values with uniform refinement and assigning all
     //  directly, initializing here is a waste...
     //
     Index initValue = 0;
 
-    _faceChildFaceCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-    _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
+    _quadParent = (_parent->getRegularFaceSize() == 4);
+    if (!_parent->getRegularFaceSize() && (_parent->getNumFaces() > 0) &&
+        ((int)_parent->_faceVertIndices.size() == 4 * _parent->getNumFaces())) {
+        _quadParent = true;
+        for (Index pFace = 0; _quadParent && (pFace < _parent->getNumFaces()); ++pFace) {
+            _quadParent = (_parent->getNumFaceVertices(pFace) == 4);
+        }
+    }
+
+    if (_quadParent) {
+        _regFaceChildFaceCount = 4;
+        _regFaceChildEdgeCount = 4;
+    } else if (_parent->getRegularFaceSize()) {
+        _regFaceChildFaceCount = _parent->getRegularFaceSize();
+        _regFaceChildEdgeCount = _parent->getRegularFaceSize();
+    } else {
+        _faceChildFaceCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
+        _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
+    }
 
     _faceChildFaceIndices.resize(faceChildFaceCount, initValue);
     _faceChildEdgeIndices.resize(faceChildEdgeCount, initValue);
@@ -99,30 +118,14 @@ QuadRefinement::allocateParentChildIndices() {
 void
 QuadRefinement::populateFaceVertexRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets within a
-    //  Level, so be sure not to re-initialize it if already done:
-    //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
+    //  Face-vertex counts/offsets of the child are implicit (see Level::getRegularFaceSize()):
     _child->_faceVertIndices.resize(_child->getNumFaces() * 4);
 
-    populateFaceVerticesFromParentFaces();
+    populateFaceVerticesFromParentFaces(0, _parent->getNumFaces());
 }
 
 void
-QuadRefinement::populateFaceVertexCountsAndOffsets() {
-
-    _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2);
-
-    for (int i = 0; i < _child->getNumFaces(); ++i) {
-        _child->_faceVertCountsAndOffsets[i*2 + 0] = 4;
-        _child->_faceVertCountsAndOffsets[i*2 + 1] = i << 2;
-    }
-}
-
-void
-QuadRefinement::populateFaceVerticesFromParentFaces() {
+QuadRefinement::populateFaceVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd) {
 
     //
     //  This is pretty straight forward, but is a good example for the case of
@@ -134,7 +137,11 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
     //  for its face-verts from the child vertices of the parent face, its edges
     //  and its vertices.
     //
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    if (_quadParent) {
+        populateFaceVerticesFromParentQuads(pFaceBegin, pFaceEnd);
+        return;
+    }
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
                         pFaceChildren = getFaceChildFaces(pFace);
@@ -172,6 +179,50 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
     }
 }
 
+void
+QuadRefinement::populateFaceVerticesFromParentQuads(Index pFaceBegin, Index pFaceEnd) {
+
+    //
+    //  With quads only, the parent face-verts and face-edges, the child faces of
+    //  each parent face and the face-verts of each child face are all at fixed
+    //  strides of 4.  The child vertices of the corners and edges of the parent
+    //  face are gathered once and the child face at corner j takes them rotated
+    //  by j (preserving its orientation wrt the parent face):
+    //
+    Index const * pFaceVertIndices = &_parent->_faceVertIndices[0];
+    Index const * pFaceEdgeIndices = &_parent->_faceEdgeIndices[0];
+    Index *       cFaceVertIndices = &_child->_faceVertIndices[0];
+
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
+        Index const * pFaceVerts    = pFaceVertIndices + 4 * pFace;
+        Index const * pFaceEdges    = pFaceEdgeIndices + 4 * pFace;
+        Index const * pFaceChildren = &_faceChildFaceIndices[4 * pFace];
+
+        Index cVertOfFace = _faceChildVertIndex[pFace];
+
+        Index cVertsOfVerts[4] = { _vertChildVertIndex[pFaceVerts[0]],
+                                   _vertChildVertIndex[pFaceVerts[1]],
+                                   _vertChildVertIndex[pFaceVerts[2]],
+                                   _vertChildVertIndex[pFaceVerts[3]] };
+        Index cVertsOfEdges[4] = { _edgeChildVertIndex[pFaceEdges[0]],
+                                   _edgeChildVertIndex[pFaceEdges[1]],
+                                   _edgeChildVertIndex[pFaceEdges[2]],
+                                   _edgeChildVertIndex[pFaceEdges[3]] };
+
+        for (int j = 0; j < 4; ++j) {
+            Index cFace = pFaceChildren[j];
+            if (IndexIsValid(cFace)) {
+                Index * cFaceVerts = cFaceVertIndices + 4 * cFace;
+
+                cFaceVerts[j]           = cVertsOfVerts[j];
+                cFaceVerts[(j + 1) & 3] = cVertsOfEdges[j];
+                cFaceVerts[(j + 2) & 3] = cVertOfFace;
+                cFaceVerts[(j + 3) & 3] = cVertsOfEdges[(j + 3) & 3];
+            }
+        }
+    }
+}
+
 
 //
 //  Methods to populate the face-vertex relation of the child Level:
@@ -180,19 +231,13 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
 void
 QuadRefinement::populateFaceEdgeRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets, so be sure
-    //  not to re-initialize it if already done:
-    //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
     _child->_faceEdgeIndices.resize(_child->getNumFaces() * 4);
 
-    populateFaceEdgesFromParentFaces();
+    populateFaceEdgesFromParentFaces(0, _parent->getNumFaces());
 }
 
 void
-QuadRefinement::populateFaceEdgesFromParentFaces() {
+QuadRefinement::populateFaceEdgesFromParentFaces(Index pFaceBegin, Index pFaceEnd) {
 
     //
     //  This is fairly straight forward, but since we are dealing with edges here, we
@@ -205,7 +250,11 @@ QuadRefinement::populateFaceEdgesFromParentFaces() {
     //  The two remaining edges per child faces are perpendicular to these prev/next
     //  edges and share the child vertex of the parent face.
     //
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    if (_quadParent) {
+        populateFaceEdgesFromParentQuads(pFaceBegin, pFaceEnd);
+        return;
+    }
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
                         pFaceChildFaces = getFaceChildFaces(pFace),
@@ -271,6 +320,54 @@ QuadRefinement::populateFaceEdgesFromParentFaces() {
     }
 }
 
+void
+QuadRefinement::populateFaceEdgesFromParentQuads(Index pFaceBegin, Index pFaceEnd) {
+
+    //
+    //  As with the face-verts of parent quads, everything is at fixed strides.  The
+    //  two child edges of each parent edge are identified once per face -- the one
+    //  at the start of the edge (wrt the face) and the one at its end -- and each
+    //  child face takes its two edges on the parent boundary from these and its two
+    //  perpendicular edges from the child edges of the face:
+    //
+    Index const * pFaceVertIndices = &_parent->_faceVertIndices[0];
+    Index const * pFaceEdgeIndices = &_parent->_faceEdgeIndices[0];
+    Index const * pEdgeVertIndices = &_parent->_edgeVertIndices[0];
+    Index *       cFaceEdgeIndices = &_child->_faceEdgeIndices[0];
+
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
+        Index const * pFaceVerts      = pFaceVertIndices + 4 * pFace;
+        Index const * pFaceEdges      = pFaceEdgeIndices + 4 * pFace;
+        Index const * pFaceChildFaces = &_faceChildFaceIndices[4 * pFace];
+        Index const * pFaceChildEdges = &_faceChildEdgeIndices[4 * pFace];
+
+        //  Beware of degenerate edges here, as with non-quads:
+        Index cEdgesAtStart[4],
+              cEdgesAtEnd[4];
+        for (int j = 0; j < 4; ++j) {
+            Index const * pEdgeVerts    = pEdgeVertIndices + 2 * pFaceEdges[j];
+            Index const * pEdgeChildren = &_edgeChildEdgeIndices[2 * pFaceEdges[j]];
+
+            bool degenerate = (pEdgeVerts[0] == pEdgeVerts[1]);
+
+            cEdgesAtStart[j] = pEdgeChildren[degenerate ? 0 : (pEdgeVerts[0] != pFaceVerts[j])];
+            cEdgesAtEnd[j]   = pEdgeChildren[degenerate ? 1 : (pEdgeVerts[0] != pFaceVerts[(j + 1) & 3])];
+        }
+
+        for (int j = 0; j < 4; ++j) {
+            Index cFace = pFaceChildFaces[j];
+            if (IndexIsValid(cFace)) {
+                Index * cFaceEdges = cFaceEdgeIndices + 4 * cFace;
+
+                cFaceEdges[j]           = cEdgesAtStart[j];
+                cFaceEdges[(j + 1) & 3] = pFaceChildEdges[j];
+                cFaceEdges[(j + 2) & 3] = pFaceChildEdges[(j + 3) & 3];
+                cFaceEdges[(j + 3) & 3] = cEdgesAtEnd[(j + 3) & 3];
+            }
+        }
+    }
+}
+
 //
 //  Methods to populate the edge-vertex relation of the child Level:
 //      - child edges originate from parent faces and edges
@@ -280,12 +377,12 @@ QuadRefinement::populateEdgeVertexRelation() {
 
     _child->_edgeVertIndices.resize(_child->getNumEdges() * 2);
 
-    populateEdgeVerticesFromParentFaces();
-    populateEdgeVerticesFromParentEdges();
+    populateEdgeVerticesFromParentFaces(0, _parent->getNumFaces());
+    populateEdgeVerticesFromParentEdges(0, _parent->getNumEdges());
 }
 
 void
-QuadRefinement::populateEdgeVerticesFromParentFaces() {
+QuadRefinement::populateEdgeVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd) {
 
     //
     //  This is straight forward.  All child edges of parent faces are assigned
@@ -293,7 +390,28 @@ QuadRefinement::populateEdgeVerticesFromParentFaces() {
     //  to all.  The second vertex is the child vertex of the parent edge to
     //  which the new child edge is perpendicular.
     //
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    if (_quadParent) {
+        //  Fixed strides for the face-edges and child edges of parent quads:
+        Index const * pFaceEdgeIndices = &_parent->_faceEdgeIndices[0];
+        Index *       cEdgeVertIndices = &_child->_edgeVertIndices[0];
+
+        for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
+            Index const * pFaceEdges      = pFaceEdgeIndices + 4 * pFace;
+            Index const * pFaceChildEdges = &_faceChildEdgeIndices[4 * pFace];
+
+            Index cVertOfFace = _faceChildVertIndex[pFace];
+
+            for (int j = 0; j < 4; ++j) {
+                Index cEdge = pFaceChildEdges[j];
+                if (IndexIsValid(cEdge)) {
+                    cEdgeVertIndices[2 * cEdge]     = cVertOfFace;
+                    cEdgeVertIndices[2 * cEdge + 1] = _edgeChildVertIndex[pFaceEdges[j]];
+                }
+            }
+        }
+        return;
+    }
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
 
@@ -310,7 +428,7 @@ QuadRefinement::populateEdgeVerticesFromParentFaces() {
 }
 
 void
-QuadRefinement::populateEdgeVerticesFromParentEdges() {
+QuadRefinement::populateEdgeVerticesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd) {
 
     //
     //  This is straight forward.  All child edges of parent edges are assigned
@@ -318,7 +436,7 @@ QuadRefinement::populateEdgeVerticesFromParentEdges() {
     //  to both.  The second vertex is the child vertex of the vertex at the
     //  end of the parent edge.
     //
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (Index pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge),
                         pEdgeChildren = getEdgeChildEdges(pEdge);
 
@@ -371,24 +489,21 @@ QuadRefinement::populateEdgeFaceRelation() {
     _child->_edgeFaceIndices.resize(     childEdgeFaceIndexSizeEstimate);
     _child->_edgeFaceLocalIndices.resize(childEdgeFaceIndexSizeEstimate);
 
-    // Update _maxEdgeFaces from the parent level before calling the 
-    // populateEdgeFacesFromParent methods below, as these may further
-    // update _maxEdgeFaces.
-    _child->_maxEdgeFaces = _parent->_maxEdgeFaces;
-
-    populateEdgeFacesFromParentFaces();
-    populateEdgeFacesFromParentEdges();
+    //  Populate the child edges in order -- those from faces precede those from edges
+    //  and the offset of each is assigned explicitly from those preceding it:
+    int offset = 0;
+    offset = populateEdgeFacesFromParentFaces(0, _parent->getNumFaces(), offset);
+    offset = populateEdgeFacesFromParentEdges(0, _parent->getNumEdges(), offset);
 
-    //  Revise the over-allocated estimate based on what is used (as indicated in the
-    //  count/offset for the last vertex) and trim the index vector accordingly:
-    childEdgeFaceIndexSizeEstimate = _child->getNumEdgeFaces(_child->getNumEdges()-1) +
-                                     _child->getOffsetOfEdgeFaces(_child->getNumEdges()-1);
+    //  Revise the over-allocated estimate based on what is used (as indicated by the
+    //  offset following the last edge) and trim the index vector accordingly:
+    childEdgeFaceIndexSizeEstimate = offset;
     _child->_edgeFaceIndices.resize(     childEdgeFaceIndexSizeEstimate);
     _child->_edgeFaceLocalIndices.resize(childEdgeFaceIndexSizeEstimate);
 }
 
-void
-QuadRefinement::populateEdgeFacesFromParentFaces() {
+int
+QuadRefinement::populateEdgeFacesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset) {
 
     //
     //  This is straight forward topologically, but when refinement is sparse the
@@ -402,7 +517,7 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
     //  orientation of child faces within their parent depends on it being a quad
     //  or not.
     //
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceChildFaces = getFaceChildFaces(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
 
@@ -414,7 +529,7 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
                 //
                 //  Reserve enough edge-faces, populate and trim as needed:
                 //
-                _child->resizeEdgeFaces(cEdge, 2);
+                _child->resizeEdgeFaces(cEdge, 2, offset);
 
                 IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
                 LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -436,20 +551,22 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
                     cEdgeFaceCount++;
                 }
                 _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+                offset += cEdgeFaceCount;
             }
         }
     }
+    return offset;
 }
 
-void
-QuadRefinement::populateEdgeFacesFromParentEdges() {
+int
+QuadRefinement::populateEdgeFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) {
 
     //
     //  Note -- the edge-face counts/offsets vector is not known
-    //  ahead of time and is populated incrementally, so we cannot
-    //  thread this yet...
+    //  ahead of time and is populated incrementally from the given
+    //  offset, so the caller must reserve enough for each range...
     //
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (Index pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         ConstIndexArray pEdgeChildEdges = getEdgeChildEdges(pEdge);
         if (!IndexIsValid(pEdgeChildEdges[0]) && !IndexIsValid(pEdgeChildEdges[1])) continue;
 
@@ -462,7 +579,7 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
             if (!IndexIsValid(cEdge)) continue;
 
             //  Reserve enough edge-faces, populate and trim as needed:
-            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
+            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size(), offset);
 
             IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
             LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -498,8 +615,10 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
                 }
             }
             _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+            offset += cEdgeFaceCount;
         }
     }
+    return offset;
 }
 
 
@@ -508,7 +627,7 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
 //      - child vertices originate from parent faces, edges and vertices
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
-//          - note this imposes ordering constraints and inhibits concurrency
+//          - offsets are assigned explicitly so ranges can be populated concurrently
 //
 void
 QuadRefinement::populateVertexFaceRelation() {
@@ -539,28 +658,28 @@ QuadRefinement::populateVertexFaceRelation() {
     _child->_vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
+    int offset = 0;
     if (getFirstChildVertexFromVertices() == 0) {
-        populateVertexFacesFromParentVertices();
-        populateVertexFacesFromParentFaces();
-        populateVertexFacesFromParentEdges();
+        offset = populateVertexFacesFromParentVertices(0, _parent->getNumVertices(), offset);
+        offset = populateVertexFacesFromParentFaces(0, _parent->getNumFaces(), offset);
+        offset = populateVertexFacesFromParentEdges(0, _parent->getNumEdges(), offset);
     } else {
-        populateVertexFacesFromParentFaces();
-        populateVertexFacesFromParentEdges();
-        populateVertexFacesFromParentVertices();
+        offset = populateVertexFacesFromParentFaces(0, _parent->getNumFaces(), offset);
+        offset = populateVertexFacesFromParentEdges(0, _parent->getNumEdges(), offset);
+        offset = populateVertexFacesFromParentVertices(0, _parent->getNumVertices(), offset);
     }
 
-    //  Revise the over-allocated estimate based on what is used (as indicated in the
-    //  count/offset for the last vertex) and trim the index vectors accordingly:
-    childVertFaceIndexSizeEstimate = _child->getNumVertexFaces(_child->getNumVertices()-1) +
-                                     _child->getOffsetOfVertexFaces(_child->getNumVertices()-1);
+    //  Revise the over-allocated estimate based on what is used (as indicated by the
+    //  offset following the last vertex) and trim the index vectors accordingly:
+    childVertFaceIndexSizeEstimate = offset;
     _child->_vertFaceIndices.resize(     childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(childVertFaceIndexSizeEstimate);
 }
 
-void
-QuadRefinement::populateVertexFacesFromParentFaces() {
+int
+QuadRefinement::populateVertexFacesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset) {
 
-    for (int pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    for (int pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         int cVert = _faceChildVertIndex[pFace];
         if (!IndexIsValid(cVert)) continue;
 
@@ -570,7 +689,7 @@ QuadRefinement::populateVertexFacesFromParentFaces() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, pFaceSize);
+        _child->resizeVertexFaces(cVert, pFaceSize, offset);
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -589,13 +708,15 @@ QuadRefinement::populateVertexFacesFromParentFaces() {
             }
         }
         _child->trimVertexFaces(cVert, cVertFaceCount);
+        offset += cVertFaceCount;
     }
+    return offset;
 }
 
-void
-QuadRefinement::populateVertexFacesFromParentEdges() {
+int
+QuadRefinement::populateVertexFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) {
 
-    for (int pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (int pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         int cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
 
@@ -605,7 +726,7 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size());
+        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size(), offset);
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -641,13 +762,15 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
             }
         }
         _child->trimVertexFaces(cVert, cVertFaceCount);
+        offset += cVertFaceCount;
     }
+    return offset;
 }
 
-void
-QuadRefinement::populateVertexFacesFromParentVertices() {
+int
+QuadRefinement::populateVertexFacesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset) {
 
-    for (int pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
+    for (int pVert = pVertBegin; pVert < pVertEnd; ++pVert) {
         int cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
 
@@ -657,7 +780,7 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, pVertFaces.size());
+        _child->resizeVertexFaces(cVert, pVertFaces.size(), offset);
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -683,7 +806,9 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
             }
         }
         _child->trimVertexFaces(cVert, cVertFaceCount);
+        offset += cVertFaceCount;
     }
+    return offset;
 }
 
 //
@@ -691,7 +816,7 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
 //      - child vertices originate from parent faces, edges and vertices
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
-//          - note this imposes ordering constraints and inhibits concurrency
+//          - offsets are assigned explicitly so ranges can be populated concurrently
 //
 void
 QuadRefinement::populateVertexEdgeRelation() {
@@ -726,28 +851,28 @@ QuadRefinement::populateVertexEdgeRelation() {
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
+    int offset = 0;
     if (getFirstChildVertexFromVertices() == 0) {
-        populateVertexEdgesFromParentVertices();
-        populateVertexEdgesFromParentFaces();
-        populateVertexEdgesFromParentEdges();
+        offset = populateVertexEdgesFromParentVertices(0, _parent->getNumVertices(), offset);
+        offset = populateVertexEdgesFromParentFaces(0, _parent->getNumFaces(), offset);
+        offset = populateVertexEdgesFromParentEdges(0, _parent->getNumEdges(), offset);
     } else {
-        populateVertexEdgesFromParentFaces();
-        populateVertexEdgesFromParentEdges();
-        populateVertexEdgesFromParentVertices();
+        offset = populateVertexEdgesFromParentFaces(0, _parent->getNumFaces(), offset);
+        offset = populateVertexEdgesFromParentEdges(0, _parent->getNumEdges(), offset);
+        offset = populateVertexEdgesFromParentVertices(0, _parent->getNumVertices(), offset);
     }
 
-    //  Revise the over-allocated estimate based on what is used (as indicated in the
-    //  count/offset for the last vertex) and trim the index vectors accordingly:
-    childVertEdgeIndexSizeEstimate = _child->getNumVertexEdges(_child->getNumVertices()-1) +
-                                     _child->getOffsetOfVertexEdges(_child->getNumVertices()-1);
+    //  Revise the over-allocated estimate based on what is used (as indicated by the
+    //  offset following the last vertex) and trim the index vectors accordingly:
+    childVertEdgeIndexSizeEstimate = offset;
     _child->_vertEdgeIndices.resize(     childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(childVertEdgeIndexSizeEstimate);
 }
 
-void
-QuadRefinement::populateVertexEdgesFromParentFaces() {
+int
+QuadRefinement::populateVertexEdgesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset) {
 
-    for (int pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    for (int pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         int cVert = _faceChildVertIndex[pFace];
         if (!IndexIsValid(cVert)) continue;
 
@@ -757,7 +882,7 @@ QuadRefinement::populateVertexEdgesFromParentFaces() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pFaceVerts.size());
+        _child->resizeVertexEdges(cVert, pFaceVerts.size(), offset);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -777,10 +902,12 @@ QuadRefinement::populateVertexEdgesFromParentFaces() {
             }
         }
         _child->trimVertexEdges(cVert, cVertEdgeCount);
+        offset += cVertEdgeCount;
     }
+    return offset;
 }
-void
-QuadRefinement::populateVertexEdgesFromParentEdges() {
+int
+QuadRefinement::populateVertexEdgesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) {
 
     //
     //  This relation turns out to be awkward to populate given the mixed parentage
@@ -795,7 +922,7 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
     //  face.  We then swap the second and third (and possibly the first two) so
     //  that we have the desired origin sequence beginning [edge, face, edge, ...]
     //
-    for (int pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (int pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         int cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
 
@@ -808,7 +935,7 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2);
+        _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2, offset);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -864,12 +991,14 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
             }
         }
         _child->trimVertexEdges(cVert, cVertEdgeCount);
+        offset += cVertEdgeCount;
     }
+    return offset;
 }
-void
-QuadRefinement::populateVertexEdgesFromParentVertices() {
+int
+QuadRefinement::populateVertexEdgesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset) {
 
-    for (int pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
+    for (int pVert = pVertBegin; pVert < pVertEnd; ++pVert) {
         int cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
 
@@ -879,7 +1008,7 @@ QuadRefinement::populateVertexEdgesFromParentVertices() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pVertEdges.size());
+        _child->resizeVertexEdges(cVert, pVertEdges.size(), offset);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -897,7 +1026,9 @@ QuadRefinement::populateVertexEdgesFromParentVertices() {
             }
         }
         _child->trimVertexEdges(cVert, cVertEdgeCount);
+        offset += cVertEdgeCount;
     }
+    return offset;
 }
 
 //
@@ -68,29 +68,35 @@ protected:
     //
     //  Internal helper methods for populating the topology:
     //
-    void populateFaceVertexCountsAndOffsets();
-    void populateFaceVerticesFromParentFaces();
+    virtual void populateFaceVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd);
 
-    void populateFaceEdgesFromParentFaces();
+    virtual void populateFaceEdgesFromParentFaces(Index pFaceBegin, Index pFaceEnd);
 
-    void populateEdgeVerticesFromParentFaces();
-    void populateEdgeVerticesFromParentEdges();
+    void populateFaceVerticesFromParentQuads(Index pFaceBegin, Index pFaceEnd);
+    void populateFaceEdgesFromParentQuads(Index pFaceBegin, Index pFaceEnd);
 
-    void populateEdgeFacesFromParentFaces();
-    void populateEdgeFacesFromParentEdges();
+    virtual void populateEdgeVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd);
+    virtual void populateEdgeVerticesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd);
 
-    void populateVertexFacesFromParentFaces();
-    void populateVertexFacesFromParentEdges();
-    void populateVertexFacesFromParentVertices();
+    virtual int populateEdgeFacesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset);
+    virtual int populateEdgeFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset);
 
-    void populateVertexEdgesFromParentFaces();
-    void populateVertexEdgesFromParentEdges();
-    void populateVertexEdgesFromParentVertices();
+    virtual int populateVertexFacesFromParentFaces(   Index pFaceBegin, Index pFaceEnd, int offset);
+    virtual int populateVertexFacesFromParentEdges(   Index pEdgeBegin, Index pEdgeEnd, int offset);
+    virtual int populateVertexFacesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset);
+
+    virtual int populateVertexEdgesFromParentFaces(   Index pFaceBegin, Index pFaceEnd, int offset);
+    virtual int populateVertexEdgesFromParentEdges(   Index pEdgeBegin, Index pEdgeEnd, int offset);
+    virtual int populateVertexEdgesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset);
 
 private:
     //
-    //  Data members -- currently none
+    //  Data members:
     //
+    //  Parent levels of quads only (all refined levels, and base levels of quads) have
+    //  implicit child face and edge counts/offsets and their topology is populated with
+    //  fixed strides rather than per-face sizes:
+    bool _quadParent;
 };
 
 } // end namespace internal
@@ -34,6 +34,7 @@
 #include <cassert>
 #include <cstdio>
 #include <utility>
+#include <algorithm>
 
 
 namespace OpenSubdiv {
@@ -52,6 +53,9 @@ Refinement::Refinement(Level const & parentArg, Level & childArg, Sdc::Options c
     _regFaceSize(-1),
     _uniform(false),
     _faceVertsFirst(false),
+    _numThreads(1),
+    _parallelFor(0),
+    _parallelForData(0),
     _childFaceFromFaceCount(0),
     _childEdgeFromFaceCount(0),
     _childEdgeFromEdgeCount(0),
@@ -63,7 +67,24 @@ Refinement::Refinement(Level const & parentArg, Level & childArg, Sdc::Options c
     _firstChildEdgeFromEdge(0),
     _firstChildVertFromFace(0),
     _firstChildVertFromEdge(0),
-    _firstChildVertFromVert(0) {
+    _firstChildVertFromVert(0),
+    _regFaceChildFaceCount(0),
+    _regFaceChildEdgeCount(0),
+    _faceChildFaceIndices(childArg.getArena()),
+    _faceChildEdgeIndices(childArg.getArena()),
+    _faceChildVertIndex(childArg.getArena()),
+    _edgeChildEdgeIndices(childArg.getArena()),
+    _edgeChildVertIndex(childArg.getArena()),
+    _vertChildVertIndex(childArg.getArena()),
+    _childFaceParentIndex(childArg.getArena()),
+    _childEdgeParentIndex(childArg.getArena()),
+    _childVertexParentIndex(childArg.getArena()),
+    _childFaceTag(childArg.getArena()),
+    _childEdgeTag(childArg.getArena()),
+    _childVertexTag(childArg.getArena()),
+    _parentFaceTag(childArg.getArena()),
+    _parentEdgeTag(childArg.getArena()),
+    _parentVertexTag(childArg.getArena()) {
 
     assert((childArg.getDepth() == 0) && (childArg.getNumVertices() == 0));
     childArg._depth = 1 + parentArg.getDepth();
@@ -85,6 +106,49 @@ Refinement::initializeChildComponentCounts() {
     _child->_faceCount = _childFaceFromFaceCount;
     _child->_edgeCount = _childEdgeFromFaceCount + _childEdgeFromEdgeCount;
     _child->_vertCount = _childVertFromFaceCount + _childVertFromEdgeCount + _childVertFromVertCount;
+
+    //  All child faces are quads or tris, so their face-vertex counts/offsets are implicit:
+    _child->_regFaceSize = _regFaceSize;
+}
+
+//
+//  When the child Level is allocated from an Arena, reserve a block large enough for
+//  the vectors that remain to be allocated for the child components -- the sizes of
+//  the variable relations are estimated from those of a regular level (two faces per
+//  edge and twice as many edges as vertices), while the fixed size vectors are known:
+//
+void
+Refinement::reserveChildArena(bool minimalTopology) {
+
+    Arena * arena = _child->getArena();
+    if (arena == 0) return;
+
+    size_t nFaces = _child->getNumFaces();
+    size_t nEdges = _child->getNumEdges();
+    size_t nVerts = _child->getNumVertices();
+
+    size_t faceVerts = nFaces * _regFaceSize;
+
+    //  Child-to-parent mapping and tags:
+    size_t size = (nFaces + nEdges + nVerts) * (sizeof(Index) + sizeof(ChildTag));
+
+    size += nFaces * sizeof(Level::FTag) +
+            nEdges * (sizeof(Level::ETag) + sizeof(float)) +
+            nVerts * (sizeof(Level::VTag) + sizeof(float));
+
+    //  Topology relations:
+    size += faceVerts * sizeof(Index);
+    if (!minimalTopology) {
+        size += faceVerts * sizeof(Index) + 2 * nEdges * sizeof(Index);
+        size += 2 * nEdges * sizeof(Index) + 2 * nEdges * (sizeof(Index) + sizeof(LocalIndex));
+        size += 2 * nVerts * sizeof(Index) + faceVerts * (sizeof(Index) + sizeof(LocalIndex));
+        size += 2 * nVerts * sizeof(Index) + 2 * nEdges * (sizeof(Index) + sizeof(LocalIndex));
+    }
+
+    //  Allowance for the alignment of each vector:
+    size += 32 * 16;
+
+    arena->reserve(size);
 }
 
 void
@@ -96,6 +160,16 @@ Refinement::initializeSparseSelectionTags() {
 }
 
 
+namespace {
+    inline void
+    notifyPhase(Refinement::Options const & options, Refinement::Phase phase) {
+
+        if (options._phaseCallback) {
+            options._phaseCallback(phase, options._phaseCallbackData);
+        }
+    }
+}
+
 //
 //  The main refinement method -- provides a high-level overview of refinement:
 //
@@ -121,6 +195,10 @@ Refinement::refine(Options refineOptions) {
 
     _uniform        = !refineOptions._sparse;
     _faceVertsFirst =  refineOptions._faceVertsFirst;
+    _numThreads     =  refineOptions._numThreads;
+
+    _parallelFor     = refineOptions._parallelFor;
+    _parallelForData = refineOptions._parallelForData;
 
     //  We may soon have an option here to suppress refinement of FVar channels...
     bool refineOptions_ignoreFVarChannels = false;
@@ -131,12 +209,18 @@ Refinement::refine(Options refineOptions) {
     //  Initialize the parent-to-child and reverse child-to-parent mappings and propagate
     //  component tags to the new child components:
     //
+    notifyPhase(refineOptions, PHASE_MAPPING);
+
     populateParentToChildMapping();
 
     initializeChildComponentCounts();
 
+    reserveChildArena(refineOptions._minimalTopology);
+
     populateChildToParentMapping();
 
+    notifyPhase(refineOptions, PHASE_TAGS);
+
     propagateComponentTags();
 
     //
@@ -154,15 +238,25 @@ Refinement::refine(Options refineOptions) {
         relationsToPopulate._vertexFaces = true;
     }
 
+    notifyPhase(refineOptions, PHASE_TOPOLOGY);
+
     subdivideTopology(relationsToPopulate);
 
     //
     //  Subdivide the sharpness values and face-varying channels:
     //    - note there is some dependency of the vertex tag/Rule for semi-sharp vertices
     //
-    subdivideSharpnessValues();
+    notifyPhase(refineOptions, PHASE_SHARPNESS);
+
+    if (refineOptions._semiSharpFeatures) {
+        subdivideSharpnessValues();
+    } else {
+        assignInfiniteSharpnessValues();
+    }
 
     if (optionallyRefineFVar) {
+        notifyPhase(refineOptions, PHASE_FVAR);
+
         subdivideFVarChannels();
     }
 
@@ -203,7 +297,7 @@ namespace {
     inline bool isSparseIndexMarked(Index index)   { return index != 0; }
 
     inline int
-    sequenceSparseIndexVector(IndexVector& indexVector, int baseValue = 0) {
+    sequenceSparseIndexVector(ArenaIndexVector& indexVector, int baseValue = 0) {
         int validCount = 0;
         for (int i = 0; i < (int) indexVector.size(); ++i) {
             indexVector[i] = isSparseIndexMarked(indexVector[i])
@@ -213,7 +307,7 @@ namespace {
     }
 
     inline int
-    sequenceFullIndexVector(IndexVector& indexVector, int baseValue = 0) {
+    sequenceFullIndexVector(ArenaIndexVector& indexVector, int baseValue = 0) {
         int indexCount = (int) indexVector.size();
         for (int i = 0; i < indexCount; ++i) {
             indexVector[i] = baseValue++;
@@ -304,6 +398,45 @@ Refinement::populateParentChildIndices() {
     }
 }
 
+void
+Refinement::getMemoryUsage(MemoryUsage & usage) const {
+
+    usage.Add(_faceChildFaceIndices);
+    usage.Add(_faceChildEdgeIndices);
+    usage.Add(_faceChildVertIndex);
+    usage.Add(_edgeChildEdgeIndices);
+    usage.Add(_edgeChildVertIndex);
+    usage.Add(_vertChildVertIndex);
+
+    usage.Add(_childFaceParentIndex);
+    usage.Add(_childEdgeParentIndex);
+    usage.Add(_childVertexParentIndex);
+    usage.Add(_childFaceTag);
+    usage.Add(_childEdgeTag);
+    usage.Add(_childVertexTag);
+
+    usage.Add(_parentFaceTag);
+    usage.Add(_parentEdgeTag);
+    usage.Add(_parentVertexTag);
+
+    usage.Add(_fvarChannels);
+}
+
+void
+Refinement::trim() {
+
+    ArenaIndexVector(_childEdgeParentIndex.get_allocator()).swap(_childEdgeParentIndex);
+    ArenaIndexVector(_childVertexParentIndex.get_allocator()).swap(_childVertexParentIndex);
+
+    ChildTagVector(_childFaceTag.get_allocator()).swap(_childFaceTag);
+    ChildTagVector(_childEdgeTag.get_allocator()).swap(_childEdgeTag);
+    ChildTagVector(_childVertexTag.get_allocator()).swap(_childVertexTag);
+
+    SparseTagVector(_parentFaceTag.get_allocator()).swap(_parentFaceTag);
+    SparseTagVector(_parentEdgeTag.get_allocator()).swap(_parentEdgeTag);
+    SparseTagVector(_parentVertexTag.get_allocator()).swap(_parentVertexTag);
+}
+
 void
 Refinement::printParentToChildMapping() const {
 
@@ -783,30 +916,48 @@ Refinement::populateVertexTagsFromParentVertices() {
 //  each relation is responsible for appropriate allocation and initialization of all
 //  data involved, and these are virtual -- provided by a quad- or tri-split subclass.
 //
+//  When more than one thread (or a client function for concurrency) is specified, the
+//  relations are instead populated by subdivideTopologyConcurrently() below from the
+//  same per-range subclass methods.
+//
 void
 Refinement::subdivideTopology(Relations const& applyTo) {
 
-    if (applyTo._faceVertices) {
-        populateFaceVertexRelation();
-    }
-    if (applyTo._faceEdges) {
-        populateFaceEdgeRelation();
-    }
-    if (applyTo._edgeVertices) {
-        populateEdgeVertexRelation();
-    }
-    if (applyTo._edgeFaces) {
-        populateEdgeFaceRelation();
-    }
-    if (applyTo._vertexFaces) {
-        populateVertexFaceRelation();
-    }
-    if (applyTo._vertexEdges) {
-        populateVertexEdgeRelation();
+    if ((_numThreads > 1) || _parallelFor) {
+        subdivideTopologyConcurrently(applyTo);
+    } else {
+        if (applyTo._faceVertices) {
+            populateFaceVertexRelation();
+        }
+        if (applyTo._faceEdges) {
+            populateFaceEdgeRelation();
+        }
+        if (applyTo._edgeVertices) {
+            populateEdgeVertexRelation();
+        }
+        if (applyTo._edgeFaces) {
+            populateEdgeFaceRelation();
+
+            //  The counts of the child edges are final only once populated:
+            _child->_maxEdgeFaces = 0;
+            for (Index cEdge = 0; cEdge < _child->getNumEdges(); ++cEdge) {
+                _child->_maxEdgeFaces = std::max(_child->_maxEdgeFaces,
+                                                 _child->getNumEdgeFaces(cEdge));
+            }
+        }
+        if (applyTo._vertexFaces) {
+            populateVertexFaceRelation();
+        }
+        if (applyTo._vertexEdges) {
+            populateVertexEdgeRelation();
+        }
     }
 
     //
     //  Additional members of the child Level not specific to any relation...
+    //      - the max edge-faces is the exact maximum of the child edges (assigned
+    //  above, or when compacting the relation if populated concurrently), i.e. it
+    //  may be less than that of the parent when refinement is sparse.
     //      - note in the case of max-valence, the child's max-valence may be less
     //  than the parent if that maximal parent vertex was not included in the sparse
     //  refinement (possible when sparse refinement is more general).
@@ -825,6 +976,314 @@ Refinement::subdivideTopology(Relations const& applyTo) {
     _child->_maxValence = std::max(_parent->_maxValence, maxRegularValence);
 }
 
+//
+//  Concurrent subdivision of topology:
+//
+//  Each relation is populated by the subclass one parent component type at a time, and
+//  each of these passes can be applied to a subset of the parent components.  Those
+//  relations with a fixed size per child component (face-vertices, face-edges and
+//  edge-vertices) are allocated in full up front and so each range of parents can be
+//  processed independently.
+//
+//  The remaining relations are of variable size and their offsets would otherwise be
+//  determined incrementally.  We assign each range its own block of indices large
+//  enough to hold all that its children may require (the same bounds used for the
+//  estimates of the serial methods), populate the ranges independently and then
+//  compact the blocks in order -- so the result is identical to the serial method.
+//
+namespace {
+    enum RangePass {
+        PASS_FACE_VERTS_FROM_FACES,
+        PASS_FACE_EDGES_FROM_FACES,
+        PASS_EDGE_VERTS_FROM_FACES,
+        PASS_EDGE_VERTS_FROM_EDGES,
+        PASS_EDGE_FACES_FROM_FACES,
+        PASS_EDGE_FACES_FROM_EDGES,
+        PASS_VERT_FACES_FROM_FACES,
+        PASS_VERT_FACES_FROM_EDGES,
+        PASS_VERT_FACES_FROM_VERTS,
+        PASS_VERT_EDGES_FROM_FACES,
+        PASS_VERT_EDGES_FROM_EDGES,
+        PASS_VERT_EDGES_FROM_VERTS
+    };
+
+    struct RangeTask {
+        RangeTask(RangePass p, Index b, Index e, int offsetArg = 0) :
+            pass(p), begin(b), end(e), offset(offsetArg) { }
+
+        RangePass pass;
+        Index     begin;
+        Index     end;
+        int       offset;
+    };
+
+    //  Total size of a relation for a range of components from its counts/offsets:
+    inline int
+    sumCounts(ArenaIndexVector const & countsAndOffsets, Index begin, Index end) {
+        int sum = 0;
+        for (Index i = begin; i < end; ++i) {
+            sum += countsAndOffsets[2*i];
+        }
+        return sum;
+    }
+    inline int
+    sumFaceVertexCounts(Level const & level, Index begin, Index end) {
+        if (level.getRegularFaceSize()) {
+            return (end - begin) * level.getRegularFaceSize();
+        }
+        int sum = 0;
+        for (Index i = begin; i < end; ++i) {
+            sum += level.getNumFaceVertices(i);
+        }
+        return sum;
+    }
+
+    //  Kernel populating a range of the tasks for all relations:
+    struct RangeTaskData {
+        RangeTaskData(Refinement & r, std::vector<RangeTask> const & t) :
+            refinement(r), tasks(t) { }
+
+        Refinement &                   refinement;
+        std::vector<RangeTask> const & tasks;
+    };
+
+    void
+    populateRangeTasks(int taskBegin, int taskEnd, void * data) {
+
+        Refinement &                   refinement = static_cast<RangeTaskData *>(data)->refinement;
+        std::vector<RangeTask> const & tasks      = static_cast<RangeTaskData *>(data)->tasks;
+
+        for (int i = taskBegin; i < taskEnd; ++i) {
+            RangeTask const & task = tasks[i];
+
+            switch (task.pass) {
+            case PASS_FACE_VERTS_FROM_FACES:
+                refinement.populateFaceVerticesFromParentFaces(task.begin, task.end);
+                break;
+            case PASS_FACE_EDGES_FROM_FACES:
+                refinement.populateFaceEdgesFromParentFaces(task.begin, task.end);
+                break;
+            case PASS_EDGE_VERTS_FROM_FACES:
+                refinement.populateEdgeVerticesFromParentFaces(task.begin, task.end);
+                break;
+            case PASS_EDGE_VERTS_FROM_EDGES:
+                refinement.populateEdgeVerticesFromParentEdges(task.begin, task.end);
+                break;
+            case PASS_EDGE_FACES_FROM_FACES:
+                refinement.populateEdgeFacesFromParentFaces(task.begin, task.end, task.offset);
+                break;
+            case PASS_EDGE_FACES_FROM_EDGES:
+                refinement.populateEdgeFacesFromParentEdges(task.begin, task.end, task.offset);
+                break;
+            case PASS_VERT_FACES_FROM_FACES:
+                refinement.populateVertexFacesFromParentFaces(task.begin, task.end, task.offset);
+                break;
+            case PASS_VERT_FACES_FROM_EDGES:
+                refinement.populateVertexFacesFromParentEdges(task.begin, task.end, task.offset);
+                break;
+            case PASS_VERT_FACES_FROM_VERTS:
+                refinement.populateVertexFacesFromParentVertices(task.begin, task.end, task.offset);
+                break;
+            case PASS_VERT_EDGES_FROM_FACES:
+                refinement.populateVertexEdgesFromParentFaces(task.begin, task.end, task.offset);
+                break;
+            case PASS_VERT_EDGES_FROM_EDGES:
+                refinement.populateVertexEdgesFromParentEdges(task.begin, task.end, task.offset);
+                break;
+            case PASS_VERT_EDGES_FROM_VERTS:
+                refinement.populateVertexEdgesFromParentVertices(task.begin, task.end, task.offset);
+                break;
+            }
+        }
+    }
+
+    //  Compact the indices of a variable sized relation following concurrent population,
+    //  returning the maximum count of its components:
+    int
+    compactRelation(ArenaIndexVector & countsAndOffsets,
+                    ArenaIndexVector & indices, ArenaLocalIndexVector & localIndices) {
+
+        int numComponents = (int)countsAndOffsets.size() / 2;
+
+        int offset   = 0;
+        int maxCount = 0;
+        for (int i = 0; i < numComponents; ++i) {
+            int count     = countsAndOffsets[2*i];
+            int oldOffset = countsAndOffsets[2*i+1];
+            maxCount = std::max(maxCount, count);
+            if (oldOffset != offset) {
+                assert(oldOffset > offset);
+                std::copy(indices.begin() + oldOffset,
+                          indices.begin() + oldOffset + count, indices.begin() + offset);
+                std::copy(localIndices.begin() + oldOffset,
+                          localIndices.begin() + oldOffset + count, localIndices.begin() + offset);
+                countsAndOffsets[2*i+1] = offset;
+            }
+            offset += count;
+        }
+        indices.resize(offset);
+        localIndices.resize(offset);
+        return maxCount;
+    }
+}
+
+void
+Refinement::subdivideTopologyConcurrently(Relations const& applyTo) {
+
+    Level const & parent = *_parent;
+    Level       & child  = *_child;
+
+    int nParentFaces = parent.getNumFaces();
+    int nParentEdges = parent.getNumEdges();
+    int nParentVerts = parent.getNumVertices();
+
+    bool splitToQuads = (_splitType == Sdc::SPLIT_TO_QUADS);
+
+    //
+    //  Identify the size of the ranges of parent components -- large enough to make
+    //  the overhead negligible while providing a few ranges per thread to balance:
+    //
+    int nParentMax = std::max(nParentFaces, std::max(nParentEdges, nParentVerts));
+    int rangeSize  = std::max(1024, nParentMax / (4 * _numThreads) + 1);
+
+    std::vector<RangeTask> tasks;
+
+    //
+    //  Fixed size relations -- allocate and append tasks to populate each:
+    //
+    if (applyTo._faceVertices) {
+        child._faceVertIndices.resize(child.getNumFaces() * _regFaceSize);
+        for (Index b = 0; b < nParentFaces; b += rangeSize) {
+            tasks.push_back(RangeTask(PASS_FACE_VERTS_FROM_FACES, b, std::min(b + rangeSize, nParentFaces)));
+        }
+    }
+    if (applyTo._faceEdges) {
+        child._faceEdgeIndices.resize(child.getNumFaces() * _regFaceSize);
+        for (Index b = 0; b < nParentFaces; b += rangeSize) {
+            tasks.push_back(RangeTask(PASS_FACE_EDGES_FROM_FACES, b, std::min(b + rangeSize, nParentFaces)));
+        }
+    }
+    if (applyTo._edgeVertices) {
+        child._edgeVertIndices.resize(child.getNumEdges() * 2);
+        for (Index b = 0; b < nParentFaces; b += rangeSize) {
+            tasks.push_back(RangeTask(PASS_EDGE_VERTS_FROM_FACES, b, std::min(b + rangeSize, nParentFaces)));
+        }
+        for (Index b = 0; b < nParentEdges; b += rangeSize) {
+            tasks.push_back(RangeTask(PASS_EDGE_VERTS_FROM_EDGES, b, std::min(b + rangeSize, nParentEdges)));
+        }
+    }
+
+    //
+    //  Variable size relations -- tasks are appended in the order of the child components
+    //  they populate, and each is assigned an offset sufficient for all that precede it:
+    //
+    if (applyTo._edgeFaces) {
+        int offset = 0;
+        for (Index b = 0; b < nParentFaces; b += rangeSize) {
+            Index e = std::min(b + rangeSize, nParentFaces);
+            tasks.push_back(RangeTask(PASS_EDGE_FACES_FROM_FACES, b, e, offset));
+            offset += 2 * sumFaceVertexCounts(parent, b, e);
+        }
+        for (Index b = 0; b < nParentEdges; b += rangeSize) {
+            Index e = std::min(b + rangeSize, nParentEdges);
+            tasks.push_back(RangeTask(PASS_EDGE_FACES_FROM_EDGES, b, e, offset));
+            offset += 2 * sumCounts(parent._edgeFaceCountsAndOffsets, b, e);
+        }
+        child._edgeFaceCountsAndOffsets.resize(child.getNumEdges() * 2);
+        child._edgeFaceIndices.resize(offset);
+        child._edgeFaceLocalIndices.resize(offset);
+    }
+
+    RangePass vertPasses[2][3] = {
+        { PASS_VERT_FACES_FROM_FACES, PASS_VERT_FACES_FROM_EDGES, PASS_VERT_FACES_FROM_VERTS },
+        { PASS_VERT_EDGES_FROM_FACES, PASS_VERT_EDGES_FROM_EDGES, PASS_VERT_EDGES_FROM_VERTS } };
+
+    for (int relation = 0; relation < 2; ++relation) {
+        if (relation == 0 && !applyTo._vertexFaces) continue;
+        if (relation == 1 && !applyTo._vertexEdges) continue;
+
+        //  Child vertices from vertices either precede or follow those from faces and edges:
+        int parentTypeOrder[3] = { 0, 1, 2 };
+        if (getFirstChildVertexFromVertices() == 0) {
+            parentTypeOrder[0] = 2;
+            parentTypeOrder[1] = 0;
+            parentTypeOrder[2] = 1;
+        }
+
+        int offset = 0;
+        for (int i = 0; i < 3; ++i) {
+            int parentType = parentTypeOrder[i];
+            if ((parentType == 0) && !splitToQuads) continue;
+
+            int nParents = (parentType == 0) ? nParentFaces :
+                          ((parentType == 1) ? nParentEdges : nParentVerts);
+
+            for (Index b = 0; b < nParents; b += rangeSize) {
+                Index e = std::min(b + rangeSize, nParents);
+                tasks.push_back(RangeTask(vertPasses[relation][parentType], b, e, offset));
+
+                if (parentType == 0) {
+                    offset += sumFaceVertexCounts(parent, b, e);
+                } else if (parentType == 1) {
+                    int nEdgeFaces = sumCounts(parent._edgeFaceCountsAndOffsets, b, e);
+                    if (relation == 0) {
+                        offset += (splitToQuads ? 2 : 3) * nEdgeFaces;
+                    } else {
+                        offset += (splitToQuads ? 1 : 2) * nEdgeFaces + 2 * (e - b);
+                    }
+                } else if (relation == 0) {
+                    offset += sumCounts(parent._vertFaceCountsAndOffsets, b, e);
+                } else {
+                    offset += sumCounts(parent._vertEdgeCountsAndOffsets, b, e);
+                }
+            }
+        }
+        if (relation == 0) {
+            child._vertFaceCountsAndOffsets.resize(child.getNumVertices() * 2);
+            child._vertFaceIndices.resize(offset);
+            child._vertFaceLocalIndices.resize(offset);
+        } else {
+            child._vertEdgeCountsAndOffsets.resize(child.getNumVertices() * 2);
+            child._vertEdgeIndices.resize(offset);
+            child._vertEdgeLocalIndices.resize(offset);
+        }
+    }
+
+    //
+    //  Populate all ranges of all relations concurrently:
+    //
+    RangeTaskData taskData(*this, tasks);
+
+    if (_parallelFor) {
+        _parallelFor(0, (int)tasks.size(), populateRangeTasks, &taskData, _parallelForData);
+    } else {
+        int nTasks = (int)tasks.size();
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+#endif
+        for (int i = 0; i < nTasks; ++i) {
+            populateRangeTasks(i, i + 1, &taskData);
+        }
+    }
+
+    //
+    //  Remove the gaps in the variable size relations left between the ranges:
+    //
+    if (applyTo._edgeFaces) {
+        child._maxEdgeFaces = compactRelation(child._edgeFaceCountsAndOffsets,
+                                              child._edgeFaceIndices, child._edgeFaceLocalIndices);
+    }
+    if (applyTo._vertexFaces) {
+        compactRelation(child._vertFaceCountsAndOffsets,
+                        child._vertFaceIndices, child._vertFaceLocalIndices);
+    }
+    if (applyTo._vertexEdges) {
+        compactRelation(child._vertEdgeCountsAndOffsets,
+                        child._vertEdgeIndices, child._vertEdgeLocalIndices);
+    }
+}
+
 
 //
 //  Methods to subdivide sharpness values:
@@ -854,10 +1313,113 @@ Refinement::subdivideSharpnessValues() {
     reclassifySemisharpVertices();
 }
 
+//
+//  Without semi-sharp features in the parent, child components are either smooth or
+//  infinitely sharp as tagged from their parents -- there is nothing to subdivide and
+//  the Rules of the child vertices propagated with their tags are final:
+//
 void
-Refinement::subdivideEdgeSharpness() {
+Refinement::assignInfiniteSharpnessValues() {
 
-    Sdc::Crease creasing(_options);
+    _child->_edgeSharpness.clear();
+    _child->_edgeSharpness.resize(_child->getNumEdges(), Sdc::Crease::SHARPNESS_SMOOTH);
+
+    Index cEdge    = getFirstChildEdgeFromEdges();
+    Index cEdgeEnd = cEdge + getNumChildEdgesFromEdges();
+    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+        if (_child->_edgeTags[cEdge]._infSharp) {
+            _child->_edgeSharpness[cEdge] = Sdc::Crease::SHARPNESS_INFINITE;
+        }
+    }
+
+    _child->_vertSharpness.clear();
+    _child->_vertSharpness.resize(_child->getNumVertices(), Sdc::Crease::SHARPNESS_SMOOTH);
+
+    Index cVert    = getFirstChildVertexFromVertices();
+    Index cVertEnd = cVert + getNumChildVerticesFromVertices();
+    for ( ; cVert < cVertEnd; ++cVert) {
+        if (_child->_vertTags[cVert]._infSharp) {
+            _child->_vertSharpness[cVert] = Sdc::Crease::SHARPNESS_INFINITE;
+        }
+    }
+}
+
+namespace {
+    //  A kernel applied to fixed size ranges of [begin, end):
+    struct RangeKernelData {
+        Refinement::Options::RangeKernel kernel;
+        void * kernelData;
+        Index  begin,
+               end,
+               rangeSize;
+    };
+
+    void
+    applyKernelToRanges(int begin, int end, void * data) {
+
+        RangeKernelData const & ranges = *static_cast<RangeKernelData const *>(data);
+
+        for (int i = begin; i < end; ++i) {
+            Index b = ranges.begin + i * ranges.rangeSize;
+            ranges.kernel(b, std::min(b + ranges.rangeSize, ranges.end), ranges.kernelData);
+        }
+    }
+}
+
+void
+Refinement::applyToRanges(Index begin, Index end, Options::RangeKernel kernel) {
+
+    int numItems  = end - begin;
+    int rangeSize = std::max(1024, numItems / (4 * _numThreads) + 1);
+
+    if (((_numThreads < 2) && !_parallelFor) || (numItems <= rangeSize)) {
+        kernel(begin, end, this);
+        return;
+    }
+
+    RangeKernelData ranges;
+    ranges.kernel     = kernel;
+    ranges.kernelData = this;
+    ranges.begin      = begin;
+    ranges.end        = end;
+    ranges.rangeSize  = rangeSize;
+
+    int nRanges = (numItems + rangeSize - 1) / rangeSize;
+
+    if (_parallelFor) {
+        _parallelFor(0, nRanges, applyKernelToRanges, &ranges, _parallelForData);
+    } else {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+#endif
+        for (int i = 0; i < nRanges; ++i) {
+            applyKernelToRanges(i, i + 1, &ranges);
+        }
+    }
+}
+
+void
+Refinement::subdivideEdgeSharpnessKernel(int begin, int end, void * refinement) {
+    static_cast<Refinement *>(refinement)->subdivideEdgeSharpness(begin, end);
+}
+
+void
+Refinement::subdivideVertexSharpnessKernel(int begin, int end, void * refinement) {
+    static_cast<Refinement *>(refinement)->subdivideVertexSharpness(begin, end);
+}
+
+void
+Refinement::reclassifyVerticesFromEdgesKernel(int begin, int end, void * refinement) {
+    static_cast<Refinement *>(refinement)->reclassifySemisharpVerticesFromEdges(begin, end);
+}
+
+void
+Refinement::reclassifyVerticesFromVerticesKernel(int begin, int end, void * refinement) {
+    static_cast<Refinement *>(refinement)->reclassifySemisharpVerticesFromVertices(begin, end);
+}
+
+void
+Refinement::subdivideEdgeSharpness() {
 
     _child->_edgeSharpness.clear();
     _child->_edgeSharpness.resize(_child->getNumEdges(), Sdc::Crease::SHARPNESS_SMOOTH);
@@ -877,14 +1439,57 @@ Refinement::subdivideEdgeSharpness() {
     //  non-trivial creasing method like Chaikin is used.  This is not being
     //  done now but is worth considering...
     //
-    internal::StackBuffer<float,16> pVertEdgeSharpness;
-    if (!creasing.IsUniform()) {
-        pVertEdgeSharpness.Reserve(_parent->getMaxValence());
+    Index cEdgeBegin = getFirstChildEdgeFromEdges();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromEdges();
+
+    applyToRanges(cEdgeBegin, cEdgeEnd, subdivideEdgeSharpnessKernel);
+}
+
+void
+Refinement::subdivideEdgeSharpness(Index cEdgeBegin, Index cEdgeEnd) {
+
+    Sdc::Crease creasing(_options);
+
+    if (creasing.IsUniform()) {
+        //
+        //  Uniform sharpness only depends on the parent edge -- the semi-sharp values
+        //  are gathered and subdivided in batches:
+        //
+        int const batchSize = 256;
+
+        Index cEdges[batchSize];
+        float sharpness[batchSize];
+
+        for (Index b = cEdgeBegin; b < cEdgeEnd; b += batchSize) {
+            Index e = std::min(b + batchSize, cEdgeEnd);
+
+            int n = 0;
+            for (Index cEdge = b; cEdge < e; ++cEdge) {
+                Level::ETag const& cEdgeTag = _child->_edgeTags[cEdge];
+
+                if (cEdgeTag._infSharp) {
+                    _child->_edgeSharpness[cEdge] = Sdc::Crease::SHARPNESS_INFINITE;
+                } else if (cEdgeTag._semiSharp) {
+                    cEdges[n]    = cEdge;
+                    sharpness[n] = _parent->_edgeSharpness[_childEdgeParentIndex[cEdge]];
+                    ++n;
+                }
+            }
+            creasing.SubdivideUniformSharpnesses(n, sharpness, sharpness);
+
+            for (int i = 0; i < n; ++i) {
+                _child->_edgeSharpness[cEdges[i]] = sharpness[i];
+                if (not Sdc::Crease::IsSharp(sharpness[i])) {
+                    _child->_edgeTags[cEdges[i]]._semiSharp = false;
+                }
+            }
+        }
+        return;
     }
 
-    Index cEdge    = getFirstChildEdgeFromEdges();
-    Index cEdgeEnd = cEdge + getNumChildEdgesFromEdges();
-    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+    internal::StackBuffer<float,16> pVertEdgeSharpness(_parent->getMaxValence());
+
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
         float&       cSharpness = _child->_edgeSharpness[cEdge];
         Level::ETag& cEdgeTag   = _child->_edgeTags[cEdge];
 
@@ -894,19 +1499,15 @@ Refinement::subdivideEdgeSharpness() {
             Index pEdge      = _childEdgeParentIndex[cEdge];
             float pSharpness = _parent->_edgeSharpness[pEdge];
 
-            if (creasing.IsUniform()) {
-                cSharpness = creasing.SubdivideUniformSharpness(pSharpness);
-            } else {
-                ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge);
-                Index           pVert      = pEdgeVerts[_childEdgeTag[cEdge]._indexInParent];
-                ConstIndexArray pVertEdges = _parent->getVertexEdges(pVert);
+            ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge);
+            Index           pVert      = pEdgeVerts[_childEdgeTag[cEdge]._indexInParent];
+            ConstIndexArray pVertEdges = _parent->getVertexEdges(pVert);
 
-                for (int i = 0; i < pVertEdges.size(); ++i) {
-                    pVertEdgeSharpness[i] = _parent->_edgeSharpness[pVertEdges[i]];
-                }
-                cSharpness = creasing.SubdivideEdgeSharpnessAtVertex(pSharpness, pVertEdges.size(),
-                                                                         pVertEdgeSharpness);
+            for (int i = 0; i < pVertEdges.size(); ++i) {
+                pVertEdgeSharpness[i] = _parent->_edgeSharpness[pVertEdges[i]];
             }
+            cSharpness = creasing.SubdivideEdgeSharpnessAtVertex(pSharpness, pVertEdges.size(),
+                                                                     pVertEdgeSharpness);
             if (not Sdc::Crease::IsSharp(cSharpness)) {
                 cEdgeTag._semiSharp = false;
             }
@@ -917,8 +1518,6 @@ Refinement::subdivideEdgeSharpness() {
 void
 Refinement::subdivideVertexSharpness() {
 
-    Sdc::Crease creasing(_options);
-
     _child->_vertSharpness.clear();
     _child->_vertSharpness.resize(_child->getNumVertices(), Sdc::Crease::SHARPNESS_SMOOTH);
 
@@ -930,19 +1529,41 @@ Refinement::subdivideVertexSharpness() {
     Index cVertBegin = getFirstChildVertexFromVertices();
     Index cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
 
-    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
-        float&       cSharpness = _child->_vertSharpness[cVert];
-        Level::VTag& cVertTag   = _child->_vertTags[cVert];
+    applyToRanges(cVertBegin, cVertEnd, subdivideVertexSharpnessKernel);
+}
 
-        if (cVertTag._infSharp) {
-            cSharpness = Sdc::Crease::SHARPNESS_INFINITE;
-        } else if (cVertTag._semiSharp) {
-            Index pVert      = _childVertexParentIndex[cVert];
-            float pSharpness = _parent->_vertSharpness[pVert];
+void
+Refinement::subdivideVertexSharpness(Index cVertBegin, Index cVertEnd) {
 
-            cSharpness = creasing.SubdivideVertexSharpness(pSharpness);
-            if (not Sdc::Crease::IsSharp(cSharpness)) {
-                cVertTag._semiSharp = false;
+    Sdc::Crease creasing(_options);
+
+    //  Semi-sharp values are gathered and subdivided in batches:
+    int const batchSize = 256;
+
+    Index cVerts[batchSize];
+    float sharpness[batchSize];
+
+    for (Index b = cVertBegin; b < cVertEnd; b += batchSize) {
+        Index e = std::min(b + batchSize, cVertEnd);
+
+        int n = 0;
+        for (Index cVert = b; cVert < e; ++cVert) {
+            Level::VTag const& cVertTag = _child->_vertTags[cVert];
+
+            if (cVertTag._infSharp) {
+                _child->_vertSharpness[cVert] = Sdc::Crease::SHARPNESS_INFINITE;
+            } else if (cVertTag._semiSharp) {
+                cVerts[n]    = cVert;
+                sharpness[n] = _parent->_vertSharpness[_childVertexParentIndex[cVert]];
+                ++n;
+            }
+        }
+        creasing.SubdivideVertexSharpnesses(n, sharpness, sharpness);
+
+        for (int i = 0; i < n; ++i) {
+            _child->_vertSharpness[cVerts[i]] = sharpness[i];
+            if (not Sdc::Crease::IsSharp(sharpness[i])) {
+                _child->_vertTags[cVerts[i]]._semiSharp = false;
             }
         }
     }
@@ -951,10 +1572,6 @@ Refinement::subdivideVertexSharpness() {
 void
 Refinement::reclassifySemisharpVertices() {
 
-    typedef Level::VTag::VTagSize VTagSize;
-
-    Sdc::Crease creasing(_options);
-
     //
     //  Inspect all vertices derived from edges -- for those whose parent edges were semisharp,
     //  reset the semisharp tag and the associated Rule according to the sharpness pair for the
@@ -963,31 +1580,76 @@ Refinement::reclassifySemisharpVertices() {
     Index vertFromEdgeBegin = getFirstChildVertexFromEdges();
     Index vertFromEdgeEnd   = vertFromEdgeBegin + getNumChildVerticesFromEdges();
 
-    for (Index cVert = vertFromEdgeBegin; cVert < vertFromEdgeEnd; ++cVert) {
-        Level::VTag& cVertTag = _child->_vertTags[cVert];
-        if (!cVertTag._semiSharpEdges) continue;
+    applyToRanges(vertFromEdgeBegin, vertFromEdgeEnd, reclassifyVerticesFromEdgesKernel);
+
+    //
+    //  Inspect all vertices derived from vertices -- for those whose parent vertices were
+    //  semisharp (inherited in the child vert's tag), inspect and reset the semisharp tag
+    //  and the associated Rule (based on neighboring child edges around the child vertex).
+    //
+    Index vertFromVertBegin = getFirstChildVertexFromVertices();
+    Index vertFromVertEnd   = vertFromVertBegin + getNumChildVerticesFromVertices();
 
-        Index pEdge = _childVertexParentIndex[cVert];
+    applyToRanges(vertFromVertBegin, vertFromVertEnd, reclassifyVerticesFromVerticesKernel);
+}
 
-        ConstIndexArray cEdges = getEdgeChildEdges(pEdge);
+void
+Refinement::reclassifySemisharpVerticesFromEdges(Index cVertBegin, Index cVertEnd) {
 
-        if (_childVertexTag[cVert]._incomplete) {
-            //  One child edge likely missing -- assume Crease if remaining edge semi-sharp:
-            cVertTag._semiSharpEdges = (IndexIsValid(cEdges[0]) && _child->_edgeTags[cEdges[0]]._semiSharp) ||
-                                       (IndexIsValid(cEdges[1]) && _child->_edgeTags[cEdges[1]]._semiSharp);
-            cVertTag._rule = (VTagSize)(cVertTag._semiSharpEdges ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH);
-        } else {
-            int sharpEdgeCount = _child->_edgeTags[cEdges[0]]._semiSharp + _child->_edgeTags[cEdges[1]]._semiSharp;
+    typedef Level::VTag::VTagSize VTagSize;
+
+    Sdc::Crease creasing(_options);
+
+    //  The Rules of complete vertices are determined in batches from their count of
+    //  semi-sharp child edges:
+    int const batchSize = 256;
+
+    Index             cVerts[batchSize];
+    int               sharpEdgeCounts[batchSize];
+    Sdc::Crease::Rule rules[batchSize];
 
-            cVertTag._semiSharpEdges = (sharpEdgeCount > 0);
-            cVertTag._rule = (VTagSize)(creasing.DetermineVertexVertexRule(0.0, sharpEdgeCount));
+    for (Index b = cVertBegin; b < cVertEnd; b += batchSize) {
+        Index e = std::min(b + batchSize, cVertEnd);
+
+        int n = 0;
+        for (Index cVert = b; cVert < e; ++cVert) {
+            Level::VTag& cVertTag = _child->_vertTags[cVert];
+            if (!cVertTag._semiSharpEdges) continue;
+
+            Index pEdge = _childVertexParentIndex[cVert];
+
+            ConstIndexArray cEdges = getEdgeChildEdges(pEdge);
+
+            if (_childVertexTag[cVert]._incomplete) {
+                //  One child edge likely missing -- assume Crease if remaining edge semi-sharp:
+                cVertTag._semiSharpEdges = (IndexIsValid(cEdges[0]) && _child->_edgeTags[cEdges[0]]._semiSharp) ||
+                                           (IndexIsValid(cEdges[1]) && _child->_edgeTags[cEdges[1]]._semiSharp);
+                cVertTag._rule = (VTagSize)(cVertTag._semiSharpEdges ? Sdc::Crease::RULE_CREASE : Sdc::Crease::RULE_SMOOTH);
+            } else {
+                int sharpEdgeCount = _child->_edgeTags[cEdges[0]]._semiSharp + _child->_edgeTags[cEdges[1]]._semiSharp;
+
+                cVertTag._semiSharpEdges = (sharpEdgeCount > 0);
+
+                cVerts[n]          = cVert;
+                sharpEdgeCounts[n] = sharpEdgeCount;
+                ++n;
+            }
+        }
+        creasing.DetermineVertexVertexRules(n, 0, sharpEdgeCounts, rules);
+
+        for (int i = 0; i < n; ++i) {
+            _child->_vertTags[cVerts[i]]._rule = (VTagSize)rules[i];
         }
     }
+}
+
+void
+Refinement::reclassifySemisharpVerticesFromVertices(Index cVertBegin, Index cVertEnd) {
+
+    typedef Level::VTag::VTagSize VTagSize;
+
+    Sdc::Crease creasing(_options);
 
-    //
-    //  Inspect all vertices derived from vertices -- for those whose parent vertices were
-    //  semisharp (inherited in the child vert's tag), inspect and reset the semisharp tag
-    //  and the associated Rule (based on neighboring child edges around the child vertex).
     //
     //  We should never find such a vertex "incomplete" in a sparse refinement as a parent
     //  vertex is either selected or not, but never neighboring.  So the only complication
@@ -998,10 +1660,7 @@ Refinement::reclassifySemisharpVertices() {
     //  In both cases, we count the number of sharp and semisharp child edges incident the
     //  child vertex and adjust the "semisharp" and "rule" tags accordingly.
     //
-    Index vertFromVertBegin = getFirstChildVertexFromVertices();
-    Index vertFromVertEnd   = vertFromVertBegin + getNumChildVerticesFromVertices();
-
-    for (Index cVert = vertFromVertBegin; cVert < vertFromVertEnd; ++cVert) {
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
         Index pVert = _childVertexParentIndex[cVert];
         Level::VTag const& pVertTag = _parent->_vertTags[pVert];
 
@@ -1067,13 +1726,34 @@ Refinement::subdivideFVarChannels() {
     int channelCount = _parent->getNumFVarChannels();
 
     for (int channel = 0; channel < channelCount; ++channel) {
-        FVarLevel* parentFVar = _parent->_fvarChannels[channel];
+        subdivideFVarChannel(channel);
+    }
+}
+
+//
+//  A single channel is subdivided after all others when appended to the parent, or
+//  subdivided again in place of the existing one after it was replaced in the parent:
+//
+void
+Refinement::subdivideFVarChannel(int channel) {
 
-        FVarLevel*      childFVar  = new FVarLevel(*_child);
-        FVarRefinement* refineFVar = new FVarRefinement(*this, *parentFVar, *childFVar);
+    assert(channel <= (int)this->_fvarChannels.size());
+    assert((int)_child->_fvarChannels.size() == (int)this->_fvarChannels.size());
 
-        refineFVar->applyRefinement();
+    FVarLevel* parentFVar = _parent->_fvarChannels[channel];
 
+    FVarLevel*      childFVar  = new FVarLevel(*_child);
+    FVarRefinement* refineFVar = new FVarRefinement(*this, *parentFVar, *childFVar);
+
+    refineFVar->applyRefinement();
+
+    if (channel < (int)this->_fvarChannels.size()) {
+        delete _child->_fvarChannels[channel];
+        delete this->_fvarChannels[channel];
+
+        _child->_fvarChannels[channel] = childFVar;
+        this->_fvarChannels[channel]   = refineFVar;
+    } else {
         _child->_fvarChannels.push_back(childFVar);
         this->_fvarChannels.push_back(refineFVar);
     }
@@ -104,16 +104,58 @@ public:
     //  currently enforce full topology at the finest level to allow for subsequent
     //  patch construction.
     //
+    //  Phases of the refinement, in order of execution (phases not applicable to
+    //  a refinement, e.g. face-varying channels, are omitted):
+    enum Phase {
+        PHASE_MAPPING,
+        PHASE_TAGS,
+        PHASE_TOPOLOGY,
+        PHASE_SHARPNESS,
+        PHASE_FVAR
+    };
+
     struct Options {
+        //  Function to apply a kernel to sub-ranges of [begin, end) concurrently:
+        typedef void (*RangeKernel)(int begin, int end, void * kernelData);
+        typedef void (*ParallelFor)(int begin, int end, RangeKernel kernel, void * kernelData,
+                                    void const * clientData);
+
+        //  Function notified at the start of each Phase of the refinement:
+        typedef void (*PhaseCallback)(Phase phase, void * clientData);
+
         Options() : _sparse(false),
                     _faceVertsFirst(false),
-                    _minimalTopology(false)
+                    _minimalTopology(false),
+                    _semiSharpFeatures(true),
+                    _numThreads(1),
+                    _parallelFor(0),
+                    _parallelForData(0),
+                    _phaseCallback(0),
+                    _phaseCallbackData(0)
                     { }
 
         unsigned int _sparse          : 1;
         unsigned int _faceVertsFirst  : 1;
         unsigned int _minimalTopology : 1;
 
+        //  Whether the parent may have semi-sharp edges or vertices -- if not, the
+        //  child has none either and its sharpness values are assigned in bulk:
+        unsigned int _semiSharpFeatures : 1;
+
+        //  Number of threads to use when subdividing the topology (ignored if
+        //  not built with OpenMP, in which case the work is done serially):
+        int _numThreads;
+
+        //  Optional client function (and its data) to use for concurrency rather
+        //  than OpenMP -- _numThreads is then the expected number of workers:
+        ParallelFor  _parallelFor;
+        void const * _parallelForData;
+
+        //  Optional client function (and its data) notified of the progress of the
+        //  refinement -- intended for profiling:
+        PhaseCallback _phaseCallback;
+        void *        _phaseCallbackData;
+
         //  Still under consideration:
         //unsigned int _childToParentMap : 1;
     };
@@ -201,6 +243,10 @@ public:
         unsigned char _indexInParent : 2;  // index of child wrt parent:  0-3, or iterative if N > 4
     };
 
+    //  Vectors of tags (allocated from the Arena of the child Level, if any):
+    typedef std::vector<SparseTag, ArenaAllocator<SparseTag> > SparseTagVector;
+    typedef std::vector<ChildTag,  ArenaAllocator<ChildTag> >  ChildTagVector;
+
     //  Methods to access and modify tags:
     SparseTag const & getParentFaceSparseTag(  Index f) const { return _parentFaceTag[f]; }
     SparseTag const & getParentEdgeSparseTag(  Index e) const { return _parentEdgeTag[e]; }
@@ -228,6 +274,14 @@ public:
     void populateParentChildIndices();
     void printParentToChildMapping() const;
 
+    //  Memory held by the mappings and tags (face-varying channels excluded):
+    virtual void getMemoryUsage(MemoryUsage & usage) const;
+
+    //  Release the tags and child-to-parent mappings only needed to refine or
+    //  build tables from the child level (parent-to-child mappings and the
+    //  parent faces of child faces are preserved for interpolation):
+    void trim();
+
     virtual void allocateParentChildIndices() = 0;
 
     //  Supporting method for sparse refinement:
@@ -239,6 +293,7 @@ public:
     virtual void markSparseFaceChildren() = 0;
 
     void initializeChildComponentCounts();
+    void reserveChildArena(bool minimalTopology);
 
     //
     //  Methods involved in constructing the child-to-parent mapping:
@@ -297,6 +352,7 @@ public:
     };
 
     void subdivideTopology(Relations const& relationsToSubdivide);
+    void subdivideTopologyConcurrently(Relations const& relationsToSubdivide);
 
     virtual void populateFaceVertexRelation() = 0;
     virtual void populateFaceEdgeRelation() = 0;
@@ -305,19 +361,61 @@ public:
     virtual void populateVertexFaceRelation() = 0;
     virtual void populateVertexEdgeRelation() = 0;
 
+    //
+    //  Virtual methods populating a relation for the children of a range of parent
+    //  components.  Relations of fixed size per child are written in place, while
+    //  those of variable size assign the given offset to the first child and return
+    //  the offset following the last -- so disjoint ranges can be populated
+    //  concurrently given a sufficient offset for each (as is done by
+    //  subdivideTopologyConcurrently()).  Not all are relevant to all splits:
+    //
+    virtual void populateFaceVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd) = 0;
+
+    virtual void populateFaceEdgesFromParentFaces(Index pFaceBegin, Index pFaceEnd) = 0;
+
+    virtual void populateEdgeVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd) = 0;
+    virtual void populateEdgeVerticesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd) = 0;
+
+    virtual int populateEdgeFacesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset) = 0;
+    virtual int populateEdgeFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) = 0;
+
+    virtual int populateVertexFacesFromParentFaces(   Index, Index, int offset) { return offset; }
+    virtual int populateVertexFacesFromParentEdges(   Index pEdgeBegin, Index pEdgeEnd, int offset) = 0;
+    virtual int populateVertexFacesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset) = 0;
+
+    virtual int populateVertexEdgesFromParentFaces(   Index, Index, int offset) { return offset; }
+    virtual int populateVertexEdgesFromParentEdges(   Index pEdgeBegin, Index pEdgeEnd, int offset) = 0;
+    virtual int populateVertexEdgesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset) = 0;
+
     //
     //  Methods involved in subdividing and inspecting sharpness values:
     //
     void subdivideSharpnessValues();
+    void assignInfiniteSharpnessValues();
 
     void subdivideVertexSharpness();
     void subdivideEdgeSharpness();
     void reclassifySemisharpVertices();
 
+    //  Each of the above is applied to ranges of child components, concurrently when
+    //  more than one thread (or a client function for concurrency) is specified:
+    void subdivideVertexSharpness(Index cVertBegin, Index cVertEnd);
+    void subdivideEdgeSharpness(Index cEdgeBegin, Index cEdgeEnd);
+    void reclassifySemisharpVerticesFromEdges(Index cVertBegin, Index cVertEnd);
+    void reclassifySemisharpVerticesFromVertices(Index cVertBegin, Index cVertEnd);
+
+    void applyToRanges(Index begin, Index end, Options::RangeKernel kernel);
+
+    static void subdivideVertexSharpnessKernel(int begin, int end, void * refinement);
+    static void subdivideEdgeSharpnessKernel(int begin, int end, void * refinement);
+    static void reclassifyVerticesFromEdgesKernel(int begin, int end, void * refinement);
+    static void reclassifyVerticesFromVerticesKernel(int begin, int end, void * refinement);
+
     //
     //  Methods involved in subdividing face-varying topology:
     //
     void subdivideFVarChannels();
+    void subdivideFVarChannel(int channel);
 
 protected:
     // A debug method of Level prints a Refinement (should really change this)
@@ -340,6 +438,10 @@ protected:
     //  Determined by the refinement options:
     bool _uniform;
     bool _faceVertsFirst;
+    int  _numThreads;
+
+    Options::ParallelFor _parallelFor;
+    void const *         _parallelForData;
 
     //
     //  Inventory and ordering of the types of child components:
@@ -374,32 +476,37 @@ protected:
     IndexArray _faceChildFaceCountsAndOffsets;
     IndexArray _faceChildEdgeCountsAndOffsets;
 
-    IndexVector _faceChildFaceIndices;  // *cannot* always use face-vert counts/offsets
-    IndexVector _faceChildEdgeIndices;  // can use face-vert counts/offsets
-    IndexVector _faceChildVertIndex;
+    //  Constant number of children per face when the counts/offsets above are implicit,
+    //  i.e. the parent Level has no face-vertex counts/offsets to share (0 otherwise):
+    int _regFaceChildFaceCount;
+    int _regFaceChildEdgeCount;
+
+    ArenaIndexVector _faceChildFaceIndices;  // *cannot* always use face-vert counts/offsets
+    ArenaIndexVector _faceChildEdgeIndices;  // can use face-vert counts/offsets
+    ArenaIndexVector _faceChildVertIndex;
 
-    IndexVector _edgeChildEdgeIndices;  // trivial/corresponding pair for each
-    IndexVector _edgeChildVertIndex;
+    ArenaIndexVector _edgeChildEdgeIndices;  // trivial/corresponding pair for each
+    ArenaIndexVector _edgeChildVertIndex;
 
-    IndexVector _vertChildVertIndex;
+    ArenaIndexVector _vertChildVertIndex;
 
     //
     //  The child-to-parent mapping:
     //
-    IndexVector _childFaceParentIndex;
-    IndexVector _childEdgeParentIndex;
-    IndexVector _childVertexParentIndex;
+    ArenaIndexVector _childFaceParentIndex;
+    ArenaIndexVector _childEdgeParentIndex;
+    ArenaIndexVector _childVertexParentIndex;
 
-    std::vector<ChildTag> _childFaceTag;
-    std::vector<ChildTag> _childEdgeTag;
-    std::vector<ChildTag> _childVertexTag;
+    ChildTagVector  _childFaceTag;
+    ChildTagVector  _childEdgeTag;
+    ChildTagVector  _childVertexTag;
 
     //
     //  Tags for spase selection of components:
     //
-    std::vector<SparseTag> _parentFaceTag;
-    std::vector<SparseTag> _parentEdgeTag;
-    std::vector<SparseTag> _parentVertexTag;
+    SparseTagVector _parentFaceTag;
+    SparseTagVector _parentEdgeTag;
+    SparseTagVector _parentVertexTag;
 
     //
     //  Refinement data for face-varying channels present in the Levels being refined:
@@ -410,6 +517,10 @@ protected:
 inline ConstIndexArray
 Refinement::getFaceChildFaces(Index parentFace) const {
 
+    if (_regFaceChildFaceCount) {
+        return ConstIndexArray(&_faceChildFaceIndices[parentFace * _regFaceChildFaceCount],
+                                                 _regFaceChildFaceCount);
+    }
     return ConstIndexArray(&_faceChildFaceIndices[_faceChildFaceCountsAndOffsets[2*parentFace+1]],
                                              _faceChildFaceCountsAndOffsets[2*parentFace]);
 }
@@ -417,6 +528,10 @@ Refinement::getFaceChildFaces(Index parentFace) const {
 inline IndexArray
 Refinement::getFaceChildFaces(Index parentFace) {
 
+    if (_regFaceChildFaceCount) {
+        return IndexArray(&_faceChildFaceIndices[parentFace * _regFaceChildFaceCount],
+                                                 _regFaceChildFaceCount);
+    }
     return IndexArray(&_faceChildFaceIndices[_faceChildFaceCountsAndOffsets[2*parentFace+1]],
                                              _faceChildFaceCountsAndOffsets[2*parentFace]);
 }
@@ -424,12 +539,20 @@ Refinement::getFaceChildFaces(Index parentFace) {
 inline ConstIndexArray
 Refinement::getFaceChildEdges(Index parentFace) const {
 
+    if (_regFaceChildEdgeCount) {
+        return ConstIndexArray(&_faceChildEdgeIndices[parentFace * _regFaceChildEdgeCount],
+                                                 _regFaceChildEdgeCount);
+    }
     return ConstIndexArray(&_faceChildEdgeIndices[_faceChildEdgeCountsAndOffsets[2*parentFace+1]],
                                              _faceChildEdgeCountsAndOffsets[2*parentFace]);
 }
 inline IndexArray
 Refinement::getFaceChildEdges(Index parentFace) {
 
+    if (_regFaceChildEdgeCount) {
+        return IndexArray(&_faceChildEdgeIndices[parentFace * _regFaceChildEdgeCount],
+                                                 _regFaceChildEdgeCount);
+    }
     return IndexArray(&_faceChildEdgeIndices[_faceChildEdgeCountsAndOffsets[2*parentFace+1]],
                                              _faceChildEdgeCountsAndOffsets[2*parentFace]);
 }
@@ -78,21 +78,20 @@ TriRefinement::allocateParentChildIndices() {
     int vertChildVertCount = _parent->getNumVertices();
 
     //
-    //  First initialize the count/offset vectors for the child-faces and child-edges of
-    //  parent faces.  For now we can use the parent's face-vert counts for the child-edges
-    //  of faces, but we must use a local vector for the child-faces.
+    //  First initialize the counts/offsets for the child-faces and child-edges of parent
+    //  faces.  Every face has four child faces, so their counts/offsets are implicit, and
+    //  we can use the parent's face-vert counts for the child-edges of faces (implicit in
+    //  turn when the parent is a refined level).
     //
     //  This will be more necessary (and need adjustment) when N-sided faces are supported.
     //
-    _localFaceChildFaceCountsAndOffsets.resize(_parent->getNumFaces() * 2, 4);
-    for (int i = 0; i < _parent->getNumFaces(); ++i) {
-        _localFaceChildFaceCountsAndOffsets[i*2 + 1] = 4 * i;
+    _regFaceChildFaceCount = 4;
+    if (_parent->getRegularFaceSize()) {
+        _regFaceChildEdgeCount = _parent->getRegularFaceSize();
+    } else {
+        _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
     }
 
-    _faceChildFaceCountsAndOffsets = IndexArray(&_localFaceChildFaceCountsAndOffsets[0],
-                                                (int)_localFaceChildFaceCountsAndOffsets.size());
-    _faceChildEdgeCountsAndOffsets = _parent->shareFaceVertCountsAndOffsets();
-
     //
     //  Given we will be ignoring initial values with uniform refinement and assigning all
     //  directly, initializing here is a waste...
@@ -116,31 +115,16 @@ TriRefinement::allocateParentChildIndices() {
 void
 TriRefinement::populateFaceVertexRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets within a
-    //  Level, so be sure not to re-initialize it if already done:
-    //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
+    //  Face-vertex counts/offsets of the child are implicit (see Level::getRegularFaceSize()):
     _child->_faceVertIndices.resize(_child->getNumFaces() * 3);
 
-    populateFaceVerticesFromParentFaces();
-}
-
-void
-TriRefinement::populateFaceVertexCountsAndOffsets() {
-
-    _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2, 3);
-
-    for (int i = 0; i < _child->getNumFaces(); ++i) {
-        _child->_faceVertCountsAndOffsets[i*2 + 1] = i * 3;
-    }
+    populateFaceVerticesFromParentFaces(0, _parent->getNumFaces());
 }
 
 void
-TriRefinement::populateFaceVerticesFromParentFaces() {
+TriRefinement::populateFaceVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd) {
 
-   for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+   for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
                         pFaceChildren = getFaceChildFaces(pFace);
@@ -202,21 +186,15 @@ TriRefinement::populateFaceVerticesFromParentFaces() {
 void
 TriRefinement::populateFaceEdgeRelation() {
 
-    //  Both face-vertex and face-edge share the face-vertex counts/offsets, so be sure
-    //  not to re-initialize it if already done:
-    //
-    if (_child->_faceVertCountsAndOffsets.size() == 0) {
-        populateFaceVertexCountsAndOffsets();
-    }
     _child->_faceEdgeIndices.resize(_child->getNumFaces() * 3);
 
-    populateFaceEdgesFromParentFaces();
+    populateFaceEdgesFromParentFaces(0, _parent->getNumFaces());
 }
 
 void
-TriRefinement::populateFaceEdgesFromParentFaces() {
+TriRefinement::populateFaceEdgesFromParentFaces(Index pFaceBegin, Index pFaceEnd) {
 
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
                         pFaceChildFaces = getFaceChildFaces(pFace),
@@ -281,14 +259,14 @@ TriRefinement::populateEdgeVertexRelation() {
 
     _child->_edgeVertIndices.resize(_child->getNumEdges() * 2);
 
-    populateEdgeVerticesFromParentFaces();
-    populateEdgeVerticesFromParentEdges();
+    populateEdgeVerticesFromParentFaces(0, _parent->getNumFaces());
+    populateEdgeVerticesFromParentEdges(0, _parent->getNumEdges());
 }
 
 void
-TriRefinement::populateEdgeVerticesFromParentFaces() {
+TriRefinement::populateEdgeVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd) {
 
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
 
@@ -322,9 +300,9 @@ TriRefinement::populateEdgeVerticesFromParentFaces() {
 }
 
 void
-TriRefinement::populateEdgeVerticesFromParentEdges() {
+TriRefinement::populateEdgeVerticesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd) {
 
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (Index pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         ConstIndexArray pEdgeVerts      = _parent->getEdgeVertices(pEdge),
                         pEdgeChildEdges = getEdgeChildEdges(pEdge);
 
@@ -367,26 +345,23 @@ TriRefinement::populateEdgeFaceRelation() {
     _child->_edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
     _child->_edgeFaceLocalIndices.resize(childEdgeFaceIndexSizeEstimate);
 
-    // Update _maxEdgeFaces from the parent level before calling the 
-    // populateEdgeFacesFromParent methods below, as these may further
-    // update _maxEdgeFaces.
-    _child->_maxEdgeFaces = _parent->_maxEdgeFaces;
-
-    populateEdgeFacesFromParentFaces();
-    populateEdgeFacesFromParentEdges();
+    //  Populate the child edges in order -- those from faces precede those from edges
+    //  and the offset of each is assigned explicitly from those preceding it:
+    int offset = 0;
+    offset = populateEdgeFacesFromParentFaces(0, _parent->getNumFaces(), offset);
+    offset = populateEdgeFacesFromParentEdges(0, _parent->getNumEdges(), offset);
 
-    //  Revise the over-allocated estimate based on what is used (as indicated in the
-    //  count/offset for the last vertex) and trim the index vector accordingly:
-    childEdgeFaceIndexSizeEstimate = _child->getNumEdgeFaces(_child->getNumEdges()-1) +
-                                     _child->getOffsetOfEdgeFaces(_child->getNumEdges()-1);
+    //  Revise the over-allocated estimate based on what is used (as indicated by the
+    //  offset following the last edge) and trim the index vector accordingly:
+    childEdgeFaceIndexSizeEstimate = offset;
     _child->_edgeFaceIndices.resize(childEdgeFaceIndexSizeEstimate);
     _child->_edgeFaceLocalIndices.resize(childEdgeFaceIndexSizeEstimate);
 }
 
-void
-TriRefinement::populateEdgeFacesFromParentFaces() {
+int
+TriRefinement::populateEdgeFacesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset) {
 
-    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+    for (Index pFace = pFaceBegin; pFace < pFaceEnd; ++pFace) {
         ConstIndexArray pFaceChildFaces = getFaceChildFaces(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
 
@@ -401,7 +376,7 @@ TriRefinement::populateEdgeFacesFromParentFaces() {
             Index cEdge = pFaceChildEdges[j];
             if (IndexIsValid(cEdge)) {
                 //  Reserve enough edge-faces, populate and trim as needed:
-                _child->resizeEdgeFaces(cEdge, 2);
+                _child->resizeEdgeFaces(cEdge, 2, offset);
 
                 IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
                 LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -418,15 +393,17 @@ TriRefinement::populateEdgeFacesFromParentFaces() {
                     cEdgeFaceCount++;
                 }
                 _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+                offset += cEdgeFaceCount;
             }
         }
     }
+    return offset;
 }
 
-void
-TriRefinement::populateEdgeFacesFromParentEdges() {
+int
+TriRefinement::populateEdgeFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) {
 
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (Index pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         ConstIndexArray pEdgeChildEdges = getEdgeChildEdges(pEdge);
         if (!IndexIsValid(pEdgeChildEdges[0]) && !IndexIsValid(pEdgeChildEdges[1])) continue;
 
@@ -441,7 +418,7 @@ TriRefinement::populateEdgeFacesFromParentEdges() {
             //
             //  Reserve enough edge-faces, populate and trim as needed:
             //
-            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
+            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size(), offset);
 
             IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
             LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -491,8 +468,10 @@ TriRefinement::populateEdgeFacesFromParentEdges() {
                 }
             }
             _child->trimEdgeFaces(cEdge, cEdgeFaceCount);
+            offset += cEdgeFaceCount;
         }
     }
+    return offset;
 }
 
 
@@ -501,7 +480,7 @@ TriRefinement::populateEdgeFacesFromParentEdges() {
 //      - child vertices originate from parent faces, edges and vertices
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
-//          - note this imposes ordering constraints and inhibits concurrency
+//          - offsets are assigned explicitly so ranges can be populated concurrently
 //
 void
 TriRefinement::populateVertexFaceRelation() {
@@ -519,26 +498,26 @@ TriRefinement::populateVertexFaceRelation() {
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
     //  Remember -- no vertices-from-faces to consider here (until N-gon support)
+    int offset = 0;
     if (getFirstChildVertexFromVertices() == 0) {
-        populateVertexFacesFromParentVertices();
-        populateVertexFacesFromParentEdges();
+        offset = populateVertexFacesFromParentVertices(0, _parent->getNumVertices(), offset);
+        offset = populateVertexFacesFromParentEdges(0, _parent->getNumEdges(), offset);
     } else {
-        populateVertexFacesFromParentEdges();
-        populateVertexFacesFromParentVertices();
+        offset = populateVertexFacesFromParentEdges(0, _parent->getNumEdges(), offset);
+        offset = populateVertexFacesFromParentVertices(0, _parent->getNumVertices(), offset);
     }
 
-    //  Revise the over-allocated estimate based on what is used (as indicated in the
-    //  count/offset for the last vertex) and trim the index vectors accordingly:
-    childVertFaceIndexSizeEstimate = _child->getNumVertexFaces(_child->getNumVertices()-1) +
-                                     _child->getOffsetOfVertexFaces(_child->getNumVertices()-1);
+    //  Revise the over-allocated estimate based on what is used (as indicated by the
+    //  offset following the last vertex) and trim the index vectors accordingly:
+    childVertFaceIndexSizeEstimate = offset;
     _child->_vertFaceIndices.resize(     childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(childVertFaceIndexSizeEstimate);
 }
 
-void
-TriRefinement::populateVertexFacesFromParentEdges() {
+int
+TriRefinement::populateVertexFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) {
 
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (Index pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
 
@@ -548,7 +527,7 @@ TriRefinement::populateVertexFacesFromParentEdges() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size());
+        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size(), offset);
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -600,13 +579,15 @@ TriRefinement::populateVertexFacesFromParentEdges() {
             }
         }
         _child->trimVertexFaces(cVert, cVertFaceCount);
+        offset += cVertFaceCount;
     }
+    return offset;
 }
 
-void
-TriRefinement::populateVertexFacesFromParentVertices() {
+int
+TriRefinement::populateVertexFacesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset) {
 
-    for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
+    for (Index pVert = pVertBegin; pVert < pVertEnd; ++pVert) {
         Index cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
 
@@ -619,7 +600,7 @@ TriRefinement::populateVertexFacesFromParentVertices() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, pVertFaces.size());
+        _child->resizeVertexFaces(cVert, pVertFaces.size(), offset);
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -637,7 +618,9 @@ TriRefinement::populateVertexFacesFromParentVertices() {
             }
         }
         _child->trimVertexFaces(cVert, cVertFaceCount);
+        offset += cVertFaceCount;
     }
+    return offset;
 }
 
 
@@ -646,7 +629,7 @@ TriRefinement::populateVertexFacesFromParentVertices() {
 //      - child vertices originate from parent faces, edges and vertices
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
-//          - note this imposes ordering constraints and inhibits concurrency
+//          - offsets are assigned explicitly so ranges can be populated concurrently
 //
 void
 TriRefinement::populateVertexEdgeRelation() {
@@ -679,26 +662,26 @@ TriRefinement::populateVertexEdgeRelation() {
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
+    int offset = 0;
     if (getFirstChildVertexFromVertices() == 0) {
-        populateVertexEdgesFromParentVertices();
-        populateVertexEdgesFromParentEdges();
+        offset = populateVertexEdgesFromParentVertices(0, _parent->getNumVertices(), offset);
+        offset = populateVertexEdgesFromParentEdges(0, _parent->getNumEdges(), offset);
     } else {
-        populateVertexEdgesFromParentEdges();
-        populateVertexEdgesFromParentVertices();
+        offset = populateVertexEdgesFromParentEdges(0, _parent->getNumEdges(), offset);
+        offset = populateVertexEdgesFromParentVertices(0, _parent->getNumVertices(), offset);
     }
 
-    //  Revise the over-allocated estimate based on what is used (as indicated in the
-    //  count/offset for the last vertex) and trim the index vectors accordingly:
-    childVertEdgeIndexSizeEstimate = _child->getNumVertexEdges(_child->getNumVertices()-1) +
-                                     _child->getOffsetOfVertexEdges(_child->getNumVertices()-1);
+    //  Revise the over-allocated estimate based on what is used (as indicated by the
+    //  offset following the last vertex) and trim the index vectors accordingly:
+    childVertEdgeIndexSizeEstimate = offset;
     _child->_vertEdgeIndices.resize(     childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(childVertEdgeIndexSizeEstimate);
 }
 
-void
-TriRefinement::populateVertexEdgesFromParentEdges() {
+int
+TriRefinement::populateVertexEdgesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset) {
 
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    for (Index pEdge = pEdgeBegin; pEdge < pEdgeEnd; ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
 
@@ -714,7 +697,7 @@ TriRefinement::populateVertexEdgesFromParentEdges() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2);
+        _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2, offset);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -786,12 +769,14 @@ TriRefinement::populateVertexEdgesFromParentEdges() {
             }
         }
         _child->trimVertexEdges(cVert, cVertEdgeCount);
+        offset += cVertEdgeCount;
     }
+    return offset;
 }
-void
-TriRefinement::populateVertexEdgesFromParentVertices() {
+int
+TriRefinement::populateVertexEdgesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset) {
 
-    for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
+    for (Index pVert = pVertBegin; pVert < pVertEnd; ++pVert) {
         Index cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
 
@@ -804,7 +789,7 @@ TriRefinement::populateVertexEdgesFromParentVertices() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pVertEdges.size());
+        _child->resizeVertexEdges(cVert, pVertEdges.size(), offset);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -819,7 +804,9 @@ TriRefinement::populateVertexEdgesFromParentVertices() {
             }
         }
         _child->trimVertexEdges(cVert, cVertEdgeCount);
+        offset += cVertEdgeCount;
     }
+    return offset;
 }
 
 //
@@ -47,6 +47,7 @@ public:
     TriRefinement(Level const & parent, Level & child, Sdc::Options const & options);
     ~TriRefinement();
 
+
 protected:
     //
     //  Virtual methods to complete the configuration of the parent-to-child mapping:
@@ -70,31 +71,21 @@ protected:
     //  identical to what is used for quad-splitting, so we may move them to the
     //  base class...
     //
-    void populateFaceVertexCountsAndOffsets();
-    void populateFaceVerticesFromParentFaces();
-
-    void populateFaceEdgesFromParentFaces();
+    virtual void populateFaceVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd);
 
-    void populateEdgeVerticesFromParentFaces();
-    void populateEdgeVerticesFromParentEdges();
+    virtual void populateFaceEdgesFromParentFaces(Index pFaceBegin, Index pFaceEnd);
 
-    void populateEdgeFacesFromParentFaces();
-    void populateEdgeFacesFromParentEdges();
+    virtual void populateEdgeVerticesFromParentFaces(Index pFaceBegin, Index pFaceEnd);
+    virtual void populateEdgeVerticesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd);
 
-    void populateVertexFacesFromParentEdges();
-    void populateVertexFacesFromParentVertices();
+    virtual int populateEdgeFacesFromParentFaces(Index pFaceBegin, Index pFaceEnd, int offset);
+    virtual int populateEdgeFacesFromParentEdges(Index pEdgeBegin, Index pEdgeEnd, int offset);
 
-    void populateVertexEdgesFromParentEdges();
-    void populateVertexEdgesFromParentVertices();
+    virtual int populateVertexFacesFromParentEdges(   Index pEdgeBegin, Index pEdgeEnd, int offset);
+    virtual int populateVertexFacesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset);
 
-private:
-    //
-    //  Unlike the quad-split, which can some vectors with the parent Level since
-    //  child components correspond to face-vertices, the tri-split must define its
-    //  own local vectors to identify the children for each parent component -- to
-    //  be referenced within the base class for more immediate/inline access:
-    //
-    IndexVector _localFaceChildFaceCountsAndOffsets;
+    virtual int populateVertexEdgesFromParentEdges(   Index pEdgeBegin, Index pEdgeEnd, int offset);
+    virtual int populateVertexEdgesFromParentVertices(Index pVertBegin, Index pVertEnd, int offset);
 };
 
 } // end namespace internal
@@ -28,6 +28,7 @@
 
 #include "../vtr/array.h"
 
+#include <cstddef>
 #include <vector>
 
 namespace OpenSubdiv {
@@ -51,6 +52,12 @@ namespace Vtr {
 //  despite the fact that we lose half the range compared to using "uint" (with ~0
 //  as invalid).
 //
+//  There is no 64-bit configuration:  the Far tables and the Osd kernels share these
+//  indices (and offsets derived from them) as "int", so a wider Index would change
+//  all of their buffer layouts and double their memory.  Far::TopologyRefiner rejects
+//  uniform refinements whose levels would exceed this range -- meshes that large are
+//  to be refined in tiles with Far::StreamingRefiner, whose indices are local to each.
+//
 typedef int Index;
 
 static const Index INDEX_INVALID = -1;
@@ -82,6 +89,31 @@ typedef ConstArray<Index>        ConstIndexArray;
 typedef Array<LocalIndex>        LocalIndexArray;
 typedef ConstArray<LocalIndex>   ConstLocalIndexArray;
 
+//
+//  Memory held by a set of vectors (in bytes) -- both the size of their elements
+//  and their reserved capacity, the difference being the slack that reallocation
+//  to fit their size would release:
+//
+struct MemoryUsage {
+
+    MemoryUsage() : used(0), reserved(0) { }
+
+    template <typename T, class A>
+    void Add(std::vector<T, A> const & v) {
+        used     += v.size() * sizeof(T);
+        reserved += v.capacity() * sizeof(T);
+    }
+
+    MemoryUsage & operator+=(MemoryUsage const & m) {
+        used     += m.used;
+        reserved += m.reserved;
+        return *this;
+    }
+
+    size_t used,      ///< bytes of the elements
+           reserved;  ///< bytes of the capacity (at least 'used')
+};
+
 
 } // end namespace Vtr
 
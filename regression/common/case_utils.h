@@ -0,0 +1,144 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef CASE_UTILS_H
+#define CASE_UTILS_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../../examples/common/stopwatch.h"
+
+//------------------------------------------------------------------------------
+//
+// Partition of the independent cases of a regression target (e.g. its shapes)
+// among concurrent processes, and report of the time taken by each case :
+//
+//   -partition <k> <n>  runs only the cases i where i % n == k, so that n
+//                       processes (e.g. tests run by 'ctest -j <n>') run all
+//                       of them
+//
+//   -timing             prints the time taken by each case run, slowest first
+//
+// Cases are numbered in the order they are begun, which must be the same in
+// all processes.
+//
+class RegressionCases {
+
+public:
+    RegressionCases() : _partition(0), _numPartitions(1), _timing(false), _next(0) { }
+
+    // Consumes the option at argv[argi] (and its arguments) : returns false
+    // if it isn't one of the options above
+    bool ParseArg(int argc, char ** argv, int & argi) {
+        if (not strcmp(argv[argi], "-partition") and (argi < argc-2)) {
+            _partition = atoi(argv[++argi]);
+            _numPartitions = atoi(argv[++argi]);
+            if ((_numPartitions < 1) or (_partition < 0) or
+                (_partition >= _numPartitions)) {
+                printf("-partition : invalid partition %d of %d\n",
+                    _partition, _numPartitions);
+                exit(1);
+            }
+            return true;
+        } else if (not strcmp(argv[argi], "-timing")) {
+            _timing = true;
+            return true;
+        }
+        return false;
+    }
+
+    static void PrintUsage() {
+        printf("        -partition <k> <n>\n");
+        printf("        Runs the cases of index k modulo n only.\n\n");
+        printf("        -timing\n");
+        printf("        Reports the time taken by each case.\n\n");
+    }
+
+    // Returns whether the next case is run by this process (and if so, starts
+    // timing it)
+    bool Begin() {
+        if ((_next++ % _numPartitions) != _partition) {
+            return false;
+        }
+        _stopwatch.Start();
+        return true;
+    }
+
+    // Records the time taken by the case begun and its number of failures
+    void End(std::string const & name, int failures) {
+        _stopwatch.Stop();
+
+        Case c;
+        c.name = name;
+        c.elapsed = _stopwatch.GetElapsed();
+        c.failures = failures;
+        _cases.push_back(c);
+    }
+
+    void PrintReport() const {
+        if (not _timing) return;
+
+        std::vector<Case> cases(_cases);
+        std::sort(cases.begin(), cases.end());
+
+        double total = 0.0;
+        printf("timing (partition %d of %d) :\n", _partition, _numPartitions);
+        for (int i=0; i<(int)cases.size(); ++i) {
+            printf("  %10.3f s  %s", cases[i].elapsed, cases[i].name.c_str());
+            if (cases[i].failures) {
+                printf("  (%d failures)", cases[i].failures);
+            }
+            printf("\n");
+            total += cases[i].elapsed;
+        }
+        printf("  %10.3f s  total of %d cases\n", total, (int)cases.size());
+    }
+
+private:
+    struct Case {
+        std::string name;
+        double      elapsed;
+        int         failures;
+
+        // slowest first
+        bool operator < (Case const & c) const { return elapsed > c.elapsed; }
+    };
+
+    int  _partition,
+         _numPartitions;
+    bool _timing;
+    int  _next;
+
+    Stopwatch         _stopwatch;
+    std::vector<Case> _cases;
+};
+
+//------------------------------------------------------------------------------
+
+#endif /* CASE_UTILS_H */
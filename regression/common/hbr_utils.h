@@ -382,10 +382,11 @@ hbrToObj( OpenSubdiv::HbrMesh<T> * mesh ) {
 
 //------------------------------------------------------------------------------
 template <class T> OpenSubdiv::HbrMesh<T> *
-createMesh( Scheme scheme=kCatmark, int fvarwidth=0) {
-
-  OpenSubdiv::HbrMesh<T> * mesh = 0;
+createMesh( Scheme scheme=kCatmark, int fvarwidth=0,
+    OpenSubdiv::HbrSubdivision<T> * subdivision=0 ) {
 
+  // Unless the mesh is given its own subdivision scheme, it shares a static
+  // instance (the state of the scheme is set when the topology is created)
   static OpenSubdiv::HbrBilinearSubdivision<T> _bilinear;
   static OpenSubdiv::HbrLoopSubdivision<T>     _loop;
   static OpenSubdiv::HbrCatmarkSubdivision<T>  _catmark;
@@ -398,27 +399,31 @@ createMesh( Scheme scheme=kCatmark, int fvarwidth=0) {
             * fvarwidths  = fvarwidth > 0 ? widths : NULL;
 
 
-  switch (scheme) {
-    case kBilinear : mesh = new OpenSubdiv::HbrMesh<T>( &_bilinear,
-                                                        fvarcount,
-                                                        fvarindices,
-                                                        fvarwidths,
-                                                        fvarwidth ); break;
-
-    case kLoop     : mesh = new OpenSubdiv::HbrMesh<T>( &_loop,
-                                                        fvarcount,
-                                                        fvarindices,
-                                                        fvarwidths,
-                                                        fvarwidth ); break;
-
-    case kCatmark  : mesh = new OpenSubdiv::HbrMesh<T>( &_catmark,
-                                                        fvarcount,
-                                                        fvarindices,
-                                                        fvarwidths,
-                                                        fvarwidth ); break;
+  if (not subdivision) {
+    switch (scheme) {
+      case kBilinear : subdivision = &_bilinear; break;
+      case kLoop     : subdivision = &_loop; break;
+      case kCatmark  : subdivision = &_catmark; break;
+    }
   }
 
-  return mesh;
+  return new OpenSubdiv::HbrMesh<T>( subdivision,
+                                     fvarcount,
+                                     fvarindices,
+                                     fvarwidths,
+                                     fvarwidth );
+}
+
+//------------------------------------------------------------------------------
+template <class T> OpenSubdiv::HbrSubdivision<T> *
+createSubdivision( Scheme scheme ) {
+
+  switch (scheme) {
+    case kBilinear : return new OpenSubdiv::HbrBilinearSubdivision<T>;
+    case kLoop     : return new OpenSubdiv::HbrLoopSubdivision<T>;
+    case kCatmark  : return new OpenSubdiv::HbrCatmarkSubdivision<T>;
+  }
+  return 0;
 }
 
 //------------------------------------------------------------------------------
@@ -578,13 +583,14 @@ createFaceVaryingUV( Shape const * sh, OpenSubdiv::HbrMesh<T> * mesh) {
 
 //------------------------------------------------------------------------------
 template <class T> OpenSubdiv::HbrMesh<T> *
-simpleHbr(char const * Shapestr, Scheme scheme, std::vector<float> * verts=0, bool fvar=false) {
+simpleHbr(char const * Shapestr, Scheme scheme, std::vector<float> * verts=0, bool fvar=false,
+    OpenSubdiv::HbrSubdivision<T> * subdivision=0) {
 
     Shape * sh = Shape::parseObj( Shapestr, scheme );
 
     int fvarwidth = fvar and sh->HasUV() ? 2 : 0;
 
-    OpenSubdiv::HbrMesh<T> * mesh = createMesh<T>(scheme, fvarwidth);
+    OpenSubdiv::HbrMesh<T> * mesh = createMesh<T>(scheme, fvarwidth, subdivision);
 
     createVerticesWithPositions<T>(sh, mesh);
 
@@ -25,6 +25,7 @@
 
 #include "shape_utils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstring>
@@ -32,6 +33,25 @@
 #include <fstream>
 #include <sstream>
 
+#if defined(OPENSUBDIV_HAS_OPENMP)
+    #include <omp.h>
+#endif
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 //------------------------------------------------------------------------------
 static char const * sgets( char * s, int size, char ** stream ) {
     for (int i=0; i<size; ++i) {
@@ -61,24 +81,129 @@ Shape::~Shape() {
 }
 
 //------------------------------------------------------------------------------
-Shape * Shape::parseObj(char const * shapestr, Scheme shapescheme,
-                        bool isLeftHanded, int axis, bool parsemtl) {
+// Scanners of the tokens of OBJ lines : unlike sscanf(), they neither require
+// a null terminated line nor go through the locale
 
-    Shape * s = new Shape;
+static inline bool isBlank(char c) {
+    return c==' ' or c=='\t' or c=='\r';
+}
 
-    s->scheme = shapescheme;
-    s->isLeftHanded = isLeftHanded;
+static inline char const * skipBlanks(char const * cp, char const * end) {
+    while (cp<end and isBlank(*cp)) ++cp;
+    return cp;
+}
 
-    char * str=const_cast<char *>(shapestr), line[256], buf[256], usemtl=-1;
-    bool done = false;
-    while (not done) {
-        done = sgets(line, sizeof(line), &str)==0;
-        char* end = &line[strlen(line)-1];
-        if (*end == '\n') *end = '\0'; // strip trailing nl
+static inline char const * skipToken(char const * cp, char const * end) {
+    while (cp<end and not isBlank(*cp)) ++cp;
+    return cp;
+}
+
+static bool scanInt(char const ** cp, char const * end, int * value) {
+
+    char const * c = *cp;
+
+    bool negative = false;
+    if (c<end and (*c=='-' or *c=='+')) {
+        negative = (*c=='-');
+        ++c;
+    }
+    if (c==end or *c<'0' or *c>'9') {
+        return false;
+    }
+    int result = 0;
+    for ( ; c<end and *c>='0' and *c<='9'; ++c) {
+        result = result*10 + (*c-'0');
+    }
+    *value = negative ? -result : result;
+    *cp = c;
+    return true;
+}
+
+static bool scanFloat(char const ** cp, char const * end, float * value) {
+
+    static double const powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    char const * c = *cp;
+
+    bool negative = false;
+    if (c<end and (*c=='-' or *c=='+')) {
+        negative = (*c=='-');
+        ++c;
+    }
+
+    // up to 19 significant digits accumulate exactly in the mantissa
+    unsigned long long mantissa = 0;
+    int exponent = 0, ndigits = 0, nsignificant = 0;
+
+    for ( ; c<end and *c>='0' and *c<='9'; ++c, ++ndigits) {
+        if (nsignificant<19) {
+            mantissa = mantissa*10 + (unsigned)(*c-'0');
+            nsignificant += (mantissa!=0);
+        } else {
+            ++exponent;
+        }
+    }
+    if (c<end and *c=='.') {
+        for (++c; c<end and *c>='0' and *c<='9'; ++c, ++ndigits) {
+            if (nsignificant<19) {
+                mantissa = mantissa*10 + (unsigned)(*c-'0');
+                nsignificant += (mantissa!=0);
+                --exponent;
+            }
+        }
+    }
+    if (ndigits==0) {
+        return false;
+    }
+    if (c<end and (*c=='e' or *c=='E')) {
+        int e = 0;
+        char const * ce = c+1;
+        if (scanInt(&ce, end, &e)) {
+            exponent += e;
+            c = ce;
+        }
+    }
+
+    double result = (double)mantissa;
+    if (mantissa!=0) {
+        for ( ; exponent>22; exponent-=22) result *= powersOf10[22];
+        for ( ; exponent<-22; exponent+=22) result /= powersOf10[22];
+        result = exponent<0 ?
+            result / powersOf10[-exponent] : result * powersOf10[exponent];
+    }
+    *value = (float)(negative ? -result : result);
+    *cp = c;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Parses the lines in [begin, end) into 's' -- materials are only bound when
+// all the lines are parsed in a single range
+static void parseObjLines(char const * begin, char const * end, Shape * s,
+    int axis, bool parsemtl) {
+
+    char usemtl=-1;
+
+    for (char const * line=begin; line<end; ) {
+
+        char const * eol = static_cast<char const *>(
+            memchr(line, '\n', end-line));
+        if (not eol) {
+            eol = end;
+        }
+
+        char const * cp = line;
         float x, y, z, u, v;
-        switch (line[0]) {
-            case 'v': switch (line[1]) {
-                          case ' ': if (sscanf(line, "v %f %f %f", &x, &y, &z) == 3) {
+
+        switch (*cp) {
+            case 'v': if (eol-cp<2) break;
+                      switch (cp[1]) {
+                          case ' ': cp = skipBlanks(cp+2, eol);
+                                    if (scanFloat(&cp, eol, &x) and
+                                        (cp = skipBlanks(cp, eol), scanFloat(&cp, eol, &y)) and
+                                        (cp = skipBlanks(cp, eol), scanFloat(&cp, eol, &z))) {
                                          s->verts.push_back(x);
                                          switch( axis ) {
                                              case 0 : s->verts.push_back(-z);
@@ -87,58 +212,359 @@ Shape * Shape::parseObj(char const * shapestr, Scheme shapescheme,
                                                       s->verts.push_back(z); break;
                                          }
                                     } break;
-                          case 't': if (sscanf(line, "vt %f %f", &u, &v) == 2) {
+                          case 't': cp = skipBlanks(cp+2, eol);
+                                    if (scanFloat(&cp, eol, &u) and
+                                        (cp = skipBlanks(cp, eol), scanFloat(&cp, eol, &v))) {
                                         s->uvs.push_back(u);
                                         s->uvs.push_back(v);
                                     } break;
-                          case 'n' : if (sscanf(line, "vn %f %f %f", &x, &y, &z) == 3) {
+                          case 'n' : cp = skipBlanks(cp+2, eol);
+                                     if (scanFloat(&cp, eol, &x) and
+                                         (cp = skipBlanks(cp, eol), scanFloat(&cp, eol, &y)) and
+                                         (cp = skipBlanks(cp, eol), scanFloat(&cp, eol, &z))) {
                                         s->normals.push_back(x);
                                         s->normals.push_back(y);
                                         s->normals.push_back(z);
                                      } break; // skip normals for now
                       } break;
-            case 'f': if (line[1] == ' ') {
+            case 'f': if (eol-cp>1 and cp[1] == ' ') {
                           int vi, ti, ni;
-                          const char* cp = &line[2];
-                          while (*cp == ' ') cp++;
-                          int nverts = 0, nitems=0;
-                          while( (nitems=sscanf(cp, "%d/%d/%d", &vi, &ti, &ni))>0) {
+                          cp = skipBlanks(cp+2, eol);
+                          int nverts = 0;
+                          while (scanInt(&cp, eol, &vi)) {
                               nverts++;
                               s->faceverts.push_back(vi-1);
-                              if(nitems > 1) s->faceuvs.push_back(ti-1);
-                              if(nitems > 2) s->facenormals.push_back(ni-1);
-                              while (*cp && *cp != ' ') cp++;
-                              while (*cp == ' ') cp++;
+                              if (cp<eol and *cp=='/') {
+                                  ++cp;
+                                  if (scanInt(&cp, eol, &ti)) s->faceuvs.push_back(ti-1);
+                                  if (cp<eol and *cp=='/') {
+                                      ++cp;
+                                      if (scanInt(&cp, eol, &ni)) s->facenormals.push_back(ni-1);
+                                  }
+                              }
+                              cp = skipBlanks(skipToken(cp, eol), eol);
                           }
                           s->nvertsPerFace.push_back(nverts);
                           if (not s->mtls.empty()) {
                               s->mtlbind.push_back(usemtl);
                           }
                       } break;
-            case 't' : if (line[1] == ' ') {
-                           Shape::tag * t = tag::parseTag( line );
+            case 't' : if (eol-cp>1 and cp[1] == ' ') {
+                           std::string tagline(line, eol);
+                           Shape::tag * t = Shape::tag::parseTag( tagline.c_str() );
                            if (t)
                                s->tags.push_back(t);
                        } break;
-            case 'u' : if (parsemtl and sscanf(line, "usemtl %s", buf)==1) {
-                           usemtl = s->FindMaterial(buf);
+            case 'u' : if (parsemtl) {
+                           char buf[256];
+                           std::string mtlline(line, eol);
+                           if (sscanf(mtlline.c_str(), "usemtl %255s", buf)==1) {
+                               usemtl = s->FindMaterial(buf);
+                           }
                        } break;
-            case 'm' : if (parsemtl and sscanf(line, "mtllib %s", buf)==1) {
-                           std::ifstream ifs(buf);
-                           if (ifs) {
-                               std::stringstream ss;
-                               ss << ifs.rdbuf();
-                               ifs.close();
-                               std::string tmpStr = ss.str();
-                               s->parseMtllib(tmpStr.c_str());
-                               s->mtllib = buf;
+            case 'm' : if (parsemtl) {
+                           char buf[256];
+                           std::string mtlline(line, eol);
+                           if (sscanf(mtlline.c_str(), "mtllib %255s", buf)==1) {
+                               std::ifstream ifs(buf);
+                               if (ifs) {
+                                   std::stringstream ss;
+                                   ss << ifs.rdbuf();
+                                   ifs.close();
+                                   std::string tmpStr = ss.str();
+                                   s->parseMtllib(tmpStr.c_str());
+                                   s->mtllib = buf;
+                               }
                            }
                        } break;
         }
+        line = eol+1;
+    }
+}
+
+template <class T>
+static void appendVector(std::vector<T> & dst, std::vector<T> const & src) {
+    dst.insert(dst.end(), src.begin(), src.end());
+}
+
+//------------------------------------------------------------------------------
+Shape * Shape::parseObj(char const * shapestr, size_t size, Scheme shapescheme,
+                        bool isLeftHanded, int axis, bool parsemtl) {
+
+    // large inputs are parsed concurrently in ranges of whole lines (except
+    // when parsing materials, bound to the faces in the order of the lines)
+    size_t const minRangeSize = 1 << 20;
+
+    int nranges = 1;
+#if defined(OPENSUBDIV_HAS_OPENMP)
+    if (not parsemtl) {
+        nranges = (int)std::min((size_t)(4 * omp_get_max_threads()),
+                                size / minRangeSize + 1);
+    }
+#endif
+
+    std::vector<char const *> bounds(nranges+1, shapestr + size);
+    bounds[0] = shapestr;
+    for (int i=1; i<nranges; ++i) {
+        char const * b = std::max(bounds[i-1], shapestr + (size * i) / nranges);
+        char const * eol = static_cast<char const *>(
+            memchr(b, '\n', shapestr + size - b));
+        bounds[i] = eol ? eol+1 : shapestr + size;
+    }
+
+    std::vector<Shape *> shapes(nranges);
+    for (int i=0; i<nranges; ++i) {
+        shapes[i] = new Shape;
+    }
+
+#if defined(OPENSUBDIV_HAS_OPENMP)
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int i=0; i<nranges; ++i) {
+        parseObjLines(bounds[i], bounds[i+1], shapes[i], axis, parsemtl);
+    }
+
+    Shape * s = shapes[0];
+
+    s->scheme = shapescheme;
+    s->isLeftHanded = isLeftHanded;
+
+    if (nranges>1) {
+        size_t nverts=0, nfaces=0, nfaceverts=0;
+        for (int i=0; i<nranges; ++i) {
+            nverts += shapes[i]->verts.size();
+            nfaces += shapes[i]->nvertsPerFace.size();
+            nfaceverts += shapes[i]->faceverts.size();
+        }
+        s->verts.reserve(nverts);
+        s->nvertsPerFace.reserve(nfaces);
+        s->faceverts.reserve(nfaceverts);
+
+        for (int i=1; i<nranges; ++i) {
+            Shape * r = shapes[i];
+            appendVector(s->verts, r->verts);
+            appendVector(s->uvs, r->uvs);
+            appendVector(s->normals, r->normals);
+            appendVector(s->nvertsPerFace, r->nvertsPerFace);
+            appendVector(s->faceverts, r->faceverts);
+            appendVector(s->faceuvs, r->faceuvs);
+            appendVector(s->facenormals, r->facenormals);
+            appendVector(s->tags, r->tags);
+            r->tags.clear();
+            delete r;
+        }
     }
     return s;
 }
 
+//------------------------------------------------------------------------------
+Shape * Shape::parseObj(char const * shapestr, Scheme shapescheme,
+                        bool isLeftHanded, int axis, bool parsemtl) {
+
+    return parseObj(shapestr, strlen(shapestr), shapescheme,
+        isLeftHanded, axis, parsemtl);
+}
+
+//------------------------------------------------------------------------------
+Shape * Shape::readObj(char const * filename, Scheme shapescheme,
+                       bool isLeftHanded, int axis, bool parsemtl) {
+
+    // the file is mapped rather than read, so that its pages are loaded
+    // concurrently by the threads parsing them
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    LARGE_INTEGER size;
+    if (not GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return 0;
+    }
+
+    Shape * s = 0;
+    if (size.QuadPart == 0) {
+        s = parseObj("", 0, shapescheme, isLeftHanded, axis, parsemtl);
+    } else {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void const * data = mapping ?
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (data) {
+            s = parseObj(static_cast<char const *>(data), (size_t)size.QuadPart,
+                shapescheme, isLeftHanded, axis, parsemtl);
+            UnmapViewOfFile(data);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    return s;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    Shape * s = 0;
+    if (st.st_size == 0) {
+        s = parseObj("", 0, shapescheme, isLeftHanded, axis, parsemtl);
+    } else {
+        void * data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            s = parseObj(static_cast<char const *>(data), (size_t)st.st_size,
+                shapescheme, isLeftHanded, axis, parsemtl);
+            munmap(data, (size_t)st.st_size);
+        }
+    }
+    close(fd);
+    return s;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Binary shapes : a header followed by the arrays of the shape, each prefixed
+// by its number of elements. Values are written in the byte order of the host
+// (the magic number of the header identifies files of another byte order).
+
+static unsigned int const binaryShapeMagic   = 0x5048534f, // "OSHP"
+                          binaryShapeVersion = 1;
+
+template <class T>
+static bool writeArray(FILE * f, std::vector<T> const & v) {
+    unsigned long long size = v.size();
+    return fwrite(&size, sizeof(size), 1, f)==1 and
+        (v.empty() or fwrite(&v[0], sizeof(T), v.size(), f)==v.size());
+}
+
+template <class T>
+static bool readArray(FILE * f, std::vector<T> & v) {
+    unsigned long long size = 0;
+    if (fread(&size, sizeof(size), 1, f)!=1) {
+        return false;
+    }
+    v.resize((size_t)size);
+    return v.empty() or fread(&v[0], sizeof(T), v.size(), f)==v.size();
+}
+
+static bool writeString(FILE * f, std::string const & str) {
+    return writeArray(f, std::vector<char>(str.begin(), str.end()));
+}
+
+static bool readString(FILE * f, std::string & str) {
+    std::vector<char> chars;
+    if (not readArray(f, chars)) {
+        return false;
+    }
+    str.assign(chars.begin(), chars.end());
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool Shape::writeShape(char const * filename) const {
+
+    FILE * f = fopen(filename, "wb");
+    if (not f) {
+        return false;
+    }
+
+    unsigned int header[4] = { binaryShapeMagic, binaryShapeVersion,
+        (unsigned int)scheme, (unsigned int)isLeftHanded };
+
+    bool success = fwrite(header, sizeof(header), 1, f)==1 and
+        writeArray(f, verts) and writeArray(f, uvs) and
+        writeArray(f, normals) and writeArray(f, nvertsPerFace) and
+        writeArray(f, faceverts) and writeArray(f, faceuvs) and
+        writeArray(f, facenormals);
+
+    unsigned long long ntags = tags.size();
+    success = success and fwrite(&ntags, sizeof(ntags), 1, f)==1;
+
+    for (int i=0; success and i<(int)tags.size(); ++i) {
+        tag const * t = tags[i];
+        success = writeString(f, t->name) and writeArray(f, t->intargs) and
+            writeArray(f, t->floatargs);
+
+        unsigned long long nstrings = t->stringargs.size();
+        success = success and fwrite(&nstrings, sizeof(nstrings), 1, f)==1;
+        for (int j=0; success and j<(int)t->stringargs.size(); ++j) {
+            success = writeString(f, t->stringargs[j]);
+        }
+    }
+    return (fclose(f)==0) and success;
+}
+
+//------------------------------------------------------------------------------
+Shape * Shape::readShape(char const * filename) {
+
+    FILE * f = fopen(filename, "rb");
+    if (not f) {
+        return 0;
+    }
+
+    unsigned int header[4];
+    if (fread(header, sizeof(header), 1, f)!=1 or
+        header[0]!=binaryShapeMagic or header[1]!=binaryShapeVersion or
+        header[2]>(unsigned int)kLoop) {
+        fclose(f);
+        return 0;
+    }
+
+    Shape * s = new Shape;
+
+    s->scheme = (Scheme)header[2];
+    s->isLeftHanded = header[3]!=0;
+
+    bool success = readArray(f, s->verts) and readArray(f, s->uvs) and
+        readArray(f, s->normals) and readArray(f, s->nvertsPerFace) and
+        readArray(f, s->faceverts) and readArray(f, s->faceuvs) and
+        readArray(f, s->facenormals);
+
+    unsigned long long ntags = 0;
+    success = success and fread(&ntags, sizeof(ntags), 1, f)==1;
+
+    for (unsigned long long i=0; success and i<ntags; ++i) {
+        tag * t = new tag;
+        s->tags.push_back(t);
+
+        success = readString(f, t->name) and readArray(f, t->intargs) and
+            readArray(f, t->floatargs);
+
+        unsigned long long nstrings = 0;
+        success = success and fread(&nstrings, sizeof(nstrings), 1, f)==1;
+        for (unsigned long long j=0; success and j<nstrings; ++j) {
+            t->stringargs.push_back(std::string());
+            success = readString(f, t->stringargs.back());
+        }
+    }
+    fclose(f);
+
+    if (not success) {
+        delete s;
+        return 0;
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+Shape * Shape::readFile(char const * filename, Scheme shapescheme,
+                        bool isLeftHanded) {
+
+    size_t len = strlen(filename);
+    if (len>4 and strcmp(filename+len-4, ".obj")==0) {
+        return readObj(filename, shapescheme, isLeftHanded);
+    }
+    return readShape(filename);
+}
+
 //------------------------------------------------------------------------------
 Shape::tag * Shape::tag::parseTag(char const * line) {
     tag * t = 0;
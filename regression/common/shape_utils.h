@@ -73,6 +73,24 @@ struct Shape {
     static Shape * parseObj(char const * Shapestr, Scheme schme,
         bool isLeftHanded=false, int axis=1, bool parsemtl=false);
 
+    // parses the 'size' first characters of Shapestr (not null terminated)
+    static Shape * parseObj(char const * Shapestr, size_t size, Scheme schme,
+        bool isLeftHanded=false, int axis=1, bool parsemtl=false);
+
+    // maps and parses an OBJ file (returns NULL if it cannot be read)
+    static Shape * readObj(char const * filename, Scheme schme,
+        bool isLeftHanded=false, int axis=1, bool parsemtl=false);
+
+    // binary shapes hold the geometry, topology and tags of the shape, but
+    // none of its materials (returns NULL if the file cannot be read)
+    static Shape * readShape(char const * filename);
+
+    bool writeShape(char const * filename) const;
+
+    // reads OBJ files (scheme and handedness given) or binary shapes
+    static Shape * readFile(char const * filename, Scheme schme,
+        bool isLeftHanded=false);
+
     void parseMtllib(char const * stream);
 
     std::string genShape(char const * name) const;
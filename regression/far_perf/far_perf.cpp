@@ -22,150 +22,624 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
-#include <fstream>
-#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include <opensubdiv/far/primvarRefiner.h>
 #include <opensubdiv/far/stencilTableFactory.h>
 #include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#include <opensubdiv/osd/cpuPackedStencilTable.h>
+#include <opensubdiv/osd/cpuCompactStencilTable.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <opensubdiv/osd/ompEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <opensubdiv/osd/tbbEvaluator.h>
+#endif
 #include "../../regression/common/far_utils.h"
 // XXX: revisit the directory structure for examples/tests
 #include "../../examples/common/stopwatch.h"
 
 #include "init_shapes.h"
 
+using namespace OpenSubdiv;
+
 //------------------------------------------------------------------------------
+// Resident memory (in KB) : on Linux the peak is reset before each phase
+// through /proc/self/clear_refs, elsewhere only the peak of the process is
+// available (which may hide the peak of later phases).
+#if defined(__linux__)
+static long
+readProcStatus(char const * field) {
+
+    long value = 0;
+    if (FILE * f = fopen("/proc/self/status", "r")) {
+        char line[256];
+        size_t len = strlen(field);
+        while (fgets(line, sizeof(line), f)) {
+            if (strncmp(line, field, len) == 0) {
+                value = atol(line + len);
+                break;
+            }
+        }
+        fclose(f);
+    }
+    return value;
+}
+#endif
+
+static long
+getCurrentMemory() {
+#if defined(__linux__)
+    return readProcStatus("VmRSS:");
+#else
+    return 0;
+#endif
+}
+
+static long
+getPeakMemory() {
+#if defined(__linux__)
+    return readProcStatus("VmHWM:");
+#elif defined(_WIN32)
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #if defined(__APPLE__)
+        return usage.ru_maxrss / 1024;
+    #else
+        return usage.ru_maxrss;
+    #endif
+#endif
+}
+
 static void
-doPerf(const Shape *shape, int maxlevel, int endCapType)
-{
-    using namespace OpenSubdiv;
+resetPeakMemory() {
+#if defined(__linux__)
+    if (FILE * f = fopen("/proc/self/clear_refs", "w")) {
+        fputs("5", f);
+        fclose(f);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Samples collected for a timed phase over repeated runs
+struct Phase {
+
+    Phase(std::string const & n) : name(n), peakMemory(0) { }
+
+    void AddSample(double time, long memory) {
+        times.push_back(time);
+        peakMemory = std::max(peakMemory, memory);
+    }
+
+    // linear interpolation between the closest ranks
+    double GetPercentile(double p) const {
+        if (times.empty()) return 0.0;
+        std::vector<double> sorted(times);
+        std::sort(sorted.begin(), sorted.end());
+        double rank = p * (sorted.size()-1);
+        int i = (int)rank;
+        if (i+1 >= (int)sorted.size()) return sorted.back();
+        return sorted[i] + (rank - i) * (sorted[i+1] - sorted[i]);
+    }
+
+    std::string name;
+    std::vector<double> times;
+    long peakMemory;  // peak increase of resident memory in KB
+};
+
+class PhaseList {
+public:
+    Phase & operator[](std::string const & name) {
+        for (int i=0; i<(int)_phases.size(); ++i) {
+            if (_phases[i].name == name) return _phases[i];
+        }
+        _phases.push_back(Phase(name));
+        return _phases.back();
+    }
+    int size() const { return (int)_phases.size(); }
+    Phase const & operator[](int i) const { return _phases[i]; }
+private:
+    std::vector<Phase> _phases;
+};
+
+// Times a phase and the peak of memory it allocates
+class PhaseTimer {
+public:
+    PhaseTimer() : _memory(0) { }
+    void Start() {
+        resetPeakMemory();
+        _memory = getCurrentMemory();
+        _stopwatch.Start();
+    }
+    void Stop(Phase & phase) {
+        _stopwatch.Stop();
+        phase.AddSample(_stopwatch.GetElapsed(),
+                        std::max(0L, getPeakMemory() - _memory));
+    }
+private:
+    Stopwatch _stopwatch;
+    long _memory;
+};
+
+//------------------------------------------------------------------------------
+// Accumulates the time spent in each phase of the refinement of all levels
+struct RefinementTimer {
+
+    RefinementTimer() : current(-1) {
+        std::fill(elapsed, elapsed+NUM_PHASES, 0.0);
+    }
+
+    enum { NUM_PHASES = Far::TopologyRefiner::PHASE_END };
+
+    static char const * GetPhaseName(int phase) {
+        static char const * names[NUM_PHASES] = {
+            "refine.selection", "refine.mapping", "refine.tags",
+            "refine.topology", "refine.sharpness", "refine.fvar" };
+        return names[phase];
+    }
+
+    static void Notify(int /* level */, Far::TopologyRefiner::RefinementPhase phase,
+                       void * data) {
 
+        RefinementTimer * timer = static_cast<RefinementTimer *>(data);
+        if (timer->current >= 0) {
+            timer->stopwatch.Stop();
+            timer->elapsed[timer->current] += timer->stopwatch.GetElapsed();
+        }
+        timer->current = (phase == Far::TopologyRefiner::PHASE_END) ? -1 : phase;
+        if (timer->current >= 0) {
+            timer->stopwatch.Start();
+        }
+    }
+
+    Stopwatch stopwatch;
+    int current;
+    double elapsed[NUM_PHASES];
+};
+
+//------------------------------------------------------------------------------
+struct Config {
+    std::string shape;
+    bool adaptive;
+    int level;
+    int endCapType;
+};
+
+struct EvalResult {
+    std::string backend;
+    int width;
+    int numStencils;
+    Phase phase;
+
+    EvalResult() : phase("eval") { }
+};
+
+struct Result {
+    Config config;
+    PhaseList phases;
+    int numVertices,
+        numStencils,
+        numPatches;
+    std::vector<EvalResult> evals;
+};
+
+static char const *
+getEndCapName(int endCapType) {
+    switch (endCapType) {
+        case Far::PatchTableFactory::Options::ENDCAP_BSPLINE_BASIS:  return "bspline";
+        case Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS:  return "gregory";
+        case Far::PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY: return "legacy";
+        default: return "none";
+    }
+}
+
+//------------------------------------------------------------------------------
+// Evaluator throughput for a given backend and primvar width
+template <class EVALUATOR, class STENCIL_TABLE>
+static void
+doEvalPerf(char const * backend, STENCIL_TABLE const * table,
+           int numControlVertices, int numStencils, int width, int repeats,
+           std::vector<EvalResult> & results) {
+
+    Osd::CpuVertexBuffer * src = Osd::CpuVertexBuffer::Create(width, numControlVertices),
+                         * dst = Osd::CpuVertexBuffer::Create(width, numStencils);
+
+    std::vector<float> values(numControlVertices * width);
+    for (int i=0; i<(int)values.size(); ++i) {
+        values[i] = (float)(i % 17) * 0.1f;
+    }
+    src->UpdateData(&values[0], 0, numControlVertices);
+
+    Osd::BufferDescriptor srcDesc(0, width, width),
+                          dstDesc(0, width, width);
+
+    EvalResult result;
+    result.backend = backend;
+    result.width = width;
+    result.numStencils = numStencils;
+
+    PhaseTimer timer;
+    for (int i=0; i<repeats; ++i) {
+        timer.Start();
+        EVALUATOR::EvalStencils(src, srcDesc, dst, dstDesc, table);
+        timer.Stop(result.phase);
+    }
+    results.push_back(result);
+
+    delete src;
+    delete dst;
+}
+
+static void
+doEvalPerf(Far::StencilTable const * stencils, std::vector<int> const & widths,
+           int repeats, std::vector<EvalResult> & results) {
+
+    int numControlVertices = stencils->GetNumControlVertices(),
+        numStencils = stencils->GetNumStencils();
+    if (numStencils == 0) return;
+
+    Osd::CpuPackedStencilTable const * packed =
+        Osd::CpuPackedStencilTable::Create(stencils);
+    Osd::CpuCompactStencilTable const * compact =
+        Osd::CpuCompactStencilTable::Create(stencils);
+
+    for (int i=0; i<(int)widths.size(); ++i) {
+        int width = widths[i];
+        doEvalPerf<Osd::CpuEvaluator>("cpu", stencils,
+            numControlVertices, numStencils, width, repeats, results);
+        doEvalPerf<Osd::CpuEvaluator>("cpu_packed", packed,
+            numControlVertices, numStencils, width, repeats, results);
+        doEvalPerf<Osd::CpuEvaluator>("cpu_compact", compact,
+            numControlVertices, numStencils, width, repeats, results);
+#ifdef OPENSUBDIV_HAS_OPENMP
+        doEvalPerf<Osd::OmpEvaluator>("omp", stencils,
+            numControlVertices, numStencils, width, repeats, results);
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+        doEvalPerf<Osd::TbbEvaluator>("tbb", stencils,
+            numControlVertices, numStencils, width, repeats, results);
+#endif
+    }
+    delete packed;
+    delete compact;
+}
+
+//------------------------------------------------------------------------------
+static void
+doPerf(const Shape *shape, Config const & config, int repeats,
+       std::vector<int> const & widths, Result & result)
+{
     Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
 
     Sdc::Options sdcOptions;
     sdcOptions.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
 
-    Stopwatch s;
+    result.config = config;
 
-    // ----------------------------------------------------------------------
-    // Instantiate a FarTopologyRefiner from the descriptor and refine
-    s.Start();
-    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
-        *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
-    {
-        Far::TopologyRefiner::AdaptiveOptions options(maxlevel);
-        refiner->RefineAdaptive(options);
-    }
-
-    s.Stop();
-    double timeRefine = s.GetElapsed();
+    PhaseList & phases = result.phases;
+    PhaseTimer timer;
 
-    // ----------------------------------------------------------------------
-    // Create stencil table
-    s.Start();
     Far::StencilTable const * vertexStencils = NULL;
-    {
-        Far::StencilTableFactory::Options options;
-        vertexStencils = Far::StencilTableFactory::Create(*refiner, options);
+
+    for (int run = 0; run < repeats; ++run) {
+
+        delete vertexStencils;
+
+        // ------------------------------------------------------------------
+        // Instantiate a FarTopologyRefiner from the descriptor and refine
+        RefinementTimer refinementTimer;
+
+        timer.Start();
+        Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
+            *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+        timer.Stop(phases["create"]);
+
+        timer.Start();
+        if (config.adaptive) {
+            Far::TopologyRefiner::AdaptiveOptions options(config.level);
+            options.phaseCallback = RefinementTimer::Notify;
+            options.phaseCallbackData = &refinementTimer;
+            refiner->RefineAdaptive(options);
+        } else {
+            Far::TopologyRefiner::UniformOptions options(config.level);
+            options.phaseCallback = RefinementTimer::Notify;
+            options.phaseCallbackData = &refinementTimer;
+            refiner->RefineUniform(options);
+        }
+        timer.Stop(phases["refine"]);
+
+        for (int i = config.adaptive ? 0 : 1; i < RefinementTimer::NUM_PHASES; ++i) {
+            phases[RefinementTimer::GetPhaseName(i)].AddSample(
+                refinementTimer.elapsed[i], 0);
+        }
+
+        // ------------------------------------------------------------------
+        // Create stencil table
+        timer.Start();
+        {
+            Far::StencilTableFactory::Options options;
+            vertexStencils = Far::StencilTableFactory::Create(*refiner, options);
+        }
+        timer.Stop(phases["stencils"]);
+
+        // ------------------------------------------------------------------
+        // Create patch table
+        timer.Start();
+        Far::PatchTable const * patchTable = NULL;
+        {
+            Far::PatchTableFactory::Options poptions(config.level);
+            if (config.adaptive) {
+                poptions.SetEndCapType(
+                    (Far::PatchTableFactory::Options::EndCapType)config.endCapType);
+            }
+            patchTable = Far::PatchTableFactory::Create(*refiner, poptions);
+        }
+        timer.Stop(phases["patches"]);
+
+        // ------------------------------------------------------------------
+        // append local points to stencils
+        if (config.adaptive) {
+            timer.Start();
+            if (Far::StencilTable const *vertexStencilsWithLocalPoints =
+                Far::StencilTableFactory::AppendLocalPointStencilTable(
+                    *refiner, vertexStencils,
+                    patchTable->GetLocalPointStencilTable())) {
+                delete vertexStencils;
+                vertexStencils = vertexStencilsWithLocalPoints;
+            }
+            timer.Stop(phases["append"]);
+        }
+
+        result.numVertices = refiner->GetNumVerticesTotal();
+        result.numStencils = vertexStencils->GetNumStencils();
+        result.numPatches = patchTable->GetNumPatchesTotal();
+
+        delete refiner;
+        delete patchTable;
     }
-    s.Stop();
-    double timeCreateStencil = s.GetElapsed();
 
     // ----------------------------------------------------------------------
-    // Create patch table
-    s.Start();
-    Far::PatchTable const * patchTable = NULL;
-    {
-        Far::PatchTableFactory::Options poptions(maxlevel);
-        poptions.SetEndCapType((Far::PatchTableFactory::Options::EndCapType)endCapType);
-        patchTable = Far::PatchTableFactory::Create(*refiner, poptions);
+    // Evaluator throughput
+    doEvalPerf(vertexStencils, widths, repeats, result.evals);
+
+    delete vertexStencils;
+}
+
+//------------------------------------------------------------------------------
+static void
+printResult(Result const & result) {
+
+    Config const & config = result.config;
+
+    printf("---- %s, %s level %d", config.shape.c_str(),
+        config.adaptive ? "adaptive" : "uniform", config.level);
+    if (config.adaptive) {
+        printf(", %s end caps", getEndCapName(config.endCapType));
     }
+    printf(" ----\n");
+    printf("%-20s %10s %10s %10s %10s\n", "phase", "median", "p10", "p90", "peak KB");
 
-    s.Stop();
-    double timeCreatePatch = s.GetElapsed();
+    for (int i=0; i<result.phases.size(); ++i) {
+        Phase const & phase = result.phases[i];
+        printf("%-20s %10.6f %10.6f %10.6f %10ld\n", phase.name.c_str(),
+            phase.GetPercentile(0.5), phase.GetPercentile(0.1),
+            phase.GetPercentile(0.9), phase.peakMemory);
+    }
+    for (int i=0; i<(int)result.evals.size(); ++i) {
+        EvalResult const & eval = result.evals[i];
+        double median = eval.phase.GetPercentile(0.5);
+        printf("eval %-11s w=%-3d %10.6f %14.0f verts/s\n", eval.backend.c_str(),
+            eval.width, median, median > 0 ? eval.numStencils / median : 0.0);
+    }
+}
 
-    // ----------------------------------------------------------------------
-    // append local points to stencils
-    s.Start();
-    {
-        if (Far::StencilTable const *vertexStencilsWithLocalPoints =
-            Far::StencilTableFactory::AppendLocalPointStencilTable(
-                *refiner, vertexStencils,
-                patchTable->GetLocalPointStencilTable())) {
-            delete vertexStencils;
-            vertexStencils = vertexStencilsWithLocalPoints;
-        }
-    }
-    s.Stop();
-    double timeAppendStencil = s.GetElapsed();
-
-    // ---------------------------------------------------------------------
-    double timeTotal = s.GetTotalElapsed();
-
-    printf("TopologyRefiner::Refine     %f %5.2f%%\n",
-           timeRefine, timeRefine/timeTotal*100);
-    printf("StencilTableFactory::Create %f %5.2f%%\n",
-           timeCreateStencil, timeCreateStencil/timeTotal*100);
-    printf("PatchTableFactory::Create   %f %5.2f%%\n",
-           timeCreatePatch, timeCreatePatch/timeTotal*100);
-    printf("StencilTableFactory::Append %f %5.2f%%\n",
-           timeAppendStencil, timeAppendStencil/timeTotal*100);
-    printf("Total                       %f\n", timeTotal);
+static void
+writePhaseJSON(FILE * f, Phase const & phase, char const * indent) {
+
+    fprintf(f, "%s\"median\": %g, \"p10\": %g, \"p90\": %g, \"min\": %g, \"max\": %g, "
+        "\"samples\": %d", indent,
+        phase.GetPercentile(0.5), phase.GetPercentile(0.1), phase.GetPercentile(0.9),
+        phase.GetPercentile(0.0), phase.GetPercentile(1.0), (int)phase.times.size());
+}
+
+static bool
+writeJSON(char const * filename, std::vector<Result> const & results, int repeats) {
+
+    FILE * f = fopen(filename, "w");
+    if (not f) {
+        printf("Cannot write %s\n", filename);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"benchmark\": \"far_perf\",\n  \"repeats\": %d,\n", repeats);
+    fprintf(f, "  \"results\": [\n");
+    for (int i=0; i<(int)results.size(); ++i) {
+        Result const & r = results[i];
+
+        fprintf(f, "    {\n");
+        fprintf(f, "      \"shape\": \"%s\",\n", r.config.shape.c_str());
+        fprintf(f, "      \"mode\": \"%s\",\n", r.config.adaptive ? "adaptive" : "uniform");
+        fprintf(f, "      \"level\": %d,\n", r.config.level);
+        fprintf(f, "      \"endcap\": \"%s\",\n",
+            r.config.adaptive ? getEndCapName(r.config.endCapType) : "none");
+        fprintf(f, "      \"counts\": { \"vertices\": %d, \"stencils\": %d, \"patches\": %d },\n",
+            r.numVertices, r.numStencils, r.numPatches);
+
+        fprintf(f, "      \"phases\": {\n");
+        for (int j=0; j<r.phases.size(); ++j) {
+            Phase const & phase = r.phases[j];
+            fprintf(f, "        \"%s\": { ", phase.name.c_str());
+            writePhaseJSON(f, phase, "");
+            fprintf(f, ", \"peak_memory_kb\": %ld }%s\n", phase.peakMemory,
+                (j+1 < r.phases.size()) ? "," : "");
+        }
+        fprintf(f, "      },\n");
+
+        fprintf(f, "      \"eval\": [\n");
+        for (int j=0; j<(int)r.evals.size(); ++j) {
+            EvalResult const & eval = r.evals[j];
+            double median = eval.phase.GetPercentile(0.5);
+            fprintf(f, "        { \"backend\": \"%s\", \"width\": %d, ",
+                eval.backend.c_str(), eval.width);
+            writePhaseJSON(f, eval.phase, "");
+            fprintf(f, ", \"verts_per_sec\": %g }%s\n",
+                median > 0 ? eval.numStencils / median : 0.0,
+                (j+1 < (int)r.evals.size()) ? "," : "");
+        }
+        fprintf(f, "      ]\n");
+        fprintf(f, "    }%s\n", (i+1 < (int)results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
 }
 
 //------------------------------------------------------------------------------
+static void
+usage(char const * program) {
+
+    printf("Usage: %s [options] [file.obj|file.shp ...]\n", program);
+    printf("  -l <level>     maximum isolation level of adaptive refinement (default 8)\n");
+    printf("  -ul <level>    maximum level of uniform refinement (default 3)\n");
+    printf("  -m <mode>      uniform, adaptive or all (default all)\n");
+    printf("  -e <endcap>    bspline, gregory, legacy or all (default all)\n");
+    printf("  -r <repeats>   number of runs of each configuration (default 5)\n");
+    printf("  -w <widths>    comma separated primvar widths evaluated (default 3,4,8)\n");
+    printf("  -json <file>   write the results in JSON format\n");
+}
+
 int main(int argc, char **argv)
 {
-    using namespace OpenSubdiv;
-
-    int maxlevel = 8;
-    std::string str;
-    int endCapType = Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+    int maxlevel = 8,
+        maxUniformLevel = 3,
+        repeats = 5;
+    bool uniform = true,
+         adaptive = true;
+    char const * jsonFile = 0;
+    std::vector<int> endCapTypes, widths;
 
     for (int i = 1; i < argc; ++i) {
-        if (strstr(argv[i], ".obj")) {
-            std::ifstream ifs(argv[i]);
-            if (ifs) {
-                std::stringstream ss;
-                ss << ifs.rdbuf();
-                ifs.close();
-                str = ss.str();
-                g_shapes.push_back(ShapeDesc(argv[i], str.c_str(), kCatmark));
-            }
+        if (strstr(argv[i], ".obj") or strstr(argv[i], ".shp")) {
+            // the file is read when its shape is measured (binary shapes
+            // hold their own scheme)
+            g_shapes.push_back(ShapeDesc(argv[i], "", kCatmark));
         }
-        else if (!strcmp(argv[i], "-l")) {
+        else if (!strcmp(argv[i], "-l") and i+1 < argc) {
             maxlevel = atoi(argv[++i]);
         }
-        else if (!strcmp(argv[i], "-e")) {
+        else if (!strcmp(argv[i], "-ul") and i+1 < argc) {
+            maxUniformLevel = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-r") and i+1 < argc) {
+            repeats = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-json") and i+1 < argc) {
+            jsonFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-m") and i+1 < argc) {
+            const char *mode = argv[++i];
+            uniform = !strcmp(mode, "uniform") or !strcmp(mode, "all");
+            adaptive = !strcmp(mode, "adaptive") or !strcmp(mode, "all");
+            if (not uniform and not adaptive) {
+                printf("Unknown mode %s\n", mode);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-w") and i+1 < argc) {
+            for (char const * w = argv[++i]; w; w = strchr(w, ',')) {
+                if (*w == ',') ++w;
+                if (atoi(w) > 0) widths.push_back(atoi(w));
+            }
+        }
+        else if (!strcmp(argv[i], "-e") and i+1 < argc) {
             const char *type = argv[++i];
             if (!strcmp(type, "bspline")) {
-                endCapType = Far::PatchTableFactory::Options::ENDCAP_BSPLINE_BASIS;
+                endCapTypes.push_back(Far::PatchTableFactory::Options::ENDCAP_BSPLINE_BASIS);
             } else if (!strcmp(type, "gregory")) {
-                endCapType = Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
-            } else {
+                endCapTypes.push_back(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+            } else if (!strcmp(type, "legacy")) {
+                endCapTypes.push_back(Far::PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
+            } else if (strcmp(type, "all")) {
                 printf("Unknown endcap type %s\n", type);
                 return 1;
             }
         }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
     }
 
     if (g_shapes.empty()) {
         initShapes();
     }
+    if (endCapTypes.empty()) {
+        endCapTypes.push_back(Far::PatchTableFactory::Options::ENDCAP_BSPLINE_BASIS);
+        endCapTypes.push_back(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        endCapTypes.push_back(Far::PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
+    }
+    if (widths.empty()) {
+        widths.push_back(3);
+        widths.push_back(4);
+        widths.push_back(8);
+    }
+
+    std::vector<Result> results;
 
     for (int i = 0; i < (int)g_shapes.size(); ++i) {
-        Shape const * shape = Shape::parseObj(
-            g_shapes[i].data.c_str(),
-            g_shapes[i].scheme,
-            g_shapes[i].isLeftHanded);
+        Shape const * shape = g_shapes[i].data.empty() ?
+            Shape::readFile(g_shapes[i].name.c_str(),
+                g_shapes[i].scheme, g_shapes[i].isLeftHanded) :
+            Shape::parseObj(g_shapes[i].data.c_str(),
+                g_shapes[i].scheme, g_shapes[i].isLeftHanded);
+        if (not shape) {
+            printf("Failed to read %s\n", g_shapes[i].name.c_str());
+            continue;
+        }
 
-        for (int lv = 1; lv <= maxlevel; ++lv) {
-            printf("---- %s, level %d ----\n", g_shapes[i].name.c_str(), lv);
-            doPerf(shape, lv, endCapType);
+        Config config;
+        config.shape = g_shapes[i].name;
+
+        if (uniform) {
+            config.adaptive = false;
+            config.endCapType = Far::PatchTableFactory::Options::ENDCAP_NONE;
+            for (int lv = 1; lv <= maxUniformLevel; ++lv) {
+                config.level = lv;
+                results.push_back(Result());
+                doPerf(shape, config, repeats, widths, results.back());
+                printResult(results.back());
+            }
         }
+        if (adaptive) {
+            config.adaptive = true;
+            for (int e = 0; e < (int)endCapTypes.size(); ++e) {
+                config.endCapType = endCapTypes[e];
+                for (int lv = 1; lv <= maxlevel; ++lv) {
+                    config.level = lv;
+                    results.push_back(Result());
+                    doPerf(shape, config, repeats, widths, results.back());
+                    printResult(results.back());
+                }
+            }
+        }
+        delete shape;
+    }
+
+    if (jsonFile and not writeJSON(jsonFile, results, repeats)) {
+        return 1;
     }
+    return 0;
 }
 
 //------------------------------------------------------------------------------
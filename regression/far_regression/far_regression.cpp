@@ -22,13 +22,23 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
 
+#include <far/hierarchicalEdits.h>
+#include <far/stencilTableFactory.h>
+#include <far/taskScheduler.h>
 
 #include "../../regression/common/hbr_utils.h"
 #include "../../regression/common/far_utils.h"
 #include "../../regression/common/cmp_utils.h"
+#include "../../regression/common/case_utils.h"
 
 #include "init_shapes.h"
 
@@ -47,6 +57,8 @@
 
 static bool g_debugmode = false;
 
+static RegressionCases g_cases;
+
 //------------------------------------------------------------------------------
 // Vertex class implementation
 struct xyzVV {
@@ -223,7 +235,254 @@ checkMesh(ShapeDesc const & desc, int maxlevel) {
 }
 
 //------------------------------------------------------------------------------
-int main(int /* argc */, char ** /* argv */) {
+// Scheduler applying ranges in reverse order to expose any order dependency
+class ReverseTaskScheduler : public OpenSubdiv::Far::TaskScheduler {
+public:
+    virtual void ParallelFor(int begin, int end, int grainSize,
+                             RangeKernel kernel, void * data) const {
+        for (int i=end; i>begin; i-=grainSize) {
+            kernel(std::max(begin, i-grainSize), i, data);
+        }
+    }
+    virtual int GetNumThreads() const { return 4; }
+};
+
+// Precision of the vertices interpolated by stencils accumulating their
+// weights in a different order
+#define SUMMATION_PRECISION 1e-5
+
+//------------------------------------------------------------------------------
+// Hierarchical edits of the tags of a shape (edits of positions only, as in
+// hbr_utils.h) -- the values of the vertex edits are appended to 'values'
+static void
+getHierarchicalEdits(Shape const & shape,
+                     OpenSubdiv::Far::HierarchicalEdits & edits,
+                     std::vector<xyzVV> & values) {
+
+    typedef OpenSubdiv::Far::HierarchicalEdits FarEdits;
+    typedef OpenSubdiv::Far::LocalIndex        FarLocalIndex;
+
+    for (int i=0; i<(int)shape.tags.size(); ++i) {
+        Shape::tag const & t = *shape.tags[i];
+
+        bool faceEdit = (t.name=="faceedit"),
+             vertexEdit = (t.name=="vertexedit"),
+             edgeEdit = (t.name=="edgeedit");
+        if (not (faceEdit or vertexEdit or edgeEdit)) continue;
+
+        FarEdits::Operation op = FarEdits::SET;
+        bool sharpness = false;
+        if (not faceEdit) {
+            if (t.stringargs[0]=="add") op = FarEdits::ADD;
+            if (t.stringargs[0]=="subtract") op = FarEdits::SUBTRACT;
+            sharpness = (t.stringargs[2]=="sharpness");
+        }
+
+        // paths : length, base face, child faces [, vertex or edge]
+        for (int k=0, f=0; k<(int)t.intargs.size(); k+=t.intargs[k]+1) {
+            int pathlength = t.intargs[k],
+                face = t.intargs[k+1];
+
+            std::vector<FarLocalIndex> subfaces(t.intargs.begin()+k+2,
+                t.intargs.begin()+k+pathlength+(faceEdit ? 1 : 0));
+            FarLocalIndex const * path = subfaces.empty() ? 0 : &subfaces[0];
+            int npath = (int)subfaces.size();
+
+            if (faceEdit) {
+                edits.AddHoleEdit(face, npath, path);
+                continue;
+            }
+
+            FarLocalIndex component = (FarLocalIndex)t.intargs[k+pathlength];
+            if (sharpness) {
+                float value = t.floatargs[f++];
+                if (vertexEdit) {
+                    edits.AddVertexSharpnessEdit(face, npath, path, component, op, value);
+                } else {
+                    edits.AddEdgeSharpnessEdit(face, npath, path, component, op, value);
+                }
+            } else {
+                edits.AddVertexEdit(face, npath, path, component, op);
+                values.push_back(xyzVV(t.floatargs[f], t.floatargs[f+1], t.floatargs[f+2]));
+                f += 3;
+            }
+        }
+    }
+}
+
+// Hierarchical edits applied by the Far refiner must match those of Hbr, both
+// when applied to primvar data and when folded into stencils
+static int
+checkHierarchicalEdits(ShapeDesc const & desc, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    printf("- %-25s ( edits    ): \n", desc.name.c_str());
+
+    Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme);
+
+    // face-varying channels do not support sharpness edits
+    shape->uvs.clear();
+    shape->faceuvs.clear();
+
+    OpenSubdiv::Far::HierarchicalEdits edits;
+    std::vector<xyzVV> editValues;
+    getHierarchicalEdits(*shape, edits, editValues);
+
+    FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(*shape,
+        FarTopologyRefinerFactory::Options(GetSdcType(*shape), GetSdcOptions(*shape)));
+    refiner->SetHierarchicalEdits(edits);
+
+    FarTopologyRefiner::UniformOptions options(maxlevel);
+    options.fullTopologyInLastLevel = true;
+    refiner->RefineUniform(options);
+
+    int nbase = refiner->GetLevel(0).GetNumVertices(),
+        nverts = refiner->GetNumVerticesTotal();
+
+    // primvar data edited after the interpolation of each level
+    std::vector<xyzVV> farVertexData(nverts);
+    for (int i=0; i<nbase; ++i) {
+        farVertexData[i].SetPosition(shape->verts[i*3+0],
+                                     shape->verts[i*3+1],
+                                     shape->verts[i*3+2]);
+    }
+
+    OpenSubdiv::Far::PrimvarRefiner primvarRefiner(*refiner);
+
+    xyzVV * src = &farVertexData[0],
+          * dst = src + nbase;
+    for (int level=1; level<=maxlevel; ++level) {
+        primvarRefiner.Interpolate(level, src, dst);
+        primvarRefiner.ApplyVertexEdits(level, editValues, dst);
+        src = dst;
+        dst += refiner->GetLevel(level).GetNumVertices();
+    }
+
+    // Hbr does not refine holes : each hole edit must instead make a refined
+    // face a hole, inherited by its descendants
+    int count=0;
+    if (refiner->HasHoles()) {
+        int nholeEdits = 0, nholes = 0;
+        for (int i=0; i<edits.GetNumEdits(); ++i) {
+            nholeEdits += (edits.GetEditType(i)==OpenSubdiv::Far::HierarchicalEdits::HOLE);
+        }
+        for (int level=1; level<=maxlevel; ++level) {
+            OpenSubdiv::Far::TopologyLevel const & parent = refiner->GetLevel(level-1),
+                                                 & child = refiner->GetLevel(level);
+            for (int f=0; f<child.GetNumFaces(); ++f) {
+                bool parentHole = parent.IsFaceHole(child.GetFaceParentFace(f));
+                if (parentHole and not child.IsFaceHole(f)) ++count;
+                nholes += child.IsFaceHole(f) and not parentHole;
+            }
+        }
+        if (nholes!=nholeEdits) {
+            printf("// edited holes fail : %d holes for %d edits\n", nholes, nholeEdits);
+            ++count;
+        }
+        delete refiner;
+        delete shape;
+        return count;
+    }
+
+    Hmesh * hmesh = interpolateHbrVertexData<xyzVV>(
+        desc.data.c_str(), desc.scheme, maxlevel);
+
+    std::vector<xyzVV> hbrVertexData;
+    GetReorderedHbrVertexData(*refiner, *hmesh, &hbrVertexData);
+
+    for (int i=0; i<nverts; ++i) {
+        int nfails=0;
+        for (int k=0; k<3; ++k) {
+            if (std::abs(hbrVertexData[i].GetPos()[k]-farVertexData[i].GetPos()[k]) >
+                PRECISION) ++nfails;
+        }
+        if (nfails) {
+            printf("// edited vertex %d fails\n", i);
+            ++count;
+        }
+    }
+
+    // stencils, with the edit values following the control vertices
+    std::vector<xyzVV> controlValues(farVertexData.begin(), farVertexData.begin()+nbase);
+    controlValues.insert(controlValues.end(), editValues.begin(), editValues.end());
+
+    ReverseTaskScheduler scheduler;
+    for (int concurrent=0; concurrent<2; ++concurrent) {
+        FarStencilTableFactory::Options stencilOptions;
+        stencilOptions.taskScheduler = concurrent ? &scheduler : 0;
+
+        FarStencilTable const * stencils =
+            FarStencilTableFactory::Create(*refiner, stencilOptions);
+
+        if (stencils->GetNumControlVertices() != (int)controlValues.size() or
+            stencils->GetNumStencils() != nverts-nbase) {
+            printf("// edited stencils fail : %d control vertices, %d stencils\n",
+                stencils->GetNumControlVertices(), stencils->GetNumStencils());
+            ++count;
+        } else {
+            std::vector<xyzVV> values(nverts-nbase);
+            stencils->UpdateValues(&controlValues[0], &values[0]);
+
+            for (int i=0; i<nverts-nbase; ++i) {
+                int nfails=0;
+                for (int k=0; k<3; ++k) {
+                    if (std::abs(values[i].GetPos()[k]-farVertexData[nbase+i].GetPos()[k]) >
+                        SUMMATION_PRECISION) ++nfails;
+                }
+                if (nfails) {
+                    printf("// edited stencil %d fails\n", i);
+                    ++count;
+                }
+            }
+        }
+        delete stencils;
+    }
+
+    delete hmesh;
+    delete refiner;
+    delete shape;
+    return count;
+}
+
+
+//------------------------------------------------------------------------------
+static void
+usage(char ** argv) {
+    printf("%s [<options>]\n\n", argv[0]);
+    printf("    Options :\n");
+
+    RegressionCases::PrintUsage();
+
+    printf("        -help / -h\n");
+    printf("        Displays usage information.\n");
+}
+
+//------------------------------------------------------------------------------
+static void
+parseArgs(int argc, char ** argv) {
+
+    for (int argi=1; argi<argc; ++argi) {
+        if (g_cases.ParseArg(argc, argv, argi)) {
+            continue;
+        } else if ((not strcmp(argv[argi],"-help")) or
+                   (not strcmp(argv[argi],"-h"))) {
+            usage(argv);
+            exit(0);
+        } else {
+            usage(argv);
+            exit(1);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+
+    // Shapes are independent cases : '-partition <k> <n>' runs a subset of
+    // them, so that the partitions of the target can run concurrently.
+    parseArgs(argc, argv);
 
     int levels=5, total=0;
 
@@ -234,17 +493,33 @@ int main(int /* argc */, char ** /* argv */) {
     else
         printf("precision : %f\n",PRECISION);
     for (int i=0; i<(int)g_shapes.size(); ++i) {
-        total+=checkMesh(g_shapes[i], levels);
+        if (not g_cases.Begin()) continue;
+
+        int failures=checkMesh(g_shapes[i], levels);
+
+        g_cases.End(g_shapes[i].name, failures);
+        total+=failures;
+    }
+    for (int i=0; i<(int)g_editShapes.size(); ++i) {
+        if (not g_cases.Begin()) continue;
+
+        int failures=checkHierarchicalEdits(g_editShapes[i], levels);
+
+        g_cases.End(g_editShapes[i].name + " (edits)", failures);
+        total+=failures;
     }
 
     if (g_debugmode)
         printf("]\n");
     else {
+        g_cases.PrintReport();
+
         if (total==0)
           printf("All tests passed.\n");
         else
           printf("Total failures : %d\n", total);
     }
+    return (total==0) ? 0 : 1;
 }
 
 //------------------------------------------------------------------------------
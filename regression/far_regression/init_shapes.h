@@ -38,6 +38,9 @@ struct ShapeDesc {
 
 static std::vector<ShapeDesc> g_shapes;
 
+// Shapes with hierarchical edits (only compared to Hbr with the edits applied)
+static std::vector<ShapeDesc> g_editShapes;
+
 #include "../shapes/bilinear_cube.h"
 
 #include "../shapes/catmark_chaikin0.h"
@@ -74,6 +77,7 @@ static std::vector<ShapeDesc> g_shapes;
 #include "../shapes/catmark_square_hedit1.h"
 #include "../shapes/catmark_square_hedit2.h"
 #include "../shapes/catmark_square_hedit3.h"
+#include "../shapes/catmark_square_hedit4.h"
 #include "../shapes/catmark_tent_creases0.h"
 #include "../shapes/catmark_tent_creases1.h"
 #include "../shapes/catmark_tent.h"
@@ -126,10 +130,6 @@ static void initShapes() {
     g_shapes.push_back( ShapeDesc("catmark_pyramid_creases0", catmark_pyramid_creases0, kCatmark ) );
     g_shapes.push_back( ShapeDesc("catmark_pyramid_creases1", catmark_pyramid_creases1, kCatmark ) );
     g_shapes.push_back( ShapeDesc("catmark_pyramid",          catmark_pyramid,          kCatmark ) );
-//    g_shapes.push_back( ShapeDesc("catmark_square_hedit0",    catmark_square_hedit0,    kCatmark ) );
-//    g_shapes.push_back( ShapeDesc("catmark_square_hedit1",    catmark_square_hedit1,    kCatmark ) );
-//    g_shapes.push_back( ShapeDesc("catmark_square_hedit2",    catmark_square_hedit2,    kCatmark ) );
-//    g_shapes.push_back( ShapeDesc("catmark_square_hedit3",    catmark_square_hedit3,    kCatmark ) );
     g_shapes.push_back( ShapeDesc("catmark_tent_creases0",    catmark_tent_creases0,    kCatmark ) );
     g_shapes.push_back( ShapeDesc("catmark_tent_creases1",    catmark_tent_creases1 ,   kCatmark ) );
     g_shapes.push_back( ShapeDesc("catmark_tent",             catmark_tent,             kCatmark ) );
@@ -151,5 +151,11 @@ static void initShapes() {
     g_shapes.push_back( ShapeDesc("loop_triangle_edgeonly",   loop_triangle_edgeonly,   kLoop ) );
 //    g_shapes.push_back( ShapeDesc("loop_chaikin0",            loop_chaikin0,            kLoop ) );
 //    g_shapes.push_back( ShapeDesc("loop_chaikin1",            loop_chaikin1,            kLoop ) );
+
+    g_editShapes.push_back( ShapeDesc("catmark_square_hedit0",    catmark_square_hedit0,    kCatmark ) );
+    g_editShapes.push_back( ShapeDesc("catmark_square_hedit1",    catmark_square_hedit1,    kCatmark ) );
+    g_editShapes.push_back( ShapeDesc("catmark_square_hedit2",    catmark_square_hedit2,    kCatmark ) );
+    g_editShapes.push_back( ShapeDesc("catmark_square_hedit3",    catmark_square_hedit3,    kCatmark ) );
+    g_editShapes.push_back( ShapeDesc("catmark_square_hedit4",    catmark_square_hedit4,    kCatmark ) );
 }
 //------------------------------------------------------------------------------
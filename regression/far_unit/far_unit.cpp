@@ -0,0 +1,7343 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+#include <far/buildMonitor.h>
+#include <far/faceLevelTableFactory.h>
+#include <far/hierarchicalEdits.h>
+#include <far/incrementalRefiner.h>
+#include <far/limitSurfaceQuery.h>
+#include <far/memoryResource.h>
+#include <far/meshletTableFactory.h>
+#include <far/patchBVH.h>
+#include <far/patchMap.h>
+#include <far/patchProvider.h>
+#include <far/patchTableFactory.h>
+#include <far/primvarBuffers.h>
+#include <far/profile.h>
+#include <far/ptexIndices.h>
+#include <far/stencilReverseIndex.h>
+#include <far/stencilTableFactory.h>
+#include <far/streamingRefiner.h>
+#include <far/tableSerializer.h>
+#include <far/taskScheduler.h>
+#include <far/topologyBatchFactory.h>
+#include <far/topologyCache.h>
+#include <far/topologyDescriptor.h>
+#include <far/topologyFingerprint.h>
+#include <far/variableLevelMeshFactory.h>
+
+#include "../../regression/common/far_utils.h"
+#include "../../regression/common/case_utils.h"
+
+#include "../far_regression/init_shapes.h"
+
+//
+// Unit checks of the Far refiners and tables, run on each regression shape.
+//
+// Notes:
+// - unlike far_regression, which matches Far to Hbr, these checks compare
+//   Far to itself : tables built concurrently, serialized, reordered, etc.
+//
+// - the setup of a shape is shared by its checks (see ShapeFixture).
+//
+// - precision is currently held at 1e-6
+//
+#define PRECISION 1e-6
+
+static RegressionCases g_cases;
+
+//------------------------------------------------------------------------------
+// Vertex class implementation
+struct xyzVV {
+
+    xyzVV() { /* _pos[0]=_pos[1]=_pos[2]=0.0f; */ }
+
+    xyzVV( int /*i*/ ) { }
+
+    xyzVV( float x, float y, float z ) { _pos[0]=x; _pos[1]=y; _pos[2]=z; }
+
+    void AddWithWeight(const xyzVV& src, float weight) {
+        _pos[0]+=weight*src._pos[0];
+        _pos[1]+=weight*src._pos[1];
+        _pos[2]+=weight*src._pos[2];
+    }
+
+    void AddVaryingWithWeight(const xyzVV& , float) { }
+
+    void Clear( void * =0 ) { _pos[0]=_pos[1]=_pos[2]=0.0f; }
+
+    void SetPosition(float x, float y, float z) { _pos[0]=x; _pos[1]=y; _pos[2]=z; }
+
+    const float * GetPos() const { return _pos; }
+
+    bool operator==(xyzVV const & other) const {
+        if (_pos[0]==other._pos[0] and
+            _pos[1]==other._pos[1] and
+            _pos[2]==other._pos[2]) {
+            return true;
+        }
+        return false;
+    }
+
+private:
+    float _pos[3];
+};
+
+//------------------------------------------------------------------------------
+typedef OpenSubdiv::Far::TopologyRefiner               FarTopologyRefiner;
+typedef OpenSubdiv::Far::TopologyRefinerFactory<Shape> FarTopologyRefinerFactory;
+
+//------------------------------------------------------------------------------
+// Setup shared by the checks of a shape : the shape is parsed once, and each
+// refinement is computed on first request and then reused by every check
+// that only reads it. Checks updating the shape or a refiner (sharpness,
+// face-varying channels, sparse refinement...) create their own.
+class ShapeFixture {
+public:
+    explicit ShapeFixture(ShapeDesc const & desc) :
+        _desc(desc),
+        _shape(Shape::parseObj(desc.data.c_str(), desc.scheme)),
+        _shapeWithoutFVar(0) { }
+
+    ~ShapeFixture() {
+        for (StencilTableMap::iterator it=_stencilTables.begin();
+                it!=_stencilTables.end(); ++it) {
+            delete it->second;
+        }
+        for (RefinerMap::iterator it=_refiners.begin(); it!=_refiners.end(); ++it) {
+            delete it->second;
+        }
+        delete _shapeWithoutFVar;
+        delete _shape;
+    }
+
+    ShapeDesc const & GetDesc() const { return _desc; }
+
+    Shape const & GetShape() const { return *_shape; }
+
+    // The shape without its face-varying channels (which do not support
+    // sharpness updates)
+    Shape const & GetShapeWithoutFVar() {
+        if (not _shapeWithoutFVar) {
+            _shapeWithoutFVar = Shape::parseObj(_desc.data.c_str(), _desc.scheme);
+            _shapeWithoutFVar->uvs.clear();
+            _shapeWithoutFVar->faceuvs.clear();
+        }
+        return *_shapeWithoutFVar;
+    }
+
+    FarTopologyRefinerFactory::Options GetRefinerOptions() const {
+        return FarTopologyRefinerFactory::Options(GetSdcType(*_shape), GetSdcOptions(*_shape));
+    }
+
+    // Returns a new unrefined refiner of the shape, owned by the caller
+    FarTopologyRefiner * CreateRefiner() const {
+        return FarTopologyRefinerFactory::Create(*_shape, GetRefinerOptions());
+    }
+
+    // Shared refiners, owned by the fixture : the unrefined base level first
+    FarTopologyRefiner const & GetBaseRefiner() {
+        return getRefiner(BASE, 0);
+    }
+
+    FarTopologyRefiner const & GetUniformRefiner(int maxlevel) {
+        return getRefiner(UNIFORM, maxlevel);
+    }
+
+    // Uniform refinement with the full topology of the last level
+    FarTopologyRefiner const & GetFullTopologyRefiner(int maxlevel) {
+        return getRefiner(FULL_TOPOLOGY, maxlevel);
+    }
+
+    FarTopologyRefiner const & GetAdaptiveRefiner(int maxlevel) {
+        return getRefiner(ADAPTIVE, maxlevel);
+    }
+
+    // Adaptive refinement isolating single crease patches
+    FarTopologyRefiner const & GetSingleCreaseRefiner(int maxlevel) {
+        return getRefiner(SINGLE_CREASE, maxlevel);
+    }
+
+    // Adaptive refinement of Catmark shapes, uniform refinement of the others
+    FarTopologyRefiner const & GetDefaultRefiner(int maxlevel) {
+        return (_desc.scheme==kCatmark) ?
+            GetAdaptiveRefiner(maxlevel) : GetUniformRefiner(maxlevel);
+    }
+
+    // Stencils of a shared refiner, built with the default options
+    OpenSubdiv::Far::StencilTable const & GetStencilTable(FarTopologyRefiner const & refiner) {
+        OpenSubdiv::Far::StencilTable const *& table = _stencilTables[&refiner];
+        if (not table) {
+            table = OpenSubdiv::Far::StencilTableFactory::Create(refiner);
+        }
+        return *table;
+    }
+
+private:
+    enum Refinement { BASE, UNIFORM, FULL_TOPOLOGY, ADAPTIVE, SINGLE_CREASE };
+
+    FarTopologyRefiner const & getRefiner(Refinement refinement, int maxlevel) {
+        FarTopologyRefiner *& refiner = _refiners[std::make_pair((int)refinement, maxlevel)];
+        if (not refiner) {
+            refiner = CreateRefiner();
+            if (refinement==BASE) {
+                return *refiner;
+            } else if (refinement==UNIFORM or refinement==FULL_TOPOLOGY) {
+                FarTopologyRefiner::UniformOptions options(maxlevel);
+                options.fullTopologyInLastLevel = (refinement==FULL_TOPOLOGY);
+                refiner->RefineUniform(options);
+            } else {
+                FarTopologyRefiner::AdaptiveOptions options(maxlevel);
+                options.useSingleCreasePatch = (refinement==SINGLE_CREASE);
+                refiner->RefineAdaptive(options);
+            }
+        }
+        return *refiner;
+    }
+
+    // Fixtures are not copied (they own their shapes and refiners)
+    ShapeFixture(ShapeFixture const &);
+    ShapeFixture & operator=(ShapeFixture const &);
+
+    typedef std::map<std::pair<int, int>, FarTopologyRefiner *> RefinerMap;
+    typedef std::map<FarTopologyRefiner const *,
+                     OpenSubdiv::Far::StencilTable const *> StencilTableMap;
+
+    ShapeDesc const & _desc;
+
+    Shape * _shape,
+          * _shapeWithoutFVar;
+
+    RefinerMap      _refiners;
+    StencilTableMap _stencilTables;
+};
+
+//------------------------------------------------------------------------------
+// Topology refined concurrently must be identical to that refined serially
+template <class ARRAY>
+static bool
+equalArrays(ARRAY const & a, ARRAY const & b) {
+
+    if (a.size() != b.size()) return false;
+    for (int i=0; i<a.size(); ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+static int
+compareTopology(FarTopologyRefiner const & serial,
+                FarTopologyRefiner const & concurrent) {
+
+    if (serial.GetNumLevels() != concurrent.GetNumLevels() or
+        serial.GetMaxValence() != concurrent.GetMaxValence()) {
+        return 1;
+    }
+
+    int count=0;
+    for (int level=0; level<serial.GetNumLevels(); ++level) {
+
+        OpenSubdiv::Far::TopologyLevel const & a = serial.GetLevel(level),
+                                             & b = concurrent.GetLevel(level);
+
+        if (a.GetNumFaces() != b.GetNumFaces() or
+            a.GetNumEdges() != b.GetNumEdges() or
+            a.GetNumVertices() != b.GetNumVertices()) {
+            ++count;
+            continue;
+        }
+        for (int f=0; f<a.GetNumFaces(); ++f) {
+            if (not equalArrays(a.GetFaceVertices(f), b.GetFaceVertices(f)) or
+                not equalArrays(a.GetFaceEdges(f), b.GetFaceEdges(f))) {
+                ++count;
+            }
+        }
+        for (int e=0; e<a.GetNumEdges(); ++e) {
+            if (not equalArrays(a.GetEdgeVertices(e), b.GetEdgeVertices(e)) or
+                not equalArrays(a.GetEdgeFaces(e), b.GetEdgeFaces(e)) or
+                not equalArrays(a.GetEdgeFaceLocalIndices(e), b.GetEdgeFaceLocalIndices(e))) {
+                ++count;
+            }
+        }
+        for (int v=0; v<a.GetNumVertices(); ++v) {
+            if (not equalArrays(a.GetVertexFaces(v), b.GetVertexFaces(v)) or
+                not equalArrays(a.GetVertexEdges(v), b.GetVertexEdges(v)) or
+                not equalArrays(a.GetVertexFaceLocalIndices(v), b.GetVertexFaceLocalIndices(v)) or
+                not equalArrays(a.GetVertexEdgeLocalIndices(v), b.GetVertexEdgeLocalIndices(v))) {
+                ++count;
+            }
+        }
+        if (a.GetNumFVarChannels() != b.GetNumFVarChannels()) {
+            ++count;
+            continue;
+        }
+        for (int channel=0; channel<a.GetNumFVarChannels(); ++channel) {
+            if (a.GetNumFVarValues(channel) != b.GetNumFVarValues(channel)) {
+                ++count;
+                continue;
+            }
+            for (int f=0; f<a.GetNumFaces(); ++f) {
+                if (not equalArrays(a.GetFaceFVarValues(f, channel), b.GetFaceFVarValues(f, channel))) {
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Scheduler applying ranges in reverse order to expose any order dependency
+class ReverseTaskScheduler : public OpenSubdiv::Far::TaskScheduler {
+public:
+    virtual void ParallelFor(int begin, int end, int grainSize,
+                             RangeKernel kernel, void * data) const {
+        for (int i=end; i>begin; i-=grainSize) {
+            kernel(std::max(begin, i-grainSize), i, data);
+        }
+    }
+    virtual int GetNumThreads() const { return 4; }
+};
+
+static int
+checkConcurrentTopology(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefinerFactory::Options options = fixture.GetRefinerOptions();
+
+    ReverseTaskScheduler scheduler;
+
+    int count=0;
+    for (int adaptive=0; adaptive<2; ++adaptive) {
+
+        if (adaptive and desc.scheme!=kCatmark) continue;
+
+        // serial (shared), OpenMP threads and client scheduler
+        FarTopologyRefiner const * refiners[3];
+        refiners[0] = adaptive ? &fixture.GetAdaptiveRefiner(maxlevel) :
+                                 &fixture.GetFullTopologyRefiner(maxlevel);
+        for (int i=1; i<3; ++i) {
+            options.numThreads = (i==1) ? 4 : 1;
+            options.taskScheduler = (i==2) ? &scheduler : 0;
+            FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(shape, options);
+            if (adaptive) {
+                FarTopologyRefiner::AdaptiveOptions adaptiveOptions(maxlevel);
+                adaptiveOptions.numThreads = (i==1) ? 4 : 1;
+                adaptiveOptions.taskScheduler = (i==2) ? &scheduler : 0;
+                refiner->RefineAdaptive(adaptiveOptions);
+            } else {
+                FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+                uniformOptions.fullTopologyInLastLevel = true;
+                uniformOptions.numThreads = (i==1) ? 4 : 1;
+                uniformOptions.taskScheduler = (i==2) ? &scheduler : 0;
+                refiner->RefineUniform(uniformOptions);
+            }
+            refiners[i] = refiner;
+        }
+        for (int i=1; i<3; ++i) {
+            int failures = compareTopology(*refiners[0], *refiners[i]);
+            if (failures) {
+                printf("// concurrent %s topology (%s) fails : %d components differ\n",
+                    adaptive ? "adaptive" : "uniform", (i==1) ? "threads" : "scheduler", failures);
+            }
+            count += failures;
+        }
+        delete refiners[1];
+        delete refiners[2];
+    }
+    return count;
+}
+
+// Errors expected from negative cases are counted rather than printed, with
+// SetErrorCallback(countErrors) around the cases
+static int g_numErrors = 0;
+
+static void
+countErrors(OpenSubdiv::Far::ErrorType, const char *) {
+    ++g_numErrors;
+}
+
+// Creates a directory of its own in the temporary directory of the system,
+// for the files written by a check (returns an empty string on failure)
+static std::string
+createTemporaryDirectory() {
+#if defined(_WIN32)
+    char path[MAX_PATH], name[MAX_PATH];
+    if (GetTempPathA(MAX_PATH, path)==0 or
+        GetTempFileNameA(path, "far", 0, name)==0) {
+        return std::string();
+    }
+    // the unique file created is replaced by a directory of the same name
+    DeleteFileA(name);
+    return CreateDirectoryA(name, NULL) ? std::string(name) : std::string();
+#else
+    char const * tmp = getenv("TMPDIR");
+    std::string path = std::string((tmp and *tmp) ? tmp : "/tmp") + "/far_regression_XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    return mkdtemp(&name[0]) ? std::string(&name[0]) : std::string();
+#endif
+}
+
+// Removes the files of a temporary directory, then the directory : returns
+// false if the directory holds other files (or can't be removed)
+static bool
+removeTemporaryDirectory(std::string const & directory,
+                         std::vector<std::string> const & filenames) {
+
+    for (int i=0; i<(int)filenames.size(); ++i) {
+        remove((directory + "/" + filenames[i]).c_str());
+    }
+#if defined(_WIN32)
+    return RemoveDirectoryA(directory.c_str()) != 0;
+#else
+    return rmdir(directory.c_str()) == 0;
+#endif
+}
+
+// Name of the file of a table of a TopologyCache
+static std::string
+getTopologyCacheFilename(OpenSubdiv::Far::TopologyFingerprint::Hash hash,
+                         char const * extension) {
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", hash);
+    return std::string(name) + extension;
+}
+
+// Stencils generated concurrently must be identical to those generated serially
+static bool
+equalStencilTables(OpenSubdiv::Far::StencilTable const & a,
+                   OpenSubdiv::Far::StencilTable const & b) {
+
+    return a.GetSizes()==b.GetSizes() and
+           a.GetOffsets()==b.GetOffsets() and
+           a.GetControlIndices()==b.GetControlIndices() and
+           a.GetWeights()==b.GetWeights() and
+           a.GetPassOffsets()==b.GetPassOffsets();
+}
+
+static int
+checkConcurrentStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::LimitStencilTable        FarLimitStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTableFactory FarLimitStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetDefaultRefiner(maxlevel);
+
+    bool adaptive = (desc.scheme==kCatmark);
+
+    ReverseTaskScheduler scheduler;
+
+    int count=0;
+    for (int factorize=0; factorize<2; ++factorize) {
+
+        FarStencilTableFactory::Options options;
+        options.factorizeIntermediateLevels = factorize;
+
+        FarStencilTable const * serial = FarStencilTableFactory::Create(refiner, options);
+
+        options.taskScheduler = &scheduler;
+        FarStencilTable const * concurrent = FarStencilTableFactory::Create(refiner, options);
+
+        if (not equalStencilTables(*serial, *concurrent)) {
+            printf("// concurrent stencils fails (factorize=%d)\n", factorize);
+            ++count;
+        }
+        delete serial;
+        delete concurrent;
+    }
+
+    if (adaptive) {
+        // a few limit locations on every ptex face
+        OpenSubdiv::Far::PtexIndices ptexIndices(refiner);
+
+        static float const s[3] = { 0.0f, 0.25f, 0.75f },
+                           t[3] = { 0.5f, 0.75f, 1.0f };
+
+        FarLimitStencilTableFactory::LocationArrayVec locations(ptexIndices.GetNumFaces());
+        for (int i=0; i<(int)locations.size(); ++i) {
+            locations[i].ptexIdx = i;
+            locations[i].numLocations = 3;
+            locations[i].s = s;
+            locations[i].t = t;
+        }
+
+        FarLimitStencilTable const * serial =
+            FarLimitStencilTableFactory::Create(refiner, locations, 0, 0, 0, true);
+        FarLimitStencilTable const * concurrent =
+            FarLimitStencilTableFactory::Create(refiner, locations, 0, 0, &scheduler, true);
+
+        if (not serial or not concurrent or
+            not equalStencilTables(*serial, *concurrent) or
+            serial->GetDuWeights()!=concurrent->GetDuWeights() or
+            serial->GetDvWeights()!=concurrent->GetDvWeights() or
+            not serial->HasSecondDerivatives() or
+            serial->GetDuuWeights()!=concurrent->GetDuuWeights() or
+            serial->GetDuvWeights()!=concurrent->GetDuvWeights() or
+            serial->GetDvvWeights()!=concurrent->GetDvvWeights()) {
+            printf("// concurrent limit stencils fails\n");
+            ++count;
+        }
+
+        // stencils sorted by patch must be those of their locations
+        FarLimitStencilTableFactory::Options limitOptions;
+        limitOptions.sortByPatch = true;
+
+        std::vector<int> serialLocations, sortedLocations, concurrentLocations;
+        delete serial;
+        serial = FarLimitStencilTableFactory::Create(refiner, locations,
+            FarLimitStencilTableFactory::Options(), 0, 0, &serialLocations);
+        FarLimitStencilTable const * sorted = FarLimitStencilTableFactory::Create(
+            refiner, locations, limitOptions, 0, 0, &sortedLocations);
+
+        limitOptions.taskScheduler = &scheduler;
+        delete concurrent;
+        concurrent = FarLimitStencilTableFactory::Create(refiner, locations,
+            limitOptions, 0, 0, &concurrentLocations);
+
+        bool sortedFails = not sorted or not concurrent or
+            not equalStencilTables(*sorted, *concurrent) or
+            sortedLocations!=concurrentLocations or
+            sortedLocations.size()!=serialLocations.size();
+
+        std::vector<int> stencilOfLocation(3*locations.size(), -1);
+        for (int i=0; i<(int)serialLocations.size(); ++i) {
+            stencilOfLocation[serialLocations[i]] = i;
+        }
+        for (int i=0; not sortedFails and i<(int)sortedLocations.size(); ++i) {
+            OpenSubdiv::Far::Stencil a = sorted->GetStencil(i),
+                b = serial->GetStencil(stencilOfLocation[sortedLocations[i]]);
+            sortedFails = a.GetSize()!=b.GetSize() or
+                not std::equal(a.GetWeights(), a.GetWeights()+a.GetSize(), b.GetWeights());
+        }
+        if (sortedFails) {
+            printf("// sorted limit stencils fails\n");
+            ++count;
+        }
+        delete serial;
+        delete sorted;
+        delete concurrent;
+    }
+
+    return count;
+}
+
+// Patches populated concurrently must be identical to those populated serially
+static bool
+equalPatchTables(OpenSubdiv::Far::PatchTable const & a,
+                 OpenSubdiv::Far::PatchTable const & b) {
+
+    if (a.GetNumPatchArrays()!=b.GetNumPatchArrays() or
+        a.GetPatchControlVerticesTable()!=b.GetPatchControlVerticesTable() or
+        a.GetSharpnessIndexTable()!=b.GetSharpnessIndexTable() or
+        a.GetSharpnessValues()!=b.GetSharpnessValues() or
+        a.GetQuadOffsetsTable()!=b.GetQuadOffsetsTable() or
+        a.GetVertexValenceTable()!=b.GetVertexValenceTable() or
+        a.GetNumFVarChannels()!=b.GetNumFVarChannels()) {
+        return false;
+    }
+    for (int i=0; i<a.GetNumPatchArrays(); ++i) {
+        if (a.GetNumPatches(i)!=b.GetNumPatches(i)) {
+            return false;
+        }
+    }
+    OpenSubdiv::Far::PatchParamTable const & aParams = a.GetPatchParamTable(),
+                                           & bParams = b.GetPatchParamTable();
+    if (aParams.size()!=bParams.size()) {
+        return false;
+    }
+    for (int i=0; i<(int)aParams.size(); ++i) {
+        if (aParams[i].field0!=bParams[i].field0 or
+            aParams[i].field1!=bParams[i].field1) {
+            return false;
+        }
+    }
+    for (int channel=0; channel<a.GetNumFVarChannels(); ++channel) {
+        if (not equalArrays(a.GetFVarValues(channel), b.GetFVarValues(channel)) or
+            not (a.GetFVarChannelPatchDescriptor(channel)==b.GetFVarChannelPatchDescriptor(channel))) {
+            return false;
+        }
+        OpenSubdiv::Far::ConstPatchParamArray aFVarParams = a.GetFVarPatchParams(channel),
+                                              bFVarParams = b.GetFVarPatchParams(channel);
+        if (aFVarParams.size()!=bFVarParams.size()) {
+            return false;
+        }
+        for (int i=0; i<aFVarParams.size(); ++i) {
+            if (aFVarParams[i].field0!=bFVarParams[i].field0 or
+                aFVarParams[i].field1!=bFVarParams[i].field1) {
+                return false;
+            }
+        }
+    }
+    OpenSubdiv::Far::StencilTable const * aStencils = a.GetLocalPointStencilTable(),
+                                        * bStencils = b.GetLocalPointStencilTable();
+    if ((aStencils==0)!=(bStencils==0) or
+        (aStencils and not equalStencilTables(*aStencils, *bStencils))) {
+        return false;
+    }
+    return true;
+}
+
+static int
+checkConcurrentPatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetSingleCreaseRefiner(maxlevel);
+
+    ReverseTaskScheduler scheduler;
+
+    static FarPatchTableFactory::Options::EndCapType const endCapTypes[3] = {
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY };
+
+    int count=0;
+    for (int i=0; i<3; ++i) {
+
+        FarPatchTableFactory::Options options(maxlevel);
+        options.useSingleCreasePatch = true;
+        options.generateFVarTables = refiner.GetNumFVarChannels()>0;
+        options.SetEndCapType(endCapTypes[i]);
+
+        FarPatchTable const * serial = FarPatchTableFactory::Create(refiner, options);
+
+        options.taskScheduler = &scheduler;
+        FarPatchTable const * concurrent = FarPatchTableFactory::Create(refiner, options);
+
+        if (not equalPatchTables(*serial, *concurrent)) {
+            printf("// concurrent patches fails (end-cap type %d)\n", endCapTypes[i]);
+            ++count;
+        }
+        delete serial;
+        delete concurrent;
+    }
+
+    return count;
+}
+
+// Tables must be restored identical from their serialized records
+static int
+checkSerializedTables(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTable        FarLimitStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTableFactory FarLimitStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+    typedef OpenSubdiv::Far::TableSerializer          FarTableSerializer;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetSingleCreaseRefiner(maxlevel);
+
+    FarStencilTable const & stencils = fixture.GetStencilTable(refiner);
+
+    OpenSubdiv::Far::PtexIndices ptexIndices(refiner);
+
+    static float const s[2] = { 0.25f, 0.75f },
+                       t[2] = { 0.5f, 1.0f };
+
+    FarLimitStencilTableFactory::LocationArrayVec locations(ptexIndices.GetNumFaces());
+    for (int i=0; i<(int)locations.size(); ++i) {
+        locations[i].ptexIdx = i;
+        locations[i].numLocations = 2;
+        locations[i].s = s;
+        locations[i].t = t;
+    }
+    FarLimitStencilTable const * limitStencils =
+        FarLimitStencilTableFactory::Create(refiner, locations, 0, 0, 0, true);
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.useSingleCreasePatch = true;
+    options.generateFVarTables = refiner.GetNumFVarChannels()>0;
+    options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, options);
+
+    // concatenate the records in a single buffer
+    std::vector<unsigned char> data;
+    FarTableSerializer::Write(stencils, data);
+    FarTableSerializer::Write(*limitStencils, data);
+    FarTableSerializer::Write(*patches, data);
+
+    size_t offset = 0, recordSize = 0;
+
+    FarStencilTable const * readStencils =
+        FarTableSerializer::ReadStencilTable(&data[0], data.size(), &recordSize);
+    offset += recordSize;
+
+    size_t stencilRecordSize = recordSize;
+
+    FarLimitStencilTable const * readLimitStencils =
+        FarTableSerializer::ReadLimitStencilTable(&data[offset], data.size()-offset, &recordSize);
+    offset += recordSize;
+
+    FarPatchTable const * readPatches =
+        FarTableSerializer::ReadPatchTable(&data[offset], data.size()-offset, &recordSize);
+    offset += recordSize;
+
+    int count=0;
+    if (not readStencils or not equalStencilTables(stencils, *readStencils)) {
+        printf("// serialized stencils fails\n");
+        ++count;
+    }
+    if (not readLimitStencils or
+        not equalStencilTables(*limitStencils, *readLimitStencils) or
+        limitStencils->GetDuWeights()!=readLimitStencils->GetDuWeights() or
+        limitStencils->GetDvWeights()!=readLimitStencils->GetDvWeights() or
+        limitStencils->GetDuuWeights()!=readLimitStencils->GetDuuWeights() or
+        limitStencils->GetDuvWeights()!=readLimitStencils->GetDuvWeights() or
+        limitStencils->GetDvvWeights()!=readLimitStencils->GetDvvWeights()) {
+        printf("// serialized limit stencils fails\n");
+        ++count;
+    }
+    if (not readPatches or not equalPatchTables(*patches, *readPatches)) {
+        printf("// serialized patches fails\n");
+        ++count;
+    }
+    if (offset!=data.size()) {
+        printf("// serialized record sizes fails\n");
+        ++count;
+    }
+
+    // publish the records in shared memory, and view the stencils in place
+    std::string name = std::string("osd_far_regression_") + desc.name;
+
+    FarTableSerializer::SharedMemory * published =
+        FarTableSerializer::SharedMemory::Publish(name.c_str(), data);
+    FarTableSerializer::SharedMemory * attached =
+        published ? FarTableSerializer::SharedMemory::Attach(name.c_str()) : 0;
+
+    FarTableSerializer::StencilTableView view;
+    if (not attached or attached->GetSize()!=data.size() or
+        memcmp(attached->GetData(), &data[0], data.size()) or
+        not FarTableSerializer::ViewStencilTable(attached->GetData(),
+            attached->GetSize(), view, &recordSize) or
+        recordSize!=stencilRecordSize) {
+        printf("// shared serialized tables fails\n");
+        ++count;
+    } else if (view.numControlVertices!=stencils.GetNumControlVertices() or
+        view.numStencils!=stencils.GetNumStencils() or
+        not std::equal(view.sizes, view.sizes+view.numStencils,
+            stencils.GetSizes().begin()) or
+        not std::equal(view.offsets, view.offsets+view.numStencils,
+            stencils.GetOffsets().begin()) or
+        not std::equal(view.indices, view.indices+stencils.GetControlIndices().size(),
+            stencils.GetControlIndices().begin()) or
+        not std::equal(view.weights, view.weights+stencils.GetWeights().size(),
+            stencils.GetWeights().begin())) {
+        printf("// shared stencil view fails\n");
+        ++count;
+    }
+    if (published) {
+        FarTableSerializer::SharedMemory::Remove(name.c_str());
+    }
+    delete attached;
+    delete published;
+
+    delete limitStencils;
+    delete patches;
+    delete readStencils;
+    delete readLimitStencils;
+    delete readPatches;
+    return count;
+}
+
+// Precision of the vertices interpolated by stencils accumulating their
+// weights in a different order
+#define SUMMATION_PRECISION 1e-5
+
+// Reordered stencils and remapped patches must evaluate the same vertices
+
+static int
+checkReorderedStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Index                    FarIndex;
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    int count=0;
+    for (int controlStencils=0; controlStencils<2; ++controlStencils) {
+
+        FarStencilTableFactory::Options options;
+        options.generateControlVerts = controlStencils;
+
+        FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+        FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+
+        std::vector<FarIndex> permutation;
+        FarStencilTable const * reordered =
+            FarStencilTableFactory::ReorderStencils(stencils, permutation);
+        if (not reordered) {
+            printf("// reordered stencils fails (control stencils=%d)\n", controlStencils);
+            ++count;
+            delete stencils;
+            delete patches;
+            continue;
+        }
+
+        FarPatchTable * remapped = new FarPatchTable(*patches);
+        FarIndex offset = controlStencils ? 0 : nControlVerts;
+        remapped->RemapControlVertices(permutation, offset);
+
+        // evaluate all the vertices (and local points) of both sets of tables
+        int nVerts = offset + stencils->GetNumStencils(),
+            nLocalPoints = patches->GetNumLocalPoints();
+
+        std::vector<xyzVV> verts(nVerts + nLocalPoints),
+                           reorderedVerts(nVerts + nLocalPoints);
+        if (not controlStencils) {
+            std::copy(controlVerts.begin(), controlVerts.end(), verts.begin());
+            std::copy(controlVerts.begin(), controlVerts.end(), reorderedVerts.begin());
+        }
+        if (stencils->GetNumStencils()) {
+            stencils->UpdateValues(&controlVerts[0], &verts[offset]);
+            reordered->UpdateValues(&controlVerts[0], &reorderedVerts[offset]);
+        }
+        if (nLocalPoints) {
+            patches->ComputeLocalPointValues(&verts[0], &verts[nVerts]);
+            remapped->ComputeLocalPointValues(&reorderedVerts[0], &reorderedVerts[nVerts]);
+        }
+
+        int nfails = 0;
+        for (int i=0; i<stencils->GetNumStencils(); ++i) {
+            float const * a = verts[offset + i].GetPos(),
+                        * b = reorderedVerts[offset + permutation[i]].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a[k]-b[k]) > SUMMATION_PRECISION) ++nfails;
+            }
+        }
+
+        FarPatchTable::PatchVertsTable const & cvs = patches->GetPatchControlVerticesTable(),
+                                             & remappedCvs = remapped->GetPatchControlVerticesTable();
+        for (int i=0; i<(int)cvs.size(); ++i) {
+            float const * a = verts[cvs[i]].GetPos(),
+                        * b = reorderedVerts[remappedCvs[i]].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a[k]-b[k]) > SUMMATION_PRECISION) ++nfails;
+            }
+        }
+
+        if (nfails) {
+            printf("// reordered stencils fails (control stencils=%d)\n", controlStencils);
+            ++count;
+        }
+
+        delete stencils;
+        delete reordered;
+        delete patches;
+        delete remapped;
+    }
+
+    return count;
+}
+
+// Stencils evaluated in several passes must interpolate the same vertices as
+// fully factorized stencils
+static int
+checkSharedStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    int count=0;
+    for (int intermediateLevels=0; intermediateLevels<2; ++intermediateLevels) {
+
+        FarStencilTableFactory::Options options;
+        options.generateIntermediateLevels = intermediateLevels;
+
+        FarStencilTable const * factorized = FarStencilTableFactory::Create(refiner, options);
+
+        options.shareIntermediateLevels = true;
+        FarStencilTable const * passes = FarStencilTableFactory::Create(refiner, options);
+
+        // evaluate the passes in a single buffer following the control vertices
+        int offset = nControlVerts,
+            nStencils = factorized->GetNumStencils(),
+            nPassStencils = passes->GetNumStencils();
+
+        std::vector<xyzVV> verts(nStencils),
+                           passVerts(offset + nPassStencils);
+        std::copy(controlVerts.begin(), controlVerts.end(), passVerts.begin());
+        if (nStencils) {
+            factorized->UpdateValues(&controlVerts[0], &verts[0]);
+            passes->UpdateValues(&passVerts[0], &passVerts[offset]);
+        }
+
+        // the last vertices of both tables must match
+        int nfails = 0;
+        for (int i=0; i<nStencils; ++i) {
+            float const * a = verts[i].GetPos(),
+                        * b = passVerts[offset + nPassStencils - nStencils + i].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a[k]-b[k]) > SUMMATION_PRECISION) ++nfails;
+            }
+        }
+
+        // shared levels must not cost more than the fully factorized stencils
+        size_t cost = passes->GetControlIndices().size() + (nPassStencils - nStencils);
+        if (cost > factorized->GetControlIndices().size()) ++nfails;
+
+        if (nPassStencils < nStencils or nfails) {
+            printf("// stencil passes fails (intermediate levels=%d)\n", intermediateLevels);
+            ++count;
+        }
+
+        delete factorized;
+        delete passes;
+    }
+
+    // unfactorized levels are evaluated one pass per level
+    {
+        FarStencilTableFactory::Options options;
+        FarStencilTable const * factorized = FarStencilTableFactory::Create(refiner, options);
+
+        options.factorizeIntermediateLevels = false;
+        FarStencilTable const * levels = FarStencilTableFactory::Create(refiner, options);
+
+        std::vector<OpenSubdiv::Far::Index> const & passOffsets = levels->GetPassOffsets();
+
+        int nfails = 0,
+            nLevels = refiner.GetMaxLevel();
+        if (nLevels>1) {
+            if ((int)passOffsets.size()!=nLevels) {
+                ++nfails;
+            } else {
+                for (int level=1, start=0; level<nLevels; ++level) {
+                    start += refiner.GetLevel(level).GetNumVertices();
+                    if (passOffsets[level]!=start) ++nfails;
+                }
+            }
+        } else if (not passOffsets.empty()) {
+            ++nfails;
+        }
+
+        int offset = nControlVerts,
+            nStencils = factorized->GetNumStencils();
+
+        std::vector<xyzVV> verts(nStencils),
+                           levelVerts(offset + levels->GetNumStencils());
+        std::copy(controlVerts.begin(), controlVerts.end(), levelVerts.begin());
+        if (nStencils) {
+            factorized->UpdateValues(&controlVerts[0], &verts[0]);
+            levels->UpdateValues(&levelVerts[0], &levelVerts[offset]);
+        }
+        if (levels->GetNumStencils()!=nStencils) ++nfails;
+
+        for (int i=0; i<nStencils and not nfails; ++i) {
+            float const * a = verts[i].GetPos(),
+                        * b = levelVerts[offset + i].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a[k]-b[k]) > SUMMATION_PRECISION) ++nfails;
+            }
+        }
+
+        if (nfails) {
+            printf("// unfactorized stencil passes fails\n");
+            ++count;
+        }
+
+        delete factorized;
+        delete levels;
+    }
+
+    return count;
+}
+
+// Sharpness updated on a refined topology must match that refined after the update
+static int
+compareSharpness(FarTopologyRefiner const & a, FarTopologyRefiner const & b) {
+
+    int count = compareTopology(a, b);
+    if (count or a.GetNumLevels() != b.GetNumLevels()) {
+        return count + 1;
+    }
+    for (int level=0; level<a.GetNumLevels(); ++level) {
+
+        OpenSubdiv::Far::TopologyLevel const & la = a.GetLevel(level),
+                                             & lb = b.GetLevel(level);
+
+        for (int e=0; e<la.GetNumEdges(); ++e) {
+            if (la.GetEdgeSharpness(e) != lb.GetEdgeSharpness(e)) {
+                ++count;
+            }
+        }
+        for (int v=0; v<la.GetNumVertices(); ++v) {
+            if (la.GetVertexSharpness(v) != lb.GetVertexSharpness(v) or
+                la.GetVertexRule(v) != lb.GetVertexRule(v)) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+static int
+checkSharpnessUpdate(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::ConstIndexArray ConstIndexArray;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    // face-varying channels do not support sharpness updates
+    Shape const & shape = fixture.GetShapeWithoutFVar();
+
+    FarTopologyRefinerFactory::Options options(GetSdcType(shape), GetSdcOptions(shape));
+
+    bool adaptive = (desc.scheme==kCatmark);
+
+    FarTopologyRefiner * refiners[3];
+    for (int i=0; i<3; ++i) {
+        refiners[i] = FarTopologyRefinerFactory::Create(shape, options);
+    }
+
+    // sharpen a subset of the edges and a vertex, then restore them
+    OpenSubdiv::Far::TopologyLevel const & base = refiners[0]->GetLevel(0);
+
+    std::vector<OpenSubdiv::Far::Index> edges, vertices(1, 0);
+    std::vector<float> sharpness, restored, vertexSharpness(1, 1.5f),
+        restoredVertex(1, base.GetVertexSharpness(0));
+    for (int e=0; e<base.GetNumEdges(); e+=3) {
+        edges.push_back(e);
+        sharpness.push_back((e % 2) ? 2.5f : 10.0f);
+        restored.push_back(base.GetEdgeSharpness(e));
+    }
+    ConstIndexArray edgeArray(&edges[0], (int)edges.size()),
+                    vertexArray(&vertices[0], 1);
+
+    // refiner 1 is updated before refinement, refiner 2 is never updated
+    refiners[1]->UpdateBaseSharpness(edgeArray, &sharpness[0], vertexArray, &vertexSharpness[0]);
+
+    for (int i=0; i<3; ++i) {
+        if (adaptive) {
+            refiners[i]->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+        } else {
+            FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+            uniformOptions.fullTopologyInLastLevel = true;
+            refiners[i]->RefineUniform(uniformOptions);
+        }
+    }
+
+    int count=0;
+    if (not refiners[0]->UpdateBaseSharpness(edgeArray, &sharpness[0],
+                                             vertexArray, &vertexSharpness[0]) or
+        compareSharpness(*refiners[0], *refiners[1])) {
+        printf("// sharpness update fails\n");
+        ++count;
+    }
+    if (not refiners[0]->UpdateBaseSharpness(edgeArray, &restored[0],
+                                             vertexArray, &restoredVertex[0]) or
+        compareSharpness(*refiners[0], *refiners[2])) {
+        printf("// sharpness restore fails\n");
+        ++count;
+    }
+
+    for (int i=0; i<3; ++i) {
+        delete refiners[i];
+    }
+    return count;
+}
+
+// Sharpness subdivided concurrently must be identical to that subdivided serially
+static int
+checkConcurrentSharpness(ShapeFixture & fixture, int maxlevel) {
+
+    // face-varying channels do not support sharpness updates
+    Shape const & shape = fixture.GetShapeWithoutFVar();
+
+    ReverseTaskScheduler scheduler;
+
+    int count=0;
+    for (int chaikin=0; chaikin<2; ++chaikin) {
+
+        FarTopologyRefinerFactory::Options options(GetSdcType(shape), GetSdcOptions(shape));
+        if (chaikin) {
+            options.schemeOptions.SetCreasingMethod(OpenSubdiv::Sdc::Options::CREASE_CHAIKIN);
+        }
+
+        // serial, OpenMP threads and client scheduler
+        FarTopologyRefiner * refiners[3];
+        for (int i=0; i<3; ++i) {
+            options.numThreads = (i==1) ? 4 : 1;
+            options.taskScheduler = (i==2) ? &scheduler : 0;
+            refiners[i] = FarTopologyRefinerFactory::Create(shape, options);
+
+            // semi-sharp edges persisting through several levels
+            OpenSubdiv::Far::TopologyLevel const & base = refiners[i]->GetLevel(0);
+
+            std::vector<OpenSubdiv::Far::Index> edges;
+            std::vector<float> sharpness;
+            for (int e=0; e<base.GetNumEdges(); e+=2) {
+                edges.push_back(e);
+                sharpness.push_back(0.5f + (float)(e % 5));
+            }
+            refiners[i]->UpdateBaseSharpness(
+                OpenSubdiv::Far::ConstIndexArray(&edges[0], (int)edges.size()),
+                &sharpness[0], OpenSubdiv::Far::ConstIndexArray(), 0);
+
+            FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+            uniformOptions.fullTopologyInLastLevel = true;
+            uniformOptions.numThreads = (i==1) ? 4 : 1;
+            uniformOptions.taskScheduler = (i==2) ? &scheduler : 0;
+            refiners[i]->RefineUniform(uniformOptions);
+        }
+        for (int i=1; i<3; ++i) {
+            int failures = compareSharpness(*refiners[0], *refiners[i]);
+            if (failures) {
+                printf("// concurrent sharpness (%s) fails : %d components differ\n",
+                    (i==1) ? "threads" : "scheduler", failures);
+            }
+            count += failures;
+        }
+        for (int i=0; i<3; ++i) {
+            delete refiners[i];
+        }
+    }
+    return count;
+}
+
+// Sparse refinement of every other base face must only generate patches
+// covering the ptex faces of the selected faces, entirely
+static int
+checkSparseRefinement(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam        FarPatchParam;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+    OpenSubdiv::Far::TopologyLevel const & base = refiner->GetLevel(0);
+    OpenSubdiv::Far::PtexIndices ptexIndices(*refiner);
+
+    std::vector<OpenSubdiv::Far::Index> faces;
+    std::vector<bool> selectedPtexFaces(ptexIndices.GetNumFaces(), false);
+    for (int face=0; face<base.GetNumFaces(); face+=2) {
+        if (base.IsFaceHole(face)) continue;
+        faces.push_back(face);
+        int nptex = base.GetFaceVertices(face).size()==4 ?
+            1 : base.GetFaceVertices(face).size();
+        for (int i=0; i<nptex; ++i) {
+            selectedPtexFaces[ptexIndices.GetFaceId(face)+i] = true;
+        }
+    }
+
+    refiner->RefineSparse(FarTopologyRefiner::AdaptiveOptions(maxlevel),
+        OpenSubdiv::Far::ConstIndexArray(&faces[0], (int)faces.size()));
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(*refiner, options);
+
+    std::vector<float> ptexArea(selectedPtexFaces.size(), 0.0f);
+
+    int count=0;
+    for (int array=0; array<patchTable->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patchTable->GetNumPatches(array); ++patch) {
+            FarPatchParam param = patchTable->GetPatchParam(array, patch);
+            if (not selectedPtexFaces[param.GetFaceId()]) {
+                ++count;
+            }
+            float frac = param.GetParamFraction();
+            ptexArea[param.GetFaceId()] += frac * frac;
+        }
+    }
+    for (int i=0; i<(int)ptexArea.size(); ++i) {
+        if (selectedPtexFaces[i] and std::fabs(ptexArea[i] - 1.0f) > 1e-4f) {
+            ++count;
+        }
+    }
+    if (count) {
+        printf("// sparse refinement fails\n");
+    }
+
+    delete patchTable;
+    delete refiner;
+    return count ? 1 : 0;
+}
+
+// Patches must cover all ptex faces and not exceed the isolation level of
+// their base faces -- or match the patches of the global isolation level
+static int
+checkFaceIsolationLevels(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam        FarPatchParam;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefinerFactory::Options refinerOptions = fixture.GetRefinerOptions();
+
+    FarTopologyRefiner * refiners[3];
+    for (int i=0; i<3; ++i) {
+        refiners[i] = FarTopologyRefinerFactory::Create(shape, refinerOptions);
+    }
+
+    OpenSubdiv::Far::TopologyLevel const & base = refiners[0]->GetLevel(0);
+    OpenSubdiv::Far::PtexIndices ptexIndices(*refiners[0]);
+
+    std::vector<unsigned char> faceLevels(base.GetNumFaces()),
+                               maxLevels(base.GetNumFaces(), (unsigned char)maxlevel),
+                               ptexLevels(ptexIndices.GetNumFaces());
+    for (int face=0; face<base.GetNumFaces(); ++face) {
+        faceLevels[face] = (unsigned char)(face % 3);
+        int nptex = base.GetFaceVertices(face).size()==4 ?
+            1 : base.GetFaceVertices(face).size();
+        for (int i=0; i<nptex; ++i) {
+            ptexLevels[ptexIndices.GetFaceId(face)+i] =
+                (unsigned char)std::max(1, (int)faceLevels[face]);
+        }
+    }
+
+    FarTopologyRefiner::AdaptiveOptions adaptiveOptions(maxlevel);
+    refiners[0]->RefineAdaptive(adaptiveOptions, &faceLevels[0]);
+    refiners[1]->RefineAdaptive(adaptiveOptions, &maxLevels[0]);
+    refiners[2]->RefineAdaptive(adaptiveOptions);
+
+    static FarPatchTableFactory::Options::EndCapType const endCapTypes[3] = {
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY };
+
+    int count=0;
+    for (int i=0; i<3; ++i) {
+
+        FarPatchTableFactory::Options options(maxlevel);
+        options.SetEndCapType(endCapTypes[i]);
+
+        FarPatchTable const * patchTables[3];
+        for (int j=0; j<3; ++j) {
+            patchTables[j] = FarPatchTableFactory::Create(*refiners[j], options);
+        }
+
+        std::vector<float> ptexArea(ptexLevels.size(), 0.0f);
+
+        bool failed = false;
+        for (int array=0; array<patchTables[0]->GetNumPatchArrays(); ++array) {
+            for (int patch=0; patch<patchTables[0]->GetNumPatches(array); ++patch) {
+                FarPatchParam param = patchTables[0]->GetPatchParam(array, patch);
+                if (param.GetDepth() > ptexLevels[param.GetFaceId()]) {
+                    failed = true;
+                }
+                float frac = param.GetParamFraction();
+                ptexArea[param.GetFaceId()] += frac * frac;
+            }
+        }
+        for (int j=0; j<(int)ptexArea.size(); ++j) {
+            if (std::fabs(ptexArea[j] - 1.0f) > 1e-4f) {
+                failed = true;
+            }
+        }
+        if (failed or not equalPatchTables(*patchTables[1], *patchTables[2])) {
+            printf("// face isolation levels fail (end-cap type %d)\n", endCapTypes[i]);
+            ++count;
+        }
+        for (int j=0; j<3; ++j) {
+            delete patchTables[j];
+        }
+    }
+
+    for (int i=0; i<3; ++i) {
+        delete refiners[i];
+    }
+    return count;
+}
+
+// Memory usage must account for the arrays of the tables, with a capacity
+// at least equal to their size
+static int
+checkMemoryUsage(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::MemoryUsage       FarMemoryUsage;
+    typedef OpenSubdiv::Far::StencilTable      FarStencilTable;
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    OpenSubdiv::Far::StencilTableFactory::Options stencilOptions;
+    stencilOptions.generateOffsets = true;
+    FarStencilTable const * stencils =
+        OpenSubdiv::Far::StencilTableFactory::Create(refiner, stencilOptions);
+
+    FarPatchTable const * patchTable = FarPatchTableFactory::Create(refiner);
+
+    int count=0;
+
+    size_t levelsUsed = 0;
+    for (int level=0; level<refiner.GetNumLevels(); ++level) {
+        FarTopologyRefiner::LevelMemoryUsage usage = refiner.GetLevelMemoryUsage(level);
+        if (usage.topology.used==0 or
+            usage.topology.reserved<usage.topology.used or
+            usage.refinement.reserved<usage.refinement.used or
+            usage.fvar.reserved<usage.fvar.used or
+            ((level<refiner.GetMaxLevel()) != (usage.refinement.used>0))) {
+            ++count;
+        }
+        levelsUsed += usage.topology.used + usage.refinement.used + usage.fvar.used;
+    }
+    FarMemoryUsage refinerUsage = refiner.GetMemoryUsage();
+    if (refinerUsage.used<levelsUsed or refinerUsage.reserved<refinerUsage.used) {
+        ++count;
+    }
+
+    FarMemoryUsage stencilUsage = stencils->GetMemoryUsage();
+    size_t stencilSize = (stencils->GetSizes().size() +
+                          stencils->GetOffsets().size() +
+                          stencils->GetControlIndices().size() +
+                          stencils->GetPassOffsets().size()) * sizeof(int) +
+                         stencils->GetWeights().size() * sizeof(float);
+    if (stencilUsage.used!=stencilSize or stencilUsage.reserved<stencilUsage.used) {
+        ++count;
+    }
+
+    // cleared tables (uploaded to devices) release their memory
+    FarStencilTable cleared(*stencils);
+    cleared.Clear();
+    if (cleared.GetMemoryUsage().reserved!=0) {
+        ++count;
+    }
+
+    FarMemoryUsage patchUsage = patchTable->GetMemoryUsage();
+    if (patchTable->GetTableMemoryUsage().patchVertices.used <
+            patchTable->GetPatchControlVerticesTable().size() * sizeof(int) or
+        patchUsage.reserved<patchUsage.used) {
+        ++count;
+    }
+
+    if (count) {
+        printf("// memory usage fails\n");
+    }
+
+    delete patchTable;
+    delete stencils;
+    return count ? 1 : 0;
+}
+
+// Trimmed refiners must release memory and still interpolate the same
+// stencils
+static int
+checkTrimmedRefiner(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    // trimming updates the refiner : it cannot be shared
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+    if (fixture.GetDesc().scheme==kCatmark) {
+        refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+    } else {
+        refiner->RefineUniform(FarTopologyRefiner::UniformOptions(maxlevel));
+    }
+
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(*refiner);
+
+    size_t used = refiner->GetMemoryUsage().used;
+
+    refiner->Trim();
+
+    FarStencilTable const * trimmed = FarStencilTableFactory::Create(*refiner);
+
+    // regular meshes may not be refined adaptively at all
+    int count=0;
+    if (refiner->GetNumLevels()>1 and (not refiner->IsTrimmed() or
+        refiner->GetMemoryUsage().used>=used or
+        not equalStencilTables(*stencils, *trimmed))) {
+        printf("// trimmed refiner fails\n");
+        ++count;
+    }
+
+    delete trimmed;
+    delete stencils;
+    delete refiner;
+    return count;
+}
+
+// Resource of the client counting the blocks allocated from it
+class CountingMemoryResource : public OpenSubdiv::Far::MemoryResource {
+public:
+    CountingMemoryResource() : numBlocks(0), numBytes(0) { }
+
+    virtual void * Allocate(size_t size) {
+        ++numBlocks;
+        numBytes += size;
+        return ::operator new(size);
+    }
+    virtual void Deallocate(void * ptr, size_t size) {
+        --numBlocks;
+        numBytes -= size;
+        ::operator delete(ptr);
+    }
+
+    int    numBlocks;
+    size_t numBytes;
+};
+
+// Refiners allocated from an arena (of the heap or a resource of the client)
+// must match those allocated from the heap
+static int
+checkArenaAllocation(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    CountingMemoryResource resource;
+
+    int count=0;
+
+    // default allocation (shared), arena and memory resource
+    FarStencilTable const * stencils[3];
+    stencils[0] = &fixture.GetStencilTable(fixture.GetDefaultRefiner(maxlevel));
+    for (int i=1; i<3; ++i) {
+        FarTopologyRefinerFactory::Options refinerOptions = fixture.GetRefinerOptions();
+        refinerOptions.memoryResource = (i==2) ? &resource : 0;
+        FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(shape, refinerOptions);
+
+        if (desc.scheme==kCatmark) {
+            FarTopologyRefiner::AdaptiveOptions options(maxlevel);
+            options.allocateFromArena = (i==1);
+            refiner->RefineAdaptive(options);
+        } else {
+            FarTopologyRefiner::UniformOptions options(maxlevel);
+            options.allocateFromArena = (i==1);
+            refiner->RefineUniform(options);
+        }
+        stencils[i] = FarStencilTableFactory::Create(*refiner);
+
+        if (i==2 and refiner->GetNumLevels()>1 and resource.numBlocks==0) {
+            printf("// arena allocation fails (resource unused)\n");
+            ++count;
+        }
+        delete refiner;
+    }
+
+    if (not equalStencilTables(*stencils[0], *stencils[1]) or
+        not equalStencilTables(*stencils[0], *stencils[2])) {
+        printf("// arena allocation fails\n");
+        ++count;
+    }
+    if (resource.numBlocks!=0 or resource.numBytes!=0) {
+        printf("// arena allocation fails (resource not released)\n");
+        ++count;
+    }
+
+    delete stencils[1];
+    delete stencils[2];
+    return count;
+}
+
+// Concurrent primvar interpolation must match serial interpolation
+static int
+checkConcurrentPrimvars(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PrimvarRefiner FarPrimvarRefiner;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetFullTopologyRefiner(maxlevel);
+
+    FarPrimvarRefiner primvarRefiner(refiner);
+
+    ReverseTaskScheduler scheduler;
+
+    int nverts = refiner.GetNumVerticesTotal(),
+        nfvars = refiner.GetNumFVarChannels() ? refiner.GetNumFVarValuesTotal() : 0,
+        nlimit = refiner.GetLevel(maxlevel).GetNumVertices();
+
+    // vertex, varying and face-varying data (arbitrary face-varying values)
+    std::vector<xyzVV> serial[3], concurrent[3];
+    for (int i=0; i<3; ++i) {
+        serial[i].resize(i==2 ? nfvars : nverts);
+        for (int j=0; j<(int)serial[i].size(); ++j) {
+            serial[i][j] = (i==2) ? xyzVV((float)j, 0.5f*j, 0.0f) :
+                xyzVV(shape.verts[(j%shape.GetNumVertices())*3],
+                      shape.verts[(j%shape.GetNumVertices())*3+1],
+                      shape.verts[(j%shape.GetNumVertices())*3+2]);
+        }
+        concurrent[i] = serial[i];
+    }
+
+    for (int pass=0; pass<2; ++pass) {
+        std::vector<xyzVV> * data = pass ? concurrent : serial;
+        int offset = 0, fvarOffset = 0;
+        for (int level=1; level<=maxlevel; ++level) {
+            int n = refiner.GetLevel(level-1).GetNumVertices(),
+                nf = nfvars ? refiner.GetLevel(level-1).GetNumFVarValues() : 0;
+
+            xyzVV * src[3] = { &data[0][offset], &data[1][offset], nfvars ? &data[2][fvarOffset] : 0 },
+                  * dst[3] = { src[0] + n, src[1] + n, nfvars ? src[2] + nf : 0 };
+
+            if (pass) {
+                primvarRefiner.Interpolate(level, src[0], dst[0], scheduler);
+                primvarRefiner.InterpolateVarying(level, src[1], dst[1], scheduler);
+                if (nfvars) {
+                    primvarRefiner.InterpolateFaceVarying(level, src[2], dst[2], 0, scheduler);
+                }
+            } else {
+                primvarRefiner.Interpolate(level, src[0], dst[0]);
+                primvarRefiner.InterpolateVarying(level, src[1], dst[1]);
+                if (nfvars) {
+                    primvarRefiner.InterpolateFaceVarying(level, src[2], dst[2]);
+                }
+            }
+            offset += n;
+            fvarOffset += nf;
+        }
+    }
+
+    std::vector<xyzVV> limit[2][3];
+    for (int pass=0; pass<2; ++pass) {
+        for (int i=0; i<3; ++i) {
+            limit[pass][i].resize(nlimit);
+        }
+        xyzVV * src = &(pass ? concurrent : serial)[0][nverts - nlimit];
+        if (pass) {
+            primvarRefiner.Limit(src, limit[pass][0], limit[pass][1], limit[pass][2], scheduler);
+        } else {
+            primvarRefiner.Limit(src, limit[pass][0], limit[pass][1], limit[pass][2]);
+        }
+    }
+
+    int count=0;
+    for (int i=0; i<3; ++i) {
+        if (serial[i]!=concurrent[i] or limit[0][i]!=limit[1][i]) {
+            printf("// concurrent primvars fails (%d)\n", i);
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+// Interpolating a set of buffers in a single pass must match the separate
+// interpolation of each buffer
+static int
+checkPrimvarBuffers(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PrimvarRefiner FarPrimvarRefiner;
+    typedef OpenSubdiv::Far::PrimvarBuffers FarPrimvarBuffers;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetFullTopologyRefiner(maxlevel);
+
+    FarPrimvarRefiner primvarRefiner(refiner);
+
+    int nverts = refiner.GetNumVerticesTotal(),
+        ncoarse = shape.GetNumVertices(),
+        nlimit = refiner.GetLevel(maxlevel).GetNumVertices();
+
+    // separate positions, and an interleaved buffer of positions and 2
+    // arbitrary floats per vertex
+    std::vector<xyzVV> verts(nverts);
+    std::vector<float> positions(nverts*3, 0.0f), interleaved(nverts*5, 0.0f);
+    for (int i=0; i<ncoarse; ++i) {
+        float const * p = &shape.verts[i*3];
+        verts[i] = xyzVV(p[0], p[1], p[2]);
+        for (int k=0; k<3; ++k) {
+            positions[i*3+k] = interleaved[i*5+k] = p[k];
+        }
+        interleaved[i*5+3] = (float)i;
+        interleaved[i*5+4] = 0.5f*i;
+    }
+
+    int offset = 0;
+    for (int level=1; level<=maxlevel; ++level) {
+        int n = refiner.GetLevel(level-1).GetNumVertices();
+
+        xyzVV * srcVerts = &verts[offset],
+              * dstVerts = srcVerts + n;
+        primvarRefiner.Interpolate(level, srcVerts, dstVerts);
+
+        FarPrimvarBuffers src, dst;
+        src.AddBuffer(&positions[offset*3], 3, 3);
+        src.AddBuffer(&interleaved[offset*5], 3, 5);
+        src.AddBuffer(&interleaved[offset*5+3], 2, 5);
+        dst.AddBuffer(&positions[(offset+n)*3], 3, 3);
+        dst.AddBuffer(&interleaved[(offset+n)*5], 3, 5);
+        dst.AddBuffer(&interleaved[(offset+n)*5+3], 2, 5);
+        primvarRefiner.Interpolate(level, src, dst);
+
+        offset += n;
+    }
+
+    // limit positions and tangents
+    std::vector<xyzVV> limit[3];
+    std::vector<float> limitBuffers[3];
+    FarPrimvarBuffers limitSrc, limitDst[3];
+    limitSrc.AddBuffer(&positions[(nverts-nlimit)*3], 3, 3);
+    for (int i=0; i<3; ++i) {
+        limit[i].resize(nlimit);
+        limitBuffers[i].resize(nlimit*3);
+        limitDst[i].AddBuffer(&limitBuffers[i][0], 3, 3);
+    }
+    xyzVV * limitVerts = &verts[nverts-nlimit];
+    primvarRefiner.Limit(limitVerts, limit[0], limit[1], limit[2]);
+    primvarRefiner.Limit(limitSrc, limitDst[0], limitDst[1], limitDst[2]);
+
+    int count=0;
+    for (int i=0; i<nverts; ++i) {
+        float const * p = verts[i].GetPos();
+        for (int k=0; k<3; ++k) {
+            if (std::abs(p[k]-positions[i*3+k]) > PRECISION or
+                std::abs(p[k]-interleaved[i*5+k]) > PRECISION) {
+                ++count;
+            }
+        }
+    }
+    for (int i=0; i<3; ++i) {
+        for (int j=0; j<nlimit; ++j) {
+            float const * p = limit[i][j].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(p[k]-limitBuffers[i][j*3+k]) > PRECISION) {
+                    ++count;
+                }
+            }
+        }
+    }
+    if (count) {
+        printf("// primvar buffers fails : %s (%d)\n", desc.name.c_str(), count);
+    }
+
+    return count;
+}
+
+// Interpolation from cached vertex masks must match the interpolation from the
+// topology, including the calls recording the masks
+static int
+checkVertexMaskCache(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PrimvarRefiner FarPrimvarRefiner;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetFullTopologyRefiner(maxlevel);
+
+    FarPrimvarRefiner primvarRefiner(refiner),
+                      cachedRefiner(refiner, /*cacheVertexMasks*/ true);
+
+    ReverseTaskScheduler scheduler;
+
+    int nverts = refiner.GetNumVerticesTotal(),
+        ncoarse = shape.GetNumVertices(),
+        nlimit = refiner.GetLevel(maxlevel).GetNumVertices();
+
+    int count=0;
+
+    // two "frames" of animated control vertices : the first records the
+    // masks, the second applies them
+    for (int frame=0; frame<2; ++frame) {
+        std::vector<xyzVV> verts(nverts), cached(nverts);
+        for (int i=0; i<ncoarse; ++i) {
+            float const * p = &shape.verts[i*3];
+            verts[i] = xyzVV(p[0], p[1]+(float)frame, p[2]*(1.0f+frame));
+        }
+        cached = verts;
+
+        int offset = 0;
+        for (int level=1; level<=maxlevel; ++level) {
+            int n = refiner.GetLevel(level-1).GetNumVertices();
+
+            xyzVV * src = &verts[offset], * dst = src + n,
+                  * cachedSrc = &cached[offset], * cachedDst = cachedSrc + n;
+            primvarRefiner.Interpolate(level, src, dst);
+            cachedRefiner.Interpolate(level, cachedSrc, cachedDst);
+
+            offset += n;
+        }
+        if (verts!=cached) {
+            printf("// vertex mask cache fails : %s (frame %d)\n", desc.name.c_str(), frame);
+            ++count;
+        }
+
+        // limit positions and tangents : the cached masks are recorded by the
+        // serial limit and applied by the concurrent one
+        std::vector<xyzVV> limit[3], cachedLimit[3];
+        for (int i=0; i<3; ++i) {
+            limit[i].resize(nlimit);
+            cachedLimit[i].resize(nlimit);
+        }
+        primvarRefiner.Limit(&verts[nverts-nlimit], limit[0], limit[1], limit[2]);
+        if (frame==0) {
+            cachedRefiner.Limit(&cached[nverts-nlimit], cachedLimit[0], cachedLimit[1], cachedLimit[2]);
+        } else {
+            cachedRefiner.Limit(&cached[nverts-nlimit], cachedLimit[0], cachedLimit[1], cachedLimit[2], scheduler);
+        }
+        for (int i=0; i<3; ++i) {
+            for (int j=0; j<nlimit; ++j) {
+                float const * a = limit[i][j].GetPos(),
+                            * b = cachedLimit[i][j].GetPos();
+                if (std::abs(a[0]-b[0])>1e-5f or std::abs(a[1]-b[1])>1e-5f or std::abs(a[2]-b[2])>1e-5f) {
+                    printf("// vertex mask cache fails : %s (limit %d, frame %d)\n",
+                        desc.name.c_str(), i, frame);
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+    if (cachedRefiner.GetVertexMasksMemoryUsage().used==0) {
+        printf("// vertex mask cache fails : %s (empty cache)\n", desc.name.c_str());
+        ++count;
+    }
+
+    return count;
+}
+
+// Topology completed from given edges must be identical to the topology
+// completed from the face-vertices only
+static int
+checkDescriptorEdges(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::TopologyDescriptor                      Descriptor;
+    typedef OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>      DescriptorFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    Descriptor descriptor;
+    descriptor.numVertices = shape.GetNumVertices();
+    descriptor.numFaces = shape.GetNumFaces();
+    descriptor.numVertsPerFace = &shape.nvertsPerFace[0];
+    descriptor.vertIndicesPerFace = &shape.faceverts[0];
+    descriptor.isLeftHanded = shape.isLeftHanded;
+
+    DescriptorFactory::Options options(GetSdcType(shape), GetSdcOptions(shape));
+
+    // face-vertices only and given edges
+    FarTopologyRefiner * refiners[2];
+    std::vector<int> faceEdges;
+    for (int i=0; i<2; ++i) {
+        if (i==1) {
+            OpenSubdiv::Far::TopologyLevel const & base = refiners[0]->GetLevel(0);
+            for (int face=0; face<base.GetNumFaces(); ++face) {
+                OpenSubdiv::Far::ConstIndexArray fEdges = base.GetFaceEdges(face);
+                for (int edge=0; edge<fEdges.size(); ++edge) {
+                    faceEdges.push_back(fEdges[shape.isLeftHanded ? (fEdges.size()-1-edge) : edge]);
+                }
+            }
+            descriptor.numEdges = base.GetNumEdges();
+            descriptor.faceEdgeIndices = &faceEdges[0];
+        }
+        refiners[i] = DescriptorFactory::Create(descriptor, options);
+
+        FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+        uniformOptions.fullTopologyInLastLevel = true;
+        refiners[i]->RefineUniform(uniformOptions);
+    }
+
+    int count = compareTopology(*refiners[0], *refiners[1]);
+    if (count) {
+        printf("// descriptor edges fails : %s (%d components differ)\n",
+            desc.name.c_str(), count);
+    }
+    delete refiners[0];
+    delete refiners[1];
+    return count;
+}
+
+// Instances sharing the topology of a refiner must match refiners created
+// from the mesh, whether shared, refined again, sharpened (copied on write)
+// or given face-varying channels, and leave the source refiner unmodified
+static int
+checkSharedTopology(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    // face-varying channels do not support sharpness updates
+    Shape const & shape = fixture.GetShapeWithoutFVar(),
+                & fvarShape = fixture.GetShape();
+
+    FarTopologyRefinerFactory::Options options(GetSdcType(shape), GetSdcOptions(shape));
+
+    FarTopologyRefiner::UniformOptions uniformOptions(maxlevel),
+                                       lowerOptions(maxlevel-1);
+    uniformOptions.fullTopologyInLastLevel = true;
+    lowerOptions.fullTopologyInLastLevel = true;
+
+    // refiner 0 is the source, refiner 1 is sharpened and 2 refined at a lower level
+    FarTopologyRefiner * refiners[3];
+    for (int i=0; i<3; ++i) {
+        refiners[i] = FarTopologyRefinerFactory::Create(shape, options);
+    }
+
+    OpenSubdiv::Far::TopologyLevel const & base = refiners[0]->GetLevel(0);
+
+    std::vector<OpenSubdiv::Far::Index> edges;
+    std::vector<float> sharpness;
+    for (int e=0; e<base.GetNumEdges(); e+=2) {
+        edges.push_back(e);
+        sharpness.push_back(3.0f);
+    }
+    OpenSubdiv::Far::ConstIndexArray edgeArray(&edges[0], (int)edges.size()),
+                                     noVertices(0, 0);
+
+    refiners[1]->UpdateBaseSharpness(edgeArray, &sharpness[0], noVertices, 0);
+    refiners[0]->RefineUniform(uniformOptions);
+    refiners[1]->RefineUniform(uniformOptions);
+    refiners[2]->RefineUniform(lowerOptions);
+
+    FarTopologyRefiner * shared = FarTopologyRefinerFactory::Create(*refiners[0]),
+                       * sharpened = FarTopologyRefinerFactory::Create(*refiners[0]),
+                       * lower = FarTopologyRefinerFactory::Create(*refiners[0]);
+
+    sharpened->UpdateBaseSharpness(edgeArray, &sharpness[0], noVertices, 0);
+    lower->Unrefine();
+    lower->RefineUniform(lowerOptions);
+
+    int count=0;
+    if (shared->GetNumSharedLevels() != refiners[0]->GetNumLevels() or
+        sharpened->GetNumSharedLevels() != 0 or lower->GetNumSharedLevels() != 1 or
+        shared->GetMemoryUsage().used >= refiners[0]->GetMemoryUsage().used) {
+        printf("// shared levels fail : %s\n", desc.name.c_str());
+        ++count;
+    }
+    count += compareTopology(*shared, *refiners[0]);
+    count += compareSharpness(*sharpened, *refiners[1]);
+    count += compareTopology(*lower, *refiners[2]);
+
+    // the source remains unsharpened
+    FarTopologyRefiner * reference = FarTopologyRefinerFactory::Create(shape, options);
+    reference->RefineUniform(uniformOptions);
+    count += compareSharpness(*refiners[0], *reference);
+
+    // face-varying channels assigned to a copy of the base level
+    FarTopologyRefiner * fvar = FarTopologyRefinerFactory::Create(fvarShape, options),
+                       * fvarInstance = FarTopologyRefinerFactory::Create(*refiners[0], fvarShape);
+    fvar->RefineUniform(uniformOptions);
+    fvarInstance->RefineUniform(uniformOptions);
+
+    count += compareTopology(*fvarInstance, *fvar);
+    if (fvarInstance->GetNumFVarChannels() != fvar->GetNumFVarChannels()) {
+        ++count;
+    } else {
+        for (int channel=0; channel<fvar->GetNumFVarChannels(); ++channel) {
+            OpenSubdiv::Far::TopologyLevel const & a = fvarInstance->GetLevel(maxlevel),
+                                                 & b = fvar->GetLevel(maxlevel);
+            if (a.GetNumFVarValues(channel) != b.GetNumFVarValues(channel)) {
+                ++count;
+                continue;
+            }
+            for (int face=0; face<a.GetNumFaces(); ++face) {
+                if (not equalArrays(a.GetFaceFVarValues(face, channel),
+                                    b.GetFaceFVarValues(face, channel))) {
+                    ++count;
+                }
+            }
+        }
+    }
+    if (count) {
+        printf("// shared topology fails : %s (%d components differ)\n",
+            desc.name.c_str(), count);
+    }
+
+    delete fvarInstance;
+    delete fvar;
+    delete reference;
+    delete shared;
+    delete sharpened;
+    delete lower;
+    for (int i=0; i<3; ++i) {
+        delete refiners[i];
+    }
+    return count;
+}
+
+// Face-varying channels updated after refinement must match those refined
+// with the vertex topology, in both the refiner and its patch table
+static int
+checkFVarChannelUpdate(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape(),
+                & plainShape = fixture.GetShapeWithoutFVar();
+
+    FarTopologyRefinerFactory::Options options = fixture.GetRefinerOptions();
+
+    // refiner 0 is updated after refinement (replacing the channel of the
+    // shape if any), refiner 1 before refinement
+    FarTopologyRefiner * refiners[2] = {
+        FarTopologyRefinerFactory::Create(shape, options),
+        FarTopologyRefinerFactory::Create(plainShape, options) };
+
+    // values shared by the vertices of most faces, with seams around every
+    // third face
+    OpenSubdiv::Far::TopologyLevel const & base = refiners[0]->GetLevel(0);
+
+    std::vector<OpenSubdiv::Far::Index> values, remap;
+    for (int face=0; face<base.GetNumFaces(); ++face) {
+        OpenSubdiv::Far::ConstIndexArray fVerts = base.GetFaceVertices(face);
+        for (int vert=0; vert<fVerts.size(); ++vert) {
+            values.push_back((face % 3) ? fVerts[vert] :
+                (base.GetNumVertices() + (int)values.size()));
+        }
+    }
+    remap.resize(base.GetNumVertices() + values.size(), -1);
+    int numValues = 0;
+    for (int i=0; i<(int)values.size(); ++i) {
+        if (remap[values[i]] < 0) {
+            remap[values[i]] = numValues++;
+        }
+        values[i] = remap[values[i]];
+    }
+    OpenSubdiv::Far::ConstIndexArray valueArray(&values[0], (int)values.size());
+
+    OpenSubdiv::Sdc::Options::FVarLinearInterpolation interpolation =
+        OpenSubdiv::Sdc::Options::FVAR_LINEAR_BOUNDARIES;
+
+    refiners[1]->UpdateFVarChannel(0, numValues, valueArray, interpolation);
+
+    bool adaptive = (desc.scheme==kCatmark);
+    for (int i=0; i<2; ++i) {
+        if (adaptive) {
+            refiners[i]->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+        } else {
+            FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+            uniformOptions.fullTopologyInLastLevel = true;
+            refiners[i]->RefineUniform(uniformOptions);
+        }
+    }
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.generateFVarTables = true;
+
+    FarPatchTable * table = FarPatchTableFactory::Create(*refiners[0], patchOptions);
+
+    int count=0;
+    if (not refiners[0]->UpdateFVarChannel(0, numValues, valueArray, interpolation) or
+        refiners[0]->GetNumFVarChannels() != 1) {
+        printf("// face-varying update fails : %s\n", desc.name.c_str());
+        delete table;
+        delete refiners[0];
+        delete refiners[1];
+        return 1;
+    }
+    for (int level=0; level<refiners[1]->GetNumLevels(); ++level) {
+        OpenSubdiv::Far::TopologyLevel const & a = refiners[0]->GetLevel(level),
+                                             & b = refiners[1]->GetLevel(level);
+        if (a.GetNumFVarValues() != b.GetNumFVarValues()) {
+            ++count;
+            continue;
+        }
+        for (int face=0; face<a.GetNumFaces(); ++face) {
+            if (not equalArrays(a.GetFaceFVarValues(face), b.GetFaceFVarValues(face))) {
+                ++count;
+            }
+        }
+    }
+
+    FarPatchTable const * expected = FarPatchTableFactory::Create(*refiners[1], patchOptions);
+    if (not FarPatchTableFactory::UpdateFVarChannels(*refiners[0], *table, patchOptions) or
+        not equalPatchTables(*table, *expected)) {
+        ++count;
+    }
+    if (count) {
+        printf("// face-varying update fails : %s (%d components differ)\n",
+            desc.name.c_str(), count);
+    }
+
+    delete expected;
+    delete table;
+    delete refiners[0];
+    delete refiners[1];
+    return count;
+}
+
+// Deferred face-varying channels must be gathered identical to those of
+// other tables
+static int
+checkDeferredFVarChannels(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (fixture.GetBaseRefiner().GetNumFVarChannels()==0) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetDefaultRefiner(maxlevel);
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.generateFVarTables = true;
+    options.generateAllLevels = (desc.scheme!=kCatmark);
+
+    ReverseTaskScheduler scheduler;
+    options.taskScheduler = &scheduler;
+
+    FarPatchTable const * expected = FarPatchTableFactory::Create(refiner, options);
+
+    options.deferFVarChannels = true;
+    FarPatchTable * deferred = FarPatchTableFactory::Create(refiner, options);
+
+    int count=0;
+    for (int channel=0; channel<deferred->GetNumFVarChannels(); ++channel) {
+        if (not deferred->GetFVarValues(channel).empty() or
+            not FarPatchTableFactory::BuildFVarChannel(refiner, *deferred, channel, options)) {
+            ++count;
+        }
+    }
+    if (count or not equalPatchTables(*deferred, *expected)) {
+        printf("// deferred face-varying channels fail : %s\n", desc.name.c_str());
+        ++count;
+    }
+
+    delete expected;
+    delete deferred;
+    return count;
+}
+
+// Bicubic face-varying patches of values matching the vertex topology must
+// evaluate to the limit of the vertex patches
+static int
+checkBicubicFVarPatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PrimvarRefiner    FarPrimvarRefiner;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+    // face-varying values of the vertices (no seams)
+    OpenSubdiv::Far::TopologyLevel const & base = refiner->GetLevel(0);
+
+    std::vector<OpenSubdiv::Far::Index> values;
+    for (int face=0; face<base.GetNumFaces(); ++face) {
+        OpenSubdiv::Far::ConstIndexArray fVerts = base.GetFaceVertices(face);
+        values.insert(values.end(), fVerts.begin(), fVerts.end());
+    }
+    refiner->UpdateFVarChannel(0, base.GetNumVertices(),
+        OpenSubdiv::Far::ConstIndexArray(&values[0], (int)values.size()),
+        OpenSubdiv::Sdc::Options::FVAR_LINEAR_NONE);
+
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.generateFVarTables = true;
+    options.generateFVarBicubicPatches = true;
+
+    FarPatchTable const * table = FarPatchTableFactory::Create(*refiner, options);
+
+    // positions as vertex and face-varying data
+    FarPrimvarRefiner primvarRefiner(*refiner);
+
+    int nverts = refiner->GetNumVerticesTotal();
+
+    std::vector<xyzVV> verts(nverts), fvars(refiner->GetNumFVarValuesTotal());
+    for (int i=0; i<base.GetNumVertices(); ++i) {
+        verts[i] = fvars[i] = xyzVV(shape.verts[i*3], shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    for (int level=1, offset=0, fvarOffset=0; level<refiner->GetNumLevels(); ++level) {
+        int n = refiner->GetLevel(level-1).GetNumVertices(),
+            nf = refiner->GetLevel(level-1).GetNumFVarValues();
+        xyzVV * src[2] = { &verts[offset], &fvars[fvarOffset] },
+              * dst[2] = { src[0] + n, src[1] + nf };
+        primvarRefiner.Interpolate(level, src[0], dst[0]);
+        primvarRefiner.InterpolateFaceVarying(level, src[1], dst[1]);
+        offset += n;
+        fvarOffset += nf;
+    }
+
+    int count=0, numCandidates=0, numBicubic=0;
+    for (int array=0, patchIndex=0; array<table->GetNumPatchArrays(); ++array) {
+        if (table->GetPatchArrayDescriptor(array).GetType() !=
+            OpenSubdiv::Far::PatchDescriptor::REGULAR) {
+            patchIndex += table->GetNumPatches(array);
+            continue;
+        }
+        for (int patch=0; patch<table->GetNumPatches(array); ++patch, ++patchIndex) {
+            OpenSubdiv::Far::ConstIndexArray cvs = table->GetPatchVertices(array, patch);
+
+            bool candidate = table->GetSharpnessIndexTable().empty() or
+                (table->GetSingleCreasePatchSharpnessValue(array, patch) == 0.0f);
+            for (int k=0; k<cvs.size(); ++k) {
+                candidate &= (cvs[k] < nverts);
+            }
+            numCandidates += candidate;
+
+            OpenSubdiv::Far::PatchParam param = table->GetPatchFVarPatchParam(array, patch);
+            if (not param.IsRegular()) {
+                continue;
+            }
+            ++numBicubic;
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * cvs.size();
+
+            float frac = param.GetParamFraction(),
+                  s = (param.GetU() + 0.25f) * frac,
+                  t = (param.GetV() + 0.75f) * frac;
+
+            float wP[20], wDs[20], wDt[20];
+            xyzVV p[2];
+
+            table->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+            p[0].Clear();
+            for (int k=0; k<cvs.size(); ++k) {
+                p[0].AddWithWeight(verts[cvs[k]], wP[k]);
+            }
+
+            OpenSubdiv::Far::ConstIndexArray fvalues = table->GetPatchFVarValues(handle);
+            table->EvaluateBasisFaceVarying(handle, s, t, wP, wDs, wDt);
+            p[1].Clear();
+            for (int k=0; k<fvalues.size(); ++k) {
+                p[1].AddWithWeight(fvars[fvalues[k]], wP[k]);
+            }
+
+            for (int k=0; k<3; ++k) {
+                if (std::abs(p[0].GetPos()[k] - p[1].GetPos()[k]) > 1e-5f) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+    if (count or numBicubic != numCandidates) {
+        printf("// bicubic face-varying patches fail : %s (%d of %d patches differ)\n",
+            desc.name.c_str(), count + numCandidates - numBicubic, numCandidates);
+        ++count;
+    }
+
+    // deferred and serialized channels must be identical
+    options.deferFVarChannels = true;
+    FarPatchTable * deferred = FarPatchTableFactory::Create(*refiner, options);
+    FarPatchTableFactory::BuildFVarChannel(*refiner, *deferred, 0, options);
+
+    std::vector<unsigned char> data;
+    OpenSubdiv::Far::TableSerializer::Write(*table, data);
+    FarPatchTable const * read =
+        OpenSubdiv::Far::TableSerializer::ReadPatchTable(&data[0], data.size());
+
+    if (not equalPatchTables(*deferred, *table) or
+        not read or not equalPatchTables(*read, *table)) {
+        printf("// bicubic face-varying patches fail : %s (deferred or serialized)\n",
+            desc.name.c_str());
+        ++count;
+    }
+
+    delete read;
+    delete deferred;
+    delete table;
+    delete refiner;
+    return count;
+}
+
+// Face-varying channels of the vertex indices alias the vertex topology and
+// must refine, interpolate and gather as a channel of the same topology with
+// permuted values does
+static int
+checkVertexAliasFVarChannels(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PrimvarRefiner    FarPrimvarRefiner;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+    // channel 0 of the vertex indices, channel 1 of the reversed vertex indices
+    OpenSubdiv::Far::TopologyLevel const & base = refiner->GetLevel(0);
+
+    int nverts = base.GetNumVertices();
+
+    std::vector<OpenSubdiv::Far::Index> values[2];
+    for (int face=0; face<base.GetNumFaces(); ++face) {
+        OpenSubdiv::Far::ConstIndexArray fVerts = base.GetFaceVertices(face);
+        for (int vert=0; vert<fVerts.size(); ++vert) {
+            values[0].push_back(fVerts[vert]);
+            values[1].push_back(nverts - 1 - fVerts[vert]);
+        }
+    }
+    for (int channel=0; channel<2; ++channel) {
+        refiner->UpdateFVarChannel(channel, nverts,
+            OpenSubdiv::Far::ConstIndexArray(&values[channel][0], (int)values[channel].size()),
+            OpenSubdiv::Sdc::Options::FVAR_LINEAR_NONE);
+    }
+
+    FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+    uniformOptions.fullTopologyInLastLevel = true;
+    refiner->RefineUniform(uniformOptions);
+
+    // refined values of both channels are those of the refined vertices
+    int count=0;
+    for (int level=1; level<refiner->GetNumLevels(); ++level) {
+        OpenSubdiv::Far::TopologyLevel const & refLevel = refiner->GetLevel(level);
+        if (refLevel.GetNumFVarValues(0) != refLevel.GetNumVertices() or
+            refLevel.GetNumFVarValues(1) != refLevel.GetNumVertices()) {
+            ++count;
+            continue;
+        }
+        for (int face=0; face<refLevel.GetNumFaces(); ++face) {
+            if (not equalArrays(refLevel.GetFaceFVarValues(face, 0), refLevel.GetFaceVertices(face)) or
+                not equalArrays(refLevel.GetFaceFVarValues(face, 1), refLevel.GetFaceVertices(face))) {
+                ++count;
+            }
+        }
+    }
+
+    // positions as face-varying data of both channels
+    FarPrimvarRefiner primvarRefiner(*refiner);
+
+    std::vector<xyzVV> fvars[2];
+    for (int channel=0; channel<2; ++channel) {
+        fvars[channel].resize(refiner->GetNumFVarValuesTotal(channel));
+        for (int i=0; i<nverts; ++i) {
+            int value = channel ? (nverts - 1 - i) : i;
+            fvars[channel][value] = xyzVV(shape.verts[i*3], shape.verts[i*3+1], shape.verts[i*3+2]);
+        }
+    }
+    for (int level=1, offset=0; level<refiner->GetNumLevels(); ++level) {
+        int n = refiner->GetLevel(level-1).GetNumFVarValues();
+        for (int channel=0; channel<2; ++channel) {
+            xyzVV * src = &fvars[channel][offset],
+                  * dst = src + n;
+            primvarRefiner.InterpolateFaceVarying(level, src, dst, channel);
+        }
+        offset += n;
+    }
+    int nlast = refiner->GetLevel(maxlevel).GetNumFVarValues(),
+        lastOffset = (int)fvars[0].size() - nlast;
+
+    std::vector<xyzVV> limits[2];
+    for (int channel=0; channel<2; ++channel) {
+        limits[channel].resize(nlast);
+
+        xyzVV * src = &fvars[channel][lastOffset],
+              * dst = &limits[channel][0];
+        primvarRefiner.LimitFaceVarying(src, dst, channel);
+    }
+    for (int i=nverts; i<(int)fvars[0].size(); ++i) {
+        for (int k=0; k<3; ++k) {
+            if (fvars[0][i].GetPos()[k] != fvars[1][i].GetPos()[k]) {
+                ++count;
+                break;
+            }
+        }
+    }
+    for (int i=0; i<nlast; ++i) {
+        for (int k=0; k<3; ++k) {
+            if (limits[0][i].GetPos()[k] != limits[1][i].GetPos()[k]) {
+                ++count;
+                break;
+            }
+        }
+    }
+
+    // uniform patches of both channels are the patch vertices (other than the
+    // triangles of Loop gathered as quads) -- also once serialized, or the
+    // vertices reordered
+    FarPatchTableFactory::Options options(maxlevel);
+    options.generateFVarTables = true;
+    options.generateAllLevels = true;
+
+    FarPatchTable * table = FarPatchTableFactory::Create(*refiner, options);
+
+    std::vector<unsigned char> data;
+    OpenSubdiv::Far::TableSerializer::Write(*table, data);
+    FarPatchTable const * read =
+        OpenSubdiv::Far::TableSerializer::ReadPatchTable(&data[0], data.size());
+
+    std::vector<OpenSubdiv::Far::Index> const & cvs = table->GetPatchControlVerticesTable();
+    OpenSubdiv::Far::ConstIndexArray cvArray(&cvs[0], (int)cvs.size());
+    if (not equalArrays(table->GetFVarValues(0), table->GetFVarValues(1)) or
+        (desc.scheme!=kLoop and not equalArrays(table->GetFVarValues(0), cvArray)) or
+        not read or not equalPatchTables(*read, *table)) {
+        ++count;
+    }
+    size_t valuesSize = table->GetFVarValues(1).size() * sizeof(OpenSubdiv::Far::Index);
+    if (desc.scheme!=kLoop and table->GetTableMemoryUsage().fvar.used >= 2 * valuesSize) {
+        ++count;
+    }
+
+    if (FarPatchTableFactory::OptimizeVertexCache(*table, 0, nverts) and
+        not equalArrays(table->GetFVarValues(0), table->GetFVarValues(1))) {
+        ++count;
+    }
+    std::vector<OpenSubdiv::Far::Index> permutation;
+    if (FarPatchTableFactory::OptimizeVertexCache(*table, &permutation, nverts) and
+        not equalArrays(table->GetFVarValues(0), table->GetFVarValues(1))) {
+        ++count;
+    }
+
+    if (count) {
+        printf("// vertex alias face-varying channels fail : %s (%d components differ)\n",
+            desc.name.c_str(), count);
+    }
+
+    delete read;
+    delete table;
+    delete refiner;
+    return count;
+}
+
+// Second derivatives of the basis of regular and bilinear patches must match
+// the finite differences of their first derivatives
+static int
+checkSecondDerivatives(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor   FarPatchDescriptor;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    bool uniform = desc.scheme!=kCatmark;
+
+    FarTopologyRefiner const & refiner = uniform ?
+        fixture.GetUniformRefiner(1) : fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * table = FarPatchTableFactory::Create(refiner, options);
+
+    int count=0;
+    for (int array=0, patchIndex=0; array<table->GetNumPatchArrays(); ++array) {
+        FarPatchDescriptor::Type type = table->GetPatchArrayDescriptor(array).GetType();
+        for (int patch=0; patch<table->GetNumPatches(array); ++patch, ++patchIndex) {
+            if (type!=FarPatchDescriptor::REGULAR and type!=FarPatchDescriptor::QUADS) {
+                continue;
+            }
+            OpenSubdiv::Far::PatchParam param = table->GetPatchParam(array, patch);
+
+            // derivatives of the children of non-quad faces are scaled by
+            // their depth rather than by their parametric fraction
+            if (param.NonQuadRoot()) {
+                continue;
+            }
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * table->GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+            float frac = param.GetParamFraction(),
+                  s = (param.GetU() + 0.25f) * frac,
+                  t = (param.GetV() + 0.75f) * frac,
+                  h = 1e-3f * frac,
+                  tolerance = 1e-2f / (frac * frac);
+
+            float wP[16], wDs[16], wDt[16], wDss[16], wDst[16], wDtt[16],
+                  wDsH[16], wDtH[16], wDsK[16], wDtK[16];
+
+            table->EvaluateBasis(handle, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+            table->EvaluateBasis(handle, s+h, t, wP, wDsH, wDtH);
+            table->EvaluateBasis(handle, s, t+h, wP, wDsK, wDtK);
+
+            int ncvs = (type==FarPatchDescriptor::REGULAR) ? 16 : 4;
+            for (int k=0; k<ncvs; ++k) {
+                if (std::abs((wDsH[k]-wDs[k])/h - wDss[k]) > tolerance or
+                    std::abs((wDtH[k]-wDt[k])/h - wDst[k]) > tolerance or
+                    std::abs((wDsK[k]-wDs[k])/h - wDst[k]) > tolerance or
+                    std::abs((wDtK[k]-wDt[k])/h - wDtt[k]) > tolerance) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+    if (count) {
+        printf("// second derivatives fail : %s (%d patches differ)\n",
+            desc.name.c_str(), count);
+    }
+
+    delete table;
+    return count;
+}
+
+// Limit stencils of patch points, applied to the patch points evaluated from
+// the control vertices, must evaluate the limit stencils of the control vertices
+static int
+checkPatchPointStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::LimitStencilTable        FarLimitStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTableFactory FarLimitStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarStencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateOffsets = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+
+    if (FarStencilTable const * localPoints = patches->GetLocalPointStencilTable()) {
+        FarStencilTable const * table =
+            FarStencilTableFactory::AppendLocalPointStencilTable(refiner, stencils, localPoints);
+        delete stencils;
+        stencils = table;
+    }
+
+    OpenSubdiv::Far::PtexIndices ptexIndices(refiner);
+
+    static float const s[3] = { 0.0f, 0.25f, 0.75f },
+                       t[3] = { 0.5f, 0.75f, 1.0f };
+
+    FarLimitStencilTableFactory::LocationArrayVec locations(ptexIndices.GetNumFaces());
+    for (int i=0; i<(int)locations.size(); ++i) {
+        locations[i].ptexIdx = i;
+        locations[i].numLocations = 3;
+        locations[i].s = s;
+        locations[i].t = t;
+    }
+
+    FarLimitStencilTableFactory::Options limitOptions;
+    FarLimitStencilTable const * limit = FarLimitStencilTableFactory::Create(
+        refiner, locations, limitOptions, stencils, patches);
+
+    limitOptions.patchPointStencils = true;
+    FarLimitStencilTable const * patchPoint = FarLimitStencilTableFactory::Create(
+        refiner, locations, limitOptions, stencils, patches);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    int nStencils = limit->GetNumStencils();
+
+    std::vector<xyzVV> points(stencils->GetNumStencils()),
+                       a(nStencils), aDu(nStencils), aDv(nStencils),
+                       b(nStencils), bDu(nStencils), bDv(nStencils);
+
+    stencils->UpdateValues(&controlVerts[0], &points[0]);
+
+    limit->UpdateValues(&controlVerts[0], &a[0]);
+    limit->UpdateDerivs(&controlVerts[0], &aDu[0], &aDv[0]);
+    patchPoint->UpdateValues(&points[0], &b[0]);
+    patchPoint->UpdateDerivs(&points[0], &bDu[0], &bDv[0]);
+
+    int nfails = patchPoint->GetNumStencils()!=nStencils;
+    for (int i=0; not nfails and i<nStencils; ++i) {
+        // patch point stencils hold at most the 20 points of a Gregory patch
+        if (patchPoint->GetSizes()[i] > 20) ++nfails;
+        for (int k=0; k<3; ++k) {
+            if (std::abs(a[i].GetPos()[k]-b[i].GetPos()[k]) > SUMMATION_PRECISION or
+                std::abs(aDu[i].GetPos()[k]-bDu[i].GetPos()[k]) > 1e-3 or
+                std::abs(aDv[i].GetPos()[k]-bDv[i].GetPos()[k]) > 1e-3) ++nfails;
+        }
+    }
+    if (nfails) {
+        printf("// patch point stencils fails : %s\n", desc.name.c_str());
+    }
+
+    delete limit;
+    delete patchPoint;
+    delete stencils;
+    delete patches;
+    return nfails ? 1 : 0;
+}
+
+// Bezier points of regular patches must evaluate the B-spline patches
+static int
+checkBezierPatchStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor     FarPatchDescriptor;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarStencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateOffsets = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+
+    FarStencilTable const * bezierStencils =
+        FarStencilTableFactory::CreateBezierPatchStencilTable(*patches);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    int nVerts = stencils->GetNumStencils();
+    std::vector<xyzVV> points(nVerts + patches->GetNumLocalPoints()),
+                       bezier(bezierStencils->GetNumStencils());
+    stencils->UpdateValues(&controlVerts[0], &points[0]);
+    if (patches->GetNumLocalPoints()) {
+        patches->ComputeLocalPointValues(&points[0], &points[nVerts]);
+    }
+    bezierStencils->UpdateValues(&points[0], &bezier[0]);
+
+    int nfails = bezierStencils->GetNumStencils() !=
+        (int)patches->GetPatchControlVerticesTable().size();
+
+    for (int array=0, patchIndex=0; array<patches->GetNumPatchArrays(); ++array) {
+        int ncvs = patches->GetPatchArrayDescriptor(array).GetNumControlVertices();
+        for (int patch=0; patch<patches->GetNumPatches(array); ++patch, ++patchIndex) {
+            if (patches->GetPatchArrayDescriptor(array).GetType()!=FarPatchDescriptor::REGULAR) {
+                continue;
+            }
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvs;
+
+            OpenSubdiv::Far::PatchParam param = patches->GetPatchParam(array, patch);
+
+            float frac = param.GetParamFraction(),
+                  s = (param.GetU() + 0.25f) * frac,
+                  t = (param.GetV() + 0.75f) * frac;
+
+            float wP[16], wDs[16], wDt[16];
+            patches->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+
+            OpenSubdiv::Far::ConstIndexArray cvs = patches->GetPatchVertices(handle);
+
+            // Bernstein polynomials at the normalized coordinates
+            param.Normalize(s, t);
+            float bs[4] = { (1-s)*(1-s)*(1-s), 3*s*(1-s)*(1-s), 3*s*s*(1-s), s*s*s },
+                  bt[4] = { (1-t)*(1-t)*(1-t), 3*t*(1-t)*(1-t), 3*t*t*(1-t), t*t*t };
+
+            int first = (int)(&cvs[0] - &patches->GetPatchControlVerticesTable()[0]);
+
+            xyzVV a, b;
+            a.Clear();
+            b.Clear();
+            for (int k=0; k<16; ++k) {
+                a.AddWithWeight(points[cvs[k]], wP[k]);
+                b.AddWithWeight(bezier[first + k], bs[k%4] * bt[k/4]);
+            }
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a.GetPos()[k]-b.GetPos()[k]) > SUMMATION_PRECISION) ++nfails;
+            }
+        }
+    }
+    if (nfails) {
+        printf("// bezier patch stencils fails : %s\n", desc.name.c_str());
+    }
+
+    delete bezierStencils;
+    delete stencils;
+    delete patches;
+    return nfails ? 1 : 0;
+}
+
+// Single-crease patches, evaluated across their semi-sharp crease, must match
+// the limit surface of the patches isolating the crease
+static int
+checkSingleCreasePatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    int nControlVerts = (int)shape.verts.size()/3;
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    FarTopologyRefiner const * refiners[2] = {
+        &fixture.GetAdaptiveRefiner(maxlevel),
+        &fixture.GetSingleCreaseRefiner(maxlevel) };
+    FarPatchTable const * patches[2];
+    FarPatchMap * patchMaps[2];
+    std::vector<xyzVV> points[2];
+    int numSingleCrease = 0;
+    for (int i=0; i<2; ++i) {
+        FarStencilTableFactory::Options options;
+        options.generateControlVerts = true;
+        options.generateOffsets = true;
+        FarStencilTable const * stencils = FarStencilTableFactory::Create(*refiners[i], options);
+
+        FarPatchTableFactory::Options patchOptions(maxlevel);
+        patchOptions.useSingleCreasePatch = (i==1);
+        patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        patches[i] = FarPatchTableFactory::Create(*refiners[i], patchOptions);
+        patchMaps[i] = new FarPatchMap(*patches[i]);
+
+        int nVerts = stencils->GetNumStencils();
+        points[i].resize(nVerts + patches[i]->GetNumLocalPoints());
+        stencils->UpdateValues(&controlVerts[0], &points[i][0]);
+        if (patches[i]->GetNumLocalPoints()) {
+            patches[i]->ComputeLocalPointValues(&points[i][0], &points[i][nVerts]);
+        }
+        delete stencils;
+    }
+    for (int array=0; array<patches[1]->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patches[1]->GetNumPatches(array); ++patch) {
+            if (patches[1]->GetSingleCreasePatchSharpnessValue(array, patch) > 0.0f) {
+                ++numSingleCrease;
+            }
+        }
+    }
+
+    OpenSubdiv::Far::PtexIndices ptexIndices(*refiners[0]);
+
+    static float const params[4] = { 0.1f, 0.35f, 0.6f, 0.85f };
+
+    int nfails = 0;
+    for (int face=0; face<ptexIndices.GetNumFaces(); ++face) {
+        for (int j=0; j<16; ++j) {
+            float s = params[j%4],
+                  t = params[j/4];
+
+            xyzVV limit[2], du[2];
+            for (int i=0; i<2; ++i) {
+                FarPatchMap::Handle const * handle = patchMaps[i]->FindPatch(face, s, t);
+                assert(handle);
+
+                float wP[20], wDs[20], wDt[20];
+                patches[i]->EvaluateBasis(*handle, s, t, wP, wDs, wDt);
+
+                OpenSubdiv::Far::ConstIndexArray cvs = patches[i]->GetPatchVertices(*handle);
+
+                limit[i].Clear();
+                du[i].Clear();
+                for (int k=0; k<cvs.size(); ++k) {
+                    limit[i].AddWithWeight(points[i][cvs[k]], wP[k]);
+                    du[i].AddWithWeight(points[i][cvs[k]], wDs[k]);
+                }
+            }
+            for (int k=0; k<3; ++k) {
+                if (std::abs(limit[0].GetPos()[k]-limit[1].GetPos()[k]) > 1e-4f or
+                    std::abs(du[0].GetPos()[k]-du[1].GetPos()[k]) > 1e-3f) {
+                    ++nfails;
+                    break;
+                }
+            }
+        }
+    }
+    if (nfails) {
+        printf("// single-crease patches fail : %s (%d single-crease patches,"
+            " %d samples differ)\n", desc.name.c_str(), numSingleCrease, nfails);
+    }
+
+    for (int i=0; i<2; ++i) {
+        delete patchMaps[i];
+        delete patches[i];
+    }
+    return nfails ? 1 : 0;
+}
+
+// Gregory end caps sharing their patch points must evaluate as the end caps
+// which don't
+static int
+checkSharedEndCapPoints(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor     FarPatchDescriptor;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarStencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateOffsets = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    FarPatchTable const * patches[2];
+    std::vector<xyzVV> points[2];
+    for (int i=0; i<2; ++i) {
+        FarPatchTableFactory::Options patchOptions(maxlevel);
+        patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        patchOptions.shareEndCapPatchPoints = (i==1);
+        patches[i] = FarPatchTableFactory::Create(refiner, patchOptions);
+
+        int nVerts = stencils->GetNumStencils();
+        points[i].resize(nVerts + patches[i]->GetNumLocalPoints());
+        stencils->UpdateValues(&controlVerts[0], &points[i][0]);
+        if (patches[i]->GetNumLocalPoints()) {
+            patches[i]->ComputeLocalPointValues(&points[i][0], &points[i][nVerts]);
+        }
+    }
+
+    int nfails =
+        patches[1]->GetNumLocalPoints() > patches[0]->GetNumLocalPoints();
+
+    for (int array=0, patchIndex=0; array<patches[0]->GetNumPatchArrays(); ++array) {
+        FarPatchDescriptor desc0 = patches[0]->GetPatchArrayDescriptor(array);
+        int ncvs = desc0.GetNumControlVertices();
+        for (int patch=0; patch<patches[0]->GetNumPatches(array); ++patch, ++patchIndex) {
+            if (desc0.GetType()!=FarPatchDescriptor::GREGORY_BASIS) {
+                continue;
+            }
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvs;
+
+            OpenSubdiv::Far::PatchParam param = patches[0]->GetPatchParam(array, patch);
+
+            float frac = param.GetParamFraction(),
+                  s = (param.GetU() + 0.3f) * frac,
+                  t = (param.GetV() + 0.6f) * frac;
+
+            xyzVV limit[2];
+            for (int i=0; i<2; ++i) {
+                float wP[20], wDs[20], wDt[20];
+                patches[i]->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+
+                OpenSubdiv::Far::ConstIndexArray cvs = patches[i]->GetPatchVertices(handle);
+
+                limit[i].Clear();
+                for (int k=0; k<cvs.size(); ++k) {
+                    limit[i].AddWithWeight(points[i][cvs[k]], wP[k]);
+                }
+            }
+            for (int k=0; k<3; ++k) {
+                if (std::abs(limit[0].GetPos()[k]-limit[1].GetPos()[k]) >
+                    SUMMATION_PRECISION) ++nfails;
+            }
+        }
+    }
+    if (nfails) {
+        printf("// shared end cap points fails : %s\n", desc.name.c_str());
+    }
+
+    delete patches[0];
+    delete patches[1];
+    delete stencils;
+    return nfails ? 1 : 0;
+}
+
+// Loop patches must evaluate the limit of the vertices of a uniform refinement
+// at their corners, and be found by the patch map at their centers
+static int
+checkLoopPatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor     FarPatchDescriptor;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+    typedef OpenSubdiv::Far::PrimvarRefiner      FarPrimvarRefiner;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kLoop) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & adaptive = fixture.GetAdaptiveRefiner(maxlevel),
+                             & uniform = fixture.GetFullTopologyRefiner(maxlevel);
+
+    int nControlVerts = shape.GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    // the vertices of all the levels of the adaptive refinement
+    FarStencilTableFactory::Options stencilOptions;
+    stencilOptions.generateControlVerts = true;
+    FarStencilTable const * stencils =
+        FarStencilTableFactory::Create(adaptive, stencilOptions);
+
+    std::vector<xyzVV> points(stencils->GetNumStencils());
+    stencils->UpdateValues(&controlVerts[0], &points[0]);
+
+    // the limit of the vertices of the last level of the uniform refinement
+    std::vector<xyzVV> verts(uniform.GetNumVerticesTotal()),
+                       limit(uniform.GetLevel(maxlevel).GetNumVertices());
+    std::copy(controlVerts.begin(), controlVerts.end(), verts.begin());
+
+    FarPrimvarRefiner primvarRefiner(uniform);
+    xyzVV * src = &verts[0];
+    for (int level=1; level<=maxlevel; ++level) {
+        xyzVV * dst = src + uniform.GetLevel(level-1).GetNumVertices();
+        primvarRefiner.Interpolate(level, src, dst);
+        src = dst;
+    }
+    xyzVV * dstLimit = &limit[0];
+    primvarRefiner.Limit(src, dstLimit);
+
+    // the uniform vertices at the corners of the triangles, indexed by their
+    // location on the grid of the base face at the last level
+    int res = 1 << maxlevel;
+
+    FarPatchTable const * triangles =
+        FarPatchTableFactory::Create(uniform, FarPatchTableFactory::Options());
+
+    std::map<long long, int> corners;
+
+    OpenSubdiv::Far::TopologyLevel const & lastLevel = uniform.GetLevel(maxlevel);
+    for (int face=0, patch=0; face<lastLevel.GetNumFaces(); ++face) {
+        if (lastLevel.IsFaceHole(face)) continue;
+
+        FarPatchParam param = triangles->GetPatchParam(0, patch++);
+
+        OpenSubdiv::Far::ConstIndexArray fverts = lastLevel.GetFaceVertices(face);
+        assert(fverts.size()==3);
+
+        for (int k=0; k<3; ++k) {
+            int s = (k==1), t = (k==2),
+                scale = res >> param.GetDepth(),
+                i = param.GetU(), j = param.GetV();
+            if (param.IsTriangleRotated()) {
+                i = (1 << param.GetDepth()) - i - s;
+                j = (1 << param.GetDepth()) - j - t;
+            } else {
+                i += s;
+                j += t;
+            }
+            long long key = ((long long)param.GetFaceId() * (res+1) + i*scale) * (res+1) + j*scale;
+            corners[key] = fverts[k];
+        }
+    }
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(adaptive, patchOptions);
+
+    FarPatchMap patchMap(*patches);
+
+    int nfails = 0;
+    for (int array=0, patchIndex=0; array<patches->GetNumPatchArrays(); ++array) {
+
+        FarPatchDescriptor::Type type = patches->GetPatchArrayDescriptor(array).GetType();
+
+        int ncvs = patches->GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+        for (int patch=0; patch<patches->GetNumPatches(array); ++patch, ++patchIndex) {
+
+            FarPatchParam param = patches->GetPatchParam(array, patch);
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvs;
+
+            int depth = param.GetDepth(),
+                scale = res >> depth;
+
+            float frac = param.GetParamFraction();
+
+            bool rotated = param.IsTriangleRotated();
+
+            // the patch must be found at its center
+            float u = (param.GetU() + 1.0f/3.0f) * frac,
+                  v = (param.GetV() + 1.0f/3.0f) * frac;
+            if (rotated) {
+                u = 1.0f - (param.GetU() + 1.0f/3.0f) * frac;
+                v = 1.0f - (param.GetV() + 1.0f/3.0f) * frac;
+            }
+            FarPatchMap::Handle const * found = patchMap.FindPatch(param.GetFaceId(), u, v);
+            if (not found or found->patchIndex!=patchIndex) {
+                ++nfails;
+                continue;
+            }
+
+            if (type!=FarPatchDescriptor::LOOP) {
+                continue;
+            }
+
+            OpenSubdiv::Far::ConstIndexArray cvs = patches->GetPatchVertices(handle);
+
+            float wP[12], wDs[12], wDt[12], wPH[12], wPK[12];
+
+            // the derivatives must match the finite differences of the weights
+            float h = 1e-3f * frac,
+                  tolerance = 1e-2f / frac;
+
+            patches->EvaluateBasis(handle, u, v, wP, wDs, wDt);
+            patches->EvaluateBasis(handle, u+h, v, wPH, 0, 0);
+            patches->EvaluateBasis(handle, u, v+h, wPK, 0, 0);
+
+            for (int k=0; k<12; ++k) {
+                if (std::abs((wPH[k]-wP[k])/h - wDs[k]) > tolerance or
+                    std::abs((wPK[k]-wP[k])/h - wDt[k]) > tolerance) {
+                    ++nfails;
+                    break;
+                }
+            }
+
+            // the points of the patch at the vertices of the last level must
+            // evaluate the limit of the uniform vertices
+            for (int k=0; k<(scale+1)*(scale+1); ++k) {
+                int s = k % (scale+1), t = k / (scale+1);
+                if (s+t > scale) continue;
+
+                int i = rotated ? ((1 << depth) - param.GetU())*scale - s : param.GetU()*scale + s,
+                    j = rotated ? ((1 << depth) - param.GetV())*scale - t : param.GetV()*scale + t;
+
+                long long key = ((long long)param.GetFaceId() * (res+1) + i) * (res+1) + j;
+
+                std::map<long long, int>::const_iterator it = corners.find(key);
+                if (it==corners.end()) {
+                    ++nfails;
+                    continue;
+                }
+
+                patches->EvaluateBasis(handle, (float)i/res, (float)j/res, wP, 0, 0);
+
+                xyzVV p;
+                p.Clear();
+                for (int n=0; n<12; ++n) {
+                    p.AddWithWeight(points[cvs[n]], wP[n]);
+                }
+                for (int c=0; c<3; ++c) {
+                    if (std::abs(p.GetPos()[c]-limit[it->second].GetPos()[c]) > 1e-4f) {
+                        ++nfails;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    if (nfails) {
+        printf("// loop patches fails : %s (%d failures)\n",
+            desc.name.c_str(), nfails);
+    }
+
+    delete patches;
+    delete triangles;
+    delete stencils;
+    return nfails ? 1 : 0;
+}
+
+// The faces streamed in tiles must match those of the uniform refinement --
+// identified by the quantized centroids of their refined vertices
+struct StreamedFaces {
+    std::vector<xyzVV> const * baseVerts;
+    std::vector<std::vector<int> > centroids;
+    int nfaces;
+};
+
+static std::vector<int>
+quantizeCentroid(std::vector<xyzVV> const & verts, OpenSubdiv::Far::ConstIndexArray fverts) {
+
+    float c[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i=0; i<fverts.size(); ++i) {
+        for (int k=0; k<3; ++k) {
+            c[k] += verts[fverts[i]].GetPos()[k] / (float)fverts.size();
+        }
+    }
+    std::vector<int> key(3);
+    for (int k=0; k<3; ++k) {
+        key[k] = (int)std::floor(c[k] * 1e4f + 0.5f);
+    }
+    return key;
+}
+
+static void
+gatherStreamedFaces(OpenSubdiv::Far::StreamingRefiner::Tile const & tile, void * clientData) {
+
+    StreamedFaces & streamed = *(StreamedFaces *)clientData;
+
+    FarTopologyRefiner const & refiner = tile.GetRefiner();
+    OpenSubdiv::Far::TopologyLevel const & lastLevel =
+        refiner.GetLevel(refiner.GetMaxLevel());
+
+    std::vector<xyzVV> verts(lastLevel.GetNumVertices());
+    tile.InterpolateVertices(&(*streamed.baseVerts)[0], &verts[0]);
+
+    OpenSubdiv::Far::ConstIndexArray faces = tile.GetFaces();
+    for (int i=0; i<faces.size(); ++i) {
+        streamed.centroids.push_back(
+            quantizeCentroid(verts, lastLevel.GetFaceVertices(faces[i])));
+    }
+    streamed.nfaces += faces.size();
+}
+
+// Concurrent validation of the base topology must match the serial one, and
+// the token of a validated topology must skip the validation of its copies
+static int
+checkTopologyValidation(ShapeFixture & fixture, int /* maxlevel */) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    ReverseTaskScheduler scheduler;
+
+    FarTopologyRefinerFactory::Options options = fixture.GetRefinerOptions();
+    options.validateFullTopology = true;
+
+    FarTopologyRefiner * serial = FarTopologyRefinerFactory::Create(shape, options);
+
+    options.taskScheduler = &scheduler;
+    FarTopologyRefiner * concurrent = FarTopologyRefinerFactory::Create(shape, options);
+
+    int count = 0;
+    if (not serial or not concurrent) {
+        printf("// topology validation fails : %s (invalid topology)\n", desc.name.c_str());
+        ++count;
+    } else {
+        unsigned long long token = serial->GetValidationToken();
+
+        options.validationToken = token;
+        FarTopologyRefiner * copy = FarTopologyRefinerFactory::Create(shape, options);
+
+        options.validationToken = token + 1;
+        options.validateFullTopology = false;
+        FarTopologyRefiner * unvalidated = FarTopologyRefinerFactory::Create(shape, options);
+
+        if (token==0 or concurrent->GetValidationToken()!=token or
+            not copy or copy->GetValidationToken()!=token or
+            not unvalidated or unvalidated->GetValidationToken()!=0) {
+            printf("// topology validation fails : %s (tokens)\n", desc.name.c_str());
+            ++count;
+        }
+        delete copy;
+        delete unvalidated;
+    }
+
+    delete serial;
+    delete concurrent;
+    return count;
+}
+
+// The faces of uniform refinements skipping holes must be those of the full
+// refinement, vertices and stencils included, with fewer components
+static int
+checkSkippedHoles(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PrimvarRefiner      FarPrimvarRefiner;
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme);
+
+    // shapes without holes have every third face made a hole
+    bool hasHoles = false;
+    for (int i=0; i<(int)shape->tags.size(); ++i) {
+        hasHoles |= (shape->tags[i]->name=="hole");
+    }
+    if (not hasHoles and shape->GetNumFaces() > 2) {
+        Shape::tag * t = new Shape::tag;
+        t->name = "hole";
+        for (int face=0; face<shape->GetNumFaces(); face+=3) {
+            t->intargs.push_back(face);
+        }
+        shape->tags.push_back(t);
+    }
+
+    FarTopologyRefinerFactory::Options options(GetSdcType(*shape), GetSdcOptions(*shape));
+
+    FarTopologyRefiner * full = FarTopologyRefinerFactory::Create(*shape, options),
+                       * skipped = FarTopologyRefinerFactory::Create(*shape, options);
+
+    FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+    full->RefineUniform(uniformOptions);
+    uniformOptions.skipHoles = true;
+    skipped->RefineUniform(uniformOptions);
+
+    int nverts = shape->GetNumVertices();
+    std::vector<xyzVV> controlVerts(nverts);
+    for (int i=0; i<nverts; ++i) {
+        controlVerts[i].SetPosition(shape->verts[i*3],
+            shape->verts[i*3+1], shape->verts[i*3+2]);
+    }
+
+    FarTopologyRefiner * refiners[2] = { full, skipped };
+    std::vector<xyzVV> verts[2];
+    for (int i=0; i<2; ++i) {
+        verts[i].resize(refiners[i]->GetNumVerticesTotal());
+        std::copy(controlVerts.begin(), controlVerts.end(), verts[i].begin());
+
+        FarPrimvarRefiner primvarRefiner(*refiners[i]);
+        xyzVV * src = &verts[i][0];
+        for (int level=1; level<=refiners[i]->GetMaxLevel(); ++level) {
+            xyzVV * dst = src + refiners[i]->GetLevel(level-1).GetNumVertices();
+            primvarRefiner.Interpolate(level, src, dst);
+            src = dst;
+        }
+    }
+
+    // the stencils of the last level of the skipped refinement
+    FarStencilTableFactory::Options stencilOptions;
+    stencilOptions.generateIntermediateLevels = false;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(*skipped, stencilOptions);
+
+    std::vector<xyzVV> points(stencils->GetNumStencils());
+    stencils->UpdateValues(&controlVerts[0], &points[0]);
+
+    int nfails = (skipped->GetMaxLevel()!=full->GetMaxLevel()) or
+                 (skipped->GetNumVerticesTotal() > full->GetNumVerticesTotal()) or
+                 (skipped->GetNumFacesTotal() > full->GetNumFacesTotal());
+
+    if (not nfails) {
+        OpenSubdiv::Far::TopologyLevel const & fullLevel = full->GetLevel(maxlevel),
+                                             & skippedLevel = skipped->GetLevel(maxlevel);
+
+        int fullOffset = full->GetNumVerticesTotal() - fullLevel.GetNumVertices(),
+            skippedOffset = skipped->GetNumVerticesTotal() - skippedLevel.GetNumVertices();
+
+        // faces which are not holes are in the same order
+        int fullFace = 0, skippedFace = 0;
+        for (;; ++fullFace, ++skippedFace) {
+            while (fullFace<fullLevel.GetNumFaces() and fullLevel.IsFaceHole(fullFace)) ++fullFace;
+            while (skippedFace<skippedLevel.GetNumFaces() and skippedLevel.IsFaceHole(skippedFace)) ++skippedFace;
+
+            if (fullFace==fullLevel.GetNumFaces() or skippedFace==skippedLevel.GetNumFaces()) {
+                nfails += (fullFace!=fullLevel.GetNumFaces()) or
+                          (skippedFace!=skippedLevel.GetNumFaces());
+                break;
+            }
+
+            OpenSubdiv::Far::ConstIndexArray a = fullLevel.GetFaceVertices(fullFace),
+                                             b = skippedLevel.GetFaceVertices(skippedFace);
+            if (a.size()!=b.size()) {
+                ++nfails;
+                continue;
+            }
+            for (int k=0; k<a.size(); ++k) {
+                float const * p = verts[0][fullOffset + a[k]].GetPos(),
+                            * q = verts[1][skippedOffset + b[k]].GetPos(),
+                            * r = points[b[k]].GetPos();
+                for (int c=0; c<3; ++c) {
+                    if (std::abs(p[c]-q[c]) > 1e-5f or std::abs(p[c]-r[c]) > 1e-5f) {
+                        ++nfails;
+                        c = 3;
+                        k = a.size();
+                    }
+                }
+            }
+        }
+    }
+
+    // refiners and tables cached with and without holes skipped are distinct
+    {
+        typedef OpenSubdiv::Far::TopologyDescriptor                 Descriptor;
+        typedef OpenSubdiv::Far::TopologyRefinerFactory<Descriptor> DescriptorFactory;
+        typedef OpenSubdiv::Far::TopologyCache                      FarTopologyCache;
+
+        std::vector<int> holes;
+        for (int i=0; i<(int)shape->tags.size(); ++i) {
+            if (shape->tags[i]->name=="hole") {
+                holes.insert(holes.end(), shape->tags[i]->intargs.begin(),
+                    shape->tags[i]->intargs.end());
+            }
+        }
+
+        Descriptor descriptor;
+        descriptor.numVertices = shape->GetNumVertices();
+        descriptor.numFaces = shape->GetNumFaces();
+        descriptor.numVertsPerFace = &shape->nvertsPerFace[0];
+        descriptor.vertIndicesPerFace = &shape->faceverts[0];
+        descriptor.isLeftHanded = shape->isLeftHanded;
+        descriptor.numHoles = (int)holes.size();
+        descriptor.holeIndices = holes.empty() ? 0 : &holes[0];
+
+        DescriptorFactory::Options descriptorOptions(GetSdcType(*shape), GetSdcOptions(*shape));
+
+        FarTopologyCache cache;
+
+        FarTopologyRefiner const * cachedRefiners[2];
+        FarStencilTable const * cachedStencils[2];
+        for (int i=0; i<2; ++i) {
+            uniformOptions.skipHoles = (i==1);
+            cachedRefiners[i] = cache.GetRefiner(descriptor, descriptorOptions, uniformOptions);
+            cachedStencils[i] = cache.GetStencilTable(descriptor, descriptorOptions,
+                uniformOptions, stencilOptions);
+            if (not cachedRefiners[i] or not cachedStencils[i] or
+                (bool)cachedRefiners[i]->GetUniformOptions().skipHoles!=(i==1) or
+                cachedStencils[i]->GetNumStencils()!=
+                    cachedRefiners[i]->GetLevel(maxlevel).GetNumVertices()) {
+                ++nfails;
+            }
+        }
+        if (cachedRefiners[0]==cachedRefiners[1] or cachedStencils[0]==cachedStencils[1] or
+            cache.GetNumEntries()!=4) {
+            ++nfails;
+        }
+    }
+
+    if (nfails) {
+        printf("// skipped holes fails : %s (%d failures)\n", desc.name.c_str(), nfails);
+    }
+
+    delete stencils;
+    delete full;
+    delete skipped;
+    delete shape;
+    return nfails;
+}
+
+static int
+checkStreamingRefinement(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StreamingRefiner FarStreamingRefiner;
+    typedef OpenSubdiv::Far::PrimvarRefiner   FarPrimvarRefiner;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme==kBilinear) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetBaseRefiner(),
+                             & uniform = fixture.GetUniformRefiner(maxlevel);
+
+    int nverts = shape.GetNumVertices();
+    std::vector<xyzVV> baseVerts(nverts),
+                       verts(uniform.GetNumVerticesTotal());
+    for (int i=0; i<nverts; ++i) {
+        baseVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    std::copy(baseVerts.begin(), baseVerts.end(), verts.begin());
+
+    FarPrimvarRefiner primvarRefiner(uniform);
+    xyzVV * src = &verts[0];
+    for (int level=1; level<=maxlevel; ++level) {
+        xyzVV * dst = src + uniform.GetLevel(level-1).GetNumVertices();
+        primvarRefiner.Interpolate(level, src, dst);
+        src = dst;
+    }
+    std::vector<xyzVV> lastVerts(src, src + uniform.GetLevel(maxlevel).GetNumVertices());
+
+    std::vector<std::vector<int> > expected;
+    OpenSubdiv::Far::TopologyLevel const & lastLevel = uniform.GetLevel(maxlevel);
+    for (int face=0; face<lastLevel.GetNumFaces(); ++face) {
+        if (lastLevel.IsFaceHole(face)) continue;
+        expected.push_back(quantizeCentroid(lastVerts, lastLevel.GetFaceVertices(face)));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    int nfails = 0;
+
+    // tiles of face ranges, and tiles interleaving faces
+    int nbaseFaces = refiner.GetLevel(0).GetNumFaces();
+    std::vector<int> baseFaceTiles(nbaseFaces);
+    for (int face=0; face<nbaseFaces; ++face) {
+        baseFaceTiles[face] = 2 * (face % 3);
+    }
+
+    for (int pass=0; pass<2; ++pass) {
+
+        FarStreamingRefiner::Options options(maxlevel);
+        options.maxTileFaces = 5;
+
+        FarStreamingRefiner * streaming = pass==0 ?
+            new FarStreamingRefiner(refiner, options) :
+            new FarStreamingRefiner(refiner, options, &baseFaceTiles[0]);
+
+        int ntiles = pass==0 ? (nbaseFaces+4)/5 : std::min(nbaseFaces, 3);
+
+        StreamedFaces streamed;
+        streamed.baseVerts = &baseVerts;
+        streamed.nfaces = 0;
+
+        if (streaming->GetNumTiles()!=ntiles or
+            not streaming->Refine(gatherStreamedFaces, &streamed)) {
+            ++nfails;
+        } else {
+            std::sort(streamed.centroids.begin(), streamed.centroids.end());
+            if (streamed.centroids!=expected) {
+                ++nfails;
+            }
+        }
+        delete streaming;
+    }
+
+    if (nfails) {
+        printf("// streaming refinement fails : %s\n", desc.name.c_str());
+    }
+
+    return nfails;
+}
+
+// Tables of partitions of the base faces created independently and merged
+// must evaluate as those of the sparse refinement of all the faces
+static OpenSubdiv::Far::PatchTable const *
+createPartitionTables(FarTopologyRefiner const & source, int maxlevel,
+    std::vector<OpenSubdiv::Far::Index> const & faces,
+    OpenSubdiv::Far::StencilTable const ** stencils) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+
+    FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(source);
+
+    refiner->RefineSparse(FarTopologyRefiner::AdaptiveOptions(maxlevel),
+        OpenSubdiv::Far::ConstIndexArray(faces.empty() ? 0 : &faces[0], (int)faces.size()));
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    // shared points are not shared across partitions
+    patchOptions.shareEndCapPatchPoints = false;
+
+    OpenSubdiv::Far::PatchTable const * patches =
+        FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    FarStencilTableFactory::Options stencilOptions;
+    stencilOptions.generateControlVerts = true;
+    FarStencilTable const * vertexStencils =
+        FarStencilTableFactory::Create(*refiner, stencilOptions);
+
+    *stencils = FarStencilTableFactory::AppendLocalPointStencilTable(*refiner,
+        vertexStencils, patches->GetLocalPointStencilTable());
+    if (*stencils) {
+        delete vertexStencils;
+    } else {
+        *stencils = vertexStencils;
+    }
+
+    delete refiner;
+    return patches;
+}
+
+static int
+checkPartitionedPatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor     FarPatchDescriptor;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme==kBilinear) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetBaseRefiner();
+
+    int const npartitions = 3;
+
+    std::vector<OpenSubdiv::Far::Index> allFaces, faces[npartitions];
+    for (int face=0; face<refiner.GetLevel(0).GetNumFaces(); ++face) {
+        allFaces.push_back(face);
+        faces[face % npartitions].push_back(face);
+    }
+
+    FarStencilTable const * stencils[npartitions+1];
+    FarPatchTable const * tables[npartitions+1];
+
+    // empty partitions are skipped by the merged tables
+    OpenSubdiv::Far::Index offsets[npartitions];
+    for (int i=0, offset=0; i<npartitions; ++i) {
+        tables[i] = 0;
+        stencils[i] = 0;
+        if (not faces[i].empty()) {
+            tables[i] = createPartitionTables(refiner, maxlevel, faces[i], &stencils[i]);
+        }
+        offsets[i] = offset;
+        offset += stencils[i] ? stencils[i]->GetNumStencils() : 0;
+    }
+    tables[npartitions] = createPartitionTables(refiner, maxlevel, allFaces, &stencils[npartitions]);
+
+    FarStencilTable const * mergedStencils = FarStencilTableFactory::Create(npartitions, stencils);
+    FarPatchTable const * merged = FarPatchTableFactory::Create(npartitions, tables, offsets);
+
+    int nverts = shape.GetNumVertices();
+    std::vector<xyzVV> controlVerts(nverts);
+    for (int i=0; i<nverts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    std::vector<xyzVV> mergedVerts(mergedStencils->GetNumStencils()),
+                       wholeVerts(stencils[npartitions]->GetNumStencils());
+    mergedStencils->UpdateValues(&controlVerts[0], &mergedVerts[0]);
+    stencils[npartitions]->UpdateValues(&controlVerts[0], &wholeVerts[0]);
+
+    FarPatchTable const * whole = tables[npartitions];
+
+    FarPatchMap patchMap(*merged);
+
+    int nfails = (merged->GetNumPatchesTotal()!=whole->GetNumPatchesTotal());
+
+    for (int array=0, patchIndex=0; array<whole->GetNumPatchArrays(); ++array) {
+
+        FarPatchDescriptor::Type type = whole->GetPatchArrayDescriptor(array).GetType();
+        bool triangle = (type==FarPatchDescriptor::LOOP or type==FarPatchDescriptor::TRIANGLES);
+
+        int ncvs = whole->GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+        for (int patch=0; patch<whole->GetNumPatches(array); ++patch, ++patchIndex) {
+
+            FarPatchParam param = whole->GetPatchParam(array, patch);
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvs;
+
+            float center = triangle ? 1.0f/3.0f : 0.5f,
+                  frac = param.GetParamFraction(),
+                  u = (param.GetU() + center) * frac,
+                  v = (param.GetV() + center) * frac;
+            if (triangle and param.IsTriangleRotated()) {
+                u = 1.0f - u;
+                v = 1.0f - v;
+            }
+
+            FarPatchMap::Handle const * found = patchMap.FindPatch(param.GetFaceId(), u, v);
+            if (not found) {
+                ++nfails;
+                continue;
+            }
+
+            float wP[20], wDs[20], wDt[20];
+            xyzVV p, q;
+            p.Clear();
+            q.Clear();
+
+            whole->EvaluateBasis(handle, u, v, wP, wDs, wDt);
+            OpenSubdiv::Far::ConstIndexArray cvs = whole->GetPatchVertices(handle);
+            for (int k=0; k<cvs.size(); ++k) {
+                p.AddWithWeight(wholeVerts[cvs[k]], wP[k]);
+            }
+
+            merged->EvaluateBasis(*found, u, v, wP, wDs, wDt);
+            cvs = merged->GetPatchVertices(*found);
+            for (int k=0; k<cvs.size(); ++k) {
+                q.AddWithWeight(mergedVerts[cvs[k]], wP[k]);
+            }
+
+            for (int k=0; k<3; ++k) {
+                if (std::abs(p.GetPos()[k]-q.GetPos()[k]) > 1e-5f) {
+                    ++nfails;
+                    break;
+                }
+            }
+        }
+    }
+    if (nfails) {
+        printf("// partitioned patches fails : %s (%d failures)\n",
+            desc.name.c_str(), nfails);
+    }
+
+    for (int i=0; i<=npartitions; ++i) {
+        delete tables[i];
+        delete stencils[i];
+    }
+    delete merged;
+    delete mergedStencils;
+    return nfails;
+}
+
+// Patches built on demand for each base face must evaluate as those of the
+// sparse refinement of all the faces, and be built once
+static int
+checkPatchProvider(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+    typedef OpenSubdiv::Far::PatchProvider       FarPatchProvider;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetBaseRefiner();
+
+    std::vector<OpenSubdiv::Far::Index> allFaces;
+    int numFaces = 0;
+    for (int face=0; face<refiner.GetLevel(0).GetNumFaces(); ++face) {
+        allFaces.push_back(face);
+        numFaces += refiner.GetLevel(0).IsFaceHole(face) ? 0 : 1;
+    }
+
+    FarStencilTable const * stencils = 0;
+    FarPatchTable const * whole = createPartitionTables(refiner, maxlevel, allFaces, &stencils);
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchProvider provider(refiner, maxlevel, options);
+
+    int nverts = shape.GetNumVertices();
+    std::vector<xyzVV> controlVerts(nverts);
+    for (int i=0; i<nverts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    std::vector<xyzVV> wholeVerts(stencils->GetNumStencils());
+    stencils->UpdateValues(&controlVerts[0], &wholeVerts[0]);
+
+    int nfails = 0;
+    for (int array=0, patchIndex=0; array<whole->GetNumPatchArrays(); ++array) {
+
+        int ncvs = whole->GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+        for (int patch=0; patch<whole->GetNumPatches(array); ++patch, ++patchIndex) {
+
+            FarPatchParam param = whole->GetPatchParam(array, patch);
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvs;
+
+            float frac = param.GetParamFraction(),
+                  u = (param.GetU() + 0.3f) * frac,
+                  v = (param.GetV() + 0.6f) * frac;
+
+            FarPatchProvider::FacePatches const * facePatches = 0;
+            FarPatchProvider::Handle const * found =
+                provider.FindPatch(param.GetFaceId(), u, v, &facePatches);
+            if (not found) {
+                ++nfails;
+                continue;
+            }
+
+            float wP[20], wDs[20], wDt[20];
+            xyzVV p, q, qDs, qDt;
+            p.Clear();
+
+            whole->EvaluateBasis(handle, u, v, wP, wDs, wDt);
+            OpenSubdiv::Far::ConstIndexArray cvs = whole->GetPatchVertices(handle);
+            for (int k=0; k<cvs.size(); ++k) {
+                p.AddWithWeight(wholeVerts[cvs[k]], wP[k]);
+            }
+
+            facePatches->Evaluate(*found, u, v, &controlVerts[0], q, &qDs, &qDt);
+
+            for (int k=0; k<3; ++k) {
+                if (std::abs(p.GetPos()[k]-q.GetPos()[k]) > 1e-5f) {
+                    ++nfails;
+                    break;
+                }
+            }
+        }
+    }
+
+    // patches are built once per face requested
+    for (int face=0; face<refiner.GetLevel(0).GetNumFaces(); ++face) {
+        if (provider.GetFacePatches(face) != provider.GetFacePatches(face)) {
+            ++nfails;
+        }
+    }
+    if (provider.GetNumFacePatches()!=numFaces) {
+        ++nfails;
+    }
+    if (nfails) {
+        printf("// patch provider fails : %s (%d failures)\n",
+            desc.name.c_str(), nfails);
+    }
+
+    delete whole;
+    delete stencils;
+    return nfails;
+}
+
+//------------------------------------------------------------------------------
+// Checks that the profiling zones of the refiner and the factories are begun and
+// ended in a nested order
+struct ProfileZones {
+    std::vector<char const *> stack;
+    int begun, nfails;
+};
+
+static void
+beginProfileZone(char const * name, void * clientData) {
+    ProfileZones * zones = (ProfileZones *)clientData;
+    zones->stack.push_back(name);
+    ++zones->begun;
+}
+
+static void
+endProfileZone(char const * name, void * clientData) {
+    ProfileZones * zones = (ProfileZones *)clientData;
+    if (zones->stack.empty() or zones->stack.back()!=name) {
+        ++zones->nfails;
+    } else {
+        zones->stack.pop_back();
+    }
+}
+
+static int
+checkProfileZones(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+#if defined(OPENSUBDIV_NO_PROFILE)
+    return 0;
+#else
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+
+    if (desc.scheme==kBilinear) {
+        return 0;
+    }
+
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+    ProfileZones zones;
+    zones.begun = zones.nfails = 0;
+
+    OpenSubdiv::Far::SetProfileCallbacks(beginProfileZone, endProfileZone, &zones);
+
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+
+    FarStencilTableFactory::Options stencilOptions;
+    stencilOptions.generateOffsets = true;
+    stencilOptions.generateIntermediateLevels = false;
+    delete FarStencilTableFactory::Create(*refiner, stencilOptions);
+
+    delete FarPatchTableFactory::Create(*refiner);
+
+    OpenSubdiv::Far::SetProfileBackend(OpenSubdiv::Far::FAR_PROFILE_NONE);
+
+    // the refinement, its phases and the two factories at least
+    int nfails = zones.nfails + (int)zones.stack.size() + (zones.begun < 4);
+    if (nfails) {
+        printf("// profile zones fails : %s (%d zones, %d failures)\n",
+            desc.name.c_str(), zones.begun, nfails);
+    }
+
+    delete refiner;
+    return nfails;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Stencils gathered for a subset of the control vertices must interpolate
+// the same vertices as the whole table
+
+static int
+checkStencilReverseIndex(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Index                    FarIndex;
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::StencilReverseIndex      FarStencilReverseIndex;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    // displace every 5th control vertex
+    std::vector<FarIndex> dirty;
+    std::vector<xyzVV> movedVerts(controlVerts);
+    for (int i=0; i<nControlVerts; i+=5) {
+        float const * p = controlVerts[i].GetPos();
+        movedVerts[i].SetPosition(p[0]+0.5f, p[1]-0.25f, p[2]+1.0f);
+        dirty.push_back(i);
+    }
+
+    int count=0;
+    for (int passes=0; passes<2; ++passes) {
+
+        FarStencilTableFactory::Options options;
+        options.shareIntermediateLevels = passes;
+
+        FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+        FarStencilReverseIndex index(*stencils);
+
+        int offset = nControlVerts,
+            nStencils = stencils->GetNumStencils();
+
+        // the control vertices and the interpolated vertices in a single buffer
+        std::vector<xyzVV> verts(offset + nStencils),
+                           movedFull(offset + nStencils);
+        std::copy(controlVerts.begin(), controlVerts.end(), verts.begin());
+        std::copy(movedVerts.begin(), movedVerts.end(), movedFull.begin());
+        if (nStencils) {
+            stencils->UpdateValues(&verts[0], &verts[offset]);
+            stencils->UpdateValues(&movedFull[0], &movedFull[offset]);
+        }
+
+        // then update the stencils of the displaced vertices only
+        std::copy(movedVerts.begin(), movedVerts.end(), verts.begin());
+
+        std::vector<FarIndex> ranges;
+        int nRangeStencils = index.GetStencilRanges(&dirty[0], (int)dirty.size(),
+            ranges, 8, 4);
+
+        int nfails = 0;
+        if ((int)ranges.size() > 2*4) ++nfails;
+
+        for (int i=0; i<(int)ranges.size(); i+=2) {
+            if (ranges[i] >= ranges[i+1] or (i>0 and ranges[i] <= ranges[i-1])) ++nfails;
+            else stencils->UpdateValues(&verts[0], &verts[offset], ranges[i], ranges[i+1]);
+        }
+
+        for (int i=0; i<nStencils; ++i) {
+            float const * a = verts[offset + i].GetPos(),
+                        * b = movedFull[offset + i].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a[k]-b[k]) > SUMMATION_PRECISION) ++nfails;
+            }
+        }
+
+        if (nRangeStencils > nStencils or nfails) {
+            printf("// stencil reverse index fails (passes=%d)\n", passes);
+            ++count;
+        }
+
+        delete stencils;
+    }
+
+    return count;
+}
+
+// The transpose of a stencil table must satisfy <S x, y> == <x, S^T y>
+
+static int
+checkTransposeStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    FarStencilTable const & stencils = fixture.GetStencilTable(refiner);
+    FarStencilTable const * transpose = FarStencilTableFactory::CreateTranspose(&stencils);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices(),
+        nStencils = stencils.GetNumStencils();
+
+    int count = 0;
+    if (not transpose or transpose->GetNumStencils()!=nControlVerts or
+        transpose->GetNumControlVertices()!=nStencils) {
+        printf("// transpose stencils fails (table)\n");
+        ++count;
+    } else if (nStencils) {
+        std::vector<xyzVV> x(nControlVerts), y(nStencils),
+                           sx(nStencils), sty(nControlVerts);
+        for (int i=0; i<nControlVerts; ++i) {
+            x[i].SetPosition(shape.verts[i*3],
+                shape.verts[i*3+1], shape.verts[i*3+2]);
+        }
+        for (int i=0; i<nStencils; ++i) {
+            y[i].SetPosition(std::sin((float)i), std::cos((float)i), (float)(i%7));
+        }
+        stencils.UpdateValues(&x[0], &sx[0]);
+        transpose->UpdateValues(&y[0], &sty[0]);
+
+        double a = 0.0, b = 0.0, norm = 0.0;
+        for (int i=0; i<nStencils; ++i) {
+            for (int k=0; k<3; ++k) {
+                a += sx[i].GetPos()[k] * y[i].GetPos()[k];
+                norm += std::abs(sx[i].GetPos()[k] * y[i].GetPos()[k]);
+            }
+        }
+        for (int i=0; i<nControlVerts; ++i) {
+            for (int k=0; k<3; ++k) {
+                b += x[i].GetPos()[k] * sty[i].GetPos()[k];
+            }
+        }
+        if (std::abs(a-b) > SUMMATION_PRECISION * std::max(norm, 1.0)) {
+            printf("// transpose stencils fails (%f != %f)\n", a, b);
+            ++count;
+        }
+    }
+
+    delete transpose;
+    return count;
+}
+
+// Approximated stencils must keep the sums of their weights and their size
+// limit, and move the points by the maximum error they report at most
+static int
+checkApproximateStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    FarStencilTable const & stencils = fixture.GetStencilTable(refiner);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices(),
+        nStencils = stencils.GetNumStencils();
+
+    std::vector<xyzVV> controlVerts(nControlVerts), exact(nStencils),
+                       approximated(nStencils);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    if (nStencils) {
+        stencils.UpdateValues(&controlVerts[0], &exact[0]);
+    }
+
+    int count = 0;
+    for (int maxSize=0; maxSize<=8; maxSize+=8) {
+
+        float maxError = -1.0f;
+        FarStencilTable const * approximation =
+            FarStencilTableFactory::CreateApproximation(&stencils, 1e-3f,
+                maxSize, &maxError, &shape.verts[0]);
+
+        if (not approximation or approximation->GetNumStencils()!=nStencils or
+            approximation->GetControlIndices().size() >
+                stencils.GetControlIndices().size() or maxError<0.0f) {
+            printf("// approximate stencils fails (table)\n");
+            ++count;
+            delete approximation;
+            continue;
+        }
+
+        for (int i=0; i<nStencils; ++i) {
+            OpenSubdiv::Far::Stencil a = stencils.GetStencil(i),
+                                     b = approximation->GetStencil(i);
+            float sumA = 0.0f, sumB = 0.0f;
+            for (int j=0; j<a.GetSize(); ++j) sumA += a.GetWeights()[j];
+            for (int j=0; j<b.GetSize(); ++j) sumB += b.GetWeights()[j];
+            if (std::abs(sumA-sumB) > 1e-5f or b.GetSize()==0 or
+                (maxSize and b.GetSize()>maxSize)) {
+                ++count;
+            }
+        }
+
+        if (nStencils) {
+            approximation->UpdateValues(&controlVerts[0], &approximated[0]);
+        }
+        float measured = 0.0f;
+        for (int i=0; i<nStencils; ++i) {
+            float const * a = exact[i].GetPos(),
+                        * b = approximated[i].GetPos();
+            measured = std::max(measured, std::sqrt((a[0]-b[0])*(a[0]-b[0]) +
+                (a[1]-b[1])*(a[1]-b[1]) + (a[2]-b[2])*(a[2]-b[2])));
+        }
+        if (std::abs(measured-maxError) > 1e-4f) {
+            printf("// approximate stencils fails (error %f != %f)\n",
+                measured, maxError);
+            ++count;
+        }
+        delete approximation;
+    }
+    if (count) {
+        printf("// approximate stencils fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// Monitored builds must create the same tables as unmonitored ones, report the
+// stencils of each level and return no table once cancelled
+class LevelStencilsMonitor : public OpenSubdiv::Far::BuildMonitor {
+public:
+    LevelStencilsMonitor() : OpenSubdiv::Far::BuildMonitor(true) { }
+
+    ~LevelStencilsMonitor() {
+        for (int i=0; i<(int)tables.size(); ++i) delete tables[i];
+    }
+
+    virtual void StencilLevelCompleted(int level,
+        OpenSubdiv::Far::StencilTable const * stencils) {
+        levels.push_back(level);
+        tables.push_back(stencils);
+    }
+
+    std::vector<int> levels;
+    std::vector<OpenSubdiv::Far::StencilTable const *> tables;
+};
+
+static int
+checkBuildMonitor(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::BuildMonitor              FarBuildMonitor;
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+    typedef OpenSubdiv::Far::LimitStencilTable         FarLimitStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTableFactory  FarLimitStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable                FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory         FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int count = 0;
+    for (int factorize=0; factorize<2; ++factorize) {
+
+        FarStencilTableFactory::Options options;
+        options.factorizeIntermediateLevels = factorize;
+        options.maxLevel = maxlevel;
+
+        FarStencilTable const * stencils =
+            FarStencilTableFactory::Create(refiner, options);
+
+        LevelStencilsMonitor monitor;
+        options.monitor = &monitor;
+
+        FarStencilTable const * monitored =
+            FarStencilTableFactory::Create(refiner, options);
+
+        if (not monitored or not equalStencilTables(*stencils, *monitored) or
+            monitor.GetProgress()!=1.0f or
+            (int)monitor.levels.size()!=std::max(maxlevel-1, 0)) {
+            printf("// build monitor fails (stencils)\n");
+            ++count;
+        }
+
+        for (int i=0; i<(int)monitor.levels.size(); ++i) {
+            options.monitor = 0;
+            options.maxLevel = monitor.levels[i];
+
+            FarStencilTable const * level =
+                FarStencilTableFactory::Create(refiner, options);
+            if (not equalStencilTables(*level, *monitor.tables[i])) {
+                printf("// build monitor fails (level %d)\n", monitor.levels[i]);
+                ++count;
+            }
+            delete level;
+        }
+
+        FarBuildMonitor cancelled;
+        cancelled.Cancel();
+        options.monitor = &cancelled;
+        options.maxLevel = maxlevel;
+        if (maxlevel>0) {
+            FarStencilTable const * none =
+                FarStencilTableFactory::Create(refiner, options);
+            if (none) {
+                printf("// build monitor fails (cancelled stencils)\n");
+                ++count;
+                delete none;
+            }
+        }
+
+        delete stencils;
+        delete monitored;
+    }
+
+    // Patches and limit stencils of adaptive refinements
+    if (desc.scheme==kCatmark) {
+        FarTopologyRefiner const & adaptive = fixture.GetAdaptiveRefiner(maxlevel);
+
+        FarPatchTableFactory::Options options;
+        FarPatchTable const * patches = FarPatchTableFactory::Create(adaptive, options);
+
+        FarBuildMonitor monitor;
+        options.monitor = &monitor;
+        FarPatchTable const * monitored = FarPatchTableFactory::Create(adaptive, options);
+
+        if (not monitored or not equalPatchTables(*patches, *monitored) or
+            monitor.GetProgress()!=1.0f) {
+            printf("// build monitor fails (patches)\n");
+            ++count;
+        }
+
+        FarBuildMonitor cancelled;
+        cancelled.Cancel();
+        options.monitor = &cancelled;
+        if (FarPatchTable const * none = FarPatchTableFactory::Create(adaptive, options)) {
+            printf("// build monitor fails (cancelled patches)\n");
+            ++count;
+            delete none;
+        }
+
+        int nfaces = adaptive.GetLevel(0).GetNumFaces();
+        std::vector<float> s(64), t(64);
+        for (int i=0; i<64; ++i) {
+            s[i] = (float)(i%8) / 7.0f;
+            t[i] = (float)(i/8) / 7.0f;
+        }
+        OpenSubdiv::Far::PtexIndices ptexIndices(adaptive);
+
+        FarLimitStencilTableFactory::LocationArrayVec locations;
+        for (int face=0; face<nfaces; ++face) {
+            if (adaptive.GetLevel(0).GetFaceVertices(face).size()!=4) continue;
+
+            FarLimitStencilTableFactory::LocationArray array;
+            array.ptexIdx = ptexIndices.GetFaceId(face);
+            array.numLocations = 64;
+            array.s = &s[0];
+            array.t = &t[0];
+            locations.push_back(array);
+        }
+
+        if (not locations.empty()) {
+            FarLimitStencilTableFactory::Options limitOptions;
+            FarLimitStencilTable const * limit =
+                FarLimitStencilTableFactory::Create(adaptive, locations, limitOptions);
+
+            monitor.Reset();
+            limitOptions.monitor = &monitor;
+            FarLimitStencilTable const * limitMonitored =
+                FarLimitStencilTableFactory::Create(adaptive, locations, limitOptions);
+
+            if (not limit or not limitMonitored or
+                not equalStencilTables(*limit, *limitMonitored) or
+                limit->GetDuWeights()!=limitMonitored->GetDuWeights() or
+                limit->GetDvWeights()!=limitMonitored->GetDvWeights() or
+                monitor.GetProgress()!=1.0f) {
+                printf("// build monitor fails (limit stencils)\n");
+                ++count;
+            }
+
+            limitOptions.monitor = &cancelled;
+            if (FarLimitStencilTable const * none =
+                FarLimitStencilTableFactory::Create(adaptive, locations, limitOptions)) {
+                printf("// build monitor fails (cancelled limit stencils)\n");
+                ++count;
+                delete none;
+            }
+            delete limit;
+            delete limitMonitored;
+        }
+
+        delete patches;
+        delete monitored;
+    }
+    if (count) {
+        printf("// build monitor fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// The stencils of the levels up to each level must be the prefix of the table
+// of all levels counted by GetLevelStencilCounts()
+static int
+checkLevelStencilCounts(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Stencil                   FarStencil;
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int count = 0;
+    for (int controlVerts=0; controlVerts<2; ++controlVerts) {
+
+        FarStencilTableFactory::Options options;
+        options.generateControlVerts = controlVerts;
+        options.maxLevel = maxlevel;
+
+        std::vector<OpenSubdiv::Far::Index> counts;
+        if (not FarStencilTableFactory::GetLevelStencilCounts(refiner, options, counts) or
+            (int)counts.size()!=maxlevel+1) {
+            printf("// level stencil counts fails (counts)\n");
+            ++count;
+            continue;
+        }
+
+        FarStencilTable const * stencils =
+            FarStencilTableFactory::Create(refiner, options);
+
+        for (int level=0; level<=maxlevel; ++level) {
+            options.maxLevel = level;
+            FarStencilTable const * levels =
+                FarStencilTableFactory::Create(refiner, options);
+
+            int nfails = levels->GetNumStencils()!=counts[level] ? 1 : 0;
+            for (int i=0; i<levels->GetNumStencils() and not nfails; ++i) {
+                FarStencil a = levels->GetStencil(i),
+                           b = stencils->GetStencil(i);
+                if (a.GetSize()!=b.GetSize()) ++nfails;
+                for (int j=0; j<a.GetSize() and not nfails; ++j) {
+                    if (a.GetVertexIndices()[j]!=b.GetVertexIndices()[j] or
+                        a.GetWeights()[j]!=b.GetWeights()[j]) ++nfails;
+                }
+            }
+            if (nfails) {
+                printf("// level stencil counts fails (level %d)\n", level);
+                ++count;
+            }
+            delete levels;
+        }
+        delete stencils;
+    }
+
+    FarStencilTableFactory::Options options;
+    options.generateIntermediateLevels = false;
+    std::vector<OpenSubdiv::Far::Index> counts;
+    if (FarStencilTableFactory::GetLevelStencilCounts(refiner, options, counts)) {
+        printf("// level stencil counts fails (last level)\n");
+        ++count;
+    }
+    if (count) {
+        printf("// level stencil counts fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// The limit projection stencils of the last level must match the limit
+// positions and tangents computed by PrimvarRefiner::Limit() from the
+// interpolated levels
+static int
+checkLimitProjection(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PrimvarRefiner            FarPrimvarRefiner;
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTable         FarLimitStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetFullTopologyRefiner(maxlevel);
+
+    int nverts = refiner.GetNumVerticesTotal(),
+        ncoarse = refiner.GetLevel(0).GetNumVertices(),
+        nlimit = refiner.GetLevel(maxlevel).GetNumVertices();
+
+    std::vector<xyzVV> verts(nverts);
+    for (int i=0; i<ncoarse; ++i) {
+        verts[i] = xyzVV(shape.verts[i*3], shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    FarPrimvarRefiner primvarRefiner(refiner);
+
+    xyzVV * src = &verts[0];
+    for (int level=1; level<=maxlevel; ++level) {
+        xyzVV * dst = src + refiner.GetLevel(level-1).GetNumVertices();
+        primvarRefiner.Interpolate(level, src, dst);
+        src = dst;
+    }
+
+    std::vector<xyzVV> limit[3];
+    for (int i=0; i<3; ++i) {
+        limit[i].resize(nlimit);
+    }
+    primvarRefiner.Limit(src, limit[0], limit[1], limit[2]);
+
+    FarStencilTableFactory::Options options;
+    options.maxLevel = maxlevel;
+    options.projectToLimit = true;
+
+    int count = 0;
+
+    FarLimitStencilTable const * table =
+        FarStencilTableFactory::CreateLimitProjection(refiner, options);
+    FarStencilTable const * created =
+        FarStencilTableFactory::Create(refiner, options);
+
+    if (not table or not created or
+        table->GetNumStencils()!=nlimit or
+        created->GetNumStencils()!=nlimit or
+        created->GetWeights()!=table->GetWeights() or
+        created->GetControlIndices()!=table->GetControlIndices()) {
+        printf("// limit projection fails (table)\n");
+        ++count;
+    } else {
+        std::vector<xyzVV> result[3];
+        for (int i=0; i<3; ++i) {
+            result[i].resize(nlimit);
+        }
+        table->UpdateValues(&verts[0], &result[0][0]);
+        table->UpdateDerivs(&verts[0], &result[1][0], &result[2][0]);
+
+        for (int i=0; i<3; ++i) {
+            int nfails = 0;
+            for (int j=0; j<nlimit; ++j) {
+                float const * a = result[i][j].GetPos(),
+                            * b = limit[i][j].GetPos();
+                for (int k=0; k<3; ++k) {
+                    if (std::abs(a[k]-b[k]) > 1e-4f*std::max(1.0f, std::abs(b[k]))) {
+                        ++nfails;
+                    }
+                }
+            }
+            if (nfails) {
+                printf("// limit projection fails (%s, %d)\n",
+                    i==0 ? "positions" : "tangents", nfails);
+                ++count;
+            }
+        }
+    }
+
+    // projected and unprojected tables are cached apart, and projected tables
+    // restored from the files of the cache keep the weights of derivatives
+    {
+        typedef OpenSubdiv::Far::TopologyDescriptor                 Descriptor;
+        typedef OpenSubdiv::Far::TopologyRefinerFactory<Descriptor> DescriptorFactory;
+        typedef OpenSubdiv::Far::TopologyFingerprint                FarTopologyFingerprint;
+        typedef OpenSubdiv::Far::TopologyCache                      FarTopologyCache;
+
+        Descriptor descriptor;
+        descriptor.numVertices = shape.GetNumVertices();
+        descriptor.numFaces = shape.GetNumFaces();
+        descriptor.numVertsPerFace = &shape.nvertsPerFace[0];
+        descriptor.vertIndicesPerFace = &shape.faceverts[0];
+        descriptor.isLeftHanded = shape.isLeftHanded;
+
+        DescriptorFactory::Options descriptorOptions(GetSdcType(shape), GetSdcOptions(shape));
+
+        FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+        uniformOptions.fullTopologyInLastLevel = true;
+
+        FarStencilTableFactory::Options unprojected = options;
+        unprojected.projectToLimit = false;
+
+        std::string directory = createTemporaryDirectory();
+
+        FarTopologyCache saving(directory.empty() ? 0 : directory.c_str());
+        FarLimitStencilTable const * expected = 0;
+        if (FarTopologyRefiner const * cachedRefiner =
+            saving.GetRefiner(descriptor, descriptorOptions, uniformOptions)) {
+            expected = FarStencilTableFactory::CreateLimitProjection(*cachedRefiner, options);
+        }
+        FarStencilTable const * projected =
+            saving.GetStencilTable(descriptor, descriptorOptions, uniformOptions, options);
+        if (not expected or not projected or
+            saving.GetStencilTable(descriptor, descriptorOptions, uniformOptions, unprojected)==projected or
+            not dynamic_cast<FarLimitStencilTable const *>(projected) or
+            not equalStencilTables(*expected, *projected)) {
+            printf("// limit projection cache fails\n");
+            ++count;
+        }
+
+        if (directory.empty()) {
+            printf("// limit projection cache directory fails\n");
+            ++count;
+        } else {
+            FarTopologyCache loading(directory.c_str());
+            FarLimitStencilTable const * loaded = dynamic_cast<FarLimitStencilTable const *>(
+                loading.GetStencilTable(descriptor, descriptorOptions, uniformOptions, options));
+            if (not expected or not loaded or loading.GetNumEntries()!=1 or
+                not equalStencilTables(*expected, *loaded) or
+                loaded->GetDuWeights()!=expected->GetDuWeights() or
+                loaded->GetDvWeights()!=expected->GetDvWeights()) {
+                printf("// limit projection cache files fails\n");
+                ++count;
+            }
+
+            FarTopologyFingerprint::Hash hash = FarTopologyFingerprint::Combine(
+                FarTopologyFingerprint::Compute(descriptor, descriptorOptions), uniformOptions);
+            std::vector<std::string> filenames;
+            filenames.push_back(getTopologyCacheFilename(
+                FarTopologyFingerprint::Combine(hash, options), ".stencils"));
+            filenames.push_back(getTopologyCacheFilename(
+                FarTopologyFingerprint::Combine(hash, unprojected), ".stencils"));
+            if (not removeTemporaryDirectory(directory, filenames)) {
+                printf("// limit projection cache directory removal fails\n");
+                ++count;
+            }
+        }
+        delete expected;
+    }
+
+    if (count) {
+        printf("// limit projection fails : %s\n", desc.name.c_str());
+    }
+
+    delete created;
+    delete table;
+    return count;
+}
+
+// Checks that the tables built by moving the arrays of their inputs (merged,
+// adopted or appended) match those built by copying them
+static int
+checkMovedStencilTables(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable                FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory         FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarStencilTableFactory::Options options;
+    options.generateIntermediateLevels = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    int count = 0;
+
+    // merging
+    FarStencilTable const * tables[3] = {
+        FarStencilTableFactory::Create(refiner, options), 0,
+        FarStencilTableFactory::Create(refiner, options) };
+    FarStencilTable const * merged = FarStencilTableFactory::Create(3, tables);
+    FarStencilTable const * moved = FarStencilTableFactory::Create(3, tables, true);
+    if (not moved or not equalStencilTables(*merged, *moved)) {
+        printf("// moved stencil tables fails (merge)\n");
+        ++count;
+    }
+    delete merged;
+    delete moved;
+
+    // adoption of the arrays of the client
+    int numControlVerts = stencils->GetNumControlVertices();
+    std::vector<int> sizes = stencils->GetSizes();
+    std::vector<OpenSubdiv::Far::Index> indices = stencils->GetControlIndices();
+    std::vector<float> weights = stencils->GetWeights();
+    FarStencilTable const * adopted =
+        FarStencilTableFactory::Create(numControlVerts, sizes, indices, weights);
+    if (not adopted or
+        adopted->GetSizes()!=stencils->GetSizes() or
+        adopted->GetOffsets()!=stencils->GetOffsets() or
+        adopted->GetControlIndices()!=stencils->GetControlIndices() or
+        adopted->GetWeights()!=stencils->GetWeights() or
+        not sizes.empty() or not indices.empty() or not weights.empty()) {
+        printf("// moved stencil tables fails (adopt)\n");
+        ++count;
+    }
+    delete adopted;
+
+    // inconsistent arrays are left to the client
+    sizes = stencils->GetSizes();
+    indices = stencils->GetControlIndices();
+    weights = stencils->GetWeights();
+    if (not indices.empty()) {
+        weights.pop_back();
+
+        OpenSubdiv::Far::SetErrorCallback(countErrors);
+        g_numErrors = 0;
+        FarStencilTable const * inconsistent =
+            FarStencilTableFactory::Create(numControlVerts, sizes, indices, weights);
+        OpenSubdiv::Far::SetErrorCallback(0);
+
+        if (inconsistent or g_numErrors!=1 or
+            sizes.size()!=stencils->GetSizes().size() or
+            indices.size()!=stencils->GetControlIndices().size()) {
+            printf("// moved stencil tables fails (inconsistent)\n");
+            ++count;
+        }
+        delete inconsistent;
+    }
+
+    // appending of local points
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+    if (FarStencilTable const * localPoints = patches->GetLocalPointStencilTable()) {
+        FarStencilTable const * appended =
+            FarStencilTableFactory::AppendLocalPointStencilTable(
+                refiner, stencils, localPoints);
+        FarStencilTable const * consumed =
+            FarStencilTableFactory::AppendLocalPointStencilTable(
+                refiner, FarStencilTableFactory::Create(refiner, options),
+                localPoints, true, true);
+        if (not appended or not consumed or not equalStencilTables(*appended, *consumed)) {
+            printf("// moved stencil tables fails (append)\n");
+            ++count;
+        }
+        delete appended;
+        delete consumed;
+    }
+
+    if (count) {
+        printf("// moved stencil tables fails : %s\n", desc.name.c_str());
+    }
+
+    delete patches;
+    delete stencils;
+    return count;
+}
+
+// Local points appended unfactorized, in a pass of their own referring to the
+// refined vertices, must evaluate as the factorized local points, whether the
+// base stencils include the control vertices or not
+static int
+checkLocalPointPass(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+
+    FarStencilTable const * localPoints = patches->GetLocalPointStencilTable();
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+
+    int count = 0;
+    for (int withControlVerts=0; localPoints and withControlVerts<2; ++withControlVerts) {
+
+        FarStencilTableFactory::Options options;
+        options.generateControlVerts = (withControlVerts==1);
+        FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+        std::vector<xyzVV> points[2];
+        for (int factorize=0; factorize<2; ++factorize) {
+            FarStencilTable const * table =
+                FarStencilTableFactory::AppendLocalPointStencilTable(
+                    refiner, stencils, localPoints, factorize==1);
+
+            points[factorize].resize(nControlVerts + table->GetNumStencils());
+            for (int i=0; i<nControlVerts; ++i) {
+                points[factorize][i].SetPosition(shape.verts[i*3],
+                    shape.verts[i*3+1], shape.verts[i*3+2]);
+            }
+            table->UpdateValues(&points[factorize][0], &points[factorize][nControlVerts]);
+
+            if (factorize==0 and table->GetPassOffsets().empty()) {
+                ++count;
+            }
+            delete table;
+        }
+        for (int i=0; i<(int)points[0].size(); ++i) {
+            for (int k=0; k<3; ++k) {
+                if (std::abs(points[0][i].GetPos()[k]-points[1][i].GetPos()[k]) >
+                    SUMMATION_PRECISION) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+        delete stencils;
+    }
+    if (count) {
+        printf("// local point pass fails : %s\n", desc.name.c_str());
+    }
+
+    delete patches;
+    return count ? 1 : 0;
+}
+
+// The triangles of each base face at each level must cover the faces of the
+// level, index the vertices refined by the stencils of all levels, and
+// contain the descendants of the corners of the base face
+static int
+checkFaceLevelTable(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Index                     FarIndex;
+    typedef OpenSubdiv::Far::ConstIndexArray           FarConstIndexArray;
+    typedef OpenSubdiv::Far::FaceLevelTable            FarFaceLevelTable;
+    typedef OpenSubdiv::Far::FaceLevelTableFactory     FarFaceLevelTableFactory;
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    FarFaceLevelTable const * table = FarFaceLevelTableFactory::Create(refiner);
+
+    FarStencilTableFactory::Options options;
+    options.generateIntermediateLevels = true;
+    options.generateControlVerts = false;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    int count = 0;
+    if (not table or table->GetMaxLevel()!=maxlevel or
+        table->GetNumBaseFaces()!=refiner.GetLevel(0).GetNumFaces() or
+        table->GetLevelVertexOffset(maxlevel+1)!=
+            refiner.GetLevel(0).GetNumVertices()+stencils->GetNumStencils()) {
+        printf("// face level table fails : %s (table)\n", desc.name.c_str());
+        delete stencils;
+        delete table;
+        return 1;
+    }
+
+    OpenSubdiv::Far::TopologyLevel const & baseLevel = refiner.GetLevel(0);
+
+    for (int level=0; level<=maxlevel; ++level) {
+        OpenSubdiv::Far::TopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        int numTriangles = 0;
+        for (int face=0; face<refLevel.GetNumFaces(); ++face) {
+            if (not refLevel.IsFaceHole(face)) {
+                numTriangles += refLevel.GetFaceVertices(face).size()-2;
+            }
+        }
+
+        FarIndex begin = table->GetLevelVertexOffset(level),
+                 end = table->GetLevelVertexOffset(level+1);
+
+        int numTableTriangles = 0;
+        for (int face=0; face<table->GetNumBaseFaces(); ++face) {
+            FarConstIndexArray triangles = table->GetTriangles(face, level);
+            numTableTriangles += triangles.size()/3;
+
+            for (int i=0; i<triangles.size(); ++i) {
+                if (triangles[i]<begin or triangles[i]>=end) ++count;
+            }
+            if (baseLevel.IsFaceHole(face)) {
+                if (triangles.size()) ++count;
+                continue;
+            }
+
+            //  The descendant of each corner at this level is a vertex of the
+            //  triangles of the base face:
+            FarConstIndexArray corners = baseLevel.GetFaceVertices(face);
+            for (int i=0; i<corners.size(); ++i) {
+                FarIndex vertex = corners[i];
+                for (int j=0; j<level; ++j) {
+                    vertex = refiner.GetLevel(j).GetVertexChildVertex(vertex);
+                }
+                if (std::find(triangles.begin(), triangles.end(), begin+vertex)==
+                        triangles.end()) {
+                    ++count;
+                }
+            }
+        }
+        if (numTableTriangles!=numTriangles) ++count;
+    }
+
+    if (count) {
+        printf("// face level table fails : %s\n", desc.name.c_str());
+    }
+
+    delete stencils;
+    delete table;
+    return count;
+}
+
+// Centroids of the refined faces of an incremental refinement, grouped by
+// the id of their base face (which does not depend on the order of the faces
+// and tiles)
+struct RefinedFaceCentroid {
+    int   id;
+    float pos[3];
+
+    bool operator<(RefinedFaceCentroid const & other) const {
+        return id < other.id;
+    }
+};
+
+static std::vector<RefinedFaceCentroid>
+getRefinedFaceCentroids(OpenSubdiv::Far::IncrementalRefiner const & refiner,
+    std::vector<float> const & verts, std::vector<int> const & baseFaceIds) {
+
+    OpenSubdiv::Far::StencilTable const * stencils = refiner.GetStencilTable();
+
+    int nControlVerts = (int)verts.size()/3,
+        nStencils = stencils ? stencils->GetNumStencils() : 0;
+
+    std::vector<xyzVV> controlVerts(nControlVerts), refined(nStencils);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(verts[i*3], verts[i*3+1], verts[i*3+2]);
+    }
+    if (nStencils) {
+        stencils->UpdateValues(&controlVerts[0], &refined[0]);
+    }
+
+    std::vector<OpenSubdiv::Far::Index> const & faceVerts =
+        refiner.GetRefinedFaceVertices();
+    std::vector<OpenSubdiv::Far::Index> const & baseFaces =
+        refiner.GetRefinedFaceBaseFaces();
+    int faceSize = refiner.GetNumRefinedFaceVertices(),
+        nFaces = (int)baseFaces.size();
+
+    std::vector<RefinedFaceCentroid> centroids(nFaces);
+    for (int i=0; i<nFaces; ++i) {
+        RefinedFaceCentroid & centroid = centroids[i];
+        centroid.id = baseFaceIds[baseFaces[i]];
+        centroid.pos[0] = centroid.pos[1] = centroid.pos[2] = 0.0f;
+        for (int j=0; j<faceSize; ++j) {
+            float const * pos = refined[faceVerts[i*faceSize+j]].GetPos();
+            for (int k=0; k<3; ++k) centroid.pos[k] += pos[k]/faceSize;
+        }
+    }
+    std::stable_sort(centroids.begin(), centroids.end());
+    return centroids;
+}
+
+// Returns true if the refined faces of each base face have the same centroids
+static bool
+equalRefinedFaceCentroids(std::vector<RefinedFaceCentroid> const & a,
+    std::vector<RefinedFaceCentroid> b) {
+
+    if (a.size()!=b.size()) return false;
+
+    for (int i=0; i<(int)a.size(); ++i) {
+        if (a[i].id!=b[i].id) return false;
+
+        // match a centroid of the faces of the same base face
+        bool matched = false;
+        for (int j=i; j<(int)b.size() and b[j].id==a[i].id; ++j) {
+            if (std::abs(a[i].pos[0]-b[j].pos[0]) < 1e-5f and
+                std::abs(a[i].pos[1]-b[j].pos[1]) < 1e-5f and
+                std::abs(a[i].pos[2]-b[j].pos[2]) < 1e-5f) {
+                std::swap(b[i], b[j]);
+                matched = true;
+                break;
+            }
+        }
+        if (not matched) return false;
+    }
+    return true;
+}
+
+// Topology edits of an incremental refinement must refine the same faces as
+// the refinement of the edited mesh from scratch
+static int
+checkIncrementalRefiner(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::IncrementalRefiner FarIncrementalRefiner;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    int nFaces = shape.GetNumFaces(),
+        nVerts = shape.GetNumVertices();
+    if (desc.scheme==kBilinear or not shape.tags.empty() or nFaces<4 or
+        maxlevel<1) {
+        return 0;
+    }
+
+    OpenSubdiv::Sdc::SchemeType type = GetSdcType(shape);
+    OpenSubdiv::Sdc::Options options = GetSdcOptions(shape);
+
+    FarIncrementalRefiner::Options refineOptions(maxlevel);
+    refineOptions.maxTileFaces = 4;
+
+    int count = 0;
+
+    FarIncrementalRefiner incremental(type, options, refineOptions);
+    if (not incremental.SetTopology(nVerts, nFaces, &shape.nvertsPerFace[0],
+            &shape.faceverts[0])) {
+        printf("// incremental refiner fails : %s (topology)\n", desc.name.c_str());
+        return 1;
+    }
+
+    // remove two faces, then add them back : the ids of the faces kept, then
+    // of the faces added back, are those of the original faces
+    OpenSubdiv::Far::Index removed[2] = { 0, nFaces/2 };
+
+    std::vector<int> keptSizes, removedSizes, originalIds, keptIds;
+    std::vector<OpenSubdiv::Far::Index> keptVerts, removedVerts;
+    for (int face=0, offset=0; face<nFaces; offset+=shape.nvertsPerFace[face++]) {
+        bool isRemoved = (face==removed[0] or face==removed[1]);
+        std::vector<int> & sizes = isRemoved ? removedSizes : keptSizes;
+        std::vector<OpenSubdiv::Far::Index> & verts = isRemoved ? removedVerts : keptVerts;
+        sizes.push_back(shape.nvertsPerFace[face]);
+        verts.insert(verts.end(), &shape.faceverts[offset],
+            &shape.faceverts[offset] + shape.nvertsPerFace[face]);
+        originalIds.push_back(face);
+        if (not isRemoved) keptIds.push_back(face);
+    }
+    std::vector<int> readdedIds(keptIds);
+    readdedIds.push_back(removed[0]);
+    readdedIds.push_back(removed[1]);
+
+    std::vector<RefinedFaceCentroid> original =
+        getRefinedFaceCentroids(incremental, shape.verts, originalIds);
+
+    FarIncrementalRefiner reduced(type, options, refineOptions);
+    reduced.SetTopology(nVerts, (int)keptSizes.size(), &keptSizes[0], &keptVerts[0]);
+
+    for (int edit=0; edit<2; ++edit) {
+        bool edited = (edit==0) ?
+            incremental.EditTopology(2, removed, 0, 0, 0, 0) :
+            incremental.EditTopology(0, 0, 0, 2, &removedSizes[0], &removedVerts[0]);
+
+        if (not edited or
+            incremental.GetNumTilesRefined() > incremental.GetNumTiles()) {
+            printf("// incremental refiner fails (edit %d)\n", edit);
+            ++count;
+            continue;
+        }
+
+        std::vector<RefinedFaceCentroid> expected = (edit==0) ?
+            getRefinedFaceCentroids(reduced, shape.verts, keptIds) : original;
+        if (not equalRefinedFaceCentroids(getRefinedFaceCentroids(
+                incremental, shape.verts, edit==0 ? keptIds : readdedIds),
+                    expected)) {
+            printf("// incremental refiner fails (edit %d)\n", edit);
+            ++count;
+        }
+    }
+
+    // faces out of range are rejected
+    OpenSubdiv::Far::Index invalid = nFaces;
+
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+    g_numErrors = 0;
+    bool edited = incremental.EditTopology(1, &invalid, 0, 0, 0, 0);
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    if (edited or g_numErrors!=1) {
+        ++count;
+    }
+
+    if (count) {
+        printf("// incremental refiner fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// Partitions of a stencil table, evaluated from the control vertices they
+// reference only, must interpolate the same points as the whole table
+static int
+checkPartitionedStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    FarStencilTable const & stencils = fixture.GetStencilTable(refiner);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices(),
+        nStencils = stencils.GetNumStencils();
+
+    std::vector<xyzVV> controlVerts(nControlVerts), exact(nStencils);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    if (nStencils) {
+        stencils.UpdateValues(&controlVerts[0], &exact[0]);
+    }
+
+    int count = 0;
+    const int nPartitions = 3;
+    for (int p=0; p<nPartitions; ++p) {
+        int start = nStencils*p/nPartitions,
+            end = nStencils*(p+1)/nPartitions;
+
+        std::vector<OpenSubdiv::Far::Index> partitionVerts;
+        FarStencilTable const * partition =
+            FarStencilTableFactory::CreatePartition(&stencils, start, end,
+                partitionVerts);
+
+        if (not partition or partition->GetNumStencils()!=end-start or
+            partition->GetNumControlVertices()!=(int)partitionVerts.size()) {
+            printf("// partitioned stencils fails (table)\n");
+            ++count;
+            delete partition;
+            continue;
+        }
+
+        std::vector<xyzVV> partitionControls(partitionVerts.size()),
+                           interpolated(end-start);
+        for (int i=0; i<(int)partitionVerts.size(); ++i) {
+            if (i and partitionVerts[i]<=partitionVerts[i-1]) ++count;
+            partitionControls[i] = controlVerts[partitionVerts[i]];
+        }
+        if (end>start) {
+            partition->UpdateValues(&partitionControls[0], &interpolated[0]);
+        }
+        for (int i=start; i<end; ++i) {
+            float const * a = exact[i].GetPos(),
+                        * b = interpolated[i-start].GetPos();
+            if (a[0]!=b[0] or a[1]!=b[1] or a[2]!=b[2]) ++count;
+        }
+        delete partition;
+    }
+
+    // out of range partitions are rejected
+    std::vector<OpenSubdiv::Far::Index> partitionVerts;
+
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+    g_numErrors = 0;
+    FarStencilTable const * outOfRange = FarStencilTableFactory::CreatePartition(
+        &stencils, 0, nStencils+1, partitionVerts);
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    if (outOfRange or g_numErrors!=1) {
+        ++count;
+    }
+    delete outOfRange;
+
+    if (count) {
+        printf("// partitioned stencils fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// Stencils of bilinear levels, interpolated from the parent topology, must
+// interpolate the same points as the bilinear masks of PrimvarRefiner
+static int
+checkBilinearStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PrimvarRefiner            FarPrimvarRefiner;
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(shape,
+        FarTopologyRefinerFactory::Options(OpenSubdiv::Sdc::SCHEME_BILINEAR,
+            GetSdcOptions(shape)));
+
+    refiner->RefineUniform(FarTopologyRefiner::UniformOptions(maxlevel));
+
+    int nverts = refiner->GetNumVerticesTotal(),
+        ncoarse = refiner->GetLevel(0).GetNumVertices();
+
+    std::vector<xyzVV> verts(nverts);
+    for (int i=0; i<ncoarse; ++i) {
+        verts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    FarPrimvarRefiner primvarRefiner(*refiner);
+    for (int level=1, offset=0; level<=maxlevel; ++level) {
+        int n = refiner->GetLevel(level-1).GetNumVertices();
+
+        xyzVV * srcVerts = &verts[offset],
+              * dstVerts = srcVerts + n;
+        primvarRefiner.Interpolate(level, srcVerts, dstVerts);
+        offset += n;
+    }
+
+    int count = 0;
+    for (int mode=0; mode<4; ++mode) {
+
+        FarStencilTableFactory::Options options;
+        options.interpolationMode = (mode & 1) ?
+            FarStencilTableFactory::INTERPOLATE_VARYING :
+            FarStencilTableFactory::INTERPOLATE_VERTEX;
+        options.factorizeIntermediateLevels = (mode & 2) ? false : true;
+
+        FarStencilTable const * stencils =
+            FarStencilTableFactory::Create(*refiner, options);
+
+        int nstencils = stencils->GetNumStencils();
+        if (nstencils != nverts-ncoarse) {
+            printf("// bilinear stencils fails (mode %d)\n", mode);
+            ++count;
+            delete stencils;
+            continue;
+        }
+
+        std::vector<xyzVV> interpolated(nstencils);
+        if (nstencils) {
+            if (options.factorizeIntermediateLevels) {
+                stencils->UpdateValues(&verts[0], &interpolated[0]);
+            } else {
+                // unfactorized stencils refer to the vertices of the
+                // previous levels
+                std::vector<xyzVV> all(verts.begin(), verts.begin()+ncoarse);
+                all.resize(nverts);
+                stencils->UpdateValues(&all[0], &all[ncoarse]);
+                interpolated.assign(all.begin()+ncoarse, all.end());
+            }
+        }
+        for (int i=0; i<nstencils; ++i) {
+            float const * a = interpolated[i].GetPos(),
+                        * b = verts[ncoarse+i].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a[k]-b[k]) > 1e-5f*std::max(1.0f, std::abs(b[k]))) {
+                    printf("// bilinear stencils fails (mode %d) : "
+                           "vertex %d\n", mode, ncoarse+i);
+                    ++count;
+                    break;
+                }
+            }
+        }
+        delete stencils;
+    }
+    if (count) {
+        printf("// bilinear stencils fails : %s\n", desc.name.c_str());
+    }
+
+    delete refiner;
+    return count;
+}
+
+// Stencils of levels counted before they are interpolated must match those
+// of levels interpolated without counting
+static int
+checkPresizedStencils(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory       FarStencilTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int count = 0;
+    for (int mode=0; mode<4; ++mode) {
+
+        FarStencilTableFactory::Options options;
+        options.interpolationMode = (mode & 1) ?
+            FarStencilTableFactory::INTERPOLATE_VARYING :
+            FarStencilTableFactory::INTERPOLATE_VERTEX;
+        options.factorizeIntermediateLevels = (mode & 2) ? false : true;
+        options.maxLevel = maxlevel;
+
+        FarStencilTable const * grown =
+            FarStencilTableFactory::Create(refiner, options);
+
+        options.presizeLevels = true;
+        FarStencilTable const * presized =
+            FarStencilTableFactory::Create(refiner, options);
+
+        if (grown->GetSizes()!=presized->GetSizes() or
+            grown->GetControlIndices()!=presized->GetControlIndices() or
+            grown->GetWeights()!=presized->GetWeights()) {
+            printf("// presized stencils fails (mode %d)\n", mode);
+            ++count;
+        }
+        delete grown;
+        delete presized;
+    }
+    if (count) {
+        printf("// presized stencils fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// Sharpness values and vertex Rules assigned in bulk when refining meshes without
+// semi-sharp features must match those of the full subdivision of sharpness values
+// (repeated when the base sharpness is updated)
+static int
+checkSharpnessPropagation(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+    if (refiner->GetNumFVarChannels() > 0) {
+        delete refiner;
+        return 0;
+    }
+
+    FarTopologyRefiner::UniformOptions options(maxlevel);
+    options.fullTopologyInLastLevel = true;
+    refiner->RefineUniform(options);
+
+    std::vector<std::vector<float> > edgeSharpness(maxlevel+1),
+                                     vertSharpness(maxlevel+1);
+    std::vector<std::vector<int> >   vertRules(maxlevel+1);
+    for (int level=1; level<=maxlevel; ++level) {
+        OpenSubdiv::Far::TopologyLevel const & l = refiner->GetLevel(level);
+        for (int e=0; e<l.GetNumEdges(); ++e) {
+            edgeSharpness[level].push_back(l.GetEdgeSharpness(e));
+        }
+        for (int v=0; v<l.GetNumVertices(); ++v) {
+            vertSharpness[level].push_back(l.GetVertexSharpness(v));
+            vertRules[level].push_back((int)l.GetVertexRule(v));
+        }
+    }
+
+    int count = 0;
+    if (not refiner->UpdateBaseSharpness(OpenSubdiv::Far::ConstIndexArray(0, 0), 0,
+            OpenSubdiv::Far::ConstIndexArray(0, 0), 0)) {
+        ++count;
+    }
+    for (int level=1; level<=maxlevel and count==0; ++level) {
+        OpenSubdiv::Far::TopologyLevel const & l = refiner->GetLevel(level);
+        for (int e=0; e<l.GetNumEdges(); ++e) {
+            if (l.GetEdgeSharpness(e) != edgeSharpness[level][e]) ++count;
+        }
+        for (int v=0; v<l.GetNumVertices(); ++v) {
+            if (l.GetVertexSharpness(v) != vertSharpness[level][v] or
+                (int)l.GetVertexRule(v) != vertRules[level][v]) ++count;
+        }
+    }
+    if (count) {
+        printf("// sharpness propagation fails : %s\n", desc.name.c_str());
+    }
+
+    delete refiner;
+    return count;
+}
+
+// Statistics of refiners and tables must be consistent with their contents,
+// whether computed serially or with a scheduler
+static int
+checkStatistics(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable              FarStencilTable;
+    typedef OpenSubdiv::Far::PatchDescriptor           FarPatchDescriptor;
+    typedef OpenSubdiv::Far::PatchTable                FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory         FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    OpenSubdiv::Far::SerialTaskScheduler scheduler;
+
+    int count = 0;
+
+    // refiner
+    int numVertices = 0, numFaces = 0;
+    for (int level=0; level<refiner.GetNumLevels(); ++level) {
+        FarTopologyRefiner::LevelStatistics stats = refiner.GetLevelStatistics(level);
+        numVertices += stats.numVertices;
+        numFaces += stats.numFaces;
+        if (stats.numRefinedFaces>stats.numFaces or
+            (level==refiner.GetMaxLevel() and stats.numRefinedFaces!=0) or
+            (level<refiner.GetMaxLevel() and stats.numRefinedFaces==0) or
+            stats.maxValence>refiner.GetMaxValence()) {
+            printf("// statistics fails (level %d)\n", level);
+            ++count;
+        }
+    }
+    if (numVertices!=refiner.GetNumVerticesTotal() or
+        numFaces!=refiner.GetNumFacesTotal()) {
+        printf("// statistics fails (refiner)\n");
+        ++count;
+    }
+
+    // stencils
+    FarStencilTable const & stencils = fixture.GetStencilTable(refiner);
+    FarStencilTable::Statistics stencilStats = stencils.GetStatistics(),
+                                scheduledStencilStats = stencils.GetStatistics(&scheduler);
+    int numStencils = 0, numWeights = 0;
+    for (int size=0; size<(int)stencilStats.sizeHistogram.size(); ++size) {
+        numStencils += stencilStats.sizeHistogram[size];
+        numWeights += size * stencilStats.sizeHistogram[size];
+    }
+    if (numStencils!=stencils.GetNumStencils() or
+        numWeights!=(int)stencils.GetWeights().size() or
+        (numStencils>0 and (stencilStats.sizeHistogram[stencilStats.minSize]==0 or
+                            stencilStats.sizeHistogram[stencilStats.maxSize]==0)) or
+        stencilStats.sizeHistogram!=scheduledStencilStats.sizeHistogram) {
+        printf("// statistics fails (stencils)\n");
+        ++count;
+    }
+
+    // patches
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+    FarPatchTable::Statistics patchStats = patches->GetStatistics(),
+                              scheduledPatchStats = patches->GetStatistics(&scheduler);
+    int numByType = 0, numByDepth = 0;
+    for (int i=0; i<(int)patchStats.numPatchesByType.size(); ++i) {
+        numByType += patchStats.numPatchesByType[i];
+    }
+    for (int i=0; i<(int)patchStats.numPatchesByDepth.size(); ++i) {
+        numByDepth += patchStats.numPatchesByDepth[i];
+    }
+    if (numByType!=patches->GetNumPatchesTotal() or
+        numByDepth!=patches->GetNumPatchesTotal() or
+        (int)patchStats.numPatchesByDepth.size()>maxlevel+1 or
+        patchStats.numEndCapPatches!=
+            patchStats.numPatchesByType[FarPatchDescriptor::GREGORY_BASIS] or
+        patchStats.numLocalPoints!=patches->GetNumLocalPoints() or
+        patchStats.numPatchesByDepth!=scheduledPatchStats.numPatchesByDepth or
+        patchStats.numEndCapPatches!=scheduledPatchStats.numEndCapPatches) {
+        printf("// statistics fails (patches)\n");
+        ++count;
+    }
+    delete patches;
+
+    // B-spline end caps are regular patches with local points
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS);
+    patches = FarPatchTableFactory::Create(refiner, patchOptions);
+    patchStats = patches->GetStatistics();
+    if (patchStats.numPatchesByType[FarPatchDescriptor::GREGORY_BASIS]!=0 or
+        (patchStats.numEndCapPatches>0)!=(patches->GetNumLocalPoints()>0)) {
+        printf("// statistics fails (b-spline end caps)\n");
+        ++count;
+    }
+    delete patches;
+
+    if (count) {
+        printf("// statistics fails : %s\n", desc.name.c_str());
+    }
+
+    return count;
+}
+
+// Objects of a batch built concurrently must have the tables of objects built
+// one at a time, and their packed tables those of all the objects in turn
+static int
+checkTopologyBatch(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::TopologyDescriptor                      Descriptor;
+    typedef OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>      DescriptorFactory;
+    typedef OpenSubdiv::Far::TopologyBatch                           FarTopologyBatch;
+    typedef OpenSubdiv::Far::TopologyBatchFactory                    FarTopologyBatchFactory;
+    typedef OpenSubdiv::Far::StencilTable                            FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory                     FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable                              FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory                       FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    // adaptive refinement (with local points) for Catmark shapes only
+    bool adaptive = (GetSdcType(shape)==OpenSubdiv::Sdc::SCHEME_CATMARK);
+
+    Descriptor descriptor;
+    descriptor.numVertices = shape.GetNumVertices();
+    descriptor.numFaces = shape.GetNumFaces();
+    descriptor.numVertsPerFace = &shape.nvertsPerFace[0];
+    descriptor.vertIndicesPerFace = &shape.faceverts[0];
+    descriptor.isLeftHanded = shape.isLeftHanded;
+
+    const int nObjects = 3;
+    Descriptor descriptors[nObjects] = { descriptor, descriptor, descriptor };
+
+    FarTopologyBatchFactory::Options options;
+    options.refinerOptions = DescriptorFactory::Options(GetSdcType(shape), GetSdcOptions(shape));
+    options.uniformOptions = FarTopologyRefiner::UniformOptions(maxlevel);
+    options.adaptiveOptions = FarTopologyRefiner::AdaptiveOptions(maxlevel);
+    options.refineAdaptive = adaptive;
+    options.createPatchTables = true;
+    options.packTables = true;
+
+    ReverseTaskScheduler scheduler;
+    options.taskScheduler = &scheduler;
+
+    FarTopologyBatch const * batch =
+        FarTopologyBatchFactory::Create(nObjects, descriptors, options);
+    if (not batch or batch->GetNumObjects()!=nObjects) {
+        printf("// topology batch fails : %s (batch)\n", desc.name.c_str());
+        delete batch;
+        return 1;
+    }
+
+    // expected tables of an object built alone
+    FarTopologyRefiner * refiner = DescriptorFactory::Create(descriptor, options.refinerOptions);
+    if (adaptive) {
+        refiner->RefineAdaptive(options.adaptiveOptions);
+    } else {
+        refiner->RefineUniform(options.uniformOptions);
+    }
+    FarStencilTableFactory::Options stencilOptions;
+    stencilOptions.generateControlVerts = true;
+    stencilOptions.generateIntermediateLevels = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(*refiner, stencilOptions);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(*refiner);
+    if (patches->GetLocalPointStencilTable() and
+        patches->GetLocalPointStencilTable()->GetNumStencils() > 0) {
+        stencils = FarStencilTableFactory::AppendLocalPointStencilTable(*refiner,
+            stencils, patches->GetLocalPointStencilTable(), true, true);
+    }
+
+    int count = 0;
+    for (int i=0; i<nObjects; ++i) {
+        FarStencilTable const * objectStencils = batch->GetStencilTable(i);
+        if (not batch->GetRefiner(i) or not objectStencils or
+            objectStencils->GetSizes()!=stencils->GetSizes() or
+            objectStencils->GetControlIndices()!=stencils->GetControlIndices() or
+            objectStencils->GetWeights()!=stencils->GetWeights() or
+            batch->GetPatchTable(i)->GetPatchControlVerticesTable()!=
+                patches->GetPatchControlVerticesTable()) {
+            printf("// topology batch fails (object %d)\n", i);
+            ++count;
+        }
+        if (batch->GetControlVertexOffset(i)!=i*stencils->GetNumControlVertices() or
+            batch->GetVertexOffset(i)!=i*stencils->GetNumStencils()) {
+            printf("// topology batch fails (offsets of object %d)\n", i);
+            ++count;
+        }
+    }
+
+    // packed stencils : those of each object in turn, offset by its control
+    // vertices, and patches offset by its vertices in the packed stencils
+    FarStencilTable const * packedStencils = batch->GetPackedStencilTable();
+    FarPatchTable const * packedPatches = batch->GetPackedPatchTable();
+    if (not packedStencils or not packedPatches or
+        packedStencils->GetNumStencils()!=nObjects*stencils->GetNumStencils() or
+        packedPatches->GetNumPatchesTotal()!=nObjects*patches->GetNumPatchesTotal() or
+        packedPatches->GetPatchControlVerticesTable().size()!=
+            nObjects*patches->GetPatchControlVerticesTable().size()) {
+        printf("// topology batch fails (packed tables)\n");
+        ++count;
+    } else {
+        int nStencils = stencils->GetNumStencils(),
+            nControlVerts = stencils->GetNumControlVertices();
+        for (int i=0; i<nObjects; ++i) {
+            for (int j=0; j<nStencils; ++j) {
+                OpenSubdiv::Far::Stencil a = packedStencils->GetStencil(i*nStencils+j),
+                                         b = stencils->GetStencil(j);
+                if (a.GetSize()!=b.GetSize()) {
+                    ++count;
+                    continue;
+                }
+                for (int k=0; k<a.GetSize(); ++k) {
+                    if (a.GetVertexIndices()[k]!=b.GetVertexIndices()[k]+i*nControlVerts or
+                        a.GetWeights()[k]!=b.GetWeights()[k]) ++count;
+                }
+            }
+        }
+        long long packedSum = 0, sum = 0;
+        for (size_t k=0; k<packedPatches->GetPatchControlVerticesTable().size(); ++k) {
+            packedSum += packedPatches->GetPatchControlVerticesTable()[k];
+        }
+        for (size_t k=0; k<patches->GetPatchControlVerticesTable().size(); ++k) {
+            sum += patches->GetPatchControlVerticesTable()[k];
+        }
+        long long nCVs = (long long)patches->GetPatchControlVerticesTable().size();
+        if (packedSum != nObjects*sum + nCVs*nStencils*(nObjects*(nObjects-1)/2)) {
+            printf("// topology batch fails (packed patches)\n");
+            ++count;
+        }
+    }
+
+    // batches without refiners, built serially (and unpacked, the stencils
+    // then exclude the control vertices)
+    options.keepRefiners = false;
+    options.packTables = false;
+    options.taskScheduler = 0;
+    FarTopologyBatch const * serial =
+        FarTopologyBatchFactory::Create(nObjects, descriptors, options);
+    if (not serial or serial->GetRefiner(0) or serial->GetPackedStencilTable() or
+        serial->GetStencilTable(nObjects-1)->GetNumStencils()!=
+            stencils->GetNumStencils()-stencils->GetNumControlVertices()) {
+        printf("// topology batch fails (serial)\n");
+        ++count;
+    }
+
+    if (count) {
+        printf("// topology batch fails : %s\n", desc.name.c_str());
+    }
+
+    delete serial;
+    delete patches;
+    delete stencils;
+    delete refiner;
+    delete batch;
+    return count;
+}
+
+// The faces of the base faces refined to their own levels must be crack-free
+// (sharing the vertices of their edges) and match uniform refinement where
+// all the levels are the same
+static int
+checkVariableLevelMesh(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Index                     FarIndex;
+    typedef OpenSubdiv::Far::ConstIndexArray           FarConstIndexArray;
+    typedef OpenSubdiv::Far::VariableLevelMesh         FarVariableLevelMesh;
+    typedef OpenSubdiv::Far::VariableLevelMeshFactory  FarVariableLevelMeshFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme==kBilinear) return 0;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+    OpenSubdiv::Far::TopologyLevel const & baseLevel = refiner->GetLevel(0);
+
+    // levels of the faces from their longest edge, the longest of all being
+    // refined to maxlevel
+    float longest = 0.0f;
+    for (int edge=0; edge<baseLevel.GetNumEdges(); ++edge) {
+        FarConstIndexArray verts = baseLevel.GetEdgeVertices(edge);
+        float const * p0 = &shape.verts[verts[0]*3],
+                    * p1 = &shape.verts[verts[1]*3];
+        float d[3] = { p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2] };
+        longest = std::max(longest, sqrtf(d[0]*d[0]+d[1]*d[1]+d[2]*d[2]));
+    }
+
+    std::vector<unsigned char> levels;
+    FarVariableLevelMeshFactory::ComputeBaseFaceLevels(*refiner, &shape.verts[0], 3,
+        longest / (float)(1<<maxlevel), maxlevel, levels);
+
+    std::vector<unsigned char> uniformLevels(baseLevel.GetNumFaces(), (unsigned char)maxlevel);
+
+    FarVariableLevelMesh const * mesh =
+        FarVariableLevelMeshFactory::Create(*refiner, &levels[0]);
+    FarVariableLevelMesh const * uniformMesh =
+        FarVariableLevelMeshFactory::Create(*refiner, &uniformLevels[0]);
+
+    refiner->RefineUniform(FarTopologyRefiner::UniformOptions(maxlevel));
+
+    OpenSubdiv::Far::TopologyLevel const & refLevel = refiner->GetLevel(maxlevel);
+
+    int numUniformFaces = 0;
+    for (int face=0; face<refLevel.GetNumFaces(); ++face) {
+        if (not refLevel.IsFaceHole(face)) ++numUniformFaces;
+    }
+
+    // closed base meshes must give closed meshes
+    bool closed = true;
+    for (int edge=0; edge<baseLevel.GetNumEdges(); ++edge) {
+        if (baseLevel.GetEdgeFaces(edge).size()!=2) closed = false;
+    }
+    for (int face=0; face<baseLevel.GetNumFaces(); ++face) {
+        if (baseLevel.IsFaceHole(face)) closed = false;
+    }
+
+    int count = 0;
+    for (int i=0; i<2; ++i) {
+        FarVariableLevelMesh const * m = i ? uniformMesh : mesh;
+        if (not m or m->GetStencilTable()->GetNumStencils()!=
+                m->GetNumVertices()-m->GetNumControlVertices() or
+            m->GetNumVertices()-m->GetNumControlVertices()>refLevel.GetNumVertices()) {
+            ++count;
+            continue;
+        }
+
+        std::set<std::pair<FarIndex, FarIndex> > edges;
+        for (int face=0; face<m->GetNumFaces(); ++face) {
+            int level = i ? maxlevel : (int)levels[m->GetFaceBaseFace(face)];
+            if (m->GetFaceLevel(face)!=level) ++count;
+
+            FarConstIndexArray verts = m->GetFaceVertices(face);
+            for (int j=0; j<verts.size(); ++j) {
+                FarIndex v0 = verts[j], v1 = verts[(j+1)%verts.size()];
+                if (v0==v1 or v0<0 or v0>=m->GetNumVertices() or
+                    not edges.insert(std::make_pair(v0, v1)).second) {
+                    ++count;
+                }
+            }
+        }
+        if (closed) {
+            std::set<std::pair<FarIndex, FarIndex> >::const_iterator it;
+            for (it=edges.begin(); it!=edges.end(); ++it) {
+                if (not edges.count(std::make_pair(it->second, it->first))) ++count;
+            }
+        }
+        if (i and m->GetNumFaces()!=numUniformFaces) ++count;
+    }
+
+    if (count) {
+        printf("// variable level mesh fails : %s\n", desc.name.c_str());
+    }
+
+    delete uniformMesh;
+    delete mesh;
+    delete refiner;
+    return count;
+}
+
+static int
+checkPtexAdjacency(ShapeFixture & fixture, int /* maxlevel */) {
+
+    typedef OpenSubdiv::Far::PtexIndices      FarPtexIndices;
+    typedef OpenSubdiv::Far::TableSerializer  FarTableSerializer;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetBaseRefiner();
+
+    ReverseTaskScheduler scheduler;
+
+    FarPtexIndices walked(refiner), built(refiner);
+
+    int count = 0;
+    if (not built.BuildAdjacency(refiner, &scheduler) or not built.HasAdjacency()) {
+        printf("// ptex adjacency fails (build)\n");
+        ++count;
+    }
+
+    std::vector<unsigned char> data;
+    FarTableSerializer::Write(built, data);
+    FarPtexIndices const * loaded =
+        FarTableSerializer::ReadPtexIndices(&data[0], data.size());
+    if (not loaded or not loaded->HasAdjacency() or
+        loaded->GetNumFaces()!=walked.GetNumFaces()) {
+        printf("// ptex adjacency fails (serialization)\n");
+        ++count;
+    }
+
+    OpenSubdiv::Far::TopologyLevel const & level = refiner.GetLevel(0);
+    for (int face=0; count==0 and face<level.GetNumFaces(); ++face) {
+        int nverts = level.GetFaceVertices(face).size();
+        for (int quadrant=0; quadrant<(nverts==4 ? 1 : nverts); ++quadrant) {
+            int faces[3][4], edges[3][4];
+            walked.GetAdjacency(refiner, face, quadrant, faces[0], edges[0]);
+            built.GetAdjacency(refiner, face, quadrant, faces[1], edges[1]);
+            loaded->GetAdjacency(walked.GetFaceId(face) + quadrant,
+                faces[2], edges[2]);
+            for (int i=1; i<3; ++i) {
+                if (not std::equal(faces[0], faces[0]+4, faces[i]) or
+                    not std::equal(edges[0], edges[0]+4, edges[i])) {
+                    printf("// ptex adjacency fails (face %d, quadrant %d)\n",
+                        face, quadrant);
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+
+    delete loaded;
+    return count;
+}
+
+static int
+checkLevelsOfDetail(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable         FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory  FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    int count = 0,
+        localPointOffset = 0;
+    for (int level=1; level<=refiner.GetMaxLevel(); ++level) {
+
+        // the table of a refinement stopped at the same level
+        FarTopologyRefiner const & levelRefiner = fixture.GetAdaptiveRefiner(level);
+
+        FarPatchTableFactory::Options poptions(level);
+        poptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+        FarPatchTable const * lod = FarPatchTableFactory::CreateLevelOfDetail(
+                refiner, level, localPointOffset, poptions),
+                            * expected = FarPatchTableFactory::Create(levelRefiner, poptions);
+
+        int nverts = refiner.GetNumVerticesTotal(),
+            nlevelVerts = levelRefiner.GetNumVerticesTotal();
+
+        bool match = lod and
+            lod->GetNumPatchArrays()==expected->GetNumPatchArrays() and
+            lod->GetNumLocalPoints()==expected->GetNumLocalPoints() and
+            lod->GetNumControlVerticesTotal()==expected->GetNumControlVerticesTotal();
+        for (int i=0; match and i<lod->GetNumPatchArrays(); ++i) {
+            match = lod->GetPatchArrayDescriptor(i)==expected->GetPatchArrayDescriptor(i) and
+                    lod->GetNumPatches(i)==expected->GetNumPatches(i);
+        }
+        for (int i=0; match and i<(int)lod->GetPatchParamTable().size(); ++i) {
+            match = lod->GetPatchParamTable()[i].field0==expected->GetPatchParamTable()[i].field0 and
+                    lod->GetPatchParamTable()[i].field1==expected->GetPatchParamTable()[i].field1;
+        }
+        for (int i=0; match and i<lod->GetNumControlVerticesTotal(); ++i) {
+            int a = lod->GetPatchControlVerticesTable()[i],
+                b = expected->GetPatchControlVerticesTable()[i];
+            match = (b < nlevelVerts) ? (a==b) : (a-nverts-localPointOffset==b-nlevelVerts);
+        }
+        if (not match) {
+            printf("// levels of detail fails (level %d)\n", level);
+            ++count;
+        }
+        if (lod) {
+            localPointOffset += lod->GetNumLocalPoints();
+        }
+        delete lod;
+        delete expected;
+    }
+
+    return count;
+}
+
+// Approximate tables of unrefined meshes have a patch per quad with a quad
+// neighborhood, and their interior regular patches are exact on smooth meshes
+static int
+checkApproximatePatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor     FarPatchDescriptor;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & base = fixture.GetBaseRefiner(),
+                             & adaptive = fixture.GetAdaptiveRefiner(maxlevel);
+
+    ReverseTaskScheduler scheduler;
+
+    FarPatchTableFactory::Options poptions(maxlevel);
+    FarPatchTable const * approx = FarPatchTableFactory::CreateApproximate(base, poptions);
+
+    poptions.taskScheduler = &scheduler;
+    FarPatchTable const * concurrent = FarPatchTableFactory::CreateApproximate(base, poptions);
+
+    int count = 0;
+    if (not approx or not concurrent or not equalPatchTables(*approx, *concurrent)) {
+        printf("// approximate patches fails (concurrent) : %s\n", desc.name.c_str());
+        delete approx;
+        delete concurrent;
+        return 1;
+    }
+
+    // the base faces which may have patches (quads with a quad neighborhood),
+    // and those which must (with interior manifold vertices), and whether the
+    // mesh is smooth
+    OpenSubdiv::Far::TopologyLevel const & level = base.GetLevel(0);
+    OpenSubdiv::Far::PtexIndices ptexIndices(base);
+
+    std::vector<int> allowed(ptexIndices.GetNumFaces(), 0),
+                     expected(ptexIndices.GetNumFaces(), 0),
+                     found(ptexIndices.GetNumFaces(), 0);
+    for (int face=0; face<level.GetNumFaces(); ++face) {
+        OpenSubdiv::Far::ConstIndexArray fverts = level.GetFaceVertices(face);
+        bool quads = (fverts.size()==4) and not level.IsFaceHole(face),
+             interior = true;
+        for (int i=0; quads and i<fverts.size(); ++i) {
+            OpenSubdiv::Far::ConstIndexArray vfaces = level.GetVertexFaces(fverts[i]),
+                                             vedges = level.GetVertexEdges(fverts[i]);
+            for (int j=0; j<vfaces.size(); ++j) {
+                quads = quads and (level.GetFaceVertices(vfaces[j]).size()==4);
+            }
+            interior = interior and (vfaces.size()==vedges.size());
+            for (int j=0; j<vedges.size(); ++j) {
+                interior = interior and (level.GetEdgeFaces(vedges[j]).size()==2);
+            }
+        }
+        if (quads) {
+            allowed[ptexIndices.GetFaceId(face)] = 1;
+            expected[ptexIndices.GetFaceId(face)] = interior;
+        }
+    }
+    bool smooth = true;
+    for (int edge=0; edge<level.GetNumEdges(); ++edge) {
+        smooth = smooth and (level.GetEdgeSharpness(edge)==0.0f);
+    }
+    for (int vert=0; vert<level.GetNumVertices(); ++vert) {
+        smooth = smooth and (level.GetVertexSharpness(vert)==0.0f);
+    }
+
+    // the limit surface of the adaptive refinement
+    int nControlVerts = shape.GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    FarPatchTableFactory::Options adaptiveOptions(maxlevel);
+    adaptiveOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(adaptive, adaptiveOptions);
+
+    FarStencilTableFactory::Options stencilOptions;
+    stencilOptions.generateControlVerts = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(adaptive, stencilOptions);
+
+    int nVerts = stencils->GetNumStencils();
+    std::vector<xyzVV> points(nVerts + patches->GetNumLocalPoints());
+    stencils->UpdateValues(&controlVerts[0], &points[0]);
+    if (patches->GetNumLocalPoints()) {
+        patches->ComputeLocalPointValues(&points[0], &points[nVerts]);
+    }
+
+    FarPatchMap patchMap(*patches);
+
+    for (int array=0, patchIndex=0; array<approx->GetNumPatchArrays(); ++array) {
+        FarPatchDescriptor::Type type = approx->GetPatchArrayDescriptor(array).GetType();
+        int ncvs = approx->GetPatchArrayDescriptor(array).GetNumControlVertices();
+
+        for (int patch=0; patch<approx->GetNumPatches(array); ++patch, ++patchIndex) {
+            FarPatchParam param = approx->GetPatchParam(array, patch);
+
+            int faceId = param.GetFaceId();
+            if (param.GetDepth()!=0 or not allowed[faceId] or found[faceId]++) {
+                ++count;
+                continue;
+            }
+            if (not smooth or type!=FarPatchDescriptor::REGULAR or param.GetBoundary()) {
+                continue;
+            }
+
+            FarPatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvs;
+
+            float s = 0.3f, t = 0.6f, wP[20], wDs[20], wDt[20];
+            approx->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+
+            OpenSubdiv::Far::ConstIndexArray cvs = approx->GetPatchVertices(handle);
+
+            xyzVV a, b;
+            a.Clear();
+            for (int k=0; k<cvs.size(); ++k) {
+                a.AddWithWeight(controlVerts[cvs[k]], wP[k]);
+            }
+
+            FarPatchMap::Handle const * limit = patchMap.FindPatch(faceId, s, t);
+            patches->EvaluateBasis(*limit, s, t, wP, wDs, wDt);
+
+            OpenSubdiv::Far::ConstIndexArray limitCVs = patches->GetPatchVertices(*limit);
+
+            b.Clear();
+            for (int k=0; k<limitCVs.size(); ++k) {
+                b.AddWithWeight(points[limitCVs[k]], wP[k]);
+            }
+            for (int k=0; k<3; ++k) {
+                if (std::abs(a.GetPos()[k]-b.GetPos()[k]) > SUMMATION_PRECISION) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+    for (int face=0; face<(int)expected.size(); ++face) {
+        if (expected[face] and not found[face]) ++count;
+    }
+    if (count) {
+        printf("// approximate patches fails : %s\n", desc.name.c_str());
+    }
+
+    delete stencils;
+    delete patches;
+    delete approx;
+    delete concurrent;
+    return count ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+// Number of misses of a LRU cache of the vertices of the patches of a table
+static int
+countVertexCacheMisses(OpenSubdiv::Far::PatchTable const & table, int cacheSize) {
+
+    std::vector<OpenSubdiv::Far::Index> cache;
+    std::vector<OpenSubdiv::Far::Index> const & verts = table.GetPatchControlVerticesTable();
+
+    int misses = 0;
+    for (int i=0; i<(int)verts.size(); ++i) {
+        std::vector<OpenSubdiv::Far::Index>::iterator it =
+            std::find(cache.begin(), cache.end(), verts[i]);
+        if (it==cache.end()) {
+            ++misses;
+        } else {
+            cache.erase(it);
+        }
+        cache.insert(cache.begin(), verts[i]);
+        if ((int)cache.size()>cacheSize) {
+            cache.pop_back();
+        }
+    }
+    return misses;
+}
+
+static int
+checkVertexCacheOrder(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Index                    FarIndex;
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+    std::vector<xyzVV> controlVerts(nControlVerts);
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+
+    FarStencilTableFactory::Options options;
+    options.generateIntermediateLevels = false;
+
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    int count=0;
+    for (int triangulate=0; triangulate<2; ++triangulate) {
+
+        FarPatchTableFactory::Options patchOptions;
+        patchOptions.triangulateQuads = triangulate;
+        patchOptions.generateFVarTables = true;
+
+        FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+        FarPatchTable * reordered = new FarPatchTable(*patches);
+
+        std::vector<FarIndex> permutation;
+        FarStencilTable const * permuted = 0;
+        if (FarPatchTableFactory::OptimizeVertexCache(*reordered, &permutation, nControlVerts)) {
+            permuted = FarStencilTableFactory::PermuteStencils(stencils, permutation);
+        }
+        if (not permuted) {
+            printf("// vertex cache order fails (triangulate=%d)\n", triangulate);
+            ++count;
+            delete patches;
+            delete reordered;
+            continue;
+        }
+
+        // evaluate the vertices of both sets of tables
+        int nVerts = nControlVerts + stencils->GetNumStencils();
+
+        std::vector<xyzVV> verts(nVerts), reorderedVerts(nVerts);
+        std::copy(controlVerts.begin(), controlVerts.end(), verts.begin());
+        std::copy(controlVerts.begin(), controlVerts.end(), reorderedVerts.begin());
+        if (stencils->GetNumStencils()) {
+            stencils->UpdateValues(&controlVerts[0], &verts[nControlVerts]);
+            permuted->UpdateValues(&controlVerts[0], &reorderedVerts[nControlVerts]);
+        }
+
+        // the faces of both tables (point positions, patch params and
+        // face-varying values) must match in any order
+        std::vector<std::vector<float> > faces[2];
+        for (int t=0; t<2; ++t) {
+            FarPatchTable const * table = t ? reordered : patches;
+            std::vector<xyzVV> const & points = t ? reorderedVerts : verts;
+            for (int array=0; array<table->GetNumPatchArrays(); ++array) {
+                for (int patch=0; patch<table->GetNumPatches(array); ++patch) {
+                    OpenSubdiv::Far::PatchParam param = table->GetPatchParam(array, patch);
+                    std::vector<float> face;
+                    face.push_back((float)param.field0);
+                    face.push_back((float)param.field1);
+                    OpenSubdiv::Far::ConstIndexArray cvs = table->GetPatchVertices(array, patch);
+                    for (int k=0; k<cvs.size(); ++k) {
+                        face.insert(face.end(), points[cvs[k]].GetPos(), points[cvs[k]].GetPos()+3);
+                    }
+                    for (int channel=0; channel<table->GetNumFVarChannels(); ++channel) {
+                        OpenSubdiv::Far::ConstIndexArray values =
+                            table->GetPatchFVarValues(array, patch, channel);
+                        for (int k=0; k<values.size(); ++k) {
+                            face.push_back((float)values[k]);
+                        }
+                    }
+                    faces[t].push_back(face);
+                }
+            }
+            std::sort(faces[t].begin(), faces[t].end());
+        }
+
+        int missesBefore = countVertexCacheMisses(*patches, 32),
+            missesAfter = countVertexCacheMisses(*reordered, 32);
+
+        if (faces[0]!=faces[1] or missesAfter>missesBefore) {
+            printf("// vertex cache order fails (triangulate=%d, misses %d > %d)\n",
+                triangulate, missesAfter, missesBefore);
+            ++count;
+        }
+
+        delete patches;
+        delete reordered;
+        delete permuted;
+    }
+
+    delete stencils;
+    return count;
+}
+
+// Patches sorted by ptex face must match those of the original table in any
+// order, with the faces of each array in increasing order
+static int
+checkPatchFaceOrder(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    static FarPatchTableFactory::Options::EndCapType const endCapTypes[3] = {
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY };
+
+    int count=0;
+    for (int adaptive=0; adaptive<2; ++adaptive) {
+
+        FarTopologyRefiner const & refiner = adaptive ?
+            fixture.GetSingleCreaseRefiner(maxlevel) : fixture.GetUniformRefiner(maxlevel);
+
+        // legacy Gregory end caps are only those of Catmark
+        int nEndCaps = adaptive ? (desc.scheme==kCatmark ? 3 : 2) : 1;
+        for (int endCap=0; endCap<nEndCaps; ++endCap) {
+
+            FarPatchTableFactory::Options options(maxlevel);
+            options.useSingleCreasePatch = true;
+            options.generateFVarTables = true;
+            options.SetEndCapType(endCapTypes[endCap]);
+
+            FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, options);
+            FarPatchTable * sorted = new FarPatchTable(*patches);
+
+            if (not FarPatchTableFactory::SortPatchesByFace(*sorted)) {
+                printf("// patch face order fails (adaptive=%d, end-cap type %d)\n",
+                    adaptive, endCapTypes[endCap]);
+                ++count;
+                delete patches;
+                delete sorted;
+                continue;
+            }
+
+            bool ordered = true;
+            std::vector<std::vector<float> > records[2];
+            for (int t=0; t<2; ++t) {
+                FarPatchTable const * table = t ? sorted : patches;
+                for (int array=0; array<table->GetNumPatchArrays(); ++array) {
+                    OpenSubdiv::Far::PatchDescriptor::Type type =
+                        table->GetPatchArrayDescriptor(array).GetType();
+                    int arrayStart = 0;
+                    for (int a=0; a<array; ++a) {
+                        arrayStart += table->GetNumPatches(a);
+                    }
+                    for (int patch=0; patch<table->GetNumPatches(array); ++patch) {
+                        OpenSubdiv::Far::PatchParam param = table->GetPatchParam(array, patch);
+                        if (t and patch and param.GetFaceId()<
+                            table->GetPatchParam(array, patch-1).GetFaceId()) {
+                            ordered = false;
+                        }
+                        std::vector<float> record;
+                        record.push_back((float)param.field0);
+                        record.push_back((float)param.field1);
+                        OpenSubdiv::Far::ConstIndexArray cvs = table->GetPatchVertices(array, patch);
+                        record.insert(record.end(), cvs.begin(), cvs.end());
+                        if (not table->GetSharpnessIndexTable().empty()) {
+                            record.push_back(table->GetSingleCreasePatchSharpnessValue(array, patch));
+                        }
+                        if ((type==OpenSubdiv::Far::PatchDescriptor::GREGORY) or
+                            (type==OpenSubdiv::Far::PatchDescriptor::GREGORY_BOUNDARY)) {
+                            FarPatchTable::PatchHandle handle;
+                            handle.arrayIndex = array;
+                            handle.patchIndex = arrayStart + patch;
+                            handle.vertIndex = patch * cvs.size();
+                            OpenSubdiv::Far::PatchTable::ConstQuadOffsetsArray offsets =
+                                table->GetPatchQuadOffsets(handle);
+                            record.insert(record.end(), offsets.begin(), offsets.end());
+                        }
+                        for (int channel=0; channel<table->GetNumFVarChannels(); ++channel) {
+                            OpenSubdiv::Far::ConstIndexArray values =
+                                table->GetPatchFVarValues(array, patch, channel);
+                            record.insert(record.end(), values.begin(), values.end());
+                            if (table->GetFVarPatchParams(channel).size()) {
+                                OpenSubdiv::Far::PatchParam fvarParam =
+                                    table->GetPatchFVarPatchParam(array, patch, channel);
+                                record.push_back((float)fvarParam.field0);
+                                record.push_back((float)fvarParam.field1);
+                            }
+                        }
+                        records[t].push_back(record);
+                    }
+                }
+                std::sort(records[t].begin(), records[t].end());
+            }
+
+            if (records[0]!=records[1] or not ordered) {
+                printf("// patch face order fails (adaptive=%d, end-cap type %d)\n",
+                    adaptive, endCapTypes[endCap]);
+                ++count;
+            }
+            delete patches;
+            delete sorted;
+        }
+    }
+    return count;
+}
+
+static int
+checkMeshlets(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::Index                    FarIndex;
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+    typedef OpenSubdiv::Far::MeshletTable             FarMeshletTable;
+    typedef OpenSubdiv::Far::MeshletTableFactory      FarMeshletTableFactory;
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetUniformRefiner(maxlevel);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices();
+
+    FarStencilTableFactory::Options options;
+    options.generateIntermediateLevels = false;
+
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    std::vector<xyzVV> verts(nControlVerts + stencils->GetNumStencils());
+    for (int i=0; i<nControlVerts; ++i) {
+        verts[i].SetPosition(shape.verts[i*3], shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    if (stencils->GetNumStencils()) {
+        stencils->UpdateValues(&verts[0], &verts[nControlVerts]);
+    }
+    float const * positions = verts[0].GetPos();
+
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner);
+
+    FarMeshletTableFactory::Options meshletOptions;
+    meshletOptions.maxVertices = 32;
+    meshletOptions.maxTriangles = 48;
+
+    FarMeshletTable const * meshlets =
+        FarMeshletTableFactory::Create(*patches, positions, 3, meshletOptions);
+
+    int nfails = meshlets ? 0 : 1;
+
+    // the triangles of the meshlets are those of the faces, in order
+    std::vector<FarIndex> triangles;
+    for (int array=0; nfails==0 and array<patches->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patches->GetNumPatches(array); ++patch) {
+            OpenSubdiv::Far::ConstIndexArray fverts = patches->GetPatchVertices(array, patch);
+            for (int i=0; i<fverts.size()-2; ++i) {
+                triangles.push_back(fverts[0]);
+                triangles.push_back(fverts[i+1]);
+                triangles.push_back(fverts[i+2]);
+            }
+        }
+    }
+
+    int nindices = 0;
+    for (int i=0; nfails==0 and i<meshlets->GetNumMeshlets(); ++i) {
+        FarMeshletTable::Meshlet const & meshlet = meshlets->GetMeshlet(i);
+        if (meshlet.numVertices>meshletOptions.maxVertices or
+            meshlet.numTriangles>meshletOptions.maxTriangles or
+            meshlet.triangleOffset*3!=nindices) {
+            ++nfails;
+            break;
+        }
+        for (int j=0; j<meshlet.numTriangles*3; ++j, ++nindices) {
+            int local = meshlets->GetTriangles()[meshlet.triangleOffset*3 + j];
+            if (local>=meshlet.numVertices or
+                meshlets->GetMeshletVertex(i, local)!=triangles[nindices]) {
+                ++nfails;
+            }
+        }
+        // the bounds contain the vertices and the normals of the triangles
+        for (int j=0; j<meshlet.numVertices; ++j) {
+            float const * p = positions + meshlets->GetMeshletVertex(i, j)*3;
+            float d[3] = { p[0]-meshlet.center[0], p[1]-meshlet.center[1], p[2]-meshlet.center[2] };
+            if (std::sqrt(d[0]*d[0]+d[1]*d[1]+d[2]*d[2]) > meshlet.radius*(1.0f+1e-5f)+1e-6f) {
+                ++nfails;
+            }
+        }
+        if (meshlet.coneCutoff<1.0f) {
+            float mindp = std::sqrt(1.0f - meshlet.coneCutoff*meshlet.coneCutoff);
+            for (int j=0; j<meshlet.numTriangles; ++j) {
+                unsigned char const * tri = &meshlets->GetTriangles()[(meshlet.triangleOffset+j)*3];
+                float const * p0 = positions + meshlets->GetMeshletVertex(i, tri[0])*3,
+                            * p1 = positions + meshlets->GetMeshletVertex(i, tri[1])*3,
+                            * p2 = positions + meshlets->GetMeshletVertex(i, tri[2])*3;
+                float e1[3] = { p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2] },
+                      e2[3] = { p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2] };
+                float n[3] = { e1[1]*e2[2]-e1[2]*e2[1], e1[2]*e2[0]-e1[0]*e2[2], e1[0]*e2[1]-e1[1]*e2[0] };
+                float length = std::sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+                if (length>0.0f and (n[0]*meshlet.coneAxis[0] + n[1]*meshlet.coneAxis[1] +
+                    n[2]*meshlet.coneAxis[2]) < (mindp - 1e-3f)*length) {
+                    ++nfails;
+                }
+            }
+        }
+    }
+    if (nfails==0 and nindices!=(int)triangles.size()) {
+        ++nfails;
+    }
+
+    if (nfails) {
+        printf("// meshlets fails\n");
+    }
+
+    delete meshlets;
+    delete patches;
+    delete stencils;
+    return nfails ? 1 : 0;
+}
+
+// The boxes of the patches must contain their limit surface, and locate it
+// for point and ray queries, before and after being refit to new positions
+static int
+checkPatchBVH(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchBVH            FarPatchBVH;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarStencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateOffsets = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices(),
+        nVerts = stencils->GetNumStencils();
+
+    FarPatchBVH * bvh = 0;
+
+    int nfails = 0;
+    for (int pass=0; pass<2; ++pass) {
+
+        // the second pass deforms the control vertices
+        std::vector<xyzVV> controlVerts(nControlVerts),
+                           points(nVerts + patches->GetNumLocalPoints());
+        for (int i=0; i<nControlVerts; ++i) {
+            float const * p = &shape.verts[i*3];
+            if (pass==0) {
+                controlVerts[i].SetPosition(p[0], p[1], p[2]);
+            } else {
+                controlVerts[i].SetPosition(2.0f*p[0]+p[1], p[1]-0.5f, p[2]*p[2]);
+            }
+        }
+        stencils->UpdateValues(&controlVerts[0], &points[0]);
+        if (patches->GetNumLocalPoints()) {
+            patches->ComputeLocalPointValues(&points[0], &points[nVerts]);
+        }
+        float const * positions = points[0].GetPos();
+
+        if (pass==0) {
+            bvh = new FarPatchBVH(*patches, positions);
+        } else {
+            OpenSubdiv::Far::SerialTaskScheduler scheduler;
+            if (not bvh->Refit(*patches, positions, 3, &scheduler)) {
+                ++nfails;
+            }
+            // refitting finds the boxes of a new hierarchy
+            FarPatchBVH rebuilt(*patches, positions);
+            for (int i=0; i<rebuilt.GetNumPatches(); ++i) {
+                if (not std::equal(rebuilt.GetPatchBox(i), rebuilt.GetPatchBox(i)+6,
+                                   bvh->GetPatchBox(i))) {
+                    ++nfails;
+                }
+            }
+        }
+        if (bvh->GetNumPatches()!=patches->GetNumPatchesTotal()) {
+            ++nfails;
+        }
+
+        std::vector<FarPatchBVH::Handle const *> found;
+        std::vector<float> distances;
+        for (int i=0; nfails==0 and i<bvh->GetNumPatches(); ++i) {
+            FarPatchBVH::Handle const & handle = bvh->GetHandle(i);
+            OpenSubdiv::Far::PatchParam param = patches->GetPatchParam(handle);
+
+            float frac = param.GetParamFraction(),
+                  s = (param.GetU() + 0.3f) * frac,
+                  t = (param.GetV() + 0.6f) * frac;
+
+            float wP[20], wDs[20], wDt[20];
+            patches->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+
+            OpenSubdiv::Far::ConstIndexArray cvs = patches->GetPatchVertices(handle);
+            xyzVV limit;
+            limit.Clear();
+            for (int k=0; k<cvs.size(); ++k) {
+                limit.AddWithWeight(points[cvs[k]], wP[k]);
+            }
+            float const * p = limit.GetPos(),
+                        * box = bvh->GetPatchBox(i);
+            for (int k=0; k<3; ++k) {
+                // clamped to the box against rounding
+                if (p[k] < box[k]-1e-5f or p[k] > box[k+3]+1e-5f) {
+                    ++nfails;
+                }
+            }
+            float point[3];
+            for (int k=0; k<3; ++k) {
+                point[k] = std::max(box[k], std::min(box[k+3], p[k]));
+            }
+
+            bvh->FindPatches(point, found);
+            if (std::find(found.begin(), found.end(), &handle)==found.end()) {
+                ++nfails;
+            }
+
+            // a ray to the point crosses the boxes crossed by the segment
+            // to the point, in order of distance
+            float direction[3] = { -1.0f, -2.0f, -3.0f },
+                  origin[3] = { point[0]+10.0f, point[1]+20.0f, point[2]+30.0f };
+            bvh->IntersectRay(origin, direction, 10.0f, found, &distances);
+
+            int ncrossed = 0;
+            for (int j=0; j<bvh->GetNumPatches(); ++j) {
+                float const * b = bvh->GetPatchBox(j);
+                float tmin = 0.0f, tmax = 10.0f;
+                for (int k=0; k<3; ++k) {
+                    float t0 = (b[k]-origin[k])*(1.0f/direction[k]),
+                          t1 = (b[k+3]-origin[k])*(1.0f/direction[k]);
+                    tmin = std::max(tmin, std::min(t0, t1));
+                    tmax = std::min(tmax, std::max(t0, t1));
+                }
+                ncrossed += (tmin<=tmax);
+            }
+            if ((int)found.size()!=ncrossed or
+                std::find(found.begin(), found.end(), &handle)==found.end()) {
+                ++nfails;
+            }
+            for (int j=1; j<(int)distances.size(); ++j) {
+                if (distances[j]<distances[j-1]) {
+                    ++nfails;
+                }
+            }
+        }
+    }
+    delete bvh;
+
+    if (nfails) {
+        printf("// patch BVH fails : %s\n", desc.name.c_str());
+    }
+
+    delete patches;
+    delete stencils;
+    return nfails ? 1 : 0;
+}
+
+// Closest points and ray hits of locations of the limit surface must be
+// found back on the surface, batched or not, and nothing found beyond the
+// maximum distance or on patches of no finite positions
+static int
+checkLimitSurfaceQuery(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchBVH            FarPatchBVH;
+    typedef OpenSubdiv::Far::LimitSurfaceQuery   FarLimitSurfaceQuery;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarStencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateOffsets = true;
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(refiner, options);
+
+    FarPatchTableFactory::Options patchOptions(maxlevel);
+    patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * patches = FarPatchTableFactory::Create(refiner, patchOptions);
+
+    int nControlVerts = refiner.GetLevel(0).GetNumVertices(),
+        nVerts = stencils->GetNumStencils();
+
+    std::vector<xyzVV> controlVerts(nControlVerts),
+                       points(nVerts + patches->GetNumLocalPoints());
+    for (int i=0; i<nControlVerts; ++i) {
+        controlVerts[i].SetPosition(shape.verts[i*3],
+            shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    stencils->UpdateValues(&controlVerts[0], &points[0]);
+    if (patches->GetNumLocalPoints()) {
+        patches->ComputeLocalPointValues(&points[0], &points[nVerts]);
+    }
+    float const * positions = points[0].GetPos();
+
+    FarPatchBVH bvh(*patches, positions);
+    FarLimitSurfaceQuery query(*patches, bvh, positions);
+
+    float const * box = bvh.GetBox();
+    float size = std::max(box[3]-box[0], std::max(box[4]-box[1], box[5]-box[2])),
+          tolerance = 1e-3f * size;
+
+    // locations of a few patches, and rays towards them along their normal
+    std::vector<float> locations, origins, directions;
+    for (int i=0; i<bvh.GetNumPatches(); i+=7) {
+        FarPatchBVH::Handle const & handle = bvh.GetHandle(i);
+        OpenSubdiv::Far::PatchParam param = patches->GetPatchParam(handle);
+
+        float frac = param.GetParamFraction(),
+              s = (param.GetU() + 0.4f) * frac,
+              t = (param.GetV() + 0.7f) * frac;
+
+        float wP[20], wDs[20], wDt[20];
+        patches->EvaluateBasis(handle, s, t, wP, wDs, wDt);
+
+        OpenSubdiv::Far::ConstIndexArray cvs = patches->GetPatchVertices(handle);
+        float p[3] = { 0, 0, 0 }, ds[3] = { 0, 0, 0 }, dt[3] = { 0, 0, 0 };
+        for (int k=0; k<cvs.size(); ++k) {
+            float const * cv = positions + cvs[k]*3;
+            for (int j=0; j<3; ++j) {
+                p[j] += wP[k]*cv[j];
+                ds[j] += wDs[k]*cv[j];
+                dt[j] += wDt[k]*cv[j];
+            }
+        }
+        float n[3] = { ds[1]*dt[2]-ds[2]*dt[1], ds[2]*dt[0]-ds[0]*dt[2], ds[0]*dt[1]-ds[1]*dt[0] },
+              len = std::sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+        if (len==0.0f) {
+            continue;
+        }
+        for (int j=0; j<3; ++j) {
+            locations.push_back(p[j]);
+            origins.push_back(p[j] + 0.05f*size*n[j]/len);
+            directions.push_back(-n[j]/len);
+        }
+    }
+    int nlocations = (int)locations.size()/3;
+
+    std::vector<FarLimitSurfaceQuery::Result> closest(nlocations), hits(nlocations);
+    OpenSubdiv::Far::SerialTaskScheduler scheduler;
+    query.FindClosestPoints(nlocations, &locations[0], size, &closest[0], &scheduler);
+    query.IntersectRays(nlocations, &origins[0], &directions[0], size, &hits[0], &scheduler);
+
+    int nfails = 0;
+    for (int i=0; i<nlocations; ++i) {
+        FarLimitSurfaceQuery::Result single;
+        if (not query.FindClosestPoint(&locations[i*3], size, single) or
+            single.handle!=closest[i].handle or single.s!=closest[i].s or
+            single.t!=closest[i].t) {
+            ++nfails;
+            continue;
+        }
+        FarLimitSurfaceQuery::Result const * results[2] = { &closest[i], &hits[i] };
+        for (int j=0; j<2; ++j) {
+            FarLimitSurfaceQuery::Result const & result = *results[j];
+            if (not result.handle) {
+                ++nfails;
+                continue;
+            }
+            // the location evaluates to the returned point
+            float wP[20], wDs[20], wDt[20];
+            patches->EvaluateBasis(*result.handle, result.s, result.t, wP, wDs, wDt);
+            OpenSubdiv::Far::ConstIndexArray cvs = patches->GetPatchVertices(*result.handle);
+            float p[3] = { 0, 0, 0 };
+            for (int k=0; k<cvs.size(); ++k) {
+                for (int c=0; c<3; ++c) {
+                    p[c] += wP[k]*positions[cvs[k]*3+c];
+                }
+            }
+            for (int c=0; c<3; ++c) {
+                if (std::abs(p[c]-result.point[c]) > tolerance) {
+                    ++nfails;
+                }
+            }
+        }
+        // the points are on the surface, and the rays hit it before them
+        if (closest[i].distance > tolerance or
+            (hits[i].handle and hits[i].distance > 0.05f*size + tolerance)) {
+            ++nfails;
+        }
+    }
+
+    if (nlocations) {
+        FarLimitSurfaceQuery::Result missed;
+
+        float away[3] = { box[3] + size, box[4] + size, box[5] + size };
+        if (query.FindClosestPoint(away, 0.5f*size, missed) or missed.handle) {
+            ++nfails;
+        }
+
+        // the hierarchy still locates the patches, whose samples are all
+        // rejected
+        std::vector<float> undefinedPositions(points.size()*3,
+            std::numeric_limits<float>::quiet_NaN());
+        FarLimitSurfaceQuery undefinedQuery(*patches, bvh, &undefinedPositions[0]);
+        if (undefinedQuery.FindClosestPoint(&locations[0], size, missed) or
+            missed.handle) {
+            ++nfails;
+        }
+        if (undefinedQuery.IntersectRay(&origins[0], &directions[0], size, missed) or
+            missed.handle) {
+            ++nfails;
+        }
+    }
+
+    if (nfails) {
+        printf("// limit surface query fails : %s (%d)\n", desc.name.c_str(), nfails);
+    }
+
+    delete patches;
+    delete stencils;
+    return nfails ? 1 : 0;
+}
+
+// Fingerprints must depend on the topology only, and cached refiners and
+// tables be shared within a session and restored across sessions
+static int
+checkTopologyCache(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::TopologyDescriptor                      Descriptor;
+    typedef OpenSubdiv::Far::TopologyRefinerFactory<Descriptor>      DescriptorFactory;
+    typedef OpenSubdiv::Far::TopologyFingerprint                     FarTopologyFingerprint;
+    typedef OpenSubdiv::Far::TopologyCache                           FarTopologyCache;
+    typedef OpenSubdiv::Far::StencilTable                            FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory                     FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable                              FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory                       FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Shape const & shape = fixture.GetShape();
+
+    // a copy of the face-vertices, so that descriptors differ by address
+    std::vector<int> nverts(shape.nvertsPerFace), faceverts(shape.faceverts);
+
+    Descriptor descriptors[2];
+    for (int i=0; i<2; ++i) {
+        descriptors[i].numVertices = shape.GetNumVertices();
+        descriptors[i].numFaces = shape.GetNumFaces();
+        descriptors[i].numVertsPerFace = i ? &nverts[0] : &shape.nvertsPerFace[0];
+        descriptors[i].vertIndicesPerFace = i ? &faceverts[0] : &shape.faceverts[0];
+        descriptors[i].isLeftHanded = shape.isLeftHanded;
+    }
+
+    DescriptorFactory::Options options(GetSdcType(shape), GetSdcOptions(shape));
+
+    ReverseTaskScheduler scheduler;
+
+    int count = 0;
+
+    FarTopologyFingerprint::Hash hash =
+        FarTopologyFingerprint::Compute(descriptors[0], options);
+    if (FarTopologyFingerprint::Compute(descriptors[1], options, &scheduler)!=hash) {
+        printf("// topology fingerprint of identical topologies fails : %s\n", desc.name.c_str());
+        ++count;
+    }
+
+    // creasing an edge changes the fingerprint
+    int crease[2] = { shape.faceverts[0], shape.faceverts[1] };
+    float weight = 2.0f;
+    descriptors[1].numCreases = 1;
+    descriptors[1].creaseVertexIndexPairs = crease;
+    descriptors[1].creaseWeights = &weight;
+    if (FarTopologyFingerprint::Compute(descriptors[1], options)==hash) {
+        printf("// topology fingerprint of creased topology fails : %s\n", desc.name.c_str());
+        ++count;
+    }
+    descriptors[1].numCreases = 0;
+
+    FarTopologyRefiner::UniformOptions uniformOptions(maxlevel);
+    FarStencilTableFactory::Options stencilOptions;
+
+    // refiners and tables shared by identical topologies
+    {
+        FarTopologyCache cache;
+
+        FarTopologyRefiner const * refiner =
+            cache.GetRefiner(descriptors[0], options, uniformOptions);
+        FarStencilTable const * stencils =
+            cache.GetStencilTable(descriptors[0], options, uniformOptions, stencilOptions);
+
+        if (not refiner or not stencils or
+            cache.GetRefiner(descriptors[1], options, uniformOptions, &scheduler)!=refiner or
+            cache.GetStencilTable(descriptors[1], options, uniformOptions, stencilOptions)!=stencils or
+            cache.GetNumEntries()!=2) {
+            printf("// topology cache sharing fails : %s\n", desc.name.c_str());
+            ++count;
+        } else {
+            FarStencilTable const * expected =
+                FarStencilTableFactory::Create(*refiner, stencilOptions);
+            if (not equalStencilTables(*expected, *stencils)) {
+                printf("// topology cache stencils fails : %s\n", desc.name.c_str());
+                ++count;
+            }
+            delete expected;
+        }
+    }
+
+    // tables saved by a session and loaded by the next one without refining
+    if (desc.scheme==kCatmark) {
+        FarTopologyRefiner::AdaptiveOptions adaptiveOptions(maxlevel);
+        FarPatchTableFactory::Options patchOptions(maxlevel);
+        patchOptions.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+        FarPatchTable const * patches[2] = { 0, 0 };
+        int numEntries[2] = { 0, 0 };
+
+        std::string directory = createTemporaryDirectory();
+        if (directory.empty()) {
+            printf("// topology cache directory fails : %s\n", desc.name.c_str());
+            return count + 1;
+        }
+
+        FarTopologyCache * caches[2];
+        for (int i=0; i<2; ++i) {
+            caches[i] = new FarTopologyCache(directory.c_str());
+            patches[i] = caches[i]->GetPatchTable(
+                descriptors[i], options, adaptiveOptions, patchOptions);
+            numEntries[i] = caches[i]->GetNumEntries();
+        }
+        if (not patches[0] or not patches[1] or
+            not equalPatchTables(*patches[0], *patches[1]) or
+            numEntries[0]!=2 or numEntries[1]!=1) {
+            printf("// topology cache files fails : %s\n", desc.name.c_str());
+            ++count;
+        }
+        delete caches[0];
+        delete caches[1];
+
+        // the table is the only file saved
+        std::vector<std::string> filenames(1, getTopologyCacheFilename(
+            FarTopologyFingerprint::Combine(
+                FarTopologyFingerprint::Combine(hash, adaptiveOptions), patchOptions),
+            ".patches"));
+        if (not removeTemporaryDirectory(directory, filenames)) {
+            printf("// topology cache directory removal fails : %s\n", desc.name.c_str());
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// The relations of all components of each level, as arrays, must match the
+// relations of the individual components
+static int
+checkTopologyLevelArrays(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::TopologyLevel   FarTopologyLevel;
+    typedef OpenSubdiv::Far::ConstIndexArray FarConstIndexArray;
+    typedef OpenSubdiv::Far::ConstFloatArray FarConstFloatArray;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetFullTopologyRefiner(maxlevel);
+
+    ReverseTaskScheduler scheduler;
+
+    int count=0;
+    for (int level=0; level<refiner.GetNumLevels(); ++level) {
+
+        FarTopologyLevel const & topology = refiner.GetLevel(level);
+
+        int nfaces = topology.GetNumFaces(),
+            nedges = topology.GetNumEdges(),
+            nverts = topology.GetNumVertices();
+
+        FarConstIndexArray faceVerts = topology.GetFaceVertices(),
+                           faceEdges = topology.GetFaceEdges(),
+                           edgeVerts = topology.GetEdgeVertices();
+
+        FarConstFloatArray edgeSharpness = topology.GetEdgeSharpnesses(),
+                           vertSharpness = topology.GetVertexSharpnesses();
+
+        if (faceVerts.size()!=topology.GetNumFaceVertices() or
+            faceEdges.size()!=topology.GetNumFaceVertices() or
+            edgeVerts.size()!=2*nedges or
+            edgeSharpness.size()!=nedges or
+            vertSharpness.size()!=nverts) {
+            ++count;
+            continue;
+        }
+
+        std::vector<int> counts[2], offsets[2];
+        for (int i=0; i<2; ++i) {
+            counts[i].resize(nfaces);
+            offsets[i].resize(nfaces+1);
+            topology.GetFaceVertexCounts(&counts[i][0], i ? &scheduler : 0);
+            topology.GetFaceVertexOffsets(&offsets[i][0], i ? &scheduler : 0);
+        }
+        if (counts[0]!=counts[1] or offsets[0]!=offsets[1] or
+            offsets[0][nfaces]!=topology.GetNumFaceVertices()) {
+            ++count;
+        }
+
+        int regFaceSize = topology.GetRegularFaceSize();
+        for (int face=0; face<nfaces; ++face) {
+            FarConstIndexArray fverts = topology.GetFaceVertices(face),
+                               fedges = topology.GetFaceEdges(face);
+            if (counts[0][face]!=fverts.size() or
+                (regFaceSize and regFaceSize!=fverts.size()) or
+                offsets[0][face+1]-offsets[0][face]!=fverts.size()) {
+                ++count;
+                continue;
+            }
+            for (int i=0; i<fverts.size(); ++i) {
+                if (faceVerts[offsets[0][face]+i]!=fverts[i] or
+                    faceEdges[offsets[0][face]+i]!=fedges[i]) {
+                    ++count;
+                }
+            }
+        }
+        for (int edge=0; edge<nedges; ++edge) {
+            FarConstIndexArray everts = topology.GetEdgeVertices(edge);
+            if (edgeVerts[2*edge]!=everts[0] or edgeVerts[2*edge+1]!=everts[1] or
+                edgeSharpness[edge]!=topology.GetEdgeSharpness(edge)) {
+                ++count;
+            }
+        }
+        for (int vert=0; vert<nverts; ++vert) {
+            if (vertSharpness[vert]!=topology.GetVertexSharpness(vert)) {
+                ++count;
+            }
+        }
+    }
+
+    if (count) {
+        printf("// topology level arrays fail : %s (%d components differ)\n",
+            desc.name.c_str(), count);
+    }
+
+    return count;
+}
+
+// Component ranges applied by a scheduler must partition the components of
+// each level in ranges of balanced cost, and the gathered face-vertex values
+// must match the face-vertices
+struct ComponentRanges {
+    std::vector<std::pair<int, int> > ranges;
+
+    static void Record(int begin, int end, void * data) {
+        static_cast<ComponentRanges *>(data)->ranges.push_back(std::make_pair(begin, end));
+    }
+};
+
+static int
+checkParallelForComponents(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::TopologyLevel   FarTopologyLevel;
+    typedef OpenSubdiv::Far::ConstIndexArray FarConstIndexArray;
+
+    FarTopologyRefiner const & refiner = fixture.GetFullTopologyRefiner(maxlevel);
+
+    ReverseTaskScheduler scheduler;
+
+    int count=0;
+    for (int level=0; level<refiner.GetNumLevels(); ++level) {
+
+        FarTopologyLevel const & topology = refiner.GetLevel(level);
+
+        int nfaces = topology.GetNumFaces(),
+            nverts = topology.GetNumVertices();
+
+        for (int concurrent=0; concurrent<2; ++concurrent) {
+
+            ComponentRanges faceRanges, vertRanges;
+            topology.ParallelForFaces(ComponentRanges::Record, &faceRanges,
+                concurrent ? &scheduler : 0);
+            topology.ParallelForVertices(ComponentRanges::Record, &vertRanges,
+                concurrent ? &scheduler : 0);
+
+            for (int vertices=0; vertices<2; ++vertices) {
+                std::vector<std::pair<int, int> > & ranges =
+                    vertices ? vertRanges.ranges : faceRanges.ranges;
+                int ncomponents = vertices ? nverts : nfaces;
+
+                std::sort(ranges.begin(), ranges.end());
+                int next = 0, maxCost = 0, maxSize = 0, totalCost = 0;
+                for (int i=0; i<(int)ranges.size(); ++i) {
+                    if (ranges[i].first!=next or ranges[i].second<ranges[i].first) {
+                        ++count;
+                    }
+                    next = ranges[i].second;
+
+                    int cost = 0;
+                    for (int j=ranges[i].first; j<ranges[i].second; ++j) {
+                        int size = vertices ? topology.GetVertexEdges(j).size() :
+                                              topology.GetFaceVertices(j).size();
+                        cost += size;
+                        maxSize = std::max(maxSize, size);
+                    }
+                    maxCost = std::max(maxCost, cost);
+                    totalCost += cost;
+                }
+                if (next!=ncomponents or (not concurrent and ranges.size()!=1)) {
+                    ++count;
+                }
+                // ranges exceed their share of the cost by less than a component
+                if (ranges.size()>1 and
+                    maxCost > totalCost/(int)ranges.size() + maxSize) {
+                    printf("// parallel for components fails : unbalanced ranges "
+                        "(level %d, %d > %d)\n", level, maxCost,
+                        totalCost/(int)ranges.size() + maxSize);
+                    ++count;
+                }
+            }
+
+            std::vector<int> vertValues(nverts),
+                             faceVertValues(topology.GetNumFaceVertices(), -1);
+            for (int vert=0; vert<nverts; ++vert) {
+                vertValues[vert] = 7*vert + 1;
+            }
+            if (nverts and topology.GetNumFaceVertices()) {
+                topology.GatherFaceVertexValues(&vertValues[0], &faceVertValues[0],
+                    concurrent ? &scheduler : 0);
+            }
+            FarConstIndexArray faceVerts = topology.GetFaceVertices();
+            for (int i=0; i<faceVerts.size(); ++i) {
+                if (faceVertValues[i]!=vertValues[faceVerts[i]]) {
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (count) {
+        printf("// parallel for components fails (%d)\n", count);
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Uniform refinements exceeding the range of 32-bit indices must fail before
+// any level is allocated
+static int
+checkUniformIndexOverflow(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    OpenSubdiv::Far::SetErrorCallback(countErrors);
+
+    int count=0;
+
+    // the deepest uniform refinement (15 levels) of any of the shapes
+    // overflows, while that of the other tests fits
+    int const levels[2] = { maxlevel, 15 };
+    for (int i=0; i<2; ++i) {
+        FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+        g_numErrors = 0;
+        refiner->RefineUniform(FarTopologyRefiner::UniformOptions(levels[i]));
+
+        bool overflows = (i==1);
+        if ((g_numErrors!=0) != overflows or
+            refiner->GetMaxLevel()!=(overflows ? 0 : levels[i])) {
+            ++count;
+        }
+        delete refiner;
+    }
+
+    OpenSubdiv::Far::SetErrorCallback(0);
+
+    if (count) {
+        printf("// uniform index overflow fails : %s\n", desc.name.c_str());
+    }
+    return count;
+}
+
+// Regular patches bounded by infinitely sharp edges must evaluate the limit
+// surface of the fully isolated features, from fewer refined vertices
+static int
+checkInfSharpPatches(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    // face-varying channels do not support sharpness updates
+    Shape const & shape = fixture.GetShapeWithoutFVar();
+
+    FarPatchTable const * tables[2];
+    FarPatchMap * patchMaps[2];
+    std::vector<xyzVV> points[2];
+    int numVertices[2], numPtexFaces = 0;
+
+    // infinitely sharp edges around every fourth face create creases, corners
+    // and faces bounded by several sharp edges
+    for (int i=0; i<2; ++i) {
+        FarTopologyRefiner * refiner = FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(GetSdcType(shape), GetSdcOptions(shape)));
+
+        OpenSubdiv::Far::TopologyLevel const & base = refiner->GetLevel(0);
+
+        std::vector<OpenSubdiv::Far::Index> edges;
+        for (int face=0; face<base.GetNumFaces(); face+=4) {
+            OpenSubdiv::Far::ConstIndexArray fEdges = base.GetFaceEdges(face);
+            for (int k=0; k<fEdges.size(); ++k) {
+                edges.push_back(fEdges[k]);
+            }
+        }
+        std::vector<float> sharpness(edges.size(), 10.0f);
+        refiner->UpdateBaseSharpness(
+            OpenSubdiv::Far::ConstIndexArray(&edges[0], (int)edges.size()), &sharpness[0],
+            OpenSubdiv::Far::ConstIndexArray(), 0);
+
+        FarTopologyRefiner::AdaptiveOptions adaptiveOptions(maxlevel);
+        adaptiveOptions.useInfSharpPatch = (i==1);
+        refiner->RefineAdaptive(adaptiveOptions);
+
+        FarStencilTableFactory::Options stencilOptions;
+        stencilOptions.generateControlVerts = true;
+        stencilOptions.generateOffsets = true;
+        FarStencilTable const * stencils =
+            FarStencilTableFactory::Create(*refiner, stencilOptions);
+
+        FarPatchTableFactory::Options options(maxlevel);
+        options.useInfSharpPatch = (i==1);
+        options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        tables[i] = FarPatchTableFactory::Create(*refiner, options);
+        patchMaps[i] = new FarPatchMap(*tables[i]);
+
+        int nControlVerts = base.GetNumVertices(),
+            nVerts = stencils->GetNumStencils();
+
+        std::vector<xyzVV> controlVerts(nControlVerts);
+        for (int j=0; j<nControlVerts; ++j) {
+            controlVerts[j].SetPosition(shape.verts[j*3],
+                shape.verts[j*3+1], shape.verts[j*3+2]);
+        }
+        points[i].resize(nVerts + tables[i]->GetNumLocalPoints());
+        stencils->UpdateValues(&controlVerts[0], &points[i][0]);
+        if (tables[i]->GetNumLocalPoints()) {
+            tables[i]->ComputeLocalPointValues(&points[i][0], &points[i][nVerts]);
+        }
+
+        numVertices[i] = refiner->GetNumVerticesTotal();
+        numPtexFaces = OpenSubdiv::Far::PtexIndices(*refiner).GetNumFaces();
+
+        delete stencils;
+        delete refiner;
+    }
+
+    // locations away from the base edges (and from the patches isolating the
+    // sharp features to the last level) lie in smooth regular patches of both
+    static float const s[3] = { 0.3f, 0.6f, 0.75f },
+                       t[3] = { 0.6f, 0.25f, 0.7f };
+
+    float size = 1.0f;
+    for (int i=0; i<(int)shape.verts.size(); ++i) {
+        size = std::max(size, std::abs(shape.verts[i]));
+    }
+    float tolerance = 1e-4f * size;
+
+    int count=0;
+    for (int face=0; face<numPtexFaces; ++face) {
+        for (int k=0; k<3; ++k) {
+
+            float p[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+            for (int i=0; i<2; ++i) {
+                FarPatchTable::PatchHandle const * handle =
+                    patchMaps[i]->FindPatch(face, s[k], t[k]);
+                if (not handle) {
+                    continue;
+                }
+                float wP[20], wDs[20], wDt[20];
+                tables[i]->EvaluateBasis(*handle, s[k], t[k], wP, wDs, wDt);
+
+                OpenSubdiv::Far::ConstIndexArray cvs = tables[i]->GetPatchVertices(*handle);
+                for (int j=0; j<cvs.size(); ++j) {
+                    float const * cv = points[i][cvs[j]].GetPos();
+                    p[i][0] += wP[j]*cv[0];
+                    p[i][1] += wP[j]*cv[1];
+                    p[i][2] += wP[j]*cv[2];
+                }
+            }
+            if (std::abs(p[0][0]-p[1][0]) > tolerance or
+                std::abs(p[0][1]-p[1][1]) > tolerance or
+                std::abs(p[0][2]-p[1][2]) > tolerance) {
+                ++count;
+            }
+        }
+    }
+    if (numVertices[1] > numVertices[0]) {
+        ++count;
+    }
+    if (count) {
+        printf("// inf-sharp patches fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+
+    for (int i=0; i<2; ++i) {
+        delete patchMaps[i];
+        delete tables[i];
+    }
+    return count;
+}
+
+// Isolating extraordinary vertices up to a secondary level only must refine
+// fewer vertices, leaving end caps close to those of the full isolation
+static int
+checkSecondaryLevel(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    Shape const & shape = fixture.GetShape();
+
+    static FarPatchTableFactory::Options::EndCapType const endCapTypes[2] = {
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS };
+
+    float size = 1.0f;
+    for (int i=0; i<(int)shape.verts.size(); ++i) {
+        size = std::max(size, std::abs(shape.verts[i]));
+    }
+    float tolerance = 5e-3f * size;
+
+    static float const s[3] = { 0.3f, 0.6f, 0.75f },
+                       t[3] = { 0.6f, 0.25f, 0.7f };
+
+    int count=0;
+    for (int e=0; e<2; ++e) {
+
+        FarPatchTable const * tables[2];
+        FarPatchMap * patchMaps[2];
+        std::vector<xyzVV> points[2];
+        int numVertices[2], numPtexFaces = 0;
+
+        for (int i=0; i<2; ++i) {
+            FarTopologyRefiner * refiner = fixture.CreateRefiner();
+
+            FarTopologyRefiner::AdaptiveOptions adaptiveOptions(maxlevel);
+            if (i==1) {
+                adaptiveOptions.secondaryLevel = 2;
+            }
+            refiner->RefineAdaptive(adaptiveOptions);
+
+            FarStencilTableFactory::Options stencilOptions;
+            stencilOptions.generateControlVerts = true;
+            stencilOptions.generateOffsets = true;
+            FarStencilTable const * stencils =
+                FarStencilTableFactory::Create(*refiner, stencilOptions);
+
+            FarPatchTableFactory::Options options(maxlevel);
+            options.generateFVarTables = refiner->GetNumFVarChannels()>0;
+            options.SetEndCapType(endCapTypes[e]);
+            tables[i] = FarPatchTableFactory::Create(*refiner, options);
+            patchMaps[i] = new FarPatchMap(*tables[i]);
+
+            int nControlVerts = refiner->GetLevel(0).GetNumVertices(),
+                nVerts = stencils->GetNumStencils();
+
+            std::vector<xyzVV> controlVerts(nControlVerts);
+            for (int j=0; j<nControlVerts; ++j) {
+                controlVerts[j].SetPosition(shape.verts[j*3],
+                    shape.verts[j*3+1], shape.verts[j*3+2]);
+            }
+            points[i].resize(nVerts + tables[i]->GetNumLocalPoints());
+            stencils->UpdateValues(&controlVerts[0], &points[i][0]);
+            if (tables[i]->GetNumLocalPoints()) {
+                tables[i]->ComputeLocalPointValues(&points[i][0], &points[i][nVerts]);
+            }
+
+            numVertices[i] = refiner->GetNumVerticesTotal();
+            numPtexFaces = OpenSubdiv::Far::PtexIndices(*refiner).GetNumFaces();
+
+            delete stencils;
+            delete refiner;
+        }
+
+        for (int face=0; face<numPtexFaces; ++face) {
+            for (int k=0; k<3; ++k) {
+
+                float p[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+                bool found = true;
+                for (int i=0; i<2; ++i) {
+                    FarPatchTable::PatchHandle const * handle =
+                        patchMaps[i]->FindPatch(face, s[k], t[k]);
+                    if (not handle) {
+                        found = false;
+                        continue;
+                    }
+                    float wP[20], wDs[20], wDt[20];
+                    tables[i]->EvaluateBasis(*handle, s[k], t[k], wP, wDs, wDt);
+
+                    OpenSubdiv::Far::ConstIndexArray cvs = tables[i]->GetPatchVertices(*handle);
+                    for (int j=0; j<cvs.size(); ++j) {
+                        float const * cv = points[i][cvs[j]].GetPos();
+                        p[i][0] += wP[j]*cv[0];
+                        p[i][1] += wP[j]*cv[1];
+                        p[i][2] += wP[j]*cv[2];
+                    }
+                }
+                if (not found or
+                    std::abs(p[0][0]-p[1][0]) > tolerance or
+                    std::abs(p[0][1]-p[1][1]) > tolerance or
+                    std::abs(p[0][2]-p[1][2]) > tolerance) {
+                    ++count;
+                }
+            }
+        }
+        if (numVertices[1] > numVertices[0]) {
+            ++count;
+        }
+
+        for (int i=0; i<2; ++i) {
+            delete patchMaps[i];
+            delete tables[i];
+        }
+    }
+    if (count) {
+        printf("// secondary level fails : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+// Legacy Gregory end caps converted to Gregory basis patches : the table is
+// that of Gregory basis end caps, and has no valence table or quad offsets
+static int
+checkLegacyGregoryConversion(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarPatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    FarPatchTable const * expected = FarPatchTableFactory::Create(refiner, options);
+
+    options.SetEndCapType(FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
+    options.convertLegacyGregory = true;
+    FarPatchTable const * converted = FarPatchTableFactory::Create(refiner, options);
+
+    int count=0;
+    if (converted->GetNumPatchArrays() != expected->GetNumPatchArrays() or
+        converted->GetNumLocalPoints() != expected->GetNumLocalPoints() or
+        converted->GetPatchControlVerticesTable() !=
+            expected->GetPatchControlVerticesTable() or
+        not converted->GetVertexValenceTable().empty() or
+        not converted->GetQuadOffsetsTable().empty()) {
+        ++count;
+    } else {
+        for (int i=0; i<converted->GetNumPatchArrays(); ++i) {
+            if (not (converted->GetPatchArrayDescriptor(i) ==
+                     expected->GetPatchArrayDescriptor(i))) {
+                ++count;
+            }
+        }
+        FarStencilTable const * a = converted->GetLocalPointStencilTable(),
+                              * b = expected->GetLocalPointStencilTable();
+        if ((a==0) != (b==0) or (a and
+                (a->GetSizes() != b->GetSizes() or
+                 a->GetControlIndices() != b->GetControlIndices() or
+                 a->GetWeights() != b->GetWeights()))) {
+            ++count;
+        }
+    }
+    if (count) {
+        printf("// legacy Gregory conversion fails : %s\n", desc.name.c_str());
+    }
+    delete converted;
+    delete expected;
+    return count;
+}
+
+// Hinted patch map lookups of moving locations must return the patches of
+// the unhinted lookups, whether the locations left their patches or not
+static int
+checkPatchMapHints(ShapeFixture & fixture, int maxlevel) {
+
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    FarTopologyRefiner const & refiner = fixture.GetAdaptiveRefiner(maxlevel);
+
+    FarPatchTable const * patches =
+        FarPatchTableFactory::Create(refiner, FarPatchTableFactory::Options(maxlevel));
+
+    FarPatchMap patchMap(*patches);
+
+    // one location at the center of each patch, walked across the face by
+    // steps of a fraction of the patch, and on the far corners of the patch
+    std::vector<int> faceids;
+    std::vector<float> u, v, du, dv;
+    for (int array=0; array<patches->GetNumPatchArrays(); ++array) {
+        for (int patch=0; patch<patches->GetNumPatches(array); ++patch) {
+            FarPatchParam param = patches->GetPatchParam(array, patch);
+            float frac = param.GetParamFraction();
+            for (int k=0; k<2; ++k) {
+                faceids.push_back(param.GetFaceId());
+                u.push_back((param.GetU() + 0.5f) * frac);
+                v.push_back((param.GetV() + 0.5f) * frac);
+                du.push_back(k ? 0.5f * frac : 0.3f * frac);
+                dv.push_back(k ? 0.5f * frac : 0.2f * frac);
+            }
+        }
+    }
+    int nlocations = (int)faceids.size();
+
+    std::vector<FarPatchMap::Handle const *> hinted(nlocations), batched(nlocations),
+                                             expected(nlocations);
+    patchMap.FindPatches(&faceids[0], &u[0], &v[0], nlocations, &hinted[0]);
+    batched = hinted;
+
+    int count=0;
+    for (int step=0; step<8; ++step) {
+        for (int i=0; i<nlocations; ++i) {
+            u[i] += du[i];
+            v[i] += dv[i];
+            if (u[i]>1.0f) u[i] -= 1.0f;
+            if (v[i]>1.0f) v[i] -= 1.0f;
+        }
+        patchMap.FindPatches(&faceids[0], &u[0], &v[0], nlocations, &expected[0]);
+        patchMap.UpdatePatches(&faceids[0], &u[0], &v[0], nlocations, &batched[0]);
+
+        for (int i=0; i<nlocations; ++i) {
+            hinted[i] = patchMap.FindPatch(faceids[i], u[i], v[i], hinted[i]);
+            if (hinted[i]!=expected[i] or batched[i]!=expected[i]) {
+                ++count;
+            }
+        }
+    }
+    if (count) {
+        printf("// patch map hints fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    delete patches;
+    return count;
+}
+
+//------------------------------------------------------------------------------
+static void
+usage(char ** argv) {
+    printf("%s [<options>]\n\n", argv[0]);
+    printf("    Options :\n");
+
+    RegressionCases::PrintUsage();
+
+    printf("        -help / -h\n");
+    printf("        Displays usage information.\n");
+}
+
+//------------------------------------------------------------------------------
+static void
+parseArgs(int argc, char ** argv) {
+
+    for (int argi=1; argi<argc; ++argi) {
+        if (g_cases.ParseArg(argc, argv, argi)) {
+            continue;
+        } else if ((not strcmp(argv[argi],"-help")) or
+                   (not strcmp(argv[argi],"-h"))) {
+            usage(argv);
+            exit(0);
+        } else {
+            usage(argv);
+            exit(1);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+
+    // Shapes are independent cases : '-partition <k> <n>' runs a subset of
+    // them, so that the partitions of the target can run concurrently.
+    parseArgs(argc, argv);
+
+    int levels=5, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        if (not g_cases.Begin()) continue;
+
+        printf("- %s\n", g_shapes[i].name.c_str());
+
+        ShapeFixture fixture(g_shapes[i]);
+
+        int failures=0;
+        failures+=checkConcurrentTopology(fixture, levels);
+        failures+=checkConcurrentStencils(fixture, levels);
+        failures+=checkConcurrentPatches(fixture, levels);
+        failures+=checkSerializedTables(fixture, levels);
+        failures+=checkReorderedStencils(fixture, levels);
+        failures+=checkSharedStencils(fixture, levels-2);
+        failures+=checkSharpnessUpdate(fixture, levels);
+        failures+=checkSparseRefinement(fixture, levels);
+        failures+=checkFaceIsolationLevels(fixture, levels);
+        failures+=checkMemoryUsage(fixture, levels-2);
+        failures+=checkTrimmedRefiner(fixture, levels-2);
+        failures+=checkArenaAllocation(fixture, levels);
+        failures+=checkConcurrentPrimvars(fixture, levels-2);
+        failures+=checkPrimvarBuffers(fixture, levels-2);
+        failures+=checkVertexMaskCache(fixture, levels-2);
+        failures+=checkDescriptorEdges(fixture, levels-2);
+        failures+=checkSharedTopology(fixture, levels-2);
+        failures+=checkFVarChannelUpdate(fixture, levels-2);
+        failures+=checkDeferredFVarChannels(fixture, levels-2);
+        failures+=checkBicubicFVarPatches(fixture, levels-2);
+        failures+=checkVertexAliasFVarChannels(fixture, levels-2);
+        failures+=checkSecondDerivatives(fixture, levels-2);
+        failures+=checkPatchPointStencils(fixture, levels-2);
+        failures+=checkBezierPatchStencils(fixture, levels-2);
+        failures+=checkSingleCreasePatches(fixture, levels);
+        failures+=checkSharedEndCapPoints(fixture, levels-2);
+        failures+=checkConcurrentSharpness(fixture, levels);
+        failures+=checkLoopPatches(fixture, levels-2);
+        failures+=checkStreamingRefinement(fixture, levels-2);
+        failures+=checkSkippedHoles(fixture, levels-2);
+        failures+=checkTopologyValidation(fixture, levels-2);
+        failures+=checkPartitionedPatches(fixture, levels-2);
+        failures+=checkPatchProvider(fixture, levels-2);
+        failures+=checkProfileZones(fixture, levels-2);
+        failures+=checkStencilReverseIndex(fixture, levels-2);
+        failures+=checkTransposeStencils(fixture, levels-2);
+        failures+=checkPtexAdjacency(fixture, levels);
+        failures+=checkLevelsOfDetail(fixture, levels-2);
+        failures+=checkApproximatePatches(fixture, levels-2);
+        failures+=checkVertexCacheOrder(fixture, levels-2);
+        failures+=checkPatchFaceOrder(fixture, levels-2);
+        failures+=checkMeshlets(fixture, levels-2);
+        failures+=checkPatchBVH(fixture, levels-2);
+        failures+=checkLimitSurfaceQuery(fixture, levels-2);
+        failures+=checkTopologyCache(fixture, levels-2);
+        failures+=checkTopologyLevelArrays(fixture, levels-2);
+        failures+=checkParallelForComponents(fixture, levels-1);
+        failures+=checkUniformIndexOverflow(fixture, levels-2);
+        failures+=checkInfSharpPatches(fixture, levels);
+        failures+=checkSecondaryLevel(fixture, levels);
+        failures+=checkLegacyGregoryConversion(fixture, levels-2);
+        failures+=checkPatchMapHints(fixture, levels-2);
+        failures+=checkApproximateStencils(fixture, levels-2);
+        failures+=checkBilinearStencils(fixture, levels-2);
+        failures+=checkBuildMonitor(fixture, levels-2);
+        failures+=checkFaceLevelTable(fixture, levels-2);
+        failures+=checkIncrementalRefiner(fixture, levels-2);
+        failures+=checkLevelStencilCounts(fixture, levels-2);
+        failures+=checkLimitProjection(fixture, levels-2);
+        failures+=checkMovedStencilTables(fixture, levels-2);
+        failures+=checkLocalPointPass(fixture, levels-2);
+        failures+=checkPartitionedStencils(fixture, levels-2);
+        failures+=checkPresizedStencils(fixture, levels-2);
+        failures+=checkSharpnessPropagation(fixture, levels-2);
+        failures+=checkStatistics(fixture, levels-2);
+        failures+=checkTopologyBatch(fixture, levels-2);
+        failures+=checkVariableLevelMesh(fixture, levels-2);
+
+        g_cases.End(g_shapes[i].name, failures);
+        total+=failures;
+    }
+
+    g_cases.PrintReport();
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+    return (total==0) ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
@@ -22,9 +22,12 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include <stdarg.h>
 #include <stdio.h>
 
 #include "../../regression/common/hbr_utils.h"
+// XXX: revisit the directory structure for examples/tests
+#include "../../examples/common/stopwatch.h"
 
 //
 // Regression testing matching Hbr to a pre-generated data-set
@@ -33,7 +36,11 @@
 // Precision is currently held at bit-wise identical
 static bool g_allowWeakRegression=true,
             g_strictRegressionFailure=false,
-            g_verbose=false;
+            g_verbose=false,
+            g_timing=false;
+
+// Number of shapes checked concurrently
+static int g_numThreads=1;
 
 #define STRICT_PRECISION 0
 #define WEAK_PRECISION 1e-6
@@ -179,21 +186,57 @@ static void writeObj( const char * fname, xyzmesh const * mesh,
 }
 
 //------------------------------------------------------------------------------
-static int checkMesh( shaperec const & r, int levels ) {
+// Results of the check of a shape : shapes may be checked concurrently, so
+// their report is buffered and printed in order once all are checked
+struct checkResult {
+
+    checkResult() : count(0), refineTime(0.0), weakPrecision(false) { }
+
+    std::string report;
+
+    int count;
+
+    double refineTime;   // time spent refining the Hbr mesh (in seconds)
+
+    bool weakPrecision;  // some vertices only matched within WEAK_PRECISION
+};
+
+static void appendReport( std::string & report, char const * format, ... ) {
+
+    char line[1024];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    report += line;
+}
+
+//------------------------------------------------------------------------------
+static void checkMesh( shaperec const & r, int levels, checkResult & result ) {
 
     int count=0;
 
+    double refineTime=0.0;
+
     float deltaAvg[3] = {0.0f, 0.0f, 0.0f},
           deltaCnt[3] = {0.0f, 0.0f, 0.0f};
 
-    xyzmesh * mesh = simpleHbr<xyzVV>(r.data.c_str(), r.scheme, 0);
+    // the mesh owns its scheme, so that it can be refined in parallel with
+    // the meshes of other shapes
+    OpenSubdiv::HbrSubdivision<xyzVV> * subdivision =
+        createSubdivision<xyzVV>(r.scheme);
+
+    xyzmesh * mesh = simpleHbr<xyzVV>(r.data.c_str(), r.scheme, 0, false,
+        subdivision);
 
     int firstface=0, lastface=mesh->GetNumFaces(),
-        firstvert=0, lastvert=mesh->GetNumVertices(), nverts;
+        firstvert=0, lastvert=mesh->GetNumVertices(), nverts=0;
 
     static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
 
-    printf("- %-25s ( %-8s ): ", r.name.c_str(), schemes[r.scheme]);
+    appendReport(result.report, "- %-25s ( %-8s ): ", r.name.c_str(), schemes[r.scheme]);
 
     for (int l=0; l<levels; ++l ) {
 
@@ -208,10 +251,14 @@ static int checkMesh( shaperec const & r, int levels ) {
         assert(sh);
 
         // subdivide up to current level
+        Stopwatch stopwatch;
+        stopwatch.Start();
         for (int i=firstface; i<lastface; ++i) {
             xyzface * f = mesh->GetFace(i);
             f->Refine();
         }
+        stopwatch.Stop();
+        refineTime += stopwatch.GetElapsed();
 
         firstface = lastface;
         lastface = mesh->GetNumFaces();
@@ -243,10 +290,10 @@ static int checkMesh( shaperec const & r, int levels ) {
             float dist = sqrtf( delta[0]*delta[0]+delta[1]*delta[1]+delta[2]*delta[2]);
             if ( dist > STRICT_PRECISION ) {
                 if(dist < WEAK_PRECISION and g_allowWeakRegression) {
-                    g_strictRegressionFailure=true;
+                    result.weakPrecision=true;
                 } else {
                     if (g_verbose) {
-                        printf("\n// HbrVertex<T> %d fails : dist=%.10f "
+                        appendReport(result.report, "\n// HbrVertex<T> %d fails : dist=%.10f "
                             "(%.10f %.10f %.10f) (%.10f %.10f %.10f)", i, dist,
                                     apos[0], apos[1], apos[2],
                                         bpos[0], bpos[1], bpos[2] );
@@ -264,7 +311,7 @@ static int checkMesh( shaperec const & r, int levels ) {
             writeObj(errfile.str().c_str(), mesh,
                 firstface, lastface, firstvert, lastvert);
 
-            printf("\n  wrote: %s\n", errfile.str().c_str());
+            appendReport(result.report, "\n  wrote: %s\n", errfile.str().c_str());
         }
 
         delete sh;
@@ -279,22 +326,29 @@ static int checkMesh( shaperec const & r, int levels ) {
         deltaAvg[2]/=deltaCnt[2];
 
     if (g_verbose) {
-        printf("\n  delta ratio : (%d/%d %d/%d %d/%d)", (int)deltaCnt[0], nverts,
+        appendReport(result.report, "\n  delta ratio : (%d/%d %d/%d %d/%d)", (int)deltaCnt[0], nverts,
                                                         (int)deltaCnt[1], nverts,
                                                         (int)deltaCnt[2], nverts );
-        printf("\n  average delta : (%.10f %.10f %.10f)", deltaAvg[0],
+        appendReport(result.report, "\n  average delta : (%.10f %.10f %.10f)", deltaAvg[0],
                                                           deltaAvg[1],
                                                           deltaAvg[2] );
     }
 
+    if (g_timing) {
+        appendReport(result.report, " (%.3f ms, %lu KB)", refineTime*1000.0,
+            (unsigned long)(mesh->GetMemStats()/1024));
+    }
+
     if (count==0) {
-        printf(" success !\n");
+        appendReport(result.report, " success !\n");
     } else
-        printf(" failed !\n");
+        appendReport(result.report, " failed !\n");
 
     delete mesh;
+    delete subdivision;
 
-    return count;
+    result.count = count;
+    result.refineTime = refineTime;
 }
 
 //------------------------------------------------------------------------------
@@ -302,6 +356,9 @@ static void usage(char const * appname) {
     printf("Usage : %s [options]\n", appname);
     printf("    -s | -strict  : strict bitwise comparisons\n");
     printf("    -v | -verbose : verbose output\n");
+    printf("    -t | -timing  : time the refinement of each shape and report\n"
+           "                    the memory of its components\n");
+    printf("    -j | -threads <n> : number of shapes checked concurrently\n");
 }
 
 //------------------------------------------------------------------------------
@@ -314,6 +371,11 @@ int main(int argc, char ** argv) {
             g_allowWeakRegression=false;
         } else if ((not strcmp(argv[i],"-v")) or (not strcmp(argv[i],"-verbose"))) {
             g_verbose=true;
+        } else if ((not strcmp(argv[i],"-t")) or (not strcmp(argv[i],"-timing"))) {
+            g_timing=true;
+        } else if (((not strcmp(argv[i],"-j")) or (not strcmp(argv[i],"-threads")))
+                    and i+1<argc) {
+            g_numThreads=std::max(1, atoi(argv[++i]));
         } else {
             usage( argv[1] );
             return 1;
@@ -324,8 +386,37 @@ int main(int argc, char ** argv) {
 
     printf("Baseline Path : \"%s\"\n", g_baseline_path.c_str());
 
-    for (int i=0; i<(int)g_shapes.size(); ++i)
-        total+=checkMesh( g_shapes[i], levels );
+    int nshapes = (int)g_shapes.size();
+
+    std::vector<checkResult> results(nshapes);
+
+    Stopwatch stopwatch;
+    stopwatch.Start();
+
+    // each shape is refined in its own mesh, so shapes are independent
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic) num_threads(g_numThreads)
+#endif
+    for (int i=0; i<nshapes; ++i)
+        checkMesh( g_shapes[i], levels, results[i] );
+
+    stopwatch.Stop();
+
+    double refineTime=0.0;
+    for (int i=0; i<nshapes; ++i) {
+        printf("%s", results[i].report.c_str());
+
+        total+=results[i].count;
+        refineTime+=results[i].refineTime;
+        if (results[i].weakPrecision)
+            g_strictRegressionFailure=true;
+    }
+
+    if (g_timing) {
+        printf("Total refinement time : %.3f ms\n", refineTime*1000.0);
+        printf("Elapsed time (%d threads) : %.3f ms\n", g_numThreads,
+            stopwatch.GetElapsed()*1000.0);
+    }
 
     if (total==0) {
         printf("All tests passed.\n");
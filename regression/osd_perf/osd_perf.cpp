@@ -0,0 +1,811 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+//
+// Throughput of the Osd evaluators : EvalStencils (refinement and limit
+// stencils) and EvalPatches, with and without first derivatives, for each
+// backend compiled in, primvar width and level of refinement.
+//
+// The time of each evaluation is split in three phases : 'upload' of the
+// control vertices (up to their synchronization), 'kernel' (the dispatch
+// of the evaluation) and 'sync' (waiting for its completion -- asynchronous
+// backends spend most of their time there).
+//
+
+#if defined(OSD_PERF_HAS_GLFW)
+    #if defined(__APPLE__)
+        #if defined(OSD_USES_GLEW)
+            #include <GL/glew.h>
+        #else
+            #include <OpenGL/gl3.h>
+        #endif
+        #define GLFW_INCLUDE_GL3
+        #define GLFW_NO_GLU
+    #else
+        #include <GL/glew.h>
+        #if defined(_WIN32)
+            // XXX Must include windows.h here or GLFW pollutes the global namespace
+            #define WIN32_LEAN_AND_MEAN
+            #include <windows.h>
+        #endif
+    #endif
+    #include <GLFW/glfw3.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <opensubdiv/far/patchMap.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/osd/mesh.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <opensubdiv/osd/ompEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <opensubdiv/osd/tbbEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_CUDA
+    #include <opensubdiv/osd/cudaEvaluator.h>
+    #include <opensubdiv/osd/cudaPatchTable.h>
+    #include <opensubdiv/osd/cudaVertexBuffer.h>
+#endif
+#ifdef OPENSUBDIV_HAS_OPENCL
+    #include <opensubdiv/osd/clEvaluator.h>
+    #include <opensubdiv/osd/clPatchTable.h>
+    #include <opensubdiv/osd/clVertexBuffer.h>
+#endif
+#if defined(OSD_PERF_HAS_GLFW)
+    #include <opensubdiv/osd/glPatchTable.h>
+    #include <opensubdiv/osd/glVertexBuffer.h>
+    #ifdef OPENSUBDIV_HAS_GLSL_TRANSFORM_FEEDBACK
+        #include <opensubdiv/osd/glXFBEvaluator.h>
+    #endif
+    #ifdef OPENSUBDIV_HAS_GLSL_COMPUTE
+        #include <opensubdiv/osd/glComputeEvaluator.h>
+    #endif
+#endif
+
+#include "../../regression/common/far_utils.h"
+// XXX: revisit the directory structure for examples/tests
+#include "../../examples/common/stopwatch.h"
+
+#include "init_shapes.h"
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+#ifdef OPENSUBDIV_HAS_OPENCL
+// A minimal OpenCL context (no sharing with GL) with the interface expected
+// by the CL evaluator and buffers
+class CLContext {
+public:
+    CLContext() : _context(0), _queue(0) { }
+
+    ~CLContext() {
+        if (_queue) clReleaseCommandQueue(_queue);
+        if (_context) clReleaseContext(_context);
+    }
+
+    bool Initialize() {
+#ifdef OPENSUBDIV_HAS_CLEW
+        if (clewInit() != CLEW_SUCCESS) {
+            return false;
+        }
+#endif
+        cl_platform_id platform;
+        cl_uint numPlatforms = 0;
+        if (clGetPlatformIDs(1, &platform, &numPlatforms) != CL_SUCCESS or
+            numPlatforms == 0) {
+            return false;
+        }
+        cl_device_id device;
+        if (clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1, &device, NULL) != CL_SUCCESS and
+            clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, 1, &device, NULL) != CL_SUCCESS) {
+            return false;
+        }
+        cl_int err;
+        _context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+        if (err != CL_SUCCESS) {
+            _context = 0;
+            return false;
+        }
+        _queue = clCreateCommandQueue(_context, device, 0, &err);
+        if (err != CL_SUCCESS) {
+            _queue = 0;
+            return false;
+        }
+        return true;
+    }
+
+    cl_context GetContext() const { return _context; }
+
+    cl_command_queue GetCommandQueue() const { return _queue; }
+
+private:
+    cl_context _context;
+    cl_command_queue _queue;
+};
+#endif
+
+//------------------------------------------------------------------------------
+// Tables evaluated for a shape refined to a given level
+struct Problem {
+
+    Problem() : numCoarseVertices(0), numRefinedVertices(0),
+        vertexStencils(0), limitStencils(0), patchTable(0) { }
+
+    ~Problem() {
+        delete vertexStencils;
+        delete limitStencils;
+        delete patchTable;
+    }
+
+    std::string shape;
+    int level;
+
+    int numCoarseVertices,
+        numRefinedVertices;       // refined vertices and local points
+
+    Far::StencilTable const      * vertexStencils;
+    Far::LimitStencilTable const * limitStencils;
+    Far::PatchTable const        * patchTable;
+
+    std::vector<Osd::PatchCoord> patchCoords;
+};
+
+static bool
+createProblem(Shape const * shape, int level, int samples, Problem & problem) {
+
+    Sdc::SchemeType type = GetSdcType(*shape);
+    Sdc::Options sdcOptions = GetSdcOptions(*shape);
+
+    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
+        *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+    if (not refiner) {
+        return false;
+    }
+    refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(level));
+
+    Far::StencilTable const * vertexStencils =
+        Far::StencilTableFactory::Create(*refiner, Far::StencilTableFactory::Options());
+
+    Far::PatchTableFactory::Options poptions(level);
+    poptions.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    Far::PatchTable const * patchTable = Far::PatchTableFactory::Create(*refiner, poptions);
+
+    if (Far::StencilTable const * withLocalPoints =
+        Far::StencilTableFactory::AppendLocalPointStencilTable(*refiner,
+            vertexStencils, patchTable->GetLocalPointStencilTable())) {
+        delete vertexStencils;
+        vertexStencils = withLocalPoints;
+    }
+
+    // a grid of samples at the center of 'samples' x 'samples' cells of each
+    // ptex face, located on the patches and as limit stencils
+    int numPtexFaces = Far::PtexIndices(*refiner).GetNumFaces();
+
+    std::vector<float> s(samples * samples), t(samples * samples);
+    for (int j = 0; j < samples; ++j) {
+        for (int i = 0; i < samples; ++i) {
+            s[j * samples + i] = ((float)i + 0.5f) / (float)samples;
+            t[j * samples + i] = ((float)j + 0.5f) / (float)samples;
+        }
+    }
+
+    Far::PatchMap patchMap(*patchTable);
+
+    Far::LimitStencilTableFactory::LocationArrayVec locations(numPtexFaces);
+    for (int face = 0; face < numPtexFaces; ++face) {
+        locations[face].ptexIdx = face;
+        locations[face].numLocations = samples * samples;
+        locations[face].s = &s[0];
+        locations[face].t = &t[0];
+
+        for (int i = 0; i < samples * samples; ++i) {
+            if (Far::PatchTable::PatchHandle const * handle =
+                patchMap.FindPatch(face, s[i], t[i])) {
+                problem.patchCoords.push_back(Osd::PatchCoord(*handle, s[i], t[i]));
+            }
+        }
+    }
+
+    problem.level = level;
+    problem.numCoarseVertices = refiner->GetLevel(0).GetNumVertices();
+    problem.numRefinedVertices = vertexStencils->GetNumStencils();
+    problem.vertexStencils = vertexStencils;
+    problem.limitStencils = Far::LimitStencilTableFactory::Create(*refiner, locations);
+    problem.patchTable = patchTable;
+
+    delete refiner;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+enum Kernel {
+    kVertexStencils = 0,   // EvalStencils of the refined vertices
+    kLimitStencils,        // EvalStencils of limit locations
+    kPatches,              // EvalPatches at the same locations
+    kNumKernels
+};
+
+static char const * g_kernelNames[kNumKernels] = {
+    "stencils", "limit_stencils", "patches" };
+
+// Median of the samples of a phase
+struct Phase {
+
+    double GetMedian() const {
+        if (times.empty()) return 0.0;
+        std::vector<double> sorted(times);
+        std::sort(sorted.begin(), sorted.end());
+        int n = (int)sorted.size();
+        return (n & 1) ? sorted[n/2] : 0.5 * (sorted[n/2 - 1] + sorted[n/2]);
+    }
+
+    std::vector<double> times;
+};
+
+struct Result {
+    std::string backend,
+                shape;
+    int level,
+        kernel,
+        width,
+        numElements;    // vertices or locations evaluated
+    bool derivatives;
+    Phase upload,
+          dispatch,
+          sync;
+
+    double GetThroughput() const {
+        double t = dispatch.GetMedian() + sync.GetMedian();
+        return t > 0.0 ? numElements / t : 0.0;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Evaluation of a Problem with a given backend : the buffers and tables of the
+// backend are created for each primvar width, outside of the timed phases.
+//
+// note: patch coordinates are stored in a vertex buffer of 5 floats, as done
+//       in glEvalLimit.
+//
+template <typename VERTEX_BUFFER, typename STENCIL_TABLE,
+          typename LIMIT_STENCIL_TABLE, typename PATCH_TABLE,
+          typename EVALUATOR, typename DEVICE_CONTEXT = void>
+class BackendPerf {
+public:
+    typedef Osd::EvaluatorCacheT<EVALUATOR> EvaluatorCache;
+
+    BackendPerf(char const * name, Problem const & problem,
+                DEVICE_CONTEXT * deviceContext = NULL) :
+        _name(name), _problem(problem), _deviceContext(deviceContext) {
+
+        _vertexStencils = Osd::convertToCompatibleStencilTable<STENCIL_TABLE>(
+            problem.vertexStencils, _deviceContext);
+        _limitStencils = Osd::convertToCompatibleStencilTable<LIMIT_STENCIL_TABLE>(
+            problem.limitStencils, _deviceContext);
+        _patchTable = PATCH_TABLE::Create(problem.patchTable, _deviceContext);
+
+        int numCoords = (int)problem.patchCoords.size();
+        _patchCoords = VERTEX_BUFFER::Create(5, numCoords, _deviceContext);
+        if (numCoords) {
+            _patchCoords->UpdateData((float const *)&problem.patchCoords[0],
+                0, numCoords, _deviceContext);
+        }
+    }
+
+    ~BackendPerf() {
+        delete _vertexStencils;
+        delete _limitStencils;
+        delete _patchTable;
+        delete _patchCoords;
+    }
+
+    void Run(int width, int repeats, std::vector<Result> & results) {
+
+        int numCoarse = _problem.numCoarseVertices,
+            numTotal = numCoarse + _problem.numRefinedVertices,
+            numLocations = _problem.limitStencils ?
+                _problem.limitStencils->GetNumStencils() : 0,
+            numCoords = (int)_problem.patchCoords.size();
+
+        std::vector<float> coarse(numCoarse * width);
+        for (int i = 0; i < (int)coarse.size(); ++i) {
+            coarse[i] = (float)(i % 17) * 0.1f;
+        }
+
+        // the refined vertices follow the control vertices in the same buffer
+        _vertices = VERTEX_BUFFER::Create(width, numTotal, _deviceContext);
+        _values = VERTEX_BUFFER::Create(width, std::max(numLocations, numCoords), _deviceContext);
+        _du = VERTEX_BUFFER::Create(width, std::max(numLocations, numCoords), _deviceContext);
+        _dv = VERTEX_BUFFER::Create(width, std::max(numLocations, numCoords), _deviceContext);
+
+        _srcDesc = Osd::BufferDescriptor(0, width, width);
+        _refinedDesc = Osd::BufferDescriptor(numCoarse * width, width, width);
+        _dstDesc = Osd::BufferDescriptor(0, width, width);
+
+        // populate the refined vertices the patches are evaluated from
+        _vertices->UpdateData(&coarse[0], 0, numCoarse, _deviceContext);
+        dispatch(kVertexStencils, false);
+        EVALUATOR::Synchronize(_deviceContext);
+
+        Stopwatch stopwatch;
+
+        for (int kernel = 0; kernel < kNumKernels; ++kernel) {
+            for (int derivatives = 0; derivatives < 2; ++derivatives) {
+
+                if (kernel == kVertexStencils and derivatives) continue;
+                if (kernel == kLimitStencils and not numLocations) continue;
+                if (kernel == kPatches and not numCoords) continue;
+
+                Result result;
+                result.backend = _name;
+                result.shape = _problem.shape;
+                result.level = _problem.level;
+                result.kernel = kernel;
+                result.width = width;
+                result.derivatives = derivatives != 0;
+                result.numElements = kernel == kVertexStencils ? _problem.numRefinedVertices :
+                    (kernel == kLimitStencils ? numLocations : numCoords);
+
+                // compile the kernels of instantiated evaluators first
+                dispatch(kernel, result.derivatives);
+                EVALUATOR::Synchronize(_deviceContext);
+
+                for (int i = 0; i < repeats; ++i) {
+                    stopwatch.Start();
+                    _vertices->UpdateData(&coarse[0], 0, numCoarse, _deviceContext);
+                    EVALUATOR::Synchronize(_deviceContext);
+                    stopwatch.Stop();
+                    result.upload.times.push_back(stopwatch.GetElapsed());
+
+                    stopwatch.Start();
+                    dispatch(kernel, result.derivatives);
+                    stopwatch.Stop();
+                    result.dispatch.times.push_back(stopwatch.GetElapsed());
+
+                    stopwatch.Start();
+                    EVALUATOR::Synchronize(_deviceContext);
+                    stopwatch.Stop();
+                    result.sync.times.push_back(stopwatch.GetElapsed());
+                }
+                results.push_back(result);
+            }
+        }
+
+        delete _vertices;
+        delete _values;
+        delete _du;
+        delete _dv;
+    }
+
+private:
+
+    void dispatch(int kernel, bool derivatives) {
+
+        Osd::BufferDescriptor duDesc(0, _dstDesc.length, _dstDesc.stride),
+                              dvDesc(0, _dstDesc.length, _dstDesc.stride);
+
+        if (kernel == kVertexStencils) {
+            EVALUATOR const * instance = Osd::GetEvaluator<EVALUATOR>(
+                &_evaluatorCache, _srcDesc, _refinedDesc, _deviceContext);
+            EVALUATOR::EvalStencils(_vertices, _srcDesc, _vertices, _refinedDesc,
+                _vertexStencils, instance, _deviceContext);
+
+        } else if (kernel == kLimitStencils and not derivatives) {
+            EVALUATOR const * instance = Osd::GetEvaluator<EVALUATOR>(
+                &_evaluatorCache, _srcDesc, _dstDesc, _deviceContext);
+            EVALUATOR::EvalStencils(_vertices, _srcDesc, _values, _dstDesc,
+                _limitStencils, instance, _deviceContext);
+
+        } else if (kernel == kLimitStencils) {
+            EVALUATOR const * instance = Osd::GetEvaluator<EVALUATOR>(
+                &_evaluatorCache, _srcDesc, _dstDesc, duDesc, dvDesc, _deviceContext);
+            EVALUATOR::EvalStencils(_vertices, _srcDesc, _values, _dstDesc,
+                _du, duDesc, _dv, dvDesc, _limitStencils, instance, _deviceContext);
+
+        } else if (not derivatives) {
+            EVALUATOR const * instance = Osd::GetEvaluator<EVALUATOR>(
+                &_evaluatorCache, _srcDesc, _dstDesc, _deviceContext);
+            EVALUATOR::EvalPatches(_vertices, _srcDesc, _values, _dstDesc,
+                (int)_problem.patchCoords.size(), _patchCoords, _patchTable,
+                instance, _deviceContext);
+
+        } else {
+            EVALUATOR const * instance = Osd::GetEvaluator<EVALUATOR>(
+                &_evaluatorCache, _srcDesc, _dstDesc, duDesc, dvDesc, _deviceContext);
+            EVALUATOR::EvalPatches(_vertices, _srcDesc, _values, _dstDesc,
+                _du, duDesc, _dv, dvDesc,
+                (int)_problem.patchCoords.size(), _patchCoords, _patchTable,
+                instance, _deviceContext);
+        }
+    }
+
+    std::string _name;
+    Problem const & _problem;
+    DEVICE_CONTEXT * _deviceContext;
+
+    EvaluatorCache _evaluatorCache;
+
+    STENCIL_TABLE const * _vertexStencils;
+    LIMIT_STENCIL_TABLE const * _limitStencils;
+    PATCH_TABLE * _patchTable;
+
+    VERTEX_BUFFER * _patchCoords,
+                  * _vertices,
+                  * _values,
+                  * _du,
+                  * _dv;
+
+    Osd::BufferDescriptor _srcDesc,
+                          _refinedDesc,
+                          _dstDesc;
+};
+
+//------------------------------------------------------------------------------
+enum Backend {
+    kCPU = 0,
+    kOPENMP,
+    kTBB,
+    kCUDA,
+    kCL,
+    kGLXFB,
+    kGLCompute,
+    kNumBackends
+};
+
+static char const * g_backendNames[kNumBackends] = {
+    "cpu", "omp", "tbb", "cuda", "cl", "glxfb", "glcompute" };
+
+static bool
+isBackendCompiled(int backend) {
+    switch (backend) {
+        case kCPU: return true;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        case kOPENMP: return true;
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+        case kTBB: return true;
+#endif
+#ifdef OPENSUBDIV_HAS_CUDA
+        case kCUDA: return true;
+#endif
+#ifdef OPENSUBDIV_HAS_OPENCL
+        case kCL: return true;
+#endif
+#if defined(OSD_PERF_HAS_GLFW) && defined(OPENSUBDIV_HAS_GLSL_TRANSFORM_FEEDBACK)
+        case kGLXFB: return true;
+#endif
+#if defined(OSD_PERF_HAS_GLFW) && defined(OPENSUBDIV_HAS_GLSL_COMPUTE)
+        case kGLCompute: return true;
+#endif
+        default: return false;
+    }
+}
+
+template <class BACKEND_PERF>
+static void
+runBackend(BACKEND_PERF & perf, std::vector<int> const & widths, int repeats,
+           std::vector<Result> & results) {
+    for (int i = 0; i < (int)widths.size(); ++i) {
+        perf.Run(widths[i], repeats, results);
+    }
+}
+
+static void
+runBackend(int backend, Problem const & problem, std::vector<int> const & widths,
+           int repeats, std::vector<Result> & results) {
+
+    char const * name = g_backendNames[backend];
+
+    if (backend == kCPU) {
+        BackendPerf<Osd::CpuVertexBuffer, Far::StencilTable, Far::LimitStencilTable,
+            Osd::CpuPatchTable, Osd::CpuEvaluator> perf(name, problem);
+        runBackend(perf, widths, repeats, results);
+    }
+#ifdef OPENSUBDIV_HAS_OPENMP
+    if (backend == kOPENMP) {
+        BackendPerf<Osd::CpuVertexBuffer, Far::StencilTable, Far::LimitStencilTable,
+            Osd::CpuPatchTable, Osd::OmpEvaluator> perf(name, problem);
+        runBackend(perf, widths, repeats, results);
+    }
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    if (backend == kTBB) {
+        BackendPerf<Osd::CpuVertexBuffer, Far::StencilTable, Far::LimitStencilTable,
+            Osd::CpuPatchTable, Osd::TbbEvaluator> perf(name, problem);
+        runBackend(perf, widths, repeats, results);
+    }
+#endif
+#ifdef OPENSUBDIV_HAS_CUDA
+    if (backend == kCUDA) {
+        BackendPerf<Osd::CudaVertexBuffer, Osd::CudaStencilTable, Osd::CudaStencilTable,
+            Osd::CudaPatchTable, Osd::CudaEvaluator> perf(name, problem);
+        runBackend(perf, widths, repeats, results);
+    }
+#endif
+#ifdef OPENSUBDIV_HAS_OPENCL
+    if (backend == kCL) {
+        static CLContext clContext;
+        if (not clContext.GetContext() and not clContext.Initialize()) {
+            printf("Failed to initialize OpenCL, skipping backend %s\n", name);
+            return;
+        }
+        BackendPerf<Osd::CLVertexBuffer, Osd::CLStencilTable, Osd::CLStencilTable,
+            Osd::CLPatchTable, Osd::CLEvaluator, CLContext> perf(name, problem, &clContext);
+        runBackend(perf, widths, repeats, results);
+    }
+#endif
+#if defined(OSD_PERF_HAS_GLFW) && defined(OPENSUBDIV_HAS_GLSL_TRANSFORM_FEEDBACK)
+    if (backend == kGLXFB) {
+        BackendPerf<Osd::GLVertexBuffer, Osd::GLStencilTableTBO, Osd::GLStencilTableTBO,
+            Osd::GLPatchTable, Osd::GLXFBEvaluator> perf(name, problem);
+        runBackend(perf, widths, repeats, results);
+    }
+#endif
+#if defined(OSD_PERF_HAS_GLFW) && defined(OPENSUBDIV_HAS_GLSL_COMPUTE)
+    if (backend == kGLCompute) {
+        BackendPerf<Osd::GLVertexBuffer, Osd::GLStencilTableSSBO, Osd::GLStencilTableSSBO,
+            Osd::GLPatchTable, Osd::GLComputeEvaluator> perf(name, problem);
+        runBackend(perf, widths, repeats, results);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+static void
+printResult(Result const & r) {
+    printf("%-10s %-16s L%d %-14s %-3s w=%-3d %9d %10.6f %10.6f %10.6f %14.0f\n",
+        r.backend.c_str(), r.shape.c_str(), r.level, g_kernelNames[r.kernel],
+        r.derivatives ? "d1" : "-", r.width, r.numElements,
+        r.upload.GetMedian(), r.dispatch.GetMedian(), r.sync.GetMedian(),
+        r.GetThroughput());
+}
+
+static bool
+writeCSV(char const * filename, std::vector<Result> const & results) {
+
+    FILE * f = fopen(filename, "w");
+    if (not f) {
+        printf("Cannot write %s\n", filename);
+        return false;
+    }
+    fprintf(f, "backend,shape,level,kernel,derivatives,width,elements,"
+        "upload,kernel_time,sync,elements_per_sec\n");
+    for (int i = 0; i < (int)results.size(); ++i) {
+        Result const & r = results[i];
+        fprintf(f, "%s,%s,%d,%s,%d,%d,%d,%g,%g,%g,%g\n",
+            r.backend.c_str(), r.shape.c_str(), r.level, g_kernelNames[r.kernel],
+            r.derivatives ? 1 : 0, r.width, r.numElements,
+            r.upload.GetMedian(), r.dispatch.GetMedian(), r.sync.GetMedian(),
+            r.GetThroughput());
+    }
+    fclose(f);
+    return true;
+}
+
+static bool
+writeJSON(char const * filename, std::vector<Result> const & results, int repeats) {
+
+    FILE * f = fopen(filename, "w");
+    if (not f) {
+        printf("Cannot write %s\n", filename);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"benchmark\": \"osd_perf\",\n  \"repeats\": %d,\n", repeats);
+    fprintf(f, "  \"results\": [\n");
+    for (int i = 0; i < (int)results.size(); ++i) {
+        Result const & r = results[i];
+        fprintf(f, "    { \"backend\": \"%s\", \"shape\": \"%s\", \"level\": %d, "
+            "\"kernel\": \"%s\", \"derivatives\": %s, \"width\": %d, \"elements\": %d,\n",
+            r.backend.c_str(), r.shape.c_str(), r.level, g_kernelNames[r.kernel],
+            r.derivatives ? "true" : "false", r.width, r.numElements);
+        fprintf(f, "      \"upload\": %g, \"kernel_time\": %g, \"sync\": %g, "
+            "\"elements_per_sec\": %g }%s\n",
+            r.upload.GetMedian(), r.dispatch.GetMedian(), r.sync.GetMedian(),
+            r.GetThroughput(), (i+1 < (int)results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+static void
+usage(char const * program) {
+
+    printf("Usage: %s [options] [file.obj|file.shp ...]\n", program);
+    printf("  -backend <name>  backend measured, or all (default) :");
+    for (int i = 0; i < kNumBackends; ++i) {
+        if (isBackendCompiled(i)) printf(" %s", g_backendNames[i]);
+    }
+    printf("\n");
+    printf("  -l <level>       maximum isolation level (default 3)\n");
+    printf("  -s <samples>     limit samples per ptex face edge (default 8)\n");
+    printf("  -r <repeats>     number of runs of each evaluation (default 5)\n");
+    printf("  -w <widths>      comma separated primvar widths (default 3,4,8)\n");
+    printf("  -csv <file>      write the results in CSV format\n");
+    printf("  -json <file>     write the results in JSON format\n");
+}
+
+int main(int argc, char **argv)
+{
+    int maxlevel = 3,
+        samples = 8,
+        repeats = 5,
+        backend = -1;
+    char const * csvFile = 0,
+               * jsonFile = 0;
+    std::vector<int> widths;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strstr(argv[i], ".obj") or strstr(argv[i], ".shp")) {
+            g_shapes.push_back(ShapeDesc(argv[i], "", kCatmark));
+        }
+        else if (!strcmp(argv[i], "-backend") and i+1 < argc) {
+            char const * name = argv[++i];
+            if (strcmp(name, "all")) {
+                for (backend = kNumBackends-1; backend >= 0; --backend) {
+                    if (!strcmp(name, g_backendNames[backend])) break;
+                }
+                if (backend < 0 or not isBackendCompiled(backend)) {
+                    printf("Unknown backend %s\n", name);
+                    return 1;
+                }
+            }
+        }
+        else if (!strcmp(argv[i], "-l") and i+1 < argc) {
+            maxlevel = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-s") and i+1 < argc) {
+            samples = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-r") and i+1 < argc) {
+            repeats = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-w") and i+1 < argc) {
+            for (char const * w = argv[++i]; w; w = strchr(w, ',')) {
+                if (*w == ',') ++w;
+                if (atoi(w) > 0) widths.push_back(atoi(w));
+            }
+        }
+        else if (!strcmp(argv[i], "-csv") and i+1 < argc) {
+            csvFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-json") and i+1 < argc) {
+            jsonFile = argv[++i];
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (g_shapes.empty()) {
+        initShapes();
+    }
+    if (widths.empty()) {
+        widths.push_back(3);
+        widths.push_back(4);
+        widths.push_back(8);
+    }
+
+#if defined(OSD_PERF_HAS_GLFW)
+    // the GL backends evaluate in the context of a hidden window
+    GLFWwindow * window = 0;
+    if (glfwInit()) {
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+        if ((window = glfwCreateWindow(16, 16, "osd_perf", NULL, NULL))) {
+            glfwMakeContextCurrent(window);
+#if defined(OSD_USES_GLEW)
+            if (glewInit() != GLEW_OK) {
+                printf("Failed to initialize glew\n");
+                glfwDestroyWindow(window);
+                window = 0;
+            }
+#endif
+        }
+    }
+    if (not window) {
+        printf("Failed to create a GL context, skipping the GL backends\n");
+    }
+#endif
+
+    printf("%-10s %-16s %-2s %-14s %-3s %-5s %9s %10s %10s %10s %14s\n",
+        "backend", "shape", "L", "kernel", "d", "width", "elements",
+        "upload", "kernel", "sync", "elements/s");
+
+    std::vector<Result> results;
+
+    for (int i = 0; i < (int)g_shapes.size(); ++i) {
+        Shape const * shape = g_shapes[i].data.empty() ?
+            Shape::readFile(g_shapes[i].name.c_str(),
+                g_shapes[i].scheme, g_shapes[i].isLeftHanded) :
+            Shape::parseObj(g_shapes[i].data.c_str(),
+                g_shapes[i].scheme, g_shapes[i].isLeftHanded);
+        if (not shape) {
+            printf("Failed to read %s\n", g_shapes[i].name.c_str());
+            continue;
+        }
+        if (shape->scheme != kCatmark) {
+            printf("Skipping %s (evaluation of Catmark patches only)\n",
+                g_shapes[i].name.c_str());
+            delete shape;
+            continue;
+        }
+
+        for (int level = 1; level <= maxlevel; ++level) {
+            Problem problem;
+            problem.shape = g_shapes[i].name;
+            if (not createProblem(shape, level, samples, problem)) {
+                printf("Failed to refine %s\n", g_shapes[i].name.c_str());
+                break;
+            }
+
+            for (int b = 0; b < kNumBackends; ++b) {
+                if ((backend >= 0 and b != backend) or not isBackendCompiled(b)) {
+                    continue;
+                }
+#if defined(OSD_PERF_HAS_GLFW)
+                if ((b == kGLXFB or b == kGLCompute) and not window) {
+                    continue;
+                }
+#endif
+                size_t first = results.size();
+                runBackend(b, problem, widths, repeats, results);
+                for (size_t r = first; r < results.size(); ++r) {
+                    printResult(results[r]);
+                }
+            }
+        }
+        delete shape;
+    }
+
+#if defined(OSD_PERF_HAS_GLFW)
+    glfwTerminate();
+#endif
+
+    if (csvFile and not writeCSV(csvFile, results)) {
+        return 1;
+    }
+    if (jsonFile and not writeJSON(jsonFile, results, repeats)) {
+        return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,815 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+//
+// Replays the frame loop of an application animating a set of meshes, without
+// a window : the meshes are loaded and their tables built once, then for each
+// frame the control vertices of every mesh are animated on the host, uploaded,
+// refined and evaluated at limit samples (positions and first derivatives).
+//
+// The latencies of each stage are reported as distributions over the meshes
+// (set up) or the frames (frame loop), along with the high-water mark of the
+// memory of the process, for each of a series of thread counts.
+//
+// Meshes are animated from key-frames read with ObjAnim (as done in glViewer),
+// or procedurally when given as single shapes. Drawing is left to the viewers,
+// so that the benchmark runs without a GL context.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include <opensubdiv/far/patchMap.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <opensubdiv/osd/ompEvaluator.h>
+    #include <opensubdiv/osd/ompTaskScheduler.h>
+    #include <omp.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <opensubdiv/osd/tbbEvaluator.h>
+    #include <opensubdiv/osd/tbbTaskScheduler.h>
+#endif
+
+#include "../../regression/common/far_utils.h"
+// XXX: revisit the directory structure for examples/tests
+#include "../../examples/common/objAnim.h"
+#include "../../examples/common/stopwatch.h"
+
+#include "init_shapes.h"
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+// High-water mark of the resident memory of the process, in bytes
+static double
+getPeakMemory() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (double)counters.PeakWorkingSetSize;
+    }
+    return 0.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+#if defined(__APPLE__)
+    return (double)usage.ru_maxrss;             // bytes
+#else
+    return (double)usage.ru_maxrss * 1024.0;    // kilobytes
+#endif
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Latencies of a stage
+struct Distribution {
+
+    double GetPercentile(double p) const {
+        if (times.empty()) return 0.0;
+        std::vector<double> sorted(times);
+        std::sort(sorted.begin(), sorted.end());
+        int rank = (int)std::ceil(p * 0.01 * (double)sorted.size()) - 1;
+        return sorted[std::min(std::max(rank, 0), (int)sorted.size() - 1)];
+    }
+
+    double GetMean() const {
+        double sum = 0.0;
+        for (int i = 0; i < (int)times.size(); ++i) {
+            sum += times[i];
+        }
+        return times.empty() ? 0.0 : sum / (double)times.size();
+    }
+
+    double GetTotal() const {
+        return GetMean() * (double)times.size();
+    }
+
+    std::vector<double> times;
+};
+
+enum Stage {
+    // set up, for each mesh
+    kTopology = 0,      // TopologyRefiner and adaptive refinement
+    kStencilTable,      // refined vertices and local points
+    kPatchTable,        // patches and limit sample locations
+    // frame loop, for all the meshes of each frame
+    kAnimate,           // control vertices on the host
+    kUpload,            // control vertices to the vertex buffers
+    kRefine,            // EvalStencils of the refined vertices
+    kLimit,             // EvalPatches of the limit samples
+    kFrame,             // all of the above
+    kNumStages
+};
+
+static char const * g_stageNames[kNumStages] = {
+    "topology", "stencil_table", "patch_table",
+    "animate", "upload", "refine", "limit", "frame" };
+
+static bool
+isSetupStage(int stage) {
+    return stage < kAnimate;
+}
+
+//------------------------------------------------------------------------------
+// Control vertices of a mesh over time
+class MeshAnimation {
+public:
+
+    // key-frames read by ObjAnim
+    MeshAnimation(std::string const & name, ObjAnim const * anim) :
+        _name(name), _shape(anim->GetShape()), _anim(anim), _ownsShape(false) {
+        initialize();
+    }
+
+    // procedural animation of a single shape
+    MeshAnimation(std::string const & name, Shape const * shape) :
+        _name(name), _shape(shape), _anim(0), _ownsShape(true) {
+        initialize();
+    }
+
+    ~MeshAnimation() {
+        if (_ownsShape) delete _shape;
+        delete _anim;
+    }
+
+    std::string const & GetName() const { return _name; }
+
+    Shape const & GetShape() const { return *_shape; }
+
+    // Populates 'positions' (xyz) with the control vertices at 'time'
+    void Animate(float time, float * positions) const {
+
+        if (_anim) {
+            _anim->InterpolatePositions(time, positions, 3);
+            return;
+        }
+
+        // a wave traveling along the y axis, of an amplitude relative to the
+        // size of the shape
+        std::vector<float> const & rest = _shape->verts;
+        for (int i = 0; i < (int)rest.size(); i += 3) {
+            float offset = _amplitude *
+                sinf(6.2831853f * (time + (rest[i+1] - _min) * _frequency));
+            positions[i  ] = rest[i  ] + offset;
+            positions[i+1] = rest[i+1];
+            positions[i+2] = rest[i+2] + offset;
+        }
+    }
+
+private:
+
+    void initialize() {
+
+        std::vector<float> const & rest = _shape->verts;
+
+        float ymin = 0.0f, ymax = 0.0f;
+        for (int i = 0; i < (int)rest.size(); i += 3) {
+            ymin = i ? std::min(ymin, rest[i+1]) : rest[i+1];
+            ymax = i ? std::max(ymax, rest[i+1]) : rest[i+1];
+        }
+        _min = ymin;
+        _amplitude = 0.05f * (ymax - ymin);
+        _frequency = (ymax > ymin) ? 1.0f / (ymax - ymin) : 0.0f;
+    }
+
+    std::string _name;
+    Shape const * _shape;
+    ObjAnim const * _anim;
+    bool _ownsShape;
+
+    float _min,
+          _amplitude,
+          _frequency;
+};
+
+//------------------------------------------------------------------------------
+// Tables and buffers of a mesh, built with a given task scheduler
+struct MeshTables {
+
+    MeshTables() : numCoarseVertices(0), numRefinedVertices(0),
+        vertexStencils(0), patchTable(0), vertices(0), patchCoordsBuffer(0),
+        values(0), du(0), dv(0) { }
+
+    ~MeshTables() {
+        delete vertexStencils;
+        delete patchTable;
+        delete vertices;
+        delete patchCoordsBuffer;
+        delete values;
+        delete du;
+        delete dv;
+    }
+
+    bool Create(Shape const & shape, int level, int samples,
+                Far::TaskScheduler const * scheduler, Distribution * stages);
+
+    int numCoarseVertices,
+        numRefinedVertices,     // refined vertices and local points
+        numPatchCoords;
+
+    Far::StencilTable const * vertexStencils;
+    Osd::CpuPatchTable      * patchTable;
+
+    // the refined vertices follow the control vertices in the same buffer
+    Osd::CpuVertexBuffer * vertices,
+                         * patchCoordsBuffer,
+                         * values,
+                         * du,
+                         * dv;
+};
+
+bool
+MeshTables::Create(Shape const & shape, int level, int samples,
+                   Far::TaskScheduler const * scheduler, Distribution * stages) {
+
+    Stopwatch stopwatch;
+
+    stopwatch.Start();
+    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(shape,
+        Far::TopologyRefinerFactory<Shape>::Options(GetSdcType(shape), GetSdcOptions(shape)));
+    if (not refiner) {
+        return false;
+    }
+    Far::TopologyRefiner::AdaptiveOptions adaptiveOptions(level);
+    adaptiveOptions.taskScheduler = scheduler;
+    refiner->RefineAdaptive(adaptiveOptions);
+    stopwatch.Stop();
+    stages[kTopology].times.push_back(stopwatch.GetElapsed());
+
+    stopwatch.Start();
+    Far::StencilTableFactory::Options stencilOptions;
+    stencilOptions.taskScheduler = scheduler;
+    Far::StencilTable const * stencils =
+        Far::StencilTableFactory::Create(*refiner, stencilOptions);
+    stopwatch.Stop();
+    double stencilTime = stopwatch.GetElapsed();
+
+    stopwatch.Start();
+    Far::PatchTableFactory::Options patchOptions(level);
+    patchOptions.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    patchOptions.taskScheduler = scheduler;
+    Far::PatchTable const * farPatchTable =
+        Far::PatchTableFactory::Create(*refiner, patchOptions);
+
+    // a grid of samples at the center of 'samples' x 'samples' cells of each
+    // ptex face
+    std::vector<Osd::PatchCoord> patchCoords;
+    {
+        Far::PatchMap patchMap(*farPatchTable);
+        int numPtexFaces = Far::PtexIndices(*refiner).GetNumFaces();
+        for (int face = 0; face < numPtexFaces; ++face) {
+            for (int j = 0; j < samples; ++j) {
+                for (int i = 0; i < samples; ++i) {
+                    float s = ((float)i + 0.5f) / (float)samples,
+                          t = ((float)j + 0.5f) / (float)samples;
+                    if (Far::PatchTable::PatchHandle const * handle =
+                        patchMap.FindPatch(face, s, t)) {
+                        patchCoords.push_back(Osd::PatchCoord(*handle, s, t));
+                    }
+                }
+            }
+        }
+    }
+    patchTable = Osd::CpuPatchTable::Create(farPatchTable);
+    stopwatch.Stop();
+    stages[kPatchTable].times.push_back(stopwatch.GetElapsed());
+
+    stopwatch.Start();
+    if (Far::StencilTable const * withLocalPoints =
+        Far::StencilTableFactory::AppendLocalPointStencilTable(*refiner,
+            stencils, farPatchTable->GetLocalPointStencilTable())) {
+        delete stencils;
+        stencils = withLocalPoints;
+    }
+    stopwatch.Stop();
+    stages[kStencilTable].times.push_back(stencilTime + stopwatch.GetElapsed());
+
+    numCoarseVertices = refiner->GetLevel(0).GetNumVertices();
+    numRefinedVertices = stencils->GetNumStencils();
+    numPatchCoords = (int)patchCoords.size();
+    vertexStencils = stencils;
+
+    vertices = Osd::CpuVertexBuffer::Create(3, numCoarseVertices + numRefinedVertices);
+    values = Osd::CpuVertexBuffer::Create(3, numPatchCoords);
+    du = Osd::CpuVertexBuffer::Create(3, numPatchCoords);
+    dv = Osd::CpuVertexBuffer::Create(3, numPatchCoords);
+
+    // patch coordinates are stored in a vertex buffer of 5 floats, as done in
+    // glEvalLimit
+    patchCoordsBuffer = Osd::CpuVertexBuffer::Create(5, numPatchCoords);
+    if (numPatchCoords) {
+        patchCoordsBuffer->UpdateData((float const *)&patchCoords[0], 0, numPatchCoords);
+    }
+
+    delete farPatchTable;
+    delete refiner;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+enum Backend {
+    kCPU = 0,
+    kOPENMP,
+    kTBB,
+    kNumBackends
+};
+
+static char const * g_backendNames[kNumBackends] = { "cpu", "omp", "tbb" };
+
+static bool
+isBackendCompiled(int backend) {
+    switch (backend) {
+        case kCPU: return true;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        case kOPENMP: return true;
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+        case kTBB: return true;
+#endif
+        default: return false;
+    }
+}
+
+static int
+getMaxThreads(int backend) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+    if (backend == kOPENMP) return omp_get_num_procs();
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    if (backend == kTBB) return Osd::TbbTaskScheduler().GetNumThreads();
+#endif
+    (void)backend;
+    return 1;
+}
+
+// Results of the runs with a number of threads
+struct Run {
+    int threads;
+    Distribution stages[kNumStages];
+    double setupMemory,         // high-water marks after set up and frames
+           frameMemory;
+};
+
+//------------------------------------------------------------------------------
+// The frame loop of the meshes with a given evaluator
+template <class EVALUATOR>
+static void
+runFrames(std::vector<MeshAnimation *> const & meshes,
+          std::vector<MeshTables *> const & tables,
+          int frames, float fps, Run & run) {
+
+    int maxCoarseVertices = 0;
+    for (int i = 0; i < (int)tables.size(); ++i) {
+        maxCoarseVertices = std::max(maxCoarseVertices, tables[i]->numCoarseVertices);
+    }
+    std::vector<float> positions(maxCoarseVertices * 3);
+
+    Osd::BufferDescriptor srcDesc(0, 3, 3),
+                          dstDesc(0, 3, 3),
+                          duDesc(0, 3, 3),
+                          dvDesc(0, 3, 3);
+
+    Stopwatch stopwatch;
+
+    // the first frame is not timed (first touch of the buffers)
+    for (int frame = -1; frame < frames; ++frame) {
+
+        float time = (float)std::max(frame, 0) / fps;
+
+        double elapsed[kNumStages];
+        memset(elapsed, 0, sizeof(elapsed));
+
+        for (int i = 0; i < (int)meshes.size(); ++i) {
+            MeshTables & mesh = *tables[i];
+
+            stopwatch.Start();
+            meshes[i]->Animate(time, &positions[0]);
+            stopwatch.Stop();
+            elapsed[kAnimate] += stopwatch.GetElapsed();
+
+            stopwatch.Start();
+            mesh.vertices->UpdateData(&positions[0], 0, mesh.numCoarseVertices);
+            stopwatch.Stop();
+            elapsed[kUpload] += stopwatch.GetElapsed();
+
+            stopwatch.Start();
+            Osd::BufferDescriptor refinedDesc(mesh.numCoarseVertices * 3, 3, 3);
+            EVALUATOR::EvalStencils(mesh.vertices, srcDesc, mesh.vertices, refinedDesc,
+                mesh.vertexStencils);
+            EVALUATOR::Synchronize(0);
+            stopwatch.Stop();
+            elapsed[kRefine] += stopwatch.GetElapsed();
+
+            stopwatch.Start();
+            if (mesh.numPatchCoords) {
+                EVALUATOR::EvalPatches(mesh.vertices, srcDesc, mesh.values, dstDesc,
+                    mesh.du, duDesc, mesh.dv, dvDesc,
+                    mesh.numPatchCoords, mesh.patchCoordsBuffer, mesh.patchTable);
+                EVALUATOR::Synchronize(0);
+            }
+            stopwatch.Stop();
+            elapsed[kLimit] += stopwatch.GetElapsed();
+        }
+
+        if (frame < 0) continue;
+
+        for (int stage = kAnimate; stage < kFrame; ++stage) {
+            run.stages[stage].times.push_back(elapsed[stage]);
+            elapsed[kFrame] += elapsed[stage];
+        }
+        run.stages[kFrame].times.push_back(elapsed[kFrame]);
+    }
+}
+
+// Builds the tables of the meshes and replays the frame loop with 'threads'
+static bool
+runThreads(int backend, int threads,
+           std::vector<MeshAnimation *> const & meshes,
+           int level, int samples, int frames, float fps, Run & run) {
+
+    run.threads = threads;
+
+    Far::TaskScheduler const * scheduler = 0;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    Osd::OmpTaskScheduler ompScheduler(threads);
+    if (backend == kOPENMP) {
+        Osd::OmpEvaluator::SetNumThreads(threads);
+        scheduler = &ompScheduler;
+    }
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    Osd::TbbTaskScheduler tbbScheduler;
+    if (backend == kTBB) {
+        Osd::TbbEvaluator::SetNumThreads(threads);
+        scheduler = &tbbScheduler;
+    }
+#endif
+
+    std::vector<MeshTables *> tables(meshes.size(), (MeshTables *)0);
+
+    bool success = true;
+    for (int i = 0; i < (int)meshes.size() and success; ++i) {
+        tables[i] = new MeshTables;
+        if (not tables[i]->Create(meshes[i]->GetShape(), level, samples,
+                                  scheduler, run.stages)) {
+            printf("Failed to refine %s\n", meshes[i]->GetName().c_str());
+            success = false;
+        }
+    }
+    run.setupMemory = getPeakMemory();
+
+    if (success) {
+        if (backend == kCPU) {
+            runFrames<Osd::CpuEvaluator>(meshes, tables, frames, fps, run);
+        }
+#ifdef OPENSUBDIV_HAS_OPENMP
+        if (backend == kOPENMP) {
+            runFrames<Osd::OmpEvaluator>(meshes, tables, frames, fps, run);
+        }
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+        if (backend == kTBB) {
+            runFrames<Osd::TbbEvaluator>(meshes, tables, frames, fps, run);
+        }
+#endif
+    }
+    run.frameMemory = getPeakMemory();
+
+    for (int i = 0; i < (int)tables.size(); ++i) {
+        delete tables[i];
+    }
+    return success;
+}
+
+//------------------------------------------------------------------------------
+static void
+printRun(char const * backend, Run const & run) {
+
+    for (int stage = 0; stage < kNumStages; ++stage) {
+        Distribution const & d = run.stages[stage];
+        printf("%-7s %7d %-14s %6d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+            backend, run.threads, g_stageNames[stage], (int)d.times.size(),
+            d.GetPercentile(0.0) * 1000.0, d.GetPercentile(50.0) * 1000.0,
+            d.GetPercentile(90.0) * 1000.0, d.GetPercentile(99.0) * 1000.0,
+            d.GetPercentile(100.0) * 1000.0, d.GetMean() * 1000.0);
+    }
+}
+
+static double
+getSetupTime(Run const & run) {
+    double t = 0.0;
+    for (int stage = 0; stage < kNumStages; ++stage) {
+        if (isSetupStage(stage)) t += run.stages[stage].GetTotal();
+    }
+    return t;
+}
+
+static void
+printScaling(char const * backend, std::vector<Run> const & runs) {
+
+    printf("\n%-7s %7s %12s %8s %12s %8s %12s %12s\n",
+        "backend", "threads", "setup (ms)", "speedup", "frame p50", "speedup",
+        "setup (MB)", "frames (MB)");
+
+    for (int i = 0; i < (int)runs.size(); ++i) {
+        Run const & run = runs[i];
+        double setup = getSetupTime(run),
+               frame = run.stages[kFrame].GetPercentile(50.0),
+               setup0 = getSetupTime(runs[0]),
+               frame0 = runs[0].stages[kFrame].GetPercentile(50.0);
+        printf("%-7s %7d %12.3f %8.2f %12.3f %8.2f %12.1f %12.1f\n",
+            backend, run.threads, setup * 1000.0, setup > 0.0 ? setup0 / setup : 0.0,
+            frame * 1000.0, frame > 0.0 ? frame0 / frame : 0.0,
+            run.setupMemory / (1024.0 * 1024.0), run.frameMemory / (1024.0 * 1024.0));
+    }
+}
+
+static bool
+writeCSV(char const * filename, char const * backend, std::vector<Run> const & runs) {
+
+    FILE * f = fopen(filename, "w");
+    if (not f) {
+        printf("Cannot write %s\n", filename);
+        return false;
+    }
+    fprintf(f, "backend,threads,stage,count,min,p50,p90,p99,max,mean,"
+        "setup_peak_bytes,frame_peak_bytes\n");
+    for (int i = 0; i < (int)runs.size(); ++i) {
+        Run const & run = runs[i];
+        for (int stage = 0; stage < kNumStages; ++stage) {
+            Distribution const & d = run.stages[stage];
+            fprintf(f, "%s,%d,%s,%d,%g,%g,%g,%g,%g,%g,%.0f,%.0f\n",
+                backend, run.threads, g_stageNames[stage], (int)d.times.size(),
+                d.GetPercentile(0.0), d.GetPercentile(50.0), d.GetPercentile(90.0),
+                d.GetPercentile(99.0), d.GetPercentile(100.0), d.GetMean(),
+                run.setupMemory, run.frameMemory);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool
+writeJSON(char const * filename, char const * backend,
+          std::vector<MeshAnimation *> const & meshes, int level, int samples,
+          int frames, std::vector<Run> const & runs) {
+
+    FILE * f = fopen(filename, "w");
+    if (not f) {
+        printf("Cannot write %s\n", filename);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"benchmark\": \"osd_pipeline\",\n  \"backend\": \"%s\",\n"
+        "  \"level\": %d,\n  \"samples\": %d,\n  \"frames\": %d,\n  \"meshes\": [",
+        backend, level, samples, frames);
+    for (int i = 0; i < (int)meshes.size(); ++i) {
+        fprintf(f, "%s\"%s\"", i ? ", " : " ", meshes[i]->GetName().c_str());
+    }
+    fprintf(f, " ],\n  \"runs\": [\n");
+    for (int i = 0; i < (int)runs.size(); ++i) {
+        Run const & run = runs[i];
+        fprintf(f, "    { \"threads\": %d, \"setup_peak_bytes\": %.0f, "
+            "\"frame_peak_bytes\": %.0f,\n      \"stages\": [\n",
+            run.threads, run.setupMemory, run.frameMemory);
+        for (int stage = 0; stage < kNumStages; ++stage) {
+            Distribution const & d = run.stages[stage];
+            fprintf(f, "        { \"stage\": \"%s\", \"count\": %d, \"min\": %g, "
+                "\"p50\": %g, \"p90\": %g, \"p99\": %g, \"max\": %g, \"mean\": %g }%s\n",
+                g_stageNames[stage], (int)d.times.size(),
+                d.GetPercentile(0.0), d.GetPercentile(50.0), d.GetPercentile(90.0),
+                d.GetPercentile(99.0), d.GetPercentile(100.0), d.GetMean(),
+                (stage+1 < kNumStages) ? "," : "");
+        }
+        fprintf(f, "      ] }%s\n", (i+1 < (int)runs.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+static void
+usage(char const * program) {
+
+    printf("Usage: %s [options] [file.obj|file.shp ...]\n", program);
+    printf("  -backend <name>  backend evaluating the frames :");
+    for (int i = 0; i < kNumBackends; ++i) {
+        if (isBackendCompiled(i)) printf(" %s", g_backendNames[i]);
+    }
+    printf("\n");
+    printf("  -anim            the OBJ files are the key-frames of a single mesh\n");
+    printf("  -n <copies>      number of copies of each mesh (default 1)\n");
+    printf("  -l <level>       maximum isolation level (default 2)\n");
+    printf("  -s <samples>     limit samples per ptex face edge (default 4)\n");
+    printf("  -f <frames>      number of frames timed (default 100)\n");
+    printf("  -fps <rate>      frame rate of the animation (default 24)\n");
+    printf("  -t <threads>     comma separated thread counts (default powers of\n"
+           "                   2 up to the number of processors)\n");
+    printf("  -csv <file>      write the results in CSV format\n");
+    printf("  -json <file>     write the results in JSON format\n");
+}
+
+int main(int argc, char **argv)
+{
+    int level = 2,
+        samples = 4,
+        frames = 100,
+        copies = 1,
+        backend = -1;
+    float fps = 24.0f;
+    bool anim = false;
+    char const * csvFile = 0,
+               * jsonFile = 0;
+    std::vector<int> threadCounts;
+    std::vector<char const *> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strstr(argv[i], ".obj") or strstr(argv[i], ".shp")) {
+            files.push_back(argv[i]);
+        }
+        else if (!strcmp(argv[i], "-backend") and i+1 < argc) {
+            char const * name = argv[++i];
+            for (backend = kNumBackends-1; backend >= 0; --backend) {
+                if (!strcmp(name, g_backendNames[backend])) break;
+            }
+            if (backend < 0 or not isBackendCompiled(backend)) {
+                printf("Unknown backend %s\n", name);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-anim")) {
+            anim = true;
+        }
+        else if (!strcmp(argv[i], "-n") and i+1 < argc) {
+            copies = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-l") and i+1 < argc) {
+            level = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-s") and i+1 < argc) {
+            samples = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-f") and i+1 < argc) {
+            frames = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-fps") and i+1 < argc) {
+            fps = std::max(1.0f, (float)atof(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-t") and i+1 < argc) {
+            for (char const * t = argv[++i]; t; t = strchr(t, ',')) {
+                if (*t == ',') ++t;
+                if (atoi(t) > 0) threadCounts.push_back(atoi(t));
+            }
+        }
+        else if (!strcmp(argv[i], "-csv") and i+1 < argc) {
+            csvFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-json") and i+1 < argc) {
+            jsonFile = argv[++i];
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // the parallel backends are measured by default
+    if (backend < 0) {
+        backend = isBackendCompiled(kOPENMP) ? kOPENMP :
+            (isBackendCompiled(kTBB) ? kTBB : kCPU);
+    }
+    if (backend == kCPU) {
+        threadCounts.assign(1, 1);
+    } else if (threadCounts.empty()) {
+        int maxThreads = getMaxThreads(backend);
+        for (int t = 1; t < maxThreads; t *= 2) {
+            threadCounts.push_back(t);
+        }
+        threadCounts.push_back(maxThreads);
+    }
+
+    // load the meshes
+    if (not anim) {
+        for (int i = 0; i < (int)files.size(); ++i) {
+            g_shapes.push_back(ShapeDesc(files[i], "", kCatmark));
+        }
+        if (g_shapes.empty()) {
+            initShapes();
+        }
+    }
+
+    std::vector<MeshAnimation *> meshes;
+    for (int copy = 0; copy < copies; ++copy) {
+        if (anim) {
+            if (ObjAnim const * objAnim = ObjAnim::Create(files)) {
+                meshes.push_back(new MeshAnimation(files[0], objAnim));
+            }
+            continue;
+        }
+        for (int i = 0; i < (int)g_shapes.size(); ++i) {
+            Shape const * shape = g_shapes[i].data.empty() ?
+                Shape::readFile(g_shapes[i].name.c_str(),
+                    g_shapes[i].scheme, g_shapes[i].isLeftHanded) :
+                Shape::parseObj(g_shapes[i].data.c_str(),
+                    g_shapes[i].scheme, g_shapes[i].isLeftHanded);
+            if (not shape) {
+                printf("Failed to read %s\n", g_shapes[i].name.c_str());
+                continue;
+            }
+            if (shape->scheme != kCatmark) {
+                printf("Skipping %s (evaluation of Catmark patches only)\n",
+                    g_shapes[i].name.c_str());
+                delete shape;
+                continue;
+            }
+            meshes.push_back(new MeshAnimation(g_shapes[i].name, shape));
+        }
+    }
+    if (meshes.empty()) {
+        printf("No mesh to evaluate\n");
+        return 1;
+    }
+
+    char const * backendName = g_backendNames[backend];
+
+    printf("%d meshes, level %d, %d samples per face, %d frames, "
+        "%.1f MB after loading\n", (int)meshes.size(), level, samples * samples,
+        frames, getPeakMemory() / (1024.0 * 1024.0));
+    printf("%-7s %7s %-14s %6s %10s %10s %10s %10s %10s %10s\n",
+        "backend", "threads", "stage", "count",
+        "min (ms)", "p50", "p90", "p99", "max", "mean");
+
+    std::vector<Run> runs(threadCounts.size());
+
+    bool success = true;
+    for (int i = 0; i < (int)threadCounts.size() and success; ++i) {
+        success = runThreads(backend, threadCounts[i], meshes,
+                             level, samples, frames, fps, runs[i]);
+        if (success) {
+            printRun(backendName, runs[i]);
+        }
+    }
+
+    if (success) {
+        printScaling(backendName, runs);
+    }
+
+    if (success and csvFile and not writeCSV(csvFile, backendName, runs)) {
+        success = false;
+    }
+    if (success and jsonFile and not writeJSON(jsonFile, backendName,
+                                               meshes, level, samples, frames, runs)) {
+        success = false;
+    }
+
+    for (int i = 0; i < (int)meshes.size(); ++i) {
+        delete meshes[i];
+    }
+    return success ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
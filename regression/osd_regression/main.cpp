@@ -54,6 +54,7 @@ GLFWwindow* g_window=0;
 #include "../common/cmp_utils.h"
 #include "../common/hbr_utils.h"
 #include "../common/far_utils.h"
+#include "../common/case_utils.h"
 
 //
 // Regression testing matching Osd to Hbr
@@ -84,6 +85,8 @@ static const char* g_BackendNames[kBackendCount] = {
 
 static int g_Backend = -1;
 
+static RegressionCases g_cases;
+
 //------------------------------------------------------------------------------
 // Vertex class implementation
 struct xyzVV {
@@ -328,6 +331,10 @@ checkMesh( char const * msg, std::string const & shape, int levels, Scheme schem
 
     int result =0;
 
+    if (not g_cases.Begin()) {
+        return result;
+    }
+
     printf("- %s (scheme=%d)\n", msg, scheme);
 
     xyzmesh * refmesh = 
@@ -351,6 +358,8 @@ checkMesh( char const * msg, std::string const & shape, int levels, Scheme schem
     delete refmesh;
     delete refiner;
 
+    g_cases.End(std::string(msg) + " (" + g_BackendNames[backend] + ")", result);
+
     return result;
 }
 
@@ -574,8 +583,10 @@ usage(char ** argv) {
     printf("        Compute backend applied (");
     for (int i=0; i < kBackendCount; ++i)
         printf("%s ", g_BackendNames[i]);
-    printf(").\n");
-    
+    printf(").\n\n");
+
+    RegressionCases::PrintUsage();
+
     printf("        -help / -h\n");
     printf("        Displays usage information.");
       
@@ -586,7 +597,9 @@ static void
 parseArgs(int argc, char ** argv) {
 
     for (int argi=1; argi<argc; ++argi) {
-        if (not strcmp(argv[argi],"-compute")) {
+        if (g_cases.ParseArg(argc, argv, argi)) {
+            continue;
+        } else if (not strcmp(argv[argi],"-compute")) {
         
             const char * backend = NULL;
             
@@ -668,8 +681,12 @@ main(int argc, char ** argv) {
 
     glfwTerminate();
 
+    g_cases.PrintReport();
+
     if (total==0)
       printf("All tests passed.\n");
     else
       printf("Total failures : %d\n", total);
+
+    return (total==0) ? 0 : 1;
 }
@@ -0,0 +1,1181 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/osd/mesh.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#include <opensubdiv/osd/cpuVaryingStencilTable.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#include <opensubdiv/osd/dispatchEvaluator.h>
+#include <opensubdiv/osd/splitEvaluator.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <opensubdiv/osd/ompEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <opensubdiv/osd/tbbEvaluator.h>
+#endif
+
+#include "../../regression/common/far_utils.h"
+#include "../../regression/common/case_utils.h"
+
+#include "../far_regression/init_shapes.h"
+
+//
+// Unit checks of the CPU backends of Osd, run on each regression shape.
+//
+// Notes:
+// - like far_unit, these checks compare Osd to itself or to Far : meshes
+//   refined through primvar buffers, wrapped or double-buffered vertices,
+//   evaluators of planar or batched buffers, etc. No device is required
+//   (the GPU side of SplitEvaluator is run by CpuEvaluator).
+//
+// - the setup of a shape is shared by its checks (see ShapeFixture).
+//
+// - precision is currently held at 1e-5, relative to values larger than 1
+//   (the kernels may sum the weights in different orders)
+//
+#define PRECISION 1e-5
+
+static RegressionCases g_cases;
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+typedef Far::TopologyRefiner               FarTopologyRefiner;
+typedef Far::TopologyRefinerFactory<Shape> FarTopologyRefinerFactory;
+
+// Osd::Mesh binds its buffers and patches for drawing : these CPU buffers and
+// patch tables bind the CPU memory, so that meshes are refined headless.
+class CpuMeshVertexBuffer : public Osd::CpuVertexBuffer {
+public:
+    static CpuMeshVertexBuffer * Create(int numElements, int numVertices,
+                                        void * =0) {
+        return new CpuMeshVertexBuffer(numElements, numVertices);
+    }
+
+    static CpuMeshVertexBuffer * Wrap(float * buffer,
+                                      int numElements, int numVertices) {
+        return new CpuMeshVertexBuffer(numElements, numVertices, buffer);
+    }
+
+    float * BindVBO(void * =0) { return BindCpuBuffer(); }
+
+private:
+    CpuMeshVertexBuffer(int numElements, int numVertices) :
+        Osd::CpuVertexBuffer(numElements, numVertices) { }
+
+    CpuMeshVertexBuffer(int numElements, int numVertices, float * buffer) :
+        Osd::CpuVertexBuffer(numElements, numVertices, buffer) { }
+};
+
+class CpuMeshPatchTable : public Osd::CpuPatchTable {
+public:
+    typedef float * VertexBufferBinding;
+
+    static CpuMeshPatchTable * Create(Far::PatchTable const * patchTable,
+                                      void * =0) {
+        return new CpuMeshPatchTable(patchTable);
+    }
+
+private:
+    explicit CpuMeshPatchTable(Far::PatchTable const * patchTable) :
+        Osd::CpuPatchTable(patchTable) { }
+};
+
+typedef Osd::Mesh<CpuMeshVertexBuffer,
+                  Far::StencilTable,
+                  Osd::CpuEvaluator,
+                  CpuMeshPatchTable> CpuMesh;
+
+//------------------------------------------------------------------------------
+// Setup shared by the checks of a shape : the shape is parsed once, and each
+// refinement is computed on first request and then reused by every check
+// that only reads it. Meshes own their refiners : checks create them from
+// CreateRefiner().
+class ShapeFixture {
+public:
+    explicit ShapeFixture(ShapeDesc const & desc) :
+        _desc(desc),
+        _shape(Shape::parseObj(desc.data.c_str(), desc.scheme)) {
+
+        // a second pose of the control vertices, to update meshes with
+        _movedVerts = _shape->verts;
+        for (int i=0; i<(int)_movedVerts.size(); ++i) {
+            _movedVerts[i] += 0.1f * (float)((i*7) % 5 - 2);
+        }
+    }
+
+    ~ShapeFixture() {
+        for (StencilTableMap::iterator it=_stencilTables.begin();
+                it!=_stencilTables.end(); ++it) {
+            delete it->second;
+        }
+        for (RefinerMap::iterator it=_refiners.begin(); it!=_refiners.end(); ++it) {
+            delete it->second;
+        }
+        delete _shape;
+    }
+
+    ShapeDesc const & GetDesc() const { return _desc; }
+
+    Shape const & GetShape() const { return *_shape; }
+
+    int GetNumControlVertices() const { return _shape->GetNumVertices(); }
+
+    // Control vertices of the shape (3 floats per vertex), and their second
+    // pose
+    float const * GetVertices() const { return &_shape->verts[0]; }
+
+    float const * GetMovedVertices() const { return &_movedVerts[0]; }
+
+    // Returns a new unrefined refiner of the shape, owned by the caller
+    FarTopologyRefiner * CreateRefiner() const {
+        return FarTopologyRefinerFactory::Create(*_shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(*_shape), GetSdcOptions(*_shape)));
+    }
+
+    FarTopologyRefiner const & GetUniformRefiner(int maxlevel) {
+        return getRefiner(false, maxlevel);
+    }
+
+    FarTopologyRefiner const & GetAdaptiveRefiner(int maxlevel) {
+        return getRefiner(true, maxlevel);
+    }
+
+    // Adaptive refinement of Catmark shapes, uniform refinement of the others
+    FarTopologyRefiner const & GetDefaultRefiner(int maxlevel) {
+        return getRefiner(_desc.scheme==kCatmark, maxlevel);
+    }
+
+    // Mesh bits matching GetDefaultRefiner()
+    Osd::MeshBitset GetDefaultMeshBits() const {
+        Osd::MeshBitset bits;
+        bits.set(Osd::MeshAdaptive, _desc.scheme==kCatmark);
+        bits.set(Osd::MeshEndCapGregoryBasis, _desc.scheme==kCatmark);
+        return bits;
+    }
+
+    // Stencils of a shared refiner, built with the default options
+    Far::StencilTable const & GetStencilTable(FarTopologyRefiner const & refiner) {
+        Far::StencilTable const *& table = _stencilTables[&refiner];
+        if (not table) {
+            table = Far::StencilTableFactory::Create(refiner);
+        }
+        return *table;
+    }
+
+private:
+    FarTopologyRefiner const & getRefiner(bool adaptive, int maxlevel) {
+        FarTopologyRefiner *& refiner = _refiners[std::make_pair(adaptive, maxlevel)];
+        if (not refiner) {
+            refiner = CreateRefiner();
+            if (adaptive) {
+                refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxlevel));
+            } else {
+                refiner->RefineUniform(FarTopologyRefiner::UniformOptions(maxlevel));
+            }
+        }
+        return *refiner;
+    }
+
+    // Fixtures are not copied (they own their shapes and refiners)
+    ShapeFixture(ShapeFixture const &);
+    ShapeFixture & operator=(ShapeFixture const &);
+
+    typedef std::map<std::pair<bool, int>, FarTopologyRefiner *> RefinerMap;
+    typedef std::map<FarTopologyRefiner const *,
+                     Far::StencilTable const *> StencilTableMap;
+
+    ShapeDesc const & _desc;
+
+    Shape * _shape;
+
+    std::vector<float> _movedVerts;
+
+    RefinerMap      _refiners;
+    StencilTableMap _stencilTables;
+};
+
+//------------------------------------------------------------------------------
+// Returns the number of values of 'b' differing from those of 'a'
+static int
+countDifferences(float const * a, float const * b, int n,
+                 float precision=(float)PRECISION) {
+
+    int count=0;
+    for (int i=0; i<n; ++i) {
+        float scale = std::max(1.0f, std::abs(a[i]));
+        if (not (std::abs(a[i]-b[i]) <= precision*scale)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Returns a new buffer of 3 floats per vertex holding 'data' (if any)
+static Osd::CpuVertexBuffer *
+createBuffer(int numVertices, float const * data=0) {
+
+    Osd::CpuVertexBuffer * buffer = Osd::CpuVertexBuffer::Create(3, numVertices);
+    if (data) {
+        buffer->UpdateData(data, 0, numVertices);
+    }
+    return buffer;
+}
+
+// Returns the limit stencils of 2 locations of each ptex face
+static Far::LimitStencilTable const *
+createLimitStencils(FarTopologyRefiner const & refiner) {
+
+    static float const s[2] = { 0.25f, 0.8f },
+                       t[2] = { 0.6f, 0.1f };
+
+    int numFaces = Far::PtexIndices(refiner).GetNumFaces();
+
+    Far::LimitStencilTableFactory::LocationArrayVec locations(numFaces);
+    for (int face=0; face<numFaces; ++face) {
+        locations[face].ptexIdx = face;
+        locations[face].numLocations = 2;
+        locations[face].s = s;
+        locations[face].t = t;
+    }
+    return Far::LimitStencilTableFactory::Create(refiner, locations);
+}
+
+// The vertices of a refined CpuMesh
+static float const *
+getMeshVertices(CpuMesh & mesh) {
+    return mesh.GetVertexBuffer()->BindCpuBuffer();
+}
+
+//------------------------------------------------------------------------------
+// Primvar buffers must be refined as the vertex buffer (vertex stencils) or
+// the varying buffer (varying stencils), whether all their vertices are
+// refined or only those depending on updated control vertices
+static int
+checkPrimvarBuffers(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    int ncvs = fixture.GetNumControlVertices(),
+        count = 0;
+
+    for (int dirty=0; dirty<2; ++dirty) {
+
+        Osd::MeshBitset bits = fixture.GetDefaultMeshBits();
+        bits.set(Osd::MeshDirtyUpdate, dirty!=0);
+
+        CpuMesh mesh(fixture.CreateRefiner(), 3, 3, maxlevel, bits);
+
+        int position = mesh.AddPrimvarBuffer("position", 3),
+            color = mesh.AddPrimvarBuffer("color", 3, true);
+
+        if (position<0 or color<0 or
+            mesh.AddPrimvarBuffer("position", 3)!=-1 or
+            mesh.FindPrimvarBuffer("color")!=color or
+            mesh.GetNumPrimvarBuffers()!=2) {
+            ++count;
+            continue;
+        }
+
+        // all the control vertices, then the first one only
+        for (int pose=0; pose<2; ++pose) {
+            float const * verts = pose ? fixture.GetMovedVertices() :
+                                         fixture.GetVertices();
+            int nverts = pose ? 1 : ncvs;
+
+            mesh.UpdateVertexBuffer(verts, 0, nverts);
+            mesh.UpdateVaryingBuffer(verts, 0, nverts);
+            mesh.UpdatePrimvarBuffer(position, verts, 0, nverts);
+            mesh.UpdatePrimvarBuffer(color, verts, 0, nverts);
+            mesh.Refine();
+
+            int n = mesh.GetNumVertices() * 3;
+            count += countDifferences(
+                mesh.GetVertexBuffer()->BindCpuBuffer(),
+                mesh.GetPrimvarBuffer(position)->BindCpuBuffer(), n);
+            count += countDifferences(
+                mesh.GetVaryingBuffer()->BindCpuBuffer(),
+                mesh.GetPrimvarBuffer(color)->BindCpuBuffer(), n);
+        }
+    }
+
+    // varying primvars require the varying stencils of the mesh
+    CpuMesh vertexOnly(fixture.CreateRefiner(), 3, 0, maxlevel,
+                       fixture.GetDefaultMeshBits());
+    if (vertexOnly.AddPrimvarBuffer("color", 3, true)!=-1) {
+        ++count;
+    }
+
+    if (count) {
+        printf("// primvar buffers fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Vertices refined into client memory wrapped by the vertex buffer must be
+// those refined into the memory of the buffer
+static int
+checkWrappedBuffers(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    int ncvs = fixture.GetNumControlVertices(),
+        count = 0;
+
+    CpuMesh owning(fixture.CreateRefiner(), 3, 0, maxlevel,
+                   fixture.GetDefaultMeshBits()),
+            wrapping(fixture.CreateRefiner(), 3, 0, maxlevel,
+                     fixture.GetDefaultMeshBits());
+
+    int n = owning.GetNumVertices() * 3;
+
+    std::vector<float> expected(n), moved(n);
+    owning.UpdateVertexBuffer(fixture.GetVertices(), 0, ncvs);
+    owning.Refine();
+    std::copy(getMeshVertices(owning), getMeshVertices(owning) + n, expected.begin());
+    owning.UpdateVertexBuffer(fixture.GetMovedVertices(), 0, ncvs);
+    owning.Refine();
+    std::copy(getMeshVertices(owning), getMeshVertices(owning) + n, moved.begin());
+
+    // the control vertices are written in place
+    std::vector<float> client(n, 0.0f), nextClient(n, 0.0f);
+    std::copy(fixture.GetVertices(), fixture.GetVertices() + ncvs*3, client.begin());
+    std::copy(fixture.GetMovedVertices(), fixture.GetMovedVertices() + ncvs*3,
+        nextClient.begin());
+
+    CpuMeshVertexBuffer * buffer = CpuMeshVertexBuffer::Wrap(&client[0], 3,
+                                                             wrapping.GetNumVertices());
+    if (not buffer->IsWrapping() or not wrapping.SetVertexBuffer(buffer)) {
+        printf("// wrapped buffers fail : %s (buffer not set)\n", desc.name.c_str());
+        return 1;
+    }
+    wrapping.UpdateVertexBuffer(&client[0], 0, ncvs);
+    wrapping.Refine();
+    count += countDifferences(&expected[0], &client[0], n);
+
+    // then into the next client buffer
+    if (not buffer->SetCpuBuffer(&nextClient[0])) {
+        ++count;
+    } else {
+        wrapping.MarkUpdated();
+        wrapping.Refine();
+        count += countDifferences(&moved[0], &nextClient[0], n);
+        count += countDifferences(&expected[0], &client[0], n);
+    }
+
+    // buffers owning their memory don't wrap client memory
+    if (owning.GetVertexBuffer()->IsWrapping() or
+        owning.GetVertexBuffer()->SetCpuBuffer(&client[0])) {
+        ++count;
+    }
+
+    if (count) {
+        printf("// wrapped buffers fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// The compact encoding of the patch indices must decode to the indices of the
+// patch table
+static int
+checkCompactPatchIndices(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetDefaultRefiner(maxlevel);
+
+    Far::PatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    Far::PatchTable const * farPatchTable =
+        Far::PatchTableFactory::Create(refiner, options);
+
+    Osd::CpuPatchTable patchTable(farPatchTable),
+                       compactTable(farPatchTable, true);
+
+    int count=0;
+    if (patchTable.GetNumCompactPatchArrays()!=0) {
+        ++count;
+    }
+
+    // the ranges of patches follow one another in the order of the patches
+    int numIndices = (int)farPatchTable->GetPatchControlVerticesTable().size(),
+        numPatches = 0;
+    int const * indices = compactTable.GetPatchIndexBuffer();
+
+    std::vector<int> decoded;
+    decoded.reserve(numIndices);
+    Osd::CompactPatchArray const * ranges = compactTable.GetCompactPatchArrayBuffer();
+    for (int i=0; i<(int)compactTable.GetNumCompactPatchArrays(); ++i) {
+        Osd::CompactPatchArray const & range = ranges[i];
+
+        int ncvs = range.GetDescriptor().GetNumControlVertices(),
+            n = range.GetNumPatches() * ncvs;
+        if (range.GetPrimitiveIdBase()!=numPatches) {
+            ++count;
+        }
+        if (range.GetIndexSize()==2) {
+            if (range.GetIndexBase() + n > (int)compactTable.GetCompactPatchIndexSize()) {
+                ++count;
+                break;
+            }
+            unsigned short const * compact =
+                compactTable.GetCompactPatchIndexBuffer() + range.GetIndexBase();
+            for (int k=0; k<n; ++k) {
+                decoded.push_back(range.GetVertexBase() + compact[k]);
+            }
+        } else {
+            if (range.GetIndexSize()!=4 or range.GetVertexBase()!=0 or
+                range.GetIndexBase() + n > (int)compactTable.GetWidePatchIndexSize()) {
+                ++count;
+                break;
+            }
+            int const * wide =
+                compactTable.GetWidePatchIndexBuffer() + range.GetIndexBase();
+            decoded.insert(decoded.end(), wide, wide + n);
+        }
+        numPatches += range.GetNumPatches();
+    }
+
+    if (numPatches!=farPatchTable->GetNumPatchesTotal() or
+        (int)decoded.size()!=numIndices or
+        (numIndices>0 and not std::equal(decoded.begin(), decoded.end(), indices))) {
+        ++count;
+    }
+
+    if (count) {
+        printf("// compact patch indices fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    delete farPatchTable;
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// The implicit varying stencils must refine the vertices of the varying
+// stencil table, with or without the intermediate levels
+static int
+checkVaryingStencils(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    int ncvs = fixture.GetNumControlVertices(),
+        count = 0;
+
+    Osd::CpuVertexBuffer * src = createBuffer(ncvs, fixture.GetVertices());
+    Osd::BufferDescriptor srcDesc(0, 3, 3);
+
+    for (int adaptive=0; adaptive<2; ++adaptive) {
+        if (adaptive and desc.scheme!=kCatmark) continue;
+
+        FarTopologyRefiner const & refiner = adaptive ?
+            fixture.GetAdaptiveRefiner(maxlevel) : fixture.GetUniformRefiner(maxlevel);
+
+        for (int intermediate=0; intermediate<2; ++intermediate) {
+
+            Far::StencilTableFactory::Options options;
+            options.interpolationMode =
+                Far::StencilTableFactory::INTERPOLATE_VARYING;
+            options.generateIntermediateLevels = (intermediate!=0);
+            Far::StencilTable const * expected =
+                Far::StencilTableFactory::Create(refiner, options);
+
+            Osd::CpuVaryingStencilTable implicit(&refiner, intermediate!=0);
+
+            int nstencils = expected->GetNumStencils();
+            if (implicit.GetNumStencils()!=nstencils or
+                implicit.HasIntermediateLevels()!=(intermediate!=0)) {
+                ++count;
+            } else if (nstencils>0) {
+                Osd::CpuVertexBuffer * a = createBuffer(nstencils),
+                                     * b = createBuffer(nstencils);
+                Osd::BufferDescriptor dstDesc(0, 3, 3);
+
+                Osd::CpuEvaluator::EvalStencils(src, srcDesc, a, dstDesc, expected);
+                Osd::CpuEvaluator::EvalStencils(src, srcDesc, b, dstDesc, &implicit);
+
+                count += countDifferences(a->BindCpuBuffer(), b->BindCpuBuffer(),
+                                          nstencils*3);
+                delete a;
+                delete b;
+            }
+            delete expected;
+        }
+    }
+    delete src;
+
+    if (count) {
+        printf("// varying stencils fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Stencils evaluated from and into planar buffers must match the interleaved
+// evaluation
+template <class EVALUATOR>
+static int
+evalPlanarStencils(Far::StencilTable const & table,
+                   float const * verts, int ncvs, float const * expected) {
+
+    int nstencils = table.GetNumStencils();
+
+    // X0..Xn-1, Y0..Yn-1, Z0..Zn-1
+    std::vector<float> planarVerts(ncvs*3);
+    for (int i=0; i<ncvs; ++i) {
+        for (int k=0; k<3; ++k) {
+            planarVerts[k*ncvs + i] = verts[i*3 + k];
+        }
+    }
+    Osd::CpuVertexBuffer * src = createBuffer(ncvs, &planarVerts[0]),
+                         * dst = createBuffer(nstencils);
+
+    Osd::BufferDescriptor srcDesc(0, 3, 1, Osd::BufferDescriptor::TYPE_FLOAT, ncvs),
+                          dstDesc(0, 3, 1, Osd::BufferDescriptor::TYPE_FLOAT, nstencils);
+
+    int count=0;
+    if (not EVALUATOR::EvalStencils(src, srcDesc, dst, dstDesc, &table)) {
+        ++count;
+    } else {
+        float const * planar = dst->BindCpuBuffer();
+        std::vector<float> interleaved(nstencils*3);
+        for (int i=0; i<nstencils; ++i) {
+            for (int k=0; k<3; ++k) {
+                interleaved[i*3 + k] = planar[k*nstencils + i];
+            }
+        }
+        count += countDifferences(expected, &interleaved[0], nstencils*3);
+    }
+    delete src;
+    delete dst;
+    return count;
+}
+
+static int
+checkPlanarBuffers(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Far::StencilTable const & table =
+        fixture.GetStencilTable(fixture.GetUniformRefiner(maxlevel));
+
+    int ncvs = fixture.GetNumControlVertices(),
+        nstencils = table.GetNumStencils();
+    if (nstencils==0) return 0;
+
+    Osd::CpuVertexBuffer * src = createBuffer(ncvs, fixture.GetVertices()),
+                         * dst = createBuffer(nstencils);
+    Osd::BufferDescriptor desc3(0, 3, 3);
+    Osd::CpuEvaluator::EvalStencils(src, desc3, dst, desc3, &table);
+
+    float const * verts = fixture.GetVertices(),
+                * expected = dst->BindCpuBuffer();
+
+    int count=0;
+    count += evalPlanarStencils<Osd::CpuEvaluator>(table, verts, ncvs, expected);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    count += evalPlanarStencils<Osd::OmpEvaluator>(table, verts, ncvs, expected);
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    count += evalPlanarStencils<Osd::TbbEvaluator>(table, verts, ncvs, expected);
+#endif
+    delete src;
+    delete dst;
+
+    if (count) {
+        printf("// planar buffers fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Worker running the task launched once the mesh waits for it, so that the
+// frames drawn before Synchronize() are observed deterministically
+class DeferredWorker : public Osd::MeshWorker {
+public:
+    DeferredWorker() : _task(0), _data(0), _numLaunches(0) { }
+
+    virtual void Launch(Task task, void * data) {
+        _task = task;
+        _data = data;
+        ++_numLaunches;
+    }
+
+    virtual void Wait() {
+        if (_task) {
+            Task task = _task;
+            _task = 0;
+            task(_data);
+        }
+    }
+
+    int GetNumLaunches() const { return _numLaunches; }
+
+private:
+    Task   _task;
+    void * _data;
+    int    _numLaunches;
+};
+
+// Meshes refined asynchronously must draw the vertices of the previous frame
+// until synchronized, and then those refined by Refine()
+static int
+checkAsyncRefine(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    int ncvs = fixture.GetNumControlVertices(),
+        count = 0;
+
+    Osd::MeshBitset bits = fixture.GetDefaultMeshBits();
+
+    CpuMesh reference(fixture.CreateRefiner(), 3, 0, maxlevel, bits);
+
+    bits.set(Osd::MeshAsyncRefine);
+    CpuMesh mesh(fixture.CreateRefiner(), 3, 0, maxlevel, bits);
+
+    DeferredWorker worker;
+    mesh.SetWorker(&worker);
+
+    int n = reference.GetNumVertices() * 3;
+    std::vector<float> expected(n);
+    reference.UpdateVertexBuffer(fixture.GetVertices(), 0, ncvs);
+    reference.Refine();
+    std::copy(getMeshVertices(reference), getMeshVertices(reference) + n,
+        expected.begin());
+
+    mesh.UpdateVertexBuffer(fixture.GetVertices(), 0, ncvs);
+    int first = mesh.RefineAsync();
+    mesh.Synchronize();
+    if (mesh.GetRefinedFrame()!=first) {
+        ++count;
+    }
+    count += countDifferences(&expected[0], getMeshVertices(mesh), n);
+
+    // the next frame is refined by the worker when synchronized
+    mesh.UpdateVertexBuffer(fixture.GetMovedVertices(), 0, ncvs);
+    int next = mesh.RefineAsync();
+    if (next!=first+1 or mesh.GetRefinedFrame()!=first) {
+        ++count;
+    }
+    count += countDifferences(&expected[0], getMeshVertices(mesh), n);
+
+    mesh.Synchronize();
+    reference.UpdateVertexBuffer(fixture.GetMovedVertices(), 0, ncvs);
+    reference.Refine();
+    if (mesh.GetRefinedFrame()!=next or worker.GetNumLaunches()!=2) {
+        ++count;
+    }
+    count += countDifferences(getMeshVertices(reference), getMeshVertices(mesh), n);
+
+    // double-buffered vertices are not replaced
+    CpuMeshVertexBuffer * buffer = CpuMeshVertexBuffer::Create(3, mesh.GetNumVertices());
+    if (mesh.SetVertexBuffer(buffer)) {
+        ++count;
+    } else {
+        delete buffer;
+    }
+
+    if (count) {
+        printf("// async refinement fails : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// The stencils dispatched to the serial or the threaded backends must match
+// the serial evaluation
+static int
+checkDispatchEvaluator(ShapeFixture & fixture, int maxlevel) {
+
+    typedef Osd::DispatchEvaluator Dispatch;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    FarTopologyRefiner const & refiner = fixture.GetDefaultRefiner(maxlevel);
+
+    Far::StencilTable const & table =
+        fixture.GetStencilTable(fixture.GetUniformRefiner(maxlevel));
+    Far::LimitStencilTable const * limitTable = createLimitStencils(refiner);
+
+    int ncvs = fixture.GetNumControlVertices(),
+        nstencils = table.GetNumStencils(),
+        nlimits = limitTable->GetNumStencils();
+
+    Osd::CpuVertexBuffer * src = createBuffer(ncvs, fixture.GetVertices()),
+                         * expected = createBuffer(nstencils),
+                         * expectedLimit = createBuffer(nlimits),
+                         * expectedDu = createBuffer(nlimits),
+                         * expectedDv = createBuffer(nlimits);
+    Osd::BufferDescriptor desc3(0, 3, 3);
+
+    Osd::CpuEvaluator::EvalStencils(src, desc3, expected, desc3, &table);
+    Osd::CpuEvaluator::EvalStencils(src, desc3, expectedLimit, desc3,
+        expectedDu, desc3, expectedDv, desc3, limitTable);
+
+    size_t threshold = Dispatch::GetThreshold();
+
+    int count=0;
+    for (int threaded=0; threaded<2; ++threaded) {
+
+        Dispatch::SetThreshold(threaded ? 0 : std::numeric_limits<size_t>::max());
+
+        Dispatch::Backend backend = Dispatch::SelectBackend(1, 3);
+        if (not Dispatch::IsAvailable(backend) or
+            (backend==Dispatch::BACKEND_CPU) != (threaded==0 or
+                not (Dispatch::IsAvailable(Dispatch::BACKEND_OMP) or
+                     Dispatch::IsAvailable(Dispatch::BACKEND_TBB)))) {
+            ++count;
+        }
+
+        Osd::CpuVertexBuffer * dst = createBuffer(nstencils),
+                             * range = createBuffer(nstencils),
+                             * limit = createBuffer(nlimits),
+                             * du = createBuffer(nlimits),
+                             * dv = createBuffer(nlimits);
+
+        if (nstencils>0) {
+            Dispatch::EvalStencils(src, desc3, dst, desc3, &table);
+            Dispatch::EvalStencilRange(src, desc3, range, desc3, &table,
+                0, nstencils/2);
+            Dispatch::EvalStencilRange(src, desc3, range, desc3, &table,
+                nstencils/2, nstencils);
+
+            count += countDifferences(expected->BindCpuBuffer(),
+                                      dst->BindCpuBuffer(), nstencils*3);
+            count += countDifferences(expected->BindCpuBuffer(),
+                                      range->BindCpuBuffer(), nstencils*3);
+        }
+        if (nlimits>0) {
+            Dispatch::EvalStencils(src, desc3, limit, desc3,
+                du, desc3, dv, desc3, limitTable);
+
+            count += countDifferences(expectedLimit->BindCpuBuffer(),
+                                      limit->BindCpuBuffer(), nlimits*3);
+            count += countDifferences(expectedDu->BindCpuBuffer(),
+                                      du->BindCpuBuffer(), nlimits*3);
+            count += countDifferences(expectedDv->BindCpuBuffer(),
+                                      dv->BindCpuBuffer(), nlimits*3);
+        }
+        delete dst;
+        delete range;
+        delete limit;
+        delete du;
+        delete dv;
+    }
+
+    // the threshold is shared by all the evaluations of the process
+    Dispatch::SetThreshold(threshold);
+
+    delete src;
+    delete expected;
+    delete expectedLimit;
+    delete expectedDu;
+    delete expectedDv;
+    delete limitTable;
+
+    if (count) {
+        printf("// dispatch evaluator fails : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Stencils split between the CPU and the "GPU" (here CpuEvaluator as well)
+// must match the evaluation of the whole table, whatever the split
+static int
+checkSplitEvaluator(ShapeFixture & fixture, int maxlevel) {
+
+    typedef Osd::SplitEvaluator<Osd::CpuEvaluator, Osd::CpuEvaluator> Split;
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Far::StencilTable const & table =
+        fixture.GetStencilTable(fixture.GetUniformRefiner(maxlevel));
+
+    int ncvs = fixture.GetNumControlVertices(),
+        nstencils = table.GetNumStencils();
+    if (nstencils==0) return 0;
+
+    Osd::CpuVertexBuffer * src = createBuffer(ncvs, fixture.GetVertices()),
+                         * expected = createBuffer(nstencils);
+    Osd::BufferDescriptor desc3(0, 3, 3);
+    Osd::CpuEvaluator::EvalStencils(src, desc3, expected, desc3, &table);
+
+    static float const fractions[] = { 0.02f, 0.5f, 0.98f };
+
+    int count=0;
+    for (int i=0; i<4; ++i) {
+
+        // fixed fractions, then rebalanced over a few evaluations
+        bool adaptive = (i==3);
+        Split split(adaptive ? 0.25f : fractions[i], adaptive);
+
+        for (int k=0; k<(adaptive ? 3 : 1); ++k) {
+            Osd::CpuVertexBuffer * dst = createBuffer(nstencils);
+            if (not split.EvalStencils(fixture.GetVertices(), src, desc3,
+                                       dst, desc3, &table, &table)) {
+                ++count;
+            }
+            split.Synchronize();
+            count += countDifferences(expected->BindCpuBuffer(),
+                                      dst->BindCpuBuffer(), nstencils*3);
+            delete dst;
+        }
+    }
+    delete src;
+    delete expected;
+
+    if (count) {
+        printf("// split evaluator fails : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// Returns the number of normals and tangents differing from the unit cross
+// product of the derivatives, and from du orthogonalized against it (nearly
+// degenerate derivatives are skipped)
+static int
+compareNormals(float const * du, float const * dv,
+               float const * normals, float const * tangents, int n) {
+
+    int count=0;
+    for (int i=0; i<n; ++i) {
+        float const * u = du + i*3,
+                    * v = dv + i*3;
+        float cross[3] = { u[1]*v[2] - u[2]*v[1],
+                           u[2]*v[0] - u[0]*v[2],
+                           u[0]*v[1] - u[1]*v[0] };
+        float nn = cross[0]*cross[0] + cross[1]*cross[1] + cross[2]*cross[2],
+              uu = u[0]*u[0] + u[1]*u[1] + u[2]*u[2],
+              vv = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+        if (nn <= 1.0e-8f * uu * vv) continue;
+
+        float normal[3], tangent[3];
+        float nLength = std::sqrt(nn);
+        for (int k=0; k<3; ++k) normal[k] = cross[k] / nLength;
+
+        float un = u[0]*normal[0] + u[1]*normal[1] + u[2]*normal[2];
+        for (int k=0; k<3; ++k) tangent[k] = u[k] - un * normal[k];
+        float tLength = std::sqrt(tangent[0]*tangent[0] +
+                                  tangent[1]*tangent[1] + tangent[2]*tangent[2]);
+        for (int k=0; k<3; ++k) tangent[k] /= tLength;
+
+        if (countDifferences(normal, normals + i*3, 3, 1e-4f) or
+            countDifferences(tangent, tangents + i*3, 3, 1e-4f)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Normals evaluated from limit stencils or patches must be those of the
+// derivatives evaluated
+static int
+checkLimitNormals(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    if (desc.scheme!=kCatmark) {
+        return 0;
+    }
+
+    int ncvs = fixture.GetNumControlVertices(),
+        count = 0;
+
+    Osd::BufferDescriptor desc3(0, 3, 3);
+
+    // limit stencils
+    Far::LimitStencilTable const * limitTable =
+        createLimitStencils(fixture.GetAdaptiveRefiner(maxlevel));
+
+    int n = limitTable->GetNumStencils();
+    if (n>0) {
+        Osd::CpuVertexBuffer * src = createBuffer(ncvs, fixture.GetVertices()),
+                             * expected = createBuffer(n),
+                             * du = createBuffer(n),
+                             * dv = createBuffer(n),
+                             * dst = createBuffer(n),
+                             * normals = createBuffer(n),
+                             * tangents = createBuffer(n);
+
+        Osd::CpuEvaluator::EvalStencils(src, desc3, expected, desc3,
+            du, desc3, dv, desc3, limitTable);
+        Osd::CpuEvaluator::EvalStencilsWithNormals(src, desc3, dst, desc3,
+            normals, desc3, tangents, desc3, limitTable);
+
+        count += countDifferences(expected->BindCpuBuffer(), dst->BindCpuBuffer(), n*3);
+        count += compareNormals(du->BindCpuBuffer(), dv->BindCpuBuffer(),
+            normals->BindCpuBuffer(), tangents->BindCpuBuffer(), n);
+
+        delete src;
+        delete expected;
+        delete du;
+        delete dv;
+        delete dst;
+        delete normals;
+        delete tangents;
+    }
+    delete limitTable;
+
+    // patches of a mesh, at one location of each patch
+    CpuMesh mesh(fixture.CreateRefiner(), 3, 0, maxlevel,
+                 fixture.GetDefaultMeshBits());
+    mesh.UpdateVertexBuffer(fixture.GetVertices(), 0, ncvs);
+    mesh.Refine();
+
+    Far::PatchTable const * farPatchTable = mesh.GetFarPatchTable();
+    Osd::CpuPatchTable const * patchTable = mesh.GetPatchTable();
+
+    std::vector<Osd::PatchCoord> coords;
+    int patchIndex = 0;
+    for (int array=0; array<farPatchTable->GetNumPatchArrays(); ++array) {
+        int ncvsPerPatch = farPatchTable->GetPatchArrayDescriptor(array)
+            .GetNumControlVertices();
+        for (int patch=0; patch<farPatchTable->GetNumPatches(array);
+                ++patch, ++patchIndex) {
+            Far::PatchParam param = farPatchTable->GetPatchParam(array, patch);
+            float frac = param.GetParamFraction();
+
+            Far::PatchTable::PatchHandle handle;
+            handle.arrayIndex = array;
+            handle.patchIndex = patchIndex;
+            handle.vertIndex = patch * ncvsPerPatch;
+            coords.push_back(Osd::PatchCoord(handle,
+                ((float)param.GetU() + 0.3f) * frac,
+                ((float)param.GetV() + 0.6f) * frac));
+        }
+    }
+
+    n = (int)coords.size();
+    if (n>0) {
+        std::vector<float> expected(n*3), du(n*3), dv(n*3),
+                           dst(n*3), normals(n*3), tangents(n*3);
+
+        Osd::CpuEvaluator::EvalPatches(getMeshVertices(mesh), desc3,
+            &expected[0], desc3, &du[0], desc3, &dv[0], desc3,
+            n, &coords[0], patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(), patchTable->GetPatchParamBuffer());
+        Osd::CpuEvaluator::EvalPatchesWithNormals(getMeshVertices(mesh), desc3,
+            &dst[0], desc3, &normals[0], desc3, &tangents[0], desc3,
+            n, &coords[0], patchTable->GetPatchArrayBuffer(),
+            patchTable->GetPatchIndexBuffer(), patchTable->GetPatchParamBuffer());
+
+        count += countDifferences(&expected[0], &dst[0], n*3);
+        count += compareNormals(&du[0], &dv[0], &normals[0], &tangents[0], n);
+    }
+
+    if (count) {
+        printf("// limit normals fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+// The instances of a batch must be refined as if evaluated one by one
+template <class EVALUATOR>
+static int
+evalStencilsBatch(Far::StencilTable const & table,
+                  std::vector<float> const & verts, int ncvs,
+                  std::vector<float> const & expected) {
+
+    int const numInstances = 3;
+    int nstencils = table.GetNumStencils();
+
+    // the instances are laid out in reverse order, one vertex apart
+    std::vector<int> offsets(numInstances*2);
+    for (int i=0; i<numInstances; ++i) {
+        offsets[i*2] = i * ncvs * 3;
+        offsets[i*2+1] = ((numInstances-1-i) * (nstencils+1) + 1) * 3;
+    }
+
+    Osd::CpuVertexBuffer * src = createBuffer(numInstances*ncvs, &verts[0]),
+                         * dst = createBuffer(numInstances*(nstencils+1) + 1);
+    std::fill(dst->BindCpuBuffer(),
+        dst->BindCpuBuffer() + (numInstances*(nstencils+1) + 1)*3, 0.0f);
+
+    Osd::BufferDescriptor desc3(0, 3, 3);
+
+    int count=0;
+    if (not EVALUATOR::EvalStencilsBatch(src, desc3, dst, desc3, &table,
+                                         numInstances, &offsets[0])) {
+        ++count;
+    } else {
+        for (int i=0; i<numInstances; ++i) {
+            count += countDifferences(&expected[i*nstencils*3],
+                dst->BindCpuBuffer() + offsets[i*2+1], nstencils*3);
+        }
+    }
+    delete src;
+    delete dst;
+    return count;
+}
+
+static int
+checkStencilsBatch(ShapeFixture & fixture, int maxlevel) {
+
+    ShapeDesc const & desc = fixture.GetDesc();
+
+    Far::StencilTable const & table =
+        fixture.GetStencilTable(fixture.GetUniformRefiner(maxlevel));
+
+    int ncvs = fixture.GetNumControlVertices(),
+        nstencils = table.GetNumStencils();
+    if (nstencils==0) return 0;
+
+    // the instances are the poses of the shape, translated
+    int const numInstances = 3;
+    std::vector<float> verts(numInstances*ncvs*3),
+                       expected(numInstances*nstencils*3);
+
+    Osd::BufferDescriptor desc3(0, 3, 3);
+    for (int i=0; i<numInstances; ++i) {
+        float const * pose = (i==1) ? fixture.GetMovedVertices() :
+                                      fixture.GetVertices();
+        for (int k=0; k<ncvs*3; ++k) {
+            verts[i*ncvs*3 + k] = pose[k] + (float)i;
+        }
+        Osd::CpuVertexBuffer * src = createBuffer(ncvs, &verts[i*ncvs*3]),
+                             * dst = createBuffer(nstencils);
+        Osd::CpuEvaluator::EvalStencils(src, desc3, dst, desc3, &table);
+        std::copy(dst->BindCpuBuffer(), dst->BindCpuBuffer() + nstencils*3,
+            expected.begin() + i*nstencils*3);
+        delete src;
+        delete dst;
+    }
+
+    int count=0;
+    count += evalStencilsBatch<Osd::CpuEvaluator>(table, verts, ncvs, expected);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    count += evalStencilsBatch<Osd::OmpEvaluator>(table, verts, ncvs, expected);
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    count += evalStencilsBatch<Osd::TbbEvaluator>(table, verts, ncvs, expected);
+#endif
+
+    if (count) {
+        printf("// stencil batches fail : %s (%d differences)\n",
+            desc.name.c_str(), count);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+static void
+usage(char ** argv) {
+    printf("%s [<options>]\n\n", argv[0]);
+    printf("    Options :\n");
+
+    RegressionCases::PrintUsage();
+
+    printf("        -help / -h\n");
+    printf("        Displays usage information.\n");
+}
+
+//------------------------------------------------------------------------------
+static void
+parseArgs(int argc, char ** argv) {
+
+    for (int argi=1; argi<argc; ++argi) {
+        if (g_cases.ParseArg(argc, argv, argi)) {
+            continue;
+        } else if ((not strcmp(argv[argi],"-help")) or
+                   (not strcmp(argv[argi],"-h"))) {
+            usage(argv);
+            exit(0);
+        } else {
+            usage(argv);
+            exit(1);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+
+    parseArgs(argc, argv);
+
+    int levels=3, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        if (not g_cases.Begin()) continue;
+
+        printf("- %s\n", g_shapes[i].name.c_str());
+
+        ShapeFixture fixture(g_shapes[i]);
+
+        int failures=0;
+        failures+=checkPrimvarBuffers(fixture, levels);
+        failures+=checkWrappedBuffers(fixture, levels);
+        failures+=checkCompactPatchIndices(fixture, levels);
+        failures+=checkVaryingStencils(fixture, levels);
+        failures+=checkPlanarBuffers(fixture, levels);
+        failures+=checkAsyncRefine(fixture, levels);
+        failures+=checkDispatchEvaluator(fixture, levels);
+        failures+=checkSplitEvaluator(fixture, levels);
+        failures+=checkLimitNormals(fixture, levels);
+        failures+=checkStencilsBatch(fixture, levels);
+
+        g_cases.End(g_shapes[i].name, failures);
+        total+=failures;
+    }
+
+    g_cases.PrintReport();
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+    return (total==0) ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
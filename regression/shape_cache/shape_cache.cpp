@@ -0,0 +1,136 @@
+//
+//   Copyright 2016 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+//
+// Converts shapes to the binary format of Shape::writeShape(), read far
+// faster than OBJ text by Shape::readShape() (see far_perf).
+//
+// OBJ files given on the command line are converted, or else all the shapes
+// of far_regression, written as <dir>/<name>.shp.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../far_regression/init_shapes.h"
+
+//------------------------------------------------------------------------------
+static bool
+convert(Shape const * shape, std::string const & filename) {
+
+    if (not shape) {
+        return false;
+    }
+    printf("%s : %d vertices, %d faces\n", filename.c_str(),
+        shape->GetNumVertices(), shape->GetNumFaces());
+    return shape->writeShape(filename.c_str());
+}
+
+static std::string
+binaryName(std::string const & dir, std::string name) {
+
+    std::string::size_type slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        name = name.substr(slash+1);
+    }
+    std::string::size_type dot = name.rfind('.');
+    if (dot != std::string::npos) {
+        name = name.substr(0, dot);
+    }
+    return dir + "/" + name + ".shp";
+}
+
+//------------------------------------------------------------------------------
+static void
+usage(char const * program) {
+
+    printf("Usage: %s [options] [file.obj ...]\n", program);
+    printf("  -o <dir>       output directory (default .)\n");
+    printf("  -bilinear      scheme of the OBJ files (default catmark)\n");
+    printf("  -loop\n");
+    printf("  -lh            OBJ files are left handed\n");
+    printf("Without OBJ files, the shapes of far_regression are converted\n");
+}
+
+int main(int argc, char **argv)
+{
+    std::string dir(".");
+    std::vector<char const *> files;
+    Scheme scheme = kCatmark;
+    bool isLeftHanded = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strstr(argv[i], ".obj")) {
+            files.push_back(argv[i]);
+        }
+        else if (!strcmp(argv[i], "-o") and i+1 < argc) {
+            dir = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-bilinear")) {
+            scheme = kBilinear;
+        }
+        else if (!strcmp(argv[i], "-loop")) {
+            scheme = kLoop;
+        }
+        else if (!strcmp(argv[i], "-lh")) {
+            isLeftHanded = true;
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    int failures = 0;
+
+    if (files.empty()) {
+        initShapes();
+        g_shapes.insert(g_shapes.end(), g_editShapes.begin(), g_editShapes.end());
+
+        for (int i = 0; i < (int)g_shapes.size(); ++i) {
+            Shape * shape = Shape::parseObj(g_shapes[i].data.c_str(),
+                g_shapes[i].scheme, g_shapes[i].isLeftHanded);
+            if (not convert(shape, binaryName(dir, g_shapes[i].name))) {
+                printf("Failed to convert %s\n", g_shapes[i].name.c_str());
+                ++failures;
+            }
+            delete shape;
+        }
+    }
+
+    for (int i = 0; i < (int)files.size(); ++i) {
+        Shape * shape = Shape::readObj(files[i], scheme, isLeftHanded);
+        if (not convert(shape, binaryName(dir, files[i]))) {
+            printf("Failed to convert %s\n", files[i]);
+            ++failures;
+        }
+        delete shape;
+    }
+    return failures ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------